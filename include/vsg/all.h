@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 // Core header files
 #include <vsg/core/Allocator.h>
+#include <vsg/core/AllocatorArena.h>
 #include <vsg/core/Array.h>
 #include <vsg/core/Array2D.h>
 #include <vsg/core/Array3D.h>
@@ -29,6 +30,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Object.h>
 #include <vsg/core/Objects.h>
 #include <vsg/core/ScratchMemory.h>
+#include <vsg/core/SizeClassAllocator.h>
 #include <vsg/core/Value.h>
 #include <vsg/core/Version.h>
 #include <vsg/core/Visitor.h>
@@ -49,6 +51,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/maths/plane.h>
 #include <vsg/maths/quat.h>
 #include <vsg/maths/sample.h>
+#include <vsg/maths/simd.h>
 #include <vsg/maths/sphere.h>
 #include <vsg/maths/transform.h>
 #include <vsg/maths/vec2.h>
@@ -62,19 +65,27 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/nodes/CullGroup.h>
 #include <vsg/nodes/CullNode.h>
 #include <vsg/nodes/DepthSorted.h>
+#include <vsg/nodes/FlattenedSubgraph.h>
 #include <vsg/nodes/Geometry.h>
 #include <vsg/nodes/Group.h>
+#include <vsg/nodes/InstanceNode.h>
+#include <vsg/nodes/InstancedGeometry.h>
 #include <vsg/nodes/InstrumentationNode.h>
 #include <vsg/nodes/LOD.h>
 #include <vsg/nodes/Light.h>
 #include <vsg/nodes/MatrixTransform.h>
 #include <vsg/nodes/Node.h>
+#include <vsg/nodes/OcclusionQueryNode.h>
 #include <vsg/nodes/PagedLOD.h>
+#include <vsg/nodes/PointCloud.h>
 #include <vsg/nodes/QuadGroup.h>
+#include <vsg/nodes/SpatialGroup.h>
 #include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/StreamingTexture.h>
 #include <vsg/nodes/Switch.h>
 #include <vsg/nodes/TileDatabase.h>
 #include <vsg/nodes/Transform.h>
+#include <vsg/nodes/TransformPool.h>
 #include <vsg/nodes/VertexDraw.h>
 #include <vsg/nodes/VertexIndexDraw.h>
 
@@ -97,6 +108,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/commands/Draw.h>
 #include <vsg/commands/DrawIndexed.h>
 #include <vsg/commands/DrawIndexedIndirect.h>
+#include <vsg/commands/DrawIndexedIndirectCommand.h>
+#include <vsg/commands/DrawIndexedIndirectCount.h>
 #include <vsg/commands/DrawIndirect.h>
 #include <vsg/commands/DrawIndirectCommand.h>
 #include <vsg/commands/EndQuery.h>
@@ -107,6 +120,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/commands/ResetQueryPool.h>
 #include <vsg/commands/ResolveImage.h>
 #include <vsg/commands/SetDepthBias.h>
+#include <vsg/commands/SetFragmentShadingRate.h>
 #include <vsg/commands/SetLineWidth.h>
 #include <vsg/commands/SetScissor.h>
 #include <vsg/commands/SetViewport.h>
@@ -115,6 +129,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 // State header files
 #include <vsg/state/ArrayState.h>
 #include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/BindlessTextures.h>
 #include <vsg/state/Buffer.h>
 #include <vsg/state/BufferInfo.h>
 #include <vsg/state/BufferView.h>
@@ -127,8 +142,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/DescriptorSet.h>
 #include <vsg/state/DescriptorSetLayout.h>
 #include <vsg/state/DescriptorTexelBufferView.h>
+#include <vsg/state/DynamicBufferRing.h>
 #include <vsg/state/DynamicState.h>
+#include <vsg/state/FragmentShadingRateState.h>
 #include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/GraphicsPipelineLibrary.h>
 #include <vsg/state/Image.h>
 #include <vsg/state/ImageInfo.h>
 #include <vsg/state/ImageView.h>
@@ -136,10 +154,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/MultisampleState.h>
 #include <vsg/state/PipelineLayout.h>
 #include <vsg/state/PushConstants.h>
+#include <vsg/state/PushDescriptorSet.h>
 #include <vsg/state/QueryPool.h>
 #include <vsg/state/RasterizationState.h>
 #include <vsg/state/ResourceHints.h>
 #include <vsg/state/Sampler.h>
+#include <vsg/state/SetDynamicState.h>
 #include <vsg/state/ShaderModule.h>
 #include <vsg/state/ShaderStage.h>
 #include <vsg/state/StateCommand.h>
@@ -155,9 +175,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/threading/Affinity.h>
 #include <vsg/threading/Barrier.h>
 #include <vsg/threading/FrameBlock.h>
+#include <vsg/threading/JobSystem.h>
 #include <vsg/threading/Latch.h>
 #include <vsg/threading/OperationQueue.h>
 #include <vsg/threading/OperationThreads.h>
+#include <vsg/threading/ThreadParker.h>
 #include <vsg/threading/atomics.h>
 
 // User Interface abstraction header files
@@ -179,22 +201,46 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 // Application header files
 #include <vsg/app/Camera.h>
 #include <vsg/app/CloseHandler.h>
+#include <vsg/app/Cluster.h>
 #include <vsg/app/CommandGraph.h>
 #include <vsg/app/CompileManager.h>
 #include <vsg/app/CompileTraversal.h>
+#include <vsg/app/ComputeCommandGraph.h>
+#include <vsg/app/DeferredRenderGraph.h>
+#include <vsg/app/DeleteQueue.h>
+#include <vsg/app/DepthPrePass.h>
+#include <vsg/app/DynamicResolution.h>
 #include <vsg/app/EllipsoidModel.h>
+#include <vsg/app/FrameGraph.h>
+#include <vsg/app/FramePacer.h>
+#include <vsg/app/FrameStatistics.h>
+#include <vsg/app/GpuTimestamps.h>
+#include <vsg/app/LODScaleController.h>
+#include <vsg/app/MemoryDefragmenter.h>
+#include <vsg/app/OITRenderGraph.h>
+#include <vsg/app/OcclusionCulling.h>
+#include <vsg/app/OcclusionQueries.h>
+#include <vsg/app/OffscreenRenderGraph.h>
+#include <vsg/app/PowerManager.h>
 #include <vsg/app/Presentation.h>
+#include <vsg/app/ProgressiveLoader.h>
 #include <vsg/app/ProjectionMatrix.h>
 #include <vsg/app/RecordAndSubmitTask.h>
+#include <vsg/app/RecordSignature.h>
 #include <vsg/app/RecordTraversal.h>
 #include <vsg/app/RenderGraph.h>
 #include <vsg/app/SecondaryCommandGraph.h>
+#include <vsg/app/SharedCull.h>
+#include <vsg/app/SwapchainTuner.h>
+#include <vsg/app/TextureStreamer.h>
+#include <vsg/app/ToneMapRenderGraph.h>
 #include <vsg/app/Trackball.h>
 #include <vsg/app/TransferTask.h>
 #include <vsg/app/UpdateOperations.h>
 #include <vsg/app/View.h>
 #include <vsg/app/ViewMatrix.h>
 #include <vsg/app/Viewer.h>
+#include <vsg/app/VisibilityCache.h>
 #include <vsg/app/Window.h>
 #include <vsg/app/WindowAdapter.h>
 #include <vsg/app/WindowResizeHandler.h>
@@ -204,7 +250,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/vk/AllocationCallbacks.h>
 #include <vsg/vk/CommandBuffer.h>
 #include <vsg/vk/CommandPool.h>
+#include <vsg/vk/CommandPoolRing.h>
 #include <vsg/vk/Context.h>
+#include <vsg/vk/DescriptorHeap.h>
 #include <vsg/vk/DescriptorPool.h>
 #include <vsg/vk/Device.h>
 #include <vsg/vk/DeviceExtensions.h>
@@ -214,34 +262,49 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/vk/Framebuffer.h>
 #include <vsg/vk/Instance.h>
 #include <vsg/vk/InstanceExtensions.h>
+#include <vsg/vk/MemoryBudget.h>
 #include <vsg/vk/MemoryBufferPools.h>
 #include <vsg/vk/PhysicalDevice.h>
+#include <vsg/vk/PipelineCache.h>
 #include <vsg/vk/Queue.h>
 #include <vsg/vk/RenderPass.h>
 #include <vsg/vk/ResourceRequirements.h>
 #include <vsg/vk/Semaphore.h>
+#include <vsg/vk/StagingRingBuffer.h>
 #include <vsg/vk/State.h>
+#include <vsg/vk/StateCache.h>
 #include <vsg/vk/SubmitCommands.h>
 #include <vsg/vk/Surface.h>
 #include <vsg/vk/Swapchain.h>
+#include <vsg/vk/TimelineSemaphore.h>
 #include <vsg/vk/vk_buffer.h>
 #include <vsg/vk/vulkan.h>
 
 // Input/Output header files
 #include <vsg/io/AsciiInput.h>
 #include <vsg/io/AsciiOutput.h>
+#include <vsg/io/AsyncLogger.h>
 #include <vsg/io/BinaryInput.h>
 #include <vsg/io/BinaryOutput.h>
 #include <vsg/io/DatabasePager.h>
+#include <vsg/io/DatabasePrefetcher.h>
+#include <vsg/io/Fields.h>
+#include <vsg/io/FileLookupCache.h>
 #include <vsg/io/FileSystem.h>
+#include <vsg/io/HashOutput.h>
 #include <vsg/io/Input.h>
 #include <vsg/io/Logger.h>
+#include <vsg/io/MappedFile.h>
 #include <vsg/io/ObjectFactory.h>
 #include <vsg/io/Options.h>
 #include <vsg/io/Output.h>
 #include <vsg/io/Path.h>
+#include <vsg/io/ReadBatch.h>
 #include <vsg/io/ReaderWriter.h>
+#include <vsg/io/TileCache.h>
 #include <vsg/io/VSG.h>
+#include <vsg/io/async_stream.h>
+#include <vsg/io/compression.h>
 #include <vsg/io/convert_utf.h>
 #include <vsg/io/glsl.h>
 #include <vsg/io/mem_stream.h>
@@ -255,23 +318,53 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 // Utility header files
 #include <vsg/utils/AnimationPath.h>
+#include <vsg/utils/BatchInstances.h>
+#include <vsg/utils/BuildCullHierarchy.h>
+#include <vsg/utils/BuildPagedLOD.h>
+#include <vsg/utils/BuildPointCloud.h>
 #include <vsg/utils/Builder.h>
+#include <vsg/utils/CacheTransformBounds.h>
 #include <vsg/utils/CommandLine.h>
 #include <vsg/utils/ComputeBounds.h>
+#include <vsg/utils/ComputeSkinning.h>
+#include <vsg/utils/GenerateLODs.h>
 #include <vsg/utils/GpuAnnotation.h>
 #include <vsg/utils/GraphicsPipelineConfigurator.h>
+#include <vsg/utils/HitchDetector.h>
+#include <vsg/utils/ImageFormatConverter.h>
+#include <vsg/utils/ImageProcessing.h>
+#include <vsg/utils/Impostor.h>
+#include <vsg/utils/InstanceCulling.h>
 #include <vsg/utils/Instrumentation.h>
 #include <vsg/utils/Intersector.h>
 #include <vsg/utils/LineSegmentIntersector.h>
 #include <vsg/utils/LoadPagedLOD.h>
+#include <vsg/utils/MemoryAccounting.h>
+#include <vsg/utils/MergeGeometry.h>
+#include <vsg/utils/MeshOptimizer.h>
+#include <vsg/utils/PackTextures.h>
+#include <vsg/utils/ParallelTraversal.h>
+#include <vsg/utils/PolytopeIntersector.h>
+#include <vsg/utils/RayBatchIntersector.h>
+#include <vsg/utils/SetThreadConfined.h>
 #include <vsg/utils/ShaderCompiler.h>
 #include <vsg/utils/ShaderSet.h>
+#include <vsg/utils/ShadingRateImage.h>
 #include <vsg/utils/SharedObjects.h>
+#include <vsg/utils/StatsInstrumentation.h>
+#include <vsg/utils/TerrainHeightQuery.h>
+#include <vsg/utils/TextureTranscoder.h>
+#include <vsg/utils/TriangleBVH.h>
+#include <vsg/utils/VirtualTexture.h>
+#include <vsg/utils/WorkloadPlayer.h>
+#include <vsg/utils/WorkloadRecorder.h>
 
 // Text header files
 #include <vsg/text/CpuLayoutTechnique.h>
+#include <vsg/text/DynamicGlyphAtlas.h>
 #include <vsg/text/Font.h>
 #include <vsg/text/GlyphMetrics.h>
+#include <vsg/text/GpuLabelTechnique.h>
 #include <vsg/text/GpuLayoutTechnique.h>
 #include <vsg/text/StandardLayout.h>
 #include <vsg/text/Text.h>
@@ -285,12 +378,16 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/raytracing/BottomLevelAccelerationStructure.h>
 #include <vsg/raytracing/BuildAccelerationStructureTraversal.h>
 #include <vsg/raytracing/DescriptorAccelerationStructure.h>
+#include <vsg/raytracing/RayQueryIntersector.h>
 #include <vsg/raytracing/RayTracingPipeline.h>
 #include <vsg/raytracing/RayTracingShaderGroup.h>
 #include <vsg/raytracing/TopLevelAccelerationStructure.h>
 #include <vsg/raytracing/TraceRays.h>
+#include <vsg/raytracing/UpdateTopLevelAccelerationStructure.h>
 
 // Mesh shader header files
+#include <vsg/meshshaders/ConvertToMeshlets.h>
 #include <vsg/meshshaders/DrawMeshTasks.h>
 #include <vsg/meshshaders/DrawMeshTasksIndirect.h>
 #include <vsg/meshshaders/DrawMeshTasksIndirectCount.h>
+#include <vsg/meshshaders/Meshlets.h>
@@ -0,0 +1,118 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Data.h>
+#include <vsg/core/Mask.h>
+#include <vsg/maths/mat4.h>
+
+#include <string>
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class Viewer;
+    class Node;
+
+    /// ClusterConnection is a reliable, ordered, message based link between two nodes of a render cluster.
+    class VSG_DECLSPEC ClusterConnection : public Inherit<Object, ClusterConnection>
+    {
+    public:
+        /// send message, return false if the connection has failed.
+        virtual bool send(const std::string& message) = 0;
+
+        /// block until the next message is received, return false if the connection has failed.
+        virtual bool receive(std::string& message) = 0;
+    };
+    VSG_type_name(vsg::ClusterConnection);
+
+    /// TCPConnection is a ClusterConnection that sends length prefixed messages over a TCP socket with Nagle's algorithm disabled.
+    class VSG_DECLSPEC TCPConnection : public Inherit<ClusterConnection, TCPConnection>
+    {
+    public:
+        /// connect to a master listening on host:port, retrying until timeout seconds have elapsed, return null on failure.
+        static ref_ptr<TCPConnection> connect(const std::string& host, uint16_t port, double timeout = 10.0);
+
+        /// listen on port and accept numConnections connections from slaves, return the connections in the order they were accepted.
+        static std::vector<ref_ptr<ClusterConnection>> accept(uint16_t port, size_t numConnections);
+
+        bool send(const std::string& message) override;
+        bool receive(std::string& message) override;
+
+    protected:
+        explicit TCPConnection(intptr_t in_socket);
+        virtual ~TCPConnection();
+
+        intptr_t _socket;
+    };
+    VSG_type_name(vsg::TCPConnection);
+
+    /// Cluster frame locks Viewers running on several render nodes, with one master driving the slaves.
+    /// Every node loads the same scene graph and registers the objects to replicate, with share()/shareSubgraph(), in the same order.
+    /// Each frame the master sends only the changes since the previous frame: MatrixTransform matrices, Switch masks, the modified byte ranges of Data
+    /// and Camera view matrices, so bandwidth scales with the amount of change rather than the size of the scene.
+    /// Slaves apply the changes before recording, then a swap barrier ensures all nodes present each frame together.
+    /// Assign to Viewer::cluster to have the Viewer call update() and swapBarrier() each frame.
+    class VSG_DECLSPEC Cluster : public Inherit<Object, Cluster>
+    {
+    public:
+        /// construct the master of the cluster with a connection to each slave.
+        explicit Cluster(std::vector<ref_ptr<ClusterConnection>> in_slaves);
+
+        /// construct a slave of the cluster connected to its master.
+        explicit Cluster(ref_ptr<ClusterConnection> in_master);
+
+        ref_ptr<ClusterConnection> master;
+        std::vector<ref_ptr<ClusterConnection>> slaves;
+
+        bool isMaster() const { return !master; }
+
+        /// register a MatrixTransform, Switch, Camera or Data for replication, other object types are ignored.
+        void share(ref_ptr<Object> object);
+
+        /// register all the MatrixTransform, Switch and Camera nodes in the subgraph, in traversal order.
+        void shareSubgraph(ref_ptr<Node> node);
+
+        /// master: send the changes since the previous frame to the slaves, slave: receive and apply the master's changes.
+        /// Called by Viewer::update() after the update operations, returns false if a connection has failed.
+        virtual bool update(Viewer& viewer);
+
+        /// wait until all the nodes of the cluster are ready to present, called by Viewer::present().
+        virtual bool swapBarrier();
+
+        /// size in bytes of the changes sent or received by the last update()
+        size_t updateSize = 0;
+
+    protected:
+        virtual ~Cluster();
+
+        struct Shared
+        {
+            ref_ptr<Object> object;
+            dmat4 matrix;
+            std::vector<Mask> masks;
+            ModifiedCount modifiedCount;
+        };
+
+        bool _changed(Shared& shared, Data::ModifiedRanges& ranges);
+        void _write(const Shared& shared, const Data::ModifiedRanges& ranges, Output& output);
+        bool _read(Shared& shared, Input& input);
+
+        std::vector<Shared> _shared;
+        uint64_t _frameCount = 0;
+    };
+    VSG_type_name(vsg::Cluster);
+
+} // namespace vsg
@@ -13,12 +13,17 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/app/Camera.h>
+#include <vsg/app/FrameStatistics.h>
+#include <vsg/app/GpuTimestamps.h>
+#include <vsg/app/OcclusionQueries.h>
+#include <vsg/app/RecordSignature.h>
 #include <vsg/app/Window.h>
 #include <vsg/core/Export.h>
 #include <vsg/nodes/Bin.h>
 #include <vsg/nodes/Group.h>
 #include <vsg/utils/Instrumentation.h>
 #include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/CommandPoolRing.h>
 
 namespace vsg
 {
@@ -46,6 +51,17 @@ namespace vsg
 
         ref_ptr<RecordTraversal> recordTraversal;
 
+        /// when true the recorded command buffers are retained and resubmitted on subsequent frames if the RecordSignature of the subgraph is unchanged,
+        /// avoiding the record traversal for static views. Subgraphs that the RecordSignature flags as not reusable are recorded every frame.
+        bool reuseCommandBuffers = false;
+
+        /// optional CommandPoolRing to allocate the CommandBuffers recorded each frame from, shared with the other CommandGraphs recorded on the same thread.
+        /// Not used when reuseCommandBuffers is enabled as reused CommandBuffers must outlive the frame.
+        ref_ptr<CommandPoolRing> commandPoolRing;
+
+        /// request the subgraph is recorded on the next frame, used when reuseCommandBuffers is enabled and a change isn't captured by the RecordSignature.
+        void requestRecord() { _recordRequested = true; }
+
         virtual VkCommandBufferLevel level() const;
         virtual void reset();
         virtual void record(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers, ref_ptr<FrameStamp> frameStamp = {}, ref_ptr<DatabasePager> databasePager = {});
@@ -53,10 +69,40 @@ namespace vsg
         /// hook for assigning Instrumentation to enable profiling of record traversal.
         ref_ptr<Instrumentation> instrumentation;
 
+        /// optional FrameStatistics to add the record time of the CommandGraph to
+        ref_ptr<FrameStatistics> frameStatistics;
+
+        /// ring of timestamp query pools used by InstrumentationNodes with gpuTiming enabled, created on the first record.
+        /// Not used when a recorded command buffer is reused as its timestamps would not be reset.
+        ref_ptr<GpuTimestamps> gpuTimestamps;
+
+        /// ring of occlusion query pools used by OcclusionQueryNodes, created on the first record.
+        /// Not used when a recorded command buffer is reused as its queries would not be reset.
+        ref_ptr<OcclusionQueries> occlusionQueries;
+
     protected:
         virtual ~CommandGraph();
 
+        /// return a CommandBuffer that isn't in use by a pending submission or retained for reuse, allocating a new one if required
+        ref_ptr<CommandBuffer> _availableCommandBuffer();
+
+        /// if reuseCommandBuffers is enabled return the CommandBuffer previously recorded for key if the subgraph's signature is unchanged, otherwise update signature and return null
+        ref_ptr<CommandBuffer> _reusableCommandBuffer(size_t key, uint64_t& signature);
+
+        /// retain a recorded CommandBuffer so that it can be reused by subsequent frames with the same key and signature
+        void _retainCommandBuffer(size_t key, uint64_t signature, ref_ptr<CommandBuffer> commandBuffer);
+
         CommandBuffers _commandBuffers; // assign one per index? Or just use round robin, each has a CommandPool
+
+        struct RetainedCommandBuffer
+        {
+            size_t key = 0;
+            uint64_t signature = 0;
+            ref_ptr<CommandBuffer> commandBuffer;
+        };
+        std::vector<RetainedCommandBuffer> _retainedCommandBuffers;
+        ref_ptr<RecordSignature> _recordSignature;
+        bool _recordRequested = false;
     };
     VSG_type_name(vsg::CommandGraph);
 
@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/app/CompileTraversal.h>
+#include <vsg/threading/Latch.h>
 #include <vsg/threading/OperationQueue.h>
 
 namespace vsg
@@ -30,6 +31,12 @@ namespace vsg
         ResourceRequirements::DynamicData earlyDynamicData;
         ResourceRequirements::DynamicData lateDynamicData;
 
+        /// CPU memory in bytes of the Data referenced by the compiled subgraph
+        VkDeviceSize dataSize = 0;
+
+        /// device memory in bytes of the buffers and images used by the compiled subgraph
+        VkDeviceSize deviceMemorySize = 0;
+
         explicit operator bool() const noexcept { return result == VK_SUCCESS; }
 
         void reset();
@@ -61,12 +68,48 @@ namespace vsg
         /// assign Instrumentation to all CompileTraversal and their associated Context
         void assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation);
 
+        /// assign PipelineCache to all CompileTraversal Context associated with the PipelineCache's Device
+        void assignPipelineCache(ref_ptr<PipelineCache> pipelineCache);
+
+        /// assign OperationThreads to all CompileTraversal and their associated Context, used to create pipelines in parallel
+        void assignOperationThreads(ref_ptr<OperationThreads> operationThreads);
+
+        /// assign asynchronousPipelineCompile setting to all CompileTraversal and their associated Context, so new subgraphs can be merged before their GraphicsPipelines have been created
+        void assignAsynchronousPipelineCompile(bool asynchronousPipelineCompile);
+
         using ContextSelectionFunction = std::function<bool(vsg::Context&)>;
 
         /// compile object
         CompileResult compile(ref_ptr<Object> object, ContextSelectionFunction contextSelection = {});
 
+        /// compile objects together using a single CompileTraversal submission, returning a CompileResult for each object
+        std::vector<CompileResult> compile(const std::vector<ref_ptr<Object>>& objects, ContextSelectionFunction contextSelection = {});
+
+        /// when true, compile(object) requests made while another is being compiled are accumulated and compiled together in a single submission
+        /// that shares the Context's staging memory, with each calling thread released once the shared submission completes.
+        /// Requests with a ContextSelectionFunction are always compiled individually.
+        bool batchCompiles = false;
+
+        /// maximum number of requests compiled together when batchCompiles is enabled
+        size_t maxBatchSize = 16;
+
     protected:
+        struct CompileRequest : public Object
+        {
+            ref_ptr<Object> object;
+            CompileResult result;
+            ref_ptr<Latch> latch;
+            bool lead = false;
+            bool completed = false;
+        };
+
+        /// compile the next batch of pending requests and release their waiting threads
+        void _compileBatch();
+
+        std::mutex _batchMutex;
+        std::vector<ref_ptr<CompileRequest>> _pendingRequests;
+        bool _batchInProgress = false;
+
         using CompileTraversals = ThreadSafeQueue<ref_ptr<CompileTraversal>>;
         size_t numCompileTraversals = 0;
         ref_ptr<CompileTraversals> compileTraversals;
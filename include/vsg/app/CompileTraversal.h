@@ -49,6 +49,12 @@ namespace vsg
         /// Hook for assigning Instrumentation to enable profiling
         ref_ptr<Instrumentation> instrumentation;
 
+        /// optional OperationThreads used to create graphics and compute pipelines in parallel, pipelines are created when record() is called.
+        ref_ptr<OperationThreads> operationThreads;
+
+        /// when true, and operationThreads are assigned, GraphicsPipelines are created in the background rather than record() waiting for them, see Context::asynchronousPipelineCompile.
+        bool asynchronousPipelineCompile = false;
+
         /// add a compile Context for device
         void add(ref_ptr<Device> device, const ResourceRequirements& resourceRequirements = {});
 
@@ -67,6 +73,15 @@ namespace vsg
         /// assign Instrumentation to all Context
         void assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation);
 
+        /// assign PipelineCache to all Context associated with the PipelineCache's Device
+        void assignPipelineCache(ref_ptr<PipelineCache> pipelineCache);
+
+        /// assign OperationThreads to all Context
+        void assignOperationThreads(ref_ptr<OperationThreads> in_operationThreads);
+
+        /// assign asynchronousPipelineCompile setting to all Context
+        void assignAsynchronousPipelineCompile(bool in_asynchronousPipelineCompile);
+
         Instrumentation* getInstrumentation() override { return instrumentation.get(); }
 
         virtual bool record();
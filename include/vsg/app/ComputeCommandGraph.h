@@ -0,0 +1,42 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/CommandGraph.h>
+
+namespace vsg
+{
+
+    /// ComputeCommandGraph is a CommandGraph for compute work that is submitted to a compute queue, preferring an async compute queue
+    /// from a queue family without graphics support so that the compute work can overlap the rendering of the graphics CommandGraphs.
+    /// The Viewer synchronizes ComputeCommandGraphs with the other RecordAndSubmitTasks on the same Device so each frame's
+    /// graphics work waits on that frame's compute results. Enable WindowTraits::asyncComputeQueue to request the async compute queue.
+    class VSG_DECLSPEC ComputeCommandGraph : public Inherit<CommandGraph, ComputeCommandGraph>
+    {
+    public:
+        ComputeCommandGraph();
+        ComputeCommandGraph(ref_ptr<Device> in_device, int family);
+        explicit ComputeCommandGraph(ref_ptr<Device> in_device, ref_ptr<Node> child = {});
+
+        /// graphics pipeline stages that wait on the compute results.
+        VkPipelineStageFlags graphicsWaitStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+        /// when true the compute work waits on the previous frame's graphics work, required when the compute shaders write to resources the graphics reads.
+        bool waitForPreviousFrame = true;
+
+    protected:
+        virtual ~ComputeCommandGraph();
+    };
+    VSG_type_name(vsg::ComputeCommandGraph);
+
+} // namespace vsg
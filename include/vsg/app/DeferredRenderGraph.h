@@ -0,0 +1,99 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RenderGraph.h>
+#include <vsg/app/View.h>
+#include <vsg/core/Value.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/DescriptorSet.h>
+#include <vsg/utils/ShaderSet.h>
+
+namespace vsg
+{
+
+    /// DeferredRenderGraph renders its View into a G-buffer in a first subpass and shades it in a second subpass that reads the G-buffer as input attachments,
+    /// so that on tile based GPUs the G-buffer can stay on chip and never be written out to memory.
+    /// The scene graph's pipelines must write the G-buffer layout, as set up by the createDeferredPhongShaderSet() and createDeferredPhysicsBasedRenderingShaderSet() ShaderSets:
+    ///   location 0 : albedo   - linear base color in rgb, ambient occlusion in a
+    ///   location 1 : normal   - eye coordinate normal in xyz
+    ///   location 2 : material - metallic in r, perceptual roughness in g
+    ///   location 3 : emissive - linear emissive color in rgb
+    /// The lighting subpass is appended to the View's children so it's recorded with the View's ViewDependentState lights and shadow maps.
+    /// As the View's bins are recorded after its children they're recorded in the lighting subpass, so they should only contain pipelines with a subpass of 1,
+    /// such as forward rendered transparent geometry which can depth test against the G-buffer's read only depth attachment.
+    class VSG_DECLSPEC DeferredRenderGraph : public Inherit<RenderGraph, DeferredRenderGraph>
+    {
+    public:
+        DeferredRenderGraph(ref_ptr<Window> in_window, ref_ptr<View> in_view, ref_ptr<const Options> options = {});
+
+        enum Attachments : uint32_t
+        {
+            COLOR,
+            ALBEDO,
+            NORMAL,
+            MATERIAL,
+            EMISSIVE,
+            DEPTH,
+            NUM_ATTACHMENTS
+        };
+
+        static constexpr VkFormat albedoFormat = VK_FORMAT_R8G8B8A8_SRGB;
+        static constexpr VkFormat normalFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+        static constexpr VkFormat materialFormat = VK_FORMAT_R8G8B8A8_UNORM;
+        static constexpr VkFormat emissiveFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+        ref_ptr<View> view;
+
+        /// G-buffer ImageViews, indexed by Attachments, the COLOR entry is unused as it's the Window's swapchain image
+        ImageViews gbuffer;
+
+        /// lighting subpass, a full screen triangle that reads the G-buffer and ViewDependentState light data
+        ref_ptr<StateGroup> lightingPass;
+
+        /// input attachment DescriptorSet bound by the lightingPass, updated when the G-buffer is recreated
+        ref_ptr<DescriptorSet> gbufferDescriptorSet;
+
+        /// inverse of the View's projection matrix, updated each frame and used by the lighting subpass to reconstruct eye coordinates from depth
+        ref_ptr<mat4Value> inverseProjection;
+
+        using RenderGraph::accept;
+
+        void accept(RecordTraversal& recordTraversal) const override;
+
+        /// (re)create the G-buffer images and the framebuffers for each of the Window's swapchain images
+        void createFramebuffers();
+
+    protected:
+        virtual ~DeferredRenderGraph();
+
+        std::vector<ref_ptr<Framebuffer>> _framebuffers;
+        std::vector<const ImageView*> _swapchainImageViews;
+    };
+    VSG_type_name(vsg::DeferredRenderGraph);
+
+    /// create a ShaderSet with the phong ShaderSet's vertex shader and bindings, with a fragment shader that writes the DeferredRenderGraph's G-buffer.
+    /// Phong materials are converted to the G-buffer's metallic roughness model, with a metallic of 0 and roughness derived from shininess.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createDeferredPhongShaderSet(ref_ptr<const Options> options = {});
+
+    /// create a ShaderSet with the pbr ShaderSet's vertex shader and bindings, with a fragment shader that writes the DeferredRenderGraph's G-buffer.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createDeferredPhysicsBasedRenderingShaderSet(ref_ptr<const Options> options = {});
+
+    /// create the ShaderSet used by the DeferredRenderGraph's lighting subpass.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createDeferredLightingShaderSet(ref_ptr<const Options> options = {});
+
+    /// Convenience function that sets up a DeferredRenderGraph and associated View to render the specified scene graph from the specified camera view.
+    /// The scene graph should be built with the createDeferredPhongShaderSet() or createDeferredPhysicsBasedRenderingShaderSet() ShaderSets.
+    extern VSG_DECLSPEC ref_ptr<DeferredRenderGraph> createDeferredRenderGraphForView(ref_ptr<Window> window, ref_ptr<Camera> camera, ref_ptr<Node> scenegraph, bool assignHeadlight = true);
+
+} // namespace vsg
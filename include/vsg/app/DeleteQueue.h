@@ -0,0 +1,93 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/threading/ActivityStatus.h>
+#include <vsg/ui/FrameStamp.h>
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// DeleteQueue defers the release of objects removed from the scene graph until the GPU can no longer be using them,
+    /// so that destructors and the destruction of the associated Vulkan objects can be done in batches on a background thread
+    /// rather than on the main thread. Objects are retained for retainForFrameCount frames after the frame they were added in.
+    class VSG_DECLSPEC DeleteQueue : public Inherit<Object, DeleteQueue>
+    {
+    public:
+        explicit DeleteQueue(ref_ptr<ActivityStatus> status, uint64_t in_retainForFrameCount = 3);
+
+        struct ObjectToDelete
+        {
+            uint64_t frameCount = 0;
+            ref_ptr<Object> object;
+        };
+
+        using ObjectsToDelete = std::list<ObjectToDelete>;
+
+        std::atomic_uint64_t frameCount{0};
+
+        /// number of frames objects are retained for, should be at least the number of frames that can be in flight on the GPU
+        uint64_t retainForFrameCount = 3;
+
+        ActivityStatus* getStatus() { return _status; }
+        const ActivityStatus* getStatus() const { return _status; }
+
+        /// advance the frameCount, releasing the thread waiting in wait_then_clear() if objects are ready to delete
+        void advance(ref_ptr<FrameStamp> frameStamp);
+
+        /// add an object to be deleted once retainForFrameCount frames have passed
+        void add(ref_ptr<Object> object);
+
+        /// move a batch of objects on to the queue
+        void add(ObjectsToDelete& objectsToDelete);
+
+        /// wait until objects are ready to delete, the status is no longer active or release() is called, then delete the ready objects
+        void wait_then_clear();
+
+        /// release the thread waiting in wait_then_clear(), or the next call to it if none is waiting, so that a thread servicing the queue with its own ActivityStatus can exit
+        void release();
+
+        /// delete all objects regardless of the frames they were added in
+        void clear();
+
+        size_t size() const;
+
+        /// designate the current thread so that objects whose reference count reaches zero on it are added to queue rather than deleted inline,
+        /// moving the destructors, and any cascade of them through a detached subgraph, off the thread. Pass null to restore inline deletion.
+        /// The queue must be serviced by a thread calling wait_then_clear().
+        static void deferDeletesOnCurrentThread(ref_ptr<DeleteQueue> queue);
+
+        /// return the DeleteQueue assigned to the current thread by deferDeletesOnCurrentThread(), or null if deletes are done inline.
+        static DeleteQueue* currentThreadDeleteQueue();
+
+        /// called by Object::_attemptDelete(), add the object to the current thread's DeleteQueue if one is assigned and active, returns true if the deletion has been deferred.
+        static bool deferDelete(const Object* object);
+
+    protected:
+        virtual ~DeleteQueue();
+
+        bool _readyToDelete() const { return !_objectsToDelete.empty() && (frameCount.load() - _objectsToDelete.front().frameCount) > retainForFrameCount; }
+
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        ObjectsToDelete _objectsToDelete;
+        ref_ptr<ActivityStatus> _status;
+        bool _releaseRequested = false;
+    };
+    VSG_type_name(vsg::DeleteQueue);
+
+} // namespace vsg
@@ -0,0 +1,78 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/GraphicsPipeline.h>
+
+#include <map>
+#include <set>
+
+namespace vsg
+{
+
+    // forward declare
+    class Node;
+
+    /// DepthPrePass records the designated bins of a View twice, first with depth only variants of their graphics pipelines to lay down the nearest depth,
+    /// then with depth equal variants so that expensive fragment shading is only run once per pixel.
+    /// Only opaque pipelines, those with depth testing and no blending, get variants. Elements with other pipelines are left out of the depth only pass and recorded as normal in the main pass.
+    /// Assigning a STATE_SORTED sortOrder to the designated bins gives front to back ordering within each state group, reducing overdraw further.
+    /// Assign to View::depthPrePass and call add(..) on the opaque subgraphs before the View is compiled.
+    class VSG_DECLSPEC DepthPrePass : public Inherit<Object, DepthPrePass>
+    {
+    public:
+        DepthPrePass();
+
+        /// numbers of the View's bins to record with the depth pre-pass
+        std::set<int32_t> binNumbers;
+
+        /// keep the fragment shader in the depth only pipelines, required when fragment shaders discard fragments, such as for alpha tested materials
+        bool keepFragmentShader = false;
+
+        struct Variants
+        {
+            ref_ptr<BindGraphicsPipeline> depthOnly;
+            ref_ptr<BindGraphicsPipeline> depthEqual;
+        };
+
+        /// variants of each opaque pipeline, keyed by the scene graph's BindGraphicsPipeline
+        std::map<const StateCommand*, Variants> variants;
+
+        /// create variants for the BindGraphicsPipeline, return false if the pipeline isn't opaque
+        virtual bool add(const BindGraphicsPipeline& bindPipeline);
+
+        /// create variants for the BindGraphicsPipelines of the StateGroups in the subgraph, return the number of pipelines with variants
+        size_t add(const Node& subgraph);
+
+        /// return the state command to record in place of command, nullptr if the depth only pass should skip the subgraph using it
+        const StateCommand* variant(const StateCommand* command, bool depthOnly) const
+        {
+            // only pipelines are replaced
+            if (command->slot != 0) return command;
+
+            if (auto itr = variants.find(command); itr != variants.end())
+                return depthOnly ? itr->second.depthOnly.get() : itr->second.depthEqual.get();
+            else
+                return depthOnly ? nullptr : command;
+        }
+
+        /// visit the variants so that the CompileTraversal compiles them along with the View
+        void traverse(Visitor& visitor) override;
+        void traverse(ConstVisitor& visitor) const override;
+
+    protected:
+        virtual ~DepthPrePass();
+    };
+    VSG_type_name(vsg::DepthPrePass);
+
+} // namespace vsg
@@ -0,0 +1,103 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RenderGraph.h>
+#include <vsg/commands/SetScissor.h>
+#include <vsg/commands/SetViewport.h>
+
+namespace vsg
+{
+
+    /// DynamicResolution renders a View into an offscreen framebuffer whose render area is scaled to keep the GPU time of rendering it within targetFrameTime,
+    /// then blits the rendered region to fill the Window's current swapchain image. Add it to a CommandGraph in place of the Window's RenderGraph.
+    /// The GPU times are read from the RecordTraversal's FrameStatistics, with FrameStatistics::recordGpuTimings enabled automatically.
+    /// The viewport and scissor are set with vkCmdSetViewport/vkCmdSetScissor so the scene's GraphicsPipelines must enable VK_DYNAMIC_STATE_VIEWPORT and VK_DYNAMIC_STATE_SCISSOR
+    /// via a DynamicState, and the Window must be created with VK_IMAGE_USAGE_TRANSFER_DST_BIT set in WindowTraits::swapchainPreferences.imageUsage.
+    class VSG_DECLSPEC DynamicResolution : public Inherit<Node, DynamicResolution>
+    {
+    public:
+        DynamicResolution(ref_ptr<Window> in_window, ref_ptr<View> in_view);
+
+        template<class N, class V>
+        static void t_traverse(N& node, V& visitor)
+        {
+            if (node.renderGraph) node.renderGraph->accept(visitor);
+        }
+
+        void traverse(Visitor& visitor) override { t_traverse(*this, visitor); }
+        void traverse(ConstVisitor& visitor) const override { t_traverse(*this, visitor); }
+
+        /// adjust the scale, record the offscreen renderGraph and blit the result to the Window's swapchain image
+        void accept(RecordTraversal& recordTraversal) const override;
+
+        ref_ptr<Window> window;
+
+        /// offscreen RenderGraph that the View is rendered with, its framebuffer is reallocated when the Window is resized
+        ref_ptr<RenderGraph> renderGraph;
+
+        /// GPU time of the offscreen renderGraph, in milliseconds, that the scale is adjusted to meet
+        double targetFrameTime = 1000.0 / 60.0;
+
+        /// scale of the render area relative to the Window's extent, adjusted each frame when automatic is true
+        double scale = 1.0;
+        double minimumScale = 0.5;
+        double maximumScale = 1.0; ///< values above 1.0 supersample, the offscreen framebuffer is allocated at maximumScale times the Window's extent
+
+        /// when false the scale is left as set by the application
+        bool automatic = true;
+
+        /// hysteresis band, the scale is only changed when the smoothed GPU time is above decreaseThreshold or below increaseThreshold times the targetFrameTime
+        double decreaseThreshold = 0.95;
+        double increaseThreshold = 0.75;
+
+        /// largest change of scale made by a single adjustment
+        double maximumScaleStep = 0.1;
+
+        /// number of GPU timings to wait after an adjustment before adjusting again, so that the timings reflect the new scale
+        uint32_t adjustmentInterval = 8;
+
+        /// weight of the latest GPU timing in the exponentially smoothed GPU time
+        double smoothing = 0.25;
+
+        /// filter used when blitting the render area to the swapchain image
+        VkFilter filter = VK_FILTER_LINEAR;
+
+        /// update the smoothed GPU time with the latest GPU timing of the renderGraph and adjust the scale when it's outside the hysteresis band
+        virtual void adjustScale(double gpuFrameTime);
+
+        /// return the current size of the render area
+        VkExtent2D getRenderExtent() const;
+
+        /// return the exponentially smoothed GPU time of the renderGraph, in milliseconds
+        double getSmoothedFrameTime() const { return _smoothedFrameTime; }
+
+    protected:
+        virtual ~DynamicResolution();
+
+        void _createAttachments(const VkExtent2D& windowExtent);
+        void _update(RecordTraversal& recordTraversal);
+
+        ref_ptr<RenderPass> _renderPass;
+        ref_ptr<ImageView> _colorImageView;
+        ref_ptr<SetViewport> _setViewport;
+        ref_ptr<SetScissor> _setScissor;
+
+        VkExtent2D _windowExtent = {0, 0};
+        uint64_t _timingsCount = 0;
+        uint32_t _timingsSinceAdjustment = 0;
+        double _smoothedFrameTime = 0.0;
+    };
+    VSG_type_name(vsg::DynamicResolution);
+
+} // namespace vsg
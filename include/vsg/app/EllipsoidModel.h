@@ -51,9 +51,22 @@ namespace vsg
         /// latitude and longitude in degrees, altitude in metres, ECEF coords in metres.
         dvec3 convertECEFToLatLongAltitude(const dvec3& ecef) const;
 
+        /// convert count latitude, longitude, altitude coords to ECEF coords.
+        void convertLatLongAltitudeToECEF(const dvec3* lla, dvec3* ecef, size_t count) const;
+
+        /// convert a grid of latitudes and longitudes, in degrees, at altitude in metres, to ECEF coords, with ecef[r * numLongitudes + c] computed from latitudes[r] and longitudes[c].
+        /// The trigonometric functions are evaluated once per row and column rather than once per coord.
+        void convertLatLongAltitudeGridToECEF(const double* latitudes, size_t numLatitudes, const double* longitudes, size_t numLongitudes, double altitude, dvec3* ecef) const;
+
+        /// convert count ECEF coords to latitude, longitude, altitude coords, using Heikkinen's closed form solution rather than evaluating the trigonometric functions of the single coord conversion.
+        void convertECEFToLatLongAltitude(const dvec3* ecef, dvec3* lla, size_t count) const;
+
         /// latitude and longitude in degrees, altitude in metres
         dmat4 computeLocalToWorldTransform(const dvec3& lla) const;
 
+        /// compute count local to world transforms, sharing the trigonometric functions between the position and orientation of each transform.
+        void computeLocalToWorldTransform(const dvec3* lla, dmat4* localToWorld, size_t count) const;
+
         /// latitude and longitude in degrees, altitude in metres
         dmat4 computeWorldToLocalTransform(const dvec3& lla) const;
 
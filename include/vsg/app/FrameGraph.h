@@ -0,0 +1,138 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RenderGraph.h>
+#include <vsg/commands/Event.h>
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/nodes/Group.h>
+
+#include <map>
+
+namespace vsg
+{
+
+    /// FrameGraphResource is an Image or Buffer that the passes of a FrameGraph read from and write to.
+    class VSG_DECLSPEC FrameGraphResource : public Inherit<Object, FrameGraphResource>
+    {
+    public:
+        FrameGraphResource();
+        FrameGraphResource(ref_ptr<Image> in_image, const VkImageSubresourceRange& in_subresourceRange, bool in_transient = false);
+        FrameGraphResource(ref_ptr<Buffer> in_buffer, VkDeviceSize in_offset = 0, VkDeviceSize in_size = VK_WHOLE_SIZE);
+
+        ref_ptr<Image> image;
+        VkImageSubresourceRange subresourceRange = {0, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+
+        ref_ptr<Buffer> buffer;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = VK_WHOLE_SIZE;
+
+        /// transient images are only used within a frame so their contents are discarded between frames,
+        /// when FrameGraph::aliasTransientImages is enabled they share memory with other transient images whose lifetimes don't overlap.
+        bool transient = false;
+
+        /// imported resources are used outside the FrameGraph, e.g. a swapchain image or a buffer read back by the application, so passes writing to them are never culled.
+        bool imported = false;
+
+        /// layout of the image at the start of each frame, ignored for transient images which always start as VK_IMAGE_LAYOUT_UNDEFINED.
+        VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        /// when set the image is transitioned to finalLayout at the end of the FrameGraph.
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    protected:
+        virtual ~FrameGraphResource();
+    };
+    VSG_type_name(vsg::FrameGraphResource);
+
+    /// FrameGraphAccess declares how a FrameGraphPass reads or writes a FrameGraphResource.
+    struct FrameGraphAccess
+    {
+        ref_ptr<FrameGraphResource> resource;
+        VkPipelineStageFlags stageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        VkAccessFlags accessMask = 0;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;      // layout the pass requires the image to be in, VK_IMAGE_LAYOUT_UNDEFINED to leave it in its current layout
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED; // layout the pass leaves the image in, i.e. a render pass attachment's finalLayout, VK_IMAGE_LAYOUT_UNDEFINED if unchanged
+        bool write = false;
+    };
+
+    /// FrameGraphPass is a RenderGraph, compute dispatch or other subgraph recorded by a FrameGraph, along with the resources it reads and writes.
+    class VSG_DECLSPEC FrameGraphPass : public Inherit<Object, FrameGraphPass>
+    {
+    public:
+        explicit FrameGraphPass(ref_ptr<Node> in_node = {}, const std::string& in_name = {});
+
+        std::string name;
+        ref_ptr<Node> node;
+
+        std::vector<FrameGraphAccess> accesses;
+
+        /// passes with side effects, such as writing to host visible memory read by the application, are never culled.
+        bool sideEffects = false;
+
+        void addRead(ref_ptr<FrameGraphResource> resource, VkPipelineStageFlags stageMask, VkAccessFlags accessMask, VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED);
+        void addWrite(ref_ptr<FrameGraphResource> resource, VkPipelineStageFlags stageMask, VkAccessFlags accessMask, VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED);
+
+    protected:
+        virtual ~FrameGraphPass();
+    };
+    VSG_type_name(vsg::FrameGraphPass);
+
+    using FrameGraphPasses = std::vector<ref_ptr<FrameGraphPass>>;
+
+    /// FrameGraph is a group that sits above RenderGraphs and compute subgraphs, scheduling the memory barriers and layout transitions between its passes
+    /// from the resources each pass declares it reads and writes, so that hand placed, typically over conservative, PipelineBarriers aren't required.
+    /// Barriers are batched so each pass has at most one PipelineBarrier ahead of it, and when a resource is produced more than one pass ahead of its consumer
+    /// a split barrier using SetEvent/WaitEvents allows the intervening passes to overlap. Passes whose results aren't used are culled and transient images
+    /// with non overlapping lifetimes share memory.
+    /// Call build() once the passes have been set up and before the FrameGraph is compiled, it replaces the FrameGraph's children with the scheduled commands and passes.
+    class VSG_DECLSPEC FrameGraph : public Inherit<Group, FrameGraph>
+    {
+    public:
+        FrameGraph();
+
+        FrameGraphPasses passes;
+
+        /// cull passes that don't contribute to imported resources or have side effects
+        bool cullUnusedPasses = true;
+
+        /// use SetEvent/WaitEvents in place of a PipelineBarrier when there are passes between the producer and consumer of a resource
+        bool splitBarriers = true;
+
+        /// alias the memory of transient images whose lifetimes don't overlap
+        bool aliasTransientImages = true;
+
+        /// return the FrameGraphResource for image, creating one if it hasn't already been used by a pass.
+        ref_ptr<FrameGraphResource> getOrCreateResource(ref_ptr<Image> image, const VkImageSubresourceRange& subresourceRange);
+
+        /// add a pass for renderGraph, declaring its framebuffer attachments as written, and read when loaded, with the layouts taken from the RenderPass.
+        /// Attachments that are neither loaded nor stored, or have VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT usage, are marked as transient so that their memory can be aliased.
+        ref_ptr<FrameGraphPass> addRenderGraph(ref_ptr<RenderGraph> renderGraph, const std::string& name = {});
+
+        /// schedule the passes and barriers, replacing the children of the FrameGraph, requires device for creating Events when splitBarriers is enabled.
+        void build(Device* device = nullptr);
+
+        /// passes recorded after culling, assigned by build()
+        FrameGraphPasses activePasses;
+
+        /// number of barriers scheduled by build(), each PipelineBarrier or WaitEvents counts as one.
+        uint32_t numBarrierCommands = 0;
+
+    protected:
+        virtual ~FrameGraph();
+
+        std::map<const Image*, ref_ptr<FrameGraphResource>> _resources;
+    };
+    VSG_type_name(vsg::FrameGraph);
+
+} // namespace vsg
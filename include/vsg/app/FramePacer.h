@@ -0,0 +1,63 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Inherit.h>
+#include <vsg/ui/UIEvent.h>
+
+namespace vsg
+{
+
+    // forward declare
+    class Viewer;
+
+    /// FramePacer reduces input to photon latency by delaying the start of each frame so that events are polled and the update and record traversals run
+    /// just before the frame is needed, rather than queuing up frames as fast as the swapchain allows.
+    /// When the windows' devices have VK_KHR_present_wait enabled, see WindowTraits::presentWait, the presentation of the previous frame is waited upon and
+    /// the next frame is started so its predicted completion lands just before the following present, otherwise only the GPU completion of the previous frame
+    /// is waited upon and frames are paced to the targetFrameTime.
+    class VSG_DECLSPEC FramePacer : public Inherit<Object, FramePacer>
+    {
+    public:
+        /// target time between frames in seconds, 0 to use the measured interval between presents.
+        double targetFrameTime = 0.0;
+
+        /// time in seconds left between the predicted completion of a frame and its deadline, to absorb variation in frame times.
+        double margin = 0.002;
+
+        /// weighting of each new measurement when smoothing frameInterval and frameDuration.
+        double smoothing = 0.1;
+
+        /// maximum time in nanoseconds to wait for the previous frame to complete.
+        uint64_t timeout = 100000000;
+
+        /// smoothed time in seconds between the completion of consecutive frames.
+        double frameInterval = 0.0;
+
+        /// smoothed time in seconds from the start of a frame to its rendering being completed by the GPU.
+        double frameDuration = 0.0;
+
+        /// time in seconds from the start of the previous frame, when its events were polled, to it being presented, or completed by the GPU when VK_KHR_present_wait isn't available.
+        double latency = 0.0;
+
+        /// wait for the previous frame to complete and then until the next frame should start, called by Viewer::advanceToNextFrame() before polling events.
+        virtual void wait(Viewer& viewer);
+
+    protected:
+        bool _frameStarted = false;
+        time_point _frameStart;
+        time_point _previousCompletion;
+    };
+    VSG_type_name(vsg::FramePacer);
+
+} // namespace vsg
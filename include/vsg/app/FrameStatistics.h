@@ -0,0 +1,204 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/core/Inherit.h>
+#include <vsg/ui/UIEvent.h>
+#include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/vulkan.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class Device;
+
+    /// Timings is a ring buffer of the most recent durations, in milliseconds, of a stage of the frame.
+    /// A single thread adds durations without locking while any thread may read them, so it can be queried at any point to update a HUD or to log percentiles.
+    class VSG_DECLSPEC Timings : public Inherit<Object, Timings>
+    {
+    public:
+        Timings(const std::string& in_name, size_t in_capacity);
+
+        const std::string name;
+
+        /// add a duration, must only be called from one thread at a time.
+        void add(double milliseconds);
+
+        /// add the duration since start
+        void add(clock::time_point start) { add(std::chrono::duration<double, std::milli>(clock::now() - start).count()); }
+
+        /// maximum number of durations retained
+        size_t capacity() const { return _capacity; }
+
+        /// number of durations currently retained
+        size_t size() const;
+
+        /// total number of durations added
+        uint64_t count() const { return _count.load(); }
+
+        /// most recent duration, 0.0 if none have been added
+        double latest() const;
+
+        /// copy the retained durations, oldest first
+        std::vector<double> values() const;
+
+        double average() const;
+
+        /// return the duration that the specified fraction, 0.0 to 1.0, of the retained durations are less than or equal to.
+        double percentile(double fraction) const;
+
+    protected:
+        virtual ~Timings();
+
+        const size_t _capacity;
+        std::unique_ptr<std::atomic<double>[]> _values;
+        std::atomic_uint64_t _count{0};
+    };
+    VSG_type_name(vsg::Timings);
+
+    /// convenience class for adding the time between construction and destruction to Timings, if the Timings pointer is null nothing is timed.
+    struct ScopedTiming
+    {
+        Timings* timings;
+        clock::time_point start;
+
+        explicit ScopedTiming(Timings* in_timings) :
+            timings(in_timings),
+            start(in_timings ? clock::now() : clock::time_point{}) {}
+
+        ~ScopedTiming()
+        {
+            if (timings) timings->add(start);
+        }
+    };
+
+    /// FrameStatistics collects the CPU time of each stage of the Viewer's frame, the record traversal time of each CommandGraph
+    /// and the GPU time of each RenderGraph, the latter measured using timestamp queries written before and after the render pass.
+    /// Assigned by default to the Viewer, with the Timings for each stage queryable from the application.
+    class VSG_DECLSPEC FrameStatistics : public Inherit<Object, FrameStatistics>
+    {
+    public:
+        explicit FrameStatistics(size_t in_capacity = 240);
+
+        /// number of frames retained by each of the Timings
+        const size_t capacity;
+
+        /// when true RenderGraphs write timestamps to measure their GPU time, requires queues that support timestamps
+        bool recordGpuTimings = true;
+
+        /// when true RenderGraphs collect VK_QUERY_TYPE_PIPELINE_STATISTICS results, requires the pipelineStatisticsQuery feature to be enabled on the Device
+        bool recordPipelineStatistics = false;
+
+        /// pipeline statistics query results of a RenderGraph
+        struct PipelineStatistics
+        {
+            uint64_t inputAssemblyVertices = 0;
+            uint64_t inputAssemblyPrimitives = 0;
+            uint64_t vertexShaderInvocations = 0;
+            uint64_t clippingInvocations = 0;
+            uint64_t clippingPrimitives = 0;
+            uint64_t fragmentShaderInvocations = 0;
+            uint64_t computeShaderInvocations = 0;
+
+            PipelineStatistics& operator+=(const PipelineStatistics& rhs);
+        };
+
+        /// totals of the commands recorded and nodes culled by all the CommandGraphs in a frame, along with the pipeline statistics of all the RenderGraphs.
+        /// Pipeline statistics are gathered once the GPU has completed the frame so are those that became available during the frame.
+        struct Counters
+        {
+            uint64_t frameCount = 0;
+            CommandBuffer::RecordStatistics record;
+            RecordTraversal::CullStatistics cull;
+            PipelineStatistics pipeline;
+        };
+
+        /// return the Counters of the most recently completed frame, suitable for driving automatic quality tuning
+        Counters latestCounters() const;
+
+        /// return the most recent pipeline statistics of a RenderGraph
+        PipelineStatistics pipelineStatistics(const Object* renderGraph) const;
+
+        /// called by the CommandGraph once it has recorded its CommandBuffer
+        void addCounters(const CommandBuffer::RecordStatistics& record, const RecordTraversal::CullStatistics& cull);
+
+        /// called by the Viewer at the start of each frame to complete the Counters of the previous frame
+        void advanceCounters(uint64_t frameCount);
+
+        enum Stage
+        {
+            FRAME,                ///< time between the start of successive frames
+            ACQUIRE,              ///< Viewer::acquireNextFrame(), including waiting for swapchain images
+            EVENTS,               ///< Viewer::handleEvents()
+            DATABASE_PAGER_MERGE, ///< merging of subgraphs loaded by the DatabasePager
+            UPDATE,               ///< Viewer::update(), excluding DATABASE_PAGER_MERGE
+            RECORD_AND_SUBMIT,    ///< Viewer::recordAndSubmit(), with threading this is the time that the viewer thread waits for the frame's submission
+            PRESENT,              ///< Viewer::present()
+            NUM_STAGES
+        };
+
+        Timings& stage(Stage s) { return *_stages[s]; }
+        const Timings& stage(Stage s) const { return *_stages[s]; }
+
+        /// get or create the Timings for the CPU time to record a CommandGraph
+        ref_ptr<Timings> recordTimings(const Object* commandGraph);
+
+        /// get or create the Timings for the GPU time of a RenderGraph
+        ref_ptr<Timings> gpuTimings(const Object* renderGraph);
+
+        /// return the sum of the most recent GPU times, in milliseconds, of all the RenderGraphs
+        double latestGpuTime() const;
+
+        /// return all the Timings, the stages first followed by the CommandGraph and RenderGraph Timings
+        std::vector<ref_ptr<Timings>> getTimings() const;
+
+        /// called by RenderGraph before beginning its render pass, gathers the GPU time from a previous frame and writes the start timestamp.
+        void beginGpuTiming(const Object* renderGraph, CommandBuffer& commandBuffer, uint64_t frameCount);
+
+        /// called by RenderGraph after ending its render pass, writes the end timestamp.
+        void endGpuTiming(const Object* renderGraph, CommandBuffer& commandBuffer, uint64_t frameCount);
+
+        /// write the latest, average, 50th, 95th and 99th percentile durations of each of the Timings
+        void report(std::ostream& out) const;
+
+    protected:
+        virtual ~FrameStatistics();
+
+        struct GpuTimer;
+
+        GpuTimer* _gpuTimer(const Object* renderGraph, CommandBuffer& commandBuffer);
+        ref_ptr<Timings> _getOrCreateTimings(std::map<const Object*, ref_ptr<Timings>>& timingsMap, const char* prefix, const Object* object);
+
+        std::vector<ref_ptr<Timings>> _stages;
+
+        mutable std::mutex _mutex;
+        std::map<const Object*, ref_ptr<Timings>> _recordTimings;
+        std::map<const Object*, ref_ptr<Timings>> _gpuTimings;
+        std::map<const Object*, std::unique_ptr<GpuTimer>> _gpuTimers;
+        std::map<const Object*, PipelineStatistics> _pipelineStatistics;
+
+        Counters _pendingCounters;
+        Counters _latestCounters;
+    };
+    VSG_type_name(vsg::FrameStatistics);
+
+} // namespace vsg
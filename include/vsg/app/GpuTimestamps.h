@@ -0,0 +1,74 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/FrameStatistics.h>
+
+namespace vsg
+{
+
+    /// GpuTimestamps manages a ring of timestamp query pools, one for each frame that may be in flight, used to measure the GPU time of
+    /// subgraphs such as InstrumentationNodes with gpuTiming enabled. Owned by the CommandGraph and assigned to its RecordTraversal,
+    /// the results of a frame are gathered when its query pool is next reused so recording never waits on the GPU.
+    class VSG_DECLSPEC GpuTimestamps : public Inherit<Object, GpuTimestamps>
+    {
+    public:
+        explicit GpuTimestamps(uint32_t in_numFrames = 4);
+
+        /// number of query pools in the ring, must be more than the number of frames that can be in flight.
+        const uint32_t numFrames;
+
+        /// initial number of queries in each query pool, pools are grown when a frame requires more.
+        uint32_t initialQueryCount = 64;
+
+        /// called by CommandGraph at the start of its command buffer, outside of any render pass, to gather the results
+        /// written when this frame's query pool was last used and reset its queries.
+        void beginFrame(CommandBuffer& commandBuffer, uint64_t frameCount);
+
+        /// write the start timestamp of a region, whose GPU time will be added to timings once available.
+        /// Returns the reference to pass to end(), 0 if the region isn't being timed.
+        uint32_t begin(CommandBuffer& commandBuffer, ref_ptr<Timings> timings);
+
+        /// write the end timestamp of a region started with begin()
+        void end(CommandBuffer& commandBuffer, uint32_t reference);
+
+    protected:
+        virtual ~GpuTimestamps();
+
+        struct Region
+        {
+            ref_ptr<Timings> timings;
+            uint32_t query = 0;
+        };
+
+        struct Frame
+        {
+            VkQueryPool queryPool = VK_NULL_HANDLE;
+            uint32_t capacity = 0;
+            uint32_t used = 0;
+            std::vector<Region> regions;
+        };
+
+        void _collect(Frame& frame);
+
+        std::mutex _mutex;
+        ref_ptr<Device> _device;
+        uint64_t _timestampMask = 0;
+        double _timestampPeriod = 1.0;
+        uint32_t _requiredCount = 0;
+        std::vector<Frame> _frames;
+        Frame* _current = nullptr;
+    };
+    VSG_type_name(vsg::GpuTimestamps);
+
+} // namespace vsg
@@ -0,0 +1,79 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/FrameStatistics.h>
+#include <vsg/app/View.h>
+#include <vsg/io/DatabasePager.h>
+
+namespace vsg
+{
+
+    /// LODScaleController is an update Operation that adjusts the View::lodBias of its views to keep the frame time within targetFrameTime,
+    /// smoothly switching to lower detail LOD and PagedLOD children when frames take too long and back to higher detail when there's headroom.
+    /// When a DatabasePager is assigned its number of active requests is used to raise View::requestLodBias, so fewer high res tiles are requested while the pager is saturated.
+    /// Usage: viewer->addUpdateOperation(LODScaleController::create(viewer->frameStatistics, viewer->recordAndSubmitTasks[0]->databasePager, views), UpdateOperations::ALL_FRAMES);
+    class VSG_DECLSPEC LODScaleController : public Inherit<Operation, LODScaleController>
+    {
+    public:
+        LODScaleController(ref_ptr<FrameStatistics> in_frameStatistics, ref_ptr<DatabasePager> in_databasePager = {}, const std::vector<ref_ptr<View>>& in_views = {});
+
+        ref_ptr<FrameStatistics> frameStatistics;
+        ref_ptr<DatabasePager> databasePager;
+        std::vector<ref_ptr<View>> views;
+
+        /// optional Timings to control, such as FrameStatistics::gpuTimings(renderGraph) when vsync keeps the frame time at the refresh period, if not set the FrameStatistics::FRAME stage is used.
+        ref_ptr<Timings> timings;
+
+        /// frame time, in milliseconds, to keep the timings within
+        double targetFrameTime = 1000.0 / 60.0;
+
+        /// hysteresis band, lodBias is only changed when the smoothed frame time is above decreaseThreshold or below increaseThreshold times the targetFrameTime
+        double decreaseThreshold = 1.0;
+        double increaseThreshold = 0.8;
+
+        /// weight of the latest timing in the exponentially smoothed frame time
+        double smoothing = 0.1;
+
+        /// proportion by which lodBias is changed on each frame outside the hysteresis band
+        double adjustmentRate = 0.02;
+
+        double minimumLodBias = 1.0;
+        double maximumLodBias = 4.0;
+
+        /// number of DatabasePager::numActiveRequests above which the pager is considered saturated
+        uint32_t saturatedActiveRequests = 32;
+
+        /// requestLodBias assigned when the pager has twice saturatedActiveRequests active, scaled linearly from 1.0 at saturatedActiveRequests
+        double saturatedRequestLodBias = 2.0;
+        double maximumRequestLodBias = 4.0;
+
+        /// current biases, assigned to the views on each run()
+        double lodBias = 1.0;
+        double requestLodBias = 1.0;
+
+        /// update the smoothed frame time and pager load, adjust the biases and assign them to the views
+        void run() override;
+
+        /// return the exponentially smoothed frame time, in milliseconds
+        double getSmoothedFrameTime() const { return _smoothedFrameTime; }
+
+    protected:
+        virtual ~LODScaleController();
+
+        uint64_t _timingsCount = 0;
+        double _smoothedFrameTime = 0.0;
+    };
+    VSG_type_name(vsg::LODScaleController);
+
+} // namespace vsg
@@ -0,0 +1,150 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/nodes/Node.h>
+#include <vsg/state/BufferInfo.h>
+#include <vsg/state/DescriptorSet.h>
+#include <vsg/threading/OperationThreads.h>
+#include <vsg/vk/CommandPool.h>
+#include <vsg/vk/Context.h>
+#include <vsg/vk/Fence.h>
+
+#include <list>
+#include <map>
+#include <ostream>
+
+namespace vsg
+{
+
+    /// MemoryDefragmenter incrementally compacts the device Buffers used by a scene graph, relocating the static buffer allocations held in sparsely occupied Buffers
+    /// into densely packed ones using GPU copies, then updating the BufferInfo, commands and descriptor sets that reference them so the sparse Buffers and
+    /// their DeviceMemory can be freed. run() should be called once per frame during the update phase, typically by adding the MemoryDefragmenter to the
+    /// Viewer's update operations with viewer->addUpdateOperation(memoryDefragmenter, vsg::UpdateOperations::ALL_FRAMES).
+    /// Only allocations whose references are all found in the scene graph and whose Buffer was created with VK_BUFFER_USAGE_TRANSFER_SRC_BIT are relocated,
+    /// Images are bound directly to DeviceMemory and referenced by ImageViews so aren't relocated.
+    class VSG_DECLSPEC MemoryDefragmenter : public Inherit<Operation, MemoryDefragmenter>
+    {
+    public:
+        MemoryDefragmenter(ref_ptr<Device> in_device, ref_ptr<Node> in_scene);
+
+        struct Statistics
+        {
+            size_t numBuffers = 0;
+            size_t numDeviceMemory = 0;
+            VkDeviceSize totalBufferSize = 0;
+            VkDeviceSize reservedSize = 0;
+            VkDeviceSize availableSize = 0;
+            VkDeviceSize largestAvailableSize = 0;
+
+            /// proportion of the Buffer memory that is reserved
+            double occupancy() const { return totalBufferSize > 0 ? static_cast<double>(reservedSize) / static_cast<double>(totalBufferSize) : 1.0; }
+
+            /// 0.0 when all the available memory is in one contiguous block, approaching 1.0 as the available memory is split into many small blocks
+            double fragmentation() const { return availableSize > 0 ? 1.0 - static_cast<double>(largestAvailableSize) / static_cast<double>(availableSize) : 0.0; }
+
+            void report(std::ostream& out) const;
+        };
+
+        ref_ptr<Device> device;
+        ref_ptr<Node> scene;
+
+        /// Context used to reserve the compacted Buffers and allocate replacement descriptor sets
+        ref_ptr<Context> context;
+
+        /// additional MemoryBufferPools, such as the Context::deviceMemoryBufferPools used by the CompileManager, that have their unused Buffers and DeviceMemory released after each pass
+        std::vector<ref_ptr<MemoryBufferPools>> memoryBufferPools;
+
+        /// maximum time in seconds spent relocating allocations in each call to run()
+        double timeBudget = 0.002;
+
+        /// Buffers with an occupancy below this ratio have their allocations relocated
+        double occupancyThreshold = 0.5;
+
+        /// minimum number of frames between the end of one pass and the start of the next
+        uint32_t numFramesBetweenPasses = 600;
+
+        /// number of frames that relocated Buffer slots and descriptor sets are retained for so that command buffers still in flight don't reference released Vulkan objects
+        uint32_t numFramesToRetainReleased = 4;
+
+        /// statistics collected at the start and end of the last completed pass
+        Statistics statisticsBefore;
+        Statistics statisticsAfter;
+
+        /// traverse the scene graph and compute the statistics for the Buffers it references
+        Statistics computeStatistics() const;
+
+        /// relocate allocations from sparsely occupied Buffers within the timeBudget, starting a new pass when required
+        void run() override;
+
+        /// return true if a pass is in progress
+        bool active() const { return !_sources.empty(); }
+
+    protected:
+        virtual ~MemoryDefragmenter();
+
+        struct Reference
+        {
+            ref_ptr<BufferInfo> bufferInfo;
+            uint32_t count = 0;
+            std::vector<ref_ptr<Command>> commands;
+            std::vector<DescriptorSet*> descriptorSets;
+            std::vector<const Descriptor*> descriptors;
+        };
+
+        struct Allocation
+        {
+            ref_ptr<BufferInfo> root;
+            std::vector<Reference*> references;
+        };
+
+        struct Source
+        {
+            ref_ptr<Buffer> buffer;
+            std::vector<Allocation> allocations;
+        };
+
+        struct Collector;
+
+        struct Retired
+        {
+            ref_ptr<Buffer> buffer;
+            VkDeviceSize offset = 0;
+            VkDeviceSize range = 0;
+            ref_ptr<DescriptorSet::Implementation> descriptorSet;
+            uint64_t frameCount = 0;
+        };
+
+        Statistics _computeStatistics(const std::map<BufferInfo*, Reference>& references) const;
+        void _startPass();
+        void _endPass();
+        bool _movable(const Allocation& allocation) const;
+        void _relocate(Source& source);
+
+        uint32_t _queueFamilyIndex = 0;
+        ref_ptr<Queue> _queue;
+        ref_ptr<CommandPool> _commandPool;
+        ref_ptr<Fence> _fence;
+
+        // only accessed from run()
+        std::map<BufferInfo*, Reference> _references;
+        std::map<DescriptorSet*, std::vector<ref_ptr<StateCommand>>> _descriptorSetBinders;
+        std::map<const Descriptor*, uint32_t> _descriptorReferences;
+        std::list<Source> _sources;
+        std::list<Retired> _retired;
+        uint64_t _frameCount = 0;
+        uint64_t _nextPassFrameCount = 0;
+    };
+    VSG_type_name(vsg::MemoryDefragmenter);
+
+} // namespace vsg
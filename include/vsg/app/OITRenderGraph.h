@@ -0,0 +1,105 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RenderGraph.h>
+#include <vsg/app/View.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DescriptorSet.h>
+#include <vsg/utils/ShaderSet.h>
+
+namespace vsg
+{
+
+    /// OITRenderGraph implements weighted blended order independent transparency, "Weighted Blended Order-Independent Transparency", McGuire and Bavoil 2013,
+    /// so transparent geometry can be recorded in any order without sorting artifacts, both between objects and within them.
+    /// The View's subgraph is rendered opaque in subpass 0, then the View's bins are recorded in subpass 1 accumulating premultiplied, depth weighted color
+    /// and revealage against the read only depth attachment, and finally subpass 2 composites the accumulated transparency over the opaque color.
+    /// The transparent bin is set up with NO_SORT as no sorting is required. Pipelines recorded in the View's bins must have a subpass of 1 and write
+    /// the accumulation and revealage attachments, as set up by the createOITPhongShaderSet() and createOITPhysicsBasedRenderingShaderSet() ShaderSets.
+    class VSG_DECLSPEC OITRenderGraph : public Inherit<RenderGraph, OITRenderGraph>
+    {
+    public:
+        OITRenderGraph(ref_ptr<Window> in_window, ref_ptr<View> in_view, int32_t transparentBinNumber = 10, ref_ptr<const Options> options = {});
+
+        enum Attachments : uint32_t
+        {
+            COLOR,
+            ACCUMULATION,
+            REVEALAGE,
+            DEPTH,
+            NUM_ATTACHMENTS
+        };
+
+        static constexpr VkFormat accumulationFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+        static constexpr VkFormat revealageFormat = VK_FORMAT_R16_SFLOAT;
+
+        ref_ptr<View> view;
+
+        /// accumulation, revealage and depth ImageViews, indexed by Attachments, the COLOR entry is unused as it's the Window's swapchain image
+        ImageViews transparencyBuffer;
+
+        /// composite subpass, a full screen triangle that blends the accumulated transparency over the opaque color
+        ref_ptr<StateGroup> compositePass;
+
+        /// input attachment DescriptorSet bound by the compositePass, updated when the transparencyBuffer is recreated
+        ref_ptr<DescriptorSet> transparencyDescriptorSet;
+
+        using RenderGraph::accept;
+
+        void accept(RecordTraversal& recordTraversal) const override;
+
+        /// (re)create the transparencyBuffer images and the framebuffers for each of the Window's swapchain images
+        void createFramebuffers();
+
+    protected:
+        virtual ~OITRenderGraph();
+
+        std::vector<ref_ptr<Framebuffer>> _framebuffers;
+        std::vector<const ImageView*> _swapchainImageViews;
+    };
+    VSG_type_name(vsg::OITRenderGraph);
+
+    /// OITColorBlendState sets up the additive accumulation and multiplicative revealage blending of the OITRenderGraph's transparent subpass,
+    /// keeping it when configureAttachments() is called by the Builder or loaders to request conventional alpha blending.
+    class VSG_DECLSPEC OITColorBlendState : public Inherit<ColorBlendState, OITColorBlendState>
+    {
+    public:
+        OITColorBlendState();
+
+        void configureAttachments(bool blendEnable) override;
+
+    protected:
+        virtual ~OITColorBlendState();
+    };
+    VSG_type_name(vsg::OITColorBlendState);
+
+    /// create a ShaderSet from base, such as the phong or pbr ShaderSet, for pipelines in the OITRenderGraph's transparent subpass.
+    /// base's fragment shader source is adapted to write outColor to the accumulation and revealage attachments, returns null if it can't be adapted.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createOITShaderSet(ref_ptr<ShaderSet> base);
+
+    /// create a ShaderSet for the OITRenderGraph's transparent subpass from the phong ShaderSet.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createOITPhongShaderSet(ref_ptr<const Options> options = {});
+
+    /// create a ShaderSet for the OITRenderGraph's transparent subpass from the pbr ShaderSet.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createOITPhysicsBasedRenderingShaderSet(ref_ptr<const Options> options = {});
+
+    /// create the ShaderSet used by the OITRenderGraph's composite subpass.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createOITCompositeShaderSet(ref_ptr<const Options> options = {});
+
+    /// Convenience function that sets up an OITRenderGraph and associated View to render the specified scene graph from the specified camera view.
+    /// Transparent geometry should be placed under DepthSorted nodes assigned to the transparentBinNumber and built with the OIT ShaderSets.
+    extern VSG_DECLSPEC ref_ptr<OITRenderGraph> createOITRenderGraphForView(ref_ptr<Window> window, ref_ptr<Camera> camera, ref_ptr<Node> scenegraph, bool assignHeadlight = true);
+
+} // namespace vsg
@@ -0,0 +1,114 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+#include <vsg/core/Array.h>
+#include <vsg/core/Inherit.h>
+#include <vsg/maths/mat4.h>
+#include <vsg/maths/sphere.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class Node;
+
+    /// OcclusionCulling provides a CPU hierarchical depth buffer that the RecordTraversal tests the bounding spheres of CullNodes and CullGroups against,
+    /// after they have passed view frustum culling, skipping the subgraphs that are hidden behind nearer geometry.
+    /// The depth buffer is either rasterized each frame from the designated occluder meshes, or assigned from a depth buffer read back from the previous frame.
+    /// Assign to View::occlusionCulling to enable.
+    class VSG_DECLSPEC OcclusionCulling : public Inherit<Object, OcclusionCulling>
+    {
+    public:
+        explicit OcclusionCulling(uint32_t in_width = 256, uint32_t in_height = 128);
+
+        /// Occluder mesh, triangles are only rasterized when they are in front of the near plane, so occluders should be coarse, closed and contained within the geometry they represent.
+        struct Occluder
+        {
+            ref_ptr<const vec3Array> vertices;
+            ref_ptr<const uintArray> indices;
+            dmat4 matrix;
+        };
+
+        /// occluders rasterized into the depth buffer at the start of each frame, when no occluders are assigned the depth buffer assigned by setDepthBuffer() is used
+        std::vector<Occluder> occluders;
+
+        void addOccluder(ref_ptr<const vec3Array> vertices, ref_ptr<const uintArray> indices, const dmat4& matrix = {});
+
+        /// number of consecutive frames that a node must be occluded before it's culled, avoids flicker when nodes are close to the edge of occluders.
+        uint32_t occludedFramesBeforeCulling = 2;
+
+        /// number of frames after which unused per node entries are removed.
+        uint32_t maximumUnusedFrames = 120;
+
+        /// assign a depth buffer, such as one read back from the previous frame, Vulkan depth values are converted to eye space depth using the projection matrix
+        /// and downsampled to the resolution of the depth pyramid keeping the farthest depth.
+        void setDepthBuffer(const float* depth, uint32_t depthWidth, uint32_t depthHeight, const dmat4& projection, const dmat4& view);
+        void setDepthBuffer(const floatArray2D& depth, const dmat4& projection, const dmat4& view) { setDepthBuffer(depth.data(), depth.width(), depth.height(), projection, view); }
+
+        /// prepare for culling a new frame, rasterizing the occluders when assigned. Called by RecordTraversal::apply(const View&).
+        virtual void beginFrame(const dmat4& projection, const dmat4& view, uint64_t frameCount);
+
+        /// return true if the subgraph of the node, with the specified bound in the local coordinates of the modelview matrix, should be culled.
+        /// Thread safe so can be called by the RecordTraversal's cull threads.
+        bool cull(const Node* node, const dsphere& bound, const dmat4& modelview);
+
+        /// return true if the sphere, in the eye coordinates of the current frame, is entirely behind the depth buffer.
+        bool occluded(const dvec3& center, double radius) const;
+
+        uint32_t width() const { return _width; }
+        uint32_t height() const { return _height; }
+
+        /// farthest eye space depth of each texel of the given level of the depth pyramid
+        const std::vector<float>& level(size_t i) const { return _levels[i]; }
+        size_t numLevels() const { return _levels.size(); }
+
+        /// number of nodes tested and culled since the last beginFrame()
+        uint32_t numTested() const { return _numTested.load(); }
+        uint32_t numCulled() const { return _numCulled.load(); }
+
+    protected:
+        virtual ~OcclusionCulling();
+
+        void _rasterizeOccluders(const dmat4& projection, const dmat4& view);
+        void _buildPyramid();
+
+        uint32_t _width;
+        uint32_t _height;
+        std::vector<std::vector<float>> _levels;
+
+        bool _depthValid = false;
+        dmat4 _depthProjection;
+        dmat4 _depthView;
+        dmat4 _currentToDepth;
+
+        struct Entry
+        {
+            uint64_t frameCount = ~uint64_t(0);
+            uint32_t occludedFrames = 0;
+        };
+
+        std::mutex _mutex;
+        std::unordered_map<const Node*, Entry> _entries;
+        uint64_t _frameCount = 0;
+
+        std::atomic_uint _numTested{0};
+        std::atomic_uint _numCulled{0};
+    };
+    VSG_type_name(vsg::OcclusionCulling);
+
+} // namespace vsg
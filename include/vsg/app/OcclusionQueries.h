@@ -0,0 +1,98 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/Buffer.h>
+#include <vsg/vk/CommandBuffer.h>
+
+#include <map>
+#include <mutex>
+
+namespace vsg
+{
+
+    // forward declare
+    class OcclusionQueryNode;
+
+    /// OcclusionQueries manages a ring of occlusion query pools, one for each frame that may be in flight, used by OcclusionQueryNodes to test
+    /// whether their proxy geometry is visible. Owned by the CommandGraph and assigned to its RecordTraversal, the results of a frame are
+    /// gathered when its query pool is next reused so recording never waits on the GPU.
+    /// When VK_EXT_conditional_rendering is enabled on the device the results of the previous frame are also copied on the GPU into a
+    /// predicate buffer so that the current frame can skip rendering the subgraphs of nodes that weren't visible, without waiting for the CPU to see the results.
+    class VSG_DECLSPEC OcclusionQueries : public Inherit<Object, OcclusionQueries>
+    {
+    public:
+        explicit OcclusionQueries(uint32_t in_numFrames = 4);
+
+        /// number of query pools in the ring, must be more than the number of frames that can be in flight.
+        const uint32_t numFrames;
+
+        /// initial number of queries in each query pool, pools are grown when a frame requires more.
+        uint32_t initialQueryCount = 256;
+
+        /// use conditional rendering when VK_EXT_conditional_rendering is enabled on the device.
+        bool conditionalRendering = true;
+
+        /// called by CommandGraph at the start of its command buffer, outside of any render pass, to gather the results of the frame
+        /// that last used this frame's query pool, reset its queries and copy the previous frame's results to the predicate buffer.
+        void beginFrame(CommandBuffer& commandBuffer, uint64_t frameCount);
+
+        /// begin an occlusion query whose result will be passed to the node once available.
+        /// Returns the reference to pass to end(), 0 if no query is available.
+        uint32_t begin(CommandBuffer& commandBuffer, const OcclusionQueryNode& node);
+
+        /// end an occlusion query started with begin()
+        void end(CommandBuffer& commandBuffer, uint32_t reference);
+
+        /// begin conditional rendering using the result of the node's query in the previous frame, for the View currently being recorded.
+        /// Returns false if there is no result to use, or conditional rendering is already active, otherwise endConditionalRendering() must be called.
+        bool beginConditionalRendering(CommandBuffer& commandBuffer, const OcclusionQueryNode& node);
+
+        /// end conditional rendering started with beginConditionalRendering()
+        void endConditionalRendering(CommandBuffer& commandBuffer);
+
+    protected:
+        virtual ~OcclusionQueries();
+
+        using QueryKey = std::pair<const OcclusionQueryNode*, uint32_t>;
+
+        struct Frame
+        {
+            VkQueryPool queryPool = VK_NULL_HANDLE;
+            uint32_t capacity = 0;
+            uint32_t used = 0;
+            uint64_t frameCount = 0;
+            std::vector<ref_ptr<const OcclusionQueryNode>> nodes;
+            std::map<QueryKey, uint32_t> queries;
+
+            // predicates copied from the previous frame's queries
+            ref_ptr<Buffer> predicates;
+            uint32_t predicateCapacity = 0;
+        };
+
+        void _collect(Frame& frame);
+        bool _copyPredicates(CommandBuffer& commandBuffer, Frame& frame, const Frame& previous);
+
+        std::mutex _mutex;
+        ref_ptr<Device> _device;
+        const DeviceExtensions* _extensions = nullptr;
+        uint32_t _requiredCount = 0;
+        std::vector<Frame> _frames;
+        std::vector<uint64_t> _results;
+        Frame* _current = nullptr;
+        const Frame* _previous = nullptr;
+        bool _conditionalRenderingActive = false;
+    };
+    VSG_type_name(vsg::OcclusionQueries);
+
+} // namespace vsg
@@ -0,0 +1,103 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RenderGraph.h>
+#include <vsg/commands/Commands.h>
+#include <vsg/commands/Event.h>
+#include <vsg/commands/PipelineBarrier.h>
+
+#include <functional>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// OffscreenRenderGraph renders to its own color and depth attachments so the Viewer can render without a Window, Surface or Swapchain, such as for server side batch rendering.
+    /// Frames cycle through numFrames color attachments so several frames can be in flight, with the color attachment of each frame copied into a persistently mapped
+    /// host visible buffer after the render pass. Readbacks complete asynchronously, signalled by an Event recorded after the copy, and are delivered to the readbackCallback in frame order.
+    /// numFrames should not exceed the RecordAndSubmitTask's numBuffers so that a color attachment's previous frame has always completed by the time it's reused.
+    /// When exportMemoryHandleTypes is non zero the color attachments are instead allocated as exportable memory, with no readback, so that they can be imported directly
+    /// by a hardware video encoder, such as via CUDA for NVENC or as dma-bufs for VA-API, and completed frames are delivered to the exportCallback. Ownership of a completed
+    /// color attachment is released to VK_QUEUE_FAMILY_EXTERNAL in VK_IMAGE_LAYOUT_GENERAL, it's rendered to again numFrames frames later so the encoder must have finished reading it by then.
+    class VSG_DECLSPEC OffscreenRenderGraph : public Inherit<RenderGraph, OffscreenRenderGraph>
+    {
+    public:
+        OffscreenRenderGraph(ref_ptr<Device> in_device, const VkExtent2D& in_extent, ref_ptr<View> in_view = {}, uint32_t numFrames = 3,
+                             VkFormat in_colorFormat = VK_FORMAT_R8G8B8A8_UNORM, VkFormat in_depthFormat = VK_FORMAT_D32_SFLOAT, VkExternalMemoryHandleTypeFlags in_exportMemoryHandleTypes = 0);
+
+        ref_ptr<Device> device;
+        const VkExtent2D extent;
+        const VkFormat colorFormat;
+        const VkFormat depthFormat;
+        const VkExternalMemoryHandleTypeFlags exportMemoryHandleTypes;
+
+        /// callback invoked with the FrameStamp::frameCount and read back color image of each completed frame.
+        /// The image maps the frame's readback buffer directly so is only valid until the callback returns, copy it if it's required afterwards.
+        /// Called from poll(), or from the record traversal if a frame's color attachment is reused before its readback has been delivered.
+        using ReadbackCallback = std::function<void(uint64_t frameCount, ref_ptr<Data> image)>;
+        ReadbackCallback readbackCallback;
+
+        /// callback invoked with the FrameStamp::frameCount and the index of the exported color attachment of each completed frame, used when exportMemoryHandleTypes is non zero.
+        /// Called from poll(), or from the record traversal if a frame's color attachment is reused before it has been delivered.
+        using ExportCallback = std::function<void(uint64_t frameCount, size_t index)>;
+        ExportCallback exportCallback;
+
+        /// number of color attachments that frames cycle through
+        size_t numFrames() const { return _frames.size(); }
+
+        /// return the color attachment of the specified frame index, when exported its memory is a dedicated allocation of getDeviceMemory(deviceID)->getMemoryRequirements().size bytes.
+        ref_ptr<Image> colorImage(size_t index) const { return _frames[index].colorImage; }
+
+        /// return a POSIX file descriptor for the memory of the specified frame index's color attachment, or -1 if it can't be exported.
+        /// Requires VK_KHR_external_memory_fd, and VK_EXT_external_memory_dma_buf for VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT, to be enabled on the Device.
+        /// Each call returns a new file descriptor owned by the caller, typically each color attachment is imported and registered with the encoder once.
+        int exportMemoryFd(size_t index, VkExternalMemoryHandleTypeFlagBits handleType) const;
+
+        /// invoke the readbackCallback for the frames whose readback has completed, returns the number of frames delivered.
+        /// Typically called each frame after Viewer::recordAndSubmit(), and after Viewer::deviceWaitIdle() to deliver the remaining frames.
+        size_t poll();
+
+        /// return the number of recorded frames whose readback hasn't yet been delivered
+        size_t pending() const;
+
+        using RenderGraph::accept;
+
+        void accept(RecordTraversal& recordTraversal) const override;
+
+    protected:
+        virtual ~OffscreenRenderGraph();
+
+        struct Frame
+        {
+            size_t index = 0;
+            ref_ptr<Image> colorImage;
+            ref_ptr<Framebuffer> framebuffer;
+            ref_ptr<Data> image;
+            ref_ptr<ImageMemoryBarrier> releaseBarrier;
+            ref_ptr<Commands> readbackCommands;
+            ref_ptr<Event> readbackCompleted;
+            uint64_t frameCount = 0;
+            bool pending = false;
+        };
+
+        /// deliver the frame's readback, if wait is true wait for it to complete, returns true if delivered
+        bool _deliver(Frame& frame, bool wait) const;
+
+        mutable std::mutex _mutex;
+        mutable std::vector<Frame> _frames;
+        mutable uint64_t _numRecorded = 0;
+    };
+    VSG_type_name(vsg::OffscreenRenderGraph);
+
+} // namespace vsg
@@ -0,0 +1,109 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RecordSignature.h>
+#include <vsg/core/observer_ptr.h>
+#include <vsg/ui/UIEvent.h>
+
+#include <atomic>
+#include <map>
+
+namespace vsg
+{
+
+    // forward declare
+    class CommandGraph;
+    class Viewer;
+
+    /// thermal status of the device, matching the levels of Android's AThermalStatus, iOS and macOS thermal states are mapped to the nearest level.
+    enum ThermalStatus
+    {
+        THERMAL_STATUS_NONE = 0,
+        THERMAL_STATUS_LIGHT = 1,
+        THERMAL_STATUS_MODERATE = 2,
+        THERMAL_STATUS_SEVERE = 3,
+        THERMAL_STATUS_CRITICAL = 4,
+        THERMAL_STATUS_EMERGENCY = 5,
+        THERMAL_STATUS_SHUTDOWN = 6
+    };
+
+    /// return the current thermal status reported by the operating system, THERMAL_STATUS_NONE where it's not available.
+    /// Uses AThermal_getCurrentThermalStatus() on Android API level 30 and later, and NSProcessInfo thermalState on iOS and macOS.
+    extern VSG_DECLSPEC ThermalStatus getThermalStatus();
+
+    /// PowerManager reduces the power used by a Viewer, typically on battery powered mobile devices, by rendering on demand and capping the frame rate as the device heats up.
+    /// When renderOnDemand is enabled Viewer::advanceToNextFrame() sleeps on the windows' event queues until a frame is needed - when there are events to handle, requestFrame() has been called,
+    /// the RecordSignature of a CommandGraph has changed since the last frame, such as from camera, transform or Data changes, the DatabasePager has loaded subgraphs to merge or there are update operations to run.
+    /// While the DatabasePager has reads in progress the viewer wakes every idlePollInterval to check for subgraphs to merge, otherwise it sleeps without a timeout until woken by
+    /// window events, requestFrame() or Viewer::addUpdateOperation().
+    /// Assign to Viewer::powerManager.
+    class VSG_DECLSPEC PowerManager : public Inherit<Object, PowerManager>
+    {
+    public:
+        /// when true only render frames when they are needed.
+        bool renderOnDemand = true;
+
+        /// number of frames rendered after the last change, so that effects that depend on previous frames settle.
+        uint32_t framesAfterChange = 1;
+
+        /// time in seconds between checking for loaded subgraphs to merge while the DatabasePager has reads in progress and no frame is needed.
+        double idlePollInterval = 0.01;
+
+        /// maximum time in seconds between frames when no frame is needed, 0 to not render until one is.
+        double maximumIdleTime = 0.0;
+
+        /// maximum frame rate, 0 for no limit.
+        double maximumFrameRate = 0.0;
+
+        /// frame rate limits applied at and above each thermal status.
+        std::map<ThermalStatus, double> thermalFrameRateLimits{{THERMAL_STATUS_MODERATE, 30.0}, {THERMAL_STATUS_SEVERE, 20.0}, {THERMAL_STATUS_CRITICAL, 10.0}, {THERMAL_STATUS_EMERGENCY, 5.0}};
+
+        /// time in seconds between querying the thermal status.
+        double thermalQueryInterval = 1.0;
+
+        /// most recently queried thermal status.
+        ThermalStatus thermalStatus = THERMAL_STATUS_NONE;
+
+        /// request that a frame is rendered, may be called from any thread, such as when data loaded by the application is ready to display.
+        /// Wakes the viewer if it's waiting for a frame to be needed.
+        void requestFrame();
+
+        /// return the current frame rate limit in frames per second, 0 for no limit.
+        double frameRateLimit() const;
+
+        /// return true if a new frame is needed.
+        virtual bool frameRequired(Viewer& viewer);
+
+        /// wait until a frame is needed and the frame rate limit allows it, gathering the viewer's window events while waiting.
+        /// Called by Viewer::advanceToNextFrame() after polling events, returns false if the viewer is no longer active.
+        virtual bool wait(Viewer& viewer);
+
+    protected:
+        /// return true if any of the CommandGraph's RecordSignatures have changed since last called.
+        bool _signaturesChanged(Viewer& viewer);
+
+        /// return the time in seconds to wait for events before checking again whether a frame is needed, negative to wait until woken.
+        double _idleTimeout(Viewer& viewer) const;
+
+        observer_ptr<Viewer> _viewer;
+
+        std::atomic_bool _frameRequested{true};
+        uint32_t _framesToRender = 0;
+        std::map<const CommandGraph*, ref_ptr<RecordSignature>> _recordSignatures;
+        time_point _previousFrameStart;
+        time_point _previousThermalQuery;
+    };
+    VSG_type_name(vsg::PowerManager);
+
+} // namespace vsg
@@ -0,0 +1,131 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/CompileManager.h>
+#include <vsg/core/observer_ptr.h>
+#include <vsg/io/Options.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/threading/ActivityStatus.h>
+
+#include <atomic>
+#include <list>
+#include <thread>
+
+namespace vsg
+{
+
+    // forward declare
+    class Viewer;
+
+    /// ProgressiveLoader shows a proxy for a model straight away and then reads, compiles and merges the model in the background, so that applications
+    /// don't have to wait for vsg::read() and Viewer::compile() of the whole model before anything is rendered.
+    /// Once read, the model is split top down into subgraphs by detaching the children of its Groups, breadth first and those with the largest bounds first,
+    /// until maxNumSubgraphs is reached. The subgraphs are then compiled in order in batches of up to maxBatchDataSize bytes, and merged back by run()
+    /// at no more than maxMergesPerFrame batches per frame, so the coarse structure of the model appears first and the finer detail fills in.
+    /// Usage:
+    ///     auto loader = vsg::ProgressiveLoader::create(filename, options);
+    ///     scene->addChild(loader->root);
+    ///     ...
+    ///     viewer->compile();
+    ///     loader->start(*viewer);
+    class VSG_DECLSPEC ProgressiveLoader : public Inherit<Operation, ProgressiveLoader>
+    {
+    public:
+        /// create a ProgressiveLoader with root containing the proxy, if no proxy is provided a wireframe box of the model's bounds is shown once the model has been read.
+        explicit ProgressiveLoader(const Path& in_filename, ref_ptr<const Options> in_options = {}, ref_ptr<Node> in_proxy = {});
+
+        Path filename;
+        ref_ptr<const Options> options;
+
+        /// node to add to the scene graph, holds the proxy until the model's first batch is merged and then the model
+        ref_ptr<Group> root;
+
+        /// optional proxy shown while the model is loading, such as a coarse representation of the model
+        ref_ptr<Node> proxy;
+
+        /// when true the proxy is shown until the whole model has been merged rather than just until the first batch has been
+        bool retainProxyUntilComplete = false;
+
+        /// maximum number of subgraphs that the model is split into, exceeded only when the first Group with several children has more children than this
+        uint32_t maxNumSubgraphs = 256;
+
+        /// maximum size in bytes of the Data compiled in each batch, a batch always contains at least one subgraph
+        VkDeviceSize maxBatchDataSize = 16 * 1024 * 1024;
+
+        /// maximum number of compiled batches merged each frame, 0 for no limit
+        uint32_t maxMergesPerFrame = 1;
+
+        /// number of frames that removed proxies are retained for so that command buffers still in flight don't reference released Vulkan objects
+        uint32_t numFramesToRetainRemoved = 4;
+
+        /// start reading the model on a background thread using the viewer's CompileManager, and add the ProgressiveLoader to the viewer's update operations.
+        /// Call after Viewer::compile().
+        void start(Viewer& viewer);
+
+        /// merge compiled batches into the scene graph, called once per frame by the viewer's update operations
+        void run() override;
+
+        /// return true once the whole model has been merged, or the read has failed
+        bool completed() const;
+
+        /// number of subgraphs the model has been split into, 0 until the model has been read
+        std::atomic_uint numSubgraphs{0};
+
+        /// number of subgraphs merged into the scene graph
+        std::atomic_uint numSubgraphsMerged{0};
+
+    protected:
+        virtual ~ProgressiveLoader();
+
+        struct Subgraph
+        {
+            ref_ptr<Group> parent;
+            ref_ptr<Node> node;
+        };
+
+        struct Batch
+        {
+            ref_ptr<Node> proxy;
+            std::vector<Subgraph> subgraphs;
+            CompileResult result;
+        };
+
+        struct Retired
+        {
+            ref_ptr<Node> node;
+            uint64_t frameCount = 0;
+        };
+
+        void _load();
+        void _compile(Batch& batch, const std::vector<ref_ptr<Object>>& objects);
+
+        observer_ptr<Viewer> _viewer;
+        ref_ptr<CompileManager> _compileManager;
+        ref_ptr<ActivityStatus> _status;
+        std::thread _thread;
+
+        mutable std::mutex _mutex;
+        std::list<Batch> _compiled;
+        bool _loadCompleted = false;
+
+        // only accessed from run()
+        ref_ptr<Node> _activeProxy;
+        bool _modelMerged = false;
+        std::atomic_bool _completed{false};
+        std::list<Retired> _retired;
+        uint64_t _frameCount = 0;
+    };
+    VSG_type_name(vsg::ProgressiveLoader);
+
+} // namespace vsg
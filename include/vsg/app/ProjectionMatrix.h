@@ -56,7 +56,11 @@ namespace vsg
         {
         }
 
-        dmat4 transform() const override { return perspective(radians(fieldOfViewY), aspectRatio, nearDistance, farDistance); }
+        dmat4 transform() const override
+        {
+            if (infiniteFar) return infinitePerspective(radians(fieldOfViewY), aspectRatio, nearDistance);
+            return perspective(radians(fieldOfViewY), aspectRatio, nearDistance, farDistance);
+        }
 
         void changeExtent(const VkExtent2D& prevExtent, const VkExtent2D& newExtent) override
         {
@@ -73,6 +77,9 @@ namespace vsg
         double aspectRatio;
         double nearDistance;
         double farDistance;
+
+        /// when true farDistance is ignored and an infinitePerspective() projection is used
+        bool infiniteFar = false;
     };
     VSG_type_name(vsg::Perspective);
 
@@ -194,6 +201,7 @@ namespace vsg
             double nearDistance = farDistance * nearFarRatio;
             //debug("H = ", H, ", l = ", l, ", theta = ", vsg::degrees(theta), ", fd = ", farDistance);
 
+            if (infiniteFar) return infinitePerspective(radians(fieldOfViewY), aspectRatio, nearDistance);
             return perspective(radians(fieldOfViewY), aspectRatio, nearDistance, farDistance);
         }
 
@@ -212,6 +220,10 @@ namespace vsg
         double aspectRatio;
         double nearFarRatio;
         double horizonMountainHeight;
+
+        /// when true the far plane isn't clamped to the horizon so geometry above the horizon, such as satellites or the moon, isn't clipped.
+        /// The near distance is still computed from the horizon distance and nearFarRatio.
+        bool infiniteFar = false;
     };
     VSG_type_name(vsg::EllipsoidPerspective);
 
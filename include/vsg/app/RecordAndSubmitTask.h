@@ -17,6 +17,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/app/Window.h>
 #include <vsg/io/DatabasePager.h>
 #include <vsg/nodes/Group.h>
+#include <vsg/threading/ThreadParker.h>
 #include <vsg/utils/Instrumentation.h>
 #include <vsg/vk/CommandBuffer.h>
 
@@ -41,6 +42,23 @@ namespace vsg
         CommandGraphs commandGraphs; // assign in application setup
         Semaphores signalSemaphores; // connect to Presentation.waitSemaphores
 
+        /// timeline semaphores signalled with the frame count on each submission, used to synchronize with RecordAndSubmitTasks submitting to other queues.
+        std::vector<ref_ptr<TimelineSemaphore>> signalFrameTimelines;
+
+        struct FrameTimelineWait
+        {
+            ref_ptr<TimelineSemaphore> semaphore;
+            uint32_t framesBehind = 0; // 0 waits on the same frame's submission, 1 on the previous frame's etc.
+            VkPipelineStageFlags waitStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        };
+
+        /// timeline semaphores, signalled by another RecordAndSubmitTask's signalFrameTimelines, that submissions wait on.
+        std::vector<FrameTimelineWait> waitFrameTimelines;
+
+        /// RecordAndSubmitTasks that signal binary semaphores in waitSemaphores, as a binary semaphore's signal must be submitted before its wait
+        /// finish() waits for these tasks to have submitted the current frame before submitting, so tasks recorded on different threads still submit in order.
+        std::vector<ref_ptr<RecordAndSubmitTask>> submitAfter;
+
         ref_ptr<TransferTask> earlyTransferTask; // data is updated prior to record traversal so can be transferred before/in parallel to record traversal
         ref_ptr<Semaphore> earlyTransferTaskConsumerCompletedSemaphore;
 
@@ -63,6 +81,12 @@ namespace vsg
         /// hook for assigning Instrumentation to enable profiling of record traversal.
         ref_ptr<Instrumentation> instrumentation;
 
+        /// optional FrameStatistics that the CommandGraphs' record times and RenderGraphs' GPU times are added to
+        ref_ptr<FrameStatistics> frameStatistics;
+
+        /// assign FrameStatistics to the RecordAndSubmitTask and its CommandGraphs
+        void assignFrameStatistics(ref_ptr<FrameStatistics> in_frameStatistics);
+
         /// Convenience method for assigning Instrumentation to the viewer and any associated objects.
         void assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation);
 
@@ -70,6 +94,13 @@ namespace vsg
         size_t _currentFrameIndex;
         std::vector<size_t> _indices;
         std::vector<ref_ptr<Fence>> _fences;
+        uint64_t _frameTimelineValue = 0;
+
+        VkResult _finish(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers);
+        void _submitted();
+
+        std::atomic_uint64_t _numSubmissions{0};
+        ThreadParker _submissionParker;
     };
     VSG_type_name(vsg::RecordAndSubmitTask);
 
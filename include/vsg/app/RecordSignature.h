@@ -0,0 +1,62 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/ConstVisitor.h>
+#include <vsg/core/Inherit.h>
+
+namespace vsg
+{
+
+    /// RecordSignature computes a hash of the parts of a subgraph that affect what a RecordTraversal records -
+    /// the objects traversed, Camera matrices and viewports, View LOD settings, Transform matrices, Switch masks, RenderGraph framebuffers and clears,
+    /// and the ModifiedCount of non dynamic Data. Dynamic Data is excluded as it's copied into existing buffers by the TransferTask.
+    /// Used by CommandGraph::reuseCommandBuffers to decide whether previously recorded command buffers can be resubmitted.
+    /// Subgraphs containing PagedLOD, StreamingTexture, ExecuteCommands or InstrumentationNode are flagged as not reusable as they depend on being recorded every frame,
+    /// as are subgraphs with StateCommands that are still pending compilation, such as a GraphicsPipeline compiled in the background.
+    class VSG_DECLSPEC RecordSignature : public Inherit<ConstVisitor, RecordSignature>
+    {
+    public:
+        RecordSignature();
+
+        uint64_t signature;
+        bool reusable = true;
+
+        /// invalidate all the signatures computed so far, so that reused command buffers are recorded again.
+        /// Used when Vulkan objects referenced by recorded command buffers are replaced without changing the scene graph, such as by the MemoryDefragmenter.
+        static void invalidate();
+
+        /// reset the signature ready for a new traversal
+        void reset();
+
+        /// combine bytes into the signature
+        void add(const void* ptr, size_t size);
+
+        template<typename T>
+        void add(const T& value) { add(&value, sizeof(T)); }
+
+        void apply(const Object& object) override;
+        void apply(const Node& node) override;
+        void apply(const Data& data) override;
+        void apply(const Transform& transform) override;
+        void apply(const Switch& sw) override;
+        void apply(const PagedLOD& plod) override;
+        void apply(const InstrumentationNode& instrumentationNode) override;
+        void apply(const Command& command) override;
+        void apply(const StateGroup& stateGroup) override;
+        void apply(const View& view) override;
+        void apply(const RenderGraph& renderGraph) override;
+    };
+    VSG_type_name(vsg::RecordSignature);
+
+} // namespace vsg
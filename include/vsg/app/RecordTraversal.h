@@ -16,7 +16,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Object.h>
 #include <vsg/core/type_name.h>
 #include <vsg/maths/mat4.h>
+#include <vsg/maths/sphere.h>
+#include <vsg/vk/vulkan.h>
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -27,24 +30,34 @@ namespace vsg
     class Node;
     class Group;
     class QuadGroup;
+    class SpatialGroup;
     class LOD;
     class PagedLOD;
     class StateGroup;
     class CullGroup;
+    class StreamingTexture;
     class CullNode;
+    class OcclusionQueryNode;
     class DepthSorted;
+    class FlattenedSubgraph;
+    class PointCloud;
     class Transform;
     class MatrixTransform;
+    class InstanceNode;
     class TileDatabase;
     class VertexDraw;
     class VertexIndexDraw;
     class Geometry;
     class Command;
     class Commands;
+    class StateCommand;
     class CommandBuffer;
     class State;
     class DatabasePager;
     class FrameStamp;
+    class FrameStatistics;
+    class GpuTimestamps;
+    class OcclusionQueries;
     class CulledPagedLODs;
     class View;
     class Bin;
@@ -58,6 +71,51 @@ namespace vsg
     class CommandGraph;
     class RecordedCommandBuffers;
     class Instrumentation;
+    class OperationThreads;
+    class Latch;
+    struct Operation;
+    class RenderGraph;
+    class CommandPoolRing;
+    class OcclusionCulling;
+    class VisibilityCache;
+    class DepthPrePass;
+
+    /// tags for the core node types that the RecordTraversal dispatches with a switch rather than the virtual accept()/apply() pair,
+    /// assigned by Inherit<> so that subclasses of these types get RecordTag::NONE and continue to use virtual dispatch.
+    enum class RecordTag : uint8_t
+    {
+        NONE = 0,
+        GROUP,
+        QUAD_GROUP,
+        STATE_GROUP,
+        MATRIX_TRANSFORM,
+        CULL_NODE,
+        CULL_GROUP,
+        LOD,
+        VERTEX_INDEX_DRAW,
+        GEOMETRY
+    };
+
+    template<class T>
+    constexpr RecordTag record_tag_v = RecordTag::NONE;
+    template<>
+    constexpr RecordTag record_tag_v<Group> = RecordTag::GROUP;
+    template<>
+    constexpr RecordTag record_tag_v<QuadGroup> = RecordTag::QUAD_GROUP;
+    template<>
+    constexpr RecordTag record_tag_v<StateGroup> = RecordTag::STATE_GROUP;
+    template<>
+    constexpr RecordTag record_tag_v<MatrixTransform> = RecordTag::MATRIX_TRANSFORM;
+    template<>
+    constexpr RecordTag record_tag_v<CullNode> = RecordTag::CULL_NODE;
+    template<>
+    constexpr RecordTag record_tag_v<CullGroup> = RecordTag::CULL_GROUP;
+    template<>
+    constexpr RecordTag record_tag_v<LOD> = RecordTag::LOD;
+    template<>
+    constexpr RecordTag record_tag_v<VertexIndexDraw> = RecordTag::VERTEX_INDEX_DRAW;
+    template<>
+    constexpr RecordTag record_tag_v<Geometry> = RecordTag::GEOMETRY;
 
     VSG_type_name(vsg::RecordTraversal);
 
@@ -84,12 +142,76 @@ namespace vsg
 
         ref_ptr<Instrumentation> instrumentation;
 
+        /// optional FrameStatistics that RenderGraphs write their GPU timings to
+        ref_ptr<FrameStatistics> frameStatistics;
+
+        /// optional GpuTimestamps that InstrumentationNodes with gpuTiming enabled write their timestamps to, assigned by the CommandGraph
+        ref_ptr<GpuTimestamps> gpuTimestamps;
+
+        /// optional OcclusionQueries that OcclusionQueryNodes use to query the visibility of their proxies, assigned by the CommandGraph
+        ref_ptr<OcclusionQueries> occlusionQueries;
+
+        enum CullType
+        {
+            CULL_NODE,
+            CULL_GROUP,
+            LOD_NODE,
+            PAGED_LOD_NODE,
+            DEPTH_SORTED,
+            SPATIAL_GROUP_CHILD,
+            NUM_CULL_TYPES
+        };
+
+        /// number of nodes of each type that were traversed and culled
+        struct CullStatistics
+        {
+            uint64_t traversed[NUM_CULL_TYPES] = {};
+            uint64_t culled[NUM_CULL_TYPES] = {};
+
+            CullStatistics& operator+=(const CullStatistics& rhs)
+            {
+                for (int i = 0; i < NUM_CULL_TYPES; ++i)
+                {
+                    traversed[i] += rhs.traversed[i];
+                    culled[i] += rhs.culled[i];
+                }
+                return *this;
+            }
+        };
+
+        /// cull results since the CommandGraph last started recording, includes the results of the parallel cull traversals.
+        CullStatistics cullStatistics;
+
+        /// number of View traversals after which the storage reserved by the traversal's draw lists and containers had grown,
+        /// only counted in debug builds. Storage is retained between frames so once a scene reaches a steady state this stops increasing.
+        uint32_t numTransientGrowths = 0;
+
         /// Container for CommandBuffers that have been recorded in current frame
         ref_ptr<RecordedCommandBuffers> recordedCommandBuffers;
 
+        /// Optional threads used to cull the children of Groups and QuadGroups in parallel.
+        /// Each thread collects the commands to record, along with their matrices and state, into its own draw list.
+        /// The draw lists are then recorded in order by this RecordTraversal, so the recorded commands match a serial traversal.
+        ref_ptr<OperationThreads> cullThreads;
+
+        /// minimum number of children a Group must have for them to be culled in parallel
+        size_t minimumParallelCullChildren = 4;
+
+        /// maximum number of draw lists to divide a Group's children between, 0 uses std::thread::hardware_concurrency()
+        uint32_t maximumNumCullTasks = 0;
+
+        /// record the subgraph of a RenderGraph, whose render pass has been begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS, into secondary CommandBuffers
+        /// that are then executed in order by the current CommandBuffer. When cullThreads is assigned the draw lists of Groups culled in parallel are also recorded in parallel,
+        /// each into its own secondary CommandBuffer. Used by RenderGraph when RenderGraph::parallelSecondaryCommandBuffers is enabled.
+        void recordSecondaryCommandBuffers(const RenderGraph& renderGraph, VkRenderPass renderPass, VkFramebuffer framebuffer);
+
         /// get the current State object used to track state and projection/modelview matrices for the current subgraph being traversed
         State* getState() { return _state; }
 
+        /// return the state command to push in place of command, differing from command while recording the bins of a View's DepthPrePass, nullptr if the subgraph using it should be skipped.
+        const StateCommand* substituteStateCommand(const StateCommand* command) const { return _depthPrePass ? _substituteStateCommand(command) : command; }
+        bool substitutingStateCommands() const { return _depthPrePass != nullptr; }
+
         /// get the current CommandBuffer for the current subgraph being traversed
         CommandBuffer* getCommandBuffer();
 
@@ -104,15 +226,23 @@ namespace vsg
 
         void apply(const Object& object);
 
+        /// visit a node, calling apply() directly for the core node types identified by Object::recordTag(), and node.accept() for all others
+        void dispatch(const Node& node);
+
         // scene graph nodes
         void apply(const Group& group);
         void apply(const QuadGroup& quadGroup);
+        void apply(const SpatialGroup& spatialGroup);
         void apply(const LOD& lod);
         void apply(const PagedLOD& pagedLOD);
         void apply(const TileDatabase& tileDatabase);
         void apply(const CullGroup& cullGroup);
+        void apply(const StreamingTexture& streamingTexture);
         void apply(const CullNode& cullNode);
+        void apply(const OcclusionQueryNode& occlusionQueryNode);
         void apply(const DepthSorted& depthSorted);
+        void apply(const FlattenedSubgraph& flattenedSubgraph);
+        void apply(const PointCloud& pointCloud);
         void apply(const Switch& sw);
 
         // leaf node
@@ -130,6 +260,7 @@ namespace vsg
         // Vulkan nodes
         void apply(const Transform& transform);
         void apply(const MatrixTransform& mt);
+        void apply(const InstanceNode& instance);
         void apply(const StateGroup& object);
 
         // Commands
@@ -158,6 +289,111 @@ namespace vsg
         int32_t _minimumBinNumber = 0;
         std::vector<ref_ptr<Bin>> _bins;
         ref_ptr<ViewDependentState> _viewDependentState;
+        ref_ptr<OcclusionCulling> _occlusionCulling;
+        ref_ptr<VisibilityCache> _visibilityCache;
+
+        /// non zero when traversing a subgraph whose bound is entirely inside the view frustum, so frustum tests can be skipped
+        uint32_t _insideFrustum = 0;
+
+        /// non zero when traversing the child of an OcclusionQueryNode whose proxy was hidden, so PagedLOD requests are suppressed
+        uint32_t _suppressPagedLODRequests = 0;
+
+        /// number of local frustums pushed by the parent RecordTraversals of a parallel cull, used to decide whether a node is beneath a Transform
+        size_t _inheritedFrustumDepth = 0;
+
+        /// small feature culling, the ratio of a bound's radius to its LOD distance below which it's culled, and the scale from pixels to that ratio for the current viewport
+        double _minimumScreenHeightRatio = 0.0;
+        double _pixelsToScreenHeightRatio = 0.0;
+
+        /// the current View's lodBias and requestLodBias
+        double _lodBias = 1.0;
+        double _requestLodBias = 1.0;
+
+        /// return true if the node passes view frustum and small feature culling, and isn't occluded
+        bool _visible(const Node* node, const dsphere& bound);
+
+        /// as above, setting entirelyInside to true when the bound is entirely inside the view frustum
+        bool _visible(const Node* node, const dsphere& bound, bool& entirelyInside);
+
+        /// return true if the bound is inside or intersects the view frustum, using and updating the View's VisibilityCache when assigned
+        bool _inFrustum(const Node* node, const dsphere& bound, bool& entirelyInside);
+
+        /// record the View's bins, with those designated by View::depthPrePass recorded in a depth only pass first
+        void _recordBins(const View& view);
+
+        /// DepthPrePass used while recording its designated bins, and whether recording the depth only pass or the depth equal pass
+        const DepthPrePass* _depthPrePass = nullptr;
+        bool _depthOnlyPass = false;
+        const StateCommand* _substituteStateCommand(const StateCommand* command) const;
+
+        /// cull the View's subgraph into its SharedCull if not already done this frame, then record the View's visible candidates
+        void _recordSharedCull(const View& view);
+
+        /// cull the children in parallel using cullThreads and record the resulting draw lists, return false if not enough children to cull in parallel
+        bool _parallelCull(const ref_ptr<Node>* children, size_t numChildren);
+
+        /// set up a RecordTraversal used by _parallelCull() to match the state and matrices of the parent RecordTraversal
+        void _initializeCull(const RecordTraversal& parent);
+
+        /// when assigned this RecordTraversal is culling on behalf of a parent RecordTraversal, nodes to record are added to the draw list instead
+        ref_ptr<Bin> _drawList;
+        std::vector<ref_ptr<RecordTraversal>> _cullTraversals;
+
+        // reused by each _parallelCull() so the steady state allocates nothing
+        std::vector<size_t> _cullBoundaries;
+        std::vector<ref_ptr<Operation>> _cullOperations;
+        std::vector<ref_ptr<Operation>> _recordOperations;
+        ref_ptr<Latch> _cullLatch;
+        ref_ptr<Latch> _recordLatch;
+
+        // bins of the Views being traversed, retained between frames to reuse their storage
+        std::vector<std::vector<ref_ptr<Bin>>> _binsStack;
+        size_t _viewDepth = 0;
+
+        /// return the storage reserved by the draw lists and containers used during traversal
+        size_t _reservedSize() const;
+        size_t _previousReservedSize = 0;
+
+        /// true when the draw list contains nodes that touch the parent RecordTraversal's bins or ViewDependentState, so must be recorded by the parent
+        bool _drawListDeferred = false;
+
+        /// time taken to cull each child assigned to this draw list, and the number of draw list entries each added
+        std::vector<double> _drawListCullTimes;
+        std::vector<size_t> _drawListEntries;
+        double _drawListRecordTime = 0.0;
+
+        /// per child cost of previous frames used to balance the ranges of children culled in parallel
+        struct ChildCosts
+        {
+            std::vector<double> costs;
+            uint64_t frameCount = 0;
+        };
+        std::map<const void*, ChildCosts> _childCosts;
+
+        /// divide numChildren into numTasks contiguous ranges of similar cost, returning the numTasks+1 range boundaries
+        void _partition(const ref_ptr<Node>* children, size_t numChildren, size_t numTasks, std::vector<size_t>& boundaries);
+
+        /// update the costs of children from the timings of the cull traversals
+        void _updateChildCosts(const ref_ptr<Node>* children, size_t numChildren, const std::vector<size_t>& boundaries);
+
+        // secondary CommandBuffer recording used by recordSecondaryCommandBuffers()
+        struct SecondaryRecording;
+        SecondaryRecording* _secondaryRecording = nullptr;
+        ref_ptr<CommandPoolRing> _secondaryCommandPoolRing;
+        uint64_t _secondaryFrameCount = 0;
+        ref_ptr<CommandBuffer> _drawListCommandBuffer;
+
+        /// allocate and begin a secondary CommandBuffer, inheriting the view settings of the specified CommandBuffer
+        ref_ptr<CommandBuffer> _beginSecondaryCommandBuffer(const SecondaryRecording& secondaryRecording, CommandBuffer& inherit);
+
+        /// end the current secondary CommandBuffer and begin the next one, used when the commands of draw lists recorded in parallel need to be placed between them
+        void _nextSecondaryCommandBuffer();
+
+        /// assign the CommandBuffer to record to, dirtying the State so that it's all recorded again
+        void _assignCommandBuffer(ref_ptr<CommandBuffer> commandBuffer);
+
+        /// record the draw list into its own secondary CommandBuffer, inheriting the state of the parent
+        void _recordDrawList(const SecondaryRecording& secondaryRecording, CommandBuffer& inherit, const State& parentState);
     };
 
 } // namespace vsg
@@ -64,6 +64,23 @@ namespace vsg
         /// Subpass contents setting passed to vkCmdBeginRenderPass
         VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE;
 
+        /// when true, and the render pass has a single subpass, the subgraph is recorded into secondary CommandBuffers executed in order within the render pass, overriding contents.
+        /// If the RecordTraversal has cullThreads assigned the children of large Groups are partitioned, using the record times of previous frames to balance them,
+        /// and recorded in parallel each into their own secondary CommandBuffer.
+        bool parallelSecondaryCommandBuffers = false;
+
+        /// when true use vkCmdBeginRendering/vkCmdEndRendering in place of vkCmdBeginRenderPass/vkCmdEndRenderPass, requires Vulkan 1.3 or VK_KHR_dynamic_rendering to be enabled.
+        /// The RenderPass is used as the description of the attachment formats, load/store ops and layouts of its first subpass, with the ImageViews taken from the framebuffer or window,
+        /// layout transitions are recorded as explicit image barriers. GraphicsPipelines compiled under the RenderGraph are created with VkPipelineRenderingCreateInfo rather than the VkRenderPass.
+        /// Defaults to the Window's WindowTraits::dynamicRendering setting. Subgraphs are recorded inline, parallelSecondaryCommandBuffers is not used.
+        bool dynamicRendering = false;
+
+        /// optional VK_FORMAT_R8_UINT fragment shading rate image, such as the one computed by vsg::ShadingRateImage, for variable rate shading of the RenderGraph's subgraph.
+        /// Used when dynamicRendering is enabled, each texel gives the shading rate of a fragmentShadingRateTexelSize region and must be in VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR.
+        /// When using render passes add the image to the framebuffer's attachments and reference it from SubpassDescription::fragmentShadingRateAttachments instead.
+        ref_ptr<ImageView> fragmentShadingRateAttachment;
+        VkExtent2D fragmentShadingRateTexelSize = {16, 16};
+
         /// Callback used to automatically update viewports, scissors, renderArea and clears when the window is resized.
         /// By default resize handling is done.
         ref_ptr<WindowResizeHandler> windowResizeHandler;
@@ -74,6 +91,9 @@ namespace vsg
         /// window extent at previous frame, used to track window resizes
         constexpr static uint32_t invalid_dimension = std::numeric_limits<uint32_t>::max();
         mutable VkExtent2D previous_extent = VkExtent2D{invalid_dimension, invalid_dimension};
+
+    protected:
+        void _recordDynamicRendering(RecordTraversal& recordTraversal, const RenderPass& activeRenderPass, const Framebuffer& activeFramebuffer) const;
     };
     VSG_type_name(vsg::RenderGraph);
 
@@ -0,0 +1,72 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/Camera.h>
+#include <vsg/nodes/Bin.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace vsg
+{
+
+    /// SharedCull enables several Views with similar view frusta, such as the tiles of a video wall, to share a single cull traversal of their scene graph.
+    /// The first View recorded each frame culls its subgraph against the SharedCull's camera, which must enclose the view frusta of all the Views sharing it,
+    /// collecting the draw nodes along with their state and matrices into a candidate list. Each View then records from the candidate list,
+    /// culling each candidate against its own view frustum, rather than traversing the whole scene graph.
+    /// LOD selection is made once for the SharedCull's camera so suits Views with similar eye points; DepthSorted nodes and lights
+    /// are culled and binned by each View as they're recorded. Assign the same SharedCull to View::sharedCull of each View, the Views must share the same scene graph.
+    class VSG_DECLSPEC SharedCull : public Inherit<Bin, SharedCull>
+    {
+    public:
+        explicit SharedCull(ref_ptr<Camera> in_camera = {});
+
+        /// camera whose view frustum encloses those of all the Views, if not assigned the camera of the first View recorded each frame is used.
+        ref_ptr<Camera> camera;
+
+        /// serializes the cull, taken by RecordTraversal::apply(const View&) when checking and updating the candidate list
+        std::mutex mutex;
+
+        /// return true if the candidate list needs culling for the specified frame, must be called with the mutex locked.
+        bool requiresCull(uint64_t frameCount) const { return frameCount != _frameCount || size() == 0; }
+
+        /// finish collecting candidates culled with the specified view matrix, must be called with the mutex locked.
+        void culled(uint64_t frameCount, const dmat4& viewMatrix);
+
+        /// record the candidates visible in the RecordTraversal's current view frustum, where viewMatrix is the View's view matrix
+        void record(RecordTraversal& rt, const dmat4& viewMatrix) const;
+
+        /// number of candidates in the list
+        size_t numCandidates() const { return size(); }
+
+    protected:
+        virtual ~SharedCull();
+
+        uint64_t _frameCount = 0;
+        dmat4 _inverseCullView;
+
+        // bounds of each candidate's node in its local coordinate frame, invalid if the candidate mustn't be culled
+        std::vector<dsphere> _bounds;
+
+        // bounds of the candidates' nodes from the previous cull, the ref_ptr prevents a deleted node's address being reused by a new node while its entry remains
+        struct CachedBound
+        {
+            ref_ptr<const Node> node;
+            dsphere bound;
+        };
+        std::unordered_map<const Node*, CachedBound> _boundsCache;
+    };
+    VSG_type_name(vsg::SharedCull);
+
+} // namespace vsg
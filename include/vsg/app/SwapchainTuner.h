@@ -0,0 +1,106 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Inherit.h>
+#include <vsg/ui/UIEvent.h>
+#include <vsg/vk/vulkan.h>
+
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class Viewer;
+
+    /// SwapchainTuner adapts the windows' swapchain present mode and image count, and the number of frames the Viewer lets the CPU get ahead of the GPU,
+    /// to the workload. Each frame it measures the time spent waiting to acquire swapchain images, waiting on the fences of previous frames and the GPU time of
+    /// the RenderGraphs, along with the latency from the start of a frame to the GPU completing it, and every adjustmentInterval frames makes at most one change
+    /// to bring the frame time within targetFrameTime and the latency within maximumLatency. Each change is logged with vsg::info() and appended to decisions.
+    /// Assign to Viewer::swapchainTuner, the acquire and GPU times are read from Viewer::frameStatistics.
+    class VSG_DECLSPEC SwapchainTuner : public Inherit<Object, SwapchainTuner>
+    {
+    public:
+        /// throughput goal, time between frames in milliseconds, 0 to disable changes made to improve throughput.
+        double targetFrameTime = 0.0;
+
+        /// latency goal, time in milliseconds from the start of a frame to the GPU completing it, 0 to disable changes made to reduce latency.
+        double maximumLatency = 0.0;
+
+        /// when true VK_PRESENT_MODE_FIFO_RELAXED_KHR and VK_PRESENT_MODE_IMMEDIATE_KHR may be selected, which can tear.
+        bool allowTearing = false;
+
+        /// range of the number of frames that may be submitted but not yet completed by the GPU, the maximum should not exceed the RecordAndSubmitTasks' number of buffers.
+        uint32_t minimumFramesInFlight = 1;
+        uint32_t maximumFramesInFlight = 3;
+
+        /// range of the swapchain imageCount requested
+        uint32_t minimumImageCount = 2;
+        uint32_t maximumImageCount = 3;
+
+        /// number of frames to measure after a change before considering another
+        uint32_t adjustmentInterval = 60;
+
+        /// weighting of each new measurement when smoothing the measured times.
+        double smoothing = 0.1;
+
+        /// maximum time in nanoseconds to wait for a previous frame to complete.
+        uint64_t timeout = 100000000;
+
+        /// current number of frames in flight, initialized to maximumFramesInFlight on the first update.
+        uint32_t framesInFlight = 0;
+
+        /// smoothed measurements in milliseconds
+        double frameTime = 0.0;
+        double acquireWait = 0.0;
+        double fenceWait = 0.0;
+        double gpuTime = 0.0;
+        double latency = 0.0;
+
+        struct Decision
+        {
+            uint64_t frameCount = 0;
+            VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+            uint32_t imageCount = 0;
+            uint32_t framesInFlight = 0;
+            std::string reason;
+        };
+
+        /// changes made, oldest first
+        std::vector<Decision> decisions;
+
+        /// measure the previous frame, waiting for enough of the previous frames to complete to stay within framesInFlight, and adjust the configuration when due.
+        /// Called by Viewer::advanceToNextFrame() before polling events.
+        virtual void update(Viewer& viewer);
+
+        /// decide whether to change the present mode, image count or frames in flight, returns true if a change was made.
+        virtual bool adjust(Viewer& viewer);
+
+        /// write the current measurements and the decisions made
+        void report(std::ostream& out) const;
+
+    protected:
+        void _smooth(double& value, double sample) const { value = (value == 0.0) ? sample : value + (sample - value) * smoothing; }
+        void _reconfigure(Viewer& viewer, VkPresentModeKHR presentMode, uint32_t imageCount, uint32_t numFramesInFlight, const std::string& reason);
+        void _reset();
+
+        uint32_t _framesSinceAdjustment = 0;
+        std::deque<time_point> _frameStarts;
+    };
+    VSG_type_name(vsg::SwapchainTuner);
+
+} // namespace vsg
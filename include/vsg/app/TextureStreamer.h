@@ -0,0 +1,100 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/CompileManager.h>
+#include <vsg/nodes/StreamingTexture.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <list>
+
+namespace vsg
+{
+
+    /// TextureStreamer compiles the finer mip levels of StreamingTexture nodes in a background thread as the RecordTraversal requests them,
+    /// and keeps the total size of the streamed mip levels within memoryBudget by switching the least recently used StreamingTexture back to their coarse mip levels.
+    /// Compiled mip levels are merged into the scene graph by run(), which should be called once per frame during the update phase, typically by adding the
+    /// TextureStreamer to the Viewer's update operations with viewer->addUpdateOperation(textureStreamer, vsg::UpdateOperations::ALL_FRAMES).
+    class VSG_DECLSPEC TextureStreamer : public Inherit<Operation, TextureStreamer>
+    {
+    public:
+        explicit TextureStreamer(ref_ptr<CompileManager> in_compileManager, VkDeviceSize in_memoryBudget = 256 * 1024 * 1024);
+
+        ref_ptr<CompileManager> compileManager;
+
+        /// maximum total size in bytes of the streamed mip levels
+        VkDeviceSize memoryBudget;
+
+        /// height in pixels of the views, used to convert screen height ratios into the number of texels required
+        double screenHeight = 1080.0;
+
+        /// bias added to the computed mip level, positive values favor coarser mip levels
+        double lodBias = 0.0;
+
+        /// number of frames that evicted state is retained for so that command buffers still in flight don't reference released Vulkan objects
+        uint32_t numFramesToRetainEvicted = 4;
+
+        /// return the mip level required for texture when its bound occupies screenHeightRatio of the view's height
+        uint32_t computeRequiredMipLevel(const StreamingTexture& texture, double screenHeightRatio) const;
+
+        /// request that the mip levels from mipLevel down are streamed in, called by RecordTraversal
+        void request(const StreamingTexture& texture, uint32_t mipLevel);
+
+        /// merge compiled mip levels into the scene graph and evict mip levels to stay within the memoryBudget
+        void run() override;
+
+        /// total size of the currently streamed mip levels
+        VkDeviceSize residentSize() const;
+
+    protected:
+        virtual ~TextureStreamer();
+
+        struct CompileOperation;
+
+        struct Compiled
+        {
+            ref_ptr<StreamingTexture> texture;
+            uint32_t mipLevel = 0;
+            ref_ptr<BindDescriptorSet> state;
+            VkDeviceSize size = 0;
+        };
+
+        struct Resident
+        {
+            ref_ptr<StreamingTexture> texture;
+            VkDeviceSize size = 0;
+        };
+
+        struct Retired
+        {
+            ref_ptr<BindDescriptorSet> state;
+            uint64_t frameCount = 0;
+        };
+
+        void _compile(const ref_ptr<StreamingTexture>& texture, uint32_t mipLevel);
+        void _evict(std::list<Resident>::iterator itr);
+
+        ref_ptr<OperationThreads> _compileThreads;
+
+        mutable std::mutex _mutex;
+        std::vector<Compiled> _compiled;
+        VkDeviceSize _residentSize = 0;
+
+        // only accessed from run()
+        std::list<Resident> _residents;
+        std::list<Retired> _retired;
+        uint64_t _frameCount = 0;
+    };
+    VSG_type_name(vsg::TextureStreamer);
+
+} // namespace vsg
@@ -0,0 +1,119 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RenderGraph.h>
+#include <vsg/app/View.h>
+#include <vsg/core/Value.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/DescriptorSet.h>
+#include <vsg/utils/ShaderSet.h>
+
+namespace vsg
+{
+
+    /// ToneMapSettings struct for passing the tone map and color grading settings as a uniform value to the ToneMapRenderGraph's tone map subpass.
+    struct ToneMapSettings
+    {
+        /// linear color filter and exposure applied before tone mapping
+        vec4 colorFilter{1.0f, 1.0f, 1.0f, 1.0f};
+        float exposure{1.0f};
+
+        /// contrast and saturation applied to the gamma encoded tone mapped color
+        float contrast{1.0f};
+        float saturation{1.0f};
+
+        /// gamma the scene's shaders encode color with, and the tone mapped color is encoded with
+        float gamma{2.2f};
+
+        void read(vsg::Input& input)
+        {
+            input.read("colorFilter", colorFilter);
+            input.read("exposure", exposure);
+            input.read("contrast", contrast);
+            input.read("saturation", saturation);
+            input.read("gamma", gamma);
+        }
+
+        void write(vsg::Output& output) const
+        {
+            output.write("colorFilter", colorFilter);
+            output.write("exposure", exposure);
+            output.write("contrast", contrast);
+            output.write("saturation", saturation);
+            output.write("gamma", gamma);
+        }
+    };
+
+    template<>
+    constexpr bool has_read_write<ToneMapSettings>() { return true; }
+
+    VSG_value(ToneMapSettingsValue, ToneMapSettings);
+
+    /// ToneMapRenderGraph renders its View to a high dynamic range color buffer in a first subpass and tone maps it to the Window's swapchain image
+    /// in a second subpass that reads it as an input attachment, so that on tile based GPUs the hdr color and depth buffers stay on chip and are never written out to memory.
+    /// Uses the RenderPass set up by createToneMapRenderPass(), the View's children and bins are all recorded in subpass 0 so the scene graph's pipelines need no changes.
+    /// If the Window is multisampled the scene is rendered multisampled and resolved within the render pass, with tone mapping and color grading fused into the single subpass that follows,
+    /// so the multisampled, resolved and hdr images are never written to or read back from memory. Post processing that samples neighbouring pixels, such as FXAA, can't be done from input attachments.
+    class VSG_DECLSPEC ToneMapRenderGraph : public Inherit<RenderGraph, ToneMapRenderGraph>
+    {
+    public:
+        ToneMapRenderGraph(ref_ptr<Window> in_window, ref_ptr<View> in_view, ref_ptr<const Options> options = {});
+
+        enum Attachments : uint32_t
+        {
+            COLOR,
+            HDR_COLOR,
+            DEPTH,
+            MULTISAMPLE_HDR_COLOR,
+            NUM_ATTACHMENTS
+        };
+
+        static constexpr VkFormat hdrFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+        ref_ptr<View> view;
+
+        /// hdr color and depth ImageViews, indexed by Attachments, the COLOR entry is unused as it's the Window's swapchain image, MULTISAMPLE_HDR_COLOR is only present when the Window is multisampled
+        ImageViews hdrBuffer;
+
+        /// tone map subpass, a full screen triangle that reads the hdr color buffer
+        ref_ptr<StateGroup> toneMapPass;
+
+        /// input attachment and settings DescriptorSet bound by the toneMapPass, updated when the hdrBuffer is recreated
+        ref_ptr<DescriptorSet> hdrDescriptorSet;
+
+        /// tone map and color grading settings, call settings->dirty() after changing them
+        ref_ptr<ToneMapSettingsValue> settings;
+
+        using RenderGraph::accept;
+
+        void accept(RecordTraversal& recordTraversal) const override;
+
+        /// (re)create the hdrBuffer images and the framebuffers for each of the Window's swapchain images
+        void createFramebuffers();
+
+    protected:
+        virtual ~ToneMapRenderGraph();
+
+        std::vector<ref_ptr<Framebuffer>> _framebuffers;
+        std::vector<const ImageView*> _swapchainImageViews;
+    };
+    VSG_type_name(vsg::ToneMapRenderGraph);
+
+    /// create the ShaderSet used by the ToneMapRenderGraph's tone map subpass, applying the ACES filmic tone curve followed by the ToneMapSettings color grading.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createToneMapShaderSet(ref_ptr<const Options> options = {});
+
+    /// Convenience function that sets up a ToneMapRenderGraph and associated View to render the specified scene graph from the specified camera view.
+    extern VSG_DECLSPEC ref_ptr<ToneMapRenderGraph> createToneMapRenderGraphForView(ref_ptr<Window> window, ref_ptr<Camera> camera, ref_ptr<Node> scenegraph, bool assignHeadlight = true);
+
+} // namespace vsg
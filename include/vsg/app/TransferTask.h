@@ -39,6 +39,9 @@ namespace vsg
         Semaphores waitSemaphores;
         Semaphores signalSemaphores;
 
+        /// values to wait on for each of the waitSemaphores that is a TimelineSemaphore, only used when the transferQueue has a timeline.
+        std::vector<uint64_t> waitValues;
+
         /// advance the currentFrameIndex
         void advance();
 
@@ -46,12 +49,37 @@ namespace vsg
         void assign(const BufferInfoList& bufferInfoList);
         void assign(const ImageInfoList& imageInfoList);
 
+        /// queue a one-off copy of data into the region of the image associated with imageInfo starting at imageOffset, the copy is recorded by a subsequent transferDynamicData().
+        /// data must be tightly packed in the image's format with the dimensions of extent, and is retained by the TransferTask until the copy has been recorded.
+        /// Unlike assign(..) this may be called from any thread, such as DatabasePager threads loading the contents of a VirtualTexture page.
+        void transfer(ref_ptr<Data> data, ref_ptr<ImageInfo> imageInfo, const VkOffset3D& imageOffset, const VkExtent3D& extent, uint32_t mipLevel = 0, uint32_t arrayLayer = 0);
+
         ref_ptr<Queue> transferQueue;
         ref_ptr<Semaphore> currentTransferCompletedSemaphore;
 
+        /// value of currentTransferCompletedSemaphore to wait on when it's the transferQueue's timeline semaphore
+        uint64_t currentTransferCompletedValue = 0;
+
+        /// queue that the transferred data is used on. When it's from a different queue family to the transferQueue, such as a dedicated transfer queue,
+        /// queue family ownership is released after the copies and the matching acquire barriers are recorded into currentAcquireCommandBuffer.
+        ref_ptr<Queue> consumerQueue;
+
+        /// command buffer to submit to the consumerQueue, ahead of the commands that use the transferred data, when queue family ownership is being transferred.
+        ref_ptr<CommandBuffer> currentAcquireCommandBuffer;
+
+        /// maximum number of bytes to transfer each frame, 0 for no limit. Modified data that doesn't fit in the budget is transferred on subsequent frames,
+        /// at least one BufferInfo or ImageInfo is transferred each frame so entries larger than the budget still get transferred.
+        VkDeviceSize maxTransferSizePerFrame = 0;
+
+        /// return true if the transferQueue and consumerQueue are from different queue families
+        bool requiresOwnershipTransfer() const;
+
         /// hook for assigning Instrumentation to enable profiling of record traversal.
         ref_ptr<Instrumentation> instrumentation;
 
+        /// optional WorkloadRecorder that the bytes transferred each frame are logged to
+        ref_ptr<WorkloadRecorder> workloadRecorder;
+
     protected:
         using OffsetBufferInfoMap = std::map<VkDeviceSize, ref_ptr<BufferInfo>>;
         using BufferMap = std::map<ref_ptr<Buffer>, OffsetBufferInfoMap>;
@@ -64,6 +92,28 @@ namespace vsg
         BufferMap _dynamicDataMap;
         std::set<ref_ptr<ImageInfo>> _dynamicImageInfoSet;
 
+        struct ImageRegion
+        {
+            ref_ptr<Data> data;
+            ref_ptr<ImageInfo> imageInfo;
+            VkOffset3D imageOffset;
+            VkExtent3D extent;
+            uint32_t mipLevel;
+            uint32_t arrayLayer;
+        };
+
+        // image regions queued by transfer(..), guarded by a mutex as they can be added from any thread
+        mutable std::mutex _imageRegionsMutex;
+        std::vector<ImageRegion> _imageRegions;
+        VkDeviceSize _imageRegionsTotalSize = 0;
+
+        // per frame transfer budget, with the first entries deferred in the previous frame used as the starting points so all entries get transferred
+        VkDeviceSize _transferredThisFrame = 0;
+        ref_ptr<Buffer> _resumeBuffer;
+        ref_ptr<ImageInfo> _resumeImageInfo;
+
+        bool _withinBudget(VkDeviceSize size) const { return maxTransferSizePerFrame == 0 || _transferredThisFrame == 0 || (_transferredThisFrame + size) <= maxTransferSizePerFrame; }
+
         size_t _currentFrameIndex;
         std::vector<size_t> _indices;
 
@@ -74,14 +124,24 @@ namespace vsg
             ref_ptr<Buffer> staging;
             void* buffer_data = nullptr;
             std::vector<VkBufferCopy> copyRegions;
+
+            // used when transferring queue family ownership to the consumerQueue
+            ref_ptr<CommandBuffer> acquireCommandBuffer;
+            ref_ptr<Buffer> acquireStaging;
+            void* acquire_buffer_data = nullptr;
+            std::vector<VkBufferMemoryBarrier> bufferBarriers;
+            std::vector<VkImageMemoryBarrier> imageBarriers;
         };
 
         std::vector<Frame> _frames;
 
         void _transferBufferInfos(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset);
+        BufferMap::iterator _transferBuffer(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset, BufferMap::iterator buffer_itr, std::vector<VkBufferCopy>& copyRegions);
 
-        void _transferImageInfos(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset);
-        void _transferImageInfo(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset, ImageInfo& imageInfo);
+        void _transferImageInfos(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset, VkCommandBuffer vk_acquireCommandBuffer, VkDeviceSize& acquireOffset);
+        void _transferImageInfo(VkCommandBuffer vk_commandBuffer, ref_ptr<Buffer> staging, void* buffer_data, VkDeviceSize& offset, ImageInfo& imageInfo, std::vector<VkImageMemoryBarrier>* releaseBarriers);
+        void _transferImageRows(VkCommandBuffer vk_commandBuffer, ref_ptr<Buffer> staging, void* buffer_data, VkDeviceSize& offset, ImageInfo& imageInfo, const Data::ModifiedRanges& ranges);
+        void _transferImageRegions(VkCommandBuffer vk_commandBuffer, ref_ptr<Buffer> staging, void* buffer_data, VkDeviceSize& offset, std::vector<ImageRegion>& imageRegions);
     };
     VSG_type_name(vsg::TransferTask);
 
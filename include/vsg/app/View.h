@@ -21,6 +21,10 @@ namespace vsg
 
     // forward declare
     class ViewDependentState;
+    class OcclusionCulling;
+    class VisibilityCache;
+    class SharedCull;
+    class DepthPrePass;
 
     /// ViewFeatures mask provide a means for controlling what features should be implemented by the View's ViewDependentState.
     enum ViewFeatures
@@ -66,6 +70,12 @@ namespace vsg
         /// camera controls the viewport state and projection and view matrices
         ref_ptr<Camera> camera;
 
+        /// optional per view cameras for multiview rendering, where a single record traversal renders to each layer of a multiview RenderPass (VK_KHR_multiview).
+        /// The camera is still used for culling so should enclose all the multiviewCameras' view frustums,
+        /// while the multiviewCameras' projection and view matrices are passed to the shaders via ViewDependentState::multiviewData.
+        /// Must be set before the View is compiled, requires the multiview device feature and ShaderSets such as vsg::createMultiviewPhongShaderSet().
+        std::vector<ref_ptr<Camera>> multiviewCameras;
+
         /// viewID is automatically assigned in View constructor
         const uint32_t viewID = 0;
 
@@ -83,6 +93,28 @@ namespace vsg
         /// view dependent state used for positional state like lighting, texgen and clipping
         ref_ptr<ViewDependentState> viewDependentState;
 
+        /// optional occlusion culling of the CullNodes and CullGroups in the View's subgraph
+        ref_ptr<OcclusionCulling> occlusionCulling;
+
+        /// optional cache of the bounds found entirely inside the view frustum, used to skip frustum tests on subsequent frames while the camera is moving slowly
+        ref_ptr<VisibilityCache> visibilityCache;
+
+        /// optional cull traversal shared with other Views of the same scene graph, the View records from its candidate list rather than traversing the scene graph itself
+        ref_ptr<SharedCull> sharedCull;
+
+        /// optional depth pre-pass for the opaque bins, recording them with depth only pipelines before recording them with depth equal pipelines
+        ref_ptr<DepthPrePass> depthPrePass;
+
+        /// minimum projected diameter, in pixels, of the bounds of CullNodes, CullGroups and DepthSorted nodes for their subgraphs to be recorded, 0.0 disables small feature culling.
+        double minimumFeatureSize = 0.0;
+
+        /// multiplier of the LOD and PagedLOD children's minimumScreenHeightRatio, values above 1.0 switch to lower detail children nearer the viewer. Typically adjusted by a LODScaleController.
+        double lodBias = 1.0;
+
+        /// additional multiplier of the PagedLOD high res child's minimumScreenHeightRatio used when deciding whether to request it from the DatabasePager,
+        /// values above 1.0 defer requests for tiles that are only just required, while already loaded tiles are still displayed using lodBias alone.
+        double requestLodBias = 1.0;
+
         /// override states for customization of graphics pipelines for this view
         GraphicsPipelineStates overridePipelineStates;
 
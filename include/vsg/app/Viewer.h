@@ -12,15 +12,22 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/app/Cluster.h>
 #include <vsg/app/CompileManager.h>
+#include <vsg/app/DeleteQueue.h>
+#include <vsg/app/FramePacer.h>
+#include <vsg/app/PowerManager.h>
 #include <vsg/app/Presentation.h>
 #include <vsg/app/RecordAndSubmitTask.h>
+#include <vsg/app/SwapchainTuner.h>
 #include <vsg/app/UpdateOperations.h>
 #include <vsg/app/Window.h>
 #include <vsg/threading/Barrier.h>
 #include <vsg/threading/FrameBlock.h>
+#include <vsg/threading/JobSystem.h>
 #include <vsg/utils/Instrumentation.h>
 
+#include <atomic>
 #include <map>
 
 namespace vsg
@@ -60,6 +67,13 @@ namespace vsg
         /// poll the events for all attached windows, return true if new events are available
         virtual bool pollEvents(bool discardPreviousEvents = true);
 
+        /// wait up to timeout seconds, or indefinitely when timeout is negative, until events are available on the attached windows or wakeEvents() is called, placing them in the Events list.
+        /// A single window blocks on its native event queue, with several windows the first is waited on for short intervals while the others are polled. Returns true if new events are available.
+        virtual bool waitEvents(double timeout, bool discardPreviousEvents = false);
+
+        /// wake a waitEvents() in progress, may be called from any thread while windows aren't being added or removed.
+        void wakeEvents();
+
         /// get the current set of Events that are filled in by prior calls to pollEvents
         UIEvents& getEvents() { return _events; }
 
@@ -84,11 +98,35 @@ namespace vsg
         void addUpdateOperation(ref_ptr<Operation> op, UpdateOperations::RunBehavior runBehavior = UpdateOperations::ONE_TIME)
         {
             updateOperations->add(op, runBehavior);
+
+            // wake a PowerManager waiting for a frame to be needed
+            if (powerManager) wakeEvents();
         }
 
         /// compile manager provides thread safe support for compiling subgraphs
         ref_ptr<CompileManager> compileManager;
 
+        /// optional JobSystem that, when assigned prior to compile(), is shared by the CompileManager and DatabasePager rather than them creating their own threads.
+        /// Update operations may also add work to it.
+        ref_ptr<JobSystem> jobSystem;
+
+        /// optional FramePacer that delays the start of each frame to reduce latency, see WindowTraits::presentWait.
+        ref_ptr<FramePacer> framePacer;
+
+        /// optional SwapchainTuner that adapts the present mode, swapchain image count and frames in flight to meet its throughput and latency goals.
+        ref_ptr<SwapchainTuner> swapchainTuner;
+
+        /// optional PowerManager that only renders frames when they are needed and limits the frame rate as the device heats up.
+        ref_ptr<PowerManager> powerManager;
+
+        /// optional Cluster that replicates scene graph changes from the master to the slave render nodes in update() and frame locks their presentation in present().
+        ref_ptr<Cluster> cluster;
+
+        /// optional DeleteQueue that, when assigned prior to compile(), defers the deletion of objects whose last reference is released on the record threads,
+        /// or on the main thread during recordAndSubmit() when not threading, until retainForFrameCount frames have completed.
+        /// The DatabasePager's deleteQueue may be used, otherwise compile() starts a thread to service it.
+        ref_ptr<DeleteQueue> deleteQueue;
+
         /// Convenience method for advancing to the next frame.
         /// Check active status, return false if viewer no longer active.
         /// If still active, poll for pending events and place them in the Events list and advance to the next frame, generate updated FrameStamp to signify the advancement to a new frame and return true.
@@ -122,9 +160,22 @@ namespace vsg
         ref_ptr<ActivityStatus> status;
         std::list<std::thread> threads;
 
+        /// when threading, complete the submission and presentation of each frame at the start of the next advanceToNextFrame() rather than in recordAndSubmit(),
+        /// so application work done between frames overlaps the record traversals, at the cost of presenting each frame later.
+        /// Scene graph modifications made between recordAndSubmit() and the next advanceToNextFrame() must be deferred using addUpdateOperation(..)
+        /// so they are applied in update() once the record traversals have completed.
+        bool pipelined = false;
+
+        /// when true assign CommandPoolRing to CommandGraphs so that command buffers are allocated from per frame pools shared by the CommandGraphs recorded on the same thread,
+        /// set before assignRecordAndSubmitTaskAndPresentation(..) and setupThreading().
+        bool useCommandPoolRings = false;
+
         void setupThreading();
         void stopThreading();
 
+        /// wait for the record traversals and submission of a pipelined frame to complete and then present it, called automatically by advanceToNextFrame() and stopThreading().
+        virtual void completeFrame();
+
         virtual void update();
 
         virtual void recordAndSubmit();
@@ -140,6 +191,25 @@ namespace vsg
         /// Convenience method for assigning Instrumentation to the viewer and any associated objects.
         void assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation);
 
+        /// FrameStatistics that the CPU time of each stage of the frame, the record time of each CommandGraph and GPU time of each RenderGraph are added to.
+        /// Created by the Viewer constructor, set to null to disable the timings.
+        ref_ptr<FrameStatistics> frameStatistics;
+
+        /// Convenience method for assigning FrameStatistics to the viewer and its RecordAndSubmitTasks
+        void assignFrameStatistics(ref_ptr<FrameStatistics> in_frameStatistics);
+
+        /// optional WorkloadRecorder that the start of each frame is logged to by recordAndSubmit()
+        ref_ptr<WorkloadRecorder> workloadRecorder;
+
+        /// Convenience method for assigning a WorkloadRecorder to the viewer and the DatabasePagers and TransferTasks of its RecordAndSubmitTasks, call after compile().
+        void assignWorkloadRecorder(ref_ptr<WorkloadRecorder> in_workloadRecorder);
+
+        /// PipelineCaches to use when compiling pipelines, one per Device.
+        PipelineCaches pipelineCaches;
+
+        /// Convenience method for assigning a PipelineCache to the viewer and CompileManager, replaces any PipelineCache previously assigned for the same Device.
+        void assignPipelineCache(ref_ptr<PipelineCache> pipelineCache);
+
     protected:
         virtual ~Viewer();
 
@@ -152,10 +222,24 @@ namespace vsg
         clock::time_point _start_point;
         UIEvents _events;
         EventHandlers _eventHandlers;
+        std::atomic_bool _wakeRequested{false};
 
         bool _threading = false;
         ref_ptr<FrameBlock> _frameBlock;
         ref_ptr<Barrier> _submissionCompleted;
+        bool _framePending = false;
+
+        ref_ptr<ActivityStatus> _deleteThreadStatus;
+        ref_ptr<DeleteQueue> _deleteThreadQueue;
+        std::thread _deleteThread;
+
+        void _stopDeleteThread();
+
+        /// when useCommandPoolRings is enabled assign a CommandPoolRing to each CommandGraph, shared by those recorded on the same thread
+        void _assignCommandPoolRings();
+
+        /// synchronize the RecordAndSubmitTasks of ComputeCommandGraphs with the other RecordAndSubmitTasks on the same Device
+        void _assignComputeSynchronization();
     };
     VSG_type_name(vsg::Viewer);
 
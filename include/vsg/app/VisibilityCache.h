@@ -0,0 +1,91 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+#include <vsg/core/Inherit.h>
+#include <vsg/maths/mat4.h>
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace vsg
+{
+
+    // forward declare
+    class Node;
+
+    /// VisibilityCache records the CullNode, CullGroup, LOD and PagedLOD bounds that the RecordTraversal found entirely inside the view frustum, and by what margin,
+    /// so that on subsequent frames, while the camera has moved less than that margin, the frustum test is skipped and the subgraph is treated as visible
+    /// without testing any of the bounds beneath it. LOD levels are still selected each frame.
+    /// Camera motion is measured relative to a reference camera position and orientation, with all entries discarded when the reference is reset.
+    /// Cached results assume the bounds don't move, so by default only nodes with no Transform above them are cached.
+    /// Assign to View::visibilityCache to enable.
+    class VSG_DECLSPEC VisibilityCache : public Inherit<Object, VisibilityCache>
+    {
+    public:
+        VisibilityCache();
+
+        /// reset the reference camera when the camera has rotated or translated further than these from it, or after maximumReferenceFrames frames.
+        double maximumRotation = 0.05;
+        double maximumTranslation = std::numeric_limits<double>::max();
+        uint64_t maximumReferenceFrames = 30;
+
+        /// also cache nodes beneath Transforms, only safe when the matrices of the Transforms above cached nodes don't change
+        bool cacheTransformedNodes = false;
+
+        /// prepare for culling a new frame, called by RecordTraversal::apply(const View&).
+        virtual void beginFrame(const dmat4& projection, const dmat4& view, uint64_t frameCount);
+
+        /// return true if the node's bound is known to be entirely inside the view frustum for the current camera.
+        /// Thread safe so can be called by the RecordTraversal's cull threads.
+        bool inside(const Node* node);
+
+        /// record that the node's bound is entirely inside the current frame's view frustum by margin, with its center at eyeDistance from the eye, both in eye coordinate units.
+        void insert(const Node* node, double margin, double eyeDistance);
+
+        /// discard all entries and reset the reference camera on the next beginFrame()
+        void clear();
+
+        /// number of nodes found inside and the number inserted since the last beginFrame()
+        uint32_t numHits() const { return _numHits.load(); }
+        uint32_t numInserted() const { return _numInserted.load(); }
+
+    protected:
+        virtual ~VisibilityCache();
+
+        struct Entry
+        {
+            double margin = 0.0;
+            double distance = 0.0;
+        };
+
+        std::mutex _mutex;
+        std::unordered_map<const Node*, Entry> _entries;
+
+        bool _referenceValid = false;
+        dmat4 _referenceProjection;
+        dmat4 _referenceView;
+        dvec3 _referenceEye;
+        uint64_t _referenceFrameCount = 0;
+
+        // motion of the current camera relative to the reference camera
+        double _translation = 0.0;
+        double _rotation = 0.0;
+
+        std::atomic_uint _numHits{0};
+        std::atomic_uint _numInserted{0};
+    };
+    VSG_type_name(vsg::VisibilityCache);
+
+} // namespace vsg
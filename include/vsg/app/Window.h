@@ -18,9 +18,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/vk/CommandBuffer.h>
 #include <vsg/vk/CommandPool.h>
 #include <vsg/vk/DeviceMemory.h>
+#include <vsg/vk/Fence.h>
 #include <vsg/vk/Framebuffer.h>
 #include <vsg/vk/Semaphore.h>
 
+#include <condition_variable>
+#include <mutex>
+
 namespace vsg
 {
 
@@ -53,9 +57,20 @@ namespace vsg
         /// events buffered since the last pollEvents.
         UIEvents bufferedEvents;
 
-        /// get the list of events since the last pollEvents() call by splicing bufferEvents with polled windowing events.
+        /// when true, runs of MoveEvents with the same button mask, and of TouchMoveEvents with the same touch id, buffered since the last pollEvents are coalesced into their most recent event,
+        /// reducing the number of events handlers visit for high rate pointer, touch and pen devices. Leave false when handlers require every sample, such as for sketching.
+        bool coalesceMoveEvents = false;
+
+        /// get the list of events since the last pollEvents() call by splicing bufferEvents with polled windowing events, coalescing MoveEvents if enabled.
         virtual bool pollEvents(UIEvents& events);
 
+        /// wait up to timeout seconds, or indefinitely when timeout is negative, until events are available or wakeEvents() is called, then poll them into events.
+        /// Returns true if new events are available. Xcb_Window and Win32_Window block on their native event queues, other Windows poll at short intervals.
+        virtual bool waitEvents(UIEvents& events, double timeout);
+
+        /// wake a waitEvents() in progress, may be called from any thread.
+        virtual void wakeEvents();
+
         virtual void resize() {}
 
         ref_ptr<WindowTraits> traits() { return _traits; }
@@ -146,6 +161,12 @@ namespace vsg
         void share(ref_ptr<Device> device);
         void buildSwapchain();
 
+        /// move the current swapchain and its associated images and framebuffers to the retired list, they are released by _releaseRetiredSwapchains() once the work already submitted to the device's queues has completed.
+        void _retireSwapchain();
+
+        /// release retired swapchains that are no longer in use by the device, if wait is true block until all have completed.
+        void _releaseRetiredSwapchains(bool wait = false);
+
         ref_ptr<WindowTraits> _traits;
 
         VkExtent2D _extent2D;
@@ -177,6 +198,19 @@ namespace vsg
 
         Frames _frames;
         std::vector<size_t> _indices;
+
+        struct RetiredSwapchain
+        {
+            ref_ptr<Swapchain> swapchain;
+            Frames frames;
+            std::vector<ref_ptr<Object>> attachments;
+            std::vector<ref_ptr<Fence>> fences;
+        };
+        std::vector<RetiredSwapchain> _retiredSwapchains;
+
+        std::mutex _wakeMutex;
+        std::condition_variable _wakeCondition;
+        bool _wakeRequested = false;
     };
     VSG_type_name(vsg::Window);
 
@@ -64,10 +64,17 @@ namespace vsg
         /// return true if the object was visited
         bool visit(const Object* object, uint32_t index = 0);
 
+        /// wait for the device to be idle before any Vulkan objects are released and recreated, only called when needed
+        /// so that resizes of scene graphs using dynamic viewport/scissor state and SetViewport/SetScissor don't stall the device.
+        void deviceWaitIdle();
+        bool deviceIdle = false;
+
         void apply(BindGraphicsPipeline& bindPipeline) override;
         void apply(Object& object) override;
         void apply(StateGroup& sg) override;
         void apply(ClearAttachments& clearAttachments) override;
+        void apply(SetViewport& setViewport) override;
+        void apply(SetScissor& setScissor) override;
         void apply(View& view) override;
     };
     VSG_type_name(WindowResizeHandler);
@@ -67,6 +67,13 @@ namespace vsg
 
         VkQueueFlags queueFlags = VK_QUEUE_GRAPHICS_BIT;
         std::vector<float> queuePiorities{1.0, 0.0};
+
+        /// request a queue from a transfer only queue family, when one is available, for the Viewer's TransferTask to upload dynamic data with
+        bool dedicatedTransferQueue = false;
+
+        /// request a queue from a compute queue family without graphics support, when one is available, for ComputeCommandGraph to submit to so compute work can overlap rendering
+        bool asyncComputeQueue = false;
+
         VkPipelineStageFlagBits imageAvailableSemaphoreWaitFlag = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 
         // hints to which extenstion to enable during Instance/Device setup
@@ -74,10 +81,19 @@ namespace vsg
         bool synchronizationLayer = false; // VK_LAYER_KHRONOS_synchronization2
         bool apiDumpLayer = false;         // VK_LAYER_LUNARG_api_dump
         bool debugUtils = false;           // VK_EXT_debug_utils
+        bool presentWait = false;          // VK_KHR_present_id and VK_KHR_present_wait, when supported, so a vsg::FramePacer can wait on presentation of previous frames
+        bool timelineSemaphores = false;   // Vulkan 1.2 or VK_KHR_timeline_semaphore, when supported, so each Queue is assigned a TimelineSemaphore used in place of per frame Fences and Semaphores
+        bool dynamicRendering = false;     // Vulkan 1.3 or VK_KHR_dynamic_rendering, when supported, so RenderGraph's for the Window use vkCmdBeginRendering in place of vkCmdBeginRenderPass
+        bool descriptorBuffer = false;     // VK_EXT_descriptor_buffer and buffer device address, when supported, so DescriptorSets are written into a vsg::DescriptorHeap in place of being allocated from DescriptorPools
+        bool graphicsPipelineLibrary = false; // VK_KHR_pipeline_library and VK_EXT_graphics_pipeline_library, when supported, so GraphicsPipelines are fast linked from shared pipeline library parts
 
         // Device to use, if not assigned use the device preferences below
         ref_ptr<vsg::Device> device;
 
+        // PhysicalDevice to create the Window's Device on, if not assigned use the device preferences below.
+        // Assign one of the PhysicalDevices of a shared Instance to each Window to render Windows on different GPUs, such as for driving a display wall from a multi-GPU server.
+        ref_ptr<vsg::PhysicalDevice> physicalDevice;
+
         // device preferences
         vsg::Names instanceExtensionNames;
         vsg::Names requestedLayers;
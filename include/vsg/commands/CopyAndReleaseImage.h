@@ -42,6 +42,9 @@ namespace vsg
             uint32_t depth = 0;
             Data::MipmapOffsets mipmapOffsets;
 
+            /// optional ImageFormatConversion that writes the source buffer, recorded ahead of the buffer to image copies
+            ref_ptr<Command> conversion;
+
             void record(CommandBuffer& commandBuffer) const;
         };
 
@@ -18,7 +18,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 namespace vsg
 {
 
-    /** Dispatch command encapsulates vkCmdDispatch, used for dispatching a Compute pipeline.*/
+    /** Dispatch command encapsulates vkCmdDispatch, used for dispatching a Compute pipeline.
+      * vkCmdDispatch can't be recorded within a render pass, so Dispatch, and the commands that dispatch compute shaders internally,
+      * must be placed outside of RenderGraphs, typically in the CommandGraph ahead of the RenderGraph that consumes their results.*/
     class VSG_DECLSPEC Dispatch : public Inherit<Command, Dispatch>
     {
     public:
@@ -35,6 +37,7 @@ namespace vsg
         void record(CommandBuffer& commandBuffer) const override
         {
             vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+            ++commandBuffer.recordStatistics.dispatches;
         }
 
         uint32_t groupCountX = 0;
@@ -39,6 +39,8 @@ namespace vsg
         void record(CommandBuffer& commandBuffer) const override
         {
             vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+            ++commandBuffer.recordStatistics.draws;
+            commandBuffer.recordStatistics.vertices += static_cast<uint64_t>(vertexCount) * instanceCount;
         }
 
         uint32_t vertexCount = 0;
@@ -40,6 +40,8 @@ namespace vsg
         void record(CommandBuffer& commandBuffer) const override
         {
             vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+            ++commandBuffer.recordStatistics.draws;
+            commandBuffer.recordStatistics.vertices += static_cast<uint64_t>(indexCount) * instanceCount;
         }
 
         uint32_t indexCount = 0;
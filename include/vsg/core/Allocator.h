@@ -36,6 +36,22 @@ namespace vsg
         ALLOCATOR_AFFINITY_LAST = ALLOCATOR_AFFINITY_NODES + 1
     };
 
+    enum MemoryPages : uint8_t
+    {
+        MEMORY_PAGES_DEFAULT = 0,       ///< allocate MemoryBlocks using the memoryBlocksAllocatorType
+        MEMORY_PAGES_TRANSPARENT_HUGE, ///< map huge page aligned memory and advise the kernel to back it with transparent huge pages, under Windows regular pages are mapped
+        MEMORY_PAGES_HUGE              ///< map explicit huge pages, requires reserved hugetlbfs pages under Linux and SeLockMemoryPrivilege under Windows, falls back to MEMORY_PAGES_TRANSPARENT_HUGE
+    };
+
+    /// MemoryPlacement specifies how the memory of new MemoryBlocks is backed, assigned per AllocatorAffinity using Allocator::setMemoryPlacement(..)
+    struct MemoryPlacement
+    {
+        MemoryPages pages = MEMORY_PAGES_DEFAULT;
+
+        /// NUMA node the memory is preferably placed on, -1 for the system's default placement. Use vsg::numaNode(affinity) to get the node of the cpus that a group of threads run on.
+        int numaNode = -1;
+    };
+
     /** extensible Allocator that handles allocation and deallocation of scene graph CPU memory,*/
     class VSG_DECLSPEC Allocator
     {
@@ -77,7 +93,7 @@ namespace vsg
 
         struct MemoryBlock
         {
-            MemoryBlock(size_t blockSize, int memoryTracking, AllocatorType in_allocatorType);
+            MemoryBlock(size_t blockSize, int memoryTracking, AllocatorType in_allocatorType, const MemoryPlacement& placement = {});
             virtual ~MemoryBlock();
 
             void* allocate(std::size_t size);
@@ -86,6 +102,9 @@ namespace vsg
             vsg::MemorySlots memorySlots;
             const AllocatorType allocatorType;
             uint8_t* memory = nullptr;
+
+            /// size of the pages mapped when memory is allocated directly from the OS to honour the MemoryPlacement, 0 when allocated using the allocatorType
+            size_t mappedSize = 0;
         };
 
         struct MemoryBlocks
@@ -93,6 +112,7 @@ namespace vsg
             Allocator* parent = nullptr;
             std::string name;
             size_t blockSize = 0;
+            MemoryPlacement placement;
             std::map<void*, std::shared_ptr<MemoryBlock>> memoryBlocks;
             std::shared_ptr<MemoryBlock> latestMemoryBlock;
 
@@ -114,6 +134,9 @@ namespace vsg
 
         void setBlockSize(AllocatorAffinity allocatorAffinity, size_t blockSize);
 
+        /// set the MemoryPlacement used for new MemoryBlocks of the specified AllocatorAffinity, existing MemoryBlocks are unaffected.
+        void setMemoryPlacement(AllocatorAffinity allocatorAffinity, const MemoryPlacement& placement);
+
         mutable std::mutex mutex;
 
         double allocationTime = 0.0;
@@ -126,10 +149,10 @@ namespace vsg
         std::vector<std::unique_ptr<MemoryBlocks>> allocatorMemoryBlocks;
     };
 
-    /// allocate memory using vsg::Allocator::instance() if available, otherwise use std::malloc(size)
+    /// allocate memory from the calling thread's current AllocatorArena if one is active, otherwise using vsg::Allocator::instance()
     extern VSG_DECLSPEC void* allocate(std::size_t size, AllocatorAffinity allocatorAffinity = ALLOCATOR_AFFINITY_OBJECTS);
 
-    /// deallocate memory using vsg::Allocator::instance() if available, otherwise use std::free(ptr)
+    /// deallocate memory, releasing it to its AllocatorArena if it was allocated from one, otherwise using vsg::Allocator::instance()
     extern VSG_DECLSPEC void deallocate(void* ptr, std::size_t size = 0);
 
     /// std container adapter for allocating with MEMORY_AFFINITY_NODES
@@ -0,0 +1,71 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+#include <vsg/core/Allocator.h>
+#include <vsg/core/Inherit.h>
+
+namespace vsg
+{
+
+    /// AllocatorArena allocates memory for objects created together, such as the nodes and data of a model loaded by the DatabasePager,
+    /// from large chunks of memory with a simple bump pointer and no per allocation bookkeeping.
+    /// Deallocating arena memory only decrements a count of live allocations, the chunks are all freed at once when the count drops to zero
+    /// after the AllocatorArena itself has been deleted. While a Scope is active on a thread, vsg::allocate() allocates from the Scope's arena.
+    /// Objects created within a Scope that outlive the rest, such as objects shared via Options::sharedObjects, keep all the arena's chunks allocated.
+    class VSG_DECLSPEC AllocatorArena : public Inherit<Object, AllocatorArena>
+    {
+    public:
+        AllocatorArena();
+
+        /// size of the chunks of memory that allocations are taken from, chunks are aligned to their size so the arena of a pointer can be looked up.
+        static constexpr size_t chunkSize = 1024 * 1024;
+
+        /// allocations larger than maximumAllocationSize are passed on to the vsg::Allocator
+        static constexpr size_t maximumAllocationSize = chunkSize / 4;
+
+        /// Scope makes the arena current for the calling thread for its lifetime, restoring the previously current arena on destruction.
+        struct VSG_DECLSPEC Scope
+        {
+            explicit Scope(AllocatorArena* arena);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            AllocatorArena* previous = nullptr;
+        };
+
+        /// return the arena current for the calling thread, nullptr if none is active.
+        static AllocatorArena* current();
+
+        /// allocate memory from the arena, return nullptr if the size is too large to be allocated from the arena
+        void* allocate(std::size_t size);
+
+        /// deallocate ptr if it was allocated from an arena, returning false if it wasn't
+        static bool deallocate(void* ptr);
+
+        /// number of allocations from this arena that have not yet been deallocated
+        size_t numAllocations() const;
+
+        /// total size of the chunks allocated by this arena
+        size_t totalMemorySize() const;
+
+    protected:
+        virtual ~AllocatorArena();
+
+        struct Region;
+        Region* _region = nullptr;
+    };
+    VSG_type_name(vsg::AllocatorArena);
+
+} // namespace vsg
@@ -158,6 +158,17 @@ namespace vsg
             {
                 size_t new_total_size = computeValueCountIncludingMipmaps(width_size, 1, 1, properties.maxNumMipmaps);
 
+                if constexpr (!has_read_write<value_type>())
+                {
+                    // reference the data in place when the input is memory mapped
+                    size_t mapped_offset = 0;
+                    if (auto mapped_storage = input.mapData(new_total_size * sizeof(value_type), mapped_offset))
+                    {
+                        assign(mapped_storage, static_cast<uint32_t>(mapped_offset), sizeof(value_type), width_size, properties);
+                        return;
+                    }
+                }
+
                 if (_data) // if data exists already may be able to reuse it
                 {
                     if (original_total_size != new_total_size) // if existing data is a different size delete old, and create new
@@ -176,7 +187,7 @@ namespace vsg
                 _size = width_size;
                 _storage = nullptr;
 
-                if (_data) input.read(new_total_size, _data);
+                if (_data && !input.readData(_data, sizeof(value_type), new_total_size)) input.read(new_total_size, _data);
 
                 dirty();
             }
@@ -187,8 +198,10 @@ namespace vsg
             Data::write(output);
 
             output.writeValue<uint32_t>("size", _size);
-            output.writeObject("storage", _storage);
-            if (_storage)
+            // storage that doesn't own its memory, such as a MappedFile, isn't serialized so the data is written in place
+            const Data* storage = (_storage && _storage->properties.allocatorType != ALLOCATOR_TYPE_NO_DELETE) ? _storage.get() : nullptr;
+            output.writeObject("storage", storage);
+            if (storage)
             {
                 auto offset = (reinterpret_cast<uintptr_t>(_data) - reinterpret_cast<uintptr_t>(_storage->dataPointer()));
                 output.writeValue<uint32_t>("offset", offset);
@@ -196,7 +209,10 @@ namespace vsg
             }
 
             output.writePropertyName("data");
-            output.write(size(), _data);
+            if constexpr (has_read_write<value_type>())
+                output.write(size(), _data);
+            else if (!output.writeData(_data, sizeof(value_type), size(), std::is_integral_v<value_type>))
+                output.write(size(), _data);
             output.writeEndOfLine();
         }
 
@@ -292,6 +308,9 @@ namespace vsg
         bool dataAvailable() const override { return available(); }
         size_t dataSize() const override { return size() * properties.stride; }
 
+        /// signify that count elements starting at element first have been modified, so only they need to be transferred
+        void dirtyElements(size_t first, size_t count) { dirty(first * properties.stride, count * properties.stride); }
+
         void* dataPointer() override { return _data; }
         const void* dataPointer() const override { return _data; }
 
@@ -411,4 +430,7 @@ namespace vsg
     VSG_array(block64Array, block64);
     VSG_array(block128Array, block128);
 
+    /// create an Array of the same type and format as data with numValues values, returns null if data isn't one of the Array types above.
+    extern VSG_DECLSPEC ref_ptr<Data> createArrayLike(const Data& data, uint32_t numValues);
+
 } // namespace vsg
@@ -129,6 +129,17 @@ namespace vsg
             {
                 size_t new_size = computeValueCountIncludingMipmaps(w, h, 1, properties.maxNumMipmaps);
 
+                if constexpr (!has_read_write<value_type>())
+                {
+                    // reference the data in place when the input is memory mapped
+                    size_t mapped_offset = 0;
+                    if (auto mapped_storage = input.mapData(new_size * sizeof(value_type), mapped_offset))
+                    {
+                        assign(mapped_storage, static_cast<uint32_t>(mapped_offset), sizeof(value_type), w, h, properties);
+                        return;
+                    }
+                }
+
                 if (_data) // if data exists already may be able to reuse it
                 {
                     if (original_size != new_size) // if existing data is a different size delete old, and create new
@@ -147,7 +158,7 @@ namespace vsg
                 _height = h;
                 _storage = nullptr;
 
-                if (_data) input.read(new_size, _data);
+                if (_data && !input.readData(_data, sizeof(value_type), new_size)) input.read(new_size, _data);
 
                 dirty();
             }
@@ -160,8 +171,10 @@ namespace vsg
             output.writeValue<uint32_t>("width", _width);
             output.writeValue<uint32_t>("height", _height);
 
-            output.writeObject("storage", _storage);
-            if (_storage)
+            // storage that doesn't own its memory, such as a MappedFile, isn't serialized so the data is written in place
+            const Data* storage = (_storage && _storage->properties.allocatorType != ALLOCATOR_TYPE_NO_DELETE) ? _storage.get() : nullptr;
+            output.writeObject("storage", storage);
+            if (storage)
             {
                 auto offset = (reinterpret_cast<uintptr_t>(_data) - reinterpret_cast<uintptr_t>(_storage->dataPointer()));
                 output.writeValue<uint32_t>("offset", offset);
@@ -169,7 +182,10 @@ namespace vsg
             }
 
             output.writePropertyName("data");
-            output.write(valueCount(), _data);
+            if constexpr (has_read_write<value_type>())
+                output.write(valueCount(), _data);
+            else if (!output.writeData(_data, sizeof(value_type), valueCount(), std::is_integral_v<value_type>))
+                output.write(valueCount(), _data);
             output.writeEndOfLine();
         }
 
@@ -271,6 +287,20 @@ namespace vsg
         bool dataAvailable() const override { return available(); }
         size_t dataSize() const override { return size() * properties.stride; }
 
+        /// signify that the w x h region starting at column x, row y has been modified, so only those rows need to be transferred
+        void dirtyRegion(uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+        {
+            if (x == 0 && w == _width)
+            {
+                dirty(size_t(y) * _width * properties.stride, size_t(h) * _width * properties.stride);
+                return;
+            }
+            for (uint32_t r = y; r < y + h; ++r)
+            {
+                dirty((size_t(r) * _width + x) * properties.stride, size_t(w) * properties.stride);
+            }
+        }
+
         void* dataPointer() override { return _data; }
         const void* dataPointer() const override { return _data; }
 
@@ -15,20 +15,41 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Object.h>
 #include <vsg/core/ref_ptr.h>
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <vector>
 
 namespace vsg
 {
 
-    /** Auxiliary provides extra Object data that is rarely used, and hooks for observers.*/
+    /// return the unique, non zero, ID for the key string, adding it to the global key table if it's not already been interned.
+    /// Keys are never removed from the table so should come from a bounded set, as object meta data keys typically do.
+    extern VSG_DECLSPEC uint32_t internKey(const std::string& key);
+
+    /// return the ID of an already interned key string, or 0 if the key hasn't been interned.
+    extern VSG_DECLSPEC uint32_t findKey(const std::string& key);
+
+    /// return the key string associated with an interned key ID.
+    extern VSG_DECLSPEC const std::string& keyString(uint32_t keyID);
+
+    /** Auxiliary provides extra Object data that is rarely used, and hooks for observers.
+      * User objects are stored against interned key IDs, the first few in a small inline array and the rest in an overflow vector, avoiding per entry heap allocations and string keys.
+      * Reads don't take any locks, writes take one of a set of mutexes shared between all Auxiliary, so concurrent writes are serialized,
+      * but reads concurrent with writes to the same Auxiliary still need synchronizing by the caller.*/
     class VSG_DECLSPEC Auxiliary
     {
     public:
-        std::mutex& getMutex() const { return _mutex; }
+        /// mutex used to serialize writes to the user objects, shared with other Auxiliary.
+        std::mutex& getMutex() const;
 
-        Object* getConnectedObject() { return _connectedObject; }
-        const Object* getConnectedObject() const { return _connectedObject; }
+        Object* getConnectedObject() { return _connectedObject.load(std::memory_order_acquire); }
+        const Object* getConnectedObject() const { return _connectedObject.load(std::memory_order_acquire); }
+
+        /// take a reference to the connected Object if it's still referenced, returning nullptr if it's been deleted or is in the process of being deleted.
+        /// Lock free, used by observer_ptr to promote to ref_ptr, the caller is responsible for the unref().
+        Object* refConnectedObject();
 
         virtual std::size_t getSizeOf() const { return sizeof(Auxiliary); }
 
@@ -39,47 +60,58 @@ namespace vsg
 
         virtual int compare(const Auxiliary& rhs) const;
 
-        void setObject(const std::string& key, ref_ptr<Object> object)
-        {
-            userObjects[key] = object;
-        }
+        void setObject(const std::string& key, ref_ptr<Object> object) { setObject(internKey(key), object); }
+        void setObject(uint32_t keyID, ref_ptr<Object> object);
+
+        Object* getObject(const std::string& key) { return getObject(findKey(key)); }
+        const Object* getObject(const std::string& key) const { return getObject(findKey(key)); }
 
-        Object* getObject(const std::string& key)
+        Object* getObject(uint32_t keyID)
         {
-            if (auto itr = userObjects.find(key); itr != userObjects.end())
-                return itr->second.get();
-            else
-                return nullptr;
+            auto entry = _find(keyID);
+            return entry ? entry->object.get() : nullptr;
         }
 
-        const Object* getObject(const std::string& key) const
+        const Object* getObject(uint32_t keyID) const
         {
-            if (auto itr = userObjects.find(key); itr != userObjects.end())
-                return itr->second.get();
-            else
-                return nullptr;
+            auto entry = _find(keyID);
+            return entry ? entry->object.get() : nullptr;
         }
 
         ref_ptr<Object> getRefObject(const std::string& key)
         {
-            if (auto itr = userObjects.find(key); itr != userObjects.end())
-                return itr->second;
-            else
-                return {};
+            auto entry = _find(findKey(key));
+            return entry ? entry->object : ref_ptr<Object>();
         }
 
         ref_ptr<const Object> getRefObject(const std::string& key) const
         {
-            if (auto itr = userObjects.find(key); itr != userObjects.end())
-                return itr->second;
-            else
-                return {};
+            auto entry = _find(findKey(key));
+            return entry ? ref_ptr<const Object>(entry->object) : ref_ptr<const Object>();
         }
 
+        /// remove the user object associated with key
+        void removeObject(const std::string& key);
+
+        /// remove all user objects
+        void clearObjects();
+
+        /// number of user objects
+        size_t numObjects() const { return _numInline.load(std::memory_order_acquire) + _overflow.size(); }
+
         using ObjectMap = std::map<std::string, vsg::ref_ptr<Object>>;
 
-        /// container for all user objects
-        ObjectMap userObjects;
+        /// return all the user objects sorted by key
+        ObjectMap getObjects() const;
+
+        /// replace the user objects with those of the ObjectMap
+        void setObjects(const ObjectMap& objects);
+
+        /// replace the user objects with those of another Auxiliary
+        void copyObjects(const Auxiliary& rhs);
+
+        /// number of user objects stored inline before using the overflow vector
+        static constexpr uint32_t numInlineObjects = 4;
 
     protected:
         explicit Auxiliary(Object* object);
@@ -95,10 +127,38 @@ namespace vsg
         friend class Object;
         friend class Allocator;
 
+        struct Entry
+        {
+            uint32_t keyID = 0;
+            ref_ptr<Object> object;
+        };
+
+        const Entry* _find(uint32_t keyID) const
+        {
+            if (keyID == 0) return nullptr;
+
+            uint32_t numInline = _numInline.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < numInline; ++i)
+            {
+                if (_inline[i].keyID == keyID) return &_inline[i];
+            }
+            for (auto& entry : _overflow)
+            {
+                if (entry.keyID == keyID) return &entry;
+            }
+            return nullptr;
+        }
+
         mutable std::atomic_uint _referenceCount;
 
-        mutable std::mutex _mutex;
-        Object* _connectedObject;
+        std::atomic<Object*> _connectedObject;
+
+        /// number of threads in refConnectedObject(), the connected Object isn't deleted until they've finished with it
+        std::atomic_uint _numPromoting{0};
+
+        std::atomic_uint32_t _numInline{0};
+        std::array<Entry, numInlineObjects> _inline;
+        std::vector<Entry> _overflow;
     };
 
 } // namespace vsg
@@ -29,6 +29,7 @@ namespace vsg
     class Commands;
     class Group;
     class QuadGroup;
+    class SpatialGroup;
     class LOD;
     class PagedLOD;
     class StateGroup;
@@ -48,6 +49,7 @@ namespace vsg
     class PointLight;
     class SpotLight;
     class InstrumentationNode;
+    class InstanceNode;
 
     // forward declare text classes
     class Text;
@@ -93,6 +95,8 @@ namespace vsg
     class DynamicState;
     class ResourceHints;
     class ClearAttachments;
+    class SetViewport;
+    class SetScissor;
     class ClearColorImage;
     class ClearDepthStencilImage;
     class QueryPool;
@@ -288,6 +292,7 @@ namespace vsg
         virtual void apply(const Commands&);
         virtual void apply(const Group&);
         virtual void apply(const QuadGroup&);
+        virtual void apply(const SpatialGroup&);
         virtual void apply(const LOD&);
         virtual void apply(const PagedLOD&);
         virtual void apply(const StateGroup&);
@@ -307,6 +312,7 @@ namespace vsg
         virtual void apply(const PointLight&);
         virtual void apply(const SpotLight&);
         virtual void apply(const InstrumentationNode&);
+        virtual void apply(const InstanceNode&);
 
         // text
         virtual void apply(const Text&);
@@ -351,6 +357,8 @@ namespace vsg
         virtual void apply(const Draw&);
         virtual void apply(const DrawIndexed&);
         virtual void apply(const ClearAttachments&);
+        virtual void apply(const SetViewport&);
+        virtual void apply(const SetScissor&);
         virtual void apply(const ClearColorImage&);
         virtual void apply(const ClearDepthStencilImage&);
         virtual void apply(const QueryPool&);
@@ -193,7 +193,28 @@ namespace vsg
         static size_t computeValueCountIncludingMipmaps(size_t w, size_t h, size_t d, uint32_t maxNumMipmaps);
 
         /// increment the ModifiedCount to signify the data has been modified
-        void dirty() { ++_modifiedCount; }
+        void dirty()
+        {
+            ++_modifiedCount;
+            _modifiedRange.valid = false;
+        }
+
+        /// increment the ModifiedCount to signify that only the bytes from offset to offset+size have been modified, allowing the TransferTask to copy just that range.
+        /// Ranges accumulate until a consumer syncs with the data, consumers that are further behind copy the whole data.
+        /// Overlapping and adjacent ranges are coalesced, when more than maxModifiedRanges are recorded the two closest are merged.
+        void dirty(size_t offset, size_t size);
+
+        /// maximum number of disjoint modified ranges tracked before neighbouring ranges are merged
+        static constexpr size_t maxModifiedRanges = 16;
+
+        /// return true and set the byte range modified since the specified ModifiedCount if only a range has been modified, return false if all the data needs copying
+        bool getModifiedRange(const ModifiedCount& mc, size_t& offset, size_t& size) const;
+
+        using ModifiedRanges = std::vector<std::pair<size_t, size_t>>;
+
+        /// return true and set the disjoint (offset, size) byte ranges, in ascending order, modified since the specified ModifiedCount if only ranges have been modified,
+        /// return false if all the data needs copying
+        bool getModifiedRanges(const ModifiedCount& mc, ModifiedRanges& ranges) const;
 
         /// get the Data's ModifiedCount and return true if this changes the specified ModifiedCount
         bool getModifiedCount(ModifiedCount& mc) const
@@ -201,6 +222,7 @@ namespace vsg
             if (_modifiedCount != mc)
             {
                 mc = _modifiedCount;
+                _modifiedRange.synced = true;
                 return true;
             }
             else
@@ -215,6 +237,15 @@ namespace vsg
 
         ModifiedCount _modifiedCount;
 
+        struct ModifiedRange
+        {
+            ModifiedCount start;                          // ModifiedCount prior to the first modification in the range
+            std::vector<std::pair<size_t, size_t>> spans; // sorted, disjoint, [begin, end) byte spans
+            bool valid = false;
+            bool synced = false; // set once a consumer has synced with the range so the next ranged modification starts a new range
+        };
+        mutable ModifiedRange _modifiedRange;
+
 #if 1
     public:
         /// deprecated: provided for backwards compatibility, use Properties instead.
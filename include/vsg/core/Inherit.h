@@ -29,7 +29,11 @@ namespace vsg
     public:
         template<typename... Args>
         Inherit(Args&&... args) :
-            ParentClass(args...) {}
+            ParentClass(args...)
+        {
+            // assigned at each level of the class hierarchy so the most derived class's tag is the one that remains
+            this->_setRecordTag(static_cast<uint8_t>(record_tag_v<Subclass>));
+        }
 
         template<typename... Args>
         static ref_ptr<Subclass> create(Args&&... args)
@@ -89,14 +89,55 @@ namespace vsg
         virtual void write(Output& output) const;
 
         // ref counting methods
-        inline void ref() const noexcept { _referenceCount.fetch_add(1, std::memory_order_relaxed); }
+        inline void ref() const noexcept
+        {
+            if (_threadConfined)
+                _referenceCount.store(_referenceCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            else
+                _referenceCount.fetch_add(1, std::memory_order_relaxed);
+        }
         inline void unref() const noexcept
         {
-            if (_referenceCount.fetch_sub(1, std::memory_order_seq_cst) <= 1) _attemptDelete();
+            if (_threadConfined)
+            {
+                auto count = _referenceCount.load(std::memory_order_relaxed);
+                _referenceCount.store(count - 1, std::memory_order_relaxed);
+                if (count <= 1) _attemptDelete();
+            }
+            else if (_referenceCount.fetch_sub(1, std::memory_order_seq_cst) <= 1)
+            {
+                _attemptDelete();
+            }
+        }
+        inline void unref_nodelete() const noexcept
+        {
+            if (_threadConfined)
+                _referenceCount.store(_referenceCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            else
+                _referenceCount.fetch_sub(1, std::memory_order_seq_cst);
         }
-        inline void unref_nodelete() const noexcept { _referenceCount.fetch_sub(1, std::memory_order_seq_cst); }
+        /// tag assigned by Inherit<> for the core node types that RecordTraversal dispatches directly, see vsg::RecordTag
+        uint8_t recordTag() const noexcept { return _recordTag; }
+
         inline unsigned int referenceCount() const noexcept { return _referenceCount.load(); }
 
+        /// increment the reference count unless it's already reached zero, return true if the reference was taken.
+        inline bool ref_if_referenced() const noexcept
+        {
+            auto count = _referenceCount.load(std::memory_order_relaxed);
+            while (count > 0)
+            {
+                if (_referenceCount.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed)) return true;
+            }
+            return false;
+        }
+
+        /// when enabled ref() and unref() use plain loads and stores rather than atomic read-modify-write operations,
+        /// only safe while all references to the object are created and released by a single thread, such as while a subgraph is being built or loaded.
+        /// Disable before the object is shared with other threads, the hand over to the other threads must synchronize, for instance via a mutex guarded queue.
+        void setThreadConfined(bool confined) const noexcept { _threadConfined = confined; }
+        bool getThreadConfined() const noexcept { return _threadConfined; }
+
         /// meta data access methods
         /// wraps the value with a vsg::Value<T> object and then assigns via setObject(key, vsg::Value<T>)
         template<typename T>
@@ -154,10 +195,14 @@ namespace vsg
         virtual void _attemptDelete() const;
         void setAuxiliary(Auxiliary* auxiliary);
 
+        void _setRecordTag(uint8_t tag) noexcept { _recordTag = tag; }
+
     private:
         friend class Auxiliary;
 
         mutable std::atomic_uint _referenceCount;
+        mutable bool _threadConfined = false;
+        uint8_t _recordTag = 0; // fits in the padding after _threadConfined so doesn't increase the size of Object
 
         Auxiliary* _auxiliary;
     };
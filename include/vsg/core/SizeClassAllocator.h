@@ -0,0 +1,75 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Allocator.h>
+
+namespace vsg
+{
+
+    /** Allocator that serves small ALLOCATOR_AFFINITY_OBJECTS/NODES allocations from segregated size classes rather than MemorySlots.
+      * Each size class carves fixed sized slots out of slabs of memory, freed slots are kept on intrusive free lists with a per thread cache
+      * so the common allocate/deallocate path takes no locks and allocates no bookkeeping nodes.
+      * Allocations larger than maxSizeClassSize and ALLOCATOR_AFFINITY_DATA allocations are passed on to the base Allocator's MemoryBlocks.
+      * To select at runtime replace the Allocator singleton, retaining the original so it can deallocate memory it's already allocated:
+      *     vsg::Allocator::instance().reset(new vsg::SizeClassAllocator(std::move(vsg::Allocator::instance())));
+      */
+    class VSG_DECLSPEC SizeClassAllocator : public Allocator
+    {
+    public:
+        explicit SizeClassAllocator(std::unique_ptr<Allocator> in_nestedAllocator = {});
+
+        ~SizeClassAllocator() override;
+
+        void* allocate(std::size_t size, AllocatorAffinity allocatorAffinity = ALLOCATOR_AFFINITY_OBJECTS) override;
+
+        bool deallocate(void* ptr, std::size_t size) override;
+
+        size_t totalAvailableSize() const override;
+
+        size_t totalReservedSize() const override;
+
+        size_t totalMemorySize() const override;
+
+        void report(std::ostream& out) const override;
+
+        /// largest allocation served from the size classes
+        static constexpr size_t maxSizeClassSize = 4096;
+
+        /// size classes are 16 byte multiples up to 256 bytes, then powers of two up to maxSizeClassSize
+        static constexpr size_t numSizeClasses = 20;
+
+        /// size of the blocks of memory that each size class divides into slots, slabs are aligned to their size
+        static constexpr size_t slabSize = 256 * 1024;
+
+        /// maximum number of free slots each thread retains per size class before returning half of them to the shared free list
+        uint32_t threadCacheSize = 64;
+
+        /// return the size class index to use for an allocation of specified size
+        static size_t sizeClass(size_t size);
+
+        /// return the size of the slots in specified size class
+        static size_t slotSize(size_t sizeClass);
+
+    protected:
+        struct Pools;
+        struct ThreadCache;
+
+        /// return this thread's cache, or nullptr if it's already been destroyed during thread exit
+        ThreadCache* _getThreadCache();
+
+        std::shared_ptr<Pools> _pools;
+        const uint64_t _instanceID;
+    };
+
+} // namespace vsg
@@ -29,6 +29,7 @@ namespace vsg
     class Commands;
     class Group;
     class QuadGroup;
+    class SpatialGroup;
     class LOD;
     class PagedLOD;
     class StateGroup;
@@ -48,6 +49,7 @@ namespace vsg
     class PointLight;
     class SpotLight;
     class InstrumentationNode;
+    class InstanceNode;
 
     // forward declare text classes
     class Text;
@@ -93,6 +95,8 @@ namespace vsg
     class DynamicState;
     class ResourceHints;
     class ClearAttachments;
+    class SetViewport;
+    class SetScissor;
     class ClearColorImage;
     class ClearDepthStencilImage;
     class QueryPool;
@@ -288,6 +292,7 @@ namespace vsg
         virtual void apply(Commands&);
         virtual void apply(Group&);
         virtual void apply(QuadGroup&);
+        virtual void apply(SpatialGroup&);
         virtual void apply(LOD&);
         virtual void apply(PagedLOD&);
         virtual void apply(StateGroup&);
@@ -307,6 +312,7 @@ namespace vsg
         virtual void apply(PointLight&);
         virtual void apply(SpotLight&);
         virtual void apply(InstrumentationNode&);
+        virtual void apply(InstanceNode&);
 
         // text
         virtual void apply(Text&);
@@ -351,6 +357,8 @@ namespace vsg
         virtual void apply(Draw&);
         virtual void apply(DrawIndexed&);
         virtual void apply(ClearAttachments&);
+        virtual void apply(SetViewport&);
+        virtual void apply(SetScissor&);
         virtual void apply(ClearColorImage&);
         virtual void apply(ClearDepthStencilImage&);
         virtual void apply(QueryPool&);
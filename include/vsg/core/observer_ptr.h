@@ -18,7 +18,7 @@ namespace vsg
 {
 
     /// weak smart pointer that works in conjunction with vsg::ref_ptr<> and vsg::Object/vsg::Auxiliary to
-    /// provide broadly similar functionality to std::weak_ptr<>.
+    /// provide broadly similar functionality to std::weak_ptr<>. Promotion to ref_ptr is lock free, the Auxiliary acts as the weak reference control block.
     template<class T>
     class observer_ptr
     {
@@ -125,13 +125,12 @@ namespace vsg
         template<class R>
         operator vsg::ref_ptr<R>() const
         {
-            if (!_auxiliary) return vsg::ref_ptr<R>();
+            if (!_auxiliary || !_auxiliary->refConnectedObject()) return vsg::ref_ptr<R>();
 
-            std::scoped_lock<std::mutex> guard(_auxiliary->getMutex());
-            if (_auxiliary->getConnectedObject() != nullptr)
-                return vsg::ref_ptr<R>(_ptr);
-            else
-                return {};
+            // transfer the reference taken by refConnectedObject() to the returned ref_ptr
+            vsg::ref_ptr<R> result(_ptr);
+            _ptr->unref_nodelete();
+            return result;
         }
 
     protected:
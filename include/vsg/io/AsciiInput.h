@@ -18,13 +18,17 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/ObjectFactory.h>
 #include <vsg/io/Options.h>
 
+#include <charconv>
 #include <fstream>
+#include <string_view>
+#include <vector>
 
 namespace vsg
 {
 
     /// vsg::Input subclass that implements reading from an ascii input stream.
     /// Used by VSG ReaderWriter when reading native .vsgt ascii files.
+    /// The stream is read in large blocks that are tokenized in memory, with numbers parsed using std::from_chars, so reading may consume data beyond the end of the object being read.
     class VSG_DECLSPEC AsciiInput : public vsg::Input
     {
     public:
@@ -38,40 +42,36 @@ namespace vsg
 
         OptionalObjectID objectID();
 
+        /// parse the next token as an integer, value is set to 0 if the token isn't a valid integer
+        template<typename T>
+        void _parse(T& value)
+        {
+            auto token = _token();
+            if (std::from_chars(token.data(), token.data() + token.size(), value).ec != std::errc()) value = 0;
+        }
+
+        /// parse the next token as a floating point number, value is set to 0 if the token isn't a valid number
+        void _parse(float& value);
+        void _parse(double& value);
+
         template<typename T>
         void _read(size_t num, T* value)
         {
-            if (num == 1)
-            {
-                _input >> *value;
-            }
-            else
+            for (; num > 0; --num, ++value)
             {
-                for (; num > 0; --num, ++value)
-                {
-                    _input >> *value;
-                }
+                _parse(*value);
             }
         }
 
         template<typename R, typename T>
         void _read_withcast(size_t num, T* value)
         {
-            if (num == 1)
+            R v;
+            for (; num > 0; --num, ++value)
             {
-                R v;
-                _input >> v;
+                _parse(v);
                 *value = static_cast<T>(v);
             }
-            else
-            {
-                R v;
-                for (; num > 0; --num, ++value)
-                {
-                    _input >> v;
-                    *value = static_cast<T>(v);
-                }
-            }
         }
 
         // read value(s)
@@ -105,8 +105,21 @@ namespace vsg
         vsg::ref_ptr<vsg::Object> read() override;
 
     protected:
+        /// return the next whitespace delimited token, the returned string_view is only valid until the next read from the buffer
+        std::string_view _token();
+
+        /// get the next character, returns false at the end of the stream
+        bool _get(char& c);
+
+        /// discard the buffered characters before keep, then read more of the stream into the buffer, returns false if no more could be read
+        bool _fill(size_t keep);
+
         std::istream& _input;
 
+        std::vector<char> _buffer;
+        size_t _position = 0;
+        size_t _end = 0;
+
         std::string _readPropertyName;
     };
 
@@ -17,6 +17,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Output.h>
 
 #include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <fstream>
 
 namespace vsg
@@ -24,71 +26,60 @@ namespace vsg
 
     /// vsg::Output subclass that implements writing objects as ascii data to an output stream.
     /// Used by VSG ReaderWriter when writing objects to native .vsgt ascii files.
+    /// Output is formatted into a memory buffer, with numbers formatted using std::to_chars, and written to the output stream in large blocks.
     class VSG_DECLSPEC AsciiOutput : public vsg::Output
     {
     public:
         explicit AsciiOutput(std::ostream& output, ref_ptr<const Options> in_options = {});
+        ~AsciiOutput();
 
-        std::ostream& indent()
+        /// write the buffered output to the output stream
+        void flush();
+
+        void indent()
         {
-            _output.write(_indentationString, std::min(_indentation, _maximumIndentation));
-            return _output;
+            _append(_indentationString, std::min(_indentation, _maximumIndentation));
         }
 
         /// write property name if appropriate for format
         void writePropertyName(const char* propertyName) override;
 
         /// write end of line as an \n
-        void writeEndOfLine() override { _output << '\n'; }
+        void writeEndOfLine() override { _append('\n'); }
 
         template<typename T>
         void _write(size_t num, const T* value)
         {
-            if (num == 1)
-            {
-                _output << ' ' << *value;
-            }
-            else
+            for (size_t numInRow = 1; num > 0; --num, ++value, ++numInRow)
             {
-                for (size_t numInRow = 1; num > 0; --num, ++value, ++numInRow)
+                _append(' ');
+                _appendNumber(*value);
+
+                if (numInRow == _maximumNumbersPerLine && num > 1)
                 {
-                    _output << ' ' << *value;
-
-                    if (numInRow == _maximumNumbersPerLine && num > 1)
-                    {
-                        numInRow = 0;
-                        writeEndOfLine();
-                        indent();
-                    }
+                    numInRow = 0;
+                    writeEndOfLine();
+                    indent();
                 }
             }
         }
 
         template<typename T>
-        void _write_real(size_t num, const T* value)
+        void _write_real(size_t num, const T* value, int precision)
         {
-            if (num == 1)
+            for (size_t numInRow = 1; num > 0; --num, ++value, ++numInRow)
             {
+                _append(' ');
                 if (std::isfinite(*value))
-                    _output << ' ' << *value;
+                    _appendReal(*value, precision);
                 else
-                    _output << ' ' << 0.0; // fallback to using 0.0 when the value is NaN or Infinite to prevent problems when reading
-            }
-            else
-            {
-                for (size_t numInRow = 1; num > 0; --num, ++value, ++numInRow)
+                    _append('0'); // fallback to using 0.0 when the value is NaN or Infinite to prevent problems when reading
+
+                if (numInRow == _maximumNumbersPerLine && num > 1)
                 {
-                    if (std::isfinite(*value))
-                        _output << ' ' << *value;
-                    else
-                        _output << ' ' << 0.0; // fallback to using 0.0 when the value is NaN or Infinite to prevent problems when reading
-
-                    if (numInRow == _maximumNumbersPerLine && num > 1)
-                    {
-                        numInRow = 0;
-                        writeEndOfLine();
-                        indent();
-                    }
+                    numInRow = 0;
+                    writeEndOfLine();
+                    indent();
                 }
             }
         }
@@ -96,22 +87,16 @@ namespace vsg
         template<typename R, typename T>
         void _write_withcast(size_t num, const T* value)
         {
-            if (num == 1)
+            for (size_t numInRow = 1; num > 0; --num, ++value, ++numInRow)
             {
-                _output << ' ' << static_cast<R>(*value);
-            }
-            else
-            {
-                for (size_t numInRow = 1; num > 0; --num, ++value, ++numInRow)
+                _append(' ');
+                _appendNumber(static_cast<R>(*value));
+
+                if (numInRow == _maximumNumbersPerLine && num > 1)
                 {
-                    _output << ' ' << static_cast<R>(*value);
-
-                    if (numInRow == _maximumNumbersPerLine && num > 1)
-                    {
-                        numInRow = 0;
-                        writeEndOfLine();
-                        indent();
-                    }
+                    numInRow = 0;
+                    writeEndOfLine();
+                    indent();
                 }
             }
         }
@@ -126,28 +111,20 @@ namespace vsg
         void write(size_t num, const uint32_t* value) override { _write(num, value); }
         void write(size_t num, const int64_t* value) override { _write(num, value); }
         void write(size_t num, const uint64_t* value) override { _write(num, value); }
-        void write(size_t num, const float* value) override
-        {
-            _output.precision(float_precision);
-            _write_real(num, value);
-        }
-        void write(size_t num, const double* value) override
-        {
-            _output.precision(double_precision);
-            _write_real(num, value);
-        }
+        void write(size_t num, const float* value) override { _write_real(num, value, float_precision); }
+        void write(size_t num, const double* value) override { _write_real(num, value, double_precision); }
 
         void _write(const std::string& str)
         {
-            _output << '"';
+            _append('"');
             for (auto c : str)
             {
                 if (c == '"')
-                    _output << "\\\"";
+                    _append("\\\"", 2);
                 else
-                    _output << c;
+                    _append(c);
             }
-            _output << '"';
+            _append('"');
         }
 
         void _write(const std::wstring& str);
@@ -163,7 +140,34 @@ namespace vsg
         int double_precision = 12;
 
     protected:
+        void _append(char c)
+        {
+            if (_buffer.size() >= _blockSize) flush();
+            _buffer.push_back(c);
+        }
+
+        void _append(const char* str, size_t length)
+        {
+            if (_buffer.size() + length > _blockSize) flush();
+            _buffer.append(str, length);
+        }
+
+        void _append(const char* str) { _append(str, std::strlen(str)); }
+
+        template<typename T>
+        void _appendNumber(T value)
+        {
+            char str[24];
+            auto result = std::to_chars(str, str + sizeof(str), value);
+            _append(str, static_cast<size_t>(result.ptr - str));
+        }
+
+        /// append value formatted to match std::ostream's default floating point formatting with the specified precision
+        void _appendReal(double value, int precision);
+
         std::ostream& _output;
+        std::string _buffer;
+        std::size_t _blockSize = 1024 * 1024;
         std::size_t _indentationStep = 2;
         std::size_t _indentation = 0;
         std::size_t _maximumIndentation = 0;
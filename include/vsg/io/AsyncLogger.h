@@ -0,0 +1,92 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+
+namespace vsg
+{
+
+    /// Logger that queues messages on a bounded lock free ring buffer and writes them to an output Logger from a background thread,
+    /// so threads logging messages don't serialize on a mutex or stall on console I/O.
+    /// Messages are formatted into per thread streams then copied into fixed size records, messages longer than maxMessageLength are truncated.
+    /// When the ring buffer is full messages are dropped rather than blocking, the number dropped is reported by the background thread.
+    /// Level checks are done before any formatting so disabled levels have only the cost of a comparison.
+    /// To use the AsyncLogger use:
+    ///     vsg::Logger::instance() = AsyncLogger::create();
+    class VSG_DECLSPEC AsyncLogger : public Inherit<Logger, AsyncLogger>
+    {
+    public:
+        static constexpr size_t maxMessageLength = 500;
+
+        /// create AsyncLogger that writes to in_output, the output level is set to LOGGER_ALL so the AsyncLogger::level controls which messages are written.
+        /// in_capacity is rounded up to a power of two.
+        explicit AsyncLogger(ref_ptr<Logger> in_output = StdLogger::create(), size_t in_capacity = 1024);
+
+        /// Logger that messages are written to by the background thread
+        const ref_ptr<Logger> output;
+
+        /// write all the queued messages to the output and flush it.
+        void flush() override;
+
+        /// number of messages dropped as the ring buffer was full
+        uint64_t dropped() const { return _dropped.load(); }
+
+    protected:
+        virtual ~AsyncLogger();
+
+        struct Record
+        {
+            std::atomic_size_t sequence{0};
+            Level level = LOGGER_INFO;
+            uint32_t length = 0;
+            char text[maxMessageLength];
+        };
+
+        void _push(Level msg_level, const std::string_view& message);
+        bool _pop(Level& msg_level, std::string& message);
+
+        /// write queued messages to output, returns true if any messages were written.
+        bool _drain();
+        void _run();
+
+        void debug_implementation(const std::string_view& message) override;
+        void info_implementation(const std::string_view& message) override;
+        void warn_implementation(const std::string_view& message) override;
+        void error_implementation(const std::string_view& message) override;
+        void fatal_implementation(const std::string_view& message) override;
+
+        size_t _mask = 0;
+        std::unique_ptr<Record[]> _records;
+
+        alignas(64) std::atomic_size_t _head{0};
+        alignas(64) std::atomic_size_t _tail{0};
+        alignas(64) std::atomic_uint64_t _dropped{0};
+        uint64_t _reportedDropped = 0;
+
+        std::mutex _drainMutex;
+        std::string _message;
+
+        std::atomic_bool _active{true};
+        std::atomic_bool _sleeping{false};
+        std::mutex _sleepMutex;
+        std::condition_variable _sleepCV;
+        std::thread _thread;
+    };
+    VSG_type_name(vsg::AsyncLogger);
+
+} // namespace vsg
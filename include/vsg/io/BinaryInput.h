@@ -74,8 +74,36 @@ namespace vsg
         /// read object
         vsg::ref_ptr<vsg::Object> read() override;
 
+        /// read the codec of the block of array data and skip any padding before it, returning mappedStorage when the uncompressed block lies within it.
+        ref_ptr<Data> mapData(size_t size, size_t& offset) override;
+
+        /// decompress a compressed block of array data directly into ptr, using Options::operationThreads when available to decompress chunks in parallel.
+        /// Invalid chunk headers, sizes beyond the end of the file or decompression errors zero the values and set the stream's failbit.
+        bool readData(void* ptr, size_t valueSize, size_t count) override;
+
+        /// true when reading a file written with BinaryOutput::alignedData set, where blocks of array data are padded to MappedFile::alignment(size) from the start of the stream.
+        bool alignedData = false;
+
+        /// memory mapped file that the input stream is reading from, used as the storage for aligned array data so that it isn't copied.
+        ref_ptr<Data> mappedStorage;
+
     protected:
         std::istream& _input;
+
+        /// read the table of chunks written by BinaryOutput::chunked and decode the chunks, using Options::operationThreads when available to decode independent chunks in parallel.
+        void _readChunks();
+
+        struct ClassEntry
+        {
+            std::string className;
+            const ObjectFactory::CreateFunction* createFunction = nullptr;
+        };
+
+        /// codec of the block of array data read by mapData() and to be decompressed by readData()
+        uint8_t _dataCodec = 0;
+
+        /// table of the classes defined so far in the file, indexed by type ID - 1, used by files written by VSG 1.1.2 and later
+        std::vector<ClassEntry> _classEntries;
     };
 
 } // namespace vsg
@@ -16,10 +16,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Output.h>
 
 #include <fstream>
+#include <set>
 
 namespace vsg
 {
 
+    // forward declare
+    class Group;
+
     /// vsg::Output subclass that implements writing objects as binary data to an output stream.
     /// Used by VSG ReaderWriter when writing objects to native .vsgb binary files.
     class VSG_DECLSPEC BinaryOutput : public vsg::Output
@@ -61,8 +65,42 @@ namespace vsg
         /// write object
         void write(const vsg::Object* object) override;
 
+        /// write array data, compressing it when enabled, otherwise pad the output so the data starts at MappedFile::alignment(size) from the start of the stream.
+        bool writeData(const void* ptr, size_t valueSize, size_t count, bool integerValues) override;
+
+        /// when true array data is aligned so the file can be memory mapped on reading, requires the output stream to support tellp().
+        bool alignedData = false;
+
+        /// compression of array data, set from the "compression" Options value, supported by VSG 1.1.4 and later files.
+        /// "lz" compresses all arrays with the general purpose LZ codec, "auto" selects COMPRESSION_DELTA_LZ for integer arrays such as indices,
+        /// COMPRESSION_SHUFFLE_LZ for other multi-byte values such as vertex attributes and COMPRESSION_LZ for byte data.
+        std::string compression;
+
+        /// arrays smaller than minimumCompressionSize bytes are not compressed
+        size_t minimumCompressionSize = 1024;
+
+        /// compressed arrays are divided into independently compressed chunks of about compressionChunkSize bytes so they can be decompressed in parallel
+        size_t compressionChunkSize = 256 * 1024;
+
+        /// when true and the root object is a Group, its children are each written as a self contained chunk listed in a table of contents
+        /// ahead of the root object so that BinaryInput can decode them on multiple threads. Set from the "chunked" Options value, requires VSG 1.1.7 and later files.
+        bool chunked = false;
+
+        /// object ID written in place of the root object's ID to mark that a table of chunks follows
+        static constexpr uint32_t chunkTableID = 0xffffffff;
+
     protected:
         std::ostream& _output;
+
+        /// write each child of group as a separate chunk preceded by the table of chunks
+        void _writeChunks(const Group& group);
+
+        /// first object ID assigned within the chunk being written, references to objects with lower IDs are recorded in _referencedIDs
+        ObjectID _chunkFirstID = 0;
+        std::set<ObjectID> _referencedIDs;
+
+        /// type IDs assigned to the classes written so far, used when writing VSG 1.1.2 and later files
+        std::unordered_map<std::string, uint32_t> _classIDMap;
     };
 
 } // namespace vsg
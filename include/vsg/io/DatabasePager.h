@@ -13,16 +13,24 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/app/CompileManager.h>
+#include <vsg/app/DeleteQueue.h>
 #include <vsg/core/Inherit.h>
 #include <vsg/core/observer_ptr.h>
+#include <vsg/io/DatabasePrefetcher.h>
 #include <vsg/io/FileSystem.h>
 #include <vsg/io/Options.h>
 #include <vsg/nodes/PagedLOD.h>
 #include <vsg/threading/ActivityStatus.h>
+#include <vsg/threading/OperationQueue.h>
+#include <vsg/threading/OperationThreads.h>
 #include <vsg/utils/Instrumentation.h>
+#include <vsg/utils/TextureTranscoder.h>
+#include <vsg/utils/WorkloadRecorder.h>
+#include <vsg/vk/MemoryBudget.h>
 
 #include <condition_variable>
 #include <list>
+#include <map>
 #include <thread>
 
 namespace vsg
@@ -48,13 +56,14 @@ namespace vsg
         std::vector<const PagedLOD*> newHighresRequired;
     };
 
-    /// Thread safe queue for tracking PagedLOD that needs to be loaded, compiled or merged by the DatabasePager
+    /// Thread safe queue for tracking PagedLOD that needs to be loaded, compiled or merged by the DatabasePager.
+    /// Entries are held in a max heap ordered by the PagedLOD::priority recorded when added or last reprioritized.
     class VSG_DECLSPEC DatabaseQueue : public Inherit<Object, DatabaseQueue>
     {
     public:
         explicit DatabaseQueue(ref_ptr<ActivityStatus> status);
 
-        using Nodes = std::list<ref_ptr<PagedLOD>>;
+        using Nodes = std::vector<ref_ptr<PagedLOD>>;
 
         ActivityStatus* getStatus() { return _status; }
         const ActivityStatus* getStatus() const { return _status; }
@@ -63,16 +72,39 @@ namespace vsg
 
         void add(ref_ptr<PagedLOD> plod, const CompileResult& cr);
 
+        /// take the highest priority PagedLOD, waiting until one is available or the status is no longer active
         ref_ptr<PagedLOD> take_when_available();
 
+        /// take the highest priority PagedLOD if one is available, otherwise return null
+        ref_ptr<PagedLOD> take();
+
         Nodes take_all(CompileResult& result);
 
+        /// take up to maxNumNodes PagedLOD in priority order, along with the CompileResult accumulated for all the queued PagedLOD
+        Nodes take(size_t maxNumNodes, CompileResult& result);
+
+        /// refresh the priorities of all queued PagedLOD and reorder the queue to match,
+        /// removing and returning the PagedLOD whose high res child hasn't been required within maxFrameDelta frames of frameCount.
+        Nodes reprioritize(uint64_t frameCount, uint64_t maxFrameDelta = 1);
+
+        size_t size() const;
+
     protected:
         virtual ~DatabaseQueue();
 
-        std::mutex _mutex;
+        struct Entry
+        {
+            double priority = 0.0;
+            ref_ptr<PagedLOD> plod;
+
+            bool operator<(const Entry& rhs) const { return priority < rhs.priority; }
+        };
+
+        void _push(ref_ptr<PagedLOD> plod);
+
+        mutable std::mutex _mutex;
         std::condition_variable _cv;
-        Nodes _queue;
+        std::vector<Entry> _queue;
         CompileResult _compileResult;
         ref_ptr<ActivityStatus> _status;
     };
@@ -96,7 +128,13 @@ namespace vsg
 
         ref_ptr<CompileManager> compileManager;
 
+        /// optional threads to share for reading and compiling, such as a Viewer's JobSystem, if not assigned start() creates dedicated read threads.
+        ref_ptr<OperationThreads> operationThreads;
+
         std::atomic_uint numActiveRequests{0};
+
+        /// return the number of loaded PagedLOD subgraphs waiting to be merged by updateSceneGraph()
+        size_t numPendingMerges() const { return _toMergeQueue ? _toMergeQueue->size() : 0; }
         std::atomic_uint64_t frameCount;
 
         ref_ptr<CulledPagedLODs> culledPagedLODs;
@@ -104,6 +142,57 @@ namespace vsg
         /// for systems with smaller GPU memory limits you may need to reduce the targetMaxNumPagedLODWithHighResSubgraphs to keep memory usage within available limits.
         uint32_t targetMaxNumPagedLODWithHighResSubgraphs = 1500;
 
+        /// when non zero, inactive PagedLOD subgraphs are expired in least recently used order until the CPU memory of the merged high res subgraphs is below this number of bytes.
+        uint64_t targetMaxDataSize = 0;
+
+        /// when non zero, inactive PagedLOD subgraphs are expired in least recently used order until the device memory of the merged high res subgraphs is below this number of bytes.
+        uint64_t targetMaxDeviceMemorySize = 0;
+
+        /// CPU memory in bytes of the currently merged high res subgraphs
+        uint64_t totalDataSize = 0;
+
+        /// device memory in bytes of the currently merged high res subgraphs
+        uint64_t totalDeviceMemorySize = 0;
+
+        /// optional MemoryBudget used to expire inactive PagedLOD subgraphs when the device local memory usage exceeds targetMaxMemoryUsageRatio of the budget.
+        /// For the budget to account for memory used by other applications enable the VK_EXT_memory_budget extension when creating the Device.
+        ref_ptr<MemoryBudget> memoryBudget;
+
+        /// proportion of the memoryBudget's device local budget above which inactive PagedLOD subgraphs are expired
+        double targetMaxMemoryUsageRatio = 0.9;
+
+        /// maximum number of loaded PagedLOD subgraphs merged in each updateSceneGraph(), 0 for no limit. The remainder are merged in later frames in priority order.
+        uint32_t maxNumMergesPerFrame = 0;
+
+        /// maximum time in milliseconds spent merging loaded PagedLOD subgraphs in each updateSceneGraph(), 0.0 for no limit. At least one subgraph is merged per frame.
+        double maxMergeTimePerFrame = 0.0;
+
+        /// when true and no operationThreads are assigned, start() sets up a staged pipeline of I/O, decode and compile threads, each with their own queue,
+        /// so that slow file reads don't hold up decoding and compiling of files that have already been read.
+        bool stagedReading = false;
+
+        /// number of staged pipeline threads that read file contents into memory
+        uint32_t numIOThreads = 8;
+
+        /// number of staged pipeline threads that decode the file contents into subgraphs, 0 uses half the available cores
+        uint32_t numDecodeThreads = 0;
+
+        /// maximum number of decoded subgraphs that the staged pipeline compiles together in a single compile submission
+        uint32_t maxCompileBatchSize = 4;
+
+        /// read each PagedLOD subgraph with its own AllocatorArena, so that when the subgraph is expired its memory is freed all at once rather than per object.
+        bool useAllocatorArenas = false;
+
+        /// queue that expired PagedLOD subgraphs are moved to so that their CPU and Vulkan resources are released on a background thread
+        /// once the GPU has finished with them, the thread is started by start(). Set to null to release expired subgraphs immediately.
+        ref_ptr<DeleteQueue> deleteQueue;
+
+        /// optional DatabasePrefetcher that requests the PagedLOD high res subgraphs required at predicted camera positions ahead of time
+        ref_ptr<DatabasePrefetcher> prefetcher;
+
+        /// optional TextureTranscoder used on the read threads to convert the textures of loaded subgraphs to block compressed formats before they are compiled
+        ref_ptr<TextureTranscoder> textureTranscoder;
+
         std::mutex pendingPagedLODMutex;
 
         ref_ptr<PagedLODContainer> pagedLODContainer;
@@ -114,17 +203,64 @@ namespace vsg
         /// assign Instrumentation to all CompileTraversal and their associated Context
         void assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation);
 
+        /// optional WorkloadRecorder that requests and merges are logged to
+        ref_ptr<WorkloadRecorder> workloadRecorder;
+
     protected:
         virtual ~DatabasePager();
 
+        /// read and compile the subgraph for the PagedLOD, moving it to the merge queue on success
+        void readAndCompile(ref_ptr<PagedLOD> plod);
+
         void requestDiscarded(PagedLOD* plod);
 
+        /// state of a PagedLOD read as it passes through the staged pipeline
+        struct StagedRead : public Object
+        {
+            ref_ptr<PagedLOD> plod;
+            ref_ptr<ActivityStatus> readStatus;
+            ref_ptr<Options> readOptions;
+            Path filename;
+            std::vector<uint8_t> contents;
+            ref_ptr<Node> subgraph;
+        };
+
+        using StagedReadQueue = ThreadSafeQueue<ref_ptr<StagedRead>>;
+
+        /// staged pipeline I/O stage, read the contents of the file into memory and pass on to the decode stage
+        void readFileContents(ref_ptr<PagedLOD> plod);
+
+        /// staged pipeline decode stage, decode the file contents into a subgraph and pass on to the compile stage
+        void decode(ref_ptr<StagedRead> stagedRead);
+
+        /// staged pipeline compile stage, compile a batch of decoded subgraphs together and move them to the merge queue
+        void compile(std::vector<ref_ptr<StagedRead>>& batch);
+
+        /// check the PagedLOD is still required and set up the cancellation token for its read, returns null if the request has been discarded
+        ref_ptr<StagedRead> beginRead(ref_ptr<PagedLOD> plod);
+
+        /// remove the read from the active reads, discarding the request and returning false if it has been cancelled
+        bool endRead(StagedRead& stagedRead);
+
+        /// signal reads of PagedLOD that are no longer required to abort, checked via Options::activityStatus
+        void cancelExpiredReads();
+
+        /// cancel all in flight reads
+        void cancelAllReads();
+
         ref_ptr<ActivityStatus> _status;
 
         ref_ptr<DatabaseQueue> _requestQueue;
         ref_ptr<DatabaseQueue> _toMergeQueue;
 
+        ref_ptr<StagedReadQueue> _decodeQueue;
+        ref_ptr<StagedReadQueue> _compileQueue;
+
         std::list<std::thread> _readThreads;
+        std::thread _deleteThread;
+
+        std::mutex _activeReadsMutex;
+        std::map<ref_ptr<PagedLOD>, ref_ptr<ActivityStatus>> _activeReads;
     };
     VSG_type_name(vsg::DatabasePager);
 
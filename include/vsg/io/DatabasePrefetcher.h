@@ -0,0 +1,92 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/Camera.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/threading/OperationThreads.h>
+#include <vsg/ui/FrameStamp.h>
+#include <vsg/utils/AnimationPath.h>
+
+namespace vsg
+{
+
+    // forward declare
+    class DatabasePager;
+
+    /// DatabasePrefetcher predicts where a Camera will be in the near future and requests the PagedLOD high res subgraphs
+    /// that will be required there, so that they are loaded before the RecordTraversal finds that they are needed.
+    /// The camera position is extrapolated from the velocity of recent view matrices, or read ahead along the AnimationPath
+    /// when an animationPathHandler is assigned. Predicted requests are given a lower priority than those made by the RecordTraversal.
+    /// Assign to DatabasePager::prefetcher, the evaluation is run on a background thread between successive DatabasePager::updateSceneGraph() calls.
+    class VSG_DECLSPEC DatabasePrefetcher : public Inherit<Object, DatabasePrefetcher>
+    {
+    public:
+        DatabasePrefetcher(ref_ptr<Node> in_scene, ref_ptr<Camera> in_camera);
+
+        /// scene graph to evaluate at the predicted camera positions
+        ref_ptr<Node> scene;
+
+        /// camera whose motion is predicted, its projectionMatrix is used for the predicted views
+        ref_ptr<Camera> camera;
+
+        /// optional AnimationPathHandler animating the camera, when assigned the predicted positions are taken from its path rather than extrapolated
+        ref_ptr<AnimationPathHandler> animationPathHandler;
+
+        /// how far ahead in seconds to predict the camera position
+        double lookAheadTime = 1.0;
+
+        /// number of predicted positions evaluated between now and lookAheadTime
+        uint32_t numSteps = 4;
+
+        /// weighting of the latest velocity sample when smoothing the camera velocity, in the range 0 to 1
+        double velocitySmoothing = 0.5;
+
+        /// minimum camera speed in units per second for an extrapolated prediction to be evaluated
+        double minimumSpeed = 1e-3;
+
+        /// scale applied to the priority of predicted requests so that requests for currently visible PagedLOD are read first
+        double priorityScale = 0.25;
+
+        /// bandwidth budget, the maximum number of predicted requests issued in each frame
+        uint32_t maxRequestsPerFrame = 4;
+
+        /// bandwidth budget, predicted requests are only issued while the DatabasePager has fewer than this number of active requests
+        uint32_t maxActiveRequests = 16;
+
+        /// number of predicted requests issued by the last evaluation
+        std::atomic_uint numRequestsIssued{0};
+
+        /// sample the camera and start the evaluation of the predicted positions, called by DatabasePager::updateSceneGraph() once merging is complete.
+        virtual void dispatch(DatabasePager& databasePager, const FrameStamp* frameStamp);
+
+        /// wait for the last dispatched evaluation to complete, called by DatabasePager::updateSceneGraph() before modifying the scene graph.
+        virtual void wait();
+
+        /// evaluate the PagedLOD required for the predicted view matrices, issuing requests to the databasePager
+        virtual void evaluate(DatabasePager& databasePager, const std::vector<dmat4>& predictedViewMatrices);
+
+    protected:
+        virtual ~DatabasePrefetcher();
+
+        bool _previousSampleValid = false;
+        time_point _previousTime;
+        dvec3 _previousEye;
+        dvec3 _velocity;
+
+        ref_ptr<Latch> _latch;
+        ref_ptr<OperationThreads> _threads;
+    };
+    VSG_type_name(vsg::DatabasePrefetcher);
+
+} // namespace vsg
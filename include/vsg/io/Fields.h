@@ -0,0 +1,162 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Input.h>
+#include <vsg/io/Output.h>
+
+#include <tuple>
+#include <type_traits>
+
+namespace vsg
+{
+
+    /// Field describes a serialized member of class C, of type T stored in files as type W.
+    /// A list of Fields declared for a class can be passed to readFields()/writeFields() in place of a chain of input.read(..)/output.write(..) calls,
+    /// for binary streams contiguous runs of plain value fields are then read/written with a single call.
+    template<class C, typename T, typename W = T>
+    struct Field
+    {
+        using value_type = T;
+        using stored_type = W;
+
+        const char* name;
+        T C::*member;
+
+        /// true if the value is stored in binary streams as the raw bytes of the member, so can be copied directly to/from memory
+        static constexpr bool raw()
+        {
+            if constexpr (std::is_same_v<T, W>)
+                return std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && !has_read_write<T>();
+            else
+                return sizeof(T) == sizeof(W) && (std::is_integral_v<T> || std::is_enum_v<T>) && (std::is_integral_v<W> || std::is_enum_v<W>);
+        }
+
+        template<class O>
+        void read(Input& input, O& object) const
+        {
+            if constexpr (std::is_same_v<T, W>)
+                input.read(name, object.*member);
+            else
+                input.readValue<W>(name, object.*member);
+        }
+
+        template<class O>
+        void write(Output& output, const O& object) const
+        {
+            if constexpr (std::is_same_v<T, W>)
+                output.write(name, object.*member);
+            else
+                output.writeValue<W>(name, object.*member);
+        }
+    };
+
+    /// declare a field stored as its own type
+    template<class C, typename T>
+    constexpr Field<C, T> field(const char* name, T C::*member)
+    {
+        return Field<C, T>{name, member};
+    }
+
+    /// declare a field stored as type W, equivalent to input.readValue<W>(name, member)/output.writeValue<W>(name, member)
+    template<typename W, class C, typename T>
+    constexpr Field<C, T, W> fieldAs(const char* name, T C::*member)
+    {
+        return Field<C, T, W>{name, member};
+    }
+
+    /// declare the list of fields in the order they are serialized
+    template<class... F>
+    constexpr std::tuple<F...> fields(F... f)
+    {
+        return std::tuple<F...>(f...);
+    }
+
+    /// read the fields of object in the order they are declared
+    template<class O, class... F>
+    void readFields(Input& input, O& object, const std::tuple<F...>& fieldList)
+    {
+        if (!input.rawFields)
+        {
+            std::apply([&](auto&... f) { (f.read(input, object), ...); }, fieldList);
+            return;
+        }
+
+        // accumulate runs of raw fields that are adjacent in memory so each run is read in one call
+        uint8_t* begin = nullptr;
+        uint8_t* end = nullptr;
+        auto flush = [&]() {
+            if (begin != end) input.read(static_cast<size_t>(end - begin), begin);
+            begin = end = nullptr;
+        };
+        auto readField = [&](auto& f) {
+            using FieldType = std::decay_t<decltype(f)>;
+            if constexpr (FieldType::raw())
+            {
+                auto ptr = reinterpret_cast<uint8_t*>(&(object.*f.member));
+                if (ptr != end)
+                {
+                    flush();
+                    begin = ptr;
+                }
+                end = ptr + sizeof(typename FieldType::value_type);
+            }
+            else
+            {
+                flush();
+                f.read(input, object);
+            }
+        };
+        std::apply([&](auto&... f) { (readField(f), ...); }, fieldList);
+        flush();
+    }
+
+    /// write the fields of object in the order they are declared
+    template<class O, class... F>
+    void writeFields(Output& output, const O& object, const std::tuple<F...>& fieldList)
+    {
+        if (!output.rawFields)
+        {
+            std::apply([&](auto&... f) { (f.write(output, object), ...); }, fieldList);
+            return;
+        }
+
+        const uint8_t* begin = nullptr;
+        const uint8_t* end = nullptr;
+        auto flush = [&]() {
+            if (begin != end) output.write(static_cast<size_t>(end - begin), begin);
+            begin = end = nullptr;
+        };
+        auto writeField = [&](auto& f) {
+            using FieldType = std::decay_t<decltype(f)>;
+            if constexpr (FieldType::raw())
+            {
+                auto ptr = reinterpret_cast<const uint8_t*>(&(object.*f.member));
+                if (ptr != end)
+                {
+                    flush();
+                    begin = ptr;
+                }
+                end = ptr + sizeof(typename FieldType::value_type);
+            }
+            else
+            {
+                flush();
+                f.write(output, object);
+            }
+        };
+        std::apply([&](auto&... f) { (writeField(f), ...); }, fieldList);
+        flush();
+    }
+
+} // namespace vsg
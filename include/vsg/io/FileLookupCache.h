@@ -0,0 +1,85 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Inherit.h>
+#include <vsg/io/Path.h>
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace vsg
+{
+
+    /// FileLookupCache caches the results of file existence checks made by vsg::findFile(filename, options), including files that don't exist,
+    /// so repeated searches of Options::paths don't have to stat each candidate file.
+    /// Directories can be indexed with a single directory listing, after which lookups of files in them don't touch the filesystem.
+    /// Assign to Options::fileLookupCache, the cache is thread safe and split into shards that are locked independently so it can be shared by DatabasePager threads.
+    class VSG_DECLSPEC FileLookupCache : public Inherit<Object, FileLookupCache>
+    {
+    public:
+        explicit FileLookupCache(double in_expiryTime = 0.0);
+
+        /// time in seconds after which cached entries are discarded and the filesystem is checked again, 0 for entries that never expire
+        double expiryTime = 0.0;
+
+        /// when true the first lookup in a directory lists the whole directory with addDirectory(..) rather than checking just the one file,
+        /// useful for paged databases with many files per directory on filesystems where each file check is expensive.
+        bool indexDirectoriesOnLookup = false;
+
+        /// return true if the file exists, using the cached result when available
+        bool fileExists(const Path& path);
+
+        /// list the contents of directory and add it to the index so that subsequent lookups of files in it are answered from the listing
+        void addDirectory(const Path& directory);
+
+        /// discard any cached result for path and any index of the directory it's in
+        void invalidate(const Path& path);
+
+        /// discard all cached results
+        void clear();
+
+    protected:
+        virtual ~FileLookupCache();
+
+        using time_point = std::chrono::steady_clock::time_point;
+
+        struct Directory
+        {
+            std::set<Path> contents;
+            time_point timestamp;
+        };
+
+        struct Shard
+        {
+            std::mutex mutex;
+            std::map<Path, std::pair<bool, time_point>> files;
+            std::map<Path, Directory> directories;
+        };
+
+        static constexpr size_t numShards = 16;
+
+        Shard& _shard(const Path& directory);
+
+        /// list the directory and add it to the index, returning true if name is in the directory
+        bool _indexDirectory(const Path& directory, const Path& name);
+        bool _expired(const time_point& timestamp, const time_point& now) const;
+
+        std::array<Shard, numShards> _shards;
+    };
+    VSG_type_name(vsg::FileLookupCache);
+
+} // namespace vsg
@@ -47,6 +47,15 @@ namespace vsg
     /// return true if a specified file/path exists on system.
     extern VSG_DECLSPEC bool fileExists(const Path& path);
 
+    /// get the size in bytes and the last modification time, in seconds since the epoch, of a file, return false if the file doesn't exist.
+    extern VSG_DECLSPEC bool fileStatus(const Path& path, uint64_t& size, int64_t& modificationTime);
+
+    /// remove a file, return true on success.
+    extern VSG_DECLSPEC bool removeFile(const Path& path);
+
+    /// rename a file, replacing any existing file at the destination, return true on success.
+    extern VSG_DECLSPEC bool renameFile(const Path& from, const Path& to);
+
     /// return the full filename path if specified filename can be found in the list of paths.
     extern VSG_DECLSPEC Path findFile(const Path& filename, const Paths& paths);
 
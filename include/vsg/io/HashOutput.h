@@ -0,0 +1,69 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Output.h>
+
+namespace vsg
+{
+
+    /// vsg::Output subclass that computes a 64 bit FNV-1a hash of the values written rather than writing them to a stream.
+    /// Objects provide their structural hash via their write(Output&) implementation, so objects that compare() as equal hash to the same value.
+    /// Used by SharedObjects to find potential matches in a hash table before falling back to compare().
+    class VSG_DECLSPEC HashOutput : public vsg::Output
+    {
+    public:
+        explicit HashOutput(ref_ptr<const Options> in_options = {});
+
+        uint64_t value;
+
+        /// combine bytes into the hash value
+        void add(const void* ptr, size_t size);
+
+        template<typename T>
+        void _write(size_t num, const T* value)
+        {
+            add(value, num * sizeof(T));
+        }
+
+        /// property names are the same for all instances of a type so aren't included in the hash
+        void writePropertyName(const char*) override {}
+        void writeEndOfLine() override {}
+
+        // write contiguous array of value(s)
+        void write(size_t num, const int8_t* value) override { _write(num, value); }
+        void write(size_t num, const uint8_t* value) override { _write(num, value); }
+        void write(size_t num, const int16_t* value) override { _write(num, value); }
+        void write(size_t num, const uint16_t* value) override { _write(num, value); }
+        void write(size_t num, const int32_t* value) override { _write(num, value); }
+        void write(size_t num, const uint32_t* value) override { _write(num, value); }
+        void write(size_t num, const int64_t* value) override { _write(num, value); }
+        void write(size_t num, const uint64_t* value) override { _write(num, value); }
+        void write(size_t num, const float* value) override { _write(num, value); }
+        void write(size_t num, const double* value) override { _write(num, value); }
+
+        void write(size_t num, const std::string* value) override;
+        void write(size_t num, const std::wstring* value) override;
+        void write(size_t num, const Path* value) override;
+
+        /// hash the object's type and the values it writes, objects already hashed contribute their ObjectID
+        void write(const vsg::Object* object) override;
+
+        /// hash array data directly rather than value by value
+        bool writeData(const void* ptr, size_t valueSize, size_t count, bool integerValues) override;
+    };
+
+    /// convenience function for computing the structural hash of an object using HashOutput
+    extern VSG_DECLSPEC uint64_t hash(const Object* object);
+
+} // namespace vsg
@@ -68,6 +68,15 @@ namespace vsg
         // read object
         virtual ref_ptr<Object> read() = 0;
 
+        /// called by Arrays of plain value types before reading a block of size bytes of array data, if the input is able to reference the data in place,
+        /// such as BinaryInput reading a memory mapped file, return the Data that holds the block and set offset to its start
+        /// and skip past it, otherwise return null and the block is read via readData().
+        virtual ref_ptr<Data> mapData(size_t /*size*/, size_t& /*offset*/) { return {}; }
+
+        /// called by Arrays to read count values of valueSize bytes into ptr when mapData() hasn't mapped them.
+        /// Return true if the input has read the data itself, such as BinaryInput decompressing it, otherwise the values are read as normal.
+        virtual bool readData(void* /*ptr*/, size_t /*valueSize*/, size_t /*count*/) { return false; }
+
         // map char to int8_t
         void read(size_t num, char* value) { read(num, reinterpret_cast<int8_t*>(value)); }
         void read(size_t num, bool* value) { read(num, reinterpret_cast<int8_t*>(value)); }
@@ -245,6 +254,9 @@ namespace vsg
 
         VsgVersion version;
 
+        /// true when values are stored as native binary with no property names, used by readFields() to read contiguous fields in a single read.
+        bool rawFields = false;
+
         virtual bool version_less(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion = 0) const;
         virtual bool version_greater_equal(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion = 0) const;
 
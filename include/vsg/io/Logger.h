@@ -57,7 +57,7 @@ namespace vsg
         {
             if (level > LOGGER_DEBUG) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
+            auto lock = _lock();
             debug_implementation(str);
         }
 
@@ -66,12 +66,10 @@ namespace vsg
         {
             if (level > LOGGER_DEBUG) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
-            _stream.str({});
-            _stream.clear();
-            (_stream << ... << args);
+            auto& stream = _format(args...);
 
-            debug_implementation(_stream.str());
+            auto lock = _lock();
+            debug_implementation(stream.str());
         }
 
         inline void info(char* message) { info(std::string_view(message)); }
@@ -83,7 +81,7 @@ namespace vsg
         {
             if (level > LOGGER_INFO) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
+            auto lock = _lock();
             info_implementation(str);
         }
 
@@ -92,12 +90,10 @@ namespace vsg
         {
             if (level > LOGGER_INFO) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
-            _stream.str({});
-            _stream.clear();
-            (_stream << ... << args);
+            auto& stream = _format(args...);
 
-            info_implementation(_stream.str());
+            auto lock = _lock();
+            info_implementation(stream.str());
         }
 
         inline void warn(char* message) { warn(std::string_view(message)); }
@@ -109,7 +105,7 @@ namespace vsg
         {
             if (level > LOGGER_WARN) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
+            auto lock = _lock();
             warn_implementation(str);
         }
 
@@ -118,12 +114,10 @@ namespace vsg
         {
             if (level > LOGGER_WARN) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
-            _stream.str({});
-            _stream.clear();
-            (_stream << ... << args);
+            auto& stream = _format(args...);
 
-            warn_implementation(_stream.str());
+            auto lock = _lock();
+            warn_implementation(stream.str());
         }
 
         inline void error(char* message) { error(std::string_view(message)); }
@@ -135,7 +129,7 @@ namespace vsg
         {
             if (level > LOGGER_DEBUG) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
+            auto lock = _lock();
             error_implementation(str);
         }
 
@@ -144,12 +138,10 @@ namespace vsg
         {
             if (level > LOGGER_ERROR) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
-            _stream.str({});
-            _stream.clear();
-            (_stream << ... << args);
+            auto& stream = _format(args...);
 
-            error_implementation(_stream.str());
+            auto lock = _lock();
+            error_implementation(stream.str());
         }
 
         inline void fatal(char* message) { fatal(std::string_view(message)); }
@@ -161,7 +153,7 @@ namespace vsg
         {
             if (level > LOGGER_DEBUG) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
+            auto lock = _lock();
             fatal_implementation(str);
         }
 
@@ -170,12 +162,10 @@ namespace vsg
         {
             if (level > LOGGER_ERROR) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
-            _stream.str({});
-            _stream.clear();
-            (_stream << ... << args);
+            auto& stream = _format(args...);
 
-            fatal_implementation(_stream.str());
+            auto lock = _lock();
+            fatal_implementation(stream.str());
         }
 
         using PrintToStreamFunction = std::function<void(std::ostream&)>;
@@ -209,18 +199,16 @@ namespace vsg
         {
             if (level > msg_level) return;
 
-            std::scoped_lock<std::mutex> lock(_mutex);
-            _stream.str({});
-            _stream.clear();
-            (_stream << ... << args);
+            auto& stream = _format(args...);
 
+            auto lock = _lock();
             switch (msg_level)
             {
-            case (LOGGER_DEBUG): debug_implementation(_stream.str()); break;
-            case (LOGGER_INFO): info_implementation(_stream.str()); break;
-            case (LOGGER_WARN): warn_implementation(_stream.str()); break;
-            case (LOGGER_ERROR): error_implementation(_stream.str()); break;
-            case (LOGGER_FATAL): fatal_implementation(_stream.str()); break;
+            case (LOGGER_DEBUG): debug_implementation(stream.str()); break;
+            case (LOGGER_INFO): info_implementation(stream.str()); break;
+            case (LOGGER_WARN): warn_implementation(stream.str()); break;
+            case (LOGGER_ERROR): error_implementation(stream.str()); break;
+            case (LOGGER_FATAL): fatal_implementation(stream.str()); break;
             default: break;
             }
         }
@@ -232,7 +220,24 @@ namespace vsg
         virtual ~Logger();
 
         std::mutex _mutex;
-        std::ostringstream _stream;
+
+        /// when true the *_implementation() methods are called with _mutex locked, subclasses with thread safe implementations can set this to false
+        bool _serializeImplementation = true;
+
+        std::unique_lock<std::mutex> _lock() { return _serializeImplementation ? std::unique_lock<std::mutex>(_mutex) : std::unique_lock<std::mutex>(_mutex, std::defer_lock); }
+
+        /// per thread stream used to format messages so formatting doesn't require _mutex to be locked
+        static std::ostringstream& _threadStream();
+
+        template<typename... Args>
+        std::ostringstream& _format(Args&&... args)
+        {
+            auto& stream = _threadStream();
+            stream.str({});
+            stream.clear();
+            (stream << ... << args);
+            return stream;
+        }
 
         virtual void debug_implementation(const std::string_view& message) = 0;
         virtual void info_implementation(const std::string_view& message) = 0;
@@ -0,0 +1,74 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2018 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Data.h>
+#include <vsg/core/Inherit.h>
+#include <vsg/io/Path.h>
+
+namespace vsg
+{
+
+    /// MappedFile memory maps a file, copy on write, so that its contents can be referenced in place by vsg::Array storage rather than read into separately allocated memory.
+    /// The mapping is released when the MappedFile is destroyed, so Arrays that reference it via their storage keep it in memory.
+    /// properties.allocatorType is ALLOCATOR_TYPE_NO_DELETE so Arrays referencing a MappedFile write their data in place rather than writing the MappedFile.
+    class VSG_DECLSPEC MappedFile : public Inherit<Data, MappedFile>
+    {
+    public:
+        explicit MappedFile(const Path& filename);
+
+        /// return true if the file was successfully mapped
+        bool valid() const { return _data != nullptr; }
+
+        /// return the alignment from the start of the file used by BinaryOutput/BinaryInput for a block of data of specified size.
+        /// Large blocks are page aligned, smaller blocks are aligned sufficiently for all vsg::Array value types.
+        static constexpr size_t alignment(size_t size) { return size >= 65536 ? 4096 : 16; }
+
+        const uint8_t* data() const { return _data; }
+        size_t size() const { return _size; }
+
+        ref_ptr<Data> clone() const override;
+
+        size_t valueSize() const override { return 1; }
+        size_t valueCount() const override { return _size; }
+
+        bool dataAvailable() const override { return _data != nullptr; }
+        size_t dataSize() const override { return _size; }
+
+        void* dataPointer() override { return _data; }
+        const void* dataPointer() const override { return _data; }
+
+        void* dataPointer(size_t index) override { return _data + index; }
+        const void* dataPointer(size_t index) const override { return _data + index; }
+
+        void* dataRelease() override { return nullptr; }
+
+        uint32_t dimensions() const override { return 1; }
+
+        uint32_t width() const override { return static_cast<uint32_t>(_size); }
+        uint32_t height() const override { return 1; }
+        uint32_t depth() const override { return 1; }
+
+    protected:
+        virtual ~MappedFile();
+
+        uint8_t* _data = nullptr;
+        size_t _size = 0;
+
+#if defined(WIN32) && !defined(__CYGWIN__)
+        void* _fileMapping = nullptr;
+#endif
+    };
+    VSG_type_name(vsg::MappedFile);
+
+} // namespace vsg
@@ -17,6 +17,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace vsg
 {
@@ -33,22 +34,49 @@ namespace vsg
         using CreateFunction = std::function<vsg::ref_ptr<vsg::Object>()>;
         using CreateMap = std::map<std::string, CreateFunction>;
 
-        CreateMap& getCreateMap() { return _createMap; }
+        /// return the CreateMap for modification, as entries may be removed this disables the hash index used by getCreateFunction(..) until buildIndex() or add<T>() is called.
+        CreateMap& getCreateMap()
+        {
+            _indexValid = false;
+            return _createMap;
+        }
         const CreateMap& getCreateMap() const { return _createMap; }
 
+        /// return the CreateFunction registered for className, or nullptr if none is registered.
+        /// Lookups use an open addressing hash index of the class names so don't require string comparisons down a tree or any allocations.
+        /// Allows readers to look up each class once and then create instances directly, such as the per file type ID table used by BinaryInput.
+        const CreateFunction* getCreateFunction(const std::string& className) const;
+
         template<class T>
         void add()
         {
-            _createMap[type_name<T>()] = []() { return T::create(); };
+            auto [itr, inserted] = _createMap.insert_or_assign(type_name<T>(), CreateFunction([]() { return T::create(); }));
+            _addToIndex(itr);
         }
 
+        /// rebuild the hash index from the CreateMap, required after entries have been added or removed via getCreateMap().
+        void buildIndex();
+
         /// return the ObjectFactory singleton instance
         static ref_ptr<ObjectFactory>& instance();
 
     protected:
         virtual ~ObjectFactory();
 
+        struct IndexEntry
+        {
+            size_t hash = 0;
+            CreateMap::const_iterator itr;
+            bool used = false;
+        };
+
+        void _addToIndex(CreateMap::const_iterator itr);
+
         CreateMap _createMap;
+
+        std::vector<IndexEntry> _index;
+        size_t _indexSize = 0;
+        bool _indexValid = false;
     };
 
     // Helper template class for registering the ability to create an Object of specified T on demand.
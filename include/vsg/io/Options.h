@@ -14,9 +14,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/core/Inherit.h>
 #include <vsg/core/observer_ptr.h>
+#include <vsg/io/FileLookupCache.h>
 #include <vsg/io/FileSystem.h>
 #include <vsg/maths/transform.h>
 #include <vsg/state/StateCommand.h>
+#include <vsg/threading/ActivityStatus.h>
 #include <vsg/utils/Instrumentation.h>
 
 namespace vsg
@@ -60,6 +62,9 @@ namespace vsg
         ReaderWriters readerWriters;
         ref_ptr<OperationThreads> operationThreads;
 
+        /// optional cancellation token, when activityStatus->cancel() returns true reads should be aborted and return as soon as possible.
+        ref_ptr<ActivityStatus> activityStatus;
+
         /// Hint to use when searching for Paths with vsg::findFile(filename, options);
         enum FindFileHint
         {
@@ -74,11 +79,24 @@ namespace vsg
         using FindFileCallback = std::function<Path(const Path& filename, const Options* options)>;
         FindFileCallback findFileCallback;
 
+        /// optional cache of file lookups used by vsg::findFile(filename, options), can be shared between Options objects and threads.
+        ref_ptr<FileLookupCache> fileLookupCache;
+
         Path fileCache;
 
         Path extensionHint;
         bool mapRGBtoRGBAHint = true;
 
+        /// Hint for whether the CPU copies of STATIC_DATA arrays read from files are released once they've been transferred to the GPU,
+        /// selected arrays are assigned STATIC_DATA_UNREF_AFTER_TRANSFER as they're read.
+        enum ReleaseDataHint
+        {
+            KEEP_DATA,          /// keep all arrays, required for the CPU intersection and recompiling on other devices
+            RELEASE_IMAGE_DATA, /// release 2D and 3D arrays, such as textures, keeping 1D arrays such as vertex arrays for intersection
+            RELEASE_ALL_DATA    /// release all arrays once transferred
+        };
+        ReleaseDataHint releaseDataHint = KEEP_DATA;
+
         /// Coordinate convention to use for scene graph
         CoordinateConvention sceneCoordinateConvention = CoordinateConvention::Z_UP;
 
@@ -91,6 +109,8 @@ namespace vsg
         ///     "phong" will substitute for vsg::createPhongShaderSet()
         ///     "flat" will substitute for vsg::createFlatShadedShaderSet()
         ///     "text" will substitute for vsg::createTextShaderSet()
+        ///     "multiview_pbr" will substitute for vsg::createMultiviewPhysicsBasedRenderingShaderSet()
+        ///     "multiview_phong" will substitute for vsg::createMultiviewPhongShaderSet()
         std::map<std::string, ref_ptr<ShaderSet>> shaderSets;
 
         /// specification of any StateCommands that will be provided the parents of any newly created subgraphs
@@ -68,6 +68,11 @@ namespace vsg
         /// write object
         virtual void write(const Object* object) = 0;
 
+        /// called by Arrays of plain value types to write count values of valueSize bytes, integerValues is true for arrays of integers such as indices.
+        /// Return true if the output has written the data itself, such as BinaryOutput compressing it, otherwise the values are written as normal.
+        /// Binary outputs may also pad the output before the values so they can be memory mapped when read back.
+        virtual bool writeData(const void* /*ptr*/, size_t /*valueSize*/, size_t /*count*/, bool /*integerValues*/) { return false; }
+
         /// map char to int8_t
         void write(size_t num, const char* value) { write(num, reinterpret_cast<const int8_t*>(value)); }
         void write(size_t num, const bool* value) { write(num, reinterpret_cast<const int8_t*>(value)); }
@@ -204,6 +209,9 @@ namespace vsg
 
         VsgVersion version;
 
+        /// true when values are written as native binary with no property names, used by writeFields() to write contiguous fields in a single write.
+        bool rawFields = false;
+
         virtual bool version_less(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion = 0) const;
         virtual bool version_greater_equal(uint32_t major, uint32_t minor, uint32_t patch, uint32_t soversion = 0) const;
 
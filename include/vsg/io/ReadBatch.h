@@ -0,0 +1,123 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/CompileManager.h>
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/Options.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <deque>
+#include <functional>
+
+namespace vsg
+{
+
+    /// ReadRequest holds the result of reading a single file as part of a ReadBatch.
+    /// The object and compileResult members are only valid once completed() returns true.
+    class VSG_DECLSPEC ReadRequest : public Inherit<Object, ReadRequest>
+    {
+    public:
+        explicit ReadRequest(const Path& in_filename);
+
+        const Path filename;
+
+        /// object read from file, null if the read failed or was cancelled
+        ref_ptr<Object> object;
+
+        /// result of compiling object, only set when the ReadBatch has a CompileManager assigned
+        CompileResult compileResult;
+
+        /// return true if the read, and compile when required, has completed
+        bool completed() const { return _latch->is_ready(); }
+
+        /// block until the request has completed, then return the object read
+        ref_ptr<Object> wait()
+        {
+            _latch->wait();
+            return object;
+        }
+
+    protected:
+        virtual ~ReadRequest();
+
+        friend class ReadBatch;
+
+        ref_ptr<Latch> _latch;
+    };
+    VSG_type_name(vsg::ReadRequest);
+
+    /// ReadBatch provides asynchronous reading of files, returning a ReadRequest for each filename that completes independently of the others.
+    /// Reads are run on the OperationThreads, with no more than maxConcurrentReads running at any one time,
+    /// and when a CompileManager is assigned each object is compiled as soon as it has been read, overlapping disk I/O, parsing and compilation.
+    /// Callbacks are invoked from the reading threads so must be thread safe, to merge results into a running Viewer's scene graph use Viewer::addUpdateOperation() and updateViewer().
+    class VSG_DECLSPEC ReadBatch : public Inherit<Object, ReadBatch>
+    {
+    public:
+        explicit ReadBatch(ref_ptr<const Options> in_options = {}, ref_ptr<CompileManager> in_compileManager = {});
+
+        /// Options passed to vsg::read(..)
+        ref_ptr<const Options> options;
+
+        /// optional CompileManager used to compile each object as soon as it has been read
+        ref_ptr<CompileManager> compileManager;
+
+        /// threads to run reads on, if not assigned options->operationThreads is used, otherwise a dedicated OperationThreads with maxConcurrentReads threads is created
+        ref_ptr<OperationThreads> operationThreads;
+
+        /// maximum number of reads that may run at one time
+        uint32_t maxConcurrentReads = 4;
+
+        using CompletedCallback = std::function<void(ReadRequest&)>;
+        using ProgressCallback = std::function<void(size_t numCompleted, size_t numRequests)>;
+
+        /// invoked as each ReadRequest completes
+        CompletedCallback completedCallback;
+
+        /// invoked after each ReadRequest completes with the number completed and total number requested
+        ProgressCallback progressCallback;
+
+        /// queue a read of filename, returning immediately
+        ref_ptr<ReadRequest> read(const Path& filename);
+
+        /// queue reads of filenames, returning immediately with a ReadRequest for each filename
+        std::vector<ref_ptr<ReadRequest>> read(const Paths& filenames);
+
+        /// block until all the requested reads have completed
+        void wait();
+
+        size_t numRequests() const;
+        size_t numCompleted() const;
+
+    protected:
+        /// abandons reads that haven't started and waits for the active ones to complete
+        virtual ~ReadBatch();
+
+        struct ReadOperation;
+
+        /// take next pending request, return null and decrement the active count if none are pending
+        ref_ptr<ReadRequest> _takeRequest();
+
+        void _process(ReadRequest& request);
+
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<ref_ptr<ReadRequest>> _pending;
+        uint32_t _numActive = 0;
+        size_t _numRequests = 0;
+        size_t _numCompleted = 0;
+    };
+    VSG_type_name(vsg::ReadBatch);
+
+} // namespace vsg
@@ -0,0 +1,87 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/Options.h>
+
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// TileCache provides a two level cache of tile subgraphs for the vsg::tile ReaderWriter,
+    /// an in-memory LRU cache of recently created tiles backed by an LRU disk cache of .vsgb files.
+    /// Disk cache files older than maxAge are discarded, and the least recently used files are removed when the total size exceeds maxDiskSize.
+    class VSG_DECLSPEC TileCache : public Inherit<Object, TileCache>
+    {
+    public:
+        TileCache(const Path& in_directory, uint64_t in_maxDiskSize = 0, double in_maxAge = 0.0, uint32_t in_maxMemoryTiles = 0);
+
+        /// directory that disk cache files are written to, if empty only the memory cache is used
+        const Path directory;
+
+        /// maximum total size in bytes of the disk cache files, 0 for no limit
+        const uint64_t maxDiskSize;
+
+        /// maximum age in seconds of disk cache files, 0 for no limit
+        const double maxAge;
+
+        /// maximum number of tiles retained in memory, 0 disables the memory cache
+        const uint32_t maxMemoryTiles;
+
+        /// return the cached tile for key, checking the memory cache first, then the disk cache. Returns null if not cached.
+        ref_ptr<Object> read(const Path& key, ref_ptr<const Options> options) const;
+
+        /// add tile to the memory and disk caches, evicting entries as required to stay within the cache limits
+        void write(const Path& key, ref_ptr<Object> object, ref_ptr<const Options> options) const;
+
+        /// return total size in bytes of the disk cache files
+        uint64_t diskSize() const;
+
+    protected:
+        virtual ~TileCache();
+
+        struct DiskEntry
+        {
+            uint64_t size = 0;
+            int64_t modificationTime = 0;
+            std::list<Path>::iterator itr;
+        };
+
+        using MemoryEntries = std::list<std::pair<Path, ref_ptr<Object>>>;
+
+        /// shift key to the most recently used position in the memory cache, adding it if required
+        void _touchMemory(const Path& key, ref_ptr<Object> object) const;
+
+        /// remove least recently used disk entries until the total size is within maxDiskSize
+        void _evictDiskEntries() const;
+
+        void _removeDiskEntry(std::map<Path, DiskEntry>::iterator itr) const;
+        bool _expired(const DiskEntry& entry, int64_t now) const;
+        Path _filename(const Path& key) const;
+
+        mutable std::mutex _mutex;
+
+        mutable MemoryEntries _memoryEntries;
+        mutable std::map<Path, MemoryEntries::iterator> _memoryLookup;
+
+        mutable std::list<Path> _diskLRU;
+        mutable std::map<Path, DiskEntry> _diskEntries;
+        mutable uint64_t _diskSize = 0;
+    };
+    VSG_type_name(vsg::TileCache);
+
+} // namespace vsg
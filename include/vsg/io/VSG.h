@@ -41,6 +41,7 @@ namespace vsg
         {
             BINARY,
             ASCII,
+            MAPPABLE_BINARY, ///< binary with array data aligned so it can be referenced in place from a memory mapped file, written when the "mappable" Options value is true
             NOT_RECOGNIZED
         };
 
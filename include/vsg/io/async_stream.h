@@ -0,0 +1,71 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Export.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace vsg
+{
+
+    /// Output stream that double buffers writes into large blocks and writes the filled blocks to the destination stream on a background thread,
+    /// so that serializing the next block overlaps with the disk writes of the previous block.
+    /// The destination stream has to be kept in memory for the duration of the async_ostream existence.
+    /// tellp() is supported when the destination stream supports it, so BinaryOutput::alignedData can be used with an async_ostream.
+    class VSG_DECLSPEC async_ostream : public std::ostream
+    {
+    public:
+        explicit async_ostream(std::ostream& destination, size_t bufferSize = 4 * 1024 * 1024);
+        ~async_ostream();
+
+    private:
+        struct async_buffer : public std::streambuf
+        {
+            async_buffer(std::ostream& in_destination, size_t bufferSize);
+            ~async_buffer();
+
+            int_type overflow(int_type c) override;
+            std::streamsize xsputn(const char_type* s, std::streamsize n) override;
+            int sync() override;
+            pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+            /// hand the filled portion of the current buffer to the background thread and switch to the other buffer
+            void submit();
+
+            /// wait for the background thread to complete writing the submitted buffer
+            void wait();
+
+            void run();
+
+            std::ostream& destination;
+            std::vector<char> buffers[2];
+            size_t current = 0;
+            size_t submitted = 0;
+            size_t pending = 0;
+            bool seekable = false;
+            bool failed = false;
+            bool active = true;
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::thread thread;
+        };
+
+        async_buffer _buffer;
+    };
+
+} // namespace vsg
@@ -0,0 +1,39 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2018 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Export.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vsg
+{
+
+    /// codecs used to compress blocks of array data in .vsgb files
+    enum CompressionCodec : uint8_t
+    {
+        COMPRESSION_NONE = 0,
+        COMPRESSION_LZ = 1,         ///< general purpose LZ77 byte codec
+        COMPRESSION_SHUFFLE_LZ = 2, ///< byte planes of each component shuffled together before LZ, suited to vertex attribute arrays
+        COMPRESSION_DELTA_LZ = 3    ///< zigzag encoded deltas between consecutive values, shuffled before LZ, suited to index arrays
+    };
+
+    /// compress size bytes of data made up of values of valueSize bytes, appending the result to dest.
+    extern VSG_DECLSPEC void compress(CompressionCodec codec, const uint8_t* src, size_t size, size_t valueSize, std::vector<uint8_t>& dest);
+
+    /// decompress srcSize bytes of compressed data into the destSize bytes pointed to by dest, return false if the compressed data is invalid.
+    extern VSG_DECLSPEC bool decompress(CompressionCodec codec, const uint8_t* src, size_t srcSize, uint8_t* dest, size_t destSize, size_t valueSize);
+
+} // namespace vsg
@@ -12,11 +12,16 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/Array.h>
+#include <vsg/core/Value.h>
 #include <vsg/io/ReaderWriter.h>
+#include <vsg/io/TileCache.h>
 #include <vsg/nodes/TileDatabase.h>
+#include <vsg/state/BindDescriptorSet.h>
 #include <vsg/state/GraphicsPipeline.h>
 #include <vsg/utils/GraphicsPipelineConfigurator.h>
 #include <vsg/utils/ShaderSet.h>
+#include <vsg/utils/TerrainHeightQuery.h>
 
 namespace vsg
 {
@@ -52,17 +57,36 @@ namespace vsg
         ref_ptr<Object> read_root(ref_ptr<const Options> options = {}) const;
         ref_ptr<Object> read_subtile(uint32_t x, uint32_t y, uint32_t lod, ref_ptr<const Options> options = {}) const;
 
-        ref_ptr<Node> createTile(const dbox& tile_extents, ref_ptr<Data> sourceData) const;
-        ref_ptr<Node> createECEFTile(const dbox& tile_extents, ref_ptr<Data> sourceData) const;
+        ref_ptr<Node> createTile(const dbox& tile_extents, ref_ptr<Data> sourceData, ref_ptr<ElevationGrid> elevationGrid = {}) const;
+        ref_ptr<Node> createECEFTile(const dbox& tile_extents, ref_ptr<Data> sourceData, ref_ptr<ElevationGrid> elevationGrid = {}) const;
         ref_ptr<Node> createTextureQuad(const dbox& tile_extents, ref_ptr<Data> sourceData) const;
 
         ref_ptr<StateGroup> createRoot() const;
 
+        /// create an ElevationGrid from elevation data read from the TileDatabaseSettings::terrainLayer, returns null if the data isn't supported.
+        ref_ptr<ElevationGrid> createElevationGrid(uint32_t x, uint32_t y, uint32_t level, ref_ptr<Object> elevationData) const;
+
+        /// add the ElevationGrid of each tile in a loaded tile group to the TerrainHeightQuery assigned to the settings, if any.
+        void addElevationGrids(ref_ptr<Object> object) const;
+
+        /// allocate a page of the TileDatabaseSettings::virtualTexture for the tile's imagery, returns null if the virtual texture isn't used or can't hold the imagery.
+        ref_ptr<VirtualTexture::Page> allocatePage(ref_ptr<Data> textureData) const;
+
         ref_ptr<ShaderSet> _shaderSet;
         ref_ptr<GraphicsPipelineConfigurator> _graphicsPipelineConfig;
         uint32_t _materialSetIndex = 1;
         ref_ptr<Sampler> _sampler;
         ref_ptr<DescriptorBuffer> _material;
+        ref_ptr<TileCache> _cache;
+        ref_ptr<BindDescriptorSet> _virtualTextureBindDescriptorSet;
+
+        // grid resolution of ECEF tiles and the arrays that are shared by all ECEF tiles
+        uint32_t _numRows = 32;
+        uint32_t _numCols = 32;
+        ref_ptr<vec2Array> _bottomLeftTexCoords;
+        ref_ptr<vec2Array> _topLeftTexCoords;
+        ref_ptr<vec4Value> _colors;
+        ref_ptr<ushortArray> _indices;
     };
     VSG_type_name(vsg::tile);
 
@@ -22,4 +22,7 @@ namespace vsg
     /** convenience method for writing objects to file.*/
     extern VSG_DECLSPEC bool write(ref_ptr<Object> object, const Path& filename, ref_ptr<const Options> options = {});
 
+    /** convenience method for writing objects to files, using Options::operationThreads when available to write the files concurrently. Returns true if all the files were written.*/
+    extern VSG_DECLSPEC bool write(const PathObjects& pathObjects, ref_ptr<const Options> options = {});
+
 } // namespace vsg
@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/maths/plane.h>
+#include <vsg/maths/simd.h>
 #include <vsg/maths/vec3.h>
 #include <vsg/maths/vec4.h>
 
@@ -230,4 +231,112 @@ namespace vsg
                          lhs[0] * rhs[2][0] + lhs[1] * rhs[2][1] + lhs[2] * rhs[2][2] + rhs[2][3] * inv);
     }
 
+#if defined(VSG_SIMD_SSE2) || defined(VSG_SIMD_NEON)
+    /// SIMD specialization of float matrix multiplication, as a non template overload it's selected in preference to the template.
+    inline mat4 operator*(const mat4& lhs, const mat4& rhs)
+    {
+        mat4 result;
+#    if defined(VSG_SIMD_SSE2)
+        const __m128 c0 = _mm_loadu_ps(lhs[0].data());
+        const __m128 c1 = _mm_loadu_ps(lhs[1].data());
+        const __m128 c2 = _mm_loadu_ps(lhs[2].data());
+        const __m128 c3 = _mm_loadu_ps(lhs[3].data());
+        for (int c = 0; c < 4; ++c)
+        {
+            const float* r = rhs[c].data();
+            __m128 v = _mm_mul_ps(c0, _mm_set1_ps(r[0]));
+            v = _mm_add_ps(v, _mm_mul_ps(c1, _mm_set1_ps(r[1])));
+            v = _mm_add_ps(v, _mm_mul_ps(c2, _mm_set1_ps(r[2])));
+            v = _mm_add_ps(v, _mm_mul_ps(c3, _mm_set1_ps(r[3])));
+            _mm_storeu_ps(result[c].data(), v);
+        }
+#    else
+        const float32x4_t c0 = vld1q_f32(lhs[0].data());
+        const float32x4_t c1 = vld1q_f32(lhs[1].data());
+        const float32x4_t c2 = vld1q_f32(lhs[2].data());
+        const float32x4_t c3 = vld1q_f32(lhs[3].data());
+        for (int c = 0; c < 4; ++c)
+        {
+            const float* r = rhs[c].data();
+            float32x4_t v = vmulq_n_f32(c0, r[0]);
+            v = vmlaq_n_f32(v, c1, r[1]);
+            v = vmlaq_n_f32(v, c2, r[2]);
+            v = vmlaq_n_f32(v, c3, r[3]);
+            vst1q_f32(result[c].data(), v);
+        }
+#    endif
+        return result;
+    }
+
+    /// SIMD specialization of float matrix * vector multiplication.
+    inline vec4 operator*(const mat4& lhs, const vec4& rhs)
+    {
+        vec4 result;
+#    if defined(VSG_SIMD_SSE2)
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(lhs[0].data()), _mm_set1_ps(rhs[0]));
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(lhs[1].data()), _mm_set1_ps(rhs[1])));
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(lhs[2].data()), _mm_set1_ps(rhs[2])));
+        v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(lhs[3].data()), _mm_set1_ps(rhs[3])));
+        _mm_storeu_ps(result.data(), v);
+#    else
+        float32x4_t v = vmulq_n_f32(vld1q_f32(lhs[0].data()), rhs[0]);
+        v = vmlaq_n_f32(v, vld1q_f32(lhs[1].data()), rhs[1]);
+        v = vmlaq_n_f32(v, vld1q_f32(lhs[2].data()), rhs[2]);
+        v = vmlaq_n_f32(v, vld1q_f32(lhs[3].data()), rhs[3]);
+        vst1q_f32(result.data(), v);
+#    endif
+        return result;
+    }
+#endif
+
+#if defined(VSG_SIMD_SSE2) || defined(VSG_SIMD_NEON64)
+    /// SIMD specialization of double matrix multiplication, uses AVX when available.
+    inline dmat4 operator*(const dmat4& lhs, const dmat4& rhs)
+    {
+        dmat4 result;
+#    if defined(VSG_SIMD_AVX)
+        const __m256d c0 = _mm256_loadu_pd(lhs[0].data());
+        const __m256d c1 = _mm256_loadu_pd(lhs[1].data());
+        const __m256d c2 = _mm256_loadu_pd(lhs[2].data());
+        const __m256d c3 = _mm256_loadu_pd(lhs[3].data());
+        for (int c = 0; c < 4; ++c)
+        {
+            const double* r = rhs[c].data();
+            __m256d v = _mm256_mul_pd(c0, _mm256_set1_pd(r[0]));
+            v = _mm256_add_pd(v, _mm256_mul_pd(c1, _mm256_set1_pd(r[1])));
+            v = _mm256_add_pd(v, _mm256_mul_pd(c2, _mm256_set1_pd(r[2])));
+            v = _mm256_add_pd(v, _mm256_mul_pd(c3, _mm256_set1_pd(r[3])));
+            _mm256_storeu_pd(result[c].data(), v);
+        }
+#    elif defined(VSG_SIMD_SSE2)
+        for (int c = 0; c < 4; ++c)
+        {
+            const double* r = rhs[c].data();
+            for (int h = 0; h < 4; h += 2)
+            {
+                __m128d v = _mm_mul_pd(_mm_loadu_pd(lhs[0].data() + h), _mm_set1_pd(r[0]));
+                v = _mm_add_pd(v, _mm_mul_pd(_mm_loadu_pd(lhs[1].data() + h), _mm_set1_pd(r[1])));
+                v = _mm_add_pd(v, _mm_mul_pd(_mm_loadu_pd(lhs[2].data() + h), _mm_set1_pd(r[2])));
+                v = _mm_add_pd(v, _mm_mul_pd(_mm_loadu_pd(lhs[3].data() + h), _mm_set1_pd(r[3])));
+                _mm_storeu_pd(result[c].data() + h, v);
+            }
+        }
+#    else
+        for (int c = 0; c < 4; ++c)
+        {
+            const double* r = rhs[c].data();
+            for (int h = 0; h < 4; h += 2)
+            {
+                float64x2_t v = vmulq_n_f64(vld1q_f64(lhs[0].data() + h), r[0]);
+                v = vfmaq_n_f64(v, vld1q_f64(lhs[1].data() + h), r[1]);
+                v = vfmaq_n_f64(v, vld1q_f64(lhs[2].data() + h), r[2]);
+                v = vfmaq_n_f64(v, vld1q_f64(lhs[3].data() + h), r[3]);
+                vst1q_f64(result[c].data() + h, v);
+            }
+        }
+#    endif
+        return result;
+    }
+#endif
+
 } // namespace vsg
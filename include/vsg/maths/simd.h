@@ -0,0 +1,34 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+/// Compile time detection of the SIMD instruction sets used by the vsg::maths kernels.
+/// Define VSG_DISABLE_SIMD to fall back to the scalar implementations.
+#if !defined(VSG_DISABLE_SIMD)
+#    if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define VSG_SIMD_SSE2 1
+#        if defined(__AVX__)
+#            define VSG_SIMD_AVX 1
+#        endif
+#        if defined(__AVX2__) && defined(__FMA__)
+#            define VSG_SIMD_AVX2 1
+#        endif
+#        include <immintrin.h>
+#    elif defined(__ARM_NEON) || defined(_M_ARM64)
+#        define VSG_SIMD_NEON 1
+#        if defined(__aarch64__) || defined(_M_ARM64)
+#            define VSG_SIMD_NEON64 1
+#        endif
+#        include <arm_neon.h>
+#    endif
+#endif
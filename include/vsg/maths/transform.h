@@ -139,6 +139,18 @@ namespace vsg
                          0, 0, (zFar * zNear) * r, 0);
     }
 
+    /// create a 4x4 matrix for a Reverse depth perspective matrix with an infinite far plane, the limit of perspective() as zFar tends to infinity.
+    /// Depth goes from 1 at zNear to 0 at infinity, so with a float depth buffer the near plane can be kept small without needing to adjust near/far each frame.
+    template<typename T>
+    constexpr t_mat4<T> infinitePerspective(T fovy_radians, T aspectRatio, T zNear)
+    {
+        T f = static_cast<T>(1.0 / std::tan(fovy_radians * 0.5));
+        return t_mat4<T>(f / aspectRatio, 0, 0, 0,
+                         0, -f, 0, 0,
+                         0, 0, 0, -1,
+                         0, 0, zNear, 0);
+    }
+
     /// create a 4x4 matrix for a Reverse depth perspective matrix, convention: 1 to 0 depth range. Y NDC coordinates are inverted in Vulkan.
     template<typename T>
     constexpr t_mat4<T> perspective(T left, T right, T bottom, T top, T zNear, T zFar)
@@ -213,6 +225,15 @@ namespace vsg
     /// double matrix inversion with automatic selection of inverse_4x3 when appropriate, otherwise uses inverse_4x4
     extern VSG_DECLSPEC dmat4 inverse(const dmat4& m);
 
+    /// transform count vec3 from src by matrix, including the perspective divide, writing the results to dst. Uses SIMD when available, src and dst may be the same array.
+    extern VSG_DECLSPEC void transform(const mat4& matrix, const vec3* src, vec3* dst, size_t count);
+
+    /// transform count vec3 from src by double matrix, including the perspective divide, writing the results to dst. Uses SIMD when available, selecting AVX2 at runtime when supported.
+    extern VSG_DECLSPEC void transform(const dmat4& matrix, const vec3* src, dvec3* dst, size_t count);
+
+    /// transform count dvec3 from src by double matrix, including the perspective divide, writing the results to dst. Uses SIMD when available, selecting AVX2 at runtime when supported.
+    extern VSG_DECLSPEC void transform(const dmat4& matrix, const dvec3* src, dvec3* dst, size_t count);
+
     /// compute determinant of float matrix
     extern VSG_DECLSPEC float determinant(const mat4& m);
 
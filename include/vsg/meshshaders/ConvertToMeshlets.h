@@ -0,0 +1,71 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Visitor.h>
+#include <vsg/io/Options.h>
+#include <vsg/meshshaders/Meshlets.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/material.h>
+
+#include <map>
+
+namespace vsg
+{
+
+    /// ConvertToMeshlets replaces the triangle list VertexIndexDraw and Geometry children of Groups with subgraphs that render
+    /// them as Meshlets using mesh shaders, with per meshlet frustum and back face culling done in the task shader.
+    /// The vertex positions and normals are found using the attribute locations of the VertexInputState of the GraphicsPipeline
+    /// they are drawn with. Instanced draws, and Geometry with non indexed or indirect draw commands, are left unchanged.
+    /// The Device must be created with the VK_EXT_mesh_shader extension and the taskShader and meshShader features enabled.
+    class VSG_DECLSPEC ConvertToMeshlets : public Inherit<Visitor, ConvertToMeshlets>
+    {
+    public:
+        explicit ConvertToMeshlets(ref_ptr<const Options> in_options = {});
+
+        ref_ptr<const Options> options;
+
+        /// ShaderSet used to render the meshlets, defaults to createMeshletPhongShaderSet(options)
+        ref_ptr<ShaderSet> shaderSet;
+
+        /// material assigned to the converted meshes
+        ref_ptr<PhongMaterialValue> material;
+
+        uint32_t vertexLocation = 0;
+        uint32_t normalLocation = 1;
+
+        /// number of draws converted to meshlets
+        uint32_t numConverted = 0;
+
+        void apply(Node& node) override;
+        void apply(Group& group) override;
+        void apply(StateGroup& stateGroup) override;
+        void apply(BindGraphicsPipeline& bindPipeline) override;
+
+    protected:
+        void _convertChildren(Group& group);
+        ref_ptr<Node> _convert(Node& node);
+        void _setUpPipeline();
+
+        GraphicsPipeline* _currentPipeline = nullptr;
+        std::map<const Node*, ref_ptr<Node>> _converted;
+
+        ref_ptr<PipelineLayout> _pipelineLayout;
+        ref_ptr<BindGraphicsPipeline> _bindPipeline;
+        ref_ptr<DescriptorBuffer> _material;
+    };
+    VSG_type_name(vsg::ConvertToMeshlets);
+
+} // namespace vsg
@@ -0,0 +1,98 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/utils/ShaderSet.h>
+
+namespace vsg
+{
+
+    /// Meshlet is a small cluster of triangles, with a bounding sphere and normal cone used for culling in the task shader.
+    /// Layout matches the std430 Meshlet struct used by the meshlet shaders.
+    struct Meshlet
+    {
+        vec4 sphere;             ///< center and radius
+        vec4 cone;               ///< cone axis and cutoff, the meshlet is back facing when dot(normalize(coneApex - eye), axis) >= cutoff
+        vec4 coneApex;           ///< xyz cone apex
+        uint32_t vertexOffset;   ///< offset into meshletVertices
+        uint32_t triangleOffset; ///< offset into meshletTriangles
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+
+        void read(vsg::Input& input)
+        {
+            input.read("sphere", sphere);
+            input.read("cone", cone);
+            input.read("coneApex", coneApex);
+            input.read("vertexOffset", vertexOffset);
+            input.read("triangleOffset", triangleOffset);
+            input.read("vertexCount", vertexCount);
+            input.read("triangleCount", triangleCount);
+        }
+
+        void write(vsg::Output& output) const
+        {
+            output.write("sphere", sphere);
+            output.write("cone", cone);
+            output.write("coneApex", coneApex);
+            output.write("vertexOffset", vertexOffset);
+            output.write("triangleOffset", triangleOffset);
+            output.write("vertexCount", vertexCount);
+            output.write("triangleCount", triangleCount);
+        }
+    };
+
+    template<>
+    constexpr bool has_read_write<Meshlet>() { return true; }
+
+    VSG_array(MeshletArray, Meshlet);
+
+    /// Meshlets splits indexed triangles into meshlets, providing the arrays that are bound as storage buffers for the meshlet shaders.
+    /// Meshlets are built greedily in index order so running MeshOptimizer first improves their locality and reduces their number.
+    class VSG_DECLSPEC Meshlets : public Inherit<Object, Meshlets>
+    {
+    public:
+        Meshlets();
+
+        /// maximum number of vertices and triangles per meshlet, must match the max_vertices and max_primitives of the mesh shader
+        static constexpr uint32_t maxVertices = 64;
+        static constexpr uint32_t maxTriangles = 124;
+
+        /// number of meshlets processed by each task shader workgroup
+        static constexpr uint32_t taskWorkgroupSize = 32;
+
+        ref_ptr<MeshletArray> meshlets;
+        ref_ptr<vec4Array> vertices;
+        ref_ptr<vec4Array> normals;
+        ref_ptr<uintArray> meshletVertices;  ///< indices into vertices and normals
+        ref_ptr<uintArray> meshletTriangles; ///< three 8 bit indices into the meshlet's vertices packed into each uint
+
+        /// build the meshlets from a triangle list, if in_normals isn't provided normals are computed from the triangles.
+        void build(const vec3Array& in_vertices, const vec3Array* in_normals, const std::vector<uint32_t>& indices);
+
+        /// task shader workgroup counts required to process all the meshlets
+        uivec3 taskWorkgroupCount() const;
+
+    protected:
+        virtual ~Meshlets();
+    };
+    VSG_type_name(vsg::Meshlets);
+
+    /// create a ShaderSet with task, mesh and fragment shaders for rendering Meshlets with Phong shading from a head light.
+    /// The task shader culls meshlets against the view frustum and by their normal cone, the GLSL shaders are compiled at runtime so
+    /// require VulkanSceneGraph to be built with shader compiler support, and the Device created with the VK_EXT_mesh_shader extension
+    /// and the taskShader and meshShader features enabled.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createMeshletPhongShaderSet(ref_ptr<const Options> options = {});
+
+} // namespace vsg
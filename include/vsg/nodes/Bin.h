@@ -15,6 +15,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/maths/sphere.h>
 #include <vsg/nodes/Node.h>
 
+#include <unordered_map>
+
 namespace vsg
 {
 
@@ -27,7 +29,15 @@ namespace vsg
         {
             NO_SORT,
             ASCENDING,
-            DESCENDING
+            DESCENDING,
+            STATE_SORTED /// sort by state commands, lowest slot first, then front to back, and only record state commands that change between elements
+        };
+
+        enum SortAlgorithm
+        {
+            STD_SORT,        /// std::sort the elements each frame
+            RADIX_SORT,      /// radix sort on the float keys, O(n) so faster for large bins
+            INCREMENTAL_SORT /// start from the previous frame's order and insertion sort, falling back to std::sort when the elements differ or the order has changed significantly
         };
 
         Bin();
@@ -42,12 +52,33 @@ namespace vsg
 
         void add(State* state, double value, const Node* node);
 
+        /// number of nodes added to the bin
+        size_t size() const { return _elements.size(); }
+
+        /// storage reserved by the bin's containers, retained when cleared so the steady state doesn't allocate
+        size_t reservedSize() const;
+
         int32_t binNumber = 0;
         SortOrder sortOrder = NO_SORT;
+        SortAlgorithm sortAlgorithm = STD_SORT;
+
+        /// when non negative overrides View::minimumFeatureSize for the DepthSorted nodes assigned to this bin.
+        double minimumFeatureSize = -1.0;
+
+        /// number of state commands recorded by the last traversal of a STATE_SORTED bin
+        uint32_t numStateCommandsRecorded() const { return _numStateCommandsRecorded; }
+
+        /// number of state commands the last traversal of a STATE_SORTED bin saved compared to recording all the state commands of every element
+        uint32_t numStateCommandsSaved() const { return _numStateCommands - _numStateCommandsRecorded; }
 
     protected:
         virtual ~Bin();
 
+        void _sort() const;
+        void _radixSort() const;
+        bool _incrementalSort() const;
+        void _stateSort() const;
+
         std::vector<dmat4> _matrices;
         std::vector<const StateCommand*> _stateCommands;
 
@@ -60,9 +91,37 @@ namespace vsg
         };
 
         std::vector<Element> _elements;
+        mutable bool _sorted = false;
 
         using KeyIndex = std::pair<float, uint32_t>;
         mutable std::vector<KeyIndex> _binElements;
+
+        // temporary storage used by the radix and incremental sorts
+        mutable std::vector<KeyIndex> _sortBuffer;
+
+        // order and children from the previous frame used by INCREMENTAL_SORT
+        mutable std::vector<uint32_t> _previousOrder;
+        mutable std::vector<const Node*> _previousChildren;
+
+        // state sort keys and the state commands currently pushed used by STATE_SORTED
+        struct StateKeyIndex
+        {
+            uint64_t stateKey;
+            float depth;
+            uint32_t index;
+        };
+        mutable std::vector<StateKeyIndex> _stateKeyElements;
+        struct StateCommandID
+        {
+            uint32_t generation = 0;
+            uint32_t id = 0;
+        };
+        // retained between traversals and invalidated by incrementing the generation, so steady state sorting doesn't allocate
+        mutable std::unordered_map<const StateCommand*, StateCommandID> _stateCommandIDs;
+        mutable uint32_t _stateCommandGeneration = 0;
+        mutable std::vector<const StateCommand*> _pushedStateCommands;
+        mutable uint32_t _numStateCommands = 0;
+        mutable uint32_t _numStateCommandsRecorded = 0;
     };
     VSG_type_name(vsg::Bin);
 
@@ -0,0 +1,109 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+#include <vsg/maths/sphere.h>
+#include <vsg/nodes/Node.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class Command;
+    class StateCommand;
+
+    /// FlattenedSubgraph records a static subgraph from contiguous arrays rather than traversing it node by node.
+    /// The child subgraph is flattened into a linear stream of entries that reference arrays of bounds, transforms, state commands and commands,
+    /// that the RecordTraversal iterates over in a single loop, culling by skipping over the entries of culled subgraphs.
+    /// Only Group, QuadGroup, StateGroup, MatrixTransform, CullGroup, CullNode, Commands and Command nodes are flattened, other nodes are
+    /// referenced from the stream and traversed as usual. All other visitors traverse the child subgraph, which remains editable,
+    /// call dirty() after adding or removing nodes, or changing the bounds or state of nodes, so it's flattened again before it's next recorded.
+    /// Changes to the matrices of MatrixTransforms don't require the subgraph to be flattened again.
+    class VSG_DECLSPEC FlattenedSubgraph : public Inherit<Node, FlattenedSubgraph>
+    {
+    public:
+        FlattenedSubgraph();
+        explicit FlattenedSubgraph(ref_ptr<Node> in_child);
+
+        void traverse(Visitor& visitor) override
+        {
+            if (child) child->accept(visitor);
+        }
+        void traverse(ConstVisitor& visitor) const override
+        {
+            if (child) child->accept(visitor);
+        }
+        void traverse(RecordTraversal& visitor) const override
+        {
+            if (child) child->accept(visitor);
+        }
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        ref_ptr<Node> child;
+
+        enum Operation : uint32_t
+        {
+            CULL,           /// test bounds[index], skipping to end if culled
+            PUSH_STATE,     /// push count stateCommands from index, skipping to end if any are pending
+            POP_STATE,      /// pop count stateCommands from index
+            PUSH_TRANSFORM, /// push the MatrixTransform nodes[index]
+            POP_TRANSFORM,  /// pop the MatrixTransform nodes[index]
+            COMMAND,        /// record commands[index]
+            STATE_COMMAND,  /// record commands[index], which is a StateCommand recorded directly
+            NODE            /// traverse nodes[index]
+        };
+
+        struct Entry
+        {
+            Operation operation;
+            uint32_t index;
+            uint32_t count;
+            uint32_t end;
+        };
+
+        /// flattened representation of the child subgraph
+        struct Stream
+        {
+            std::vector<Entry> entries;
+            std::vector<dsphere> bounds;
+            std::vector<const Node*> cullNodes;
+            std::vector<ref_ptr<const StateCommand>> stateCommands;
+            std::vector<ref_ptr<const Command>> commands;
+            std::vector<ref_ptr<const Node>> nodes;
+        };
+
+        /// return the flattened representation, flattening the child subgraph first if it's been changed since it was last flattened. Thread safe.
+        const Stream& stream() const;
+
+        /// mark the child subgraph as changed so it's flattened again before it's next recorded
+        void dirty() { _dirty = true; }
+
+        bool isDirty() const { return _dirty.load(); }
+
+    protected:
+        virtual ~FlattenedSubgraph();
+
+        static void _flatten(Stream& stream, const Node* node);
+
+        mutable Stream _stream;
+        mutable std::mutex _mutex;
+        mutable std::atomic_bool _dirty{true};
+    };
+    VSG_type_name(vsg::FlattenedSubgraph);
+
+} // namespace vsg
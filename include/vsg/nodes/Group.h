@@ -28,7 +28,7 @@ namespace vsg
         template<typename Iterator>
         Group(Iterator begin, Iterator end)
         {
-            for (Iterator itr = begin; itr != end; ++itr) addChild(*itr);
+            addChildren(begin, end);
         }
 
         template<class N, class V>
@@ -51,7 +51,23 @@ namespace vsg
 
         void addChild(vsg::ref_ptr<Node> child)
         {
-            children.push_back(child);
+            children.push_back(std::move(child));
+        }
+
+        /// add a range of children with a single reallocation of the children container when Iterator is a forward iterator,
+        /// use std::make_move_iterator to transfer the ref_ptr<> without reference count updates.
+        template<typename Iterator>
+        void addChildren(Iterator begin, Iterator end)
+        {
+            children.insert(children.end(), begin, end);
+        }
+
+        /// create a child of type T, constructed with the specified arguments, without copying its ref_ptr<>, returns a pointer to the new child.
+        template<class T, typename... Args>
+        T* emplaceChild(Args&&... args)
+        {
+            auto& child = children.emplace_back(T::create(std::forward<Args>(args)...));
+            return static_cast<T*>(child.get());
         }
 
     protected:
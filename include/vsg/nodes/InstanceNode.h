@@ -0,0 +1,69 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+#include <vsg/nodes/Transform.h>
+#include <vsg/state/StateCommand.h>
+
+namespace vsg
+{
+
+    /// InstanceNode is a Transform that places a prototype subgraph, shared by many InstanceNodes, with its own matrix and optional per instance state,
+    /// so many copies of a subgraph, such as the parts of a CAD assembly, can be placed without cloning the prototype's nodes and state.
+    /// The RecordTraversal pushes the stateCommands and matrix then records the prototype, and as a Transform the Intersector, ComputeBounds
+    /// and computeTransform(nodePath) handle InstanceNodes without any special treatment.
+    /// Per instance parameters are typically provided by a PushConstants or BindDescriptorSet in stateCommands, the pipeline bound within
+    /// the prototype must have a compatible layout. Any children are traversed after the prototype.
+    class VSG_DECLSPEC InstanceNode : public Inherit<Transform, InstanceNode>
+    {
+    public:
+        InstanceNode();
+        InstanceNode(const dmat4& in_matrix, ref_ptr<Node> in_prototype, const StateCommands& in_stateCommands = {});
+
+        dmat4 matrix;
+
+        /// subgraph shared by all the instances
+        ref_ptr<Node> prototype;
+
+        /// per instance state pushed before the prototype is traversed
+        StateCommands stateCommands;
+
+        dmat4 transform(const dmat4& mv) const override { return mv * matrix; }
+
+        template<class N, class V>
+        static void t_traverse(N& node, V& visitor)
+        {
+            for (auto& stateCommand : node.stateCommands) stateCommand->accept(visitor);
+            if (node.prototype) node.prototype->accept(visitor);
+            for (auto& child : node.children) child->accept(visitor);
+        }
+
+        void traverse(Visitor& visitor) override { t_traverse(*this, visitor); }
+        void traverse(ConstVisitor& visitor) const override { t_traverse(*this, visitor); }
+        void traverse(RecordTraversal& visitor) const override
+        {
+            // stateCommands are pushed by RecordTraversal::apply(const InstanceNode&) rather than recorded directly
+            if (prototype) prototype->accept(visitor);
+            for (auto& child : children) child->accept(visitor);
+        }
+
+        int compare(const Object& rhs) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~InstanceNode();
+    };
+    VSG_type_name(vsg::InstanceNode);
+
+} // namespace vsg
@@ -0,0 +1,131 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/Camera.h>
+#include <vsg/commands/DrawIndexedIndirectCommand.h>
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/core/Array.h>
+#include <vsg/maths/sphere.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ComputePipeline.h>
+
+namespace vsg
+{
+
+    /// InstancedGeometry draws many copies of a mesh, each positioned by a per instance translation, with per instance frustum culling
+    /// and LOD selection done on the GPU by an InstancedGeometryCulling command.
+    /// Each LOD level is a VertexIndexDraw whose last array is the per instance positions, so the pipeline's vertex input state should
+    /// declare that binding with VK_VERTEX_INPUT_RATE_INSTANCE, as with the VSG_INSTANCE_POSITIONS define of the standard ShaderSets.
+    /// When recording, that binding is replaced by the compacted positions of the instances that the culling selected for the level,
+    /// and each level is drawn with a single vkCmdDrawIndexedIndirect using the instance count written by the culling.
+    /// For intersection and bounds computation the highest detail level is traversed with all the instances, so assigning a
+    /// PositionArrayState as the prototypeArrayState of the parent StateGroup allows LineSegmentIntersector to intersect each instance.
+    /// positions are in the world coordinate frame of the Camera's ViewMatrix.
+    class VSG_DECLSPEC InstancedGeometry : public Inherit<Command, InstancedGeometry>
+    {
+    public:
+        InstancedGeometry();
+        explicit InstancedGeometry(ref_ptr<vec3Array> in_positions);
+
+        struct LODLevel
+        {
+            double minimumScreenHeightRatio = 0.0; // 0.0 is always visible
+            ref_ptr<VertexIndexDraw> mesh;
+        };
+
+        /// per instance translations
+        ref_ptr<vec3Array> positions;
+
+        /// LOD levels, ordered from the highest detail level to the lowest
+        std::vector<LODLevel> lods;
+
+        /// bounding sphere of the meshes, if invalid it's computed from the vertices of the highest detail level
+        dsphere meshBound;
+
+        /// add a LOD level, appending the instance positions to the mesh's arrays. Levels must be added in order of decreasing detail.
+        void addLOD(double minimumScreenHeightRatio, ref_ptr<VertexIndexDraw> mesh);
+
+        /// buffers shared with InstancedGeometryCulling, created by assignCullingData()
+        ref_ptr<BufferInfo> instancePositions;
+        ref_ptr<BufferInfo> instanceBounds;
+        ref_ptr<BufferInfo> lodRatios;
+        ref_ptr<BufferInfo> drawTemplates;
+        ref_ptr<BufferInfo> drawCommands;
+        ref_ptr<BufferInfo> culledPositions;
+
+        /// create the per instance bounds, LOD ratios and indirect draw buffers from the positions and lods,
+        /// called by compile() and InstancedGeometryCulling when they haven't already been assigned.
+        void assignCullingData();
+
+        uint32_t numInstances() const { return positions ? static_cast<uint32_t>(positions->size()) : 0; }
+
+        void traverse(Visitor& visitor) override;
+        void traverse(ConstVisitor& visitor) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        virtual ~InstancedGeometry();
+
+        struct VulkanLODData
+        {
+            std::vector<VkBuffer> vkBuffers;
+            std::vector<VkDeviceSize> offsets;
+            VkBuffer indexBuffer = VK_NULL_HANDLE;
+            VkDeviceSize indexOffset = 0;
+            VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+        };
+
+        vk_buffer<std::vector<VulkanLODData>> _vulkanData;
+    };
+    VSG_type_name(vsg::InstancedGeometry);
+
+    /// InstancedGeometryCulling command culls the instances of an InstancedGeometry against the Camera's view frustum and selects each visible
+    /// instance's LOD level using a compute shader, writing the compacted positions and instance counts used by the InstancedGeometry's indirect draws.
+    /// The indirect draws read the results of the most recent cull, so add it ahead of the Camera's RenderGraph, see Dispatch for the placement of compute commands.
+    class VSG_DECLSPEC InstancedGeometryCulling : public Inherit<Command, InstancedGeometryCulling>
+    {
+    public:
+        InstancedGeometryCulling(ref_ptr<Camera> in_camera, ref_ptr<InstancedGeometry> in_instancedGeometry);
+
+        /// Camera providing the view frustum and LOD scale
+        ref_ptr<Camera> camera;
+
+        ref_ptr<InstancedGeometry> instancedGeometry;
+
+        /// multiplier of the LOD levels' minimumScreenHeightRatio, matching View::lodBias
+        double lodBias = 1.0;
+
+        /// local workgroup size used by the compute shader
+        static constexpr uint32_t workgroupSize = 64;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        ref_ptr<PipelineLayout> _pipelineLayout;
+        ref_ptr<BindComputePipeline> _bindPipeline;
+        ref_ptr<BindDescriptorSet> _bindDescriptorSet;
+        ref_ptr<PipelineBarrier> _preCullBarrier;
+        ref_ptr<PipelineBarrier> _resetBarrier;
+        ref_ptr<PipelineBarrier> _postCullBarrier;
+    };
+    VSG_type_name(vsg::InstancedGeometryCulling);
+
+} // namespace vsg
@@ -19,6 +19,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 namespace vsg
 {
 
+    // forward declare
+    class Timings;
+
     /// InstrumentationNode enables instrumentation of a subgraph
     class VSG_DECLSPEC InstrumentationNode : public Inherit<Node, InstrumentationNode>
     {
@@ -42,6 +45,17 @@ namespace vsg
         void setLevel(uint32_t level);
         uint32_t getLevel() const { return _level; }
 
+        /// enable measuring the GPU time of the child subgraph with timestamps written before and after it, using the query pools of the CommandGraph that records it.
+        /// Results are available a few frames after recording, when the CommandGraph reuses the frame's query pool.
+        void setGpuTiming(bool enabled);
+        bool getGpuTiming() const { return _gpuTimings.valid(); }
+
+        /// GPU times of the child subgraph in milliseconds, null if GPU timing isn't enabled.
+        ref_ptr<Timings> getGpuTimings() const;
+
+        /// most recent GPU time of the child subgraph in milliseconds, 0.0 if no timings are available.
+        double getGpuTime() const;
+
         ref_ptr<vsg::Node> child;
 
     protected:
@@ -50,6 +64,7 @@ namespace vsg
         uint32_t _level = 1;
         uint_color _color;
         std::string _name;
+        ref_ptr<Timings> _gpuTimings;
 
         // SourceLocation variants for passing to Instrumentation that adapt the level, color and name to work with SourceLocation usad by Instrumentation
         SourceLocation _sl_Visitor;
@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/maths/sphere.h>
 #include <vsg/nodes/Transform.h>
 
 namespace vsg
@@ -28,6 +29,11 @@ namespace vsg
 
         dmat4 matrix;
 
+        /// optional bound of the subgraph in the parent's coordinate frame, for static subgraphs only, see vsg::CacheTransformBounds.
+        /// When valid the RecordTraversal culls the whole subgraph against it, and when it's entirely inside the view frustum
+        /// skips transforming the frustum into the local coordinate frame, along with the frustum tests of the subgraph.
+        dsphere bound;
+
         int compare(const Object& rhs) const override;
 
         void read(Input& input) override;
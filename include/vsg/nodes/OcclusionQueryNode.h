@@ -0,0 +1,73 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/maths/sphere.h>
+#include <vsg/nodes/Node.h>
+
+namespace vsg
+{
+
+    /// OcclusionQueryNode draws a cheap proxy, such as the bounding box of its child, with an occlusion query and uses the result to skip
+    /// recording its child subgraph when the proxy was hidden. Queries are managed by the CommandGraph's OcclusionQueries so the CPU
+    /// never waits on the GPU, the results becoming available a few frames after the proxy was drawn. When VK_EXT_conditional_rendering
+    /// and its conditionalRendering feature are enabled on the device the child is also recorded with conditional rendering, so the GPU
+    /// skips it when the proxy was hidden in the previous frame. PagedLOD nodes beneath a hidden node don't request their high resolution children.
+    /// The proxy's state should disable color and depth writes, and as the query counts the samples that pass the depth test the occluders
+    /// should be rendered first. Subgraphs placed in Bins, such as DepthSorted nodes, are recorded outside of the query/conditional rendering.
+    class VSG_DECLSPEC OcclusionQueryNode : public Inherit<Node, OcclusionQueryNode>
+    {
+    public:
+        OcclusionQueryNode();
+        OcclusionQueryNode(const dsphere& in_bound, ref_ptr<Node> in_proxy, ref_ptr<Node> in_child);
+
+        /// bounding sphere of the proxy and child, used for view frustum culling
+        dsphere bound;
+
+        /// geometry enclosing the child that is drawn with the occlusion query
+        ref_ptr<Node> proxy;
+
+        /// subgraph that is skipped when the proxy is hidden
+        ref_ptr<Node> child;
+
+        /// when conditional rendering is in use continue recording the child when the latest query result is hidden, leaving the GPU to skip it,
+        /// so that it reappears on the frame after the proxy becomes visible rather than once the CPU sees the result.
+        bool recordHidden = true;
+
+        /// number of frames after which a query result is no longer used, so nodes that become visible after being out of view aren't skipped.
+        uint32_t maximumResultAge = 8;
+
+        /// frame of the latest query result, and of the latest query result that found the proxy visible
+        mutable std::atomic_uint64_t frameLastQueried{0};
+        mutable std::atomic_uint64_t frameLastVisible{0};
+
+        /// return true unless a recent query result found the proxy hidden
+        bool visible(uint64_t frameCount) const
+        {
+            auto lastQueried = frameLastQueried.load();
+            return frameLastVisible.load() >= lastQueried || (frameCount - lastQueried) > maximumResultAge;
+        }
+
+        void traverse(Visitor& visitor) override;
+        void traverse(ConstVisitor& visitor) const override;
+        void traverse(RecordTraversal& visitor) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~OcclusionQueryNode();
+    };
+    VSG_type_name(vsg::OcclusionQueryNode);
+
+} // namespace vsg
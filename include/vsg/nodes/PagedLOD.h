@@ -102,6 +102,10 @@ namespace vsg
         mutable uint32_t index = 0;
 
         ref_ptr<Node> pending;
+
+        /// CPU and device memory in bytes used by the high res subgraph, measured by the DatabasePager after it's compiled
+        uint64_t highResDataSize = 0;
+        uint64_t highResDeviceMemorySize = 0;
     };
     VSG_type_name(vsg::PagedLOD);
 
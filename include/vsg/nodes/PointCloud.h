@@ -0,0 +1,79 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/nodes/PagedLOD.h>
+
+#include <array>
+
+namespace vsg
+{
+
+    /// PointCloud renders a point cloud stored as an octree of tiles that are streamed in by the DatabasePager.
+    /// Each octant's tile holds a subsample of the points in its bounds, with its children adding progressively finer detail, so all
+    /// the loaded octants along the path from the root are drawn together rather than replacing their parent as PagedLOD does.
+    /// During the record traversal visible octants are selected in order of decreasing screen size until the pointBudget is reached,
+    /// so the number of points drawn each frame is bounded regardless of the size of the dataset. Octants that are selected but not
+    /// loaded are requested from the DatabasePager, and tiles that are no longer selected are expired by it like PagedLOD subgraphs.
+    /// The tiles are standard subgraphs so are recorded into the View's Bins as normal, see vsg::BuildPointCloud for creating PointCloud databases.
+    class VSG_DECLSPEC PointCloud : public Inherit<Node, PointCloud>
+    {
+    public:
+        PointCloud();
+
+        struct Octant
+        {
+            dsphere bound;
+            uint32_t numPoints = 0;
+            double spacing = 0.0;                  // approximate distance between the points of this octant's tile
+            std::array<uint32_t, 8> children = {}; // indices into octants, 0 for no child as the root is never a child
+            Path filename;                         // tile file, relative to the PointCloud's file
+            ref_ptr<PagedLOD> tile;                // PagedLOD used as the DatabasePager's handle for loading the tile, loaded tile is assigned to tile->children[0].node
+        };
+
+        /// octree of octants, octant 0 is the root
+        std::vector<Octant> octants;
+
+        /// maximum number of points to draw each frame
+        uint64_t pointBudget = 5000000;
+
+        /// minimum ratio of screen height that an octant's bounding sphere needs to occupy for its children to be selected
+        double minimumScreenHeightRatio = 0.1;
+
+        /// options used when loading tiles
+        ref_ptr<Options> options;
+
+        /// assign a PagedLOD for each octant's tile, each resolving its filename relative to the directory path
+        void assignTiles(const Path& directory = {});
+
+        template<class N, class V>
+        static void t_traverse(N& node, V& visitor)
+        {
+            for (auto& octant : node.octants)
+            {
+                if (octant.tile) octant.tile->accept(visitor);
+            }
+        }
+
+        void traverse(Visitor& visitor) override { t_traverse(*this, visitor); }
+        void traverse(ConstVisitor& visitor) const override { t_traverse(*this, visitor); }
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~PointCloud();
+    };
+    VSG_type_name(vsg::PointCloud);
+
+} // namespace vsg
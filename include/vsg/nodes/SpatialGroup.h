@@ -0,0 +1,113 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/maths/sphere.h>
+#include <vsg/maths/vec3.h>
+#include <vsg/nodes/Node.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace vsg
+{
+
+    /// SpatialGroup is a dynamic spatial index for large numbers of moving children, such as vehicles, held in a hashed loose grid.
+    /// Each child is assigned to the grid cell containing the center of its bound, and each cell's bound is expanded by the radius of its largest child,
+    /// so updating a child's bound only moves it between cells when its center crosses a cell boundary, which is O(1).
+    /// The RecordTraversal and Intersectors only visit the children of the cells that intersect the view frustum or intersector.
+    class VSG_DECLSPEC SpatialGroup : public Inherit<Node, SpatialGroup>
+    {
+    public:
+        explicit SpatialGroup(double in_cellSize = 100.0);
+
+        template<class N, class V>
+        static void t_traverse(N& node, V& visitor)
+        {
+            for (auto& child : node._children)
+            {
+                if (child.node) child.node->accept(visitor);
+            }
+        }
+
+        void traverse(Visitor& visitor) override { t_traverse(*this, visitor); }
+        void traverse(ConstVisitor& visitor) const override { t_traverse(*this, visitor); }
+        void traverse(RecordTraversal& visitor) const override { t_traverse(*this, visitor); }
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        struct Child
+        {
+            dsphere bound;
+            ref_ptr<Node> node;
+        };
+
+        struct Cell
+        {
+            /// loose bound of the cell, enclosing the bounds of all its children
+            dsphere bound;
+            double maximumChildRadius = 0.0;
+            std::vector<uint32_t> children;
+        };
+
+        using Children = std::vector<Child>;
+        using Cells = std::unordered_map<uint64_t, Cell>;
+
+        /// add a child with its bound in the SpatialGroup's local coordinate frame, returns the index used to update or remove it
+        uint32_t addChild(ref_ptr<Node> node, const dsphere& bound);
+
+        /// update the bound of a child, such as after changing the matrix of the child's transform
+        void updateChild(uint32_t index, const dsphere& bound);
+
+        /// remove a child, its index may be reused by subsequent calls to addChild()
+        void removeChild(uint32_t index);
+
+        /// remove all children
+        void clear();
+
+        /// set the size of the grid cells, reassigning all the children to the new grid. Cells should be a few times larger than typical children.
+        void setCellSize(double in_cellSize);
+        double getCellSize() const { return _cellSize; }
+
+        /// children indexed by the values returned by addChild(), removed children have a null node
+        const Children& children() const { return _children; }
+
+        /// occupied grid cells
+        const Cells& cells() const { return _cells; }
+
+        /// number of children that haven't been removed
+        size_t size() const { return _children.size() - _freeIndices.size(); }
+
+    protected:
+        virtual ~SpatialGroup();
+
+        struct Placement
+        {
+            uint64_t cell = 0;
+            uint32_t position = 0;
+        };
+
+        uint64_t _cellKey(const dvec3& position) const;
+        void _insert(uint32_t index);
+        void _erase(uint32_t index);
+
+        double _cellSize;
+        Children _children;
+        std::vector<Placement> _placements;
+        std::vector<uint32_t> _freeIndices;
+        Cells _cells;
+    };
+    VSG_type_name(vsg::SpatialGroup);
+
+} // namespace vsg
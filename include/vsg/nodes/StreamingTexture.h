@@ -0,0 +1,91 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/maths/sphere.h>
+#include <vsg/nodes/Node.h>
+#include <vsg/state/BindDescriptorSet.h>
+
+namespace vsg
+{
+
+    // forward declare
+    class TextureStreamer;
+
+    /// StreamingTexture node binds the state for a texture whose finer mip levels are streamed in as the screen space size of its subgraph requires them.
+    /// Only the coarsest numCoarseMipLevels of the image's mipmaps are compiled with the subgraph, finer levels are compiled in the background by the
+    /// TextureStreamer, which switches the StreamingTexture over to them once they are ready and back to the coarse levels when it needs to free memory.
+    /// Each level is a view of the image's mipmap chain so the image data must contain its mipmaps.
+    class VSG_DECLSPEC StreamingTexture : public Inherit<Node, StreamingTexture>
+    {
+    public:
+        StreamingTexture();
+
+        /// bounding sphere of the subgraph the texture is mapped on to, used to cull the subgraph and estimate the texture's screen space size
+        dsphere bound;
+
+        /// texture image data, including its mipmaps
+        ref_ptr<Data> image;
+
+        /// BindDescriptorSet used as a template for the state of each mip level, the DescriptorImage at descriptorIndex is replaced with one for each level
+        ref_ptr<BindDescriptorSet> bindDescriptorSet;
+        uint32_t descriptorIndex = 0;
+
+        /// number of the coarsest mip levels that are compiled with the subgraph
+        uint32_t numCoarseMipLevels = 4;
+
+        /// TextureStreamer used to stream in the finer mip levels, if null only the coarse levels are used
+        ref_ptr<TextureStreamer> streamer;
+
+        ref_ptr<Node> child;
+
+        /// set up the coarse mip level state, needs to be called once image and bindDescriptorSet have been assigned and before the subgraph is compiled
+        void init();
+
+        /// number of mip levels in the image
+        uint32_t numMipLevels() const;
+
+        /// create the state for the mipmap chain starting at baseMipLevel, the image data is shared rather than copied
+        ref_ptr<BindDescriptorSet> createBindDescriptorSet(uint32_t baseMipLevel) const;
+
+        /// state for the coarse mip levels, and its base mip level
+        ref_ptr<BindDescriptorSet> coarseState;
+        uint32_t coarseMipLevel = 0;
+
+        /// state currently bound when recording, and its base mip level, updated by the TextureStreamer
+        ref_ptr<BindDescriptorSet> activeState;
+        uint32_t activeMipLevel = 0;
+
+        /// record traversal fields used by the TextureStreamer
+        mutable std::atomic_uint64_t frameLastUsed{0};
+        mutable std::atomic_bool requestPending{false};
+
+        template<class N, class V>
+        static void t_traverse(N& node, V& visitor)
+        {
+            if (node.coarseState) node.coarseState->accept(visitor);
+            if (node.child) node.child->accept(visitor);
+        }
+
+        void traverse(Visitor& visitor) override { t_traverse(*this, visitor); }
+        void traverse(ConstVisitor& visitor) const override { t_traverse(*this, visitor); }
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~StreamingTexture();
+    };
+    VSG_type_name(vsg::StreamingTexture);
+
+} // namespace vsg
@@ -19,6 +19,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/PipelineLayout.h>
 #include <vsg/state/Sampler.h>
 #include <vsg/utils/ShaderSet.h>
+#include <vsg/utils/VirtualTexture.h>
 
 namespace vsg
 {
@@ -43,6 +44,8 @@ namespace vsg
         ref_ptr<EllipsoidModel> ellipsoidModel = EllipsoidModel::create();
 
         Path imageLayer;
+        /// optional elevation tiles, used to displace the tiles of an ellipsoid database and to populate a vsg::TerrainHeightQuery
+        /// assigned to the settings with setObject("TerrainHeightQuery", heightQuery).
         Path terrainLayer;
         uint32_t mipmapLevelsHint = 16;
 
@@ -51,6 +54,22 @@ namespace vsg
 
         /// optional shaderSet to use for setting up shaders, if left null use vsg::createTileShaderSet().
         ref_ptr<ShaderSet> shaderSet;
+
+        /// optional directory to cache the created tile subgraphs in as .vsgb files, if left empty the disk cache is disabled.
+        Path cacheDirectory;
+
+        /// maximum total size in bytes of the disk cache, 0 for no limit.
+        uint64_t maxCacheSize = 0;
+
+        /// maximum age in seconds of disk cache files before they are discarded and the tiles recreated, 0 for no limit.
+        double maxCacheAge = 0.0;
+
+        /// maximum number of recently created tiles to retain in memory, 0 disables the memory cache.
+        uint32_t memoryCacheSize = 0;
+
+        /// optional VirtualTexture to pack the tile imagery into so all tiles share a single descriptor set, tiles fall back to their own texture when the imagery isn't compatible or the atlas is full.
+        /// Runtime only setting that isn't serialized, the disk and memory caches are disabled when it's assigned.
+        ref_ptr<VirtualTexture> virtualTexture;
     };
     VSG_type_name(vsg::TileDatabaseSettings);
 
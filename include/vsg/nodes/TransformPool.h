@@ -0,0 +1,95 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/nodes/Transform.h>
+
+#include <vector>
+
+namespace vsg
+{
+
+    /// TransformPool holds the matrices of many PooledTransform nodes in a single contiguous array, so simulations can update them in bulk
+    /// rather than writing to separately allocated MatrixTransform nodes. Threads may write to disjoint ranges of the matrices in parallel,
+    /// but allocate() and release() must not be called while the matrices are being written or traversed.
+    class VSG_DECLSPEC TransformPool : public Inherit<Object, TransformPool>
+    {
+    public:
+        explicit TransformPool(uint32_t initialCapacity = 0);
+
+        /// contiguous matrices, reallocated by allocate() when its capacity is exceeded so pointers into it shouldn't be retained across calls to allocate().
+        ref_ptr<dmat4Array> matrices;
+
+        /// optional single precision copy of the matrices, such as for use as a GPU instance buffer, updated by updateInstanceMatrices()
+        ref_ptr<mat4Array> instanceMatrices;
+
+        /// allocate a matrix, returns its index
+        uint32_t allocate(const dmat4& matrix = {});
+
+        /// release a matrix so its index can be reused by later calls to allocate()
+        void release(uint32_t index);
+
+        /// copy count matrices into the pool, starting at index first
+        void set(uint32_t first, const dmat4* src, uint32_t count);
+
+        dmat4& at(uint32_t index) { return matrices->at(index); }
+        const dmat4& at(uint32_t index) const { return matrices->at(index); }
+
+        dmat4* data() { return matrices->data(); }
+        const dmat4* data() const { return matrices->data(); }
+
+        /// number of matrix indices in use, including released indices that haven't been reused
+        uint32_t size() const { return _size; }
+
+        /// convert the matrices to instanceMatrices, creating it when required, and mark it as dirty so it's transferred to the GPU
+        void updateInstanceMatrices();
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~TransformPool();
+
+        uint32_t _size = 0;
+        std::vector<uint32_t> _freeIndices;
+    };
+    VSG_type_name(vsg::TransformPool);
+
+    /// PooledTransform is a Transform whose matrix is held in a TransformPool and referenced by index.
+    class VSG_DECLSPEC PooledTransform : public Inherit<Transform, PooledTransform>
+    {
+    public:
+        PooledTransform();
+        PooledTransform(ref_ptr<TransformPool> in_pool, uint32_t in_index);
+
+        ref_ptr<TransformPool> pool;
+        uint32_t index = 0;
+
+        /// convenience access to the pooled matrix
+        dmat4& matrix() { return pool->at(index); }
+        const dmat4& matrix() const { return pool->at(index); }
+
+        int compare(const Object& rhs) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        dmat4 transform(const dmat4& mv) const override { return mv * pool->matrices->at(index); }
+
+    protected:
+        virtual ~PooledTransform();
+    };
+    VSG_type_name(vsg::PooledTransform);
+
+} // namespace vsg
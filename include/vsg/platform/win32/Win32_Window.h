@@ -185,6 +185,10 @@ namespace vsgWin32
 
         bool pollEvents(vsg::UIEvents& events) override;
 
+        bool waitEvents(vsg::UIEvents& events, double timeout) override;
+
+        void wakeEvents() override;
+
         void resize() override;
 
         operator HWND() const { return _window; }
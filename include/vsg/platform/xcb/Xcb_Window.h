@@ -70,6 +70,10 @@ namespace vsgXcb
 
         bool pollEvents(vsg::UIEvents& events) override;
 
+        bool waitEvents(vsg::UIEvents& events, double timeout) override;
+
+        void wakeEvents() override;
+
         void resize() override;
 
     protected:
@@ -85,6 +89,9 @@ namespace vsgXcb
 
         bool _windowMapped = false;
 
+        // pipe written to by wakeEvents() to release the poll() in waitEvents()
+        int _wakePipe[2] = {-1, -1};
+
         xcb_timestamp_t _first_xcb_timestamp = 0;
         vsg::clock::time_point _first_xcb_time_point;
 
@@ -35,6 +35,7 @@ namespace vsg
         uint64_t handle() const { return _handle; }
 
         VkDeviceSize requiredScratchSize() const { return _requiredBuildScratchSize; }
+        VkDeviceSize requiredUpdateScratchSize() const { return _requiredUpdateScratchSize; }
 
     protected:
         virtual ~AccelerationStructure();
@@ -47,6 +48,7 @@ namespace vsg
         ref_ptr<DeviceMemory> _memory;
         uint64_t _handle = 0;
         VkDeviceSize _requiredBuildScratchSize;
+        VkDeviceSize _requiredUpdateScratchSize;
 
         ref_ptr<Device> _device;
     };
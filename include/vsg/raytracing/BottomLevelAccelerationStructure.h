@@ -28,9 +28,27 @@ namespace vsg
 
         AccelerationGeometries geometries;
 
+        /// when true the acceleration structure is built with ALLOW_COMPACTION so that it can be compacted once built.
+        bool allowCompaction = false;
+
+        /// return the size of the acceleration structure's memory
+        VkDeviceSize size() const { return _accelerationStructureInfo.size; }
+
+        /// create an acceleration structure of compactedSize, as reported by a VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR query of the built acceleration structure,
+        /// and record the compacting copy to it. The new acceleration structure replaces the original, which is kept until releaseUncompacted() is called once the copy has completed.
+        void recordCompaction(Context& context, CommandBuffer& commandBuffer, VkDeviceSize compactedSize);
+
+        /// release the original acceleration structure replaced by recordCompaction()
+        void releaseUncompacted();
+
     protected:
+        virtual ~BottomLevelAccelerationStructure();
+
         // compiled data
         std::vector<VkAccelerationStructureGeometryKHR> _vkGeometries;
+
+        VkAccelerationStructureKHR _uncompactedAccelerationStructure = VK_NULL_HANDLE;
+        ref_ptr<Buffer> _uncompactedBuffer;
     };
     VSG_type_name(vsg::BottomLevelAccelerationStructure);
 
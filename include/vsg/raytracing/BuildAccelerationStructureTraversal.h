@@ -42,12 +42,24 @@ namespace vsg
         // the top level acceleration structure we are creating and adding geometry instances to as we find and create them
         ref_ptr<TopLevelAccelerationStructure> tlas;
 
+        /// when true buildBottomLevelAccelerationStructures() compacts the bottom level acceleration structures once built
+        bool compact = true;
+
+        /// maximum scratch memory used by a single batch of bottom level acceleration structure builds
+        VkDeviceSize maxBatchScratchSize = 128 * 1024 * 1024;
+
+        /// build the bottom level acceleration structures created by the traversal using batched vkCmdBuildAccelerationStructuresKHR calls that share
+        /// a single scratch buffer, then when compact is true replace them with compacted copies. Call after the traversal and before compiling the tlas.
+        /// Returns the number of bytes of device memory freed by compaction.
+        VkDeviceSize buildBottomLevelAccelerationStructures(Queue* queue);
+
     protected:
         void createGeometryInstance(BottomLevelAccelerationStructure* blas);
 
         ref_ptr<Device> _device;
 
         MatrixStack _transformStack;
+        std::vector<const Node*> _nodePath;
 
         // cache blas's created for various types of draw node
         std::map<VertexIndexDraw*, ref_ptr<BottomLevelAccelerationStructure>> _vertexIndexDrawBlasMap;
@@ -0,0 +1,80 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/raytracing/TopLevelAccelerationStructure.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ComputePipeline.h>
+#include <vsg/utils/RayBatchIntersector.h>
+#include <vsg/vk/Context.h>
+
+namespace vsg
+{
+
+    /// RayQueryIntersector intersects batches of line segments with a TopLevelAccelerationStructure on the GPU, using VK_KHR_ray_query in a compute shader,
+    /// moving the cost of mass picking and line of sight queries off the CPU on capable hardware.
+    /// The closest intersection of each segment is returned as a LineSegmentIntersector::Intersection, the node paths are provided by the GeometryInstance::nodePath
+    /// assigned by BuildAccelerationStructureTraversal.
+    /// The Device must have the VK_KHR_ray_query extension and rayQuery feature enabled, along with those required by the acceleration structures,
+    /// and the compute shader is compiled from GLSL at runtime so requires VulkanSceneGraph to be built with shader compiler support.
+    class VSG_DECLSPEC RayQueryIntersector : public Inherit<Object, RayQueryIntersector>
+    {
+    public:
+        RayQueryIntersector(ref_ptr<Device> in_device, ref_ptr<Queue> in_queue, ref_ptr<TopLevelAccelerationStructure> in_tlas);
+
+        using Segment = RayBatchIntersector::Segment;
+        using Segments = RayBatchIntersector::Segments;
+        using Intersection = LineSegmentIntersector::Intersection;
+        using Intersections = LineSegmentIntersector::Intersections;
+
+        ref_ptr<Device> device;
+        ref_ptr<Queue> queue;
+        ref_ptr<TopLevelAccelerationStructure> tlas;
+
+        /// mask compared against GeometryInstance::mask to select the instances to intersect
+        uint32_t cullMask = 0xff;
+
+        /// local workgroup size used by the compute shader
+        static constexpr uint32_t workgroupSize = 64;
+
+        /// return true if the device supports ray queries
+        static bool supported(const Device* device);
+
+        /// intersect the segments, in world coordinates, returning the closest intersection of each segment with null entries for the segments that miss.
+        Intersections intersect(const Segments& segments);
+
+    protected:
+        virtual ~RayQueryIntersector();
+
+        void _compile();
+        void _reserve(uint32_t numSegments);
+
+        ref_ptr<Context> _context;
+        ref_ptr<Fence> _fence;
+
+        ref_ptr<DescriptorSetLayout> _descriptorSetLayout;
+        ref_ptr<PipelineLayout> _pipelineLayout;
+        ref_ptr<BindComputePipeline> _bindPipeline;
+        ref_ptr<BindDescriptorSet> _bindDescriptorSet;
+
+        uint32_t _capacity = 0;
+        ref_ptr<vec4Array> _segments;
+        ref_ptr<vec4Array> _hits;
+        ref_ptr<uivec4Array> _hitIndices;
+        ref_ptr<BufferInfo> _segmentsInfo;
+        ref_ptr<BufferInfo> _hitsInfo;
+        ref_ptr<BufferInfo> _hitIndicesInfo;
+    };
+    VSG_type_name(vsg::RayQueryIntersector);
+
+} // namespace vsg
@@ -19,6 +19,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 namespace vsg
 {
+    // forward declare
+    class Node;
 
     // VkGeometryInstance encapsulates the VkAccelerationStructureInstanceKHR settings.
     // This structure is required to populate the top level structures instance buffer and is essentially the same as VkAccelerationStructureInstanceKHR
@@ -74,6 +76,9 @@ namespace vsg
         uint32_t shaderOffset;
         uint32_t flags;
         ref_ptr<BottomLevelAccelerationStructure> accelerationStructure;
+
+        /// path to the draw node the instance was created from, assigned by BuildAccelerationStructureTraversal so RayQueryIntersector can map intersections back to the scene graph
+        std::vector<const Node*> nodePath;
     };
     VSG_type_name(vsg::GeometryInstance);
 
@@ -89,10 +94,29 @@ namespace vsg
 
         GeometryInstances geometryInstances;
 
+        /// when true the acceleration structure is built with ALLOW_UPDATE and its instance data is uploaded by the late TransferTask,
+        /// an UpdateTopLevelAccelerationStructure command placed ahead of the commands that trace against it then refits it each frame.
+        bool allowUpdate = false;
+
+        /// number of refits between full rebuilds, rebuilding restores the trace performance lost as instances move away from where they were built, 0 disables rebuilds.
+        uint32_t rebuildInterval = 120;
+
+        /// copy the geometryInstances settings into the instance data and mark it as modified so it's transferred for the next frame.
+        /// Instances with a nodePath have their transform recomputed from the transforms along it.
+        void updateInstances();
+
+        /// return the BufferInfo of the instance data, created on first call. With allowUpdate its data is DYNAMIC_DATA_TRANSFER_AFTER_RECORD.
+        ref_ptr<BufferInfo> getInstanceBufferInfo();
+
+        /// record a refit, or a full rebuild when rebuild is true, of the compiled acceleration structure using the specified scratch buffer.
+        void recordUpdate(CommandBuffer& commandBuffer, Buffer* scratchBuffer, bool rebuild) const;
+
     protected:
         // compiled data
         ref_ptr<VkGeometryInstanceArray> _instances;
+        ref_ptr<BufferInfo> _instanceBufferInfo;
         ref_ptr<Buffer> _instanceBuffer;
+        VkAccelerationStructureGeometryKHR _accelerationStructureGeometry;
     };
     VSG_type_name(vsg::TopLevelAccelerationStructure);
 
@@ -0,0 +1,47 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/Command.h>
+#include <vsg/raytracing/TopLevelAccelerationStructure.h>
+#include <vsg/vk/vk_buffer.h>
+
+namespace vsg
+{
+
+    /// UpdateTopLevelAccelerationStructure command refits a TopLevelAccelerationStructure, compiled with allowUpdate, each time it's recorded
+    /// so that ray traced scenes can animate their GeometryInstance transforms without recompiling. Every rebuildInterval updates a full
+    /// rebuild is recorded instead. Place it ahead of the TraceRays or ray query commands in the command graph that use the acceleration structure.
+    class VSG_DECLSPEC UpdateTopLevelAccelerationStructure : public Inherit<Command, UpdateTopLevelAccelerationStructure>
+    {
+    public:
+        explicit UpdateTopLevelAccelerationStructure(ref_ptr<TopLevelAccelerationStructure> in_accelerationStructure = {});
+
+        ref_ptr<TopLevelAccelerationStructure> accelerationStructure;
+
+        /// when true record() calls TopLevelAccelerationStructure::updateInstances() so the instances follow the current transforms in the scene graph,
+        /// set to false when the application calls updateInstances() itself.
+        bool updateInstances = true;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        virtual ~UpdateTopLevelAccelerationStructure();
+
+        vk_buffer<ref_ptr<Buffer>> _scratchBuffers;
+        mutable uint32_t _numUpdates = 0;
+    };
+    VSG_type_name(vsg::UpdateTopLevelAccelerationStructure);
+
+} // namespace vsg
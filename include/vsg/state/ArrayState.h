@@ -63,6 +63,9 @@ namespace vsg
 
         DataList arrays;
 
+        /// read back BufferInfo data that's been released after transfer so traversals such as ComputeBounds and Intersector can still access it
+        bool reloadReleasedData = true;
+
         bool getAttributeDetails(const VertexInputState& vas, uint32_t location, AttributeDetails& attributeDetails);
 
         using ConstVisitor::apply;
@@ -13,8 +13,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/state/DescriptorSet.h>
+#include <vsg/state/DynamicBufferRing.h>
 #include <vsg/state/PipelineLayout.h>
 #include <vsg/state/StateCommand.h>
+#include <vsg/vk/DescriptorHeap.h>
 #include <vsg/vk/DescriptorPool.h>
 
 namespace vsg
@@ -78,6 +80,10 @@ namespace vsg
         {
             VkPipelineLayout _vkPipelineLayout = 0;
             std::vector<VkDescriptorSet> _vkDescriptorSets;
+
+            // DescriptorHeap and offsets of the DescriptorSets within it, used when VK_EXT_descriptor_buffer is enabled
+            ref_ptr<DescriptorHeap> _descriptorHeap;
+            std::vector<VkDeviceSize> _descriptorHeapOffsets;
         };
 
         vk_buffer<VulkanData> _vulkanData;
@@ -126,6 +132,10 @@ namespace vsg
         ref_ptr<DescriptorSet> descriptorSet;
         std::vector<uint32_t> dynamicOffsets;
 
+        /// optional DynamicBufferRing whose current frame offset is added to each of the dynamicOffsets, with an offset for each of the
+        /// DescriptorSet's dynamic descriptors when dynamicOffsets is empty. Not supported when VK_EXT_descriptor_buffer is enabled.
+        ref_ptr<DynamicBufferRing> bufferRing;
+
         int compare(const Object& rhs_object) const override;
 
         template<class N, class V>
@@ -153,6 +163,12 @@ namespace vsg
         {
             VkPipelineLayout _vkPipelineLayout = 0;
             VkDescriptorSet _vkDescriptorSet;
+
+            // DescriptorHeap and offset of the DescriptorSet within it, used when VK_EXT_descriptor_buffer is enabled
+            ref_ptr<DescriptorHeap> _descriptorHeap;
+            VkDeviceSize _descriptorHeapOffset = 0;
+
+            uint32_t _numDynamicOffsets = 0;
         };
 
         vk_buffer<VulkanData> _vulkanData;
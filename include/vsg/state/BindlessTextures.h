@@ -0,0 +1,80 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/DescriptorSet.h>
+#include <vsg/state/ImageInfo.h>
+
+#include <map>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// BindlessTextures is a DescriptorSet holding a single large array of combined image samplers that textures are registered into,
+    /// so that many objects can share one DescriptorSet with each draw passing the slots of its textures via push constants or instance data.
+    /// The binding is created as partially bound and update after bind so textures can be added while the DescriptorSet is in use,
+    /// which requires the VkPhysicalDeviceDescriptorIndexingFeatures descriptorBindingPartiallyBound, descriptorBindingSampledImageUpdateAfterBind,
+    /// descriptorBindingUpdateUnusedWhilePending and runtimeDescriptorArray features to be enabled via WindowTraits::deviceFeatures.
+    /// Shaders should declare the array as "layout(set = N, binding = B) uniform sampler2D textures[];" and index it using nonuniformEXT(index) if the index isn't uniform.
+    class VSG_DECLSPEC BindlessTextures : public Inherit<DescriptorSet, BindlessTextures>
+    {
+    public:
+        explicit BindlessTextures(uint32_t in_maxTextures = 4096, uint32_t in_binding = 0, VkShaderStageFlags in_stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT);
+
+        /// size of the texture array
+        const uint32_t maxTextures;
+
+        /// binding of the texture array in the DescriptorSetLayout
+        const uint32_t binding;
+
+        /// register a texture, returning its slot in the texture array. Registering the same ImageInfo again returns the same slot.
+        /// Returns maxTextures if all the slots are used.
+        uint32_t add(ref_ptr<ImageInfo> imageInfo);
+
+        /// register a texture created from image and sampler, registering the same image and sampler pair again returns the same slot.
+        uint32_t add(ref_ptr<Data> image, ref_ptr<Sampler> sampler = {});
+
+        /// release slot for reuse, the caller must ensure no draws still in flight, or recorded in reused command buffers, access the slot.
+        void remove(uint32_t slot);
+
+        /// return the ImageInfo registered in slot
+        ref_ptr<ImageInfo> get(uint32_t slot) const;
+
+        /// number of textures registered
+        uint32_t count() const;
+
+        /// allocate the DescriptorSet if required and write any slots that have been registered since the last compile
+        void compile(Context& context) override;
+
+    protected:
+        virtual ~BindlessTextures();
+
+        struct Slot
+        {
+            ref_ptr<ImageInfo> imageInfo;
+            uint32_t modifiedCount = 0;
+        };
+
+        mutable std::mutex _mutex;
+        std::vector<Slot> _slots;
+        std::vector<uint32_t> _freeSlots;
+        std::map<const ImageInfo*, uint32_t> _imageInfoSlots;
+        std::map<std::pair<const Data*, const Sampler*>, uint32_t> _imageSlots;
+
+        /// the modifiedCount of each slot when it was last written to each device's VkDescriptorSet
+        vk_buffer<std::vector<uint32_t>> _compiledCounts;
+    };
+    VSG_type_name(vsg::BindlessTextures);
+
+} // namespace vsg
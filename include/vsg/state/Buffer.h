@@ -36,11 +36,18 @@ namespace vsg
         VkBufferUsageFlags usage;
         VkSharingMode sharingMode;
 
+        /// when non zero the VkBuffer is created with a VkExternalMemoryBufferCreateInfo so that its memory can be shared with other APIs and processes,
+        /// use allocateAndBindMemory() to allocate exportable dedicated memory, or compile(Device*) and bind() the DeviceMemory returned by importDeviceMemory().
+        VkExternalMemoryHandleTypeFlags externalMemoryHandleTypes = 0;
+
         /// return the number of VulkanData entries.
         uint32_t sizeVulkanData() const { return _vulkanData.size(); }
 
         VkResult bind(DeviceMemory* deviceMemory, VkDeviceSize memoryOffset);
 
+        /// allocate DeviceMemory for the whole buffer and bind it, exportable memory is allocated when externalMemoryHandleTypes is non zero and pNextAllocInfo is null. Requires the VkBuffer to have been created.
+        VkResult allocateAndBindMemory(Device* device, VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, void* pNextAllocInfo = nullptr);
+
         MemorySlots::OptionalOffset reserve(VkDeviceSize in_size, VkDeviceSize alignment);
         void release(VkDeviceSize offset, VkDeviceSize in_size);
 
@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/state/Buffer.h>
 
+#include <algorithm>
 #include <cstring>
 
 namespace vsg
@@ -53,6 +54,16 @@ namespace vsg
         ref_ptr<Data> data;
         ref_ptr<BufferInfo> parent;
 
+        /// empty array of the same type and format as the data, assigned when the data is released after transfer so that it can be recovered with reloadData()
+        ref_ptr<Data> releasedPrototype;
+
+        /// return true if the data has been released after transfer and can be read back from the buffer
+        bool dataReleased() const { return !data && releasedPrototype && buffer; }
+
+        /// read the released data back from the buffer's memory, assigning it to data. Returns null if the data hasn't been released or can't be read back.
+        /// The transfer of the data to the GPU must have completed before calling reloadData().
+        ref_ptr<Data> reloadData();
+
         /// return true if the BufferInfo's data has been modified and should be copied to the buffer
         bool requiresCopy(uint32_t deviceID) const
         {
@@ -65,6 +76,68 @@ namespace vsg
             return data && data->getModifiedCount(copiedModifiedCounts[deviceID]);
         }
 
+        /// return true if the BufferInfo's data has been modified and should be copied to the buffer, and sync the modification counts.
+        /// copyOffset and copySize are set to the range of the BufferInfo that needs copying, which is a subset of it when only a range of the data has been dirtied.
+        bool syncModifiedCounts(uint32_t deviceID, VkDeviceSize& copyOffset, VkDeviceSize& copySize)
+        {
+            if (!data) return false;
+
+            auto& mc = copiedModifiedCounts[deviceID];
+            size_t rangeOffset = 0, rangeSize = 0;
+            bool partial = data->getModifiedRange(mc, rangeOffset, rangeSize);
+            if (!data->getModifiedCount(mc)) return false;
+
+            if (partial && rangeOffset < range)
+            {
+                if (rangeSize == 0) return false;
+
+                // copies are kept 4 byte aligned
+                copyOffset = (rangeOffset / 4) * 4;
+                copySize = std::min(range, ((rangeOffset + rangeSize + 3) / 4) * 4) - copyOffset;
+            }
+            else
+            {
+                copyOffset = 0;
+                copySize = range;
+            }
+            return true;
+        }
+
+        using CopyRanges = std::vector<std::pair<VkDeviceSize, VkDeviceSize>>;
+
+        /// return true if the BufferInfo's data has been modified and should be copied to the buffer, and sync the modification counts.
+        /// copyRanges is set to the disjoint, 4 byte aligned (offset, size) ranges of the BufferInfo that need copying, a single range covering the whole BufferInfo is set when the data has been fully dirtied.
+        bool syncModifiedCounts(uint32_t deviceID, CopyRanges& copyRanges)
+        {
+            copyRanges.clear();
+            if (!data) return false;
+
+            auto& mc = copiedModifiedCounts[deviceID];
+            Data::ModifiedRanges ranges;
+            bool partial = data->getModifiedRanges(mc, ranges);
+            if (!data->getModifiedCount(mc)) return false;
+
+            if (!partial)
+            {
+                copyRanges.emplace_back(0, range);
+                return true;
+            }
+
+            for (auto& [rangeOffset, rangeSize] : ranges)
+            {
+                if (rangeOffset >= range || rangeSize == 0) continue;
+
+                // copies are kept 4 byte aligned, merging with the previous range if alignment makes them overlap
+                VkDeviceSize begin = (rangeOffset / 4) * 4;
+                VkDeviceSize end = std::min(range, ((rangeOffset + rangeSize + 3) / 4) * 4);
+                if (!copyRanges.empty() && begin <= copyRanges.back().first + copyRanges.back().second)
+                    copyRanges.back().second = std::max(copyRanges.back().first + copyRanges.back().second, end) - copyRanges.back().first;
+                else
+                    copyRanges.emplace_back(begin, end - begin);
+            }
+            return !copyRanges.empty();
+        }
+
         vk_buffer<ModifiedCount> copiedModifiedCounts;
 
     protected:
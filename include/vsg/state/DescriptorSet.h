@@ -20,6 +20,7 @@ namespace vsg
 
     // forward declare
     class DescriptorPool;
+    class DescriptorHeap;
 
     /// DescriptorSet encapsulates VkDescriptorSet and VkDescriptorSetAllocateInfo settings used to describe the Descriptors associated with the descriptor set.
     class VSG_DECLSPEC DescriptorSet : public Inherit<Object, DescriptorSet>
@@ -48,13 +49,13 @@ namespace vsg
         void write(Output& output) const override;
 
         // compile the Vulkan object, context parameter used for Device
-        void compile(Context& context);
+        virtual void compile(Context& context);
 
         // remove the local reference to the Vulkan implementation
         void release(uint32_t deviceID);
         void release();
 
-        /// get the Vulkan handle to the descriptor set for specified device
+        /// get the Vulkan handle to the descriptor set for specified device, VK_NULL_HANDLE when allocated from a DescriptorHeap.
         VkDescriptorSet vk(uint32_t deviceID) const;
 
     public:
@@ -65,10 +66,19 @@ namespace vsg
         {
         public:
             Implementation(DescriptorPool* descriptorPool, DescriptorSetLayout* descriptorSetLayout);
+            Implementation(DescriptorHeap* descriptorHeap, DescriptorSetLayout* descriptorSetLayout);
 
             void assign(Context& context, const Descriptors& descriptors);
 
-            VkDescriptorSet _descriptorSet;
+            /// write descriptors using vkUpdateDescriptorSets, or directly into the DescriptorHeap, dstSet is assigned by write().
+            void write(uint32_t descriptorWriteCount, VkWriteDescriptorSet* descriptorWrites);
+
+            VkDescriptorSet _descriptorSet = VK_NULL_HANDLE;
+
+            /// DescriptorHeap and offset within it when allocated using VK_EXT_descriptor_buffer
+            ref_ptr<DescriptorHeap> _descriptorHeap;
+            VkDeviceSize _descriptorHeapOffset = 0;
+            VkDeviceSize _descriptorHeapSize = 0;
 
             static void recycle(ref_ptr<DescriptorSet::Implementation>& dsi);
 
@@ -81,6 +91,13 @@ namespace vsg
             ref_ptr<DescriptorSetLayout> _descriptorSetLayout;
         };
 
+        /// remove the local reference to the Vulkan implementation without recycling it, so the next compile() allocates a new one.
+        /// The caller should recycle the returned implementation once command buffers that use it have completed.
+        ref_ptr<Implementation> detach(uint32_t deviceID);
+
+        /// get the Implementation for specified device, nullptr if not yet compiled.
+        Implementation* getImplementation(uint32_t deviceID) const { return _implementation[deviceID]; }
+
     protected:
         virtual ~DescriptorSet();
 
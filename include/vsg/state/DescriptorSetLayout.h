@@ -34,8 +34,12 @@ namespace vsg
         virtual VkDescriptorSetLayout vk(uint32_t deviceID) const { return _implementation[deviceID]->_descriptorSetLayout; }
 
         /// VkDescriptorSetLayoutCreateInfo settings
+        VkDescriptorSetLayoutCreateFlags flags = 0;
         DescriptorSetLayoutBindings bindings;
 
+        /// optional VkDescriptorSetLayoutBindingFlagsCreateInfo settings, one entry per binding, used to enable descriptor indexing features such as partially bound and update after bind descriptors.
+        std::vector<VkDescriptorBindingFlagsEXT> bindingFlags;
+
         /// map the descriptor bindings to the descriptor pool sizes that will be required to represent them.
         void getDescriptorPoolSizes(DescriptorPoolSizes& descriptorPoolSizes);
 
@@ -51,17 +55,37 @@ namespace vsg
         void release(uint32_t deviceID) { _implementation[deviceID] = {}; }
         void release() { _implementation.clear(); }
 
+        /// VkDescriptorUpdateTemplate used to write all the bindings of a descriptor set in a single vkUpdateDescriptorSetWithTemplate call,
+        /// with an entry per binding locating the binding's VkDescriptorImageInfo/VkDescriptorBufferInfo/VkBufferView within the template data.
+        struct UpdateTemplate
+        {
+            VkDescriptorUpdateTemplate handle = VK_NULL_HANDLE;
+            std::vector<VkDescriptorUpdateTemplateEntry> entries;
+            size_t dataSize = 0;
+        };
+
+        /// get the UpdateTemplate for the specified device, nullptr if not compiled, the device doesn't support update templates,
+        /// or the layout has bindings that can't be written with one such as push descriptor, variable count or partially bound bindings.
+        const UpdateTemplate* getUpdateTemplate(uint32_t deviceID) const
+        {
+            auto& implementation = _implementation[deviceID];
+            return (implementation && implementation->_updateTemplate.handle) ? &(implementation->_updateTemplate) : nullptr;
+        }
+
     protected:
         virtual ~DescriptorSetLayout();
 
         struct Implementation : public Inherit<Object, Implementation>
         {
-            Implementation(Device* device, const DescriptorSetLayoutBindings& descriptorSetLayoutBindings);
+            Implementation(Device* device, const DescriptorSetLayoutBindings& descriptorSetLayoutBindings, VkDescriptorSetLayoutCreateFlags flags = 0, const std::vector<VkDescriptorBindingFlagsEXT>& bindingFlags = {});
 
             virtual ~Implementation();
 
             ref_ptr<Device> _device;
             VkDescriptorSetLayout _descriptorSetLayout;
+            UpdateTemplate _updateTemplate;
+
+            void _createUpdateTemplate(const DescriptorSetLayoutBindings& descriptorSetLayoutBindings, VkDescriptorSetLayoutCreateFlags flags, const std::vector<VkDescriptorBindingFlagsEXT>& bindingFlags);
         };
 
         vk_buffer<ref_ptr<Implementation>> _implementation;
@@ -0,0 +1,100 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/threading/OperationQueue.h>
+#include <vsg/vk/vk_buffer.h>
+
+namespace vsg
+{
+
+    /// DynamicBufferRing is a persistently mapped, host coherent buffer divided into per frame slices, for small frequently updated uniform or storage data
+    /// such as lights and per object parameters. Data added to the ring is written directly into the current frame's slice, avoiding the staging copy
+    /// and barriers of DYNAMIC_DATA updates via TransferTask, with the slice selected by a dynamic offset passed by BindDescriptorSet::bufferRing.
+    /// Add the ring to Viewer::updateOperations with UpdateOperations::ALL_FRAMES so it advances each frame, and leave the Data's dataVariance as STATIC_DATA
+    /// as changes are detected using the Data's ModifiedCount.
+    class VSG_DECLSPEC DynamicBufferRing : public Inherit<Operation, DynamicBufferRing>
+    {
+    public:
+        /// numSlices must exceed the number of frames that can be in flight, as a slice is written before the frame that last used it is waited on.
+        explicit DynamicBufferRing(VkDeviceSize in_sliceSize = 65536, uint32_t in_numSlices = 4, VkBufferUsageFlags in_usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+
+        /// alignment of the BufferInfo within each slice and of the slices, the largest minUniformBufferOffsetAlignment and minStorageBufferOffsetAlignment required by the Vulkan spec.
+        static constexpr VkDeviceSize alignment = 256;
+
+        const VkDeviceSize sliceSize;
+        const uint32_t numSlices;
+        const VkBufferUsageFlags usage;
+
+        /// reserve space for data in each slice, returning the BufferInfo to assign to a DynamicDescriptorBuffer or null if the slices are full.
+        ref_ptr<BufferInfo> add(ref_ptr<Data> data);
+
+        /// dynamic offset of the current frame's slice
+        uint32_t dynamicOffset() const { return static_cast<uint32_t>(_currentSlice * sliceSize); }
+
+        /// advance to the next slice, copying Data modified since that slice was last written into it.
+        void advance();
+
+        void run() override { advance(); }
+
+        /// create the buffer and map its memory for context's device, writing the current data to all slices.
+        void compile(Context& context);
+
+        Buffer* getBuffer() { return _buffer; }
+        const Buffer* getBuffer() const { return _buffer; }
+
+    protected:
+        virtual ~DynamicBufferRing();
+
+        void _copy(uint32_t slice, BufferInfo& bufferInfo);
+
+        struct Entry
+        {
+            ref_ptr<BufferInfo> bufferInfo;
+            std::vector<ModifiedCount> copiedModifiedCounts; // one per slice
+        };
+
+        struct VulkanData
+        {
+            ref_ptr<DeviceMemory> deviceMemory;
+            uint8_t* data = nullptr;
+
+            void release();
+        };
+
+        ref_ptr<Buffer> _buffer;
+        VkDeviceSize _used = 0;
+        uint32_t _currentSlice = 0;
+        std::mutex _mutex;
+        std::vector<Entry> _entries;
+        vk_buffer<VulkanData> _vulkanData;
+    };
+    VSG_type_name(vsg::DynamicBufferRing);
+
+    /// DynamicDescriptorBuffer is a VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC or VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC DescriptorBuffer whose BufferInfo are allocated from a DynamicBufferRing.
+    class VSG_DECLSPEC DynamicDescriptorBuffer : public Inherit<DescriptorBuffer, DynamicDescriptorBuffer>
+    {
+    public:
+        DynamicDescriptorBuffer(ref_ptr<DynamicBufferRing> in_bufferRing, ref_ptr<Data> data, uint32_t dstBinding = 0, uint32_t dstArrayElement = 0, VkDescriptorType descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
+
+        ref_ptr<DynamicBufferRing> bufferRing;
+
+        void compile(Context& context) override;
+
+    protected:
+        virtual ~DynamicDescriptorBuffer();
+    };
+    VSG_type_name(vsg::DynamicDescriptorBuffer);
+
+} // namespace vsg
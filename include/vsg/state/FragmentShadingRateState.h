@@ -0,0 +1,49 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/GraphicsPipeline.h>
+
+namespace vsg
+{
+
+    /// FragmentShadingRateState encapsulates VkPipelineFragmentShadingRateStateCreateInfoKHR settings passed when setting up GraphicsPipeline, requires VK_KHR_fragment_shading_rate.
+    /// Add to a View's overridePipelineStates to set the shading rate for all the pipelines compiled for that View, or to the GraphicsPipelineConfigurator::pipelineStates for a single pipeline.
+    /// To vary the rate without recompiling pipelines include VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR in the DynamicState and use the SetFragmentShadingRate command.
+    class VSG_DECLSPEC FragmentShadingRateState : public Inherit<GraphicsPipelineState, FragmentShadingRateState>
+    {
+    public:
+        FragmentShadingRateState(const VkExtent2D& in_fragmentSize = {1, 1});
+        FragmentShadingRateState(const FragmentShadingRateState& fsrs);
+
+        /// VkPipelineFragmentShadingRateStateCreateInfoKHR settings
+        /// fragmentSize is the width and height, in pixels, shaded by each fragment shader invocation, each of 1, 2 or 4.
+        VkExtent2D fragmentSize = {1, 1};
+
+        /// combinerOps[0] combines the pipeline rate with the per primitive rate, combinerOps[1] combines that result with the rate from the RenderGraph's shading rate attachment.
+        /// The default of MAX lets the attachment coarsen, but not refine, the pipeline's rate.
+        VkFragmentShadingRateCombinerOpKHR combinerOps[2] = {VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR, VK_FRAGMENT_SHADING_RATE_COMBINER_OP_MAX_KHR};
+
+        int compare(const Object& rhs) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        void apply(Context& context, VkGraphicsPipelineCreateInfo& pipelineInfo) const override;
+
+    protected:
+        virtual ~FragmentShadingRateState();
+    };
+    VSG_type_name(vsg::FragmentShadingRateState);
+
+} // namespace vsg
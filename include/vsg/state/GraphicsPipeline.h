@@ -15,12 +15,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/PipelineLayout.h>
 #include <vsg/state/ShaderStage.h>
 #include <vsg/state/StateCommand.h>
+#include <vsg/vk/PipelineCache.h>
 #include <vsg/vk/RenderPass.h>
 
 namespace vsg
 {
     // forward declare
     class Context;
+    class GraphicsPipelineLibraryPart;
 
     /// Base class for setting up the various pipeline states with the VkGraphicsPipelineCreateInfo
     /// Subclasses are ColorBlendState, DepthStencilState, DynamicState, InputAssemblyState,
@@ -59,10 +61,10 @@ namespace vsg
         GraphicsPipeline(PipelineLayout* pipelineLayout, const ShaderStages& shaderStages, const GraphicsPipelineStates& pipelineStates, uint32_t subpass = 0);
 
         /// return the Vulkan Pipeline for specified viewID.
-        VkPipeline vk(uint32_t viewID) const { return _implementation[viewID]->_pipeline; }
+        VkPipeline vk(uint32_t viewID) const { return _implementation[viewID]->_pipeline.load(); }
 
         /// variant of vk(viewID) method that is slower but adds validation of the viewID parameter
-        VkPipeline validated_vk(uint32_t viewID) const { return (viewID < _implementation.size()) ? (_implementation[viewID] ? _implementation[viewID]->_pipeline : 0) : 0; }
+        VkPipeline validated_vk(uint32_t viewID) const { return (viewID < _implementation.size()) ? (_implementation[viewID] ? _implementation[viewID]->_pipeline.load() : 0) : 0; }
 
         /// VkGraphicsPipelineCreateInfo settings
         ShaderStages stages;
@@ -78,24 +80,51 @@ namespace vsg
         // compile the Vulkan object, context parameter used for Device
         void compile(Context& context);
 
+        /// size the per view implementation container for numViews, so that compiling one of those views doesn't resize it while other threads read it
+        void reserve(uint32_t numViews)
+        {
+            if (_implementation.size() < numViews) _implementation.resize(numViews);
+        }
+
         // remove the local reference to the Vulkan implementation
         void release(uint32_t viewID) { _implementation[viewID] = {}; }
         void release() { _implementation.clear(); }
 
+        /// number of background compiles in progress, see Context::asynchronousPipelineCompile
+        std::atomic_uint pendingCompiles{0};
+
+        /// return true while the pipeline is being compiled in the background
+        bool pending() const { return pendingCompiles.load() != 0; }
+
+        /// return true if the pipeline's DynamicState includes any of the states recorded by SetDynamicState, set up by compile()
+        bool usesSetDynamicState() const { return _usesSetDynamicState; }
+
     protected:
         virtual ~GraphicsPipeline();
 
+        bool _usesSetDynamicState = false;
+
         struct Implementation : public Inherit<Object, Implementation>
         {
             Implementation(Context& context, Device* device, const RenderPass* renderPass, const PipelineLayout* pipelineLayout, const ShaderStages& shaderStages, const GraphicsPipelineStates& pipelineStates, uint32_t subpass);
 
             virtual ~Implementation();
 
-            VkPipeline _pipeline;
+            std::atomic<VkPipeline> _pipeline{VK_NULL_HANDLE};
 
             ref_ptr<Device> _device;
+
+            /// when created from a GraphicsPipelineLibrary the fast linked pipeline is used until the link time optimized pipeline replaces it,
+            /// the fast linked pipeline is retained until the Implementation is destroyed so command buffers already recorded with it remain valid.
+            VkPipeline _fastLinkedPipeline = VK_NULL_HANDLE;
+            std::vector<ref_ptr<GraphicsPipelineLibraryPart>> _libraryParts;
+            VkPipelineCreateFlags _flags = 0;
+            ref_ptr<const PipelineLayout> _pipelineLayout;
+            ref_ptr<PipelineCache> _pipelineCache;
         };
 
+        struct LinkOptimizedOperation;
+
         std::vector<ref_ptr<Implementation>> _implementation;
     };
     VSG_type_name(vsg::GraphicsPipeline);
@@ -109,6 +138,12 @@ namespace vsg
         /// pipeline to pass in the vkCmdBindPipeline call;
         ref_ptr<GraphicsPipeline> pipeline;
 
+        /// optional pipeline, with the same PipelineLayout as pipeline, to bind while pipeline is pending, if not assigned the subgraph is skipped till pipeline has been compiled.
+        ref_ptr<GraphicsPipeline> fallbackPipeline;
+
+        /// return true if pipeline is being compiled in the background and no fallbackPipeline is assigned
+        bool pending() const override { return pipeline && pipeline->pending() && !fallbackPipeline; }
+
         int compare(const Object& rhs_object) const override;
 
         void read(Input& input) override;
@@ -0,0 +1,111 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <map>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// GraphicsPipelineLibraryPart wraps a VkPipeline created with VK_PIPELINE_CREATE_LIBRARY_BIT_KHR for one of the VK_EXT_graphics_pipeline_library parts.
+    class VSG_DECLSPEC GraphicsPipelineLibraryPart : public Inherit<Object, GraphicsPipelineLibraryPart>
+    {
+    public:
+        GraphicsPipelineLibraryPart(Device* in_device, VkGraphicsPipelineLibraryFlagsEXT in_flags, VkPipeline in_pipeline);
+
+        const VkGraphicsPipelineLibraryFlagsEXT flags;
+
+        VkPipeline vk() const { return _pipeline; }
+
+    protected:
+        virtual ~GraphicsPipelineLibraryPart();
+
+        VkPipeline _pipeline;
+        ref_ptr<Device> _device;
+    };
+    VSG_type_name(vsg::GraphicsPipelineLibraryPart);
+
+    using GraphicsPipelineLibraryParts = std::vector<ref_ptr<GraphicsPipelineLibraryPart>>;
+
+    /// GraphicsPipelineLibrary splits graphics pipeline creation into the vertex input interface, pre-rasterization shaders, fragment shader
+    /// and fragment output interface parts provided by VK_EXT_graphics_pipeline_library. Parts are cached and shared between all the
+    /// GraphicsPipelines that have matching shaders and state for that part, so a new combination of shaders and state usually only
+    /// requires a fast link of already created parts. The link time optimized pipeline is then created in the background by operationThreads.
+    /// Enabled by setting WindowTraits::graphicsPipelineLibrary, when enabled Context assigns the Device's GraphicsPipelineLibrary to Context::graphicsPipelineLibrary.
+    class VSG_DECLSPEC GraphicsPipelineLibrary : public Inherit<Object, GraphicsPipelineLibrary>
+    {
+    public:
+        explicit GraphicsPipelineLibrary(Device* in_device);
+
+        /// return true if the Device has been created with VK_KHR_pipeline_library and VK_EXT_graphics_pipeline_library enabled.
+        static bool supported(const Device* device);
+
+        /// return the GraphicsPipelineLibrary for the Device, creating one if none is currently in use.
+        static ref_ptr<GraphicsPipelineLibrary> getOrCreate(Device* device);
+
+        /// get or create the parts required for pipelineInfo and return the pipeline fast linked from them, returns VK_NULL_HANDLE if pipelineInfo can't be split into library parts.
+        /// pipelineLayout and renderPass are those pipelineInfo.layout and pipelineInfo.renderPass were assigned from, and are held by the parts created for them.
+        /// shaderStages, in the same order as pipelineInfo.pStages, and pipelineStates are those applied to pipelineInfo and are used to match previously created parts.
+        VkPipeline createFastLinked(const VkGraphicsPipelineCreateInfo& pipelineInfo, const PipelineLayout* pipelineLayout, const RenderPass* renderPass, const ShaderStages& shaderStages, const GraphicsPipelineStates& pipelineStates, VkPipelineCache pipelineCache, GraphicsPipelineLibraryParts& parts);
+
+        /// link parts into a complete pipeline, when optimize is true link time optimization is used which is slower to create but faster to render with.
+        static VkPipeline link(Device* device, const GraphicsPipelineLibraryParts& parts, VkPipelineCreateFlags flags, VkPipelineLayout layout, VkPipelineCache pipelineCache, bool optimize);
+
+        /// threads used to create the link time optimized pipelines.
+        ref_ptr<OperationThreads> operationThreads;
+
+        /// return the number of parts currently cached.
+        size_t numParts() const;
+
+        /// release the cached parts, parts still used by GraphicsPipelines are destroyed once those GraphicsPipelines are released.
+        void clear();
+
+        Device* getDevice() { return _device; }
+        const Device* getDevice() const { return _device; }
+
+    protected:
+        virtual ~GraphicsPipelineLibrary();
+
+        struct PartKey
+        {
+            VkGraphicsPipelineLibraryFlagsEXT flags;
+            VkPipelineCreateFlags pipelineFlags;
+            ref_ptr<const PipelineLayout> layout;
+            ref_ptr<const RenderPass> renderPass;
+            uint32_t subpass;
+
+            // attachment formats and view mask from the VkPipelineRenderingCreateInfo used in place of the renderPass with dynamic rendering
+            std::vector<VkFormat> colorAttachmentFormats;
+            VkFormat depthAttachmentFormat;
+            VkFormat stencilAttachmentFormat;
+            uint32_t viewMask;
+
+            std::vector<ref_ptr<const Object>> objects;
+
+            bool operator<(const PartKey& rhs) const;
+        };
+
+        ref_ptr<GraphicsPipelineLibraryPart> _getOrCreatePart(PartKey& key, const VkGraphicsPipelineCreateInfo& pipelineInfo, const ShaderStages& shaderStages, VkPipelineCache pipelineCache);
+
+        ref_ptr<Device> _device;
+
+        mutable std::mutex _mutex;
+        std::map<PartKey, ref_ptr<GraphicsPipelineLibraryPart>> _parts;
+    };
+    VSG_type_name(vsg::GraphicsPipelineLibrary);
+
+} // namespace vsg
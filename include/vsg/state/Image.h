@@ -48,6 +48,10 @@ namespace vsg
         std::vector<uint32_t> queueFamilyIndices;
         VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
+        /// when non zero the VkImage is created with a VkExternalMemoryImageCreateInfo so that its memory can be shared with other APIs and processes.
+        /// allocateAndBindMemory() and compile(Context&) then allocate exportable dedicated memory, to import memory instead compile(Device*) and bind() the DeviceMemory returned by importDeviceMemory().
+        VkExternalMemoryHandleTypeFlags externalMemoryHandleTypes = 0;
+
         int compare(const Object& rhs_object) const override;
 
         DeviceMemory* getDeviceMemory(uint32_t deviceID) { return _vulkanData[deviceID].deviceMemory; }
@@ -59,6 +63,10 @@ namespace vsg
 
         VkResult allocateAndBindMemory(Device* device, VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, void* pNextAllocInfo = nullptr);
 
+        /// return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, adding VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT when usage includes VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+        /// and the device has a compatible lazily allocated memory type, on tile based GPUs this avoids backing the attachment with memory at all. Requires the VkImage to have been created.
+        VkMemoryPropertyFlags preferredMemoryProperties(Device* device) const;
+
         VkResult bind(DeviceMemory* deviceMemory, VkDeviceSize memoryOffset);
 
         /// return true if the Image's data has been modified and should be copied to the buffer.
@@ -63,6 +63,20 @@ namespace vsg
             return data && data->getModifiedCount(copiedModifiedCounts[deviceID]);
         }
 
+        /// return true if the ImageInfo's data has been modified and should be copied to the buffer, and sync the modification counts.
+        /// ranges is set to the byte ranges of the data that have been modified when only ranges have been dirtied, and left empty when all the data needs copying.
+        bool syncModifiedCounts(uint32_t deviceID, Data::ModifiedRanges& ranges)
+        {
+            ranges.clear();
+            if (!imageView || !imageView->image) return false;
+            auto& data = imageView->image->data;
+            if (!data) return false;
+
+            auto& mc = copiedModifiedCounts[deviceID];
+            if (!data->getModifiedRanges(mc, ranges)) ranges.clear();
+            return data->getModifiedCount(mc);
+        }
+
         vk_buffer<ModifiedCount> copiedModifiedCounts;
 
     protected:
@@ -68,6 +68,29 @@ namespace vsg
     extern VSG_DECLSPEC ref_ptr<ImageView> createImageView(Device* device, ref_ptr<Image> image, VkImageAspectFlags aspectFlags);
 
     /// convenience function that uploads staging buffer data to device including mipmaps.
-    extern VSG_DECLSPEC void transferImageData(ref_ptr<ImageView> imageView, VkImageLayout targetImageLayout, Data::Properties properties, uint32_t width, uint32_t height, uint32_t depth, uint32_t mipLevels, const Data::MipmapOffsets& mipmapOffsets, ref_ptr<Buffer> stagingBuffer, VkDeviceSize stagingBufferOffset, VkCommandBuffer vk_commandBuffer, vsg::Device* device);
+    /// If srcQueueFamilyIndex and dstQueueFamilyIndex differ, and no mipmaps need generating, the final barrier releases ownership of the image to the dstQueueFamilyIndex.
+    /// Returns the final barrier recorded, so a matching acquire barrier can be recorded on the dstQueueFamilyIndex queue.
+    extern VSG_DECLSPEC VkImageMemoryBarrier transferImageData(ref_ptr<ImageView> imageView, VkImageLayout targetImageLayout, Data::Properties properties, uint32_t width, uint32_t height, uint32_t depth, uint32_t mipLevels, const Data::MipmapOffsets& mipmapOffsets, ref_ptr<Buffer> stagingBuffer, VkDeviceSize stagingBufferOffset, VkCommandBuffer vk_commandBuffer, vsg::Device* device,
+                                                               uint32_t srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, uint32_t dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED);
+
+    /// settings for transferring staging buffer data to an image with the batched transferImageData(..)
+    struct ImageTransfer
+    {
+        ref_ptr<ImageView> imageView;
+        VkImageLayout targetImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        Data::Properties properties;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t depth = 0;
+        uint32_t mipLevels = 1;
+        Data::MipmapOffsets mipmapOffsets;
+        ref_ptr<Buffer> stagingBuffer;
+        VkDeviceSize stagingBufferOffset = 0;
+    };
+    using ImageTransfers = std::vector<ImageTransfer>;
+
+    /// convenience function that uploads staging buffer data to many images, recording the layout transitions of all the images in shared barriers
+    /// and generating the mipmaps of all the images that need them level by level, so the number of vkCmdPipelineBarrier is independent of the number of images.
+    extern VSG_DECLSPEC void transferImageData(const ImageTransfers& transfers, VkCommandBuffer vk_commandBuffer, vsg::Device* device);
 
 } // namespace vsg
@@ -0,0 +1,85 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/Descriptor.h>
+#include <vsg/state/PipelineLayout.h>
+#include <vsg/state/StateCommand.h>
+
+namespace vsg
+{
+
+    /// PushDescriptorSet state command encapsulates vkCmdPushDescriptorSetKHR call and associated settings, writing the descriptors
+    /// directly into the command buffer so no DescriptorSet needs to be allocated from a DescriptorPool. Suited to small, frequently changing bindings.
+    /// Requires the VK_KHR_push_descriptor device extension, and the DescriptorSetLayout of the set to have the VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR flag.
+    /// Only image, buffer and texel buffer view descriptors are supported, dynamic uniform/storage buffers can't be used with push descriptors.
+    class VSG_DECLSPEC PushDescriptorSet : public Inherit<StateCommand, PushDescriptorSet>
+    {
+    public:
+        PushDescriptorSet();
+
+        PushDescriptorSet(VkPipelineBindPoint in_bindPoint, PipelineLayout* in_layout, uint32_t in_set, const Descriptors& in_descriptors) :
+            Inherit(1 + in_set),
+            pipelineBindPoint(in_bindPoint),
+            layout(in_layout),
+            set(in_set),
+            descriptors(in_descriptors)
+        {
+        }
+
+        /// vkCmdPushDescriptorSetKHR settings
+        VkPipelineBindPoint pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        ref_ptr<PipelineLayout> layout;
+        uint32_t set = 0;
+        Descriptors descriptors;
+
+        int compare(const Object& rhs_object) const override;
+
+        template<class N, class V>
+        static void t_traverse(N& pds, V& visitor)
+        {
+            if (pds.layout) pds.layout->accept(visitor);
+            for (auto& descriptor : pds.descriptors) descriptor->accept(visitor);
+        }
+
+        void traverse(Visitor& visitor) override { t_traverse(*this, visitor); }
+        void traverse(ConstVisitor& visitor) const override { t_traverse(*this, visitor); }
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        // compile the Vulkan object, context parameter used for Device
+        void compile(Context& context) override;
+
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        virtual ~PushDescriptorSet() {}
+
+        struct VulkanData
+        {
+            VkPipelineLayout _vkPipelineLayout = 0;
+            PFN_vkCmdPushDescriptorSetKHR _vkCmdPushDescriptorSetKHR = nullptr;
+
+            // descriptor writes with the descriptor infos they point to, retained for recording
+            std::vector<VkWriteDescriptorSet> _descriptorWrites;
+            std::vector<VkDescriptorImageInfo> _imageInfos;
+            std::vector<VkDescriptorBufferInfo> _bufferInfos;
+            std::vector<VkBufferView> _texelBufferViews;
+        };
+
+        vk_buffer<VulkanData> _vulkanData;
+    };
+    VSG_type_name(vsg::PushDescriptorSet);
+
+} // namespace vsg
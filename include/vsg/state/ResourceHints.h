@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/io/Options.h>
 #include <vsg/maths/vec2.h>
 #include <vsg/vk/DescriptorPool.h>
 
@@ -37,6 +38,9 @@ namespace vsg
         uivec2 numShadowMapsRange = {0, 64};
         uivec2 shadowMapSize = {2048, 2028};
 
+        /// policy for releasing the CPU copies of STATIC_DATA once they've been transferred to the GPU, released BufferInfo data can be recovered with BufferInfo::reloadData().
+        Options::ReleaseDataHint releaseDataHint = Options::KEEP_DATA;
+
         void read(Input& input) override;
         void write(Output& output) const override;
 
@@ -0,0 +1,73 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DepthStencilState.h>
+#include <vsg/state/DynamicState.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/RasterizationState.h>
+#include <vsg/state/StateCommand.h>
+
+namespace vsg
+{
+
+    /// SetDynamicState state command encapsulates the vkCmdSet* calls of VK_EXT_extended_dynamic_state, VK_EXT_extended_dynamic_state2 and VK_EXT_extended_dynamic_state3,
+    /// recording the listed dynamicStates with the values taken from the assigned RasterizationState, DepthStencilState, InputAssemblyState and ColorBlendState.
+    /// Used with GraphicsPipelines that declare those states dynamic so that materials only differing in cull mode, depth test, topology or blending can share a GraphicsPipeline.
+    class VSG_DECLSPEC SetDynamicState : public Inherit<StateCommand, SetDynamicState>
+    {
+    public:
+        SetDynamicState();
+
+        /// take the values of the listed dynamic states from the RasterizationState, DepthStencilState, InputAssemblyState and ColorBlendState in pipelineStates
+        SetDynamicState(const DynamicState::DynamicStates& in_dynamicStates, const GraphicsPipelineStates& pipelineStates);
+
+        /// slot used by SetDynamicState, after those used by BindGraphicsPipeline and the BindDescriptorSet of sets 0 to 6
+        static constexpr uint32_t dynamicStateSlot = 8;
+
+        /// dynamic states to record, states not supported by SetDynamicState are ignored
+        DynamicState::DynamicStates dynamicStates;
+
+        ref_ptr<RasterizationState> rasterizationState;
+        ref_ptr<DepthStencilState> depthStencilState;
+        ref_ptr<InputAssemblyState> inputAssemblyState;
+        ref_ptr<ColorBlendState> colorBlendState;
+
+        /// return true if the dynamicState is one that SetDynamicState records
+        static bool supported(VkDynamicState dynamicState);
+
+        /// replace the states in pipelineStates with copies that have the values set by this SetDynamicState reset to their defaults and add dynamicStates to the pipeline's DynamicState,
+        /// so that GraphicsPipelines that only differ in their dynamic state compare as equal and can be shared.
+        /// A dynamic primitive topology is reset to the first topology of its topology class, as without dynamicPrimitiveTopologyUnrestricted the topology may only change within the class.
+        void makeDynamic(GraphicsPipelineStates& pipelineStates) const;
+
+        int compare(const Object& rhs_object) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        virtual ~SetDynamicState();
+
+        // per attachment values for the VK_EXT_extended_dynamic_state3 color blend calls, set up by compile()
+        std::vector<VkBool32> _colorBlendEnables;
+        std::vector<VkColorBlendEquationEXT> _colorBlendEquations;
+        std::vector<VkColorComponentFlags> _colorWriteMasks;
+    };
+    VSG_type_name(vsg::SetDynamicState);
+
+} // namespace vsg
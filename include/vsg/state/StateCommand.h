@@ -33,6 +33,9 @@ namespace vsg
 
         uint32_t slot = 0;
 
+        /// return true if the StateCommand isn't ready to be recorded, in which case RecordTraversal skips the subgraph the StateCommand applies to
+        virtual bool pending() const { return false; }
+
     protected:
         virtual ~StateCommand() {}
     };
@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/app/CommandGraph.h>
 #include <vsg/app/RenderGraph.h>
 #include <vsg/io/Logger.h>
+#include <vsg/maths/sphere.h>
 #include <vsg/nodes/Light.h>
 #include <vsg/nodes/Switch.h>
 #include <vsg/state/BindDescriptorSet.h>
@@ -140,17 +141,90 @@ namespace vsg
         ref_ptr<BufferInfo> viewportDataBufferInfo;
 
         ref_ptr<Image> shadowDepthImage;
+        ref_ptr<Image> staticShadowDepthImage;
         ref_ptr<DescriptorImage> shadowMapImages;
 
         ref_ptr<DescriptorSetLayout> descriptorSetLayout;
         ref_ptr<DescriptorBuffer> descriptor;
         ref_ptr<DescriptorSet> descriptorSet;
 
+        /// clustered lighting settings, must be set before the ViewDependentState is initialized.
+        /// When enabled the point and spot lights are assigned to a clusterDimensions grid of view frustum clusters, split into tiles in x/y and
+        /// exponentially spaced depth slices in z, and written to the clusterData storage buffer at binding 3 so shaders only need to
+        /// iterate over the lights that affect the fragment's cluster.
+        /// clusterData layout, as uints:
+        ///   [0..3] clusterDimensions.x, y, z, number of light indices used
+        ///   [4..7] floatBitsToUint of the near and far eye distances of the depth slices, and 0, 0
+        ///   [8 + 2 * cluster] offset and count of the cluster's light indices, cluster = (z * dimY + y) * dimX + x
+        ///   [8 + 2 * numClusters + offset + i] index of the vec4 in lightData that the light's settings start at, with the top bit set for spot lights
+        /// The tile x/y are computed from the fragment's normalized device coordinates, or from gl_FragCoord relative to viewportData,
+        /// and z from the eye distance d as floor(log(d / near) / log(far / near) * dimZ).
+        bool clusteredLighting = false;
+        uivec3 clusterDimensions = {16, 9, 24};
+        uint32_t maxClusterLightIndices = 65536;
+
+        /// light intensity below which a light is considered to no longer affect a cluster, used to compute each light's range from its intensity
+        float clusterLightCutoff = 0.01f;
+
+        /// when enabled the RecordTraversal culls PointLight and SpotLight against the view frustum using their range of influence, so only visible lights are packed into lightData
+        bool cullLights = false;
+
+        /// return the distance at which the light's intensity falls below clusterLightCutoff, used for both light culling and cluster assignment
+        double lightRange(const Light& light) const { return std::sqrt(std::max(static_cast<double>(light.intensity), 0.0) / static_cast<double>(clusterLightCutoff)); }
+
+        /// return the bounding sphere, in the light's local coordinates, of the volume that the light illuminates
+        dsphere lightBound(const PointLight& light) const { return dsphere(light.position, lightRange(light)); }
+        dsphere lightBound(const SpotLight& light) const;
+
+        ref_ptr<uintArray> clusterData;
+        ref_ptr<BufferInfo> clusterDataBufferInfo;
+        ref_ptr<DescriptorBuffer> clusterDescriptor;
+
+        /// multiview matrices, allocated when the View has multiviewCameras and bound at binding 4 for the vertex shaders to index with gl_ViewIndex.
+        /// multiviewData layout, for each of up to maxMultiviews views:
+        ///   [2 * viewIndex] the view's projection matrix
+        ///   [2 * viewIndex + 1] the view's view matrix relative to the View's camera, so modelView push constants can be transformed into the view's eye coordinates
+        /// Lighting is computed in the View's camera eye coordinates so lightData and the shadow maps are shared by all the views.
+        static constexpr uint32_t maxMultiviews = 4;
+        ref_ptr<mat4Array> multiviewData;
+        ref_ptr<BufferInfo> multiviewDataBufferInfo;
+        ref_ptr<DescriptorBuffer> multiviewDescriptor;
+
         // shadow map hints
         double maxShadowDistance = 1e8;
         double shadowMapBias = 0.005;
         double lambda = 0.5;
 
+        enum CascadeFitting
+        {
+            FIT_TO_SLICE,  ///< fit the shadow map to the light space bounds of the view frustum slice
+            FIT_TIGHT,     ///< rotate the shadow map about the light direction to minimize the area of the view frustum slice's bounds
+            FIT_STABILIZED ///< fit to the view frustum slice's bounding sphere and snap to whole texels, to avoid shimmering edges as the view moves
+        };
+
+        CascadeFitting cascadeFitting = FIT_TO_SLICE;
+
+        /// distance to extend the shadow map volume towards the light, so that casters outside the view frustum slice are rendered into it
+        double shadowCasterExtension = 0.0;
+
+        /// eye space depth range of the visible receivers, when y > x the cascade splits are computed over this range rather than the camera's near/far.
+        /// Typically set by the application from a depth reduction of the previous frame's depth buffer.
+        dvec2 receiverDepthRange = {0.0, 0.0};
+
+        /// shadow map caching settings, must be set before the ViewDependentState is initialized.
+        /// When enabled the subgraphs with node masks matching staticShadowCasterMask are rendered into a cached shadow map that is only
+        /// re-rendered when the light direction changes or the view frustum slice moves outside the cached bounds, with the subgraphs
+        /// matching dynamicShadowCasterMask rendered over a copy of the cache each frame.
+        bool cacheShadowMaps = false;
+        Mask staticShadowCasterMask = 0x1;
+        Mask dynamicShadowCasterMask = 0x2;
+
+        /// proportion to enlarge the shadow map bounds by when refitting, so small view changes can reuse the cached shadow map
+        double shadowMapCacheMargin = 0.2;
+
+        /// number of frames between re-rendering of cascades beyond the first when they haven't needed refitting, 1 updates every frame
+        uint32_t distantCascadeUpdateInterval = 1;
+
         // Shadow backend.
         ref_ptr<CommandGraph> preRenderCommandGraph;
         ref_ptr<Switch> preRenderSwitch;
@@ -159,12 +233,36 @@ namespace vsg
         {
             ref_ptr<RenderGraph> renderGraph;
             ref_ptr<View> view;
+
+            // static casters' cache, only used when cacheShadowMaps is enabled
+            ref_ptr<RenderGraph> staticRenderGraph;
+            ref_ptr<View> staticView;
+            ref_ptr<Switch> staticSwitch;
+
+            // light and direction that the shadow map camera was last fitted for
+            bool valid = false;
+            const void* light = nullptr;
+            dvec3 lightDirection;
         };
 
         mutable std::vector<ShadowMap> shadowMaps;
 
     protected:
         ~ViewDependentState();
+
+        struct ClusterLight
+        {
+            uint32_t lightDataIndex;
+            dvec3 eye_position;
+            double range;
+        };
+
+        /// assign the lights to clusters and write the results to clusterData
+        virtual void assignLightClusters(const std::vector<ClusterLight>& lights) const;
+
+        mutable std::vector<ClusterLight> _clusterLights;
+        mutable std::vector<uint32_t> _clusterCounts;
+        mutable std::vector<uivec3> _clusterRanges;
     };
     VSG_type_name(vsg::ViewDependentState);
 
@@ -38,13 +38,34 @@ namespace vsg
 
         void setup(Text* text, uint32_t minimumAllocation = 0, ref_ptr<const Options> options = {}) override;
         void setup(TextGroup* textGroup, uint32_t minimumAllocation = 0, ref_ptr<const Options> options = {}) override;
+        bool update(TextGroup* textGroup, Text* text) override;
         dbox extents() const override { return textExtents; }
 
-        virtual ref_ptr<Node> createRenderingSubgraph(ref_ptr<ShaderSet> shaderSet, ref_ptr<Font> font, bool billboard, TextQuads& textQuads, uint32_t minimumAllocation);
+        virtual ref_ptr<Node> createRenderingSubgraph(ref_ptr<ShaderSet> shaderSet, ref_ptr<Font> font, bool in_billboard, TextQuads& textQuads, uint32_t minimumAllocation);
+
+        /// DataVariance of the vertex arrays, set to DYNAMIC_DATA before the first setup() to allow the text to be changed after it has been compiled.
+        /// When dynamic, subsequent setup() calls that fit within the existing arrays update them in place and keep the existing rendering subgraph.
+        DataVariance dataVariance = STATIC_DATA;
+
+        /// number of spare glyphs allocated for each Text of a dynamic TextGroup so that update(..) can lengthen a Text in place
+        uint32_t textSlack = 4;
+
+        struct TextRange
+        {
+            uint32_t firstQuad = 0;
+            uint32_t capacity = 0;
+        };
 
         // implementation data structure
         dbox textExtents;
         ref_ptr<Node> scenegraph;
+        std::vector<TextRange> textRanges; ///< quads allocated to each of the TextGroup's children
+
+        bool billboard = false;
+        bool singleColor = true;
+        bool singleOutlineColor = true;
+        bool singleOutlineWidth = true;
+        bool singleCenterAutoScaleDistance = true;
 
         ref_ptr<vec3Array> vertices;
         ref_ptr<vec4Array> colors;
@@ -57,6 +78,9 @@ namespace vsg
 
         ref_ptr<BindVertexBuffers> bindVertexBuffers;
         ref_ptr<BindIndexBuffer> bindIndexBuffer;
+
+    protected:
+        void _assignQuad(uint32_t vi, const TextQuad& quad);
     };
     VSG_type_name(vsg::CpuLayoutTechnique);
 
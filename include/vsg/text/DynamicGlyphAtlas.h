@@ -0,0 +1,118 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/TransferTask.h>
+#include <vsg/state/ImageInfo.h>
+#include <vsg/text/GlyphMetrics.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace vsg
+{
+
+    // forward declare
+    class Font;
+
+    /// GlyphRasterizer is the interface used by DynamicGlyphAtlas to create glyphs on demand, implemented by font loaders such as vsgXchange's freetype support.
+    class VSG_DECLSPEC GlyphRasterizer : public Inherit<Object, GlyphRasterizer>
+    {
+    public:
+        /// return the signed distance field of the glyph for charcode, no larger than maximumSize x maximumSize texels, and assign its metrics,
+        /// normalized to the font height, other than the uvrect which is assigned by the DynamicGlyphAtlas. Return null if the font doesn't have the glyph.
+        /// May be called from multiple threads.
+        virtual ref_ptr<ubyteArray2D> rasterize(uint32_t charcode, uint32_t maximumSize, GlyphMetrics& metrics) = 0;
+
+        float ascender = 1.0f;
+        float descender = 0.0f;
+        float height = 1.0f;
+    };
+    VSG_type_name(vsg::GlyphRasterizer);
+
+    /// DynamicGlyphAtlas provides a Font with a fixed size atlas that glyphs are rasterized into when first used, so fonts with large character sets
+    /// such as CJK only use atlas memory for the glyphs in use. The atlas is split into equally sized cells, and once all the cells are used the least
+    /// recently used glyph that has not been used for minimumEvictionAge frames is replaced. Glyphs rasterized after the atlas has been compiled are
+    /// uploaded as sub image copies by the assigned TransferTask.
+    /// Text whose glyphs are pending or have been evicted needs to be set up again once glyphsModifiedCount changes.
+    class VSG_DECLSPEC DynamicGlyphAtlas : public Inherit<Object, DynamicGlyphAtlas>
+    {
+    public:
+        DynamicGlyphAtlas(ref_ptr<GlyphRasterizer> in_rasterizer, uint32_t in_cellSize = 64, uint32_t in_numCellsX = 32, uint32_t in_numCellsY = 32);
+
+        const ref_ptr<GlyphRasterizer> rasterizer;
+        const uint32_t cellSize;
+        const uint32_t numCellsX;
+        const uint32_t numCellsY;
+
+        /// threads to rasterize glyphs on, if null glyphs are rasterized by the thread that first uses them
+        ref_ptr<OperationThreads> operationThreads;
+
+        /// TransferTask used to upload glyphs once the atlas has been compiled, typically the viewer's RecordAndSubmitTask::earlyTransferTask
+        ref_ptr<TransferTask> transferTask;
+
+        /// number of frames a glyph must go unused before its cell can be reused
+        uint64_t minimumEvictionAge = 2;
+
+        /// assign the atlas, glyph metrics and ascender/descender/height to the font, and the font's glyph lookups to this atlas
+        void setup(Font& font);
+
+        /// return the index into the Font::glyphMetrics of the glyph for charcode, or 0 if the glyph isn't available yet.
+        /// Glyphs not already in the atlas are rasterized, or queued for rasterization when operationThreads is assigned.
+        uint32_t glyphIndex(uint32_t charcode) const;
+
+        /// advance the frame count used to decide which glyphs can be evicted, call once per frame
+        void advanceFrame() { ++_frameCount; }
+
+        /// incremented whenever glyphs are added or evicted
+        uint32_t glyphsModifiedCount() const { return _glyphsModifiedCount.load(); }
+
+        uint32_t numCells() const { return numCellsX * numCellsY; }
+        uint32_t numPending() const;
+        uint32_t numEvictions() const { return _numEvictions.load(); }
+
+    protected:
+        virtual ~DynamicGlyphAtlas();
+
+        struct Cell
+        {
+            uint32_t charcode = 0;
+            uint64_t frameLastUsed = 0;
+            bool occupied = false;
+            bool pending = false;
+            bool valid = false;
+        };
+
+        friend struct RasterizeGlyph;
+
+        ref_ptr<ubyteArray2D> _rasterize(uint32_t charcode, GlyphMetrics& metrics) const;
+        void _assign(uint32_t cellIndex, uint32_t charcode, ref_ptr<ubyteArray2D> image, const GlyphMetrics& metrics) const;
+        bool _allocate(uint32_t charcode, uint32_t& cellIndex) const;
+
+        mutable std::mutex _mutex;
+        mutable std::vector<Cell> _cells;
+        mutable std::unordered_map<uint32_t, uint32_t> _charcodeCells;
+        mutable std::atomic_uint32_t _glyphsModifiedCount{0};
+        mutable uint32_t _numPending = 0;
+        mutable std::atomic_uint32_t _numEvictions{0};
+        std::atomic_uint64_t _frameCount{1};
+
+        ref_ptr<ubyteArray2D> _atlas;
+        ref_ptr<GlyphMetricsArray> _glyphMetrics;
+        ref_ptr<ImageInfo> _atlasImageInfo;
+        ref_ptr<ImageInfo> _glyphImageInfo;
+    };
+    VSG_type_name(vsg::DynamicGlyphAtlas);
+
+} // namespace vsg
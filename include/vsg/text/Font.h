@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Data.h>
 #include <vsg/io/Options.h>
 #include <vsg/state/ImageInfo.h>
+#include <vsg/text/DynamicGlyphAtlas.h>
 #include <vsg/text/GlyphMetrics.h>
 #include <vsg/utils/SharedObjects.h>
 
@@ -39,9 +40,13 @@ namespace vsg
         ref_ptr<ImageInfo> atlasImageInfo;
         ref_ptr<ImageInfo> glyphImageInfo;
 
+        /// when assigned glyphs are rasterized on demand into the atlas rather than looked up in the charmap, see DynamicGlyphAtlas::setup(Font&)
+        ref_ptr<DynamicGlyphAtlas> dynamicAtlas;
+
         /// get the index into the glyphMetrics array for the glyph associated with specified charcode
         uint32_t glyphIndexForCharcode(uint32_t charcode) const
         {
+            if (dynamicAtlas) return dynamicAtlas->glyphIndex(charcode);
             if (charmap && charcode < charmap->size()) return charmap->at(charcode);
             return 0;
         }
@@ -0,0 +1,202 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/Camera.h>
+#include <vsg/commands/DrawIndirect.h>
+#include <vsg/commands/DrawIndirectCommand.h>
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ComputePipeline.h>
+#include <vsg/text/TextTechnique.h>
+
+namespace vsg
+{
+    /// per label data used by GpuLabelTechnique, read by the LabelCulling compute shader and the label vertex shader
+    struct LabelStruct
+    {
+        vec4 position;       ///< xyz position, w billboardAutoScaleDistance
+        vec4 horizontal;     ///< xyz horizontal axis, w 1.0 for billboard labels
+        vec4 vertical;       ///< xyz vertical axis
+        vec4 color;
+        vec4 outlineColor;
+        vec4 extents;        ///< min x/y, max x/y of the glyph quads in units of the horizontal/vertical axes
+        uint32_t firstGlyph; ///< index of the label's first glyph in the glyph array
+        uint32_t numGlyphs;
+        float outlineWidth;
+        float maximumDistance; ///< distance beyond which the label is culled, 0.0 for no limit
+
+        void read(vsg::Input& input)
+        {
+            input.read("position", position);
+            input.read("horizontal", horizontal);
+            input.read("vertical", vertical);
+            input.read("color", color);
+            input.read("outlineColor", outlineColor);
+            input.read("extents", extents);
+            input.read("firstGlyph", firstGlyph);
+            input.read("numGlyphs", numGlyphs);
+            input.read("outlineWidth", outlineWidth);
+            input.read("maximumDistance", maximumDistance);
+        }
+
+        void write(vsg::Output& output) const
+        {
+            output.write("position", position);
+            output.write("horizontal", horizontal);
+            output.write("vertical", vertical);
+            output.write("color", color);
+            output.write("outlineColor", outlineColor);
+            output.write("extents", extents);
+            output.write("firstGlyph", firstGlyph);
+            output.write("numGlyphs", numGlyphs);
+            output.write("outlineWidth", outlineWidth);
+            output.write("maximumDistance", maximumDistance);
+        }
+    };
+
+    template<>
+    constexpr bool has_read_write<LabelStruct>() { return true; }
+
+    VSG_array(LabelArray, LabelStruct);
+
+    /// per glyph data used by GpuLabelTechnique, the glyph quad is generated in the vertex shader from the rect and uvrect
+    struct LabelGlyph
+    {
+        vec4 rect;   ///< min x/y, max x/y in units of the label's horizontal/vertical axes
+        vec4 uvrect; ///< min x/y, max x/y of the glyph in the font atlas
+        uint32_t label;
+        uint32_t padding[3];
+
+        void read(vsg::Input& input)
+        {
+            input.read("rect", rect);
+            input.read("uvrect", uvrect);
+            input.read("label", label);
+        }
+
+        void write(vsg::Output& output) const
+        {
+            output.write("rect", rect);
+            output.write("uvrect", uvrect);
+            output.write("label", label);
+        }
+    };
+
+    template<>
+    constexpr bool has_read_write<LabelGlyph>() { return true; }
+
+    VSG_array(LabelGlyphArray, LabelGlyph);
+
+    /// LabelCulling command culls the labels of a GpuLabelTechnique on the GPU using a compute shader, testing each label against the Camera's view frustum
+    /// and maximum distances, then decluttering the labels that remain by giving each cell of a screen space grid to the visible label with the lowest index.
+    /// Labels that don't own all the cells they overlap are culled, so TextGroup::children should be ordered by priority.
+    /// The glyphs of the labels that remain are written to the visibleGlyphs buffer and counted in the drawCommand's instanceCount, for a single DrawIndirect.
+    /// Add one LabelCulling per Camera viewing the labels, ahead of that Camera's RenderGraph, see Dispatch for the placement of compute commands.
+    /// Like the label vertex and fragment shaders, the culling shader is GLSL source compiled via the Context's ShaderCompiler.
+    class VSG_DECLSPEC LabelCulling : public Inherit<Command, LabelCulling>
+    {
+    public:
+        LabelCulling();
+
+        /// Camera providing the view frustum and viewport
+        ref_ptr<Camera> camera;
+
+        /// local to world transform of the TextGroup
+        dmat4 matrix;
+
+        /// labels beyond this distance from the eye are culled
+        double maximumDistance = std::numeric_limits<double>::max();
+
+        /// enable screen space decluttering
+        bool declutter = true;
+
+        /// size in pixels of the cells used for decluttering
+        uint32_t declutterCellSize = 16;
+
+        /// maximum number of grid cells, the cell size is increased for viewports that would need more
+        uint32_t maximumGridCells = 256 * 256;
+
+        /// input labels
+        ref_ptr<BufferInfo> labels;
+
+        /// output indices of the visible glyphs
+        ref_ptr<BufferInfo> visibleGlyphs;
+
+        /// output DrawIndirectCommand whose instanceCount is the number of visible glyphs
+        ref_ptr<BufferInfo> drawCommand;
+
+        uint32_t numLabels = 0;
+
+        /// local workgroup size used by the compute shader
+        static constexpr uint32_t workgroupSize = 64;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        ref_ptr<BufferInfo> _grid;
+        ref_ptr<BufferInfo> _labelRects;
+        ref_ptr<PipelineLayout> _pipelineLayout;
+        ref_ptr<BindComputePipeline> _bindPipeline;
+        ref_ptr<BindDescriptorSet> _bindDescriptorSet;
+        ref_ptr<PipelineBarrier> _preCullBarrier;
+        ref_ptr<PipelineBarrier> _clearBarrier;
+        ref_ptr<PipelineBarrier> _claimBarrier;
+        ref_ptr<PipelineBarrier> _postCullBarrier;
+    };
+    VSG_type_name(vsg::LabelCulling);
+
+    /// GpuLabelTechnique is a TextTechnique for TextGroups with very large numbers of labels, such as map labels.
+    /// All the labels and glyphs are held in storage buffers, glyph quads are generated in the vertex shader, and a LabelCulling command culls the labels and
+    /// writes the visible glyphs for a single DrawIndirect covering the whole TextGroup.
+    /// Only Text with a StandardLayout is supported. The LabelCulling command must be added to the CommandGraph ahead of the RenderGraph that renders the TextGroup.
+    class VSG_DECLSPEC GpuLabelTechnique : public Inherit<TextTechnique, GpuLabelTechnique>
+    {
+    public:
+        template<class N, class V>
+        static void t_traverse(N& node, V& visitor)
+        {
+            if (node.scenegraph) node.scenegraph->accept(visitor);
+        }
+
+        void traverse(Visitor& visitor) override { t_traverse(*this, visitor); }
+        void traverse(ConstVisitor& visitor) const override { t_traverse(*this, visitor); }
+        void traverse(RecordTraversal& visitor) const override { t_traverse(*this, visitor); }
+
+        void setup(Text* text, uint32_t minimumAllocation = 0, ref_ptr<const Options> options = {}) override;
+        void setup(TextGroup* textGroup, uint32_t minimumAllocation = 0, ref_ptr<const Options> options = {}) override;
+        dbox extents() const override { return textExtents; }
+
+        /// Camera used by the culling command, assign before setup(..)
+        ref_ptr<Camera> camera;
+
+        /// distance beyond which labels are culled, assigned to LabelStruct::maximumDistance, 0.0 for no limit
+        float labelMaximumDistance = 0.0f;
+
+        // implementation data structure
+        dbox textExtents;
+        ref_ptr<Node> scenegraph;
+
+        ref_ptr<LabelArray> labels;
+        ref_ptr<LabelGlyphArray> glyphs;
+        ref_ptr<LabelCulling> culling;
+        ref_ptr<DrawIndirect> draw;
+    };
+    VSG_type_name(vsg::GpuLabelTechnique);
+
+    /// create the ShaderSet used by GpuLabelTechnique, if options->shaderSets["label"] is assigned it is returned instead
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createLabelShaderSet(ref_ptr<const Options> options = {});
+
+} // namespace vsg
@@ -57,6 +57,10 @@ namespace vsg
         /// create the rendering backend.
         /// minimumAllocation provides a hint for the minimum number of glyphs to allocate space for.
         virtual void setup(uint32_t minimumAllocation = 0, ref_ptr<const Options> options = {});
+
+        /// update the rendering of a child Text after its text or layout has changed, patching the technique's existing data in place where possible,
+        /// otherwise falling back to a full setup(), which creates a new rendering subgraph that will need compiling.
+        virtual void update(Text* text, ref_ptr<const Options> options = {});
     };
     VSG_type_name(vsg::TextGroup);
 } // namespace vsg
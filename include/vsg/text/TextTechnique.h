@@ -27,6 +27,9 @@ namespace vsg
         virtual void setup(Text* text, uint32_t minimumAllocation = 0, ref_ptr<const Options> options = {}) = 0;
         virtual void setup(TextGroup* text, uint32_t minimumAllocation = 0, ref_ptr<const Options> options = {}) = 0;
         virtual dbox extents() const = 0;
+
+        /// update the rendering of a Text that is a child of the TextGroup in place, returns false if this isn't possible and TextGroup::setup() is required.
+        virtual bool update(TextGroup* /*textGroup*/, Text* /*text*/) { return false; }
     };
     VSG_type_name(vsg::TextTechnique);
 
@@ -42,4 +42,8 @@ namespace vsg
     /// Note, under Linux the CPU affinity of thread is inherited by any threads that it creates
     extern VSG_DECLSPEC void setAffinity(const Affinity& affinity);
 
+    /// return the NUMA node that the cpus of the affinity are on, or -1 if unknown or the cpus are spread across several nodes.
+    /// Used to assign the MemoryPlacement::numaNode of memory accessed by threads running with that affinity.
+    extern VSG_DECLSPEC int numaNode(const Affinity& affinity);
+
 } // namespace vsg
@@ -13,13 +13,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/core/Inherit.h>
-
-#include <condition_variable>
+#include <vsg/threading/ThreadParker.h>
 
 namespace vsg
 {
 
     /// Barrier provides a means for synchronizing multiple threads that all release together once specified number of threads joined the Barrier.
+    /// Arrival is counted with atomics, the waiting threads spin briefly before parking.
     class Barrier : public Inherit<Object, Barrier>
     {
     public:
@@ -34,23 +34,22 @@ namespace vsg
         /// increment the arrived count and release the barrier if count matches number of threads to arrive otherwise wait for the arrived count to match the number of threads to arrive
         void arrive_and_wait()
         {
-            std::unique_lock lock(_mutex);
-            if (++_num_arrived == _num_threads)
+            // the phase can't advance until this thread has arrived so it's safe to read it first
+            auto my_phase = _phase.load();
+            if (_num_arrived.fetch_add(1) + 1 == _num_threads)
             {
                 _release();
             }
             else
             {
-                auto my_phase = _phase;
-                _cv.wait(lock, [this, my_phase]() { return this->_phase != my_phase; });
+                _parker.wait([this, my_phase]() { return this->_phase.load() != my_phase; });
             }
         }
 
         /// increment the arrived count and release the barrier if count matches number of threads to arrive, return immediately without waiting for release condition
         void arrive_and_drop()
         {
-            std::unique_lock lock(_mutex);
-            if (++_num_arrived == _num_threads)
+            if (_num_arrived.fetch_add(1) + 1 == _num_threads)
             {
                 _release();
             }
@@ -61,17 +60,17 @@ namespace vsg
 
         void _release()
         {
-            _num_arrived = 0;
+            // reset the count before advancing the phase so released threads arriving at the next phase are counted afresh
+            _num_arrived.store(0);
             ++_phase;
-            _cv.notify_all();
+            _parker.notify_all();
         }
 
         const uint32_t _num_threads;
-        uint32_t _num_arrived;
-        uint32_t _phase;
+        std::atomic_uint32_t _num_arrived;
+        std::atomic_uint32_t _phase;
 
-        std::mutex _mutex;
-        std::condition_variable _cv;
+        ThreadParker _parker;
     };
     VSG_type_name(vsg::Barrier);
 
@@ -13,12 +13,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/threading/ActivityStatus.h>
+#include <vsg/threading/ThreadParker.h>
 #include <vsg/ui/ApplicationEvent.h>
 
 namespace vsg
 {
 
     /// FrameBlock provides a mechanism for synchronizing threads that are waiting on the start of a new frame.
+    /// Waiting threads spin briefly on an atomic copy of the current FrameStamp pointer before parking, so a new frame can be picked up without a lock or a futex wake up.
     class FrameBlock : public Inherit<Object, FrameBlock>
     {
     public:
@@ -26,6 +28,7 @@ namespace vsg
 
         explicit FrameBlock(ref_ptr<ActivityStatus> status) :
             _value(initial_value),
+            _current(initial_value.get()),
             _status(status) {}
 
         FrameBlock(const FrameBlock&) = delete;
@@ -33,9 +36,12 @@ namespace vsg
 
         void set(ref_ptr<FrameStamp> frameStamp)
         {
-            std::scoped_lock lock(_mutex);
-            _value = frameStamp;
-            _cv.notify_all();
+            {
+                std::scoped_lock lock(_mutex);
+                _value = frameStamp;
+                _current.store(frameStamp.get());
+            }
+            _parker.notify_all();
         }
 
         ref_ptr<FrameStamp> get()
@@ -48,19 +54,15 @@ namespace vsg
 
         void wake()
         {
-            std::scoped_lock lock(_mutex);
-            _cv.notify_all();
+            _parker.notify_all();
         }
 
         bool wait_for_change(ref_ptr<FrameStamp>& value)
         {
-            std::unique_lock lock(_mutex);
-            while (_value == value && _status->active())
-            {
-                _cv.wait(lock);
-            }
+            // value holds a reference to the FrameStamp so its address can't be reused by a later frame
+            _parker.wait([&]() { return _current.load() != value.get() || !_status->active(); });
 
-            value = _value;
+            value = get();
             return _status->active();
         }
 
@@ -68,9 +70,10 @@ namespace vsg
         virtual ~FrameBlock() {}
 
         std::mutex _mutex;
-        std::condition_variable _cv;
         ref_ptr<FrameStamp> _value;
+        std::atomic<FrameStamp*> _current;
         ref_ptr<ActivityStatus> _status;
+        ThreadParker _parker;
     };
     VSG_type_name(vsg::FrameBlock);
 
@@ -0,0 +1,120 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/threading/Affinity.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <memory>
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class JobSystem;
+
+    /// Job is an Operation that can depend upon other Jobs, it's only run once all the Jobs it depends upon have completed.
+    /// Dependencies are only honoured when the Job is added to a JobSystem, all Jobs in a dependency graph must be added to the JobSystem.
+    class VSG_DECLSPEC Job : public Inherit<Operation, Job>
+    {
+    public:
+        explicit Job(ref_ptr<Operation> in_operation = {});
+
+        /// operation to run, subclasses may instead override run() and call completed() when done
+        ref_ptr<Operation> operation;
+
+        /// declare that this Job must not run until dependency has completed, must be called before this Job is added to the JobSystem
+        void dependsOn(ref_ptr<Job> dependency);
+
+        /// convenience method for declaring that the continuation must not run until this Job has completed, returns continuation to allow chaining
+        ref_ptr<Job> then(ref_ptr<Job> continuation)
+        {
+            continuation->dependsOn(ref_ptr<Job>(this));
+            return continuation;
+        }
+
+        void run() override;
+
+        /// return true if this Job has completed
+        bool isCompleted() const;
+
+    protected:
+        virtual ~Job();
+
+        /// mark the Job as completed and schedule any continuations that no longer have outstanding dependencies
+        void completed();
+
+        friend class JobSystem;
+
+        // one count for each outstanding dependency plus one that is released when the Job is added to the JobSystem
+        std::atomic_uint _pendingCount{1};
+        JobSystem* _jobSystem = nullptr;
+
+        mutable std::mutex _mutex;
+        bool _completed = false;
+        std::vector<ref_ptr<Job>> _continuations;
+    };
+    VSG_type_name(vsg::Job);
+
+    /// JobSystem is a work stealing alternative to OperationThreads.
+    /// Each worker thread has its own lock free deque, Operations added from a worker thread are pushed on to that thread's deque
+    /// and Operations added from other threads are pushed on to a shared queue. Idle workers take from their own deque first,
+    /// then the shared queue, then steal from the other workers' deques.
+    /// As JobSystem is an OperationThreads it can be shared by the DatabasePager, CompileManager and vsg::Options::operationThreads.
+    class VSG_DECLSPEC JobSystem : public Inherit<OperationThreads, JobSystem>
+    {
+    public:
+        /// create numThreads worker threads, if the affinity has at least numThreads cpus each worker is pinned to its own cpu, otherwise all workers share the affinity.
+        explicit JobSystem(uint32_t numThreads, const Affinity& in_affinity = {}, ref_ptr<ActivityStatus> in_status = {});
+
+        /// add an Operation, if it's a Job with outstanding dependencies it'll be scheduled once they complete.
+        void add(ref_ptr<Operation> operation) override;
+
+        /// use this thread to run operations until none are available.
+        /// When called from a worker thread only the operations in that worker's deque are run.
+        void run() override;
+
+        /// stop threads
+        void stop() override;
+
+        /// return the number of worker threads
+        size_t numWorkers() const { return _workers.size(); }
+
+        Affinity affinity;
+
+    protected:
+        virtual ~JobSystem();
+
+        friend class Job;
+
+        struct Worker;
+
+        /// push an Operation that is ready to run.
+        void _schedule(ref_ptr<Operation> operation);
+
+        /// take next available Operation, checking worker's deque first, then shared queue, then the other workers' deques
+        ref_ptr<Operation> _next(Worker* worker);
+
+        void _workerLoop(Worker* worker);
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+
+        std::atomic_int64_t _numQueued{0};
+        std::atomic_uint _numSleeping{0};
+        std::mutex _sleepMutex;
+        std::condition_variable _sleepCV;
+    };
+    VSG_type_name(vsg::JobSystem);
+
+} // namespace vsg
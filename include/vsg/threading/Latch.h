@@ -13,14 +13,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/core/Inherit.h>
-
-#include <condition_variable>
-#include <mutex>
+#include <vsg/threading/ThreadParker.h>
 
 namespace vsg
 {
 
     /// Latch provides a means for synchronizing multiple threads that waits for the latch count to be decremented to zero.
+    /// The count is atomic, waiting threads spin briefly before parking.
     class Latch : public Inherit<Object, Latch>
     {
     public:
@@ -63,22 +62,17 @@ namespace vsg
 
         bool is_ready() const
         {
-            return (_count <= 0);
+            return (_count.load() <= 0);
         }
 
         void wait()
         {
-            std::unique_lock lock(_mutex);
-            while (_count > 0)
-            {
-                _cv.wait(lock);
-            }
+            _parker.wait([this]() { return _count.load() <= 0; });
         }
 
         virtual void release()
         {
-            std::unique_lock lock(_mutex);
-            _cv.notify_all();
+            _parker.notify_all();
         }
 
         int count() const { return _count.load(); }
@@ -87,8 +81,7 @@ namespace vsg
         virtual ~Latch() {}
 
         std::atomic_int _count;
-        std::mutex _mutex;
-        std::condition_variable _cv;
+        ThreadParker _parker;
     };
     VSG_type_name(vsg::Latch)
 
@@ -14,7 +14,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/threading/OperationQueue.h>
 
+#include <functional>
 #include <thread>
+#include <vector>
 
 namespace vsg
 {
@@ -29,7 +31,7 @@ namespace vsg
         OperationThreads(const OperationThreads&) = delete;
         OperationThreads& operator=(const OperationThreads& rhs) = delete;
 
-        void add(ref_ptr<Operation> operation)
+        virtual void add(ref_ptr<Operation> operation)
         {
             queue->add(operation);
         }
@@ -37,15 +39,15 @@ namespace vsg
         template<typename Iterator>
         void add(Iterator begin, Iterator end)
         {
-            queue->add(begin, end);
+            for (auto itr = begin; itr != end; ++itr) add(*itr);
         }
 
         /// use this thread to run operations till the queue is empty as well
         /// this thread will consume and run operations in parallel with any threads associated with this OperationThreads.
-        void run();
+        virtual void run();
 
         /// stop threads
-        void stop();
+        virtual void stop();
 
         using Threads = std::list<std::thread>;
         Threads threads;
@@ -57,4 +59,8 @@ namespace vsg
     };
     VSG_type_name(vsg::OperationThreads)
 
+    /// run the functions on the operationThreads, using the calling thread as well, and wait till they have all completed.
+    /// If any of the functions throw, the first exception is rethrown on the calling thread once all the functions have completed.
+    extern VSG_DECLSPEC void runAndWait(OperationThreads& operationThreads, const std::vector<std::function<void()>>& functions);
+
 } // namespace vsg
@@ -0,0 +1,116 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#    include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#    include <immintrin.h>
+#endif
+
+namespace vsg
+{
+
+    /// hint to the CPU that the calling thread is spinning waiting on another thread
+    inline void cpu_relax()
+    {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    /// ThreadParker provides the waiting side of the lock free threading primitives such as Latch, Barrier and FrameBlock.
+    /// Waiting threads spin briefly checking the ready condition before parking, the spin count adapting to whether previous spins succeeded.
+    /// When C++20 atomic wait/notify are available threads park on an atomic epoch, otherwise on a condition variable that's only locked when threads are parked,
+    /// so notify_all() is just an atomic load when no threads are waiting.
+    /// The state that the ready condition tests must be modified with sequentially consistent atomic operations before notify_all() is called.
+    class ThreadParker
+    {
+    public:
+        static constexpr uint32_t minSpinCount = 16;
+        static constexpr uint32_t maxSpinCount = 4096;
+
+        ThreadParker() = default;
+        ThreadParker(const ThreadParker&) = delete;
+        ThreadParker& operator=(const ThreadParker&) = delete;
+
+        /// wait until ready() returns true
+        template<typename F>
+        void wait(F ready)
+        {
+            uint32_t spinCount = _spinCount.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < spinCount; ++i)
+            {
+                if (ready())
+                {
+                    // spinning succeeded so allow longer spins
+                    if (spinCount < maxSpinCount) _spinCount.store(spinCount * 2, std::memory_order_relaxed);
+                    return;
+                }
+                cpu_relax();
+            }
+
+            // spinning failed so shorten future spins
+            if (spinCount > minSpinCount) _spinCount.store(spinCount / 2, std::memory_order_relaxed);
+
+#if defined(__cpp_lib_atomic_wait)
+            ++_numParked;
+            for (;;)
+            {
+                uint32_t epoch = _epoch.load();
+                if (ready()) break;
+                _epoch.wait(epoch);
+            }
+            --_numParked;
+#else
+            std::unique_lock lock(_mutex);
+            ++_numParked;
+            _cv.wait(lock, ready);
+            --_numParked;
+#endif
+        }
+
+        /// wake all parked threads so they recheck their ready condition
+        void notify_all()
+        {
+            if (_numParked.load() == 0) return;
+
+#if defined(__cpp_lib_atomic_wait)
+            ++_epoch;
+            _epoch.notify_all();
+#else
+            std::scoped_lock lock(_mutex);
+            _cv.notify_all();
+#endif
+        }
+
+    protected:
+        std::atomic_uint32_t _spinCount{256};
+        std::atomic_uint32_t _numParked{0};
+
+#if defined(__cpp_lib_atomic_wait)
+        std::atomic_uint32_t _epoch{0};
+#else
+        std::mutex _mutex;
+        std::condition_variable _cv;
+#endif
+    };
+
+} // namespace vsg
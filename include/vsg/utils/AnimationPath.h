@@ -17,6 +17,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/ui/KeyEvent.h>
 
 #include <map>
+#include <vector>
 
 namespace vsg
 {
@@ -53,11 +54,73 @@ namespace vsg
         Location computeLocation(double time) const;
         dmat4 computeMatrix(double time) const;
 
+        /// remove control points that can be interpolated from their neighbours to within the specified tolerances, returns the number of control points removed.
+        /// positionTolerance is a distance, orientationTolerance an angle in radians and scaleTolerance the maximum difference of each scale component.
+        size_t reduce(double positionTolerance, double orientationTolerance = 0.001, double scaleTolerance = 0.001);
+
         void read(Input& input) override;
         void write(Output& output) const override;
     };
     VSG_type_name(vsg::AnimationPath);
 
+    /// CompactAnimationPath is a compact, sorted array form of an AnimationPath for efficient evaluation of large numbers of paths.
+    /// Orientations are stored in single precision and scales are only stored when they aren't all {1.0, 1.0, 1.0}.
+    /// Lookups can pass in a hint, the index of the interval found by the previous lookup, so that forward playback finds the interval in O(1) amortized time.
+    class VSG_DECLSPEC CompactAnimationPath : public Inherit<Object, CompactAnimationPath>
+    {
+    public:
+        CompactAnimationPath();
+        explicit CompactAnimationPath(const AnimationPath& path);
+
+        AnimationPath::Mode mode = AnimationPath::ONCE;
+        std::vector<double> times;
+        std::vector<dvec3> positions;
+        std::vector<quat> orientations;
+        std::vector<vec3> scales;
+
+        size_t size() const { return times.size(); }
+        double period() const { return times.empty() ? 0.0 : (times.back() - times.front()); }
+
+        /// map time onto the range of times, applying the mode
+        double localTime(double time) const;
+
+        /// return the index i of the interval times[i] <= time <= times[i+1] for a local time, searching from hint first and updating hint to the result. Requires at least 2 control points.
+        size_t findInterval(double time, size_t& hint) const;
+
+        AnimationPath::Location computeLocation(double time) const;
+        AnimationPath::Location computeLocation(double time, size_t& hint) const;
+
+        dmat4 computeMatrix(double time) const;
+        dmat4 computeMatrix(double time, size_t& hint) const;
+    };
+    VSG_type_name(vsg::CompactAnimationPath);
+
+    /// AnimationPathBatch evaluates the matrices of many CompactAnimationPath at once, such as for large numbers of vehicles following recorded paths.
+    /// Each path keeps its own lookup hint so forward playback avoids searching, and the interpolation and matrix composition use SIMD when available.
+    /// Orientations are interpolated with normalized linear interpolation, which for densely sampled paths is visually indistinguishable from the slerp used by AnimationPath.
+    class VSG_DECLSPEC AnimationPathBatch : public Inherit<Object, AnimationPathBatch>
+    {
+    public:
+        struct Entry
+        {
+            ref_ptr<CompactAnimationPath> path;
+            double timeOffset = 0.0;
+            size_t hint = 0;
+        };
+
+        std::vector<Entry> entries;
+
+        /// add a path to the batch, timeOffset is added to the time passed to computeMatrices() for this path, returns the index of the path's matrix
+        size_t add(ref_ptr<CompactAnimationPath> path, double timeOffset = 0.0);
+
+        /// compute the matrices of all the paths at the specified time, matrices must have room for one matrix per entry.
+        void computeMatrices(double time, dmat4* matrices);
+
+        /// compute the matrices of all the paths at the specified time, resizing matrices to match the number of entries.
+        void computeMatrices(double time, std::vector<dmat4>& matrices);
+    };
+    VSG_type_name(vsg::AnimationPathBatch);
+
     /// AnimationPathHandler event handler animates Camera or MatrixTransform along an AnimationPath.
     /// To automatically update, attach the AnimationPathHandler to the viewer using Viewer::addEventHandler().
     class VSG_DECLSPEC AnimationPathHandler : public Inherit<Visitor, AnimationPathHandler>
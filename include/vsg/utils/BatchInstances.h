@@ -0,0 +1,103 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Visitor.h>
+#include <vsg/maths/box.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/GraphicsPipeline.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace vsg
+{
+
+    /// BatchInstances collapses a VertexIndexDraw, or StateGroup chain ending in a VertexIndexDraw, that is shared by many translation only MatrixTransforms
+    /// into instanced draws with a per instance vsg_position attribute, replacing one draw and push constant matrix change per instance with one draw per cluster.
+    /// Instances are grouped into spatial clusters of up to maximumInstancesPerCluster, each decorated with a CullNode so view frustum culling is retained.
+    /// The GraphicsPipeline is duplicated with an extra per instance binding for the positions and the instancePositionsDefine added to the shader hints,
+    /// so it must be built from shader source that supports VSG_INSTANCE_POSITIONS, such as the standard flat, phong and pbr ShaderSets.
+    /// Usage:
+    ///     vsg::BatchInstances batchInstances;
+    ///     scene->accept(batchInstances);
+    ///     batchInstances.batch();
+    class VSG_DECLSPEC BatchInstances : public Inherit<Visitor, BatchInstances>
+    {
+    public:
+        BatchInstances();
+
+        /// only batch subgraphs that are shared by at least this many transforms
+        uint32_t minimumInstances = 4;
+
+        /// maximum number of instances in each culled cluster
+        uint32_t maximumInstancesPerCluster = 256;
+
+        /// attribute location of the per instance position
+        uint32_t positionLocation = 4;
+
+        /// define that enables per instance positions in the shaders
+        std::string instancePositionsDefine = "VSG_INSTANCE_POSITIONS";
+
+        /// tolerance used when checking whether a MatrixTransform's matrix is a pure translation
+        double translationEpsilon = 1e-6;
+
+        uint32_t numBatches = 0;
+        uint32_t numClusters = 0;
+        uint32_t numInstances = 0; ///< transformed instances replaced by instanced draws
+
+        void apply(Node& node) override;
+        void apply(Group& group) override;
+        void apply(StateGroup& stateGroup) override;
+        void apply(MatrixTransform& transform) override;
+        void apply(BindGraphicsPipeline& bindPipeline) override;
+
+        /// replace the instances collected by the traversal, returns the number of batches created.
+        uint32_t batch();
+
+    protected:
+        struct Anchor
+        {
+            const GraphicsPipeline* pipeline = nullptr;
+            bool valid = true;
+        };
+
+        struct Instance
+        {
+            MatrixTransform* transform = nullptr;
+            dvec3 position;
+        };
+
+        using Key = std::pair<Group*, Node*>;
+
+        void _traverse(Group& group);
+        void _traverseAnchor(Group& group);
+        ref_ptr<GraphicsPipeline> _instancedPipeline(const GraphicsPipeline* pipeline, uint32_t positionBinding);
+        bool _batch(const Key& key, const std::vector<Instance>& instances);
+
+        // nearest ancestor Group that isn't a translation only MatrixTransform, batches are added as its children
+        Group* _anchor = nullptr;
+        Group* _parent = nullptr;
+        dvec3 _offset;
+        const GraphicsPipeline* _currentPipeline = nullptr;
+
+        std::map<Group*, Anchor> _anchors;
+        std::map<Key, std::vector<Instance>> _instances;
+        std::map<MatrixTransform*, std::set<Group*>> _transformParents;
+        std::map<std::pair<const GraphicsPipeline*, uint32_t>, ref_ptr<GraphicsPipeline>> _pipelines;
+    };
+    VSG_type_name(vsg::BatchInstances);
+
+} // namespace vsg
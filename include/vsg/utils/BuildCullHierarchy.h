@@ -0,0 +1,69 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Visitor.h>
+#include <vsg/maths/box.h>
+#include <vsg/nodes/CullGroup.h>
+
+#include <set>
+#include <vector>
+
+namespace vsg
+{
+
+    /// BuildCullHierarchy reorganizes wide flat Groups into a balanced bounding volume hierarchy of CullGroups, so that the RecordTraversal
+    /// can reject subgraphs that are mostly off screen with a handful of frustum tests rather than testing every child's bound.
+    /// Children are partitioned by the surface area heuristic until no more than maximumLeafChildren remain in each leaf CullGroup.
+    /// Only Group, CullGroup, StateGroup and MatrixTransform children lists are reorganized, children without valid bounds are kept as direct children.
+    /// Note, the order of the children changes, so subgraphs that rely on the draw order of siblings should be placed in a Bin or DepthSorted.
+    /// Usage:
+    ///     vsg::BuildCullHierarchy buildCullHierarchy;
+    ///     scene->accept(buildCullHierarchy);
+    class VSG_DECLSPEC BuildCullHierarchy : public Inherit<Visitor, BuildCullHierarchy>
+    {
+    public:
+        BuildCullHierarchy();
+
+        /// only reorganize Groups with at least this many children
+        uint32_t minimumChildren = 32;
+
+        /// maximum number of children in each leaf CullGroup
+        uint32_t maximumLeafChildren = 8;
+
+        /// number of buckets along the longest axis to evaluate when choosing where to split
+        uint32_t numBuckets = 16;
+
+        uint32_t numGroupsReorganized = 0;
+        uint32_t numCullGroupsCreated = 0;
+
+        void apply(Node& node) override;
+        void apply(Group& group) override;
+
+    protected:
+        struct Item
+        {
+            ref_ptr<Node> node;
+            dbox bounds;
+            dvec3 center;
+        };
+
+        using Items = std::vector<Item>;
+
+        ref_ptr<CullGroup> _build(Items::iterator begin, Items::iterator end);
+
+        std::set<Group*> _visited;
+    };
+    VSG_type_name(vsg::BuildCullHierarchy);
+
+} // namespace vsg
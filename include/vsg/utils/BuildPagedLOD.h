@@ -0,0 +1,128 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/core/Visitor.h>
+#include <vsg/io/Options.h>
+#include <vsg/maths/box.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <memory>
+#include <vector>
+
+namespace vsg
+{
+
+    /// BuildPagedLOD partitions the triangles of a scene graph into an octree, or quadtree, of tiles and writes them out as a paged database,
+    /// so that models too large to render, or hold in memory, at full detail can be streamed by the DatabasePager.
+    /// The leaf tiles contain the original triangles, each parent tile contains a simplified version of its children's triangles
+    /// and a PagedLOD that loads the file containing its children when it's close enough.
+    /// The triangles of VertexIndexDraw and Geometry are collected with their accumulated transforms and StateGroups, draws are split
+    /// by triangle so single large meshes are partitioned too, and the StateGroups are replicated in each tile that uses them.
+    /// Partitioning, simplification and writing of tiles are done in parallel when operationThreads is assigned.
+    /// Usage:
+    ///     vsg::BuildPagedLOD buildPagedLOD("city_database");
+    ///     scene->accept(buildPagedLOD);
+    ///     auto root = buildPagedLOD.build(); // also written to city_database/tiles.vsgb
+    class VSG_DECLSPEC BuildPagedLOD : public Inherit<Visitor, BuildPagedLOD>
+    {
+    public:
+        explicit BuildPagedLOD(const Path& in_outputDirectory, ref_ptr<const Options> in_options = {});
+
+        /// directory the tiles are written to
+        Path outputDirectory;
+
+        /// base name of the tile files
+        std::string name = "tiles";
+        std::string extension = ".vsgb";
+
+        /// options passed to vsg::write(..)
+        ref_ptr<const Options> options;
+
+        /// split tiles in x and y only, suitable for models that are much wider than they are high, such as cities
+        bool quadtree = false;
+
+        uint32_t maximumTrianglesPerTile = 65536;
+        uint32_t maximumLevels = 12;
+
+        /// PagedLOD::Child::minimumScreenHeightRatio at which the children of a tile are loaded
+        double lodTransitionScreenHeightRatio = 0.25;
+
+        /// maximum simplification error of parent tiles as a ratio of the tile's bounding sphere radius
+        double simplificationError = 0.02;
+
+        /// attribute location of the vertex positions
+        uint32_t vertexLocation = 0;
+
+        /// optional threads used to build and write tiles in parallel
+        ref_ptr<OperationThreads> operationThreads;
+
+        uint32_t numTiles = 0;
+
+        void apply(Node& node) override;
+        void apply(StateGroup& stateGroup) override;
+        void apply(Transform& transform) override;
+        void apply(BindGraphicsPipeline& bindPipeline) override;
+        void apply(VertexIndexDraw& vid) override;
+        void apply(Geometry& geometry) override;
+
+        /// partition the collected triangles, write the tiles and return the root node, nullptr if no triangles have been collected.
+        ref_ptr<Node> build();
+
+    protected:
+        struct Item
+        {
+            std::vector<ref_ptr<StateGroup>> stateGroups;
+            dmat4 matrix;
+            uint32_t firstBinding = 0;
+            DataList arrays;
+            std::vector<bool> perVertex;
+            ref_ptr<vec3Array> vertices;
+            std::vector<uint32_t> indices;
+            uint32_t instanceCount = 1;
+        };
+
+        struct Part
+        {
+            uint32_t item = 0;
+            std::vector<uint32_t> triangles;
+        };
+
+        struct Cell
+        {
+            uint32_t level = 0;
+            std::string filename;
+            dbox bounds;
+            std::vector<Part> parts;
+            size_t numTriangles = 0;
+            std::vector<std::unique_ptr<Cell>> children;
+            ref_ptr<Node> content;
+        };
+
+        void _addDraw(Node& draw, uint32_t firstBinding, const BufferInfoList& arrays, ref_ptr<BufferInfo> indices, uint32_t firstIndex, uint32_t indexCount, uint32_t instanceCount);
+        void _split(Cell& cell) const;
+        void _createContent(Cell& cell) const;
+        ref_ptr<Node> _createNode(Cell& cell, std::vector<std::pair<ref_ptr<Node>, Path>>& files);
+        void _runInParallel(const std::vector<Cell*>& cells, void (BuildPagedLOD::*function)(Cell&) const);
+
+        std::vector<ref_ptr<StateGroup>> _stateGroups;
+        std::vector<dmat4> _matrixStack;
+        GraphicsPipeline* _currentPipeline = nullptr;
+        std::vector<Item> _items;
+    };
+    VSG_type_name(vsg::BuildPagedLOD);
+
+} // namespace vsg
@@ -0,0 +1,74 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/core/Value.h>
+#include <vsg/io/Options.h>
+#include <vsg/maths/box.h>
+#include <vsg/nodes/PointCloud.h>
+#include <vsg/nodes/StateGroup.h>
+
+namespace vsg
+{
+
+    /// BuildPointCloud partitions a set of points into an octree and creates a PointCloud, with the tiles written out to outputDirectory
+    /// so that they can be streamed by the DatabasePager, or kept in memory when no outputDirectory is assigned.
+    /// Each octant keeps at most one point per cell of a gridResolution^3 grid across its bounds, up to maximumPointsPerOctant, and passes
+    /// the remaining points on to its children, so each level adds finer detail to the levels above it.
+    /// The returned StateGroup binds a point rendering pipeline whose vertex shader sizes the points from the octant's point spacing,
+    /// so that the points of coarser octants are drawn larger to fill the gaps between them. The point size shader requires the
+    /// Device to be created with the largePoints feature enabled.
+    /// Usage:
+    ///     vsg::BuildPointCloud buildPointCloud("lidar_database");
+    ///     auto root = buildPointCloud.build(positions, colors); // also written to lidar_database/points.vsgb
+    class VSG_DECLSPEC BuildPointCloud : public Inherit<Object, BuildPointCloud>
+    {
+    public:
+        explicit BuildPointCloud(const Path& in_outputDirectory = {}, ref_ptr<const Options> in_options = {});
+
+        /// directory the tiles are written to, if empty the tiles are kept in memory
+        Path outputDirectory;
+
+        /// base name of the root and tile files
+        std::string name = "points";
+        std::string extension = ".vsgb";
+
+        /// options passed to vsg::write(..)
+        ref_ptr<const Options> options;
+
+        uint32_t maximumPointsPerOctant = 65536;
+        uint32_t maximumLevels = 16;
+        uint32_t gridResolution = 128;
+
+        /// vec4(pointSizeScale, minimumPointSize, maximumPointSize, viewportHeight) uniform used by the point shader, sizes in pixels.
+        /// viewportHeight should be updated by the application when the window is resized.
+        ref_ptr<vec4Value> pointSizeSettings;
+
+        /// partition the points and return the StateGroup containing the PointCloud, nullptr if there are no points.
+        /// colors are optional, if assigned they must be the same size as positions.
+        ref_ptr<StateGroup> build(ref_ptr<const vec3Array> positions, ref_ptr<const ubvec4Array> colors = {});
+
+        /// create the StateGroup that binds the point rendering pipeline
+        ref_ptr<StateGroup> createStateGroup(bool perVertexColors) const;
+
+    protected:
+        uint32_t _addOctant(PointCloud& pointCloud, const dbox& bounds, std::vector<uint32_t>& indices, uint32_t level);
+        ref_ptr<Node> _createTile(const std::vector<uint32_t>& indices, const dvec3& center, double spacing) const;
+
+        ref_ptr<const vec3Array> _positions;
+        ref_ptr<const ubvec4Array> _colors;
+    };
+    VSG_type_name(vsg::BuildPointCloud);
+
+} // namespace vsg
@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/app/CompileTraversal.h>
+#include <vsg/core/AllocatorArena.h>
 #include <vsg/maths/box.h>
 #include <vsg/maths/sphere.h>
 #include <vsg/utils/ShaderSet.h>
@@ -115,6 +116,15 @@ namespace vsg
 
         ref_ptr<StateGroup> createStateGroup(const StateInfo& stateInfo = {});
 
+        using CreateShapeFunction = ref_ptr<Node> (Builder::*)(const GeometryInfo&, const StateInfo&);
+
+        /// create a shape for each GeometryInfo using one of the create methods above, i.e. createShapes(&Builder::createBox, infos),
+        /// with all the shapes placed beneath a single StateGroup so the state is created and compiled once rather than per shape.
+        ref_ptr<Node> createShapes(CreateShapeFunction createShape, const std::vector<GeometryInfo>& infos, const StateInfo& stateInfo = {});
+
+        /// optional arena that the nodes and arrays created by createShapes() are allocated from
+        ref_ptr<AllocatorArena> allocatorArena;
+
         /// assign compile traversal to enable compilation.
         void assignCompileTraversal(ref_ptr<CompileTraversal> ct);
 
@@ -128,6 +138,9 @@ namespace vsg
 
         ref_ptr<Node> decorateAndCompileIfRequired(const GeometryInfo& info, const StateInfo& stateInfo, ref_ptr<Node> node);
 
+        // set by createShapes() so that the individual shapes aren't decorated with their own StateGroup or compiled
+        bool _batchingShapes = false;
+
         ref_ptr<ShaderSet> _flatShadedShaderSet;
         ref_ptr<ShaderSet> _phongShaderSet;
 
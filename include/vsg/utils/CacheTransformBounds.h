@@ -0,0 +1,42 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Visitor.h>
+
+#include <set>
+
+namespace vsg
+{
+
+    /// CacheTransformBounds assigns MatrixTransform::bound for each MatrixTransform in a subgraph, computed from the subgraph beneath it in the parent's coordinate frame.
+    /// The bounds are only valid while the subgraphs don't change, including the matrices of any nested MatrixTransforms, so should only be used for static subgraphs.
+    /// Usage:
+    ///     vsg::CacheTransformBounds cacheTransformBounds;
+    ///     staticSubgraph->accept(cacheTransformBounds);
+    class VSG_DECLSPEC CacheTransformBounds : public Inherit<Visitor, CacheTransformBounds>
+    {
+    public:
+        CacheTransformBounds();
+
+        uint32_t numBoundsAssigned = 0;
+
+        void apply(Node& node) override;
+        void apply(MatrixTransform& transform) override;
+
+    protected:
+        std::set<MatrixTransform*> _visited;
+    };
+    VSG_type_name(vsg::CacheTransformBounds);
+
+} // namespace vsg
@@ -12,12 +12,72 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/observer_ptr.h>
 #include <vsg/maths/box.h>
 #include <vsg/state/ArrayState.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <map>
+#include <mutex>
 
 namespace vsg
 {
 
+    /// BoundsCache caches the bounds of subgraphs computed by ComputeBounds so they can be reused by subsequent ComputeBounds traversals,
+    /// avoiding re-reading the vertex arrays of unchanged subgraphs.
+    /// Cached bounds are in the local coordinate frame of the node, and are invalidated automatically when any of the arrays they were computed from are modified,
+    /// i.e. Data::dirty() is called. Changes to the structure of the scene graph, such as adding or removing children or changing transforms,
+    /// need to be notified by calling dirty() with the path to the modified node so the bounds of the node and all its ancestors are recomputed.
+    /// Thread safe, so a BoundsCache can be shared by ComputeBounds running in different threads.
+    class VSG_DECLSPEC BoundsCache : public Inherit<Object, BoundsCache>
+    {
+    public:
+        BoundsCache();
+
+        struct DataSource
+        {
+            observer_ptr<Data> data;
+            ModifiedCount modifiedCount;
+        };
+
+        using DataSources = std::vector<DataSource>;
+
+        /// get the cached bounds of the node, returns false if there are no cached bounds or they are no longer valid
+        bool getBounds(const Node& node, dbox& bounds, DataSources& sources);
+
+        /// assign the bounds of the node computed from the specified data sources
+        void setBounds(const Node& node, const dbox& bounds, const DataSources& sources);
+
+        /// invalidate the cached bounds of the node
+        void dirty(const Node* node);
+
+        /// invalidate the cached bounds of all the nodes in a node path, used to propagate a change in a node to all its ancestors
+        void dirty(const std::vector<const Node*>& nodePath);
+
+        /// remove all the cached bounds
+        void clear();
+
+        /// remove the cached bounds of nodes that have been deleted, returns the number removed
+        size_t prune();
+
+        /// return the number of cached bounds
+        size_t size() const;
+
+    protected:
+        virtual ~BoundsCache();
+
+        struct Entry
+        {
+            observer_ptr<Node> node;
+            dbox bounds;
+            DataSources sources;
+        };
+
+        mutable std::mutex _mutex;
+        std::map<const Node*, Entry> _entries;
+    };
+    VSG_type_name(vsg::BoundsCache);
+
     /// ComputeBounds traverses a scene graph computing an overall bounding box that encloses all the geometry in that scene graph.
     class VSG_DECLSPEC ComputeBounds : public Inherit<ConstVisitor, ComputeBounds>
     {
@@ -31,6 +91,14 @@ namespace vsg
         /// Using the bounding volumes is faster but may result in less tight bounds around the geometry in the scene.
         bool useNodeBounds = true;
 
+        /// optional cache of the bounds of Groups, Transforms, StateGroups and draw nodes, reused when their subgraphs haven't changed.
+        /// The cached bounds of a subgraph are transformed as a box into the parent's coordinate frame so may be less tight under rotations.
+        ref_ptr<BoundsCache> boundsCache;
+
+        /// optional OperationThreads used to compute the bounds of draws with at least minimumVerticesForThreading vertices in parallel
+        ref_ptr<OperationThreads> operationThreads;
+        uint32_t minimumVerticesForThreading = 65536;
+
         using ArrayStateStack = std::vector<ref_ptr<ArrayState>>;
         ArrayStateStack arrayStateStack;
 
@@ -41,6 +109,7 @@ namespace vsg
         ref_ptr<const uintArray> uint_indices;
 
         void apply(const Object& node) override;
+        void apply(const Group& group) override;
         void apply(const StateGroup& stategroup) override;
         void apply(const Transform& transform) override;
         void apply(const MatrixTransform& transform) override;
@@ -69,6 +138,15 @@ namespace vsg
 
         void add(const dbox& bb);
         void add(const dsphere& bs);
+
+    protected:
+        template<class F>
+        void _cached(const Node& node, F traverse);
+
+        void _addVertices(const vec3Array& vertices, const Data* indices, uint32_t first, uint32_t end);
+
+        BoundsCache::DataSources _dataSources;
+        uint32_t _cacheDepth = 0;
     };
     VSG_type_name(vsg::ComputeBounds);
 
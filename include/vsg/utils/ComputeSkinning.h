@@ -0,0 +1,93 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/core/Array.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ComputePipeline.h>
+
+namespace vsg
+{
+
+    /// ComputeSkinning command evaluates morph targets and linear blend skinning of a mesh's vertices and normals on the GPU using a compute shader,
+    /// writing the results to the skinnedVertices and skinnedNormals BufferInfos that can be used as the vsg_Vertex and vsg_Normal arrays of the draw,
+    /// so the phong and pbr ShaderSets render skinned meshes without modification.
+    /// The outputs are only held in device memory, they have no Data, so each frame's skinned results are shared by all the passes that draw the mesh,
+    /// such as the ViewDependentState shadow map passes and the main view, while intersections and bounds use the draw's other arrays.
+    /// jointMatrices and morphWeights should be DYNAMIC_DATA and updated prior to the record traversal, the BufferInfo for jointMatrices can be shared
+    /// by all the ComputeSkinning of a skeleton so that the joint matrices are only transferred once per frame.
+    /// Adding it to the CommandGraph ahead of the RenderGraph ensures it's compiled, and the outputs allocated, before the draws that use them.
+    class VSG_DECLSPEC ComputeSkinning : public Inherit<Command, ComputeSkinning>
+    {
+    public:
+        struct MorphTarget
+        {
+            ref_ptr<vec3Array> vertexDeltas;
+            ref_ptr<vec3Array> normalDeltas;
+        };
+        using MorphTargets = std::vector<MorphTarget>;
+
+        /// jointIndices, jointWeights and jointMatrices may be null when only morph targets are used, morphWeights must be the same size as morphTargets
+        ComputeSkinning(ref_ptr<vec3Array> in_vertices, ref_ptr<vec3Array> in_normals,
+                        ref_ptr<uivec4Array> in_jointIndices, ref_ptr<vec4Array> in_jointWeights, ref_ptr<BufferInfo> in_jointMatrices,
+                        const MorphTargets& in_morphTargets = {}, ref_ptr<floatArray> in_morphWeights = {});
+
+        /// bind pose vertices and normals, the same size
+        ref_ptr<vec3Array> vertices;
+        ref_ptr<vec3Array> normals;
+
+        /// per vertex indices into jointMatrices and their weights, null when only morph targets are used
+        ref_ptr<uivec4Array> jointIndices;
+        ref_ptr<vec4Array> jointWeights;
+
+        /// joint matrices, each mapping the bind pose vertices to the joint's current pose
+        ref_ptr<BufferInfo> jointMatrices;
+
+        /// morph targets, each with deltas for every vertex
+        MorphTargets morphTargets;
+
+        /// weights of the morph targets, one per morph target
+        ref_ptr<floatArray> morphWeights;
+
+        /// skinned outputs, assigned device buffers by compile()
+        ref_ptr<BufferInfo> skinnedVertices;
+        ref_ptr<BufferInfo> skinnedNormals;
+
+        /// local workgroup size used by the compute shader
+        static constexpr uint32_t workgroupSize = 64;
+
+        /// replace the vertex and normal arrays of the draw with skinnedVertices and skinnedNormals
+        void assignOutputs(VertexIndexDraw& draw, uint32_t vertexArrayIndex = 0, uint32_t normalArrayIndex = 1) const;
+
+        void traverse(ConstVisitor& visitor) const override;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        void _setUp();
+
+        ref_ptr<PipelineLayout> _pipelineLayout;
+        ref_ptr<BindComputePipeline> _bindPipeline;
+        ref_ptr<BindDescriptorSet> _bindDescriptorSet;
+        ref_ptr<PipelineBarrier> _preSkinningBarrier;
+        ref_ptr<PipelineBarrier> _postSkinningBarrier;
+        BufferInfoList _staticBufferInfos;
+        BufferInfoList _dynamicBufferInfos;
+        bool _skinned = false;
+    };
+    VSG_type_name(vsg::ComputeSkinning);
+
+} // namespace vsg
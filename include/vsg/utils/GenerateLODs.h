@@ -0,0 +1,106 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/core/Visitor.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <map>
+#include <vector>
+
+namespace vsg
+{
+
+    /// simplify a triangle list using quadric error metric edge collapses, Garland and Heckbert 1997, returning the indices of the simplified triangles.
+    /// Edges are collapsed onto one of their existing vertices so the simplified triangles can share the original vertex arrays.
+    /// Vertices on borders, including the seams between vertices with the same position but different normals or texcoords, are kept in place.
+    /// Simplification stops once the number of triangles is at or below targetTriangleCount, or the next collapse would exceed maximumError,
+    /// the distance from the original surface measured in the coordinate frame of the vertices.
+    extern VSG_DECLSPEC std::vector<uint32_t> simplifyTriangles(const vec3Array& vertices, const std::vector<uint32_t>& indices, size_t targetTriangleCount, double maximumError);
+
+    /// GenerateLODs replaces large triangle list VertexIndexDraw and Geometry children of Groups with LOD nodes,
+    /// the first LOD child is the original draw and the following children are simplified versions that share the original vertex arrays.
+    /// Draws are collected by the traversal and the simplified versions generated by generate(), in parallel when operationThreads is assigned.
+    /// Usage:
+    ///     vsg::GenerateLODs generateLODs;
+    ///     generateLODs.operationThreads = vsg::OperationThreads::create(4);
+    ///     scene->accept(generateLODs);
+    ///     generateLODs.generate();
+    class VSG_DECLSPEC GenerateLODs : public Inherit<Visitor, GenerateLODs>
+    {
+    public:
+        GenerateLODs();
+
+        struct Level
+        {
+            float triangleRatio = 0.5f;            ///< target number of triangles as a ratio of the original
+            double minimumScreenHeightRatio = 0.0; ///< LOD::Child::minimumScreenHeightRatio for the level
+        };
+
+        /// LOD::Child::minimumScreenHeightRatio for the original draw
+        double fullDetailScreenHeightRatio = 0.25;
+
+        /// simplified levels, ordered from highest to lowest detail
+        std::vector<Level> levels{{0.5f, 0.1}, {0.2f, 0.03}, {0.05f, 0.0}};
+
+        /// only generate LODs for draws with at least this many triangles
+        uint32_t minimumTriangles = 2048;
+
+        /// maximum simplification error as a ratio of the radius of the draw's bounding sphere
+        double maximumError = 0.02;
+
+        /// attribute location of the vertex positions
+        uint32_t vertexLocation = 0;
+
+        /// optional threads used to simplify draws in parallel
+        ref_ptr<OperationThreads> operationThreads;
+
+        uint32_t numLODs = 0;
+        uint64_t numTriangles = 0;           ///< triangles in the draws replaced by LODs
+        uint64_t numLowestDetailTriangles = 0; ///< triangles in the lowest detail levels of the LODs
+
+        void apply(Node& node) override;
+        void apply(Group& group) override;
+        void apply(StateGroup& stateGroup) override;
+        void apply(BindGraphicsPipeline& bindPipeline) override;
+        void apply(LOD& lod) override;
+        void apply(PagedLOD& plod) override;
+
+        /// generate the LODs for the draws collected by traversals and assign them in place of the original draws
+        void generate();
+
+    protected:
+        struct Entry
+        {
+            ref_ptr<Node> draw;
+            ref_ptr<vec3Array> vertices;
+            std::vector<uint32_t> indices;
+            std::vector<ref_ptr<Group>> parents;
+            dsphere bound;
+            std::vector<std::vector<uint32_t>> levels;
+        };
+
+        void _collectChildren(Group& group);
+        void _simplify(Entry& entry) const;
+        ref_ptr<Node> _createLOD(Entry& entry);
+
+        GraphicsPipeline* _currentPipeline = nullptr;
+        std::map<const Node*, size_t> _entryIndices;
+        std::vector<Entry> _entries;
+    };
+    VSG_type_name(vsg::GenerateLODs);
+
+} // namespace vsg
@@ -23,6 +23,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/InputAssemblyState.h>
 #include <vsg/state/MultisampleState.h>
 #include <vsg/state/RasterizationState.h>
+#include <vsg/state/SetDynamicState.h>
 #include <vsg/state/TessellationState.h>
 #include <vsg/state/VertexInputState.h>
 #include <vsg/state/ViewportState.h>
@@ -50,6 +51,11 @@ namespace vsg
         bool assignTexture(const std::string& name, ref_ptr<Data> textureData = {}, ref_ptr<Sampler> sampler = {}, uint32_t dstArrayElement = 0);
         bool assignTexture(const std::string& name, const ImageInfoList& imageInfoList, uint32_t dstArrayElement = 0);
 
+        /// register texture with the ShaderSet's BindlessTextureBinding rather than creating a per object DescriptorSet, the slot it's assigned is recorded in bindlessTextureIndices.
+        /// If the ShaderSet has no BindlessTextureBinding, as is the case for the built in flat, phong and pbr ShaderSets, or all its slots are in use,
+        /// falls back to assignTexture(..) and returns its result.
+        bool assignBindlessTexture(const std::string& name, ref_ptr<Data> textureData = {}, ref_ptr<Sampler> sampler = {});
+
         bool enableDescriptor(const std::string& name);
         bool assignDescriptor(const std::string& name, ref_ptr<Data> data = {}, uint32_t dstArrayElement = 0);
         bool assignDescriptor(const std::string& name, const BufferInfoList& bufferInfoList, uint32_t dstArrayElement = 0);
@@ -68,6 +74,9 @@ namespace vsg
         std::set<std::string> assigned;
         std::set<std::string> defines;
         std::vector<ref_ptr<DescriptorSet>> descriptorSets;
+
+        /// slots in the BindlessTextures texture array of the textures assigned by assignBindlessTexture(..), to be passed to the shaders via push constants or instance data.
+        std::map<std::string, uint32_t> bindlessTextureIndices;
     };
     VSG_type_name(vsg::DescriptorConfigurator);
 
@@ -109,6 +118,10 @@ namespace vsg
         uint32_t baseAttributeBinding = 0;
         ref_ptr<ShaderSet> shaderSet;
 
+        /// extended dynamic states, such as VK_DYNAMIC_STATE_CULL_MODE_EXT or VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT, to set with a SetDynamicState rather than bake into the GraphicsPipeline.
+        /// GraphicsPipelines that only differ in these states are then shared, requires VK_EXT_extended_dynamic_state, VK_EXT_extended_dynamic_state2 or VK_EXT_extended_dynamic_state3 as appropriate.
+        DynamicState::DynamicStates extendedDynamicStates;
+
         void reset();
 
         bool enableArray(const std::string& name, VkVertexInputRate vertexInputRate, uint32_t stride, VkFormat format = VK_FORMAT_UNDEFINED);
@@ -124,6 +137,10 @@ namespace vsg
         /// set the inherited state which if compatible can hint the the state setup and copying to avoid setting inherited state local subgraph
         void assignInheritedState(const StateCommands& stateCommands);
 
+        /// set the pipeline's fragment shading rate by assigning a FragmentShadingRateState to pipelineStates, must be called before init(), requires VK_KHR_fragment_shading_rate.
+        /// The attachmentCombinerOp controls how the rate is combined with any fragment shading rate attachment of the RenderGraph.
+        void assignFragmentShadingRate(const VkExtent2D& fragmentSize, VkFragmentShadingRateCombinerOpKHR attachmentCombinerOp = VK_FRAGMENT_SHADING_RATE_COMBINER_OP_MAX_KHR);
+
         [[deprecated("use enableDescriptor(..)")]] bool enableUniform(const std::string& name) { return enableDescriptor(name); }
 
         [[deprecated("use assignDescriptor(..)")]] bool assignUniform(const std::string& name, ref_ptr<Data> data = {}) { return assignDescriptor(name, data); }
@@ -152,6 +169,7 @@ namespace vsg
         ref_ptr<PipelineLayout> layout;
         ref_ptr<GraphicsPipeline> graphicsPipeline;
         ref_ptr<BindGraphicsPipeline> bindGraphicsPipeline;
+        ref_ptr<SetDynamicState> setDynamicState;
 
     protected:
         void _assignShaderSetSettings();
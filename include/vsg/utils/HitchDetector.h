@@ -0,0 +1,131 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Path.h>
+#include <vsg/utils/Instrumentation.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace vsg
+{
+
+    /// HitchDetector is an Instrumentation implementation that continuously keeps the CPU zones and plotted values, such as the compile, DatabasePager merge
+    /// and pipeline compile activity, of the last numFrames frames in ring buffers. When a frame takes longer than the hitch thresholds the buffers are written
+    /// to a snapshot file in the Chrome trace event JSON format, viewable in Perfetto or chrome://tracing, giving post-mortem data on rare frame spikes
+    /// without running a full profiler. Assign it with Viewer::assignInstrumentation(HitchDetector::create()).
+    class VSG_DECLSPEC HitchDetector : public Inherit<Instrumentation, HitchDetector>
+    {
+    public:
+        HitchDetector();
+
+        /// maximum SourceLocation level to record CPU zones for
+        uint32_t cpuInstrumentationLevel = 2;
+
+        /// number of frames whose events are kept and written in each snapshot
+        uint32_t numFrames = 120;
+
+        /// capacity of each thread's ring buffer of events, older events are overwritten once it's full
+        uint32_t eventsPerThread = 16384;
+
+        /// frame duration in milliseconds above which a frame is a hitch
+        double thresholdTime = 50.0;
+
+        /// when non zero, frames longer than thresholdRatio times the average duration of the buffered frames are also hitches
+        double thresholdRatio = 3.0;
+
+        /// minimum number of frames between snapshots so that a run of slow frames only generates one snapshot
+        uint32_t minimumFramesBetweenSnapshots = 120;
+
+        /// directory that the hitch_<frameCount>.json snapshots are written to
+        Path directory = ".";
+
+        /// return the number of snapshots written
+        uint32_t numSnapshots() const { return _numSnapshots.load(); }
+
+        /// write the currently buffered events as Chrome trace event JSON
+        void write(std::ostream& out) const;
+
+        void setThreadName(const std::string& name) const override;
+
+        void enterFrame(const SourceLocation* sl, uint64_t& reference, FrameStamp& frameStamp) const override;
+        void leaveFrame(const SourceLocation* sl, uint64_t& reference, FrameStamp& frameStamp) const override;
+
+        void enter(const SourceLocation* sl, uint64_t& reference, const Object* object = nullptr) const override;
+        void leave(const SourceLocation* sl, uint64_t& reference, const Object* object = nullptr) const override;
+
+        void enterCommandBuffer(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer) const override;
+        void leaveCommandBuffer(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer) const override;
+
+        void enter(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer, const Object* object = nullptr) const override;
+        void leave(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer, const Object* object = nullptr) const override;
+
+        void plot(const char* name, double value) const override;
+
+    protected:
+        virtual ~HitchDetector();
+
+        struct Event
+        {
+            const SourceLocation* sourceLocation = nullptr; ///< null for plotted values
+            const char* name = nullptr;                     ///< name of plotted value
+            uint64_t start = 0;
+            uint64_t duration = 0;
+            double value = 0.0;
+        };
+
+        struct ThreadEvents
+        {
+            std::mutex mutex;
+            std::string name;
+            std::vector<Event> events;
+            uint64_t count = 0;
+        };
+
+        struct Frame
+        {
+            uint64_t frameCount = 0;
+            uint64_t start = 0;
+            uint64_t duration = 0;
+            size_t allocatedMemory = 0;
+        };
+
+        struct Snapshot;
+
+        ThreadEvents* _threadEvents() const;
+        void _add(const Event& event) const;
+        std::unique_ptr<Snapshot> _snapshot() const;
+        void _write(std::ostream& out, const Snapshot& snapshot) const;
+
+        const uint64_t _id;
+
+        mutable std::mutex _threadsMutex;
+        mutable std::vector<std::unique_ptr<ThreadEvents>> _threads;
+
+        // frames are only added by the viewer thread in leaveFrame() but may be read by write()
+        mutable std::mutex _framesMutex;
+        mutable std::vector<Frame> _frames;
+        mutable uint64_t _frameIndex = 0;
+        mutable uint64_t _framesSinceSnapshot = 0;
+
+        mutable std::atomic_uint32_t _numSnapshots{0};
+        mutable std::thread _writeThread;
+    };
+    VSG_type_name(vsg::HitchDetector);
+
+} // namespace vsg
@@ -0,0 +1,87 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/Command.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/BufferInfo.h>
+#include <vsg/state/ComputePipeline.h>
+
+#include <mutex>
+
+namespace vsg
+{
+
+    // forward declare
+    class Context;
+
+    /// ImageFormatConverter expands 3 component image data, which vsg::Image remaps to 4 component formats as few devices support sampling 3 component formats,
+    /// on the GPU using a compute shader so the CPU only has to copy the original data into a staging buffer.
+    /// The expanded data is written to a device local buffer that is then copied to the image with the usual buffer to image copies.
+    /// getOrCreate() returns null when no ShaderCompiler is available or the graphics queue lacks compute support, in which case Context expands the data on the CPU.
+    class VSG_DECLSPEC ImageFormatConverter : public Inherit<Object, ImageFormatConverter>
+    {
+    public:
+        ImageFormatConverter();
+
+        /// local workgroup size used by the compute shader
+        static constexpr uint32_t workgroupSize = 64;
+
+        /// return true if the conversion from sourceFormat to targetFormat is supported, these are the 8, 16 and 32 bit per component 3 to 4 component expansions.
+        static bool supported(VkFormat sourceFormat, VkFormat targetFormat);
+
+        /// get or create the ImageFormatConverter shared by all the Contexts of context.device, returns null if shaders can't be compiled.
+        static ref_ptr<ImageFormatConverter> getOrCreate(Context& context);
+
+        /// copy data to a staging buffer and set up the conversion to a device local buffer in targetFormat, returns null if the conversion isn't supported or buffers can't be allocated.
+        /// The returned Command must be recorded before the buffer to image copies that read its destination.
+        ref_ptr<Command> convert(Context& context, ref_ptr<Data> data, VkFormat targetFormat);
+
+        /// record the barrier required for transfer commands to read the results of previously recorded conversions
+        void recordBarrier(CommandBuffer& commandBuffer) const;
+
+        ref_ptr<PipelineLayout> pipelineLayout;
+        ref_ptr<DescriptorSetLayout> descriptorSetLayout;
+        ref_ptr<BindComputePipeline> bindPipeline;
+
+    protected:
+        virtual ~ImageFormatConverter();
+
+        std::mutex _mutex;
+    };
+    VSG_type_name(vsg::ImageFormatConverter);
+
+    /// ImageFormatConversion records the dispatch that converts the source buffer into the destination buffer, created by ImageFormatConverter::convert().
+    class VSG_DECLSPEC ImageFormatConversion : public Inherit<Command, ImageFormatConversion>
+    {
+    public:
+        ImageFormatConversion(ref_ptr<ImageFormatConverter> in_converter, ref_ptr<BufferInfo> in_source, ref_ptr<BufferInfo> in_destination);
+
+        struct PushConstants
+        {
+            uint32_t componentSize = 1;
+            uint32_t numGroups = 0;
+            uint32_t alpha = 0;
+        };
+
+        ref_ptr<ImageFormatConverter> converter;
+        ref_ptr<BufferInfo> source;
+        ref_ptr<BufferInfo> destination;
+        ref_ptr<BindDescriptorSet> bindDescriptorSet;
+        PushConstants pushConstants;
+
+        void record(CommandBuffer& commandBuffer) const override;
+    };
+    VSG_type_name(vsg::ImageFormatConversion);
+
+} // namespace vsg
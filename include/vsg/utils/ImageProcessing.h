@@ -0,0 +1,57 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Data.h>
+
+namespace vsg
+{
+
+    /// filters used by resizeImage()
+    enum ResizeFilter
+    {
+        RESIZE_BOX,     /// average of the source pixels covered by each destination pixel, nearest neighbour when upsampling
+        RESIZE_LANCZOS3 /// windowed sinc filter with a radius of 3, sharper than box filtering for both downsampling and upsampling
+    };
+
+    /// return true if the image processing functions support the format, these are the 8 bit UNORM/SRGB, 16 bit SFLOAT and 32 bit SFLOAT formats with 1 to 4 components.
+    extern VSG_DECLSPEC bool imageProcessingSupported(VkFormat format);
+
+    /// copy count pixels from src to dest, copying the first min(srcStride, destStride) bytes of each pixel and filling the remainder from defaultValue,
+    /// such as when expanding RGB to RGBA. Uses SIMD for 3 to 4 byte expansions and multiple threads for large images.
+    extern VSG_DECLSPEC void copyPixels(const void* src, uint32_t srcStride, void* dest, uint32_t destStride, size_t count, const uint8_t* defaultValue);
+
+    /// create an image of a supported format, with storage for maxNumMipmaps mipmap levels. Images with a depth greater than 1 are created as Array3D.
+    /// Returns null if the format isn't supported.
+    extern VSG_DECLSPEC ref_ptr<Data> createImage(VkFormat format, uint32_t width, uint32_t height, uint32_t depth = 1, uint8_t maxNumMipmaps = 0);
+
+    /// convert an image to targetFormat, converting between 8 bit, sRGB, 16 bit and 32 bit float components and adding or removing components.
+    /// Added color components are set to 0 and alpha to 1. Only the first mipmap level is converted. Returns null if either format isn't supported.
+    extern VSG_DECLSPEC ref_ptr<Data> convertImage(const Data& image, VkFormat targetFormat);
+
+    /// resize the first mipmap level of each layer of an image, filtering in linear space for sRGB formats. Returns null if the format isn't supported.
+    extern VSG_DECLSPEC ref_ptr<Data> resizeImage(const Data& image, uint32_t width, uint32_t height, ResizeFilter filter = RESIZE_BOX);
+
+    /// create a copy of an image with maxNumMipmaps mipmap levels generated by box filtering, 0 generates the full mipmap chain.
+    /// 3D images are downsampled in depth as well, matching Data::computeMipmapOffsets(). Returns null if the format isn't supported.
+    extern VSG_DECLSPEC ref_ptr<Data> generateMipmaps(const Data& image, uint32_t maxNumMipmaps = 0);
+
+    /// split a 2D image, such as a texture atlas, into tileWidth x tileHeight tiles stored as the layers of a VK_IMAGE_VIEW_TYPE_2D_ARRAY image, ordered row by row.
+    /// Returns null if the format isn't supported or the image is smaller than a tile.
+    extern VSG_DECLSPEC ref_ptr<Data> createImageLayers(const Data& image, uint32_t tileWidth, uint32_t tileHeight);
+
+    /// convert between 16 bit half float and float values
+    extern VSG_DECLSPEC float halfToFloat(uint16_t value);
+    extern VSG_DECLSPEC uint16_t floatToHalf(float value);
+
+} // namespace vsg
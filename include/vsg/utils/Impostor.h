@@ -0,0 +1,194 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/observer_ptr.h>
+#include <vsg/maths/sphere.h>
+#include <vsg/nodes/Node.h>
+#include <vsg/threading/OperationThreads.h>
+#include <vsg/utils/ShaderSet.h>
+#include <vsg/utils/SharedObjects.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class ImpostorManager;
+    class Viewer;
+    class Window;
+    class CommandGraph;
+    class RenderGraph;
+    class RenderPass;
+    class Framebuffer;
+    class ImageView;
+    class View;
+    class Group;
+
+    /// Impostor renders its subgraph when near and, beyond the LOD cut off, a single camera facing billboard textured from an atlas of
+    /// octahedral views of the subgraph, selecting the atlas cell whose view direction is closest to the eye.
+    /// The atlas is rendered by the ImpostorManager the first time the Impostor is beyond the cut off, the subgraph is rendered until it's ready.
+    class VSG_DECLSPEC Impostor : public Inherit<Node, Impostor>
+    {
+    public:
+        explicit Impostor(ref_ptr<Node> in_subgraph = {});
+
+        ref_ptr<Node> subgraph;
+
+        /// bounding sphere of the subgraph, computed by the constructor when a subgraph is provided.
+        dsphere bound;
+
+        /// the subgraph is rendered while its bounding sphere occupies at least this ratio of the screen height, as LOD::Child::minimumScreenHeightRatio, otherwise the billboard.
+        double minimumScreenHeightRatio = 0.1;
+
+        /// ImpostorManager that renders the atlas
+        observer_ptr<ImpostorManager> manager;
+
+        /// billboard subgraph assigned by the ImpostorManager once the atlas has been rendered, reset when the atlas is evicted.
+        ref_ptr<Node> billboard;
+
+        /// FrameStamp::frameCount of the last frame the billboard was recorded, used by the ImpostorManager when choosing atlases to evict.
+        mutable std::atomic_uint64_t frameLastUsed{0};
+
+        void traverse(Visitor& visitor) override
+        {
+            if (subgraph) subgraph->accept(visitor);
+        }
+        void traverse(ConstVisitor& visitor) const override
+        {
+            if (subgraph) subgraph->accept(visitor);
+        }
+        void traverse(RecordTraversal& visitor) const override
+        {
+            if (subgraph) subgraph->accept(visitor);
+        }
+
+        void accept(RecordTraversal& visitor) const override;
+
+        int compare(const Object& rhs) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~Impostor();
+    };
+    VSG_type_name(vsg::Impostor);
+
+    /// return the unit direction of the center of the octahedral atlas cell (i, j) of a gridSize x gridSize atlas.
+    extern VSG_DECLSPEC dvec3 octahedralDirection(uint32_t i, uint32_t j, uint32_t gridSize);
+
+    /// return the index, j * gridSize + i, of the octahedral atlas cell whose view direction is closest to the specified direction.
+    extern VSG_DECLSPEC uint32_t octahedralCell(const dvec3& direction, uint32_t gridSize);
+
+    /// ImpostorManager renders the octahedral atlases of Impostors offscreen and manages their memory.
+    /// Each frame, as an update operation, it assigns the billboards of the atlases rendered by the previous frame, evicts the least recently used atlases
+    /// while over the memoryBudget and renders the atlas of the next requested Impostor using its CommandGraph.
+    /// Usage:
+    ///     auto impostorManager = vsg::ImpostorManager::create(viewer, window);
+    ///     auto impostor = impostorManager->createImpostor(tree);
+    ///     viewer->assignRecordAndSubmitTaskAndPresentation({impostorManager->commandGraph, commandGraph});
+    ///     viewer->compile();
+    class VSG_DECLSPEC ImpostorManager : public Inherit<Operation, ImpostorManager>
+    {
+    public:
+        /// create the CommandGraph used to render atlases on the window's device and add the ImpostorManager to the viewer's update operations.
+        ImpostorManager(ref_ptr<Viewer> in_viewer, ref_ptr<Window> window, uint32_t in_gridSize = 8, uint32_t in_cellSize = 128);
+
+        observer_ptr<Viewer> viewer;
+
+        /// number of cells across the octahedral atlas, each atlas is gridSize * cellSize pixels square.
+        const uint32_t gridSize;
+        const uint32_t cellSize;
+        const VkFormat colorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+        const VkFormat depthFormat = VK_FORMAT_D32_SFLOAT;
+
+        /// CommandGraph that renders the atlases, must be submitted before the CommandGraphs that render the Impostors.
+        ref_ptr<CommandGraph> commandGraph;
+
+        /// ShaderSet used for the billboards, defaults to the flat shaded ShaderSet as the lighting is already captured by the atlas.
+        ref_ptr<ShaderSet> shaderSet;
+        ref_ptr<SharedObjects> sharedObjects;
+
+        /// maximum memory in bytes for atlases, least recently used atlases are evicted when it's exceeded.
+        VkDeviceSize memoryBudget = 256 * 1024 * 1024;
+
+        /// alpha below which billboard fragments are discarded
+        float alphaCutoff = 0.5f;
+
+        /// number of frames that the resources of evicted atlases are retained for so that frames in flight that use them can complete.
+        uint64_t retainForFrameCount = 3;
+
+        /// create an Impostor for the subgraph that uses this ImpostorManager.
+        ref_ptr<Impostor> createImpostor(ref_ptr<Node> subgraph, double minimumScreenHeightRatio = 0.1);
+
+        /// request that the impostor's atlas is rendered, called by Impostor's record traversal, thread safe.
+        void request(const Impostor* impostor);
+
+        /// evict the atlas of the impostor, releasing its resources once the frames in flight have completed.
+        void evict(Impostor& impostor);
+
+        /// update operation, see class description
+        void run() override;
+
+        /// memory in bytes used by the atlases
+        VkDeviceSize atlasMemory() const { return static_cast<VkDeviceSize>(_atlases.size()) * atlasSize(); }
+        VkDeviceSize atlasSize() const { return static_cast<VkDeviceSize>(gridSize * cellSize) * (gridSize * cellSize) * 4; }
+
+        uint64_t numRendered = 0;
+        uint64_t numEvicted = 0;
+
+    protected:
+        virtual ~ImpostorManager();
+
+        struct Atlas
+        {
+            ref_ptr<Impostor> impostor;
+            ref_ptr<ImageView> imageView;
+            ref_ptr<Framebuffer> framebuffer;
+        };
+
+        /// create the billboard subgraph that renders the cells of the atlas
+        virtual ref_ptr<Node> _createBillboard(const Impostor& impostor, ref_ptr<ImageView> imageView);
+
+        /// evict least recently used atlases until there is room for another atlas, return false if all the atlases are still in use
+        bool _makeRoom(uint64_t frameCount);
+
+        ref_ptr<RenderPass> _renderPass;
+        ref_ptr<ImageView> _depthImageView;
+        ref_ptr<RenderGraph> _renderGraph;
+        ref_ptr<View> _view;
+        ref_ptr<Group> _cells;
+
+        std::mutex _requestMutex;
+        std::vector<ref_ptr<Impostor>> _requests;
+
+        std::list<Atlas> _atlases;
+        std::list<Atlas> _rendering;
+
+        struct Retired
+        {
+            uint64_t frameCount = 0;
+            ref_ptr<Object> billboard;
+            ref_ptr<Object> imageView;
+            ref_ptr<Object> framebuffer;
+        };
+        std::list<Retired> _retired;
+    };
+    VSG_type_name(vsg::ImpostorManager);
+
+} // namespace vsg
@@ -0,0 +1,78 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2018 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/Camera.h>
+#include <vsg/commands/DrawIndexedIndirectCommand.h>
+#include <vsg/commands/DrawIndexedIndirectCount.h>
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ComputePipeline.h>
+
+namespace vsg
+{
+
+    /// InstanceCulling command culls instances against the Camera's view frustum on the GPU using a compute shader,
+    /// writing the draw commands of the visible instances and their count for use by a DrawIndexedIndirectCount command.
+    /// Each instance has a bounding sphere, in the world coordinate frame of the Camera's ViewMatrix, and a DrawIndexedIndirectCommand
+    /// template that is copied to the output when the sphere intersects the view frustum, the template's firstInstance can be used to
+    /// look up per instance data via gl_InstanceIndex in the vertex shader.
+    /// It records the pipeline barriers required for a DrawIndexedIndirectCount later in the same CommandGraph to consume the results.
+    class VSG_DECLSPEC InstanceCulling : public Inherit<Command, InstanceCulling>
+    {
+    public:
+        InstanceCulling();
+
+        /// bounds vec4's are (center.x, center.y, center.z, radius), drawTemplates must be the same size as bounds
+        InstanceCulling(ref_ptr<Camera> in_camera, ref_ptr<vec4Array> in_bounds, ref_ptr<DrawIndexedIndirectCommandArray> in_drawTemplates);
+
+        /// Camera providing the view frustum
+        ref_ptr<Camera> camera;
+
+        /// input bounding spheres, one vec4 per instance
+        ref_ptr<BufferInfo> instanceBounds;
+
+        /// input DrawIndexedIndirectCommands, one per instance
+        ref_ptr<BufferInfo> drawTemplates;
+
+        /// output DrawIndexedIndirectCommands of the visible instances, packed at the start of the buffer
+        ref_ptr<BufferInfo> drawCommands;
+
+        /// output uint32_t count of the visible instances
+        ref_ptr<BufferInfo> drawCount;
+
+        /// number of instances to cull
+        uint32_t numInstances = 0;
+
+        /// local workgroup size used by the compute shader
+        static constexpr uint32_t workgroupSize = 64;
+
+        /// create a DrawIndexedIndirectCount command that draws the visible instances.
+        ref_ptr<DrawIndexedIndirectCount> createDrawCommand() const;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        void _setUp();
+
+        ref_ptr<PipelineLayout> _pipelineLayout;
+        ref_ptr<BindComputePipeline> _bindPipeline;
+        ref_ptr<BindDescriptorSet> _bindDescriptorSet;
+        ref_ptr<PipelineBarrier> _preCullBarrier;
+        ref_ptr<PipelineBarrier> _clearCountBarrier;
+        ref_ptr<PipelineBarrier> _postCullBarrier;
+    };
+    VSG_type_name(vsg::InstanceCulling);
+
+} // namespace vsg
@@ -39,6 +39,7 @@ namespace vsg
         void apply(const CullNode& cn) override;
         void apply(const CullGroup& cn) override;
         void apply(const DepthSorted& cn) override;
+        void apply(const SpatialGroup& sg) override;
 
         void apply(const VertexDraw& vid) override;
         void apply(const VertexIndexDraw& vid) override;
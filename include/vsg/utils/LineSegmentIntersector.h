@@ -59,6 +59,10 @@ namespace vsg
 
         ref_ptr<Intersection> add(const dvec3& coord, double ratio, const IndexRatios& indexRatios, uint32_t instanceIndex);
 
+        /// use a TriangleBVH to find the triangles to test for draws with at least minimumTrianglesForBVH triangles, building and caching it on first use.
+        bool useTriangleBVH = true;
+        uint32_t minimumTrianglesForBVH = 256;
+
         void pushTransform(const Transform& transform) override;
         void popTransform() override;
 
@@ -0,0 +1,106 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/ConstVisitor.h>
+#include <vsg/core/Inherit.h>
+#include <vsg/state/ImageInfo.h>
+#include <vsg/vk/MemoryBufferPools.h>
+
+#include <map>
+#include <ostream>
+#include <set>
+
+namespace vsg
+{
+
+    /// MemoryAccounting is a ConstVisitor that attributes the CPU and GPU memory used by a scene graph to its subgraphs, so the models or tiles
+    /// that use the most memory can be found. CPU memory is the sizeofObject() of each Object plus the dataSize() of each Data, GPU memory is the range
+    /// of each BufferInfo and the memory requirements of each Image bound to DeviceMemory. Objects shared between subgraphs are only counted once,
+    /// against the first subgraph they are encountered in.
+    /// The subgraphs reported are the children of the node the traversal is started from and the loaded high resolution children of PagedLODs.
+    class VSG_DECLSPEC MemoryAccounting : public Inherit<ConstVisitor, MemoryAccounting>
+    {
+    public:
+        explicit MemoryAccounting(uint32_t in_deviceID = 0);
+
+        /// deviceID of the Buffers and Images to report the GPU memory of
+        uint32_t deviceID = 0;
+
+        struct Usage
+        {
+            size_t objects = 0;
+            size_t objectMemory = 0;            ///< sizeofObject() of the Objects
+            size_t dataMemory = 0;              ///< dataSize() of the Data
+            VkDeviceSize deviceLocalMemory = 0; ///< Buffer ranges and Images bound to DEVICE_LOCAL memory
+            VkDeviceSize hostMemory = 0;        ///< Buffer ranges and Images bound to memory that isn't DEVICE_LOCAL
+
+            size_t cpuMemory() const { return objectMemory + dataMemory; }
+            VkDeviceSize gpuMemory() const { return deviceLocalMemory + hostMemory; }
+
+            Usage& operator+=(const Usage& rhs);
+        };
+
+        /// totals for the whole of the traversed scene graph
+        Usage total;
+
+        /// usage of each of the subgraphs reported, nested subgraphs are included in the usage of the subgraphs that contain them
+        std::map<const Node*, Usage> subgraphs;
+
+        /// optional MemoryBufferPools, such as the Context::deviceMemoryBufferPools used by the CompileManager, to report the totals of in report()
+        std::vector<ref_ptr<MemoryBufferPools>> memoryBufferPools;
+
+        /// optional Device to report the allocated memory of each memory heap of in report()
+        ref_ptr<Device> device;
+
+        /// clear the results so that the MemoryAccounting can be reused
+        void reset();
+
+        void apply(const Object& object) override;
+        void apply(const Data& data) override;
+        void apply(const Node& node) override;
+        void apply(const PagedLOD& plod) override;
+        void apply(const StateGroup& stateGroup) override;
+        void apply(const Geometry& geometry) override;
+        void apply(const VertexDraw& vd) override;
+        void apply(const VertexIndexDraw& vid) override;
+        void apply(const BindVertexBuffers& bvb) override;
+        void apply(const BindIndexBuffer& bib) override;
+        void apply(const DescriptorBuffer& db) override;
+        void apply(const DescriptorImage& di) override;
+
+        void apply(const BufferInfo& bufferInfo) override;
+
+        /// write the totals, the subgraphs using the most memory, the CPU Allocator, MemoryBufferPools and memory heap totals.
+        void report(std::ostream& out, size_t maxSubgraphs = 20) const;
+
+    protected:
+        /// return true if object hasn't been counted yet, adding its sizeofObject() to the active subgraphs
+        bool _count(const Object& object);
+        void _add(const Usage& usage);
+
+        /// enter a Node's subgraph, returning true if the Node is the root of a reported subgraph
+        bool _push(const Node& node);
+        void _pop(bool subgraph);
+
+        void _imageInfo(const ImageInfo& imageInfo);
+        void _image(const Image& image);
+
+        std::set<const Object*> _counted;
+        std::vector<Usage*> _activeSubgraphs;
+        uint32_t _depth = 0;
+        const Node* _pagedLODChild = nullptr;
+    };
+    VSG_type_name(vsg::MemoryAccounting);
+
+} // namespace vsg
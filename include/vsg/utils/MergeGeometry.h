@@ -0,0 +1,79 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Visitor.h>
+#include <vsg/maths/box.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/GraphicsPipeline.h>
+
+#include <set>
+#include <vector>
+
+namespace vsg
+{
+
+    /// MergeGeometry merges small VertexIndexDraws that are siblings under the same Group, have the same StateGroup chain and a compatible
+    /// VertexInputState into combined vertex and index arrays, replacing many small vkCmdDrawIndexed calls with one draw per batch.
+    /// Draws are ordered spatially before being packed into batches of up to maximumBatchVertices, and each batch is decorated with a CullNode
+    /// so culling granularity is retained. When useIndirect is true each batch is a Geometry with a DrawIndexedIndirect command holding one
+    /// command per original draw, rather than a single VertexIndexDraw, this requires the multiDrawIndirect device feature.
+    /// Usage:
+    ///     vsg::MergeGeometry mergeGeometry;
+    ///     scene->accept(mergeGeometry);
+    class VSG_DECLSPEC MergeGeometry : public Inherit<Visitor, MergeGeometry>
+    {
+    public:
+        MergeGeometry();
+
+        /// only merge draws with no more than this many vertices
+        uint32_t maximumDrawVertices = 4096;
+
+        /// maximum number of vertices in each merged batch
+        uint32_t maximumBatchVertices = 65536;
+
+        /// emit a DrawIndexedIndirect per batch with a command for each merged draw
+        bool useIndirect = false;
+
+        uint32_t numDrawsMerged = 0;
+        uint32_t numBatches = 0;
+
+        void apply(Node& node) override;
+        void apply(Group& group) override;
+        void apply(StateGroup& stateGroup) override;
+        void apply(BindGraphicsPipeline& bindPipeline) override;
+
+    protected:
+        struct Member
+        {
+            size_t childIndex = 0;
+            std::vector<uintptr_t> key; ///< pipeline, state and array layout that must match for draws to be merged
+            std::vector<StateGroup*> chain;
+            VertexIndexDraw* draw = nullptr;
+            std::vector<bool> perVertex;
+            uint32_t numVertices = 0;
+            std::vector<uint32_t> indices;
+            dbox bounds;
+        };
+
+        bool _member(Node* node, Member& member) const;
+        ref_ptr<Node> _merge(const std::vector<Member*>& batch) const;
+        void _mergeChildren(Group& group);
+
+        const GraphicsPipeline* _currentPipeline = nullptr;
+        std::set<Group*> _visited;
+    };
+    VSG_type_name(vsg::MergeGeometry);
+
+} // namespace vsg
@@ -0,0 +1,120 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Visitor.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/VertexInputState.h>
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+
+namespace vsg
+{
+
+    /// MeshOptimizer collects the VertexIndexDraw and Geometry in a subgraph, grouped by the GraphicsPipeline they are drawn with,
+    /// then optimize() reorders and repacks their vertex data for more efficient use of GPU vertex caches and memory bandwidth:
+    ///   - triangles are reordered for post transform vertex cache locality using Tipsify, Sander et al. 2007,
+    ///   - vertices are reordered into the order they are first referenced for vertex fetch locality,
+    ///   - normals are quantized to VK_FORMAT_R8G8B8A8_SNORM and texcoords in the 0 to 1 range to VK_FORMAT_R16G16_UNORM,
+    ///   - per vertex attributes other than the vertex positions are interleaved into a single binding,
+    /// with the GraphicsPipeline's VertexInputState replaced to match. The normalized formats are read as floats by shaders so no shader changes are required.
+    /// The layout changes are only applied to pipelines that all of their draws are compatible with, and as the GraphicsPipeline are modified
+    /// in place the optimizer should be run before the scene graph is compiled, and on subgraphs that don't share their pipelines with other subgraphs.
+    /// Usage:
+    ///     vsg::MeshOptimizer optimizer;
+    ///     scene->accept(optimizer);
+    ///     optimizer.optimize();
+    ///     optimizer.report(std::cout);
+    class VSG_DECLSPEC MeshOptimizer : public Inherit<Visitor, MeshOptimizer>
+    {
+    public:
+        MeshOptimizer();
+
+        /// reorder triangles of VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST draws for post transform vertex cache locality
+        bool optimizeVertexCache = true;
+
+        /// reorder vertices into the order they are first referenced by the indices
+        bool optimizeVertexFetch = true;
+
+        /// quantize VK_FORMAT_R32G32B32_SFLOAT normals to VK_FORMAT_R8G8B8A8_SNORM
+        bool quantizeNormals = true;
+
+        /// quantize VK_FORMAT_R32G32_SFLOAT texcoords to VK_FORMAT_R16G16_UNORM when all their values are in the 0 to 1 range
+        bool quantizeTexCoords = true;
+
+        /// interleave the per vertex attributes, other than vertex positions, into a single binding, keeping positions in their own
+        /// tightly packed binding for position only passes such as shadow maps and depth pre-passes
+        bool interleaveAttributes = true;
+
+        /// number of vertex cache entries that triangles are reordered for
+        uint32_t vertexCacheSize = 16;
+
+        /// attribute locations of vertex positions, normals and texcoords, defaults match those of the standard ShaderSets
+        std::set<uint32_t> positionLocations = {0};
+        std::set<uint32_t> normalLocations = {1};
+        std::set<uint32_t> texCoordLocations = {2};
+
+        struct Statistics
+        {
+            uint32_t numDraws = 0;
+            uint32_t numDrawsReordered = 0;
+            uint32_t numPipelinesRepacked = 0;
+            uint64_t numTriangles = 0;
+            uint64_t vertexCacheMissesBefore = 0; ///< vertices transformed by a FIFO cache of vertexCacheSize entries
+            uint64_t vertexCacheMissesAfter = 0;
+            uint64_t vertexBytesBefore = 0;
+            uint64_t vertexBytesAfter = 0;
+        };
+
+        Statistics statistics;
+
+        void apply(Node& node) override;
+        void apply(StateGroup& stateGroup) override;
+        void apply(Commands& commands) override;
+        void apply(BindGraphicsPipeline& bindPipeline) override;
+        void apply(VertexIndexDraw& vid) override;
+        void apply(Geometry& geometry) override;
+
+        /// optimize the draws collected by traversals, clearing the collected draws once done
+        void optimize();
+
+        /// write the statistics of the optimizations applied
+        void report(std::ostream& out) const;
+
+    protected:
+        struct Draw
+        {
+            ref_ptr<Command> command;
+            uint32_t firstBinding = 0;
+            DataList arrays;
+            ref_ptr<Data> indices;
+            std::vector<std::pair<uint32_t, uint32_t>> ranges; // firstIndex and indexCount of each draw
+            bool reorderable = true;
+        };
+
+        using Draws = std::vector<Draw>;
+
+        void _addDraw(Draw&& draw);
+        void _reorder(Draw& draw, const VertexInputState* vertexInputState, bool triangles);
+        bool _repack(GraphicsPipeline& pipeline, Draws& draws);
+        void _assignArrays(Draw& draw, const DataList& arrays);
+
+        GraphicsPipeline* _currentPipeline = nullptr;
+        std::map<ref_ptr<GraphicsPipeline>, Draws> _draws;
+    };
+    VSG_type_name(vsg::MeshOptimizer);
+
+} // namespace vsg
@@ -0,0 +1,109 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/core/Visitor.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/BufferInfo.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/Sampler.h>
+#include <vsg/utils/SharedObjects.h>
+
+#include <map>
+#include <vector>
+
+namespace vsg
+{
+
+    /// PackTextures packs small textures into shared atlases, rewriting the texture coordinates of the draws that use them and merging the DescriptorSets
+    /// that then only differ by their texture, so that fewer Images, ImageViews and DescriptorSets are created and the remaining descriptor set bindings are shared.
+    /// A texture is packed when it's bound by a BindDescriptorSet in a StateGroup whose DescriptorSet has a single DescriptorImage with one ImageInfo,
+    /// its Data is uncompressed, without mipmaps and available on the CPU, and the texture coordinates of all the draws beneath the StateGroup
+    /// are vec2Arrays within [0, 1] that aren't shared with draws using other textures, as atlases can't honour repeating texture coordinates.
+    /// Textures are grouped by format, origin and filtering, with each atlas using clamp to edge addressing and padding replicating the edges of each texture.
+    /// Usage:
+    ///     vsg::PackTextures packTextures;
+    ///     scene->accept(packTextures);
+    ///     packTextures.pack();
+    class VSG_DECLSPEC PackTextures : public Inherit<Visitor, PackTextures>
+    {
+    public:
+        PackTextures();
+
+        /// only pack textures with width and height no larger than this
+        uint32_t maximumTextureSize = 256;
+
+        /// width and height of each atlas
+        uint32_t atlasSize = 2048;
+
+        /// texels around each texture in the atlas that replicate its edges to avoid bleeding from neighbouring textures when filtering
+        uint32_t padding = 2;
+
+        /// attribute location of the texture coordinates
+        uint32_t texCoordLocation = 2;
+
+        /// SharedObjects used to merge the rewritten DescriptorSets and BindDescriptorSets
+        ref_ptr<SharedObjects> sharedObjects;
+
+        uint32_t numTexturesPacked = 0;
+        uint32_t numAtlases = 0;
+        uint32_t numDescriptorSetsMerged = 0; ///< reduction in the number of DescriptorSets
+
+        void apply(Node& node) override;
+        void apply(StateGroup& stateGroup) override;
+        void apply(BindGraphicsPipeline& bindPipeline) override;
+        void apply(VertexDraw& vd) override;
+        void apply(VertexIndexDraw& vid) override;
+        void apply(Geometry& geometry) override;
+
+        /// pack the textures collected by traversals into atlases, returns the number of textures packed.
+        uint32_t pack();
+
+    protected:
+        struct Binding
+        {
+            StateGroup* stateGroup = nullptr;
+            size_t stateCommandIndex = 0;
+            size_t descriptorIndex = 0;
+        };
+
+        struct Texture
+        {
+            ref_ptr<Data> image;
+            ref_ptr<Sampler> sampler;
+            std::vector<Binding> bindings;
+            std::vector<ref_ptr<vec2Array>> texCoords;
+            bool valid = true;
+
+            // position in the atlas assigned by pack()
+            uint32_t atlas = 0;
+            uint32_t x = 0;
+            uint32_t y = 0;
+        };
+
+        /// return the index of the packable texture bound by the StateGroup's state command, or -1 if it's not packable
+        int _texture(StateGroup& stateGroup, size_t stateCommandIndex);
+
+        void _draw(uint32_t firstBinding, const BufferInfoList& arrays);
+
+        const GraphicsPipeline* _currentPipeline = nullptr;
+        std::vector<int> _textureStack;
+        std::vector<Texture> _textures;
+        std::map<const Data*, size_t> _textureIndices;
+        std::map<const vec2Array*, int> _texCoordTextures;
+    };
+    VSG_type_name(vsg::PackTextures);
+
+} // namespace vsg
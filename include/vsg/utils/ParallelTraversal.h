@@ -0,0 +1,103 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/ConstVisitor.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace vsg
+{
+
+    /// ConcurrentVisitedSet is a thread safe set of objects, used by visitors run by ParallelTraversal to visit shared subgraphs only once.
+    class VSG_DECLSPEC ConcurrentVisitedSet : public Inherit<Object, ConcurrentVisitedSet>
+    {
+    public:
+        /// return true if the object hadn't been inserted before
+        bool insert(const Object* object);
+
+        bool contains(const Object* object) const;
+
+        void clear();
+
+    protected:
+        struct Stripe
+        {
+            mutable std::mutex mutex;
+            std::unordered_set<const Object*> objects;
+        };
+
+        Stripe& _stripe(const Object* object) const { return _stripes[(reinterpret_cast<uintptr_t>(object) >> 4) % _stripes.size()]; }
+
+        mutable std::array<Stripe, 16> _stripes;
+    };
+    VSG_type_name(vsg::ConcurrentVisitedSet);
+
+    /// ParallelTraversal runs read only ConstVisitor traversals of large scene graphs across OperationThreads.
+    /// The graph is split at wide Groups, found by descending through plain Groups from the root, into disjoint subgraphs that are divided
+    /// into contiguous ranges, each range is traversed by its own visitor created by the user supplied create function, and once all have completed
+    /// the visitors are passed in range order to the user supplied reduce function on the calling thread.
+    /// The Groups that the graph is split at are not themselves visited, so visitors must not rely on apply(const Group&) being called for plain Groups,
+    /// as splitting only descends through plain Groups no Transform or state is missed by the subgraph traversals.
+    /// Subgraphs shared between split Groups are only traversed once, visitors that need to de-duplicate shared subgraphs deeper in the graph can use visited.
+    /// Usage:
+    ///     vsg::dbox bounds;
+    ///     auto parallel = vsg::ParallelTraversal::create(operationThreads);
+    ///     parallel->traverse<vsg::ComputeBounds>(*scene, []() { return vsg::ComputeBounds::create(); }, [&](vsg::ComputeBounds& cb) { bounds.add(cb.bounds); });
+    class VSG_DECLSPEC ParallelTraversal : public Inherit<Object, ParallelTraversal>
+    {
+    public:
+        explicit ParallelTraversal(ref_ptr<OperationThreads> in_operationThreads = {});
+
+        /// threads to run the traversals on, if null the traversals are run on the calling thread
+        ref_ptr<OperationThreads> operationThreads;
+
+        /// only split Groups with at least this many children
+        size_t minimumGroupChildren = 16;
+
+        /// maximum depth beneath the root at which Groups are split
+        uint32_t maximumSplitDepth = 8;
+
+        /// maximum number of visitors created, each traversing a contiguous range of the subgraphs
+        size_t maximumTasks = 64;
+
+        /// shared set of visited objects that visitors can use to de-duplicate shared subgraphs, cleared at the start of each traverse()
+        ref_ptr<ConcurrentVisitedSet> visited;
+
+        using CreateFunction = std::function<ref_ptr<ConstVisitor>()>;
+        using ReduceFunction = std::function<void(ConstVisitor&)>;
+
+        /// traverse the graph, returns the number of visitors created
+        size_t traverse(const Node& root, const CreateFunction& create, const ReduceFunction& reduce);
+
+        /// convenience method for visitors of type V
+        template<class V, typename Create, typename Reduce>
+        size_t traverse(const Node& root, Create create, Reduce reduce)
+        {
+            return traverse(
+                root, [&]() -> ref_ptr<ConstVisitor> { return create(); }, [&](ConstVisitor& visitor) { reduce(static_cast<V&>(visitor)); });
+        }
+
+    protected:
+        virtual ~ParallelTraversal();
+
+        void _split(const Node* node, uint32_t depth, std::vector<const Node*>& subgraphs, std::unordered_set<const Node*>& added) const;
+    };
+    VSG_type_name(vsg::ParallelTraversal);
+
+} // namespace vsg
@@ -0,0 +1,99 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/threading/OperationThreads.h>
+#include <vsg/utils/LineSegmentIntersector.h>
+
+namespace vsg
+{
+
+    /// RayBatchIntersector is an Intersector subclass that intersects many line segments with the scene graph in a single traversal,
+    /// carrying the subset of segments still intersecting the bounds of each subgraph down the traversal and testing triangles against packets of segments using SIMD.
+    /// Useful for LiDAR simulation and mass terrain height queries, intersect() can also split the segments into batches that are intersected in parallel.
+    class VSG_DECLSPEC RayBatchIntersector : public Inherit<Intersector, RayBatchIntersector>
+    {
+    public:
+        struct Segment
+        {
+            dvec3 start;
+            dvec3 end;
+        };
+
+        using Segments = std::vector<Segment>;
+        using Intersection = LineSegmentIntersector::Intersection;
+        using Intersections = LineSegmentIntersector::Intersections;
+
+        explicit RayBatchIntersector(const Segments& in_segments, ref_ptr<ArrayState> initialArrayData = {});
+
+        /// line segments, in world coordinates. If modified after construction use intersect() rather than node->accept() so the traversal state is reset.
+        Segments segments;
+
+        /// intersections of each of the segments
+        std::vector<Intersections> intersections;
+
+        /// only keep the intersection closest to the start of each segment
+        bool closestOnly = false;
+
+        /// use a TriangleBVH to find the triangles to test for draws with at least minimumTrianglesForBVH triangles, see LineSegmentIntersector::useTriangleBVH
+        bool useTriangleBVH = true;
+        uint32_t minimumTrianglesForBVH = 256;
+
+        /// intersect the subgraph, when operationThreads is assigned the segments are split into batches of segmentsPerBatch that are intersected in parallel,
+        /// with the results merged into intersections.
+        void intersect(const Node& node, ref_ptr<OperationThreads> operationThreads = {}, size_t segmentsPerBatch = 4096);
+
+        using Intersector::apply;
+
+        void apply(const LOD& lod) override;
+        void apply(const PagedLOD& plod) override;
+        void apply(const CullNode& cn) override;
+        void apply(const CullGroup& cn) override;
+        void apply(const DepthSorted& cn) override;
+
+        void pushTransform(const Transform& transform) override;
+        void popTransform() override;
+
+        /// return true if any of the active segments intersect the sphere
+        bool intersects(const dsphere& bs) override;
+
+        bool intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t firstInstance, uint32_t instanceCount) override;
+        bool intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount) override;
+
+    protected:
+        /// the segments still active in a subgraph, with their start and end in local coordinates
+        struct Frame
+        {
+            std::vector<uint32_t> active;
+            Segments local;
+        };
+
+        std::vector<Frame> _frames;
+
+        /// ratio along each segment beyond which intersections are ignored, reduced as intersections are found when closestOnly is set
+        std::vector<double> _maxRatios;
+
+        size_t _numIntersections = 0;
+
+        /// reset the frames and intersections ready for a new traversal
+        void _reset();
+
+        /// push a frame containing the active segments that intersect the bounding sphere, returns false and pushes nothing if none do
+        bool _pushBound(const dsphere& bs);
+        void _popBound() { _frames.pop_back(); }
+
+        void _intersectTriangles(const Data* indices, uint32_t first, uint32_t count, uint32_t firstInstance, uint32_t instanceCount);
+    };
+    VSG_type_name(vsg::RayBatchIntersector);
+
+} // namespace vsg
@@ -0,0 +1,34 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+#include <vsg/core/ConstVisitor.h>
+#include <vsg/core/Inherit.h>
+
+namespace vsg
+{
+
+    /// SetThreadConfined visitor sets Object::setThreadConfined(confined) on all the objects in a subgraph.
+    /// Enable while a subgraph is being constructed by a single thread so that ref_ptr copies avoid atomic operations,
+    /// and disable before the subgraph is shared, for instance before it's added to a scene graph being rendered or passed to the CompileManager.
+    class VSG_DECLSPEC SetThreadConfined : public Inherit<ConstVisitor, SetThreadConfined>
+    {
+    public:
+        explicit SetThreadConfined(bool in_confined = true);
+
+        bool confined = true;
+
+        void apply(const Object& object) override;
+    };
+    VSG_type_name(vsg::SetThreadConfined);
+
+} // namespace vsg
@@ -3,10 +3,44 @@
 #include <vsg/core/Visitor.h>
 #include <vsg/io/FileSystem.h>
 #include <vsg/state/ShaderStage.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <map>
+#include <mutex>
 
 namespace vsg
 {
 
+    /// SpirvCache retains the SPIR-V generated by ShaderCompiler, keyed by a hash of the shader source after includes and defines have been applied,
+    /// the ShaderCompileSettings, the other stages of the program and the glslang version, so each permutation is only compiled once.
+    /// SPIR-V is held in memory and, when a cache directory is provided, also written to directory/shaders so it's reused by subsequent runs.
+    class VSG_DECLSPEC SpirvCache : public Inherit<Object, SpirvCache>
+    {
+    public:
+        /// directory to use when the Options passed to ShaderCompiler::compile(..) don't provide a fileCache
+        Path fileCache;
+
+        /// get the SPIR-V for key, checking memory first then the directory, return true if found.
+        bool read(uint64_t key, ShaderModule::SPIRV& code, const Path& directory);
+
+        /// retain the SPIR-V for key in memory and, if directory is set, on disk.
+        void write(uint64_t key, const ShaderModule::SPIRV& code, const Path& directory);
+
+        /// clear the SPIR-V held in memory, files on disk are retained.
+        void clear();
+
+        /// return the file used to store the SPIR-V for key in the directory, returns an empty Path if no directory is set.
+        static Path filename(uint64_t key, const Path& directory);
+
+        /// SpirvCache shared by ShaderCompilers by default
+        static ref_ptr<SpirvCache>& instance();
+
+    protected:
+        std::mutex _mutex;
+        std::map<uint64_t, ShaderModule::SPIRV> _spirv;
+    };
+    VSG_type_name(vsg::SpirvCache);
+
     /// ShaderCompiler integrates with GLSLang to provide shader compilation from GLSL shaders to SPIRV shaders usable by Vulkan.
     /// To be able to compile GLSL the VulkanSceneGraph has to be compiled against GLSLang, you can check whether shader compilation
     /// is supported via the VSG_SUPPORTS_ShaderCompiler #define provided in include/core/Version.h, if the value is 1 then shader compilation
@@ -24,9 +58,21 @@ namespace vsg
         // default ShaderCompileSettings
         ref_ptr<ShaderCompileSettings> defaults;
 
+        /// cache of previously compiled SPIR-V, defaults to SpirvCache::instance(), set to null to always compile.
+        ref_ptr<SpirvCache> spirvCache;
+
         bool compile(ShaderStages& shaders, const std::vector<std::string>& defines = {}, ref_ptr<const Options> options = {});
         bool compile(ref_ptr<ShaderStage> shaderStage, const std::vector<std::string>& defines = {}, ref_ptr<const Options> options = {});
 
+        /// compile multiple programs, each a set of ShaderStages linked together, with programs that have identical stages only compiled once.
+        /// When operationThreads are provided the programs are compiled in parallel, programs that share ShaderModules are compiled in separate passes.
+        /// Returns true if all programs compiled successfully.
+        bool compile(std::vector<ShaderStages>& programs, ref_ptr<OperationThreads> operationThreads, ref_ptr<const Options> options = {});
+
+        /// traverse object collecting all the pipelines whose shaders require compiling then compile them in parallel using operationThreads,
+        /// if no operationThreads are provided temporary threads are created. Returns true if all programs compiled successfully.
+        bool compileSubgraph(Object& object, ref_ptr<OperationThreads> operationThreads = {}, ref_ptr<const Options> options = {});
+
         std::string combineSourceAndDefines(const std::string& source, const std::vector<std::string>& defines);
 
         void apply(Node& node) override;
@@ -36,7 +82,15 @@ namespace vsg
         void apply(BindRayTracingPipeline& bgp) override;
 
     protected:
+        /// initialize glslang for this process, must be called before compiling from multiple threads
+        void _initialize();
+
+        /// compile programs immediately or, when called from compileSubgraph(), collect them to compile once the traversal is complete
+        void _compileOrCollect(ShaderStages& shaders);
+
         bool _initialized = false;
+        bool _collecting = false;
+        std::vector<ShaderStages> _collectedPrograms;
     };
     VSG_type_name(vsg::ShaderCompiler);
 
@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/core/compare.h>
 #include <vsg/state/ArrayState.h>
+#include <vsg/state/BindlessTextures.h>
 #include <vsg/state/GraphicsPipeline.h>
 #include <vsg/state/Sampler.h>
 #include <vsg/state/ShaderStage.h>
@@ -62,6 +63,18 @@ namespace vsg
     };
     VSG_type_name(vsg::PushConstantRange);
 
+    /// SpecializationConstantBinding maps a define onto a boolean specialization constant, so that variants differing in the define share the same SPIR-V.
+    /// Shaders declare the constant in place of testing the define, i.e. layout(constant_id = 0) const bool VSG_TWO_SIDED_LIGHTING = false;
+    struct VSG_DECLSPEC SpecializationConstantBinding
+    {
+        std::string define;
+        uint32_t constantID = 0;
+        VkShaderStageFlags stageFlags = VK_SHADER_STAGE_ALL;
+
+        int compare(const SpecializationConstantBinding& rhs) const;
+    };
+    VSG_type_name(vsg::SpecializationConstantBinding);
+
     struct VSG_DECLSPEC DefinesArrayState
     {
         std::set<std::string> defines;
@@ -107,6 +120,29 @@ namespace vsg
     };
     VSG_type_name(vsg::ViewDependentStateBinding);
 
+    /// Custom state binding class for providing the DescriptorSetLayout and BindDescriptorSet for a BindlessTextures texture array shared by all the pipelines using the ShaderSet.
+    /// Textures are registered using DescriptorConfigurator::assignBindlessTexture(..), which enables the define so shaders can select indexing into the texture array.
+    struct VSG_DECLSPEC BindlessTextureBinding : public Inherit<CustomDescriptorSetBinding, BindlessTextureBinding>
+    {
+        BindlessTextureBinding(uint32_t in_set = 0, ref_ptr<BindlessTextures> in_textures = {});
+
+        int compare(const Object& rhs) const override;
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+        /// define assigned by DescriptorConfigurator when textures are registered with the BindlessTextures
+        std::string define = "VSG_BINDLESS_TEXTURES";
+
+        /// runtime texture array, not serialized, a default BindlessTextures is created when reading
+        ref_ptr<BindlessTextures> textures;
+
+        bool compatibleDescriptorSetLayout(const DescriptorSetLayout& dsl) const override;
+        ref_ptr<DescriptorSetLayout> createDescriptorSetLayout() override;
+        ref_ptr<StateCommand> createStateCommand(ref_ptr<PipelineLayout> layout) override;
+    };
+    VSG_type_name(vsg::BindlessTextureBinding);
+
     /// ShaderSet provides a collection of shader related settings to provide a form of shader introspection.
     class VSG_DECLSPEC ShaderSet : public Inherit<Object, ShaderSet>
     {
@@ -120,11 +156,15 @@ namespace vsg
         std::vector<AttributeBinding> attributeBindings;
         std::vector<DescriptorBinding> descriptorBindings;
         std::vector<PushConstantRange> pushConstantRanges;
+        std::vector<SpecializationConstantBinding> specializationConstantBindings;
         std::vector<DefinesArrayState> definesArrayStates; // put more constrained ArrayState matches first so they are matched first.
         std::set<std::string> optionalDefines;
         GraphicsPipelineStates defaultGraphicsPipelineStates;
         std::vector<ref_ptr<CustomDescriptorSetBinding>> customDescriptorSetBindings;
 
+        /// subpass of the render pass that pipelines set up from this ShaderSet are used in
+        uint32_t subpass = 0;
+
         ref_ptr<ShaderCompileSettings> defaultShaderHints;
         /// variants of the rootShaderModule compiled for different combinations of ShaderCompileSettings
         std::map<ref_ptr<ShaderCompileSettings>, ShaderStages, DereferenceLess> variants;
@@ -143,6 +183,9 @@ namespace vsg
         /// add a push constant range. Not thread safe, should only be called when initially setting up the ShaderSet
         void addPushConstantRange(const std::string& name, const std::string& define, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size);
 
+        /// add a specialization constant binding. Not thread safe, should only be called when initially setting up the ShaderSet
+        void addSpecializationConstantBinding(const std::string& define, uint32_t constantID, VkShaderStageFlags stageFlags = VK_SHADER_STAGE_ALL);
+
         /// get the AttributeBinding associated with name
         AttributeBinding& getAttributeBinding(const std::string& name);
 
@@ -163,8 +206,13 @@ namespace vsg
         ref_ptr<ArrayState> getSuitableArrayState(const std::set<std::string>& defines) const;
 
         /// get the ShaderStages variant that uses specified ShaderCompileSettings.
+        /// Defines mapped to specializationConstantBindings are set as specialization constants on ShaderStages that share the ShaderModule compiled without them.
         ShaderStages getShaderStages(ref_ptr<ShaderCompileSettings> scs = {});
 
+        /// create a new ShaderSet with copies of the binding settings that shares this ShaderSet's ShaderStages and precompiled variants.
+        /// Used by the built-in ShaderSets so their embedded SPIR-V is only read once per SharedObjects however many times they are created.
+        ref_ptr<ShaderSet> sharedCopy();
+
         /// return the <minimum_set, maximum_set+1> range of set numbers encompassing DescriptorBindings
         std::pair<uint32_t, uint32_t> descriptorSetRange() const;
 
@@ -195,11 +243,17 @@ namespace vsg
     protected:
         virtual ~ShaderSet();
 
+        ShaderStages& _getShaderStages(ref_ptr<ShaderCompileSettings> scs);
+
         AttributeBinding _nullAttributeBinding;
         DescriptorBinding _nullDescriptorBinding;
     };
     VSG_type_name(vsg::ShaderSet);
 
+    /// return a sharedCopy() of the ShaderSet cached in options->sharedObjects under name, calling create() to set it up on first use.
+    /// Without options->sharedObjects the ShaderSet returned by create() is returned, so ShaderStages are only shared by users of the same SharedObjects.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createSharedShaderSet(const std::string& name, ref_ptr<const Options> options, ref_ptr<ShaderSet> (*create)());
+
     /// create a ShaderSet for unlit, flat shaded rendering
     extern VSG_DECLSPEC ref_ptr<ShaderSet> createFlatShadedShaderSet(ref_ptr<const Options> options = {});
 
@@ -209,4 +263,14 @@ namespace vsg
     /// create a ShaderSet for Physics Based Rendering
     extern VSG_DECLSPEC ref_ptr<ShaderSet> createPhysicsBasedRenderingShaderSet(ref_ptr<const Options> options = {});
 
+    /// create a multiview variant of a ShaderSet, replacing its vertex shader with one that uses gl_ViewIndex to select the ViewDependentState::multiviewData matrices.
+    /// The base ShaderSet's vertex shader must have the same inputs and outputs as the built-in Phong and PBR ShaderSets.
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createMultiviewShaderSet(ref_ptr<ShaderSet> base);
+
+    /// create a ShaderSet for Phong shaded multiview rendering
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createMultiviewPhongShaderSet(ref_ptr<const Options> options = {});
+
+    /// create a ShaderSet for Physics Based multiview Rendering
+    extern VSG_DECLSPEC ref_ptr<ShaderSet> createMultiviewPhysicsBasedRenderingShaderSet(ref_ptr<const Options> options = {});
+
 } // namespace vsg
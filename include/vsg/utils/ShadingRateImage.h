@@ -0,0 +1,77 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ComputePipeline.h>
+#include <vsg/state/ImageInfo.h>
+#include <vsg/vk/RenderPass.h>
+
+namespace vsg
+{
+
+    /// ShadingRateImage command computes a VK_KHR_fragment_shading_rate attachment image using a compute shader, for variable rate shading of a RenderGraph.
+    /// Each texel of the VK_FORMAT_R8_UINT image gives the shading rate of a texelSize region of the framebuffer, full rate, 2x2 or 4x4, chosen by distance from a
+    /// foveation center and/or by the luminance contrast of a source image such as the previous frame, so that regions that wouldn't benefit are shaded at a coarser rate.
+    /// The image is left in VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR ready to be assigned to RenderGraph::fragmentShadingRateAttachment,
+    /// so record it ahead of that RenderGraph each frame.
+    class VSG_DECLSPEC ShadingRateImage : public Inherit<Command, ShadingRateImage>
+    {
+    public:
+        /// framebufferExtent is the size of the framebuffer that the shading rate image is used with, texelSize must be supported by the device's fragment shading rate properties
+        explicit ShadingRateImage(const VkExtent2D& in_framebufferExtent = {0, 0}, const VkExtent2D& in_texelSize = {16, 16});
+
+        const VkExtent2D framebufferExtent;
+        const VkExtent2D texelSize;
+
+        /// when true the shading rate is reduced with distance from the foveation center
+        bool foveated = true;
+
+        /// foveation center in normalized framebuffer coordinates, typically updated each frame from eye tracking or left at the center of the display
+        vec2 center = {0.5f, 0.5f};
+
+        /// radii, as a proportion of the framebuffer height, within which full rate shading is used and beyond which 4x4 shading is used, with 2x2 shading between
+        float innerRadius = 0.25f;
+        float outerRadius = 0.5f;
+
+        /// optional image, such as the previous frame's color attachment, sampled to choose the rate from its local luminance contrast. Must be set before compile.
+        /// When combined with foveation the coarser of the two rates is used.
+        ref_ptr<ImageInfo> sourceImage;
+
+        /// luminance range within a texel's region below which 4x4 and 2x2 shading are used
+        float lowContrastThreshold = 0.02f;
+        float mediumContrastThreshold = 0.08f;
+
+        /// the computed shading rate image
+        ref_ptr<ImageView> imageView;
+
+        /// local workgroup size, in each dimension, used by the compute shader
+        static constexpr uint32_t workgroupSize = 8;
+
+        /// AttachmentDescription for use of imageView with a RenderPass and SubpassDescription::fragmentShadingRateAttachments
+        AttachmentDescription attachmentDescription() const;
+
+        void compile(Context& context) override;
+        void record(CommandBuffer& commandBuffer) const override;
+
+    protected:
+        ref_ptr<PipelineLayout> _pipelineLayout;
+        ref_ptr<BindComputePipeline> _bindPipeline;
+        ref_ptr<BindDescriptorSet> _bindDescriptorSet;
+        ref_ptr<PipelineBarrier> _preComputeBarrier;
+        ref_ptr<PipelineBarrier> _postComputeBarrier;
+    };
+    VSG_type_name(vsg::ShadingRateImage);
+
+} // namespace vsg
@@ -17,9 +17,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/stream.h>
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <ostream>
 #include <set>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace vsg
 {
@@ -28,6 +31,8 @@ namespace vsg
     class SuitableForSharing;
 
     /// class for facilitating the sharing of instances of objects that have the same properties.
+    /// Objects are held in a hash table per type, keyed by their structural hash computed with HashOutput, with compare() only used to resolve objects with the same hash.
+    /// Each type's table has its own lock so threads sharing objects of different types don't contend.
     class VSG_DECLSPEC SharedObjects : public Inherit<Object, SharedObjects>
     {
     public:
@@ -75,9 +80,25 @@ namespace vsg
     protected:
         virtual ~SharedObjects();
 
+        /// hash table of the shared objects of one type
+        struct Table
+        {
+            std::mutex mutex;
+            std::unordered_multimap<uint64_t, ref_ptr<Object>> objects;
+        };
+
+        /// return the Table for type, creating it if required
+        Table& _getTable(const std::type_index& type);
+
+        /// return the object in the type's Table that matches object, if none matches and insert is true add object to the Table
+        ref_ptr<Object> _share(const std::type_index& type, ref_ptr<Object> object, bool insert);
+
+        // guards _defaults and suitableForSharing
         mutable std::recursive_mutex _mutex;
         std::map<std::type_index, ref_ptr<Object>> _defaults;
-        std::map<std::type_index, std::set<ref_ptr<Object>, DereferenceLess>> _sharedObjects;
+
+        mutable std::shared_mutex _tablesMutex;
+        std::map<std::type_index, std::unique_ptr<Table>> _tables;
     };
     VSG_type_name(vsg::SharedObjects);
 
@@ -95,6 +116,9 @@ namespace vsg
         void traverse(ConstVisitor& visitor) const override;
 
         int compare(const Object& rhs_object) const override;
+
+        /// only the filename is written, used to provide the structural hash for SharedObjects
+        void write(Output& output) const override;
     };
     VSG_type_name(vsg::LoadedObject);
 
@@ -134,14 +158,9 @@ namespace vsg
         if (!def_T)
         {
             def_T = T::create();
-            auto& shared_objects = _sharedObjects[id];
-            if (auto itr = shared_objects.find(def_T); itr != shared_objects.end())
+            if (auto existing = _share(id, def_T, true))
             {
-                def_T = (static_cast<T*>(itr->get()));
-            }
-            else
-            {
-                shared_objects.insert(def_T);
+                def_T = (static_cast<T*>(existing.get()));
             }
 
             def = def_T;
@@ -154,47 +173,41 @@ namespace vsg
     template<class T>
     void SharedObjects::share(ref_ptr<T>& object)
     {
-        std::scoped_lock<std::recursive_mutex> lock(_mutex);
-
-        if (suitableForSharing && !suitableForSharing->suitable(object.get())) return;
+        if (!object) return;
 
-        auto id = std::type_index(typeid(T));
-        auto& shared_objects = _sharedObjects[id];
-        if (auto itr = shared_objects.find(object); itr != shared_objects.end())
         {
-            object = ref_ptr<T>(static_cast<T*>(itr->get()));
-            return;
+            std::scoped_lock<std::recursive_mutex> lock(_mutex);
+            if (suitableForSharing && !suitableForSharing->suitable(object.get())) return;
         }
 
-        shared_objects.insert(object);
+        if (auto existing = _share(std::type_index(typeid(T)), object, true))
+        {
+            object = ref_ptr<T>(static_cast<T*>(existing.get()));
+        }
     }
 
     // implementation of template method
     template<class T, typename Func>
     void SharedObjects::share(ref_ptr<T>& object, Func init)
     {
+        auto id = std::type_index(typeid(T));
+        if (auto existing = _share(id, object, false))
         {
-            std::scoped_lock<std::recursive_mutex> lock(_mutex);
-
-            auto id = std::type_index(typeid(T));
-            auto& shared_objects = _sharedObjects[id];
-            if (auto itr = shared_objects.find(object); itr != shared_objects.end())
-            {
-                object = ref_ptr<T>(static_cast<T*>(itr->get()));
-                return;
-            }
+            object = ref_ptr<T>(static_cast<T*>(existing.get()));
+            return;
         }
 
         init(object);
 
         {
             std::scoped_lock<std::recursive_mutex> lock(_mutex);
-            auto id = std::type_index(typeid(T));
-            auto& shared_objects = _sharedObjects[id];
-            if (suitableForSharing && suitableForSharing->suitable(object.get()))
-            {
-                shared_objects.insert(object);
-            }
+            if (!suitableForSharing || !suitableForSharing->suitable(object.get())) return;
+        }
+
+        // another thread may have shared a matching object while this one was being initialized, in which case use the first one shared
+        if (auto existing = _share(id, object, true))
+        {
+            object = ref_ptr<T>(static_cast<T*>(existing.get()));
         }
     }
 
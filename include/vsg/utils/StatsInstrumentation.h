@@ -0,0 +1,132 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Path.h>
+#include <vsg/utils/Instrumentation.h>
+#include <vsg/vk/vulkan.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace vsg
+{
+
+    // forward declare
+    class Device;
+
+    /// StatsInstrumentation is a built-in Instrumentation implementation that aggregates the call count and total, minimum, maximum
+    /// and percentile CPU time of each SourceLocation on each thread, and the GPU time of each command buffer and GPU instrumented
+    /// region, such as InstrumentationNode subgraphs, measured with timestamp queries. Results are merged at the end of each frame
+    /// and can be written as JSON or CSV to monitor hot paths without an external profiler.
+    class VSG_DECLSPEC StatsInstrumentation : public Inherit<Instrumentation, StatsInstrumentation>
+    {
+    public:
+        StatsInstrumentation();
+
+        /// maximum SourceLocation level to record CPU timings for
+        uint32_t cpuInstrumentationLevel = 3;
+
+        /// maximum SourceLocation level to write GPU timestamps for
+        uint32_t gpuInstrumentationLevel = 1;
+
+        /// maximum number of SourceLocations recorded per thread, further SourceLocations are ignored
+        uint32_t maxSourceLocations = 1024;
+
+        /// number of timestamp queries available to each command buffer per frame, each timed region uses two
+        uint32_t queriesPerCommandBuffer = 256;
+
+        /// maximum number of command buffers per device per frame that can be GPU timed
+        uint32_t commandBuffersPerFrame = 16;
+
+        /// aggregated timings of a SourceLocation, durations in milliseconds
+        struct Statistics
+        {
+            const SourceLocation* sourceLocation = nullptr;
+            std::string thread; ///< name of the thread for CPU timings, "GPU" for GPU timings
+            bool gpu = false;
+            uint64_t count = 0;
+            double total = 0.0;
+            double minimum = 0.0;
+            double maximum = 0.0;
+            double percentile50 = 0.0;
+            double percentile95 = 0.0;
+            double percentile99 = 0.0;
+
+            double average() const { return count > 0 ? total / static_cast<double>(count) : 0.0; }
+        };
+
+        enum Format
+        {
+            JSON,
+            CSV
+        };
+
+        /// merge the timings recorded by all threads and the available GPU results, called automatically at the end of each frame.
+        void merge() const;
+
+        /// return the Statistics from the most recent merge
+        std::vector<Statistics> results() const;
+
+        /// write the results of the most recent merge
+        void write(std::ostream& out, Format format = JSON) const;
+
+        /// write the results of the most recent merge to file, using CSV if the file extension is .csv and JSON otherwise.
+        bool write(const Path& filename) const;
+
+        void setThreadName(const std::string& name) const override;
+
+        void enterFrame(const SourceLocation* sl, uint64_t& reference, FrameStamp& frameStamp) const override;
+        void leaveFrame(const SourceLocation* sl, uint64_t& reference, FrameStamp& frameStamp) const override;
+
+        void enter(const SourceLocation* sl, uint64_t& reference, const Object* object = nullptr) const override;
+        void leave(const SourceLocation* sl, uint64_t& reference, const Object* object = nullptr) const override;
+
+        void enterCommandBuffer(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer) const override;
+        void leaveCommandBuffer(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer) const override;
+
+        void enter(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer, const Object* object = nullptr) const override;
+        void leave(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer, const Object* object = nullptr) const override;
+
+    protected:
+        virtual ~StatsInstrumentation();
+
+        struct Accumulator;
+        struct ThreadStats;
+        struct GpuQueries;
+
+        ThreadStats* _threadStats() const;
+        void _collectGpuResults(GpuQueries& queries, uint32_t slotIndex, uint64_t frameCount) const;
+        void _enterGpu(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer, bool beginCommandBuffer) const;
+        void _leaveGpu(uint64_t& reference, CommandBuffer& commandBuffer) const;
+
+        const uint64_t _id;
+        mutable std::atomic_uint64_t _frameCount{0};
+
+        mutable std::mutex _threadsMutex;
+        mutable std::vector<std::unique_ptr<ThreadStats>> _threads;
+
+        mutable std::mutex _gpuMutex;
+        mutable std::map<const Device*, std::unique_ptr<GpuQueries>> _gpuQueries;
+        mutable std::map<const SourceLocation*, std::unique_ptr<Accumulator>> _gpuStats;
+
+        mutable std::mutex _resultsMutex;
+        mutable std::vector<Statistics> _results;
+    };
+    VSG_type_name(vsg::StatsInstrumentation);
+
+} // namespace vsg
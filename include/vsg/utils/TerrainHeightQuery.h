@@ -0,0 +1,112 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array2D.h>
+#include <vsg/core/observer_ptr.h>
+#include <vsg/nodes/TileDatabase.h>
+
+#include <map>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// ElevationGrid holds the heights of a TileDatabase tile, sampled on a regular grid across the tile's extents.
+    class VSG_DECLSPEC ElevationGrid : public Inherit<Object, ElevationGrid>
+    {
+    public:
+        ElevationGrid();
+        ElevationGrid(uint32_t in_x, uint32_t in_y, uint32_t in_level, const dbox& in_extents, ref_ptr<floatArray2D> in_heights);
+
+        /// tile coords and level within the TileDatabase
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t level = 0;
+
+        /// extents of the tile in the TileDatabaseSettings::projection coords
+        dbox extents;
+
+        /// heights in metres, heights->properties.origin specifies whether the first row is at extents.max.y (TOP_LEFT) or extents.min.y
+        ref_ptr<floatArray2D> heights;
+
+        /// bilinear sample of the height at a coord within the extents
+        double sample(double px, double py) const;
+
+        /// convert elevation data read from a TileDatabaseSettings::terrainLayer into heights in metres.
+        /// Supports float, int16 and uint16 heights and Mapbox terrain-RGB encoded ubvec3/ubvec4 images, returns null for unsupported data.
+        static ref_ptr<floatArray2D> convert(ref_ptr<Data> data);
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+    };
+    VSG_type_name(vsg::ElevationGrid);
+
+    /// TerrainHeightQuery provides fast lookup of terrain heights for a TileDatabase, such as for clamping vehicles and labels to the terrain.
+    /// The ElevationGrid of each tile read by the vsg::tile ReaderWriter is added when TileDatabaseSettings::terrainLayer is set and the query has been
+    /// assigned to the settings with settings->setObject("TerrainHeightQuery", heightQuery). The grids are held as observer_ptr so are dropped once the
+    /// DatabasePager expires the tiles, and queries use the highest resolution grid available, only falling back to intersecting the scene when no grid covers a location.
+    class VSG_DECLSPEC TerrainHeightQuery : public Inherit<Object, TerrainHeightQuery>
+    {
+    public:
+        explicit TerrainHeightQuery(const TileDatabaseSettings& settings);
+
+        /// tiling scheme, copied from the TileDatabaseSettings
+        dbox extents;
+        uint32_t noX = 2;
+        uint32_t noY = 1;
+        bool originTopLeft = true;
+        std::string projection;
+        ref_ptr<EllipsoidModel> ellipsoidModel;
+
+        /// optional scene graph to intersect against when no ElevationGrid covers a location, requires an ellipsoidModel.
+        ref_ptr<Node> scene;
+
+        /// add an ElevationGrid, thread safe so may be called from the database reading threads.
+        void add(ref_ptr<ElevationGrid> grid);
+
+        /// compute the height at a latitude and longitude in degrees, return false if no height could be found.
+        bool computeHeight(double latitude, double longitude, double& height) const;
+
+        /// compute the heights of count latitude, longitude pairs in degrees, heights that can't be found are set to defaultHeight. Returns the number of heights found.
+        size_t computeHeights(const dvec2* latitudeLongitudes, double* heights, size_t count, double defaultHeight = 0.0) const;
+
+        /// compute the heights of latitude, longitude pairs in degrees, resizing heights to match. Returns the number of heights found.
+        size_t computeHeights(const std::vector<dvec2>& latitudeLongitudes, std::vector<double>& heights, double defaultHeight = 0.0) const;
+
+        /// remove the entries of grids that have been deleted, returns the number removed.
+        size_t prune();
+
+        /// return the number of grid entries, including any deleted grids that haven't been pruned yet
+        size_t size() const;
+
+    protected:
+        virtual ~TerrainHeightQuery();
+
+        /// convert latitude, longitude to the projection coords used by the tiles
+        dvec2 computeProjectionCoord(double latitude, double longitude) const;
+
+        /// find the highest resolution grid covering the projection coord, checking the previously found grid first
+        ref_ptr<ElevationGrid> findGrid(const dvec2& coord, ref_ptr<ElevationGrid>& previous) const;
+
+        bool intersect(double latitude, double longitude, double& height) const;
+
+        static uint64_t key(uint32_t x, uint32_t y, uint32_t level) { return (uint64_t(level) << 58) | (uint64_t(y) << 29) | uint64_t(x); }
+
+        mutable std::mutex _mutex;
+        std::map<uint64_t, observer_ptr<ElevationGrid>> _grids;
+        uint32_t _maxLevel = 0;
+    };
+    VSG_type_name(vsg::TerrainHeightQuery);
+
+} // namespace vsg
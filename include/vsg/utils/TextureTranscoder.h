@@ -0,0 +1,64 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/ImageInfo.h>
+#include <vsg/vk/PhysicalDevice.h>
+
+namespace vsg
+{
+
+    /// TextureTranscoder converts the uncompressed textures of a subgraph to block compressed formats supported by the device,
+    /// reducing the size of uploads and the GPU memory used by four to eight times.
+    /// The built in encoder is a fast bounding box encoder that compresses VK_FORMAT_R8G8B8A8 and VK_FORMAT_B8G8R8A8 UNORM/SRGB textures
+    /// to BC1 when they are opaque and BC3 when they have an alpha channel. Mipmaps are generated on the CPU before compression when required
+    /// by the sampler as block compressed images can't have mipmaps generated on the GPU with vkCmdBlitImage.
+    /// Subclasses can override transcode(const Data*, uint32_t) to add support for other source formats, such as supercompressed KTX2/Basis data,
+    /// or other target formats such as ASTC.
+    /// The transcode() methods are const and thread safe so a single TextureTranscoder can be shared by the DatabasePager's read threads,
+    /// textures should be transcoded before they are compiled.
+    class VSG_DECLSPEC TextureTranscoder : public Inherit<Object, TextureTranscoder>
+    {
+    public:
+        TextureTranscoder();
+
+        /// set the supported formats from the PhysicalDevice's textureCompressionBC and textureCompressionASTC_LDR features
+        explicit TextureTranscoder(const PhysicalDevice* physicalDevice);
+
+        /// device supports the BC formats
+        bool supportsBC = false;
+
+        /// device supports the ASTC LDR formats, used by subclasses that transcode to ASTC
+        bool supportsASTC = false;
+
+        /// textures with a width or height smaller than minimumDimension are left uncompressed
+        uint32_t minimumDimension = 32;
+
+        /// transcode the textures of all the DescriptorImage in a subgraph, returning the number of textures transcoded
+        uint32_t transcode(Object& object) const;
+
+        /// transcode the image data of an ImageInfo in place, returning true if the data was replaced
+        bool transcode(ImageInfo& imageInfo) const;
+
+        /// return a block compressed version of data with mipLevels mipmap levels, or null if data can't be transcoded
+        virtual ref_ptr<Data> transcode(const Data* data, uint32_t mipLevels) const;
+
+        /// return true if the format is one of the uncompressed formats the built in encoder supports
+        static bool compressible(VkFormat format);
+
+    protected:
+        virtual ~TextureTranscoder();
+    };
+    VSG_type_name(vsg::TextureTranscoder);
+
+} // namespace vsg
@@ -238,6 +238,11 @@ namespace vsg
             MemWrite(&item->gpuZoneEnd.context, ctx->GetId());
             Profiler::QueueSerialFinish();
         }
+
+        void plot(const char* name, double value) const override
+        {
+            TracyPlot(name, value);
+        }
     };
     VSG_type_name(vsg::TracyInstrumentation);
 #else
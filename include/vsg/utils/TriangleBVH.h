@@ -0,0 +1,156 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/threading/OperationThreads.h>
+#include <vsg/utils/Intersector.h>
+
+namespace vsg
+{
+
+    /// TriangleBVH is a bounding volume hierarchy of the triangles of a vkCmdDraw/vkCmdDrawIndexed triangle list, built using the surface area heuristic.
+    /// Used by LineSegmentIntersector to avoid testing every triangle, it's cached on the vertex array it was built from, alongside those of the other draws
+    /// sharing the vertex array, so is reused by subsequent intersections and is written out along with the vertex array so can be built ahead of time using BuildTriangleBVHs.
+    class VSG_DECLSPEC TriangleBVH : public Inherit<Object, TriangleBVH>
+    {
+    public:
+        TriangleBVH();
+
+        /// node of the hierarchy, leaf nodes have a non zero count of triangles starting at first,
+        /// internal nodes have a zero count with the left child immediately following the node and the right child at first.
+        struct BVHNode
+        {
+            vec3 lower;
+            uint32_t first = 0;
+            vec3 upper;
+            uint32_t count = 0;
+        };
+
+        std::vector<BVHNode> nodes;
+
+        /// the three vertex indices of each triangle, ordered so the triangles of each leaf are contiguous
+        std::vector<uint32_t> indices;
+
+        /// the index array, null for non indexed draws, and draw range the TriangleBVH was built for
+        ref_ptr<const Data> indexArray;
+        uint32_t first = 0;
+        uint32_t count = 0;
+
+        /// maximum number of triangles in a leaf node
+        static constexpr uint32_t maxLeafSize = 4;
+
+        /// build the hierarchy for count vertices/indices starting at first, indices may be a ushortArray or uintArray, or null for non indexed draws
+        void build(const vec3Array& vertices, const Data* indexArray, uint32_t in_first, uint32_t in_count);
+
+        /// return true if the TriangleBVH was built for the specified index array and draw range
+        bool matches(const Data* in_indexArray, uint32_t in_first, uint32_t in_count) const
+        {
+            return first == in_first && count == in_count && indexArray.get() == in_indexArray;
+        }
+
+        /// call triangle(i0, i1, i2) for each triangle in the leaves whose bounds intersect the line segment
+        template<class F>
+        void intersect(const dvec3& start, const dvec3& end, F triangle) const
+        {
+            if (nodes.empty()) return;
+
+            dvec3 d = end - start;
+            dvec3 inv_d(1.0 / d.x, 1.0 / d.y, 1.0 / d.z);
+
+            uint32_t stack[64];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+            while (stackSize > 0)
+            {
+                const auto& node = nodes[stack[--stackSize]];
+
+                double tmin = 0.0, tmax = 1.0;
+                for (int a = 0; a < 3; ++a)
+                {
+                    double t0 = (double(node.lower[a]) - start[a]) * inv_d[a];
+                    double t1 = (double(node.upper[a]) - start[a]) * inv_d[a];
+                    if (t0 > t1) std::swap(t0, t1);
+                    if (t0 > tmin) tmin = t0;
+                    if (t1 < tmax) tmax = t1;
+                }
+                if (tmin > tmax) continue;
+
+                if (node.count > 0)
+                {
+                    const uint32_t* triangleIndices = indices.data() + node.first * 3;
+                    for (uint32_t i = 0; i < node.count; ++i, triangleIndices += 3)
+                    {
+                        triangle(triangleIndices[0], triangleIndices[1], triangleIndices[2]);
+                    }
+                }
+                else if (stackSize + 2 <= 64)
+                {
+                    stack[stackSize++] = node.first;
+                    stack[stackSize++] = static_cast<uint32_t>(&node - nodes.data()) + 1;
+                }
+            }
+        }
+
+        /// return the TriangleBVH cached on the vertices for the specified index array and draw range, building and caching it if required.
+        /// Returns null if the vertices aren't static data or there are too few triangles.
+        static ref_ptr<const TriangleBVH> getOrCreate(const vec3Array& vertices, const Data* indexArray, uint32_t in_first, uint32_t in_count, uint32_t minimumTriangles = 256);
+
+        void read(Input& input) override;
+        void write(Output& output) const override;
+
+    protected:
+        virtual ~TriangleBVH();
+    };
+    VSG_type_name(vsg::TriangleBVH);
+
+    /// BuildTriangleBVHs traverses a scene graph collecting the draws that LineSegmentIntersector would intersect and builds their TriangleBVH ahead of time,
+    /// using the OperationThreads to build them in parallel when assigned. Usage:
+    ///     auto buildBVHs = vsg::BuildTriangleBVHs::create(operationThreads);
+    ///     scene->accept(*buildBVHs);
+    ///     buildBVHs->build();
+    class VSG_DECLSPEC BuildTriangleBVHs : public Inherit<Intersector, BuildTriangleBVHs>
+    {
+    public:
+        explicit BuildTriangleBVHs(ref_ptr<OperationThreads> in_operationThreads = {});
+
+        ref_ptr<OperationThreads> operationThreads;
+
+        /// draws with fewer triangles than this are left to be intersected directly
+        uint32_t minimumTriangles = 256;
+
+        struct Draw
+        {
+            ref_ptr<const vec3Array> vertices;
+            ref_ptr<const Data> indices;
+            uint32_t first = 0;
+            uint32_t count = 0;
+        };
+
+        std::vector<Draw> draws;
+
+        /// build the TriangleBVH of each of the collected draws, returns the number built.
+        size_t build();
+
+        void pushTransform(const Transform&) override {}
+        void popTransform() override {}
+        bool intersects(const dsphere&) override { return true; }
+        bool intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t firstInstance, uint32_t instanceCount) override;
+        bool intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount) override;
+
+    protected:
+        void _add(const Data* indices, uint32_t first, uint32_t count);
+    };
+    VSG_type_name(vsg::BuildTriangleBVHs);
+
+} // namespace vsg
@@ -0,0 +1,90 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/TransferTask.h>
+#include <vsg/maths/vec2.h>
+#include <vsg/state/ImageInfo.h>
+
+#include <mutex>
+
+namespace vsg
+{
+
+    /// VirtualTexture packs many equally sized textures, such as the imagery of terrain tiles, into the pages of a single atlas Image so that
+    /// subgraphs using them can share one pipeline and descriptor set, with each subgraph mapping its texture coordinates into its page of the atlas.
+    /// Page contents are uploaded by the assigned TransferTask, and pages are returned for reuse once the Page object returned by allocate(..) is deleted.
+    class VSG_DECLSPEC VirtualTexture : public Inherit<Object, VirtualTexture>
+    {
+    public:
+        /// create an atlas of numPagesX by numPagesY pages that each hold a pageWidth by pageHeight texture, plus a pageBorder of texels around it to avoid filtering across pages.
+        VirtualTexture(uint32_t in_pageWidth, uint32_t in_pageHeight, uint32_t in_numPagesX, uint32_t in_numPagesY, VkFormat in_format = VK_FORMAT_R8G8B8A8_UNORM, uint32_t in_pageBorder = 1);
+
+        const uint32_t pageWidth;
+        const uint32_t pageHeight;
+        const uint32_t numPagesX;
+        const uint32_t numPagesY;
+        const VkFormat format;
+        const uint32_t pageBorder;
+
+        /// TransferTask used to upload the contents of pages, typically the viewer's RecordAndSubmitTask::earlyTransferTask. Must be assigned before pages are allocated.
+        ref_ptr<TransferTask> transferTask;
+
+        /// sampler and atlas image, the atlas has a single mip level so the sampler's maxLod is 0.
+        ref_ptr<Sampler> sampler;
+        ref_ptr<ImageInfo> atlas;
+
+        /// Page of the atlas, returned to the VirtualTexture's free pages when deleted.
+        class VSG_DECLSPEC Page : public Inherit<Object, Page>
+        {
+        public:
+            Page(ref_ptr<VirtualTexture> in_virtualTexture, uint32_t in_index);
+
+            const uint32_t index;
+
+            /// offset and scale that map the page's 0 to 1 texture coordinates into the atlas
+            vec2 offset;
+            vec2 scale;
+
+            vec2 transform(const vec2& tc) const { return offset + tc * scale; }
+
+        protected:
+            virtual ~Page();
+
+            ref_ptr<VirtualTexture> _virtualTexture;
+        };
+
+        /// allocate a page and queue the upload of data to it, returns null if the data isn't compatible with the pages or no pages are free.
+        /// Thread safe so can be called from DatabasePager threads.
+        ref_ptr<Page> allocate(ref_ptr<Data> data);
+
+        /// return true if data's dimensions and format can be uploaded to a page, the data's format must be the atlas format, or its RGB equivalent that is padded to RGBA
+        bool compatible(const Data* data) const;
+
+        uint32_t numPages() const { return numPagesX * numPagesY; }
+        uint32_t numAllocatedPages() const;
+
+    protected:
+        virtual ~VirtualTexture();
+
+        friend Page;
+
+        void _release(uint32_t index);
+
+        mutable std::mutex _mutex;
+        std::vector<uint32_t> _freePages;
+    };
+    VSG_type_name(vsg::VirtualTexture);
+    VSG_type_name(vsg::VirtualTexture::Page);
+
+} // namespace vsg
@@ -0,0 +1,73 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/Camera.h>
+#include <vsg/io/Path.h>
+
+namespace vsg
+{
+
+    /// WorkloadPlayer reads a workload log written by WorkloadRecorder and replays the recorded camera matrices frame by frame.
+    /// The recorded DatabasePager and dynamic data events of each frame are available for comparison with those of the replay.
+    class VSG_DECLSPEC WorkloadPlayer : public Inherit<Object, WorkloadPlayer>
+    {
+    public:
+        explicit WorkloadPlayer(const std::vector<ref_ptr<Camera>>& in_cameras = {});
+
+        struct CameraMatrices
+        {
+            dmat4 projection;
+            dmat4 view;
+        };
+
+        struct PagerEvent
+        {
+            Path filename;
+            double priority = 0.0;
+        };
+
+        struct Frame
+        {
+            uint64_t frameCount = 0;
+            double time = 0.0; ///< seconds since the first recorded frame
+            std::vector<CameraMatrices> cameras;
+            std::vector<PagerEvent> pagerRequests;
+            std::vector<PagerEvent> pagerMerges;
+            uint64_t dynamicDataSize = 0;
+        };
+
+        /// cameras to assign the recorded matrices to, in the order they were recorded
+        std::vector<ref_ptr<Camera>> cameras;
+
+        std::vector<Frame> frames;
+
+        /// index of the next frame to be replayed
+        size_t nextFrame = 0;
+
+        /// read the log, replacing any previously read frames, returns false on failure
+        bool read(const Path& filename);
+
+        /// assign the next frame's camera matrices to the cameras, returns null once all the frames have been replayed
+        const Frame* advance();
+
+        /// total number of pager requests and merges recorded
+        size_t numPagerRequests() const;
+        size_t numPagerMerges() const;
+
+    protected:
+        virtual ~WorkloadPlayer();
+    };
+    VSG_type_name(vsg::WorkloadPlayer);
+
+} // namespace vsg
@@ -0,0 +1,80 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/Camera.h>
+#include <vsg/io/Path.h>
+#include <vsg/ui/FrameStamp.h>
+
+#include <fstream>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// WorkloadRecorder writes a compact binary log of the per frame workload, the camera matrices, DatabasePager requests and merges, and dynamic data transfers,
+    /// so that the frames can be replayed with WorkloadPlayer to reproduce the paging and compile behavior of a session, such as in the vsg_frame_benchmark harness.
+    /// Assign to a Viewer after compile() using Viewer::assignWorkloadRecorder(..) so the DatabasePagers and TransferTasks log to it.
+    class VSG_DECLSPEC WorkloadRecorder : public Inherit<Object, WorkloadRecorder>
+    {
+    public:
+        explicit WorkloadRecorder(const Path& in_filename, const std::vector<ref_ptr<Camera>>& in_cameras = {});
+
+        /// format of the stream, a header of magic and version followed by records each starting with a uint8_t RecordType
+        static constexpr uint32_t magic = 0x57475356; // "VSGW"
+        static constexpr uint32_t version = 1;
+
+        enum RecordType : uint8_t
+        {
+            FRAME = 0,         ///< uint64_t frameCount, double time in seconds since the first frame
+            CAMERA = 1,        ///< uint32_t camera index, dmat4 projection matrix, dmat4 view matrix
+            PAGER_REQUEST = 2, ///< uint64_t frameCount, double priority, uint32_t length and filename characters
+            PAGER_MERGE = 3,   ///< uint64_t frameCount, uint32_t length and filename characters
+            DYNAMIC_DATA = 4   ///< uint64_t frameCount, uint64_t number of bytes transferred
+        };
+
+        const Path filename;
+
+        /// cameras to record the view and projection matrices of on each frame
+        std::vector<ref_ptr<Camera>> cameras;
+
+        /// return true if the file was opened successfully and no write has failed
+        bool valid() const;
+
+        /// record the start of a frame and the matrices of the cameras, called by Viewer::recordAndSubmit()
+        void frame(const FrameStamp& frameStamp);
+
+        /// record a PagedLOD high res subgraph request, called by DatabasePager::request()
+        void pagerRequest(uint64_t frameCount, const Path& plodFilename, double priority);
+
+        /// record a merge of a PagedLOD high res subgraph, called by DatabasePager::updateSceneGraph()
+        void pagerMerge(uint64_t frameCount, const Path& plodFilename);
+
+        /// record the bytes of dynamic data transferred to the device, called by TransferTask::transferDynamicData()
+        void dynamicData(uint64_t size);
+
+        /// flush and close the file
+        void close();
+
+    protected:
+        virtual ~WorkloadRecorder();
+
+        mutable std::mutex _mutex;
+        std::ofstream _fout;
+        uint64_t _frameCount = 0;
+        bool _firstFrame = true;
+        clock::time_point _startTime;
+    };
+    VSG_type_name(vsg::WorkloadRecorder);
+
+} // namespace vsg
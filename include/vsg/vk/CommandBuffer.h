@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/core/ScratchMemory.h>
+#include <vsg/maths/mat4.h>
 #include <vsg/state/PipelineLayout.h>
 #include <vsg/vk/CommandPool.h>
 
@@ -21,6 +22,8 @@ namespace vsg
 
     // forward declare
     class ViewDependentState;
+    class CommandPoolRing;
+    class StateCommand;
 
     /// CommandBuffer encapsulates VkCommandBuffer
     class VSG_DECLSPEC CommandBuffer : public Inherit<Object, CommandBuffer>
@@ -51,7 +54,12 @@ namespace vsg
 
         void setCurrentPipelineLayout(const PipelineLayout* pipelineLayout)
         {
-            _currentPipelineLayout = pipelineLayout->vk(deviceID);
+            auto layout = pipelineLayout->vk(deviceID);
+
+            // descriptor sets and push constants bound with a different pipeline layout may be disturbed, so they have to be recorded again
+            if (layout != _currentPipelineLayout) resetRecordedState();
+
+            _currentPipelineLayout = layout;
             if (pipelineLayout->pushConstantRanges.empty())
                 _currentPushConstantStageFlags = 0;
             else
@@ -63,8 +71,64 @@ namespace vsg
 
         ref_ptr<ScratchMemory> scratchMemory;
 
+        /// StateCommands last recorded by vsg::State for each slot, used to skip recording StateCommands that are already bound.
+        std::vector<const StateCommand*> recordedStateCommands;
+
+        /// projection and modelview matrices last pushed by vsg::State, indexed by push constant offset / 64.
+        mat4 recordedMatrices[2];
+        uint32_t recordedMatricesMask = 0;
+
+        struct RecordStatistics
+        {
+            uint64_t stateCommandsRecorded = 0;
+            uint64_t stateCommandsSkipped = 0;
+            uint64_t matricesPushed = 0;
+            uint64_t matricesSkipped = 0;
+
+            uint64_t draws = 0;               ///< vkCmdDraw and vkCmdDrawIndexed calls
+            uint64_t indirectDraws = 0;       ///< indirect and mesh task draw calls, the number of draws they issue is only known to the GPU
+            uint64_t vertices = 0;            ///< vertices and indices of the direct draws multiplied by their instance counts
+            uint64_t dispatches = 0;          ///< vkCmdDispatch calls
+            uint64_t pipelinesBound = 0;      ///< vkCmdBindPipeline calls
+            uint64_t descriptorSetsBound = 0; ///< DescriptorSets bound by vkCmdBindDescriptorSets calls
+            uint64_t pushConstants = 0;       ///< vkCmdPushConstants calls made by PushConstants commands
+
+            RecordStatistics& operator+=(const RecordStatistics& rhs)
+            {
+                stateCommandsRecorded += rhs.stateCommandsRecorded;
+                stateCommandsSkipped += rhs.stateCommandsSkipped;
+                matricesPushed += rhs.matricesPushed;
+                matricesSkipped += rhs.matricesSkipped;
+                draws += rhs.draws;
+                indirectDraws += rhs.indirectDraws;
+                vertices += rhs.vertices;
+                dispatches += rhs.dispatches;
+                pipelinesBound += rhs.pipelinesBound;
+                descriptorSetsBound += rhs.descriptorSetsBound;
+                pushConstants += rhs.pushConstants;
+                return *this;
+            }
+        };
+
+        /// number of commands recorded by type, and StateCommands and matrices recorded and skipped by vsg::State, since the CommandBuffer was last reset.
+        RecordStatistics recordStatistics;
+
+        /// forget the state recorded so that it's all recorded again, call when the bound state is no longer known such as after vkCmdExecuteCommands.
+        void resetRecordedState()
+        {
+            recordedStateCommands.clear();
+            recordedMatricesMask = 0;
+        }
+
+        /// forget the StateCommand recorded for the specified slot, call when a StateCommand is recorded outside of vsg::State.
+        void resetRecordedStateCommand(uint32_t slot)
+        {
+            if (slot < recordedStateCommands.size()) recordedStateCommands[slot] = nullptr;
+        }
+
     protected:
         friend CommandPool;
+        friend CommandPoolRing;
         CommandBuffer(CommandPool* commandPool, VkCommandBuffer commandBuffer, VkCommandBufferLevel level);
 
         virtual ~CommandBuffer();
@@ -0,0 +1,59 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/vk/CommandBuffer.h>
+
+namespace vsg
+{
+
+    /// CommandPoolRing provides CommandBuffers from a ring of per frame CommandPools, with each frame's CommandPool reset as a whole with vkResetCommandPool
+    /// rather than resetting CommandBuffers individually, and the CommandBuffers it allocated retained for reuse by subsequent frames.
+    /// A CommandPoolRing may be shared by all the CommandGraphs that record on the same thread, but must not be used by more than one thread at a time.
+    class VSG_DECLSPEC CommandPoolRing : public Inherit<Object, CommandPoolRing>
+    {
+    public:
+        CommandPoolRing(Device* in_device, uint32_t in_queueFamilyIndex);
+
+        const ref_ptr<Device> device;
+        const uint32_t queueFamilyIndex;
+
+        /// advance to the next frame, reusing the oldest frame's CommandPool once none of its CommandBuffers have pending submissions, otherwise adding a new frame to the ring.
+        void advance();
+
+        /// return a CommandBuffer from the current frame's CommandPool ready for vkBeginCommandBuffer
+        ref_ptr<CommandBuffer> allocate(VkCommandBufferLevel level);
+
+        /// number of frames in the ring
+        size_t numFrames() const { return _frames.size(); }
+
+    protected:
+        virtual ~CommandPoolRing();
+
+        struct Frame
+        {
+            ref_ptr<CommandPool> commandPool;
+            CommandBuffers primaryCommandBuffers;
+            CommandBuffers secondaryCommandBuffers;
+            size_t numPrimaryUsed = 0;
+            size_t numSecondaryUsed = 0;
+
+            bool available() const;
+        };
+
+        std::vector<Frame> _frames;
+        size_t _currentFrame = 0;
+    };
+    VSG_type_name(vsg::CommandPoolRing);
+
+} // namespace vsg
@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <deque>
+#include <functional>
 #include <memory>
 
 #include <vsg/commands/Command.h>
@@ -21,15 +22,22 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/ScratchMemory.h>
 #include <vsg/nodes/Group.h>
 #include <vsg/state/BufferInfo.h>
+#include <vsg/state/ComputePipeline.h>
 #include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/GraphicsPipelineLibrary.h>
 #include <vsg/state/ImageInfo.h>
+#include <vsg/threading/OperationThreads.h>
 #include <vsg/utils/Instrumentation.h>
 #include <vsg/utils/ShaderCompiler.h>
 #include <vsg/vk/CommandPool.h>
+#include <vsg/vk/DescriptorHeap.h>
 #include <vsg/vk/DescriptorPool.h>
 #include <vsg/vk/Fence.h>
 #include <vsg/vk/MemoryBufferPools.h>
+#include <vsg/vk/PipelineCache.h>
 #include <vsg/vk/ResourceRequirements.h>
+#include <vsg/vk/StagingRingBuffer.h>
+#include <vsg/vk/StateCache.h>
 
 namespace vsg
 {
@@ -92,7 +100,7 @@ namespace vsg
         /// get the maxSets and descriptorPoolSizes to use
         void getDescriptorPoolSizesToUse(uint32_t& maxSets, DescriptorPoolSizes& descriptorPoolSizes);
 
-        /// allocate or reuse a DescriptorSet::Implementation from the available DescriptorPool
+        /// allocate or reuse a DescriptorSet::Implementation from the available DescriptorPool, or from the DescriptorHeap when the Device has VK_EXT_descriptor_buffer enabled
         ref_ptr<DescriptorSet::Implementation> allocateDescriptorSet(DescriptorSetLayout* descriptorSetLayout);
 
         /// reserve resources that may be needed during compile traversal.
@@ -101,6 +109,12 @@ namespace vsg
         // used by GraphicsPipeline.cpp
         ref_ptr<RenderPass> renderPass;
 
+        /// when true GraphicsPipeline.cpp uses renderPass as a description of the attachment formats for VkPipelineRenderingCreateInfo, in place of the VkRenderPass, for use with dynamic rendering.
+        bool dynamicRendering = false;
+
+        /// when true, along with dynamicRendering, GraphicsPipelines are created to be compatible with the RenderGraph's fragment shading rate attachment.
+        bool fragmentShadingRateAttachment = false;
+
         // pipeline states that are usually not set in a scene, e.g.,
         // the viewport state, but might be set for some uses
         GraphicsPipelineStates defaultPipelineStates;
@@ -116,9 +130,42 @@ namespace vsg
         // DescriptorPool
         std::list<ref_ptr<DescriptorPool>> descriptorPools;
 
+        /// DescriptorHeap used in place of descriptorPools when the Device has VK_EXT_descriptor_buffer enabled, assigned on first use from DescriptorHeap::getOrCreate(device)
+        ref_ptr<DescriptorHeap> descriptorHeap;
+
         // ShaderCompiler
         ref_ptr<ShaderCompiler> shaderCompiler;
 
+        /// optional PipelineCache to pass to vkCreate*Pipelines calls, must be created for the same Device as the Context
+        ref_ptr<PipelineCache> pipelineCache;
+
+        /// GraphicsPipelineLibrary used to create GraphicsPipelines from shared pipeline library parts when the Device has VK_EXT_graphics_pipeline_library enabled, assigned from GraphicsPipelineLibrary::getOrCreate(device)
+        ref_ptr<GraphicsPipelineLibrary> graphicsPipelineLibrary;
+
+        /// StateCache used to share the Vulkan implementations of objects with the same state, assigned from StateCache::getOrCreate(device), reset to disable sharing
+        ref_ptr<StateCache> stateCache;
+
+        /// optional OperationThreads used to create pipelines in parallel, when assigned pipeline creation is deferred till compileDeferred() is called.
+        ref_ptr<OperationThreads> operationThreads;
+
+        /// defer creation of the pipeline till compileDeferred() is called, the current Context state is captured for use when creating the pipeline.
+        /// return false if no operationThreads are assigned, in which case the caller should compile the pipeline directly.
+        bool deferCompile(ref_ptr<GraphicsPipeline> pipeline);
+        bool deferCompile(ref_ptr<ComputePipeline> pipeline);
+
+        /// create all deferred pipelines, using operationThreads to create them in parallel, returns once all pipelines have been created.
+        /// When asynchronousPipelineCompile is true the GraphicsPipelines are instead created in the background and compileDeferred() returns without waiting for them.
+        void compileDeferred();
+
+        /// when true deferred GraphicsPipelines are created in the background, while a GraphicsPipeline is pending BindGraphicsPipeline binds its fallbackPipeline,
+        /// or if no fallbackPipeline is assigned the subgraph the pipeline is bound in is skipped by RecordTraversal, so new subgraphs can be merged without waiting for their pipelines.
+        bool asynchronousPipelineCompile = false;
+
+        using DeferredPipelines = std::map<ref_ptr<Object>, std::vector<ref_ptr<Context>>>;
+
+        /// pipelines waiting to be created by compileDeferred(), along with the Context state to create each one with
+        DeferredPipelines deferredPipelines;
+
         /// Hook for assigning Instrumentation to enable profiling
         ref_ptr<Instrumentation> instrumentation;
 
@@ -147,9 +194,40 @@ namespace vsg
         ref_ptr<MemoryBufferPools> deviceMemoryBufferPools;
         ref_ptr<MemoryBufferPools> stagingMemoryBufferPools;
 
+        /// StagingRingBuffer shared by all Contexts of the device, staging memory is allocated from it in preference to the stagingMemoryBufferPools
+        ref_ptr<StagingRingBuffer> stagingRingBuffer;
+
+        /// when the device has a large device local, host visible memory heap, as with resizable BAR or unified memory, buffer data is written
+        /// directly to buffers allocated from hostVisibleDeviceMemoryBufferPools without staging. Set to null to always stage buffer uploads.
+        ref_ptr<MemoryBufferPools> hostVisibleDeviceMemoryBufferPools;
+
+        /// reserve size bytes of staging memory and call write with a pointer to the mapped memory to fill it in, returns the staging BufferInfo for copy commands to use.
+        /// Staging memory from the stagingRingBuffer is released by waitForCompletion().
+        ref_ptr<BufferInfo> writeToStagingBuffer(VkDeviceSize size, VkDeviceSize alignment, const std::function<void(void* ptr)>& write);
+
         // RTX ray tracing
         VkDeviceSize scratchBufferSize;
         std::vector<ref_ptr<BuildAccelerationStructureCommand>> buildAccelerationStructureCommands;
+
+    protected:
+        ref_ptr<Context> _getOrCreateDeferredState();
+
+        /// create pipelines in parallel using threads, returns once all pipelines have been created
+        void _compilePipelines(DeferredPipelines& pipelines, ref_ptr<OperationThreads> threads);
+
+        /// compile the GLSL, PipelineLayouts and ShaderModules of the pipelines and size the GraphicsPipelines' per view implementation containers,
+        /// so that _createPipelines(..) only reads the objects that may be shared with pipelines compiled by other threads.
+        void _preparePipelines(DeferredPipelines& pipelines, ref_ptr<OperationThreads> threads);
+
+        /// create the pipelines prepared by _preparePipelines(..) in parallel using threads, returns once all pipelines have been created
+        void _createPipelines(DeferredPipelines& pipelines, ref_ptr<OperationThreads> threads);
+
+        ref_ptr<Context> _deferredState;
+
+        /// release the staging memory allocated from the stagingRingBuffer for the last submission
+        void _releaseStagingAllocations();
+
+        std::vector<StagingRingBuffer::Allocation> _stagingAllocations;
     };
     VSG_type_name(vsg::Context);
 
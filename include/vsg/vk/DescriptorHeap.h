@@ -0,0 +1,77 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+#include <vsg/core/MemorySlots.h>
+#include <vsg/state/Buffer.h>
+
+namespace vsg
+{
+
+    // forward declare
+    class CommandBuffer;
+    class DescriptorSetLayout;
+
+    /// DescriptorHeap manages a host visible VK_EXT_descriptor_buffer buffer that DescriptorSets are suballocated from and have their descriptors written directly into.
+    /// Used by Context::allocateDescriptorSet() in place of DescriptorPool when the Device has been created with VK_EXT_descriptor_buffer enabled, see WindowTraits::descriptorBuffer.
+    /// A single DescriptorHeap is shared by all the Contexts associated with a Device so that all the DescriptorSets are accessible from one vkCmdBindDescriptorBuffersEXT binding.
+    class VSG_DECLSPEC DescriptorHeap : public Inherit<Object, DescriptorHeap>
+    {
+    public:
+        DescriptorHeap(Device* in_device, VkDeviceSize in_size);
+
+        const VkDeviceSize size;
+        const VkBufferUsageFlags usage;
+
+        /// return true if the Device has been created with VK_EXT_descriptor_buffer enabled, in which case DescriptorSetLayouts and pipelines are created for use with DescriptorHeap.
+        static bool supported(const Device* device) { return device && device->getExtensions()->vkGetDescriptorEXT != nullptr; }
+
+        /// return the DescriptorHeap shared by all users of the device, creating one of the specified size if none is currently active.
+        static ref_ptr<DescriptorHeap> getOrCreate(Device* device, VkDeviceSize size = 16 * 1024 * 1024);
+
+        /// reserve space for a DescriptorSet using the specified compiled layout, returns {true, offset} on success.
+        MemorySlots::OptionalOffset reserve(const DescriptorSetLayout* descriptorSetLayout, VkDeviceSize& setSize);
+
+        /// release space previously reserved by reserve()
+        void release(VkDeviceSize offset, VkDeviceSize setSize);
+
+        /// write descriptors into the DescriptorSet at specified offset, VkWriteDescriptorSet::dstSet is ignored.
+        void write(const DescriptorSetLayout* descriptorSetLayout, VkDeviceSize offset, uint32_t descriptorWriteCount, const VkWriteDescriptorSet* descriptorWrites);
+
+        /// record vkCmdBindDescriptorBuffersEXT for the heap's buffer and vkCmdSetDescriptorBufferOffsetsEXT for the specified descriptor sets offsets.
+        void bind(CommandBuffer& commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t setCount, const VkDeviceSize* offsets) const;
+
+        const VkPhysicalDeviceDescriptorBufferPropertiesEXT& getProperties() const { return _properties; }
+
+        size_t totalAvailableSize() const;
+        size_t totalReservedSize() const;
+
+        Device* getDevice() { return _device; }
+        const Device* getDevice() const { return _device; }
+
+    protected:
+        virtual ~DescriptorHeap();
+
+        size_t _descriptorSize(VkDescriptorType descriptorType) const;
+
+        ref_ptr<Device> _device;
+        ref_ptr<Buffer> _buffer;
+        VkDeviceAddress _address = 0;
+        uint8_t* _mappedData = nullptr;
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT _properties;
+
+        mutable std::mutex _mutex;
+        MemorySlots _memorySlots;
+    };
+    VSG_type_name(vsg::DescriptorHeap);
+
+} // namespace vsg
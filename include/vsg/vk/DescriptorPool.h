@@ -21,7 +21,10 @@ namespace vsg
     class VSG_DECLSPEC DescriptorPool : public Inherit<Object, DescriptorPool>
     {
     public:
-        DescriptorPool(Device* device, uint32_t maxSets, const DescriptorPoolSizes& descriptorPoolSizes);
+        DescriptorPool(Device* device, uint32_t maxSets, const DescriptorPoolSizes& descriptorPoolSizes, VkDescriptorPoolCreateFlags in_flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+
+        /// VkDescriptorPoolCreateInfo::flags, pools created with VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT are required for DescriptorSetLayouts using VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT
+        const VkDescriptorPoolCreateFlags flags;
 
         operator VkDescriptorPool() const { return _descriptorPool; }
         VkDescriptorPool vk() const { return _descriptorPool; }
@@ -16,6 +16,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/vk/DeviceFeatures.h>
 #include <vsg/vk/Queue.h>
 
+#include <array>
+#include <atomic>
 #include <list>
 
 namespace vsg
@@ -82,6 +84,9 @@ namespace vsg
         /// return true if Device was created with specified extension
         bool supportsDeviceExtension(const char* extensionName) const;
 
+        /// return the total size of the DeviceMemory currently allocated from the specified memory heap
+        VkDeviceSize allocatedMemory(uint32_t heapIndex) const { return heapIndex < VK_MAX_MEMORY_HEAPS ? _allocatedMemory[heapIndex].load() : 0; }
+
     protected:
         virtual ~Device();
 
@@ -93,6 +98,9 @@ namespace vsg
         ref_ptr<DeviceExtensions> _extensions;
 
         Queues _queues;
+
+        friend class DeviceMemory;
+        std::array<std::atomic<VkDeviceSize>, VK_MAX_MEMORY_HEAPS> _allocatedMemory{};
     };
     VSG_type_name(vsg::Device);
 
@@ -28,15 +28,28 @@ namespace vsg
         // VK_EXT_host_query_reset / Vulkan-1.2
         PFN_vkResetQueryPoolEXT vkResetQueryPool = nullptr;
 
+        // VK_KHR_descriptor_update_template / Vulkan-1.1
+        PFN_vkCreateDescriptorUpdateTemplateKHR vkCreateDescriptorUpdateTemplate = nullptr;
+        PFN_vkDestroyDescriptorUpdateTemplateKHR vkDestroyDescriptorUpdateTemplate = nullptr;
+        PFN_vkUpdateDescriptorSetWithTemplateKHR vkUpdateDescriptorSetWithTemplate = nullptr;
+
+        // VK_KHR_push_descriptor
+        PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSetKHR = nullptr;
+
         // VK_KHR_create_renderpass2
         PFN_vkCreateRenderPass2KHR_Compatibility vkCreateRenderPass2 = nullptr;
 
+        // VK_KHR_draw_indirect_count / Vulkan-1.2
+        PFN_vkCmdDrawIndexedIndirectCount_Compatibility vkCmdDrawIndexedIndirectCount = nullptr;
+
         // VK_KHR_ray_tracing
         PFN_vkCreateAccelerationStructureKHR vkCreateAccelerationStructureKHR = nullptr;
         PFN_vkDestroyAccelerationStructureKHR vkDestroyAccelerationStructureKHR = nullptr;
         PFN_vkGetAccelerationStructureDeviceAddressKHR vkGetAccelerationStructureDeviceAddressKHR = nullptr;
         PFN_vkGetAccelerationStructureBuildSizesKHR vkGetAccelerationStructureBuildSizesKHR = nullptr;
         PFN_vkCmdBuildAccelerationStructuresKHR vkCmdBuildAccelerationStructuresKHR = nullptr;
+        PFN_vkCmdCopyAccelerationStructureKHR vkCmdCopyAccelerationStructureKHR = nullptr;
+        PFN_vkCmdWriteAccelerationStructuresPropertiesKHR vkCmdWriteAccelerationStructuresPropertiesKHR = nullptr;
         PFN_vkCreateRayTracingPipelinesKHR vkCreateRayTracingPipelinesKHR = nullptr;
         PFN_vkGetRayTracingShaderGroupHandlesKHR vkGetRayTracingShaderGroupHandlesKHR = nullptr;
         PFN_vkCmdTraceRaysKHR vkCmdTraceRaysKHR = nullptr;
@@ -47,6 +60,63 @@ namespace vsg
         PFN_vkCmdDrawMeshTasksEXT vkCmdDrawMeshTasksEXT = nullptr;
         PFN_vkCmdDrawMeshTasksIndirectEXT vkCmdDrawMeshTasksIndirectEXT = nullptr;
         PFN_vkCmdDrawMeshTasksIndirectCountEXT vkCmdDrawMeshTasksIndirectCountEXT = nullptr;
+
+        // VK_EXT_conditional_rendering
+        PFN_vkCmdBeginConditionalRenderingEXT vkCmdBeginConditionalRenderingEXT = nullptr;
+        PFN_vkCmdEndConditionalRenderingEXT vkCmdEndConditionalRenderingEXT = nullptr;
+
+        // VK_KHR_timeline_semaphore / Vulkan-1.2
+        PFN_vkGetSemaphoreCounterValue vkGetSemaphoreCounterValue = nullptr;
+        PFN_vkWaitSemaphores vkWaitSemaphores = nullptr;
+        PFN_vkSignalSemaphore vkSignalSemaphore = nullptr;
+
+        // VK_KHR_present_wait
+        PFN_vkWaitForPresentKHR vkWaitForPresentKHR = nullptr;
+
+        // VK_KHR_external_memory_fd
+        PFN_vkGetMemoryFdKHR vkGetMemoryFdKHR = nullptr;
+        PFN_vkGetMemoryFdPropertiesKHR vkGetMemoryFdPropertiesKHR = nullptr;
+
+        // VK_KHR_external_semaphore_fd
+        PFN_vkGetSemaphoreFdKHR vkGetSemaphoreFdKHR = nullptr;
+        PFN_vkImportSemaphoreFdKHR vkImportSemaphoreFdKHR = nullptr;
+
+        // VK_KHR_dynamic_rendering / Vulkan-1.3
+        PFN_vkCmdBeginRenderingKHR vkCmdBeginRendering = nullptr;
+        PFN_vkCmdEndRenderingKHR vkCmdEndRendering = nullptr;
+
+        // VK_KHR_fragment_shading_rate
+        PFN_vkCmdSetFragmentShadingRateKHR vkCmdSetFragmentShadingRateKHR = nullptr;
+
+        // VK_EXT_descriptor_buffer
+        PFN_vkGetDescriptorSetLayoutSizeEXT vkGetDescriptorSetLayoutSizeEXT = nullptr;
+        PFN_vkGetDescriptorSetLayoutBindingOffsetEXT vkGetDescriptorSetLayoutBindingOffsetEXT = nullptr;
+        PFN_vkGetDescriptorEXT vkGetDescriptorEXT = nullptr;
+        PFN_vkCmdBindDescriptorBuffersEXT vkCmdBindDescriptorBuffersEXT = nullptr;
+        PFN_vkCmdSetDescriptorBufferOffsetsEXT vkCmdSetDescriptorBufferOffsetsEXT = nullptr;
+
+        // VK_EXT_extended_dynamic_state / Vulkan-1.3
+        PFN_vkCmdSetCullModeEXT vkCmdSetCullMode = nullptr;
+        PFN_vkCmdSetFrontFaceEXT vkCmdSetFrontFace = nullptr;
+        PFN_vkCmdSetPrimitiveTopologyEXT vkCmdSetPrimitiveTopology = nullptr;
+        PFN_vkCmdSetDepthTestEnableEXT vkCmdSetDepthTestEnable = nullptr;
+        PFN_vkCmdSetDepthWriteEnableEXT vkCmdSetDepthWriteEnable = nullptr;
+        PFN_vkCmdSetDepthCompareOpEXT vkCmdSetDepthCompareOp = nullptr;
+        PFN_vkCmdSetDepthBoundsTestEnableEXT vkCmdSetDepthBoundsTestEnable = nullptr;
+        PFN_vkCmdSetStencilTestEnableEXT vkCmdSetStencilTestEnable = nullptr;
+        PFN_vkCmdSetStencilOpEXT vkCmdSetStencilOp = nullptr;
+
+        // VK_EXT_extended_dynamic_state2 / Vulkan-1.3
+        PFN_vkCmdSetRasterizerDiscardEnableEXT vkCmdSetRasterizerDiscardEnable = nullptr;
+        PFN_vkCmdSetDepthBiasEnableEXT vkCmdSetDepthBiasEnable = nullptr;
+        PFN_vkCmdSetPrimitiveRestartEnableEXT vkCmdSetPrimitiveRestartEnable = nullptr;
+
+        // VK_EXT_extended_dynamic_state3
+        PFN_vkCmdSetDepthClampEnableEXT vkCmdSetDepthClampEnableEXT = nullptr;
+        PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT = nullptr;
+        PFN_vkCmdSetColorBlendEnableEXT vkCmdSetColorBlendEnableEXT = nullptr;
+        PFN_vkCmdSetColorBlendEquationEXT vkCmdSetColorBlendEquationEXT = nullptr;
+        PFN_vkCmdSetColorWriteMaskEXT vkCmdSetColorWriteMaskEXT = nullptr;
     };
     VSG_type_name(vsg::DeviceExtensions);
 
@@ -41,6 +41,7 @@ namespace vsg
 
         const VkMemoryRequirements& getMemoryRequirements() const { return _memoryRequirements; }
         const VkMemoryPropertyFlags& getMemoryPropertyFlags() const { return _properties; }
+        uint32_t getHeapIndex() const { return _heapIndex; }
 
         MemorySlots::OptionalOffset reserve(VkDeviceSize size);
         void release(VkDeviceSize offset, VkDeviceSize size);
@@ -53,12 +54,20 @@ namespace vsg
         Device* getDevice() { return _device; }
         const Device* getDevice() const { return _device; }
 
+        /// return a POSIX file descriptor, owned by the caller, referring to the memory, or -1 on failure.
+        /// The memory must have been allocated with a VkExportMemoryAllocateInfo that includes handleType, and VK_KHR_external_memory_fd enabled on the Device.
+        int exportFd(VkExternalMemoryHandleTypeFlagBits handleType) const;
+
+        /// return a Win32 HANDLE referring to the memory, or nullptr on failure or when not built for Windows. Requires VK_KHR_external_memory_win32 enabled on the Device.
+        void* exportWin32Handle(VkExternalMemoryHandleTypeFlagBits handleType) const;
+
     protected:
         virtual ~DeviceMemory();
 
         VkDeviceMemory _deviceMemory;
         VkMemoryRequirements _memoryRequirements;
         VkMemoryPropertyFlags _properties;
+        uint32_t _heapIndex = 0;
         ref_ptr<Device> _device;
 
         mutable std::mutex _mutex;
@@ -66,6 +75,22 @@ namespace vsg
     };
     VSG_type_name(vsg::DeviceMemory);
 
+    /// allocate DeviceMemory that can be exported with the specified handle types to share with other APIs and processes.
+    /// When dedicatedImage or dedicatedBuffer are assigned the memory is a dedicated allocation for it, as usually required by importers such as CUDA and VA-API.
+    extern VSG_DECLSPEC ref_ptr<DeviceMemory> createExportableDeviceMemory(Device* device, const VkMemoryRequirements& memRequirements, VkMemoryPropertyFlags properties, VkExternalMemoryHandleTypeFlags handleTypes,
+                                                                           VkImage dedicatedImage = VK_NULL_HANDLE, VkBuffer dedicatedBuffer = VK_NULL_HANDLE);
+
+    /// allocate DeviceMemory that imports the memory referred to by a POSIX file descriptor, such as an opaque fd from CUDA or a dma-buf from a capture device. Requires VK_KHR_external_memory_fd,
+    /// plus VK_EXT_external_memory_dma_buf for dma-bufs. On success ownership of fd passes to the Vulkan implementation, on failure an Exception is thrown and the caller retains it.
+    /// memRequirements.size should be the size of the exported allocation, memory exported as a dedicated allocation must be imported with the matching dedicatedImage or dedicatedBuffer.
+    extern VSG_DECLSPEC ref_ptr<DeviceMemory> importDeviceMemory(Device* device, const VkMemoryRequirements& memRequirements, VkMemoryPropertyFlags properties, VkExternalMemoryHandleTypeFlagBits handleType, int fd,
+                                                                 VkImage dedicatedImage = VK_NULL_HANDLE, VkBuffer dedicatedBuffer = VK_NULL_HANDLE);
+
+    /// allocate DeviceMemory that imports the memory referred to by a Win32 HANDLE, requires VK_KHR_external_memory_win32. The handle remains owned by the caller.
+    /// Throws an Exception on failure or when not built for Windows.
+    extern VSG_DECLSPEC ref_ptr<DeviceMemory> importDeviceMemoryWin32(Device* device, const VkMemoryRequirements& memRequirements, VkMemoryPropertyFlags properties, VkExternalMemoryHandleTypeFlagBits handleType, void* handle,
+                                                                      VkImage dedicatedImage = VK_NULL_HANDLE, VkBuffer dedicatedBuffer = VK_NULL_HANDLE);
+
     template<class T>
     class MappedData : public T
     {
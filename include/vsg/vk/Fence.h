@@ -13,7 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/vk/CommandBuffer.h>
-#include <vsg/vk/Semaphore.h>
+#include <vsg/vk/TimelineSemaphore.h>
 
 namespace vsg
 {
@@ -29,9 +29,15 @@ namespace vsg
 
         VkResult wait(uint64_t timeout) const;
 
-        VkResult reset() const;
+        VkResult reset();
 
-        VkResult status() const { return vkGetFenceStatus(*_device, _vkFence); }
+        VkResult status() const;
+
+        /// assign a timeline semaphore value to wait on in place of the VkFence, used when submissions signal a Queue::timeline rather than the Fence.
+        /// The assignment is cleared by reset().
+        void assignTimelineValue(ref_ptr<TimelineSemaphore> timeline, uint64_t value);
+
+        bool hasTimelineValue() const { return _timeline.valid(); }
 
         bool hasDependencies() const { return (_dependentSemaphores.size() + _dependentCommandBuffers.size()) > 0; }
 
@@ -50,6 +56,9 @@ namespace vsg
         Semaphores _dependentSemaphores;
         CommandBuffers _dependentCommandBuffers;
 
+        ref_ptr<TimelineSemaphore> _timeline;
+        uint64_t _timelineValue = 0;
+
         ref_ptr<Device> _device;
     };
     VSG_type_name(vsg::Fence);
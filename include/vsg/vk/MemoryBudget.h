@@ -0,0 +1,72 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/vk/Device.h>
+
+#include <ostream>
+#include <vector>
+
+namespace vsg
+{
+
+    /// MemoryBudget tracks the per heap memory budget and usage of a Device.
+    /// If the Device was created with the VK_EXT_memory_budget extension enabled the budget and usage reported by the driver are used,
+    /// these take account of memory used by other processes. Otherwise the budget falls back to fallbackBudgetRatio of each heap's size
+    /// and the usage to the DeviceMemory that the VSG has allocated from each heap.
+    class VSG_DECLSPEC MemoryBudget : public Inherit<Object, MemoryBudget>
+    {
+    public:
+        explicit MemoryBudget(ref_ptr<Device> in_device);
+
+        struct Heap
+        {
+            VkMemoryHeapFlags flags = 0;
+            VkDeviceSize size = 0;
+            VkDeviceSize budget = 0;
+            VkDeviceSize usage = 0;
+            VkDeviceSize allocated = 0;
+        };
+
+        ref_ptr<Device> device;
+
+        /// true if the VK_EXT_memory_budget extension is enabled on the device
+        bool memoryBudgetSupported = false;
+
+        /// proportion of heap size to use as the budget when VK_EXT_memory_budget isn't supported
+        double fallbackBudgetRatio = 0.8;
+
+        /// budget and usage of each memory heap, as collected by the last update()
+        std::vector<Heap> heaps;
+
+        /// query the budget and usage for each heap, note the driver only updates the values it reports once per frame.
+        virtual void update();
+
+        /// return the summed usage/budget ratio of heaps with all the specified flags, returns 0.0 if no heaps match
+        double usageRatio(VkMemoryHeapFlags heapFlags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) const;
+
+        /// return the summed budget of heaps with all the specified flags
+        VkDeviceSize budget(VkMemoryHeapFlags heapFlags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) const;
+
+        /// return the summed usage of heaps with all the specified flags
+        VkDeviceSize usage(VkMemoryHeapFlags heapFlags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) const;
+
+        /// write the last collected budget and usage of each heap to stream
+        void report(std::ostream& out) const;
+
+    protected:
+        virtual ~MemoryBudget();
+    };
+    VSG_type_name(vsg::MemoryBudget);
+
+} // namespace vsg
@@ -44,6 +44,15 @@ namespace vsg
         using DeviceMemoryOffset = std::pair<ref_ptr<DeviceMemory>, VkDeviceSize>;
         DeviceMemoryOffset reserveMemory(VkMemoryRequirements memRequirements, VkMemoryPropertyFlags memoryProperties, void* pNextAllocInfo = nullptr);
 
+        /// remove Buffers and DeviceMemory without any reservations from the pools so that they are deleted once nothing else references them.
+        /// Returns the total size of the Buffers and DeviceMemory removed.
+        VkDeviceSize releaseUnused();
+
+        /// return true if the device has a device local, host visible and host coherent memory type whose heap is larger than minimumHeapSize,
+        /// as with resizable BAR or unified memory, so buffer data can be written directly to device local memory without staging.
+        /// The default minimumHeapSize excludes the 256MB PCI BAR window available without resizable BAR.
+        static bool supportsHostVisibleDeviceLocalMemory(Device* device, VkDeviceSize minimumHeapSize = VkDeviceSize(256) * 1024 * 1024);
+
     protected:
         mutable std::mutex _mutex;
 
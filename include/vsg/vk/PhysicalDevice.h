@@ -15,6 +15,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/observer_ptr.h>
 #include <vsg/vk/Surface.h>
 
+#include <mutex>
+
 namespace vsg
 {
     /// PhysicalDevice encapsulates VkPhysicalDevice
@@ -72,9 +74,16 @@ namespace vsg
             return properties;
         }
 
+        /// get the memory properties using vkGetPhysicalDeviceMemoryProperties2 with pNext chained to it, such as VkPhysicalDeviceMemoryBudgetPropertiesEXT.
+        /// Returns false, filling in just the memoryProperties, if vkGetPhysicalDeviceMemoryProperties2 isn't available.
+        bool getMemoryProperties(VkPhysicalDeviceMemoryProperties& memoryProperties, void* pNext = nullptr) const;
+
         /// Call vkEnumerateDeviceExtensionProperties to enumerate extension properties.
         ExtensionProperties enumerateDeviceExtensionProperties(const char* pLayerName = nullptr);
 
+        /// return the extension properties of the physicalDevice, enumerated on the first call and cached for subsequent calls.
+        const ExtensionProperties& getExtensionProperties();
+
         /// return true if the extension is supported by physicalDevice
         bool supportsDeviceExtension(const char* extensionName);
 
@@ -94,8 +103,13 @@ namespace vsg
 
         PFN_vkGetPhysicalDeviceFeatures2 _vkGetPhysicalDeviceFeatures2 = nullptr;
         PFN_vkGetPhysicalDeviceProperties2 _vkGetPhysicalDeviceProperties2 = nullptr;
+        PFN_vkGetPhysicalDeviceMemoryProperties2 _vkGetPhysicalDeviceMemoryProperties2 = nullptr;
 
         vsg::observer_ptr<Instance> _instance;
+
+        std::mutex _extensionPropertiesMutex;
+        bool _extensionPropertiesEnumerated = false;
+        ExtensionProperties _extensionProperties;
     };
     VSG_type_name(vsg::PhysicalDevice);
 
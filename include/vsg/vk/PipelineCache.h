@@ -0,0 +1,72 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2018 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/io/Path.h>
+#include <vsg/vk/Device.h>
+
+namespace vsg
+{
+    // forward declare
+    class Options;
+
+    /// PipelineCache encapsulates VkPipelineCache, used to speed up creation of graphics, compute and ray tracing pipelines.
+    /// The contents of the cache can be written to disk and read back in on later runs to avoid the driver recompiling pipelines.
+    class VSG_DECLSPEC PipelineCache : public Inherit<Object, PipelineCache>
+    {
+    public:
+        /// create PipelineCache, if initialData is compatible with the device it's used to seed the cache
+        explicit PipelineCache(Device* device, ref_ptr<ubyteArray> initialData = {});
+
+        /// create PipelineCache, seeding it with the contents of filename if it exists and is compatible with the device
+        PipelineCache(Device* device, const Path& in_filename);
+
+        operator VkPipelineCache() const { return _pipelineCache; }
+        VkPipelineCache vk() const { return _pipelineCache; }
+
+        Device* getDevice() { return _device; }
+        const Device* getDevice() const { return _device; }
+
+        /// filename used by write()
+        Path filename;
+
+        /// get the current contents of the cache via vkGetPipelineCacheData
+        ref_ptr<ubyteArray> getData() const;
+
+        /// write the contents of the cache to file, return true on success
+        bool write(const Path& filename) const;
+
+        /// write the contents of the cache to PipelineCache::filename, return true on success
+        bool write() const { return write(filename); }
+
+        /// return true if the data has a VkPipelineCacheHeaderVersionOne header that matches the device's vendorID, deviceID and pipelineCacheUUID
+        static bool compatible(const Device* device, const ubyteArray* data);
+
+        /// return a filename unique to the device's pipelineCacheUUID and driverVersion, located in the options->fileCache directory.
+        /// returns an empty Path if no options->fileCache is assigned.
+        static Path cacheFilename(const Device* device, const Options* options);
+
+    protected:
+        virtual ~PipelineCache();
+
+        void _create(const ubyteArray* initialData);
+
+        VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
+        ref_ptr<Device> _device;
+    };
+    VSG_type_name(vsg::PipelineCache);
+
+    using PipelineCaches = std::vector<ref_ptr<PipelineCache>>;
+
+} // namespace vsg
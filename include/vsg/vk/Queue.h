@@ -22,6 +22,7 @@ namespace vsg
 {
     // forward declare
     class Fence;
+    class TimelineSemaphore;
 
     /// Queue encapsulates a single vkQueue, used to submit vulkan commands for processing.
     class VSG_DECLSPEC Queue : public Inherit<Object, Queue>
@@ -38,6 +39,14 @@ namespace vsg
 
         VkResult submit(const VkSubmitInfo& submitInfo, Fence* fence = nullptr);
 
+        /// submit, signalling the Queue's timeline semaphore with its next value that is returned in signalValue.
+        /// waitValues are the values to wait on for each of submitInfo.pWaitSemaphores that is a timeline semaphore, entries for binary semaphores are ignored.
+        /// signalValues are the values to signal for each of submitInfo.pSignalSemaphores that is a timeline semaphore, entries for binary semaphores are ignored.
+        VkResult submit(const VkSubmitInfo& submitInfo, const std::vector<uint64_t>& waitValues, uint64_t& signalValue, const std::vector<uint64_t>& signalValues = {});
+
+        /// optional timeline semaphore signalled by submissions to this queue, when assigned RecordAndSubmitTask and TransferTask use it in place of Fences and per frame binary Semaphores.
+        ref_ptr<TimelineSemaphore> timeline;
+
         VkResult present(const VkPresentInfoKHR& info);
 
         VkResult waitIdle();
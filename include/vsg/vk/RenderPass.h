@@ -78,6 +78,11 @@ namespace vsg
         VkResolveModeFlagBits depthResolveMode = VK_RESOLVE_MODE_NONE;
         VkResolveModeFlagBits stencilResolveMode = VK_RESOLVE_MODE_NONE;
         std::vector<AttachmentReference> depthStencilResolveAttachments;
+
+        /// maps to VkFragmentShadingRateAttachmentInfoKHR, requires VK_KHR_fragment_shading_rate.
+        /// The attachment is a VK_FORMAT_R8_UINT image with each texel giving the shading rate of a shadingRateAttachmentTexelSize region of the framebuffer.
+        std::vector<AttachmentReference> fragmentShadingRateAttachments;
+        VkExtent2D shadingRateAttachmentTexelSize = {16, 16};
     };
     VSG_type_name(vsg::SubpassDescription);
 
@@ -106,6 +111,9 @@ namespace vsg
         /// Used for deciding if multisampling is required and the value to use when setting up the GraphicsPipeline's vsg::MultisampleState
         const VkSampleCountFlagBits maxSamples;
 
+        /// return the maximum samples of the color and depth/stencil attachments used by the specified subpass, or maxSamples if it has none.
+        VkSampleCountFlagBits subpassSamples(uint32_t subpass) const;
+
     protected:
         virtual ~RenderPass();
 
@@ -123,6 +131,18 @@ namespace vsg
     /// create RenderPass with multisampled color and depth buffers
     extern VSG_DECLSPEC ref_ptr<RenderPass> createMultisampledRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat, VkSampleCountFlagBits samples, bool requiresDepthRead = false);
 
+    /// create RenderPass with color and depth buffers that renders to numViews layers of the attachments in a single subpass with multiview, requires the multiview device feature
+    extern VSG_DECLSPEC ref_ptr<RenderPass> createMultiviewRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat, uint32_t numViews = 2, bool requiresDepthRead = false);
+
+    /// create RenderPass with a depth only subpass 0 that lays down the depth buffer, followed by subpass 1 that shades the color buffer against the read only depth buffer.
+    /// Subpass 1 pipelines should use VK_COMPARE_OP_EQUAL or VK_COMPARE_OP_GREATER_OR_EQUAL depth testing so that each pixel is only shaded once.
+    extern VSG_DECLSPEC ref_ptr<RenderPass> createDepthPrePassRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat, bool requiresDepthRead = false);
+
+    /// create RenderPass that renders to an hdrFormat color buffer and depth buffer in subpass 0, then in subpass 1 reads the hdr color buffer as an input attachment and writes the tone mapped result to the imageFormat color buffer.
+    /// Attachments are ordered color, hdr color and depth, the hdr color and depth buffers aren't stored so can be transient, lazily allocated attachments that stay on chip on tile based GPUs.
+    /// When samples is greater than 1 subpass 0 renders to a multisampled hdr color buffer, appended as a 4th attachment, with multisampled depth and resolves to the hdr color buffer at the end of the subpass.
+    extern VSG_DECLSPEC ref_ptr<RenderPass> createToneMapRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat, VkFormat hdrFormat = VK_FORMAT_R16G16B16A16_SFLOAT, VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
+
     /// create RenderPass with color buffers
     extern VSG_DECLSPEC ref_ptr<RenderPass> createRenderPass(Device* device, VkFormat imageFormat);
 
@@ -81,6 +81,13 @@ namespace vsg
         Views views;
         ViewDetailStack viewDetailsStack;
 
+        /// BufferInfo and Image referenced by the subgraph, used to compute its memory footprint once compiled
+        std::set<const BufferInfo*> bufferInfos;
+        std::set<const Image*> images;
+
+        /// CPU memory in bytes of the Data referenced by the bufferInfos and images
+        VkDeviceSize dataSize = 0;
+
         uint32_t maxSlot = 0;
         uint32_t externalNumDescriptorSets = 0;
         bool containsPagedLOD = false;
@@ -91,6 +98,8 @@ namespace vsg
         uivec2 numLightsRange = {8, 1024};
         uivec2 numShadowMapsRange = {0, 64};
         uivec2 shadowMapSize = {2048, 2048};
+
+        Options::ReleaseDataHint releaseDataHint = Options::KEEP_DATA;
     };
     VSG_type_name(vsg::ResourceRequirements);
 
@@ -35,6 +35,20 @@ namespace vsg
         Device* getDevice() { return _device; }
         const Device* getDevice() const { return _device; }
 
+        /// return a POSIX file descriptor, owned by the caller, referring to the semaphore's payload, or -1 on failure.
+        /// The Semaphore must have been created exportable, see createExportableSemaphore(), and VK_KHR_external_semaphore_fd enabled on the Device.
+        int exportFd(VkExternalSemaphoreHandleTypeFlagBits handleType) const;
+
+        /// import the payload referred to by a POSIX file descriptor, such as one exported by CUDA, so that submissions can wait on and signal work done by other APIs.
+        /// On success ownership of fd passes to the Vulkan implementation. Requires VK_KHR_external_semaphore_fd enabled on the Device.
+        VkResult importFd(VkExternalSemaphoreHandleTypeFlagBits handleType, int fd, VkSemaphoreImportFlags flags = 0);
+
+        /// return a Win32 HANDLE referring to the semaphore's payload, or nullptr on failure or when not built for Windows. Requires VK_KHR_external_semaphore_win32.
+        void* exportWin32Handle(VkExternalSemaphoreHandleTypeFlagBits handleType) const;
+
+        /// import the payload referred to by a Win32 HANDLE, the handle remains owned by the caller. Requires VK_KHR_external_semaphore_win32.
+        VkResult importWin32Handle(VkExternalSemaphoreHandleTypeFlagBits handleType, void* handle, VkSemaphoreImportFlags flags = 0);
+
     protected:
         virtual ~Semaphore();
 
@@ -47,4 +61,7 @@ namespace vsg
 
     using Semaphores = std::vector<ref_ptr<Semaphore>>;
 
+    /// create a binary Semaphore whose payload can be exported with the specified handle types, for GPU side synchronization with other APIs and processes.
+    extern VSG_DECLSPEC ref_ptr<Semaphore> createExportableSemaphore(Device* device, VkExternalSemaphoreHandleTypeFlags handleTypes, VkPipelineStageFlags pipelineStageFlags = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
 } // namespace vsg
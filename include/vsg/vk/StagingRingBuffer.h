@@ -0,0 +1,83 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/state/BufferInfo.h>
+#include <vsg/vk/Device.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace vsg
+{
+
+    /// StagingRingBuffer is a persistently mapped host visible buffer that staging memory for uploads is allocated from in a ring,
+    /// so that CPU writes to new allocations overlap with the GPU copying from earlier ones without allocating new staging memory.
+    /// Allocation is lock free, allocations are released once the GPU has completed the copies from them and the ring's tail
+    /// advances past released allocations in the order they were allocated.
+    class VSG_DECLSPEC StagingRingBuffer : public Inherit<Object, StagingRingBuffer>
+    {
+    public:
+        StagingRingBuffer(Device* in_device, VkDeviceSize in_size = 64 * 1024 * 1024);
+
+        /// get or create the StagingRingBuffer shared by all the Contexts associated with a Device
+        static ref_ptr<StagingRingBuffer> getOrCreate(Device* device);
+
+        struct Allocation
+        {
+            uint64_t begin = 0;
+            uint64_t end = 0;
+            VkDeviceSize offset = 0;
+            void* data = nullptr;
+
+            explicit operator bool() const noexcept { return data != nullptr; }
+        };
+
+        /// allocate size bytes aligned to alignment, returns an invalid Allocation if the ring doesn't currently have space
+        Allocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+        /// release an allocation once the GPU has completed all the copies from it
+        void release(const Allocation& allocation);
+
+        /// create a BufferInfo for the allocation, releasing the BufferInfo doesn't release the allocation
+        ref_ptr<BufferInfo> bufferInfo(const Allocation& allocation, VkDeviceSize size) const;
+
+        /// number of bytes currently allocated
+        VkDeviceSize used() const { return static_cast<VkDeviceSize>(_head.load() - _tail.load()); }
+
+        VkDeviceSize size() const { return _size; }
+        Buffer* getBuffer() { return _buffer; }
+        const Buffer* getBuffer() const { return _buffer; }
+        Device* getDevice() { return _device; }
+        const Device* getDevice() const { return _device; }
+
+    protected:
+        virtual ~StagingRingBuffer();
+
+        ref_ptr<Device> _device;
+        VkDeviceSize _size = 0;
+        ref_ptr<Buffer> _buffer;
+        ref_ptr<BufferInfo> _rootBufferInfo;
+        uint8_t* _data = nullptr;
+
+        // positions in the ring are monotonically increasing byte counts, the offset within the buffer being the position modulo _size
+        std::atomic_uint64_t _head{0};
+        std::atomic_uint64_t _tail{0};
+
+        std::mutex _releaseMutex;
+        std::map<uint64_t, uint64_t> _released;
+    };
+    VSG_type_name(vsg::StagingRingBuffer);
+
+} // namespace vsg
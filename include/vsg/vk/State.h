@@ -18,9 +18,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/PushConstants.h>
 #include <vsg/vk/CommandBuffer.h>
 
+#include <algorithm>
 #include <array>
+#include <limits>
 #include <map>
 #include <stack>
+#include <vector>
 
 namespace vsg
 {
@@ -35,21 +38,23 @@ namespace vsg
         StateStack() :
             dirty(false) {}
 
-        using Stack = std::stack<ref_ptr<const T>>;
+        /// the stack doesn't take references to the StateCommands, they need to remain referenced while on the stack, as the scene graph does during a traversal,
+        /// which avoids atomic reference count updates on the shared StateCommands for every push and pop.
+        using Stack = std::stack<const T*, std::vector<const T*>>;
         Stack stack;
         bool dirty;
 
         template<class R>
-        inline void push(ref_ptr<R> value)
+        inline void push(const ref_ptr<R>& value)
         {
-            stack.push(value);
+            stack.push(value.get());
             dirty = true;
         }
 
         template<class R>
         inline void push(R* value)
         {
-            stack.push(ref_ptr<const T>(value));
+            stack.push(value);
             dirty = true;
         }
 
@@ -61,11 +66,25 @@ namespace vsg
         size_t size() const { return stack.size(); }
         const T* top() const { return stack.top(); }
 
-        inline void record(CommandBuffer& commandBuffer)
+        inline void record(CommandBuffer& commandBuffer, size_t slot)
         {
             if (dirty)
             {
-                stack.top()->record(commandBuffer);
+                auto command = stack.top();
+                auto& recorded = commandBuffer.recordedStateCommands;
+                if (slot < recorded.size() && recorded[slot] == command)
+                {
+                    // command is already bound on this CommandBuffer
+                    ++commandBuffer.recordStatistics.stateCommandsSkipped;
+                }
+                else
+                {
+                    command->record(commandBuffer);
+
+                    if (slot >= recorded.size()) recorded.resize(slot + 1, nullptr);
+                    recorded[slot] = command;
+                    ++commandBuffer.recordStatistics.stateCommandsRecorded;
+                }
                 dirty = false;
             }
         }
@@ -85,43 +104,71 @@ namespace vsg
 
         using value_type = double;
 
-        std::stack<dmat4> matrixStack;
+        // vector rather than the default deque so the storage is retained between frames
+        std::stack<dmat4, std::vector<dmat4>> matrixStack;
         uint32_t offset = 0;
         bool dirty = false;
 
+        /// when enabled MatrixTransforms beneath the View's matrix are multiplied in float precision, using SIMD when available.
+        /// The modelview matrix is relative to the eye so float precision is sufficient as long as the translations involved are small,
+        /// matrices with translations beyond relativeToEyeFloatLimit, such as those positioning tiles on a whole earth model, are still multiplied in double precision.
+        bool relativeToEyeFloat = false;
+        double relativeToEyeFloatLimit = 1.0e4;
+
+        /// float copy of the matrixStack, maintained when relativeToEyeFloat is enabled
+        std::vector<mat4> floatMatrixStack;
+
         inline void set(const mat4& matrix)
         {
-            matrixStack = {};
+            while (!matrixStack.empty()) matrixStack.pop();
             matrixStack.emplace(matrix);
+            _resetFloat();
             dirty = true;
         }
 
         inline void set(const dmat4& matrix)
         {
-            matrixStack = {};
+            while (!matrixStack.empty()) matrixStack.pop();
             matrixStack.emplace(matrix);
+            _resetFloat();
             dirty = true;
         }
 
         inline void push(const mat4& matrix)
         {
             matrixStack.emplace(matrix);
+            _pushFloat();
             dirty = true;
         }
         inline void push(const dmat4& matrix)
         {
             matrixStack.emplace(matrix);
+            _pushFloat();
             dirty = true;
         }
         inline void push(const Transform& transform)
         {
             matrixStack.emplace(transform.transform(matrixStack.top()));
+            _pushFloat();
             dirty = true;
         }
 
         inline void push(const MatrixTransform& transform)
         {
+            if (relativeToEyeFloat && matrixStack.size() >= 2 && floatMatrixStack.size() == matrixStack.size())
+            {
+                const auto& parent = floatMatrixStack.back();
+                if (_withinFloatLimit(parent[3][0], parent[3][1], parent[3][2]) && _withinFloatLimit(transform.matrix[3][0], transform.matrix[3][1], transform.matrix[3][2]))
+                {
+                    floatMatrixStack.push_back(parent * mat4(transform.matrix));
+                    matrixStack.emplace(floatMatrixStack.back());
+                    dirty = true;
+                    return;
+                }
+            }
+
             matrixStack.emplace(matrixStack.top() * transform.matrix);
+            _pushFloat();
             dirty = true;
         }
 
@@ -130,6 +177,7 @@ namespace vsg
         inline void pop()
         {
             matrixStack.pop();
+            if (!floatMatrixStack.empty()) floatMatrixStack.pop_back();
             dirty = true;
         }
 
@@ -148,10 +196,74 @@ namespace vsg
 
                 // make sure matrix is a float matrix.
                 mat4 newmatrix(matrixStack.top());
+
+                uint32_t index = offset / 64;
+                if ((offset % 64) == 0 && index < 2)
+                {
+                    uint32_t bit = 1u << index;
+                    if ((commandBuffer.recordedMatricesMask & bit) != 0 && commandBuffer.recordedMatrices[index] == newmatrix)
+                    {
+                        // matrix already pushed on this CommandBuffer
+                        ++commandBuffer.recordStatistics.matricesSkipped;
+                        dirty = false;
+                        return;
+                    }
+
+                    commandBuffer.recordedMatrices[index] = newmatrix;
+                    commandBuffer.recordedMatricesMask |= bit;
+                }
+
                 vkCmdPushConstants(commandBuffer, pipeline, stageFlags, offset, sizeof(newmatrix), newmatrix.data());
+                ++commandBuffer.recordStatistics.matricesPushed;
                 dirty = false;
             }
         }
+
+    protected:
+        inline void _resetFloat()
+        {
+            floatMatrixStack.clear();
+            if (relativeToEyeFloat) floatMatrixStack.emplace_back(matrixStack.top());
+        }
+
+        inline void _pushFloat()
+        {
+            if (relativeToEyeFloat) floatMatrixStack.emplace_back(matrixStack.top());
+        }
+
+        template<typename T>
+        inline bool _withinFloatLimit(T x, T y, T z) const
+        {
+            return std::abs(x) < relativeToEyeFloatLimit && std::abs(y) < relativeToEyeFloatLimit && std::abs(z) < relativeToEyeFloatLimit;
+        }
+    };
+
+    /// SphereBatch holds bounding spheres in struct of arrays layout for batch frustum culling with Frustum::intersect(const SphereBatch&, ..)
+    struct SphereBatch
+    {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        std::vector<double> radius;
+
+        template<typename T>
+        void add(const t_sphere<T>& s)
+        {
+            x.push_back(s.center.x);
+            y.push_back(s.center.y);
+            z.push_back(s.center.z);
+            radius.push_back(s.radius);
+        }
+
+        size_t size() const { return x.size(); }
+
+        void clear()
+        {
+            x.clear();
+            y.clear();
+            z.clear();
+            radius.clear();
+        }
     };
 
     /// Frustum used internally by vsg::State to manage view fustum culling during vsg::RecordTraversal
@@ -221,6 +333,73 @@ namespace vsg
                 if (distance(face[5], s.center) < negative_radius) return false;
             return true;
         }
+
+        /// return the smallest distance between the sphere and the frustum planes when it's entirely inside the frustum, otherwise a negative value.
+        /// Distances are in the units of the coordinate frame that the frustum has been transformed into.
+        template<typename T>
+        value_type insideMargin(const t_sphere<T>& s) const
+        {
+            value_type margin = std::numeric_limits<value_type>::max();
+            for (int i = 0; i < POLYTOPE_SIZE; ++i)
+            {
+                margin = std::min(margin, distance(face[i], s.center) / length(face[i].n));
+            }
+            return margin - s.radius;
+        }
+
+        /// test count spheres, stored in struct of arrays layout, against the frustum using SIMD when available.
+        /// Returns a mask with bit i set when sphere i is inside or intersects the frustum, count must not exceed 64.
+        uint64_t intersect(const double* x, const double* y, const double* z, const double* radius, size_t count) const
+        {
+            uint64_t mask = 0;
+            size_t i = 0;
+#if defined(VSG_SIMD_AVX)
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m256d cx = _mm256_loadu_pd(x + i), cy = _mm256_loadu_pd(y + i), cz = _mm256_loadu_pd(z + i);
+                const __m256d negative_radius = _mm256_sub_pd(_mm256_setzero_pd(), _mm256_loadu_pd(radius + i));
+                __m256d inside = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+                for (int f = 0; f < POLYTOPE_SIZE; ++f)
+                {
+                    const auto& pl = face[f];
+                    __m256d d = _mm256_add_pd(_mm256_mul_pd(cx, _mm256_set1_pd(pl[0])), _mm256_set1_pd(pl[3]));
+                    d = _mm256_add_pd(d, _mm256_mul_pd(cy, _mm256_set1_pd(pl[1])));
+                    d = _mm256_add_pd(d, _mm256_mul_pd(cz, _mm256_set1_pd(pl[2])));
+                    inside = _mm256_and_pd(inside, _mm256_cmp_pd(d, negative_radius, _CMP_NLT_UQ));
+                }
+                mask |= static_cast<uint64_t>(_mm256_movemask_pd(inside)) << i;
+            }
+#elif defined(VSG_SIMD_SSE2)
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m128d cx = _mm_loadu_pd(x + i), cy = _mm_loadu_pd(y + i), cz = _mm_loadu_pd(z + i);
+                const __m128d negative_radius = _mm_sub_pd(_mm_setzero_pd(), _mm_loadu_pd(radius + i));
+                __m128d inside = _mm_castsi128_pd(_mm_set1_epi32(-1));
+                for (int f = 0; f < POLYTOPE_SIZE; ++f)
+                {
+                    const auto& pl = face[f];
+                    __m128d d = _mm_add_pd(_mm_mul_pd(cx, _mm_set1_pd(pl[0])), _mm_set1_pd(pl[3]));
+                    d = _mm_add_pd(d, _mm_mul_pd(cy, _mm_set1_pd(pl[1])));
+                    d = _mm_add_pd(d, _mm_mul_pd(cz, _mm_set1_pd(pl[2])));
+                    inside = _mm_and_pd(inside, _mm_cmpnlt_pd(d, negative_radius));
+                }
+                mask |= static_cast<uint64_t>(_mm_movemask_pd(inside)) << i;
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                if (intersect(dsphere(x[i], y[i], z[i], radius[i]))) mask |= uint64_t(1) << i;
+            }
+            return mask;
+        }
+
+        /// test up to 64 spheres from the batch, starting at first, against the frustum. Returns a mask with bit i set when sphere first + i is visible.
+        uint64_t intersect(const SphereBatch& spheres, size_t first = 0, size_t count = 64) const
+        {
+            if (first >= spheres.size()) return 0;
+            count = std::min(count, std::min(spheres.size() - first, size_t(64)));
+            return intersect(spheres.x.data() + first, spheres.y.data() + first, spheres.z.data() + first, spheres.radius.data() + first, count);
+        }
     };
 
     /// vsg::State is used by vsg::RecordTraversal to manage state stacks, projection and modelview matrices and frustum stacks.
@@ -240,7 +419,7 @@ namespace vsg
         Frustum _frustumUnit;
         Frustum _frustumProjected;
 
-        using FrustumStack = std::stack<Frustum>;
+        using FrustumStack = std::stack<Frustum, std::vector<Frustum>>;
         FrustumStack _frustumStack;
 
         bool dirty = true;
@@ -287,9 +466,9 @@ namespace vsg
         {
             if (dirty)
             {
-                for (auto& stateStack : stateStacks)
+                for (size_t slot = 0; slot < stateStacks.size(); ++slot)
                 {
-                    stateStack.record(*_commandBuffer);
+                    stateStacks[slot].record(*_commandBuffer, slot);
                 }
 
                 projectionMatrixStack.record(*_commandBuffer);
@@ -308,6 +487,20 @@ namespace vsg
                 _frustumStack.top().computeLodScale(projectionMatrixStack.top(), modelviewMatrixStack.top());
         }
 
+        /// push a frustum for a subgraph already known to be entirely inside the view frustum, only the LOD scale is computed for the
+        /// current modelview matrix, with the planes set so every bound is treated as inside rather than transformed into the local coordinate frame.
+        inline void pushFrustumInside()
+        {
+            _frustumStack.push(Frustum());
+            auto& frustum = _frustumStack.top();
+            for (auto& face : frustum.face) face.set(0.0, 0.0, 0.0, std::numeric_limits<Frustum::value_type>::max());
+
+            if (inheritViewForLODScaling)
+                frustum.computeLodScale(inheritedProjectionMatrix, inheritedViewTransform * modelviewMatrixStack.top());
+            else
+                frustum.computeLodScale(projectionMatrixStack.top(), modelviewMatrixStack.top());
+        }
+
         inline void applyFrustum()
         {
             _frustumStack.top().set(_frustumProjected, modelviewMatrixStack.top());
@@ -325,13 +518,29 @@ namespace vsg
             return _frustumStack.top().intersect(s);
         }
 
+        /// batch test up to 64 spheres against the current frustum, see Frustum::intersect(const SphereBatch&, ..)
+        uint64_t intersect(const SphereBatch& spheres, size_t first = 0, size_t count = 64) const
+        {
+            return _frustumStack.top().intersect(spheres, first, count);
+        }
+
+        uint64_t intersect(const double* x, const double* y, const double* z, const double* radius, size_t count) const
+        {
+            return _frustumStack.top().intersect(x, y, z, radius, count);
+        }
+
         template<typename T>
         T lodDistance(const t_sphere<T>& s) const
         {
-            const auto& frustum = _frustumStack.top();
-            if (!frustum.intersect(s)) return -1.0;
+            if (!_frustumStack.top().intersect(s)) return -1.0;
+            return lodDistanceWithoutCulling(s);
+        }
 
-            const auto& lodScale = frustum.lodScale;
+        /// return the LOD distance of a sphere that is already known to be within the frustum
+        template<typename T>
+        T lodDistanceWithoutCulling(const t_sphere<T>& s) const
+        {
+            const auto& lodScale = _frustumStack.top().lodScale;
             return std::abs(lodScale[0] * s.x + lodScale[1] * s.y + lodScale[2] * s.z + lodScale[3]);
         }
     };
@@ -0,0 +1,89 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/observer_ptr.h>
+#include <vsg/vk/Device.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace vsg
+{
+
+    /// StateCache shares the Vulkan implementations of Sampler, DescriptorSetLayout, PipelineLayout and GraphicsPipeline objects
+    /// that have the same state, so that independently loaded subgraphs with duplicate state objects reuse existing Vulkan handles.
+    /// Objects are matched by hashing their serialized state, rather than ordering with compare() as SharedObjects does, and unlike
+    /// SharedObjects the scene graph objects themselves aren't replaced. One StateCache is shared by all the Context for a Device,
+    /// assigned to Context::stateCache on construction, the Context::stateCache can be reset to disable sharing.
+    class VSG_DECLSPEC StateCache : public Inherit<Object, StateCache>
+    {
+    public:
+        explicit StateCache(Device* in_device);
+
+        /// return the StateCache for the Device, creating one if none is currently in use.
+        static ref_ptr<StateCache> getOrCreate(Device* device);
+
+        /// return the implementation previously created for an object with the same state as object, otherwise call create() and cache the result.
+        /// Implementations are only shared between objects with the same scope, such as the RenderPass a GraphicsPipeline is created for.
+        /// variant encodes any settings, such as the Context's dynamic rendering settings, that change the implementation created but aren't part of the object's state or scope.
+        /// Implementations are held by observer_ptr so are destroyed once no objects use them.
+        ref_ptr<Object> getOrCreate(const Object& object, const Object* scope, const std::function<ref_ptr<Object>()>& create, uint32_t variant = 0);
+
+        struct Statistics
+        {
+            uint64_t requests = 0;
+            uint64_t hits = 0;
+            uint64_t bytesShared = 0; // serialized size of the state that was shared rather than duplicated, a rough guide to the memory saved
+
+            double hitRate() const { return requests > 0 ? static_cast<double>(hits) / static_cast<double>(requests) : 0.0; }
+        };
+
+        /// return the Statistics of each type of object, keyed by className()
+        std::map<std::string, Statistics> getStatistics() const;
+
+        /// print the Statistics of each type of object
+        void report(std::ostream& out) const;
+
+        /// return the number of cached entries, including entries for implementations that have since been destroyed
+        size_t size() const;
+
+        /// remove entries for implementations that have been destroyed
+        void prune();
+
+        Device* getDevice() { return _device; }
+        const Device* getDevice() const { return _device; }
+
+    protected:
+        virtual ~StateCache();
+
+        void _prune();
+
+        struct Entry
+        {
+            ref_ptr<const Object> scope;
+            observer_ptr<Object> implementation;
+        };
+
+        ref_ptr<Device> _device;
+
+        mutable std::mutex _mutex;
+        std::unordered_map<std::string, Entry> _entries;
+        std::map<std::string, Statistics> _statistics;
+        size_t _pruneSize = 256;
+    };
+    VSG_type_name(vsg::StateCache);
+
+} // namespace vsg
@@ -59,6 +59,9 @@ namespace vsg
         /// call vkAcquireNextImageKHR
         VkResult acquireNextImage(uint64_t timeout, ref_ptr<Semaphore> semaphore, ref_ptr<Fence> fence, uint32_t& imageIndex);
 
+        /// id assigned to the most recent present of this swapchain when VK_KHR_present_id is enabled, 0 if none have been presented.
+        uint64_t presentId = 0;
+
     protected:
         virtual ~Swapchain();
 
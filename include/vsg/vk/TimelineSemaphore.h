@@ -0,0 +1,45 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/vk/Semaphore.h>
+
+namespace vsg
+{
+    /// TimelineSemaphore encapsulates a VkSemaphore of type VK_SEMAPHORE_TYPE_TIMELINE, a monotonically increasing counter that submissions signal and wait on
+    /// and that the CPU can query or wait on directly, requires Vulkan 1.2 or VK_KHR_timeline_semaphore with the timelineSemaphore feature enabled.
+    /// When assigned to Queue::timeline it's signalled by RecordAndSubmitTask and TransferTask submissions in place of Fences and per frame binary Semaphores.
+    class VSG_DECLSPEC TimelineSemaphore : public Inherit<Semaphore, TimelineSemaphore>
+    {
+    public:
+        /// when exportHandleTypes is non zero the payload can be exported with exportFd() or exportWin32Handle(), such as to share with CUDA as an external timeline semaphore.
+        explicit TimelineSemaphore(Device* device, uint64_t initialValue = 0, VkPipelineStageFlags pipelineStageFlags = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VkExternalSemaphoreHandleTypeFlags exportHandleTypes = 0);
+
+        /// return the current value of the counter
+        uint64_t value() const;
+
+        /// wait for the counter to reach value, timeout is in nanoseconds
+        VkResult wait(uint64_t value, uint64_t timeout) const;
+
+        /// signal the counter to value from the host
+        VkResult signal(uint64_t value);
+
+        /// highest value that a submission has been assigned to signal, incremented by Queue::submit(..) while holding the Queue's mutex so values increase in submission order
+        std::atomic_uint64_t submittedValue{0};
+
+    protected:
+        virtual ~TimelineSemaphore();
+    };
+    VSG_type_name(vsg::TimelineSemaphore);
+
+} // namespace vsg
@@ -0,0 +1,482 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/core/Allocator.h>
+#include <vsg/core/MemorySlots.h>
+#include <vsg/core/Version.h>
+#include <vsg/core/observer_ptr.h>
+#include <vsg/core/Visitor.h>
+#include <vsg/io/Options.h>
+#include <vsg/io/VSG.h>
+#include <vsg/maths/transform.h>
+#include <vsg/nodes/Bin.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/state/Sampler.h>
+#include <vsg/threading/Barrier.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/threading/OperationQueue.h>
+#include <vsg/utils/CommandLine.h>
+#include <vsg/utils/SharedObjects.h>
+#include <vsg/vk/State.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+/// vsg_benchmarks runs microbenchmarks of the core hot paths and reports the results as JSON, or CSV with --csv, so they can be compared across versions.
+/// Usage:
+///     vsg_benchmarks [--filter name] [--min-time seconds] [--csv] [-o results.json]
+
+namespace
+{
+    struct Result
+    {
+        std::string name;
+        uint64_t operations = 0;
+        double seconds = 0.0;
+    };
+
+    struct Benchmark
+    {
+        std::string name;
+
+        /// run one batch of the benchmark, returning the number of operations it performed
+        std::function<uint64_t()> run;
+    };
+
+    /// prevent the compiler optimizing away the results of benchmarked code
+    template<typename T>
+    void doNotOptimize(const T& value)
+    {
+        static volatile const void* s_sink = nullptr;
+        s_sink = &value;
+    }
+
+    Result measure(const Benchmark& benchmark, double minTime)
+    {
+        using clock = std::chrono::steady_clock;
+
+        // warm up caches and allocators before measuring
+        benchmark.run();
+
+        Result result;
+        result.name = benchmark.name;
+
+        auto start = clock::now();
+        do
+        {
+            result.operations += benchmark.run();
+            result.seconds = std::chrono::duration<double>(clock::now() - start).count();
+        } while (result.seconds < minTime);
+
+        return result;
+    }
+
+    /// create a quad tree of CullNode, MatrixTransform and Group nodes with plain Node leaves
+    vsg::ref_ptr<vsg::Node> createSceneGraph(uint32_t depth, const vsg::dvec3& center, double radius)
+    {
+        if (depth == 0) return vsg::Node::create();
+
+        auto group = vsg::Group::create();
+        double childRadius = radius * 0.5;
+        for (int i = 0; i < 4; ++i)
+        {
+            vsg::dvec3 childCenter = center + vsg::dvec3((i & 1) ? childRadius : -childRadius, (i & 2) ? childRadius : -childRadius, 0.0);
+            auto transform = vsg::MatrixTransform::create(vsg::translate(childCenter - center));
+            transform->addChild(createSceneGraph(depth - 1, vsg::dvec3(0.0, 0.0, 0.0), childRadius));
+            group->addChild(vsg::CullNode::create(vsg::dsphere(childCenter, childRadius * 1.5), transform));
+        }
+        return group;
+    }
+
+    /// mutex and condition variable Barrier, as vsg::Barrier was implemented before it moved to atomics and ThreadParker, to compare against
+    class MutexBarrier : public vsg::Inherit<vsg::Object, MutexBarrier>
+    {
+    public:
+        explicit MutexBarrier(uint32_t num_threads) :
+            _num_threads(num_threads) {}
+
+        void arrive_and_wait()
+        {
+            std::unique_lock lock(_mutex);
+            if (++_num_arrived == _num_threads)
+            {
+                _num_arrived = 0;
+                ++_phase;
+                _cv.notify_all();
+            }
+            else
+            {
+                auto my_phase = _phase;
+                _cv.wait(lock, [this, my_phase]() { return _phase != my_phase; });
+            }
+        }
+
+    protected:
+        const uint32_t _num_threads;
+        uint32_t _num_arrived = 0;
+        uint32_t _phase = 0;
+        std::mutex _mutex;
+        std::condition_variable _cv;
+    };
+
+    /// mutex and condition variable Latch, as vsg::Latch was implemented before it moved to ThreadParker, to compare against
+    class MutexLatch : public vsg::Inherit<vsg::Object, MutexLatch>
+    {
+    public:
+        explicit MutexLatch(int num) :
+            _count(num) {}
+
+        void count_down()
+        {
+            if (_count.fetch_sub(1) <= 1)
+            {
+                std::unique_lock lock(_mutex);
+                _cv.notify_all();
+            }
+        }
+
+        void wait()
+        {
+            std::unique_lock lock(_mutex);
+            while (_count.load() > 0) _cv.wait(lock);
+        }
+
+    protected:
+        std::atomic_int _count;
+        std::mutex _mutex;
+        std::condition_variable _cv;
+    };
+
+    /// threads repeatedly synchronizing on a Barrier, as the RecordAndSubmitTask and TransferTask threads do each frame
+    template<class B>
+    std::function<uint64_t()> barrierBenchmark(uint32_t numThreads)
+    {
+        return [numThreads]() {
+            const size_t count = 1000;
+            auto barrier = B::create(numThreads);
+            std::vector<std::thread> threads;
+            for (uint32_t t = 1; t < numThreads; ++t)
+            {
+                threads.emplace_back([&]() {
+                    for (size_t i = 0; i < count; ++i) barrier->arrive_and_wait();
+                });
+            }
+            for (size_t i = 0; i < count; ++i) barrier->arrive_and_wait();
+            for (auto& thread : threads) thread.join();
+            return uint64_t(count);
+        };
+    }
+
+    /// hand off from a thread counting down Latches to a thread waiting on them, as the CompileManager and DatabasePager do
+    template<class L>
+    std::function<uint64_t()> latchBenchmark()
+    {
+        return []() {
+            const size_t count = 1000;
+            std::vector<vsg::ref_ptr<L>> latches;
+            latches.reserve(count);
+            for (size_t i = 0; i < count; ++i) latches.push_back(L::create(1));
+            std::thread producer([&]() {
+                for (auto& latch : latches) latch->count_down();
+            });
+            for (auto& latch : latches) latch->wait();
+            producer.join();
+            return uint64_t(count);
+        };
+    }
+
+    /// threads promoting observer_ptr to ref_ptr and releasing them, as the DatabasePager and caches do
+    std::function<uint64_t()> observerPromotionBenchmark(uint32_t numThreads)
+    {
+        return [numThreads]() {
+            const size_t count = 10000;
+            static auto object = vsg::Object::create();
+            static vsg::observer_ptr<vsg::Object> observer(object);
+            auto promote = []() {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    vsg::ref_ptr<vsg::Object> ref = observer;
+                    doNotOptimize(ref);
+                }
+            };
+            std::vector<std::thread> threads;
+            for (uint32_t t = 1; t < numThreads; ++t) threads.emplace_back(promote);
+            promote();
+            for (auto& thread : threads) thread.join();
+            return uint64_t(count) * numThreads;
+        };
+    }
+
+    struct CountNodes : public vsg::Visitor
+    {
+        uint64_t count = 0;
+
+        void apply(vsg::Node& node) override
+        {
+            ++count;
+            node.traverse(*this);
+        }
+    };
+
+    uint64_t countNodes(vsg::Node& node)
+    {
+        CountNodes counter;
+        node.accept(counter);
+        return counter.count;
+    }
+
+    std::vector<Benchmark> createBenchmarks()
+    {
+        std::vector<Benchmark> benchmarks;
+
+        benchmarks.push_back({"Allocator::allocate/deallocate", []() {
+                                  const size_t count = 10000;
+                                  static std::vector<void*> pointers(count);
+                                  for (size_t i = 0; i < count; ++i) pointers[i] = vsg::allocate(16 + (i % 16) * 16, vsg::ALLOCATOR_AFFINITY_OBJECTS);
+                                  for (size_t i = 0; i < count; ++i) vsg::deallocate(pointers[i], 16 + (i % 16) * 16);
+                                  return uint64_t(count);
+                              }});
+
+        benchmarks.push_back({"MemorySlots::reserve/release", []() {
+                                  const size_t count = 1000;
+                                  vsg::MemorySlots memorySlots(size_t(256) * 1024 * 1024);
+                                  std::mt19937 random(1);
+                                  std::vector<std::pair<size_t, size_t>> reserved;
+                                  reserved.reserve(count);
+                                  for (size_t i = 0; i < count; ++i)
+                                  {
+                                      size_t size = 256 + (random() % 65536);
+                                      auto [success, offset] = memorySlots.reserve(size, 256);
+                                      if (success) reserved.emplace_back(offset, size);
+                                  }
+                                  std::shuffle(reserved.begin(), reserved.end(), random);
+                                  for (auto& [offset, size] : reserved) memorySlots.release(offset, size);
+                                  return uint64_t(count);
+                              }});
+
+        benchmarks.push_back({"ref_ptr churn", []() {
+                                  const size_t count = 10000;
+                                  static auto object = vsg::Object::create();
+                                  std::vector<vsg::ref_ptr<vsg::Object>> pointers;
+                                  pointers.reserve(count);
+                                  for (size_t i = 0; i < count; ++i) pointers.push_back(object);
+                                  pointers.clear();
+                                  return uint64_t(count);
+                              }});
+
+        benchmarks.push_back({"ref_ptr create/destroy", []() {
+                                  const size_t count = 10000;
+                                  for (size_t i = 0; i < count; ++i)
+                                  {
+                                      auto node = vsg::Node::create();
+                                      doNotOptimize(node);
+                                  }
+                                  return uint64_t(count);
+                              }});
+
+        benchmarks.push_back({"Visitor dispatch", []() {
+                                  static auto scene = createSceneGraph(6, vsg::dvec3(0.0, 0.0, 0.0), 1000.0);
+                                  CountNodes countNodes;
+                                  scene->accept(countNodes);
+                                  return countNodes.count;
+                              }});
+
+        // no CommandBuffer is assigned, so only the culling and state stack management of the traversal is measured
+        benchmarks.push_back({"RecordTraversal cull", []() {
+                                  static auto scene = createSceneGraph(6, vsg::dvec3(0.0, 0.0, 0.0), 1000.0);
+                                  static auto recordTraversal = vsg::RecordTraversal::create();
+                                  auto state = recordTraversal->getState();
+                                  state->setProjectionAndViewMatrix(vsg::perspective(vsg::radians(60.0), 1.0, 1.0, 10000.0), vsg::lookAt(vsg::dvec3(0.0, -2000.0, 1000.0), vsg::dvec3(0.0, 0.0, 0.0), vsg::dvec3(0.0, 0.0, 1.0)));
+                                  static uint64_t numNodes = countNodes(*scene);
+                                  scene->accept(*recordTraversal);
+                                  return numNodes;
+                              }});
+
+        auto binSort = [](vsg::Bin::SortAlgorithm sortAlgorithm) {
+            return [sortAlgorithm]() {
+                const size_t count = 10000;
+                static auto recordTraversal = vsg::RecordTraversal::create();
+                static std::vector<vsg::ref_ptr<vsg::Node>> nodes;
+                if (nodes.empty())
+                {
+                    for (size_t i = 0; i < count; ++i) nodes.push_back(vsg::Node::create());
+                }
+
+                auto bin = vsg::Bin::create(1, vsg::Bin::DESCENDING);
+                bin->sortAlgorithm = sortAlgorithm;
+
+                auto state = recordTraversal->getState();
+                state->setProjectionAndViewMatrix(vsg::dmat4(), vsg::dmat4());
+
+                std::mt19937 random(1);
+                for (auto& node : nodes) bin->add(state, static_cast<double>(random() % 100000), node);
+                bin->traverse(*recordTraversal);
+                return uint64_t(count);
+            };
+        };
+        benchmarks.push_back({"Bin::traverse std::sort", binSort(vsg::Bin::STD_SORT)});
+        benchmarks.push_back({"Bin::traverse radix sort", binSort(vsg::Bin::RADIX_SORT)});
+
+        benchmarks.push_back({"dmat4 multiply", []() {
+                                  const size_t count = 100000;
+                                  vsg::dmat4 matrix = vsg::rotate(0.1, 0.0, 0.0, 1.0);
+                                  vsg::dmat4 result;
+                                  for (size_t i = 0; i < count; ++i) result = result * matrix;
+                                  doNotOptimize(result);
+                                  return uint64_t(count);
+                              }});
+
+        benchmarks.push_back({"dmat4 inverse", []() {
+                                  const size_t count = 100000;
+                                  vsg::dmat4 matrix = vsg::translate(1.0, 2.0, 3.0) * vsg::rotate(0.1, 0.0, 0.0, 1.0);
+                                  vsg::dmat4 result;
+                                  for (size_t i = 0; i < count; ++i)
+                                  {
+                                      matrix[3][0] += 1.0;
+                                      result = vsg::inverse(matrix);
+                                  }
+                                  doNotOptimize(result);
+                                  return uint64_t(count);
+                              }});
+
+        auto createOptions = []() {
+            auto options = vsg::Options::create();
+            options->extensionHint = ".vsgb";
+            return options;
+        };
+
+        benchmarks.push_back({"BinaryOutput write (nodes)", [createOptions]() {
+                                  static auto scene = createSceneGraph(5, vsg::dvec3(0.0, 0.0, 0.0), 1000.0);
+                                  static auto options = createOptions();
+                                  std::ostringstream stream;
+                                  static uint64_t numNodes = countNodes(*scene);
+                                  vsg::VSG().write(scene, stream, options);
+                                  return numNodes;
+                              }});
+
+        benchmarks.push_back({"BinaryInput read (nodes)", [createOptions]() {
+                                  static auto options = createOptions();
+                                  static std::string contents = [&]() {
+                                      std::ostringstream stream;
+                                      vsg::VSG().write(createSceneGraph(5, vsg::dvec3(0.0, 0.0, 0.0), 1000.0), stream, options);
+                                      return stream.str();
+                                  }();
+                                  static uint64_t numNodes = countNodes(*createSceneGraph(5, vsg::dvec3(0.0, 0.0, 0.0), 1000.0));
+                                  auto object = vsg::VSG().read(reinterpret_cast<const uint8_t*>(contents.data()), contents.size(), options);
+                                  doNotOptimize(object);
+                                  return numNodes;
+                              }});
+
+        benchmarks.push_back({"SharedObjects::share", []() {
+                                  const size_t count = 1000;
+                                  auto sharedObjects = vsg::SharedObjects::create();
+                                  for (size_t i = 0; i < count; ++i)
+                                  {
+                                      auto sampler = vsg::Sampler::create();
+                                      sampler->maxLod = static_cast<float>(i % 16);
+                                      sharedObjects->share(sampler);
+                                  }
+                                  return uint64_t(count);
+                              }});
+
+        benchmarks.push_back({"ThreadSafeQueue add/take", []() {
+                                  const size_t count = 10000;
+                                  auto queue = std::make_shared<vsg::ThreadSafeQueue<vsg::ref_ptr<vsg::Object>>>(vsg::ActivityStatus::create());
+                                  static auto object = vsg::Object::create();
+                                  std::thread producer([&]() {
+                                      for (size_t i = 0; i < count; ++i) queue->add(object);
+                                  });
+                                  for (size_t i = 0; i < count; ++i) doNotOptimize(queue->take_when_available());
+                                  producer.join();
+                                  return uint64_t(count);
+                              }});
+
+        benchmarks.push_back({"observer_ptr promote/release", observerPromotionBenchmark(1)});
+        benchmarks.push_back({"observer_ptr promote/release (4 threads)", observerPromotionBenchmark(4)});
+
+        benchmarks.push_back({"Barrier arrive_and_wait (2 threads)", barrierBenchmark<vsg::Barrier>(2)});
+        benchmarks.push_back({"MutexBarrier arrive_and_wait (2 threads)", barrierBenchmark<MutexBarrier>(2)});
+        benchmarks.push_back({"Barrier arrive_and_wait (4 threads)", barrierBenchmark<vsg::Barrier>(4)});
+        benchmarks.push_back({"MutexBarrier arrive_and_wait (4 threads)", barrierBenchmark<MutexBarrier>(4)});
+        benchmarks.push_back({"Latch count_down/wait", latchBenchmark<vsg::Latch>()});
+        benchmarks.push_back({"MutexLatch count_down/wait", latchBenchmark<MutexLatch>()});
+
+        return benchmarks;
+    }
+
+    void writeJSON(std::ostream& out, const std::vector<Result>& results)
+    {
+        out << "{\n  \"version\": \"" << vsgGetVersionString() << "\",\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            auto& result = results[i];
+            out << (i == 0 ? "\n" : ",\n");
+            out << "    {\"name\": \"" << result.name << "\", \"operations\": " << result.operations << ", \"seconds\": " << result.seconds
+                << ", \"ns_per_operation\": " << (result.seconds * 1e9 / static_cast<double>(result.operations)) << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    void writeCSV(std::ostream& out, const std::vector<Result>& results)
+    {
+        out << "name,operations,seconds,ns_per_operation\n";
+        for (auto& result : results)
+        {
+            out << "\"" << result.name << "\"," << result.operations << "," << result.seconds << "," << (result.seconds * 1e9 / static_cast<double>(result.operations)) << "\n";
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    auto filter = arguments.value(std::string(), "--filter");
+    auto minTime = arguments.value(0.5, "--min-time");
+    bool csv = arguments.read("--csv");
+    auto outputFilename = arguments.value(std::string(), "-o");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::vector<Result> results;
+    for (auto& benchmark : createBenchmarks())
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) continue;
+
+        results.push_back(measure(benchmark, minTime));
+
+        auto& result = results.back();
+        std::cerr << std::left << std::setw(32) << result.name << " " << (result.seconds * 1e9 / static_cast<double>(result.operations)) << " ns/op" << std::endl;
+    }
+
+    std::ofstream fout;
+    if (!outputFilename.empty()) fout.open(outputFilename);
+    std::ostream& out = fout.is_open() ? fout : std::cout;
+
+    if (csv)
+        writeCSV(out, results);
+    else
+        writeJSON(out, results);
+
+    return 0;
+}
@@ -0,0 +1,333 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/all.h>
+
+#include <fstream>
+#include <iostream>
+#include <random>
+
+/// vsg_frame_benchmark renders reproducible synthetic scenes headless, to an offscreen Framebuffer, along a fixed camera path
+/// and reports the CPU time of each stage of the frame and GPU time of each RenderGraph as JSON, so that whole frame performance
+/// can be compared across drivers and library versions without the display compositor affecting the results.
+/// A workload log written by vsg::WorkloadRecorder can be replayed in place of the camera path to reproduce the frames of an application session.
+/// Usage:
+///     vsg_frame_benchmark [--nodes N] [--states M] [--lights K] [--terrain G] [--frames F] [--warmup W] [--width w] [--height h] [-o results.json]
+///                         [--record-workload file.vsgw] [--replay-workload file.vsgw]
+
+namespace
+{
+    struct Settings
+    {
+        uint32_t numNodes = 10000;
+        uint32_t numStates = 16;
+        uint32_t numLights = 4;
+        uint32_t terrainTiles = 0;
+        vsg::Path databaseDirectory = "vsg_frame_benchmark_tiles";
+        double extent = 1000.0;
+    };
+
+    /// create a unique small texture for each state so each state needs its own descriptor set
+    vsg::ref_ptr<vsg::Data> createTexture(uint32_t index)
+    {
+        auto image = vsg::ubvec4Array2D::create(16, 16, vsg::Data::Properties{VK_FORMAT_R8G8B8A8_UNORM});
+        std::mt19937 random(index);
+        for (auto& texel : *image) texel.set(static_cast<uint8_t>(random()), static_cast<uint8_t>(random()), static_cast<uint8_t>(random()), 255);
+        return image;
+    }
+
+    /// create the scene of numNodes boxes spread over the ground plane using numStates unique states, with numLights point lights
+    /// and an optional terrainTiles x terrainTiles paged terrain. The random number generator is seeded so the scene is the same in every run.
+    vsg::ref_ptr<vsg::Node> createScene(const Settings& settings, vsg::ref_ptr<vsg::Options> options)
+    {
+        auto scene = vsg::Group::create();
+
+        auto ambientLight = vsg::AmbientLight::create();
+        ambientLight->intensity = 0.1f;
+        scene->addChild(ambientLight);
+
+        std::mt19937 random(1);
+        std::uniform_real_distribution<double> position(-settings.extent * 0.5, settings.extent * 0.5);
+
+        for (uint32_t i = 0; i < settings.numLights; ++i)
+        {
+            auto pointLight = vsg::PointLight::create();
+            pointLight->position.set(position(random), position(random), settings.extent * 0.1);
+            pointLight->intensity = static_cast<float>(settings.extent * settings.extent * 0.01);
+            scene->addChild(pointLight);
+        }
+
+        auto builder = vsg::Builder::create();
+        builder->options = options;
+
+        std::vector<vsg::StateInfo> states(std::max(settings.numStates, 1u));
+        for (uint32_t i = 0; i < states.size(); ++i) states[i].image = createTexture(i);
+
+        double size = settings.extent / std::sqrt(static_cast<double>(std::max(settings.numNodes, 1u))) * 0.5;
+        for (uint32_t i = 0; i < settings.numNodes; ++i)
+        {
+            vsg::GeometryInfo geomInfo;
+            geomInfo.position.set(static_cast<float>(position(random)), static_cast<float>(position(random)), static_cast<float>(size * 0.5));
+            geomInfo.dx.set(static_cast<float>(size), 0.0f, 0.0f);
+            geomInfo.dy.set(0.0f, static_cast<float>(size), 0.0f);
+            geomInfo.dz.set(0.0f, 0.0f, static_cast<float>(size));
+            geomInfo.cullNode = true;
+            scene->addChild(builder->createBox(geomInfo, states[i % states.size()]));
+        }
+
+        if (settings.terrainTiles > 0)
+        {
+            // build the paged terrain from a grid of height field tiles and write it out so that it's streamed by the DatabasePager
+            auto terrain = vsg::Group::create();
+            double tileSize = settings.extent / static_cast<double>(settings.terrainTiles);
+            for (uint32_t y = 0; y < settings.terrainTiles; ++y)
+            {
+                for (uint32_t x = 0; x < settings.terrainTiles; ++x)
+                {
+                    vsg::GeometryInfo geomInfo;
+                    geomInfo.position.set(static_cast<float>((x + 0.5) * tileSize - settings.extent * 0.5), static_cast<float>((y + 0.5) * tileSize - settings.extent * 0.5), 0.0f);
+                    geomInfo.dx.set(static_cast<float>(tileSize), 0.0f, 0.0f);
+                    geomInfo.dy.set(0.0f, static_cast<float>(tileSize), 0.0f);
+                    terrain->addChild(builder->createHeightField(geomInfo, states[(x + y) % states.size()]));
+                }
+            }
+
+            vsg::BuildPagedLOD buildPagedLOD(settings.databaseDirectory, options);
+            buildPagedLOD.quadtree = true;
+            terrain->accept(buildPagedLOD);
+            if (auto pagedTerrain = buildPagedLOD.build()) scene->addChild(pagedTerrain);
+        }
+
+        return scene;
+    }
+
+    /// fixed camera path that circles the scene, so every run renders the same sequence of views
+    vsg::ref_ptr<vsg::AnimationPath> createCameraPath(double extent, double period)
+    {
+        auto path = vsg::AnimationPath::create();
+        path->mode = vsg::AnimationPath::REPEAT;
+
+        const int numKeyFrames = 16;
+        for (int i = 0; i <= numKeyFrames; ++i)
+        {
+            double angle = 2.0 * vsg::PI * static_cast<double>(i) / static_cast<double>(numKeyFrames);
+            vsg::dvec3 eye(std::sin(angle) * extent * 0.75, -std::cos(angle) * extent * 0.75, extent * 0.25);
+            vsg::dmat4 lookAt = vsg::lookAt(eye, vsg::dvec3(0.0, 0.0, 0.0), vsg::dvec3(0.0, 0.0, 1.0));
+
+            vsg::dvec3 position, scale;
+            vsg::dquat orientation;
+            vsg::decompose(vsg::inverse(lookAt), position, orientation, scale);
+            path->add(period * static_cast<double>(i) / static_cast<double>(numKeyFrames), position, orientation);
+        }
+        return path;
+    }
+
+    vsg::ref_ptr<vsg::ImageView> createAttachment(vsg::Device* device, VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspectMask, uint32_t width, uint32_t height)
+    {
+        auto image = vsg::Image::create();
+        image->imageType = VK_IMAGE_TYPE_2D;
+        image->format = format;
+        image->extent = VkExtent3D{width, height, 1};
+        image->mipLevels = 1;
+        image->arrayLayers = 1;
+        image->samples = VK_SAMPLE_COUNT_1_BIT;
+        image->tiling = VK_IMAGE_TILING_OPTIMAL;
+        image->usage = usage;
+        image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        return vsg::createImageView(device, image, aspectMask);
+    }
+
+    void writeTimings(std::ostream& out, const vsg::Timings& timings, bool last)
+    {
+        out << "    {\"name\": \"" << timings.name << "\", \"count\": " << timings.size() << ", \"average_ms\": " << timings.average()
+            << ", \"p50_ms\": " << timings.percentile(0.5) << ", \"p95_ms\": " << timings.percentile(0.95) << ", \"p99_ms\": " << timings.percentile(0.99) << "}" << (last ? "\n" : ",\n");
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    Settings settings;
+    arguments.read("--nodes", settings.numNodes);
+    arguments.read("--states", settings.numStates);
+    arguments.read("--lights", settings.numLights);
+    arguments.read("--terrain", settings.terrainTiles);
+    arguments.read("--database", settings.databaseDirectory);
+    auto numFrames = arguments.value(1000u, "--frames");
+    auto numWarmupFrames = arguments.value(100u, "--warmup");
+    auto width = arguments.value(1920u, "--width");
+    auto height = arguments.value(1080u, "--height");
+    auto pathPeriod = arguments.value(10.0, "--period");
+    auto outputFilename = arguments.value(std::string(), "-o");
+    auto recordWorkloadFilename = arguments.value(vsg::Path(), "--record-workload");
+    auto replayWorkloadFilename = arguments.value(vsg::Path(), "--replay-workload");
+    bool debugLayer = arguments.read("--debug");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    try
+    {
+        // headless Instance and Device, no surface or swapchain so results aren't affected by the display compositor
+        vsg::Names instanceExtensions;
+        vsg::Names layers;
+        if (debugLayer) layers.push_back("VK_LAYER_KHRONOS_validation");
+
+        auto instance = vsg::Instance::create(instanceExtensions, vsg::validateInstancelayerNames(layers));
+        auto physicalDevice = instance->getPhysicalDevice(VK_QUEUE_GRAPHICS_BIT, {VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU});
+        if (!physicalDevice)
+        {
+            std::cerr << "vsg_frame_benchmark : no suitable PhysicalDevice available." << std::endl;
+            return 1;
+        }
+
+        int queueFamily = physicalDevice->getQueueFamily(VK_QUEUE_GRAPHICS_BIT);
+        vsg::QueueSettings queueSettings{vsg::QueueSetting{queueFamily, {1.0}}};
+        auto device = vsg::Device::create(physicalDevice, queueSettings, vsg::validateInstancelayerNames(layers), vsg::Names{});
+
+        auto options = vsg::Options::create();
+        options->sharedObjects = vsg::SharedObjects::create();
+
+        auto scene = createScene(settings, options);
+
+        // offscreen color and depth attachments
+        VkFormat colorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+        VkFormat depthFormat = VK_FORMAT_D32_SFLOAT;
+        auto colorImageView = createAttachment(device, colorFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_IMAGE_ASPECT_COLOR_BIT, width, height);
+        auto depthImageView = createAttachment(device, depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT, width, height);
+
+        auto renderPass = vsg::createRenderPass(device, colorFormat, depthFormat);
+        auto framebuffer = vsg::Framebuffer::create(renderPass, vsg::ImageViews{colorImageView, depthImageView}, width, height, 1);
+
+        auto lookAt = vsg::LookAt::create(vsg::dvec3(0.0, -settings.extent, settings.extent * 0.25), vsg::dvec3(0.0, 0.0, 0.0), vsg::dvec3(0.0, 0.0, 1.0));
+        auto perspective = vsg::Perspective::create(60.0, static_cast<double>(width) / static_cast<double>(height), settings.extent * 0.001, settings.extent * 4.0);
+        auto camera = vsg::Camera::create(perspective, lookAt, vsg::ViewportState::create(0, 0, width, height));
+
+        auto view = vsg::View::create(camera, scene);
+
+        auto renderGraph = vsg::RenderGraph::create();
+        renderGraph->framebuffer = framebuffer;
+        renderGraph->renderArea.offset = {0, 0};
+        renderGraph->renderArea.extent = {width, height};
+        renderGraph->clearValues.resize(2);
+        renderGraph->clearValues[0].color = {{0.2f, 0.2f, 0.2f, 1.0f}};
+        renderGraph->clearValues[1].depthStencil = VkClearDepthStencilValue{0.0f, 0};
+        renderGraph->addChild(view);
+
+        auto commandGraph = vsg::CommandGraph::create(device, queueFamily);
+        commandGraph->addChild(renderGraph);
+
+        auto viewer = vsg::Viewer::create();
+        viewer->assignRecordAndSubmitTaskAndPresentation({commandGraph});
+
+        auto compileStart = vsg::clock::now();
+        viewer->compile();
+        double compileTime = std::chrono::duration<double, std::milli>(vsg::clock::now() - compileStart).count();
+
+        auto cameraPath = createCameraPath(settings.extent, pathPeriod);
+
+        vsg::ref_ptr<vsg::WorkloadPlayer> workloadPlayer;
+        if (replayWorkloadFilename)
+        {
+            workloadPlayer = vsg::WorkloadPlayer::create(std::vector<vsg::ref_ptr<vsg::Camera>>{camera});
+            if (!workloadPlayer->read(replayWorkloadFilename))
+            {
+                std::cerr << "vsg_frame_benchmark : unable to read workload " << replayWorkloadFilename << std::endl;
+                return 1;
+            }
+            numFrames = std::min(numFrames, static_cast<uint32_t>(workloadPlayer->frames.size()));
+        }
+
+        // fixed time step so every run renders the same views regardless of frame rate
+        double timeStep = pathPeriod / 240.0;
+        uint64_t frameIndex = 0;
+        auto renderFrame = [&]() {
+            if (!viewer->advanceToNextFrame()) return false;
+            if (workloadPlayer)
+            {
+                if (!workloadPlayer->advance()) return false;
+            }
+            else
+            {
+                lookAt->set(cameraPath->computeMatrix(timeStep * static_cast<double>(frameIndex++)));
+            }
+            viewer->handleEvents();
+            viewer->update();
+            viewer->recordAndSubmit();
+            viewer->present();
+            return true;
+        };
+
+        // warm up pipelines, caches and the paged terrain before measuring, when replaying a workload warm up from its first frame
+        for (uint32_t i = 0; i < numWarmupFrames && renderFrame(); ++i)
+        {
+            if (workloadPlayer) workloadPlayer->nextFrame = 0;
+        }
+
+        viewer->deviceWaitIdle();
+        viewer->assignFrameStatistics(vsg::FrameStatistics::create(std::max(numFrames, 1u)));
+
+        vsg::ref_ptr<vsg::WorkloadRecorder> workloadRecorder;
+        if (recordWorkloadFilename)
+        {
+            workloadRecorder = vsg::WorkloadRecorder::create(recordWorkloadFilename, std::vector<vsg::ref_ptr<vsg::Camera>>{camera});
+            viewer->assignWorkloadRecorder(workloadRecorder);
+        }
+
+        auto start = vsg::clock::now();
+        for (uint32_t i = 0; i < numFrames && renderFrame(); ++i) {}
+        viewer->deviceWaitIdle();
+        double totalTime = std::chrono::duration<double, std::milli>(vsg::clock::now() - start).count();
+
+        if (workloadRecorder)
+        {
+            viewer->assignWorkloadRecorder({});
+            workloadRecorder->close();
+        }
+
+        auto memoryBudget = vsg::MemoryBudget::create(device);
+        memoryBudget->update();
+
+        std::ofstream fout;
+        if (!outputFilename.empty()) fout.open(outputFilename);
+        std::ostream& out = fout.is_open() ? fout : std::cout;
+
+        out << "{\n";
+        out << "  \"version\": \"" << vsgGetVersionString() << "\",\n";
+        out << "  \"device\": \"" << physicalDevice->getProperties().deviceName << "\",\n";
+        out << "  \"driver_version\": " << physicalDevice->getProperties().driverVersion << ",\n";
+        out << "  \"scene\": {\"nodes\": " << settings.numNodes << ", \"states\": " << settings.numStates << ", \"lights\": " << settings.numLights << ", \"terrain_tiles\": " << settings.terrainTiles << "},\n";
+        out << "  \"resolution\": [" << width << ", " << height << "],\n";
+        out << "  \"frames\": " << numFrames << ",\n";
+        out << "  \"compile_ms\": " << compileTime << ",\n";
+        out << "  \"total_ms\": " << totalTime << ",\n";
+        out << "  \"memory\": {\"cpu_allocated\": " << vsg::Allocator::instance()->totalMemorySize() << ", \"cpu_reserved\": " << vsg::Allocator::instance()->totalReservedSize()
+            << ", \"device_local_usage\": " << memoryBudget->usage(VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) << ", \"device_local_budget\": " << memoryBudget->budget(VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) << "},\n";
+        if (workloadPlayer)
+        {
+            out << "  \"workload\": {\"filename\": \"" << replayWorkloadFilename << "\", \"frames\": " << workloadPlayer->frames.size() << ", \"pager_requests\": " << workloadPlayer->numPagerRequests()
+                << ", \"pager_merges\": " << workloadPlayer->numPagerMerges() << "},\n";
+        }
+        out << "  \"timings\": [\n";
+        auto timings = viewer->frameStatistics->getTimings();
+        for (size_t i = 0; i < timings.size(); ++i) writeTimings(out, *timings[i], i + 1 == timings.size());
+        out << "  ]\n}\n";
+    }
+    catch (const vsg::Exception& exception)
+    {
+        std::cerr << "vsg_frame_benchmark : " << exception.message << " result = " << exception.result << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
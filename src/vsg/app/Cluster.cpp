@@ -0,0 +1,521 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/Camera.h>
+#include <vsg/app/Cluster.h>
+#include <vsg/app/Viewer.h>
+#include <vsg/io/BinaryInput.h>
+#include <vsg/io/BinaryOutput.h>
+#include <vsg/io/Logger.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/Switch.h>
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+#else
+#    include <netdb.h>
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+using namespace vsg;
+
+namespace
+{
+    // message types, the first byte of each message
+    constexpr char UPDATE_MESSAGE = 'U';
+    constexpr char READY_MESSAGE = 'R';
+    constexpr char PRESENT_MESSAGE = 'P';
+
+    // id marking the end of the changes in an update message
+    constexpr uint32_t END_OF_CHANGES = 0xffffffff;
+
+    constexpr intptr_t INVALID_SOCKET_HANDLE = -1;
+
+#if defined(_WIN32)
+    bool startSockets()
+    {
+        static const bool s_started = []() {
+            WSADATA wsaData;
+            return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+        }();
+        return s_started;
+    }
+
+    void closeSocket(intptr_t s) { closesocket(static_cast<SOCKET>(s)); }
+    using socklen_type = int;
+#else
+    bool startSockets() { return true; }
+    void closeSocket(intptr_t s) { ::close(static_cast<int>(s)); }
+    using socklen_type = socklen_t;
+#endif
+
+    intptr_t toHandle(decltype(::socket(0, 0, 0)) s)
+    {
+#if defined(_WIN32)
+        return (s == INVALID_SOCKET) ? INVALID_SOCKET_HANDLE : static_cast<intptr_t>(s);
+#else
+        return (s < 0) ? INVALID_SOCKET_HANDLE : static_cast<intptr_t>(s);
+#endif
+    }
+
+    void setNoDelay(intptr_t s)
+    {
+        // the swap barrier messages are tiny and latency critical, so don't let them be coalesced
+        int flag = 1;
+        setsockopt(static_cast<decltype(::socket(0, 0, 0))>(s), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&flag), sizeof(flag));
+    }
+
+    bool sendAll(intptr_t s, const char* ptr, size_t size)
+    {
+        while (size > 0)
+        {
+            auto result = ::send(static_cast<decltype(::socket(0, 0, 0))>(s), ptr, static_cast<int>(std::min(size, size_t(1) << 30)), 0);
+            if (result <= 0) return false;
+            ptr += result;
+            size -= static_cast<size_t>(result);
+        }
+        return true;
+    }
+
+    bool receiveAll(intptr_t s, char* ptr, size_t size)
+    {
+        while (size > 0)
+        {
+            auto result = ::recv(static_cast<decltype(::socket(0, 0, 0))>(s), ptr, static_cast<int>(std::min(size, size_t(1) << 30)), 0);
+            if (result <= 0) return false;
+            ptr += result;
+            size -= static_cast<size_t>(result);
+        }
+        return true;
+    }
+
+    struct CollectShared : public Visitor
+    {
+        Cluster& cluster;
+
+        explicit CollectShared(Cluster& in_cluster) :
+            cluster(in_cluster) {}
+
+        void apply(Node& node) override { node.traverse(*this); }
+
+        void apply(MatrixTransform& mt) override
+        {
+            cluster.share(ref_ptr<Object>(&mt));
+            mt.traverse(*this);
+        }
+
+        void apply(Switch& sw) override
+        {
+            cluster.share(ref_ptr<Object>(&sw));
+            sw.traverse(*this);
+        }
+
+        void apply(Camera& camera) override
+        {
+            cluster.share(ref_ptr<Object>(&camera));
+            camera.traverse(*this);
+        }
+    };
+
+    // the LookAt that a slave's camera view can be set through, either the camera's own or one decorated by a RelativeViewMatrix that offsets the slave's view.
+    LookAt* findLookAt(ViewMatrix* viewMatrix)
+    {
+        if (auto lookAt = dynamic_cast<LookAt*>(viewMatrix)) return lookAt;
+        if (auto relative = dynamic_cast<RelativeViewMatrix*>(viewMatrix)) return findLookAt(relative->viewMatrix.get());
+        return nullptr;
+    }
+
+    dmat4 viewOf(const Camera& camera)
+    {
+        if (auto lookAt = findLookAt(camera.viewMatrix.get())) return lookAt->transform();
+        return camera.viewMatrix ? camera.viewMatrix->transform() : dmat4();
+    }
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////
+//
+// TCPConnection
+//
+TCPConnection::TCPConnection(intptr_t in_socket) :
+    _socket(in_socket)
+{
+    setNoDelay(_socket);
+}
+
+TCPConnection::~TCPConnection()
+{
+    if (_socket != INVALID_SOCKET_HANDLE) closeSocket(_socket);
+}
+
+ref_ptr<TCPConnection> TCPConnection::connect(const std::string& host, uint16_t port, double timeout)
+{
+    if (!startSockets()) return {};
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+    {
+        warn("TCPConnection::connect() unable to resolve ", host);
+        return {};
+    }
+
+    // the master may not be listening yet so keep retrying until the timeout
+    auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(timeout));
+    intptr_t connected = INVALID_SOCKET_HANDLE;
+    while (connected == INVALID_SOCKET_HANDLE)
+    {
+        for (auto address = addresses; address && connected == INVALID_SOCKET_HANDLE; address = address->ai_next)
+        {
+            auto s = toHandle(::socket(address->ai_family, address->ai_socktype, address->ai_protocol));
+            if (s == INVALID_SOCKET_HANDLE) continue;
+
+            if (::connect(static_cast<decltype(::socket(0, 0, 0))>(s), address->ai_addr, static_cast<socklen_type>(address->ai_addrlen)) == 0)
+                connected = s;
+            else
+                closeSocket(s);
+        }
+
+        if (connected == INVALID_SOCKET_HANDLE)
+        {
+            if (clock::now() > deadline) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    freeaddrinfo(addresses);
+
+    if (connected == INVALID_SOCKET_HANDLE)
+    {
+        warn("TCPConnection::connect() unable to connect to ", host, ":", port);
+        return {};
+    }
+
+    return ref_ptr<TCPConnection>(new TCPConnection(connected));
+}
+
+std::vector<ref_ptr<ClusterConnection>> TCPConnection::accept(uint16_t port, size_t numConnections)
+{
+    std::vector<ref_ptr<ClusterConnection>> connections;
+    if (!startSockets()) return connections;
+
+    auto listener = toHandle(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    if (listener == INVALID_SOCKET_HANDLE) return connections;
+
+    auto native_listener = static_cast<decltype(::socket(0, 0, 0))>(listener);
+
+    int reuse = 1;
+    setsockopt(native_listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    if (::bind(native_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(native_listener, static_cast<int>(numConnections)) != 0)
+    {
+        warn("TCPConnection::accept() unable to listen on port ", port);
+        closeSocket(listener);
+        return connections;
+    }
+
+    while (connections.size() < numConnections)
+    {
+        auto s = toHandle(::accept(native_listener, nullptr, nullptr));
+        if (s == INVALID_SOCKET_HANDLE) break;
+        connections.push_back(ref_ptr<ClusterConnection>(new TCPConnection(s)));
+    }
+
+    closeSocket(listener);
+    return connections;
+}
+
+bool TCPConnection::send(const std::string& message)
+{
+    uint32_t size = static_cast<uint32_t>(message.size());
+    return sendAll(_socket, reinterpret_cast<const char*>(&size), sizeof(size)) && sendAll(_socket, message.data(), message.size());
+}
+
+bool TCPConnection::receive(std::string& message)
+{
+    uint32_t size = 0;
+    if (!receiveAll(_socket, reinterpret_cast<char*>(&size), sizeof(size))) return false;
+
+    message.resize(size);
+    return receiveAll(_socket, message.data(), size);
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Cluster
+//
+Cluster::Cluster(std::vector<ref_ptr<ClusterConnection>> in_slaves) :
+    slaves(in_slaves)
+{
+}
+
+Cluster::Cluster(ref_ptr<ClusterConnection> in_master) :
+    master(in_master)
+{
+}
+
+Cluster::~Cluster()
+{
+}
+
+void Cluster::share(ref_ptr<Object> object)
+{
+    if (!object) return;
+
+    // snapshot the current state so that only subsequent changes are sent, every node starts with the same scene graph.
+    Shared shared;
+    shared.object = object;
+    if (auto mt = object.cast<MatrixTransform>())
+        shared.matrix = mt->matrix;
+    else if (auto sw = object.cast<Switch>())
+        for (auto& child : sw->children) shared.masks.push_back(child.mask);
+    else if (auto camera = object.cast<Camera>())
+        shared.matrix = viewOf(*camera);
+    else if (auto data = object.cast<Data>())
+        data->getModifiedCount(shared.modifiedCount);
+    else
+        return;
+
+    _shared.push_back(shared);
+}
+
+void Cluster::shareSubgraph(ref_ptr<Node> node)
+{
+    if (!node) return;
+
+    CollectShared collect(*this);
+    node->accept(collect);
+}
+
+bool Cluster::_changed(Shared& shared, Data::ModifiedRanges& ranges)
+{
+    ranges.clear();
+
+    if (auto mt = shared.object.cast<MatrixTransform>())
+    {
+        if (mt->matrix == shared.matrix) return false;
+        shared.matrix = mt->matrix;
+    }
+    else if (auto sw = shared.object.cast<Switch>())
+    {
+        bool changed = sw->children.size() != shared.masks.size();
+        shared.masks.resize(sw->children.size());
+        for (size_t i = 0; i < sw->children.size(); ++i)
+        {
+            if (shared.masks[i] != sw->children[i].mask)
+            {
+                shared.masks[i] = sw->children[i].mask;
+                changed = true;
+            }
+        }
+        if (!changed) return false;
+    }
+    else if (auto camera = shared.object.cast<Camera>())
+    {
+        auto view = viewOf(*camera);
+        if (view == shared.matrix) return false;
+        shared.matrix = view;
+    }
+    else if (auto data = shared.object.cast<Data>())
+    {
+        if (!data->differentModifiedCount(shared.modifiedCount)) return false;
+
+        // send just the modified byte ranges when they are known, otherwise all the data
+        if (!data->getModifiedRanges(shared.modifiedCount, ranges))
+        {
+            ranges.clear();
+            ranges.emplace_back(0, data->dataSize());
+        }
+        data->getModifiedCount(shared.modifiedCount);
+    }
+
+    return true;
+}
+
+void Cluster::_write(const Shared& shared, const Data::ModifiedRanges& ranges, Output& output)
+{
+    if (shared.object.cast<MatrixTransform>() || shared.object.cast<Camera>())
+    {
+        output.write(16, shared.matrix.data());
+    }
+    else if (shared.object.cast<Switch>())
+    {
+        output.writeValue<uint32_t>("numMasks", shared.masks.size());
+        if (!shared.masks.empty()) output.write(shared.masks.size(), shared.masks.data());
+    }
+    else if (auto data = shared.object.cast<Data>())
+    {
+        auto ptr = static_cast<const uint8_t*>(data->dataPointer());
+        output.writeValue<uint32_t>("numRanges", ranges.size());
+        for (auto& [offset, size] : ranges)
+        {
+            output.writeValue<uint64_t>("offset", offset);
+            output.writeValue<uint64_t>("size", size);
+            output.write(size, ptr + offset);
+        }
+    }
+}
+
+bool Cluster::_read(Shared& shared, Input& input)
+{
+    if (auto mt = shared.object.cast<MatrixTransform>())
+    {
+        input.read(16, mt->matrix.data());
+    }
+    else if (auto camera = shared.object.cast<Camera>())
+    {
+        dmat4 view;
+        input.read(16, view.data());
+        if (auto lookAt = findLookAt(camera->viewMatrix.get()))
+            lookAt->set(inverse(view));
+        else
+        {
+            auto newLookAt = LookAt::create();
+            newLookAt->set(inverse(view));
+            camera->viewMatrix = newLookAt;
+        }
+    }
+    else if (auto sw = shared.object.cast<Switch>())
+    {
+        auto numMasks = input.readValue<uint32_t>("numMasks");
+        std::vector<Mask> masks(numMasks);
+        if (numMasks > 0) input.read(masks.size(), masks.data());
+
+        if (masks.size() != sw->children.size()) return false;
+        for (size_t i = 0; i < masks.size(); ++i) sw->children[i].mask = masks[i];
+    }
+    else if (auto data = shared.object.cast<Data>())
+    {
+        auto ptr = static_cast<uint8_t*>(data->dataPointer());
+        auto numRanges = input.readValue<uint32_t>("numRanges");
+        for (uint32_t i = 0; i < numRanges; ++i)
+        {
+            auto offset = input.readValue<uint64_t>("offset");
+            auto size = input.readValue<uint64_t>("size");
+            if (offset + size > data->dataSize()) return false;
+
+            input.read(size, ptr + offset);
+
+            // record the same ranges so that the slave's transfers are no larger than the master's
+            if (offset == 0 && size == data->dataSize())
+                data->dirty();
+            else
+                data->dirty(offset, size);
+        }
+    }
+    return true;
+}
+
+bool Cluster::update(Viewer& viewer)
+{
+    updateSize = 0;
+
+    if (isMaster())
+    {
+        std::ostringstream stream;
+        stream.put(UPDATE_MESSAGE);
+
+        BinaryOutput output(stream);
+        auto frameCount = viewer.getFrameStamp() ? viewer.getFrameStamp()->frameCount : _frameCount;
+        output.writeValue<uint64_t>("frameCount", frameCount);
+
+        Data::ModifiedRanges ranges;
+        for (uint32_t id = 0; id < _shared.size(); ++id)
+        {
+            auto& shared = _shared[id];
+            if (!_changed(shared, ranges)) continue;
+
+            output.writeValue<uint32_t>("id", id);
+            _write(shared, ranges, output);
+        }
+        output.writeValue<uint32_t>("id", END_OF_CHANGES);
+
+        auto message = stream.str();
+        updateSize = message.size();
+
+        bool result = true;
+        for (auto& slave : slaves)
+        {
+            if (!slave->send(message)) result = false;
+        }
+
+        _frameCount = frameCount + 1;
+        return result;
+    }
+
+    std::string message;
+    if (!master->receive(message) || message.empty() || message[0] != UPDATE_MESSAGE) return false;
+    updateSize = message.size();
+
+    std::istringstream stream(message);
+    stream.get();
+
+    BinaryInput input(stream, {});
+    _frameCount = input.readValue<uint64_t>("frameCount");
+
+    for (;;)
+    {
+        auto id = input.readValue<uint32_t>("id");
+        if (!stream || id == END_OF_CHANGES) break;
+
+        if (id >= _shared.size() || !_read(_shared[id], input))
+        {
+            warn("Cluster::update() objects shared by master and slave don't match, check that share() is called in the same order on every node.");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Cluster::swapBarrier()
+{
+    const std::string ready(1, READY_MESSAGE);
+    const std::string present(1, PRESENT_MESSAGE);
+    std::string message;
+
+    if (isMaster())
+    {
+        // wait for every slave to have submitted its frame, then release them all together
+        bool result = true;
+        for (auto& slave : slaves)
+        {
+            if (!slave->receive(message) || message != ready) result = false;
+        }
+        for (auto& slave : slaves)
+        {
+            if (!slave->send(present)) result = false;
+        }
+        return result;
+    }
+
+    return master->send(ready) && master->receive(message) && message == present;
+}
@@ -72,15 +72,100 @@ ref_ptr<RecordTraversal> CommandGraph::getOrCreateRecordTraversal()
     return recordTraversal;
 }
 
+ref_ptr<CommandBuffer> CommandGraph::_availableCommandBuffer()
+{
+    if (commandPoolRing && !reuseCommandBuffers) return commandPoolRing->allocate(level());
+
+    auto retained = [&](const CommandBuffer* cb) {
+        for (auto& rcb : _retainedCommandBuffers)
+        {
+            if (rcb.commandBuffer == cb) return true;
+        }
+        return false;
+    };
+
+    for (auto& cb : _commandBuffers)
+    {
+        if (cb->numDependentSubmissions() == 0 && !retained(cb))
+        {
+            cb->reset();
+            return cb;
+        }
+    }
+
+    ref_ptr<CommandPool> cp = CommandPool::create(device, queueFamily);
+    auto commandBuffer = cp->allocate(level());
+    _commandBuffers.push_back(commandBuffer);
+    return commandBuffer;
+}
+
+ref_ptr<CommandBuffer> CommandGraph::_reusableCommandBuffer(size_t key, uint64_t& signature)
+{
+    if (!reuseCommandBuffers || instrumentation)
+    {
+        _retainedCommandBuffers.clear();
+        return {};
+    }
+
+    if (!_recordSignature) _recordSignature = RecordSignature::create();
+
+    _recordSignature->reset();
+    traverse(*_recordSignature);
+
+    signature = _recordSignature->signature;
+
+    if (!_recordSignature->reusable || _recordRequested)
+    {
+        _recordRequested = false;
+        _retainedCommandBuffers.clear();
+        return {};
+    }
+
+    for (auto& rcb : _retainedCommandBuffers)
+    {
+        if (rcb.key == key && rcb.signature == signature) return rcb.commandBuffer;
+    }
+    return {};
+}
+
+void CommandGraph::_retainCommandBuffer(size_t key, uint64_t signature, ref_ptr<CommandBuffer> commandBuffer)
+{
+    if (!reuseCommandBuffers || instrumentation || !_recordSignature || !_recordSignature->reusable) return;
+
+    for (auto& rcb : _retainedCommandBuffers)
+    {
+        if (rcb.key == key)
+        {
+            // previous CommandBuffer for this key is returned to the available CommandBuffers once its pending submissions complete
+            rcb.signature = signature;
+            rcb.commandBuffer = commandBuffer;
+            return;
+        }
+    }
+    _retainedCommandBuffers.push_back(RetainedCommandBuffer{key, signature, commandBuffer});
+}
+
 void CommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers, ref_ptr<FrameStamp> frameStamp, ref_ptr<DatabasePager> databasePager)
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "CommandGraph record", COLOR_RECORD_L1);
 
+    ScopedTiming timing(frameStatistics ? frameStatistics->recordTimings(this).get() : nullptr);
+
     if (window && !window->visible())
     {
         return;
     }
 
+    // each swapchain image has its own framebuffer so retain a recorded CommandBuffer per image
+    size_t key = window ? window->imageIndex() : 0;
+    uint64_t signature = 0;
+    if (auto reusable = _reusableCommandBuffer(key, signature))
+    {
+        reusable->numDependentSubmissions().fetch_add(1);
+        recordedCommandBuffers->add(submitOrder, reusable);
+        return;
+    }
+
     // create the RecordTraversal if it isn't already created
     getOrCreateRecordTraversal();
 
@@ -94,29 +179,13 @@ void CommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers
     recordTraversal->setDatabasePager(databasePager);
     recordTraversal->clearBins();
 
-    ref_ptr<CommandBuffer> commandBuffer;
-    for (auto& cb : _commandBuffers)
-    {
-        if (cb->numDependentSubmissions() == 0)
-        {
-            commandBuffer = cb;
-            break;
-        }
-    }
-    if (!commandBuffer)
-    {
-        ref_ptr<CommandPool> cp = CommandPool::create(device, queueFamily);
-        commandBuffer = cp->allocate(level());
-        _commandBuffers.push_back(commandBuffer);
-    }
-    else
-    {
-        commandBuffer->reset();
-    }
-
+    auto commandBuffer = _availableCommandBuffer();
     commandBuffer->numDependentSubmissions().fetch_add(1);
 
     recordTraversal->getState()->_commandBuffer = commandBuffer;
+    commandBuffer->resetRecordedState();
+    commandBuffer->recordStatistics = {};
+    recordTraversal->cullStatistics = {};
 
     // or select index when maps to a dormant CommandBuffer
     VkCommandBuffer vk_commandBuffer = *commandBuffer;
@@ -125,11 +194,28 @@ void CommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers
     // if we are nested within a CommandBuffer already then use VkCommandBufferInheritanceInfo
     VkCommandBufferBeginInfo beginInfo = {};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.flags = reuseCommandBuffers ? VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     beginInfo.pInheritanceInfo = nullptr;
 
     vkBeginCommandBuffer(vk_commandBuffer, &beginInfo);
 
+    // timestamps aren't reset when a retained CommandBuffer is resubmitted so only time subgraphs when the CommandBuffer won't be reused
+    if (!gpuTimestamps) gpuTimestamps = GpuTimestamps::create();
+    if (!occlusionQueries) occlusionQueries = OcclusionQueries::create();
+    if (!reuseCommandBuffers && frameStamp)
+    {
+        recordTraversal->gpuTimestamps = gpuTimestamps;
+        gpuTimestamps->beginFrame(*commandBuffer, frameStamp->frameCount);
+
+        recordTraversal->occlusionQueries = occlusionQueries;
+        occlusionQueries->beginFrame(*commandBuffer, frameStamp->frameCount);
+    }
+    else
+    {
+        recordTraversal->gpuTimestamps = {};
+        recordTraversal->occlusionQueries = {};
+    }
+
     {
         COMMAND_BUFFER_INSTRUMENTATION(instrumentation, *commandBuffer, "CommandGraph record", COLOR_RECORD)
         traverse(*recordTraversal);
@@ -137,6 +223,10 @@ void CommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers
 
     vkEndCommandBuffer(vk_commandBuffer);
 
+    if (frameStatistics) frameStatistics->addCounters(commandBuffer->recordStatistics, recordTraversal->cullStatistics);
+
+    _retainCommandBuffer(key, signature, commandBuffer);
+
     recordedCommandBuffers->add(submitOrder, commandBuffer);
 }
 
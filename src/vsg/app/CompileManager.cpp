@@ -25,6 +25,8 @@ void CompileResult::reset()
     result = VK_INCOMPLETE;
     maxSlot = 0;
     containsPagedLOD = false;
+    dataSize = 0;
+    deviceMemorySize = 0;
     views.clear();
     earlyDynamicData.clear();
     lateDynamicData.clear();
@@ -35,6 +37,8 @@ void CompileResult::add(const CompileResult& cr)
     if (result == VK_INCOMPLETE) result = cr.result;
     if (cr.maxSlot > maxSlot) maxSlot = cr.maxSlot;
     if (!containsPagedLOD) containsPagedLOD = cr.containsPagedLOD;
+    dataSize += cr.dataSize;
+    deviceMemorySize += cr.deviceMemorySize;
 
     for (auto& [src_view, src_binDetails] : cr.views)
     {
@@ -161,25 +165,131 @@ void CompileManager::assignInstrumentation(ref_ptr<Instrumentation> in_instrumen
     }
 }
 
+void CompileManager::assignPipelineCache(ref_ptr<PipelineCache> pipelineCache)
+{
+    auto cts = takeCompileTraversals(numCompileTraversals);
+    for (auto& ct : cts)
+    {
+        ct->assignPipelineCache(pipelineCache);
+
+        compileTraversals->add(ct);
+    }
+}
+
+void CompileManager::assignOperationThreads(ref_ptr<OperationThreads> operationThreads)
+{
+    auto cts = takeCompileTraversals(numCompileTraversals);
+    for (auto& ct : cts)
+    {
+        ct->assignOperationThreads(operationThreads);
+
+        compileTraversals->add(ct);
+    }
+}
+
+void CompileManager::assignAsynchronousPipelineCompile(bool asynchronousPipelineCompile)
+{
+    auto cts = takeCompileTraversals(numCompileTraversals);
+    for (auto& ct : cts)
+    {
+        ct->assignAsynchronousPipelineCompile(asynchronousPipelineCompile);
+
+        compileTraversals->add(ct);
+    }
+}
+
 CompileResult CompileManager::compile(ref_ptr<Object> object, ContextSelectionFunction contextSelection)
 {
-    CollectResourceRequirements collectRequirements;
-    object->accept(collectRequirements);
+    if (!batchCompiles || contextSelection) return compile(std::vector<ref_ptr<Object>>{object}, contextSelection).front();
+
+    ref_ptr<CompileRequest> request(new CompileRequest);
+    request->object = object;
+    request->latch = Latch::create(1);
+
+    bool lead = false;
+    {
+        std::scoped_lock<std::mutex> lock(_batchMutex);
+        _pendingRequests.push_back(request);
+        lead = !_batchInProgress;
+        _batchInProgress = true;
+    }
 
-    auto& requirements = collectRequirements.requirements;
-    auto& viewDetailsStack = requirements.viewDetailsStack;
+    if (!lead)
+    {
+        // wait for another thread's batch to compile this request, or for the leading thread to hand over to this one
+        request->latch->wait();
+        if (!request->lead) return request->result;
+    }
 
-    CompileResult result;
-    result.maxSlot = requirements.maxSlot;
-    result.containsPagedLOD = requirements.containsPagedLOD;
-    result.views = requirements.views;
-    result.earlyDynamicData = requirements.earlyDynamicData;
-    result.lateDynamicData = requirements.lateDynamicData;
+    while (!request->completed) _compileBatch();
+
+    // hand over to the next waiting request so no thread is held up compiling other threads' requests indefinitely
+    {
+        std::scoped_lock<std::mutex> lock(_batchMutex);
+        if (_pendingRequests.empty())
+        {
+            _batchInProgress = false;
+        }
+        else
+        {
+            auto& next = _pendingRequests.front();
+            next->lead = true;
+            next->latch->count_down();
+        }
+    }
+
+    return request->result;
+}
+
+void CompileManager::_compileBatch()
+{
+    std::vector<ref_ptr<CompileRequest>> batch;
+    {
+        std::scoped_lock<std::mutex> lock(_batchMutex);
+        auto numToTake = std::min(_pendingRequests.size(), std::max(maxBatchSize, size_t(1)));
+        batch.assign(_pendingRequests.begin(), _pendingRequests.begin() + numToTake);
+        _pendingRequests.erase(_pendingRequests.begin(), _pendingRequests.begin() + numToTake);
+    }
+
+    if (batch.empty()) return;
+
+    std::vector<ref_ptr<Object>> objects;
+    objects.reserve(batch.size());
+    for (auto& request : batch) objects.push_back(request->object);
+
+    auto results = compile(objects);
+
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        batch[i]->result = results[i];
+        batch[i]->completed = true;
+        batch[i]->latch->count_down();
+    }
+}
+
+std::vector<CompileResult> CompileManager::compile(const std::vector<ref_ptr<Object>>& objects, ContextSelectionFunction contextSelection)
+{
+    std::vector<CollectResourceRequirements> collectRequirements(objects.size());
+    std::vector<CompileResult> results(objects.size());
+
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        objects[i]->accept(collectRequirements[i]);
+
+        auto& requirements = collectRequirements[i].requirements;
+        auto& result = results[i];
+        result.maxSlot = requirements.maxSlot;
+        result.containsPagedLOD = requirements.containsPagedLOD;
+        result.views = requirements.views;
+        result.earlyDynamicData = requirements.earlyDynamicData;
+        result.lateDynamicData = requirements.lateDynamicData;
+        result.dataSize = requirements.dataSize;
+    }
 
     auto compileTraversal = compileTraversals->take_when_available();
 
     // if no CompileTraversals are available abort compile
-    if (!compileTraversal) return result;
+    if (!compileTraversal) return results;
 
     auto run_compile_traversal = [&]() -> void {
         try
@@ -188,49 +298,85 @@ CompileResult CompileManager::compile(ref_ptr<Object> object, ContextSelectionFu
             {
                 ref_ptr<View> view = context->view;
 
-                if (view)
+                for (size_t i = 0; i < objects.size(); ++i)
                 {
-                    if (view->viewDependentState)
-                    {
-                        view->viewDependentState->update(requirements);
-                    }
+                    auto& requirements = collectRequirements[i].requirements;
+                    auto& viewDetailsStack = requirements.viewDetailsStack;
+                    auto& result = results[i];
 
-                    if (!viewDetailsStack.empty())
+                    if (view)
                     {
-                        if (auto itr = result.views.find(view.get()); itr == result.views.end())
+                        if (view->viewDependentState)
                         {
-                            result.views[view] = viewDetailsStack.top();
+                            view->viewDependentState->update(requirements);
+                        }
+
+                        if (!viewDetailsStack.empty())
+                        {
+                            if (auto itr = result.views.find(view.get()); itr == result.views.end())
+                            {
+                                result.views[view] = viewDetailsStack.top();
+                            }
                         }
                     }
+                    context->reserve(requirements);
                 }
-                context->reserve(requirements);
             }
 
-            object->accept(*compileTraversal);
+            // all the objects are compiled in to the same Context, so share its staging memory and are transferred in a single submission
+            for (auto& object : objects)
+            {
+                object->accept(*compileTraversal);
+            }
 
             //debug("Finished compile traversal ", object);
 
             compileTraversal->record(); // records and submits to queue
             compileTraversal->waitForCompletion();
+
+            // measure the device memory used, for the first device compiled for
+            if (!compileTraversal->contexts.empty())
+            {
+                auto deviceID = compileTraversal->contexts.front()->deviceID;
+                for (size_t i = 0; i < objects.size(); ++i)
+                {
+                    auto& requirements = collectRequirements[i].requirements;
+                    auto& result = results[i];
+                    for (auto& bufferInfo : requirements.bufferInfos)
+                    {
+                        if (bufferInfo->buffer && bufferInfo->buffer->vk(deviceID)) result.deviceMemorySize += bufferInfo->range;
+                    }
+                    for (auto& image : requirements.images)
+                    {
+                        if (image->vk(deviceID) && image->getDeviceMemory(deviceID)) result.deviceMemorySize += image->getMemoryRequirements(deviceID).size;
+                    }
+                }
+            }
         }
         catch (const vsg::Exception& ve)
         {
             vsg::debug("CompileManager::compile() exception caught : ", ve.message);
-            result.message = ve.message;
-            result.result = ve.result;
+            for (auto& result : results)
+            {
+                result.message = ve.message;
+                result.result = ve.result;
+            }
         }
         catch (...)
         {
             vsg::debug("CompileManager::compile() exception caught");
-            result.message = "Exception occurred during compilation.";
-            result.result = VK_ERROR_UNKNOWN;
+            for (auto& result : results)
+            {
+                result.message = "Exception occurred during compilation.";
+                result.result = VK_ERROR_UNKNOWN;
+            }
         }
 
-        debug("Finished waiting for compile ", object);
+        debug("Finished waiting for compile of ", objects.size(), " objects");
     };
 
     // assume success, overite this on failures.
-    result.result = VK_SUCCESS;
+    for (auto& result : results) result.result = VK_SUCCESS;
 
     if (contextSelection)
     {
@@ -254,5 +400,5 @@ CompileResult CompileManager::compile(ref_ptr<Object> object, ContextSelectionFu
 
     compileTraversals->add(compileTraversal);
 
-    return result;
+    return results;
 }
@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/app/CompileTraversal.h>
 
 #include <vsg/app/CommandGraph.h>
+#include <vsg/app/DepthPrePass.h>
 #include <vsg/app/RenderGraph.h>
 #include <vsg/app/View.h>
 #include <vsg/app/Viewer.h>
@@ -64,6 +65,8 @@ void CompileTraversal::add(ref_ptr<Device> device, const ResourceRequirements& r
     auto queueFamily = device->getPhysicalDevice()->getQueueFamily(queueFlags);
     auto context = Context::create(device, resourceRequirements);
     context->instrumentation = instrumentation;
+    context->operationThreads = operationThreads;
+    context->asynchronousPipelineCompile = asynchronousPipelineCompile;
     context->commandPool = CommandPool::create(device, queueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
     context->graphicsQueue = device->getQueue(queueFamily, queueFamilyIndex);
     contexts.push_back(context);
@@ -76,7 +79,10 @@ void CompileTraversal::add(Window& window, ref_ptr<ViewportState> viewport, cons
     auto queueFamily = device->getPhysicalDevice()->getQueueFamily(queueFlags);
     auto context = Context::create(device, resourceRequirements);
     context->instrumentation = instrumentation;
+    context->operationThreads = operationThreads;
+    context->asynchronousPipelineCompile = asynchronousPipelineCompile;
     context->renderPass = renderPass;
+    context->dynamicRendering = window.traits()->dynamicRendering;
     context->commandPool = CommandPool::create(device, queueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
     context->graphicsQueue = device->getQueue(queueFamily, queueFamilyIndex);
 
@@ -97,7 +103,10 @@ void CompileTraversal::add(Window& window, ref_ptr<View> view, const ResourceReq
     auto queueFamily = device->getPhysicalDevice()->getQueueFamily(queueFlags);
     auto context = Context::create(device, resourceRequirements);
     context->instrumentation = instrumentation;
+    context->operationThreads = operationThreads;
+    context->asynchronousPipelineCompile = asynchronousPipelineCompile;
     context->renderPass = renderPass;
+    context->dynamicRendering = window.traits()->dynamicRendering;
     context->commandPool = vsg::CommandPool::create(device, queueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
     context->graphicsQueue = device->getQueue(queueFamily, queueFamilyIndex);
 
@@ -126,6 +135,8 @@ void CompileTraversal::add(Framebuffer& framebuffer, ref_ptr<View> view, const R
     auto queueFamily = device->getPhysicalDevice()->getQueueFamily(VK_QUEUE_GRAPHICS_BIT);
     auto context = Context::create(device, resourceRequirements);
     context->instrumentation = instrumentation;
+    context->operationThreads = operationThreads;
+    context->asynchronousPipelineCompile = asynchronousPipelineCompile;
     context->renderPass = renderPass;
     context->commandPool = vsg::CommandPool::create(device, queueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
     context->graphicsQueue = device->getQueue(queueFamily, queueFamilyIndex);
@@ -170,10 +181,11 @@ void CompileTraversal::add(const Viewer& viewer, const ResourceRequirements& res
 
         void apply(RenderGraph& rg) override
         {
-            if (rg.window)
-                objectStack.emplace(rg.window);
-            else
+            // RenderGraph::accept() prefers the framebuffer when one is assigned, so compile against its RenderPass
+            if (rg.framebuffer)
                 objectStack.emplace(rg.framebuffer);
+            else
+                objectStack.emplace(rg.window);
 
             rg.traverse(*this);
 
@@ -223,6 +235,34 @@ void CompileTraversal::assignInstrumentation(ref_ptr<Instrumentation> in_instrum
     }
 }
 
+void CompileTraversal::assignPipelineCache(ref_ptr<PipelineCache> pipelineCache)
+{
+    if (!pipelineCache) return;
+
+    for (auto& context : contexts)
+    {
+        if (context->device == pipelineCache->getDevice()) context->pipelineCache = pipelineCache;
+    }
+}
+
+void CompileTraversal::assignOperationThreads(ref_ptr<OperationThreads> in_operationThreads)
+{
+    operationThreads = in_operationThreads;
+    for (auto& context : contexts)
+    {
+        context->operationThreads = operationThreads;
+    }
+}
+
+void CompileTraversal::assignAsynchronousPipelineCompile(bool in_asynchronousPipelineCompile)
+{
+    asynchronousPipelineCompile = in_asynchronousPipelineCompile;
+    for (auto& context : contexts)
+    {
+        context->asynchronousPipelineCompile = asynchronousPipelineCompile;
+    }
+}
+
 void CompileTraversal::apply(Object& object)
 {
     CPU_INSTRUMENTATION_L2_NC(instrumentation, "CompileTraversal Object", COLOR_COMPILE);
@@ -293,7 +333,11 @@ void CompileTraversal::apply(RenderGraph& renderGraph)
 
     for (auto& context : contexts)
     {
+        auto previousDynamicRendering = context->dynamicRendering;
+        auto previousFragmentShadingRateAttachment = context->fragmentShadingRateAttachment;
         context->renderPass = renderGraph.getRenderPass();
+        context->dynamicRendering = renderGraph.dynamicRendering;
+        context->fragmentShadingRateAttachment = renderGraph.fragmentShadingRateAttachment.valid();
 
         // save previous states to be restored after traversal
         auto previousDefaultPipelineStates = context->defaultPipelineStates;
@@ -318,6 +362,8 @@ void CompileTraversal::apply(RenderGraph& renderGraph)
         // restore previous values
         context->defaultPipelineStates = previousDefaultPipelineStates;
         context->overridePipelineStates = previousOverridePipelineStates;
+        context->dynamicRendering = previousDynamicRendering;
+        context->fragmentShadingRateAttachment = previousFragmentShadingRateAttachment;
     }
 }
 
@@ -352,6 +398,8 @@ void CompileTraversal::apply(View& view)
 
         view.traverse(*this);
 
+        if (view.depthPrePass) view.depthPrePass->accept(*this);
+
         // restore previous states
         context->viewID = previous_viewID;
         context->mask = previous_mask;
@@ -369,6 +417,7 @@ bool CompileTraversal::record()
     bool recorded = false;
     for (auto& context : contexts)
     {
+        context->compileDeferred();
         if (context->record()) recorded = true;
     }
     return recorded;
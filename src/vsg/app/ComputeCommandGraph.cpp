@@ -0,0 +1,53 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/ComputeCommandGraph.h>
+#include <vsg/io/Logger.h>
+
+using namespace vsg;
+
+ComputeCommandGraph::ComputeCommandGraph()
+{
+}
+
+ComputeCommandGraph::ComputeCommandGraph(ref_ptr<Device> in_device, int family) :
+    Inherit(in_device, family)
+{
+}
+
+ComputeCommandGraph::ComputeCommandGraph(ref_ptr<Device> in_device, ref_ptr<Node> child)
+{
+    device = in_device;
+
+    // prefer a queue from a compute only family, fallback to any queue supporting compute
+    for (auto& queue : device->getQueues())
+    {
+        auto flags = queue->queueFlags();
+        if ((flags & VK_QUEUE_COMPUTE_BIT) == 0) continue;
+
+        if ((flags & VK_QUEUE_GRAPHICS_BIT) == 0)
+        {
+            queueFamily = static_cast<int>(queue->queueFamilyIndex());
+            break;
+        }
+
+        if (queueFamily < 0) queueFamily = static_cast<int>(queue->queueFamilyIndex());
+    }
+
+    if (queueFamily < 0) warn("ComputeCommandGraph::ComputeCommandGraph(..) no compute queue available.");
+
+    if (child) addChild(child);
+}
+
+ComputeCommandGraph::~ComputeCommandGraph()
+{
+}
@@ -0,0 +1,956 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/DeferredRenderGraph.h>
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/commands/Draw.h>
+#include <vsg/commands/NextSubPass.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/nodes/Light.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DepthStencilState.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/MultisampleState.h>
+#include <vsg/state/RasterizationState.h>
+#include <vsg/state/VertexInputState.h>
+#include <vsg/state/ViewDependentState.h>
+
+using namespace vsg;
+
+namespace
+{
+    const char* deferred_phong_frag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#pragma import_defines (VSG_POINT_SPRITE, VSG_DIFFUSE_MAP, VSG_GREYSCALE_DIFFUSE_MAP, VSG_EMISSIVE_MAP, VSG_LIGHTMAP_MAP, VSG_NORMAL_MAP, VSG_SPECULAR_MAP, VSG_TWO_SIDED_LIGHTING)
+
+#define MATERIAL_DESCRIPTOR_SET 1
+
+#ifdef VSG_DIFFUSE_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 0) uniform sampler2D diffuseMap;
+#endif
+
+#ifdef VSG_NORMAL_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 2) uniform sampler2D normalMap;
+#endif
+
+#ifdef VSG_LIGHTMAP_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 3) uniform sampler2D aoMap;
+#endif
+
+#ifdef VSG_EMISSIVE_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 4) uniform sampler2D emissiveMap;
+#endif
+
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 10) uniform MaterialData
+{
+    vec4 ambientColor;
+    vec4 diffuseColor;
+    vec4 specularColor;
+    vec4 emissiveColor;
+    float shininess;
+    float alphaMask;
+    float alphaMaskCutoff;
+} material;
+
+layout(location = 0) in vec3 eyePos;
+layout(location = 1) in vec3 normalDir;
+layout(location = 2) in vec4 vertexColor;
+#ifndef VSG_POINT_SPRITE
+layout(location = 3) in vec2 texCoord0;
+#endif
+
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec4 outNormal;
+layout(location = 2) out vec4 outMaterial;
+layout(location = 3) out vec4 outEmissive;
+
+vec3 getNormal()
+{
+    vec3 result;
+#if defined(VSG_NORMAL_MAP) && !defined(VSG_POINT_SPRITE)
+    vec3 tangentNormal = texture(normalMap, texCoord0).xyz * 2.0 - 1.0;
+
+    vec3 q1 = dFdx(eyePos);
+    vec3 q2 = dFdy(eyePos);
+    vec2 st1 = dFdx(texCoord0);
+    vec2 st2 = dFdy(texCoord0);
+
+    vec3 N = normalize(normalDir);
+    vec3 T = normalize(q1 * st2.t - q2 * st1.t);
+    vec3 B = -normalize(cross(N, T));
+    mat3 TBN = mat3(T, B, N);
+
+    result = normalize(TBN * tangentNormal);
+#else
+    result = normalize(normalDir);
+#endif
+#ifdef VSG_TWO_SIDED_LIGHTING
+    if (!gl_FrontFacing)
+        result = -result;
+#endif
+    return result;
+}
+
+void main()
+{
+#ifdef VSG_POINT_SPRITE
+    vec2 texCoord0 = gl_PointCoord.xy;
+#endif
+
+    vec4 diffuseColor = vertexColor * material.diffuseColor;
+#ifdef VSG_DIFFUSE_MAP
+    #ifdef VSG_GREYSCALE_DIFFUSE_MAP
+        float v = texture(diffuseMap, texCoord0.st).s;
+        diffuseColor *= vec4(v, v, v, 1.0);
+    #else
+        diffuseColor *= texture(diffuseMap, texCoord0.st);
+    #endif
+#endif
+
+    if (material.alphaMask == 1.0f)
+    {
+        if (diffuseColor.a < material.alphaMaskCutoff)
+            discard;
+    }
+
+    vec4 emissiveColor = material.emissiveColor;
+#ifdef VSG_EMISSIVE_MAP
+    emissiveColor *= texture(emissiveMap, texCoord0.st);
+#endif
+
+    float ambientOcclusion = 1.0;
+#ifdef VSG_LIGHTMAP_MAP
+    ambientOcclusion *= texture(aoMap, texCoord0.st).r;
+#endif
+
+    // map the phong shininess on to the equivalent Blinn-Phong roughness
+    float roughness = sqrt(2.0 / (max(material.shininess, 0.0) + 2.0));
+
+    outAlbedo = vec4(diffuseColor.rgb, ambientOcclusion);
+    outNormal = vec4(getNormal(), 0.0);
+    outMaterial = vec4(0.0, roughness, 0.0, 1.0);
+    outEmissive = vec4(emissiveColor.rgb, 1.0);
+}
+)";
+
+    const char* deferred_pbr_frag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#pragma import_defines (VSG_DIFFUSE_MAP, VSG_GREYSCALE_DIFFUSE_MAP, VSG_EMISSIVE_MAP, VSG_LIGHTMAP_MAP, VSG_NORMAL_MAP, VSG_METALLROUGHNESS_MAP, VSG_SPECULAR_MAP, VSG_TWO_SIDED_LIGHTING, VSG_WORKFLOW_SPECGLOSS)
+
+#define MATERIAL_DESCRIPTOR_SET 1
+
+const float c_MinRoughness = 0.04;
+
+#ifdef VSG_DIFFUSE_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 0) uniform sampler2D diffuseMap;
+#endif
+
+#ifdef VSG_METALLROUGHNESS_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 1) uniform sampler2D mrMap;
+#endif
+
+#ifdef VSG_NORMAL_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 2) uniform sampler2D normalMap;
+#endif
+
+#ifdef VSG_LIGHTMAP_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 3) uniform sampler2D aoMap;
+#endif
+
+#ifdef VSG_EMISSIVE_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 4) uniform sampler2D emissiveMap;
+#endif
+
+#ifdef VSG_SPECULAR_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 5) uniform sampler2D specularMap;
+#endif
+
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 10) uniform PbrData
+{
+    vec4 baseColorFactor;
+    vec4 emissiveFactor;
+    vec4 diffuseFactor;
+    vec4 specularFactor;
+    float metallicFactor;
+    float roughnessFactor;
+    float alphaMask;
+    float alphaMaskCutoff;
+} pbr;
+
+layout(location = 0) in vec3 eyePos;
+layout(location = 1) in vec3 normalDir;
+layout(location = 2) in vec4 vertexColor;
+layout(location = 3) in vec2 texCoord0;
+
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec4 outNormal;
+layout(location = 2) out vec4 outMaterial;
+layout(location = 3) out vec4 outEmissive;
+
+vec4 SRGBtoLINEAR(vec4 srgbIn)
+{
+    vec3 linOut = pow(srgbIn.xyz, vec3(2.2));
+    return vec4(linOut, srgbIn.w);
+}
+
+vec3 getNormal()
+{
+    vec3 result;
+#ifdef VSG_NORMAL_MAP
+    vec3 tangentNormal = texture(normalMap, texCoord0).xyz * 2.0 - 1.0;
+
+    vec3 q1 = dFdx(eyePos);
+    vec3 q2 = dFdy(eyePos);
+    vec2 st1 = dFdx(texCoord0);
+    vec2 st2 = dFdy(texCoord0);
+
+    vec3 N = normalize(normalDir);
+    vec3 T = normalize(q1 * st2.t - q2 * st1.t);
+    vec3 B = -normalize(cross(N, T));
+    mat3 TBN = mat3(T, B, N);
+
+    result = normalize(TBN * tangentNormal);
+#else
+    result = normalize(normalDir);
+#endif
+#ifdef VSG_TWO_SIDED_LIGHTING
+    if (!gl_FrontFacing)
+        result = -result;
+#endif
+    return result;
+}
+
+float convertMetallic(vec3 diffuse, vec3 specular, float maxSpecular)
+{
+    float perceivedDiffuse = sqrt(0.299 * diffuse.r * diffuse.r + 0.587 * diffuse.g * diffuse.g + 0.114 * diffuse.b * diffuse.b);
+    float perceivedSpecular = sqrt(0.299 * specular.r * specular.r + 0.587 * specular.g * specular.g + 0.114 * specular.b * specular.b);
+
+    if (perceivedSpecular < c_MinRoughness)
+    {
+        return 0.0;
+    }
+
+    float a = c_MinRoughness;
+    float b = perceivedDiffuse * (1.0 - maxSpecular) / (1.0 - c_MinRoughness) + perceivedSpecular - 2.0 * c_MinRoughness;
+    float c = c_MinRoughness - perceivedSpecular;
+    float D = max(b * b - 4.0 * a * c, 0.0);
+    return clamp((-b + sqrt(D)) / (2.0 * a), 0.0, 1.0);
+}
+
+void main()
+{
+    float perceptualRoughness = 0.0;
+    float metallic;
+    vec4 baseColor;
+    float ambientOcclusion = 1.0;
+
+#ifdef VSG_DIFFUSE_MAP
+    #ifdef VSG_GREYSCALE_DIFFUSE_MAP
+        float v = texture(diffuseMap, texCoord0.st).s;
+        baseColor = vertexColor * vec4(v, v, v, 1.0) * pbr.baseColorFactor;
+    #else
+        baseColor = vertexColor * SRGBtoLINEAR(texture(diffuseMap, texCoord0)) * pbr.baseColorFactor;
+    #endif
+#else
+    baseColor = vertexColor * pbr.baseColorFactor;
+#endif
+
+    if (pbr.alphaMask == 1.0f)
+    {
+        if (baseColor.a < pbr.alphaMaskCutoff)
+            discard;
+    }
+
+#ifdef VSG_WORKFLOW_SPECGLOSS
+    #ifdef VSG_DIFFUSE_MAP
+        vec4 diffuse = SRGBtoLINEAR(texture(diffuseMap, texCoord0));
+    #else
+        vec4 diffuse = vec4(1.0);
+    #endif
+
+    #ifdef VSG_SPECULAR_MAP
+        vec4 specular_texel = texture(specularMap, texCoord0);
+        vec3 specular = SRGBtoLINEAR(specular_texel).rgb;
+        perceptualRoughness = 1.0 - specular_texel.a;
+    #else
+        vec3 specular = vec3(0.0);
+        perceptualRoughness = 0.0;
+    #endif
+
+        float maxSpecular = max(max(specular.r, specular.g), specular.b);
+
+        metallic = convertMetallic(diffuse.rgb, specular, maxSpecular);
+
+        const float epsilon = 1e-6;
+        vec3 baseColorDiffusePart = diffuse.rgb * ((1.0 - maxSpecular) / (1 - c_MinRoughness) / max(1 - metallic, epsilon)) * pbr.diffuseFactor.rgb;
+        vec3 baseColorSpecularPart = specular - (vec3(c_MinRoughness) * (1 - metallic) * (1 / max(metallic, epsilon))) * pbr.specularFactor.rgb;
+        baseColor = vec4(mix(baseColorDiffusePart, baseColorSpecularPart, metallic * metallic), diffuse.a);
+#else
+        perceptualRoughness = pbr.roughnessFactor;
+        metallic = pbr.metallicFactor;
+
+    #ifdef VSG_METALLROUGHNESS_MAP
+        vec4 mrSample = texture(mrMap, texCoord0);
+        perceptualRoughness = mrSample.g * perceptualRoughness;
+        metallic = mrSample.b * metallic;
+    #endif
+#endif
+
+#ifdef VSG_LIGHTMAP_MAP
+    ambientOcclusion = texture(aoMap, texCoord0).r;
+#endif
+
+#ifdef VSG_EMISSIVE_MAP
+    vec3 emissive = SRGBtoLINEAR(texture(emissiveMap, texCoord0)).rgb * pbr.emissiveFactor.rgb;
+#else
+    vec3 emissive = pbr.emissiveFactor.rgb;
+#endif
+
+    outAlbedo = vec4(baseColor.rgb, ambientOcclusion);
+    outNormal = vec4(getNormal(), 0.0);
+    outMaterial = vec4(metallic, perceptualRoughness, 0.0, 1.0);
+    outEmissive = vec4(emissive, 1.0);
+}
+)";
+
+    const char* deferred_lighting_vert = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) out vec2 ndc;
+
+out gl_PerVertex{ vec4 gl_Position; };
+
+void main()
+{
+    // full screen triangle
+    ndc = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2) * 2.0 - 1.0;
+    gl_Position = vec4(ndc, 0.0, 1.0);
+}
+)";
+
+    const char* deferred_lighting_frag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#pragma import_defines (SHADOWMAP_DEBUG)
+
+#define VIEW_DESCRIPTOR_SET 0
+#define GBUFFER_DESCRIPTOR_SET 1
+
+const float PI = 3.14159265359;
+const float RECIPROCAL_PI = 0.31830988618;
+
+// ViewDependentState
+layout(set = VIEW_DESCRIPTOR_SET, binding = 0) uniform LightData
+{
+    vec4 values[2048];
+} lightData;
+
+layout(set = VIEW_DESCRIPTOR_SET, binding = 2) uniform sampler2DArrayShadow shadowMaps;
+
+// G-buffer
+layout(input_attachment_index = 0, set = GBUFFER_DESCRIPTOR_SET, binding = 0) uniform subpassInput albedoInput;
+layout(input_attachment_index = 1, set = GBUFFER_DESCRIPTOR_SET, binding = 1) uniform subpassInput normalInput;
+layout(input_attachment_index = 2, set = GBUFFER_DESCRIPTOR_SET, binding = 2) uniform subpassInput materialInput;
+layout(input_attachment_index = 3, set = GBUFFER_DESCRIPTOR_SET, binding = 3) uniform subpassInput emissiveInput;
+layout(input_attachment_index = 4, set = GBUFFER_DESCRIPTOR_SET, binding = 4) uniform subpassInput depthInput;
+
+layout(set = GBUFFER_DESCRIPTOR_SET, binding = 5) uniform DeferredData
+{
+    mat4 inverseProjection;
+} deferred;
+
+layout(location = 0) in vec2 ndc;
+
+layout(location = 0) out vec4 outColor;
+
+struct PBRInfo
+{
+    float NdotL;
+    float NdotV;
+    float NdotH;
+    float LdotH;
+    float VdotH;
+    float VdotL;
+    float perceptualRoughness;
+    float metalness;
+    vec3 reflectance0;
+    vec3 reflectance90;
+    float alphaRoughness;
+    vec3 diffuseColor;
+    vec3 specularColor;
+};
+
+vec4 LINEARtoSRGB(vec4 srgbIn)
+{
+    vec3 linOut = pow(srgbIn.xyz, vec3(1.0 / 2.2));
+    return vec4(linOut, srgbIn.w);
+}
+
+vec3 BRDF_Diffuse_Disney(PBRInfo pbrInputs)
+{
+    float Fd90 = 0.5 + 2.0 * pbrInputs.perceptualRoughness * pbrInputs.VdotH * pbrInputs.VdotH;
+    vec3 f0 = vec3(0.1);
+    vec3 invF0 = vec3(1.0, 1.0, 1.0) - f0;
+    float dim = min(invF0.r, min(invF0.g, invF0.b));
+    float result = ((1.0 + (Fd90 - 1.0) * pow(1.0 - pbrInputs.NdotL, 5.0 )) * (1.0 + (Fd90 - 1.0) * pow(1.0 - pbrInputs.NdotV, 5.0 ))) * dim;
+    return pbrInputs.diffuseColor * result;
+}
+
+vec3 specularReflection(PBRInfo pbrInputs)
+{
+    return pbrInputs.reflectance0 + (pbrInputs.reflectance90 - pbrInputs.reflectance90*pbrInputs.reflectance0) * exp2((-5.55473 * pbrInputs.VdotH - 6.98316) * pbrInputs.VdotH);
+}
+
+float geometricOcclusion(PBRInfo pbrInputs)
+{
+    float NdotL = pbrInputs.NdotL;
+    float NdotV = pbrInputs.NdotV;
+    float r = pbrInputs.alphaRoughness * pbrInputs.alphaRoughness;
+
+    float attenuationL = 2.0 * NdotL / (NdotL + sqrt(r + (1.0 - r) * (NdotL * NdotL)));
+    float attenuationV = 2.0 * NdotV / (NdotV + sqrt(r + (1.0 - r) * (NdotV * NdotV)));
+    return attenuationL * attenuationV;
+}
+
+float microfacetDistribution(PBRInfo pbrInputs)
+{
+    float roughnessSq = pbrInputs.alphaRoughness * pbrInputs.alphaRoughness;
+    float f = (pbrInputs.NdotH * roughnessSq - pbrInputs.NdotH) * pbrInputs.NdotH + 1.0;
+    return roughnessSq / (PI * f * f);
+}
+
+vec3 BRDF(vec3 u_LightColor, vec3 v, vec3 n, vec3 l, vec3 h, float perceptualRoughness, float metallic, vec3 specularEnvironmentR0, vec3 specularEnvironmentR90, float alphaRoughness, vec3 diffuseColor, vec3 specularColor, float ao)
+{
+    float NdotL = clamp(dot(n, l), 0.001, 1.0);
+    float NdotV = clamp(abs(dot(n, v)), 0.001, 1.0);
+    float NdotH = clamp(dot(n, h), 0.0, 1.0);
+    float LdotH = clamp(dot(l, h), 0.0, 1.0);
+    float VdotH = clamp(dot(v, h), 0.0, 1.0);
+    float VdotL = clamp(dot(v, l), 0.0, 1.0);
+
+    PBRInfo pbrInputs = PBRInfo(NdotL, NdotV, NdotH, LdotH, VdotH, VdotL,
+                                perceptualRoughness, metallic,
+                                specularEnvironmentR0, specularEnvironmentR90,
+                                alphaRoughness, diffuseColor, specularColor);
+
+    vec3 F = specularReflection(pbrInputs);
+    float G = geometricOcclusion(pbrInputs);
+    float D = microfacetDistribution(pbrInputs);
+
+    vec3 diffuseContrib = (1.0 - F) * BRDF_Diffuse_Disney(pbrInputs);
+    vec3 specContrib = F * G * D / (4.0 * NdotL * NdotV);
+
+    return NdotL * u_LightColor * (diffuseContrib + specContrib) * ao;
+}
+
+void main()
+{
+    float depth = subpassLoad(depthInput).r;
+
+    // nothing rendered to this pixel so leave the clear color
+    if (depth == 0.0) discard;
+
+    vec4 eye = deferred.inverseProjection * vec4(ndc, depth, 1.0);
+    vec3 eyePos = eye.xyz / eye.w;
+
+    vec4 albedo = subpassLoad(albedoInput);
+    vec3 n = normalize(subpassLoad(normalInput).xyz);
+    vec4 materialSample = subpassLoad(materialInput);
+    vec3 emissive = subpassLoad(emissiveInput).rgb;
+
+    float brightnessCutoff = 0.001;
+
+    vec3 baseColor = albedo.rgb;
+    float ambientOcclusion = albedo.a;
+    float metallic = materialSample.r;
+    float perceptualRoughness = materialSample.g;
+
+    vec3 f0 = vec3(0.04);
+    vec3 diffuseColor = baseColor * (vec3(1.0) - f0) * (1.0 - metallic);
+    float alphaRoughness = perceptualRoughness * perceptualRoughness;
+    vec3 specularColor = mix(f0, baseColor, metallic);
+
+    float reflectance = max(max(specularColor.r, specularColor.g), specularColor.b);
+    float reflectance90 = clamp(reflectance * 25.0, 0.0, 1.0);
+    vec3 specularEnvironmentR0 = specularColor.rgb;
+    vec3 specularEnvironmentR90 = vec3(1.0, 1.0, 1.0) * reflectance90;
+
+    vec3 v = normalize(-eyePos);
+
+    vec3 color = vec3(0.0, 0.0, 0.0);
+
+    vec4 lightNums = lightData.values[0];
+    int numAmbientLights = int(lightNums[0]);
+    int numDirectionalLights = int(lightNums[1]);
+    int numPointLights = int(lightNums[2]);
+    int numSpotLights = int(lightNums[3]);
+    int index = 1;
+
+    for(int i = 0; i<numAmbientLights; ++i)
+    {
+        vec4 ambient_color = lightData.values[index++];
+        color += (baseColor * ambient_color.rgb) * (ambient_color.a * ambientOcclusion);
+    }
+
+    int shadowMapIndex = 0;
+    for(int i = 0; i<numDirectionalLights; ++i)
+    {
+        vec4 lightColor = lightData.values[index++];
+        vec3 direction = -lightData.values[index++].xyz;
+        vec4 shadowMapSettings = lightData.values[index++];
+
+        float brightness = lightColor.a;
+
+        bool matched = false;
+        while ((shadowMapSettings.r > 0.0 && brightness > brightnessCutoff) && !matched)
+        {
+            mat4 sm_matrix = mat4(lightData.values[index++],
+                                  lightData.values[index++],
+                                  lightData.values[index++],
+                                  lightData.values[index++]);
+
+            vec4 sm_tc = (sm_matrix) * vec4(eyePos, 1.0);
+
+            if (sm_tc.x >= 0.0 && sm_tc.x <= 1.0 && sm_tc.y >= 0.0 && sm_tc.y <= 1.0 && sm_tc.z >= 0.0)
+            {
+                matched = true;
+
+                float coverage = texture(shadowMaps, vec4(sm_tc.st, shadowMapIndex, sm_tc.z)).r;
+                brightness *= (1.0-coverage);
+
+#ifdef SHADOWMAP_DEBUG
+                if (shadowMapIndex==0) color = vec3(1.0, 0.0, 0.0);
+                else if (shadowMapIndex==1) color = vec3(0.0, 1.0, 0.0);
+                else if (shadowMapIndex==2) color = vec3(0.0, 0.0, 1.0);
+                else color = vec3(1.0, 1.0, 1.0);
+#endif
+            }
+
+            ++shadowMapIndex;
+            shadowMapSettings.r -= 1.0;
+        }
+
+        if (shadowMapSettings.r > 0.0)
+        {
+            index += 4 * int(shadowMapSettings.r);
+            shadowMapIndex += int(shadowMapSettings.r);
+        }
+
+        if (brightness <= brightnessCutoff ) continue;
+
+        vec3 l = direction;
+        vec3 h = normalize(l+v);
+        color.rgb += BRDF(lightColor.rgb * brightness, v, n, l, h, perceptualRoughness, metallic, specularEnvironmentR0, specularEnvironmentR90, alphaRoughness, diffuseColor, specularColor, ambientOcclusion);
+    }
+
+    for(int i = 0; i<numPointLights; ++i)
+    {
+        vec4 lightColor = lightData.values[index++];
+        vec3 position = lightData.values[index++].xyz;
+
+        vec3 delta = position - eyePos;
+        float distance2 = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+        vec3 l = delta / sqrt(distance2);
+        vec3 h = normalize(l+v);
+        float scale = lightColor.a / distance2;
+
+        color.rgb += BRDF(lightColor.rgb * scale, v, n, l, h, perceptualRoughness, metallic, specularEnvironmentR0, specularEnvironmentR90, alphaRoughness, diffuseColor, specularColor, ambientOcclusion);
+    }
+
+    for(int i = 0; i<numSpotLights; ++i)
+    {
+        vec4 lightColor = lightData.values[index++];
+        vec4 position_cosInnerAngle = lightData.values[index++];
+        vec4 lightDirection_cosOuterAngle = lightData.values[index++];
+
+        vec3 delta = position_cosInnerAngle.xyz - eyePos;
+        float distance2 = delta.x * delta.x + delta.y * delta.y + delta.z * delta.z;
+        vec3 l = delta / sqrt(distance2);
+        float dot_lightdirection = -dot(lightDirection_cosOuterAngle.xyz, l);
+        vec3 h = normalize(l+v);
+        float scale = (lightColor.a * smoothstep(lightDirection_cosOuterAngle.w, position_cosInnerAngle.w, dot_lightdirection)) / distance2;
+
+        color.rgb += BRDF(lightColor.rgb * scale, v, n, l, h, perceptualRoughness, metallic, specularEnvironmentR0, specularEnvironmentR90, alphaRoughness, diffuseColor, specularColor, ambientOcclusion);
+    }
+
+    color += emissive;
+
+    outColor = LINEARtoSRGB(vec4(color, 1.0));
+}
+)";
+
+    ref_ptr<ShaderSet> createGBufferShaderSet(ref_ptr<ShaderSet> base, const char* fragmentSource)
+    {
+        ShaderStages stages;
+        for (auto& stage : base->stages)
+        {
+            if (stage->stage == VK_SHADER_STAGE_VERTEX_BIT) stages.push_back(stage);
+        }
+        stages.push_back(ShaderStage::create(VK_SHADER_STAGE_FRAGMENT_BIT, "main", fragmentSource));
+
+        // share the base ShaderSet's bindings so that the G-buffer variant can be used in place of it
+        auto shaderSet = ShaderSet::create(stages, base->defaultShaderHints);
+        shaderSet->attributeBindings = base->attributeBindings;
+        shaderSet->descriptorBindings = base->descriptorBindings;
+        shaderSet->pushConstantRanges = base->pushConstantRanges;
+        shaderSet->definesArrayStates = base->definesArrayStates;
+        shaderSet->optionalDefines = base->optionalDefines;
+        shaderSet->customDescriptorSetBindings = base->customDescriptorSetBindings;
+
+        for (auto& pipelineState : base->defaultGraphicsPipelineStates)
+        {
+            if (!pipelineState->is_compatible(typeid(ColorBlendState))) shaderSet->defaultGraphicsPipelineStates.push_back(pipelineState);
+        }
+
+        // one color attachment for each of the G-buffer's albedo, normal, material and emissive attachments, blending isn't meaningful for G-buffer data
+        auto colorBlendState = ColorBlendState::create();
+        colorBlendState->attachments.resize(4, colorBlendState->attachments.front());
+        shaderSet->defaultGraphicsPipelineStates.push_back(colorBlendState);
+
+        return shaderSet;
+    }
+
+    ref_ptr<ImageView> createAttachment(Device* device, const VkExtent2D& extent, VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspectFlags)
+    {
+        auto image = Image::create();
+        image->imageType = VK_IMAGE_TYPE_2D;
+        image->extent = VkExtent3D{extent.width, extent.height, 1};
+        image->mipLevels = 1;
+        image->arrayLayers = 1;
+        image->format = format;
+        image->tiling = VK_IMAGE_TILING_OPTIMAL;
+        image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image->samples = VK_SAMPLE_COUNT_1_BIT;
+        image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image->usage = usage | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        image->compile(device);
+
+        // the G-buffer is never stored so use lazily allocated memory when it's available, on tile based GPUs this avoids backing it with memory at all
+        image->allocateAndBindMemory(device, image->preferredMemoryProperties(device));
+
+        auto imageView = ImageView::create(image, aspectFlags);
+        imageView->compile(device);
+        return imageView;
+    }
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DeferredRenderGraph
+//
+DeferredRenderGraph::DeferredRenderGraph(ref_ptr<Window> in_window, ref_ptr<View> in_view, ref_ptr<const Options> options) :
+    view(in_view),
+    gbuffer(NUM_ATTACHMENTS),
+    inverseProjection(mat4Value::create())
+{
+    window = in_window;
+
+    // the dynamic rendering path only supports a single subpass
+    dynamicRendering = false;
+
+    auto device = window->getOrCreateDevice();
+
+    if (window->framebufferSamples() != VK_SAMPLE_COUNT_1_BIT)
+    {
+        info("DeferredRenderGraph::DeferredRenderGraph() multisampled windows are not supported, the G-buffer is single sampled.");
+    }
+
+    auto attachment = [](VkFormat format, VkAttachmentStoreOp storeOp, VkImageLayout finalLayout) {
+        AttachmentDescription description = {};
+        description.format = format;
+        description.samples = VK_SAMPLE_COUNT_1_BIT;
+        description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        description.storeOp = storeOp;
+        description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        description.finalLayout = finalLayout;
+        return description;
+    };
+
+    // only the swapchain image is stored, the G-buffer and depth attachments are discarded at the end of the render pass
+    RenderPass::Attachments attachments(NUM_ATTACHMENTS);
+    attachments[COLOR] = attachment(window->surfaceFormat().format, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    attachments[ALBEDO] = attachment(albedoFormat, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    attachments[NORMAL] = attachment(normalFormat, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    attachments[MATERIAL] = attachment(materialFormat, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    attachments[EMISSIVE] = attachment(emissiveFormat, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    attachments[DEPTH] = attachment(window->depthFormat(), VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+    // subpass 0 writes the G-buffer
+    SubpassDescription gbufferSubpass = {};
+    gbufferSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    for (uint32_t i = ALBEDO; i <= EMISSIVE; ++i)
+    {
+        gbufferSubpass.colorAttachments.push_back(AttachmentReference{i, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    }
+    gbufferSubpass.depthStencilAttachments.push_back(AttachmentReference{DEPTH, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
+
+    // subpass 1 reads the G-buffer as input attachments and writes the lit result to the swapchain image,
+    // depth is also attached read only so that forward rendered geometry in the View's bins can depth test against it
+    SubpassDescription lightingSubpass = {};
+    lightingSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    for (uint32_t i = ALBEDO; i <= EMISSIVE; ++i)
+    {
+        lightingSubpass.inputAttachments.push_back(AttachmentReference{i, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT});
+    }
+    lightingSubpass.inputAttachments.push_back(AttachmentReference{DEPTH, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_DEPTH_BIT});
+    lightingSubpass.colorAttachments.push_back(AttachmentReference{COLOR, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    lightingSubpass.depthStencilAttachments.push_back(AttachmentReference{DEPTH, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL});
+
+    RenderPass::Subpasses subpasses{gbufferSubpass, lightingSubpass};
+
+    RenderPass::Dependencies dependencies(3);
+
+    // G-buffer and depth are shared between swapchain images
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dependencyFlags = 0;
+
+    // G-buffer writes must complete before the lighting subpass reads them, only the same pixel is read so the dependency can be by region
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = 1;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // swapchain image layout transition
+    dependencies[2].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[2].dstSubpass = 1;
+    dependencies[2].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].srcAccessMask = 0;
+    dependencies[2].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dependencyFlags = 0;
+
+    renderPass = RenderPass::create(device, attachments, subpasses, dependencies);
+
+    // set up the lighting subpass' descriptors, the G-buffer ImageViews are assigned by createFramebuffers()
+    Descriptors descriptors;
+    DescriptorSetLayoutBindings bindings;
+    for (uint32_t i = ALBEDO; i <= DEPTH; ++i)
+    {
+        uint32_t binding = i - ALBEDO;
+        auto layout = (i == DEPTH) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        descriptors.push_back(DescriptorImage::create(ImageInfo::create(ref_ptr<Sampler>(), ref_ptr<ImageView>(), layout), binding, 0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT));
+        bindings.push_back(VkDescriptorSetLayoutBinding{binding, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
+    }
+
+    inverseProjection->properties.dataVariance = DYNAMIC_DATA_TRANSFER_AFTER_RECORD;
+    descriptors.push_back(DescriptorBuffer::create(inverseProjection, DEPTH - ALBEDO + 1, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER));
+    bindings.push_back(VkDescriptorSetLayoutBinding{DEPTH - ALBEDO + 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
+
+    gbufferDescriptorSet = DescriptorSet::create(DescriptorSetLayout::create(bindings), descriptors);
+
+    createFramebuffers();
+
+    // set up the lighting subpass, a full screen triangle that uses the View's ViewDependentState descriptor set for the light data and shadow maps
+    auto shaderSet = createDeferredLightingShaderSet(options);
+
+    auto pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{ViewDescriptorSetLayout::create(), gbufferDescriptorSet->setLayout}, PushConstantRanges{{VK_SHADER_STAGE_VERTEX_BIT, 0, 128}});
+
+    auto rasterizationState = RasterizationState::create();
+    rasterizationState->cullMode = VK_CULL_MODE_NONE;
+
+    auto depthStencilState = DepthStencilState::create();
+    depthStencilState->depthTestEnable = VK_FALSE;
+    depthStencilState->depthWriteEnable = VK_FALSE;
+
+    GraphicsPipelineStates pipelineStates{
+        VertexInputState::create(),
+        InputAssemblyState::create(),
+        rasterizationState,
+        MultisampleState::create(),
+        ColorBlendState::create(),
+        depthStencilState};
+
+    auto graphicsPipeline = GraphicsPipeline::create(pipelineLayout, shaderSet->getShaderStages(), pipelineStates, 1);
+
+    lightingPass = StateGroup::create();
+    lightingPass->add(BindGraphicsPipeline::create(graphicsPipeline));
+    lightingPass->add(BindViewDescriptorSets::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0));
+    lightingPass->add(BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, gbufferDescriptorSet));
+    lightingPass->addChild(Draw::create(3, 1, 0, 0));
+
+    if (view)
+    {
+        addChild(view);
+        view->addChild(NextSubPass::create());
+        view->addChild(lightingPass);
+
+        if (view->camera && view->camera->viewportState) renderArea = view->camera->getRenderArea();
+    }
+
+    if (!view || !view->camera || !view->camera->viewportState)
+    {
+        renderArea.offset = {0, 0};
+        renderArea.extent = window->extent2D();
+    }
+
+    previous_extent = window->extent2D();
+
+    setClearValues(window->clearColor(), VkClearDepthStencilValue{0.0f, 0});
+}
+
+DeferredRenderGraph::~DeferredRenderGraph()
+{
+}
+
+void DeferredRenderGraph::createFramebuffers()
+{
+    auto device = window->getOrCreateDevice();
+    auto extent = window->extent2D();
+
+    gbuffer[ALBEDO] = createAttachment(device, extent, albedoFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    gbuffer[NORMAL] = createAttachment(device, extent, normalFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    gbuffer[MATERIAL] = createAttachment(device, extent, materialFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    gbuffer[EMISSIVE] = createAttachment(device, extent, emissiveFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    gbuffer[DEPTH] = createAttachment(device, extent, window->depthFormat(), VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    _framebuffers.clear();
+    _swapchainImageViews.clear();
+    for (size_t i = 0; i < window->numFrames(); ++i)
+    {
+        auto imageViews = gbuffer;
+        imageViews[COLOR] = window->imageView(i);
+        _framebuffers.push_back(Framebuffer::create(renderPass, imageViews, extent.width, extent.height, 1));
+        _swapchainImageViews.push_back(window->imageView(i).get());
+    }
+
+    if (!_framebuffers.empty()) framebuffer = _framebuffers.front();
+
+    // assign the new G-buffer ImageViews to the input attachment descriptors, if already compiled update the Vulkan descriptor set in place
+    auto implementation = gbufferDescriptorSet->getImplementation(device->deviceID);
+
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+    imageInfos.reserve(DEPTH - ALBEDO + 1);
+    for (uint32_t i = ALBEDO; i <= DEPTH; ++i)
+    {
+        auto descriptorImage = gbufferDescriptorSet->descriptors[i - ALBEDO].cast<DescriptorImage>();
+        auto& imageInfo = descriptorImage->imageInfoList.front();
+        imageInfo->imageView = gbuffer[i];
+
+        if (implementation)
+        {
+            imageInfos.push_back(VkDescriptorImageInfo{VK_NULL_HANDLE, gbuffer[i]->vk(device->deviceID), imageInfo->imageLayout});
+
+            VkWriteDescriptorSet descriptorWrite = {};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstBinding = i - ALBEDO;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            descriptorWrite.pImageInfo = &imageInfos.back();
+            descriptorWrites.push_back(descriptorWrite);
+        }
+    }
+
+    if (implementation) implementation->write(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data());
+}
+
+void DeferredRenderGraph::accept(RecordTraversal& recordTraversal) const
+{
+    // recreate the G-buffer and framebuffers if the Window's swapchain has been recreated
+    bool swapchainChanged = _swapchainImageViews.size() != window->numFrames();
+    for (size_t i = 0; !swapchainChanged && i < _swapchainImageViews.size(); ++i)
+    {
+        swapchainChanged = _swapchainImageViews[i] != window->imageView(i).get();
+    }
+
+    auto this_renderGraph = const_cast<DeferredRenderGraph*>(this);
+    if (swapchainChanged) this_renderGraph->createFramebuffers();
+
+    size_t imageIndex = window->imageIndex();
+    if (imageIndex >= _framebuffers.size()) return;
+
+    // RenderGraph::accept() uses the framebuffer in preference to the Window's own, so assign the one for the current swapchain image
+    this_renderGraph->framebuffer = _framebuffers[imageIndex];
+
+    if (view && view->camera)
+    {
+        inverseProjection->set(mat4(inverse(view->camera->projectionMatrix->transform())));
+        inverseProjection->dirty();
+    }
+
+    RenderGraph::accept(recordTraversal);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// G-buffer and lighting ShaderSets
+//
+ref_ptr<ShaderSet> vsg::createDeferredPhongShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("deferred_phong"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    return createGBufferShaderSet(createPhongShaderSet(options), deferred_phong_frag);
+}
+
+ref_ptr<ShaderSet> vsg::createDeferredPhysicsBasedRenderingShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("deferred_pbr"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    return createGBufferShaderSet(createPhysicsBasedRenderingShaderSet(options), deferred_pbr_frag);
+}
+
+ref_ptr<ShaderSet> vsg::createDeferredLightingShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("deferred_lighting"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    ShaderStages stages{
+        ShaderStage::create(VK_SHADER_STAGE_VERTEX_BIT, "main", deferred_lighting_vert),
+        ShaderStage::create(VK_SHADER_STAGE_FRAGMENT_BIT, "main", deferred_lighting_frag)};
+
+    auto shaderSet = ShaderSet::create(stages);
+    shaderSet->optionalDefines = {"SHADOWMAP_DEBUG"};
+    shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+    return shaderSet;
+}
+
+ref_ptr<DeferredRenderGraph> vsg::createDeferredRenderGraphForView(ref_ptr<Window> window, ref_ptr<Camera> camera, ref_ptr<Node> scenegraph, bool assignHeadlight)
+{
+    // set up the view
+    auto view = View::create(camera);
+    if (assignHeadlight) view->addChild(createHeadlight());
+    if (scenegraph) view->addChild(scenegraph);
+
+    // set up the render graph, which appends the lighting subpass to the view
+    return DeferredRenderGraph::create(window, view);
+}
@@ -0,0 +1,124 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/DeleteQueue.h>
+#include <vsg/io/Logger.h>
+
+using namespace vsg;
+
+// DeleteQueue assigned to the current thread by DeleteQueue::deferDeletesOnCurrentThread()
+static thread_local ref_ptr<DeleteQueue> s_currentThreadDeleteQueue;
+
+DeleteQueue::DeleteQueue(ref_ptr<ActivityStatus> status, uint64_t in_retainForFrameCount) :
+    retainForFrameCount(in_retainForFrameCount),
+    _status(status)
+{
+}
+
+DeleteQueue::~DeleteQueue()
+{
+}
+
+void DeleteQueue::advance(ref_ptr<FrameStamp> frameStamp)
+{
+    if (!frameStamp) return;
+
+    std::scoped_lock lock(_mutex);
+    frameCount.exchange(frameStamp->frameCount);
+    if (_readyToDelete()) _cv.notify_one();
+}
+
+void DeleteQueue::add(ref_ptr<Object> object)
+{
+    if (!object) return;
+
+    std::scoped_lock lock(_mutex);
+    _objectsToDelete.push_back(ObjectToDelete{frameCount.load(), object});
+}
+
+void DeleteQueue::add(ObjectsToDelete& objectsToDelete)
+{
+    std::scoped_lock lock(_mutex);
+    _objectsToDelete.splice(_objectsToDelete.end(), objectsToDelete);
+}
+
+void DeleteQueue::wait_then_clear()
+{
+    ObjectsToDelete objectsToDelete;
+    {
+        std::chrono::duration waitDuration = std::chrono::milliseconds(100);
+        std::unique_lock lock(_mutex);
+
+        // wait until the conditional variable signals that a frame has advanced far enough for objects to be deleted
+        while (!_readyToDelete() && _status->active() && !_releaseRequested)
+        {
+            _cv.wait_for(lock, waitDuration);
+        }
+        _releaseRequested = false;
+
+        // entries are added in frame order so the ready entries are all at the front
+        auto itr = _objectsToDelete.begin();
+        while (itr != _objectsToDelete.end() && (frameCount.load() - itr->frameCount) > retainForFrameCount) ++itr;
+        objectsToDelete.splice(objectsToDelete.end(), _objectsToDelete, _objectsToDelete.begin(), itr);
+    }
+
+    // release the objects outside of the lock so that destructors don't block adding to the queue
+    if (!objectsToDelete.empty()) debug("DeleteQueue::wait_then_clear() deleting ", objectsToDelete.size(), " objects");
+    objectsToDelete.clear();
+}
+
+void DeleteQueue::release()
+{
+    {
+        std::scoped_lock lock(_mutex);
+        _releaseRequested = true;
+    }
+    _cv.notify_all();
+}
+
+void DeleteQueue::clear()
+{
+    ObjectsToDelete objectsToDelete;
+    {
+        std::scoped_lock lock(_mutex);
+        objectsToDelete.swap(_objectsToDelete);
+    }
+    objectsToDelete.clear();
+}
+
+size_t DeleteQueue::size() const
+{
+    std::scoped_lock lock(_mutex);
+    return _objectsToDelete.size();
+}
+
+void DeleteQueue::deferDeletesOnCurrentThread(ref_ptr<DeleteQueue> queue)
+{
+    s_currentThreadDeleteQueue = queue;
+}
+
+DeleteQueue* DeleteQueue::currentThreadDeleteQueue()
+{
+    return s_currentThreadDeleteQueue.get();
+}
+
+bool DeleteQueue::deferDelete(const Object* object)
+{
+    auto queue = s_currentThreadDeleteQueue.get();
+
+    // the DeleteQueue itself is deleted inline, such as when the thread_local is destroyed on thread exit
+    if (!queue || object == queue || !queue->_status || !queue->_status->active()) return false;
+
+    // the reference taken by the queue brings the count back to 1, when the queue releases it on its own thread the object is deleted
+    queue->add(ref_ptr<Object>(const_cast<Object*>(object)));
+    return true;
+}
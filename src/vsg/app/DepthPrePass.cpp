@@ -0,0 +1,160 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/DepthPrePass.h>
+#include <vsg/core/ConstVisitor.h>
+#include <vsg/core/Visitor.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DepthStencilState.h>
+
+using namespace vsg;
+
+DepthPrePass::DepthPrePass()
+{
+}
+
+DepthPrePass::~DepthPrePass()
+{
+}
+
+bool DepthPrePass::add(const BindGraphicsPipeline& bindPipeline)
+{
+    if (variants.count(&bindPipeline) > 0) return true;
+
+    auto pipeline = bindPipeline.pipeline;
+    if (!pipeline) return false;
+
+    ref_ptr<DepthStencilState> depthStencilState;
+    ref_ptr<ColorBlendState> colorBlendState;
+    for (auto& pipelineState : pipeline->pipelineStates)
+    {
+        if (auto dss = pipelineState.cast<DepthStencilState>())
+            depthStencilState = dss;
+        else if (auto cbs = pipelineState.cast<ColorBlendState>())
+            colorBlendState = cbs;
+    }
+
+    if (depthStencilState && !depthStencilState->depthTestEnable) return false;
+    if (colorBlendState)
+    {
+        for (auto& attachment : colorBlendState->attachments)
+        {
+            if (attachment.blendEnable) return false;
+        }
+    }
+
+    auto depthOnly_depthStencilState = depthStencilState ? DepthStencilState::create(*depthStencilState) : DepthStencilState::create();
+    depthOnly_depthStencilState->depthWriteEnable = VK_TRUE;
+
+    // keep the attachments so they still match the RenderPass, but don't write to them
+    auto depthOnly_colorBlendState = colorBlendState ? ColorBlendState::create(*colorBlendState) : ColorBlendState::create();
+    for (auto& attachment : depthOnly_colorBlendState->attachments)
+    {
+        attachment.colorWriteMask = 0;
+    }
+
+    auto depthEqual_depthStencilState = depthStencilState ? DepthStencilState::create(*depthStencilState) : DepthStencilState::create();
+    depthEqual_depthStencilState->depthWriteEnable = VK_FALSE;
+    depthEqual_depthStencilState->depthCompareOp = VK_COMPARE_OP_EQUAL;
+
+    GraphicsPipelineStates depthOnly_pipelineStates;
+    GraphicsPipelineStates depthEqual_pipelineStates;
+    for (auto& pipelineState : pipeline->pipelineStates)
+    {
+        if (pipelineState == depthStencilState)
+        {
+            depthOnly_pipelineStates.push_back(depthOnly_depthStencilState);
+            depthEqual_pipelineStates.push_back(depthEqual_depthStencilState);
+        }
+        else if (pipelineState == colorBlendState)
+        {
+            depthOnly_pipelineStates.push_back(depthOnly_colorBlendState);
+            depthEqual_pipelineStates.push_back(pipelineState);
+        }
+        else
+        {
+            depthOnly_pipelineStates.push_back(pipelineState);
+            depthEqual_pipelineStates.push_back(pipelineState);
+        }
+    }
+    if (!depthStencilState)
+    {
+        depthOnly_pipelineStates.push_back(depthOnly_depthStencilState);
+        depthEqual_pipelineStates.push_back(depthEqual_depthStencilState);
+    }
+    if (!colorBlendState) depthOnly_pipelineStates.push_back(depthOnly_colorBlendState);
+
+    ShaderStages depthOnly_stages;
+    for (auto& stage : pipeline->stages)
+    {
+        if (keepFragmentShader || stage->stage != VK_SHADER_STAGE_FRAGMENT_BIT) depthOnly_stages.push_back(stage);
+    }
+
+    auto& pipelineVariants = variants[&bindPipeline];
+    pipelineVariants.depthOnly = BindGraphicsPipeline::create(GraphicsPipeline::create(pipeline->layout, depthOnly_stages, depthOnly_pipelineStates, pipeline->subpass));
+    pipelineVariants.depthEqual = BindGraphicsPipeline::create(GraphicsPipeline::create(pipeline->layout, pipeline->stages, depthEqual_pipelineStates, pipeline->subpass));
+
+    return true;
+}
+
+size_t DepthPrePass::add(const Node& subgraph)
+{
+    struct FindPipelines : public ConstVisitor
+    {
+        DepthPrePass* depthPrePass = nullptr;
+        size_t numPipelines = 0;
+
+        void apply(const Node& node) override
+        {
+            node.traverse(*this);
+        }
+
+        void apply(const StateGroup& stateGroup) override
+        {
+            for (auto& command : stateGroup.stateCommands)
+            {
+                command->accept(*this);
+            }
+            stateGroup.traverse(*this);
+        }
+
+        void apply(const BindGraphicsPipeline& bindPipeline) override
+        {
+            bool known = depthPrePass->variants.count(&bindPipeline) > 0;
+            if (depthPrePass->add(bindPipeline) && !known) ++numPipelines;
+        }
+    } findPipelines;
+
+    findPipelines.depthPrePass = this;
+    subgraph.accept(findPipelines);
+
+    return findPipelines.numPipelines;
+}
+
+void DepthPrePass::traverse(Visitor& visitor)
+{
+    for (auto& [command, pipelineVariants] : variants)
+    {
+        pipelineVariants.depthOnly->accept(visitor);
+        pipelineVariants.depthEqual->accept(visitor);
+    }
+}
+
+void DepthPrePass::traverse(ConstVisitor& visitor) const
+{
+    for (auto& [command, pipelineVariants] : variants)
+    {
+        pipelineVariants.depthOnly->accept(visitor);
+        pipelineVariants.depthEqual->accept(visitor);
+    }
+}
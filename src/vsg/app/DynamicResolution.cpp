@@ -0,0 +1,251 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/DynamicResolution.h>
+#include <vsg/app/FrameStatistics.h>
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/app/View.h>
+#include <vsg/io/Logger.h>
+#include <vsg/vk/State.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vsg;
+
+namespace
+{
+    /// RenderPass with a color attachment that is left in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL ready to blit to the swapchain image
+    ref_ptr<RenderPass> createBlitSourceRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat)
+    {
+        auto colorAttachment = defaultColorAttachment(imageFormat);
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+        auto depthAttachment = defaultDepthAttachment(depthFormat);
+
+        RenderPass::Attachments attachments{colorAttachment, depthAttachment};
+
+        AttachmentReference colorAttachmentRef = {};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        AttachmentReference depthAttachmentRef = {};
+        depthAttachmentRef.attachment = 1;
+        depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        SubpassDescription subpass = {};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachments.emplace_back(colorAttachmentRef);
+        subpass.depthStencilAttachments.emplace_back(depthAttachmentRef);
+
+        RenderPass::Subpasses subpasses{subpass};
+
+        // the previous frame's blit must have finished reading the color attachment before it's overwritten
+        SubpassDependency colorDependency = {};
+        colorDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        colorDependency.dstSubpass = 0;
+        colorDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+        colorDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        colorDependency.srcAccessMask = 0;
+        colorDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        colorDependency.dependencyFlags = 0;
+
+        SubpassDependency depthDependency = {};
+        depthDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        depthDependency.dstSubpass = 0;
+        depthDependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        depthDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        depthDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depthDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depthDependency.dependencyFlags = 0;
+
+        // make the color writes available to the blit
+        SubpassDependency blitDependency = {};
+        blitDependency.srcSubpass = 0;
+        blitDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+        blitDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        blitDependency.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        blitDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        blitDependency.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        blitDependency.dependencyFlags = 0;
+
+        RenderPass::Dependencies dependencies{colorDependency, depthDependency, blitDependency};
+
+        return RenderPass::create(device, attachments, subpasses, dependencies);
+    }
+
+    ref_ptr<ImageView> createAttachment(Device* device, VkFormat format, const VkExtent2D& extent, VkImageUsageFlags usage, VkImageAspectFlags aspectFlags)
+    {
+        auto image = Image::create();
+        image->imageType = VK_IMAGE_TYPE_2D;
+        image->extent = VkExtent3D{extent.width, extent.height, 1};
+        image->mipLevels = 1;
+        image->arrayLayers = 1;
+        image->format = format;
+        image->tiling = VK_IMAGE_TILING_OPTIMAL;
+        image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image->samples = VK_SAMPLE_COUNT_1_BIT;
+        image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image->usage = usage;
+
+        return createImageView(device, image, aspectFlags);
+    }
+} // namespace
+
+DynamicResolution::DynamicResolution(ref_ptr<Window> in_window, ref_ptr<View> in_view) :
+    window(in_window)
+{
+    auto device = window->getOrCreateDevice();
+    _renderPass = createBlitSourceRenderPass(device, window->surfaceFormat().format, window->depthFormat());
+
+    _setViewport = SetViewport::create(0, Viewports{VkViewport{0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f}});
+    _setScissor = SetScissor::create(0, Scissors{VkRect2D{{0, 0}, {1, 1}}});
+
+    renderGraph = RenderGraph::create();
+    renderGraph->addChild(_setViewport);
+    renderGraph->addChild(_setScissor);
+    if (in_view) renderGraph->addChild(in_view);
+
+    _createAttachments(window->extent2D());
+
+    // the camera covers the whole of the offscreen framebuffer, the dynamic viewport then selects the scaled region of it
+    auto extent = renderGraph->framebuffer->extent2D();
+    if (in_view && in_view->camera) in_view->camera->viewportState = ViewportState::create(extent);
+
+    renderGraph->renderArea = VkRect2D{{0, 0}, extent};
+    renderGraph->previous_extent = extent;
+    renderGraph->setClearValues(window->clearColor(), VkClearDepthStencilValue{0.0f, 0});
+}
+
+DynamicResolution::~DynamicResolution()
+{
+}
+
+void DynamicResolution::_createAttachments(const VkExtent2D& windowExtent)
+{
+    auto device = window->getOrCreateDevice();
+
+    // previous frames may still be using the current attachments
+    if (renderGraph->framebuffer) vkDeviceWaitIdle(*device);
+
+    VkExtent2D extent{std::max(1u, static_cast<uint32_t>(std::ceil(static_cast<double>(windowExtent.width) * maximumScale))),
+                      std::max(1u, static_cast<uint32_t>(std::ceil(static_cast<double>(windowExtent.height) * maximumScale)))};
+
+    _colorImageView = createAttachment(device, window->surfaceFormat().format, extent, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    auto depthImageView = createAttachment(device, window->depthFormat(), extent, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    // the RenderGraph's WindowResizeHandler picks up the change in framebuffer extent and updates the View's camera to fit
+    renderGraph->framebuffer = Framebuffer::create(_renderPass, ImageViews{_colorImageView, depthImageView}, extent.width, extent.height, 1);
+
+    _windowExtent = windowExtent;
+}
+
+VkExtent2D DynamicResolution::getRenderExtent() const
+{
+    auto extent = renderGraph->framebuffer->extent2D();
+    double clampedScale = std::clamp(scale, minimumScale, maximumScale);
+    return VkExtent2D{std::clamp(static_cast<uint32_t>(static_cast<double>(_windowExtent.width) * clampedScale + 0.5), 1u, extent.width),
+                      std::clamp(static_cast<uint32_t>(static_cast<double>(_windowExtent.height) * clampedScale + 0.5), 1u, extent.height)};
+}
+
+void DynamicResolution::adjustScale(double gpuFrameTime)
+{
+    _smoothedFrameTime = (_smoothedFrameTime > 0.0) ? (_smoothedFrameTime + smoothing * (gpuFrameTime - _smoothedFrameTime)) : gpuFrameTime;
+
+    if (++_timingsSinceAdjustment < adjustmentInterval || targetFrameTime <= 0.0 || _smoothedFrameTime <= 0.0) return;
+
+    double ratio = _smoothedFrameTime / targetFrameTime;
+    if (ratio >= increaseThreshold && ratio <= decreaseThreshold) return;
+
+    // GPU time is dominated by the number of fragments so it scales with the square of the scale, aim for the middle of the hysteresis band
+    double desiredScale = scale * std::sqrt((increaseThreshold + decreaseThreshold) * 0.5 / ratio);
+    double newScale = std::clamp(std::clamp(desiredScale, scale - maximumScaleStep, scale + maximumScaleStep), minimumScale, maximumScale);
+    if (newScale == scale) return;
+
+    debug("DynamicResolution::adjustScale() smoothed GPU time = ", _smoothedFrameTime, "ms, scale changed from ", scale, " to ", newScale);
+
+    scale = newScale;
+    _timingsSinceAdjustment = 0;
+    _smoothedFrameTime = 0.0;
+}
+
+void DynamicResolution::_update(RecordTraversal& recordTraversal)
+{
+    if (window->extent2D() != _windowExtent) _createAttachments(window->extent2D());
+
+    if (auto frameStatistics = recordTraversal.frameStatistics; frameStatistics && automatic)
+    {
+        frameStatistics->recordGpuTimings = true;
+
+        // GPU timings arrive a few frames after they are recorded, so only adjust when a new one has arrived
+        auto timings = frameStatistics->gpuTimings(renderGraph);
+        if (timings->count() != _timingsCount)
+        {
+            _timingsCount = timings->count();
+            adjustScale(timings->latest());
+        }
+    }
+
+    auto renderExtent = getRenderExtent();
+    renderGraph->renderArea = VkRect2D{{0, 0}, renderExtent};
+    _setViewport->viewports[0] = VkViewport{0.0f, 0.0f, static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height), 0.0f, 1.0f};
+    _setScissor->scissors[0] = VkRect2D{{0, 0}, renderExtent};
+}
+
+void DynamicResolution::accept(RecordTraversal& recordTraversal) const
+{
+    size_t imageIndex = window->imageIndex();
+    if (imageIndex >= window->numFrames()) return;
+
+    auto this_dynamicResolution = const_cast<DynamicResolution*>(this);
+    this_dynamicResolution->_update(recordTraversal);
+
+    renderGraph->accept(recordTraversal);
+
+    auto& commandBuffer = *recordTraversal.getState()->_commandBuffer;
+    auto deviceID = commandBuffer.deviceID;
+    auto srcImage = _colorImageView->image->vk(deviceID);
+    auto dstImage = window->imageView(imageIndex)->image->vk(deviceID);
+
+    VkImageMemoryBarrier toTransferDst = {};
+    toTransferDst.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransferDst.srcAccessMask = 0;
+    toTransferDst.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toTransferDst.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    toTransferDst.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toTransferDst.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransferDst.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransferDst.image = dstImage;
+    toTransferDst.subresourceRange = VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    // the swapchain image acquire semaphore is waited on at the color attachment output stage
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &toTransferDst);
+
+    auto renderExtent = renderGraph->renderArea.extent;
+    auto windowExtent = window->extent2D();
+
+    VkImageBlit region = {};
+    region.srcSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.srcOffsets[1] = VkOffset3D{static_cast<int32_t>(renderExtent.width), static_cast<int32_t>(renderExtent.height), 1};
+    region.dstSubresource = VkImageSubresourceLayers{VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.dstOffsets[1] = VkOffset3D{static_cast<int32_t>(windowExtent.width), static_cast<int32_t>(windowExtent.height), 1};
+
+    vkCmdBlitImage(commandBuffer, srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region, filter);
+
+    VkImageMemoryBarrier toPresent = toTransferDst;
+    toPresent.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toPresent.dstAccessMask = 0;
+    toPresent.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &toPresent);
+}
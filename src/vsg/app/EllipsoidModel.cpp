@@ -14,6 +14,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/maths/transform.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 using namespace vsg;
 
 EllipsoidModel::EllipsoidModel(double rEquator, double rPolar) :
@@ -62,6 +66,52 @@ dvec3 EllipsoidModel::convertLatLongAltitudeToECEF(const dvec3& lla) const
                  (N * (1 - _eccentricitySquared) + height) * sin_latitude);
 }
 
+void EllipsoidModel::convertLatLongAltitudeToECEF(const dvec3* lla, dvec3* ecef, size_t count) const
+{
+    const double one_minus_e2 = 1.0 - _eccentricitySquared;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double latitude = radians(lla[i][0]);
+        const double longitude = radians(lla[i][1]);
+        const double height = lla[i][2];
+
+        double sin_latitude = sin(latitude);
+        double cos_latitude = cos(latitude);
+        double N = _radiusEquator / sqrt(1.0 - _eccentricitySquared * sin_latitude * sin_latitude);
+        double horizontal = (N + height) * cos_latitude;
+        ecef[i].set(horizontal * cos(longitude), horizontal * sin(longitude), (N * one_minus_e2 + height) * sin_latitude);
+    }
+}
+
+void EllipsoidModel::convertLatLongAltitudeGridToECEF(const double* latitudes, size_t numLatitudes, const double* longitudes, size_t numLongitudes, double altitude, dvec3* ecef) const
+{
+    std::vector<double> sin_longitudes(numLongitudes);
+    std::vector<double> cos_longitudes(numLongitudes);
+    for (size_t c = 0; c < numLongitudes; ++c)
+    {
+        const double longitude = radians(longitudes[c]);
+        sin_longitudes[c] = sin(longitude);
+        cos_longitudes[c] = cos(longitude);
+    }
+
+    const double one_minus_e2 = 1.0 - _eccentricitySquared;
+    for (size_t r = 0; r < numLatitudes; ++r)
+    {
+        const double latitude = radians(latitudes[r]);
+        double sin_latitude = sin(latitude);
+        double cos_latitude = cos(latitude);
+        double N = _radiusEquator / sqrt(1.0 - _eccentricitySquared * sin_latitude * sin_latitude);
+        double horizontal = (N + altitude) * cos_latitude;
+        double z = (N * one_minus_e2 + altitude) * sin_latitude;
+
+        dvec3* row = ecef + r * numLongitudes;
+        for (size_t c = 0; c < numLongitudes; ++c)
+        {
+            row[c].set(horizontal * cos_longitudes[c], horizontal * sin_longitudes[c], z);
+        }
+    }
+}
+
 dvec3 EllipsoidModel::convertECEFToLatLongAltitude(const dvec3& ecef) const
 {
     double latitude, longitude, height;
@@ -118,6 +168,53 @@ dvec3 EllipsoidModel::convertECEFToLatLongAltitude(const dvec3& ecef) const
     return dvec3(degrees(latitude), degrees(longitude), height);
 }
 
+void EllipsoidModel::convertECEFToLatLongAltitude(const dvec3* ecef, dvec3* lla, size_t count) const
+{
+    // Heikkinen's closed form solution, see https://en.wikipedia.org/wiki/Geographic_coordinate_conversion#The_application_of_Ferrari's_solution
+    const double a = _radiusEquator;
+    const double b = _radiusPolar;
+    const double a2 = a * a;
+    const double b2 = b * b;
+    const double e2 = _eccentricitySquared;
+    const double e4 = e2 * e2;
+    const double one_minus_e2 = 1.0 - e2;
+    const double eDashSquared = (a2 - b2) / b2;
+
+    // the solution becomes ill conditioned close to the center of the ellipsoid so fall back to the single coord conversion there
+    const double minimumDistance2 = (b * 0.5) * (b * 0.5);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double x = ecef[i].x;
+        const double y = ecef[i].y;
+        const double z = ecef[i].z;
+
+        double p2 = x * x + y * y;
+        if (p2 == 0.0 || (p2 + z * z) < minimumDistance2)
+        {
+            lla[i] = convertECEFToLatLongAltitude(ecef[i]);
+            continue;
+        }
+
+        double p = sqrt(p2);
+        double z2 = z * z;
+        double F = 54.0 * b2 * z2;
+        double G = p2 + one_minus_e2 * z2 - e2 * (a2 - b2);
+        double c = e4 * F * p2 / (G * G * G);
+        double s = cbrt(1.0 + c + sqrt(c * c + 2.0 * c));
+        double k = s + 1.0 + 1.0 / s;
+        double P = F / (3.0 * k * k * G * G);
+        double Q = sqrt(1.0 + 2.0 * e4 * P);
+        double r0 = -(P * e2 * p) / (1.0 + Q) + sqrt(std::max(0.0, 0.5 * a2 * (1.0 + 1.0 / Q) - P * one_minus_e2 * z2 / (Q * (1.0 + Q)) - 0.5 * P * p2));
+        double p_minus_e2r0 = p - e2 * r0;
+        double U = sqrt(p_minus_e2r0 * p_minus_e2r0 + z2);
+        double V = sqrt(p_minus_e2r0 * p_minus_e2r0 + one_minus_e2 * z2);
+        double z0 = b2 * z / (a * V);
+
+        lla[i].set(degrees(atan2(z + eDashSquared * z0, p)), degrees(atan2(y, x)), U * (1.0 - b2 / (a * V)));
+    }
+}
+
 dmat4 EllipsoidModel::computeLocalToWorldTransform(const dvec3& lla) const
 {
     dvec3 ecef = convertLatLongAltitudeToECEF(lla);
@@ -148,6 +245,30 @@ dmat4 EllipsoidModel::computeLocalToWorldTransform(const dvec3& lla) const
     return localToWorld;
 }
 
+void EllipsoidModel::computeLocalToWorldTransform(const dvec3* lla, dmat4* localToWorld, size_t count) const
+{
+    const double one_minus_e2 = 1.0 - _eccentricitySquared;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double latitude = radians(lla[i][0]);
+        const double longitude = radians(lla[i][1]);
+        const double height = lla[i][2];
+
+        double sin_latitude = sin(latitude);
+        double cos_latitude = cos(latitude);
+        double sin_longitude = sin(longitude);
+        double cos_longitude = cos(longitude);
+        double N = _radiusEquator / sqrt(1.0 - _eccentricitySquared * sin_latitude * sin_latitude);
+        double horizontal = (N + height) * cos_latitude;
+
+        // columns are east, north = cross(up, east), up and the ECEF position
+        localToWorld[i] = dmat4(-sin_longitude, cos_longitude, 0.0, 0.0,
+                                -sin_latitude * cos_longitude, -sin_latitude * sin_longitude, cos_latitude, 0.0,
+                                cos_latitude * cos_longitude, cos_latitude * sin_longitude, sin_latitude, 0.0,
+                                horizontal * cos_longitude, horizontal * sin_longitude, (N * one_minus_e2 + height) * sin_latitude, 1.0);
+    }
+}
+
 dmat4 EllipsoidModel::computeWorldToLocalTransform(const dvec3& lla) const
 {
     return vsg::inverse(computeLocalToWorldTransform(lla));
@@ -0,0 +1,559 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/FrameGraph.h>
+#include <vsg/core/Exception.h>
+#include <vsg/io/Logger.h>
+#include <vsg/state/ImageView.h>
+#include <vsg/vk/Context.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+using namespace vsg;
+
+namespace
+{
+    /// synchronization state of a FrameGraphResource as passes are scheduled
+    struct ResourceState
+    {
+        VkPipelineStageFlags writeStages = 0;
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;
+        VkPipelineStageFlags syncedStages = 0; // stages that the last write has been made visible to
+        VkAccessFlags syncedAccess = 0;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        int writePass = -1;
+        int readPass = -1;
+    };
+
+    struct Barrier
+    {
+        FrameGraphResource* resource = nullptr;
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        VkAccessFlags srcAccess = 0;
+        VkAccessFlags dstAccess = 0;
+        VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        int producerPass = -1;
+    };
+
+    /// update state for access by passIndex, returning true and filling in barrier if synchronization is required before the access.
+    bool access(ResourceState& state, const FrameGraphAccess& fga, int passIndex, Barrier& barrier)
+    {
+        bool isImage = fga.resource->image.valid();
+        bool layoutChange = isImage && fga.layout != VK_IMAGE_LAYOUT_UNDEFINED && fga.layout != state.layout;
+
+        barrier = {};
+        barrier.resource = fga.resource.get();
+        barrier.dstStages = fga.stageMask;
+        barrier.dstAccess = fga.accessMask;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = layoutChange ? fga.layout : state.layout;
+
+        if (state.writeStages != 0 && (fga.write || layoutChange || (fga.stageMask & ~state.syncedStages) != 0 || (fga.accessMask & ~state.syncedAccess) != 0))
+        {
+            // read after write or write after write
+            barrier.srcStages |= state.writeStages;
+            barrier.srcAccess |= state.writeAccess;
+            barrier.producerPass = state.writePass;
+        }
+
+        if ((fga.write || layoutChange) && state.readStages != 0)
+        {
+            // write after read only requires an execution dependency
+            barrier.srcStages |= state.readStages;
+            barrier.producerPass = std::max(barrier.producerPass, state.readPass);
+        }
+
+        bool required = barrier.srcStages != 0 || layoutChange;
+        if (required && barrier.srcStages == 0) barrier.srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+        if (fga.write)
+        {
+            state.writeStages = fga.stageMask;
+            state.writeAccess = fga.accessMask;
+            state.readStages = 0;
+            state.syncedStages = 0;
+            state.syncedAccess = 0;
+            state.writePass = passIndex;
+            state.readPass = -1;
+        }
+        else
+        {
+            if (required)
+            {
+                state.syncedStages |= fga.stageMask;
+                state.syncedAccess |= fga.accessMask;
+            }
+            state.readStages |= fga.stageMask;
+            state.readPass = passIndex;
+        }
+
+        if (layoutChange) state.layout = fga.layout;
+        if (isImage && fga.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED) state.layout = fga.finalLayout;
+
+        return required;
+    }
+
+    /// merge the accesses a pass makes to the same resource
+    std::vector<FrameGraphAccess> mergedAccesses(const FrameGraphPass& pass)
+    {
+        std::vector<FrameGraphAccess> merged;
+        for (auto& fga : pass.accesses)
+        {
+            if (!fga.resource) continue;
+
+            auto itr = std::find_if(merged.begin(), merged.end(), [&](const FrameGraphAccess& m) { return m.resource == fga.resource; });
+            if (itr == merged.end())
+            {
+                merged.push_back(fga);
+                continue;
+            }
+
+            itr->stageMask |= fga.stageMask;
+            itr->accessMask |= fga.accessMask;
+            itr->write = itr->write || fga.write;
+            if (itr->layout == VK_IMAGE_LAYOUT_UNDEFINED) itr->layout = fga.layout;
+            if (fga.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED) itr->finalLayout = fga.finalLayout;
+        }
+        return merged;
+    }
+
+    template<class T>
+    void addBarrier(T& command, const Barrier& barrier)
+    {
+        auto resource = barrier.resource;
+        if (resource->image)
+            command.add(ImageMemoryBarrier::create(barrier.srcAccess, barrier.dstAccess, barrier.oldLayout, barrier.newLayout, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, resource->image, resource->subresourceRange));
+        else if (resource->buffer)
+            command.add(BufferMemoryBarrier::create(barrier.srcAccess, barrier.dstAccess, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, resource->buffer, resource->offset, resource->size));
+        else
+            command.add(MemoryBarrier::create(barrier.srcAccess, barrier.dstAccess));
+    }
+
+    /// Compilable placed ahead of the passes so that the transient images are created and bound to aliased memory before the passes compile them.
+    class TransientImageAllocator : public Inherit<Compilable, TransientImageAllocator>
+    {
+    public:
+        struct TransientImage
+        {
+            ref_ptr<Image> image;
+            int firstPass = 0;
+            int lastPass = 0;
+        };
+
+        std::vector<TransientImage> transientImages;
+
+        void compile(Context& context) override
+        {
+            auto deviceID = context.deviceID;
+
+            struct Block
+            {
+                VkMemoryRequirements requirements = {0, 0, ~0u};
+                std::vector<TransientImage*> images;
+
+                bool overlaps(const TransientImage& ti) const
+                {
+                    for (auto& other : images)
+                    {
+                        if (ti.firstPass <= other->lastPass && other->firstPass <= ti.lastPass) return true;
+                    }
+                    return false;
+                }
+            };
+
+            std::vector<std::pair<TransientImage*, VkMemoryRequirements>> pending;
+            for (auto& ti : transientImages)
+            {
+                if (ti.image->vk(deviceID) != VK_NULL_HANDLE) continue;
+
+                ti.image->compile(context.device);
+
+                // lazily allocated memory isn't backed by physical memory on the GPUs that support it so there's nothing to gain from aliasing it
+                if (auto memoryProperties = ti.image->preferredMemoryProperties(context.device); (memoryProperties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0)
+                {
+                    ti.image->allocateAndBindMemory(context.device, memoryProperties);
+                    continue;
+                }
+
+                pending.emplace_back(&ti, ti.image->getMemoryRequirements(deviceID));
+            }
+
+            if (pending.empty()) return;
+
+            // place the largest images first so smaller images fill the blocks they create
+            std::sort(pending.begin(), pending.end(), [](const auto& lhs, const auto& rhs) { return lhs.second.size > rhs.second.size; });
+
+            std::vector<Block> blocks;
+            VkDeviceSize totalSize = 0;
+            for (auto& [ti, requirements] : pending)
+            {
+                totalSize += requirements.size;
+
+                Block* block = nullptr;
+                for (auto& candidate : blocks)
+                {
+                    if ((candidate.requirements.memoryTypeBits & requirements.memoryTypeBits) != 0 && !candidate.overlaps(*ti))
+                    {
+                        block = &candidate;
+                        break;
+                    }
+                }
+                if (!block) block = &blocks.emplace_back();
+
+                block->requirements.size = std::max(block->requirements.size, requirements.size);
+                block->requirements.alignment = std::max(block->requirements.alignment, requirements.alignment);
+                block->requirements.memoryTypeBits &= requirements.memoryTypeBits;
+                block->images.push_back(ti);
+            }
+
+            VkDeviceSize aliasedSize = 0;
+            for (auto& block : blocks)
+            {
+                auto deviceMemory = DeviceMemory::create(context.device, block.requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                for (auto& ti : block.images)
+                {
+                    if (ti->image->bind(deviceMemory, 0) != VK_SUCCESS)
+                    {
+                        throw Exception{"Error: FrameGraph failed to bind transient image memory."};
+                    }
+                }
+                aliasedSize += block.requirements.size;
+            }
+
+            debug("FrameGraph transient images ", pending.size(), " in ", blocks.size(), " memory blocks, ", aliasedSize, " bytes in place of ", totalSize);
+        }
+
+    protected:
+        virtual ~TransientImageAllocator() {}
+    };
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////
+//
+// FrameGraphResource
+//
+FrameGraphResource::FrameGraphResource()
+{
+}
+
+FrameGraphResource::FrameGraphResource(ref_ptr<Image> in_image, const VkImageSubresourceRange& in_subresourceRange, bool in_transient) :
+    image(in_image),
+    subresourceRange(in_subresourceRange),
+    transient(in_transient)
+{
+}
+
+FrameGraphResource::FrameGraphResource(ref_ptr<Buffer> in_buffer, VkDeviceSize in_offset, VkDeviceSize in_size) :
+    buffer(in_buffer),
+    offset(in_offset),
+    size(in_size)
+{
+}
+
+FrameGraphResource::~FrameGraphResource()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// FrameGraphPass
+//
+FrameGraphPass::FrameGraphPass(ref_ptr<Node> in_node, const std::string& in_name) :
+    name(in_name),
+    node(in_node)
+{
+}
+
+FrameGraphPass::~FrameGraphPass()
+{
+}
+
+void FrameGraphPass::addRead(ref_ptr<FrameGraphResource> resource, VkPipelineStageFlags stageMask, VkAccessFlags accessMask, VkImageLayout layout)
+{
+    accesses.push_back(FrameGraphAccess{resource, stageMask, accessMask, layout, VK_IMAGE_LAYOUT_UNDEFINED, false});
+}
+
+void FrameGraphPass::addWrite(ref_ptr<FrameGraphResource> resource, VkPipelineStageFlags stageMask, VkAccessFlags accessMask, VkImageLayout layout, VkImageLayout finalLayout)
+{
+    accesses.push_back(FrameGraphAccess{resource, stageMask, accessMask, layout, finalLayout, true});
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// FrameGraph
+//
+FrameGraph::FrameGraph()
+{
+}
+
+FrameGraph::~FrameGraph()
+{
+}
+
+ref_ptr<FrameGraphResource> FrameGraph::getOrCreateResource(ref_ptr<Image> image, const VkImageSubresourceRange& subresourceRange)
+{
+    auto& resource = _resources[image.get()];
+    if (!resource) resource = FrameGraphResource::create(image, subresourceRange);
+    return resource;
+}
+
+ref_ptr<FrameGraphPass> FrameGraph::addRenderGraph(ref_ptr<RenderGraph> renderGraph, const std::string& name)
+{
+    auto pass = FrameGraphPass::create(renderGraph, name);
+    passes.push_back(pass);
+
+    auto framebuffer = renderGraph->framebuffer;
+    if (!framebuffer)
+    {
+        // window framebuffers are managed by the window, so RenderGraphs rendering to windows don't declare their attachments
+        return pass;
+    }
+
+    auto renderPass = renderGraph->renderPass ? renderGraph->renderPass.get() : framebuffer->getRenderPass();
+    auto& attachments = framebuffer->getAttachments();
+    for (size_t i = 0; i < attachments.size() && i < renderPass->attachments.size(); ++i)
+    {
+        auto& imageView = attachments[i];
+        if (!imageView || !imageView->image) continue;
+
+        auto& description = renderPass->attachments[i];
+        auto aspectMask = computeAspectFlagsForFormat(description.format);
+        bool depthStencil = (aspectMask & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) != 0;
+        bool loaded = description.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD || description.stencilLoadOp == VK_ATTACHMENT_LOAD_OP_LOAD;
+        bool stored = description.storeOp == VK_ATTACHMENT_STORE_OP_STORE || description.stencilStoreOp == VK_ATTACHMENT_STORE_OP_STORE;
+
+        bool created = _resources.count(imageView->image.get()) == 0;
+        auto resource = getOrCreateResource(imageView->image, imageView->subresourceRange);
+        if (created) resource->transient = (!loaded && !stored) || (imageView->image->usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0;
+
+        VkPipelineStageFlags stageMask = depthStencil ? (VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        VkAccessFlags readAccess = depthStencil ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+        VkAccessFlags writeAccess = depthStencil ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        // the render pass performs the transition from initialLayout to finalLayout itself
+        if (loaded) pass->addRead(resource, stageMask, readAccess, description.initialLayout);
+        pass->addWrite(resource, stageMask, writeAccess, description.initialLayout, description.finalLayout);
+    }
+
+    return pass;
+}
+
+void FrameGraph::build(Device* device)
+{
+    children.clear();
+    activePasses.clear();
+    numBarrierCommands = 0;
+
+    // cull passes, walking backwards from the passes with side effects or that write to imported resources
+    std::vector<bool> active(passes.size(), !cullUnusedPasses);
+    if (cullUnusedPasses)
+    {
+        std::set<const FrameGraphResource*> required;
+        for (size_t i = passes.size(); i > 0; --i)
+        {
+            auto& pass = passes[i - 1];
+            bool used = pass->sideEffects;
+            for (auto& fga : pass->accesses)
+            {
+                if (fga.resource && fga.write && (fga.resource->imported || required.count(fga.resource.get()) > 0)) used = true;
+            }
+
+            if (!used) continue;
+
+            active[i - 1] = true;
+            for (auto& fga : pass->accesses)
+            {
+                if (fga.resource && !fga.write) required.insert(fga.resource.get());
+            }
+        }
+    }
+
+    std::vector<std::vector<FrameGraphAccess>> accesses;
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        if (!active[i])
+        {
+            debug("FrameGraph::build() culled pass ", passes[i]->name);
+            continue;
+        }
+        activePasses.push_back(passes[i]);
+        accesses.push_back(mergedAccesses(*passes[i]));
+    }
+
+    int numPasses = static_cast<int>(activePasses.size());
+
+    // lifetimes of the transient images
+    std::map<const FrameGraphResource*, std::pair<int, int>> lifetimes;
+    for (int i = 0; i < numPasses; ++i)
+    {
+        for (auto& fga : accesses[i])
+        {
+            if (!fga.resource->transient || !fga.resource->image) continue;
+
+            auto itr = lifetimes.find(fga.resource.get());
+            if (itr == lifetimes.end())
+                lifetimes[fga.resource.get()] = {i, i};
+            else
+                itr->second.second = i;
+        }
+    }
+
+    // simulate a frame to find the state each persistent resource is left in, as the first access in the next frame has to synchronize with it
+    std::map<const FrameGraphResource*, ResourceState> endStates;
+    for (int i = 0; i < numPasses; ++i)
+    {
+        for (auto& fga : accesses[i])
+        {
+            Barrier barrier;
+            access(endStates[fga.resource.get()], fga, i, barrier);
+        }
+    }
+
+    std::map<const FrameGraphResource*, ResourceState> states;
+    for (auto& [resource, endState] : endStates)
+    {
+        auto& state = states[resource];
+        if (resource->transient) continue;
+
+        state.writeStages = endState.writeStages;
+        state.writeAccess = endState.writeAccess;
+        state.readStages = endState.readStages;
+        state.layout = resource->initialLayout;
+    }
+
+    bool useEvents = splitBarriers && device;
+
+    std::vector<Group::Children> before(numPasses), after(numPasses);
+    for (int i = 0; i < numPasses; ++i)
+    {
+        // stages and access of transient images whose lifetimes ended before this pass, that aliased images must wait on
+        VkPipelineStageFlags retiredStages = 0;
+        VkAccessFlags retiredAccess = 0;
+        if (aliasTransientImages)
+        {
+            for (auto& [resource, lifetime] : lifetimes)
+            {
+                if (lifetime.second >= i) continue;
+                auto& state = states[resource];
+                retiredStages |= state.writeStages | state.readStages;
+                retiredAccess |= state.writeAccess;
+            }
+        }
+
+        ref_ptr<PipelineBarrier> pipelineBarrier;
+        std::map<int, ref_ptr<WaitEvents>> waitEvents;
+
+        for (auto& fga : accesses[i])
+        {
+            auto resource = fga.resource.get();
+            bool firstUseOfAliased = aliasTransientImages && lifetimes.count(resource) > 0 && lifetimes[resource].first == i;
+
+            Barrier barrier;
+            bool required = access(states[resource], fga, i, barrier);
+
+            if (firstUseOfAliased && retiredStages != 0)
+            {
+                if (!required) barrier.srcStages = 0;
+                barrier.srcStages |= retiredStages;
+                barrier.srcAccess |= retiredAccess;
+                barrier.producerPass = -1;
+                required = true;
+            }
+
+            if (!required) continue;
+
+            if (useEvents && barrier.producerPass >= 0 && barrier.producerPass < i - 1)
+            {
+                auto& waitEvent = waitEvents[barrier.producerPass];
+                if (!waitEvent) waitEvent = WaitEvents::create(0, 0);
+                waitEvent->srcStageMask |= barrier.srcStages;
+                waitEvent->dstStageMask |= barrier.dstStages;
+                addBarrier(*waitEvent, barrier);
+            }
+            else
+            {
+                if (!pipelineBarrier) pipelineBarrier = PipelineBarrier::create(0, 0, 0);
+                pipelineBarrier->srcStageMask |= barrier.srcStages;
+                pipelineBarrier->dstStageMask |= barrier.dstStages;
+                addBarrier(*pipelineBarrier, barrier);
+            }
+        }
+
+        for (auto& [producerPass, waitEvent] : waitEvents)
+        {
+            auto event = Event::create(device);
+            waitEvent->add(event);
+
+            // reset once waited on so the Event can signal the next frame
+            after[producerPass].push_back(SetEvent::create(event, waitEvent->srcStageMask));
+            before[i].push_back(waitEvent);
+            before[i].push_back(ResetEvent::create(event, waitEvent->dstStageMask));
+            ++numBarrierCommands;
+        }
+
+        if (pipelineBarrier)
+        {
+            before[i].push_back(pipelineBarrier);
+            ++numBarrierCommands;
+        }
+    }
+
+    // transition resources with a finalLayout
+    ref_ptr<PipelineBarrier> finalBarrier;
+    for (auto& [resource, state] : states)
+    {
+        if (!resource->image || resource->finalLayout == VK_IMAGE_LAYOUT_UNDEFINED || resource->finalLayout == state.layout) continue;
+
+        Barrier barrier;
+        barrier.resource = const_cast<FrameGraphResource*>(resource);
+        barrier.srcStages = (state.writeStages | state.readStages) != 0 ? (state.writeStages | state.readStages) : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        barrier.srcAccess = state.writeAccess;
+        barrier.dstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = resource->finalLayout;
+
+        if (!finalBarrier) finalBarrier = PipelineBarrier::create(0, 0, 0);
+        finalBarrier->srcStageMask |= barrier.srcStages;
+        finalBarrier->dstStageMask |= barrier.dstStages;
+        addBarrier(*finalBarrier, barrier);
+    }
+
+    if (aliasTransientImages && !lifetimes.empty())
+    {
+        auto allocator = TransientImageAllocator::create();
+        for (auto& [resource, lifetime] : lifetimes)
+        {
+            allocator->transientImages.push_back(TransientImageAllocator::TransientImage{resource->image, lifetime.first, lifetime.second});
+        }
+        children.push_back(allocator);
+    }
+
+    for (int i = 0; i < numPasses; ++i)
+    {
+        children.insert(children.end(), before[i].begin(), before[i].end());
+        if (activePasses[i]->node) children.push_back(activePasses[i]->node);
+        children.insert(children.end(), after[i].begin(), after[i].end());
+    }
+
+    if (finalBarrier)
+    {
+        children.push_back(finalBarrier);
+        ++numBarrierCommands;
+    }
+
+    debug("FrameGraph::build() ", numPasses, " of ", passes.size(), " passes, ", numBarrierCommands, " barrier commands");
+}
@@ -0,0 +1,74 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/FramePacer.h>
+#include <vsg/app/Viewer.h>
+#include <vsg/utils/Instrumentation.h>
+
+#include <thread>
+
+using namespace vsg;
+
+void FramePacer::wait(Viewer& viewer)
+{
+    CPU_INSTRUMENTATION_L1_NC(viewer.instrumentation, "FramePacer wait", COLOR_VIEWER);
+
+    if (_frameStarted)
+    {
+        auto smooth = [&](double& value, double sample) { value = (value == 0.0) ? sample : value + (sample - value) * smoothing; };
+
+        // GPU completion of the previous frame gives the duration of the work, excluding any wait for the display
+        viewer.waitForFences(0, timeout);
+        auto renderCompleted = vsg::clock::now();
+        smooth(frameDuration, std::chrono::duration<double, std::chrono::seconds::period>(renderCompleted - _frameStart).count());
+
+        bool presentWaited = false;
+        for (auto& window : viewer.windows())
+        {
+            auto swapchain = window->getSwapchain();
+            auto device = window->getDevice();
+            if (!window->visible() || !swapchain || swapchain->presentId == 0 || !device) continue;
+
+            if (auto vkWaitForPresentKHR = device->getExtensions()->vkWaitForPresentKHR)
+            {
+                vkWaitForPresentKHR(device->vk(), swapchain->vk(), swapchain->presentId, timeout);
+                presentWaited = true;
+            }
+        }
+
+        auto completion = presentWaited ? vsg::clock::now() : renderCompleted;
+        latency = std::chrono::duration<double, std::chrono::seconds::period>(completion - _frameStart).count();
+
+        if (_previousCompletion != time_point{}) smooth(frameInterval, std::chrono::duration<double, std::chrono::seconds::period>(completion - _previousCompletion).count());
+        _previousCompletion = completion;
+
+        if (viewer.instrumentation)
+        {
+            viewer.instrumentation->plot("vsg frame latency (ms)", latency * 1000.0);
+            viewer.instrumentation->plot("vsg frame duration (ms)", frameDuration * 1000.0);
+        }
+
+        // without present wait the measured interval is just the viewer's own frame rate, so only pace to an explicit target
+        double interval = targetFrameTime > 0.0 ? targetFrameTime : (presentWaited ? frameInterval : 0.0);
+        if (interval > 0.0)
+        {
+            auto seconds = [](double t) { return std::chrono::duration_cast<vsg::clock::duration>(std::chrono::duration<double>(t)); };
+
+            // with present wait start the next frame so its predicted completion is just before the next present, otherwise cap the frame rate
+            auto nextStart = presentWaited ? (completion + seconds(interval - frameDuration - margin)) : (_frameStart + seconds(interval));
+            if (nextStart > vsg::clock::now()) std::this_thread::sleep_until(nextStart);
+        }
+    }
+
+    _frameStart = vsg::clock::now();
+    _frameStarted = true;
+}
@@ -0,0 +1,361 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/FrameStatistics.h>
+#include <vsg/io/Logger.h>
+#include <vsg/vk/CommandBuffer.h>
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+
+using namespace vsg;
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Timings
+//
+Timings::Timings(const std::string& in_name, size_t in_capacity) :
+    name(in_name),
+    _capacity(std::max(in_capacity, size_t(1))),
+    _values(new std::atomic<double>[_capacity])
+{
+    for (size_t i = 0; i < _capacity; ++i) _values[i].store(0.0, std::memory_order_relaxed);
+}
+
+Timings::~Timings()
+{
+}
+
+void Timings::add(double milliseconds)
+{
+    auto index = _count.load(std::memory_order_relaxed);
+    _values[index % _capacity].store(milliseconds, std::memory_order_relaxed);
+    _count.store(index + 1, std::memory_order_release);
+}
+
+size_t Timings::size() const
+{
+    return static_cast<size_t>(std::min(_count.load(std::memory_order_acquire), static_cast<uint64_t>(_capacity)));
+}
+
+double Timings::latest() const
+{
+    auto count = _count.load(std::memory_order_acquire);
+    return count > 0 ? _values[(count - 1) % _capacity].load(std::memory_order_relaxed) : 0.0;
+}
+
+std::vector<double> Timings::values() const
+{
+    auto count = _count.load(std::memory_order_acquire);
+    auto num = std::min(count, static_cast<uint64_t>(_capacity));
+
+    std::vector<double> durations;
+    durations.reserve(static_cast<size_t>(num));
+    for (uint64_t i = count - num; i < count; ++i)
+    {
+        durations.push_back(_values[i % _capacity].load(std::memory_order_relaxed));
+    }
+    return durations;
+}
+
+double Timings::average() const
+{
+    auto durations = values();
+    if (durations.empty()) return 0.0;
+
+    double total = 0.0;
+    for (auto duration : durations) total += duration;
+    return total / static_cast<double>(durations.size());
+}
+
+double Timings::percentile(double fraction) const
+{
+    auto durations = values();
+    if (durations.empty()) return 0.0;
+
+    auto index = static_cast<size_t>(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(durations.size() - 1) + 0.5);
+    std::nth_element(durations.begin(), durations.begin() + index, durations.end());
+    return durations[index];
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// FrameStatistics::GpuTimer
+//
+struct FrameStatistics::GpuTimer
+{
+    // number of frames that may be in flight before a slot's timestamps are reused, must be more than the frames that can be in flight.
+    static constexpr uint32_t numSlots = 4;
+    static constexpr uint64_t invalidFrame = std::numeric_limits<uint64_t>::max();
+
+    static constexpr VkQueryPipelineStatisticFlags pipelineStatisticFlags =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+    GpuTimer(Device* in_device, uint32_t queueFamilyIndex, bool pipelineStatistics) :
+        device(in_device),
+        pipelineStatisticsRequested(pipelineStatistics)
+    {
+        slotFrames.fill(invalidFrame);
+        statisticsSlotFrames.fill(invalidFrame);
+
+        auto physicalDevice = device->getPhysicalDevice();
+        if (pipelineStatistics)
+        {
+            if (physicalDevice->getFeatures().pipelineStatisticsQuery)
+            {
+                VkQueryPoolCreateInfo createInfo = {};
+                createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+                createInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+                createInfo.queryCount = numSlots;
+                createInfo.pipelineStatistics = pipelineStatisticFlags;
+                if (vkCreateQueryPool(*device, &createInfo, device->getAllocationCallbacks(), &statisticsQueryPool) != VK_SUCCESS) statisticsQueryPool = VK_NULL_HANDLE;
+            }
+            else
+            {
+                info("vsg::FrameStatistics pipelineStatisticsQuery not supported, pipeline statistics disabled.");
+            }
+        }
+
+        auto& queueFamilyProperties = physicalDevice->getQueueFamilyProperties();
+        uint32_t timestampValidBits = queueFamilyIndex < queueFamilyProperties.size() ? queueFamilyProperties[queueFamilyIndex].timestampValidBits : 0;
+        if (timestampValidBits == 0)
+        {
+            info("vsg::FrameStatistics timestamps not supported by queue family ", queueFamilyIndex, ", GPU timings disabled.");
+            return;
+        }
+
+        timestampMask = (timestampValidBits >= 64) ? std::numeric_limits<uint64_t>::max() : ((uint64_t(1) << timestampValidBits) - 1);
+        timestampPeriod = static_cast<double>(physicalDevice->getProperties().limits.timestampPeriod);
+
+        VkQueryPoolCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = numSlots * 2;
+        if (vkCreateQueryPool(*device, &createInfo, device->getAllocationCallbacks(), &queryPool) != VK_SUCCESS) queryPool = VK_NULL_HANDLE;
+    }
+
+    ~GpuTimer()
+    {
+        if (queryPool) vkDestroyQueryPool(*device, queryPool, device->getAllocationCallbacks());
+        if (statisticsQueryPool) vkDestroyQueryPool(*device, statisticsQueryPool, device->getAllocationCallbacks());
+    }
+
+    ref_ptr<Device> device;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    uint64_t timestampMask = 0;
+    double timestampPeriod = 1.0;
+    std::array<uint64_t, numSlots> slotFrames;
+    ref_ptr<Timings> timings;
+
+    bool pipelineStatisticsRequested = false;
+    VkQueryPool statisticsQueryPool = VK_NULL_HANDLE;
+    std::array<uint64_t, numSlots> statisticsSlotFrames;
+};
+
+/////////////////////////////////////////////////////////////////////////
+//
+// FrameStatistics::PipelineStatistics
+//
+FrameStatistics::PipelineStatistics& FrameStatistics::PipelineStatistics::operator+=(const PipelineStatistics& rhs)
+{
+    inputAssemblyVertices += rhs.inputAssemblyVertices;
+    inputAssemblyPrimitives += rhs.inputAssemblyPrimitives;
+    vertexShaderInvocations += rhs.vertexShaderInvocations;
+    clippingInvocations += rhs.clippingInvocations;
+    clippingPrimitives += rhs.clippingPrimitives;
+    fragmentShaderInvocations += rhs.fragmentShaderInvocations;
+    computeShaderInvocations += rhs.computeShaderInvocations;
+    return *this;
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// FrameStatistics
+//
+FrameStatistics::FrameStatistics(size_t in_capacity) :
+    capacity(in_capacity)
+{
+    const char* names[NUM_STAGES] = {"Frame", "Acquire", "Events", "DatabasePager merge", "Update", "Record and submit", "Present"};
+    for (auto name : names)
+    {
+        _stages.push_back(Timings::create(name, capacity));
+    }
+}
+
+FrameStatistics::~FrameStatistics()
+{
+}
+
+ref_ptr<Timings> FrameStatistics::recordTimings(const Object* commandGraph)
+{
+    std::scoped_lock lock(_mutex);
+    return _getOrCreateTimings(_recordTimings, "Record ", commandGraph);
+}
+
+ref_ptr<Timings> FrameStatistics::gpuTimings(const Object* renderGraph)
+{
+    std::scoped_lock lock(_mutex);
+    return _getOrCreateTimings(_gpuTimings, "GPU ", renderGraph);
+}
+
+ref_ptr<Timings> FrameStatistics::_getOrCreateTimings(std::map<const Object*, ref_ptr<Timings>>& timingsMap, const char* prefix, const Object* object)
+{
+    auto& timings = timingsMap[object];
+    if (!timings) timings = Timings::create(prefix + std::string(object->className()) + " " + std::to_string(timingsMap.size() - 1), capacity);
+    return timings;
+}
+
+double FrameStatistics::latestGpuTime() const
+{
+    std::scoped_lock lock(_mutex);
+
+    double total = 0.0;
+    for (auto& [renderGraph, timings] : _gpuTimings) total += timings->latest();
+    return total;
+}
+
+std::vector<ref_ptr<Timings>> FrameStatistics::getTimings() const
+{
+    std::scoped_lock lock(_mutex);
+
+    auto timings = _stages;
+    for (auto& [object, objectTimings] : _recordTimings) timings.push_back(objectTimings);
+    for (auto& [object, objectTimings] : _gpuTimings) timings.push_back(objectTimings);
+    return timings;
+}
+
+FrameStatistics::GpuTimer* FrameStatistics::_gpuTimer(const Object* renderGraph, CommandBuffer& commandBuffer)
+{
+    std::scoped_lock lock(_mutex);
+    auto& timer = _gpuTimers[renderGraph];
+    if (!timer || timer->device != commandBuffer.getDevice() || (recordPipelineStatistics && !timer->pipelineStatisticsRequested))
+    {
+        timer.reset(new GpuTimer(commandBuffer.getDevice(), commandBuffer.getCommandPool()->queueFamilyIndex, recordPipelineStatistics));
+        timer->timings = _getOrCreateTimings(_gpuTimings, "GPU ", renderGraph);
+    }
+    return timer.get();
+}
+
+void FrameStatistics::beginGpuTiming(const Object* renderGraph, CommandBuffer& commandBuffer, uint64_t frameCount)
+{
+    if (!recordGpuTimings && !recordPipelineStatistics) return;
+
+    auto timer = _gpuTimer(renderGraph, commandBuffer);
+    uint32_t slot = static_cast<uint32_t>(frameCount % GpuTimer::numSlots);
+
+    if (recordPipelineStatistics && timer->statisticsQueryPool)
+    {
+        if (timer->statisticsSlotFrames[slot] != GpuTimer::invalidFrame)
+        {
+            // gather the statistics of the frame that last used this slot, if it hasn't completed yet just skip them
+            uint64_t results[7] = {};
+            if (vkGetQueryPoolResults(*timer->device, timer->statisticsQueryPool, slot, 1, sizeof(results), results, sizeof(results), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+            {
+                PipelineStatistics stats{results[0], results[1], results[2], results[3], results[4], results[5], results[6]};
+
+                std::scoped_lock lock(_mutex);
+                _pipelineStatistics[renderGraph] = stats;
+                _pendingCounters.pipeline += stats;
+            }
+        }
+
+        vkCmdResetQueryPool(commandBuffer, timer->statisticsQueryPool, slot, 1);
+        vkCmdBeginQuery(commandBuffer, timer->statisticsQueryPool, slot, 0);
+        timer->statisticsSlotFrames[slot] = frameCount;
+    }
+    else if (timer->statisticsQueryPool)
+    {
+        timer->statisticsSlotFrames[slot] = GpuTimer::invalidFrame;
+    }
+
+    if (!recordGpuTimings || !timer->queryPool) return;
+    if (timer->slotFrames[slot] != GpuTimer::invalidFrame)
+    {
+        // gather the timestamps written when this slot was last used, if the frame hasn't completed yet just skip its timing
+        uint64_t timestamps[2] = {0, 0};
+        if (vkGetQueryPoolResults(*timer->device, timer->queryPool, slot * 2, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            uint64_t ticks = (timestamps[1] - timestamps[0]) & timer->timestampMask;
+            timer->timings->add(static_cast<double>(ticks) * timer->timestampPeriod * 1e-6);
+        }
+    }
+
+    vkCmdResetQueryPool(commandBuffer, timer->queryPool, slot * 2, 2);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timer->queryPool, slot * 2);
+    timer->slotFrames[slot] = frameCount;
+}
+
+void FrameStatistics::endGpuTiming(const Object* renderGraph, CommandBuffer& commandBuffer, uint64_t frameCount)
+{
+    if (!recordGpuTimings && !recordPipelineStatistics) return;
+
+    auto timer = _gpuTimer(renderGraph, commandBuffer);
+    uint32_t slot = static_cast<uint32_t>(frameCount % GpuTimer::numSlots);
+
+    if (timer->statisticsQueryPool && timer->statisticsSlotFrames[slot] == frameCount) vkCmdEndQuery(commandBuffer, timer->statisticsQueryPool, slot);
+
+    if (!recordGpuTimings || !timer->queryPool || timer->slotFrames[slot] != frameCount) return;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timer->queryPool, slot * 2 + 1);
+}
+
+void FrameStatistics::addCounters(const CommandBuffer::RecordStatistics& record, const RecordTraversal::CullStatistics& cull)
+{
+    std::scoped_lock lock(_mutex);
+    _pendingCounters.record += record;
+    _pendingCounters.cull += cull;
+}
+
+void FrameStatistics::advanceCounters(uint64_t frameCount)
+{
+    std::scoped_lock lock(_mutex);
+    _latestCounters = _pendingCounters;
+    _pendingCounters = {};
+    _pendingCounters.frameCount = frameCount;
+}
+
+FrameStatistics::Counters FrameStatistics::latestCounters() const
+{
+    std::scoped_lock lock(_mutex);
+    return _latestCounters;
+}
+
+FrameStatistics::PipelineStatistics FrameStatistics::pipelineStatistics(const Object* renderGraph) const
+{
+    std::scoped_lock lock(_mutex);
+    auto itr = _pipelineStatistics.find(renderGraph);
+    return itr != _pipelineStatistics.end() ? itr->second : PipelineStatistics{};
+}
+
+void FrameStatistics::report(std::ostream& out) const
+{
+    out << std::fixed << std::setprecision(3);
+    out << "FrameStatistics (ms)      latest    average     50th     95th     99th" << std::endl;
+    for (auto& timings : getTimings())
+    {
+        if (timings->size() == 0) continue;
+
+        out << std::left << std::setw(24) << timings->name << std::right
+            << std::setw(10) << timings->latest()
+            << std::setw(10) << timings->average()
+            << std::setw(9) << timings->percentile(0.5)
+            << std::setw(9) << timings->percentile(0.95)
+            << std::setw(9) << timings->percentile(0.99) << std::endl;
+    }
+}
@@ -0,0 +1,141 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/GpuTimestamps.h>
+#include <vsg/io/Logger.h>
+#include <vsg/vk/CommandBuffer.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+GpuTimestamps::GpuTimestamps(uint32_t in_numFrames) :
+    numFrames(std::max(in_numFrames, 2u)),
+    _frames(numFrames)
+{
+}
+
+GpuTimestamps::~GpuTimestamps()
+{
+    for (auto& frame : _frames)
+    {
+        if (frame.queryPool) vkDestroyQueryPool(*_device, frame.queryPool, _device->getAllocationCallbacks());
+    }
+}
+
+void GpuTimestamps::_collect(Frame& frame)
+{
+    // results of regions whose frame hasn't completed yet, or whose end timestamp wasn't written, are skipped rather than waited on
+    for (auto& region : frame.regions)
+    {
+        uint64_t timestamps[2] = {0, 0};
+        if (vkGetQueryPoolResults(*_device, frame.queryPool, region.query, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            uint64_t ticks = (timestamps[1] - timestamps[0]) & _timestampMask;
+            region.timings->add(static_cast<double>(ticks) * _timestampPeriod * 1e-6);
+        }
+    }
+    frame.regions.clear();
+    frame.used = 0;
+}
+
+void GpuTimestamps::beginFrame(CommandBuffer& commandBuffer, uint64_t frameCount)
+{
+    std::scoped_lock lock(_mutex);
+
+    _current = nullptr;
+
+    auto device = commandBuffer.getDevice();
+    if (_device != device)
+    {
+        for (auto& frame : _frames)
+        {
+            if (frame.queryPool) vkDestroyQueryPool(*_device, frame.queryPool, _device->getAllocationCallbacks());
+            frame = {};
+        }
+
+        _device = device;
+
+        auto physicalDevice = device->getPhysicalDevice();
+        auto& queueFamilyProperties = physicalDevice->getQueueFamilyProperties();
+        uint32_t queueFamilyIndex = commandBuffer.getCommandPool()->queueFamilyIndex;
+        uint32_t timestampValidBits = queueFamilyIndex < queueFamilyProperties.size() ? queueFamilyProperties[queueFamilyIndex].timestampValidBits : 0;
+        if (timestampValidBits == 0) info("vsg::GpuTimestamps timestamps not supported by queue family ", queueFamilyIndex, ", GPU timings disabled.");
+
+        _timestampMask = (timestampValidBits >= 64) ? std::numeric_limits<uint64_t>::max() : ((uint64_t(1) << timestampValidBits) - 1);
+        _timestampPeriod = static_cast<double>(physicalDevice->getProperties().limits.timestampPeriod);
+    }
+
+    // no query pools are created until a region has requested timing
+    if (_timestampMask == 0 || _requiredCount == 0) return;
+
+    auto& frame = _frames[frameCount % numFrames];
+    if (frame.queryPool) _collect(frame);
+
+    if (frame.capacity < _requiredCount)
+    {
+        // the GPU has finished with the pool as its frame is more than the number of frames in flight behind, so it can be replaced with a larger one
+        if (frame.queryPool) vkDestroyQueryPool(*_device, frame.queryPool, _device->getAllocationCallbacks());
+
+        VkQueryPoolCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = _requiredCount;
+        if (vkCreateQueryPool(*_device, &createInfo, _device->getAllocationCallbacks(), &frame.queryPool) != VK_SUCCESS)
+        {
+            frame = {};
+            return;
+        }
+        frame.capacity = _requiredCount;
+    }
+
+    vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, frame.capacity);
+    _current = &frame;
+}
+
+uint32_t GpuTimestamps::begin(CommandBuffer& commandBuffer, ref_ptr<Timings> timings)
+{
+    std::scoped_lock lock(_mutex);
+
+    if (!timings) return 0;
+
+    if (!_current)
+    {
+        // first region to be timed so request query pools from the next frame
+        _requiredCount = std::max(_requiredCount, initialQueryCount);
+        return 0;
+    }
+
+    auto& frame = *_current;
+    if ((frame.used + 2) > frame.capacity)
+    {
+        // not enough queries for this frame, so grow the pools the next time they are used
+        _requiredCount = std::max(_requiredCount, frame.capacity * 2);
+        return 0;
+    }
+
+    uint32_t query = frame.used;
+    frame.used += 2;
+    frame.regions.push_back(Region{timings, query});
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, query);
+
+    return query + 2;
+}
+
+void GpuTimestamps::end(CommandBuffer& commandBuffer, uint32_t reference)
+{
+    if (reference == 0) return;
+
+    std::scoped_lock lock(_mutex);
+    if (_current) vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _current->queryPool, reference - 1);
+}
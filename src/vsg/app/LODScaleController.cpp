@@ -0,0 +1,66 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/LODScaleController.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+LODScaleController::LODScaleController(ref_ptr<FrameStatistics> in_frameStatistics, ref_ptr<DatabasePager> in_databasePager, const std::vector<ref_ptr<View>>& in_views) :
+    frameStatistics(in_frameStatistics),
+    databasePager(in_databasePager),
+    views(in_views)
+{
+}
+
+LODScaleController::~LODScaleController()
+{
+}
+
+void LODScaleController::run()
+{
+    auto activeTimings = timings ? timings.get() : (frameStatistics ? &frameStatistics->stage(FrameStatistics::FRAME) : nullptr);
+    if (activeTimings && activeTimings->count() != _timingsCount)
+    {
+        _timingsCount = activeTimings->count();
+
+        double frameTime = activeTimings->latest();
+        _smoothedFrameTime = (_smoothedFrameTime > 0.0) ? (_smoothedFrameTime + smoothing * (frameTime - _smoothedFrameTime)) : frameTime;
+
+        // small multiplicative steps each frame so detail changes gradually rather than popping
+        if (targetFrameTime > 0.0)
+        {
+            double ratio = _smoothedFrameTime / targetFrameTime;
+            if (ratio > decreaseThreshold)
+                lodBias *= (1.0 + adjustmentRate);
+            else if (ratio < increaseThreshold)
+                lodBias /= (1.0 + adjustmentRate);
+        }
+        lodBias = std::clamp(lodBias, minimumLodBias, maximumLodBias);
+    }
+
+    if (databasePager && saturatedActiveRequests > 0)
+    {
+        double load = static_cast<double>(databasePager->numActiveRequests.load()) / static_cast<double>(saturatedActiveRequests);
+        double targetRequestLodBias = std::clamp(1.0 + (saturatedRequestLodBias - 1.0) * (load - 1.0), 1.0, maximumRequestLodBias);
+
+        // smooth the changes so that requests aren't toggled on and off as individual tiles complete
+        requestLodBias += smoothing * (targetRequestLodBias - requestLodBias);
+    }
+
+    for (auto& view : views)
+    {
+        view->lodBias = lodBias;
+        view->requestLodBias = requestLodBias;
+    }
+}
@@ -0,0 +1,481 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/MemoryDefragmenter.h>
+#include <vsg/app/RecordSignature.h>
+#include <vsg/commands/BindIndexBuffer.h>
+#include <vsg/commands/BindVertexBuffers.h>
+#include <vsg/io/Logger.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/VertexDraw.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/ui/UIEvent.h>
+#include <vsg/vk/SubmitCommands.h>
+
+#include <limits>
+#include <set>
+
+using namespace vsg;
+
+/// Collector traverses a scene graph collecting the BufferInfo referenced by commands and descriptor sets
+struct MemoryDefragmenter::Collector : public Visitor
+{
+    std::map<BufferInfo*, Reference> references;
+    std::map<DescriptorSet*, std::vector<ref_ptr<StateCommand>>> descriptorSetBinders;
+    std::map<const Descriptor*, uint32_t> descriptorReferences;
+
+    std::set<const Object*> visited;
+    DescriptorSet* currentDescriptorSet = nullptr;
+
+    bool firstVisit(const Object& object) { return visited.insert(&object).second; }
+
+    void add(Command& command, const ref_ptr<BufferInfo>& bufferInfo)
+    {
+        if (!bufferInfo || !bufferInfo->buffer) return;
+
+        auto& reference = references[bufferInfo.get()];
+        reference.bufferInfo = bufferInfo;
+        ++reference.count;
+        reference.commands.emplace_back(&command);
+    }
+
+    void add(Command& command, const BufferInfoList& bufferInfoList)
+    {
+        for (auto& bufferInfo : bufferInfoList) add(command, bufferInfo);
+    }
+
+    void addBinder(StateCommand& binder, const ref_ptr<DescriptorSet>& descriptorSet)
+    {
+        if (!descriptorSet) return;
+
+        descriptorSetBinders[descriptorSet.get()].emplace_back(&binder);
+        descriptorSet->accept(*this);
+    }
+
+    void apply(Object& object) override
+    {
+        if (firstVisit(object)) object.traverse(*this);
+    }
+
+    void apply(StateGroup& stateGroup) override
+    {
+        if (!firstVisit(stateGroup)) return;
+
+        for (auto& stateCommand : stateGroup.stateCommands) stateCommand->accept(*this);
+        stateGroup.traverse(*this);
+    }
+
+    void apply(VertexDraw& vd) override
+    {
+        if (firstVisit(vd)) add(vd, vd.arrays);
+    }
+
+    void apply(VertexIndexDraw& vid) override
+    {
+        if (!firstVisit(vid)) return;
+
+        add(vid, vid.arrays);
+        add(vid, vid.indices);
+    }
+
+    void apply(Geometry& geometry) override
+    {
+        if (!firstVisit(geometry)) return;
+
+        add(geometry, geometry.arrays);
+        add(geometry, geometry.indices);
+    }
+
+    void apply(BindVertexBuffers& bvb) override
+    {
+        if (firstVisit(bvb)) add(bvb, bvb.arrays);
+    }
+
+    void apply(BindIndexBuffer& bib) override
+    {
+        if (firstVisit(bib)) add(bib, bib.indices);
+    }
+
+    void apply(BindDescriptorSet& bds) override
+    {
+        if (firstVisit(bds)) addBinder(bds, bds.descriptorSet);
+    }
+
+    void apply(BindDescriptorSets& bds) override
+    {
+        if (!firstVisit(bds)) return;
+
+        for (auto& descriptorSet : bds.descriptorSets) addBinder(bds, descriptorSet);
+    }
+
+    void apply(DescriptorSet& descriptorSet) override
+    {
+        if (!firstVisit(descriptorSet)) return;
+
+        currentDescriptorSet = &descriptorSet;
+        for (auto& descriptor : descriptorSet.descriptors) descriptor->accept(*this);
+        currentDescriptorSet = nullptr;
+    }
+
+    void apply(DescriptorBuffer& db) override
+    {
+        // only track DescriptorBuffer found via a DescriptorSet, they are counted for each DescriptorSet they are found in
+        if (!currentDescriptorSet) return;
+
+        bool first = (++descriptorReferences[&db] == 1);
+        for (auto& bufferInfo : db.bufferInfoList)
+        {
+            if (!bufferInfo || !bufferInfo->buffer) continue;
+
+            auto& reference = references[bufferInfo.get()];
+            reference.bufferInfo = bufferInfo;
+            reference.descriptorSets.push_back(currentDescriptorSet);
+            if (first)
+            {
+                ++reference.count;
+                reference.descriptors.push_back(&db);
+            }
+        }
+    }
+};
+
+void MemoryDefragmenter::Statistics::report(std::ostream& out) const
+{
+    out << "numBuffers = " << numBuffers << ", numDeviceMemory = " << numDeviceMemory << ", totalBufferSize = " << totalBufferSize << ", reservedSize = " << reservedSize
+        << ", availableSize = " << availableSize << ", largestAvailableSize = " << largestAvailableSize << ", occupancy = " << occupancy() << ", fragmentation = " << fragmentation();
+}
+
+MemoryDefragmenter::MemoryDefragmenter(ref_ptr<Device> in_device, ref_ptr<Node> in_scene) :
+    device(in_device),
+    scene(in_scene)
+{
+    context = Context::create(device.get());
+
+    _queueFamilyIndex = static_cast<uint32_t>(device->getPhysicalDevice()->getQueueFamily(VK_QUEUE_GRAPHICS_BIT));
+    _queue = device->getQueue(_queueFamilyIndex);
+    _commandPool = CommandPool::create(device, _queueFamilyIndex, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+    _fence = Fence::create(device);
+}
+
+MemoryDefragmenter::~MemoryDefragmenter()
+{
+    for (auto& retired : _retired)
+    {
+        if (retired.buffer) retired.buffer->release(retired.offset, retired.range);
+        DescriptorSet::Implementation::recycle(retired.descriptorSet);
+    }
+}
+
+MemoryDefragmenter::Statistics MemoryDefragmenter::_computeStatistics(const std::map<BufferInfo*, Reference>& references) const
+{
+    std::set<const Buffer*> buffers;
+    for (auto& entry : references)
+    {
+        buffers.insert(entry.second.bufferInfo->buffer.get());
+    }
+
+    Statistics statistics;
+    std::set<const DeviceMemory*> deviceMemories;
+    for (auto& buffer : buffers)
+    {
+        ++statistics.numBuffers;
+        statistics.totalBufferSize += buffer->size;
+        statistics.reservedSize += buffer->totalReservedSize();
+        statistics.availableSize += buffer->totalAvailableSize();
+        statistics.largestAvailableSize = std::max(statistics.largestAvailableSize, static_cast<VkDeviceSize>(buffer->maximumAvailableSpace()));
+
+        if (auto deviceMemory = buffer->getDeviceMemory(device->deviceID)) deviceMemories.insert(deviceMemory);
+    }
+    statistics.numDeviceMemory = deviceMemories.size();
+
+    return statistics;
+}
+
+MemoryDefragmenter::Statistics MemoryDefragmenter::computeStatistics() const
+{
+    if (!scene) return {};
+
+    Collector collector;
+    scene->accept(collector);
+
+    return _computeStatistics(collector.references);
+}
+
+void MemoryDefragmenter::_startPass()
+{
+    if (!scene) return;
+
+    Collector collector;
+    scene->accept(collector);
+
+    _references.swap(collector.references);
+    _descriptorSetBinders.swap(collector.descriptorSetBinders);
+    _descriptorReferences.swap(collector.descriptorReferences);
+
+    statisticsBefore = _computeStatistics(_references);
+
+    // group the references by the BufferInfo that holds the Buffer reservation
+    std::map<BufferInfo*, Allocation> allocations;
+    for (auto& [bufferInfo, reference] : _references)
+    {
+        BufferInfo* root = bufferInfo->parent ? bufferInfo->parent.get() : bufferInfo;
+
+        auto& allocation = allocations[root];
+        allocation.root = root;
+        allocation.references.push_back(&reference);
+    }
+
+    // group the allocations by Buffer
+    std::map<Buffer*, Source> sources;
+    for (auto& [root, allocation] : allocations)
+    {
+        if (!allocation.root->buffer) continue;
+
+        auto& source = sources[allocation.root->buffer.get()];
+        source.buffer = allocation.root->buffer;
+        source.allocations.push_back(std::move(allocation));
+    }
+
+    std::multimap<double, Source*> candidates;
+    for (auto& [buffer, source] : sources)
+    {
+        // Buffers have to be copyable, and only relocating allocations from Buffers that all of their reservations are known about will allow the Buffer to be freed
+        if ((buffer->usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT) == 0 || !buffer->getDeviceMemory(device->deviceID)) continue;
+
+        VkDeviceSize totalRange = 0;
+        for (auto& allocation : source.allocations) totalRange += allocation.root->range;
+
+        double occupancy = static_cast<double>(buffer->totalReservedSize()) / static_cast<double>(buffer->size);
+        if (occupancy < occupancyThreshold && totalRange == buffer->totalReservedSize())
+        {
+            candidates.emplace(occupancy, &source);
+        }
+    }
+
+    // relocate from the least occupied Buffers first
+    for (auto& candidate : candidates)
+    {
+        _sources.push_back(std::move(*candidate.second));
+    }
+
+    debug("MemoryDefragmenter::_startPass() ", _sources.size(), " of ", sources.size(), " Buffers to relocate.");
+
+    if (_sources.empty()) _endPass();
+}
+
+void MemoryDefragmenter::_endPass()
+{
+    _sources.clear();
+    _references.clear();
+    _descriptorSetBinders.clear();
+    _descriptorReferences.clear();
+
+    statisticsAfter = computeStatistics();
+
+    _nextPassFrameCount = _frameCount + numFramesBetweenPasses;
+}
+
+bool MemoryDefragmenter::_movable(const Allocation& allocation) const
+{
+    auto deviceID = device->deviceID;
+
+    // the Allocation holds one reference to the root
+    uint32_t expectedRootReferences = 1;
+
+    for (auto& reference : allocation.references)
+    {
+        auto& bufferInfo = reference->bufferInfo;
+
+        // dynamic data and data pending a copy will be written to the Buffer that it's assigned so can't be relocated
+        if (bufferInfo->data && (bufferInfo->data->dynamic() || bufferInfo->requiresCopy(deviceID))) return false;
+
+        // references from outside the scene graph would be left with stale Vulkan handles
+        if (bufferInfo == allocation.root)
+        {
+            expectedRootReferences += 1 + reference->count;
+        }
+        else
+        {
+            if (bufferInfo->referenceCount() != 1 + reference->count) return false;
+            ++expectedRootReferences;
+        }
+
+        for (auto& descriptor : reference->descriptors)
+        {
+            if (auto itr = _descriptorReferences.find(descriptor); itr == _descriptorReferences.end() || descriptor->referenceCount() != itr->second) return false;
+        }
+
+        for (auto& descriptorSet : reference->descriptorSets)
+        {
+            if (auto itr = _descriptorSetBinders.find(descriptorSet); itr == _descriptorSetBinders.end() || descriptorSet->referenceCount() != itr->second.size()) return false;
+        }
+    }
+
+    return allocation.root->referenceCount() == expectedRootReferences;
+}
+
+void MemoryDefragmenter::_relocate(Source& source)
+{
+    auto deviceID = device->deviceID;
+    auto& buffer = source.buffer;
+
+    auto deviceMemory = buffer->getDeviceMemory(deviceID);
+    if (!deviceMemory) return;
+
+    auto memoryProperties = deviceMemory->getMemoryPropertyFlags();
+
+    // preserve the alignment of the original offset so that the offsets of BufferInfo that share the reservation remain aligned
+    const VkDeviceSize maxAlignment = 256;
+
+    struct Move
+    {
+        Allocation* allocation;
+        ref_ptr<BufferInfo> destination;
+    };
+    std::vector<Move> moves;
+    std::map<ref_ptr<Buffer>, std::vector<VkBufferCopy>> regions;
+
+    for (auto& allocation : source.allocations)
+    {
+        auto& root = allocation.root;
+        if (root->buffer != buffer || !_movable(allocation)) continue;
+
+        VkDeviceSize alignment = (root->offset == 0) ? maxAlignment : std::min(root->offset & (~root->offset + 1), maxAlignment);
+        auto destination = context->deviceMemoryBufferPools->reserveBuffer(root->range, alignment, buffer->usage, buffer->sharingMode, memoryProperties);
+        if (!destination) break;
+
+        if (destination->buffer == buffer)
+        {
+            destination->release();
+            continue;
+        }
+
+        regions[destination->buffer].push_back(VkBufferCopy{root->offset, destination->offset, root->range});
+        moves.push_back(Move{&allocation, destination});
+    }
+
+    if (moves.empty()) return;
+
+    submitCommandsToQueue(_commandPool, _fence, std::numeric_limits<uint64_t>::max(), _queue, [&](CommandBuffer& commandBuffer) {
+        for (auto& [destinationBuffer, copyRegions] : regions)
+        {
+            vkCmdCopyBuffer(commandBuffer, buffer->vk(deviceID), destinationBuffer->vk(deviceID), static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+        }
+
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    });
+    _fence->reset();
+
+    std::set<ref_ptr<Command>> commands;
+    std::set<DescriptorSet*> descriptorSets;
+
+    for (auto& move : moves)
+    {
+        auto& root = move.allocation->root;
+        auto& destination = move.destination;
+
+        // retain the original slot until command buffers still in flight have completed
+        _retired.push_back(Retired{buffer, root->offset, root->range, {}, _frameCount});
+
+        for (auto& reference : move.allocation->references)
+        {
+            auto& bufferInfo = reference->bufferInfo;
+            if (bufferInfo != root)
+            {
+                bufferInfo->buffer = destination->buffer;
+                bufferInfo->offset = destination->offset + (bufferInfo->offset - root->offset);
+            }
+
+            commands.insert(reference->commands.begin(), reference->commands.end());
+            descriptorSets.insert(reference->descriptorSets.begin(), reference->descriptorSets.end());
+        }
+
+        // transfer the reservation to the root
+        root->buffer = destination->buffer;
+        root->offset = destination->offset;
+        destination->buffer = {};
+        destination->range = 0;
+    }
+
+    // replace the descriptor sets so that descriptor sets used by command buffers in flight aren't modified
+    for (auto& descriptorSet : descriptorSets)
+    {
+        _retired.push_back(Retired{{}, 0, 0, descriptorSet->detach(deviceID), _frameCount});
+        descriptorSet->compile(*context);
+
+        for (auto& binder : _descriptorSetBinders[descriptorSet]) binder->compile(*context);
+    }
+
+    // update the Vulkan handles cached by the commands
+    for (auto& command : commands)
+    {
+        command->compile(*context);
+    }
+
+    // command buffers reused by CommandGraph::reuseCommandBuffers still reference the relocated Buffers and replaced descriptor sets
+    RecordSignature::invalidate();
+}
+
+void MemoryDefragmenter::run()
+{
+    ++_frameCount;
+
+    size_t numReleased = 0;
+    while (!_retired.empty() && (_frameCount - _retired.front().frameCount) > numFramesToRetainReleased)
+    {
+        auto& retired = _retired.front();
+        if (retired.buffer) retired.buffer->release(retired.offset, retired.range);
+        DescriptorSet::Implementation::recycle(retired.descriptorSet);
+        _retired.pop_front();
+        ++numReleased;
+    }
+
+    if (numReleased > 0 && _retired.empty())
+    {
+        // release the Buffers and DeviceMemory that have been emptied
+        VkDeviceSize totalReleased = context->deviceMemoryBufferPools->releaseUnused();
+        for (auto& pools : memoryBufferPools)
+        {
+            if (pools) totalReleased += pools->releaseUnused();
+        }
+        debug("MemoryDefragmenter::run() released ", totalReleased, " bytes of unused Buffers and DeviceMemory.");
+    }
+
+    if (_sources.empty())
+    {
+        if (_frameCount < _nextPassFrameCount) return;
+
+        _startPass();
+    }
+
+    auto startTime = vsg::clock::now();
+    while (!_sources.empty())
+    {
+        _relocate(_sources.front());
+        _sources.pop_front();
+
+        if (_sources.empty())
+        {
+            _endPass();
+            break;
+        }
+
+        if (std::chrono::duration<double>(vsg::clock::now() - startTime).count() >= timeBudget) break;
+    }
+}
@@ -0,0 +1,536 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/OITRenderGraph.h>
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/commands/Draw.h>
+#include <vsg/commands/NextSubPass.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/nodes/Bin.h>
+#include <vsg/nodes/Light.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/DepthStencilState.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/MultisampleState.h>
+#include <vsg/state/RasterizationState.h>
+#include <vsg/state/VertexInputState.h>
+
+#include <cstring>
+
+using namespace vsg;
+
+namespace
+{
+    const char* oit_output_declaration = "layout(location = 0) out vec4 outColor;";
+
+    const char* oit_outputs = R"(vec4 outColor;
+
+layout(location = 0) out vec4 outAccumulation;
+layout(location = 1) out float outRevealage;)";
+
+    const char* oit_main = R"(
+
+void main()
+{
+    vsg_shade();
+
+    // equation (10) of McGuire and Bavoil 2013, using 1.0 - gl_FragCoord.z as the depth as VSG uses a reversed depth range
+    float alpha = outColor.a;
+    float z = 1.0 - gl_FragCoord.z;
+    float weight = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - z * 0.9, 3.0), 1e-2, 3e3);
+
+    outAccumulation = vec4(outColor.rgb * alpha, alpha) * weight;
+    outRevealage = alpha;
+}
+)";
+
+    const char* oit_composite_vert = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+out gl_PerVertex{ vec4 gl_Position; };
+
+void main()
+{
+    // full screen triangle
+    gl_Position = vec4(vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2) * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    const char* oit_composite_frag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput accumulationInput;
+layout(input_attachment_index = 1, set = 0, binding = 1) uniform subpassInput revealageInput;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    float revealage = subpassLoad(revealageInput).r;
+
+    // no transparent fragments were accumulated for this pixel
+    if (revealage >= 1.0) discard;
+
+    vec4 accumulation = subpassLoad(accumulationInput);
+    outColor = vec4(accumulation.rgb / max(accumulation.a, 1e-5), 1.0 - revealage);
+}
+)";
+
+    ref_ptr<ImageView> createAttachment(Device* device, const VkExtent2D& extent, VkFormat format, VkImageUsageFlags usage, VkImageAspectFlags aspectFlags)
+    {
+        auto image = Image::create();
+        image->imageType = VK_IMAGE_TYPE_2D;
+        image->extent = VkExtent3D{extent.width, extent.height, 1};
+        image->mipLevels = 1;
+        image->arrayLayers = 1;
+        image->format = format;
+        image->tiling = VK_IMAGE_TILING_OPTIMAL;
+        image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image->samples = VK_SAMPLE_COUNT_1_BIT;
+        image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image->usage = usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        image->compile(device);
+
+        // accumulation, revealage and depth are never stored so can be lazily allocated, keeping them on chip on tile based GPUs
+        image->allocateAndBindMemory(device, image->preferredMemoryProperties(device));
+
+        auto imageView = ImageView::create(image, aspectFlags);
+        imageView->compile(device);
+        return imageView;
+    }
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// OITRenderGraph
+//
+OITRenderGraph::OITRenderGraph(ref_ptr<Window> in_window, ref_ptr<View> in_view, int32_t transparentBinNumber, ref_ptr<const Options> options) :
+    view(in_view),
+    transparencyBuffer(NUM_ATTACHMENTS)
+{
+    window = in_window;
+
+    // the dynamic rendering path only supports a single subpass
+    dynamicRendering = false;
+
+    auto device = window->getOrCreateDevice();
+
+    if (window->framebufferSamples() != VK_SAMPLE_COUNT_1_BIT)
+    {
+        info("OITRenderGraph::OITRenderGraph() multisampled windows are not supported, the transparency buffer is single sampled.");
+    }
+
+    auto attachment = [](VkFormat format, VkAttachmentStoreOp storeOp, VkImageLayout finalLayout) {
+        AttachmentDescription description = {};
+        description.format = format;
+        description.samples = VK_SAMPLE_COUNT_1_BIT;
+        description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        description.storeOp = storeOp;
+        description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        description.finalLayout = finalLayout;
+        return description;
+    };
+
+    // only the swapchain image is stored
+    RenderPass::Attachments attachments(NUM_ATTACHMENTS);
+    attachments[COLOR] = attachment(window->surfaceFormat().format, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    attachments[ACCUMULATION] = attachment(accumulationFormat, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    attachments[REVEALAGE] = attachment(revealageFormat, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    attachments[DEPTH] = attachment(window->depthFormat(), VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+
+    // subpass 0 renders the opaque scene
+    SubpassDescription opaqueSubpass = {};
+    opaqueSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    opaqueSubpass.colorAttachments.push_back(AttachmentReference{COLOR, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    opaqueSubpass.depthStencilAttachments.push_back(AttachmentReference{DEPTH, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
+
+    // subpass 1 accumulates the transparent geometry, depth tested against the opaque scene but not written
+    SubpassDescription transparentSubpass = {};
+    transparentSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    transparentSubpass.colorAttachments.push_back(AttachmentReference{ACCUMULATION, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    transparentSubpass.colorAttachments.push_back(AttachmentReference{REVEALAGE, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    transparentSubpass.depthStencilAttachments.push_back(AttachmentReference{DEPTH, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL});
+    transparentSubpass.preserveAttachments.push_back(COLOR);
+
+    // subpass 2 reads the accumulation and revealage as input attachments and blends the result over the opaque color
+    SubpassDescription compositeSubpass = {};
+    compositeSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    compositeSubpass.inputAttachments.push_back(AttachmentReference{ACCUMULATION, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT});
+    compositeSubpass.inputAttachments.push_back(AttachmentReference{REVEALAGE, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT});
+    compositeSubpass.colorAttachments.push_back(AttachmentReference{COLOR, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+
+    RenderPass::Subpasses subpasses{opaqueSubpass, transparentSubpass, compositeSubpass};
+
+    RenderPass::Dependencies dependencies(5);
+
+    // depth, accumulation and revealage are shared between swapchain images
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dependencyFlags = 0;
+
+    dependencies[1].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].dstSubpass = 1;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dependencyFlags = 0;
+
+    // opaque depth writes must complete before the transparent subpass tests against them
+    dependencies[2].srcSubpass = 0;
+    dependencies[2].dstSubpass = 1;
+    dependencies[2].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[2].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[2].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // the composite subpass reads the accumulated transparency and blends over the opaque color, only the same pixel is accessed so the dependencies can be by region
+    dependencies[3].srcSubpass = 1;
+    dependencies[3].dstSubpass = 2;
+    dependencies[3].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[3].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[3].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[3].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[3].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    dependencies[4].srcSubpass = 0;
+    dependencies[4].dstSubpass = 2;
+    dependencies[4].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[4].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[4].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[4].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[4].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // swapchain image layout transition
+    SubpassDependency swapchainDependency;
+    swapchainDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    swapchainDependency.dstSubpass = 0;
+    swapchainDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    swapchainDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    swapchainDependency.srcAccessMask = 0;
+    swapchainDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    swapchainDependency.dependencyFlags = 0;
+    dependencies.push_back(swapchainDependency);
+
+    renderPass = RenderPass::create(device, attachments, subpasses, dependencies);
+
+    // set up the composite subpass' descriptors, the ImageViews are assigned by createFramebuffers()
+    Descriptors descriptors;
+    DescriptorSetLayoutBindings bindings;
+    for (uint32_t i = ACCUMULATION; i <= REVEALAGE; ++i)
+    {
+        uint32_t binding = i - ACCUMULATION;
+        descriptors.push_back(DescriptorImage::create(ImageInfo::create(ref_ptr<Sampler>(), ref_ptr<ImageView>(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL), binding, 0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT));
+        bindings.push_back(VkDescriptorSetLayoutBinding{binding, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr});
+    }
+
+    transparencyDescriptorSet = DescriptorSet::create(DescriptorSetLayout::create(bindings), descriptors);
+
+    createFramebuffers();
+
+    // set up the composite subpass, a full screen triangle blended over the opaque color
+    auto shaderSet = createOITCompositeShaderSet(options);
+
+    // the push constant range matches the one the RecordTraversal pushes the projection and modelview matrices to
+    auto pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{transparencyDescriptorSet->setLayout}, PushConstantRanges{{VK_SHADER_STAGE_VERTEX_BIT, 0, 128}});
+
+    auto rasterizationState = RasterizationState::create();
+    rasterizationState->cullMode = VK_CULL_MODE_NONE;
+
+    auto colorBlendState = ColorBlendState::create();
+    colorBlendState->configureAttachments(true);
+
+    auto depthStencilState = DepthStencilState::create();
+    depthStencilState->depthTestEnable = VK_FALSE;
+    depthStencilState->depthWriteEnable = VK_FALSE;
+
+    GraphicsPipelineStates pipelineStates{
+        VertexInputState::create(),
+        InputAssemblyState::create(),
+        rasterizationState,
+        MultisampleState::create(),
+        colorBlendState,
+        depthStencilState};
+
+    auto graphicsPipeline = GraphicsPipeline::create(pipelineLayout, shaderSet->getShaderStages(), pipelineStates, 2);
+
+    compositePass = StateGroup::create();
+    compositePass->add(BindGraphicsPipeline::create(graphicsPipeline));
+    compositePass->add(BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, transparencyDescriptorSet));
+    compositePass->addChild(Draw::create(3, 1, 0, 0));
+
+    if (view)
+    {
+        // the View's bins are recorded after its children, so start the transparent subpass after them
+        view->addChild(NextSubPass::create());
+
+        // weighted blending is order independent so the transparent bin needn't be sorted
+        bool binAssigned = false;
+        for (auto& bin : view->bins)
+        {
+            if (bin->binNumber == transparentBinNumber)
+            {
+                bin->sortOrder = Bin::NO_SORT;
+                binAssigned = true;
+            }
+        }
+        if (!binAssigned) view->bins.push_back(Bin::create(transparentBinNumber, Bin::NO_SORT));
+
+        addChild(view);
+
+        if (view->camera && view->camera->viewportState) renderArea = view->camera->getRenderArea();
+    }
+
+    addChild(NextSubPass::create());
+    addChild(compositePass);
+
+    if (!view || !view->camera || !view->camera->viewportState)
+    {
+        renderArea.offset = {0, 0};
+        renderArea.extent = window->extent2D();
+    }
+
+    previous_extent = window->extent2D();
+
+    setClearValues(window->clearColor(), VkClearDepthStencilValue{0.0f, 0});
+
+    // accumulation starts from zero and revealage from one, fully revealed
+    if (clearValues.size() == NUM_ATTACHMENTS)
+    {
+        clearValues[ACCUMULATION].color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+        clearValues[REVEALAGE].color = {{1.0f, 0.0f, 0.0f, 0.0f}};
+    }
+}
+
+OITRenderGraph::~OITRenderGraph()
+{
+}
+
+void OITRenderGraph::createFramebuffers()
+{
+    auto device = window->getOrCreateDevice();
+    auto extent = window->extent2D();
+
+    transparencyBuffer[ACCUMULATION] = createAttachment(device, extent, accumulationFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    transparencyBuffer[REVEALAGE] = createAttachment(device, extent, revealageFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    transparencyBuffer[DEPTH] = createAttachment(device, extent, window->depthFormat(), VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    _framebuffers.clear();
+    _swapchainImageViews.clear();
+    for (size_t i = 0; i < window->numFrames(); ++i)
+    {
+        auto imageViews = transparencyBuffer;
+        imageViews[COLOR] = window->imageView(i);
+        _framebuffers.push_back(Framebuffer::create(renderPass, imageViews, extent.width, extent.height, 1));
+        _swapchainImageViews.push_back(window->imageView(i).get());
+    }
+
+    if (!_framebuffers.empty()) framebuffer = _framebuffers.front();
+
+    // assign the new ImageViews to the input attachment descriptors, if already compiled update the Vulkan descriptor set in place
+    auto implementation = transparencyDescriptorSet->getImplementation(device->deviceID);
+
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+    imageInfos.reserve(REVEALAGE - ACCUMULATION + 1);
+    for (uint32_t i = ACCUMULATION; i <= REVEALAGE; ++i)
+    {
+        auto descriptorImage = transparencyDescriptorSet->descriptors[i - ACCUMULATION].cast<DescriptorImage>();
+        auto& imageInfo = descriptorImage->imageInfoList.front();
+        imageInfo->imageView = transparencyBuffer[i];
+
+        if (implementation)
+        {
+            imageInfos.push_back(VkDescriptorImageInfo{VK_NULL_HANDLE, transparencyBuffer[i]->vk(device->deviceID), imageInfo->imageLayout});
+
+            VkWriteDescriptorSet descriptorWrite = {};
+            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstBinding = i - ACCUMULATION;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            descriptorWrite.pImageInfo = &imageInfos.back();
+            descriptorWrites.push_back(descriptorWrite);
+        }
+    }
+
+    if (implementation) implementation->write(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data());
+}
+
+void OITRenderGraph::accept(RecordTraversal& recordTraversal) const
+{
+    // recreate the transparency buffer and framebuffers if the Window's swapchain has been recreated
+    bool swapchainChanged = _swapchainImageViews.size() != window->numFrames();
+    for (size_t i = 0; !swapchainChanged && i < _swapchainImageViews.size(); ++i)
+    {
+        swapchainChanged = _swapchainImageViews[i] != window->imageView(i).get();
+    }
+
+    auto this_renderGraph = const_cast<OITRenderGraph*>(this);
+    if (swapchainChanged) this_renderGraph->createFramebuffers();
+
+    size_t imageIndex = window->imageIndex();
+    if (imageIndex >= _framebuffers.size()) return;
+
+    // RenderGraph::accept() uses the framebuffer in preference to the Window's own, so assign the one for the current swapchain image
+    this_renderGraph->framebuffer = _framebuffers[imageIndex];
+
+    RenderGraph::accept(recordTraversal);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// OITColorBlendState
+//
+OITColorBlendState::OITColorBlendState()
+{
+    configureAttachments(true);
+}
+
+OITColorBlendState::~OITColorBlendState()
+{
+}
+
+void OITColorBlendState::configureAttachments(bool /*blendEnable*/)
+{
+    // accumulation sums the weighted premultiplied colors, revealage multiplies by (1 - alpha) of each fragment
+    attachments = {
+        {VK_TRUE, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE, VK_BLEND_OP_ADD,
+         VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT},
+        {VK_TRUE, VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR, VK_BLEND_OP_ADD, VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_OP_ADD,
+         VK_COLOR_COMPONENT_R_BIT}};
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// OIT ShaderSets
+//
+ref_ptr<ShaderSet> vsg::createOITShaderSet(ref_ptr<ShaderSet> base)
+{
+    if (!base) return {};
+
+    ShaderStages stages;
+    for (auto& stage : base->stages)
+    {
+        if (stage->stage != VK_SHADER_STAGE_FRAGMENT_BIT)
+        {
+            stages.push_back(stage);
+            continue;
+        }
+
+        // rename the base fragment shader's main() so the OIT main() can call it and write its outColor to the accumulation and revealage attachments
+        std::string source = stage->module ? stage->module->source : std::string();
+        auto outputPos = source.find(oit_output_declaration);
+        auto mainPos = source.rfind("void main()");
+        if (outputPos == std::string::npos || mainPos == std::string::npos || mainPos < outputPos)
+        {
+            warn("vsg::createOITShaderSet() unable to adapt fragment shader, its source must declare \"", oit_output_declaration, "\" followed by main().");
+            return {};
+        }
+
+        source.replace(mainPos, std::strlen("void main()"), "void vsg_shade()");
+        source.replace(outputPos, std::strlen(oit_output_declaration), oit_outputs);
+        source += oit_main;
+
+        auto oitStage = ShaderStage::create(stage->stage, stage->entryPointName, ShaderModule::create(source, stage->module->hints));
+        oitStage->specializationConstants = stage->specializationConstants;
+        stages.push_back(oitStage);
+    }
+
+    // share the base ShaderSet's bindings so that the OIT variant can be used in place of it
+    auto shaderSet = ShaderSet::create(stages, base->defaultShaderHints);
+    shaderSet->attributeBindings = base->attributeBindings;
+    shaderSet->descriptorBindings = base->descriptorBindings;
+    shaderSet->pushConstantRanges = base->pushConstantRanges;
+    shaderSet->definesArrayStates = base->definesArrayStates;
+    shaderSet->optionalDefines = base->optionalDefines;
+    shaderSet->customDescriptorSetBindings = base->customDescriptorSetBindings;
+    shaderSet->subpass = 1;
+
+    for (auto& pipelineState : base->defaultGraphicsPipelineStates)
+    {
+        if (!pipelineState->is_compatible(typeid(ColorBlendState)) && !pipelineState->is_compatible(typeid(DepthStencilState))) shaderSet->defaultGraphicsPipelineStates.push_back(pipelineState);
+    }
+
+    // transparent fragments are depth tested against the opaque scene, but don't occlude each other
+    auto depthStencilState = DepthStencilState::create();
+    depthStencilState->depthWriteEnable = VK_FALSE;
+
+    shaderSet->defaultGraphicsPipelineStates.push_back(OITColorBlendState::create());
+    shaderSet->defaultGraphicsPipelineStates.push_back(depthStencilState);
+
+    return shaderSet;
+}
+
+ref_ptr<ShaderSet> vsg::createOITPhongShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("oit_phong"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    return createOITShaderSet(createPhongShaderSet(options));
+}
+
+ref_ptr<ShaderSet> vsg::createOITPhysicsBasedRenderingShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("oit_pbr"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    return createOITShaderSet(createPhysicsBasedRenderingShaderSet(options));
+}
+
+ref_ptr<ShaderSet> vsg::createOITCompositeShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("oit_composite"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    ShaderStages stages{
+        ShaderStage::create(VK_SHADER_STAGE_VERTEX_BIT, "main", oit_composite_vert),
+        ShaderStage::create(VK_SHADER_STAGE_FRAGMENT_BIT, "main", oit_composite_frag)};
+
+    auto shaderSet = ShaderSet::create(stages);
+    shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+    shaderSet->subpass = 2;
+
+    return shaderSet;
+}
+
+ref_ptr<OITRenderGraph> vsg::createOITRenderGraphForView(ref_ptr<Window> window, ref_ptr<Camera> camera, ref_ptr<Node> scenegraph, bool assignHeadlight)
+{
+    // set up the view
+    auto view = View::create(camera);
+    if (assignHeadlight) view->addChild(createHeadlight());
+    if (scenegraph) view->addChild(scenegraph);
+
+    // set up the render graph, which starts the transparent subpass after the view's subgraph
+    return OITRenderGraph::create(window, view);
+}
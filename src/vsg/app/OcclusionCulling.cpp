@@ -0,0 +1,359 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/OcclusionCulling.h>
+#include <vsg/maths/simd.h>
+#include <vsg/maths/transform.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace vsg;
+
+namespace
+{
+    struct ScreenVertex
+    {
+        float x, y, depth;
+        bool valid;
+    };
+
+    /// fill the texels of the row [x0, x1] whose centres, offset by the conservative edge offsets, are inside all three edges, keeping the nearest depth
+    void fillRow(float* row, int x0, int x1, float e0, float e1, float e2, float a0, float a1, float a2, float depth)
+    {
+        int x = x0;
+#if defined(VSG_SIMD_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 v_depth = _mm_set1_ps(depth);
+        const __m128 steps = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+        __m128 v_e0 = _mm_add_ps(_mm_set1_ps(e0), _mm_mul_ps(_mm_set1_ps(a0), steps));
+        __m128 v_e1 = _mm_add_ps(_mm_set1_ps(e1), _mm_mul_ps(_mm_set1_ps(a1), steps));
+        __m128 v_e2 = _mm_add_ps(_mm_set1_ps(e2), _mm_mul_ps(_mm_set1_ps(a2), steps));
+        const __m128 v_a0 = _mm_set1_ps(a0 * 4.0f);
+        const __m128 v_a1 = _mm_set1_ps(a1 * 4.0f);
+        const __m128 v_a2 = _mm_set1_ps(a2 * 4.0f);
+        for (; x + 3 <= x1; x += 4)
+        {
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(v_e0, zero), _mm_cmpge_ps(v_e1, zero)), _mm_cmpge_ps(v_e2, zero));
+            if (_mm_movemask_ps(inside) != 0)
+            {
+                __m128 current = _mm_loadu_ps(row + x);
+                __m128 nearest = _mm_min_ps(current, v_depth);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+            }
+            v_e0 = _mm_add_ps(v_e0, v_a0);
+            v_e1 = _mm_add_ps(v_e1, v_a1);
+            v_e2 = _mm_add_ps(v_e2, v_a2);
+        }
+        float offset = static_cast<float>(x - x0);
+        e0 += a0 * offset;
+        e1 += a1 * offset;
+        e2 += a2 * offset;
+#endif
+        for (; x <= x1; ++x)
+        {
+            if (e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f && depth < row[x]) row[x] = depth;
+            e0 += a0;
+            e1 += a1;
+            e2 += a2;
+        }
+    }
+
+    /// rasterize the texels that are entirely covered by the triangle, using the farthest vertex depth so the result is conservative
+    void rasterizeTriangle(float* texels, int width, int height, ScreenVertex v0, ScreenVertex v1, ScreenVertex v2)
+    {
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        if (std::abs(area) < 1e-6f) return;
+        if (area < 0.0f) std::swap(v1, v2);
+
+        int x0 = std::max(0, static_cast<int>(std::floor(std::min({v0.x, v1.x, v2.x}))));
+        int x1 = std::min(width - 1, static_cast<int>(std::ceil(std::max({v0.x, v1.x, v2.x}))) - 1);
+        int y0 = std::max(0, static_cast<int>(std::floor(std::min({v0.y, v1.y, v2.y}))));
+        int y1 = std::min(height - 1, static_cast<int>(std::ceil(std::max({v0.y, v1.y, v2.y}))) - 1);
+        if (x0 > x1 || y0 > y1) return;
+
+        float depth = std::max({v0.depth, v1.depth, v2.depth});
+
+        // edge functions, positive inside, with c reduced by half the texel extent along the edge normal so a texel only passes when it's entirely inside
+        auto edge = [](const ScreenVertex& a, const ScreenVertex& b, float& ea, float& eb, float& ec) {
+            ea = a.y - b.y;
+            eb = b.x - a.x;
+            ec = a.x * b.y - a.y * b.x - 0.5f * (std::abs(ea) + std::abs(eb));
+        };
+
+        float a0, b0, c0, a1, b1, c1, a2, b2, c2;
+        edge(v0, v1, a0, b0, c0);
+        edge(v1, v2, a1, b1, c1);
+        edge(v2, v0, a2, b2, c2);
+
+        float cx = static_cast<float>(x0) + 0.5f;
+        for (int y = y0; y <= y1; ++y)
+        {
+            float cy = static_cast<float>(y) + 0.5f;
+            fillRow(texels + y * width, x0, x1, a0 * cx + b0 * cy + c0, a1 * cx + b1 * cy + c1, a2 * cx + b2 * cy + c2, a0, a1, a2, depth);
+        }
+    }
+} // namespace
+
+OcclusionCulling::OcclusionCulling(uint32_t in_width, uint32_t in_height) :
+    _width(std::max(in_width, 1u)),
+    _height(std::max(in_height, 1u))
+{
+    uint32_t w = _width, h = _height;
+    _levels.emplace_back(static_cast<size_t>(w) * h, FLT_MAX);
+    while (w > 1 || h > 1)
+    {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        _levels.emplace_back(static_cast<size_t>(w) * h, FLT_MAX);
+    }
+}
+
+OcclusionCulling::~OcclusionCulling()
+{
+}
+
+void OcclusionCulling::addOccluder(ref_ptr<const vec3Array> vertices, ref_ptr<const uintArray> indices, const dmat4& matrix)
+{
+    occluders.push_back(Occluder{vertices, indices, matrix});
+}
+
+void OcclusionCulling::setDepthBuffer(const float* depth, uint32_t depthWidth, uint32_t depthHeight, const dmat4& projection, const dmat4& view)
+{
+    if (!depth || depthWidth == 0 || depthHeight == 0)
+    {
+        _depthValid = false;
+        return;
+    }
+
+    // eye space z and w as linear functions of the ndc coordinates and depth value
+    auto inv = inverse(projection);
+    auto eyeDepth = [&](double x, double y, double d) -> float {
+        double z = inv[0][2] * x + inv[1][2] * y + inv[2][2] * d + inv[3][2];
+        double w = inv[0][3] * x + inv[1][3] * y + inv[2][3] * d + inv[3][3];
+        if (std::abs(w) < 1e-12) return FLT_MAX;
+        double distance = -z / w;
+        return distance > static_cast<double>(FLT_MAX) ? FLT_MAX : static_cast<float>(distance);
+    };
+
+    auto& base = _levels[0];
+    for (uint32_t y = 0; y < _height; ++y)
+    {
+        uint32_t sy0 = (y * depthHeight) / _height;
+        uint32_t sy1 = std::max(sy0 + 1, ((y + 1) * depthHeight + _height - 1) / _height);
+        for (uint32_t x = 0; x < _width; ++x)
+        {
+            uint32_t sx0 = (x * depthWidth) / _width;
+            uint32_t sx1 = std::max(sx0 + 1, ((x + 1) * depthWidth + _width - 1) / _width);
+
+            float farthest = 0.0f;
+            for (uint32_t sy = sy0; sy < sy1 && sy < depthHeight; ++sy)
+            {
+                double ndc_y = (static_cast<double>(sy) + 0.5) / static_cast<double>(depthHeight) * 2.0 - 1.0;
+                const float* row = depth + static_cast<size_t>(sy) * depthWidth;
+                for (uint32_t sx = sx0; sx < sx1 && sx < depthWidth; ++sx)
+                {
+                    double ndc_x = (static_cast<double>(sx) + 0.5) / static_cast<double>(depthWidth) * 2.0 - 1.0;
+                    farthest = std::max(farthest, eyeDepth(ndc_x, ndc_y, row[sx]));
+                }
+            }
+            base[static_cast<size_t>(y) * _width + x] = farthest;
+        }
+    }
+
+    _buildPyramid();
+
+    _depthProjection = projection;
+    _depthView = view;
+    _depthValid = true;
+}
+
+void OcclusionCulling::beginFrame(const dmat4& projection, const dmat4& view, uint64_t frameCount)
+{
+    _frameCount = frameCount;
+    _numTested = 0;
+    _numCulled = 0;
+
+    if (!occluders.empty()) _rasterizeOccluders(projection, view);
+
+    // the depth buffer may be from a previous frame, so map from the current eye coordinates to those of the depth buffer
+    if (_depthValid) _currentToDepth = _depthView * inverse(view);
+
+    if ((frameCount % 32) == 0)
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        for (auto itr = _entries.begin(); itr != _entries.end();)
+        {
+            if ((itr->second.frameCount + maximumUnusedFrames) < frameCount)
+                itr = _entries.erase(itr);
+            else
+                ++itr;
+        }
+    }
+}
+
+void OcclusionCulling::_rasterizeOccluders(const dmat4& projection, const dmat4& view)
+{
+    auto& base = _levels[0];
+    std::fill(base.begin(), base.end(), FLT_MAX);
+
+    std::vector<ScreenVertex> screenVertices;
+    for (auto& occluder : occluders)
+    {
+        if (!occluder.vertices || !occluder.indices) continue;
+
+        auto modelview = view * occluder.matrix;
+        auto mvp = projection * modelview;
+
+        screenVertices.resize(occluder.vertices->size());
+        auto sv_itr = screenVertices.begin();
+        for (auto& v : *occluder.vertices)
+        {
+            auto& sv = *(sv_itr++);
+            dvec4 clip = mvp * dvec4(v.x, v.y, v.z, 1.0);
+            double depth = -(modelview[0][2] * v.x + modelview[1][2] * v.y + modelview[2][2] * v.z + modelview[3][2]);
+            sv.valid = clip.w > 1e-6 && depth > 0.0;
+            if (sv.valid)
+            {
+                sv.x = static_cast<float>((clip.x / clip.w * 0.5 + 0.5) * static_cast<double>(_width));
+                sv.y = static_cast<float>((clip.y / clip.w * 0.5 + 0.5) * static_cast<double>(_height));
+                sv.depth = static_cast<float>(depth);
+            }
+        }
+
+        auto& indices = *occluder.indices;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            if (indices[i] >= screenVertices.size() || indices[i + 1] >= screenVertices.size() || indices[i + 2] >= screenVertices.size()) continue;
+
+            auto& v0 = screenVertices[indices[i]];
+            auto& v1 = screenVertices[indices[i + 1]];
+            auto& v2 = screenVertices[indices[i + 2]];
+
+            // triangles crossing the near plane are skipped, which is conservative as they just occlude less
+            if (v0.valid && v1.valid && v2.valid) rasterizeTriangle(base.data(), static_cast<int>(_width), static_cast<int>(_height), v0, v1, v2);
+        }
+    }
+
+    _buildPyramid();
+
+    _depthProjection = projection;
+    _depthView = view;
+    _depthValid = true;
+}
+
+void OcclusionCulling::_buildPyramid()
+{
+    uint32_t w = _width, h = _height;
+    for (size_t i = 1; i < _levels.size(); ++i)
+    {
+        const auto& src = _levels[i - 1];
+        auto& dest = _levels[i];
+        uint32_t dw = (w + 1) / 2, dh = (h + 1) / 2;
+        for (uint32_t y = 0; y < dh; ++y)
+        {
+            uint32_t sy0 = y * 2, sy1 = std::min(sy0 + 1, h - 1);
+            for (uint32_t x = 0; x < dw; ++x)
+            {
+                uint32_t sx0 = x * 2, sx1 = std::min(sx0 + 1, w - 1);
+                dest[static_cast<size_t>(y) * dw + x] = std::max(std::max(src[sy0 * w + sx0], src[sy0 * w + sx1]),
+                                                                 std::max(src[sy1 * w + sx0], src[sy1 * w + sx1]));
+            }
+        }
+        w = dw;
+        h = dh;
+    }
+}
+
+bool OcclusionCulling::occluded(const dvec3& eye_center, double radius) const
+{
+    if (!_depthValid) return false;
+
+    dvec3 center = _currentToDepth * eye_center;
+    float nearestDepth = static_cast<float>(-center.z - radius);
+    if (nearestDepth <= 0.0f) return false;
+
+    // screen space extents of the sphere's bounding box
+    double minX = DBL_MAX, minY = DBL_MAX, maxX = -DBL_MAX, maxY = -DBL_MAX;
+    for (int i = 0; i < 8; ++i)
+    {
+        dvec4 corner(center.x + ((i & 1) ? radius : -radius),
+                     center.y + ((i & 2) ? radius : -radius),
+                     center.z + ((i & 4) ? radius : -radius), 1.0);
+        dvec4 clip = _depthProjection * corner;
+        if (clip.w <= 1e-6) return false;
+
+        double x = (clip.x / clip.w * 0.5 + 0.5) * static_cast<double>(_width);
+        double y = (clip.y / clip.w * 0.5 + 0.5) * static_cast<double>(_height);
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+
+    // spheres extending beyond the depth buffer aren't occluded as nothing is known about them.
+    if (minX < 0.0 || minY < 0.0 || maxX > static_cast<double>(_width) || maxY > static_cast<double>(_height)) return false;
+
+    uint32_t x1 = std::min(static_cast<uint32_t>(maxX), _width - 1);
+    uint32_t y1 = std::min(static_cast<uint32_t>(maxY), _height - 1);
+    uint32_t x0 = std::min(static_cast<uint32_t>(minX), x1);
+    uint32_t y0 = std::min(static_cast<uint32_t>(minY), y1);
+
+    // choose the pyramid level where the extents cover no more than 2 or 3 texels in each direction
+    uint32_t extent = std::max(x1 - x0, y1 - y0) + 1;
+    size_t level = 0;
+    while ((extent >> level) > 2 && (level + 1) < _levels.size()) ++level;
+
+    uint32_t levelWidth = _width;
+    for (size_t i = 0; i < level; ++i) levelWidth = (levelWidth + 1) / 2;
+
+    const auto& texels = _levels[level];
+    for (uint32_t y = (y0 >> level); y <= (y1 >> level); ++y)
+    {
+        for (uint32_t x = (x0 >> level); x <= (x1 >> level); ++x)
+        {
+            if (nearestDepth <= texels[static_cast<size_t>(y) * levelWidth + x]) return false;
+        }
+    }
+
+    return true;
+}
+
+bool OcclusionCulling::cull(const Node* node, const dsphere& bound, const dmat4& modelview)
+{
+    if (!_depthValid || bound.radius < 0.0) return false;
+
+    double scale2 = std::max({length2(dvec3(modelview[0][0], modelview[0][1], modelview[0][2])),
+                              length2(dvec3(modelview[1][0], modelview[1][1], modelview[1][2])),
+                              length2(dvec3(modelview[2][0], modelview[2][1], modelview[2][2]))});
+
+    bool isOccluded = occluded(modelview * bound.center, bound.radius * std::sqrt(scale2));
+
+    bool culled = false;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        auto& entry = _entries[node];
+        if (!isOccluded)
+            entry.occludedFrames = 0;
+        else if (entry.frameCount != _frameCount)
+            ++entry.occludedFrames;
+        entry.frameCount = _frameCount;
+
+        culled = isOccluded && entry.occludedFrames >= occludedFramesBeforeCulling;
+    }
+
+    ++_numTested;
+    if (culled) ++_numCulled;
+
+    return culled;
+}
@@ -0,0 +1,216 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/OcclusionQueries.h>
+#include <vsg/io/Logger.h>
+#include <vsg/nodes/OcclusionQueryNode.h>
+#include <vsg/threading/atomics.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+OcclusionQueries::OcclusionQueries(uint32_t in_numFrames) :
+    numFrames(std::max(in_numFrames, 2u)),
+    _frames(numFrames)
+{
+}
+
+OcclusionQueries::~OcclusionQueries()
+{
+    for (auto& frame : _frames)
+    {
+        if (frame.queryPool) vkDestroyQueryPool(*_device, frame.queryPool, _device->getAllocationCallbacks());
+    }
+}
+
+void OcclusionQueries::_collect(Frame& frame)
+{
+    if (frame.used > 0)
+    {
+        // results of queries whose frame hasn't completed yet are skipped rather than waited on
+        _results.resize(static_cast<size_t>(frame.used) * 2);
+        vkGetQueryPoolResults(*_device, frame.queryPool, 0, frame.used, _results.size() * sizeof(uint64_t), _results.data(), 2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        for (uint32_t i = 0; i < frame.used; ++i)
+        {
+            if (_results[i * 2 + 1] == 0) continue;
+
+            // a node recorded by several Views is visible if any of its queries passed samples
+            auto& node = *frame.nodes[i];
+            exchange_if_greater(node.frameLastQueried, frame.frameCount);
+            if (_results[i * 2] != 0) exchange_if_greater(node.frameLastVisible, frame.frameCount);
+        }
+    }
+
+    frame.nodes.clear();
+    frame.queries.clear();
+    frame.used = 0;
+}
+
+bool OcclusionQueries::_copyPredicates(CommandBuffer& commandBuffer, Frame& frame, const Frame& previous)
+{
+    if (previous.used == 0) return false;
+
+    if (frame.predicateCapacity < previous.used)
+    {
+        // this frame's predicates were last read more than the number of frames in flight ago, so the buffer can be replaced
+        frame.predicateCapacity = std::max(previous.capacity, previous.used);
+        frame.predicates = createBufferAndMemory(_device, frame.predicateCapacity * sizeof(uint32_t), VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (!frame.predicates)
+        {
+            frame.predicateCapacity = 0;
+            return false;
+        }
+    }
+
+    // the previous frame was submitted ahead of this one so waiting on its queries doesn't stall the CPU
+    VkBuffer predicates = frame.predicates->vk(_device->deviceID);
+    vkCmdCopyQueryPoolResults(commandBuffer, previous.queryPool, 0, previous.used, predicates, 0, sizeof(uint32_t), VK_QUERY_RESULT_WAIT_BIT);
+
+    VkBufferMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_CONDITIONAL_RENDERING_READ_BIT_EXT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = predicates;
+    barrier.offset = 0;
+    barrier.size = previous.used * sizeof(uint32_t);
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_CONDITIONAL_RENDERING_BIT_EXT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+    return true;
+}
+
+void OcclusionQueries::beginFrame(CommandBuffer& commandBuffer, uint64_t frameCount)
+{
+    std::scoped_lock lock(_mutex);
+
+    _current = nullptr;
+    _previous = nullptr;
+    _conditionalRenderingActive = false;
+
+    auto device = commandBuffer.getDevice();
+    if (_device != device)
+    {
+        for (auto& frame : _frames)
+        {
+            if (frame.queryPool) vkDestroyQueryPool(*_device, frame.queryPool, _device->getAllocationCallbacks());
+            frame = {};
+        }
+
+        _device = device;
+        _extensions = device->getExtensions();
+    }
+
+    // no query pools are created until a node has requested a query
+    if (_requiredCount == 0) return;
+
+    auto& frame = _frames[frameCount % numFrames];
+    if (frame.queryPool) _collect(frame);
+
+    if (frame.capacity < _requiredCount)
+    {
+        // the GPU has finished with the pool as its frame is more than the number of frames in flight behind, so it can be replaced with a larger one
+        if (frame.queryPool) vkDestroyQueryPool(*_device, frame.queryPool, _device->getAllocationCallbacks());
+
+        VkQueryPoolCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_OCCLUSION;
+        createInfo.queryCount = _requiredCount;
+        if (vkCreateQueryPool(*_device, &createInfo, _device->getAllocationCallbacks(), &frame.queryPool) != VK_SUCCESS)
+        {
+            frame.queryPool = VK_NULL_HANDLE;
+            frame.capacity = 0;
+            return;
+        }
+        frame.capacity = _requiredCount;
+    }
+
+    auto& previous = _frames[(frameCount + numFrames - 1) % numFrames];
+    bool supportsConditionalRendering = _extensions->vkCmdBeginConditionalRenderingEXT && _extensions->vkCmdEndConditionalRenderingEXT;
+    if (conditionalRendering && supportsConditionalRendering && previous.queryPool && previous.frameCount + 1 == frameCount)
+    {
+        if (_copyPredicates(commandBuffer, frame, previous)) _previous = &previous;
+    }
+
+    vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, frame.capacity);
+    frame.frameCount = frameCount;
+    _current = &frame;
+}
+
+uint32_t OcclusionQueries::begin(CommandBuffer& commandBuffer, const OcclusionQueryNode& node)
+{
+    std::scoped_lock lock(_mutex);
+
+    if (!_current)
+    {
+        // first node to be queried so request query pools from the next frame
+        _requiredCount = std::max(_requiredCount, initialQueryCount);
+        return 0;
+    }
+
+    auto& frame = *_current;
+    if (frame.used >= frame.capacity)
+    {
+        // not enough queries for this frame, so grow the pools the next time they are used
+        _requiredCount = std::max(_requiredCount, frame.capacity * 2);
+        return 0;
+    }
+
+    uint32_t query = frame.used++;
+    frame.nodes.emplace_back(&node);
+    frame.queries.emplace(QueryKey(&node, commandBuffer.viewID), query);
+
+    vkCmdBeginQuery(commandBuffer, frame.queryPool, query, 0);
+
+    return query + 1;
+}
+
+void OcclusionQueries::end(CommandBuffer& commandBuffer, uint32_t reference)
+{
+    if (reference == 0) return;
+
+    std::scoped_lock lock(_mutex);
+    if (_current) vkCmdEndQuery(commandBuffer, _current->queryPool, reference - 1);
+}
+
+bool OcclusionQueries::beginConditionalRendering(CommandBuffer& commandBuffer, const OcclusionQueryNode& node)
+{
+    std::scoped_lock lock(_mutex);
+
+    // conditional rendering can't be nested so nodes within the child of a conditionally rendered node are left to their parent's predicate
+    if (!_previous || !_current || _conditionalRenderingActive) return false;
+
+    auto itr = _previous->queries.find(QueryKey(&node, commandBuffer.viewID));
+    if (itr == _previous->queries.end()) return false;
+
+    VkConditionalRenderingBeginInfoEXT beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT;
+    beginInfo.buffer = _current->predicates->vk(_device->deviceID);
+    beginInfo.offset = itr->second * sizeof(uint32_t);
+    beginInfo.flags = 0;
+    _extensions->vkCmdBeginConditionalRenderingEXT(commandBuffer, &beginInfo);
+
+    _conditionalRenderingActive = true;
+    return true;
+}
+
+void OcclusionQueries::endConditionalRendering(CommandBuffer& commandBuffer)
+{
+    std::scoped_lock lock(_mutex);
+
+    if (!_conditionalRenderingActive) return;
+
+    _extensions->vkCmdEndConditionalRenderingEXT(commandBuffer);
+    _conditionalRenderingActive = false;
+}
@@ -0,0 +1,287 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/OffscreenRenderGraph.h>
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/app/View.h>
+#include <vsg/commands/CopyImageToBuffer.h>
+#include <vsg/core/Array2D.h>
+#include <vsg/core/Exception.h>
+#include <vsg/io/Logger.h>
+#include <vsg/state/ImageInfo.h>
+#include <vsg/ui/FrameStamp.h>
+#include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/CommandPool.h>
+
+#include <thread>
+
+using namespace vsg;
+
+namespace
+{
+    ref_ptr<Image> createAttachment(Device* device, const VkExtent2D& extent, VkFormat format, VkImageUsageFlags usage, VkExternalMemoryHandleTypeFlags exportMemoryHandleTypes = 0)
+    {
+        auto image = Image::create();
+        image->imageType = VK_IMAGE_TYPE_2D;
+        image->extent = VkExtent3D{extent.width, extent.height, 1};
+        image->mipLevels = 1;
+        image->arrayLayers = 1;
+        image->format = format;
+        image->tiling = VK_IMAGE_TILING_OPTIMAL;
+        image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image->samples = VK_SAMPLE_COUNT_1_BIT;
+        image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image->usage = usage;
+
+        // exportable images are allocated as dedicated allocations, dma-bufs are imported without a DRM format modifier so need a linear layout
+        image->externalMemoryHandleTypes = exportMemoryHandleTypes;
+        if ((exportMemoryHandleTypes & VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT) != 0) image->tiling = VK_IMAGE_TILING_LINEAR;
+
+        image->compile(device);
+        image->allocateAndBindMemory(device, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        return image;
+    }
+
+    template<class T>
+    ref_ptr<Data> mapImage(DeviceMemory* deviceMemory, VkDeviceSize offset, VkFormat format, uint32_t width, uint32_t height)
+    {
+        return MappedData<T>::create(deviceMemory, offset, 0, Data::Properties{format}, width, height);
+    }
+
+} // namespace
+
+OffscreenRenderGraph::OffscreenRenderGraph(ref_ptr<Device> in_device, const VkExtent2D& in_extent, ref_ptr<View> in_view, uint32_t numFrames, VkFormat in_colorFormat, VkFormat in_depthFormat,
+                                           VkExternalMemoryHandleTypeFlags in_exportMemoryHandleTypes) :
+    device(in_device),
+    extent(in_extent),
+    colorFormat(in_colorFormat),
+    depthFormat(in_depthFormat),
+    exportMemoryHandleTypes(in_exportMemoryHandleTypes)
+{
+    bool exportMemory = exportMemoryHandleTypes != 0;
+
+    // the color attachment is left ready to copy from, or to be released to the external consumer, rather than present
+    auto colorAttachment = defaultColorAttachment(colorFormat);
+    colorAttachment.finalLayout = exportMemory ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+    RenderPass::Attachments attachments{colorAttachment, defaultDepthAttachment(depthFormat)};
+
+    SubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachments.push_back(AttachmentReference{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    subpass.depthStencilAttachments.push_back(AttachmentReference{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
+
+    RenderPass::Dependencies dependencies(3);
+
+    // wait for the previous copy from the color attachment before rendering to it again
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = exportMemory ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[0].srcAccessMask = 0;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dependencyFlags = 0;
+
+    // depth buffer is shared between the frames
+    dependencies[1].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].dstSubpass = 0;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dependencyFlags = 0;
+
+    // rendering must complete before the color attachment is copied to the readback buffer, or released to the external consumer
+    dependencies[2].srcSubpass = 0;
+    dependencies[2].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[2].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].dstStageMask = exportMemory ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstAccessMask = exportMemory ? 0 : VK_ACCESS_TRANSFER_READ_BIT;
+    dependencies[2].dependencyFlags = 0;
+
+    renderPass = RenderPass::create(device, attachments, RenderPass::Subpasses{subpass}, dependencies);
+
+    auto depthImage = createAttachment(device, extent, depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+    auto depthImageView = ImageView::create(depthImage, VK_IMAGE_ASPECT_DEPTH_BIT);
+    depthImageView->compile(device);
+
+    auto traits = getFormatTraits(colorFormat);
+    VkDeviceSize imageSize = static_cast<VkDeviceSize>(extent.width) * extent.height * traits.size;
+
+    _frames.resize(std::max(numFrames, 1u));
+    for (size_t i = 0; i < _frames.size(); ++i)
+    {
+        auto& frame = _frames[i];
+        frame.index = i;
+
+        auto colorImage = createAttachment(device, extent, colorFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, exportMemoryHandleTypes);
+        auto colorImageView = ImageView::create(colorImage, VK_IMAGE_ASPECT_COLOR_BIT);
+        colorImageView->compile(device);
+
+        frame.colorImage = colorImage;
+        frame.framebuffer = Framebuffer::create(renderPass, ImageViews{colorImageView, depthImageView}, extent.width, extent.height, 1);
+        frame.readbackCompleted = Event::create(device);
+        frame.readbackCommands = Commands::create();
+
+        if (exportMemory)
+        {
+            // the srcQueueFamilyIndex is assigned to that of the CommandBuffer when recorded
+            frame.releaseBarrier = ImageMemoryBarrier::create(VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, 0, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+                                                              VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_EXTERNAL, colorImage, VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1});
+
+            frame.readbackCommands->addChild(PipelineBarrier::create(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, frame.releaseBarrier));
+            frame.readbackCommands->addChild(SetEvent::create(frame.readbackCompleted, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT));
+            continue;
+        }
+
+        // host cached memory where available so reading back the image isn't slowed by uncached reads
+        ref_ptr<Buffer> readbackBuffer;
+        try
+        {
+            readbackBuffer = createBufferAndMemory(device, imageSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        }
+        catch (const Exception&)
+        {
+            readbackBuffer = createBufferAndMemory(device, imageSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        }
+
+        // mapped once and kept mapped for the lifetime of the OffscreenRenderGraph
+        auto deviceMemory = readbackBuffer->getDeviceMemory(device->deviceID);
+        auto memoryOffset = readbackBuffer->getMemoryOffset(device->deviceID);
+        switch (traits.size)
+        {
+        case 1: frame.image = mapImage<ubyteArray2D>(deviceMemory, memoryOffset, colorFormat, extent.width, extent.height); break;
+        case 2: frame.image = mapImage<ushortArray2D>(deviceMemory, memoryOffset, colorFormat, extent.width, extent.height); break;
+        case 4: frame.image = mapImage<ubvec4Array2D>(deviceMemory, memoryOffset, colorFormat, extent.width, extent.height); break;
+        case 8: frame.image = mapImage<usvec4Array2D>(deviceMemory, memoryOffset, colorFormat, extent.width, extent.height); break;
+        case 16: frame.image = mapImage<vec4Array2D>(deviceMemory, memoryOffset, colorFormat, extent.width, extent.height); break;
+        default: warn("OffscreenRenderGraph::OffscreenRenderGraph() colorFormat = ", colorFormat, " not supported for readback."); break;
+        }
+
+        auto copyImage = CopyImageToBuffer::create();
+        copyImage->srcImage = colorImage;
+        copyImage->srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        copyImage->dstBuffer = readbackBuffer;
+
+        VkBufferImageCopy copyRegion = {};
+        copyRegion.bufferOffset = 0;
+        copyRegion.bufferRowLength = 0;
+        copyRegion.bufferImageHeight = 0;
+        copyRegion.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        copyRegion.imageOffset = {0, 0, 0};
+        copyRegion.imageExtent = {extent.width, extent.height, 1};
+        copyImage->regions.push_back(copyRegion);
+
+        // make the copy visible to the host before signalling the Event that poll() checks
+        auto hostBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                                                   BufferMemoryBarrier::create(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, readbackBuffer, 0, imageSize));
+
+        frame.readbackCommands->addChild(copyImage);
+        frame.readbackCommands->addChild(hostBarrier);
+        frame.readbackCommands->addChild(SetEvent::create(frame.readbackCompleted, VK_PIPELINE_STAGE_TRANSFER_BIT));
+    }
+
+    framebuffer = _frames.front().framebuffer;
+
+    renderArea.offset = {0, 0};
+    renderArea.extent = extent;
+
+    setClearValues();
+
+    if (in_view) addChild(in_view);
+}
+
+OffscreenRenderGraph::~OffscreenRenderGraph()
+{
+}
+
+bool OffscreenRenderGraph::_deliver(Frame& frame, bool wait) const
+{
+    if (!frame.pending) return false;
+
+    while (frame.readbackCompleted->status() != VK_EVENT_SET)
+    {
+        if (!wait) return false;
+        std::this_thread::yield();
+    }
+
+    frame.pending = false;
+    if (frame.image)
+    {
+        if (readbackCallback) readbackCallback(frame.frameCount, frame.image);
+    }
+    else if (exportCallback && exportMemoryHandleTypes != 0)
+    {
+        exportCallback(frame.frameCount, frame.index);
+    }
+    return true;
+}
+
+int OffscreenRenderGraph::exportMemoryFd(size_t index, VkExternalMemoryHandleTypeFlagBits handleType) const
+{
+    if (index >= _frames.size() || (exportMemoryHandleTypes & handleType) == 0) return -1;
+
+    return _frames[index].colorImage->getDeviceMemory(device->deviceID)->exportFd(handleType);
+}
+
+size_t OffscreenRenderGraph::poll()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    // frames are recorded round robin so the oldest pending frame is the one after the most recently recorded
+    size_t numDelivered = 0;
+    for (uint64_t i = 0; i < _frames.size(); ++i)
+    {
+        auto& frame = _frames[(_numRecorded + i) % _frames.size()];
+        if (!frame.pending) continue;
+        if (!_deliver(frame, false)) break;
+        ++numDelivered;
+    }
+    return numDelivered;
+}
+
+size_t OffscreenRenderGraph::pending() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    size_t numPending = 0;
+    for (auto& frame : _frames)
+    {
+        if (frame.pending) ++numPending;
+    }
+    return numPending;
+}
+
+void OffscreenRenderGraph::accept(RecordTraversal& recordTraversal) const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    auto& frame = _frames[_numRecorded % _frames.size()];
+    ++_numRecorded;
+
+    // deliver the previous use of this frame's color attachment before its readback buffer is overwritten
+    _deliver(frame, true);
+
+    frame.readbackCompleted->reset();
+    frame.frameCount = recordTraversal.getFrameStamp() ? recordTraversal.getFrameStamp()->frameCount : (_numRecorded - 1);
+    frame.pending = true;
+
+    const_cast<OffscreenRenderGraph*>(this)->framebuffer = frame.framebuffer;
+
+    RenderGraph::accept(recordTraversal);
+
+    auto& commandBuffer = *recordTraversal.getCommandBuffer();
+    if (frame.releaseBarrier) frame.releaseBarrier->srcQueueFamilyIndex = commandBuffer.getCommandPool()->queueFamilyIndex;
+
+    frame.readbackCommands->record(commandBuffer);
+}
@@ -0,0 +1,149 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/PowerManager.h>
+#include <vsg/app/Viewer.h>
+#include <vsg/io/DatabasePager.h>
+
+#include <algorithm>
+
+#if defined(__ANDROID__)
+#    include <android/api-level.h>
+#    if __ANDROID_API__ >= 30
+#        include <android/thermal.h>
+#    endif
+#endif
+
+using namespace vsg;
+
+#if !defined(__APPLE__)
+// iOS and macOS implementations are provided by iOS_Window.mm and MacOS_Window.mm
+ThermalStatus vsg::getThermalStatus()
+{
+#    if defined(__ANDROID__) && __ANDROID_API__ >= 30
+    static AThermalManager* s_thermalManager = AThermal_acquireManager();
+    if (s_thermalManager) return static_cast<ThermalStatus>(std::max(0, static_cast<int>(AThermal_getCurrentThermalStatus(s_thermalManager))));
+#    endif
+    return THERMAL_STATUS_NONE;
+}
+#endif
+
+double PowerManager::frameRateLimit() const
+{
+    double limit = maximumFrameRate;
+    for (auto& [status, frameRate] : thermalFrameRateLimits)
+    {
+        if (thermalStatus >= status && frameRate > 0.0 && (limit <= 0.0 || frameRate < limit)) limit = frameRate;
+    }
+    return limit;
+}
+
+void PowerManager::requestFrame()
+{
+    _frameRequested = true;
+    if (auto viewer = _viewer.ref_ptr()) viewer->wakeEvents();
+}
+
+bool PowerManager::_signaturesChanged(Viewer& viewer)
+{
+    bool changed = false;
+    for (auto& task : viewer.recordAndSubmitTasks)
+    {
+        for (auto& commandGraph : task->commandGraphs)
+        {
+            auto& recordSignature = _recordSignatures[commandGraph.get()];
+            if (!recordSignature) recordSignature = RecordSignature::create();
+
+            auto previous = recordSignature->signature;
+            recordSignature->reset();
+            commandGraph->traverse(*recordSignature);
+
+            // subgraphs that aren't reusable, such as those with PagedLOD, still only need rendering when their signature changes as camera changes and merges alter it
+            if (recordSignature->signature != previous) changed = true;
+        }
+    }
+    return changed;
+}
+
+bool PowerManager::frameRequired(Viewer& viewer)
+{
+    bool required = _frameRequested.exchange(false) || !viewer.getEvents().empty();
+
+    // always check the signatures so that they're up to date for the next call
+    if (_signaturesChanged(viewer)) required = true;
+
+    for (auto& task : viewer.recordAndSubmitTasks)
+    {
+        if (task->databasePager && task->databasePager->numPendingMerges() > 0) required = true;
+    }
+
+    if (viewer.updateOperations && (!viewer.updateOperations->getUpdateOperationsOneTime().empty() || !viewer.updateOperations->getUpdateOperationsAllFrames().empty())) required = true;
+
+    if (required)
+    {
+        _framesToRender = framesAfterChange + 1;
+        return true;
+    }
+
+    if (_framesToRender > 0) return true;
+
+    return maximumIdleTime > 0.0 && std::chrono::duration<double>(clock::now() - _previousFrameStart).count() >= maximumIdleTime;
+}
+
+double PowerManager::_idleTimeout(Viewer& viewer) const
+{
+    // reads in progress complete on the DatabasePager's threads without waking the viewer, so check periodically for subgraphs to merge
+    for (auto& task : viewer.recordAndSubmitTasks)
+    {
+        if (task->databasePager && task->databasePager->numActiveRequests.load() > 0) return idlePollInterval;
+    }
+
+    if (maximumIdleTime > 0.0) return std::max(0.0, maximumIdleTime - std::chrono::duration<double>(clock::now() - _previousFrameStart).count());
+
+    return -1.0;
+}
+
+bool PowerManager::wait(Viewer& viewer)
+{
+    _viewer = &viewer;
+
+    if (renderOnDemand)
+    {
+        while (!frameRequired(viewer))
+        {
+            if (!viewer.active()) return false;
+            viewer.waitEvents(_idleTimeout(viewer), false);
+        }
+        if (_framesToRender > 0) --_framesToRender;
+    }
+
+    auto now = clock::now();
+    if (thermalQueryInterval >= 0.0 && std::chrono::duration<double>(now - _previousThermalQuery).count() >= thermalQueryInterval)
+    {
+        thermalStatus = getThermalStatus();
+        _previousThermalQuery = now;
+    }
+
+    if (double limit = frameRateLimit(); limit > 0.0)
+    {
+        auto frameStart = _previousFrameStart + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / limit));
+        // keep gathering events so that the windows stay responsive while waiting
+        for (; now < frameStart; now = clock::now())
+        {
+            viewer.waitEvents(std::chrono::duration<double>(frameStart - now).count(), false);
+        }
+    }
+
+    _previousFrameStart = clock::now();
+
+    return viewer.active();
+}
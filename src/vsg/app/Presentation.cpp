@@ -28,13 +28,27 @@ VkResult Presentation::present()
 
     std::vector<VkSwapchainKHR> vk_swapchains;
     std::vector<uint32_t> indices;
+    std::vector<uint64_t> presentIds;
+    bool usePresentId = false;
     for (auto& window : windows)
     {
         size_t imageIndex = window->imageIndex();
         if (window->visible() && imageIndex < window->numFrames())
         {
-            vk_swapchains.emplace_back(*(window->getOrCreateSwapchain()));
+            auto swapchain = window->getOrCreateSwapchain();
+            vk_swapchains.emplace_back(*swapchain);
             indices.emplace_back(static_cast<uint32_t>(imageIndex));
+
+            // tag each present with an increasing id so that a FramePacer can wait on its completion
+            if (window->getDevice()->supportsDeviceExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME))
+            {
+                presentIds.emplace_back(++(swapchain->presentId));
+                usePresentId = true;
+            }
+            else
+            {
+                presentIds.emplace_back(0);
+            }
         }
     }
 
@@ -52,6 +66,15 @@ VkResult Presentation::present()
     presentInfo.pSwapchains = vk_swapchains.data();
     presentInfo.pImageIndices = indices.data();
 
+    VkPresentIdKHR presentIdInfo = {};
+    if (usePresentId)
+    {
+        presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentIdInfo.swapchainCount = static_cast<uint32_t>(presentIds.size());
+        presentIdInfo.pPresentIds = presentIds.data();
+        presentInfo.pNext = &presentIdInfo;
+    }
+
 #if 0
     debug( "pdo.presentInfo->present(..)");
     debug( "    presentInfo.waitSemaphoreCount = ", presentInfo.waitSemaphoreCount);
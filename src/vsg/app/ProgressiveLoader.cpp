@@ -0,0 +1,265 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/ProgressiveLoader.h>
+#include <vsg/app/Viewer.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/read.h>
+#include <vsg/utils/Builder.h>
+#include <vsg/utils/ComputeBounds.h>
+#include <vsg/vk/ResourceRequirements.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+ProgressiveLoader::ProgressiveLoader(const Path& in_filename, ref_ptr<const Options> in_options, ref_ptr<Node> in_proxy) :
+    filename(in_filename),
+    options(in_options),
+    root(Group::create()),
+    proxy(in_proxy),
+    _status(ActivityStatus::create())
+{
+    if (proxy)
+    {
+        root->addChild(proxy);
+        _activeProxy = proxy;
+    }
+}
+
+ProgressiveLoader::~ProgressiveLoader()
+{
+    _status->set(false);
+    if (_thread.joinable()) _thread.join();
+}
+
+void ProgressiveLoader::start(Viewer& viewer)
+{
+    if (_thread.joinable()) return;
+
+    if (!viewer.compileManager)
+    {
+        warn("ProgressiveLoader::start(viewer) requires Viewer::compile() to have been called to set up the viewer's CompileManager.");
+        _completed = true;
+        return;
+    }
+
+    _viewer = &viewer;
+    _compileManager = viewer.compileManager;
+
+    viewer.addUpdateOperation(ref_ptr<Operation>(this), UpdateOperations::ALL_FRAMES);
+
+    _thread = std::thread(&ProgressiveLoader::_load, this);
+}
+
+bool ProgressiveLoader::completed() const
+{
+    return _completed;
+}
+
+void ProgressiveLoader::_compile(Batch& batch, const std::vector<ref_ptr<Object>>& objects)
+{
+    auto results = _compileManager->compile(objects);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        if (results[i])
+        {
+            batch.result.add(results[i]);
+        }
+        else
+        {
+            // leave subgraphs that failed to compile out of the scene graph, along with any of their descendants
+            warn("ProgressiveLoader unable to compile subgraph of ", filename, ", ", results[i].message);
+            batch.subgraphs[i].node = {};
+        }
+    }
+
+    batch.subgraphs.erase(std::remove_if(batch.subgraphs.begin(), batch.subgraphs.end(), [](const Subgraph& subgraph) { return !subgraph.node; }), batch.subgraphs.end());
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _compiled.push_back(std::move(batch));
+}
+
+void ProgressiveLoader::_load()
+{
+    auto readOptions = options ? Options::create(*options) : Options::create();
+    readOptions->activityStatus = _status;
+
+    auto model = read_cast<Node>(filename, readOptions);
+    if (!model)
+    {
+        if (_status->active()) warn("ProgressiveLoader unable to read ", filename);
+
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _loadCompleted = true;
+        return;
+    }
+
+    // show the bounds of the model while it's compiled
+    if (!proxy)
+    {
+        ComputeBounds computeBounds;
+        model->accept(computeBounds);
+        if (computeBounds.bounds.valid())
+        {
+            GeometryInfo geomInfo;
+            geomInfo.set(box(vec3(computeBounds.bounds.min), vec3(computeBounds.bounds.max)));
+
+            StateInfo stateInfo;
+            stateInfo.wireframe = true;
+            stateInfo.lighting = false;
+
+            Batch batch;
+            batch.proxy = Builder::create()->createBox(geomInfo, stateInfo);
+            if (auto result = _compileManager->compile(batch.proxy))
+            {
+                batch.result = result;
+
+                std::scoped_lock<std::mutex> lock(_mutex);
+                _compiled.push_back(std::move(batch));
+            }
+        }
+    }
+
+    // split the model top down into subgraphs, breadth first so that parents are merged before their children.
+    // The first Group with several children is always split so that models with a single wide Group are still loaded progressively.
+    std::vector<Subgraph> subgraphs{Subgraph{root, model}};
+    bool splitWideGroup = false;
+    for (size_t i = 0; i < subgraphs.size() && subgraphs.size() < maxNumSubgraphs; ++i)
+    {
+        auto group = subgraphs[i].node.cast<Group>();
+        if (!group || group->children.empty() || (splitWideGroup && (subgraphs.size() + group->children.size()) > maxNumSubgraphs)) continue;
+        if (group->children.size() > 1) splitWideGroup = true;
+
+        std::vector<std::pair<double, ref_ptr<Node>>> children;
+        for (auto& child : group->children)
+        {
+            ComputeBounds computeBounds;
+            child->accept(computeBounds);
+            double radius = computeBounds.bounds.valid() ? length(computeBounds.bounds.max - computeBounds.bounds.min) : 0.0;
+            children.emplace_back(radius, child);
+        }
+        group->children.clear();
+
+        // merge the largest children first so the overall shape of the model fills in before the finer details
+        std::stable_sort(children.begin(), children.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+        for (auto& child : children) subgraphs.push_back(Subgraph{group, child.second});
+    }
+
+    numSubgraphs = static_cast<uint32_t>(subgraphs.size());
+
+    // compile the subgraphs in order, batching them together up to the maxBatchDataSize
+    Batch batch;
+    std::vector<ref_ptr<Object>> objects;
+    VkDeviceSize batchDataSize = 0;
+    for (auto& subgraph : subgraphs)
+    {
+        if (!_status->active()) return;
+
+        CollectResourceRequirements collectRequirements;
+        subgraph.node->accept(collectRequirements);
+        VkDeviceSize dataSize = collectRequirements.requirements.dataSize;
+
+        if (!objects.empty() && (batchDataSize + dataSize) > maxBatchDataSize)
+        {
+            _compile(batch, objects);
+            batch = {};
+            objects.clear();
+            batchDataSize = 0;
+        }
+
+        batch.subgraphs.push_back(subgraph);
+        objects.push_back(subgraph.node);
+        batchDataSize += dataSize;
+    }
+
+    if (!objects.empty()) _compile(batch, objects);
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _loadCompleted = true;
+}
+
+void ProgressiveLoader::run()
+{
+    ++_frameCount;
+
+    auto viewer = _viewer.ref_ptr();
+
+    std::list<Batch> batches;
+    bool loadCompleted = false;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        auto end = _compiled.begin();
+        for (uint32_t i = 0; end != _compiled.end() && (maxMergesPerFrame == 0 || i < maxMergesPerFrame); ++i) ++end;
+        batches.splice(batches.end(), _compiled, _compiled.begin(), end);
+        loadCompleted = _loadCompleted && _compiled.empty();
+    }
+
+    auto removeProxy = [&]() {
+        if (!_activeProxy) return;
+
+        auto itr = std::find(root->children.begin(), root->children.end(), _activeProxy);
+        if (itr != root->children.end()) root->children.erase(itr);
+
+        _retired.push_back(Retired{_activeProxy, _frameCount});
+        _activeProxy = {};
+    };
+
+    for (auto& batch : batches)
+    {
+        if (batch.proxy)
+        {
+            if (!_modelMerged)
+            {
+                removeProxy();
+                root->addChild(batch.proxy);
+                _activeProxy = batch.proxy;
+            }
+            else
+            {
+                _retired.push_back(Retired{batch.proxy, _frameCount});
+            }
+        }
+        else
+        {
+            if (!retainProxyUntilComplete) removeProxy();
+
+            for (auto& subgraph : batch.subgraphs)
+            {
+                subgraph.parent->addChild(subgraph.node);
+            }
+
+            _modelMerged = true;
+            numSubgraphsMerged += static_cast<uint32_t>(batch.subgraphs.size());
+        }
+
+        if (viewer) updateViewer(*viewer, batch.result);
+    }
+
+    if (loadCompleted && !_completed)
+    {
+        removeProxy();
+        _completed = true;
+    }
+
+    // release removed proxies once command buffers that might still reference them have completed
+    while (!_retired.empty() && (_frameCount - _retired.front().frameCount) > numFramesToRetainRemoved)
+    {
+        _retired.pop_front();
+    }
+
+    if (_completed && _retired.empty() && viewer)
+    {
+        // nothing left to do so stop running each frame, allowing render on demand to idle
+        viewer->updateOperations->remove(ref_ptr<Operation>(this));
+    }
+}
@@ -23,6 +23,11 @@ void Perspective::read(Input& input)
     input.read("aspectRatio", aspectRatio);
     input.read("nearDistance", nearDistance);
     input.read("farDistance", farDistance);
+
+    if (input.version_greater_equal(1, 1, 11))
+    {
+        input.read("infiniteFar", infiniteFar);
+    }
 }
 
 void Perspective::write(Output& output) const
@@ -33,4 +38,9 @@ void Perspective::write(Output& output) const
     output.write("aspectRatio", aspectRatio);
     output.write("nearDistance", nearDistance);
     output.write("farDistance", farDistance);
+
+    if (output.version_greater_equal(1, 1, 11))
+    {
+        output.write("infiniteFar", infiniteFar);
+    }
 }
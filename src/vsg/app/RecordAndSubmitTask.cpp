@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Logger.h>
 #include <vsg/ui/ApplicationEvent.h>
 #include <vsg/vk/State.h>
+#include <vsg/vk/TimelineSemaphore.h>
 
 using namespace vsg;
 
@@ -68,6 +69,18 @@ void RecordAndSubmitTask::advance()
 
     if (earlyTransferTask) earlyTransferTask->advance();
     if (lateTransferTask) lateTransferTask->advance();
+
+    // advance each CommandPoolRing once, even when shared between CommandGraphs
+    std::vector<CommandPoolRing*> commandPoolRings;
+    for (auto& commandGraph : commandGraphs)
+    {
+        auto commandPoolRing = commandGraph->commandPoolRing.get();
+        if (commandPoolRing && std::find(commandPoolRings.begin(), commandPoolRings.end(), commandPoolRing) == commandPoolRings.end())
+        {
+            commandPoolRing->advance();
+            commandPoolRings.push_back(commandPoolRing);
+        }
+    }
 }
 
 size_t RecordAndSubmitTask::index(size_t relativeFrameIndex) const
@@ -86,16 +99,22 @@ VkResult RecordAndSubmitTask::submit(ref_ptr<FrameStamp> frameStamp)
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "RecordAndSubmitTask submit", COLOR_RECORD);
 
-    if (VkResult result = start(); result != VK_SUCCESS) return result;
+    // a failed frame is still counted as submitted so that tasks waiting to submit after this one aren't blocked
+    auto failed = [&](VkResult result) {
+        _submitted();
+        return result;
+    };
+
+    if (VkResult result = start(); result != VK_SUCCESS) return failed(result);
 
     if (earlyTransferTask)
     {
-        if (VkResult result = earlyTransferTask->transferDynamicData(); result != VK_SUCCESS) return result;
+        if (VkResult result = earlyTransferTask->transferDynamicData(); result != VK_SUCCESS) return failed(result);
     }
 
     auto recordedCommandBuffers = RecordedCommandBuffers::create();
 
-    if (VkResult result = record(recordedCommandBuffers, frameStamp); result != VK_SUCCESS) return result;
+    if (VkResult result = record(recordedCommandBuffers, frameStamp); result != VK_SUCCESS) return failed(result);
 
     return finish(recordedCommandBuffers);
 }
@@ -104,8 +123,16 @@ VkResult RecordAndSubmitTask::start()
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "RecordAndSubmitTask start", COLOR_RECORD);
 
-    if (earlyTransferTask) earlyTransferTask->currentTransferCompletedSemaphore = {};
-    if (lateTransferTask) lateTransferTask->currentTransferCompletedSemaphore = {};
+    if (earlyTransferTask)
+    {
+        earlyTransferTask->currentTransferCompletedSemaphore = {};
+        earlyTransferTask->currentAcquireCommandBuffer = {};
+    }
+    if (lateTransferTask)
+    {
+        lateTransferTask->currentTransferCompletedSemaphore = {};
+        lateTransferTask->currentAcquireCommandBuffer = {};
+    }
 
     auto current_fence = fence();
     if (current_fence->hasDependencies())
@@ -134,12 +161,33 @@ VkResult RecordAndSubmitTask::finish(ref_ptr<RecordedCommandBuffers> recordedCom
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "RecordAndSubmitTask finish", COLOR_RECORD);
 
+    VkResult result = _finish(recordedCommandBuffers);
+
+    // release any tasks waiting to submit after this one, whether or not this frame's submission succeeded
+    _submitted();
+
+    return result;
+}
+
+void RecordAndSubmitTask::_submitted()
+{
+    ++_numSubmissions;
+    _submissionParker.notify_all();
+}
+
+VkResult RecordAndSubmitTask::_finish(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers)
+{
     if (lateTransferTask)
     {
         if (VkResult result = lateTransferTask->transferDynamicData(); result != VK_SUCCESS) return result;
     }
 
-    if (recordedCommandBuffers->empty())
+    bool usingFrameTimelines = !signalFrameTimelines.empty() || !waitFrameTimelines.empty();
+    if (usingFrameTimelines) ++_frameTimelineValue;
+
+    // tasks on other queues wait on this task's frame timeline values and binary semaphores so an empty submission is still required to signal them,
+    // and binary semaphores signalled by other tasks must still be waited on so they can be signalled again next frame
+    if (recordedCommandBuffers->empty() && !usingFrameTimelines && waitSemaphores.empty() && signalSemaphores.empty())
     {
         // nothing to do so return early
         std::this_thread::sleep_for(std::chrono::milliseconds(16)); // sleep for 1/60th of a second
@@ -154,6 +202,16 @@ VkResult RecordAndSubmitTask::finish(ref_ptr<RecordedCommandBuffers> recordedCom
 
     auto current_fence = fence();
 
+    // queue family ownership of data uploaded on a dedicated transfer queue must be acquired before the recorded command buffers use it
+    for (auto& transferTask : {earlyTransferTask, lateTransferTask})
+    {
+        if (transferTask && transferTask->currentTransferCompletedSemaphore && transferTask->currentAcquireCommandBuffer)
+        {
+            vk_commandBuffers.push_back(*(transferTask->currentAcquireCommandBuffer));
+            current_fence->dependentCommandBuffers().emplace_back(transferTask->currentAcquireCommandBuffer);
+        }
+    }
+
     // convert VSG CommandBuffer to Vulkan handles and add to the Fence's list of dependent CommandBuffers
     auto buffers = recordedCommandBuffers->buffers();
     for (auto& commandBuffer : buffers)
@@ -165,22 +223,23 @@ VkResult RecordAndSubmitTask::finish(ref_ptr<RecordedCommandBuffers> recordedCom
 
     current_fence->dependentSemaphores() = signalSemaphores;
 
-    if (earlyTransferTask && earlyTransferTask->currentTransferCompletedSemaphore)
-    {
-        vk_waitSemaphores.emplace_back(*earlyTransferTask->currentTransferCompletedSemaphore);
-        vk_waitStages.emplace_back(earlyTransferTask->currentTransferCompletedSemaphore->pipelineStageFlags());
-
-        earlyTransferTask->waitSemaphores.push_back(earlyTransferTaskConsumerCompletedSemaphore);
-        vk_signalSemaphores.emplace_back(*earlyTransferTaskConsumerCompletedSemaphore);
-    }
+    // when the queue has a timeline semaphore, transfer dependencies are expressed as timeline values rather than binary semaphores
+    auto& timeline = queue->timeline;
+    std::vector<uint64_t> vk_waitValues;
 
-    if (lateTransferTask && lateTransferTask->currentTransferCompletedSemaphore)
+    for (auto& [transferTask, consumerCompletedSemaphore] : {std::pair(earlyTransferTask, earlyTransferTaskConsumerCompletedSemaphore), std::pair(lateTransferTask, lateTransferTaskConsumerCompletedSemaphore)})
     {
-        vk_waitSemaphores.emplace_back(*lateTransferTask->currentTransferCompletedSemaphore);
-        vk_waitStages.emplace_back(lateTransferTask->currentTransferCompletedSemaphore->pipelineStageFlags());
+        if (!transferTask || !transferTask->currentTransferCompletedSemaphore) continue;
+
+        vk_waitSemaphores.emplace_back(*transferTask->currentTransferCompletedSemaphore);
+        vk_waitStages.emplace_back(transferTask->currentTransferCompletedSemaphore->pipelineStageFlags());
+        vk_waitValues.emplace_back(transferTask->currentTransferCompletedValue);
 
-        lateTransferTask->waitSemaphores.push_back(lateTransferTaskConsumerCompletedSemaphore);
-        vk_signalSemaphores.emplace_back(*lateTransferTaskConsumerCompletedSemaphore);
+        if (!timeline)
+        {
+            transferTask->waitSemaphores.push_back(consumerCompletedSemaphore);
+            vk_signalSemaphores.emplace_back(*consumerCompletedSemaphore);
+        }
     }
 
     for (auto& window : windows)
@@ -205,6 +264,34 @@ VkResult RecordAndSubmitTask::finish(ref_ptr<RecordedCommandBuffers> recordedCom
         vk_signalSemaphores.emplace_back(*(semaphore));
     }
 
+    std::vector<uint64_t> vk_signalValues;
+    if (usingFrameTimelines)
+    {
+        vk_waitValues.resize(vk_waitSemaphores.size(), 0);
+        for (auto& [semaphore, framesBehind, waitStages] : waitFrameTimelines)
+        {
+            if (framesBehind >= _frameTimelineValue) continue;
+
+            vk_waitSemaphores.emplace_back(*semaphore);
+            vk_waitStages.emplace_back(waitStages);
+            vk_waitValues.emplace_back(_frameTimelineValue - framesBehind);
+        }
+
+        vk_signalValues.resize(vk_signalSemaphores.size(), 0);
+        for (auto& semaphore : signalFrameTimelines)
+        {
+            vk_signalSemaphores.emplace_back(*semaphore);
+            vk_signalValues.emplace_back(_frameTimelineValue);
+        }
+    }
+
+    // the binary semaphores waited on must already have been signalled by a submission to another queue
+    for (auto& task : submitAfter)
+    {
+        uint64_t numSubmissions = _numSubmissions.load() + 1;
+        task->_submissionParker.wait([&]() { return task->_numSubmissions.load() >= numSubmissions; });
+    }
+
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -218,7 +305,40 @@ VkResult RecordAndSubmitTask::finish(ref_ptr<RecordedCommandBuffers> recordedCom
     submitInfo.signalSemaphoreCount = static_cast<uint32_t>(vk_signalSemaphores.size());
     submitInfo.pSignalSemaphores = vk_signalSemaphores.data();
 
-    return queue->submit(submitInfo, current_fence);
+    if (!timeline)
+    {
+        VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+        if (usingFrameTimelines)
+        {
+            vk_waitValues.resize(vk_waitSemaphores.size(), 0);
+
+            timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+            timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(vk_waitValues.size());
+            timelineInfo.pWaitSemaphoreValues = vk_waitValues.data();
+            timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(vk_signalValues.size());
+            timelineInfo.pSignalSemaphoreValues = vk_signalValues.data();
+            submitInfo.pNext = &timelineInfo;
+        }
+        return queue->submit(submitInfo, current_fence);
+    }
+
+    uint64_t signalValue = 0;
+    if (VkResult result = queue->submit(submitInfo, vk_waitValues, signalValue, vk_signalValues); result != VK_SUCCESS) return result;
+
+    // the next transfer submissions mustn't overwrite the data this submission uses until it has completed
+    for (auto& transferTask : {earlyTransferTask, lateTransferTask})
+    {
+        if (transferTask && transferTask->currentTransferCompletedSemaphore)
+        {
+            transferTask->waitSemaphores.push_back(timeline);
+            transferTask->waitValues.resize(transferTask->waitSemaphores.size() - 1, 0);
+            transferTask->waitValues.push_back(signalValue);
+        }
+    }
+
+    current_fence->assignTimelineValue(timeline, signalValue);
+
+    return VK_SUCCESS;
 }
 
 void RecordAndSubmitTask::assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation)
@@ -236,6 +356,17 @@ void RecordAndSubmitTask::assignInstrumentation(ref_ptr<Instrumentation> in_inst
     }
 }
 
+void RecordAndSubmitTask::assignFrameStatistics(ref_ptr<FrameStatistics> in_frameStatistics)
+{
+    frameStatistics = in_frameStatistics;
+
+    for (auto cg : commandGraphs)
+    {
+        cg->frameStatistics = frameStatistics;
+        cg->getOrCreateRecordTraversal()->frameStatistics = frameStatistics;
+    }
+}
+
 void vsg::updateTasks(RecordAndSubmitTasks& tasks, ref_ptr<CompileManager> compileManager, const CompileResult& compileResult)
 {
     //info("vsg::updateTasks(RecordAndSubmitTasks& tasks..) compileResult.maxSlot = ", compileResult.maxSlot);
@@ -0,0 +1,188 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RecordSignature.h>
+#include <vsg/app/RenderGraph.h>
+#include <vsg/app/View.h>
+#include <vsg/commands/ExecuteCommands.h>
+#include <vsg/nodes/InstrumentationNode.h>
+#include <vsg/nodes/PagedLOD.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/StreamingTexture.h>
+#include <vsg/nodes/Switch.h>
+#include <vsg/nodes/Transform.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/GraphicsPipeline.h>
+
+using namespace vsg;
+
+// FNV-1a 64 bit offset basis and prime
+static constexpr uint64_t s_offsetBasis = 14695981039346656037ull;
+static constexpr uint64_t s_prime = 1099511628211ull;
+
+static std::atomic_uint64_t s_invalidationCount{0};
+
+// state that is still being compiled in the background leads to the subgraph being skipped or a fallback pipeline being recorded
+static bool s_pending(const StateCommand& stateCommand)
+{
+    if (stateCommand.pending()) return true;
+    if (auto bgp = dynamic_cast<const BindGraphicsPipeline*>(&stateCommand); bgp && bgp->pipeline && bgp->pipeline->pending()) return true;
+    return false;
+}
+
+RecordSignature::RecordSignature() :
+    signature(s_offsetBasis)
+{
+}
+
+void RecordSignature::invalidate()
+{
+    ++s_invalidationCount;
+}
+
+void RecordSignature::reset()
+{
+    signature = s_offsetBasis;
+    reusable = true;
+
+    // signatures computed after an invalidate() never match those computed before it
+    add(s_invalidationCount.load());
+}
+
+void RecordSignature::add(const void* ptr, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(ptr);
+    for (size_t i = 0; i < size; ++i)
+    {
+        signature = (signature ^ bytes[i]) * s_prime;
+    }
+}
+
+void RecordSignature::apply(const Object& object)
+{
+    // pointers of the objects traversed capture changes to the structure of the subgraph
+    add(&object);
+    object.traverse(*this);
+}
+
+void RecordSignature::apply(const Node& node)
+{
+    // the TextureStreamer relies on StreamingTexture being recorded each frame to request finer mip levels, and swaps the activeState that is bound,
+    // the StreamingTexture::traverse() only visiting the coarseState
+    if (auto streamingTexture = node.cast<StreamingTexture>())
+    {
+        reusable = false;
+        add(streamingTexture->activeState.get());
+    }
+    apply(static_cast<const Object&>(node));
+}
+
+void RecordSignature::apply(const Data& data)
+{
+    add(&data);
+    if (!data.dynamic())
+    {
+        ModifiedCount modifiedCount;
+        data.getModifiedCount(modifiedCount);
+        add(modifiedCount.count);
+    }
+}
+
+void RecordSignature::apply(const Transform& transform)
+{
+    add(transform.transform(dmat4()));
+    apply(static_cast<const Object&>(transform));
+}
+
+void RecordSignature::apply(const Switch& sw)
+{
+    for (auto& child : sw.children)
+    {
+        add(child.mask);
+    }
+    apply(static_cast<const Object&>(sw));
+}
+
+void RecordSignature::apply(const PagedLOD& plod)
+{
+    // the DatabasePager relies on PagedLOD being traversed each frame to request loading and to retain high resolution children
+    reusable = false;
+    apply(static_cast<const Object&>(plod));
+}
+
+void RecordSignature::apply(const InstrumentationNode& instrumentationNode)
+{
+    // timestamp queries need to be recorded each frame
+    reusable = false;
+    apply(static_cast<const Object&>(instrumentationNode));
+}
+
+void RecordSignature::apply(const Command& command)
+{
+    // the secondary command buffers executed are provided each frame by their SecondaryCommandGraph
+    if (dynamic_cast<const ExecuteCommands*>(&command)) reusable = false;
+
+    // the command buffers need to be recorded again once pending state has been compiled
+    if (auto stateCommand = dynamic_cast<const StateCommand*>(&command); stateCommand && s_pending(*stateCommand)) reusable = false;
+
+    // the dynamic offset of a DynamicBufferRing changes every frame
+    if (auto bds = dynamic_cast<const BindDescriptorSet*>(&command); bds && bds->bufferRing) add(bds->bufferRing->dynamicOffset());
+    apply(static_cast<const Object&>(command));
+}
+
+void RecordSignature::apply(const StateGroup& stateGroup)
+{
+    // StateGroup::traverse() doesn't visit the stateCommands so check them directly
+    for (auto& stateCommand : stateGroup.stateCommands)
+    {
+        add(stateCommand.get());
+        if (s_pending(*stateCommand)) reusable = false;
+    }
+    apply(static_cast<const Object&>(stateGroup));
+}
+
+void RecordSignature::apply(const View& view)
+{
+    add(view.mask);
+    add(view.minimumFeatureSize);
+    add(view.lodBias);
+    add(view.requestLodBias);
+    if (auto& camera = view.camera)
+    {
+        add(camera.get());
+        if (camera->projectionMatrix) add(camera->projectionMatrix->transform());
+        if (camera->viewMatrix) add(camera->viewMatrix->transform());
+        if (camera->viewportState)
+        {
+            for (auto& viewport : camera->viewportState->viewports) add(viewport);
+            for (auto& scissor : camera->viewportState->scissors) add(scissor);
+        }
+    }
+    apply(static_cast<const Object&>(view));
+}
+
+void RecordSignature::apply(const RenderGraph& renderGraph)
+{
+    if (renderGraph.framebuffer)
+        add(renderGraph.framebuffer.get());
+    else if (renderGraph.window && renderGraph.window->imageIndex() < renderGraph.window->numFrames())
+        add(renderGraph.window->framebuffer(renderGraph.window->imageIndex()).get());
+
+    add(renderGraph.renderArea);
+    add(renderGraph.contents);
+    for (auto& clearValue : renderGraph.clearValues) add(clearValue);
+
+    // the secondary CommandBuffers are allocated per frame so can't be executed by a reused primary CommandBuffer
+    if (renderGraph.parallelSecondaryCommandBuffers) reusable = false;
+
+    apply(static_cast<const Object&>(renderGraph));
+}
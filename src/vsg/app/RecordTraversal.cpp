@@ -11,8 +11,15 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/app/CommandGraph.h>
+#include <vsg/app/DepthPrePass.h>
+#include <vsg/app/OcclusionCulling.h>
+#include <vsg/app/OcclusionQueries.h>
 #include <vsg/app/RecordTraversal.h>
+#include <vsg/app/RenderGraph.h>
+#include <vsg/app/SharedCull.h>
+#include <vsg/app/TextureStreamer.h>
 #include <vsg/app/View.h>
+#include <vsg/app/VisibilityCache.h>
 #include <vsg/commands/Command.h>
 #include <vsg/commands/Commands.h>
 #include <vsg/io/DatabasePager.h>
@@ -24,30 +31,91 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/nodes/CullGroup.h>
 #include <vsg/nodes/CullNode.h>
 #include <vsg/nodes/DepthSorted.h>
+#include <vsg/nodes/FlattenedSubgraph.h>
 #include <vsg/nodes/Geometry.h>
 #include <vsg/nodes/Group.h>
 #include <vsg/nodes/LOD.h>
 #include <vsg/nodes/Light.h>
+#include <vsg/nodes/InstanceNode.h>
 #include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/OcclusionQueryNode.h>
 #include <vsg/nodes/PagedLOD.h>
+#include <vsg/nodes/PointCloud.h>
 #include <vsg/nodes/QuadGroup.h>
+#include <vsg/nodes/SpatialGroup.h>
 #include <vsg/nodes/StateGroup.h>
 #include <vsg/nodes/Switch.h>
 #include <vsg/nodes/TileDatabase.h>
 #include <vsg/nodes/VertexDraw.h>
 #include <vsg/nodes/VertexIndexDraw.h>
 #include <vsg/state/ViewDependentState.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/threading/OperationThreads.h>
 #include <vsg/threading/atomics.h>
 #include <vsg/ui/ApplicationEvent.h>
 #include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/CommandPoolRing.h>
 #include <vsg/vk/RenderPass.h>
 #include <vsg/vk/State.h>
 
 #include <vsg/utils/Instrumentation.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace vsg;
 
 #define INLINE_TRAVERSE 0
+#define STATIC_DISPATCH 1
+
+void RecordTraversal::dispatch(const Node& node)
+{
+#if STATIC_DISPATCH
+    switch (static_cast<RecordTag>(node.recordTag()))
+    {
+    case RecordTag::GROUP: apply(static_cast<const Group&>(node)); return;
+    case RecordTag::QUAD_GROUP: apply(static_cast<const QuadGroup&>(node)); return;
+    case RecordTag::STATE_GROUP: apply(static_cast<const StateGroup&>(node)); return;
+    case RecordTag::MATRIX_TRANSFORM: apply(static_cast<const MatrixTransform&>(node)); return;
+    case RecordTag::CULL_NODE: apply(static_cast<const CullNode&>(node)); return;
+    case RecordTag::CULL_GROUP: apply(static_cast<const CullGroup&>(node)); return;
+    case RecordTag::LOD: apply(static_cast<const LOD&>(node)); return;
+    case RecordTag::VERTEX_INDEX_DRAW: apply(static_cast<const VertexIndexDraw&>(node)); return;
+    case RecordTag::GEOMETRY: apply(static_cast<const Geometry&>(node)); return;
+    default: break;
+    }
+#endif
+    node.accept(*this);
+}
+
+namespace
+{
+    // when the node is exactly of type T its children can be dispatched directly, subclasses may override traverse() so must use it
+    template<class T>
+    inline void traverseChildren(RecordTraversal& rt, const T& node)
+    {
+#if STATIC_DISPATCH
+        if (node.recordTag() == static_cast<uint8_t>(record_tag_v<T>))
+        {
+            for (auto& child : node.children) rt.dispatch(*child);
+            return;
+        }
+#endif
+        node.traverse(rt);
+    }
+
+    inline void traverseChildren(RecordTraversal& rt, const CullNode& cullNode)
+    {
+#if STATIC_DISPATCH
+        if (cullNode.recordTag() == static_cast<uint8_t>(RecordTag::CULL_NODE))
+        {
+            rt.dispatch(*cullNode.child);
+            return;
+        }
+#endif
+        cullNode.traverse(rt);
+    }
+} // namespace
 
 RecordTraversal::RecordTraversal(uint32_t in_maxSlot, std::set<Bin*> in_bins) :
     _state(new State(in_maxSlot))
@@ -120,11 +188,16 @@ void RecordTraversal::apply(const Group& group)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "Group", COLOR_RECORD_L2, &group);
 
+    if (cullThreads && !_drawList && group.children.size() >= minimumParallelCullChildren)
+    {
+        if (_parallelCull(group.children.data(), group.children.size())) return;
+    }
+
     //debug("Visiting Group");
 #if INLINE_TRAVERSE
     vsg::Group::t_traverse(group, *this);
 #else
-    group.traverse(*this);
+    traverseChildren(*this, group);
 #endif
 }
 
@@ -132,12 +205,107 @@ void RecordTraversal::apply(const QuadGroup& quadGroup)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "QuadGroup", COLOR_RECORD_L2, &quadGroup);
 
+    if (cullThreads && !_drawList && quadGroup.children.size() >= minimumParallelCullChildren)
+    {
+        if (_parallelCull(quadGroup.children.data(), quadGroup.children.size())) return;
+    }
+
     //debug("Visiting QuadGroup");
+
+    // quad trees are typically built from CullGroups and CullNodes so test their bounds as a single batch,
+    // traversing the visible ones directly so they aren't tested again.
+    double x[4], y[4], z[4], radius[4];
+    const dsphere* bounds[4] = {nullptr, nullptr, nullptr, nullptr};
+    CullType cullTypes[4] = {CULL_GROUP, CULL_GROUP, CULL_GROUP, CULL_GROUP};
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto& type = quadGroup.children[i]->type_info();
+        if (type == typeid(CullGroup))
+            bounds[i] = &(static_cast<const CullGroup*>(quadGroup.children[i].get())->bound);
+        else if (type == typeid(CullNode))
+        {
+            bounds[i] = &(static_cast<const CullNode*>(quadGroup.children[i].get())->bound);
+            cullTypes[i] = CULL_NODE;
+        }
+
+        const dsphere& bound = bounds[i] ? *bounds[i] : dsphere(0.0, 0.0, 0.0, -1.0);
+        x[i] = bound.x;
+        y[i] = bound.y;
+        z[i] = bound.z;
+        radius[i] = bound.radius;
+    }
+
+    if (!bounds[0] && !bounds[1] && !bounds[2] && !bounds[3])
+    {
 #if INLINE_TRAVERSE
-    vsg::QuadGroup::t_traverse(quadGroup, *this);
+        vsg::QuadGroup::t_traverse(quadGroup, *this);
 #else
-    quadGroup.traverse(*this);
+        traverseChildren(*this, quadGroup);
 #endif
+        return;
+    }
+
+    uint64_t visible = (_insideFrustum > 0) ? 0xf : _state->intersect(x, y, z, radius, 4);
+    if (visible != 0 && _minimumScreenHeightRatio > 0.0)
+    {
+        const auto& lodScale = _state->_frustumStack.top().lodScale;
+        for (int i = 0; i < 4; ++i)
+        {
+            auto lodDistance = std::abs(lodScale[0] * x[i] + lodScale[1] * y[i] + lodScale[2] * z[i] + lodScale[3]);
+            if (radius[i] < lodDistance * _minimumScreenHeightRatio) visible &= ~(uint64_t(1) << i);
+        }
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto& child = quadGroup.children[i];
+        if (!bounds[i])
+            dispatch(*child);
+        else if ((visible & (uint64_t(1) << i)) != 0 && !(_occlusionCulling && _occlusionCulling->cull(child.get(), *bounds[i], _state->modelviewMatrixStack.top())))
+        {
+            ++cullStatistics.traversed[cullTypes[i]];
+            child->traverse(*this);
+        }
+        else
+            ++cullStatistics.culled[cullTypes[i]];
+    }
+}
+
+void RecordTraversal::apply(const SpatialGroup& spatialGroup)
+{
+    GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "SpatialGroup", COLOR_RECORD_L2, &spatialGroup);
+
+    auto& children = spatialGroup.children();
+    for (auto& [key, cell] : spatialGroup.cells())
+    {
+        // test the cell bounds directly rather than via _inFrustum() as the VisibilityCache is keyed on nodes
+        bool entirelyInside = false;
+        if (_insideFrustum == 0)
+        {
+            const auto& frustum = _state->_frustumStack.top();
+            if (!frustum.intersect(cell.bound))
+            {
+                cullStatistics.culled[SPATIAL_GROUP_CHILD] += cell.children.size();
+                continue;
+            }
+            entirelyInside = frustum.insideMargin(cell.bound) > 0.0;
+        }
+
+        if (entirelyInside) ++_insideFrustum;
+        for (auto index : cell.children)
+        {
+            auto& child = children[index];
+            if (_visible(child.node.get(), child.bound))
+            {
+                ++cullStatistics.traversed[SPATIAL_GROUP_CHILD];
+                dispatch(*child.node);
+            }
+            else
+            {
+                ++cullStatistics.culled[SPATIAL_GROUP_CHILD];
+            }
+        }
+        if (entirelyInside) --_insideFrustum;
+    }
 }
 
 void RecordTraversal::apply(const LOD& lod)
@@ -147,19 +315,25 @@ void RecordTraversal::apply(const LOD& lod)
     const auto& sphere = lod.bound;
 
     // check if lod bounding sphere is in view frustum.
-    auto lodDistance = _state->lodDistance(sphere);
-    if (lodDistance < 0.0)
+    bool entirelyInside = false;
+    if (!_inFrustum(&lod, sphere, entirelyInside))
     {
+        ++cullStatistics.culled[LOD_NODE];
         return;
     }
 
+    ++cullStatistics.traversed[LOD_NODE];
+
+    auto lodDistance = _state->lodDistanceWithoutCulling(sphere);
     for (auto& child : lod.children)
     {
-        auto cutoff = lodDistance * child.minimumScreenHeightRatio;
+        auto cutoff = lodDistance * child.minimumScreenHeightRatio * _lodBias;
         bool child_visible = sphere.r > cutoff;
         if (child_visible)
         {
-            child.node->accept(*this);
+            if (entirelyInside) ++_insideFrustum;
+            dispatch(*child.node);
+            if (entirelyInside) --_insideFrustum;
             return;
         }
     }
@@ -173,9 +347,11 @@ void RecordTraversal::apply(const PagedLOD& plod)
     auto frameCount = _frameStamp->frameCount;
 
     // check if lod bounding sphere is in view frustum.
-    auto lodDistance = _state->lodDistance(sphere);
-    if (lodDistance < 0.0)
+    bool entirelyInside = false;
+    if (!_inFrustum(&plod, sphere, entirelyInside))
     {
+        ++cullStatistics.culled[PAGED_LOD_NODE];
+
         if ((frameCount - plod.frameHighResLastUsed) > 1 && _culledPagedLODs)
         {
             _culledPagedLODs->highresCulled.emplace_back(&plod);
@@ -184,11 +360,15 @@ void RecordTraversal::apply(const PagedLOD& plod)
         return;
     }
 
+    ++cullStatistics.traversed[PAGED_LOD_NODE];
+
+    auto lodDistance = _state->lodDistanceWithoutCulling(sphere);
+
     // check the high res child to see if it's visible
     {
         const auto& child = plod.children[0];
 
-        auto cutoff = lodDistance * child.minimumScreenHeightRatio;
+        auto cutoff = lodDistance * child.minimumScreenHeightRatio * _lodBias;
         bool child_visible = sphere.r > cutoff;
         if (child_visible)
         {
@@ -201,13 +381,19 @@ void RecordTraversal::apply(const PagedLOD& plod)
             if (child.node)
             {
                 // high res visible and available so traverse it
-                child.node->accept(*this);
+                if (entirelyInside) ++_insideFrustum;
+                dispatch(*child.node);
+                if (entirelyInside) --_insideFrustum;
                 return;
             }
-            else if (_databasePager)
+            else if (auto requestCutoff = cutoff * _requestLodBias; _databasePager && _suppressPagedLODRequests == 0 && sphere.r > requestCutoff)
             {
-                auto priority = sphere.r / cutoff;
-                exchange_if_greater(plod.priority, priority);
+                // reset the priority on the first visit of each frame so the DatabasePager can reprioritize requests as the view changes
+                auto priority = sphere.r / requestCutoff;
+                if (previousHighResUsed != frameCount)
+                    plod.priority.exchange(priority);
+                else
+                    exchange_if_greater(plod.priority, priority);
 
                 auto previousRequestCount = plod.requestCount.fetch_add(1);
                 if (previousRequestCount == 0)
@@ -233,13 +419,99 @@ void RecordTraversal::apply(const PagedLOD& plod)
     // check the low res child to see if it's visible
     {
         const auto& child = plod.children[1];
-        auto cutoff = lodDistance * child.minimumScreenHeightRatio;
+        auto cutoff = lodDistance * child.minimumScreenHeightRatio * _lodBias;
         bool child_visible = sphere.r > cutoff;
         if (child_visible)
         {
             if (child.node)
             {
-                child.node->accept(*this);
+                if (entirelyInside) ++_insideFrustum;
+                dispatch(*child.node);
+                if (entirelyInside) --_insideFrustum;
+            }
+        }
+    }
+}
+
+void RecordTraversal::apply(const PointCloud& pointCloud)
+{
+    GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "PointCloud", COLOR_PAGER, &pointCloud);
+
+    const auto& octants = pointCloud.octants;
+    if (octants.empty()) return;
+
+    auto frameCount = _frameStamp->frameCount;
+
+    // select octants in order of decreasing screen size, the larger an octant appears the more its points contribute.
+    using Candidate = std::pair<double, uint32_t>;
+    std::vector<Candidate> candidates;
+    auto addCandidate = [&](uint32_t index, bool root) {
+        const auto& sphere = octants[index].bound;
+        auto lodDistance = _state->lodDistance(sphere);
+        if (lodDistance < 0.0) return;
+
+        // children are only selected when their parent is large enough on screen to benefit from the extra detail
+        if (!root && sphere.r <= lodDistance * pointCloud.minimumScreenHeightRatio * _lodBias) return;
+
+        candidates.emplace_back(lodDistance > 0.0 ? sphere.r / lodDistance : std::numeric_limits<double>::max(), index);
+        std::push_heap(candidates.begin(), candidates.end());
+    };
+
+    addCandidate(0, true);
+
+    uint64_t numPoints = 0;
+    while (!candidates.empty())
+    {
+        std::pop_heap(candidates.begin(), candidates.end());
+        auto [priority, index] = candidates.back();
+        candidates.pop_back();
+
+        const auto& octant = octants[index];
+        if (numPoints > 0 && (numPoints + octant.numPoints) > pointCloud.pointBudget) break;
+
+        auto& tile = octant.tile;
+        if (!tile) continue;
+
+        auto previousHighResUsed = tile->frameHighResLastUsed.exchange(frameCount);
+        if (_culledPagedLODs && tile->filename && (frameCount - previousHighResUsed) > 1)
+        {
+            _culledPagedLODs->newHighresRequired.emplace_back(tile.get());
+        }
+
+        if (const auto& node = tile->children[0].node)
+        {
+            ++cullStatistics.traversed[PAGED_LOD_NODE];
+            numPoints += octant.numPoints;
+            node->accept(*this);
+
+            for (auto child : octant.children)
+            {
+                if (child != 0) addCandidate(child, false);
+            }
+        }
+        else if (_databasePager && tile->filename)
+        {
+            if (previousHighResUsed != frameCount)
+                tile->priority.exchange(priority);
+            else
+                exchange_if_greater(tile->priority, priority);
+
+            if (tile->requestCount.fetch_add(1) == 0)
+            {
+                _databasePager->request(tile);
+            }
+        }
+    }
+
+    // tiles that were selected last frame but not this frame can now be expired by the DatabasePager
+    if (_culledPagedLODs)
+    {
+        for (const auto& octant : octants)
+        {
+            if (octant.tile && octant.tile->filename && (frameCount - octant.tile->frameHighResLastUsed.load()) == 1)
+            {
+                ++cullStatistics.culled[PAGED_LOD_NODE];
+                _culledPagedLODs->highresCulled.emplace_back(octant.tile.get());
             }
         }
     }
@@ -252,26 +524,172 @@ void RecordTraversal::apply(const TileDatabase& tileDatabase)
     tileDatabase.traverse(*this);
 }
 
+bool RecordTraversal::_inFrustum(const Node* node, const dsphere& bound, bool& entirelyInside)
+{
+    if (_insideFrustum > 0) return true;
+    if (!_visibilityCache) return _state->intersect(bound);
+
+    // cached results are only valid while the node's bound stays fixed relative to the world
+    bool cacheable = _visibilityCache->cacheTransformedNodes || (_inheritedFrustumDepth + _state->_frustumStack.size()) == 1;
+    if (cacheable && _visibilityCache->inside(node))
+    {
+        entirelyInside = true;
+        return true;
+    }
+
+    const auto& frustum = _state->_frustumStack.top();
+    if (!frustum.intersect(bound)) return false;
+
+    auto margin = frustum.insideMargin(bound);
+    if (margin > 0.0)
+    {
+        entirelyInside = true;
+        if (cacheable)
+        {
+            // convert from local to eye coordinate units
+            const auto& mv = _state->modelviewMatrixStack.top();
+            double scale = length(dvec3(mv[0][0], mv[0][1], mv[0][2]));
+            _visibilityCache->insert(node, margin * scale, length(mv * bound.center));
+        }
+    }
+    return true;
+}
+
+bool RecordTraversal::_visible(const Node* node, const dsphere& bound)
+{
+    bool entirelyInside = false;
+    return _visible(node, bound, entirelyInside);
+}
+
+bool RecordTraversal::_visible(const Node* node, const dsphere& bound, bool& entirelyInside)
+{
+    if (!_inFrustum(node, bound, entirelyInside)) return false;
+    if (_minimumScreenHeightRatio > 0.0 && bound.radius < _state->lodDistanceWithoutCulling(bound) * _minimumScreenHeightRatio) return false;
+    return !_occlusionCulling || !_occlusionCulling->cull(node, bound, _state->modelviewMatrixStack.top());
+}
+
 void RecordTraversal::apply(const CullGroup& cullGroup)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "CullGroup", COLOR_RECORD_L2, &cullGroup);
 
-    if (_state->intersect(cullGroup.bound))
+    bool entirelyInside = false;
+    if (_visible(&cullGroup, cullGroup.bound, entirelyInside))
     {
         // debug("Passed node");
-        cullGroup.traverse(*this);
+        ++cullStatistics.traversed[CULL_GROUP];
+        if (entirelyInside) ++_insideFrustum;
+        traverseChildren(*this, cullGroup);
+        if (entirelyInside) --_insideFrustum;
+    }
+    else
+    {
+        ++cullStatistics.culled[CULL_GROUP];
+    }
+}
+
+void RecordTraversal::apply(const StreamingTexture& streamingTexture)
+{
+    GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "StreamingTexture", COLOR_RECORD_L2, &streamingTexture);
+
+    auto lodDistance = _state->lodDistance(streamingTexture.bound);
+    if (lodDistance < 0.0 || !streamingTexture.activeState) return;
+
+    streamingTexture.frameLastUsed = _frameStamp->frameCount;
+
+    if (streamingTexture.streamer && streamingTexture.activeMipLevel > 0)
+    {
+        auto requiredMipLevel = streamingTexture.streamer->computeRequiredMipLevel(streamingTexture, streamingTexture.bound.r / lodDistance);
+        if (requiredMipLevel < streamingTexture.activeMipLevel) streamingTexture.streamer->request(streamingTexture, requiredMipLevel);
     }
+
+    auto& command = streamingTexture.activeState;
+    _state->stateStacks[command->slot].push(command);
+    _state->dirty = true;
+
+    if (streamingTexture.child) streamingTexture.child->accept(*this);
+
+    _state->stateStacks[command->slot].pop();
+    _state->dirty = true;
 }
 
 void RecordTraversal::apply(const CullNode& cullNode)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "CullNode", COLOR_RECORD_L2, &cullNode);
 
-    if (_state->intersect(cullNode.bound))
+    bool entirelyInside = false;
+    if (_visible(&cullNode, cullNode.bound, entirelyInside))
     {
         //debug("Passed node");
-        cullNode.traverse(*this);
+        ++cullStatistics.traversed[CULL_NODE];
+        if (entirelyInside) ++_insideFrustum;
+        traverseChildren(*this, cullNode);
+        if (entirelyInside) --_insideFrustum;
+    }
+    else
+    {
+        ++cullStatistics.culled[CULL_NODE];
+    }
+}
+
+void RecordTraversal::apply(const OcclusionQueryNode& oqn)
+{
+    GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "OcclusionQueryNode", COLOR_RECORD_L2, &oqn);
+
+    // queries are written directly to the command buffer so leave the node to be recorded with the draw list
+    if (_drawList)
+    {
+        if (_state->intersect(oqn.bound))
+        {
+            _drawList->add(_state, 0.0, &oqn);
+            _drawListDeferred = true;
+        }
+        return;
+    }
+
+    bool entirelyInside = false;
+    if (!_visible(&oqn, oqn.bound, entirelyInside))
+    {
+        ++cullStatistics.culled[CULL_NODE];
+        return;
+    }
+
+    ++cullStatistics.traversed[CULL_NODE];
+    if (entirelyInside) ++_insideFrustum;
+
+    // queries and conditional rendering aren't inherited by secondary command buffers, so just record the child
+    if (!occlusionQueries || _secondaryRecording)
+    {
+        if (oqn.child) dispatch(*oqn.child);
     }
+    else
+    {
+        auto& commandBuffer = *(_state->_commandBuffer);
+        if (oqn.proxy)
+        {
+            auto reference = occlusionQueries->begin(commandBuffer, oqn);
+            dispatch(*oqn.proxy);
+            occlusionQueries->end(commandBuffer, reference);
+        }
+
+        bool visible = oqn.visible(_frameStamp ? _frameStamp->frameCount : 0);
+        if (oqn.child && (visible || oqn.recordHidden))
+        {
+            bool conditional = occlusionQueries->beginConditionalRendering(commandBuffer, oqn);
+            if (visible)
+            {
+                dispatch(*oqn.child);
+            }
+            else if (conditional)
+            {
+                ++_suppressPagedLODRequests;
+                dispatch(*oqn.child);
+                --_suppressPagedLODRequests;
+            }
+            if (conditional) occlusionQueries->endConditionalRendering(commandBuffer);
+        }
+    }
+
+    if (entirelyInside) --_insideFrustum;
 }
 
 void RecordTraversal::apply(const Switch& sw)
@@ -282,7 +700,7 @@ void RecordTraversal::apply(const Switch& sw)
     {
         if ((traversalMask & (overrideMask | child.mask)) != MASK_OFF)
         {
-            child.node->accept(*this);
+            dispatch(*child.node);
         }
     }
 }
@@ -291,13 +709,123 @@ void RecordTraversal::apply(const DepthSorted& depthSorted)
 {
     CPU_INSTRUMENTATION_L2_NCO(instrumentation, "DepthSorted", COLOR_RECORD_L2, &depthSorted);
 
-    if (_state->intersect(depthSorted.bound))
+    // bins aren't thread safe so leave DepthSorted to be binned when the draw list is recorded
+    if (_drawList)
+    {
+        if (_state->intersect(depthSorted.bound))
+        {
+            _drawList->add(_state, 0.0, &depthSorted);
+            _drawListDeferred = true;
+        }
+        return;
+    }
+
+
+    auto& bin = _bins[depthSorted.binNumber - _minimumBinNumber];
+    auto minimumScreenHeightRatio = (bin->minimumFeatureSize >= 0.0) ? bin->minimumFeatureSize * _pixelsToScreenHeightRatio : _minimumScreenHeightRatio;
+    if (minimumScreenHeightRatio > 0.0)
+    {
+        auto lodDistance = _state->lodDistance(depthSorted.bound);
+        if (lodDistance < 0.0 || depthSorted.bound.radius < lodDistance * minimumScreenHeightRatio)
+        {
+            ++cullStatistics.culled[DEPTH_SORTED];
+            return;
+        }
+    }
+    else if (!_state->intersect(depthSorted.bound))
+    {
+        ++cullStatistics.culled[DEPTH_SORTED];
+        return;
+    }
+
+    ++cullStatistics.traversed[DEPTH_SORTED];
+
+    const auto& mv = _state->modelviewMatrixStack.top();
+    auto& center = depthSorted.bound.center;
+    auto distance = -(mv[0][2] * center.x + mv[1][2] * center.y + mv[2][2] * center.z + mv[3][2]);
+
+    bin->add(_state, distance, depthSorted.child);
+}
+
+void RecordTraversal::apply(const FlattenedSubgraph& flattenedSubgraph)
+{
+    GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "FlattenedSubgraph", COLOR_RECORD_L2, &flattenedSubgraph);
+
+    // the draw list captures the nodes to record so cull the original subgraph
+    if (_drawList)
     {
-        const auto& mv = _state->modelviewMatrixStack.top();
-        auto& center = depthSorted.bound.center;
-        auto distance = -(mv[0][2] * center.x + mv[1][2] * center.y + mv[2][2] * center.z + mv[3][2]);
+        flattenedSubgraph.traverse(*this);
+        return;
+    }
+
+    const auto& stream = flattenedSubgraph.stream();
+    const auto* entries = stream.entries.data();
+    const uint32_t numEntries = static_cast<uint32_t>(stream.entries.size());
 
-        _bins[depthSorted.binNumber - _minimumBinNumber]->add(_state, distance, depthSorted.child);
+    uint32_t i = 0;
+    while (i < numEntries)
+    {
+        const auto& entry = entries[i];
+        switch (entry.operation)
+        {
+        case FlattenedSubgraph::CULL:
+            if (!_visible(stream.cullNodes[entry.index], stream.bounds[entry.index]))
+            {
+                i = entry.end;
+                continue;
+            }
+            break;
+        case FlattenedSubgraph::PUSH_STATE: {
+            const auto* stateCommands = stream.stateCommands.data() + entry.index;
+            bool pending = false;
+            for (uint32_t c = 0; c < entry.count; ++c) pending = pending || stateCommands[c]->pending();
+            if (pending)
+            {
+                i = entry.end;
+                continue;
+            }
+            for (uint32_t c = 0; c < entry.count; ++c) _state->stateStacks[stateCommands[c]->slot].push(stateCommands[c]);
+            _state->dirty = true;
+            break;
+        }
+        case FlattenedSubgraph::POP_STATE: {
+            const auto* stateCommands = stream.stateCommands.data() + entry.index;
+            for (uint32_t c = 0; c < entry.count; ++c) _state->stateStacks[stateCommands[c]->slot].pop();
+            _state->dirty = true;
+            break;
+        }
+        case FlattenedSubgraph::PUSH_TRANSFORM: {
+            const auto& mt = static_cast<const MatrixTransform&>(*stream.nodes[entry.index]);
+            _state->modelviewMatrixStack.push(mt);
+            _state->dirty = true;
+            if (mt.subgraphRequiresLocalFrustum) _state->pushFrustum();
+            break;
+        }
+        case FlattenedSubgraph::POP_TRANSFORM: {
+            const auto& mt = static_cast<const MatrixTransform&>(*stream.nodes[entry.index]);
+            if (mt.subgraphRequiresLocalFrustum) _state->popFrustum();
+            _state->modelviewMatrixStack.pop();
+            _state->dirty = true;
+            break;
+        }
+        case FlattenedSubgraph::COMMAND:
+            _state->record();
+            stream.commands[entry.index]->record(*(_state->_commandBuffer));
+            break;
+        case FlattenedSubgraph::STATE_COMMAND: {
+            _state->record();
+            const auto& command = stream.commands[entry.index];
+            command->record(*(_state->_commandBuffer));
+
+            // StateCommands recorded directly replace what vsg::State last recorded for that slot
+            _state->_commandBuffer->resetRecordedStateCommand(static_cast<const StateCommand&>(*command).slot);
+            break;
+        }
+        case FlattenedSubgraph::NODE:
+            dispatch(*stream.nodes[entry.index]);
+            break;
+        }
+        ++i;
     }
 }
 
@@ -305,6 +833,12 @@ void RecordTraversal::apply(const VertexDraw& vd)
 {
     GPU_INSTRUMENTATION_L3_NCO(instrumentation, *getCommandBuffer(), "VertexDraw", COLOR_GPU, &vd);
 
+    if (_drawList)
+    {
+        _drawList->add(_state, 0.0, &vd);
+        return;
+    }
+
     //debug("Visiting VertexDraw");
     _state->record();
     vd.record(*(_state->_commandBuffer));
@@ -314,6 +848,12 @@ void RecordTraversal::apply(const VertexIndexDraw& vid)
 {
     GPU_INSTRUMENTATION_L3_NCO(instrumentation, *getCommandBuffer(), "VertexIndexDraw", COLOR_GPU, &vid);
 
+    if (_drawList)
+    {
+        _drawList->add(_state, 0.0, &vid);
+        return;
+    }
+
     //debug("Visiting VertexIndexDraw");
     _state->record();
     vid.record(*(_state->_commandBuffer));
@@ -323,6 +863,12 @@ void RecordTraversal::apply(const Geometry& geometry)
 {
     GPU_INSTRUMENTATION_L3_NCO(instrumentation, *getCommandBuffer(), "Geometry", COLOR_GPU, &geometry);
 
+    if (_drawList)
+    {
+        _drawList->add(_state, 0.0, &geometry);
+        return;
+    }
+
     //debug("Visiting Geometry");
     _state->record();
     geometry.record(*(_state->_commandBuffer));
@@ -340,6 +886,14 @@ void RecordTraversal::apply(const AmbientLight& light)
     CPU_INSTRUMENTATION_L2_O(instrumentation, &light);
 
     //debug("RecordTraversal::apply(AmbientLight) ", light.className());
+    if (_drawList)
+    {
+        // ViewDependentState isn't thread safe so leave the light to be added when the draw list is recorded
+        _drawList->add(_state, 0.0, &light);
+        _drawListDeferred = true;
+        return;
+    }
+
     if (_viewDependentState) _viewDependentState->ambientLights.emplace_back(_state->modelviewMatrixStack.top(), &light);
 }
 
@@ -348,6 +902,14 @@ void RecordTraversal::apply(const DirectionalLight& light)
     CPU_INSTRUMENTATION_L2_O(instrumentation, &light);
 
     //debug("RecordTraversal::apply(DirectionalLight) ", light.className());
+    if (_drawList)
+    {
+        // ViewDependentState isn't thread safe so leave the light to be added when the draw list is recorded
+        _drawList->add(_state, 0.0, &light);
+        _drawListDeferred = true;
+        return;
+    }
+
     if (_viewDependentState) _viewDependentState->directionalLights.emplace_back(_state->modelviewMatrixStack.top(), &light);
 }
 
@@ -356,6 +918,16 @@ void RecordTraversal::apply(const PointLight& light)
     CPU_INSTRUMENTATION_L2_O(instrumentation, &light);
 
     //debug("RecordTraversal::apply(PointLight) ", light.className());
+    if (_viewDependentState && _viewDependentState->cullLights && !_state->intersect(_viewDependentState->lightBound(light))) return;
+
+    if (_drawList)
+    {
+        // ViewDependentState isn't thread safe so leave the light to be added when the draw list is recorded
+        _drawList->add(_state, 0.0, &light);
+        _drawListDeferred = true;
+        return;
+    }
+
     if (_viewDependentState) _viewDependentState->pointLights.emplace_back(_state->modelviewMatrixStack.top(), &light);
 }
 
@@ -364,6 +936,16 @@ void RecordTraversal::apply(const SpotLight& light)
     CPU_INSTRUMENTATION_L2_O(instrumentation, &light);
 
     //debug("RecordTraversal::apply(SpotLight) ", light.className());
+    if (_viewDependentState && _viewDependentState->cullLights && !_state->intersect(_viewDependentState->lightBound(light))) return;
+
+    if (_drawList)
+    {
+        // ViewDependentState isn't thread safe so leave the light to be added when the draw list is recorded
+        _drawList->add(_state, 0.0, &light);
+        _drawListDeferred = true;
+        return;
+    }
+
     if (_viewDependentState) _viewDependentState->spotLights.emplace_back(_state->modelviewMatrixStack.top(), &light);
 }
 
@@ -373,13 +955,36 @@ void RecordTraversal::apply(const StateGroup& stateGroup)
 
     //debug("Visiting StateGroup");
 
-    for (auto& command : stateGroup.stateCommands)
+    if (_depthPrePass)
     {
-        _state->stateStacks[command->slot].push(command);
+        // skip subgraphs with opaque pipelines left out of the depth only pass, or variants still being compiled
+        for (auto& command : stateGroup.stateCommands)
+        {
+            auto variant = _substituteStateCommand(command);
+            if (!variant || variant->pending()) return;
+        }
+
+        for (auto& command : stateGroup.stateCommands)
+        {
+            _state->stateStacks[command->slot].push(_substituteStateCommand(command));
+        }
+    }
+    else
+    {
+        // skip subgraphs with state that can't be recorded yet, such as pipelines still being compiled in the background
+        for (auto& command : stateGroup.stateCommands)
+        {
+            if (command->pending()) return;
+        }
+
+        for (auto& command : stateGroup.stateCommands)
+        {
+            _state->stateStacks[command->slot].push(command);
+        }
     }
     _state->dirty = true;
 
-    stateGroup.traverse(*this);
+    traverseChildren(*this, stateGroup);
 
     for (auto& command : stateGroup.stateCommands)
     {
@@ -397,7 +1002,10 @@ void RecordTraversal::apply(const Transform& transform)
 
     if (transform.subgraphRequiresLocalFrustum)
     {
-        _state->pushFrustum();
+        if (_insideFrustum > 0)
+            _state->pushFrustumInside();
+        else
+            _state->pushFrustum();
         transform.traverse(*this);
         _state->popFrustum();
     }
@@ -414,21 +1022,77 @@ void RecordTraversal::apply(const MatrixTransform& mt)
 {
     GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "MatrixTransform", COLOR_RECORD_L2, &mt);
 
+    // the cached bound is in the parent's coordinate frame so can be tested before the frustum is transformed into the local coordinate frame
+    bool entirelyInside = _insideFrustum > 0;
+    if (mt.bound.valid() && !entirelyInside)
+    {
+        const auto& frustum = _state->_frustumStack.top();
+        if (!frustum.intersect(mt.bound)) return;
+        entirelyInside = frustum.insideMargin(mt.bound) > 0.0;
+    }
+
     _state->modelviewMatrixStack.push(mt);
     _state->dirty = true;
 
     if (mt.subgraphRequiresLocalFrustum)
+    {
+        if (entirelyInside)
+        {
+            _state->pushFrustumInside();
+            ++_insideFrustum;
+            traverseChildren(*this, mt);
+            --_insideFrustum;
+        }
+        else
+        {
+            _state->pushFrustum();
+            traverseChildren(*this, mt);
+        }
+        _state->popFrustum();
+    }
+    else
+    {
+        traverseChildren(*this, mt);
+    }
+
+    _state->modelviewMatrixStack.pop();
+    _state->dirty = true;
+}
+
+void RecordTraversal::apply(const InstanceNode& instance)
+{
+    GPU_INSTRUMENTATION_L2_NCO(instrumentation, *getCommandBuffer(), "InstanceNode", COLOR_RECORD_L2, &instance);
+
+    for (auto& command : instance.stateCommands)
+    {
+        if (command->pending()) return;
+    }
+
+    for (auto& command : instance.stateCommands)
+    {
+        _state->stateStacks[command->slot].push(command);
+    }
+
+    _state->modelviewMatrixStack.push(instance);
+    _state->dirty = true;
+
+    if (instance.subgraphRequiresLocalFrustum)
     {
         _state->pushFrustum();
-        mt.traverse(*this);
+        instance.traverse(*this);
         _state->popFrustum();
     }
     else
     {
-        mt.traverse(*this);
+        instance.traverse(*this);
     }
 
     _state->modelviewMatrixStack.pop();
+
+    for (auto& command : instance.stateCommands)
+    {
+        _state->stateStacks[command->slot].pop();
+    }
     _state->dirty = true;
 }
 
@@ -437,10 +1101,20 @@ void RecordTraversal::apply(const Commands& commands)
 {
     GPU_INSTRUMENTATION_L3_NCO(instrumentation, *getCommandBuffer(), "Commands", COLOR_GPU, &commands);
 
+    if (_drawList)
+    {
+        _drawList->add(_state, 0.0, &commands);
+        return;
+    }
+
     _state->record();
+    auto& commandBuffer = *(_state->_commandBuffer);
     for (auto& command : commands.children)
     {
-        command->record(*(_state->_commandBuffer));
+        command->record(commandBuffer);
+
+        // StateCommands recorded directly replace what vsg::State last recorded for that slot
+        if (auto stateCommand = command->cast<StateCommand>()) commandBuffer.resetRecordedStateCommand(stateCommand->slot);
     }
 }
 
@@ -448,9 +1122,18 @@ void RecordTraversal::apply(const Command& command)
 {
     GPU_INSTRUMENTATION_L3_NCO(instrumentation, *getCommandBuffer(), "Command", COLOR_GPU, &command);
 
+    if (_drawList)
+    {
+        _drawList->add(_state, 0.0, &command);
+        return;
+    }
+
     //debug("Visiting Command");
     _state->record();
     command.record(*(_state->_commandBuffer));
+
+    // StateCommands recorded directly replace what vsg::State last recorded for that slot
+    if (auto stateCommand = command.cast<StateCommand>()) _state->_commandBuffer->resetRecordedStateCommand(stateCommand->slot);
 }
 
 void RecordTraversal::apply(const Bin& bin)
@@ -465,17 +1148,45 @@ void RecordTraversal::apply(const View& view)
 {
     GPU_INSTRUMENTATION_L1_NCO(instrumentation, *getCommandBuffer(), "View", COLOR_RECORD_L1, &view);
 
+    if (_drawList)
+    {
+        // nested Views set up their own bins and matrices so leave them to be traversed when the draw list is recorded
+        _drawList->add(_state, 0.0, &view);
+        _drawListDeferred = true;
+        return;
+    }
+
     // note, View::accept() updates the RecordTraversal's traversalMask
     auto cached_traversalMask = _state->_commandBuffer->traversalMask;
     _state->_commandBuffer->traversalMask = traversalMask;
+    if (_state->_commandBuffer->viewID != view.viewID)
+    {
+        // view dependent StateCommands record different state for each View
+        _state->_commandBuffer->resetRecordedState();
+    }
     _state->_commandBuffer->viewID = view.viewID;
     _state->_commandBuffer->viewDependentState = view.viewDependentState.get();
 
     // cache the previous bins
     int32_t cached_minimumBinNumber = _minimumBinNumber;
-    decltype(_bins) cached_bins;
-    cached_bins.swap(_bins);
+    size_t binsIndex = _viewDepth++;
+    if (_binsStack.size() <= binsIndex) _binsStack.resize(binsIndex + 1);
+    _binsStack[binsIndex].swap(_bins);
+    _bins.clear();
     auto cached_viewDependentState = _viewDependentState;
+    auto cached_occlusionCulling = _occlusionCulling;
+    auto cached_visibilityCache = _visibilityCache;
+    auto cached_insideFrustum = _insideFrustum;
+    auto cached_inheritedFrustumDepth = _inheritedFrustumDepth;
+    auto cached_minimumScreenHeightRatio = _minimumScreenHeightRatio;
+    auto cached_pixelsToScreenHeightRatio = _pixelsToScreenHeightRatio;
+    auto cached_lodBias = _lodBias;
+    auto cached_requestLodBias = _requestLodBias;
+
+    // nested Views within a depth pre-pass bin record their subgraphs as normal
+    auto cached_depthPrePass = _depthPrePass;
+    auto cached_depthOnlyPass = _depthOnlyPass;
+    _depthPrePass = nullptr;
 
     // assign and clear the View's bins
     int32_t min_binNumber = 0;
@@ -506,6 +1217,28 @@ void RecordTraversal::apply(const View& view)
         _state->inheritViewForLODScaling = (view.features & INHERIT_VIEWPOINT) != 0;
         _state->setProjectionAndViewMatrix(view.camera->projectionMatrix->transform(), view.camera->viewMatrix->transform());
 
+        // the ratio of radius to LOD distance is sqrt(2) times the ratio of the projected radius to the viewport height
+        const auto& viewportState = view.camera->viewportState;
+        double viewportHeight = (viewportState && !viewportState->viewports.empty()) ? viewportState->viewports.front().height : 0.0;
+        _pixelsToScreenHeightRatio = viewportHeight > 0.0 ? 1.0 / (std::sqrt(2.0) * viewportHeight) : 0.0;
+        _minimumScreenHeightRatio = view.minimumFeatureSize * _pixelsToScreenHeightRatio;
+        _lodBias = view.lodBias;
+        _requestLodBias = view.requestLodBias;
+
+        _occlusionCulling = view.occlusionCulling;
+        if (_occlusionCulling)
+        {
+            _occlusionCulling->beginFrame(_state->projectionMatrixStack.top(), _state->modelviewMatrixStack.top(), _frameStamp ? _frameStamp->frameCount : 0);
+        }
+
+        _insideFrustum = 0;
+        _inheritedFrustumDepth = 0;
+        _visibilityCache = view.visibilityCache;
+        if (_visibilityCache)
+        {
+            _visibilityCache->beginFrame(_state->projectionMatrixStack.top(), _state->modelviewMatrixStack.top(), _frameStamp ? _frameStamp->frameCount : 0);
+        }
+
         if (_viewDependentState && _viewDependentState->viewportData && view.camera->viewportState)
         {
             auto& viewportData = _viewDependentState->viewportData;
@@ -526,17 +1259,29 @@ void RecordTraversal::apply(const View& view)
             }
         }
 
-        view.traverse(*this);
+        if (view.sharedCull)
+            _recordSharedCull(view);
+        else
+            view.traverse(*this);
+
+        if (_occlusionCulling && instrumentation)
+        {
+            instrumentation->plot("OcclusionCulling tested", _occlusionCulling->numTested());
+            instrumentation->plot("OcclusionCulling culled", _occlusionCulling->numCulled());
+        }
+
+        if (_visibilityCache && instrumentation)
+        {
+            instrumentation->plot("VisibilityCache hits", _visibilityCache->numHits());
+            instrumentation->plot("VisibilityCache inserted", _visibilityCache->numInserted());
+        }
     }
     else
     {
         view.traverse(*this);
     }
 
-    for (auto& bin : view.bins)
-    {
-        bin->accept(*this);
-    }
+    _recordBins(view);
 
     if (_viewDependentState)
     {
@@ -545,15 +1290,47 @@ void RecordTraversal::apply(const View& view)
 
     // swap back previous bin setup.
     _minimumBinNumber = cached_minimumBinNumber;
-    cached_bins.swap(_bins);
+    _binsStack[binsIndex].swap(_bins);
+    _binsStack[binsIndex].clear();
+    --_viewDepth;
+
+#ifndef NDEBUG
+    if (_viewDepth == 0)
+    {
+        auto reservedSize = _reservedSize();
+        if (reservedSize > _previousReservedSize)
+        {
+            if (_previousReservedSize > 0) ++numTransientGrowths;
+            debug("RecordTraversal reserved storage grew from ", _previousReservedSize, " to ", reservedSize, " bytes");
+            _previousReservedSize = reservedSize;
+        }
+    }
+#endif
     _state->_commandBuffer->traversalMask = cached_traversalMask;
     _viewDependentState = cached_viewDependentState;
+    _occlusionCulling = cached_occlusionCulling;
+    _visibilityCache = cached_visibilityCache;
+    _insideFrustum = cached_insideFrustum;
+    _inheritedFrustumDepth = cached_inheritedFrustumDepth;
+    _minimumScreenHeightRatio = cached_minimumScreenHeightRatio;
+    _pixelsToScreenHeightRatio = cached_pixelsToScreenHeightRatio;
+    _lodBias = cached_lodBias;
+    _requestLodBias = cached_requestLodBias;
+    _depthPrePass = cached_depthPrePass;
+    _depthOnlyPass = cached_depthOnlyPass;
 }
 
 void RecordTraversal::apply(const CommandGraph& commandGraph)
 {
     GPU_INSTRUMENTATION_L1_NCO(instrumentation, *getCommandBuffer(), "RecordTraversal CommandGraph", COLOR_RECORD_L1, &commandGraph);
 
+    if (_drawList)
+    {
+        _drawList->add(_state, 0.0, &commandGraph);
+        _drawListDeferred = true;
+        return;
+    }
+
     if (recordedCommandBuffers)
     {
         auto cg = const_cast<CommandGraph*>(&commandGraph);
@@ -561,7 +1338,7 @@ void RecordTraversal::apply(const CommandGraph& commandGraph)
         {
             if (_viewDependentState && _viewDependentState->view && _viewDependentState->view->camera)
             {
-                auto camera = _viewDependentState->view->camera;
+                const auto& camera = _viewDependentState->view->camera;
                 cg->getOrCreateRecordTraversal()->_state->setInhertiedViewProjectionAndViewMatrix(camera->projectionMatrix->transform(), camera->viewMatrix->transform());
             }
 
@@ -577,3 +1354,496 @@ void RecordTraversal::apply(const CommandGraph& commandGraph)
         commandGraph.traverse(*this);
     }
 }
+
+void RecordTraversal::_initializeCull(const RecordTraversal& parent)
+{
+    _frameStamp = parent._frameStamp;
+    _databasePager = parent._databasePager;
+    _suppressPagedLODRequests = parent._suppressPagedLODRequests;
+    traversalMask = parent.traversalMask;
+    overrideMask = parent.overrideMask;
+
+    if (parent._culledPagedLODs)
+    {
+        if (_culledPagedLODs)
+            _culledPagedLODs->clear();
+        else
+            _culledPagedLODs = CulledPagedLODs::create();
+    }
+    else
+    {
+        _culledPagedLODs = {};
+    }
+
+    if (_drawList)
+        _drawList->clear();
+    else
+        _drawList = Bin::create(0, Bin::NO_SORT);
+    _drawListDeferred = false;
+    _drawListCommandBuffer = {};
+
+    // only the matrices and frustum are required for culling, the draw list captures state pushed within the subgraph
+    // so the state inherited from the parent is still in place when the draw list is recorded.
+    auto& parentState = *parent._state;
+    _occlusionCulling = parent._occlusionCulling;
+    _visibilityCache = parent._visibilityCache;
+    _insideFrustum = parent._insideFrustum;
+    _inheritedFrustumDepth = parent._inheritedFrustumDepth + parent._state->_frustumStack.size() - 1;
+    _minimumScreenHeightRatio = parent._minimumScreenHeightRatio;
+    _pixelsToScreenHeightRatio = parent._pixelsToScreenHeightRatio;
+    _lodBias = parent._lodBias;
+    _requestLodBias = parent._requestLodBias;
+    _state->_commandBuffer = parentState._commandBuffer;
+    _state->_frustumUnit = parentState._frustumUnit;
+    _state->_frustumProjected = parentState._frustumProjected;
+    while (!_state->_frustumStack.empty()) _state->_frustumStack.pop();
+    _state->_frustumStack.push(parentState._frustumStack.top());
+    _state->inheritViewForLODScaling = parentState.inheritViewForLODScaling;
+    _state->inheritedProjectionMatrix = parentState.inheritedProjectionMatrix;
+    _state->inheritedViewMatrix = parentState.inheritedViewMatrix;
+    _state->inheritedViewTransform = parentState.inheritedViewTransform;
+    _state->projectionMatrixStack.set(parentState.projectionMatrixStack.top());
+    _state->modelviewMatrixStack.relativeToEyeFloat = parentState.modelviewMatrixStack.relativeToEyeFloat;
+    _state->modelviewMatrixStack.relativeToEyeFloatLimit = parentState.modelviewMatrixStack.relativeToEyeFloatLimit;
+    _state->modelviewMatrixStack.set(parentState.modelviewMatrixStack.top());
+    if (_state->stateStacks.size() < parentState.stateStacks.size()) _state->stateStacks.resize(parentState.stateStacks.size());
+}
+
+struct RecordTraversal::SecondaryRecording
+{
+    VkCommandBufferInheritanceInfo inheritanceInfo = {};
+    CommandBuffers commandBuffers;
+};
+
+void RecordTraversal::_recordBins(const View& view)
+{
+    auto depthPrePass = view.depthPrePass.get();
+    if (depthPrePass && !depthPrePass->binNumbers.empty())
+    {
+        _depthPrePass = depthPrePass;
+        _depthOnlyPass = true;
+        for (auto& bin : view.bins)
+        {
+            if (depthPrePass->binNumbers.count(bin->binNumber) > 0) bin->accept(*this);
+        }
+
+        _depthOnlyPass = false;
+        for (auto& bin : view.bins)
+        {
+            _depthPrePass = (depthPrePass->binNumbers.count(bin->binNumber) > 0) ? depthPrePass : nullptr;
+            bin->accept(*this);
+        }
+    }
+    else
+    {
+        for (auto& bin : view.bins)
+        {
+            bin->accept(*this);
+        }
+    }
+
+    _depthPrePass = nullptr;
+}
+
+const StateCommand* RecordTraversal::_substituteStateCommand(const StateCommand* command) const
+{
+    return _depthPrePass->variant(command, _depthOnlyPass);
+}
+
+size_t RecordTraversal::_reservedSize() const
+{
+    size_t size = _cullBoundaries.capacity() * sizeof(size_t);
+    size += (_cullOperations.capacity() + _recordOperations.capacity()) * sizeof(ref_ptr<Operation>);
+    for (auto& bins : _binsStack) size += bins.capacity() * sizeof(ref_ptr<Bin>);
+
+    if (_culledPagedLODs) size += (_culledPagedLODs->highresCulled.capacity() + _culledPagedLODs->newHighresRequired.capacity()) * sizeof(const PagedLOD*);
+
+    if (_drawList) size += _drawList->reservedSize();
+    size += (_drawListCullTimes.capacity() * sizeof(double)) + (_drawListEntries.capacity() * sizeof(size_t));
+
+    for (auto& rt : _cullTraversals) size += rt->_reservedSize();
+
+    return size;
+}
+
+void RecordTraversal::_partition(const ref_ptr<Node>* children, size_t numChildren, size_t numTasks, std::vector<size_t>& boundaries)
+{
+    boundaries.resize(numTasks + 1);
+    for (size_t i = 0; i <= numTasks; ++i) boundaries[i] = (numChildren * i) / numTasks;
+
+    auto itr = _childCosts.find(children);
+    if (itr == _childCosts.end() || itr->second.costs.size() != numChildren) return;
+
+    auto& costs = itr->second.costs;
+    double totalCost = 0.0;
+    for (auto cost : costs) totalCost += cost;
+    if (totalCost <= 0.0) return;
+
+    // place each boundary where the accumulated cost passes its share of the total, leaving at least one child per range
+    double accumulatedCost = 0.0;
+    size_t child = 0;
+    for (size_t i = 1; i < numTasks; ++i)
+    {
+        double targetCost = (totalCost * static_cast<double>(i)) / static_cast<double>(numTasks);
+        while (child < numChildren && accumulatedCost + costs[child] * 0.5 < targetCost)
+        {
+            accumulatedCost += costs[child++];
+        }
+        boundaries[i] = std::min(std::max(child, boundaries[i - 1] + 1), numChildren - (numTasks - i));
+        while (child < boundaries[i]) accumulatedCost += costs[child++];
+    }
+}
+
+void RecordTraversal::_updateChildCosts(const ref_ptr<Node>* children, size_t numChildren, const std::vector<size_t>& boundaries)
+{
+    uint64_t frameCount = _frameStamp ? _frameStamp->frameCount : 0;
+
+    // discard the costs of Groups that are no longer being traversed
+    if (_childCosts.size() > 64)
+    {
+        for (auto itr = _childCosts.begin(); itr != _childCosts.end();)
+        {
+            if (itr->second.frameCount + 60 < frameCount)
+                itr = _childCosts.erase(itr);
+            else
+                ++itr;
+        }
+    }
+
+    auto& childCosts = _childCosts[children];
+    bool initialize = childCosts.costs.size() != numChildren;
+    if (initialize) childCosts.costs.assign(numChildren, 0.0);
+    childCosts.frameCount = frameCount;
+
+    const double smoothing = 0.2;
+    for (size_t i = 0; i + 1 < boundaries.size(); ++i)
+    {
+        auto& rt = _cullTraversals[i];
+
+        // share the time taken to record the draw list between the children in proportion to the entries they added
+        size_t numEntries = 0;
+        for (auto entries : rt->_drawListEntries) numEntries += entries;
+        double recordTimePerEntry = numEntries > 0 ? rt->_drawListRecordTime / static_cast<double>(numEntries) : 0.0;
+
+        for (size_t c = boundaries[i]; c < boundaries[i + 1]; ++c)
+        {
+            size_t local = c - boundaries[i];
+            double cost = rt->_drawListCullTimes[local] + recordTimePerEntry * static_cast<double>(rt->_drawListEntries[local]);
+            auto& childCost = childCosts.costs[c];
+            childCost = initialize ? cost : (childCost + (cost - childCost) * smoothing);
+        }
+    }
+}
+
+void RecordTraversal::_recordSharedCull(const View& view)
+{
+    auto& sharedCull = *view.sharedCull;
+    auto frameCount = _frameStamp ? _frameStamp->frameCount : 0;
+
+    {
+        std::scoped_lock<std::mutex> lock(sharedCull.mutex);
+        if (sharedCull.requiresCull(frameCount))
+        {
+            CPU_INSTRUMENTATION_L2_NC(instrumentation, "RecordTraversal shared cull", COLOR_RECORD_L2);
+
+            const auto& cullCamera = sharedCull.camera ? sharedCull.camera : view.camera;
+            auto cullViewMatrix = cullCamera->viewMatrix->transform();
+            _state->setProjectionAndViewMatrix(cullCamera->projectionMatrix->transform(), cullViewMatrix);
+
+            // occlusion culling and the visibility cache are specific to this View's camera so can't be used for the shared cull
+            auto cached_occlusionCulling = _occlusionCulling;
+            auto cached_visibilityCache = _visibilityCache;
+            _occlusionCulling = {};
+            _visibilityCache = {};
+
+            sharedCull.clear();
+            _drawList = view.sharedCull;
+            view.traverse(*this);
+            _drawList = {};
+            _drawListDeferred = false;
+
+            sharedCull.culled(frameCount, cullViewMatrix);
+
+            _occlusionCulling = cached_occlusionCulling;
+            _visibilityCache = cached_visibilityCache;
+            _state->setProjectionAndViewMatrix(view.camera->projectionMatrix->transform(), view.camera->viewMatrix->transform());
+        }
+    }
+
+    sharedCull.record(*this, view.camera->viewMatrix->transform());
+
+    if (instrumentation) instrumentation->plot("SharedCull candidates", static_cast<double>(sharedCull.numCandidates()));
+}
+
+bool RecordTraversal::_parallelCull(const ref_ptr<Node>* children, size_t numChildren)
+{
+    size_t numTasks = (maximumNumCullTasks > 0) ? maximumNumCullTasks : std::thread::hardware_concurrency();
+    if (numTasks > numChildren) numTasks = numChildren;
+    if (numTasks < 2) return false;
+
+    CPU_INSTRUMENTATION_L2_NC(instrumentation, "RecordTraversal parallel cull", COLOR_RECORD_L2);
+
+    while (_cullTraversals.size() < numTasks)
+    {
+        _cullTraversals.push_back(RecordTraversal::create(static_cast<uint32_t>(_state->stateStacks.size() - 1)));
+    }
+
+    struct CullOperation : public Operation
+    {
+        void run() override
+        {
+            rt->_drawListCullTimes.clear();
+            rt->_drawListEntries.clear();
+            rt->cullStatistics = {};
+            for (auto itr = begin; itr != end; ++itr)
+            {
+                auto startTime = vsg::clock::now();
+                size_t startSize = rt->_drawList->size();
+
+                if (*itr) rt->dispatch(**itr);
+
+                rt->_drawListCullTimes.push_back(std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count());
+                rt->_drawListEntries.push_back(rt->_drawList->size() - startSize);
+            }
+            latch->count_down();
+        }
+
+        RecordTraversal* rt = nullptr;
+        const ref_ptr<Node>* begin = nullptr;
+        const ref_ptr<Node>* end = nullptr;
+        Latch* latch = nullptr;
+    };
+
+    // divide the children into contiguous ranges so that recording the draw lists in order matches a serial traversal,
+    // using the costs of previous frames to balance the ranges
+    auto& boundaries = _cullBoundaries;
+    _partition(children, numChildren, numTasks, boundaries);
+
+    while (_cullOperations.size() < numTasks) _cullOperations.push_back(ref_ptr<Operation>(new CullOperation));
+    if (!_cullLatch) _cullLatch = Latch::create(0);
+    _cullLatch->set(static_cast<int>(numTasks));
+
+    for (size_t i = 0; i < numTasks; ++i)
+    {
+        auto& rt = _cullTraversals[i];
+        rt->_initializeCull(*this);
+        rt->_drawListRecordTime = 0.0;
+
+        auto& cullOperation = static_cast<CullOperation&>(*_cullOperations[i]);
+        cullOperation.rt = rt.get();
+        cullOperation.begin = children + boundaries[i];
+        cullOperation.end = children + boundaries[i + 1];
+        cullOperation.latch = _cullLatch.get();
+        cullThreads->add(_cullOperations[i]);
+    }
+
+    cullThreads->run();
+    _cullLatch->wait();
+
+    for (size_t i = 0; i < numTasks; ++i) cullStatistics += _cullTraversals[i]->cullStatistics;
+
+    if (_secondaryRecording)
+    {
+        // record the draw lists that don't depend on this RecordTraversal into their own secondary CommandBuffers in parallel
+        struct RecordOperation : public Operation
+        {
+            void run() override
+            {
+                rt->_recordDrawList(*secondaryRecording, *inherit, *parentState);
+                latch->count_down();
+            }
+
+            RecordTraversal* rt = nullptr;
+            const SecondaryRecording* secondaryRecording = nullptr;
+            CommandBuffer* inherit = nullptr;
+            const State* parentState = nullptr;
+            Latch* latch = nullptr;
+        };
+
+        int numParallelRecords = 0;
+        for (size_t i = 0; i < numTasks; ++i)
+        {
+            if (!_cullTraversals[i]->_drawListDeferred) ++numParallelRecords;
+        }
+
+        while (_recordOperations.size() < numTasks) _recordOperations.push_back(ref_ptr<Operation>(new RecordOperation));
+        if (!_recordLatch) _recordLatch = Latch::create(0);
+        _recordLatch->set(numParallelRecords);
+
+        for (size_t i = 0; i < numTasks; ++i)
+        {
+            auto& rt = _cullTraversals[i];
+            if (rt->_drawListDeferred) continue;
+
+            auto& recordOperation = static_cast<RecordOperation&>(*_recordOperations[i]);
+            recordOperation.rt = rt.get();
+            recordOperation.secondaryRecording = _secondaryRecording;
+            recordOperation.inherit = _state->_commandBuffer.get();
+            recordOperation.parentState = _state;
+            recordOperation.latch = _recordLatch.get();
+            cullThreads->add(_recordOperations[i]);
+        }
+
+        cullThreads->run();
+        _recordLatch->wait();
+    }
+
+    // when recording secondary CommandBuffers, the current one is ended before the first draw list recorded in parallel and the next begun once one is needed
+    bool recordingSecondary = _secondaryRecording != nullptr;
+    for (size_t i = 0; i < numTasks; ++i)
+    {
+        auto& rt = _cullTraversals[i];
+        if (rt->_drawListCommandBuffer)
+        {
+            if (recordingSecondary)
+            {
+                vkEndCommandBuffer(*_state->_commandBuffer);
+                recordingSecondary = false;
+            }
+
+            _secondaryRecording->commandBuffers.push_back(rt->_drawListCommandBuffer);
+            rt->_drawListCommandBuffer = {};
+        }
+        else
+        {
+            if (_secondaryRecording && !recordingSecondary)
+            {
+                _nextSecondaryCommandBuffer();
+                recordingSecondary = true;
+            }
+
+            auto startTime = vsg::clock::now();
+            rt->_drawList->traverse(*this);
+            rt->_drawListRecordTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+        }
+
+        if (_culledPagedLODs && rt->_culledPagedLODs)
+        {
+            auto& highresCulled = rt->_culledPagedLODs->highresCulled;
+            auto& newHighresRequired = rt->_culledPagedLODs->newHighresRequired;
+            _culledPagedLODs->highresCulled.insert(_culledPagedLODs->highresCulled.end(), highresCulled.begin(), highresCulled.end());
+            _culledPagedLODs->newHighresRequired.insert(_culledPagedLODs->newHighresRequired.end(), newHighresRequired.begin(), newHighresRequired.end());
+        }
+    }
+
+    if (_secondaryRecording && !recordingSecondary) _nextSecondaryCommandBuffer();
+
+    _updateChildCosts(children, numChildren, boundaries);
+
+    return true;
+}
+
+ref_ptr<CommandBuffer> RecordTraversal::_beginSecondaryCommandBuffer(const SecondaryRecording& secondaryRecording, CommandBuffer& inherit)
+{
+    auto device = inherit.getDevice();
+    auto queueFamilyIndex = inherit.getCommandPool()->queueFamilyIndex;
+    if (!_secondaryCommandPoolRing || _secondaryCommandPoolRing->device != device || _secondaryCommandPoolRing->queueFamilyIndex != queueFamilyIndex)
+    {
+        _secondaryCommandPoolRing = CommandPoolRing::create(device, queueFamilyIndex);
+    }
+
+    // advance the ring once per frame, CommandBuffers with pending submissions are never reset by advance()
+    uint64_t frameCount = _frameStamp ? (_frameStamp->frameCount + 1) : 0;
+    if (frameCount != _secondaryFrameCount || frameCount == 0)
+    {
+        _secondaryCommandPoolRing->advance();
+        _secondaryFrameCount = frameCount;
+    }
+
+    auto commandBuffer = _secondaryCommandPoolRing->allocate(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    commandBuffer->numDependentSubmissions().fetch_add(1);
+    commandBuffer->viewID = inherit.viewID;
+    commandBuffer->traversalMask = inherit.traversalMask;
+    commandBuffer->overrideMask = inherit.overrideMask;
+    commandBuffer->viewDependentState = inherit.viewDependentState;
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &secondaryRecording.inheritanceInfo;
+
+    vkBeginCommandBuffer(*commandBuffer, &beginInfo);
+
+    return commandBuffer;
+}
+
+void RecordTraversal::_assignCommandBuffer(ref_ptr<CommandBuffer> commandBuffer)
+{
+    _state->_commandBuffer = commandBuffer;
+    _state->_commandBuffer->resetRecordedState();
+
+    // a new CommandBuffer starts with no state bound so all the current state needs recording again
+    for (auto& stateStack : _state->stateStacks)
+    {
+        stateStack.dirty = stateStack.size() > 0;
+    }
+    _state->projectionMatrixStack.dirty = true;
+    _state->modelviewMatrixStack.dirty = true;
+    _state->dirty = true;
+}
+
+void RecordTraversal::_nextSecondaryCommandBuffer()
+{
+    auto commandBuffer = _beginSecondaryCommandBuffer(*_secondaryRecording, *_state->_commandBuffer);
+    _secondaryRecording->commandBuffers.push_back(commandBuffer);
+    _assignCommandBuffer(commandBuffer);
+}
+
+void RecordTraversal::_recordDrawList(const SecondaryRecording& secondaryRecording, CommandBuffer& inherit, const State& parentState)
+{
+    auto startTime = vsg::clock::now();
+
+    _state->stateStacks = parentState.stateStacks;
+    _assignCommandBuffer(_beginSecondaryCommandBuffer(secondaryRecording, inherit));
+
+    // record the draw list rather than adding to it
+    auto drawList = _drawList;
+    _drawList = {};
+    drawList->traverse(*this);
+    _drawList = drawList;
+
+    vkEndCommandBuffer(*_state->_commandBuffer);
+    _drawListCommandBuffer = _state->_commandBuffer;
+
+    _drawListRecordTime = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - startTime).count();
+}
+
+void RecordTraversal::recordSecondaryCommandBuffers(const RenderGraph& renderGraph, VkRenderPass renderPass, VkFramebuffer framebuffer)
+{
+    CPU_INSTRUMENTATION_L1_NC(instrumentation, "RecordTraversal recordSecondaryCommandBuffers", COLOR_RECORD_L1);
+
+    auto primaryCommandBuffer = _state->_commandBuffer;
+
+    SecondaryRecording secondaryRecording;
+    secondaryRecording.inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    secondaryRecording.inheritanceInfo.renderPass = renderPass;
+    secondaryRecording.inheritanceInfo.subpass = 0;
+    secondaryRecording.inheritanceInfo.framebuffer = framebuffer;
+
+    auto previousSecondaryRecording = _secondaryRecording;
+    _secondaryRecording = &secondaryRecording;
+
+    _nextSecondaryCommandBuffer();
+
+    renderGraph.traverse(*this);
+
+    vkEndCommandBuffer(*_state->_commandBuffer);
+
+    _secondaryRecording = previousSecondaryRecording;
+    _assignCommandBuffer(primaryCommandBuffer);
+
+    std::vector<VkCommandBuffer> vk_commandBuffers;
+    vk_commandBuffers.reserve(secondaryRecording.commandBuffers.size());
+    for (auto& commandBuffer : secondaryRecording.commandBuffers)
+    {
+        vk_commandBuffers.push_back(*commandBuffer);
+
+        // the Fence associated with the submission releases the CommandBuffers once they've been executed
+        if (recordedCommandBuffers) recordedCommandBuffers->add(0, commandBuffer);
+    }
+
+    vkCmdExecuteCommands(*primaryCommandBuffer, static_cast<uint32_t>(vk_commandBuffers.size()), vk_commandBuffers.data());
+
+    // state bound by the secondary CommandBuffers is undefined once they've been executed
+    primaryCommandBuffer->resetRecordedState();
+}
@@ -10,6 +10,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/app/FrameStatistics.h>
 #include <vsg/app/RenderGraph.h>
 #include <vsg/app/View.h>
 #include <vsg/io/Logger.h>
@@ -17,6 +18,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/nodes/Bin.h>
 #include <vsg/nodes/Light.h>
 #include <vsg/state/MultisampleState.h>
+#include <vsg/ui/FrameStamp.h>
 #include <vsg/vk/Context.h>
 #include <vsg/vk/State.h>
 
@@ -51,6 +53,9 @@ RenderGraph::RenderGraph(ref_ptr<Window> in_window, ref_ptr<View> in_view) :
 
     // set up the clearValues based on the RenderPass's attachments.
     setClearValues(window->clearColor(), VkClearDepthStencilValue{0.0f, 0});
+
+    // the Window's device has been set up by setClearValues() so WindowTraits::dynamicRendering reflects whether it's been enabled
+    dynamicRendering = window->traits()->dynamicRendering;
 }
 
 RenderPass* RenderGraph::getRenderPass()
@@ -115,6 +120,47 @@ void RenderGraph::accept(RecordTraversal& recordTraversal) const
         this_renderGraph->resized();
     }
 
+    // write timestamps and pipeline statistics queries either side of the render pass, whichever of the paths below records it
+    struct ScopedGpuTiming
+    {
+        FrameStatistics* frameStatistics = nullptr;
+        const Object* renderGraph = nullptr;
+        CommandBuffer* commandBuffer = nullptr;
+        uint64_t frameCount = 0;
+
+        ~ScopedGpuTiming()
+        {
+            if (frameStatistics) frameStatistics->endGpuTiming(renderGraph, *commandBuffer, frameCount);
+        }
+    } gpuTiming;
+
+    if (auto frameStatistics = recordTraversal.frameStatistics.get(); frameStatistics && (frameStatistics->recordGpuTimings || frameStatistics->recordPipelineStatistics) && recordTraversal.getFrameStamp())
+    {
+        gpuTiming.frameStatistics = frameStatistics;
+        gpuTiming.renderGraph = this;
+        gpuTiming.commandBuffer = recordTraversal.getCommandBuffer();
+        gpuTiming.frameCount = recordTraversal.getFrameStamp()->frameCount;
+        frameStatistics->beginGpuTiming(this, *gpuTiming.commandBuffer, gpuTiming.frameCount);
+    }
+
+    if (dynamicRendering)
+    {
+        auto activeFramebuffer = framebuffer ? framebuffer.get() : nullptr;
+        if (!activeFramebuffer)
+        {
+            size_t imageIndex = window->imageIndex();
+            if (imageIndex >= window->numFrames()) return;
+            activeFramebuffer = window->framebuffer(imageIndex);
+        }
+
+        auto activeRenderPass = renderPass ? renderPass.get() : activeFramebuffer->getRenderPass();
+        if (activeRenderPass && !activeRenderPass->subpasses.empty())
+        {
+            _recordDynamicRendering(recordTraversal, *activeRenderPass, *activeFramebuffer);
+            return;
+        }
+    }
+
     VkRenderPassBeginInfo renderPassInfo = {};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 
@@ -143,6 +189,18 @@ void RenderGraph::accept(RecordTraversal& recordTraversal) const
     renderPassInfo.pClearValues = clearValues.data();
 
     VkCommandBuffer vk_commandBuffer = *(recordTraversal.getState()->_commandBuffer);
+
+    auto activeRenderPass = renderPass ? renderPass.get() : (framebuffer ? framebuffer->getRenderPass() : window->getRenderPass().get());
+    if (parallelSecondaryCommandBuffers && activeRenderPass && activeRenderPass->subpasses.size() == 1)
+    {
+        vkCmdBeginRenderPass(vk_commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+        recordTraversal.recordSecondaryCommandBuffers(*this, renderPassInfo.renderPass, renderPassInfo.framebuffer);
+
+        vkCmdEndRenderPass(vk_commandBuffer);
+        return;
+    }
+
     vkCmdBeginRenderPass(vk_commandBuffer, &renderPassInfo, contents);
 
     // traverse the subgraph to place commands into the command buffer.
@@ -151,6 +209,195 @@ void RenderGraph::accept(RecordTraversal& recordTraversal) const
     vkCmdEndRenderPass(vk_commandBuffer);
 }
 
+void RenderGraph::_recordDynamicRendering(RecordTraversal& recordTraversal, const RenderPass& activeRenderPass, const Framebuffer& activeFramebuffer) const
+{
+    auto commandBuffer = recordTraversal.getState()->_commandBuffer;
+    auto extensions = commandBuffer->getDevice()->getExtensions();
+    if (!extensions->vkCmdBeginRendering || !extensions->vkCmdEndRendering)
+    {
+        warn("vsg::RenderGraph::accept() dynamicRendering requested but vkCmdBeginRendering is not available, requires Vulkan 1.3 or VK_KHR_dynamic_rendering.");
+        return;
+    }
+
+    VkCommandBuffer vk_commandBuffer = commandBuffer->vk();
+    auto deviceID = commandBuffer->deviceID;
+
+    const auto& attachments = activeFramebuffer.getAttachments();
+    const auto& subpass = activeRenderPass.subpasses.front();
+
+    // the external dependencies of the RenderPass provide the synchronization to use for the layout transitions
+    VkPipelineStageFlags srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    VkAccessFlags srcAccessMask = 0;
+    VkPipelineStageFlags dstStageMask = 0;
+    VkAccessFlags dstAccessMask = 0;
+    for (auto& dependency : activeRenderPass.dependencies)
+    {
+        if (dependency.srcSubpass == VK_SUBPASS_EXTERNAL)
+        {
+            srcStageMask |= dependency.srcStageMask;
+            srcAccessMask |= dependency.srcAccessMask;
+        }
+        else if (dependency.dstSubpass == VK_SUBPASS_EXTERNAL)
+        {
+            dstStageMask |= dependency.dstStageMask;
+            dstAccessMask |= dependency.dstAccessMask;
+        }
+    }
+    if (dstStageMask == 0) dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+    const VkPipelineStageFlags attachmentStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+    std::vector<VkImageMemoryBarrier> beginBarriers;
+    std::vector<VkImageMemoryBarrier> endBarriers;
+
+    auto imageView = [&](const AttachmentReference& reference) -> ImageView* {
+        if (reference.attachment == VK_ATTACHMENT_UNUSED || reference.attachment >= attachments.size() || reference.attachment >= activeRenderPass.attachments.size()) return nullptr;
+        auto view = attachments[reference.attachment].get();
+        return (view && view->image) ? view : nullptr;
+    };
+
+    auto addBarriers = [&](const AttachmentReference& reference, VkAccessFlags attachmentAccessMask) {
+        auto view = imageView(reference);
+        if (!view) return;
+
+        auto& description = activeRenderPass.attachments[reference.attachment];
+
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = view->image->vk(deviceID);
+        barrier.subresourceRange = view->subresourceRange;
+
+        barrier.srcAccessMask = srcAccessMask;
+        barrier.dstAccessMask = attachmentAccessMask;
+        barrier.oldLayout = description.initialLayout;
+        barrier.newLayout = reference.layout;
+        beginBarriers.push_back(barrier);
+
+        if (description.finalLayout != reference.layout || dstAccessMask != 0)
+        {
+            barrier.srcAccessMask = attachmentAccessMask;
+            barrier.dstAccessMask = dstAccessMask;
+            barrier.oldLayout = reference.layout;
+            barrier.newLayout = description.finalLayout;
+            endBarriers.push_back(barrier);
+        }
+    };
+
+    auto attachmentInfo = [&](const AttachmentReference& reference, bool stencil) {
+        VkRenderingAttachmentInfoKHR info = {};
+        info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        info.imageView = VK_NULL_HANDLE;
+        info.imageLayout = reference.layout;
+        info.resolveMode = VK_RESOLVE_MODE_NONE;
+        info.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        info.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+        if (auto view = imageView(reference))
+        {
+            auto& description = activeRenderPass.attachments[reference.attachment];
+            info.imageView = view->vk(deviceID);
+            info.loadOp = stencil ? description.stencilLoadOp : description.loadOp;
+            info.storeOp = stencil ? description.stencilStoreOp : description.storeOp;
+            if (reference.attachment < clearValues.size()) info.clearValue = clearValues[reference.attachment];
+        }
+        return info;
+    };
+
+    auto assignResolve = [&](VkRenderingAttachmentInfoKHR& info, const AttachmentReference& reference, VkResolveModeFlagBits resolveMode) {
+        auto view = imageView(reference);
+        if (!view || info.imageView == VK_NULL_HANDLE || resolveMode == VK_RESOLVE_MODE_NONE) return;
+
+        info.resolveMode = resolveMode;
+        info.resolveImageView = view->vk(deviceID);
+        info.resolveImageLayout = reference.layout;
+    };
+
+    const VkAccessFlags colorAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    const VkAccessFlags depthAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    std::vector<VkRenderingAttachmentInfoKHR> colorAttachments;
+    for (size_t i = 0; i < subpass.colorAttachments.size(); ++i)
+    {
+        auto& reference = subpass.colorAttachments[i];
+        addBarriers(reference, colorAccessMask);
+        colorAttachments.push_back(attachmentInfo(reference, false));
+
+        if (i < subpass.resolveAttachments.size())
+        {
+            auto& resolveReference = subpass.resolveAttachments[i];
+            addBarriers(resolveReference, colorAccessMask);
+            assignResolve(colorAttachments.back(), resolveReference, VK_RESOLVE_MODE_AVERAGE_BIT);
+        }
+    }
+
+    VkRenderingAttachmentInfoKHR depthAttachment = {};
+    VkRenderingAttachmentInfoKHR stencilAttachment = {};
+    bool hasDepth = false;
+    bool hasStencil = false;
+    if (!subpass.depthStencilAttachments.empty())
+    {
+        auto& reference = subpass.depthStencilAttachments.front();
+        if (imageView(reference))
+        {
+            auto aspectMask = computeAspectFlagsForFormat(activeRenderPass.attachments[reference.attachment].format);
+            hasDepth = (aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) != 0;
+            hasStencil = (aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) != 0;
+
+            addBarriers(reference, depthAccessMask);
+            depthAttachment = attachmentInfo(reference, false);
+            stencilAttachment = attachmentInfo(reference, true);
+
+            if (!subpass.depthStencilResolveAttachments.empty())
+            {
+                auto& resolveReference = subpass.depthStencilResolveAttachments.front();
+                addBarriers(resolveReference, depthAccessMask);
+                assignResolve(depthAttachment, resolveReference, subpass.depthResolveMode);
+                assignResolve(stencilAttachment, resolveReference, subpass.stencilResolveMode);
+            }
+        }
+    }
+
+    if (!beginBarriers.empty())
+    {
+        vkCmdPipelineBarrier(vk_commandBuffer, srcStageMask, attachmentStageMask, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(beginBarriers.size()), beginBarriers.data());
+    }
+
+    VkRenderingInfoKHR renderingInfo = {};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.flags = 0;
+    renderingInfo.renderArea = renderArea;
+    renderingInfo.layerCount = activeFramebuffer.layers();
+    renderingInfo.viewMask = subpass.viewMask;
+    renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorAttachments.size());
+    renderingInfo.pColorAttachments = colorAttachments.data();
+    renderingInfo.pDepthAttachment = hasDepth ? &depthAttachment : nullptr;
+    renderingInfo.pStencilAttachment = hasStencil ? &stencilAttachment : nullptr;
+
+    VkRenderingFragmentShadingRateAttachmentInfoKHR fragmentShadingRateInfo = {};
+    if (fragmentShadingRateAttachment)
+    {
+        fragmentShadingRateInfo.sType = VK_STRUCTURE_TYPE_RENDERING_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR;
+        fragmentShadingRateInfo.imageView = fragmentShadingRateAttachment->vk(deviceID);
+        fragmentShadingRateInfo.imageLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+        fragmentShadingRateInfo.shadingRateAttachmentTexelSize = fragmentShadingRateTexelSize;
+        renderingInfo.pNext = &fragmentShadingRateInfo;
+    }
+
+    extensions->vkCmdBeginRendering(vk_commandBuffer, &renderingInfo);
+
+    // traverse the subgraph to place commands into the command buffer.
+    traverse(recordTraversal);
+
+    extensions->vkCmdEndRendering(vk_commandBuffer);
+
+    if (!endBarriers.empty())
+    {
+        vkCmdPipelineBarrier(vk_commandBuffer, attachmentStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(endBarriers.size()), endBarriers.data());
+    }
+}
+
 void RenderGraph::resized()
 {
     if (!windowResizeHandler) return;
@@ -167,6 +414,7 @@ void RenderGraph::resized()
 
     windowResizeHandler->context->commandPool = nullptr;
     windowResizeHandler->context->renderPass = activeRenderPass;
+    windowResizeHandler->context->dynamicRendering = dynamicRendering;
     windowResizeHandler->renderArea = renderArea;
     windowResizeHandler->previous_extent = previous_extent;
     windowResizeHandler->new_extent = extent;
@@ -177,8 +425,8 @@ void RenderGraph::resized()
         windowResizeHandler->context->overridePipelineStates.emplace_back(vsg::MultisampleState::create(activeRenderPass->maxSamples));
     }
 
-    // make sure the device is idle before we recreate any Vulkan objects
-    vkDeviceWaitIdle(*(device));
+    // the WindowResizeHandler waits for the device to be idle only if it needs to recreate any Vulkan objects
+    windowResizeHandler->deviceIdle = false;
 
     traverse(*windowResizeHandler);
 
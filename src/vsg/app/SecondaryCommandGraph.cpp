@@ -59,11 +59,28 @@ void SecondaryCommandGraph::_disconnect(ExecuteCommands* ec)
 
 void SecondaryCommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedCommandBuffers, ref_ptr<FrameStamp> frameStamp, ref_ptr<DatabasePager> databasePager)
 {
+    ScopedTiming timing(frameStatistics ? frameStatistics->recordTimings(this).get() : nullptr);
+
     if (window && !window->visible())
     {
         return;
     }
 
+    // secondary CommandBuffers inherit the RenderPass without a framebuffer so a single recorded CommandBuffer can be reused
+    uint64_t signature = 0;
+    if (auto reusable = _reusableCommandBuffer(0, signature))
+    {
+        reusable->numDependentSubmissions().fetch_add(1);
+
+        for (auto& ec : _executeCommands)
+        {
+            ec->completed(*this, reusable);
+        }
+
+        recordedCommandBuffers->add(submitOrder, reusable);
+        return;
+    }
+
     if (!recordTraversal)
     {
         recordTraversal = RecordTraversal::create(maxSlot);
@@ -79,29 +96,11 @@ void SecondaryCommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedComma
     recordTraversal->setDatabasePager(databasePager);
     recordTraversal->clearBins();
 
-    ref_ptr<CommandBuffer> commandBuffer;
-    for (auto& cb : _commandBuffers)
-    {
-        if (cb->numDependentSubmissions() == 0)
-        {
-            commandBuffer = cb;
-            break;
-        }
-    }
-    if (!commandBuffer)
-    {
-        ref_ptr<CommandPool> cp = CommandPool::create(device, queueFamily);
-        commandBuffer = cp->allocate(level());
-        _commandBuffers.push_back(commandBuffer);
-    }
-    else
-    {
-        commandBuffer->reset();
-    }
-
+    auto commandBuffer = _availableCommandBuffer();
     commandBuffer->numDependentSubmissions().fetch_add(1);
 
     recordTraversal->getState()->_commandBuffer = commandBuffer;
+    commandBuffer->resetRecordedState();
 
     // or select index when maps to a dormant CommandBuffer
     VkCommandBuffer vk_commandBuffer = *commandBuffer;
@@ -111,7 +110,7 @@ void SecondaryCommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedComma
     VkCommandBufferBeginInfo beginInfo = {};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
-    if (_executeCommands.size() > 1) beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+    if (_executeCommands.size() > 1 || reuseCommandBuffers) beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
 
     VkCommandBufferInheritanceInfo inheritanceInfo;
     inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
@@ -141,6 +140,8 @@ void SecondaryCommandGraph::record(ref_ptr<RecordedCommandBuffers> recordedComma
 
     vkEndCommandBuffer(vk_commandBuffer);
 
+    _retainCommandBuffer(0, signature, commandBuffer);
+
     // pass on this command buffer to connected ExecuteCommands nodes
     for (auto& ec : _executeCommands)
     {
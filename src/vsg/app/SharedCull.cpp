@@ -0,0 +1,133 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/app/SharedCull.h>
+#include <vsg/maths/transform.h>
+#include <vsg/nodes/DepthSorted.h>
+#include <vsg/nodes/Light.h>
+#include <vsg/state/StateCommand.h>
+#include <vsg/utils/ComputeBounds.h>
+#include <vsg/vk/State.h>
+
+using namespace vsg;
+
+SharedCull::SharedCull(ref_ptr<Camera> in_camera) :
+    camera(in_camera)
+{
+}
+
+SharedCull::~SharedCull()
+{
+}
+
+void SharedCull::culled(uint64_t frameCount, const dmat4& viewMatrix)
+{
+    _frameCount = frameCount;
+    _inverseCullView = inverse(viewMatrix);
+
+    // only the entries of nodes that are still candidates are carried over, so nodes removed from the scene graph are released
+    std::unordered_map<const Node*, CachedBound> boundsCache;
+    boundsCache.reserve(_boundsCache.size());
+
+    _bounds.resize(_elements.size());
+    for (size_t i = 0; i < _elements.size(); ++i)
+    {
+        auto node = _elements[i].child;
+
+        // DepthSorted nodes and lights are culled by the RecordTraversal itself when recorded
+        if (node->is_compatible(typeid(DepthSorted)) || node->is_compatible(typeid(Light)))
+        {
+            _bounds[i] = {};
+            continue;
+        }
+
+        // the draw nodes are typically static so cache their bounds across frames
+        auto itr = boundsCache.find(node);
+        if (itr == boundsCache.end())
+        {
+            if (auto previous = _boundsCache.find(node); previous != _boundsCache.end())
+            {
+                itr = boundsCache.emplace(node, std::move(previous->second)).first;
+            }
+            else
+            {
+                ComputeBounds computeBounds;
+                node->accept(computeBounds);
+
+                dsphere bound;
+                if (computeBounds.bounds.valid())
+                {
+                    auto& bounds = computeBounds.bounds;
+                    bound.set((bounds.min + bounds.max) * 0.5, length(bounds.max - bounds.min) * 0.5);
+                }
+                itr = boundsCache.emplace(node, CachedBound{ref_ptr<const Node>(node), bound}).first;
+            }
+        }
+        _bounds[i] = itr->second.bound;
+    }
+
+    _boundsCache.swap(boundsCache);
+}
+
+void SharedCull::record(RecordTraversal& rt, const dmat4& viewMatrix) const
+{
+    auto state = rt.getState();
+
+    // the candidates' matrices are relative to the cull view, so map them into this View's eye coordinates
+    auto cullToView = viewMatrix * _inverseCullView;
+
+    uint32_t previousMatrixIndex = static_cast<uint32_t>(_matrices.size());
+    bool matrixPushed = false;
+
+    state->pushFrustum();
+    state->dirty = true;
+
+    for (size_t i = 0; i < _elements.size(); ++i)
+    {
+        auto& element = _elements[i];
+
+        if (element.matrixIndex != previousMatrixIndex)
+        {
+            if (matrixPushed) state->modelviewMatrixStack.pop();
+            state->modelviewMatrixStack.push(cullToView * _matrices[element.matrixIndex]);
+            matrixPushed = true;
+            state->applyFrustum();
+            state->dirty = true;
+            previousMatrixIndex = element.matrixIndex;
+        }
+
+        if (_bounds[i].valid() && !state->intersect(_bounds[i])) continue;
+
+        uint32_t endIndex = element.stateCommandIndex + element.stateCommandCount;
+        for (uint32_t c = element.stateCommandIndex; c < endIndex; ++c)
+        {
+            auto command = _stateCommands[c];
+            state->stateStacks[command->slot].push(command);
+        }
+        if (element.stateCommandCount > 0) state->dirty = true;
+
+        element.child->accept(rt);
+
+        for (uint32_t c = element.stateCommandIndex; c < endIndex; ++c)
+        {
+            auto command = _stateCommands[c];
+            state->stateStacks[command->slot].pop();
+        }
+        if (element.stateCommandCount > 0) state->dirty = true;
+    }
+
+    if (matrixPushed) state->modelviewMatrixStack.pop();
+
+    state->popFrustum();
+    state->dirty = true;
+}
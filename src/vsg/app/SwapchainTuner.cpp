@@ -0,0 +1,229 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/FrameStatistics.h>
+#include <vsg/app/SwapchainTuner.h>
+#include <vsg/app/Viewer.h>
+#include <vsg/io/Logger.h>
+#include <vsg/utils/Instrumentation.h>
+#include <vsg/vk/Swapchain.h>
+
+#include <algorithm>
+#include <iomanip>
+
+using namespace vsg;
+
+namespace
+{
+    const char* presentModeName(VkPresentModeKHR presentMode)
+    {
+        switch (presentMode)
+        {
+        case (VK_PRESENT_MODE_IMMEDIATE_KHR): return "IMMEDIATE";
+        case (VK_PRESENT_MODE_MAILBOX_KHR): return "MAILBOX";
+        case (VK_PRESENT_MODE_FIFO_KHR): return "FIFO";
+        case (VK_PRESENT_MODE_FIFO_RELAXED_KHR): return "FIFO_RELAXED";
+        default: return "UNKNOWN";
+        }
+    }
+
+    double milliseconds(clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+} // namespace
+
+void SwapchainTuner::update(Viewer& viewer)
+{
+    CPU_INSTRUMENTATION_L1_NC(viewer.instrumentation, "SwapchainTuner update", COLOR_VIEWER);
+
+    uint32_t lowerFramesInFlight = std::max(minimumFramesInFlight, 1u);
+    uint32_t upperFramesInFlight = std::max(maximumFramesInFlight, lowerFramesInFlight);
+    framesInFlight = std::clamp(framesInFlight == 0 ? upperFramesInFlight : framesInFlight, lowerFramesInFlight, upperFramesInFlight);
+
+    if (auto frameStatistics = viewer.frameStatistics; frameStatistics && frameStatistics->stage(FrameStatistics::FRAME).count() > 0)
+    {
+        _smooth(frameTime, frameStatistics->stage(FrameStatistics::FRAME).latest());
+        _smooth(acquireWait, frameStatistics->stage(FrameStatistics::ACQUIRE).latest());
+        if (double latestGpuTime = frameStatistics->latestGpuTime(); latestGpuTime > 0.0) _smooth(gpuTime, latestGpuTime);
+    }
+
+    // before the RecordAndSubmitTasks advance fence(0) is that of the most recently submitted frame,
+    // so completing fence(framesInFlight - 1) limits the frames in flight to framesInFlight once the next frame is submitted.
+    auto waitStart = clock::now();
+    for (auto& task : viewer.recordAndSubmitTasks)
+    {
+        auto fence = task->fence(framesInFlight - 1);
+        if (fence && fence->hasDependencies()) fence->wait(timeout);
+    }
+    auto waitEnd = clock::now();
+
+    if (!_frameStarts.empty()) _smooth(fenceWait, milliseconds(waitEnd - waitStart));
+
+    // the GPU completion of the frame is only observed when its fence is waited upon, so when the GPU finishes earlier this is an upper bound
+    if (_frameStarts.size() >= framesInFlight) _smooth(latency, milliseconds(waitEnd - _frameStarts[_frameStarts.size() - framesInFlight]));
+
+    _frameStarts.push_back(waitEnd);
+    while (_frameStarts.size() > upperFramesInFlight) _frameStarts.pop_front();
+
+    if (viewer.instrumentation)
+    {
+        viewer.instrumentation->plot("vsg acquire wait (ms)", acquireWait);
+        viewer.instrumentation->plot("vsg fence wait (ms)", fenceWait);
+    }
+
+    if (_framesSinceAdjustment < adjustmentInterval)
+        ++_framesSinceAdjustment;
+    else if (adjust(viewer))
+        _reset();
+}
+
+bool SwapchainTuner::adjust(Viewer& viewer)
+{
+    // all the windows are configured the same, so base decisions on the first with a swapchain
+    ref_ptr<Window> window;
+    for (auto& candidate : viewer.windows())
+    {
+        if (candidate->visible() && candidate->getSwapchain())
+        {
+            window = candidate;
+            break;
+        }
+    }
+    if (!window || !window->getPhysicalDevice() || !window->getSurface()) return false;
+
+    const auto& preferences = window->traits()->swapchainPreferences;
+    auto presentMode = preferences.presentMode;
+    auto imageCount = preferences.imageCount;
+
+    auto details = querySwapChainSupport(*(window->getPhysicalDevice()), *(window->getSurface()));
+    auto supported = [&](VkPresentModeKHR mode) { return std::find(details.presentModes.begin(), details.presentModes.end(), mode) != details.presentModes.end(); };
+
+    uint32_t lowerImageCount = std::max(minimumImageCount, details.capabilities.minImageCount);
+    uint32_t upperImageCount = (details.capabilities.maxImageCount > 0) ? std::min(maximumImageCount, details.capabilities.maxImageCount) : maximumImageCount;
+    uint32_t lowerFramesInFlight = std::max(minimumFramesInFlight, 1u);
+
+    bool fifo = (presentMode == VK_PRESENT_MODE_FIFO_KHR || presentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR);
+
+    if (maximumLatency > 0.0 && latency > maximumLatency)
+    {
+        if (framesInFlight > lowerFramesInFlight)
+        {
+            _reconfigure(viewer, presentMode, imageCount, framesInFlight - 1, "latency above maximumLatency, reducing frames in flight");
+            return true;
+        }
+        if (fifo && supported(VK_PRESENT_MODE_MAILBOX_KHR))
+        {
+            _reconfigure(viewer, VK_PRESENT_MODE_MAILBOX_KHR, imageCount, framesInFlight, "latency above maximumLatency, switching to MAILBOX so the latest frame replaces those queued for presentation");
+            return true;
+        }
+        if (fifo && imageCount > lowerImageCount)
+        {
+            _reconfigure(viewer, presentMode, imageCount - 1, framesInFlight, "latency above maximumLatency, reducing the swapchain images queued for presentation");
+            return true;
+        }
+        if (allowTearing && presentMode != VK_PRESENT_MODE_IMMEDIATE_KHR && supported(VK_PRESENT_MODE_IMMEDIATE_KHR))
+        {
+            _reconfigure(viewer, VK_PRESENT_MODE_IMMEDIATE_KHR, imageCount, framesInFlight, "latency above maximumLatency, switching to IMMEDIATE");
+            return true;
+        }
+        return false;
+    }
+
+    if (targetFrameTime > 0.0 && frameTime > targetFrameTime * 1.05)
+    {
+        // waiting on acquiring swapchain images means presentation is holding back the frame rate
+        if (fifo && acquireWait > frameTime * 0.25)
+        {
+            if (imageCount < upperImageCount)
+            {
+                _reconfigure(viewer, presentMode, imageCount + 1, framesInFlight, "frame time above targetFrameTime while waiting on image acquire, adding a swapchain image");
+                return true;
+            }
+            if (allowTearing && presentMode == VK_PRESENT_MODE_FIFO_KHR && supported(VK_PRESENT_MODE_FIFO_RELAXED_KHR))
+            {
+                _reconfigure(viewer, VK_PRESENT_MODE_FIFO_RELAXED_KHR, imageCount, framesInFlight, "frame time above targetFrameTime while waiting on image acquire, switching to FIFO_RELAXED so late frames are presented immediately");
+                return true;
+            }
+            if (supported(VK_PRESENT_MODE_MAILBOX_KHR))
+            {
+                _reconfigure(viewer, VK_PRESENT_MODE_MAILBOX_KHR, imageCount, framesInFlight, "frame time above targetFrameTime while waiting on image acquire, switching to MAILBOX");
+                return true;
+            }
+        }
+
+        // waiting on fences while the GPU is idle for part of each frame means the CPU and GPU are serialized, another frame in flight lets them overlap,
+        // but only make the change if the extra frame of latency stays within the latency goal.
+        bool gpuIdle = (gpuTime <= 0.0) || (gpuTime < frameTime * 0.9);
+        bool withinLatency = (maximumLatency <= 0.0) || (latency + frameTime <= maximumLatency);
+        if (fenceWait > frameTime * 0.25 && gpuIdle && withinLatency && framesInFlight < maximumFramesInFlight)
+        {
+            _reconfigure(viewer, presentMode, imageCount, framesInFlight + 1, "frame time above targetFrameTime while waiting on fences with the GPU partly idle, adding a frame in flight");
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SwapchainTuner::_reconfigure(Viewer& viewer, VkPresentModeKHR presentMode, uint32_t imageCount, uint32_t numFramesInFlight, const std::string& reason)
+{
+    Decision decision;
+    decision.frameCount = viewer.getFrameStamp() ? viewer.getFrameStamp()->frameCount : 0;
+    decision.presentMode = presentMode;
+    decision.imageCount = imageCount;
+    decision.framesInFlight = numFramesInFlight;
+    decision.reason = reason;
+
+    for (auto& window : viewer.windows())
+    {
+        auto& preferences = window->traits()->swapchainPreferences;
+        if (!window->getSwapchain() || (preferences.presentMode == presentMode && preferences.imageCount == imageCount)) continue;
+
+        preferences.presentMode = presentMode;
+        preferences.imageCount = imageCount;
+
+        // rebuilds the swapchain, which passes back the present mode and image count it was created with
+        window->resize();
+
+        decision.presentMode = preferences.presentMode;
+        decision.imageCount = preferences.imageCount;
+    }
+
+    framesInFlight = numFramesInFlight;
+
+    info("SwapchainTuner ", reason, " : presentMode = ", presentModeName(decision.presentMode), ", imageCount = ", decision.imageCount, ", framesInFlight = ", decision.framesInFlight);
+
+    decisions.push_back(decision);
+}
+
+void SwapchainTuner::_reset()
+{
+    frameTime = 0.0;
+    acquireWait = 0.0;
+    fenceWait = 0.0;
+    gpuTime = 0.0;
+    latency = 0.0;
+    _framesSinceAdjustment = 0;
+}
+
+void SwapchainTuner::report(std::ostream& out) const
+{
+    out << std::fixed << std::setprecision(3);
+    out << "SwapchainTuner (ms) frameTime = " << frameTime << ", acquireWait = " << acquireWait << ", fenceWait = " << fenceWait << ", gpuTime = " << gpuTime << ", latency = " << latency
+        << ", framesInFlight = " << framesInFlight << std::endl;
+    for (auto& decision : decisions)
+    {
+        out << "    frame " << decision.frameCount << " : presentMode = " << presentModeName(decision.presentMode) << ", imageCount = " << decision.imageCount
+            << ", framesInFlight = " << decision.framesInFlight << ", " << decision.reason << std::endl;
+    }
+}
@@ -0,0 +1,182 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/TextureStreamer.h>
+#include <vsg/core/observer_ptr.h>
+#include <vsg/io/Logger.h>
+#include <vsg/state/DescriptorImage.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vsg;
+
+struct TextureStreamer::CompileOperation : public Inherit<Operation, CompileOperation>
+{
+    CompileOperation(TextureStreamer* in_streamer, ref_ptr<StreamingTexture> in_texture, uint32_t in_mipLevel) :
+        streamer(in_streamer),
+        texture(in_texture),
+        mipLevel(in_mipLevel) {}
+
+    void run() override
+    {
+        ref_ptr<TextureStreamer> ts = streamer;
+        if (ts) ts->_compile(texture, mipLevel);
+    }
+
+    observer_ptr<TextureStreamer> streamer;
+    ref_ptr<StreamingTexture> texture;
+    uint32_t mipLevel;
+};
+
+TextureStreamer::TextureStreamer(ref_ptr<CompileManager> in_compileManager, VkDeviceSize in_memoryBudget) :
+    compileManager(in_compileManager),
+    memoryBudget(in_memoryBudget),
+    _compileThreads(OperationThreads::create(1))
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    _compileThreads->stop();
+}
+
+uint32_t TextureStreamer::computeRequiredMipLevel(const StreamingTexture& texture, double screenHeightRatio) const
+{
+    if (!texture.image || screenHeightRatio <= 0.0) return texture.coarseMipLevel;
+
+    // number of texels of the finest mip level divided by the number of pixels the texture covers gives the level of detail
+    double texels = static_cast<double>(texture.image->height() * texture.image->properties.blockHeight);
+    double pixels = screenHeightRatio * screenHeight;
+    double level = std::floor(std::log2(texels / pixels) + lodBias);
+
+    if (level <= 0.0) return 0;
+    if (level >= static_cast<double>(texture.coarseMipLevel)) return texture.coarseMipLevel;
+    return static_cast<uint32_t>(level);
+}
+
+void TextureStreamer::request(const StreamingTexture& texture, uint32_t mipLevel)
+{
+    // only one request at a time for each StreamingTexture
+    if (texture.requestPending.exchange(true)) return;
+
+    _compileThreads->add(CompileOperation::create(this, ref_ptr<StreamingTexture>(const_cast<StreamingTexture*>(&texture)), mipLevel));
+}
+
+void TextureStreamer::_compile(const ref_ptr<StreamingTexture>& texture, uint32_t mipLevel)
+{
+    // if the StreamingTexture has been removed from the scene graph there is no need to compile it
+    if (texture->referenceCount() <= 1)
+    {
+        texture->requestPending = false;
+        return;
+    }
+
+    auto state = texture->createBindDescriptorSet(mipLevel);
+    if (!state || !compileManager)
+    {
+        texture->requestPending = false;
+        return;
+    }
+
+    auto result = compileManager->compile(state);
+    if (!result)
+    {
+        warn("TextureStreamer unable to compile mip level ", mipLevel, " of ", texture, ", ", result.message);
+        texture->requestPending = false;
+        return;
+    }
+
+    VkDeviceSize size = 0;
+    auto descriptorImage = state->descriptorSet->descriptors[texture->descriptorIndex].cast<DescriptorImage>();
+    for (auto& imageInfo : descriptorImage->imageInfoList)
+    {
+        if (imageInfo->imageView && imageInfo->imageView->image && imageInfo->imageView->image->data) size += imageInfo->imageView->image->data->dataSize();
+    }
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _compiled.push_back(Compiled{texture, mipLevel, state, size});
+}
+
+void TextureStreamer::_evict(std::list<Resident>::iterator itr)
+{
+    auto& texture = *(itr->texture);
+    _retired.push_back(Retired{texture.activeState, _frameCount});
+
+    texture.activeState = texture.coarseState;
+    texture.activeMipLevel = texture.coarseMipLevel;
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _residentSize -= itr->size;
+    _residents.erase(itr);
+}
+
+void TextureStreamer::run()
+{
+    ++_frameCount;
+
+    std::vector<Compiled> compiled;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        compiled.swap(_compiled);
+    }
+
+    // switch StreamingTexture over to their newly compiled mip levels
+    for (auto& entry : compiled)
+    {
+        auto& texture = *(entry.texture);
+        texture.requestPending = false;
+
+        if (entry.mipLevel >= texture.activeMipLevel)
+        {
+            _retired.push_back(Retired{entry.state, _frameCount});
+            continue;
+        }
+
+        auto itr = std::find_if(_residents.begin(), _residents.end(), [&](const Resident& resident) { return resident.texture == entry.texture; });
+        if (itr != _residents.end()) _evict(itr);
+
+        texture.activeState = entry.state;
+        texture.activeMipLevel = entry.mipLevel;
+
+        _residents.push_back(Resident{entry.texture, entry.size});
+
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _residentSize += entry.size;
+    }
+
+    // release the streamed mip levels of StreamingTexture that are no longer in the scene graph
+    for (auto itr = _residents.begin(); itr != _residents.end();)
+    {
+        auto current = itr++;
+        if (current->texture->referenceCount() == 1) _evict(current);
+    }
+
+    // evict the least recently used streamed mip levels until within the memory budget
+    while (residentSize() > memoryBudget && !_residents.empty())
+    {
+        auto lru = std::min_element(_residents.begin(), _residents.end(), [](const Resident& lhs, const Resident& rhs) { return lhs.texture->frameLastUsed < rhs.texture->frameLastUsed; });
+        _evict(lru);
+    }
+
+    // release evicted state once command buffers that might still reference it have completed
+    while (!_retired.empty() && (_frameCount - _retired.front().frameCount) > numFramesToRetainEvicted)
+    {
+        _retired.pop_front();
+    }
+}
+
+VkDeviceSize TextureStreamer::residentSize() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _residentSize;
+}
@@ -0,0 +1,300 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/app/ToneMapRenderGraph.h>
+#include <vsg/commands/Draw.h>
+#include <vsg/commands/NextSubPass.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/nodes/Light.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DepthStencilState.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/MultisampleState.h>
+#include <vsg/state/RasterizationState.h>
+#include <vsg/state/VertexInputState.h>
+
+using namespace vsg;
+
+namespace
+{
+    const char* tonemap_vert = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+out gl_PerVertex{ vec4 gl_Position; };
+
+void main()
+{
+    // full screen triangle
+    gl_Position = vec4(vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2) * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+    const char* tonemap_frag = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput hdrInput;
+
+layout(set = 0, binding = 1) uniform ToneMapSettings
+{
+    vec4 colorFilter;
+    float exposure;
+    float contrast;
+    float saturation;
+    float gamma;
+} settings;
+
+layout(location = 0) out vec4 outColor;
+
+// ACES filmic tone curve, fit by Krzysztof Narkowicz 2015
+vec3 ACESFilm(vec3 x)
+{
+    const float a = 2.51;
+    const float b = 0.03;
+    const float c = 2.43;
+    const float d = 0.59;
+    const float e = 0.14;
+    return clamp((x * (a * x + b)) / (x * (c * x + d) + e), 0.0, 1.0);
+}
+
+void main()
+{
+    // the scene's shaders write gamma encoded color, so decode to linear before tone mapping and encode the result again
+    vec3 color = pow(max(subpassLoad(hdrInput).rgb, vec3(0.0)), vec3(settings.gamma)) * settings.colorFilter.rgb * settings.exposure;
+    color = pow(ACESFilm(color), vec3(1.0 / settings.gamma));
+
+    // color grading
+    float luminance = dot(color, vec3(0.2126, 0.7152, 0.0722));
+    color = mix(vec3(luminance), color, settings.saturation);
+    color = (color - 0.5) * settings.contrast + 0.5;
+
+    outColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
+)";
+
+    ref_ptr<ImageView> createAttachment(Device* device, const VkExtent2D& extent, VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage, VkImageAspectFlags aspectFlags)
+    {
+        auto image = Image::create();
+        image->imageType = VK_IMAGE_TYPE_2D;
+        image->extent = VkExtent3D{extent.width, extent.height, 1};
+        image->mipLevels = 1;
+        image->arrayLayers = 1;
+        image->format = format;
+        image->tiling = VK_IMAGE_TILING_OPTIMAL;
+        image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image->samples = samples;
+        image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image->usage = usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        image->compile(device);
+
+        // hdr color, multisampled hdr color and depth are never stored so can be lazily allocated
+        image->allocateAndBindMemory(device, image->preferredMemoryProperties(device));
+
+        auto imageView = ImageView::create(image, aspectFlags);
+        imageView->compile(device);
+        return imageView;
+    }
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// ToneMapRenderGraph
+//
+ToneMapRenderGraph::ToneMapRenderGraph(ref_ptr<Window> in_window, ref_ptr<View> in_view, ref_ptr<const Options> options) :
+    view(in_view),
+    settings(ToneMapSettingsValue::create())
+{
+    window = in_window;
+
+    // the dynamic rendering path only supports a single subpass
+    dynamicRendering = false;
+
+    auto device = window->getOrCreateDevice();
+
+    renderPass = createToneMapRenderPass(device, window->surfaceFormat().format, window->depthFormat(), hdrFormat, window->framebufferSamples());
+    hdrBuffer.resize(renderPass->attachments.size());
+
+    // set up the tone map subpass' descriptors, the hdr color ImageView is assigned by createFramebuffers()
+    settings->properties.dataVariance = DYNAMIC_DATA;
+
+    Descriptors descriptors{
+        DescriptorImage::create(ImageInfo::create(ref_ptr<Sampler>(), ref_ptr<ImageView>(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL), 0, 0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT),
+        DescriptorBuffer::create(settings, 1, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)};
+
+    DescriptorSetLayoutBindings bindings{
+        VkDescriptorSetLayoutBinding{0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr},
+        VkDescriptorSetLayoutBinding{1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}};
+
+    hdrDescriptorSet = DescriptorSet::create(DescriptorSetLayout::create(bindings), descriptors);
+
+    createFramebuffers();
+
+    // set up the tone map subpass, a full screen triangle that writes every pixel of the swapchain image
+    auto shaderSet = createToneMapShaderSet(options);
+
+    // the push constant range matches the one the RecordTraversal pushes the projection and modelview matrices to
+    auto pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{hdrDescriptorSet->setLayout}, PushConstantRanges{{VK_SHADER_STAGE_VERTEX_BIT, 0, 128}});
+
+    auto rasterizationState = RasterizationState::create();
+    rasterizationState->cullMode = VK_CULL_MODE_NONE;
+
+    auto depthStencilState = DepthStencilState::create();
+    depthStencilState->depthTestEnable = VK_FALSE;
+    depthStencilState->depthWriteEnable = VK_FALSE;
+
+    GraphicsPipelineStates pipelineStates{
+        VertexInputState::create(),
+        InputAssemblyState::create(),
+        rasterizationState,
+        MultisampleState::create(),
+        ColorBlendState::create(),
+        depthStencilState};
+
+    auto graphicsPipeline = GraphicsPipeline::create(pipelineLayout, shaderSet->getShaderStages(), pipelineStates, 1);
+
+    toneMapPass = StateGroup::create();
+    toneMapPass->add(BindGraphicsPipeline::create(graphicsPipeline));
+    toneMapPass->add(BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, hdrDescriptorSet));
+    toneMapPass->addChild(Draw::create(3, 1, 0, 0));
+
+    if (view)
+    {
+        addChild(view);
+
+        if (view->camera && view->camera->viewportState) renderArea = view->camera->getRenderArea();
+    }
+
+    // the View's bins are recorded after its children, so start the tone map subpass after the View
+    addChild(NextSubPass::create());
+    addChild(toneMapPass);
+
+    if (!view || !view->camera || !view->camera->viewportState)
+    {
+        renderArea.offset = {0, 0};
+        renderArea.extent = window->extent2D();
+    }
+
+    previous_extent = window->extent2D();
+
+    setClearValues(window->clearColor(), VkClearDepthStencilValue{0.0f, 0});
+}
+
+ToneMapRenderGraph::~ToneMapRenderGraph()
+{
+}
+
+void ToneMapRenderGraph::createFramebuffers()
+{
+    auto device = window->getOrCreateDevice();
+    auto extent = window->extent2D();
+
+    auto samples = renderPass->maxSamples;
+
+    hdrBuffer[HDR_COLOR] = createAttachment(device, extent, hdrFormat, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    hdrBuffer[DEPTH] = createAttachment(device, extent, window->depthFormat(), samples, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+    if (samples != VK_SAMPLE_COUNT_1_BIT)
+    {
+        hdrBuffer[MULTISAMPLE_HDR_COLOR] = createAttachment(device, extent, hdrFormat, samples, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    _framebuffers.clear();
+    _swapchainImageViews.clear();
+    for (size_t i = 0; i < window->numFrames(); ++i)
+    {
+        auto imageViews = hdrBuffer;
+        imageViews[COLOR] = window->imageView(i);
+        _framebuffers.push_back(Framebuffer::create(renderPass, imageViews, extent.width, extent.height, 1));
+        _swapchainImageViews.push_back(window->imageView(i).get());
+    }
+
+    if (!_framebuffers.empty()) framebuffer = _framebuffers.front();
+
+    // assign the new ImageView to the input attachment descriptor, if already compiled update the Vulkan descriptor set in place
+    auto descriptorImage = hdrDescriptorSet->descriptors[0].cast<DescriptorImage>();
+    auto& imageInfo = descriptorImage->imageInfoList.front();
+    imageInfo->imageView = hdrBuffer[HDR_COLOR];
+
+    if (auto implementation = hdrDescriptorSet->getImplementation(device->deviceID))
+    {
+        VkDescriptorImageInfo vk_imageInfo{VK_NULL_HANDLE, hdrBuffer[HDR_COLOR]->vk(device->deviceID), imageInfo->imageLayout};
+
+        VkWriteDescriptorSet descriptorWrite = {};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        descriptorWrite.pImageInfo = &vk_imageInfo;
+
+        implementation->write(1, &descriptorWrite);
+    }
+}
+
+void ToneMapRenderGraph::accept(RecordTraversal& recordTraversal) const
+{
+    // recreate the hdr buffer and framebuffers if the Window's swapchain has been recreated
+    bool swapchainChanged = _swapchainImageViews.size() != window->numFrames();
+    for (size_t i = 0; !swapchainChanged && i < _swapchainImageViews.size(); ++i)
+    {
+        swapchainChanged = _swapchainImageViews[i] != window->imageView(i).get();
+    }
+
+    auto this_renderGraph = const_cast<ToneMapRenderGraph*>(this);
+    if (swapchainChanged) this_renderGraph->createFramebuffers();
+
+    size_t imageIndex = window->imageIndex();
+    if (imageIndex >= _framebuffers.size()) return;
+
+    // RenderGraph::accept() uses the framebuffer in preference to the Window's own, so assign the one for the current swapchain image
+    this_renderGraph->framebuffer = _framebuffers[imageIndex];
+
+    RenderGraph::accept(recordTraversal);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// tone map ShaderSet
+//
+ref_ptr<ShaderSet> vsg::createToneMapShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("tonemap"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    ShaderStages stages{
+        ShaderStage::create(VK_SHADER_STAGE_VERTEX_BIT, "main", tonemap_vert),
+        ShaderStage::create(VK_SHADER_STAGE_FRAGMENT_BIT, "main", tonemap_frag)};
+
+    auto shaderSet = ShaderSet::create(stages);
+    shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+    return shaderSet;
+}
+
+ref_ptr<ToneMapRenderGraph> vsg::createToneMapRenderGraphForView(ref_ptr<Window> window, ref_ptr<Camera> camera, ref_ptr<Node> scenegraph, bool assignHeadlight)
+{
+    // set up the view
+    auto view = View::create(camera);
+    if (assignHeadlight) view->addChild(createHeadlight());
+    if (scenegraph) view->addChild(scenegraph);
+
+    return ToneMapRenderGraph::create(window, view);
+}
@@ -14,7 +14,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/app/View.h>
 #include <vsg/io/Logger.h>
 #include <vsg/ui/ApplicationEvent.h>
+#include <vsg/utils/ImageProcessing.h>
 #include <vsg/vk/State.h>
+#include <vsg/vk/TimelineSemaphore.h>
 
 using namespace vsg;
 
@@ -64,7 +66,19 @@ size_t TransferTask::index(size_t relativeFrameIndex) const
 
 bool TransferTask::containsDataToTransfer() const
 {
-    return !_dynamicDataMap.empty() || !_dynamicImageInfoSet.empty();
+    if (!_dynamicDataMap.empty() || !_dynamicImageInfoSet.empty()) return true;
+
+    std::scoped_lock lock(_imageRegionsMutex);
+    return !_imageRegions.empty();
+}
+
+void TransferTask::transfer(ref_ptr<Data> data, ref_ptr<ImageInfo> imageInfo, const VkOffset3D& imageOffset, const VkExtent3D& extent, uint32_t mipLevel, uint32_t arrayLayer)
+{
+    if (!data || !imageInfo || !imageInfo->imageView || !imageInfo->imageView->image) return;
+
+    std::scoped_lock lock(_imageRegionsMutex);
+    _imageRegions.push_back(ImageRegion{data, imageInfo, imageOffset, extent, mipLevel, arrayLayer});
+    _imageRegionsTotalSize += data->dataSize() + 16;
 }
 
 void TransferTask::assign(const ResourceRequirements::DynamicData& dynamicData)
@@ -103,80 +117,128 @@ void TransferTask::assign(const BufferInfoList& bufferInfoList)
     _dynamicDataTotalSize = offset;
 }
 
+bool TransferTask::requiresOwnershipTransfer() const
+{
+    return transferQueue && consumerQueue && transferQueue->queueFamilyIndex() != consumerQueue->queueFamilyIndex();
+}
+
 void TransferTask::_transferBufferInfos(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset)
 {
     CPU_INSTRUMENTATION_L1(instrumentation);
 
+    auto& copyRegions = frame.copyRegions;
+
+    // BufferInfos with several modified ranges record a region per range, so the regions are appended as required
+    copyRegions.clear();
+    copyRegions.reserve(_dynamicDataTotalRegions);
+
+    frame.bufferBarriers.clear();
+
+    // start from the first buffer that couldn't be transferred within the previous frame's budget
+    auto resumeBuffer = _resumeBuffer;
+    _resumeBuffer = {};
+
+    auto buffer_itr = resumeBuffer ? _dynamicDataMap.lower_bound(resumeBuffer) : _dynamicDataMap.begin();
+    while (buffer_itr != _dynamicDataMap.end())
+    {
+        buffer_itr = _transferBuffer(vk_commandBuffer, frame, offset, buffer_itr, copyRegions);
+    }
+
+    if (resumeBuffer)
+    {
+        auto end_itr = _dynamicDataMap.lower_bound(resumeBuffer);
+        for (buffer_itr = _dynamicDataMap.begin(); buffer_itr != end_itr;)
+        {
+            buffer_itr = _transferBuffer(vk_commandBuffer, frame, offset, buffer_itr, copyRegions);
+        }
+    }
+}
+
+TransferTask::BufferMap::iterator TransferTask::_transferBuffer(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset, BufferMap::iterator buffer_itr, std::vector<VkBufferCopy>& copyRegions)
+{
     Logger::Level level = Logger::LOGGER_DEBUG;
     //level = Logger::LOGGER_INFO;
 
     auto deviceID = device->deviceID;
     auto& staging = frame.staging;
-    auto& copyRegions = frame.copyRegions;
     auto& buffer_data = frame.buffer_data;
+    bool ownershipTransfer = requiresOwnershipTransfer();
 
     VkDeviceSize alignment = 4;
 
-    copyRegions.clear();
-    copyRegions.resize(_dynamicDataTotalRegions);
-    VkBufferCopy* pRegions = copyRegions.data();
+    auto& buffer = buffer_itr->first;
+    auto& bufferInfos = buffer_itr->second;
 
-    // copy any modified BufferInfo
-    for (auto buffer_itr = _dynamicDataMap.begin(); buffer_itr != _dynamicDataMap.end();)
+    size_t firstRegion = copyRegions.size();
+    BufferInfo::CopyRanges copyRanges;
+    for (auto bufferInfo_itr = bufferInfos.begin(); bufferInfo_itr != bufferInfos.end();)
     {
-        auto& bufferInfos = buffer_itr->second;
-
-        uint32_t regionCount = 0;
-        for (auto bufferInfo_itr = bufferInfos.begin(); bufferInfo_itr != bufferInfos.end();)
+        auto& bufferInfo = bufferInfo_itr->second;
+        if (bufferInfo->referenceCount() == 1)
         {
-            auto& bufferInfo = bufferInfo_itr->second;
-            if (bufferInfo->referenceCount() == 1)
+            log(level, "BufferInfo only ref left ", bufferInfo, ", ", bufferInfo->referenceCount());
+            bufferInfo_itr = bufferInfos.erase(bufferInfo_itr);
+        }
+        else
+        {
+            if (bufferInfo->requiresCopy(deviceID) && !_withinBudget(bufferInfo->range))
             {
-                log(level, "BufferInfo only ref left ", bufferInfo, ", ", bufferInfo->referenceCount());
-                bufferInfo_itr = bufferInfos.erase(bufferInfo_itr);
+                // leave the modified count unsynced so the BufferInfo is transferred on a later frame
+                if (!_resumeBuffer) _resumeBuffer = buffer;
             }
-            else
+            else if (bufferInfo->syncModifiedCounts(deviceID, copyRanges))
             {
-                if (bufferInfo->syncModifiedCounts(deviceID))
+                // copy data to staging buffer memory, when only ranges of the data have been dirtied just those ranges are copied
+                for (auto& [copyOffset, copySize] : copyRanges)
                 {
-                    // copy data to staging buffer memory
                     char* ptr = reinterpret_cast<char*>(buffer_data) + offset;
-                    std::memcpy(ptr, bufferInfo->data->dataPointer(), bufferInfo->range);
+                    std::memcpy(ptr, reinterpret_cast<const char*>(bufferInfo->data->dataPointer()) + copyOffset, copySize);
 
                     // record region
-                    pRegions[regionCount++] = VkBufferCopy{offset, bufferInfo->offset, bufferInfo->range};
+                    copyRegions.push_back(VkBufferCopy{offset, bufferInfo->offset + copyOffset, copySize});
+
+                    if (ownershipTransfer)
+                    {
+                        VkBufferMemoryBarrier barrier = {};
+                        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+                        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                        barrier.dstAccessMask = 0;
+                        barrier.srcQueueFamilyIndex = transferQueue->queueFamilyIndex();
+                        barrier.dstQueueFamilyIndex = consumerQueue->queueFamilyIndex();
+                        barrier.buffer = buffer->vk(deviceID);
+                        barrier.offset = bufferInfo->offset + copyOffset;
+                        barrier.size = copySize;
+                        frame.bufferBarriers.push_back(barrier);
+                    }
 
                     log(level, "       copying ", bufferInfo, ", ", bufferInfo->data, " to ", (void*)ptr);
 
-                    VkDeviceSize endOfEntry = offset + bufferInfo->range;
+                    _transferredThisFrame += copySize;
+
+                    VkDeviceSize endOfEntry = offset + copySize;
                     offset = (/*alignment == 1 ||*/ (endOfEntry % alignment) == 0) ? endOfEntry : ((endOfEntry / alignment) + 1) * alignment;
                 }
-                ++bufferInfo_itr;
             }
+            ++bufferInfo_itr;
         }
+    }
 
-        if (regionCount > 0)
-        {
-            auto& buffer = buffer_itr->first;
-
-            vkCmdCopyBuffer(vk_commandBuffer, staging->vk(deviceID), buffer->vk(deviceID), regionCount, pRegions);
-
-            log(level, "   vkCmdCopyBuffer(", ", ", staging->vk(deviceID), ", ", buffer->vk(deviceID), ", ", regionCount, ", ", pRegions);
+    uint32_t regionCount = static_cast<uint32_t>(copyRegions.size() - firstRegion);
+    if (regionCount > 0)
+    {
+        const VkBufferCopy* pRegions = copyRegions.data() + firstRegion;
+        vkCmdCopyBuffer(vk_commandBuffer, staging->vk(deviceID), buffer->vk(deviceID), regionCount, pRegions);
 
-            // advance to next buffer
-            pRegions += regionCount;
-        }
+        log(level, "   vkCmdCopyBuffer(", ", ", staging->vk(deviceID), ", ", buffer->vk(deviceID), ", ", regionCount, ", ", pRegions);
+    }
 
-        if (bufferInfos.empty())
-        {
-            log(level, "bufferInfos.empty()");
-            buffer_itr = _dynamicDataMap.erase(buffer_itr);
-        }
-        else
-        {
-            ++buffer_itr;
-        }
+    if (bufferInfos.empty())
+    {
+        log(level, "bufferInfos.empty()");
+        return _dynamicDataMap.erase(buffer_itr);
     }
+
+    return ++buffer_itr;
 }
 
 void TransferTask::assign(const ImageInfoList& imageInfoList)
@@ -205,6 +267,9 @@ void TransferTask::assign(const ImageInfoList& imageInfoList)
         auto targetTraits = getFormatTraits(targetFormat);
         VkDeviceSize imageTotalSize = targetTraits.size * data->valueCount();
 
+        // allow for the 16 byte alignment of each band of rows when only rows of the image are transferred
+        imageTotalSize += 16 * (Data::maxModifiedRanges + 1);
+
         VkDeviceSize endOfEntry = offset + imageTotalSize;
         offset = (/*alignment == 1 ||*/ (endOfEntry % alignment) == 0) ? endOfEntry : ((endOfEntry / alignment) + 1) * alignment;
     }
@@ -213,7 +278,7 @@ void TransferTask::assign(const ImageInfoList& imageInfoList)
     log(level, "    _dynamicImageTotalSize = ", _dynamicImageTotalSize);
 }
 
-void TransferTask::_transferImageInfos(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset)
+void TransferTask::_transferImageInfos(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset, VkCommandBuffer vk_acquireCommandBuffer, VkDeviceSize& acquireOffset)
 {
     CPU_INSTRUMENTATION_L1(instrumentation);
 
@@ -221,37 +286,97 @@ void TransferTask::_transferImageInfos(VkCommandBuffer vk_commandBuffer, Frame&
     //level = Logger::LOGGER_INFO;
 
     auto deviceID = device->deviceID;
+    bool ownershipTransfer = requiresOwnershipTransfer();
+
+    frame.imageBarriers.clear();
+
+    // row copies are only used for single level 2D images whose data can be copied directly into the image
+    auto rowCopyCompatible = [&](ImageInfo& imageInfo) {
+        auto& data = imageInfo.imageView->image->data;
+        auto& properties = data->properties;
+        if (data->depth() != 1 || !data->contiguous() || properties.blockWidth != 1 || properties.blockHeight != 1) return false;
+        if (vsg::computeNumMipMapLevels(data, imageInfo.sampler) != 1) return false;
+        return properties.format == imageInfo.imageView->format || getFormatTraits(properties.format).size == getFormatTraits(imageInfo.imageView->format).size;
+    };
+
+    Data::ModifiedRanges modifiedRanges;
+    auto transfer = [&](ImageInfo& imageInfo) {
+        auto& data = imageInfo.imageView->image->data;
+        auto targetTraits = getFormatTraits(imageInfo.imageView->format);
+        VkDeviceSize imageTotalSize = std::max(VkDeviceSize(targetTraits.size * data->valueCount()), VkDeviceSize(data->dataSize()));
+
+        if (imageInfo.requiresCopy(deviceID) && !_withinBudget(imageTotalSize))
+        {
+            // leave the modified count unsynced so the ImageInfo is transferred on a later frame
+            if (!_resumeImageInfo) _resumeImageInfo = &imageInfo;
+            return;
+        }
 
-    // transfer any modified ImageInfo
-    for (auto imageInfo_itr = _dynamicImageInfoSet.begin(); imageInfo_itr != _dynamicImageInfoSet.end();)
-    {
+        if (!imageInfo.syncModifiedCounts(deviceID, modifiedRanges)) return;
+
+        if (!ownershipTransfer && !modifiedRanges.empty() && rowCopyCompatible(imageInfo))
+        {
+            // only rows of the image have been dirtied so just copy those rows
+            _transferImageRows(vk_commandBuffer, frame.staging, frame.buffer_data, offset, imageInfo, modifiedRanges);
+            return;
+        }
+
+        _transferredThisFrame += imageTotalSize;
+
+        if (!ownershipTransfer)
+        {
+            _transferImageInfo(vk_commandBuffer, frame.staging, frame.buffer_data, offset, imageInfo, nullptr);
+        }
+        else if (vsg::computeNumMipMapLevels(data, imageInfo.sampler) > 1 && data->computeMipmapOffsets().size() <= 1)
+        {
+            // generating mipmaps requires vkCmdBlitImage which isn't supported by transfer only queues, so transfer these images on the consumer queue
+            _transferImageInfo(vk_acquireCommandBuffer, frame.acquireStaging, frame.acquire_buffer_data, acquireOffset, imageInfo, nullptr);
+        }
+        else
+        {
+            _transferImageInfo(vk_commandBuffer, frame.staging, frame.buffer_data, offset, imageInfo, &frame.imageBarriers);
+        }
+    };
+
+    // start from the first image that couldn't be transferred within the previous frame's budget
+    auto resumeImageInfo = _resumeImageInfo;
+    _resumeImageInfo = {};
+
+    auto process = [&](std::set<ref_ptr<ImageInfo>>::iterator imageInfo_itr) {
         auto& imageInfo = *imageInfo_itr;
         if (imageInfo->referenceCount() == 1)
         {
             log(level, "ImageInfo only ref left ", imageInfo, ", ", imageInfo->referenceCount());
-            imageInfo_itr = _dynamicImageInfoSet.erase(imageInfo_itr);
+            return _dynamicImageInfoSet.erase(imageInfo_itr);
         }
-        else
-        {
-            if (imageInfo->syncModifiedCounts(deviceID))
-            {
-                _transferImageInfo(vk_commandBuffer, frame, offset, *imageInfo);
-            }
 
-            ++imageInfo_itr;
+        transfer(*imageInfo);
+        return ++imageInfo_itr;
+    };
+
+    auto imageInfo_itr = resumeImageInfo ? _dynamicImageInfoSet.lower_bound(resumeImageInfo) : _dynamicImageInfoSet.begin();
+    while (imageInfo_itr != _dynamicImageInfoSet.end())
+    {
+        imageInfo_itr = process(imageInfo_itr);
+    }
+
+    if (resumeImageInfo)
+    {
+        auto end_itr = _dynamicImageInfoSet.lower_bound(resumeImageInfo);
+        for (imageInfo_itr = _dynamicImageInfoSet.begin(); imageInfo_itr != end_itr;)
+        {
+            imageInfo_itr = process(imageInfo_itr);
         }
     }
 }
 
-void TransferTask::_transferImageInfo(VkCommandBuffer vk_commandBuffer, Frame& frame, VkDeviceSize& offset, ImageInfo& imageInfo)
+void TransferTask::_transferImageInfo(VkCommandBuffer vk_commandBuffer, ref_ptr<Buffer> imageStagingBuffer, void* buffer_data, VkDeviceSize& offset, ImageInfo& imageInfo, std::vector<VkImageMemoryBarrier>* releaseBarriers)
 {
     CPU_INSTRUMENTATION_L1(instrumentation);
 
     Logger::Level level = Logger::LOGGER_DEBUG;
     //level = Logger::LOGGER_INFO;
 
-    auto& imageStagingBuffer = frame.staging;
-    auto& buffer_data = frame.buffer_data;
     char* ptr = reinterpret_cast<char*>(buffer_data) + offset;
 
     auto& data = imageInfo.imageView->image->data;
@@ -301,32 +426,191 @@ void TransferTask::_transferImageInfo(VkCommandBuffer vk_commandBuffer, Frame& f
 
             offset += imageTotalSize;
 
-            // copy data
-            using value_type = uint8_t;
-            const value_type* src_ptr = reinterpret_cast<const value_type*>(data->dataPointer());
+            copyPixels(data->dataPointer(), bytesFromSource, ptr, bytesToTarget, data->valueCount(), default_ptr);
+        }
+    }
 
-            value_type* dest_ptr = reinterpret_cast<value_type*>(ptr);
+    // transfer data.
+    if (releaseBarriers)
+    {
+        // release ownership to the consumer queue family, the matching acquire barrier is recorded in the acquire command buffer
+        auto barrier = transferImageData(imageInfo.imageView, imageInfo.imageLayout, properties, width, height, depth, mipLevels, mipmapOffsets, imageStagingBuffer, source_offset, vk_commandBuffer, device,
+                                         transferQueue->queueFamilyIndex(), consumerQueue->queueFamilyIndex());
+        releaseBarriers->push_back(barrier);
+    }
+    else
+    {
+        transferImageData(imageInfo.imageView, imageInfo.imageLayout, properties, width, height, depth, mipLevels, mipmapOffsets, imageStagingBuffer, source_offset, vk_commandBuffer, device);
+    }
+}
 
-            size_t valueCount = data->valueCount();
-            for (size_t i = 0; i < valueCount; ++i)
-            {
-                uint32_t s = 0;
-                for (; s < bytesFromSource; ++s)
-                {
-                    (*dest_ptr++) = *(src_ptr++);
-                }
+void TransferTask::_transferImageRows(VkCommandBuffer vk_commandBuffer, ref_ptr<Buffer> imageStagingBuffer, void* buffer_data, VkDeviceSize& offset, ImageInfo& imageInfo, const Data::ModifiedRanges& ranges)
+{
+    CPU_INSTRUMENTATION_L1(instrumentation);
 
-                const value_type* src_default = default_ptr;
-                for (; s < bytesToTarget; ++s)
-                {
-                    (*dest_ptr++) = *(src_default++);
-                }
-            }
+    uint32_t deviceID = device->deviceID;
+    auto& imageView = imageInfo.imageView;
+    auto& data = imageView->image->data;
+    VkImage vk_image = imageView->image->vk(deviceID);
+
+    uint32_t width = data->width();
+    uint32_t height = data->height();
+    size_t rowSize = size_t(width) * data->stride();
+    if (rowSize == 0) return;
+
+    // convert the modified byte ranges into bands of rows, merging bands that touch
+    std::vector<std::pair<uint32_t, uint32_t>> bands;
+    for (auto& [rangeOffset, rangeSize] : ranges)
+    {
+        uint32_t firstRow = static_cast<uint32_t>(rangeOffset / rowSize);
+        uint32_t endRow = std::min(height, static_cast<uint32_t>((rangeOffset + rangeSize + rowSize - 1) / rowSize));
+        if (firstRow >= endRow) continue;
+
+        if (!bands.empty() && firstRow <= bands.back().second)
+            bands.back().second = std::max(bands.back().second, endRow);
+        else
+            bands.emplace_back(firstRow, endRow);
+    }
+    if (bands.empty()) return;
+
+    // staging offsets for vkCmdCopyBufferToImage must be a multiple of the texel size and 4
+    offset = ((offset + 15) / 16) * 16;
+
+    VkImageSubresourceRange subresourceRange = {imageView->subresourceRange.aspectMask, 0, 1, 0, 1};
+    VkImageLayout finalLayout = imageInfo.imageLayout;
+
+    std::vector<VkBufferImageCopy> copyRegions;
+    for (auto& [firstRow, endRow] : bands)
+    {
+        size_t bandSize = rowSize * (endRow - firstRow);
+        std::memcpy(reinterpret_cast<char*>(buffer_data) + offset, reinterpret_cast<const char*>(data->dataPointer()) + rowSize * firstRow, bandSize);
+
+        VkBufferImageCopy copyRegion = {};
+        copyRegion.bufferOffset = offset;
+        copyRegion.bufferRowLength = 0;
+        copyRegion.bufferImageHeight = 0;
+        copyRegion.imageSubresource = {subresourceRange.aspectMask, 0, 0, 1};
+        copyRegion.imageOffset = VkOffset3D{0, static_cast<int32_t>(firstRow), 0};
+        copyRegion.imageExtent = VkExtent3D{width, endRow - firstRow, 1};
+        copyRegions.push_back(copyRegion);
+
+        offset = ((offset + bandSize + 15) / 16) * 16;
+        _transferredThisFrame += bandSize;
+    }
+
+    VkImageMemoryBarrier preCopyBarrier = {};
+    preCopyBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    preCopyBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    preCopyBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    preCopyBarrier.oldLayout = finalLayout;
+    preCopyBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    preCopyBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    preCopyBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    preCopyBarrier.image = vk_image;
+    preCopyBarrier.subresourceRange = subresourceRange;
+
+    vkCmdPipelineBarrier(vk_commandBuffer,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, nullptr,
+                         0, nullptr,
+                         1, &preCopyBarrier);
+
+    vkCmdCopyBufferToImage(vk_commandBuffer, imageStagingBuffer->vk(deviceID), vk_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+
+    VkImageMemoryBarrier postCopyBarrier = preCopyBarrier;
+    postCopyBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    postCopyBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    postCopyBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    postCopyBarrier.newLayout = finalLayout;
+
+    vkCmdPipelineBarrier(vk_commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                         0, nullptr,
+                         0, nullptr,
+                         1, &postCopyBarrier);
+}
+
+void TransferTask::_transferImageRegions(VkCommandBuffer vk_commandBuffer, ref_ptr<Buffer> imageStagingBuffer, void* buffer_data, VkDeviceSize& offset, std::vector<ImageRegion>& imageRegions)
+{
+    CPU_INSTRUMENTATION_L1(instrumentation);
+
+    uint32_t deviceID = device->deviceID;
+    std::vector<ImageRegion> deferredRegions;
+
+    for (auto& region : imageRegions)
+    {
+        auto& imageView = region.imageInfo->imageView;
+        VkImage vk_image = imageView->image->vk(deviceID);
+        VkDeviceSize dataSize = region.data->dataSize();
+
+        // images that haven't been compiled yet, or regions that don't fit in this frame's budget, are retained for a later frame
+        if (vk_image == VK_NULL_HANDLE || !_withinBudget(dataSize))
+        {
+            deferredRegions.push_back(region);
+            continue;
         }
+
+        // staging offsets for vkCmdCopyBufferToImage must be a multiple of the texel size and 4
+        offset = ((offset + 15) / 16) * 16;
+
+        std::memcpy(reinterpret_cast<char*>(buffer_data) + offset, region.data->dataPointer(), dataSize);
+
+        VkImageSubresourceRange subresourceRange = {imageView->subresourceRange.aspectMask, region.mipLevel, 1, region.arrayLayer, 1};
+        VkImageLayout finalLayout = region.imageInfo->imageLayout;
+
+        VkImageMemoryBarrier preCopyBarrier = {};
+        preCopyBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        preCopyBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        preCopyBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        preCopyBarrier.oldLayout = finalLayout;
+        preCopyBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        preCopyBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        preCopyBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        preCopyBarrier.image = vk_image;
+        preCopyBarrier.subresourceRange = subresourceRange;
+
+        // wait on prior reads of the image on this queue so regions being reused aren't overwritten while still being rendered
+        vkCmdPipelineBarrier(vk_commandBuffer,
+                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                             0, nullptr,
+                             0, nullptr,
+                             1, &preCopyBarrier);
+
+        VkBufferImageCopy copyRegion = {};
+        copyRegion.bufferOffset = offset;
+        copyRegion.bufferRowLength = 0;
+        copyRegion.bufferImageHeight = 0;
+        copyRegion.imageSubresource = {subresourceRange.aspectMask, region.mipLevel, region.arrayLayer, 1};
+        copyRegion.imageOffset = region.imageOffset;
+        copyRegion.imageExtent = region.extent;
+
+        vkCmdCopyBufferToImage(vk_commandBuffer, imageStagingBuffer->vk(deviceID), vk_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+
+        VkImageMemoryBarrier postCopyBarrier = preCopyBarrier;
+        postCopyBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        postCopyBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        postCopyBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        postCopyBarrier.newLayout = finalLayout;
+
+        vkCmdPipelineBarrier(vk_commandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                             0, nullptr,
+                             0, nullptr,
+                             1, &postCopyBarrier);
+
+        offset += dataSize;
+        _transferredThisFrame += dataSize;
     }
 
-    // transfer data.
-    transferImageData(imageInfo.imageView, imageInfo.imageLayout, properties, width, height, depth, mipLevels, mipmapOffsets, imageStagingBuffer, source_offset, vk_commandBuffer, device);
+    if (!deferredRegions.empty())
+    {
+        std::scoped_lock lock(_imageRegionsMutex);
+        for (auto& region : deferredRegions)
+        {
+            _imageRegionsTotalSize += region.data->dataSize() + 16;
+        }
+        _imageRegions.insert(_imageRegions.begin(), deferredRegions.begin(), deferredRegions.end());
+    }
 }
 
 VkResult TransferTask::transferDynamicData()
@@ -336,10 +620,23 @@ VkResult TransferTask::transferDynamicData()
     Logger::Level level = Logger::LOGGER_DEBUG;
     //level = Logger::LOGGER_INFO;
 
+    currentAcquireCommandBuffer = {};
+    _transferredThisFrame = 0;
+
     size_t frameIndex = index(0);
     if (frameIndex > _frames.size()) return VK_SUCCESS;
 
-    VkDeviceSize totalSize = _dynamicDataTotalSize + _dynamicImageTotalSize;
+    // take the image regions queued by transfer(..) since the previous frame
+    std::vector<ImageRegion> imageRegions;
+    VkDeviceSize imageRegionsSize = 0;
+    {
+        std::scoped_lock lock(_imageRegionsMutex);
+        imageRegions.swap(_imageRegions);
+        imageRegionsSize = _imageRegionsTotalSize;
+        _imageRegionsTotalSize = 0;
+    }
+
+    VkDeviceSize totalSize = _dynamicDataTotalSize + _dynamicImageTotalSize + imageRegionsSize;
     if (totalSize == 0) return VK_SUCCESS;
 
     uint32_t deviceID = device->deviceID;
@@ -365,6 +662,21 @@ VkResult TransferTask::transferDynamicData()
         commandBuffer->reset();
     }
 
+    bool ownershipTransfer = requiresOwnershipTransfer();
+    auto& acquireCommandBuffer = frame.acquireCommandBuffer;
+    if (ownershipTransfer)
+    {
+        if (!acquireCommandBuffer)
+        {
+            auto cp = CommandPool::create(device, consumerQueue->queueFamilyIndex());
+            acquireCommandBuffer = cp->allocate(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        }
+        else
+        {
+            acquireCommandBuffer->reset();
+        }
+    }
+
     if (!semaphore)
     {
         // signal transfer submission has completed
@@ -385,6 +697,20 @@ VkResult TransferTask::transferDynamicData()
         if (result != VK_SUCCESS) return result;
     }
 
+    // images that are transferred on the consumer queue use their own staging buffer so that each staging buffer is only accessed by one queue family
+    auto& acquireStaging = frame.acquireStaging;
+    VkDeviceSize acquireSize = _dynamicImageTotalSize + imageRegionsSize;
+    if (ownershipTransfer && acquireSize > 0 && (!acquireStaging || acquireStaging->size < acquireSize))
+    {
+        VkMemoryPropertyFlags stagingMemoryPropertiesFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        acquireStaging = vsg::createBufferAndMemory(device, acquireSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE, stagingMemoryPropertiesFlags);
+
+        auto stagingMemory = acquireStaging->getDeviceMemory(deviceID);
+        frame.acquire_buffer_data = nullptr;
+        result = stagingMemory->map(acquireStaging->getMemoryOffset(deviceID), acquireStaging->size, 0, &frame.acquire_buffer_data);
+        if (result != VK_SUCCESS) return result;
+    }
+
     log(level, "   totalSize = ", totalSize);
 
     VkCommandBufferBeginInfo beginInfo = {};
@@ -395,19 +721,78 @@ VkResult TransferTask::transferDynamicData()
     VkCommandBuffer vk_commandBuffer = *commandBuffer;
     vkBeginCommandBuffer(vk_commandBuffer, &beginInfo);
 
+    VkCommandBuffer vk_acquireCommandBuffer = VK_NULL_HANDLE;
+    if (ownershipTransfer)
+    {
+        vk_acquireCommandBuffer = *acquireCommandBuffer;
+        vkBeginCommandBuffer(vk_acquireCommandBuffer, &beginInfo);
+    }
+
     VkDeviceSize offset = 0;
+    VkDeviceSize acquireOffset = 0;
     {
         COMMAND_BUFFER_INSTRUMENTATION(instrumentation, *commandBuffer, "transferDynamicData", COLOR_GPU)
 
         // transfer the modified BufferInfo and ImageInfo
         _transferBufferInfos(vk_commandBuffer, frame, offset);
-        _transferImageInfos(vk_commandBuffer, frame, offset);
+        _transferImageInfos(vk_commandBuffer, frame, offset, vk_acquireCommandBuffer, acquireOffset);
+
+        if (!imageRegions.empty())
+        {
+            // image regions are copied on the queue family that owns the image, so when transferring ownership they are recorded into the acquire command buffer
+            if (ownershipTransfer)
+                _transferImageRegions(vk_acquireCommandBuffer, acquireStaging, frame.acquire_buffer_data, acquireOffset, imageRegions);
+            else
+                _transferImageRegions(vk_commandBuffer, staging, buffer_data, offset, imageRegions);
+        }
+
+        if (!frame.bufferBarriers.empty())
+        {
+            // release ownership of the copied buffer regions to the consumer queue family
+            vkCmdPipelineBarrier(vk_commandBuffer,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                                 0, nullptr,
+                                 static_cast<uint32_t>(frame.bufferBarriers.size()), frame.bufferBarriers.data(),
+                                 0, nullptr);
+        }
     }
 
     vkEndCommandBuffer(vk_commandBuffer);
 
+    bool acquireRecorded = false;
+    if (ownershipTransfer)
+    {
+        // acquire ownership on the consumer queue family using barriers that match the release barriers
+        for (auto& barrier : frame.bufferBarriers)
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        }
+
+        for (auto& barrier : frame.imageBarriers)
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        }
+
+        if (!frame.bufferBarriers.empty() || !frame.imageBarriers.empty())
+        {
+            vkCmdPipelineBarrier(vk_acquireCommandBuffer,
+                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                                 0, nullptr,
+                                 static_cast<uint32_t>(frame.bufferBarriers.size()), frame.bufferBarriers.data(),
+                                 static_cast<uint32_t>(frame.imageBarriers.size()), frame.imageBarriers.data());
+        }
+
+        vkEndCommandBuffer(vk_acquireCommandBuffer);
+
+        acquireRecorded = acquireOffset > 0 || !frame.bufferBarriers.empty() || !frame.imageBarriers.empty();
+    }
+
+    if (workloadRecorder && offset > 0) workloadRecorder->dynamicData(offset);
+
     // if no regions to copy have been found then commandBuffer will be empty so no need to submit it to queue and signal the associated semaphore
-    if (offset > 0)
+    if (offset > 0 || acquireRecorded)
     {
         // submit the transfer commands
         VkSubmitInfo submitInfo = {};
@@ -436,9 +821,10 @@ VkResult TransferTask::transferDynamicData()
             submitInfo.pWaitDstStageMask = vk_waitStages.data();
         }
 
-        // set up the vulkan signal sempahore
+        // set up the vulkan signal sempahore, when the transferQueue has a timeline it's signalled in place of the per frame semaphore
+        auto& timeline = transferQueue->timeline;
         std::vector<VkSemaphore> vk_signalSemaphores;
-        vk_signalSemaphores.push_back(*semaphore);
+        if (!timeline) vk_signalSemaphores.push_back(*semaphore);
         for (auto& ss : signalSemaphores)
         {
             vk_signalSemaphores.push_back(*ss);
@@ -450,19 +836,35 @@ VkResult TransferTask::transferDynamicData()
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = &vk_commandBuffer;
 
-        result = transferQueue->submit(submitInfo);
+        uint64_t signalValue = 0;
+        if (timeline)
+            result = transferQueue->submit(submitInfo, waitValues, signalValue);
+        else
+            result = transferQueue->submit(submitInfo);
 
         waitSemaphores.clear();
+        waitValues.clear();
 
         if (result != VK_SUCCESS) return result;
 
-        currentTransferCompletedSemaphore = semaphore;
+        if (timeline)
+        {
+            currentTransferCompletedSemaphore = timeline;
+            currentTransferCompletedValue = signalValue;
+        }
+        else
+        {
+            currentTransferCompletedSemaphore = semaphore;
+            currentTransferCompletedValue = 0;
+        }
+        if (acquireRecorded) currentAcquireCommandBuffer = acquireCommandBuffer;
     }
     else
     {
         log(level, "Nothing to submit");
 
         waitSemaphores.clear();
+        waitValues.clear();
     }
 
     return VK_SUCCESS;
@@ -10,7 +10,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/app/DepthPrePass.h>
+#include <vsg/app/OcclusionCulling.h>
+#include <vsg/app/SharedCull.h>
 #include <vsg/app/View.h>
+#include <vsg/app/VisibilityCache.h>
 #include <vsg/io/Options.h>
 #include <vsg/nodes/Bin.h>
 #include <vsg/state/ViewDependentState.h>
@@ -78,7 +82,10 @@ View::View(const View& view) :
     Inherit(view),
     viewID(sharedViewID(view.viewID)),
     features(view.features),
-    mask(view.mask)
+    mask(view.mask),
+    minimumFeatureSize(view.minimumFeatureSize),
+    lodBias(view.lodBias),
+    requestLodBias(view.requestLodBias)
 {
     if (view.camera && view.camera->viewportState)
     {
@@ -11,12 +11,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/app/CompileTraversal.h>
+#include <vsg/app/ComputeCommandGraph.h>
 #include <vsg/app/View.h>
 #include <vsg/app/Viewer.h>
 #include <vsg/io/Logger.h>
 #include <vsg/nodes/StateGroup.h>
 #include <vsg/state/Descriptor.h>
 
+#include <algorithm>
 #include <chrono>
 #include <map>
 #include <set>
@@ -30,6 +32,7 @@ using namespace vsg;
 Viewer::Viewer() :
     updateOperations(UpdateOperations::create()),
     status(vsg::ActivityStatus::create()),
+    frameStatistics(FrameStatistics::create()),
     _start_point(clock::now())
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer costructor", COLOR_VIEWER);
@@ -43,6 +46,20 @@ Viewer::~Viewer()
 
     // don't destroy viewer while devices are still active
     Viewer::deviceWaitIdle();
+
+    _stopDeleteThread();
+    if (deleteQueue) deleteQueue->clear();
+}
+
+void Viewer::_stopDeleteThread()
+{
+    if (!_deleteThread.joinable()) return;
+
+    // the delete thread waits on the deleteQueue's own ActivityStatus so needs to be released to see its status has changed
+    _deleteThreadStatus->set(false);
+    _deleteThreadQueue->release();
+    _deleteThread.join();
+    _deleteThreadQueue = {};
 }
 
 void Viewer::deviceWaitIdle() const
@@ -116,7 +133,7 @@ bool Viewer::active() const
     bool viewerIsActive = !_close;
     if (viewerIsActive)
     {
-        for (auto window : _windows)
+        for (auto& window : _windows)
         {
             if (!window->valid()) viewerIsActive = false;
         }
@@ -149,19 +166,65 @@ bool Viewer::pollEvents(bool discardPreviousEvents)
     return result;
 }
 
+bool Viewer::waitEvents(double timeout, bool discardPreviousEvents)
+{
+    CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer waitEvents", COLOR_UPDATE);
+
+    if (discardPreviousEvents) _events.clear();
+    if (_windows.empty()) return false;
+
+    if (_windows.size() == 1) return _windows.front()->waitEvents(_events, timeout);
+
+    // a thread can only block on one window's event queue, so wait on the first for short intervals and poll the others in between
+    const double interval = 0.01;
+    auto start = clock::now();
+    while (true)
+    {
+        double remaining = timeout < 0.0 ? interval : timeout - std::chrono::duration<double>(clock::now() - start).count();
+        bool result = _windows.front()->waitEvents(_events, std::max(0.0, std::min(interval, remaining)));
+        for (size_t i = 1; i < _windows.size(); ++i)
+        {
+            if (_windows[i]->pollEvents(_events)) result = true;
+        }
+
+        if (result || _wakeRequested.exchange(false) || (timeout >= 0.0 && remaining <= interval)) return result;
+    }
+}
+
+void Viewer::wakeEvents()
+{
+    _wakeRequested = true;
+    for (auto& window : _windows)
+    {
+        window->wakeEvents();
+    }
+}
+
 bool Viewer::advanceToNextFrame()
 {
     static constexpr SourceLocation s_frame_source_location{"Viewer advanceToNextFrame", VsgFunctionName, __FILE__, __LINE__, COLOR_VIEWER, 1};
     uint64_t reference = 0;
 
+    // finish the previous pipelined frame before checking the viewer and devices are still active
+    completeFrame();
+
     if (!active()) return false;
 
     // signal to instrumentation the end of the previous frame
     if (instrumentation && _frameStamp) instrumentation->leaveFrame(&s_frame_source_location, reference, *_frameStamp);
 
+    // wait until just before the frame is needed so that events are polled as late as possible
+    if (framePacer) framePacer->wait(*this);
+
+    // limit the frames in flight and adapt the swapchain to the measured workload
+    if (swapchainTuner) swapchainTuner->update(*this);
+
     // poll all the windows for events.
     pollEvents(true);
 
+    // wait until a frame is needed, accumulating events while waiting
+    if (powerManager && !powerManager->wait(*this)) return false;
+
     if (!acquireNextFrame()) return false;
 
     // create FrameStamp for frame
@@ -173,10 +236,14 @@ bool Viewer::advanceToNextFrame()
     }
     else
     {
+        if (frameStatistics) frameStatistics->stage(FrameStatistics::FRAME).add(std::chrono::duration<double, std::milli>(time - _frameStamp->time).count());
+
         // after first frame so increment frame count and indices
         _frameStamp = FrameStamp::create(time, _frameStamp->frameCount + 1);
     }
 
+    if (frameStatistics) frameStatistics->advanceCounters(_frameStamp->frameCount);
+
     for (auto& task : recordAndSubmitTasks)
     {
         task->advance();
@@ -195,6 +262,8 @@ bool Viewer::acquireNextFrame()
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer acquireNextFrame", COLOR_VIEWER);
 
+    ScopedTiming timing(frameStatistics ? &frameStatistics->stage(FrameStatistics::ACQUIRE) : nullptr);
+
     if (_close) return false;
 
     VkResult result = VK_SUCCESS;
@@ -252,6 +321,8 @@ void Viewer::handleEvents()
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer handle events", COLOR_UPDATE);
 
+    ScopedTiming timing(frameStatistics ? &frameStatistics->stage(FrameStatistics::EVENTS) : nullptr);
+
     for (auto& vsg_event : _events)
     {
         for (auto& handler : _eventHandlers)
@@ -313,6 +384,7 @@ void Viewer::compile(ref_ptr<ResourceHints> hints)
         auto queueFamily = physicalDevice->getQueueFamily(VK_QUEUE_GRAPHICS_BIT); // TODO : could we just use transfer bit?
 
         deviceResources.compile = CompileTraversal::create(device, resourceRequirements);
+        for (auto& pipelineCache : pipelineCaches) deviceResources.compile->assignPipelineCache(pipelineCache);
 
         for (auto& context : deviceResources.compile->contexts)
         {
@@ -390,7 +462,12 @@ void Viewer::compile(ref_ptr<ResourceHints> hints)
     }
 
     // set up the CompileManager
-    if (!compileManager) compileManager = CompileManager::create(*this, hints);
+    if (!compileManager)
+    {
+        compileManager = CompileManager::create(*this, hints);
+        for (auto& pipelineCache : pipelineCaches) compileManager->assignPipelineCache(pipelineCache);
+        if (jobSystem) compileManager->assignOperationThreads(jobSystem);
+    }
 
     // assign CompileManager to DatabasePager
     if (databasePager && !databasePager->compileManager)
@@ -398,6 +475,12 @@ void Viewer::compile(ref_ptr<ResourceHints> hints)
         databasePager->compileManager = compileManager;
     }
 
+    // share the JobSystem with the DatabasePager
+    if (databasePager && jobSystem && !databasePager->operationThreads)
+    {
+        databasePager->operationThreads = jobSystem;
+    }
+
     // record any transfer commands
     for (auto& dp : deviceResourceMap)
     {
@@ -419,6 +502,24 @@ void Viewer::compile(ref_ptr<ResourceHints> hints)
         }
     }
 
+    // the DatabasePager's delete thread services its own deleteQueue, any other needs its own thread
+    if (deleteQueue && !_deleteThread.joinable() && !(databasePager && databasePager->deleteQueue == deleteQueue))
+    {
+        auto clear = [](ref_ptr<DeleteQueue> queue, ref_ptr<ActivityStatus> deleteThreadStatus, ref_ptr<Instrumentation> viewer_instrumentation) {
+            auto local_instrumentation = shareOrDuplicateForThreadSafety(viewer_instrumentation);
+            if (local_instrumentation) local_instrumentation->setThreadName("Viewer delete thread");
+
+            while (deleteThreadStatus->active())
+            {
+                queue->wait_then_clear();
+            }
+        };
+
+        _deleteThreadStatus = ActivityStatus::create();
+        _deleteThreadQueue = deleteQueue;
+        _deleteThread = std::thread(clear, deleteQueue, _deleteThreadStatus, instrumentation);
+    }
+
     auto end_tick = clock::now();
     auto compile_time = std::chrono::duration<double, std::chrono::milliseconds::period>(end_tick - start_tick).count();
     debug("Viewer::compile() ", compile_time, "ms");
@@ -519,16 +620,55 @@ void Viewer::assignRecordAndSubmitTaskAndPresentation(CommandGraphs in_commandGr
         // get an appropriate transfer queue
         ref_ptr<Queue> transferQueue = mainQueue;
 
-        VkQueueFlags transferQueueFlags = VK_QUEUE_TRANSFER_BIT | VK_QUEUE_GRAPHICS_BIT; // use VK_QUEUE_GRAPHICS_BIT to ensure we can blit images
-        for (auto& queue : device->getQueues())
+        // only use a non graphics transfer queue when one has been requested via WindowTraits::dedicatedTransferQueue,
+        // the TransferTask then transfers queue family ownership to the mainQueue.
+        bool dedicatedTransferQueue = false;
+        for (auto& window : _windows)
         {
-            if ((queue->queueFlags() & transferQueueFlags) == transferQueueFlags)
+            if (window->getDevice() == device && window->traits() && window->traits()->dedicatedTransferQueue) dedicatedTransferQueue = true;
+        }
+
+        if (dedicatedTransferQueue)
+        {
+            // don't share the queue families used by ComputeCommandGraphs, i.e. the WindowTraits::asyncComputeQueue
+            std::set<int> computeQueueFamilies;
+            for (auto& commandGraph : in_commandGraphs)
+            {
+                if (commandGraph->device == device && commandGraph->cast<ComputeCommandGraph>()) computeQueueFamilies.insert(commandGraph->queueFamily);
+            }
+
+            // prefer a transfer only queue, falling back to one that also supports compute
+            ref_ptr<Queue> computeCapableQueue;
+            for (auto& queue : device->getQueues())
             {
-                if (queue != mainQueue)
+                auto flags = queue->queueFlags();
+                if ((flags & VK_QUEUE_TRANSFER_BIT) == 0 || (flags & VK_QUEUE_GRAPHICS_BIT) != 0) continue;
+                if (computeQueueFamilies.count(static_cast<int>(queue->queueFamilyIndex())) != 0) continue;
+
+                if ((flags & VK_QUEUE_COMPUTE_BIT) == 0)
                 {
                     transferQueue = queue;
                     break;
                 }
+                if (!computeCapableQueue) computeCapableQueue = queue;
+            }
+
+            if (transferQueue == mainQueue && computeCapableQueue) transferQueue = computeCapableQueue;
+        }
+
+        if (transferQueue == mainQueue)
+        {
+            VkQueueFlags transferQueueFlags = VK_QUEUE_TRANSFER_BIT | VK_QUEUE_GRAPHICS_BIT; // use VK_QUEUE_GRAPHICS_BIT to ensure we can blit images
+            for (auto& queue : device->getQueues())
+            {
+                if ((queue->queueFlags() & transferQueueFlags) == transferQueueFlags)
+                {
+                    if (queue != mainQueue)
+                    {
+                        transferQueue = queue;
+                        break;
+                    }
+                }
             }
         }
 
@@ -555,10 +695,13 @@ void Viewer::assignRecordAndSubmitTaskAndPresentation(CommandGraphs in_commandGr
             recordAndSubmitTasks.emplace_back(recordAndSubmitTask);
 
             recordAndSubmitTask->earlyTransferTask->transferQueue = transferQueue;
+            recordAndSubmitTask->earlyTransferTask->consumerQueue = mainQueue;
             recordAndSubmitTask->lateTransferTask->transferQueue = transferQueue;
+            recordAndSubmitTask->lateTransferTask->consumerQueue = mainQueue;
 
             // assign instrumentation
             if (instrumentation) recordAndSubmitTask->assignInstrumentation(instrumentation);
+            if (frameStatistics) recordAndSubmitTask->assignFrameStatistics(frameStatistics);
 
             auto presentation = vsg::Presentation::create();
             presentation->waitSemaphores.emplace_back(renderFinishedSemaphore);
@@ -577,14 +720,112 @@ void Viewer::assignRecordAndSubmitTaskAndPresentation(CommandGraphs in_commandGr
             recordAndSubmitTasks.emplace_back(recordAndSubmitTask);
 
             recordAndSubmitTask->earlyTransferTask->transferQueue = transferQueue;
+            recordAndSubmitTask->earlyTransferTask->consumerQueue = mainQueue;
             recordAndSubmitTask->lateTransferTask->transferQueue = transferQueue;
+            recordAndSubmitTask->lateTransferTask->consumerQueue = mainQueue;
 
             // assign instrumentation
             if (instrumentation) recordAndSubmitTask->assignInstrumentation(instrumentation);
+            if (frameStatistics) recordAndSubmitTask->assignFrameStatistics(frameStatistics);
+        }
+    }
+
+    _assignComputeSynchronization();
+
+    if (needToStartThreading)
+        setupThreading();
+    else
+        _assignCommandPoolRings();
+}
+
+void Viewer::_assignComputeSynchronization()
+{
+    auto computeCommandGraph = [](const RecordAndSubmitTask& task) -> ComputeCommandGraph* {
+        if (task.commandGraphs.empty() || !task.windows.empty()) return nullptr;
+        for (auto& commandGraph : task.commandGraphs)
+        {
+            if (!commandGraph->cast<ComputeCommandGraph>()) return nullptr;
+        }
+        return task.commandGraphs.front()->cast<ComputeCommandGraph>();
+    };
+
+    RecordAndSubmitTasks computeTasks;
+    RecordAndSubmitTasks otherTasks;
+    for (auto& task : recordAndSubmitTasks)
+    {
+        if (computeCommandGraph(*task))
+            computeTasks.push_back(task);
+        else
+            otherTasks.push_back(task);
+    }
+
+    if (computeTasks.empty()) return;
+
+    for (auto& computeTask : computeTasks)
+    {
+        auto settings = computeCommandGraph(*computeTask);
+        for (auto& task : otherTasks)
+        {
+            if (task->device != computeTask->device) continue;
+
+            if (computeTask->queue->timeline && task->queue->timeline)
+            {
+                // timeline semaphores signalled with the frame count let each frame's graphics wait on that frame's compute,
+                // and the compute wait on the previous frame's graphics, without relying on the order the tasks are submitted.
+                auto computeCompleted = TimelineSemaphore::create(computeTask->device);
+                computeTask->signalFrameTimelines.push_back(computeCompleted);
+                task->waitFrameTimelines.push_back(RecordAndSubmitTask::FrameTimelineWait{computeCompleted, 0, settings->graphicsWaitStages});
+
+                if (settings->waitForPreviousFrame)
+                {
+                    auto graphicsCompleted = TimelineSemaphore::create(computeTask->device);
+                    task->signalFrameTimelines.push_back(graphicsCompleted);
+                    computeTask->waitFrameTimelines.push_back(RecordAndSubmitTask::FrameTimelineWait{graphicsCompleted, 1, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT});
+                }
+            }
+            else
+            {
+                // binary semaphores require the compute task to be submitted before the task waiting on it each frame,
+                // the tasks may be recorded on different threads so the waiting task's finish() holds its submission till the compute task has submitted.
+                auto computeCompleted = Semaphore::create(computeTask->device, settings->graphicsWaitStages);
+                computeTask->signalSemaphores.push_back(computeCompleted);
+                task->waitSemaphores.push_back(computeCompleted);
+                task->submitAfter.push_back(computeTask);
+            }
         }
     }
 
-    if (needToStartThreading) setupThreading();
+    // submit the compute tasks first so their work can start while the graphics tasks are still recording
+    recordAndSubmitTasks = computeTasks;
+    recordAndSubmitTasks.insert(recordAndSubmitTasks.end(), otherTasks.begin(), otherTasks.end());
+}
+
+void Viewer::_assignCommandPoolRings()
+{
+    if (!useCommandPoolRings) return;
+
+    // when single threaded all CommandGraphs are recorded on the main thread, when threading each task has its own thread,
+    // or a thread per CommandGraph when it has more than one
+    std::map<std::pair<const Device*, int>, ref_ptr<CommandPoolRing>> commandPoolRings;
+    for (auto& task : recordAndSubmitTasks)
+    {
+        if (_threading) commandPoolRings.clear();
+
+        bool threadPerCommandGraph = _threading && task->commandGraphs.size() > 1;
+        for (auto& commandGraph : task->commandGraphs)
+        {
+            if (threadPerCommandGraph)
+            {
+                commandGraph->commandPoolRing = CommandPoolRing::create(commandGraph->device, commandGraph->queueFamily);
+            }
+            else
+            {
+                auto& commandPoolRing = commandPoolRings[std::pair<const Device*, int>(commandGraph->device.get(), commandGraph->queueFamily)];
+                if (!commandPoolRing) commandPoolRing = CommandPoolRing::create(commandGraph->device, commandGraph->queueFamily);
+                commandGraph->commandPoolRing = commandPoolRing;
+            }
+        }
+    }
 }
 
 void Viewer::addRecordAndSubmitTaskAndPresentation(CommandGraphs commandGraphs)
@@ -633,16 +874,20 @@ void Viewer::setupThreading()
     _frameBlock = FrameBlock::create(status);
     _submissionCompleted = Barrier::create(1 + numValidTasks);
 
+    _assignCommandPoolRings();
+
     // set up required threads for each task
     for (auto& task : recordAndSubmitTasks)
     {
         if (task->commandGraphs.size() == 1 && !task->earlyTransferTask)
         {
             // task only contains a single CommandGraph so keep thread simple
-            auto run = [](ref_ptr<RecordAndSubmitTask> viewer_task, ref_ptr<FrameBlock> viewer_frameBlock, ref_ptr<Barrier> submissionCompleted, const std::string& threadName) {
+            auto run = [](ref_ptr<RecordAndSubmitTask> viewer_task, ref_ptr<FrameBlock> viewer_frameBlock, ref_ptr<Barrier> submissionCompleted, ref_ptr<DeleteQueue> viewer_deleteQueue, const std::string& threadName) {
                 auto local_instrumentation = shareOrDuplicateForThreadSafety(viewer_task->instrumentation);
                 if (local_instrumentation) local_instrumentation->setThreadName(threadName);
 
+                DeleteQueue::deferDeletesOnCurrentThread(viewer_deleteQueue);
+
                 auto frameStamp = viewer_frameBlock->initial_value;
 
                 // wait for this frame to be signaled
@@ -654,9 +899,11 @@ void Viewer::setupThreading()
 
                     submissionCompleted->arrive_and_drop();
                 }
+
+                DeleteQueue::deferDeletesOnCurrentThread({});
             };
 
-            threads.emplace_back(run, task, _frameBlock, _submissionCompleted, make_string("Viewer run thread"));
+            threads.emplace_back(run, task, _frameBlock, _submissionCompleted, deleteQueue, make_string("Viewer run thread"));
         }
         else if (!task->commandGraphs.empty())
         {
@@ -677,6 +924,7 @@ void Viewer::setupThreading()
                 ref_ptr<RecordAndSubmitTask> task;
                 ref_ptr<FrameBlock> frameBlock;
                 ref_ptr<Barrier> submissionCompletedBarrier;
+                ref_ptr<DeleteQueue> deleteQueue;
 
                 // shared between threads associated with each task
                 ref_ptr<RecordedCommandBuffers> recordedCommandBuffers;
@@ -688,11 +936,14 @@ void Viewer::setupThreading()
             if (task->earlyTransferTask) ++numThreads;
 
             ref_ptr<SharedData> sharedData = SharedData::create(task, _frameBlock, _submissionCompleted, numThreads);
+            sharedData->deleteQueue = deleteQueue;
 
             auto run_primary = [](ref_ptr<SharedData> data, ref_ptr<CommandGraph> commandGraph, const std::string& threadName) {
                 auto local_instrumentation = shareOrDuplicateForThreadSafety(data->task->instrumentation);
                 if (local_instrumentation) local_instrumentation->setThreadName(threadName);
 
+                DeleteQueue::deferDeletesOnCurrentThread(data->deleteQueue);
+
                 auto frameStamp = data->frameBlock->initial_value;
 
                 // wait for this frame to be signaled
@@ -718,12 +969,16 @@ void Viewer::setupThreading()
 
                     data->submissionCompletedBarrier->arrive_and_wait();
                 }
+
+                DeleteQueue::deferDeletesOnCurrentThread({});
             };
 
             auto run_secondary = [](ref_ptr<SharedData> data, ref_ptr<CommandGraph> commandGraph, const std::string& threadName) {
                 auto local_instrumentation = shareOrDuplicateForThreadSafety(data->task->instrumentation);
                 if (local_instrumentation) local_instrumentation->setThreadName(threadName);
 
+                DeleteQueue::deferDeletesOnCurrentThread(data->deleteQueue);
+
                 auto frameStamp = data->frameBlock->initial_value;
 
                 // wait for this frame to be signaled
@@ -737,12 +992,16 @@ void Viewer::setupThreading()
 
                     data->recordCompletedBarrier->arrive_and_wait();
                 }
+
+                DeleteQueue::deferDeletesOnCurrentThread({});
             };
 
             auto run_transfer = [](ref_ptr<SharedData> data, ref_ptr<TransferTask> transferTask, const std::string& threadName) {
                 auto local_instrumentation = shareOrDuplicateForThreadSafety(data->task->instrumentation);
                 if (local_instrumentation) local_instrumentation->setThreadName(threadName);
 
+                DeleteQueue::deferDeletesOnCurrentThread(data->deleteQueue);
+
                 auto frameStamp = data->frameBlock->initial_value;
 
                 // wait for this frame to be signaled
@@ -758,6 +1017,8 @@ void Viewer::setupThreading()
 
                     data->recordCompletedBarrier->arrive_and_wait();
                 }
+
+                DeleteQueue::deferDeletesOnCurrentThread({});
             };
 
             for (uint32_t i = 0; i < task->commandGraphs.size(); ++i)
@@ -781,6 +1042,10 @@ void Viewer::stopThreading()
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer stopThreading", COLOR_VIEWER);
 
     if (!_threading) return;
+
+    // the threads of a pipelined frame have to arrive at the submission barrier before they can exit
+    completeFrame();
+
     _threading = false;
 
     debug("Viewer::stopThreading()");
@@ -795,29 +1060,58 @@ void Viewer::stopThreading()
         if (thread.joinable()) thread.join();
     }
     threads.clear();
+
+    _assignCommandPoolRings();
 }
 
 void Viewer::update()
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer update", COLOR_UPDATE);
 
+    auto start = clock::now();
+    clock::duration mergeDuration{0};
+
+    if (deleteQueue) deleteQueue->advance(_frameStamp);
+
     for (auto& task : recordAndSubmitTasks)
     {
         if (task->databasePager)
         {
+            auto mergeStart = clock::now();
+
             CompileResult cr;
             task->databasePager->updateSceneGraph(_frameStamp, cr);
             if (cr.requiresViewerUpdate()) updateViewer(*this, cr);
+
+            mergeDuration += clock::now() - mergeStart;
         }
     }
 
     updateOperations->run();
+
+    // send the frame's changes to the slaves, or apply the master's changes, before recording
+    if (cluster && !cluster->update(*this))
+    {
+        warn("Viewer::update() cluster connection failed, closing viewer.");
+        close();
+    }
+
+    if (frameStatistics)
+    {
+        auto updateDuration = (clock::now() - start) - mergeDuration;
+        frameStatistics->stage(FrameStatistics::DATABASE_PAGER_MERGE).add(std::chrono::duration<double, std::milli>(mergeDuration).count());
+        frameStatistics->stage(FrameStatistics::UPDATE).add(std::chrono::duration<double, std::milli>(updateDuration).count());
+    }
 }
 
 void Viewer::recordAndSubmit()
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer recordAndSubmitTask", COLOR_VIEWER);
 
+    ScopedTiming timing(frameStatistics ? &frameStatistics->stage(FrameStatistics::RECORD_AND_SUBMIT) : nullptr);
+
+    if (workloadRecorder) workloadRecorder->frame(*_frameStamp);
+
     // reset connected ExecuteCommands
     for (auto& recordAndSubmitTask : recordAndSubmitTasks)
     {
@@ -837,21 +1131,49 @@ void Viewer::recordAndSubmit()
 #endif
     {
         _frameBlock->set(_frameStamp);
-        _submissionCompleted->arrive_and_wait();
+
+        if (pipelined)
+            _framePending = true;
+        else
+            _submissionCompleted->arrive_and_wait();
     }
     else
     {
+        DeleteQueue::deferDeletesOnCurrentThread(deleteQueue);
+
         for (auto& recordAndSubmitTask : recordAndSubmitTasks)
         {
             recordAndSubmitTask->submit(_frameStamp);
         }
+
+        DeleteQueue::deferDeletesOnCurrentThread({});
     }
 }
 
+void Viewer::completeFrame()
+{
+    if (!_framePending) return;
+
+    CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer completeFrame", COLOR_VIEWER);
+
+    _submissionCompleted->arrive_and_wait();
+    _framePending = false;
+
+    present();
+}
+
 void Viewer::present()
 {
     CPU_INSTRUMENTATION_L1_NC(instrumentation, "Viewer present", COLOR_VIEWER);
 
+    // a pipelined frame is presented once its submission has completed
+    if (_framePending) return;
+
+    ScopedTiming timing(frameStatistics ? &frameStatistics->stage(FrameStatistics::PRESENT) : nullptr);
+
+    // frame lock with the other nodes of the cluster, a failed connection is picked up by the next update()
+    if (cluster) cluster->swapBarrier();
+
     for (auto& presentation : presentations)
     {
         presentation->present();
@@ -879,6 +1201,56 @@ void Viewer::assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation)
     if (previous_threading) setupThreading();
 }
 
+void Viewer::assignFrameStatistics(ref_ptr<FrameStatistics> in_frameStatistics)
+{
+    bool previous_threading = _threading;
+    if (_threading) stopThreading();
+
+    frameStatistics = in_frameStatistics;
+
+    for (auto& task : recordAndSubmitTasks)
+    {
+        task->assignFrameStatistics(frameStatistics);
+    }
+
+    if (previous_threading) setupThreading();
+}
+
+void Viewer::assignWorkloadRecorder(ref_ptr<WorkloadRecorder> in_workloadRecorder)
+{
+    bool previous_threading = _threading;
+    if (_threading) stopThreading();
+
+    workloadRecorder = in_workloadRecorder;
+
+    for (auto& task : recordAndSubmitTasks)
+    {
+        if (task->databasePager) task->databasePager->workloadRecorder = workloadRecorder;
+        if (task->earlyTransferTask) task->earlyTransferTask->workloadRecorder = workloadRecorder;
+        if (task->lateTransferTask) task->lateTransferTask->workloadRecorder = workloadRecorder;
+    }
+
+    if (previous_threading) setupThreading();
+}
+
+void Viewer::assignPipelineCache(ref_ptr<PipelineCache> pipelineCache)
+{
+    if (!pipelineCache) return;
+
+    bool replaced = false;
+    for (auto& existing : pipelineCaches)
+    {
+        if (existing->getDevice() == pipelineCache->getDevice())
+        {
+            existing = pipelineCache;
+            replaced = true;
+        }
+    }
+    if (!replaced) pipelineCaches.push_back(pipelineCache);
+
+    if (compileManager) compileManager->assignPipelineCache(pipelineCache);
+}
+
 void vsg::updateViewer(Viewer& viewer, const CompileResult& compileResult)
 {
     CPU_INSTRUMENTATION_L1_NC(viewer.instrumentation, "updateViewer", COLOR_VIEWER);
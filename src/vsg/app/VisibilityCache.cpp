@@ -0,0 +1,105 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/VisibilityCache.h>
+#include <vsg/maths/transform.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vsg;
+
+VisibilityCache::VisibilityCache()
+{
+}
+
+VisibilityCache::~VisibilityCache()
+{
+}
+
+void VisibilityCache::beginFrame(const dmat4& projection, const dmat4& view, uint64_t frameCount)
+{
+    _numHits = 0;
+    _numInserted = 0;
+
+    auto inverseView = inverse(view);
+    dvec3 eye(inverseView[3][0], inverseView[3][1], inverseView[3][2]);
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    bool reset = !_referenceValid || projection != _referenceProjection || (frameCount - _referenceFrameCount) > maximumReferenceFrames;
+    if (!reset)
+    {
+        _translation = length(eye - _referenceEye);
+
+        // angle of the rotation from the reference camera's orientation to the current one, computed from the trace of their relative rotation
+        double trace = 0.0;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j) trace += view[j][i] * _referenceView[j][i];
+        }
+        _rotation = std::acos(std::clamp((trace - 1.0) * 0.5, -1.0, 1.0));
+
+        reset = _translation > maximumTranslation || _rotation > maximumRotation;
+    }
+
+    if (reset)
+    {
+        _entries.clear();
+        _referenceValid = true;
+        _referenceProjection = projection;
+        _referenceView = view;
+        _referenceEye = eye;
+        _referenceFrameCount = frameCount;
+        _translation = 0.0;
+        _rotation = 0.0;
+    }
+}
+
+bool VisibilityCache::inside(const Node* node)
+{
+    bool result = false;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        if (auto itr = _entries.find(node); itr != _entries.end())
+        {
+            // a point's distance to any of the frustum planes can change by no more than how far it moves in eye coordinates
+            auto& entry = itr->second;
+            result = entry.margin > (_translation + _rotation * entry.distance);
+        }
+    }
+
+    if (result) ++_numHits;
+    return result;
+}
+
+void VisibilityCache::insert(const Node* node, double margin, double eyeDistance)
+{
+    // convert to a margin relative to the reference camera, so it can be checked against the motion of later frames from the reference
+    double referenceDistance = eyeDistance + _translation;
+    double referenceMargin = margin - (_translation + _rotation * referenceDistance);
+    if (referenceMargin <= 0.0) return;
+
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _entries[node] = Entry{referenceMargin, referenceDistance};
+    }
+
+    ++_numInserted;
+}
+
+void VisibilityCache::clear()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _entries.clear();
+    _referenceValid = false;
+}
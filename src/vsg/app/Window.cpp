@@ -19,8 +19,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/maths/color.h>
 #include <vsg/maths/vec4.h>
 #include <vsg/ui/ApplicationEvent.h>
+#include <vsg/ui/PointerEvent.h>
+#include <vsg/ui/TouchEvent.h>
 #include <vsg/vk/SubmitCommands.h>
+#include <vsg/vk/TimelineSemaphore.h>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 
@@ -52,6 +56,8 @@ Window::~Window()
 
 void Window::clear()
 {
+    _releaseRetiredSwapchains(true);
+
     _frames.clear();
     _swapchain.reset();
 
@@ -164,6 +170,13 @@ ref_ptr<ImageView> Window::getOrCreateDepthImageView()
 
 void Window::_initInstance()
 {
+    // share the Instance of the requested PhysicalDevice
+    if (_traits->physicalDevice)
+    {
+        _instance = _traits->physicalDevice->getInstance();
+        if (_instance) return;
+    }
+
     // create the vkInstance
     _traits->validate();
 
@@ -181,6 +194,14 @@ void Window::_initPhysicalDevice()
     if (!_surface) _initSurface();
 
     // if required set up physical device
+    if (!_physicalDevice && _traits->physicalDevice)
+    {
+        auto [graphicsFamily, presentFamily] = _traits->physicalDevice->getQueueFamily(_traits->queueFlags, _surface);
+        if (graphicsFamily < 0 || presentFamily < 0) throw Exception{"Error: vsg::Window::create(...) failed to create Window, WindowTraits::physicalDevice doesn't support the Window's queueFlags and surface.", VK_ERROR_INVALID_EXTERNAL_HANDLE};
+
+        _physicalDevice = _traits->physicalDevice;
+    }
+
     if (!_physicalDevice)
     {
         _physicalDevice = _instance->getPhysicalDevice(_traits->queueFlags, _surface, _traits->deviceTypePreferences);
@@ -232,12 +253,162 @@ void Window::_initDevice()
     deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     deviceExtensions.insert(deviceExtensions.end(), _traits->deviceExtensionNames.begin(), _traits->deviceExtensionNames.end());
 
+    if (_traits->presentWait)
+    {
+        auto presentIdFeatures = _physicalDevice->getFeatures<VkPhysicalDevicePresentIdFeaturesKHR, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR>();
+        auto presentWaitFeatures = _physicalDevice->getFeatures<VkPhysicalDevicePresentWaitFeaturesKHR, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR>();
+        if (_physicalDevice->supportsDeviceExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) && _physicalDevice->supportsDeviceExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME) &&
+            presentIdFeatures.presentId && presentWaitFeatures.presentWait)
+        {
+            deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+            if (!_traits->deviceFeatures) _traits->deviceFeatures = DeviceFeatures::create();
+            _traits->deviceFeatures->get<VkPhysicalDevicePresentIdFeaturesKHR, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR>().presentId = VK_TRUE;
+            _traits->deviceFeatures->get<VkPhysicalDevicePresentWaitFeaturesKHR, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR>().presentWait = VK_TRUE;
+        }
+        else
+        {
+            info("vsg::Window::_initDevice() VK_KHR_present_id/VK_KHR_present_wait not supported, frame pacing will fall back to CPU timing.");
+        }
+    }
+
+    bool timelineSemaphores = false;
+    if (_traits->timelineSemaphores)
+    {
+        bool coreTimelineSemaphores = _instance->apiVersion >= VK_API_VERSION_1_2;
+        auto timelineSemaphoreFeatures = _physicalDevice->getFeatures<VkPhysicalDeviceTimelineSemaphoreFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES>();
+        if ((coreTimelineSemaphores || _physicalDevice->supportsDeviceExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) && timelineSemaphoreFeatures.timelineSemaphore)
+        {
+            if (!coreTimelineSemaphores) deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+
+            if (!_traits->deviceFeatures) _traits->deviceFeatures = DeviceFeatures::create();
+            _traits->deviceFeatures->get<VkPhysicalDeviceTimelineSemaphoreFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES>().timelineSemaphore = VK_TRUE;
+            timelineSemaphores = true;
+        }
+        else
+        {
+            info("vsg::Window::_initDevice() timeline semaphores not supported, falling back to Fences and binary Semaphores.");
+        }
+    }
+
+    if (_traits->dynamicRendering)
+    {
+        bool coreDynamicRendering = _instance->apiVersion >= VK_API_VERSION_1_3;
+        auto dynamicRenderingFeatures = _physicalDevice->getFeatures<VkPhysicalDeviceDynamicRenderingFeaturesKHR, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR>();
+        if ((coreDynamicRendering || _physicalDevice->supportsDeviceExtension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) && dynamicRenderingFeatures.dynamicRendering)
+        {
+            if (!coreDynamicRendering) deviceExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+
+            if (!_traits->deviceFeatures) _traits->deviceFeatures = DeviceFeatures::create();
+            _traits->deviceFeatures->get<VkPhysicalDeviceDynamicRenderingFeaturesKHR, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR>().dynamicRendering = VK_TRUE;
+        }
+        else
+        {
+            info("vsg::Window::_initDevice() dynamic rendering not supported, falling back to vkCmdBeginRenderPass.");
+            _traits->dynamicRendering = false;
+        }
+    }
+
+    if (_traits->descriptorBuffer)
+    {
+        bool coreBufferDeviceAddress = _instance->apiVersion >= VK_API_VERSION_1_2;
+        auto descriptorBufferFeatures = _physicalDevice->getFeatures<VkPhysicalDeviceDescriptorBufferFeaturesEXT, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT>();
+        auto bufferDeviceAddressFeatures = _physicalDevice->getFeatures<VkPhysicalDeviceBufferDeviceAddressFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES>();
+        if (_physicalDevice->supportsDeviceExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) && descriptorBufferFeatures.descriptorBuffer &&
+            (coreBufferDeviceAddress || _physicalDevice->supportsDeviceExtension(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME)) && bufferDeviceAddressFeatures.bufferDeviceAddress)
+        {
+            deviceExtensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+            if (!coreBufferDeviceAddress) deviceExtensions.push_back(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+
+            if (!_traits->deviceFeatures) _traits->deviceFeatures = DeviceFeatures::create();
+            _traits->deviceFeatures->get<VkPhysicalDeviceDescriptorBufferFeaturesEXT, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT>().descriptorBuffer = VK_TRUE;
+            _traits->deviceFeatures->get<VkPhysicalDeviceBufferDeviceAddressFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES>().bufferDeviceAddress = VK_TRUE;
+        }
+        else
+        {
+            info("vsg::Window::_initDevice() VK_EXT_descriptor_buffer not supported, falling back to DescriptorPools.");
+            _traits->descriptorBuffer = false;
+        }
+    }
+
+    if (_traits->graphicsPipelineLibrary)
+    {
+        auto graphicsPipelineLibraryFeatures = _physicalDevice->getFeatures<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT>();
+        if (_physicalDevice->supportsDeviceExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) && _physicalDevice->supportsDeviceExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+            graphicsPipelineLibraryFeatures.graphicsPipelineLibrary)
+        {
+            deviceExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+
+            if (!_traits->deviceFeatures) _traits->deviceFeatures = DeviceFeatures::create();
+            _traits->deviceFeatures->get<VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT>().graphicsPipelineLibrary = VK_TRUE;
+        }
+        else
+        {
+            info("vsg::Window::_initDevice() VK_EXT_graphics_pipeline_library not supported, falling back to monolithic GraphicsPipeline creation.");
+            _traits->graphicsPipelineLibrary = false;
+        }
+    }
+
     auto [graphicsFamily, presentFamily] = _physicalDevice->getQueueFamily(_traits->queueFlags, _surface);
     if (graphicsFamily < 0 || presentFamily < 0) throw Exception{"Error: vsg::Window::create(...) failed to create Window, no suitable Vulkan Device available.", VK_ERROR_INVALID_EXTERNAL_HANDLE};
 
     vsg::QueueSettings queueSettings{vsg::QueueSetting{graphicsFamily, _traits->queuePiorities}, vsg::QueueSetting{presentFamily, {1.0}}};
+
+    if (_traits->dedicatedTransferQueue)
+    {
+        // prefer a transfer only queue family, falling back to one that supports compute but not graphics
+        int transferFamily = -1;
+        const auto& queueFamilyProperties = _physicalDevice->getQueueFamilyProperties();
+        for (size_t i = 0; i < queueFamilyProperties.size(); ++i)
+        {
+            auto flags = queueFamilyProperties[i].queueFlags;
+            if ((flags & VK_QUEUE_TRANSFER_BIT) == 0 || (flags & VK_QUEUE_GRAPHICS_BIT) != 0) continue;
+
+            if ((flags & VK_QUEUE_COMPUTE_BIT) == 0)
+            {
+                transferFamily = static_cast<int>(i);
+                break;
+            }
+            if (transferFamily < 0) transferFamily = static_cast<int>(i);
+        }
+
+        if (transferFamily >= 0)
+            queueSettings.push_back(vsg::QueueSetting{transferFamily, {1.0}});
+        else
+            info("vsg::Window::_initDevice() no dedicated transfer queue family available.");
+    }
+
+    if (_traits->asyncComputeQueue)
+    {
+        int computeFamily = -1;
+        const auto& queueFamilyProperties = _physicalDevice->getQueueFamilyProperties();
+        for (size_t i = 0; i < queueFamilyProperties.size(); ++i)
+        {
+            auto flags = queueFamilyProperties[i].queueFlags;
+            if ((flags & VK_QUEUE_COMPUTE_BIT) != 0 && (flags & VK_QUEUE_GRAPHICS_BIT) == 0)
+            {
+                computeFamily = static_cast<int>(i);
+                break;
+            }
+        }
+
+        if (computeFamily >= 0)
+            queueSettings.push_back(vsg::QueueSetting{computeFamily, {1.0}});
+        else
+            info("vsg::Window::_initDevice() no async compute queue family available.");
+    }
     _device = vsg::Device::create(_physicalDevice, queueSettings, validatedNames, deviceExtensions, _traits->deviceFeatures, _instance->getAllocationCallbacks());
 
+    if (timelineSemaphores)
+    {
+        for (auto& queue : _device->getQueues())
+        {
+            if (!queue->timeline) queue->timeline = TimelineSemaphore::create(_device);
+        }
+    }
+
     _initFormats();
 }
 
@@ -267,28 +438,26 @@ void Window::_initSwapchain()
 
 void Window::buildSwapchain()
 {
+    ref_ptr<Swapchain> oldSwapchain = _swapchain;
     if (_swapchain)
     {
-        // make sure all operations on the device have stopped before we go on deleting associated resources
-        vkDeviceWaitIdle(*_device);
-
-        // clean up previous swap chain before we begin creating a new one.
-        _frames.clear();
-        _indices.clear();
-
-        _depthImageView.reset();
-        _depthImage.reset();
-
-        _multisampleImage.reset();
-        _multisampleImageView.reset();
+        // rather than waiting for the device to be idle retire the previous swapchain and its associated resources,
+        // they are released once the frames already submitted have completed.
+        _retireSwapchain();
     }
 
     // is width and height even required here as the surface appears to control it?
-    _swapchain = Swapchain::create(_physicalDevice, _device, _surface, _extent2D.width, _extent2D.height, _traits->swapchainPreferences, _swapchain);
+    _swapchain = Swapchain::create(_physicalDevice, _device, _surface, _extent2D.width, _extent2D.height, _traits->swapchainPreferences, oldSwapchain);
 
     // pass back the extents used by the swap chain.
     _extent2D = _swapchain->getExtent();
 
+    // attachments that are only accessed within the render pass can be transient, allowing them to use lazily allocated memory on tile based GPUs
+    auto attachmentUsage = [](VkImageUsageFlags usage) {
+        const VkImageUsageFlags attachmentOnly = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+        return ((usage & ~attachmentOnly) == 0) ? (usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) : usage;
+    };
+
     bool multisampling = _framebufferSamples != VK_SAMPLE_COUNT_1_BIT;
     if (multisampling)
     {
@@ -302,13 +471,13 @@ void Window::buildSwapchain()
         _multisampleImage->arrayLayers = 1;
         _multisampleImage->samples = _framebufferSamples;
         _multisampleImage->tiling = VK_IMAGE_TILING_OPTIMAL;
-        _multisampleImage->usage = _traits->swapchainPreferences.imageUsage;
+        _multisampleImage->usage = attachmentUsage(_traits->swapchainPreferences.imageUsage);
         _multisampleImage->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         _multisampleImage->flags = 0;
         _multisampleImage->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
         _multisampleImage->compile(_device);
-        _multisampleImage->allocateAndBindMemory(_device);
+        _multisampleImage->allocateAndBindMemory(_device, _multisampleImage->preferredMemoryProperties(_device));
 
         _multisampleImageView = ImageView::create(_multisampleImage, VK_IMAGE_ASPECT_COLOR_BIT);
         _multisampleImageView->compile(_device);
@@ -330,10 +499,10 @@ void Window::buildSwapchain()
     _depthImage->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     _depthImage->samples = _framebufferSamples;
     _depthImage->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    _depthImage->usage = _traits->depthImageUsage;
+    _depthImage->usage = attachmentUsage(_traits->depthImageUsage);
 
     _depthImage->compile(_device);
-    _depthImage->allocateAndBindMemory(_device);
+    _depthImage->allocateAndBindMemory(_device, _depthImage->preferredMemoryProperties(_device));
 
     _depthImageView = ImageView::create(_depthImage);
     _depthImageView->compile(_device);
@@ -431,10 +600,70 @@ void Window::buildSwapchain()
     }
 }
 
+void Window::_retireSwapchain()
+{
+    RetiredSwapchain retired;
+    retired.swapchain = _swapchain;
+    retired.frames.swap(_frames);
+    for (ref_ptr<Object> attachment : {ref_ptr<Object>(_depthImageView), ref_ptr<Object>(_depthImage), ref_ptr<Object>(_multisampleImageView), ref_ptr<Object>(_multisampleImage),
+                                       ref_ptr<Object>(_multisampleDepthImageView), ref_ptr<Object>(_multisampleDepthImage)})
+    {
+        if (attachment) retired.attachments.push_back(attachment);
+    }
+
+    // an empty submission signals its fence once all the work previously submitted to that queue has completed
+    for (auto& queue : _device->getQueues())
+    {
+        auto fence = Fence::create(_device);
+        if (queue->submit(std::vector<VkSubmitInfo>{}, fence) == VK_SUCCESS)
+        {
+            retired.fences.push_back(fence);
+        }
+        else
+        {
+            queue->waitIdle();
+        }
+    }
+
+    _retiredSwapchains.push_back(std::move(retired));
+
+    _swapchain.reset();
+    _indices.clear();
+
+    _depthImageView.reset();
+    _depthImage.reset();
+
+    _multisampleImage.reset();
+    _multisampleImageView.reset();
+
+    _multisampleDepthImage.reset();
+    _multisampleDepthImageView.reset();
+}
+
+void Window::_releaseRetiredSwapchains(bool wait)
+{
+    if (_retiredSwapchains.empty()) return;
+
+    auto completed = [&](RetiredSwapchain& retired) {
+        for (auto& fence : retired.fences)
+        {
+            if (wait)
+                fence->wait(std::numeric_limits<uint64_t>::max());
+            else if (fence->status() != VK_SUCCESS)
+                return false;
+        }
+        return true;
+    };
+
+    _retiredSwapchains.erase(std::remove_if(_retiredSwapchains.begin(), _retiredSwapchains.end(), completed), _retiredSwapchains.end());
+}
+
 VkResult Window::acquireNextImage(uint64_t timeout)
 {
     if (!_swapchain) _initSwapchain();
 
+    _releaseRetiredSwapchains();
+
     if (!_availableSemaphore) _availableSemaphore = vsg::Semaphore::create(_device, _traits->imageAvailableSemaphoreWaitFlag);
 
     // check the dimensions of the swapchain and window extents are consistent, if not return a VK_ERROR_OUT_OF_DATE_KHR
@@ -467,12 +696,90 @@ VkResult Window::acquireNextImage(uint64_t timeout)
 
 bool Window::pollEvents(vsg::UIEvents& events)
 {
-    if (!bufferedEvents.empty())
+    if (bufferedEvents.empty()) return false;
+
+    if (coalesceMoveEvents)
     {
-        events.splice(events.end(), bufferedEvents);
+        // first event in events of the current run of move events, events.end() when not in a run
+        auto moveRunStart = events.end();
+        auto coalesce = [&](auto match) {
+            for (auto itr = moveRunStart; itr != events.end(); ++itr)
+            {
+                if (match(*itr))
+                {
+                    if (itr == moveRunStart) ++moveRunStart;
+                    events.erase(itr);
+                    return;
+                }
+            }
+        };
+
+        for (auto& event : bufferedEvents)
+        {
+            bool moving = true;
+            if (auto moveEvent = event->cast<MoveEvent>())
+            {
+                coalesce([&](const ref_ptr<UIEvent>& previous) {
+                    auto previousMove = previous->cast<MoveEvent>();
+                    return previousMove && previousMove->mask == moveEvent->mask;
+                });
+            }
+            else if (auto touchMoveEvent = event->cast<TouchMoveEvent>())
+            {
+                coalesce([&](const ref_ptr<UIEvent>& previous) {
+                    auto previousTouchMove = previous->cast<TouchMoveEvent>();
+                    return previousTouchMove && previousTouchMove->id == touchMoveEvent->id;
+                });
+            }
+            else
+            {
+                moving = false;
+            }
+
+            events.push_back(event);
+
+            if (!moving)
+                moveRunStart = events.end();
+            else if (moveRunStart == events.end())
+                moveRunStart = std::prev(events.end());
+        }
         bufferedEvents.clear();
-        return true;
     }
+    else
+    {
+        events.splice(events.end(), bufferedEvents);
+    }
+
+    return true;
+}
+
+bool Window::waitEvents(vsg::UIEvents& events, double timeout)
+{
+    // the native event queue isn't accessible here so poll it at short intervals, returning early when woken
+    const auto pollInterval = std::chrono::milliseconds(10);
+    auto deadline = timeout >= 0.0 ? clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(timeout)) : clock::time_point::max();
+
+    while (true)
+    {
+        if (pollEvents(events)) return true;
+
+        std::unique_lock lock(_wakeMutex);
+        if (_wakeRequested)
+        {
+            _wakeRequested = false;
+            return false;
+        }
+
+        auto now = clock::now();
+        if (now >= deadline) return false;
 
-    return false;
+        _wakeCondition.wait_until(lock, (deadline - now) > pollInterval ? now + pollInterval : deadline);
+    }
+}
+
+void Window::wakeEvents()
+{
+    std::scoped_lock lock(_wakeMutex);
+    _wakeRequested = true;
+    _wakeCondition.notify_all();
 }
@@ -13,8 +13,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/app/View.h>
 #include <vsg/app/WindowResizeHandler.h>
 #include <vsg/commands/ClearAttachments.h>
+#include <vsg/commands/SetScissor.h>
+#include <vsg/commands/SetViewport.h>
 #include <vsg/io/Options.h>
 #include <vsg/nodes/StateGroup.h>
+#include <vsg/state/DynamicState.h>
 #include <vsg/vk/Context.h>
 #include <vsg/vk/State.h>
 
@@ -101,6 +104,14 @@ bool WindowResizeHandler::visit(const Object* object, uint32_t index)
     return true;
 }
 
+void WindowResizeHandler::deviceWaitIdle()
+{
+    if (deviceIdle || !context || !context->device) return;
+
+    vkDeviceWaitIdle(*(context->device));
+    deviceIdle = true;
+}
+
 void WindowResizeHandler::apply(vsg::BindGraphicsPipeline& bindPipeline)
 {
     GraphicsPipeline* graphicsPipeline = bindPipeline.pipeline;
@@ -116,6 +127,14 @@ void WindowResizeHandler::apply(vsg::BindGraphicsPipeline& bindPipeline)
         {
             bool foundViewport = false;
             void apply(const ViewportState&) override { foundViewport = true; }
+            void apply(const DynamicState& dynamicState) override
+            {
+                // viewport and scissor set dynamically via SetViewport/SetScissor so no need to regenerate to pick up the new ViewportState
+                auto& states = dynamicState.dynamicStates;
+                bool dynamicViewport = std::find(states.begin(), states.end(), VK_DYNAMIC_STATE_VIEWPORT) != states.end();
+                bool dynamicScissor = std::find(states.begin(), states.end(), VK_DYNAMIC_STATE_SCISSOR) != states.end();
+                if (dynamicViewport && dynamicScissor) foundViewport = true;
+            }
             bool operator()(const GraphicsPipeline& gp)
             {
                 for (auto& pipelineState : gp.pipelineStates)
@@ -129,6 +148,9 @@ void WindowResizeHandler::apply(vsg::BindGraphicsPipeline& bindPipeline)
         bool needToRegenerateGraphicsPipeline = !containsViewport(*graphicsPipeline);
         if (needToRegenerateGraphicsPipeline)
         {
+            // make sure the pipeline isn't still in use before we release it
+            deviceWaitIdle();
+
             graphicsPipeline->release(context->viewID);
             graphicsPipeline->compile(*context);
         }
@@ -162,6 +184,32 @@ void WindowResizeHandler::apply(ClearAttachments& clearAttachments)
     }
 }
 
+void WindowResizeHandler::apply(SetViewport& setViewport)
+{
+    if (!visit(&setViewport)) return;
+
+    for (auto& viewport : setViewport.viewports)
+    {
+        VkRect2D rect{{static_cast<int32_t>(viewport.x), static_cast<int32_t>(viewport.y)}, {static_cast<uint32_t>(viewport.width), static_cast<uint32_t>(viewport.height)}};
+        scale_rect(rect);
+
+        viewport.x = static_cast<float>(rect.offset.x);
+        viewport.y = static_cast<float>(rect.offset.y);
+        viewport.width = static_cast<float>(rect.extent.width);
+        viewport.height = static_cast<float>(rect.extent.height);
+    }
+}
+
+void WindowResizeHandler::apply(SetScissor& setScissor)
+{
+    if (!visit(&setScissor)) return;
+
+    for (auto& scissor : setScissor.scissors)
+    {
+        scale_rect(scissor);
+    }
+}
+
 void WindowResizeHandler::apply(vsg::View& view)
 {
     if (!visit(&view)) return;
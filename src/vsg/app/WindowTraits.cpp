@@ -41,10 +41,17 @@ WindowTraits::WindowTraits(const WindowTraits& traits) :
     depthFormat(traits.depthFormat),
     depthImageUsage(traits.depthImageUsage),
     queueFlags(traits.queueFlags),
+    dedicatedTransferQueue(traits.dedicatedTransferQueue),
+    asyncComputeQueue(traits.asyncComputeQueue),
     imageAvailableSemaphoreWaitFlag(traits.imageAvailableSemaphoreWaitFlag),
     debugLayer(traits.debugLayer),
     apiDumpLayer(traits.apiDumpLayer),
     debugUtils(traits.debugUtils),
+    presentWait(traits.presentWait),
+    timelineSemaphores(traits.timelineSemaphores),
+    dynamicRendering(traits.dynamicRendering),
+    descriptorBuffer(traits.descriptorBuffer),
+    graphicsPipelineLibrary(traits.graphicsPipelineLibrary),
     device(traits.device),
     instanceExtensionNames(traits.instanceExtensionNames),
     requestedLayers(traits.requestedLayers),
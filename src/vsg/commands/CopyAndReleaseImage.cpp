@@ -14,6 +14,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/commands/PipelineBarrier.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
+#include <vsg/utils/ImageFormatConverter.h>
+#include <vsg/utils/ImageProcessing.h>
 #include <vsg/vk/CommandBuffer.h>
 
 using namespace vsg;
@@ -113,29 +115,10 @@ void CopyAndReleaseImage::copy(ref_ptr<Data> data, ref_ptr<ImageInfo> dest, uint
         uint32_t bytesFromSource = sourceTraits.size;
         uint32_t bytesToTarget = targetTraits.size;
 
-        // copy data
-        using value_type = uint8_t;
-        const value_type* src_ptr = reinterpret_cast<const value_type*>(data->dataPointer());
-
         void* buffer_data;
         imageStagingMemory->map(imageStagingBuffer->getMemoryOffset(deviceID) + stagingBufferInfo->offset, imageTotalSize, 0, &buffer_data);
-        value_type* dest_ptr = reinterpret_cast<value_type*>(buffer_data);
 
-        size_t valueCount = data->valueCount();
-        for (size_t i = 0; i < valueCount; ++i)
-        {
-            uint32_t s = 0;
-            for (; s < bytesFromSource; ++s)
-            {
-                (*dest_ptr++) = *(src_ptr++);
-            }
-
-            const value_type* src_default = default_ptr;
-            for (; s < bytesToTarget; ++s)
-            {
-                (*dest_ptr++) = *(src_default++);
-            }
-        }
+        copyPixels(data->dataPointer(), bytesFromSource, buffer_data, bytesToTarget, data->valueCount(), default_ptr);
 
         imageStagingMemory->unmap();
 
@@ -166,6 +149,12 @@ void CopyAndReleaseImage::_copyDirectly(ref_ptr<Data> data, ref_ptr<ImageInfo> d
 
 void CopyAndReleaseImage::CopyData::record(CommandBuffer& commandBuffer) const
 {
+    if (conversion)
+    {
+        conversion->record(commandBuffer);
+        conversion.cast<ImageFormatConversion>()->converter->recordBarrier(commandBuffer);
+    }
+
     transferImageData(destination->imageView, destination->imageLayout, layout, width, height, depth, mipLevels, mipmapOffsets, source->buffer, source->offset, commandBuffer.vk(), commandBuffer.getDevice());
 }
 
@@ -177,10 +166,27 @@ void CopyAndReleaseImage::record(CommandBuffer& commandBuffer) const
 
     _readyToClear.swap(_completed);
 
+    // record any format conversions first so they can share a single barrier before the copies
+    const ImageFormatConverter* converter = nullptr;
+    for (auto& copyData : _pending)
+    {
+        if (copyData.conversion)
+        {
+            copyData.conversion->record(commandBuffer);
+            converter = copyData.conversion.cast<ImageFormatConversion>()->converter.get();
+        }
+    }
+    if (converter) converter->recordBarrier(commandBuffer);
+
+    // record all the pending copies together so their layout transitions and mipmap generation share barriers
+    ImageTransfers transfers;
+    transfers.reserve(_pending.size());
     for (auto& copyData : _pending)
     {
-        copyData.record(commandBuffer);
+        transfers.push_back(ImageTransfer{copyData.destination->imageView, copyData.destination->imageLayout, copyData.layout, copyData.width, copyData.height, copyData.depth,
+                                          copyData.mipLevels, copyData.mipmapOffsets, copyData.source->buffer, copyData.source->offset});
     }
+    transferImageData(transfers, commandBuffer.vk(), commandBuffer.getDevice());
 
     _pending.swap(_completed);
 }
@@ -98,4 +98,5 @@ void DrawIndexedIndirect::compile(Context& context)
 void DrawIndexedIndirect::record(CommandBuffer& commandBuffer) const
 {
     vkCmdDrawIndexedIndirect(commandBuffer, bufferInfo->buffer->vk(commandBuffer.deviceID), bufferInfo->offset, drawCount, stride);
+    ++commandBuffer.recordStatistics.indirectDraws;
 }
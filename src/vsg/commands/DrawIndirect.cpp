@@ -98,4 +98,5 @@ void DrawIndirect::compile(Context& context)
 void DrawIndirect::record(CommandBuffer& commandBuffer) const
 {
     vkCmdDrawIndirect(commandBuffer, bufferInfo->buffer->vk(commandBuffer.deviceID), bufferInfo->offset, drawCount, stride);
+    ++commandBuffer.recordStatistics.indirectDraws;
 }
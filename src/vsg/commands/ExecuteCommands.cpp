@@ -80,5 +80,8 @@ void ExecuteCommands::record(CommandBuffer& commandBuffer) const
     if (!vk_commandBuffers.empty())
     {
         vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(vk_commandBuffers.size()), vk_commandBuffers.data());
+
+        // state bound by the secondary CommandBuffers is undefined once they've been executed
+        commandBuffer.resetRecordedState();
     }
 }
@@ -11,14 +11,150 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/core/Allocator.h>
+#include <vsg/core/AllocatorArena.h>
 #include <vsg/core/Exception.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
 
 #include <algorithm>
 
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#elif defined(__linux__)
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
 using namespace vsg;
 
+namespace
+{
+    size_t roundUp(size_t size, size_t alignment)
+    {
+        return ((size + alignment - 1) / alignment) * alignment;
+    }
+
+#if defined(_WIN32)
+    void* mapPages(size_t size, const MemoryPlacement& placement, size_t& mappedSize)
+    {
+        // Windows has no transparent huge pages, so MEMORY_PAGES_TRANSPARENT_HUGE maps regular pages
+        DWORD nndPreferred = placement.numaNode >= 0 ? static_cast<DWORD>(placement.numaNode) : NUMA_NO_PREFERRED_NODE;
+
+        if (placement.pages == MEMORY_PAGES_HUGE)
+        {
+            if (size_t largePageSize = GetLargePageMinimum(); largePageSize > 0)
+            {
+                size_t largeSize = roundUp(size, largePageSize);
+                if (auto ptr = VirtualAllocExNuma(GetCurrentProcess(), nullptr, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, nndPreferred))
+                {
+                    mappedSize = largeSize;
+                    return ptr;
+                }
+            }
+        }
+
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        size_t pagesSize = roundUp(size, systemInfo.dwPageSize);
+        if (auto ptr = VirtualAllocExNuma(GetCurrentProcess(), nullptr, pagesSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, nndPreferred))
+        {
+            mappedSize = pagesSize;
+            return ptr;
+        }
+        return nullptr;
+    }
+
+    void unmapPages(void* ptr, size_t /*size*/)
+    {
+        VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+
+#elif defined(__linux__)
+    const size_t hugePageSize = 2 * 1024 * 1024;
+
+    void bindToNumaNode(void* ptr, size_t size, int numaNode)
+    {
+#    if defined(SYS_mbind)
+        // call mbind directly rather than depending upon libnuma, MPOL_PREFERRED so allocation falls back to other nodes when numaNode is full
+        const int MPOL_PREFERRED_MODE = 1;
+        const size_t maxNodes = 1024;
+        if (numaNode < 0 || static_cast<size_t>(numaNode) >= maxNodes) return;
+
+        unsigned long nodemask[maxNodes / (8 * sizeof(unsigned long))] = {};
+        nodemask[numaNode / (8 * sizeof(unsigned long))] = 1ul << (numaNode % (8 * sizeof(unsigned long)));
+        syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_MODE, nodemask, maxNodes + 1, 0);
+#    else
+        (void)ptr;
+        (void)size;
+        (void)numaNode;
+#    endif
+    }
+
+    void* mapPages(size_t size, const MemoryPlacement& placement, size_t& mappedSize)
+    {
+        size_t hugeSize = roundUp(size, hugePageSize);
+        void* ptr = MAP_FAILED;
+
+#    if defined(MAP_HUGETLB)
+        if (placement.pages == MEMORY_PAGES_HUGE)
+        {
+            ptr = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#    endif
+
+        if (ptr == MAP_FAILED && placement.pages != MEMORY_PAGES_DEFAULT)
+        {
+            // over allocate so the mapping can be trimmed to huge page alignment, as transparent huge pages are only used for aligned 2MB ranges
+            size_t reservedSize = hugeSize + hugePageSize;
+            auto reserved = static_cast<uint8_t*>(mmap(nullptr, reservedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (reserved != MAP_FAILED)
+            {
+                auto aligned = reinterpret_cast<uint8_t*>(roundUp(reinterpret_cast<size_t>(reserved), hugePageSize));
+                if (aligned > reserved) munmap(reserved, aligned - reserved);
+                if (auto tail = reserved + reservedSize - (aligned + hugeSize); tail > 0) munmap(aligned + hugeSize, tail);
+                ptr = aligned;
+#    if defined(MADV_HUGEPAGE)
+                madvise(ptr, hugeSize, MADV_HUGEPAGE);
+#    endif
+            }
+        }
+
+        if (ptr == MAP_FAILED)
+        {
+            hugeSize = roundUp(size, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+            ptr = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) return nullptr;
+        }
+
+        // bind before the pages are first touched so they are allocated on the requested node
+        bindToNumaNode(ptr, hugeSize, placement.numaNode);
+
+        mappedSize = hugeSize;
+        return ptr;
+    }
+
+    void unmapPages(void* ptr, size_t size)
+    {
+        munmap(ptr, size);
+    }
+
+#else
+    void* mapPages(size_t /*size*/, const MemoryPlacement& /*placement*/, size_t& /*mappedSize*/)
+    {
+        // not implemented, fallback to allocatorType
+        return nullptr;
+    }
+
+    void unmapPages(void* /*ptr*/, size_t /*size*/)
+    {
+    }
+#endif
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // vsg::Allocator
@@ -265,6 +401,16 @@ void Allocator::setBlockSize(AllocatorAffinity allocatorAffinity, size_t blockSi
     }
 }
 
+void Allocator::setMemoryPlacement(AllocatorAffinity allocatorAffinity, const MemoryPlacement& placement)
+{
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    if (size_t(allocatorAffinity) < allocatorMemoryBlocks.size())
+    {
+        allocatorMemoryBlocks[allocatorAffinity]->placement = placement;
+    }
+}
+
 void Allocator::setMemoryTracking(int mt)
 {
     memoryTracking = mt;
@@ -284,17 +430,21 @@ void Allocator::setMemoryTracking(int mt)
 //
 // vsg::Allocator::MemoryBlock
 //
-Allocator::MemoryBlock::MemoryBlock(size_t blockSize, int memoryTracking, AllocatorType in_allocatorType) :
+Allocator::MemoryBlock::MemoryBlock(size_t blockSize, int memoryTracking, AllocatorType in_allocatorType, const MemoryPlacement& placement) :
     memorySlots(blockSize, memoryTracking),
     allocatorType(in_allocatorType)
 {
-    if (allocatorType == ALLOCATOR_TYPE_NEW_DELETE)
+    if (placement.pages != MEMORY_PAGES_DEFAULT || placement.numaNode >= 0)
     {
-        memory = static_cast<uint8_t*>(operator new(blockSize));
+        memory = static_cast<uint8_t*>(mapPages(blockSize, placement, mappedSize));
     }
-    else
+
+    if (!memory)
     {
-        memory = static_cast<uint8_t*>(std::malloc(blockSize));
+        if (allocatorType == ALLOCATOR_TYPE_NEW_DELETE)
+            memory = static_cast<uint8_t*>(operator new(blockSize));
+        else
+            memory = static_cast<uint8_t*>(std::malloc(blockSize));
     }
 
     if (memorySlots.memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS)
@@ -310,7 +460,11 @@ Allocator::MemoryBlock::~MemoryBlock()
         info("MemoryBlock::~MemoryBlock(", memorySlots.totalMemorySize(), ") freed memory");
     }
 
-    if (allocatorType == ALLOCATOR_TYPE_NEW_DELETE)
+    if (mappedSize > 0)
+    {
+        unmapPages(memory, mappedSize);
+    }
+    else if (allocatorType == ALLOCATOR_TYPE_NEW_DELETE)
     {
         operator delete(memory);
     }
@@ -390,7 +544,7 @@ void* Allocator::MemoryBlocks::allocate(std::size_t size)
 
     size_t new_blockSize = std::max(size, blockSize);
 
-    auto block = std::make_shared<MemoryBlock>(new_blockSize, parent->memoryTracking, parent->memoryBlocksAllocatorType);
+    auto block = std::make_shared<MemoryBlock>(new_blockSize, parent->memoryTracking, parent->memoryBlocksAllocatorType, placement);
     latestMemoryBlock = block;
 
     auto ptr = block->allocate(size);
@@ -503,10 +657,15 @@ size_t Allocator::MemoryBlocks::totalMemorySize() const
 //
 void* vsg::allocate(std::size_t size, AllocatorAffinity allocatorAffinity)
 {
+    if (auto arena = AllocatorArena::current())
+    {
+        if (auto ptr = arena->allocate(size)) return ptr;
+    }
     return Allocator::instance()->allocate(size, allocatorAffinity);
 }
 
 void vsg::deallocate(void* ptr, std::size_t size)
 {
+    if (AllocatorArena::deallocate(ptr)) return;
     Allocator::instance()->deallocate(ptr, size);
 }
@@ -0,0 +1,182 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/AllocatorArena.h>
+
+#include <atomic>
+#include <new>
+
+using namespace vsg;
+
+namespace
+{
+    // chunks are looked up from a pointer using a two level table indexed by the pointer's chunk number, covering a 48 bit address space.
+    constexpr size_t chunkShift = 20;
+    constexpr size_t leafBits = 14;
+    constexpr size_t leafSize = size_t(1) << leafBits;
+    constexpr size_t rootSize = size_t(1) << (48 - chunkShift - leafBits);
+
+    static_assert((size_t(1) << chunkShift) == AllocatorArena::chunkSize, "chunkShift must match AllocatorArena::chunkSize");
+
+    constexpr size_t alignment = 16;
+
+    // statically zero initialized so deallocations during static destruction can still safely look up chunks, leaves are never deleted
+    std::atomic<void*> s_root[rootSize];
+    std::atomic_bool s_arenasCreated{false};
+    std::mutex s_rootMutex;
+
+    thread_local AllocatorArena* s_currentArena = nullptr;
+
+    using Leaf = std::atomic<void*>[leafSize];
+
+    std::atomic<void*>* leafEntry(const void* ptr, bool create)
+    {
+        auto chunkNumber = reinterpret_cast<uintptr_t>(ptr) >> chunkShift;
+        if ((chunkNumber >> leafBits) >= rootSize) return nullptr;
+
+        auto& rootEntry = s_root[chunkNumber >> leafBits];
+        auto leaf = static_cast<std::atomic<void*>*>(rootEntry.load(std::memory_order_acquire));
+        if (!leaf)
+        {
+            if (!create) return nullptr;
+
+            std::scoped_lock<std::mutex> lock(s_rootMutex);
+            leaf = static_cast<std::atomic<void*>*>(rootEntry.load(std::memory_order_relaxed));
+            if (!leaf)
+            {
+                leaf = new Leaf;
+                for (size_t i = 0; i < leafSize; ++i) leaf[i].store(nullptr, std::memory_order_relaxed);
+                rootEntry.store(leaf, std::memory_order_release);
+            }
+        }
+        return &leaf[chunkNumber & (leafSize - 1)];
+    }
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// AllocatorArena::Region
+//
+struct AllocatorArena::Region
+{
+    std::mutex mutex;
+    std::vector<uint8_t*> chunks;
+    uint8_t* next = nullptr;
+    uint8_t* end = nullptr;
+
+    // one count for each live allocation plus one held by the AllocatorArena
+    std::atomic_size_t count{1};
+
+    ~Region()
+    {
+        for (auto chunk : chunks)
+        {
+            if (auto entry = leafEntry(chunk, false)) entry->store(nullptr, std::memory_order_release);
+            ::operator delete(chunk, std::align_val_t(chunkSize));
+        }
+    }
+
+    void release()
+    {
+        if (count.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+
+    void* allocate(std::size_t size)
+    {
+        size = (size + alignment - 1) & ~(alignment - 1);
+
+        std::scoped_lock<std::mutex> lock(mutex);
+        if (static_cast<size_t>(end - next) < size)
+        {
+            auto chunk = static_cast<uint8_t*>(::operator new(chunkSize, std::align_val_t(chunkSize)));
+            auto entry = leafEntry(chunk, true);
+            if (!entry)
+            {
+                ::operator delete(chunk, std::align_val_t(chunkSize));
+                return nullptr;
+            }
+            entry->store(this, std::memory_order_release);
+
+            chunks.push_back(chunk);
+            next = chunk;
+            end = chunk + chunkSize;
+        }
+
+        void* ptr = next;
+        next += size;
+        count.fetch_add(1, std::memory_order_relaxed);
+        return ptr;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// AllocatorArena
+//
+AllocatorArena::AllocatorArena() :
+    _region(new Region)
+{
+    s_arenasCreated = true;
+}
+
+AllocatorArena::~AllocatorArena()
+{
+    // the chunks are freed once all the allocations from them have also been deallocated
+    _region->release();
+}
+
+AllocatorArena::Scope::Scope(AllocatorArena* arena) :
+    previous(s_currentArena)
+{
+    s_currentArena = arena;
+}
+
+AllocatorArena::Scope::~Scope()
+{
+    s_currentArena = previous;
+}
+
+AllocatorArena* AllocatorArena::current()
+{
+    return s_currentArena;
+}
+
+void* AllocatorArena::allocate(std::size_t size)
+{
+    if (size > maximumAllocationSize) return nullptr;
+    return _region->allocate(size);
+}
+
+bool AllocatorArena::deallocate(void* ptr)
+{
+    if (!ptr || !s_arenasCreated.load(std::memory_order_relaxed)) return false;
+
+    auto entry = leafEntry(ptr, false);
+    if (!entry) return false;
+
+    auto region = static_cast<Region*>(entry->load(std::memory_order_acquire));
+    if (!region) return false;
+
+    region->release();
+    return true;
+}
+
+size_t AllocatorArena::numAllocations() const
+{
+    return _region->count.load() - 1;
+}
+
+size_t AllocatorArena::totalMemorySize() const
+{
+    std::scoped_lock<std::mutex> lock(_region->mutex);
+    return _region->chunks.size() * chunkSize;
+}
@@ -17,8 +17,68 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/io/Output.h>
 
+#include <deque>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+
 using namespace vsg;
 
+namespace
+{
+    struct KeyTable
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, uint32_t> keyIDs;
+        std::deque<std::string> keys;
+    };
+
+    // never deleted so keys can still be looked up by objects destroyed during static destruction
+    KeyTable& keyTable()
+    {
+        static KeyTable* s_keyTable = new KeyTable;
+        return *s_keyTable;
+    }
+
+    // mutexes shared between all Auxiliary, selected by the Auxiliary's address
+    std::array<std::mutex, 64> s_mutexes;
+} // namespace
+
+uint32_t vsg::internKey(const std::string& key)
+{
+    auto& table = keyTable();
+    {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        if (auto itr = table.keyIDs.find(key); itr != table.keyIDs.end()) return itr->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    if (auto itr = table.keyIDs.find(key); itr != table.keyIDs.end()) return itr->second;
+
+    table.keys.push_back(key);
+    uint32_t keyID = static_cast<uint32_t>(table.keys.size());
+    table.keyIDs[key] = keyID;
+    return keyID;
+}
+
+uint32_t vsg::findKey(const std::string& key)
+{
+    auto& table = keyTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    if (auto itr = table.keyIDs.find(key); itr != table.keyIDs.end()) return itr->second;
+    return 0;
+}
+
+const std::string& vsg::keyString(uint32_t keyID)
+{
+    static const std::string s_empty;
+
+    auto& table = keyTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    if (keyID == 0 || keyID > table.keys.size()) return s_empty;
+    return table.keys[keyID - 1];
+}
+
 Auxiliary::Auxiliary(Object* object) :
     _referenceCount(0),
     _connectedObject(object)
@@ -31,6 +91,11 @@ Auxiliary::~Auxiliary()
     //vsg::debug("Auxiliary::~Auxiliary() ", this);
 }
 
+std::mutex& Auxiliary::getMutex() const
+{
+    return s_mutexes[(reinterpret_cast<uintptr_t>(this) >> 4) % s_mutexes.size()];
+}
+
 void Auxiliary::ref() const
 {
     ++_referenceCount;
@@ -52,18 +117,34 @@ void Auxiliary::unref_nodelete() const
     --_referenceCount;
 }
 
-bool Auxiliary::signalConnectedObjectToBeDeleted()
+Object* Auxiliary::refConnectedObject()
 {
-    std::scoped_lock<std::mutex> guard(_mutex);
+    // announce the promotion before reading the pointer, so either signalConnectedObjectToBeDeleted() waits for it or it sees the disconnected object
+    _numPromoting.fetch_add(1, std::memory_order_seq_cst);
+
+    Object* object = _connectedObject.load(std::memory_order_seq_cst);
+    if (object && !object->ref_if_referenced()) object = nullptr;
 
-    if (_connectedObject && _connectedObject->referenceCount() > 0)
+    _numPromoting.fetch_sub(1, std::memory_order_release);
+    return object;
+}
+
+bool Auxiliary::signalConnectedObjectToBeDeleted()
+{
+    Object* object = _connectedObject.load(std::memory_order_acquire);
+    if (object && object->referenceCount() > 0)
     {
         // return false, the object should not be deleted
         return false;
     }
 
-    // disconnect this Auxiliary object from the ConnectedObject
-    _connectedObject = nullptr;
+    // disconnect this Auxiliary object from the ConnectedObject, observers that already have the pointer can't take a reference as the count is zero,
+    // but may still be reading the count so wait for them to finish before the object is deleted.
+    _connectedObject.store(nullptr, std::memory_order_seq_cst);
+    while (_numPromoting.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
 
     // return true, the object should be deleted
     return true;
@@ -71,16 +152,129 @@ bool Auxiliary::signalConnectedObjectToBeDeleted()
 
 void Auxiliary::resetConnectedObject()
 {
-    std::scoped_lock<std::mutex> guard(_mutex);
+    _connectedObject.store(nullptr, std::memory_order_release);
+}
+
+void Auxiliary::setObject(uint32_t keyID, ref_ptr<Object> object)
+{
+    if (keyID == 0) return;
+
+    // release the previous object once the mutex has been released, as its deletion may need to lock the mutex of its own Auxiliary
+    ref_ptr<Object> previous;
+
+    std::scoped_lock<std::mutex> guard(getMutex());
+    if (auto entry = const_cast<Entry*>(_find(keyID)))
+    {
+        previous = entry->object;
+        entry->object = object;
+        return;
+    }
+
+    uint32_t numInline = _numInline.load(std::memory_order_relaxed);
+    if (numInline < numInlineObjects)
+    {
+        _inline[numInline].keyID = keyID;
+        _inline[numInline].object = object;
+        _numInline.store(numInline + 1, std::memory_order_release);
+    }
+    else
+    {
+        _overflow.push_back(Entry{keyID, object});
+    }
+}
+
+void Auxiliary::removeObject(const std::string& key)
+{
+    auto keyID = findKey(key);
+    if (keyID == 0) return;
 
-    _connectedObject = nullptr;
+    ref_ptr<Object> previous;
+
+    std::scoped_lock<std::mutex> guard(getMutex());
+    for (auto itr = _overflow.begin(); itr != _overflow.end(); ++itr)
+    {
+        if (itr->keyID == keyID)
+        {
+            previous = itr->object;
+            _overflow.erase(itr);
+            return;
+        }
+    }
+
+    uint32_t numInline = _numInline.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < numInline; ++i)
+    {
+        if (_inline[i].keyID == keyID)
+        {
+            previous = _inline[i].object;
+
+            // fill the gap with the last inline entry, then refill the inline entries from the overflow
+            _inline[i] = _inline[numInline - 1];
+            _inline[numInline - 1] = {};
+            --numInline;
+
+            if (!_overflow.empty())
+            {
+                _inline[numInline++] = _overflow.back();
+                _overflow.pop_back();
+            }
+            _numInline.store(numInline, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void Auxiliary::clearObjects()
+{
+    std::vector<Entry> previous;
+
+    std::scoped_lock<std::mutex> guard(getMutex());
+    previous.swap(_overflow);
+
+    uint32_t numInline = _numInline.exchange(0);
+    for (uint32_t i = 0; i < numInline; ++i)
+    {
+        previous.push_back(_inline[i]);
+        _inline[i] = {};
+    }
+}
+
+Auxiliary::ObjectMap Auxiliary::getObjects() const
+{
+    ObjectMap objects;
+
+    uint32_t numInline = _numInline.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < numInline; ++i) objects[keyString(_inline[i].keyID)] = _inline[i].object;
+    for (auto& entry : _overflow) objects[keyString(entry.keyID)] = entry.object;
+
+    return objects;
+}
+
+void Auxiliary::setObjects(const ObjectMap& objects)
+{
+    clearObjects();
+    for (auto& [key, object] : objects) setObject(key, object);
+}
+
+void Auxiliary::copyObjects(const Auxiliary& rhs)
+{
+    if (&rhs == this) return;
+
+    clearObjects();
+
+    uint32_t numInline = rhs._numInline.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < numInline; ++i) setObject(rhs._inline[i].keyID, rhs._inline[i].object);
+    for (auto& entry : rhs._overflow) setObject(entry.keyID, entry.object);
 }
 
 int Auxiliary::compare(const Auxiliary& rhs) const
 {
-    auto lhs_itr = userObjects.begin();
-    auto rhs_itr = rhs.userObjects.begin();
-    while (lhs_itr != userObjects.end() && rhs_itr != rhs.userObjects.end())
+    auto lhs_objects = getObjects();
+    auto rhs_objects = rhs.getObjects();
+
+    auto lhs_itr = lhs_objects.begin();
+    auto rhs_itr = rhs_objects.begin();
+    while (lhs_itr != lhs_objects.end() && rhs_itr != rhs_objects.end())
     {
         if (lhs_itr->first < rhs_itr->first) return -1;
         if (lhs_itr->first > rhs_itr->first) return 1;
@@ -89,10 +283,10 @@ int Auxiliary::compare(const Auxiliary& rhs) const
         ++rhs_itr;
     }
 
-    // only can get here if either lhs_itr == userObjects.end() || rhs_itr == rhs.userObjects.end()
-    if (lhs_itr == userObjects.end())
+    // only can get here if either lhs_itr == lhs_objects.end() || rhs_itr == rhs_objects.end()
+    if (lhs_itr == lhs_objects.end())
     {
-        if (rhs_itr != rhs.userObjects.end())
+        if (rhs_itr != rhs_objects.end())
             return -1;
         else
             return 0;
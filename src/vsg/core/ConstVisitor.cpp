@@ -537,6 +537,10 @@ void ConstVisitor::apply(const QuadGroup& value)
 {
     apply(static_cast<const Node&>(value));
 }
+void ConstVisitor::apply(const SpatialGroup& value)
+{
+    apply(static_cast<const Node&>(value));
+}
 void ConstVisitor::apply(const LOD& value)
 {
     apply(static_cast<const Node&>(value));
@@ -613,6 +617,10 @@ void ConstVisitor::apply(const InstrumentationNode& value)
 {
     apply(static_cast<const Node&>(value));
 }
+void ConstVisitor::apply(const InstanceNode& value)
+{
+    apply(static_cast<const Transform&>(value));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -783,6 +791,14 @@ void ConstVisitor::apply(const ClearAttachments& value)
 {
     apply(static_cast<const Command&>(value));
 }
+void ConstVisitor::apply(const SetViewport& value)
+{
+    apply(static_cast<const Command&>(value));
+}
+void ConstVisitor::apply(const SetScissor& value)
+{
+    apply(static_cast<const Command&>(value));
+}
 void ConstVisitor::apply(const ClearColorImage& value)
 {
     apply(static_cast<const Command&>(value));
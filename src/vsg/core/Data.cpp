@@ -11,11 +11,15 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/core/Allocator.h>
+#include <vsg/core/Array.h>
 #include <vsg/core/Data.h>
 #include <vsg/io/Input.h>
 #include <vsg/io/Options.h>
 #include <vsg/io/Output.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace vsg;
 
 int Data::Properties::compare(const Properties& rhs) const
@@ -92,6 +96,12 @@ void Data::read(Input& input)
     }
 
     properties.format = VkFormat(format);
+
+    if (input.options && properties.dataVariance == STATIC_DATA)
+    {
+        auto hint = input.options->releaseDataHint;
+        if (hint == Options::RELEASE_ALL_DATA || (hint == Options::RELEASE_IMAGE_DATA && dimensions() >= 2)) properties.dataVariance = STATIC_DATA_UNREF_AFTER_TRANSFER;
+    }
 }
 
 void Data::write(Output& output) const
@@ -141,6 +151,73 @@ Data::MipmapOffsets Data::computeMipmapOffsets() const
     return offsets;
 }
 
+void Data::dirty(size_t offset, size_t size)
+{
+    auto& spans = _modifiedRange.spans;
+    if (!_modifiedRange.valid || _modifiedRange.synced)
+    {
+        _modifiedRange.start = _modifiedCount;
+        _modifiedRange.valid = true;
+        _modifiedRange.synced = false;
+        spans.clear();
+    }
+
+    // insert the span, coalescing with any spans it overlaps or touches
+    size_t begin = offset;
+    size_t end = offset + size;
+    auto itr = std::lower_bound(spans.begin(), spans.end(), begin, [](const std::pair<size_t, size_t>& span, size_t value) { return span.second < value; });
+    auto last = itr;
+    while (last != spans.end() && last->first <= end)
+    {
+        begin = std::min(begin, last->first);
+        end = std::max(end, last->second);
+        ++last;
+    }
+    itr = spans.erase(itr, last);
+    spans.insert(itr, {begin, end});
+
+    if (spans.size() > maxModifiedRanges)
+    {
+        // merge the pair of neighbouring spans with the smallest gap between them
+        size_t mergeIndex = 0;
+        size_t smallestGap = std::numeric_limits<size_t>::max();
+        for (size_t i = 0; i + 1 < spans.size(); ++i)
+        {
+            size_t gap = spans[i + 1].first - spans[i].second;
+            if (gap < smallestGap)
+            {
+                smallestGap = gap;
+                mergeIndex = i;
+            }
+        }
+        spans[mergeIndex].second = spans[mergeIndex + 1].second;
+        spans.erase(spans.begin() + mergeIndex + 1);
+    }
+
+    ++_modifiedCount;
+}
+
+bool Data::getModifiedRange(const ModifiedCount& mc, size_t& offset, size_t& size) const
+{
+    if (!_modifiedRange.valid || _modifiedRange.start != mc || _modifiedRange.spans.empty()) return false;
+
+    offset = _modifiedRange.spans.front().first;
+    size = _modifiedRange.spans.back().second - offset;
+    return true;
+}
+
+bool Data::getModifiedRanges(const ModifiedCount& mc, ModifiedRanges& ranges) const
+{
+    ranges.clear();
+    if (!_modifiedRange.valid || _modifiedRange.start != mc || _modifiedRange.spans.empty()) return false;
+
+    for (auto& [begin, end] : _modifiedRange.spans)
+    {
+        ranges.emplace_back(begin, end - begin);
+    }
+    return true;
+}
+
 std::size_t Data::computeValueCountIncludingMipmaps(std::size_t w, std::size_t h, std::size_t d, uint32_t numMipmaps)
 {
     if (numMipmaps <= 1) return w * h * d;
@@ -159,3 +236,54 @@ std::size_t Data::computeValueCountIncludingMipmaps(std::size_t w, std::size_t h
 
     return lastPosition;
 }
+
+namespace
+{
+    template<class A>
+    ref_ptr<Data> createArrayOfType(const Data& data, uint32_t numValues)
+    {
+        if (data.type_info() != typeid(A)) return {};
+        return A::create(numValues, Data::Properties(data.properties.format));
+    }
+} // namespace
+
+ref_ptr<Data> vsg::createArrayLike(const Data& data, uint32_t numValues)
+{
+    if (auto array = createArrayOfType<byteArray>(data, numValues)) return array;
+    if (auto array = createArrayOfType<ubyteArray>(data, numValues)) return array;
+    if (auto array = createArrayOfType<shortArray>(data, numValues)) return array;
+    if (auto array = createArrayOfType<ushortArray>(data, numValues)) return array;
+    if (auto array = createArrayOfType<intArray>(data, numValues)) return array;
+    if (auto array = createArrayOfType<uintArray>(data, numValues)) return array;
+    if (auto array = createArrayOfType<floatArray>(data, numValues)) return array;
+    if (auto array = createArrayOfType<doubleArray>(data, numValues)) return array;
+    if (auto array = createArrayOfType<vec2Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<vec3Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<vec4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<dvec2Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<dvec3Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<dvec4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<bvec2Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<bvec3Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<bvec4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<ubvec2Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<ubvec3Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<ubvec4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<svec2Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<svec3Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<svec4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<usvec2Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<usvec3Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<usvec4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<ivec2Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<ivec3Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<ivec4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<uivec2Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<uivec3Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<uivec4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<mat4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<dmat4Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<block64Array>(data, numValues)) return array;
+    if (auto array = createArrayOfType<block128Array>(data, numValues)) return array;
+    return {};
+}
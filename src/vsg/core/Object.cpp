@@ -10,6 +10,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/app/DeleteQueue.h>
 #include <vsg/core/Allocator.h>
 #include <vsg/core/Auxiliary.h>
 #include <vsg/core/ConstVisitor.h>
@@ -35,8 +36,7 @@ Object::Object(const Object& rhs) :
     if (rhs._auxiliary && rhs._auxiliary->getConnectedObject() == &rhs)
     {
         // the rhs's auxiliary is uniquely attached to it, so we need to create our own and copy its ObjectMap across
-        auto& userObjects = getOrCreateAuxiliary()->userObjects;
-        userObjects = rhs._auxiliary->userObjects;
+        getOrCreateAuxiliary()->copyObjects(*rhs._auxiliary);
     }
 }
 
@@ -49,8 +49,7 @@ Object& Object::operator=(const Object& rhs)
     if (rhs._auxiliary)
     {
         // the rhs's auxiliary is uniquely attached to it, so we need to create our own and copy its ObjectMap across
-        auto& userObjects = getOrCreateAuxiliary()->userObjects;
-        userObjects = rhs._auxiliary->userObjects;
+        getOrCreateAuxiliary()->copyObjects(*rhs._auxiliary);
     }
 
     return *this;
@@ -74,6 +73,9 @@ void Object::_attemptDelete() const
     // if no auxiliary is attached then go straight ahead and delete.
     if (_auxiliary == nullptr || _auxiliary->signalConnectedObjectToBeDeleted())
     {
+        // when the current thread has been designated to defer deletes let its DeleteQueue delete the object on a background thread
+        if (DeleteQueue::deferDelete(this)) return;
+
         //debug("Object::_delete() ", this, " calling delete");
 
         delete this;
@@ -116,11 +118,13 @@ void Object::read(Input& input)
     auto numObjects = input.readValue<uint32_t>("userObjects");
     if (numObjects > 0)
     {
-        auto& objectMap = getOrCreateAuxiliary()->userObjects;
+        auto auxiliary = getOrCreateAuxiliary();
         for (; numObjects > 0; --numObjects)
         {
             std::string key = input.readValue<std::string>("key");
-            input.readObject("object", objectMap[key]);
+            ref_ptr<Object> object;
+            input.readObject("object", object);
+            auxiliary->setObject(key, object);
         }
     }
 }
@@ -130,7 +134,7 @@ void Object::write(Output& output) const
     if (_auxiliary)
     {
         // we have a unique auxiliary, need to write out its ObjectMap entries
-        auto& userObjects = _auxiliary->userObjects;
+        auto userObjects = _auxiliary->getObjects();
         output.writeValue<uint32_t>("userObjects", userObjects.size());
         for (auto& entry : userObjects)
         {
@@ -177,7 +181,7 @@ void Object::removeObject(const std::string& key)
 {
     if (_auxiliary)
     {
-        _auxiliary->userObjects.erase(key);
+        _auxiliary->removeObject(key);
     }
 }
 
@@ -0,0 +1,452 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/SizeClassAllocator.h>
+#include <vsg/io/Logger.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <new>
+
+using namespace vsg;
+
+namespace
+{
+    struct FreeSlot
+    {
+        FreeSlot* next;
+    };
+
+    // slabs are looked up from a pointer using a two level table indexed by the pointer's slab number, covering a 48 bit address space.
+    constexpr size_t slabShift = 18;
+    constexpr size_t leafBits = 16;
+    constexpr size_t leafSize = size_t(1) << leafBits;
+    constexpr size_t rootSize = size_t(1) << (48 - slabShift - leafBits);
+
+    static_assert((size_t(1) << slabShift) == SizeClassAllocator::slabSize, "slabShift must match SizeClassAllocator::slabSize");
+
+    std::atomic<uint64_t> s_nextInstanceID{1};
+
+    // set once this thread's ThreadCache has been destroyed so that deallocations from later destructors bypass it
+    thread_local bool s_threadCacheDestroyed = false;
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// SizeClassAllocator::Pools
+//
+struct SizeClassAllocator::Pools
+{
+    // entries hold sizeClass + 1 for slabs owned by these Pools, 0 otherwise
+    using Leaf = std::array<std::atomic<uint8_t>, leafSize>;
+
+    struct SizeClass
+    {
+        std::mutex mutex;
+        FreeSlot* freeSlots = nullptr;
+        uint8_t* unusedBegin = nullptr;
+        uint8_t* unusedEnd = nullptr;
+        size_t numSlabs = 0;
+        size_t slotsTaken = 0; // slots either in use or held in thread caches
+    };
+
+    std::array<SizeClass, numSizeClasses> sizeClasses;
+
+    std::mutex slabMutex;
+    std::vector<uint8_t*> slabs;
+    std::unique_ptr<std::atomic<Leaf*>[]> root;
+
+    mutable std::mutex threadCachesMutex;
+    std::vector<ThreadCache*> threadCaches;
+
+    Pools() :
+        root(new std::atomic<Leaf*>[rootSize])
+    {
+        for (size_t i = 0; i < rootSize; ++i) root[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~Pools()
+    {
+        for (auto slab : slabs)
+        {
+            operator delete(slab, std::align_val_t(slabSize));
+        }
+
+        for (size_t i = 0; i < rootSize; ++i)
+        {
+            delete root[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    /// return the size class of the slab containing ptr, or numSizeClasses if ptr wasn't allocated from these Pools
+    size_t findSizeClass(const void* ptr) const
+    {
+        auto slabNumber = reinterpret_cast<uintptr_t>(ptr) >> slabShift;
+        if ((slabNumber >> leafBits) >= rootSize) return numSizeClasses;
+
+        auto leaf = root[slabNumber >> leafBits].load(std::memory_order_acquire);
+        if (!leaf) return numSizeClasses;
+
+        auto value = (*leaf)[slabNumber & (leafSize - 1)].load(std::memory_order_relaxed);
+        return value == 0 ? numSizeClasses : size_t(value - 1);
+    }
+
+    /// allocate a new slab and register it for the size class, return nullptr if the slab can't be registered
+    uint8_t* createSlab(size_t sc)
+    {
+        auto slab = static_cast<uint8_t*>(operator new(slabSize, std::align_val_t(slabSize)));
+
+        auto slabNumber = reinterpret_cast<uintptr_t>(slab) >> slabShift;
+        if ((slabNumber >> leafBits) >= rootSize)
+        {
+            operator delete(slab, std::align_val_t(slabSize));
+            return nullptr;
+        }
+
+        std::scoped_lock<std::mutex> lock(slabMutex);
+
+        auto& leafEntry = root[slabNumber >> leafBits];
+        auto leaf = leafEntry.load(std::memory_order_relaxed);
+        if (!leaf)
+        {
+            leaf = new Leaf;
+            for (auto& value : *leaf) value.store(0, std::memory_order_relaxed);
+            leafEntry.store(leaf, std::memory_order_release);
+        }
+        (*leaf)[slabNumber & (leafSize - 1)].store(static_cast<uint8_t>(sc + 1), std::memory_order_relaxed);
+
+        slabs.push_back(slab);
+        return slab;
+    }
+
+    /// take up to count slots from the size class, returning them as a linked list, count is set to the number of slots taken
+    FreeSlot* takeSlots(size_t sc, uint32_t& count)
+    {
+        auto& sizeClass = sizeClasses[sc];
+        size_t size = slotSize(sc);
+
+        std::scoped_lock<std::mutex> lock(sizeClass.mutex);
+
+        FreeSlot* head = nullptr;
+        uint32_t taken = 0;
+        while (taken < count)
+        {
+            if (sizeClass.freeSlots)
+            {
+                auto slot = sizeClass.freeSlots;
+                sizeClass.freeSlots = slot->next;
+                slot->next = head;
+                head = slot;
+            }
+            else
+            {
+                if (sizeClass.unusedBegin == sizeClass.unusedEnd)
+                {
+                    if (taken > 0) break;
+
+                    auto slab = createSlab(sc);
+                    if (!slab) break;
+
+                    sizeClass.unusedBegin = slab;
+                    sizeClass.unusedEnd = slab + (slabSize / size) * size;
+                    ++sizeClass.numSlabs;
+                }
+
+                auto slot = reinterpret_cast<FreeSlot*>(sizeClass.unusedBegin);
+                sizeClass.unusedBegin += size;
+                slot->next = head;
+                head = slot;
+            }
+            ++taken;
+        }
+
+        sizeClass.slotsTaken += taken;
+        count = taken;
+        return head;
+    }
+
+    /// return a linked list of count slots to the size class
+    void returnSlots(size_t sc, FreeSlot* head, uint32_t count)
+    {
+        auto tail = head;
+        while (tail->next) tail = tail->next;
+
+        auto& sizeClass = sizeClasses[sc];
+
+        std::scoped_lock<std::mutex> lock(sizeClass.mutex);
+
+        tail->next = sizeClass.freeSlots;
+        sizeClass.freeSlots = head;
+        sizeClass.slotsTaken -= count;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// SizeClassAllocator::ThreadCache
+//
+struct SizeClassAllocator::ThreadCache
+{
+    struct List
+    {
+        FreeSlot* head = nullptr;
+        std::atomic<uint32_t> count{0};
+    };
+
+    uint64_t instanceID = 0;
+    std::weak_ptr<Pools> pools;
+    std::array<List, numSizeClasses> lists;
+
+    ~ThreadCache()
+    {
+        release();
+        s_threadCacheDestroyed = true;
+    }
+
+    /// return all cached slots to the Pools they came from, if they still exist
+    void release()
+    {
+        if (auto p = pools.lock())
+        {
+            for (size_t sc = 0; sc < numSizeClasses; ++sc)
+            {
+                auto& list = lists[sc];
+                if (list.head) p->returnSlots(sc, list.head, list.count.exchange(0, std::memory_order_relaxed));
+            }
+
+            std::scoped_lock<std::mutex> lock(p->threadCachesMutex);
+            p->threadCaches.erase(std::remove(p->threadCaches.begin(), p->threadCaches.end(), this), p->threadCaches.end());
+        }
+
+        for (auto& list : lists)
+        {
+            list.head = nullptr;
+            list.count.store(0, std::memory_order_relaxed);
+        }
+
+        pools.reset();
+        instanceID = 0;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// SizeClassAllocator
+//
+SizeClassAllocator::SizeClassAllocator(std::unique_ptr<Allocator> in_nestedAllocator) :
+    Allocator(std::move(in_nestedAllocator)),
+    _pools(std::make_shared<Pools>()),
+    _instanceID(s_nextInstanceID.fetch_add(1))
+{
+    if (memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS)
+    {
+        info("SizeClassAllocator()", this);
+    }
+}
+
+SizeClassAllocator::~SizeClassAllocator()
+{
+    if (memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS)
+    {
+        info("~SizeClassAllocator() ", this);
+    }
+}
+
+size_t SizeClassAllocator::sizeClass(size_t size)
+{
+    if (size <= 256) return size == 0 ? 0 : (size - 1) / 16;
+
+    size_t sc = 16;
+    for (size_t classSize = 512; classSize < size; classSize *= 2) ++sc;
+    return sc;
+}
+
+size_t SizeClassAllocator::slotSize(size_t sc)
+{
+    if (sc < 16) return (sc + 1) * 16;
+    return size_t(512) << (sc - 16);
+}
+
+SizeClassAllocator::ThreadCache* SizeClassAllocator::_getThreadCache()
+{
+    if (s_threadCacheDestroyed) return nullptr;
+
+    static thread_local ThreadCache s_threadCache;
+
+    if (s_threadCache.instanceID != _instanceID)
+    {
+        // this thread was last used with another SizeClassAllocator so return its slots before switching over
+        s_threadCache.release();
+        s_threadCache.instanceID = _instanceID;
+        s_threadCache.pools = _pools;
+
+        std::scoped_lock<std::mutex> lock(_pools->threadCachesMutex);
+        _pools->threadCaches.push_back(&s_threadCache);
+    }
+
+    return &s_threadCache;
+}
+
+void* SizeClassAllocator::allocate(std::size_t size, AllocatorAffinity allocatorAffinity)
+{
+    if (allocatorType != ALLOCATOR_TYPE_VSG_ALLOCATOR || allocatorAffinity == ALLOCATOR_AFFINITY_DATA || size > maxSizeClassSize)
+    {
+        return Allocator::allocate(size, allocatorAffinity);
+    }
+
+    size_t sc = sizeClass(size);
+    auto threadCache = _getThreadCache();
+    if (!threadCache)
+    {
+        uint32_t count = 1;
+        if (auto slot = _pools->takeSlots(sc, count)) return slot;
+        return Allocator::allocate(size, allocatorAffinity);
+    }
+
+    auto& list = threadCache->lists[sc];
+    if (!list.head)
+    {
+        uint32_t count = std::max(threadCacheSize / 2, 1u);
+        list.head = _pools->takeSlots(sc, count);
+        list.count.store(count, std::memory_order_relaxed);
+
+        if (!list.head)
+        {
+            // unable to create a slab that can be looked up, so fallback to the base Allocator
+            return Allocator::allocate(size, allocatorAffinity);
+        }
+    }
+
+    auto slot = list.head;
+    list.head = slot->next;
+    list.count.store(list.count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+    if (memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS)
+    {
+        info("SizeClassAllocator::allocate(", size, ", ", int(allocatorAffinity), ") ptr = ", slot, ", sizeClass = ", sc);
+    }
+
+    return slot;
+}
+
+bool SizeClassAllocator::deallocate(void* ptr, std::size_t size)
+{
+    size_t sc = ptr ? _pools->findSizeClass(ptr) : numSizeClasses;
+    if (sc >= numSizeClasses)
+    {
+        return Allocator::deallocate(ptr, size);
+    }
+
+    auto slot = static_cast<FreeSlot*>(ptr);
+
+    auto threadCache = _getThreadCache();
+    if (!threadCache)
+    {
+        slot->next = nullptr;
+        _pools->returnSlots(sc, slot, 1);
+        return true;
+    }
+
+    auto& list = threadCache->lists[sc];
+    slot->next = list.head;
+    list.head = slot;
+
+    uint32_t count = list.count.load(std::memory_order_relaxed) + 1;
+    if (count > threadCacheSize)
+    {
+        // retain the most recently freed half of the slots, return the rest to the size class
+        uint32_t retain = threadCacheSize / 2;
+        if (retain > 0)
+        {
+            auto last = list.head;
+            for (uint32_t i = 1; i < retain; ++i) last = last->next;
+
+            auto head = last->next;
+            last->next = nullptr;
+            _pools->returnSlots(sc, head, count - retain);
+        }
+        else
+        {
+            _pools->returnSlots(sc, list.head, count);
+            list.head = nullptr;
+        }
+        count = retain;
+    }
+    list.count.store(count, std::memory_order_relaxed);
+
+    if (memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS)
+    {
+        info("SizeClassAllocator::deallocate(", ptr, ", ", size, ") sizeClass = ", sc);
+    }
+
+    return true;
+}
+
+size_t SizeClassAllocator::totalAvailableSize() const
+{
+    return totalMemorySize() - totalReservedSize();
+}
+
+size_t SizeClassAllocator::totalReservedSize() const
+{
+    std::array<size_t, numSizeClasses> cached{};
+    {
+        std::scoped_lock<std::mutex> lock(_pools->threadCachesMutex);
+        for (auto threadCache : _pools->threadCaches)
+        {
+            for (size_t sc = 0; sc < numSizeClasses; ++sc) cached[sc] += threadCache->lists[sc].count.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t size = Allocator::totalReservedSize();
+    for (size_t sc = 0; sc < numSizeClasses; ++sc)
+    {
+        auto& sizeClass = _pools->sizeClasses[sc];
+        std::scoped_lock<std::mutex> lock(sizeClass.mutex);
+        if (sizeClass.slotsTaken > cached[sc]) size += (sizeClass.slotsTaken - cached[sc]) * slotSize(sc);
+    }
+    return size;
+}
+
+size_t SizeClassAllocator::totalMemorySize() const
+{
+    size_t size = Allocator::totalMemorySize();
+    for (auto& sizeClass : _pools->sizeClasses)
+    {
+        std::scoped_lock<std::mutex> lock(sizeClass.mutex);
+        size += sizeClass.numSlabs * slabSize;
+    }
+    return size;
+}
+
+void SizeClassAllocator::report(std::ostream& out) const
+{
+    Allocator::report(out);
+
+    size_t numThreadCaches = 0;
+    {
+        std::scoped_lock<std::mutex> lock(_pools->threadCachesMutex);
+        numThreadCaches = _pools->threadCaches.size();
+    }
+
+    out << "SizeClassAllocator::report() " << numSizeClasses << " size classes, " << numThreadCaches << " thread caches" << std::endl;
+    for (size_t sc = 0; sc < numSizeClasses; ++sc)
+    {
+        auto& sizeClass = _pools->sizeClasses[sc];
+        std::scoped_lock<std::mutex> lock(sizeClass.mutex);
+        if (sizeClass.numSlabs > 0)
+        {
+            out << "SizeClass_" << slotSize(sc) << " " << sizeClass.numSlabs << " slabs [taken = " << sizeClass.slotsTaken * slotSize(sc) << ", memory = " << sizeClass.numSlabs * slabSize << "]" << std::endl;
+        }
+    }
+}
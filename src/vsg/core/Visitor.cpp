@@ -537,6 +537,10 @@ void Visitor::apply(QuadGroup& value)
 {
     apply(static_cast<Node&>(value));
 }
+void Visitor::apply(SpatialGroup& value)
+{
+    apply(static_cast<Node&>(value));
+}
 void Visitor::apply(LOD& value)
 {
     apply(static_cast<Node&>(value));
@@ -613,6 +617,10 @@ void Visitor::apply(InstrumentationNode& value)
 {
     apply(static_cast<Node&>(value));
 }
+void Visitor::apply(InstanceNode& value)
+{
+    apply(static_cast<Transform&>(value));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -783,6 +791,14 @@ void Visitor::apply(ClearAttachments& value)
 {
     apply(static_cast<Command&>(value));
 }
+void Visitor::apply(SetViewport& value)
+{
+    apply(static_cast<Command&>(value));
+}
+void Visitor::apply(SetScissor& value)
+{
+    apply(static_cast<Command&>(value));
+}
 void Visitor::apply(ClearColorImage& value)
 {
     apply(static_cast<Command&>(value));
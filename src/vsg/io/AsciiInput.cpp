@@ -15,18 +15,110 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/ReaderWriter.h>
 
 #include <cstring>
+#include <locale>
+#include <sstream>
 
 using namespace vsg;
 
+namespace
+{
+    // size of the blocks read from the stream, the buffer grows if a single token is longer than this
+    constexpr size_t s_blockSize = 1024 * 1024;
+
+    // whitespace as defined by the classic locale
+    inline bool is_space(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    template<typename T>
+    void parse_real(std::string_view token, T& value)
+    {
+#if defined(__cpp_lib_to_chars)
+        if (std::from_chars(token.data(), token.data() + token.size(), value).ec != std::errc()) value = 0;
+#else
+        // floating point std::from_chars isn't supported by this standard library, so fallback to a classic locale stream
+        std::istringstream str{std::string(token)};
+        str.imbue(std::locale::classic());
+        if (!(str >> value)) value = 0;
+#endif
+    }
+} // namespace
+
 AsciiInput::AsciiInput(std::istream& input, ref_ptr<ObjectFactory> in_objectFactory, ref_ptr<const Options> in_options) :
     Input(in_objectFactory, in_options),
-    _input(input)
+    _input(input),
+    _buffer(s_blockSize)
+{
+}
+
+bool AsciiInput::_fill(size_t keep)
+{
+    // move the characters still required to the start of the buffer
+    if (keep > 0)
+    {
+        std::memmove(_buffer.data(), _buffer.data() + keep, _end - keep);
+        _position -= keep;
+        _end -= keep;
+    }
+
+    if (!_input.good()) return false;
+
+    // grow the buffer if it's full, so that a token longer than the buffer can be read
+    if (_buffer.size() - _end < s_blockSize / 2) _buffer.resize(_buffer.size() + s_blockSize);
+
+    _input.read(_buffer.data() + _end, static_cast<std::streamsize>(_buffer.size() - _end));
+    auto count = static_cast<size_t>(_input.gcount());
+    _end += count;
+
+    return count > 0;
+}
+
+bool AsciiInput::_get(char& c)
+{
+    if (_position >= _end && !_fill(_position)) return false;
+
+    c = _buffer[_position++];
+    return true;
+}
+
+std::string_view AsciiInput::_token()
+{
+    // skip leading whitespace
+    for (;;)
+    {
+        while (_position < _end && is_space(_buffer[_position])) ++_position;
+        if (_position < _end || !_fill(_position)) break;
+    }
+
+    size_t start = _position;
+    for (;;)
+    {
+        while (_position < _end && !is_space(_buffer[_position])) ++_position;
+        if (_position < _end) break;
+
+        // the token runs to the end of the buffer, so read more of the stream to complete it
+        bool more = _fill(start);
+        start = 0;
+        if (!more) break;
+    }
+
+    return std::string_view(_buffer.data() + start, _position - start);
+}
+
+void AsciiInput::_parse(float& value)
+{
+    parse_real(_token(), value);
+}
+
+void AsciiInput::_parse(double& value)
 {
+    parse_real(_token(), value);
 }
 
 bool AsciiInput::matchPropertyName(const char* propertyName)
 {
-    _input >> _readPropertyName;
+    _readPropertyName = _token();
     if (_readPropertyName != propertyName)
     {
         error("Unable to match ", propertyName, " got ", _readPropertyName, " instead.");
@@ -37,14 +129,11 @@ bool AsciiInput::matchPropertyName(const char* propertyName)
 
 AsciiInput::OptionalObjectID AsciiInput::objectID()
 {
-    std::string token;
-    _input >> token;
+    auto token = _token();
     if (token.compare(0, 3, "id=") == 0)
     {
-        token.erase(0, 3);
-        std::stringstream str(token);
-        ObjectID id;
-        str >> id;
+        ObjectID id = 0;
+        std::from_chars(token.data() + 3, token.data() + token.size(), id);
         return OptionalObjectID{true, id};
     }
     else
@@ -57,40 +146,39 @@ void AsciiInput::_read(std::string& value)
 {
     value.clear();
 
+    auto token = _token();
+    if (token.empty()) return;
+
+    if (token.front() != '"')
+    {
+        value = token;
+        return;
+    }
+
+    // quoted strings may contain whitespace, so rewind to just after the opening quote and read character by character
+    _position -= token.size() - 1;
+
     char c;
-    _input >> c;
-    if (_input.good())
+    while (_get(c))
     {
-        if (c == '"')
+        if (c == '\\')
         {
-            _input.get(c);
-            while (_input.good())
+            if (!_get(c)) break;
+            if (c == '"')
+                value.push_back(c);
+            else
             {
-                if (c == '\\')
-                {
-                    _input.get(c);
-                    if (c == '"')
-                        value.push_back(c);
-                    else
-                    {
-                        value.push_back('\\');
-                        value.push_back(c);
-                    }
-                }
-                else if (c != '"')
-                {
-                    value.push_back(c);
-                }
-                else
-                {
-                    break;
-                }
-                _input.get(c);
+                value.push_back('\\');
+                value.push_back(c);
             }
         }
+        else if (c != '"')
+        {
+            value.push_back(c);
+        }
         else
         {
-            _input >> value;
+            break;
         }
     }
 }
@@ -166,8 +254,7 @@ vsg::ref_ptr<vsg::Object> AsciiInput::read()
         }
         else
         {
-            std::string className;
-            _input >> className;
+            std::string className(_token());
 
             //debug("Loading new object ", className);
 
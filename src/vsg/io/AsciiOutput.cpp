@@ -15,6 +15,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/AsciiOutput.h>
 
 #include <cstring>
+#include <locale>
+#include <sstream>
 
 using namespace vsg;
 
@@ -23,28 +25,53 @@ AsciiOutput::AsciiOutput(std::ostream& output, ref_ptr<const Options> in_options
     _output(output)
 {
     _maximumIndentation = std::strlen(_indentationString);
+    _buffer.reserve(_blockSize);
+}
+
+AsciiOutput::~AsciiOutput()
+{
+    flush();
+}
+
+void AsciiOutput::flush()
+{
+    if (_buffer.empty()) return;
+
+    _output.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _buffer.clear();
+}
+
+void AsciiOutput::_appendReal(double value, int precision)
+{
+#if defined(__cpp_lib_to_chars)
+    // std::chars_format::general with a precision matches printf's %g, as used by std::ostream's default floating point formatting
+    char str[64];
+    auto result = std::to_chars(str, str + sizeof(str), value, std::chars_format::general, precision);
+    _append(str, static_cast<size_t>(result.ptr - str));
+#else
+    // floating point std::to_chars isn't supported by this standard library, so fallback to a classic locale stream
+    std::ostringstream str;
+    str.imbue(std::locale::classic());
+    str.precision(precision);
+    str << value;
+    auto formatted = str.str();
+    _append(formatted.data(), formatted.size());
+#endif
 }
 
 void AsciiOutput::writePropertyName(const char* propertyName)
 {
-    indent() << propertyName;
+    indent();
+    _append(propertyName);
 }
 
 void AsciiOutput::write(size_t num, const std::string* value)
 {
-    if (num == 1)
+    for (; num > 0; --num, ++value)
     {
-        _output << ' ';
+        _append(' ');
         _write(*value);
     }
-    else
-    {
-        for (; num > 0; --num, ++value)
-        {
-            _output << ' ';
-            _write(*value);
-        }
-    }
 }
 
 void AsciiOutput::_write(const std::wstring& str)
@@ -56,36 +83,20 @@ void AsciiOutput::_write(const std::wstring& str)
 
 void AsciiOutput::write(size_t num, const std::wstring* value)
 {
-    if (num == 1)
+    for (; num > 0; --num, ++value)
     {
-        _output << ' ';
+        _append(' ');
         _write(*value);
     }
-    else
-    {
-        for (; num > 0; --num, ++value)
-        {
-            _output << ' ';
-            _write(*value);
-        }
-    }
 }
 
 void AsciiOutput::write(size_t num, const Path* value)
 {
-    if (num == 1)
+    for (; num > 0; --num, ++value)
     {
-        _output << ' ';
+        _append(' ');
         _write(value->string());
     }
-    else
-    {
-        for (; num > 0; --num, ++value)
-        {
-            _output << ' ';
-            _write(value->string());
-        }
-    }
 }
 
 void AsciiOutput::write(const vsg::Object* object)
@@ -93,28 +104,34 @@ void AsciiOutput::write(const vsg::Object* object)
     if (auto itr = objectIDMap.find(object); itr != objectIDMap.end())
     {
         // write out the objectID
-        _output << " id=" << itr->second << "\n";
+        _append(" id=");
+        _appendNumber(itr->second);
+        _append('\n');
         return;
     }
 
     ObjectID id = objectID++;
     objectIDMap[object] = id;
 
+    _append(" id=");
+    _appendNumber(id);
+
     if (object)
     {
-#if 0
-        _output<<"id="<<id<<" "<<vsg::type_name(*object)<<"\n";
-#else
-        _output << " id=" << id << " " << object->className() << "\n";
-#endif
-        indent() << "{\n";
+        _append(' ');
+        _append(object->className());
+        _append('\n');
+
+        indent();
+        _append("{\n");
         _indentation += _indentationStep;
         object->write(*this);
         _indentation -= _indentationStep;
-        indent() << "}\n";
+        indent();
+        _append("}\n");
     }
     else
     {
-        _output << " id=" << id << " nullptr\n";
+        _append(" nullptr\n");
     }
 }
@@ -0,0 +1,174 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Exception.h>
+#include <vsg/io/AsyncLogger.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace vsg;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// AsyncLogger
+//
+AsyncLogger::AsyncLogger(ref_ptr<Logger> in_output, size_t in_capacity) :
+    output(in_output)
+{
+    // the ring buffer is thread safe so there is no need to serialize calls to the *_implementation() methods
+    _serializeImplementation = false;
+
+    if (output) output->level = LOGGER_ALL;
+
+    size_t capacity = 2;
+    while (capacity < in_capacity) capacity *= 2;
+
+    _mask = capacity - 1;
+    _records.reset(new Record[capacity]);
+    for (size_t i = 0; i < capacity; ++i) _records[i].sequence.store(i, std::memory_order_relaxed);
+
+    _thread = std::thread(&AsyncLogger::_run, this);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    _active = false;
+    {
+        std::scoped_lock<std::mutex> lock(_sleepMutex);
+        _sleepCV.notify_all();
+    }
+    if (_thread.joinable()) _thread.join();
+
+    flush();
+}
+
+void AsyncLogger::_push(Level msg_level, const std::string_view& message)
+{
+    // bounded multi-producer queue using per record sequence numbers, based on Dmitry Vyukov's bounded MPMC queue.
+    Record* record = nullptr;
+    size_t pos = _head.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        record = &_records[pos & _mask];
+        size_t sequence = record->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+            if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0)
+        {
+            // ring buffer is full so drop the message rather than block
+            ++_dropped;
+            return;
+        }
+        else
+        {
+            pos = _head.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->level = msg_level;
+    record->length = static_cast<uint32_t>(std::min(message.size(), maxMessageLength));
+    std::memcpy(record->text, message.data(), record->length);
+    record->sequence.store(pos + 1, std::memory_order_release);
+
+    if (_sleeping.load())
+    {
+        std::scoped_lock<std::mutex> lock(_sleepMutex);
+        _sleepCV.notify_one();
+    }
+}
+
+bool AsyncLogger::_pop(Level& msg_level, std::string& message)
+{
+    size_t pos = _tail.load(std::memory_order_relaxed);
+    Record* record = &_records[pos & _mask];
+    if (record->sequence.load(std::memory_order_acquire) != pos + 1) return false;
+
+    // only one thread drains at a time, guarded by _drainMutex, so the tail can be advanced without a compare exchange
+    msg_level = record->level;
+    message.assign(record->text, record->length);
+    _tail.store(pos + 1, std::memory_order_relaxed);
+    record->sequence.store(pos + _mask + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncLogger::_drain()
+{
+    std::scoped_lock<std::mutex> lock(_drainMutex);
+
+    bool written = false;
+    Level msg_level;
+    while (_pop(msg_level, _message))
+    {
+        if (output) output->log(msg_level, _message);
+        written = true;
+    }
+
+    if (auto dropped = _dropped.load(); dropped != _reportedDropped)
+    {
+        if (output) output->warn("AsyncLogger dropped ", dropped - _reportedDropped, " messages as the ring buffer was full.");
+        _reportedDropped = dropped;
+    }
+
+    return written;
+}
+
+void AsyncLogger::_run()
+{
+    while (_active)
+    {
+        if (_drain()) continue;
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleeping = true;
+        _sleepCV.wait_for(lock, std::chrono::milliseconds(100), [&]() { return !_active || _head.load() != _tail.load(); });
+        _sleeping = false;
+    }
+}
+
+void AsyncLogger::flush()
+{
+    _drain();
+    if (output) output->flush();
+}
+
+void AsyncLogger::debug_implementation(const std::string_view& message)
+{
+    _push(LOGGER_DEBUG, message);
+}
+
+void AsyncLogger::info_implementation(const std::string_view& message)
+{
+    _push(LOGGER_INFO, message);
+}
+
+void AsyncLogger::warn_implementation(const std::string_view& message)
+{
+    _push(LOGGER_WARN, message);
+}
+
+void AsyncLogger::error_implementation(const std::string_view& message)
+{
+    _push(LOGGER_ERROR, message);
+}
+
+void AsyncLogger::fatal_implementation(const std::string_view& message)
+{
+    // fatal messages throw an exception so write all pending messages then pass the fatal message directly to the output
+    flush();
+    if (output) output->fatal(message);
+    throw vsg::Exception{std::string(message)};
+}
@@ -11,10 +11,17 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/io/BinaryInput.h>
+#include <vsg/io/BinaryOutput.h>
 #include <vsg/io/Logger.h>
+#include <vsg/io/MappedFile.h>
 #include <vsg/io/ReaderWriter.h>
+#include <vsg/io/compression.h>
+#include <vsg/io/mem_stream.h>
+#include <vsg/threading/OperationThreads.h>
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 using namespace vsg;
 
@@ -22,6 +29,142 @@ BinaryInput::BinaryInput(std::istream& input, ref_ptr<ObjectFactory> in_objectFa
     Input(in_objectFactory, in_options),
     _input(input)
 {
+    rawFields = true;
+}
+
+ref_ptr<Data> BinaryInput::mapData(size_t size, size_t& offset)
+{
+    if (version_greater_equal(1, 1, 4))
+    {
+        _read(1, &_dataCodec);
+
+        // compressed blocks can't be referenced in place so leave them to readData()
+        if (_dataCodec != COMPRESSION_NONE) return {};
+    }
+
+    if (!alignedData) return {};
+
+    std::streamoff position = _input.tellg();
+    if (position < 0) return {};
+
+    size_t alignment = MappedFile::alignment(size);
+    size_t start = ((static_cast<size_t>(position) + alignment - 1) / alignment) * alignment;
+
+    // Array storage offsets are 32bit so blocks beyond 4GB into the file have to be copied
+    if (mappedStorage && (start + size) <= mappedStorage->dataSize() && start <= std::numeric_limits<uint32_t>::max())
+    {
+        _input.seekg(static_cast<std::streamoff>(start + size));
+        offset = start;
+        return mappedStorage;
+    }
+
+    _input.ignore(static_cast<std::streamsize>(start - static_cast<size_t>(position)));
+    return {};
+}
+
+bool BinaryInput::readData(void* ptr, size_t valueSize, size_t count)
+{
+    if (_dataCodec == COMPRESSION_NONE) return false;
+
+    auto codec = static_cast<CompressionCodec>(_dataCodec);
+    _dataCodec = COMPRESSION_NONE;
+
+    size_t size = valueSize * count;
+    uint8_t* dest = reinterpret_cast<uint8_t*>(ptr);
+
+    // the destination is zeroed and the stream marked as failed so that invalid data isn't left in place of the values or read as following fields
+    auto failed = [&](const char* reason) {
+        warn("BinaryInput::readData(..) compressed data of size ", size, " ", reason);
+        std::memset(dest, 0, size);
+        _input.setstate(std::ios::failbit);
+        return true;
+    };
+
+    uint32_t header[2] = {0, 0};
+    _read(2, header);
+    size_t chunkSize = header[0];
+    size_t numChunks = header[1];
+
+    // the chunk size and count must match the destination before anything is allocated from them
+    if (!_input || chunkSize == 0 || numChunks != (size + chunkSize - 1) / chunkSize) return failed("has invalid chunks.");
+
+    // bytes remaining in the file or seekable stream, bounding the compressed sizes read from it
+    size_t remaining = std::numeric_limits<size_t>::max();
+    std::streamoff position = _input.tellg();
+    if (mappedStorage && position >= 0)
+    {
+        remaining = (static_cast<size_t>(position) <= mappedStorage->dataSize()) ? mappedStorage->dataSize() - static_cast<size_t>(position) : 0;
+    }
+    else if (position >= 0)
+    {
+        _input.seekg(0, std::ios::end);
+        std::streamoff end = _input.tellg();
+        _input.seekg(position);
+        if (end >= position) remaining = static_cast<size_t>(end - position);
+    }
+
+    if (numChunks > remaining / sizeof(uint32_t)) return failed("has more chunks than the file contains.");
+
+    std::vector<uint32_t> chunkSizes(numChunks);
+    _read(numChunks, chunkSizes.data());
+    remaining -= numChunks * sizeof(uint32_t);
+
+    size_t payloadSize = 0;
+    for (auto chunk : chunkSizes)
+    {
+        payloadSize += chunk;
+        if (payloadSize > remaining) return failed("has chunks larger than the file contains.");
+    }
+
+    // decompress straight from memory mapped files, otherwise read the compressed payload into a temporary buffer
+    std::vector<uint8_t> buffer;
+    const uint8_t* payload = nullptr;
+    if (mappedStorage && position >= 0)
+    {
+        position = _input.tellg();
+        payload = reinterpret_cast<const uint8_t*>(mappedStorage->dataPointer()) + position;
+        _input.seekg(static_cast<std::streamoff>(position + payloadSize));
+    }
+    else
+    {
+        buffer.resize(payloadSize);
+        _read(payloadSize, buffer.data());
+        payload = buffer.data();
+    }
+
+    if (!_input) return failed("is truncated.");
+
+    std::atomic_bool succeeded{true};
+    auto decompressChunk = [&](size_t i, size_t payloadOffset) {
+        size_t offset = chunkSize * i;
+        if (!decompress(codec, payload + payloadOffset, chunkSizes[i], dest + offset, std::min(chunkSize, size - offset), valueSize)) succeeded = false;
+    };
+
+    auto operationThreads = options ? options->operationThreads : ref_ptr<OperationThreads>();
+    if (operationThreads && numChunks > 1)
+    {
+        std::vector<std::function<void()>> functions;
+        size_t payloadOffset = 0;
+        for (size_t i = 0; i < numChunks; ++i)
+        {
+            functions.push_back([&decompressChunk, i, payloadOffset]() { decompressChunk(i, payloadOffset); });
+            payloadOffset += chunkSizes[i];
+        }
+        runAndWait(*operationThreads, functions);
+    }
+    else
+    {
+        size_t payloadOffset = 0;
+        for (size_t i = 0; i < numChunks; ++i)
+        {
+            decompressChunk(i, payloadOffset);
+            payloadOffset += chunkSizes[i];
+        }
+    }
+
+    if (!succeeded) return failed("failed to decompress.");
+
+    return true;
 }
 
 void BinaryInput::_read(std::string& value)
@@ -88,33 +231,191 @@ void BinaryInput::read(size_t num, Path* value)
     }
 }
 
+void BinaryInput::_readChunks()
+{
+    struct Chunk
+    {
+        uint64_t size = 0;
+        ObjectID firstID = 0;
+        ObjectID endID = 0;
+        std::vector<ObjectID> referencedIDs;
+        std::vector<size_t> dependencies;
+        std::vector<uint8_t> buffer;
+        const uint8_t* data = nullptr;
+        ObjectIDMap objects;
+        bool completed = false;
+    };
+
+    uint32_t numChunks = 0;
+    _read(1, &numChunks);
+
+    std::vector<Chunk> chunks(numChunks);
+    for (auto& chunk : chunks)
+    {
+        uint32_t header[3] = {0, 0, 0};
+        _read(1, &chunk.size);
+        _read(3, header);
+        chunk.firstID = header[0];
+        chunk.endID = header[1];
+        chunk.referencedIDs.resize(header[2]);
+        _read(chunk.referencedIDs.size(), chunk.referencedIDs.data());
+    }
+
+    // chunks are written in increasing object ID order so the chunk defining a referenced object can be found with a binary search
+    for (auto& chunk : chunks)
+    {
+        for (auto id : chunk.referencedIDs)
+        {
+            auto itr = std::upper_bound(chunks.begin(), chunks.end(), id, [](ObjectID lhs, const Chunk& rhs) { return lhs < rhs.firstID; });
+            if (itr != chunks.begin() && id < (itr - 1)->endID) chunk.dependencies.push_back(static_cast<size_t>(itr - 1 - chunks.begin()));
+        }
+    }
+
+    // decode straight from memory mapped files, otherwise read each chunk into its own buffer
+    std::streamoff position = mappedStorage ? std::streamoff(_input.tellg()) : std::streamoff(-1);
+    for (auto& chunk : chunks)
+    {
+        if (position >= 0 && (static_cast<size_t>(position) + chunk.size) <= mappedStorage->dataSize())
+        {
+            chunk.data = reinterpret_cast<const uint8_t*>(mappedStorage->dataPointer()) + position;
+            position += static_cast<std::streamoff>(chunk.size);
+            _input.seekg(position);
+        }
+        else
+        {
+            chunk.buffer.resize(chunk.size);
+            _read(chunk.buffer.size(), chunk.buffer.data());
+            chunk.data = chunk.buffer.data();
+        }
+    }
+
+    auto decodeChunk = [&](Chunk& chunk) {
+        mem_stream chunk_stream(chunk.data, chunk.size);
+        BinaryInput chunkInput(chunk_stream, objectFactory, options);
+        chunkInput.version = version;
+        chunkInput.filename = filename;
+
+        // the objects this chunk references are only read from the objectIDMap once the chunks defining them have been merged into it
+        for (auto id : chunk.referencedIDs)
+        {
+            if (auto itr = objectIDMap.find(id); itr != objectIDMap.end()) chunkInput.objectIDMap.insert(*itr);
+        }
+
+        chunkInput.read();
+        chunk.objects.swap(chunkInput.objectIDMap);
+    };
+
+    // decode the chunks in waves, each wave containing the chunks whose dependencies have all been decoded by earlier waves
+    auto operationThreads = options ? options->operationThreads : ref_ptr<OperationThreads>();
+    size_t numCompleted = 0;
+    while (numCompleted < chunks.size())
+    {
+        std::vector<Chunk*> wave;
+        for (auto& chunk : chunks)
+        {
+            if (chunk.completed) continue;
+
+            bool ready = std::all_of(chunk.dependencies.begin(), chunk.dependencies.end(), [&](size_t i) { return chunks[i].completed; });
+            if (ready) wave.push_back(&chunk);
+        }
+
+        if (wave.empty())
+        {
+            warn("BinaryInput::_readChunks() unable to resolve chunk dependencies.");
+            break;
+        }
+
+        if (operationThreads && wave.size() > 1)
+        {
+            // exceptions thrown decoding a chunk are rethrown here once the whole wave has completed
+            std::vector<std::function<void()>> functions;
+            for (auto chunk : wave) functions.push_back([&decodeChunk, chunk]() { decodeChunk(*chunk); });
+            runAndWait(*operationThreads, functions);
+        }
+        else
+        {
+            for (auto chunk : wave) decodeChunk(*chunk);
+        }
+
+        for (auto chunk : wave)
+        {
+            objectIDMap.insert(chunk->objects.begin(), chunk->objects.end());
+            chunk->objects.clear();
+            chunk->buffer = {};
+            chunk->completed = true;
+        }
+        numCompleted += wave.size();
+    }
+}
+
 vsg::ref_ptr<vsg::Object> BinaryInput::read()
 {
     ObjectID id = objectID();
 
+    if (id == BinaryOutput::chunkTableID && version_greater_equal(1, 1, 7))
+    {
+        // the chunks define the root object's children, so once they've been decoded the root object follows.
+        _readChunks();
+        id = objectID();
+    }
+
     if (auto itr = objectIDMap.find(id); itr != objectIDMap.end())
     {
         return itr->second;
     }
-    else
+
+    vsg::ref_ptr<vsg::Object> object;
+
+    if (version_greater_equal(1, 1, 2))
     {
-        std::string className = readValue<std::string>(nullptr);
+        // type ID of 0 is a null object, a type ID one beyond the entries read so far is followed by the definition of its class name
+        uint32_t typeID = readValue<uint32_t>(nullptr);
+        if (typeID == _classEntries.size() + 1)
+        {
+            ClassEntry entry;
+            entry.className = readValue<std::string>(nullptr);
+            entry.createFunction = objectFactory->getCreateFunction(entry.className);
+            _classEntries.push_back(std::move(entry));
+        }
 
-        vsg::ref_ptr<vsg::Object> object;
-        if (className != "nullptr")
+        if (typeID > _classEntries.size())
         {
-            object = objectFactory->create(className.c_str());
+            warn("BinaryInput::read() invalid type ID : ", typeID);
+        }
+        else if (typeID > 0)
+        {
+            auto& entry = _classEntries[typeID - 1];
+
+            // fallback to ObjectFactory::create() for classes not in the CreateMap, allowing ObjectFactory subclasses to handle them.
+            object = entry.createFunction ? (*entry.createFunction)() : objectFactory->create(entry.className);
             if (object)
             {
                 object->read(*this);
             }
             else
             {
-                warn("Unable to create instance of class : ", className);
+                warn("Unable to create instance of class : ", entry.className);
             }
         }
 
         objectIDMap[id] = object;
         return object;
     }
+
+    std::string className = readValue<std::string>(nullptr);
+    if (className != "nullptr")
+    {
+        object = objectFactory->create(className.c_str());
+        if (object)
+        {
+            object->read(*this);
+        }
+        else
+        {
+            warn("Unable to create instance of class : ", className);
+        }
+    }
+
+    objectIDMap[id] = object;
+    return object;
 }
@@ -13,6 +13,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Version.h>
 
 #include <vsg/io/BinaryOutput.h>
+#include <vsg/io/MappedFile.h>
+#include <vsg/io/compression.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <algorithm>
+#include <sstream>
 
 using namespace vsg;
 
@@ -20,6 +27,99 @@ BinaryOutput::BinaryOutput(std::ostream& output, ref_ptr<const Options> in_optio
     Output(in_options),
     _output(output)
 {
+    rawFields = true;
+
+    if (options)
+    {
+        options->getValue("compression", compression);
+        options->getValue("chunked", chunked);
+    }
+}
+
+bool BinaryOutput::writeData(const void* ptr, size_t valueSize, size_t count, bool integerValues)
+{
+    size_t size = valueSize * count;
+
+    if (version_greater_equal(1, 1, 4))
+    {
+        // each block of array data is preceded by the CompressionCodec used
+        CompressionCodec codec = COMPRESSION_NONE;
+        if (!compression.empty() && compression != "none" && size >= minimumCompressionSize)
+        {
+            if (compression == "auto" && integerValues && (valueSize == 2 || valueSize == 4))
+                codec = COMPRESSION_DELTA_LZ;
+            else if (compression == "auto" && valueSize > 1)
+                codec = COMPRESSION_SHUFFLE_LZ;
+            else
+                codec = COMPRESSION_LZ;
+        }
+
+        if (codec != COMPRESSION_NONE)
+        {
+            // chunks hold whole values so that they can be decompressed independently
+            size_t chunkSize = std::max(valueSize, (compressionChunkSize / valueSize) * valueSize);
+            size_t numChunks = (size + chunkSize - 1) / chunkSize;
+
+            const uint8_t* src = reinterpret_cast<const uint8_t*>(ptr);
+            std::vector<std::vector<uint8_t>> compressedChunks(numChunks);
+            auto compressChunk = [&](size_t i) {
+                size_t offset = chunkSize * i;
+                compress(codec, src + offset, std::min(chunkSize, size - offset), valueSize, compressedChunks[i]);
+            };
+
+            // compress the chunks in parallel when Options::operationThreads is available
+            auto operationThreads = options ? options->operationThreads : ref_ptr<OperationThreads>();
+            if (operationThreads && numChunks > 1)
+            {
+                std::vector<std::function<void()>> functions;
+                for (size_t i = 0; i < numChunks; ++i) functions.push_back([&compressChunk, i]() { compressChunk(i); });
+                runAndWait(*operationThreads, functions);
+            }
+            else
+            {
+                for (size_t i = 0; i < numChunks; ++i) compressChunk(i);
+            }
+
+            std::vector<uint32_t> chunkSizes;
+            std::vector<uint8_t> payload;
+            for (auto& compressedChunk : compressedChunks)
+            {
+                chunkSizes.push_back(static_cast<uint32_t>(compressedChunk.size()));
+                payload.insert(payload.end(), compressedChunk.begin(), compressedChunk.end());
+            }
+
+            // only use the compressed form if it's smaller than writing the data directly
+            size_t compressedSize = sizeof(uint32_t) * (2 + numChunks) + payload.size();
+            if (compressedSize < size)
+            {
+                uint8_t codecValue = codec;
+                uint32_t header[2] = {static_cast<uint32_t>(chunkSize), static_cast<uint32_t>(numChunks)};
+                _write(1, &codecValue);
+                _write(2, header);
+                _write(chunkSizes.size(), chunkSizes.data());
+                _write(payload.size(), payload.data());
+                return true;
+            }
+        }
+
+        uint8_t codecValue = COMPRESSION_NONE;
+        _write(1, &codecValue);
+    }
+
+    if (alignedData)
+    {
+        std::streamoff position = _output.tellp();
+        if (position >= 0)
+        {
+            size_t alignment = MappedFile::alignment(size);
+            size_t padding = (alignment - (static_cast<size_t>(position) % alignment)) % alignment;
+
+            static const char zeros[4096] = {};
+            _output.write(zeros, static_cast<std::streamsize>(padding));
+        }
+    }
+
+    return false;
 }
 
 void BinaryOutput::_write(const std::string& str)
@@ -81,20 +181,110 @@ void BinaryOutput::write(size_t num, const Path* value)
     }
 }
 
+void BinaryOutput::_writeChunks(const Group& group)
+{
+    struct Chunk
+    {
+        std::string data;
+        ObjectID firstID = 0;
+        ObjectID endID = 0;
+        std::vector<ObjectID> referencedIDs;
+    };
+
+    std::vector<Chunk> chunks;
+    for (auto& child : group.children)
+    {
+        if (objectIDMap.count(child.get()) != 0) continue;
+
+        // each chunk has its own class table so it can be decoded independently, but shares the object IDs so shared objects are only written once
+        std::ostringstream chunk_stream;
+        BinaryOutput chunkOutput(chunk_stream, options);
+        chunkOutput.version = version;
+        chunkOutput.chunked = false;
+        chunkOutput.compression = compression;
+        chunkOutput.minimumCompressionSize = minimumCompressionSize;
+        chunkOutput.compressionChunkSize = compressionChunkSize;
+        chunkOutput.objectIDMap.swap(objectIDMap);
+        chunkOutput.objectID = objectID;
+        chunkOutput._chunkFirstID = objectID;
+
+        chunkOutput.write(child.get());
+
+        Chunk chunk;
+        chunk.data = chunk_stream.str();
+        chunk.firstID = objectID;
+        chunk.endID = chunkOutput.objectID;
+        chunk.referencedIDs.assign(chunkOutput._referencedIDs.begin(), chunkOutput._referencedIDs.end());
+        chunks.push_back(std::move(chunk));
+
+        objectIDMap.swap(chunkOutput.objectIDMap);
+        objectID = chunkOutput.objectID;
+    }
+
+    uint32_t marker = chunkTableID;
+    uint32_t numChunks = static_cast<uint32_t>(chunks.size());
+    _write(1, &marker);
+    _write(1, &numChunks);
+    for (auto& chunk : chunks)
+    {
+        uint64_t size = chunk.data.size();
+        uint32_t header[3] = {chunk.firstID, chunk.endID, static_cast<uint32_t>(chunk.referencedIDs.size())};
+        _write(1, &size);
+        _write(3, header);
+        _write(chunk.referencedIDs.size(), chunk.referencedIDs.data());
+    }
+
+    for (auto& chunk : chunks)
+    {
+        _output.write(chunk.data.data(), static_cast<std::streamsize>(chunk.data.size()));
+    }
+}
+
 void BinaryOutput::write(const vsg::Object* object)
 {
     if (auto itr = objectIDMap.find(object); itr != objectIDMap.end())
     {
         // write out the objectID
         uint32_t id = itr->second;
+        if (id < _chunkFirstID) _referencedIDs.insert(id);
         _output.write(reinterpret_cast<const char*>(&id), sizeof(id));
         return;
     }
 
+    if (chunked && version_greater_equal(1, 1, 7))
+    {
+        // only the root object's children are chunked
+        chunked = false;
+
+        auto group = dynamic_cast<const Group*>(object);
+        if (group && group->children.size() > 1) _writeChunks(*group);
+    }
+
     ObjectID id = objectID++;
     objectIDMap[object] = id;
 
     _output.write(reinterpret_cast<const char*>(&id), sizeof(id));
+
+    if (version_greater_equal(1, 1, 2))
+    {
+        // write a type ID rather than the class name, with the class name following the first use of each type ID
+        uint32_t typeID = 0;
+        if (object)
+        {
+            auto [itr, inserted] = _classIDMap.emplace(object->className(), static_cast<uint32_t>(_classIDMap.size() + 1));
+            typeID = itr->second;
+            _output.write(reinterpret_cast<const char*>(&typeID), sizeof(typeID));
+            if (inserted) _write(itr->first);
+
+            object->write(*this);
+        }
+        else
+        {
+            _output.write(reinterpret_cast<const char*>(&typeID), sizeof(typeID));
+        }
+        return;
+    }
+
     if (object)
     {
         _write(std::string(object->className()));
@@ -10,6 +10,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/core/AllocatorArena.h>
 #include <vsg/io/DatabasePager.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/ReaderWriter.h>
@@ -17,6 +18,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/threading/atomics.h>
 #include <vsg/ui/ApplicationEvent.h>
 
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
 using namespace vsg;
 
 /////////////////////////////////////////////////////////////////////////
@@ -32,19 +37,25 @@ DatabaseQueue::~DatabaseQueue()
 {
 }
 
+void DatabaseQueue::_push(ref_ptr<PagedLOD> plod)
+{
+    _queue.push_back(Entry{plod->priority.load(), plod});
+    std::push_heap(_queue.begin(), _queue.end());
+}
+
 void DatabaseQueue::add(ref_ptr<PagedLOD> plod)
 {
     // debug("DatabaseQueue::add(", plod,") status = ",plod->requestStatus.load());
 
     std::scoped_lock lock(_mutex);
-    _queue.emplace_back(plod);
+    _push(plod);
     _cv.notify_one();
 }
 
 void DatabaseQueue::add(ref_ptr<PagedLOD> plod, const CompileResult& cr)
 {
     std::scoped_lock lock(_mutex);
-    _queue.emplace_back(plod);
+    _push(plod);
     _cv.notify_one();
     _compileResult.add(cr);
 }
@@ -72,19 +83,23 @@ ref_ptr<PagedLOD> DatabaseQueue::take_when_available()
 
     // debug("DatabaseQueue::take_when_available() D ", _queue.size());
 
-    // find the PagedLOD with the highest priority;
-    auto itr = _queue.begin();
-    auto highest_itr = itr++;
+    // the PagedLOD with the highest priority is at the top of the heap
+    std::pop_heap(_queue.begin(), _queue.end());
+    ref_ptr<PagedLOD> plod = std::move(_queue.back().plod);
+    _queue.pop_back();
 
-    for (; itr != _queue.end(); ++itr)
-    {
-        if ((*itr)->priority > (*highest_itr)->priority) highest_itr = itr;
-    }
+    // debug("Returning ", plod.get(), std::dec, ", size = ", _queue.size());
+    return plod;
+}
 
-    ref_ptr<PagedLOD> plod = *highest_itr;
-    _queue.erase(highest_itr);
+ref_ptr<PagedLOD> DatabaseQueue::take()
+{
+    std::scoped_lock lock(_mutex);
+    if (_queue.empty()) return {};
 
-    // debug("Returning ", plod.get(), std::dec, ", size = ", _queue.size());
+    std::pop_heap(_queue.begin(), _queue.end());
+    ref_ptr<PagedLOD> plod = std::move(_queue.back().plod);
+    _queue.pop_back();
     return plod;
 }
 
@@ -92,12 +107,60 @@ DatabaseQueue::Nodes DatabaseQueue::take_all(CompileResult& cr)
 {
     std::scoped_lock lock(_mutex);
     Nodes nodes;
-    nodes.swap(_queue);
+    nodes.reserve(_queue.size());
+    for (auto& entry : _queue)
+    {
+        nodes.push_back(std::move(entry.plod));
+    }
+    _queue.clear();
     cr.add(_compileResult);
     _compileResult.reset();
     return nodes;
 }
 
+DatabaseQueue::Nodes DatabaseQueue::take(size_t maxNumNodes, CompileResult& cr)
+{
+    std::scoped_lock lock(_mutex);
+    Nodes nodes;
+    nodes.reserve(std::min(maxNumNodes, _queue.size()));
+    while (!_queue.empty() && nodes.size() < maxNumNodes)
+    {
+        std::pop_heap(_queue.begin(), _queue.end());
+        nodes.push_back(std::move(_queue.back().plod));
+        _queue.pop_back();
+    }
+    cr.add(_compileResult);
+    _compileResult.reset();
+    return nodes;
+}
+
+DatabaseQueue::Nodes DatabaseQueue::reprioritize(uint64_t frameCount, uint64_t maxFrameDelta)
+{
+    std::scoped_lock lock(_mutex);
+
+    Nodes expired;
+    auto itr = std::remove_if(_queue.begin(), _queue.end(), [&](Entry& entry) {
+        if ((frameCount - entry.plod->frameHighResLastUsed.load()) > maxFrameDelta)
+        {
+            expired.push_back(std::move(entry.plod));
+            return true;
+        }
+        entry.priority = entry.plod->priority.load();
+        return false;
+    });
+    _queue.erase(itr, _queue.end());
+
+    std::make_heap(_queue.begin(), _queue.end());
+
+    return expired;
+}
+
+size_t DatabaseQueue::size() const
+{
+    std::scoped_lock lock(_mutex);
+    return _queue.size();
+}
+
 /////////////////////////////////////////////////////////////////////////
 //
 // DatabasePager
@@ -112,6 +175,8 @@ DatabasePager::DatabasePager()
     _toMergeQueue = DatabaseQueue::create(_status);
 
     pagedLODContainer = PagedLODContainer::create(4000);
+
+    deleteQueue = DeleteQueue::create(_status);
 }
 
 DatabasePager::~DatabasePager()
@@ -120,10 +185,16 @@ DatabasePager::~DatabasePager()
 
     _status->set(false);
 
+    cancelAllReads();
+
     for (auto& thread : _readThreads)
     {
         thread.join();
     }
+
+    if (_deleteThread.joinable()) _deleteThread.join();
+
+    if (deleteQueue) deleteQueue->clear();
 }
 
 void DatabasePager::assignInstrumentation(ref_ptr<Instrumentation> in_instrumentation)
@@ -133,6 +204,96 @@ void DatabasePager::assignInstrumentation(ref_ptr<Instrumentation> in_instrument
 
 void DatabasePager::start()
 {
+    // dedicated thread for releasing expired subgraphs, not shared with operationThreads as it blocks waiting for frames to advance
+    if (deleteQueue && !_deleteThread.joinable())
+    {
+        auto clear = [](ref_ptr<DeleteQueue> queue, ref_ptr<ActivityStatus> status, DatabasePager& databasePager) {
+            debug("Started DatabasePager delete thread");
+
+            auto local_instrumentation = shareOrDuplicateForThreadSafety(databasePager.instrumentation);
+            if (local_instrumentation) local_instrumentation->setThreadName("DatabasePager delete thread");
+
+            while (status->active())
+            {
+                queue->wait_then_clear();
+            }
+            debug("Finished DatabasePager delete thread");
+        };
+
+        _deleteThread = std::thread(clear, deleteQueue, _status, std::ref(*this));
+    }
+
+    // when sharing threads read requests are dispatched as operations from request()
+    if (operationThreads) return;
+
+    if (stagedReading)
+    {
+        _decodeQueue = StagedReadQueue::create(_status);
+        _compileQueue = StagedReadQueue::create(_status);
+
+        auto io = [](ref_ptr<DatabaseQueue> requestQueue, ref_ptr<ActivityStatus> status, DatabasePager& databasePager, const std::string& threadName) {
+            auto local_instrumentation = shareOrDuplicateForThreadSafety(databasePager.instrumentation);
+            if (local_instrumentation) local_instrumentation->setThreadName(threadName);
+
+            while (status->active())
+            {
+                if (auto plod = requestQueue->take_when_available()) databasePager.readFileContents(plod);
+            }
+        };
+
+        auto decode = [](ref_ptr<StagedReadQueue> decodeQueue, ref_ptr<ActivityStatus> status, DatabasePager& databasePager, const std::string& threadName) {
+            auto local_instrumentation = shareOrDuplicateForThreadSafety(databasePager.instrumentation);
+            if (local_instrumentation) local_instrumentation->setThreadName(threadName);
+
+            while (status->active())
+            {
+                if (auto stagedRead = decodeQueue->take_when_available()) databasePager.decode(stagedRead);
+            }
+        };
+
+        auto compile = [](ref_ptr<StagedReadQueue> compileQueue, ref_ptr<ActivityStatus> status, DatabasePager& databasePager, const std::string& threadName) {
+            auto local_instrumentation = shareOrDuplicateForThreadSafety(databasePager.instrumentation);
+            if (local_instrumentation) local_instrumentation->setThreadName(threadName);
+
+            std::vector<ref_ptr<StagedRead>> batch;
+            while (status->active())
+            {
+                // wait for the first subgraph and then batch up any others that are already waiting
+                if (auto stagedRead = compileQueue->take_when_available())
+                {
+                    batch.push_back(stagedRead);
+                    while (batch.size() < std::max(databasePager.maxCompileBatchSize, 1u))
+                    {
+                        if (auto next = compileQueue->take())
+                            batch.push_back(next);
+                        else
+                            break;
+                    }
+
+                    databasePager.compile(batch);
+                    batch.clear();
+                }
+            }
+        };
+
+        uint32_t numDecode = numDecodeThreads > 0 ? numDecodeThreads : std::max(std::thread::hardware_concurrency() / 2, 1u);
+
+        for (uint32_t i = 0; i < std::max(numIOThreads, 1u); ++i)
+        {
+            _readThreads.emplace_back(io, std::ref(_requestQueue), std::ref(_status), std::ref(*this), make_string("DatabasePager I/O thread ", i));
+        }
+
+        for (uint32_t i = 0; i < numDecode; ++i)
+        {
+            _readThreads.emplace_back(decode, std::ref(_decodeQueue), std::ref(_status), std::ref(*this), make_string("DatabasePager decode thread ", i));
+        }
+
+        _readThreads.emplace_back(compile, std::ref(_compileQueue), std::ref(_status), std::ref(*this), "DatabasePager compile thread");
+
+        debug("DatabasePager::start() staged reading with ", numIOThreads, " I/O threads, ", numDecode, " decode threads and 1 compile thread");
+        return;
+    }
+
     int numReadThreads = 4;
 
     //
@@ -149,60 +310,288 @@ void DatabasePager::start()
             auto plod = requestQueue->take_when_available();
             if (plod)
             {
-                CPU_INSTRUMENTATION_L1_NC(databasePager.instrumentation, "DatabasePager read", COLOR_PAGER);
+                databasePager.readAndCompile(plod);
+            }
+        }
+        debug("Finished DatabaseThread read thread");
+    };
 
-                uint64_t frameDelta = databasePager.frameCount - plod->frameHighResLastUsed.load();
-                if (frameDelta > 1 || !compare_exchange(plod->requestStatus, PagedLOD::ReadRequest, PagedLOD::Reading))
-                {
-                    // debug("Expire read request");
-                    databasePager.requestDiscarded(plod);
-                    continue;
-                }
+    for (int i = 0; i < numReadThreads; ++i)
+    {
+        _readThreads.emplace_back(read, std::ref(_requestQueue), std::ref(_status), std::ref(*this), make_string("DatabasePager thread ", i));
+    }
+}
 
-                auto read_object = vsg::read(plod->filename, plod->options);
-                auto subgraph = read_object.cast<Node>();
+void DatabasePager::readAndCompile(ref_ptr<PagedLOD> plod)
+{
+    CPU_INSTRUMENTATION_L1_NC(instrumentation, "DatabasePager read", COLOR_PAGER);
 
-                if (subgraph && compare_exchange(plod->requestStatus, PagedLOD::Reading, PagedLOD::Compiling))
-                {
-                    {
-                        std::scoped_lock<std::mutex> lock(databasePager.pendingPagedLODMutex);
-                        plod->pending = subgraph;
-                    }
+    uint64_t frameDelta = frameCount - plod->frameHighResLastUsed.load();
+    if (frameDelta > 1 || !compare_exchange(plod->requestStatus, PagedLOD::ReadRequest, PagedLOD::Reading))
+    {
+        // debug("Expire read request");
+        requestDiscarded(plod);
+        return;
+    }
 
-                    // compile plod
-                    if (auto result = databasePager.compileManager->compile(subgraph))
-                    {
-                        plod->requestStatus.exchange(PagedLOD::MergeRequest);
+    // pass a cancellation token to the read so that it can be aborted if the PagedLOD is no longer required
+    auto readStatus = ActivityStatus::create();
+    auto readOptions = plod->options ? Options::create(*plod->options) : Options::create();
+    readOptions->activityStatus = readStatus;
 
-                        // move to the merge queue;
-                        databasePager._toMergeQueue->add(plod, result);
-                    }
-                    else
-                    {
-                        debug("Failed to compile ", plod, " ", plod->filename);
-                        databasePager.requestDiscarded(plod);
-                    }
+    {
+        std::scoped_lock<std::mutex> lock(_activeReadsMutex);
+        _activeReads[plod] = readStatus;
+    }
+
+    ref_ptr<Object> read_object;
+    if (useAllocatorArenas)
+    {
+        auto arena = AllocatorArena::create();
+        AllocatorArena::Scope scope(arena);
+        read_object = vsg::read(plod->filename, readOptions);
+    }
+    else
+    {
+        read_object = vsg::read(plod->filename, readOptions);
+    }
+
+    {
+        std::scoped_lock<std::mutex> lock(_activeReadsMutex);
+        _activeReads.erase(plod);
+    }
+
+    if (readStatus->cancel())
+    {
+        debug("Cancelled read of ", plod, " ", plod->filename);
+        requestDiscarded(plod);
+        return;
+    }
+
+    auto subgraph = read_object.cast<Node>();
+    if (subgraph && textureTranscoder) textureTranscoder->transcode(*subgraph);
+
+    if (subgraph && compare_exchange(plod->requestStatus, PagedLOD::Reading, PagedLOD::Compiling))
+    {
+        {
+            std::scoped_lock<std::mutex> lock(pendingPagedLODMutex);
+            plod->pending = subgraph;
+        }
+
+        // compile plod
+        if (auto result = compileManager->compile(subgraph))
+        {
+            plod->highResDataSize = result.dataSize;
+            plod->highResDeviceMemorySize = result.deviceMemorySize;
+
+            plod->requestStatus.exchange(PagedLOD::MergeRequest);
+
+            // move to the merge queue;
+            _toMergeQueue->add(plod, result);
+        }
+        else
+        {
+            debug("Failed to compile ", plod, " ", plod->filename);
+            requestDiscarded(plod);
+        }
+    }
+    else
+    {
+        if (auto read_error = read_object.cast<ReadError>())
+            warn(read_error->message);
+        else
+            warn("Failed to read ", plod, " ", plod->filename);
+
+        requestDiscarded(plod);
+    }
+}
+
+ref_ptr<DatabasePager::StagedRead> DatabasePager::beginRead(ref_ptr<PagedLOD> plod)
+{
+    uint64_t frameDelta = frameCount - plod->frameHighResLastUsed.load();
+    if (frameDelta > 1 || !compare_exchange(plod->requestStatus, PagedLOD::ReadRequest, PagedLOD::Reading))
+    {
+        requestDiscarded(plod);
+        return {};
+    }
+
+    ref_ptr<StagedRead> stagedRead(new StagedRead);
+    stagedRead->plod = plod;
+    stagedRead->filename = plod->filename;
+    stagedRead->readStatus = ActivityStatus::create();
+    stagedRead->readOptions = plod->options ? Options::create(*plod->options) : Options::create();
+    stagedRead->readOptions->activityStatus = stagedRead->readStatus;
+
+    std::scoped_lock<std::mutex> lock(_activeReadsMutex);
+    _activeReads[plod] = stagedRead->readStatus;
+
+    return stagedRead;
+}
+
+bool DatabasePager::endRead(StagedRead& stagedRead)
+{
+    {
+        std::scoped_lock<std::mutex> lock(_activeReadsMutex);
+        _activeReads.erase(stagedRead.plod);
+    }
+
+    if (stagedRead.readStatus->cancel())
+    {
+        debug("Cancelled read of ", stagedRead.plod, " ", stagedRead.filename);
+        requestDiscarded(stagedRead.plod);
+        return false;
+    }
+    return true;
+}
+
+void DatabasePager::readFileContents(ref_ptr<PagedLOD> plod)
+{
+    CPU_INSTRUMENTATION_L1_NC(instrumentation, "DatabasePager I/O", COLOR_READ);
+
+    auto stagedRead = beginRead(plod);
+    if (!stagedRead) return;
+
+    // only local files not shared via sharedObjects can be read ahead of decoding, others are left for the ReaderWriter to read
+    auto& readOptions = stagedRead->readOptions;
+    if (!readOptions->sharedObjects)
+    {
+        if (auto foundPath = findFile(stagedRead->filename, readOptions))
+        {
+            std::ifstream fin(foundPath, std::ios::in | std::ios::binary | std::ios::ate);
+            if (fin)
+            {
+                auto fileSize = static_cast<size_t>(fin.tellg());
+                fin.seekg(0);
+                stagedRead->contents.resize(fileSize);
+                if (!fin.read(reinterpret_cast<char*>(stagedRead->contents.data()), static_cast<std::streamsize>(fileSize)))
+                {
+                    stagedRead->contents.clear();
                 }
                 else
                 {
-                    if (auto read_error = read_object.cast<ReadError>())
-                        warn(read_error->message);
-                    else
-                        warn("Failed to read ", plod, " ", plod->filename);
-
-                    databasePager.requestDiscarded(plod);
+                    // decoding from memory can't locate files referenced relative to the file, so add its directory to the search paths
+                    if (auto path = filePath(foundPath)) readOptions->paths.insert(readOptions->paths.begin(), path);
+                    readOptions->extensionHint = lowerCaseFileExtension(foundPath);
                 }
             }
         }
-        debug("Finished DatabaseThread read thread");
+    }
+
+    if (stagedRead->readStatus->cancel())
+    {
+        endRead(*stagedRead);
+        return;
+    }
+
+    _decodeQueue->add(stagedRead);
+}
+
+void DatabasePager::decode(ref_ptr<StagedRead> stagedRead)
+{
+    CPU_INSTRUMENTATION_L1_NC(instrumentation, "DatabasePager decode", COLOR_READ);
+
+    auto& readOptions = stagedRead->readOptions;
+    auto& contents = stagedRead->contents;
+
+    auto read_object = [&]() -> ref_ptr<Object> {
+        if (stagedRead->readStatus->cancel()) return {};
+
+        if (!contents.empty())
+        {
+            auto object = vsg::read(contents.data(), contents.size(), readOptions);
+            if (object && !object.cast<ReadError>()) return object;
+
+            // no ReaderWriter supports decoding from memory so fall back to reading the file
+            readOptions->extensionHint = Path();
+        }
+        return vsg::read(stagedRead->filename, readOptions);
     };
 
-    for (int i = 0; i < numReadThreads; ++i)
+    ref_ptr<Object> object;
+    if (useAllocatorArenas)
     {
-        _readThreads.emplace_back(read, std::ref(_requestQueue), std::ref(_status), std::ref(*this), make_string("DatabasePager thread ", i));
+        auto arena = AllocatorArena::create();
+        AllocatorArena::Scope scope(arena);
+        object = read_object();
+    }
+    else
+    {
+        object = read_object();
+    }
+
+    contents = {};
+
+    if (!endRead(*stagedRead)) return;
+
+    auto& plod = stagedRead->plod;
+    stagedRead->subgraph = object.cast<Node>();
+    if (stagedRead->subgraph && textureTranscoder) textureTranscoder->transcode(*stagedRead->subgraph);
+    if (stagedRead->subgraph && compare_exchange(plod->requestStatus, PagedLOD::Reading, PagedLOD::Compiling))
+    {
+        {
+            std::scoped_lock<std::mutex> lock(pendingPagedLODMutex);
+            plod->pending = stagedRead->subgraph;
+        }
+
+        _compileQueue->add(stagedRead);
+    }
+    else
+    {
+        if (auto read_error = object.cast<ReadError>())
+            warn(read_error->message);
+        else
+            warn("Failed to read ", plod, " ", plod->filename);
+
+        requestDiscarded(plod);
     }
 }
 
+void DatabasePager::compile(std::vector<ref_ptr<StagedRead>>& batch)
+{
+    CPU_INSTRUMENTATION_L1_NC(instrumentation, "DatabasePager compile", COLOR_COMPILE);
+
+    // drop subgraphs that are no longer required before compiling them
+    std::vector<ref_ptr<Object>> subgraphs;
+    for (auto& stagedRead : batch)
+    {
+        if ((frameCount - stagedRead->plod->frameHighResLastUsed.load()) > 1)
+        {
+            requestDiscarded(stagedRead->plod);
+            stagedRead = {};
+            continue;
+        }
+
+        subgraphs.push_back(stagedRead->subgraph);
+    }
+
+    batch.erase(std::remove(batch.begin(), batch.end(), ref_ptr<StagedRead>()), batch.end());
+    if (batch.empty()) return;
+
+    // compile all the subgraphs in a single submission
+    auto results = compileManager->compile(subgraphs);
+
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        auto& plod = batch[i]->plod;
+        auto& result = results[i];
+        if (!result)
+        {
+            debug("Failed to compile ", plod, " ", plod->filename);
+            requestDiscarded(plod);
+            continue;
+        }
+
+        plod->highResDataSize = result.dataSize;
+        plod->highResDeviceMemorySize = result.deviceMemorySize;
+
+        plod->requestStatus.exchange(PagedLOD::MergeRequest);
+
+        _toMergeQueue->add(plod, result);
+    }
+
+    if (instrumentation) instrumentation->plot("DatabasePager compile batch size", static_cast<double>(batch.size()));
+}
+
 void DatabasePager::request(ref_ptr<PagedLOD> plod)
 {
     ++numActiveRequests;
@@ -219,6 +608,28 @@ void DatabasePager::request(ref_ptr<PagedLOD> plod)
         {
             // debug("DatabasePager::request(", plod.get(), ") adding to requestQueue ", plod->filename, ", ", plod->priority, " plod=", plod.get());
             _requestQueue->add(plod);
+
+            if (workloadRecorder) workloadRecorder->pagerRequest(frameCount.load(), plod->filename, plod->priority.load());
+
+            if (operationThreads)
+            {
+                // each operation takes the highest priority request at the time it's run rather than the request that it was added for.
+                struct ReadOperation : public Operation
+                {
+                    explicit ReadOperation(ref_ptr<DatabasePager> in_databasePager) :
+                        databasePager(in_databasePager) {}
+
+                    void run() override
+                    {
+                        if (databasePager->_status->cancel()) return;
+                        if (auto next_plod = databasePager->_requestQueue->take()) databasePager->readAndCompile(next_plod);
+                    }
+
+                    ref_ptr<DatabasePager> databasePager;
+                };
+
+                operationThreads->add(ref_ptr<Operation>(new ReadOperation(ref_ptr<DatabasePager>(this))));
+            }
         }
         else
         {
@@ -241,13 +652,47 @@ void DatabasePager::requestDiscarded(PagedLOD* plod)
     --numActiveRequests;
 }
 
+void DatabasePager::cancelExpiredReads()
+{
+    std::scoped_lock<std::mutex> lock(_activeReadsMutex);
+    for (auto& [plod, readStatus] : _activeReads)
+    {
+        if ((frameCount - plod->frameHighResLastUsed.load()) > 1) readStatus->set(false);
+    }
+}
+
+void DatabasePager::cancelAllReads()
+{
+    std::scoped_lock<std::mutex> lock(_activeReadsMutex);
+    for (auto& entry : _activeReads)
+    {
+        entry.second->set(false);
+    }
+}
+
 void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
 {
     CPU_INSTRUMENTATION_L1(instrumentation);
 
+    // the prefetcher traverses the scene graph in the background so must complete before any subgraphs are merged or expired
+    if (prefetcher) prefetcher->wait();
+
     frameCount.exchange(frameStamp ? frameStamp->frameCount : 0);
 
-    auto nodes = _toMergeQueue->take_all(cr);
+    // only defer deletion when the delete thread is running
+    DeleteQueue* activeDeleteQueue = (deleteQueue && _deleteThread.joinable()) ? deleteQueue.get() : nullptr;
+    if (activeDeleteQueue) activeDeleteQueue->advance(ref_ptr<FrameStamp>(frameStamp));
+
+    // drop requests that are no longer required before they are read, and reorder the remaining ones using the latest priorities
+    for (auto& plod : _requestQueue->reprioritize(frameCount))
+    {
+        requestDiscarded(plod);
+    }
+
+    cancelExpiredReads();
+
+    // take the loaded subgraphs in priority order so that any deferred by the merge budget are the least important
+    auto nodes = _toMergeQueue->take(maxNumMergesPerFrame > 0 ? maxNumMergesPerFrame : std::numeric_limits<size_t>::max(), cr);
 
     if (culledPagedLODs)
     {
@@ -296,14 +741,9 @@ void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
 
         debug("DatabasePager : activeList.count = ", pagedLODContainer->activeList.count, ", inactiveList.count = ", pagedLODContainer->inactiveList.count, ", total = ", total);
 
-        if ((nodes.size() + total) > targetMaxNumPagedLODWithHighResSubgraphs)
-        {
-            uint32_t numPagedLODHighRestSubgraphsToRemove = (static_cast<uint32_t>(nodes.size()) + total) - targetMaxNumPagedLODWithHighResSubgraphs;
-            uint32_t targetNumInactive = (numPagedLODHighRestSubgraphsToRemove < pagedLODContainer->inactiveList.count) ? (pagedLODContainer->inactiveList.count - numPagedLODHighRestSubgraphsToRemove) : 0;
-
-            debug("Need to remove, inactive count = ", pagedLODContainer->inactiveList.count, ", target = ", targetNumInactive);
-
-            for (uint32_t index = pagedLODContainer->inactiveList.head; (index != 0) && (pagedLODContainer->inactiveList.count > targetNumInactive);)
+        // expire inactive subgraphs from the head of the inactiveList, the least recently used, while required() returns true
+        auto expireInactiveWhile = [&](auto required) {
+            for (uint32_t index = pagedLODContainer->inactiveList.head; (index != 0) && required();)
             {
                 auto& element = elements[index];
                 index = element.next;
@@ -311,14 +751,70 @@ void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
                 if (compare_exchange(element.plod->requestStatus, PagedLOD::NoRequest, PagedLOD::DeleteRequest))
                 {
                     ref_ptr<PagedLOD> plod = element.plod;
+                    if (activeDeleteQueue) activeDeleteQueue->add(plod->children[0].node);
                     plod->children[0].node = nullptr;
                     plod->requestCount.exchange(0);
                     plod->requestStatus.exchange(PagedLOD::NoRequest);
                     plod->pending = {};
+                    totalDataSize -= std::min(totalDataSize, plod->highResDataSize);
+                    totalDeviceMemorySize -= std::min(totalDeviceMemorySize, plod->highResDeviceMemorySize);
+                    plod->highResDataSize = 0;
+                    plod->highResDeviceMemorySize = 0;
                     pagedLODContainer->remove(plod);
                     debug("    trimming ", plod, " ", plod->filename);
                 }
             }
+        };
+
+        auto expireInactive = [&](uint32_t numPagedLODHighRestSubgraphsToRemove) {
+            uint32_t targetNumInactive = (numPagedLODHighRestSubgraphsToRemove < pagedLODContainer->inactiveList.count) ? (pagedLODContainer->inactiveList.count - numPagedLODHighRestSubgraphsToRemove) : 0;
+
+            debug("Need to remove, inactive count = ", pagedLODContainer->inactiveList.count, ", target = ", targetNumInactive);
+
+            expireInactiveWhile([&]() { return pagedLODContainer->inactiveList.count > targetNumInactive; });
+        };
+
+        if (targetMaxDataSize > 0 || targetMaxDeviceMemorySize > 0)
+        {
+            // account for the subgraphs about to be merged so that memory is made available for them
+            uint64_t pendingDataSize = 0;
+            uint64_t pendingDeviceMemorySize = 0;
+            for (auto& plod : nodes)
+            {
+                pendingDataSize += plod->highResDataSize;
+                pendingDeviceMemorySize += plod->highResDeviceMemorySize;
+            }
+
+            expireInactiveWhile([&]() {
+                return (targetMaxDataSize > 0 && (totalDataSize + pendingDataSize) > targetMaxDataSize) ||
+                       (targetMaxDeviceMemorySize > 0 && (totalDeviceMemorySize + pendingDeviceMemorySize) > targetMaxDeviceMemorySize);
+            });
+
+            if (instrumentation)
+            {
+                instrumentation->plot("DatabasePager data size MB", static_cast<double>(totalDataSize) / (1024.0 * 1024.0));
+                instrumentation->plot("DatabasePager device memory size MB", static_cast<double>(totalDeviceMemorySize) / (1024.0 * 1024.0));
+            }
+        }
+        else if ((nodes.size() + total) > targetMaxNumPagedLODWithHighResSubgraphs)
+        {
+            expireInactive((static_cast<uint32_t>(nodes.size()) + total) - targetMaxNumPagedLODWithHighResSubgraphs);
+        }
+
+        if (memoryBudget)
+        {
+            memoryBudget->update();
+
+            double ratio = memoryBudget->usageRatio();
+            if (instrumentation) instrumentation->plot("DatabasePager memory usage ratio", ratio);
+
+            if (ratio > targetMaxMemoryUsageRatio && pagedLODContainer->inactiveList.count > 0)
+            {
+                // expire the proportion of the inactive subgraphs that the usage is over target by, at least one per frame, so usage converges on the target over successive frames
+                auto numToRemove = static_cast<uint32_t>(static_cast<double>(pagedLODContainer->inactiveList.count) * (ratio - targetMaxMemoryUsageRatio) / ratio);
+                debug("DatabasePager : memory usage ratio = ", ratio, " exceeds target = ", targetMaxMemoryUsageRatio);
+                expireInactive(std::max(numToRemove, 1u));
+            }
         }
     }
 
@@ -331,8 +827,21 @@ void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
 #endif
 
         debug("DatabasePager::updateSceneGraph() nodes to merge : nodes.size() = ", nodes.size(), ", ", numActiveRequests.load());
+
+        auto mergeStartTime = clock::now();
+        uint32_t numMerged = 0;
         for (auto& plod : nodes)
         {
+            if (maxMergeTimePerFrame > 0.0 && numMerged > 0 &&
+                std::chrono::duration<double, std::chrono::milliseconds::period>(clock::now() - mergeStartTime).count() >= maxMergeTimePerFrame)
+            {
+                // over the time budget so defer the merge to a later frame
+                _toMergeQueue->add(plod);
+                continue;
+            }
+
+            ++numMerged;
+
             if (compare_exchange(plod->requestStatus, PagedLOD::MergeRequest, PagedLOD::Merging))
             {
                 debug("   Merged ", plod->filename, " after ", plod->requestCount.load(), " priority ", plod->priority.load(), " ", frameCount - plod->frameHighResLastUsed.load(), " plod = ", plod);
@@ -343,13 +852,31 @@ void DatabasePager::updateSceneGraph(FrameStamp* frameStamp, CompileResult& cr)
                     plod->children[0].node = plod->pending;
                 }
 
+                totalDataSize += plod->highResDataSize;
+                totalDeviceMemorySize += plod->highResDeviceMemorySize;
+
+                // predicted requests may be merged before the RecordTraversal has used them, so track them to ensure they can be expired
+                if (plod->index == 0 && pagedLODContainer) pagedLODContainer->active(plod);
+
                 plod->requestStatus.exchange(PagedLOD::NoRequest);
+
+                if (workloadRecorder) workloadRecorder->pagerMerge(frameCount.load(), plod->filename);
             }
         }
-        numActiveRequests -= static_cast<uint32_t>(nodes.size());
+        numActiveRequests -= numMerged;
+
+        if (instrumentation)
+        {
+            instrumentation->plot("DatabasePager merge time ms", std::chrono::duration<double, std::chrono::milliseconds::period>(clock::now() - mergeStartTime).count());
+            instrumentation->plot("DatabasePager merged", static_cast<double>(numMerged));
+        }
+
+        if (numMerged < nodes.size()) debug("DatabasePager::updateSceneGraph() deferred ", nodes.size() - numMerged, " merges");
     }
     else
     {
         debug("DatabasePager::updateSceneGraph() nothing to merge");
     }
+
+    if (prefetcher) prefetcher->dispatch(*this, frameStamp);
 }
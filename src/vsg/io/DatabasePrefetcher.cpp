@@ -0,0 +1,209 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/DatabasePager.h>
+#include <vsg/io/DatabasePrefetcher.h>
+#include <vsg/io/Logger.h>
+#include <vsg/utils/LoadPagedLOD.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+namespace
+{
+    struct PredictedViewMatrix : public ViewMatrix
+    {
+        explicit PredictedViewMatrix(const dmat4& m) :
+            matrix(m) {}
+
+        dmat4 transform() const override { return matrix; }
+
+        dmat4 matrix;
+    };
+
+    /// collect the PagedLOD whose high res child would be required at a predicted view without reading them
+    class CollectPrefetchCandidates : public LoadPagedLOD
+    {
+    public:
+        CollectPrefetchCandidates(ref_ptr<Camera> in_camera, double in_priorityScale, std::map<PagedLOD*, double>& in_candidates) :
+            LoadPagedLOD(in_camera),
+            priorityScale(in_priorityScale),
+            candidates(in_candidates)
+        {
+        }
+
+        using LoadPagedLOD::apply;
+
+        void apply(PagedLOD& plod) override
+        {
+            if (!intersect(_frustumStack.top(), plod.bound)) return;
+
+            auto [distance, rf] = computeDistanceAndRF(plod.bound);
+
+            auto& child = plod.children[0];
+            auto cutoff = child.minimumScreenHeightRatio * distance;
+            if (rf > cutoff)
+            {
+                if (child.node)
+                {
+                    child.node->accept(*this);
+                }
+                else
+                {
+                    auto priority = (cutoff > 0.0 ? (rf / cutoff) : 1.0) * priorityScale;
+                    auto& candidate = candidates[&plod];
+                    candidate = std::max(candidate, priority);
+                }
+            }
+            else if (plod.children[1].node)
+            {
+                plod.children[1].node->accept(*this);
+            }
+        }
+
+        double priorityScale = 1.0;
+        std::map<PagedLOD*, double>& candidates;
+    };
+
+    struct PrefetchOperation : public Operation
+    {
+        PrefetchOperation(ref_ptr<DatabasePrefetcher> in_prefetcher, ref_ptr<DatabasePager> in_databasePager, std::vector<dmat4> in_viewMatrices, ref_ptr<Latch> in_latch) :
+            prefetcher(in_prefetcher),
+            databasePager(in_databasePager),
+            viewMatrices(std::move(in_viewMatrices)),
+            latch(in_latch) {}
+
+        void run() override
+        {
+            prefetcher->evaluate(*databasePager, viewMatrices);
+            latch->count_down();
+        }
+
+        ref_ptr<DatabasePrefetcher> prefetcher;
+        ref_ptr<DatabasePager> databasePager;
+        std::vector<dmat4> viewMatrices;
+        ref_ptr<Latch> latch;
+    };
+} // namespace
+
+DatabasePrefetcher::DatabasePrefetcher(ref_ptr<Node> in_scene, ref_ptr<Camera> in_camera) :
+    scene(in_scene),
+    camera(in_camera)
+{
+}
+
+DatabasePrefetcher::~DatabasePrefetcher()
+{
+    wait();
+}
+
+void DatabasePrefetcher::dispatch(DatabasePager& databasePager, const FrameStamp* frameStamp)
+{
+    if (!scene || !camera || !camera->viewMatrix || !camera->projectionMatrix || !frameStamp || numSteps == 0) return;
+
+    // sample the camera velocity
+    auto viewMatrix = camera->viewMatrix->transform();
+    auto eye = camera->viewMatrix->inverse() * dvec3(0.0, 0.0, 0.0);
+    if (_previousSampleValid)
+    {
+        double dt = std::chrono::duration<double, std::chrono::seconds::period>(frameStamp->time - _previousTime).count();
+        if (dt > 0.0) _velocity = mix(_velocity, (eye - _previousEye) / dt, velocitySmoothing);
+    }
+    _previousSampleValid = true;
+    _previousTime = frameStamp->time;
+    _previousEye = eye;
+
+    std::vector<dmat4> predictedViewMatrices;
+    if (animationPathHandler && animationPathHandler->path)
+    {
+        for (uint32_t i = 1; i <= numSteps; ++i)
+        {
+            double t = animationPathHandler->time + lookAheadTime * static_cast<double>(i) / static_cast<double>(numSteps);
+            predictedViewMatrices.push_back(inverse(animationPathHandler->path->computeMatrix(t)));
+        }
+    }
+    else if (length(_velocity) > minimumSpeed)
+    {
+        for (uint32_t i = 1; i <= numSteps; ++i)
+        {
+            double t = lookAheadTime * static_cast<double>(i) / static_cast<double>(numSteps);
+            predictedViewMatrices.push_back(viewMatrix * translate(-_velocity * t));
+        }
+    }
+
+    if (predictedViewMatrices.empty()) return;
+
+    ref_ptr<OperationThreads> threads = databasePager.operationThreads;
+    if (!threads)
+    {
+        if (!_threads) _threads = OperationThreads::create(1);
+        threads = _threads;
+    }
+
+    _latch = Latch::create(1);
+    threads->add(ref_ptr<Operation>(new PrefetchOperation(ref_ptr<DatabasePrefetcher>(this), ref_ptr<DatabasePager>(&databasePager), std::move(predictedViewMatrices), _latch)));
+}
+
+void DatabasePrefetcher::wait()
+{
+    if (_latch)
+    {
+        _latch->wait();
+        _latch = {};
+    }
+}
+
+void DatabasePrefetcher::evaluate(DatabasePager& databasePager, const std::vector<dmat4>& predictedViewMatrices)
+{
+    uint64_t frameCount = databasePager.frameCount.load();
+
+    // collect the PagedLOD required at each predicted view, weighting the nearer predictions more highly
+    std::map<PagedLOD*, double> candidates;
+    for (size_t i = 0; i < predictedViewMatrices.size(); ++i)
+    {
+        auto predictedCamera = Camera::create(camera->projectionMatrix, ref_ptr<ViewMatrix>(new PredictedViewMatrix(predictedViewMatrices[i])));
+        CollectPrefetchCandidates collect(predictedCamera, priorityScale / static_cast<double>(i + 1), candidates);
+        scene->accept(collect);
+    }
+
+    std::vector<std::pair<double, PagedLOD*>> ordered;
+    ordered.reserve(candidates.size());
+    for (auto& [plod, priority] : candidates) ordered.emplace_back(priority, plod);
+    std::sort(ordered.begin(), ordered.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+    uint32_t numIssued = 0;
+    for (auto& [priority, plod] : ordered)
+    {
+        if (plod->requestStatus.load() != PagedLOD::NoRequest)
+        {
+            // keep earlier predicted requests that are still in flight from being discarded as expired
+            if (plod->frameHighResLastUsed.load() < frameCount) plod->frameHighResLastUsed.exchange(frameCount);
+            continue;
+        }
+
+        if (numIssued >= maxRequestsPerFrame || databasePager.numActiveRequests.load() >= maxActiveRequests) continue;
+
+        plod->priority.exchange(priority);
+        if (plod->frameHighResLastUsed.load() < frameCount) plod->frameHighResLastUsed.exchange(frameCount);
+
+        if (plod->requestCount.fetch_add(1) == 0)
+        {
+            databasePager.request(ref_ptr<PagedLOD>(plod));
+            ++numIssued;
+        }
+    }
+
+    numRequestsIssued.exchange(numIssued);
+
+    if (numIssued > 0) debug("DatabasePrefetcher::evaluate() issued ", numIssued, " predicted requests from ", candidates.size(), " candidates");
+}
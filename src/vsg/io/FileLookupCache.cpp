@@ -0,0 +1,127 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/FileLookupCache.h>
+#include <vsg/io/FileSystem.h>
+
+using namespace vsg;
+
+namespace
+{
+    // split path into its directory and the final path component
+    std::pair<Path, Path> splitPath(const Path& path)
+    {
+        auto pos = path.find_last_of(Path::separators);
+        if (pos == Path::npos) return {Path(), path};
+        return {path.substr(0, pos), path.substr(pos + 1)};
+    }
+} // namespace
+
+FileLookupCache::FileLookupCache(double in_expiryTime) :
+    expiryTime(in_expiryTime)
+{
+}
+
+FileLookupCache::~FileLookupCache()
+{
+}
+
+FileLookupCache::Shard& FileLookupCache::_shard(const Path& directory)
+{
+    // files are sharded by their directory so a directory index and the files within it are guarded by the same mutex
+    return _shards[std::hash<Path::string_type>{}(directory.native()) % numShards];
+}
+
+bool FileLookupCache::_expired(const time_point& timestamp, const time_point& now) const
+{
+    return expiryTime > 0.0 && std::chrono::duration<double>(now - timestamp).count() > expiryTime;
+}
+
+bool FileLookupCache::fileExists(const Path& path)
+{
+    auto [directory, name] = splitPath(path);
+    auto now = std::chrono::steady_clock::now();
+
+    auto& shard = _shard(directory);
+    {
+        std::scoped_lock<std::mutex> lock(shard.mutex);
+
+        if (auto itr = shard.directories.find(directory); itr != shard.directories.end())
+        {
+            if (!_expired(itr->second.timestamp, now)) return itr->second.contents.count(name) != 0;
+            shard.directories.erase(itr);
+        }
+
+        if (auto itr = shard.files.find(path); itr != shard.files.end())
+        {
+            if (!_expired(itr->second.second, now)) return itr->second.first;
+            shard.files.erase(itr);
+        }
+    }
+
+    // check the filesystem without holding the lock so other threads aren't blocked by slow filesystems
+    if (indexDirectoriesOnLookup && !directory.empty())
+    {
+        return _indexDirectory(directory, name);
+    }
+
+    bool exists = vsg::fileExists(path);
+
+    std::scoped_lock<std::mutex> lock(shard.mutex);
+    shard.files[path] = {exists, now};
+    return exists;
+}
+
+bool FileLookupCache::_indexDirectory(const Path& directory, const Path& name)
+{
+    Directory entry;
+    entry.timestamp = std::chrono::steady_clock::now();
+    for (auto& name : getDirectoryContents(directory))
+    {
+        entry.contents.insert(name);
+    }
+
+    auto& shard = _shard(directory);
+    std::scoped_lock<std::mutex> lock(shard.mutex);
+    auto& directoryEntry = shard.directories[directory];
+    directoryEntry = std::move(entry);
+    return !name.empty() && directoryEntry.contents.count(name) != 0;
+}
+
+void FileLookupCache::addDirectory(const Path& in_directory)
+{
+    // strip trailing separators so the directory matches the paths that lookups are split into
+    auto directory = in_directory;
+    while (directory.size() > 1 && directory.find_last_of(Path::separators) == directory.size() - 1) directory = directory.substr(0, directory.size() - 1);
+
+    _indexDirectory(directory, {});
+}
+
+void FileLookupCache::invalidate(const Path& path)
+{
+    auto directory = splitPath(path).first;
+
+    auto& shard = _shard(directory);
+    std::scoped_lock<std::mutex> lock(shard.mutex);
+    shard.files.erase(path);
+    shard.directories.erase(directory);
+}
+
+void FileLookupCache::clear()
+{
+    for (auto& shard : _shards)
+    {
+        std::scoped_lock<std::mutex> lock(shard.mutex);
+        shard.files.clear();
+        shard.directories.clear();
+    }
+}
@@ -142,6 +142,42 @@ bool vsg::fileExists(const Path& path)
 #endif
 }
 
+bool vsg::fileStatus(const Path& path, uint64_t& size, int64_t& modificationTime)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    struct __stat64 stbuf;
+    if (_wstat64(path.c_str(), &stbuf) != 0) return false;
+#elif defined(__APPLE__)
+    struct stat stbuf;
+    if (stat(path.c_str(), &stbuf) != 0) return false;
+#else
+    struct stat64 stbuf;
+    if (stat64(path.c_str(), &stbuf) != 0) return false;
+#endif
+
+    size = static_cast<uint64_t>(stbuf.st_size);
+    modificationTime = static_cast<int64_t>(stbuf.st_mtime);
+    return true;
+}
+
+bool vsg::removeFile(const Path& path)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    return _wremove(path.c_str()) == 0;
+#else
+    return ::remove(path.c_str()) == 0;
+#endif
+}
+
+bool vsg::renameFile(const Path& from, const Path& to)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    return MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return ::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
 Path vsg::findFile(const Path& filename, const Paths& paths)
 {
     for (auto path : paths)
@@ -162,20 +198,28 @@ Path vsg::findFile(const Path& filename, const Options* options)
         // if Options has a findFileCallback use it
         if (options->findFileCallback) return options->findFileCallback(filename, options);
 
+        auto exists = [&](const Path& path) { return options->fileLookupCache ? options->fileLookupCache->fileExists(path) : fileExists(path); };
+
         if (!options->paths.empty())
         {
             // if appropriate use the filename directly if it exists.
-            if (options->checkFilenameHint == Options::CHECK_ORIGINAL_FILENAME_EXISTS_FIRST && fileExists(filename)) return filename;
+            if (options->checkFilenameHint == Options::CHECK_ORIGINAL_FILENAME_EXISTS_FIRST && exists(filename)) return filename;
 
             // search for the file in the options specific paths.
-            if (auto path = findFile(filename, options->paths)) return path;
+            for (auto& path : options->paths)
+            {
+                Path fullpath = path / filename;
+                if (exists(fullpath)) return fullpath;
+            }
 
             // if appropriate use the filename directly if it exists.
-            if (options->checkFilenameHint == Options::CHECK_ORIGINAL_FILENAME_EXISTS_LAST && fileExists(filename))
+            if (options->checkFilenameHint == Options::CHECK_ORIGINAL_FILENAME_EXISTS_LAST && exists(filename))
                 return filename;
             else
                 return {};
         }
+
+        return exists(filename) ? filename : Path();
     }
 
     return fileExists(filename) ? filename : Path();
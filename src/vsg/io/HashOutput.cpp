@@ -0,0 +1,98 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/HashOutput.h>
+
+using namespace vsg;
+
+// FNV-1a 64 bit offset basis and prime
+static constexpr uint64_t s_offsetBasis = 14695981039346656037ull;
+static constexpr uint64_t s_prime = 1099511628211ull;
+
+HashOutput::HashOutput(ref_ptr<const Options> in_options) :
+    Output(in_options),
+    value(s_offsetBasis)
+{
+}
+
+void HashOutput::add(const void* ptr, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(ptr);
+    for (size_t i = 0; i < size; ++i)
+    {
+        value = (value ^ bytes[i]) * s_prime;
+    }
+}
+
+void HashOutput::write(size_t num, const std::string* value)
+{
+    for (; num > 0; --num, ++value)
+    {
+        uint64_t size = value->size();
+        add(&size, sizeof(size));
+        add(value->data(), value->size());
+    }
+}
+
+void HashOutput::write(size_t num, const std::wstring* value)
+{
+    for (; num > 0; --num, ++value)
+    {
+        uint64_t size = value->size();
+        add(&size, sizeof(size));
+        add(value->data(), value->size() * sizeof(wchar_t));
+    }
+}
+
+void HashOutput::write(size_t num, const Path* value)
+{
+    for (; num > 0; --num, ++value)
+    {
+        auto& str = value->native();
+        uint64_t size = str.size();
+        add(&size, sizeof(size));
+        add(str.data(), str.size() * sizeof(Path::value_type));
+    }
+}
+
+void HashOutput::write(const vsg::Object* object)
+{
+    if (auto itr = objectIDMap.find(object); itr != objectIDMap.end())
+    {
+        add(&(itr->second), sizeof(ObjectID));
+        return;
+    }
+
+    ObjectID id = objectID++;
+    objectIDMap[object] = id;
+    add(&id, sizeof(id));
+
+    if (object)
+    {
+        std::string className(object->className());
+        write(1, &className);
+        object->write(*this);
+    }
+}
+
+bool HashOutput::writeData(const void* ptr, size_t valueSize, size_t count, bool /*integerValues*/)
+{
+    add(ptr, valueSize * count);
+    return true;
+}
+
+uint64_t vsg::hash(const Object* object)
+{
+    HashOutput output;
+    output.write(object);
+    return output.value;
+}
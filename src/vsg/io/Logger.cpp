@@ -42,6 +42,12 @@ Logger::~Logger()
 {
 }
 
+std::ostringstream& Logger::_threadStream()
+{
+    static thread_local std::ostringstream s_stream;
+    return s_stream;
+}
+
 ref_ptr<Logger>& Logger::instance()
 {
     static ref_ptr<Logger> s_logger = StdLogger::create();
@@ -53,72 +59,77 @@ void Logger::debug_stream(PrintToStreamFunction print)
 {
     if (level > LOGGER_DEBUG) return;
 
-    std::scoped_lock<std::mutex> lock(_mutex);
-    _stream.str({});
-    _stream.clear();
+    auto& stream = _threadStream();
+    stream.str({});
+    stream.clear();
 
-    print(_stream);
+    print(stream);
 
-    debug_implementation(_stream.str());
+    auto lock = _lock();
+    debug_implementation(stream.str());
 }
 
 void Logger::info_stream(PrintToStreamFunction print)
 {
     if (level > LOGGER_INFO) return;
 
-    std::scoped_lock<std::mutex> lock(_mutex);
-    _stream.str({});
-    _stream.clear();
+    auto& stream = _threadStream();
+    stream.str({});
+    stream.clear();
 
-    print(_stream);
+    print(stream);
 
-    info_implementation(_stream.str());
+    auto lock = _lock();
+    info_implementation(stream.str());
 }
 
 void Logger::warn_stream(PrintToStreamFunction print)
 {
     if (level > LOGGER_WARN) return;
 
-    std::scoped_lock<std::mutex> lock(_mutex);
-    _stream.str({});
-    _stream.clear();
+    auto& stream = _threadStream();
+    stream.str({});
+    stream.clear();
 
-    print(_stream);
+    print(stream);
 
-    warn_implementation(_stream.str());
+    auto lock = _lock();
+    warn_implementation(stream.str());
 }
 
 void Logger::error_stream(PrintToStreamFunction print)
 {
     if (level > LOGGER_ERROR) return;
 
-    std::scoped_lock<std::mutex> lock(_mutex);
-    _stream.str({});
-    _stream.clear();
+    auto& stream = _threadStream();
+    stream.str({});
+    stream.clear();
 
-    print(_stream);
+    print(stream);
 
-    error_implementation(_stream.str());
+    auto lock = _lock();
+    error_implementation(stream.str());
 }
 
 void Logger::fatal_stream(PrintToStreamFunction print)
 {
     if (level > LOGGER_FATAL) return;
 
-    std::scoped_lock<std::mutex> lock(_mutex);
-    _stream.str({});
-    _stream.clear();
+    auto& stream = _threadStream();
+    stream.str({});
+    stream.clear();
 
-    print(_stream);
+    print(stream);
 
-    fatal_implementation(_stream.str());
+    auto lock = _lock();
+    fatal_implementation(stream.str());
 }
 
 void Logger::log(Level msg_level, const std::string_view& message)
 {
     if (level > msg_level) return;
-    std::scoped_lock<std::mutex> lock(_mutex);
 
+    auto lock = _lock();
     switch (msg_level)
     {
     case (LOGGER_DEBUG): debug_implementation(message); break;
@@ -134,19 +145,20 @@ void Logger::log_stream(Level msg_level, PrintToStreamFunction print)
 {
     if (level > msg_level) return;
 
-    std::scoped_lock<std::mutex> lock(_mutex);
-    _stream.str({});
-    _stream.clear();
+    auto& stream = _threadStream();
+    stream.str({});
+    stream.clear();
 
-    print(_stream);
+    print(stream);
 
+    auto lock = _lock();
     switch (msg_level)
     {
-    case (LOGGER_DEBUG): debug_implementation(_stream.str()); break;
-    case (LOGGER_INFO): info_implementation(_stream.str()); break;
-    case (LOGGER_WARN): warn_implementation(_stream.str()); break;
-    case (LOGGER_ERROR): error_implementation(_stream.str()); break;
-    case (LOGGER_FATAL): fatal_implementation(_stream.str()); break;
+    case (LOGGER_DEBUG): debug_implementation(stream.str()); break;
+    case (LOGGER_INFO): info_implementation(stream.str()); break;
+    case (LOGGER_WARN): warn_implementation(stream.str()); break;
+    case (LOGGER_ERROR): error_implementation(stream.str()); break;
+    case (LOGGER_FATAL): fatal_implementation(stream.str()); break;
     default: break;
     }
 }
@@ -0,0 +1,113 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+
+#include <vsg/core/Array.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/MappedFile.h>
+
+#include <cstring>
+#include <limits>
+
+#if defined(WIN32) && !defined(__CYGWIN__)
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+using namespace vsg;
+
+MappedFile::MappedFile(const Path& filename)
+{
+    properties.allocatorType = ALLOCATOR_TYPE_NO_DELETE;
+
+#if defined(WIN32) && !defined(__CYGWIN__)
+    HANDLE file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        warn("MappedFile() unable to open ", filename);
+        return;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+    {
+        // copy on write mapping so Arrays that reference the file can still be modified without affecting the file
+        _fileMapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (_fileMapping)
+        {
+            _data = reinterpret_cast<uint8_t*>(MapViewOfFile(_fileMapping, FILE_MAP_COPY, 0, 0, 0));
+            if (_data)
+            {
+                _size = static_cast<size_t>(fileSize.QuadPart);
+            }
+            else
+            {
+                CloseHandle(_fileMapping);
+                _fileMapping = nullptr;
+            }
+        }
+    }
+
+    CloseHandle(file);
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        warn("MappedFile() unable to open ", filename);
+        return;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        // copy on write mapping so Arrays that reference the file can still be modified without affecting the file
+        void* ptr = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (ptr != MAP_FAILED)
+        {
+            _data = reinterpret_cast<uint8_t*>(ptr);
+            _size = static_cast<size_t>(fileStat.st_size);
+        }
+    }
+
+    // the mapping remains valid after the file descriptor is closed
+    close(fd);
+#endif
+
+    if (!_data) warn("MappedFile() unable to map ", filename);
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(WIN32) && !defined(__CYGWIN__)
+    if (_data) UnmapViewOfFile(_data);
+    if (_fileMapping) CloseHandle(_fileMapping);
+#else
+    if (_data) munmap(_data, _size);
+#endif
+}
+
+ref_ptr<Data> MappedFile::clone() const
+{
+    if (_size > std::numeric_limits<uint32_t>::max())
+    {
+        warn("MappedFile::clone() file too large to copy to a ubyteArray.");
+        return {};
+    }
+
+    auto copy = ubyteArray::create(static_cast<uint32_t>(_size));
+    if (_data) std::memcpy(copy->dataPointer(), _data, _size);
+    return copy;
+}
@@ -25,6 +25,10 @@ ObjectFactory::ObjectFactory()
 {
     _createMap["nullptr"] = []() { return ref_ptr<Object>(); };
 
+    // size the index for all the built-in types so that registering them doesn't require repeated rebuilds
+    _index.resize(1024);
+    buildIndex();
+
     // cores
     add<vsg::Object>();
     add<vsg::Objects>();
@@ -58,6 +62,7 @@ ObjectFactory::ObjectFactory()
     add<vsg::materialValue>();
     add<vsg::PhongMaterialValue>();
     add<vsg::PbrMaterialValue>();
+    add<vsg::ToneMapSettingsValue>();
     add<vsg::sphereValue>();
     add<vsg::boxValue>();
     add<vsg::quatValue>();
@@ -106,6 +111,7 @@ ObjectFactory::ObjectFactory()
     add<vsg::PhongMaterialArray>();
     add<vsg::PbrMaterialArray>();
     add<vsg::DrawIndirectCommandArray>();
+    add<vsg::DrawIndexedIndirectCommandArray>();
 
     // array2Ds
     add<vsg::byteArray2D>();
@@ -171,16 +177,25 @@ ObjectFactory::ObjectFactory()
     add<vsg::QuadGroup>();
     add<vsg::StateGroup>();
     add<vsg::CullGroup>();
+    add<vsg::SpatialGroup>();
     add<vsg::CullNode>();
+    add<vsg::OcclusionQueryNode>();
     add<vsg::LOD>();
     add<vsg::PagedLOD>();
+    add<vsg::Impostor>();
+    add<vsg::PointCloud>();
+    add<vsg::StreamingTexture>();
     add<vsg::AbsoluteTransform>();
     add<vsg::MatrixTransform>();
+    add<vsg::TransformPool>();
+    add<vsg::PooledTransform>();
     add<vsg::Geometry>();
     add<vsg::VertexDraw>();
     add<vsg::VertexIndexDraw>();
+    add<vsg::InstancedGeometry>();
     add<vsg::Bin>();
     add<vsg::DepthSorted>();
+    add<vsg::FlattenedSubgraph>();
     add<vsg::Switch>();
     add<vsg::Light>();
     add<vsg::AmbientLight>();
@@ -190,6 +205,7 @@ ObjectFactory::ObjectFactory()
     add<vsg::TileDatabase>();
     add<vsg::TileDatabaseSettings>();
     add<vsg::InstrumentationNode>();
+    add<vsg::InstanceNode>();
 
     // vulkan objects
     add<vsg::BindGraphicsPipeline>();
@@ -206,14 +222,16 @@ ObjectFactory::ObjectFactory()
     add<vsg::RasterizationState>();
     add<vsg::MultisampleState>();
     add<vsg::ColorBlendState>();
+    add<vsg::OITColorBlendState>();
     add<vsg::ViewportState>();
     add<vsg::MultisampleState>();
     add<vsg::DepthStencilState>();
-    add<vsg::ColorBlendState>();
     add<vsg::DynamicState>();
+    add<vsg::FragmentShadingRateState>();
     add<vsg::Dispatch>();
     add<vsg::BindDescriptorSets>();
     add<vsg::BindDescriptorSet>();
+    add<vsg::PushDescriptorSet>();
     add<vsg::BindVertexBuffers>();
     add<vsg::BindIndexBuffer>();
     add<vsg::BindViewDescriptorSets>();
@@ -226,12 +244,14 @@ ObjectFactory::ObjectFactory()
     add<vsg::PushConstants>();
     add<vsg::ResourceHints>();
     add<vsg::StateSwitch>();
+    add<vsg::SetDynamicState>();
 
     // commands
     add<vsg::Draw>();
     add<vsg::DrawIndirect>();
     add<vsg::DrawIndexed>();
     add<vsg::DrawIndexedIndirect>();
+    add<vsg::DrawIndexedIndirectCount>();
     add<vsg::CopyImage>();
     add<vsg::BlitImage>();
     add<vsg::QueryPool>();
@@ -249,6 +269,9 @@ ObjectFactory::ObjectFactory()
     add<vsg::StandardLayout>();
     add<vsg::CpuLayoutTechnique>();
     add<vsg::GpuLayoutTechnique>();
+    add<vsg::GpuLabelTechnique>();
+    add<vsg::LabelArray>();
+    add<vsg::LabelGlyphArray>();
     add<vsg::TextLayoutValue>();
 
     // ui
@@ -282,6 +305,7 @@ ObjectFactory::ObjectFactory()
     add<vsg::DrawMeshTasks>();
     add<vsg::DrawMeshTasksIndirect>();
     add<vsg::DrawMeshTasksIndirectCount>();
+    add<vsg::MeshletArray>();
 
     // io
     add<vsg::Options>();
@@ -295,11 +319,14 @@ ObjectFactory::ObjectFactory()
     add<vsg::AnimationPath>();
     add<vsg::ShaderSet>();
     add<vsg::ViewDependentStateBinding>();
+    add<vsg::BindlessTextureBinding>();
     add<vsg::PositionAndDisplacementMapArrayState>();
     add<vsg::DisplacementMapArrayState>();
     add<vsg::PositionArrayState>();
     add<vsg::BillboardArrayState>();
     add<vsg::SharedObjects>();
+    add<vsg::TriangleBVH>();
+    add<vsg::ElevationGrid>();
 
     // application
     add<vsg::EllipsoidModel>();
@@ -309,12 +336,79 @@ ObjectFactory::~ObjectFactory()
 {
 }
 
+void ObjectFactory::buildIndex()
+{
+    size_t capacity = std::max(_index.size(), size_t(16));
+    while (capacity < _createMap.size() * 2) capacity *= 2;
+
+    _index.clear();
+    _index.resize(capacity);
+    _indexSize = 0;
+    _indexValid = true;
+
+    for (auto itr = _createMap.begin(); itr != _createMap.end(); ++itr)
+    {
+        _addToIndex(itr);
+    }
+}
+
+void ObjectFactory::_addToIndex(CreateMap::const_iterator itr)
+{
+    if (!_indexValid) return;
+
+    // keep the load factor at or below 0.5 so probe sequences stay short
+    if ((_indexSize + 1) * 2 > _index.size())
+    {
+        _index.resize(_index.size() * 2);
+        buildIndex();
+        return;
+    }
+
+    size_t hash = std::hash<std::string>{}(itr->first);
+    size_t mask = _index.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        auto& entry = _index[i];
+        if (!entry.used)
+        {
+            entry.hash = hash;
+            entry.itr = itr;
+            entry.used = true;
+            ++_indexSize;
+            return;
+        }
+        if (entry.hash == hash && entry.itr->first == itr->first)
+        {
+            entry.itr = itr;
+            return;
+        }
+    }
+}
+
+const ObjectFactory::CreateFunction* ObjectFactory::getCreateFunction(const std::string& className) const
+{
+    if (_indexValid)
+    {
+        size_t hash = std::hash<std::string>{}(className);
+        size_t mask = _index.size() - 1;
+        for (size_t i = hash & mask; _index[i].used; i = (i + 1) & mask)
+        {
+            auto& entry = _index[i];
+            if (entry.hash == hash && entry.itr->first == className) return &(entry.itr->second);
+        }
+        return nullptr;
+    }
+
+    auto itr = _createMap.find(className);
+    return (itr != _createMap.end()) ? &(itr->second) : nullptr;
+}
+
 vsg::ref_ptr<vsg::Object> ObjectFactory::create(const std::string& className)
 {
-    if (auto itr = _createMap.find(className); itr != _createMap.end())
+    if (auto createFunction = getCreateFunction(className))
     {
         debug("Using _createMap for ", className);
-        return (itr->second)();
+        return (*createFunction)();
     }
 
     warn("ObjectFactory::create(", className, ") failed to find means to create object");
@@ -36,12 +36,15 @@ Options::Options(const Options& options) :
     sharedObjects(options.sharedObjects),
     readerWriters(options.readerWriters),
     operationThreads(options.operationThreads),
+    activityStatus(options.activityStatus),
     checkFilenameHint(options.checkFilenameHint),
     paths(options.paths),
     findFileCallback(options.findFileCallback),
+    fileLookupCache(options.fileLookupCache),
     fileCache(options.fileCache),
     extensionHint(options.extensionHint),
     mapRGBtoRGBAHint(options.mapRGBtoRGBAHint),
+    releaseDataHint(options.releaseDataHint),
     sceneCoordinateConvention(options.sceneCoordinateConvention),
     formatCoordinateConventions(options.formatCoordinateConventions),
     shaderSets(options.shaderSets),
@@ -50,7 +53,7 @@ Options::Options(const Options& options) :
 {
     getOrCreateAuxiliary();
     // copy any meta data.
-    if (options.getAuxiliary()) getAuxiliary()->userObjects = options.getAuxiliary()->userObjects;
+    if (options.getAuxiliary()) getAuxiliary()->copyObjects(*options.getAuxiliary());
 }
 
 Options::~Options()
@@ -70,6 +73,7 @@ int Options::compare(const Object& rhs_object) const
     if ((result = compare_value(fileCache, rhs.fileCache))) return result;
     if ((result = compare_value(extensionHint, rhs.extensionHint))) return result;
     if ((result = compare_value(mapRGBtoRGBAHint, rhs.mapRGBtoRGBAHint))) return result;
+    if ((result = compare_value(releaseDataHint, rhs.releaseDataHint))) return result;
     if ((result = compare_value(sceneCoordinateConvention, rhs.sceneCoordinateConvention))) return result;
     if ((result = compare_value(formatCoordinateConventions, rhs.formatCoordinateConventions))) return result;
     return compare_value(shaderSets, rhs.shaderSets);
@@ -0,0 +1,172 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/ReadBatch.h>
+#include <vsg/io/read.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ReadRequest
+//
+ReadRequest::ReadRequest(const Path& in_filename) :
+    filename(in_filename),
+    _latch(Latch::create(1))
+{
+}
+
+ReadRequest::~ReadRequest()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ReadBatch
+//
+struct ReadBatch::ReadOperation : public Inherit<Operation, ReadOperation>
+{
+    explicit ReadOperation(ReadBatch* in_batch) :
+        batch(in_batch) {}
+
+    void run() override
+    {
+        // keep reading pending requests until none are left so the number of concurrent reads never exceeds the number of ReadOperation
+        while (auto request = batch->_takeRequest())
+        {
+            batch->_process(*request);
+        }
+    }
+
+    ReadBatch* batch;
+};
+
+ReadBatch::ReadBatch(ref_ptr<const Options> in_options, ref_ptr<CompileManager> in_compileManager) :
+    options(in_options),
+    compileManager(in_compileManager)
+{
+    if (options) operationThreads = options->operationThreads;
+}
+
+ReadBatch::~ReadBatch()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // abandon pending requests, releasing anyone waiting on them
+    for (auto& request : _pending)
+    {
+        request->_latch->count_down();
+    }
+    _pending.clear();
+
+    // the ReadOperation don't hold a reference to the ReadBatch so wait for the active ones to finish with it
+    _cv.wait(lock, [&]() { return _numActive == 0; });
+}
+
+ref_ptr<ReadRequest> ReadBatch::read(const Path& filename)
+{
+    return read(Paths{filename}).front();
+}
+
+std::vector<ref_ptr<ReadRequest>> ReadBatch::read(const Paths& filenames)
+{
+    std::vector<ref_ptr<ReadRequest>> requests;
+    requests.reserve(filenames.size());
+    for (auto& filename : filenames)
+    {
+        requests.push_back(ReadRequest::create(filename));
+    }
+
+    uint32_t numOperations = 0;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        _pending.insert(_pending.end(), requests.begin(), requests.end());
+        _numRequests += requests.size();
+
+        uint32_t maxActive = std::max(maxConcurrentReads, 1u);
+        while (_numActive < maxActive && _numActive < _pending.size())
+        {
+            ++_numActive;
+            ++numOperations;
+        }
+
+        if (numOperations > 0 && !operationThreads) operationThreads = OperationThreads::create(maxActive);
+    }
+
+    for (uint32_t i = 0; i < numOperations; ++i)
+    {
+        operationThreads->add(ReadOperation::create(this));
+    }
+
+    return requests;
+}
+
+ref_ptr<ReadRequest> ReadBatch::_takeRequest()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    if (_pending.empty())
+    {
+        --_numActive;
+        _cv.notify_all();
+        return {};
+    }
+
+    auto request = _pending.front();
+    _pending.pop_front();
+    return request;
+}
+
+void ReadBatch::_process(ReadRequest& request)
+{
+    if (request.filename) request.object = vsg::read(request.filename, options);
+
+    if (request.object && compileManager)
+    {
+        request.compileResult = compileManager->compile(request.object);
+    }
+
+    if (completedCallback) completedCallback(request);
+
+    request._latch->count_down();
+
+    size_t completed = 0;
+    size_t total = 0;
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        completed = ++_numCompleted;
+        total = _numRequests;
+    }
+    _cv.notify_all();
+
+    if (progressCallback) progressCallback(completed, total);
+}
+
+void ReadBatch::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [&]() { return _numCompleted >= _numRequests; });
+}
+
+size_t ReadBatch::numRequests() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _numRequests;
+}
+
+size_t ReadBatch::numCompleted() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _numCompleted;
+}
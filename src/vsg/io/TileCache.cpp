@@ -0,0 +1,236 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/io/TileCache.h>
+#include <vsg/io/VSG.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+using namespace vsg;
+
+namespace
+{
+    // files being written are given a .tmp.vsgb suffix until they're complete and renamed into place
+    bool isTemporaryFile(const Path& key)
+    {
+        return lowerCaseFileExtension(key) == ".vsgb" && lowerCaseFileExtension(removeExtension(key)) == ".tmp";
+    }
+} // namespace
+
+TileCache::TileCache(const Path& in_directory, uint64_t in_maxDiskSize, double in_maxAge, uint32_t in_maxMemoryTiles) :
+    directory(in_directory),
+    maxDiskSize(in_maxDiskSize),
+    maxAge(in_maxAge),
+    maxMemoryTiles(in_maxMemoryTiles)
+{
+    if (!directory) return;
+
+    if (!makeDirectory(directory))
+    {
+        warn("TileCache::TileCache() unable to create cache directory ", directory);
+        return;
+    }
+
+    // populate the disk entries from the files left by previous runs, using the modification time to set the initial LRU order
+    std::vector<std::pair<int64_t, Path>> existingFiles;
+    for (auto& key : getDirectoryContents(directory))
+    {
+        if (lowerCaseFileExtension(key) != ".vsgb") continue;
+
+        uint64_t size = 0;
+        int64_t modificationTime = 0;
+        if (isTemporaryFile(key))
+        {
+            // remove files left partially written by runs that exited mid-write, leaving recent ones that another process may still be writing
+            if (fileStatus(_filename(key), size, modificationTime) && (static_cast<int64_t>(std::time(nullptr)) - modificationTime) > 60) removeFile(_filename(key));
+        }
+        else if (fileStatus(_filename(key), size, modificationTime))
+        {
+            existingFiles.emplace_back(modificationTime, key);
+            _diskEntries[key] = DiskEntry{size, modificationTime, {}};
+            _diskSize += size;
+        }
+    }
+
+    std::sort(existingFiles.begin(), existingFiles.end());
+    for (auto& [modificationTime, key] : existingFiles)
+    {
+        _diskEntries[key].itr = _diskLRU.insert(_diskLRU.end(), key);
+    }
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    // discard expired files, later expiry is checked as each file is read
+    auto now = static_cast<int64_t>(std::time(nullptr));
+    for (auto itr = _diskEntries.begin(); itr != _diskEntries.end();)
+    {
+        auto current = itr++;
+        if (_expired(current->second, now)) _removeDiskEntry(current);
+    }
+
+    _evictDiskEntries();
+}
+
+TileCache::~TileCache()
+{
+}
+
+Path TileCache::_filename(const Path& key) const
+{
+    return directory / key;
+}
+
+bool TileCache::_expired(const DiskEntry& entry, int64_t now) const
+{
+    return maxAge > 0.0 && static_cast<double>(now - entry.modificationTime) > maxAge;
+}
+
+ref_ptr<Object> TileCache::read(const Path& key, ref_ptr<const Options> options) const
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        if (auto itr = _memoryLookup.find(key); itr != _memoryLookup.end())
+        {
+            _memoryEntries.splice(_memoryEntries.begin(), _memoryEntries, itr->second);
+            return itr->second->second;
+        }
+
+        auto itr = _diskEntries.find(key);
+        if (itr == _diskEntries.end()) return {};
+
+        if (_expired(itr->second, static_cast<int64_t>(std::time(nullptr))))
+        {
+            _removeDiskEntry(itr);
+            return {};
+        }
+
+        _diskLRU.splice(_diskLRU.end(), _diskLRU, itr->second.itr);
+    }
+
+    VSG rw;
+    auto object = rw.read(_filename(key), options);
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    if (object)
+    {
+        _touchMemory(key, object);
+    }
+    else if (auto itr = _diskEntries.find(key); itr != _diskEntries.end())
+    {
+        // file unreadable so discard it
+        warn("TileCache::read() unable to read cache file ", _filename(key), ", removing it from the cache.");
+        _removeDiskEntry(itr);
+    }
+
+    return object;
+}
+
+void TileCache::write(const Path& key, ref_ptr<Object> object, ref_ptr<const Options> options) const
+{
+    if (!object) return;
+
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _touchMemory(key, object);
+    }
+
+    if (!directory) return;
+
+    // write to a uniquely named temporary file in the cache directory and then rename it into place,
+    // so that concurrent reads, and later runs after a crash mid-write, never see a partially written file.
+    static std::atomic_uint64_t s_writeCount{0};
+    auto unique = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    auto filename = _filename(key);
+    auto tempFilename = removeExtension(filename);
+    tempFilename += Path(std::string(".") + std::to_string(unique) + "_" + std::to_string(s_writeCount++) + ".tmp.vsgb");
+
+    VSG rw;
+    if (!rw.write(object, tempFilename, options) || !renameFile(tempFilename, filename))
+    {
+        warn("TileCache::write() unable to write cache file ", filename);
+        removeFile(tempFilename);
+        return;
+    }
+
+    uint64_t size = 0;
+    int64_t modificationTime = 0;
+    if (!fileStatus(filename, size, modificationTime)) return;
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    auto [itr, inserted] = _diskEntries.try_emplace(key);
+    auto& entry = itr->second;
+    if (inserted)
+    {
+        entry.itr = _diskLRU.insert(_diskLRU.end(), key);
+    }
+    else
+    {
+        _diskSize -= entry.size;
+        _diskLRU.splice(_diskLRU.end(), _diskLRU, entry.itr);
+    }
+
+    entry.size = size;
+    entry.modificationTime = modificationTime;
+    _diskSize += size;
+
+    _evictDiskEntries();
+}
+
+uint64_t TileCache::diskSize() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _diskSize;
+}
+
+void TileCache::_touchMemory(const Path& key, ref_ptr<Object> object) const
+{
+    if (maxMemoryTiles == 0) return;
+
+    if (auto itr = _memoryLookup.find(key); itr != _memoryLookup.end())
+    {
+        itr->second->second = object;
+        _memoryEntries.splice(_memoryEntries.begin(), _memoryEntries, itr->second);
+        return;
+    }
+
+    _memoryEntries.emplace_front(key, object);
+    _memoryLookup[key] = _memoryEntries.begin();
+
+    while (_memoryEntries.size() > maxMemoryTiles)
+    {
+        _memoryLookup.erase(_memoryEntries.back().first);
+        _memoryEntries.pop_back();
+    }
+}
+
+void TileCache::_removeDiskEntry(std::map<Path, DiskEntry>::iterator itr) const
+{
+    removeFile(_filename(itr->first));
+    _diskSize -= itr->second.size;
+    _diskLRU.erase(itr->second.itr);
+    _diskEntries.erase(itr);
+}
+
+void TileCache::_evictDiskEntries() const
+{
+    while (maxDiskSize > 0 && _diskSize > maxDiskSize && !_diskLRU.empty())
+    {
+        _removeDiskEntry(_diskEntries.find(_diskLRU.front()));
+    }
+}
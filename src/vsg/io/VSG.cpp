@@ -16,7 +16,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/BinaryInput.h>
 #include <vsg/io/BinaryOutput.h>
 #include <vsg/io/Logger.h>
+#include <vsg/io/MappedFile.h>
 #include <vsg/io/VSG.h>
+#include <vsg/io/async_stream.h>
 #include <vsg/io/mem_stream.h>
 
 using namespace vsg;
@@ -54,6 +56,7 @@ VSG::FormatInfo VSG::readHeader(std::istream& fin) const
 
     const char* match_token_ascii = "#vsga";
     const char* match_token_binary = "#vsgb";
+    const char* match_token_mappable = "#vsgm";
     char read_token[5];
     fin.read(read_token, 5);
 
@@ -62,6 +65,8 @@ VSG::FormatInfo VSG::readHeader(std::istream& fin) const
         type = ASCII;
     else if (std::strncmp(match_token_binary, read_token, 5) == 0)
         type = BINARY;
+    else if (std::strncmp(match_token_mappable, read_token, 5) == 0)
+        type = MAPPABLE_BINARY;
 
     if (type == NOT_RECOGNIZED)
     {
@@ -84,6 +89,8 @@ void VSG::writeHeader(std::ostream& fout, const FormatInfo& formatInfo) const
     fout.imbue(s_class_locale);
     if (formatInfo.first == BINARY)
         fout << "#vsgb";
+    else if (formatInfo.first == MAPPABLE_BINARY)
+        fout << "#vsgm";
     else
         fout << "#vsga";
 
@@ -104,7 +111,32 @@ vsg::ref_ptr<vsg::Object> VSG::read(const vsg::Path& filename, ref_ptr<const Opt
     if (!fin) return {};
 
     auto [type, version] = readHeader(fin);
-    if (type == BINARY)
+    if (type == MAPPABLE_BINARY)
+    {
+        // map the file so that the array data can be referenced in place rather than copied
+        auto mappedFile = MappedFile::create(filenameToUse);
+        if (mappedFile->valid())
+        {
+            fin.close();
+
+            mem_stream mapped_fin(mappedFile->data(), mappedFile->size());
+            readHeader(mapped_fin);
+
+            vsg::BinaryInput input(mapped_fin, _objectFactory, options);
+            input.filename = filenameToUse;
+            input.version = version;
+            input.alignedData = true;
+            input.mappedStorage = mappedFile;
+            return input.readObject("Root");
+        }
+
+        vsg::BinaryInput input(fin, _objectFactory, options);
+        input.filename = filenameToUse;
+        input.version = version;
+        input.alignedData = true;
+        return input.readObject("Root");
+    }
+    else if (type == BINARY)
     {
         vsg::BinaryInput input(fin, _objectFactory, options);
         input.filename = filenameToUse;
@@ -130,10 +162,11 @@ vsg::ref_ptr<vsg::Object> VSG::read(std::istream& fin, vsg::ref_ptr<const vsg::O
     if (options && !compatibleExtension(options, ".vsgb", ".vsgt")) return {};
 
     auto [type, version] = readHeader(fin);
-    if (type == BINARY)
+    if (type == BINARY || type == MAPPABLE_BINARY)
     {
         vsg::BinaryInput input(fin, _objectFactory, options);
         input.version = version;
+        input.alignedData = (type == MAPPABLE_BINARY);
         return input.readObject("Root");
     }
     else if (type == ASCII)
@@ -174,13 +207,22 @@ bool VSG::write(const vsg::Object* object, const vsg::Path& filename, ref_ptr<co
     auto ext = vsg::lowerCaseFileExtension(filename);
     if (ext == ".vsgb")
     {
+        bool mappable = false;
+        if (options) options->getValue("mappable", mappable);
+
         std::ofstream fout(filename, std::ios::out | std::ios::binary);
-        writeHeader(fout, FormatInfo{BINARY, version});
 
-        vsg::BinaryOutput output(fout, options);
+        // write through an async_ostream so that disk writes happen on a background thread while the next block is serialized
+        async_ostream async_out(fout);
+        writeHeader(async_out, FormatInfo{mappable ? MAPPABLE_BINARY : BINARY, version});
+
+        vsg::BinaryOutput output(async_out, options);
         output.version = version;
+        output.alignedData = mappable;
         output.writeObject("Root", object);
-        return true;
+
+        async_out.flush();
+        return static_cast<bool>(async_out);
     }
     else if (ext == ".vsga" || ext == ".vsgt")
     {
@@ -229,10 +271,16 @@ bool VSG::write(const vsg::Object* object, std::ostream& fout, ref_ptr<const Opt
     }
     else
     {
-        writeHeader(fout, FormatInfo(BINARY, version));
+        // aligning the array data requires the stream position
+        bool mappable = false;
+        if (options) options->getValue("mappable", mappable);
+        if (mappable && std::streamoff(fout.tellp()) < 0) mappable = false;
+
+        writeHeader(fout, FormatInfo(mappable ? MAPPABLE_BINARY : BINARY, version));
 
         vsg::BinaryOutput output(fout, options);
         output.version = version;
+        output.alignedData = mappable;
         output.writeObject("Root", object);
         return true;
     }
@@ -0,0 +1,151 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/async_stream.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace vsg;
+
+async_ostream::async_ostream(std::ostream& destination, size_t bufferSize) :
+    std::ostream(&_buffer),
+    _buffer(destination, bufferSize)
+{
+    rdbuf(&_buffer);
+}
+
+async_ostream::~async_ostream()
+{
+    _buffer.pubsync();
+}
+
+async_ostream::async_buffer::async_buffer(std::ostream& in_destination, size_t bufferSize) :
+    destination(in_destination)
+{
+    // positions are reported relative to the start of the destination stream when it supports tellp()
+    std::streamoff position = destination.tellp();
+    seekable = position >= 0;
+    if (seekable) submitted = static_cast<size_t>(position);
+
+    for (auto& buffer : buffers) buffer.resize(std::max(bufferSize, size_t(4096)));
+    setp(buffers[0].data(), buffers[0].data() + buffers[0].size());
+
+    thread = std::thread(&async_buffer::run, this);
+}
+
+async_ostream::async_buffer::~async_buffer()
+{
+    sync();
+    {
+        std::scoped_lock<std::mutex> lock(mutex);
+        active = false;
+    }
+    cv.notify_all();
+    thread.join();
+}
+
+void async_ostream::async_buffer::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        cv.wait(lock, [&]() { return pending > 0 || !active; });
+        if (pending == 0) break;
+
+        // write the other buffer with the mutex released so that the serializing thread can continue filling the current buffer
+        const char* data = buffers[1 - current].data();
+        size_t size = pending;
+        lock.unlock();
+        bool written = static_cast<bool>(destination.write(data, static_cast<std::streamsize>(size)));
+        lock.lock();
+
+        if (!written) failed = true;
+        pending = 0;
+        cv.notify_all();
+    }
+}
+
+void async_ostream::async_buffer::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return pending == 0; });
+}
+
+void async_ostream::async_buffer::submit()
+{
+    size_t size = static_cast<size_t>(pptr() - pbase());
+    if (size == 0) return;
+
+    // only two buffers so wait for the previous block to be written before handing over the next one
+    wait();
+
+    {
+        std::scoped_lock<std::mutex> lock(mutex);
+        pending = size;
+        submitted += size;
+        current = 1 - current;
+    }
+    cv.notify_all();
+
+    setp(buffers[current].data(), buffers[current].data() + buffers[current].size());
+}
+
+async_ostream::async_buffer::int_type async_ostream::async_buffer::overflow(int_type c)
+{
+    submit();
+    if (failed) return traits_type::eof();
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize async_ostream::async_buffer::xsputn(const char_type* s, std::streamsize n)
+{
+    std::streamsize remaining = n;
+    while (remaining > 0)
+    {
+        if (pptr() == epptr())
+        {
+            submit();
+            if (failed) return n - remaining;
+        }
+
+        auto count = std::min(remaining, static_cast<std::streamsize>(epptr() - pptr()));
+        std::memcpy(pptr(), s, static_cast<size_t>(count));
+        pbump(static_cast<int>(count));
+        s += count;
+        remaining -= count;
+    }
+    return n;
+}
+
+int async_ostream::async_buffer::sync()
+{
+    submit();
+    wait();
+
+    destination.flush();
+    return (failed || !destination) ? -1 : 0;
+}
+
+async_ostream::async_buffer::pos_type async_ostream::async_buffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    // only support querying the current position, as required by tellp()
+    if (!seekable || off != 0 || dir != std::ios_base::cur || (which & std::ios_base::out) == 0) return pos_type(off_type(-1));
+
+    return pos_type(off_type(submitted + static_cast<size_t>(pptr() - pbase())));
+}
@@ -0,0 +1,287 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+
+#include <vsg/io/compression.h>
+
+#include <cstring>
+
+using namespace vsg;
+
+namespace
+{
+    constexpr size_t minMatchLength = 4;
+    constexpr size_t maxMatchOffset = 65535;
+    constexpr uint32_t hashBits = 14;
+
+    inline uint32_t read32(const uint8_t* ptr)
+    {
+        uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline void writeLength(std::vector<uint8_t>& dest, size_t length)
+    {
+        while (length >= 255)
+        {
+            dest.push_back(255);
+            length -= 255;
+        }
+        dest.push_back(static_cast<uint8_t>(length));
+    }
+
+    inline bool readLength(const uint8_t*& ptr, const uint8_t* end, size_t& length)
+    {
+        uint8_t value = 0;
+        do
+        {
+            if (ptr >= end) return false;
+            value = *(ptr++);
+            length += value;
+        } while (value == 255);
+        return true;
+    }
+
+    /// emit a sequence of literals followed by a match, a matchLength of 0 marks the final sequence that only has literals
+    void writeSequence(std::vector<uint8_t>& dest, const uint8_t* literals, size_t numLiterals, size_t matchOffset, size_t matchLength)
+    {
+        size_t matchCode = (matchLength >= minMatchLength) ? (matchLength - minMatchLength) : 0;
+        uint8_t token = static_cast<uint8_t>(((numLiterals >= 15) ? 15 : numLiterals) << 4) | static_cast<uint8_t>((matchCode >= 15) ? 15 : matchCode);
+        dest.push_back(token);
+
+        if (numLiterals >= 15) writeLength(dest, numLiterals - 15);
+        dest.insert(dest.end(), literals, literals + numLiterals);
+
+        if (matchLength == 0) return;
+
+        dest.push_back(static_cast<uint8_t>(matchOffset & 0xff));
+        dest.push_back(static_cast<uint8_t>(matchOffset >> 8));
+        if (matchCode >= 15) writeLength(dest, matchCode - 15);
+    }
+
+    /// greedy LZ77 compression using a hash table of the most recent position of each 4 byte sequence
+    void lz_compress(const uint8_t* src, size_t size, std::vector<uint8_t>& dest)
+    {
+        std::vector<uint32_t> hashTable(size_t(1) << hashBits, 0);
+
+        size_t anchor = 0;
+        size_t position = 0;
+        size_t limit = (size > 8) ? (size - 8) : 0;
+        while (position < limit)
+        {
+            uint32_t sequence = read32(src + position);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - hashBits);
+            size_t candidate = hashTable[hash];
+            hashTable[hash] = static_cast<uint32_t>(position + 1);
+
+            if (candidate > 0 && (position - (candidate - 1)) <= maxMatchOffset && read32(src + candidate - 1) == sequence)
+            {
+                size_t match = candidate - 1;
+                size_t matchLength = minMatchLength;
+                while ((position + matchLength) < size && src[match + matchLength] == src[position + matchLength]) ++matchLength;
+
+                writeSequence(dest, src + anchor, position - anchor, position - match, matchLength);
+
+                position += matchLength;
+                anchor = position;
+            }
+            else
+            {
+                ++position;
+            }
+        }
+
+        writeSequence(dest, src + anchor, size - anchor, 0, 0);
+    }
+
+    bool lz_decompress(const uint8_t* src, size_t srcSize, uint8_t* dest, size_t destSize)
+    {
+        const uint8_t* ptr = src;
+        const uint8_t* end = src + srcSize;
+        uint8_t* out = dest;
+        uint8_t* out_end = dest + destSize;
+
+        while (ptr < end)
+        {
+            uint8_t token = *(ptr++);
+
+            size_t numLiterals = token >> 4;
+            if (numLiterals == 15 && !readLength(ptr, end, numLiterals)) return false;
+            if (numLiterals > static_cast<size_t>(end - ptr) || numLiterals > static_cast<size_t>(out_end - out)) return false;
+
+            std::memcpy(out, ptr, numLiterals);
+            ptr += numLiterals;
+            out += numLiterals;
+
+            // final sequence only has literals
+            if (ptr == end) break;
+
+            if ((end - ptr) < 2) return false;
+            size_t matchOffset = size_t(ptr[0]) | (size_t(ptr[1]) << 8);
+            ptr += 2;
+
+            size_t matchLength = token & 15;
+            if (matchLength == 15 && !readLength(ptr, end, matchLength)) return false;
+            matchLength += minMatchLength;
+
+            if (matchOffset == 0 || matchOffset > static_cast<size_t>(out - dest) || matchLength > static_cast<size_t>(out_end - out)) return false;
+
+            // matches may overlap the output being written, so copy byte by byte
+            const uint8_t* match = out - matchOffset;
+            for (size_t i = 0; i < matchLength; ++i) out[i] = match[i];
+            out += matchLength;
+        }
+
+        return out == out_end;
+    }
+
+    /// size of the components that make up a value, floats and 32bit integers are the most common components so prefer 4 bytes
+    inline size_t componentSize(size_t valueSize)
+    {
+        if ((valueSize % 4) == 0) return 4;
+        if ((valueSize % 2) == 0) return 2;
+        return 1;
+    }
+
+    /// transpose the bytes of each component so that each byte plane is stored contiguously, trailing bytes are copied unchanged
+    void shuffle(const uint8_t* src, uint8_t* dest, size_t size, size_t stride)
+    {
+        size_t count = size / stride;
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t b = 0; b < stride; ++b) dest[b * count + i] = src[i * stride + b];
+        }
+        std::memcpy(dest + count * stride, src + count * stride, size - count * stride);
+    }
+
+    void unshuffle(const uint8_t* src, uint8_t* dest, size_t size, size_t stride)
+    {
+        size_t count = size / stride;
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t b = 0; b < stride; ++b) dest[i * stride + b] = src[b * count + i];
+        }
+        std::memcpy(dest + count * stride, src + count * stride, size - count * stride);
+    }
+
+    template<typename T, typename S>
+    void deltaEncode(uint8_t* data, size_t count)
+    {
+        T previous = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            T value;
+            std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+            S delta = static_cast<S>(static_cast<T>(value - previous));
+            T zigzag = static_cast<T>((static_cast<T>(delta) << 1) ^ static_cast<T>(delta >> (sizeof(T) * 8 - 1)));
+            std::memcpy(data + i * sizeof(T), &zigzag, sizeof(T));
+            previous = value;
+        }
+    }
+
+    template<typename T>
+    void deltaDecode(uint8_t* data, size_t count)
+    {
+        T previous = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            T zigzag;
+            std::memcpy(&zigzag, data + i * sizeof(T), sizeof(T));
+            T delta = static_cast<T>((zigzag >> 1) ^ static_cast<T>(0 - (zigzag & 1)));
+            T value = static_cast<T>(previous + delta);
+            std::memcpy(data + i * sizeof(T), &value, sizeof(T));
+            previous = value;
+        }
+    }
+
+    void deltaEncode(uint8_t* data, size_t size, size_t stride)
+    {
+        if (stride == 4)
+            deltaEncode<uint32_t, int32_t>(data, size / 4);
+        else if (stride == 2)
+            deltaEncode<uint16_t, int16_t>(data, size / 2);
+        else
+            deltaEncode<uint8_t, int8_t>(data, size);
+    }
+
+    void deltaDecode(uint8_t* data, size_t size, size_t stride)
+    {
+        if (stride == 4)
+            deltaDecode<uint32_t>(data, size / 4);
+        else if (stride == 2)
+            deltaDecode<uint16_t>(data, size / 2);
+        else
+            deltaDecode<uint8_t>(data, size);
+    }
+} // namespace
+
+void vsg::compress(CompressionCodec codec, const uint8_t* src, size_t size, size_t valueSize, std::vector<uint8_t>& dest)
+{
+    if (size == 0) return;
+
+    size_t stride = componentSize(valueSize);
+    switch (codec)
+    {
+    case (COMPRESSION_LZ):
+        lz_compress(src, size, dest);
+        break;
+    case (COMPRESSION_SHUFFLE_LZ):
+    {
+        std::vector<uint8_t> shuffled(size);
+        shuffle(src, shuffled.data(), size, stride);
+        lz_compress(shuffled.data(), size, dest);
+        break;
+    }
+    case (COMPRESSION_DELTA_LZ):
+    {
+        std::vector<uint8_t> deltas(src, src + size);
+        deltaEncode(deltas.data(), size, stride);
+
+        std::vector<uint8_t> shuffled(size);
+        shuffle(deltas.data(), shuffled.data(), size, stride);
+        lz_compress(shuffled.data(), size, dest);
+        break;
+    }
+    default:
+        dest.insert(dest.end(), src, src + size);
+        break;
+    }
+}
+
+bool vsg::decompress(CompressionCodec codec, const uint8_t* src, size_t srcSize, uint8_t* dest, size_t destSize, size_t valueSize)
+{
+    if (destSize == 0) return srcSize == 0;
+
+    size_t stride = componentSize(valueSize);
+    switch (codec)
+    {
+    case (COMPRESSION_LZ):
+        return lz_decompress(src, srcSize, dest, destSize);
+    case (COMPRESSION_SHUFFLE_LZ):
+    case (COMPRESSION_DELTA_LZ):
+    {
+        std::vector<uint8_t> shuffled(destSize);
+        if (!lz_decompress(src, srcSize, shuffled.data(), destSize)) return false;
+
+        unshuffle(shuffled.data(), dest, destSize, stride);
+        if (codec == COMPRESSION_DELTA_LZ) deltaDecode(dest, destSize, stride);
+        return true;
+    }
+    case (COMPRESSION_NONE):
+        if (srcSize != destSize) return false;
+        std::memcpy(dest, src, destSize);
+        return true;
+    default:
+        return false;
+    }
+}
@@ -16,6 +16,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/spirv.h>
 #include <vsg/io/tile.h>
 #include <vsg/io/txt.h>
+#include <vsg/threading/ActivityStatus.h>
 #include <vsg/threading/OperationThreads.h>
 #include <vsg/utils/SharedObjects.h>
 
@@ -25,11 +26,19 @@ ref_ptr<Object> vsg::read(const Path& filename, ref_ptr<const Options> options)
 {
     CPU_INSTRUMENTATION_L1_NC(options ? options->instrumentation.get() : nullptr, "read", COLOR_READ);
 
+    auto cancelled = [&]() -> bool {
+        return options && options->activityStatus && options->activityStatus->cancel();
+    };
+
     auto read_file = [&]() -> ref_ptr<Object> {
+        if (cancelled()) return {};
+
         if (options && !options->readerWriters.empty())
         {
             for (auto& readerWriter : options->readerWriters)
             {
+                if (cancelled()) return {};
+
                 auto object = readerWriter->read(filename, options);
                 if (object) return object;
             }
@@ -18,6 +18,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/io/read.h>
 #include <vsg/io/tile.h>
+#include <vsg/maths/transform.h>
 #include <vsg/nodes/CullGroup.h>
 #include <vsg/nodes/MatrixTransform.h>
 #include <vsg/nodes/PagedLOD.h>
@@ -38,6 +39,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/utils/ComputeBounds.h>
 #include <vsg/vk/ResourceRequirements.h>
 
+#include <algorithm>
+
 using namespace vsg;
 
 tile::tile(ref_ptr<TileDatabaseSettings> in_settings, ref_ptr<const Options> in_options) :
@@ -126,7 +129,9 @@ vsg::ref_ptr<vsg::Object> tile::read(const vsg::Path& filename, vsg::ref_ptr<con
     auto tile_info = filename.substr(0, filename.length() - 5);
     if (tile_info == "root")
     {
-        return read_root(options);
+        auto object = read_root(options);
+        addElevationGrids(object);
+        return object;
     }
     else
     {
@@ -137,7 +142,24 @@ vsg::ref_ptr<vsg::Object> tile::read(const vsg::Path& filename, vsg::ref_ptr<con
 
         vsg::debug("read(", filename, ") -> tile_info = ", tile_info, ", x = ", x, ", y = ", y, ", z = ", lod, ", tile = ", this, ", settings =  ", settings);
 
-        return read_subtile(x, y, lod, options);
+        if (!_cache)
+        {
+            auto object = read_subtile(x, y, lod, options);
+            addElevationGrids(object);
+            return object;
+        }
+
+        auto key = vsg::make_string(x, "_", y, "_", lod, ".vsgb");
+        if (auto object = _cache->read(key, options))
+        {
+            addElevationGrids(object);
+            return object;
+        }
+
+        auto object = read_subtile(x, y, lod, options);
+        if (object && !object.cast<ReadError>()) _cache->write(key, object, options);
+        addElevationGrids(object);
+        return object;
     }
 }
 
@@ -157,8 +179,11 @@ vsg::ref_ptr<vsg::Object> tile::read_root(vsg::ref_ptr<const vsg::Options> optio
 
             if (imageTile)
             {
+                ref_ptr<ElevationGrid> elevationGrid;
+                if (settings->terrainLayer) elevationGrid = createElevationGrid(x, y, lod, vsg::read(getTilePath(settings->terrainLayer, x, y, lod), options));
+
                 auto tile_extents = computeTileExtents(x, y, lod);
-                auto tile_node = createTile(tile_extents, imageTile);
+                auto tile_node = createTile(tile_extents, imageTile, elevationGrid);
                 if (tile_node)
                 {
                     vsg::ComputeBounds computeBound;
@@ -172,6 +197,7 @@ vsg::ref_ptr<vsg::Object> tile::read_root(vsg::ref_ptr<const vsg::Options> optio
                     plod->children[1] = vsg::PagedLOD::Child{0.0, tile_node}; // visible always
                     plod->filename = vsg::make_string(x, " ", y, " 0.tile");
                     plod->options = Options::create_if(options, *options);
+                    if (elevationGrid) plod->setObject("ElevationGrid", elevationGrid);
 
                     group->addChild(plod);
                 }
@@ -218,7 +244,9 @@ vsg::ref_ptr<vsg::Object> tile::read_subtile(uint32_t x, uint32_t y, uint32_t lo
     };
 
     vsg::Paths tiles;
+    vsg::Paths terrainTiles;
     std::map<vsg::Path, TileID> pathToTileID;
+    std::map<vsg::Path, vsg::Path> pathToTerrainPath;
 
     uint32_t subtile_x = x * 2;
     uint32_t subtile_y = y * 2;
@@ -232,11 +260,21 @@ vsg::ref_ptr<vsg::Object> tile::read_subtile(uint32_t x, uint32_t y, uint32_t lo
             auto tilePath = getTilePath(settings->imageLayer, local_x, local_y, local_lod);
             tiles.push_back(tilePath);
             pathToTileID[tilePath] = TileID{local_x, local_y};
+
+            if (settings->terrainLayer)
+            {
+                auto terrainPath = getTilePath(settings->terrainLayer, local_x, local_y, local_lod);
+                terrainTiles.push_back(terrainPath);
+                pathToTerrainPath[tilePath] = terrainPath;
+            }
         }
     }
 
     auto pathObjects = vsg::read(tiles, options);
 
+    vsg::PathObjects terrainObjects;
+    if (!terrainTiles.empty()) terrainObjects = vsg::read(terrainTiles, options);
+
     if (pathObjects.size() == 4)
     {
         for (auto& [tilePath, object] : pathObjects)
@@ -245,8 +283,15 @@ vsg::ref_ptr<vsg::Object> tile::read_subtile(uint32_t x, uint32_t y, uint32_t lo
             if (imageTile)
             {
                 auto& tileID = pathToTileID[tilePath];
+
+                ref_ptr<ElevationGrid> elevationGrid;
+                if (auto terrain_itr = terrainObjects.find(pathToTerrainPath[tilePath]); terrain_itr != terrainObjects.end())
+                {
+                    elevationGrid = createElevationGrid(tileID.local_x, tileID.local_y, local_lod, terrain_itr->second);
+                }
+
                 auto tile_extents = computeTileExtents(tileID.local_x, tileID.local_y, local_lod);
-                auto tile_node = createTile(tile_extents, imageTile);
+                auto tile_node = createTile(tile_extents, imageTile, elevationGrid);
                 if (tile_node)
                 {
                     vsg::ComputeBounds computeBound;
@@ -265,6 +310,7 @@ vsg::ref_ptr<vsg::Object> tile::read_subtile(uint32_t x, uint32_t y, uint32_t lo
 
                         vsg::debug("plod->filename ", plod->filename);
 
+                        if (elevationGrid) plod->setObject("ElevationGrid", elevationGrid);
                         group->addChild(plod);
                     }
                     else
@@ -273,6 +319,7 @@ vsg::ref_ptr<vsg::Object> tile::read_subtile(uint32_t x, uint32_t y, uint32_t lo
                         cullGroup->bound = bound;
                         cullGroup->addChild(tile_node);
 
+                        if (elevationGrid) cullGroup->setObject("ElevationGrid", elevationGrid);
                         group->addChild(cullGroup);
                     }
                 }
@@ -324,6 +371,54 @@ void tile::init(vsg::ref_ptr<const vsg::Options> options)
 
     _graphicsPipelineConfig = GraphicsPipelineConfigurator::create(_shaderSet);
 
+    // set up the arrays that are shared by all the ECEF tiles
+    uint32_t numRows = _numRows;
+    uint32_t numCols = _numCols;
+    uint32_t numVertices = numRows * numCols;
+    uint32_t numTriangles = (numRows - 1) * (numCols - 1) * 2;
+
+    float sCoordScale = 1.0f / float(numCols - 1);
+    float tCoordScale = 1.0f / float(numRows - 1);
+    _bottomLeftTexCoords = vsg::vec2Array::create(numVertices);
+    _topLeftTexCoords = vsg::vec2Array::create(numVertices);
+    for (uint32_t r = 0; r < numRows; ++r)
+    {
+        for (uint32_t c = 0; c < numCols; ++c)
+        {
+            uint32_t vi = c + r * numCols;
+            _bottomLeftTexCoords->set(vi, vsg::vec2(float(c) * sCoordScale, float(r) * tCoordScale));
+            _topLeftTexCoords->set(vi, vsg::vec2(float(c) * sCoordScale, 1.0f - float(r) * tCoordScale));
+        }
+    }
+
+    _colors = vsg::vec4Value::create(vsg::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+
+    _indices = vsg::ushortArray::create(numTriangles * 3);
+    auto itr = _indices->begin();
+    for (uint32_t r = 0; r < numRows - 1; ++r)
+    {
+        for (uint32_t c = 0; c < numCols - 1; ++c)
+        {
+            uint32_t vi = c + r * numCols;
+            (*itr++) = static_cast<uint16_t>(vi);
+            (*itr++) = static_cast<uint16_t>(vi + 1);
+            (*itr++) = static_cast<uint16_t>(vi + numCols);
+            (*itr++) = static_cast<uint16_t>(vi + numCols);
+            (*itr++) = static_cast<uint16_t>(vi + 1);
+            (*itr++) = static_cast<uint16_t>(vi + numCols + 1);
+        }
+    }
+
+    if (settings->virtualTexture && (settings->cacheDirectory || settings->memoryCacheSize > 0))
+    {
+        // cached tiles would reference pages of the atlas that are no longer allocated to them
+        info("tile::init() tile caching disabled as TileDatabaseSettings::virtualTexture is assigned.");
+    }
+    else if (settings->cacheDirectory || settings->memoryCacheSize > 0)
+    {
+        _cache = TileCache::create(settings->cacheDirectory, settings->maxCacheSize, settings->maxCacheAge, settings->memoryCacheSize);
+    }
+
     if (options)
     {
         _graphicsPipelineConfig->assignInheritedState(options->inheritedState);
@@ -365,6 +460,15 @@ void tile::init(vsg::ref_ptr<const vsg::Options> options)
     }
 
     _graphicsPipelineConfig->init();
+
+    if (settings->virtualTexture && settings->virtualTexture->atlas && settings->imageLayer)
+    {
+        // all tiles that use the virtual texture share a single descriptor set that is bound at the root
+        auto atlas = vsg::DescriptorImage::create(settings->virtualTexture->atlas, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        vsg::Descriptors descriptors{atlas};
+        if (settings->ellipsoidModel) descriptors.push_back(_material);
+        _virtualTextureBindDescriptorSet = vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipelineConfig->layout, _materialSetIndex, descriptors);
+    }
 }
 
 vsg::ref_ptr<vsg::StateGroup> tile::createRoot() const
@@ -373,14 +477,43 @@ vsg::ref_ptr<vsg::StateGroup> tile::createRoot() const
 
     _graphicsPipelineConfig->copyTo(root, {});
 
+    if (_virtualTextureBindDescriptorSet) root->add(_virtualTextureBindDescriptorSet);
+
     return root;
 }
 
-vsg::ref_ptr<vsg::Node> tile::createTile(const vsg::dbox& tile_extents, vsg::ref_ptr<vsg::Data> sourceData) const
+vsg::ref_ptr<vsg::VirtualTexture::Page> tile::allocatePage(vsg::ref_ptr<vsg::Data> textureData) const
+{
+    if (!_virtualTextureBindDescriptorSet || !textureData) return {};
+
+    return settings->virtualTexture->allocate(textureData);
+}
+
+vsg::ref_ptr<vsg::ElevationGrid> tile::createElevationGrid(uint32_t x, uint32_t y, uint32_t level, vsg::ref_ptr<vsg::Object> elevationData) const
+{
+    auto heights = ElevationGrid::convert(elevationData.cast<Data>());
+    if (!heights) return {};
+
+    return ElevationGrid::create(x, y, level, computeTileExtents(x, y, level), heights);
+}
+
+void tile::addElevationGrids(vsg::ref_ptr<vsg::Object> object) const
+{
+    auto heightQuery = settings->getRefObject<TerrainHeightQuery>("TerrainHeightQuery");
+    auto group = object.cast<Group>();
+    if (!heightQuery || !group) return;
+
+    for (auto& child : group->children)
+    {
+        if (auto elevationGrid = child->getRefObject<ElevationGrid>("ElevationGrid")) heightQuery->add(elevationGrid);
+    }
+}
+
+vsg::ref_ptr<vsg::Node> tile::createTile(const vsg::dbox& tile_extents, vsg::ref_ptr<vsg::Data> sourceData, vsg::ref_ptr<vsg::ElevationGrid> elevationGrid) const
 {
     if (settings->ellipsoidModel)
     {
-        return createECEFTile(tile_extents, sourceData);
+        return createECEFTile(tile_extents, sourceData, elevationGrid);
     }
     else
     {
@@ -388,7 +521,7 @@ vsg::ref_ptr<vsg::Node> tile::createTile(const vsg::dbox& tile_extents, vsg::ref
     }
 }
 
-vsg::ref_ptr<vsg::Node> tile::createECEFTile(const vsg::dbox& tile_extents, vsg::ref_ptr<vsg::Data> textureData) const
+vsg::ref_ptr<vsg::Node> tile::createECEFTile(const vsg::dbox& tile_extents, vsg::ref_ptr<vsg::Data> textureData, vsg::ref_ptr<vsg::ElevationGrid> elevationGrid) const
 {
     vsg::dvec3 center = computeLatitudeLongitudeAltitude((tile_extents.min + tile_extents.max) * 0.5);
 
@@ -399,88 +532,100 @@ vsg::ref_ptr<vsg::Node> tile::createECEFTile(const vsg::dbox& tile_extents, vsg:
                             localToWorld(1, 0), localToWorld(1, 1), localToWorld(1, 2),
                             localToWorld(2, 0), localToWorld(2, 1), localToWorld(2, 2));
 
-    // create texture image, material and associated DescriptorSets and binding
-    auto texture = vsg::DescriptorImage::create(_sampler, textureData, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
-
-    auto bindDescriptorSet = vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipelineConfig->layout, _materialSetIndex, vsg::Descriptors{texture, _material});
-
-    // create StateGroup to bind any texture state
-    auto scenegraph = vsg::StateGroup::create();
-    scenegraph->add(bindDescriptorSet);
+    // use a page of the virtual texture when available, otherwise create the tile's own texture image, material and associated DescriptorSets and binding
+    auto page = allocatePage(textureData);
 
     // set up model transformation node
     auto transform = vsg::MatrixTransform::create(localToWorld); // VK_SHADER_STAGE_VERTEX_BIT
 
-    // add transform to root of the scene graph
-    scenegraph->addChild(transform);
+    ref_ptr<Node> scenegraph = transform;
+    if (page)
+    {
+        // the page is released for reuse when the tile is deleted
+        transform->setObject("VirtualTexturePage", page);
+    }
+    else
+    {
+        auto texture = vsg::DescriptorImage::create(_sampler, textureData, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+        auto bindDescriptorSet = vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipelineConfig->layout, _materialSetIndex, vsg::Descriptors{texture, _material});
+
+        // create StateGroup to bind any texture state, with the transform added to it as the root of the scene graph
+        auto stateGroup = vsg::StateGroup::create();
+        stateGroup->add(bindDescriptorSet);
+        stateGroup->addChild(transform);
+        scenegraph = stateGroup;
+    }
 
-    uint32_t numRows = 32;
-    uint32_t numCols = 32;
+    uint32_t numRows = _numRows;
+    uint32_t numCols = _numCols;
     uint32_t numVertices = numRows * numCols;
-    uint32_t numTriangles = (numRows - 1) * (numCols - 1) * 2;
 
     double longitudeOrigin = tile_extents.min.x;
     double longitudeScale = (tile_extents.max.x - tile_extents.min.x) / double(numCols - 1);
     double latitudeOrigin = tile_extents.min.y;
     double latitudeScale = (tile_extents.max.y - tile_extents.min.y) / double(numRows - 1);
 
-    float sCoordScale = 1.0f / float(numCols - 1);
-    float tCoordScale = 1.0f / float(numRows - 1);
-    float tCoordOrigin = 0.0;
-    if (textureData->properties.origin == vsg::TOP_LEFT)
+    // the projection maps rows to latitudes and columns to longitudes independently, so convert the grid's rows and columns rather than each vertex
+    std::vector<double> latitudes(numRows);
+    for (uint32_t r = 0; r < numRows; ++r)
     {
-        tCoordScale = -tCoordScale;
-        tCoordOrigin = 1.0f;
+        latitudes[r] = computeLatitudeLongitudeAltitude(vsg::dvec3(longitudeOrigin, latitudeOrigin + double(r) * latitudeScale, 0.0)).x;
     }
 
-    vsg::vec4 color(1.0f, 1.0f, 1.0f, 1.0f);
+    std::vector<double> longitudes(numCols);
+    for (uint32_t c = 0; c < numCols; ++c)
+    {
+        longitudes[c] = computeLatitudeLongitudeAltitude(vsg::dvec3(longitudeOrigin + double(c) * longitudeScale, latitudeOrigin, 0.0)).y;
+    }
 
-    // set up vertex coords
-    auto vertices = vsg::vec3Array::create(numVertices);
-    auto normals = vsg::vec3Array::create(numVertices);
-    auto texcoords = vsg::vec2Array::create(numVertices);
-    auto colors = vsg::vec4Value::create(color);
-    for (uint32_t r = 0; r < numRows; ++r)
+    std::vector<vsg::dvec3> ecefCoords(numVertices);
+    if (elevationGrid)
     {
-        for (uint32_t c = 0; c < numCols; ++c)
+        // displace the vertices by the heights sampled from the elevation grid
+        std::vector<vsg::dvec3> latLongAltitudes(numVertices);
+        for (uint32_t r = 0; r < numRows; ++r)
         {
-            vsg::dvec3 location(longitudeOrigin + double(c) * longitudeScale, latitudeOrigin + double(r) * latitudeScale, 0.0);
-            vsg::dvec3 latitudeLongitudeAltitude = computeLatitudeLongitudeAltitude(location);
+            for (uint32_t c = 0; c < numCols; ++c)
+            {
+                double height = elevationGrid->sample(longitudeOrigin + double(c) * longitudeScale, latitudeOrigin + double(r) * latitudeScale);
+                latLongAltitudes[c + r * numCols].set(latitudes[r], longitudes[c], height);
+            }
+        }
+        settings->ellipsoidModel->convertLatLongAltitudeToECEF(latLongAltitudes.data(), ecefCoords.data(), numVertices);
+    }
+    else
+    {
+        settings->ellipsoidModel->convertLatLongAltitudeGridToECEF(latitudes.data(), numRows, longitudes.data(), numCols, 0.0, ecefCoords.data());
+    }
 
-            auto ecef = settings->ellipsoidModel->convertLatLongAltitudeToECEF(latitudeLongitudeAltitude);
-            vsg::vec3 vertex(worldToLocal * ecef);
-            vsg::vec3 normal(normalize(ecef * normalMatrix));
-            vsg::vec2 texcoord(float(c) * sCoordScale, tCoordOrigin + float(r) * tCoordScale);
+    std::vector<vsg::dvec3> localCoords(numVertices);
+    vsg::transform(worldToLocal, ecefCoords.data(), localCoords.data(), numVertices);
 
-            uint32_t vi = c + r * numCols;
-            vertices->set(vi, vertex);
-            texcoords->set(vi, texcoord);
-            normals->set(vi, normal);
-        }
+    // set up vertex coords
+    auto vertices = vsg::vec3Array::create(numVertices);
+    auto normals = vsg::vec3Array::create(numVertices);
+    for (uint32_t i = 0; i < numVertices; ++i)
+    {
+        vertices->set(i, vsg::vec3(localCoords[i]));
+        normals->set(i, vsg::vec3(normalize(ecefCoords[i] * normalMatrix)));
     }
 
-    // set up indices
-    auto indices = vsg::ushortArray::create(numTriangles * 3);
-    auto itr = indices->begin();
-    for (uint32_t r = 0; r < numRows - 1; ++r)
+    // texcoords, colors and indices only depend upon the grid resolution so are shared by all tiles
+    ref_ptr<vec2Array> texcoords = (textureData->properties.origin == vsg::TOP_LEFT) ? _topLeftTexCoords : _bottomLeftTexCoords;
+    if (page)
     {
-        for (uint32_t c = 0; c < numCols - 1; ++c)
-        {
-            uint32_t vi = c + r * numCols;
-            (*itr++) = vi;
-            (*itr++) = vi + 1;
-            (*itr++) = vi + numCols;
-            (*itr++) = vi + numCols;
-            (*itr++) = vi + 1;
-            (*itr++) = vi + numCols + 1;
-        }
+        // map the texcoords into the tile's page of the atlas
+        auto pageTexCoords = vsg::vec2Array::create(texcoords->size());
+        std::transform(texcoords->begin(), texcoords->end(), pageTexCoords->begin(), [&page](const vsg::vec2& tc) { return page->transform(tc); });
+        texcoords = pageTexCoords;
     }
 
     // setup geometry
     auto vid = vsg::VertexIndexDraw::create();
-    vid->assignArrays(vsg::DataList{vertices, normals, texcoords, colors});
-    vid->assignIndices(indices);
-    vid->indexCount = static_cast<uint32_t>(indices->size());
+    vid->assignArrays(vsg::DataList{vertices, normals, texcoords, _colors});
+    vid->assignIndices(_indices);
+    vid->indexCount = static_cast<uint32_t>(_indices->size());
     vid->instanceCount = 1;
 
     transform->addChild(vid);
@@ -492,20 +637,30 @@ vsg::ref_ptr<vsg::Node> tile::createTextureQuad(const vsg::dbox& tile_extents, v
 {
     if (!textureData) return {};
 
-    // create texture image and associated DescriptorSets and binding
-    auto texture = vsg::DescriptorImage::create(_sampler, textureData, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
-
-    auto bindDescriptorSet = vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipelineConfig->layout, _materialSetIndex, vsg::Descriptors{texture});
-
-    // create StateGroup to bind any texture state
-    auto scenegraph = vsg::StateGroup::create();
-    scenegraph->add(bindDescriptorSet);
+    // use a page of the virtual texture when available, otherwise create the tile's own texture image and associated DescriptorSets and binding
+    auto page = allocatePage(textureData);
 
     // set up model transformation node
     auto transform = vsg::MatrixTransform::create();
 
-    // add transform to root of the scene graph
-    scenegraph->addChild(transform);
+    ref_ptr<Node> scenegraph = transform;
+    if (page)
+    {
+        // the page is released for reuse when the tile is deleted
+        transform->setObject("VirtualTexturePage", page);
+    }
+    else
+    {
+        auto texture = vsg::DescriptorImage::create(_sampler, textureData, 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+
+        auto bindDescriptorSet = vsg::BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipelineConfig->layout, _materialSetIndex, vsg::Descriptors{texture});
+
+        // create StateGroup to bind any texture state, with the transform added to it as the root of the scene graph
+        auto stateGroup = vsg::StateGroup::create();
+        stateGroup->add(bindDescriptorSet);
+        stateGroup->addChild(transform);
+        scenegraph = stateGroup;
+    }
 
     // set up vertex and index arrays
     float min_x = static_cast<float>(tile_extents.min.x);
@@ -536,6 +691,12 @@ vsg::ref_ptr<vsg::Node> tile::createTextureQuad(const vsg::dbox& tile_extents, v
          {right, top},
          {left, top}}); // VK_FORMAT_R32G32_SFLOAT, VK_VERTEX_INPUT_RATE_VERTEX, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE
 
+    if (page)
+    {
+        // map the texcoords into the tile's page of the atlas
+        for (auto& tc : *texcoords) tc = page->transform(tc);
+    }
+
     auto indices = vsg::ushortArray::create(
         {0, 1, 2,
          2, 3, 0}); // VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE
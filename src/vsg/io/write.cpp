@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/glsl.h>
 #include <vsg/io/spirv.h>
 #include <vsg/io/write.h>
+#include <vsg/threading/OperationThreads.h>
 #include <vsg/utils/SharedObjects.h>
 
 using namespace vsg;
@@ -66,3 +67,37 @@ bool vsg::write(ref_ptr<Object> object, const Path& filename, ref_ptr<const Opti
 
     return fileWritten;
 }
+
+bool vsg::write(const PathObjects& pathObjects, ref_ptr<const Options> options)
+{
+    CPU_INSTRUMENTATION_L1_NC(options ? options->instrumentation.get() : nullptr, "write", COLOR_WRITE);
+
+    ref_ptr<OperationThreads> operationThreads;
+    if (options) operationThreads = options->operationThreads;
+
+    if (operationThreads && pathObjects.size() > 1)
+    {
+        std::atomic_bool result{true};
+
+        std::vector<std::function<void()>> functions;
+        for (auto& [filename, object] : pathObjects)
+        {
+            functions.push_back([&result, &options, object = object, filename = filename]() {
+                if (!vsg::write(object, filename, options)) result = false;
+            });
+        }
+
+        // write the files on the operationThreads and this thread, waiting till all the writes have completed
+        runAndWait(*operationThreads, functions);
+
+        return result;
+    }
+
+    // run writes single threaded
+    bool result = true;
+    for (auto& [filename, object] : pathObjects)
+    {
+        if (!vsg::write(object, filename, options)) result = false;
+    }
+    return result;
+}
@@ -162,9 +162,90 @@ mat4 vsg::inverse_4x3(const mat4& m)
     return t_inverse_4x3(m);
 }
 
+#if defined(VSG_SIMD_SSE2)
+// block matrix inversion of a 4x4 float matrix using SSE, computing the 2x2 sub matrix adjugates and determinants 4 values at a time.
+// As inverse(transpose(m)) == transpose(inverse(m)) the method applies equally to the column major storage used by vsg::mat4.
+#    define VSG_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#    define VSG_SWIZZLE(a, x, y, z, w) _mm_shuffle_ps(a, a, _MM_SHUFFLE(w, z, y, x))
+
+// 2x2 matrix multiply A*B
+static inline __m128 mat2Mul(__m128 a, __m128 b)
+{
+    return _mm_add_ps(_mm_mul_ps(a, VSG_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(VSG_SWIZZLE(a, 1, 0, 3, 2), VSG_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// 2x2 matrix adjugate multiply adj(A)*B
+static inline __m128 mat2AdjMul(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(VSG_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(VSG_SWIZZLE(a, 1, 1, 2, 2), VSG_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// 2x2 matrix multiply adjugate A*adj(B)
+static inline __m128 mat2MulAdj(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(a, VSG_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(VSG_SWIZZLE(a, 1, 0, 3, 2), VSG_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+static mat4 simd_inverse_4x4(const mat4& m)
+{
+    const __m128 c0 = _mm_loadu_ps(m[0].data());
+    const __m128 c1 = _mm_loadu_ps(m[1].data());
+    const __m128 c2 = _mm_loadu_ps(m[2].data());
+    const __m128 c3 = _mm_loadu_ps(m[3].data());
+
+    // 2x2 sub matrices
+    __m128 A = _mm_movelh_ps(c0, c1);
+    __m128 B = _mm_movehl_ps(c1, c0);
+    __m128 C = _mm_movelh_ps(c2, c3);
+    __m128 D = _mm_movehl_ps(c3, c2);
+
+    // determinants of the sub matrices (|A| |B| |C| |D|)
+    __m128 detSub = _mm_sub_ps(_mm_mul_ps(VSG_SHUFFLE(c0, c2, 0, 2, 0, 2), VSG_SHUFFLE(c1, c3, 1, 3, 1, 3)),
+                               _mm_mul_ps(VSG_SHUFFLE(c0, c2, 1, 3, 1, 3), VSG_SHUFFLE(c1, c3, 0, 2, 0, 2)));
+    __m128 detA = VSG_SWIZZLE(detSub, 0, 0, 0, 0);
+    __m128 detB = VSG_SWIZZLE(detSub, 1, 1, 1, 1);
+    __m128 detC = VSG_SWIZZLE(detSub, 2, 2, 2, 2);
+    __m128 detD = VSG_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    __m128 D_C = mat2AdjMul(D, C);
+    __m128 A_B = mat2AdjMul(A, B);
+    __m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), mat2Mul(B, D_C));
+    __m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), mat2Mul(C, A_B));
+    __m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), mat2MulAdj(D, A_B));
+    __m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), mat2MulAdj(A, D_C));
+
+    // |M| = |A|*|D| + |B|*|C| - trace(adj(A)B * adj(D)C)
+    __m128 tr = _mm_mul_ps(A_B, VSG_SWIZZLE(D_C, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, VSG_SWIZZLE(tr, 2, 3, 0, 1));
+    tr = _mm_add_ps(tr, VSG_SWIZZLE(tr, 1, 0, 3, 2));
+    __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+    if (_mm_cvtss_f32(detM) == 0.0f) return mat4(std::numeric_limits<float>::quiet_NaN());
+
+    __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+    X_ = _mm_mul_ps(X_, rDetM);
+    Y_ = _mm_mul_ps(Y_, rDetM);
+    Z_ = _mm_mul_ps(Z_, rDetM);
+    W_ = _mm_mul_ps(W_, rDetM);
+
+    mat4 result;
+    _mm_storeu_ps(result[0].data(), VSG_SHUFFLE(X_, Y_, 3, 1, 3, 1));
+    _mm_storeu_ps(result[1].data(), VSG_SHUFFLE(X_, Y_, 2, 0, 2, 0));
+    _mm_storeu_ps(result[2].data(), VSG_SHUFFLE(Z_, W_, 3, 1, 3, 1));
+    _mm_storeu_ps(result[3].data(), VSG_SHUFFLE(Z_, W_, 2, 0, 2, 0));
+    return result;
+}
+#    undef VSG_SHUFFLE
+#    undef VSG_SWIZZLE
+#endif
+
 mat4 vsg::inverse_4x4(const mat4& m)
 {
+#if defined(VSG_SIMD_SSE2)
+    return simd_inverse_4x4(m);
+#else
     return t_inverse_4x4(m);
+#endif
 }
 
 mat4 vsg::inverse(const mat4& m)
@@ -175,7 +256,7 @@ mat4 vsg::inverse(const mat4& m)
     }
     else
     {
-        return t_inverse_4x4(m);
+        return inverse_4x4(m);
     }
 }
 
@@ -201,6 +282,139 @@ dmat4 vsg::inverse(const dmat4& m)
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// transform arrays of vec3
+//
+template<typename M, typename S, typename D>
+void t_transform(const M& matrix, const S* src, D* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = matrix * D(src[i]);
+    }
+}
+
+#if defined(VSG_SIMD_SSE2)
+static void sse_transform(const mat4& matrix, const vec3* src, vec3* dst, size_t count)
+{
+    const __m128 c0 = _mm_loadu_ps(matrix[0].data());
+    const __m128 c1 = _mm_loadu_ps(matrix[1].data());
+    const __m128 c2 = _mm_loadu_ps(matrix[2].data());
+    const __m128 c3 = _mm_loadu_ps(matrix[3].data());
+
+    alignas(16) float result[4];
+    for (size_t i = 0; i < count; ++i)
+    {
+        const vec3& s = src[i];
+        __m128 v = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(s.x)), c3);
+        v = _mm_add_ps(v, _mm_mul_ps(c1, _mm_set1_ps(s.y)));
+        v = _mm_add_ps(v, _mm_mul_ps(c2, _mm_set1_ps(s.z)));
+        v = _mm_div_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+        _mm_store_ps(result, v);
+        dst[i].set(result[0], result[1], result[2]);
+    }
+}
+
+template<typename S>
+static void sse_transform(const dmat4& matrix, const S* src, dvec3* dst, size_t count)
+{
+    const __m128d c0l = _mm_loadu_pd(matrix[0].data()), c0h = _mm_loadu_pd(matrix[0].data() + 2);
+    const __m128d c1l = _mm_loadu_pd(matrix[1].data()), c1h = _mm_loadu_pd(matrix[1].data() + 2);
+    const __m128d c2l = _mm_loadu_pd(matrix[2].data()), c2h = _mm_loadu_pd(matrix[2].data() + 2);
+    const __m128d c3l = _mm_loadu_pd(matrix[3].data()), c3h = _mm_loadu_pd(matrix[3].data() + 2);
+
+    alignas(16) double result[4];
+    for (size_t i = 0; i < count; ++i)
+    {
+        const __m128d x = _mm_set1_pd(src[i].x), y = _mm_set1_pd(src[i].y), z = _mm_set1_pd(src[i].z);
+        __m128d l = _mm_add_pd(_mm_add_pd(_mm_mul_pd(c0l, x), _mm_mul_pd(c1l, y)), _mm_add_pd(_mm_mul_pd(c2l, z), c3l));
+        __m128d h = _mm_add_pd(_mm_add_pd(_mm_mul_pd(c0h, x), _mm_mul_pd(c1h, y)), _mm_add_pd(_mm_mul_pd(c2h, z), c3h));
+        __m128d w = _mm_unpackhi_pd(h, h);
+        _mm_store_pd(result, _mm_div_pd(l, w));
+        _mm_store_sd(result + 2, _mm_div_sd(h, w));
+        dst[i].set(result[0], result[1], result[2]);
+    }
+}
+
+#    if !defined(VSG_SIMD_AVX2) && (defined(__GNUC__) || defined(__clang__))
+#        define VSG_SIMD_AVX2_DISPATCH 1
+#    endif
+
+#    if defined(VSG_SIMD_AVX2) || defined(VSG_SIMD_AVX2_DISPATCH)
+template<typename S>
+#        if defined(VSG_SIMD_AVX2_DISPATCH)
+__attribute__((target("avx2,fma")))
+#        endif
+static void avx2_transform(const dmat4& matrix, const S* src, dvec3* dst, size_t count)
+{
+    const __m256d c0 = _mm256_loadu_pd(matrix[0].data());
+    const __m256d c1 = _mm256_loadu_pd(matrix[1].data());
+    const __m256d c2 = _mm256_loadu_pd(matrix[2].data());
+    const __m256d c3 = _mm256_loadu_pd(matrix[3].data());
+
+    alignas(32) double result[4];
+    for (size_t i = 0; i < count; ++i)
+    {
+        __m256d v = _mm256_fmadd_pd(c0, _mm256_set1_pd(src[i].x), c3);
+        v = _mm256_fmadd_pd(c1, _mm256_set1_pd(src[i].y), v);
+        v = _mm256_fmadd_pd(c2, _mm256_set1_pd(src[i].z), v);
+        v = _mm256_div_pd(v, _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 3, 3, 3)));
+        _mm256_store_pd(result, v);
+        dst[i].set(result[0], result[1], result[2]);
+    }
+}
+#    endif
+
+static bool useAVX2()
+{
+#    if defined(VSG_SIMD_AVX2)
+    return true;
+#    elif defined(VSG_SIMD_AVX2_DISPATCH)
+    static const bool s_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return s_avx2;
+#    else
+    return false;
+#    endif
+}
+
+template<typename S>
+static void simd_transform(const dmat4& matrix, const S* src, dvec3* dst, size_t count)
+{
+#    if defined(VSG_SIMD_AVX2) || defined(VSG_SIMD_AVX2_DISPATCH)
+    if (useAVX2()) return avx2_transform(matrix, src, dst, count);
+#    endif
+    sse_transform(matrix, src, dst, count);
+}
+#endif
+
+void vsg::transform(const mat4& matrix, const vec3* src, vec3* dst, size_t count)
+{
+#if defined(VSG_SIMD_SSE2)
+    sse_transform(matrix, src, dst, count);
+#else
+    t_transform(matrix, src, dst, count);
+#endif
+}
+
+void vsg::transform(const dmat4& matrix, const vec3* src, dvec3* dst, size_t count)
+{
+#if defined(VSG_SIMD_SSE2)
+    simd_transform(matrix, src, dst, count);
+#else
+    t_transform(matrix, src, dst, count);
+#endif
+}
+
+void vsg::transform(const dmat4& matrix, const dvec3* src, dvec3* dst, size_t count)
+{
+#if defined(VSG_SIMD_SSE2)
+    simd_transform(matrix, src, dst, count);
+#else
+    t_transform(matrix, src, dst, count);
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // compute determinant of a matrix
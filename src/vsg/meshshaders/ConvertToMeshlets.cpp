@@ -0,0 +1,244 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/DrawIndexed.h>
+#include <vsg/io/Logger.h>
+#include <vsg/meshshaders/ConvertToMeshlets.h>
+#include <vsg/meshshaders/DrawMeshTasks.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DepthStencilState.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/MultisampleState.h>
+#include <vsg/state/RasterizationState.h>
+#include <vsg/state/VertexInputState.h>
+
+using namespace vsg;
+
+namespace
+{
+    bool readIndices(const Data* data, std::vector<uint32_t>& indices)
+    {
+        if (!data || !data->dataAvailable() || data->stride() != data->valueSize()) return false;
+
+        auto copy = [&](auto array) {
+            indices.assign(array->begin(), array->end());
+            return true;
+        };
+
+        if (auto us = data->cast<ushortArray>()) return copy(us);
+        if (auto ui = data->cast<uintArray>()) return copy(ui);
+        if (auto ub = data->cast<ubyteArray>()) return copy(ub);
+        return false;
+    }
+
+    /// return the per vertex vec3Array assigned to the attribute at location
+    ref_ptr<vec3Array> findArray(const VertexInputState& vertexInputState, uint32_t location, uint32_t firstBinding, const BufferInfoList& arrays)
+    {
+        for (auto& attribute : vertexInputState.vertexAttributeDescriptions)
+        {
+            if (attribute.location != location) continue;
+            if (attribute.format != VK_FORMAT_R32G32B32_SFLOAT || attribute.offset != 0 || attribute.binding < firstBinding) return {};
+
+            for (auto& binding : vertexInputState.vertexBindingDescriptions)
+            {
+                if (binding.binding == attribute.binding && binding.inputRate != VK_VERTEX_INPUT_RATE_VERTEX) return {};
+            }
+
+            size_t index = attribute.binding - firstBinding;
+            if (index >= arrays.size() || !arrays[index]) return {};
+
+            auto array = arrays[index]->data.cast<vec3Array>();
+            if (array && array->stride() == sizeof(vec3)) return array;
+            return {};
+        }
+        return {};
+    }
+} // namespace
+
+ConvertToMeshlets::ConvertToMeshlets(ref_ptr<const Options> in_options) :
+    options(in_options)
+{
+}
+
+void ConvertToMeshlets::apply(Node& node)
+{
+    node.traverse(*this);
+}
+
+void ConvertToMeshlets::apply(Group& group)
+{
+    _convertChildren(group);
+}
+
+void ConvertToMeshlets::apply(StateGroup& stateGroup)
+{
+    auto previousPipeline = _currentPipeline;
+
+    for (auto& stateCommand : stateGroup.stateCommands)
+    {
+        stateCommand->accept(*this);
+    }
+
+    _convertChildren(stateGroup);
+
+    _currentPipeline = previousPipeline;
+}
+
+void ConvertToMeshlets::apply(BindGraphicsPipeline& bindPipeline)
+{
+    _currentPipeline = bindPipeline.pipeline.get();
+}
+
+void ConvertToMeshlets::_convertChildren(Group& group)
+{
+    for (auto& child : group.children)
+    {
+        if (auto itr = _converted.find(child.get()); itr != _converted.end())
+        {
+            if (itr->second) child = itr->second;
+            continue;
+        }
+
+        if (auto converted = _convert(*child))
+        {
+            _converted[child.get()] = converted;
+            child = converted;
+            ++numConverted;
+        }
+        else
+        {
+            _converted[child.get()] = {};
+            child->accept(*this);
+        }
+    }
+}
+
+ref_ptr<Node> ConvertToMeshlets::_convert(Node& node)
+{
+    if (!_currentPipeline) return {};
+
+    uint32_t firstBinding = 0;
+    const BufferInfoList* arrays = nullptr;
+    ref_ptr<BufferInfo> indices;
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+
+    if (auto vid = node.cast<VertexIndexDraw>())
+    {
+        if (vid->instanceCount > 1 || vid->vertexOffset != 0) return {};
+
+        firstBinding = vid->firstBinding;
+        arrays = &vid->arrays;
+        indices = vid->indices;
+        ranges.emplace_back(vid->firstIndex, vid->indexCount);
+    }
+    else if (auto geometry = node.cast<Geometry>())
+    {
+        firstBinding = geometry->firstBinding;
+        arrays = &geometry->arrays;
+        indices = geometry->indices;
+        for (auto& command : geometry->commands)
+        {
+            auto drawIndexed = command.cast<DrawIndexed>();
+            if (!drawIndexed || drawIndexed->instanceCount > 1 || drawIndexed->vertexOffset != 0) return {};
+            ranges.emplace_back(drawIndexed->firstIndex, drawIndexed->indexCount);
+        }
+    }
+    else
+    {
+        return {};
+    }
+
+    if (!indices || ranges.empty()) return {};
+
+    const VertexInputState* vertexInputState = nullptr;
+    for (auto& state : _currentPipeline->pipelineStates)
+    {
+        if (auto vis = state.cast<VertexInputState>()) vertexInputState = vis;
+        if (auto ias = state.cast<InputAssemblyState>(); ias && ias->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST) return {};
+    }
+    if (!vertexInputState) return {};
+
+    auto vertices = findArray(*vertexInputState, vertexLocation, firstBinding, *arrays);
+    if (!vertices) return {};
+    auto normals = findArray(*vertexInputState, normalLocation, firstBinding, *arrays);
+
+    std::vector<uint32_t> allIndices;
+    if (!readIndices(indices->data, allIndices)) return {};
+
+    std::vector<uint32_t> triangles;
+    for (auto& [first, count] : ranges)
+    {
+        if (first + count > allIndices.size()) return {};
+        triangles.insert(triangles.end(), allIndices.begin() + first, allIndices.begin() + first + (count / 3) * 3);
+    }
+
+    for (auto index : triangles)
+    {
+        if (index >= vertices->size()) return {};
+    }
+
+    if (triangles.empty()) return {};
+
+    auto meshlets = Meshlets::create();
+    meshlets->build(*vertices, normals, triangles);
+
+    if (!_bindPipeline) _setUpPipeline();
+
+    Descriptors descriptors{
+        DescriptorBuffer::create(meshlets->meshlets, 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(meshlets->vertices, 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(meshlets->normals, 2, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(meshlets->meshletVertices, 3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(meshlets->meshletTriangles, 4, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        _material};
+    auto descriptorSet = DescriptorSet::create(_pipelineLayout->setLayouts[0], descriptors);
+
+    auto stateGroup = StateGroup::create();
+    stateGroup->add(_bindPipeline);
+    stateGroup->add(BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0, descriptorSet));
+
+    auto workgroups = meshlets->taskWorkgroupCount();
+    stateGroup->addChild(DrawMeshTasks::create(workgroups.x, workgroups.y, workgroups.z));
+
+    // DrawMeshTasks has no vertex arrays for ComputeBounds to use, so provide the bound via a CullNode
+    dvec3 minimum(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    dvec3 maximum(-minimum);
+    for (auto& v : *vertices)
+    {
+        minimum.set(std::min(minimum.x, double(v.x)), std::min(minimum.y, double(v.y)), std::min(minimum.z, double(v.z)));
+        maximum.set(std::max(maximum.x, double(v.x)), std::max(maximum.y, double(v.y)), std::max(maximum.z, double(v.z)));
+    }
+    dvec3 center = (minimum + maximum) * 0.5;
+
+    return CullNode::create(dsphere(center, length(maximum - center)), stateGroup);
+}
+
+void ConvertToMeshlets::_setUpPipeline()
+{
+    if (!shaderSet) shaderSet = createMeshletPhongShaderSet(options);
+    if (!material) material = PhongMaterialValue::create();
+
+    _pipelineLayout = shaderSet->createPipelineLayout({}, {0, 1});
+
+    GraphicsPipelineStates pipelineStates{
+        RasterizationState::create(),
+        MultisampleState::create(),
+        ColorBlendState::create(),
+        DepthStencilState::create()};
+
+    _bindPipeline = BindGraphicsPipeline::create(GraphicsPipeline::create(_pipelineLayout, shaderSet->stages, pipelineStates));
+    _material = DescriptorBuffer::create(material, 5, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+}
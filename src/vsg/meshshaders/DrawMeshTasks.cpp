@@ -47,4 +47,5 @@ void DrawMeshTasks::record(vsg::CommandBuffer& commandBuffer) const
     Device* device = commandBuffer.getDevice();
     auto extensions = device->getExtensions();
     extensions->vkCmdDrawMeshTasksEXT(commandBuffer, groupCountX, groupCountY, groupCountZ);
+    ++commandBuffer.recordStatistics.indirectDraws;
 }
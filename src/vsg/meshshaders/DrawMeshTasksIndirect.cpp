@@ -76,4 +76,5 @@ void DrawMeshTasksIndirect::record(vsg::CommandBuffer& commandBuffer) const
     Device* device = commandBuffer.getDevice();
     auto extensions = device->getExtensions();
     extensions->vkCmdDrawMeshTasksIndirectEXT(commandBuffer, drawParameters->buffer->vk(commandBuffer.deviceID), drawParameters->offset, drawCount, stride);
+    ++commandBuffer.recordStatistics.indirectDraws;
 }
@@ -0,0 +1,379 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Options.h>
+#include <vsg/maths/common.h>
+#include <vsg/meshshaders/Meshlets.h>
+#include <vsg/state/material.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+namespace
+{
+    const char* meshlet_glsl = R"(
+struct Meshlet
+{
+    vec4 sphere;
+    vec4 cone;
+    vec4 coneApex;
+    uint vertexOffset;
+    uint triangleOffset;
+    uint vertexCount;
+    uint triangleCount;
+};
+
+layout(push_constant) uniform PushConstants {
+    mat4 projection;
+    mat4 modelView;
+} pc;
+
+layout(std430, set = 0, binding = 0) readonly buffer Meshlets { Meshlet meshlets[]; };
+
+struct TaskPayload
+{
+    uint meshletIndices[32];
+};
+)";
+
+    const char* meshlet_task = R"(
+#version 460
+#extension GL_EXT_mesh_shader : require
+
+layout(local_size_x = 32) in;
+
+#include "meshlet.glsl"
+
+taskPayloadSharedEXT TaskPayload payload;
+
+shared uint numVisible;
+
+bool visible(Meshlet meshlet)
+{
+    // frustum test of bounding sphere against the side planes, extracted from the projection matrix so are in eye coordinates
+    vec3 center = (pc.modelView * vec4(meshlet.sphere.xyz, 1.0)).xyz;
+    float scale = max(max(length(pc.modelView[0].xyz), length(pc.modelView[1].xyz)), length(pc.modelView[2].xyz));
+    float radius = meshlet.sphere.w * scale;
+
+    mat4 p = transpose(pc.projection);
+    vec4 planes[4] = vec4[4](p[3] + p[0], p[3] - p[0], p[3] + p[1], p[3] - p[1]);
+    for (int i = 0; i < 4; ++i)
+    {
+        if (dot(planes[i].xyz, center) + planes[i].w < -radius * length(planes[i].xyz)) return false;
+    }
+
+    // back face test of normal cone, the eye is at the origin in eye coordinates
+    vec3 apex = (pc.modelView * vec4(meshlet.coneApex.xyz, 1.0)).xyz;
+    vec3 axis = normalize(mat3(pc.modelView) * meshlet.cone.xyz);
+    return dot(normalize(apex), axis) < meshlet.cone.w;
+}
+
+void main()
+{
+    if (gl_LocalInvocationIndex == 0) numVisible = 0;
+    barrier();
+
+    uint workgroupIndex = gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    uint meshletIndex = workgroupIndex * 32 + gl_LocalInvocationIndex;
+    if (meshletIndex < meshlets.length() && visible(meshlets[meshletIndex]))
+    {
+        payload.meshletIndices[atomicAdd(numVisible, 1)] = meshletIndex;
+    }
+    barrier();
+
+    EmitMeshTasksEXT(numVisible, 1, 1);
+}
+)";
+
+    const char* meshlet_mesh = R"(
+#version 460
+#extension GL_EXT_mesh_shader : require
+
+layout(local_size_x = 32) in;
+layout(triangles, max_vertices = 64, max_primitives = 124) out;
+
+#include "meshlet.glsl"
+
+layout(std430, set = 0, binding = 1) readonly buffer Vertices { vec4 vertices[]; };
+layout(std430, set = 0, binding = 2) readonly buffer Normals { vec4 normals[]; };
+layout(std430, set = 0, binding = 3) readonly buffer MeshletVertices { uint meshletVertices[]; };
+layout(std430, set = 0, binding = 4) readonly buffer MeshletTriangles { uint meshletTriangles[]; };
+
+taskPayloadSharedEXT TaskPayload payload;
+
+layout(location = 0) out vec3 eyePos[];
+layout(location = 1) out vec3 normalDir[];
+
+void main()
+{
+    Meshlet meshlet = meshlets[payload.meshletIndices[gl_WorkGroupID.x]];
+
+    SetMeshOutputsEXT(meshlet.vertexCount, meshlet.triangleCount);
+
+    for (uint i = gl_LocalInvocationIndex; i < meshlet.vertexCount; i += 32)
+    {
+        uint v = meshletVertices[meshlet.vertexOffset + i];
+        vec4 eye = pc.modelView * vec4(vertices[v].xyz, 1.0);
+        gl_MeshVerticesEXT[i].gl_Position = pc.projection * eye;
+        eyePos[i] = eye.xyz;
+        normalDir[i] = (pc.modelView * vec4(normals[v].xyz, 0.0)).xyz;
+    }
+
+    for (uint i = gl_LocalInvocationIndex; i < meshlet.triangleCount; i += 32)
+    {
+        uint packed = meshletTriangles[meshlet.triangleOffset + i];
+        gl_PrimitiveTriangleIndicesEXT[i] = uivec3(packed & 0xff, (packed >> 8) & 0xff, (packed >> 16) & 0xff);
+    }
+}
+)";
+
+    const char* meshlet_frag = R"(
+#version 450
+
+layout(set = 0, binding = 5) uniform MaterialData
+{
+    vec4 ambientColor;
+    vec4 diffuseColor;
+    vec4 specularColor;
+    vec4 emissiveColor;
+    float shininess;
+    float alphaMask;
+    float alphaMaskCutoff;
+} material;
+
+layout(location = 0) in vec3 eyePos;
+layout(location = 1) in vec3 normalDir;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    vec3 nd = normalize(normalDir);
+    if (!gl_FrontFacing) nd = -nd;
+
+    // head light at the eye
+    vec3 vd = normalize(-eyePos);
+    float diff = max(dot(nd, vd), 0.0);
+    float spec = diff > 0.0 ? pow(max(dot(reflect(-vd, nd), vd), 0.0), material.shininess) : 0.0;
+
+    vec3 color = material.ambientColor.rgb * 0.1 + material.diffuseColor.rgb * diff + material.specularColor.rgb * spec + material.emissiveColor.rgb;
+    outColor = vec4(color, material.diffuseColor.a);
+}
+)";
+
+    std::string expandInclude(const char* source)
+    {
+        std::string str(source);
+        const std::string include("#include \"meshlet.glsl\"");
+        if (auto pos = str.find(include); pos != std::string::npos) str.replace(pos, include.size(), meshlet_glsl);
+        return str;
+    }
+} // namespace
+
+Meshlets::Meshlets()
+{
+}
+
+Meshlets::~Meshlets()
+{
+}
+
+void Meshlets::build(const vec3Array& in_vertices, const vec3Array* in_normals, const std::vector<uint32_t>& indices)
+{
+    uint32_t numVertices = static_cast<uint32_t>(in_vertices.size());
+    size_t numTriangles = indices.size() / 3;
+
+    vertices = vec4Array::create(numVertices);
+    for (uint32_t v = 0; v < numVertices; ++v) vertices->at(v) = vec4(in_vertices[v], 1.0f);
+
+    std::vector<vec3> faceNormals(numTriangles);
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        auto& v0 = in_vertices[indices[t * 3]];
+        auto& v1 = in_vertices[indices[t * 3 + 1]];
+        auto& v2 = in_vertices[indices[t * 3 + 2]];
+        auto n = cross(v1 - v0, v2 - v0);
+        if (float len = length(n); len > 0.0f) faceNormals[t] = n / len;
+    }
+
+    normals = vec4Array::create(numVertices);
+    if (in_normals && in_normals->size() == numVertices)
+    {
+        for (uint32_t v = 0; v < numVertices; ++v) normals->at(v) = vec4(in_normals->at(v), 0.0f);
+    }
+    else
+    {
+        for (auto& n : *normals) n.set(0.0f, 0.0f, 0.0f, 0.0f);
+        for (size_t t = 0; t < numTriangles; ++t)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                auto& n = normals->at(indices[t * 3 + k]);
+                n = n + vec4(faceNormals[t], 0.0f);
+            }
+        }
+        for (auto& n : *normals)
+        {
+            if (float len = length(n); len > 0.0f) n /= len;
+        }
+    }
+
+    std::vector<Meshlet> meshletList;
+    std::vector<uint32_t> vertexList;
+    std::vector<uint32_t> triangleList;
+    vertexList.reserve(numVertices);
+    triangleList.reserve(numTriangles);
+
+    std::vector<uint32_t> localIndices(numVertices, std::numeric_limits<uint32_t>::max());
+    Meshlet meshlet{};
+    size_t firstTriangle = 0;
+
+    auto finish = [&](size_t endTriangle) {
+        if (meshlet.triangleCount == 0) return;
+
+        // bounding sphere centered on the bounding box of the meshlet's vertices
+        vec3 minimum(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+        vec3 maximum(-minimum);
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+        {
+            auto& v = in_vertices[vertexList[meshlet.vertexOffset + i]];
+            minimum.set(std::min(minimum.x, v.x), std::min(minimum.y, v.y), std::min(minimum.z, v.z));
+            maximum.set(std::max(maximum.x, v.x), std::max(maximum.y, v.y), std::max(maximum.z, v.z));
+        }
+        vec3 center = (minimum + maximum) * 0.5f;
+        float radius = 0.0f;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+        {
+            radius = std::max(radius, length(in_vertices[vertexList[meshlet.vertexOffset + i]] - center));
+        }
+        meshlet.sphere = vec4(center, radius);
+
+        // normal cone, following the approach used by meshoptimizer, a cutoff above 1 disables cone culling
+        vec3 axis;
+        for (size_t t = firstTriangle; t < endTriangle; ++t) axis += faceNormals[t];
+
+        meshlet.cone = vec4(0.0f, 0.0f, 1.0f, 2.0f);
+        meshlet.coneApex = vec4(center, 0.0f);
+        if (float len = length(axis); len > 0.0f)
+        {
+            axis /= len;
+
+            float minimumDot = 1.0f;
+            for (size_t t = firstTriangle; t < endTriangle; ++t) minimumDot = std::min(minimumDot, dot(faceNormals[t], axis));
+
+            if (minimumDot > 0.1f)
+            {
+                // move the apex back along the axis so that the cone contains all the triangles' planes
+                float maximumT = 0.0f;
+                for (size_t t = firstTriangle; t < endTriangle; ++t)
+                {
+                    auto& v0 = in_vertices[indices[t * 3]];
+                    float dn = dot(faceNormals[t], axis);
+                    if (dn > 0.0f) maximumT = std::max(maximumT, dot(center - v0, faceNormals[t]) / dn);
+                }
+
+                meshlet.cone = vec4(axis, std::sqrt(1.0f - minimumDot * minimumDot));
+                meshlet.coneApex = vec4(center - axis * maximumT, 0.0f);
+            }
+        }
+
+        meshletList.push_back(meshlet);
+
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) localIndices[vertexList[meshlet.vertexOffset + i]] = std::numeric_limits<uint32_t>::max();
+
+        meshlet = Meshlet{};
+        meshlet.vertexOffset = static_cast<uint32_t>(vertexList.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(triangleList.size());
+        firstTriangle = endTriangle;
+    };
+
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        const uint32_t* tri = &indices[t * 3];
+
+        uint32_t numNew = 0;
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            bool duplicate = (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+            if (localIndices[tri[k]] == std::numeric_limits<uint32_t>::max() && !duplicate) ++numNew;
+        }
+
+        if (meshlet.vertexCount + numNew > maxVertices || meshlet.triangleCount + 1 > maxTriangles) finish(t);
+
+        uint32_t packed = 0;
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            auto& local = localIndices[tri[k]];
+            if (local == std::numeric_limits<uint32_t>::max())
+            {
+                local = meshlet.vertexCount++;
+                vertexList.push_back(tri[k]);
+            }
+            packed |= local << (k * 8);
+        }
+        triangleList.push_back(packed);
+        ++meshlet.triangleCount;
+    }
+    finish(numTriangles);
+
+    meshlets = MeshletArray::create(static_cast<uint32_t>(meshletList.size()));
+    std::copy(meshletList.begin(), meshletList.end(), meshlets->begin());
+
+    meshletVertices = uintArray::create(static_cast<uint32_t>(vertexList.size()));
+    std::copy(vertexList.begin(), vertexList.end(), meshletVertices->begin());
+
+    meshletTriangles = uintArray::create(static_cast<uint32_t>(triangleList.size()));
+    std::copy(triangleList.begin(), triangleList.end(), meshletTriangles->begin());
+}
+
+uivec3 Meshlets::taskWorkgroupCount() const
+{
+    // keep within the minimum supported maxTaskWorkGroupCount of 65535 per dimension, the task shader culls out of range meshlets
+    uint32_t numWorkgroups = meshlets ? static_cast<uint32_t>((meshlets->size() + taskWorkgroupSize - 1) / taskWorkgroupSize) : 0;
+    uint32_t x = std::min(numWorkgroups, 65535u);
+    uint32_t y = x > 0 ? (numWorkgroups + x - 1) / x : 0;
+    return uivec3(x, y, 1);
+}
+
+ref_ptr<ShaderSet> vsg::createMeshletPhongShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("meshlet_phong"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    // GL_EXT_mesh_shader requires SPIR-V 1.4
+    auto hints = ShaderCompileSettings::create();
+    hints->vulkanVersion = VK_API_VERSION_1_2;
+    hints->target = ShaderCompileSettings::SPIRV_1_4;
+
+    ShaderStages stages{
+        ShaderStage::create(VK_SHADER_STAGE_TASK_BIT_EXT, "main", expandInclude(meshlet_task), hints),
+        ShaderStage::create(VK_SHADER_STAGE_MESH_BIT_EXT, "main", expandInclude(meshlet_mesh), hints),
+        ShaderStage::create(VK_SHADER_STAGE_FRAGMENT_BIT, "main", std::string(meshlet_frag), hints)};
+
+    auto shaderSet = ShaderSet::create(stages, hints);
+
+    VkShaderStageFlags meshStages = VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+    shaderSet->addDescriptorBinding("vsg_Meshlets", "", 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, meshStages, MeshletArray::create(1));
+    shaderSet->addDescriptorBinding("vsg_MeshletPositions", "", 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_MESH_BIT_EXT, vec4Array::create(1));
+    shaderSet->addDescriptorBinding("vsg_MeshletNormals", "", 0, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_MESH_BIT_EXT, vec4Array::create(1));
+    shaderSet->addDescriptorBinding("vsg_MeshletVertices", "", 0, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_MESH_BIT_EXT, uintArray::create(1));
+    shaderSet->addDescriptorBinding("vsg_MeshletTriangles", "", 0, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_MESH_BIT_EXT, uintArray::create(1));
+    shaderSet->addDescriptorBinding("material", "", 0, 5, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, PhongMaterialValue::create());
+
+    shaderSet->addPushConstantRange("pc", "", meshStages, 0, 128);
+
+    return shaderSet;
+}
@@ -16,6 +16,9 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/vk/State.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
 
 using namespace vsg;
 
@@ -39,6 +42,17 @@ void Bin::clear()
     _stateCommands.clear();
     _elements.clear();
     _binElements.clear();
+    _sorted = false;
+}
+
+size_t Bin::reservedSize() const
+{
+    return _matrices.capacity() * sizeof(dmat4) +
+           _stateCommands.capacity() * sizeof(const StateCommand*) +
+           _elements.capacity() * sizeof(Element) +
+           _binElements.capacity() * sizeof(KeyIndex) +
+           _sortBuffer.capacity() * sizeof(KeyIndex) +
+           _stateKeyElements.capacity() * sizeof(StateKeyIndex);
 }
 
 void Bin::add(State* state, double value, const Node* node)
@@ -86,30 +100,201 @@ void Bin::add(State* state, double value, const Node* node)
     element.child = node;
 
     _binElements.emplace_back(static_cast<float>(value), static_cast<uint32_t>(_elements.size()));
+    _sorted = false;
 
     _elements.push_back(element);
 }
 
+void Bin::_sort() const
+{
+    switch (sortAlgorithm)
+    {
+    case (RADIX_SORT):
+        _radixSort();
+        return;
+    case (INCREMENTAL_SORT):
+        if (!_incrementalSort())
+        {
+            if (sortOrder == ASCENDING)
+                std::sort(_binElements.begin(), _binElements.end(), [](const KeyIndex& lhs, const KeyIndex& rhs) { return lhs.first < rhs.first; });
+            else
+                std::sort(_binElements.begin(), _binElements.end(), [](const KeyIndex& lhs, const KeyIndex& rhs) { return rhs.first < lhs.first; });
+        }
+
+        // retain the order for use in the next frame
+        _previousOrder.resize(_binElements.size());
+        _previousChildren.resize(_elements.size());
+        for (size_t i = 0; i < _binElements.size(); ++i) _previousOrder[i] = _binElements[i].second;
+        for (size_t i = 0; i < _elements.size(); ++i) _previousChildren[i] = _elements[i].child;
+        return;
+    case (STD_SORT):
+        break;
+    }
+
+    if (sortOrder == ASCENDING)
+        std::sort(_binElements.begin(), _binElements.end(), [](const KeyIndex& lhs, const KeyIndex& rhs) { return lhs.first < rhs.first; });
+    else
+        std::sort(_binElements.begin(), _binElements.end(), [](const KeyIndex& lhs, const KeyIndex& rhs) { return rhs.first < lhs.first; });
+}
+
+void Bin::_radixSort() const
+{
+    size_t size = _binElements.size();
+    if (size < 2) return;
+
+    // map the float to an unsigned int that sorts in the same order, flipping all the bits for DESCENDING
+    const uint32_t invert = (sortOrder == DESCENDING) ? 0xffffffff : 0x0;
+    auto key = [invert](float value) -> uint32_t {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits = (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+        return bits ^ invert;
+    };
+
+    _sortBuffer.resize(size);
+    auto* src = &_binElements;
+    auto* dest = &_sortBuffer;
+
+    std::array<uint32_t, 256> offsets;
+    for (uint32_t shift = 0; shift < 32; shift += 8)
+    {
+        offsets.fill(0);
+        for (auto& keyIndex : *src) ++offsets[(key(keyIndex.first) >> shift) & 0xff];
+
+        // skip passes where all the elements have the same digit
+        if (offsets[(key(src->front().first) >> shift) & 0xff] == size) continue;
+
+        uint32_t total = 0;
+        for (auto& offset : offsets)
+        {
+            uint32_t count = offset;
+            offset = total;
+            total += count;
+        }
+
+        for (auto& keyIndex : *src) (*dest)[offsets[(key(keyIndex.first) >> shift) & 0xff]++] = keyIndex;
+
+        std::swap(src, dest);
+    }
+
+    if (src != &_binElements) _binElements.swap(_sortBuffer);
+}
+
+bool Bin::_incrementalSort() const
+{
+    size_t size = _binElements.size();
+    if (_previousOrder.size() != size || _previousChildren.size() != _elements.size()) return false;
+
+    for (size_t i = 0; i < _elements.size(); ++i)
+    {
+        if (_elements[i].child != _previousChildren[i]) return false;
+    }
+
+    // reorder into the previous frame's order, _binElements are still in the order they were added so can be indexed by element index
+    _sortBuffer.resize(size);
+    for (size_t i = 0; i < size; ++i) _sortBuffer[i] = _binElements[_previousOrder[i]];
+    _binElements.swap(_sortBuffer);
+
+    auto less = [this](const KeyIndex& lhs, const KeyIndex& rhs) { return (sortOrder == ASCENDING) ? (lhs.first < rhs.first) : (rhs.first < lhs.first); };
+
+    // insertion sort is efficient on nearly sorted data, but give up if the elements have moved too far
+    size_t maxNumMoves = size * 8;
+    size_t numMoves = 0;
+    for (size_t i = 1; i < size; ++i)
+    {
+        auto keyIndex = _binElements[i];
+        size_t j = i;
+        for (; j > 0 && less(keyIndex, _binElements[j - 1]); --j)
+        {
+            _binElements[j] = _binElements[j - 1];
+            if (++numMoves > maxNumMoves)
+            {
+                _binElements[j - 1] = keyIndex;
+                return false;
+            }
+        }
+        _binElements[j] = keyIndex;
+    }
+
+    return true;
+}
+
+void Bin::_stateSort() const
+{
+    // assign each StateCommand an id in order of first appearance so that elements sharing state commands end up with matching keys
+    // discard entries for state commands no longer in use once they outnumber those in use
+    if (_stateCommandIDs.size() > 2 * _stateCommands.size() + 64 || _stateCommandGeneration == std::numeric_limits<uint32_t>::max())
+    {
+        _stateCommandIDs.clear();
+        _stateCommandGeneration = 0;
+    }
+
+    uint32_t generation = ++_stateCommandGeneration;
+    uint32_t numIDs = 0;
+    for (auto command : _stateCommands)
+    {
+        auto& commandID = _stateCommandIDs[command];
+        if (commandID.generation != generation) commandID = StateCommandID{generation, numIDs++};
+    }
+
+    // pack the ids of the first four state commands, lowest slot (normally the pipeline) first, into the key
+    _stateKeyElements.resize(_binElements.size());
+    for (size_t i = 0; i < _binElements.size(); ++i)
+    {
+        auto& keyIndex = _binElements[i];
+        auto& element = _elements[keyIndex.second];
+
+        uint64_t key = 0;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            uint64_t id = (c < element.stateCommandCount) ? std::min(uint64_t(_stateCommandIDs[_stateCommands[element.stateCommandIndex + c]].id) + 1, uint64_t(0xffff)) : 0;
+            key = (key << 16) | id;
+        }
+
+        _stateKeyElements[i] = StateKeyIndex{key, keyIndex.first, keyIndex.second};
+    }
+
+    // sort by state, using front to back depth as the tie breaker to make the most of early depth tests
+    std::sort(_stateKeyElements.begin(), _stateKeyElements.end(), [](const StateKeyIndex& lhs, const StateKeyIndex& rhs) {
+        if (lhs.stateKey != rhs.stateKey) return lhs.stateKey < rhs.stateKey;
+        return lhs.depth < rhs.depth;
+    });
+
+    for (size_t i = 0; i < _stateKeyElements.size(); ++i)
+    {
+        _binElements[i].first = _stateKeyElements[i].depth;
+        _binElements[i].second = _stateKeyElements[i].index;
+    }
+}
+
 void Bin::traverse(RecordTraversal& rt) const
 {
     //debug("Bin::traverse(RecordTraversal& visitor) ", sortOrder, " ", _binElements.size());
 
     auto state = rt.getState();
 
-    switch (sortOrder)
+    // bins recorded by a depth pre-pass are traversed twice, so only sort on the first traversal
+    if (!_sorted)
     {
-    case (ASCENDING):
-        std::sort(_binElements.begin(), _binElements.end(), [](const KeyIndex& lhs, const KeyIndex& rhs) { return lhs.first < rhs.first; });
-        break;
-    case (DESCENDING):
-        std::sort(_binElements.begin(), _binElements.end(), [](const KeyIndex& lhs, const KeyIndex& rhs) { return rhs.first < lhs.first; });
-        break;
-    case (NO_SORT):
-        break;
+        if (sortOrder == STATE_SORTED)
+            _stateSort();
+        else if (sortOrder != NO_SORT)
+            _sort();
+        _sorted = true;
+    }
+
+    if (sortOrder == STATE_SORTED)
+    {
+        _numStateCommands = static_cast<uint32_t>(_stateCommands.size());
+        _numStateCommandsRecorded = 0;
     }
 
+    // while recording a depth pre-pass pipelines are substituted, and elements without a substitute are skipped
+    const bool substitute = rt.substitutingStateCommands();
+
     uint32_t previousMatrixIndex = static_cast<uint32_t>(_matrices.size());
     //uint32_t previousStateCommandIndex = _stateCommands.size();
+    bool matrixPushed = false;
 
     state->pushFrustum();
     state->dirty = true;
@@ -120,7 +305,10 @@ void Bin::traverse(RecordTraversal& rt) const
 
         if (element.matrixIndex != previousMatrixIndex)
         {
+            // replace rather than accumulate matrices so the modelview stack is left as it was found
+            if (matrixPushed) state->modelviewMatrixStack.pop();
             state->modelviewMatrixStack.push(_matrices[element.matrixIndex]);
+            matrixPushed = true;
             state->applyFrustum();
             state->dirty = true;
             previousMatrixIndex = element.matrixIndex;
@@ -131,14 +319,58 @@ void Bin::traverse(RecordTraversal& rt) const
             //debug("    No need to update");
         }
 
-        if (element.stateCommandCount > 0)
+        if (substitute)
+        {
+            bool recordable = true;
+            for (uint32_t i = element.stateCommandIndex; recordable && i < element.stateCommandIndex + element.stateCommandCount; ++i)
+            {
+                auto variant = rt.substituteStateCommand(_stateCommands[i]);
+                recordable = variant && !variant->pending();
+            }
+            if (!recordable) continue;
+        }
+
+        if (sortOrder == STATE_SORTED)
+        {
+            // keep the state commands shared with the previous element pushed so they aren't recorded again,
+            // once a slot differs all the following slots are recorded again as a new pipeline may disturb them.
+            uint32_t commonCount = 0;
+            while (commonCount < _pushedStateCommands.size() && commonCount < element.stateCommandCount &&
+                   _pushedStateCommands[commonCount] == _stateCommands[element.stateCommandIndex + commonCount])
+            {
+                ++commonCount;
+            }
+
+            if (commonCount < _pushedStateCommands.size() || commonCount < element.stateCommandCount)
+            {
+                for (size_t i = _pushedStateCommands.size(); i > commonCount; --i)
+                {
+                    state->stateStacks[_pushedStateCommands[i - 1]->slot].pop();
+                }
+                _pushedStateCommands.resize(commonCount);
+
+                for (uint32_t i = element.stateCommandIndex + commonCount; i < element.stateCommandIndex + element.stateCommandCount; ++i)
+                {
+                    auto command = _stateCommands[i];
+                    state->stateStacks[command->slot].push(substitute ? rt.substituteStateCommand(command) : command);
+                    _pushedStateCommands.push_back(command);
+                }
+                state->dirty = true;
+            }
+
+            _numStateCommandsRecorded += element.stateCommandCount - commonCount;
+
+            element.child->accept(rt);
+        }
+        else if (element.stateCommandCount > 0)
         {
             uint32_t endIndex = element.stateCommandIndex + element.stateCommandCount;
             for (uint32_t i = element.stateCommandIndex; i < endIndex; ++i)
             {
                 auto command = _stateCommands[i];
-                state->stateStacks[command->slot].push(command);
+                state->stateStacks[command->slot].push(substitute ? rt.substituteStateCommand(command) : command);
             }
+            state->dirty = true;
 
             element.child->accept(rt);
 
@@ -147,6 +379,7 @@ void Bin::traverse(RecordTraversal& rt) const
                 auto command = _stateCommands[i];
                 state->stateStacks[command->slot].pop();
             }
+            state->dirty = true;
         }
         else
         {
@@ -154,6 +387,14 @@ void Bin::traverse(RecordTraversal& rt) const
         }
     }
 
+    for (size_t i = _pushedStateCommands.size(); i > 0; --i)
+    {
+        state->stateStacks[_pushedStateCommands[i - 1]->slot].pop();
+    }
+    _pushedStateCommands.clear();
+
+    if (matrixPushed) state->modelviewMatrixStack.pop();
+
     state->popFrustum();
     state->dirty = true;
 }
@@ -0,0 +1,167 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/Commands.h>
+#include <vsg/io/Options.h>
+#include <vsg/io/stream.h>
+#include <vsg/nodes/CullGroup.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/FlattenedSubgraph.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/QuadGroup.h>
+#include <vsg/nodes/StateGroup.h>
+
+using namespace vsg;
+
+FlattenedSubgraph::FlattenedSubgraph()
+{
+}
+
+FlattenedSubgraph::FlattenedSubgraph(ref_ptr<Node> in_child) :
+    child(in_child)
+{
+}
+
+FlattenedSubgraph::~FlattenedSubgraph()
+{
+}
+
+void FlattenedSubgraph::read(Input& input)
+{
+    Node::read(input);
+
+    input.read("child", child);
+
+    dirty();
+}
+
+void FlattenedSubgraph::write(Output& output) const
+{
+    Node::write(output);
+
+    output.write("child", child);
+}
+
+const FlattenedSubgraph::Stream& FlattenedSubgraph::stream() const
+{
+    if (_dirty.load())
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        if (_dirty.load())
+        {
+            _stream = {};
+            if (child) _flatten(_stream, child.get());
+            _dirty = false;
+        }
+    }
+    return _stream;
+}
+
+void FlattenedSubgraph::_flatten(Stream& stream, const Node* node)
+{
+    auto size = [](const auto& container) { return static_cast<uint32_t>(container.size()); };
+
+    auto addCommand = [&](const Command* command) {
+        Operation operation = command->cast<StateCommand>() ? STATE_COMMAND : COMMAND;
+        stream.entries.push_back(Entry{operation, size(stream.commands), 1, size(stream.entries) + 1});
+        stream.commands.emplace_back(command);
+    };
+
+    auto addChildren = [&](const auto& children) {
+        for (auto& child : children)
+        {
+            if (child) _flatten(stream, child.get());
+        }
+    };
+
+    // only flatten the exact types whose RecordTraversal handling is replicated by RecordTraversal::apply(const FlattenedSubgraph&), subclasses may change how they're recorded
+    const auto& type = node->type_info();
+    if (type == typeid(Group))
+    {
+        addChildren(static_cast<const Group*>(node)->children);
+    }
+    else if (type == typeid(QuadGroup))
+    {
+        addChildren(static_cast<const QuadGroup*>(node)->children);
+    }
+    else if (type == typeid(CullGroup) || type == typeid(CullNode))
+    {
+        auto cullIndex = size(stream.entries);
+        if (type == typeid(CullGroup))
+        {
+            auto cullGroup = static_cast<const CullGroup*>(node);
+            stream.entries.push_back(Entry{CULL, size(stream.bounds), 1, 0});
+            stream.bounds.push_back(cullGroup->bound);
+            stream.cullNodes.push_back(node);
+            addChildren(cullGroup->children);
+        }
+        else
+        {
+            auto cullNode = static_cast<const CullNode*>(node);
+            stream.entries.push_back(Entry{CULL, size(stream.bounds), 1, 0});
+            stream.bounds.push_back(cullNode->bound);
+            stream.cullNodes.push_back(node);
+            if (cullNode->child) _flatten(stream, cullNode->child.get());
+        }
+        stream.entries[cullIndex].end = size(stream.entries);
+    }
+    else if (type == typeid(StateGroup))
+    {
+        auto stateGroup = static_cast<const StateGroup*>(node);
+        if (stateGroup->stateCommands.empty())
+        {
+            addChildren(stateGroup->children);
+            return;
+        }
+
+        auto pushIndex = size(stream.entries);
+        Entry entry{PUSH_STATE, size(stream.stateCommands), size(stateGroup->stateCommands), 0};
+        for (auto& stateCommand : stateGroup->stateCommands) stream.stateCommands.emplace_back(stateCommand);
+
+        stream.entries.push_back(entry);
+        addChildren(stateGroup->children);
+
+        entry.operation = POP_STATE;
+        stream.entries.push_back(entry);
+
+        // when any of the state commands are pending the whole subgraph, including the POP_STATE, is skipped
+        stream.entries[pushIndex].end = size(stream.entries);
+    }
+    else if (type == typeid(MatrixTransform))
+    {
+        auto transform = static_cast<const MatrixTransform*>(node);
+        Entry entry{PUSH_TRANSFORM, size(stream.nodes), 1, 0};
+        stream.nodes.emplace_back(node);
+
+        stream.entries.push_back(entry);
+        addChildren(transform->children);
+
+        entry.operation = POP_TRANSFORM;
+        stream.entries.push_back(entry);
+    }
+    else if (type == typeid(Commands))
+    {
+        for (auto& command : static_cast<const Commands*>(node)->children)
+        {
+            if (command) addCommand(command.get());
+        }
+    }
+    else if (auto command = node->cast<Command>())
+    {
+        addCommand(command);
+    }
+    else
+    {
+        stream.entries.push_back(Entry{NODE, size(stream.nodes), 1, size(stream.entries) + 1});
+        stream.nodes.emplace_back(node);
+    }
+}
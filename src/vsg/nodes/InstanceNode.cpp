@@ -0,0 +1,64 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/compare.h>
+#include <vsg/io/Input.h>
+#include <vsg/io/Output.h>
+#include <vsg/nodes/InstanceNode.h>
+
+using namespace vsg;
+
+InstanceNode::InstanceNode()
+{
+}
+
+InstanceNode::InstanceNode(const dmat4& in_matrix, ref_ptr<Node> in_prototype, const StateCommands& in_stateCommands) :
+    matrix(in_matrix),
+    prototype(in_prototype),
+    stateCommands(in_stateCommands)
+{
+}
+
+InstanceNode::~InstanceNode()
+{
+}
+
+int InstanceNode::compare(const Object& rhs_object) const
+{
+    int result = Transform::compare(rhs_object);
+    if (result != 0) return result;
+
+    auto& rhs = static_cast<decltype(*this)>(rhs_object);
+    if ((result = compare_value(matrix, rhs.matrix))) return result;
+    if ((result = compare_pointer(prototype, rhs.prototype))) return result;
+    return compare_pointer_container(stateCommands, rhs.stateCommands);
+}
+
+void InstanceNode::read(Input& input)
+{
+    Transform::read(input);
+
+    input.read("matrix", matrix);
+    input.read("prototype", prototype);
+    input.readObjects("stateCommands", stateCommands);
+    input.read("subgraphRequiresLocalFrustum", subgraphRequiresLocalFrustum);
+}
+
+void InstanceNode::write(Output& output) const
+{
+    Transform::write(output);
+
+    output.write("matrix", matrix);
+    output.write("prototype", prototype);
+    output.writeObjects("stateCommands", stateCommands);
+    output.write("subgraphRequiresLocalFrustum", subgraphRequiresLocalFrustum);
+}
@@ -0,0 +1,399 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/BindIndexBuffer.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/stream.h>
+#include <vsg/nodes/InstancedGeometry.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/vk/Context.h>
+
+using namespace vsg;
+
+namespace
+{
+    const char* instancedGeometryCulling_comp = R"(
+#version 450
+
+layout(local_size_x = 64) in;
+
+struct DrawIndexedIndirectCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(push_constant) uniform PushConstants
+{
+    vec4 frustum[6];
+    vec4 lodScale;
+    uint numInstances;
+    uint numLODs;
+} pc;
+
+layout(std430, set = 0, binding = 0) readonly buffer InstanceBounds { vec4 bounds[]; };
+layout(std430, set = 0, binding = 1) readonly buffer InstancePositions { float positions[]; };
+layout(std430, set = 0, binding = 2) readonly buffer LODRatios { float lodRatios[]; };
+layout(std430, set = 0, binding = 3) buffer DrawCommands { DrawIndexedIndirectCommand drawCommands[]; };
+layout(std430, set = 0, binding = 4) writeonly buffer CulledPositions { float culledPositions[]; };
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.numInstances) return;
+
+    vec4 sphere = bounds[i];
+    for (int f = 0; f < 6; ++f)
+    {
+        if (dot(pc.frustum[f].xyz, sphere.xyz) + pc.frustum[f].w < -sphere.w) return;
+    }
+
+    float lodDistance = abs(dot(pc.lodScale.xyz, sphere.xyz) + pc.lodScale.w);
+    for (uint lod = 0; lod < pc.numLODs; ++lod)
+    {
+        if (sphere.w > lodDistance * lodRatios[lod])
+        {
+            uint index = drawCommands[lod].firstInstance + atomicAdd(drawCommands[lod].instanceCount, 1);
+            culledPositions[index * 3] = positions[i * 3];
+            culledPositions[index * 3 + 1] = positions[i * 3 + 1];
+            culledPositions[index * 3 + 2] = positions[i * 3 + 2];
+            return;
+        }
+    }
+}
+)";
+
+    struct CullingPushConstants
+    {
+        vec4 frustum[6];
+        vec4 lodScale;
+        uint32_t numInstances;
+        uint32_t numLODs;
+    };
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////
+//
+// InstancedGeometry
+//
+InstancedGeometry::InstancedGeometry()
+{
+}
+
+InstancedGeometry::InstancedGeometry(ref_ptr<vec3Array> in_positions) :
+    positions(in_positions)
+{
+}
+
+InstancedGeometry::~InstancedGeometry()
+{
+}
+
+void InstancedGeometry::addLOD(double minimumScreenHeightRatio, ref_ptr<VertexIndexDraw> mesh)
+{
+    if (!instancePositions) instancePositions = BufferInfo::create(positions);
+
+    mesh->arrays.push_back(instancePositions);
+    mesh->instanceCount = numInstances();
+    lods.push_back(LODLevel{minimumScreenHeightRatio, mesh});
+
+    // the culling data needs to be recreated to include the new level
+    drawCommands = {};
+}
+
+void InstancedGeometry::assignCullingData()
+{
+    uint32_t instanceCount = numInstances();
+    uint32_t numLODs = static_cast<uint32_t>(lods.size());
+    if (instanceCount == 0 || numLODs == 0) return;
+
+    if (!meshBound.valid() && !lods.front().mesh->arrays.empty())
+    {
+        if (auto vertices = lods.front().mesh->arrays.front()->data.cast<vec3Array>(); vertices && vertices->size() > 0)
+        {
+            dbox box;
+            for (auto& vertex : *vertices) box.add(vertex);
+
+            meshBound.center = (box.min + box.max) * 0.5;
+            meshBound.radius = 0.0;
+            for (auto& vertex : *vertices) meshBound.radius = std::max(meshBound.radius, length(dvec3(vertex) - meshBound.center));
+        }
+    }
+
+    if (!instancePositions) instancePositions = BufferInfo::create(positions);
+
+    auto bounds = vec4Array::create(instanceCount);
+    for (uint32_t i = 0; i < instanceCount; ++i)
+    {
+        dvec3 center = dvec3(positions->at(i)) + meshBound.center;
+        bounds->set(i, vec4(vec3(center), static_cast<float>(meshBound.radius)));
+    }
+    instanceBounds = BufferInfo::create(bounds);
+
+    // each level's visible instances are packed into its own block of culledPositions, starting at the level's firstInstance
+    auto ratios = floatArray::create(numLODs);
+    auto templates = DrawIndexedIndirectCommandArray::create(numLODs);
+    for (uint32_t lod = 0; lod < numLODs; ++lod)
+    {
+        auto& mesh = lods[lod].mesh;
+        ratios->set(lod, static_cast<float>(lods[lod].minimumScreenHeightRatio));
+        templates->set(lod, DrawIndexedIndirectCommand{mesh->indexCount, 0, mesh->firstIndex, static_cast<int32_t>(mesh->vertexOffset), lod * instanceCount});
+    }
+    lodRatios = BufferInfo::create(ratios);
+    drawTemplates = BufferInfo::create(templates);
+    auto commands = DrawIndexedIndirectCommandArray::create(numLODs);
+    for (uint32_t lod = 0; lod < numLODs; ++lod) commands->set(lod, templates->at(lod));
+    drawCommands = BufferInfo::create(commands);
+    culledPositions = BufferInfo::create(vec3Array::create(numLODs * instanceCount));
+}
+
+void InstancedGeometry::traverse(Visitor& visitor)
+{
+    for (auto& lod : lods)
+    {
+        if (lod.mesh) lod.mesh->accept(visitor);
+    }
+}
+
+void InstancedGeometry::traverse(ConstVisitor& visitor) const
+{
+    // the highest detail level, drawn with all the instances, stands in for the culled draws
+    if (!lods.empty() && lods.front().mesh) lods.front().mesh->accept(visitor);
+}
+
+void InstancedGeometry::read(Input& input)
+{
+    Command::read(input);
+
+    input.readObject("positions", positions);
+    input.read("meshBound", meshBound);
+
+    instancePositions = BufferInfo::create(positions);
+
+    lods.resize(input.readValue<uint32_t>("lods"));
+    for (auto& lod : lods)
+    {
+        input.read("lod.minimumScreenHeightRatio", lod.minimumScreenHeightRatio);
+        input.read("lod.mesh", lod.mesh);
+
+        // share the same instance positions BufferInfo across all the levels
+        if (lod.mesh && !lod.mesh->arrays.empty()) lod.mesh->arrays.back() = instancePositions;
+    }
+
+    drawCommands = {};
+}
+
+void InstancedGeometry::write(Output& output) const
+{
+    Command::write(output);
+
+    output.writeObject("positions", positions);
+    output.write("meshBound", meshBound);
+
+    output.writeValue<uint32_t>("lods", lods.size());
+    for (auto& lod : lods)
+    {
+        output.write("lod.minimumScreenHeightRatio", lod.minimumScreenHeightRatio);
+        output.write("lod.mesh", lod.mesh);
+    }
+}
+
+void InstancedGeometry::compile(Context& context)
+{
+    if (lods.empty() || numInstances() == 0) return;
+
+    if (!drawCommands) assignCullingData();
+
+    auto deviceID = context.deviceID;
+
+    // the culling buffers are created here, rather than by the DescriptorBuffer, so that they have the vertex and indirect usage they're drawn with
+    if (instancePositions->requiresCopy(deviceID) || instanceBounds->requiresCopy(deviceID) || lodRatios->requiresCopy(deviceID) || drawTemplates->requiresCopy(deviceID))
+    {
+        createBufferAndTransferData(context, {instancePositions, instanceBounds, lodRatios, drawTemplates}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+    }
+    if (drawCommands->requiresCopy(deviceID))
+    {
+        createBufferAndTransferData(context, {drawCommands}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+    }
+    if (culledPositions->requiresCopy(deviceID))
+    {
+        createBufferAndTransferData(context, {culledPositions}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+    }
+
+    auto& lodData = _vulkanData[deviceID];
+    lodData.clear();
+
+    for (auto& lod : lods)
+    {
+        auto& mesh = lod.mesh;
+        if (!mesh->indices || mesh->arrays.empty()) continue;
+
+        // the mesh's own vertex arrays, excluding the instance positions which are replaced by culledPositions when drawing
+        BufferInfoList bufferInfos(mesh->arrays.begin(), mesh->arrays.end() - 1);
+        bufferInfos.push_back(mesh->indices);
+
+        bool requiresCreateAndCopy = false;
+        for (auto& bufferInfo : bufferInfos)
+        {
+            if (bufferInfo->requiresCopy(deviceID)) requiresCreateAndCopy = true;
+        }
+        if (requiresCreateAndCopy)
+        {
+            createBufferAndTransferData(context, bufferInfos, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+        }
+
+        VulkanLODData vkd;
+        for (size_t i = 0; i + 1 < bufferInfos.size(); ++i)
+        {
+            vkd.vkBuffers.push_back(bufferInfos[i]->buffer->vk(deviceID));
+            vkd.offsets.push_back(bufferInfos[i]->offset);
+        }
+        vkd.vkBuffers.push_back(culledPositions->buffer->vk(deviceID));
+        vkd.offsets.push_back(culledPositions->offset);
+
+        vkd.indexBuffer = mesh->indices->buffer->vk(deviceID);
+        vkd.indexOffset = mesh->indices->offset;
+        vkd.indexType = computeIndexType(mesh->indices->data);
+        lodData.push_back(vkd);
+    }
+}
+
+void InstancedGeometry::record(CommandBuffer& commandBuffer) const
+{
+    auto deviceID = commandBuffer.deviceID;
+    auto& lodData = _vulkanData[deviceID];
+    if (lodData.size() != lods.size() || !drawCommands || !drawCommands->buffer) return;
+
+    VkBuffer drawBuffer = drawCommands->buffer->vk(deviceID);
+    uint32_t stride = static_cast<uint32_t>(sizeof(DrawIndexedIndirectCommand));
+
+    for (size_t lod = 0; lod < lodData.size(); ++lod)
+    {
+        auto& vkd = lodData[lod];
+        vkCmdBindVertexBuffers(commandBuffer, lods[lod].mesh->firstBinding, static_cast<uint32_t>(vkd.vkBuffers.size()), vkd.vkBuffers.data(), vkd.offsets.data());
+        vkCmdBindIndexBuffer(commandBuffer, vkd.indexBuffer, vkd.indexOffset, vkd.indexType);
+        vkCmdDrawIndexedIndirect(commandBuffer, drawBuffer, drawCommands->offset + lod * stride, 1, stride);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// InstancedGeometryCulling
+//
+InstancedGeometryCulling::InstancedGeometryCulling(ref_ptr<Camera> in_camera, ref_ptr<InstancedGeometry> in_instancedGeometry) :
+    camera(in_camera),
+    instancedGeometry(in_instancedGeometry)
+{
+    if (!instancedGeometry->drawCommands) instancedGeometry->assignCullingData();
+
+    DescriptorSetLayoutBindings bindings{
+        {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+    auto descriptorSetLayout = DescriptorSetLayout::create(bindings);
+
+    PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingPushConstants)}};
+    _pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{descriptorSetLayout}, pushConstantRanges);
+
+    auto computeShader = ShaderStage::create(VK_SHADER_STAGE_COMPUTE_BIT, "main", instancedGeometryCulling_comp);
+    _bindPipeline = BindComputePipeline::create(ComputePipeline::create(_pipelineLayout, computeShader));
+
+    Descriptors descriptors{
+        DescriptorBuffer::create(BufferInfoList{instancedGeometry->instanceBounds}, 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{instancedGeometry->instancePositions}, 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{instancedGeometry->lodRatios}, 2, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{instancedGeometry->drawCommands}, 3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{instancedGeometry->culledPositions}, 4, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)};
+    _bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, DescriptorSet::create(descriptorSetLayout, descriptors));
+
+    // previous frame's draws must have finished reading the outputs before they're reset and rewritten
+    _preCullBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                              MemoryBarrier::create(0, VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+    // the reset instance counts must be visible to the compute shader's atomicAdd
+    _resetBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                            MemoryBarrier::create(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+    // the compute shader's writes must be visible to the indirect draws and their instance attributes
+    _postCullBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0,
+                                               MemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT));
+}
+
+void InstancedGeometryCulling::compile(Context& context)
+{
+    // create the InstancedGeometry's buffers before the DescriptorBuffers can, so they have the usage required for drawing
+    instancedGeometry->compile(context);
+
+    _bindPipeline->compile(context);
+    _bindDescriptorSet->compile(context);
+}
+
+void InstancedGeometryCulling::record(CommandBuffer& commandBuffer) const
+{
+    auto& drawCommands = instancedGeometry->drawCommands;
+    auto& drawTemplates = instancedGeometry->drawTemplates;
+    uint32_t numInstances = instancedGeometry->numInstances();
+    uint32_t numLODs = static_cast<uint32_t>(instancedGeometry->lods.size());
+    if (!camera || numInstances == 0 || !drawCommands || !drawCommands->buffer || !drawTemplates->buffer) return;
+
+    dmat4 projectionMatrix = camera->projectionMatrix->transform();
+    dmat4 viewMatrix = camera->viewMatrix->transform();
+
+    // world coordinate frustum planes from the clip space planes, normalized so the shader can compare distances against the sphere radii
+    dmat4 clipMatrix = projectionMatrix * viewMatrix;
+    const dplane clipPlanes[6] = {
+        {1.0, 0.0, 0.0, 1.0},  // left
+        {-1.0, 0.0, 0.0, 1.0}, // right
+        {0.0, -1.0, 0.0, 1.0}, // bottom
+        {0.0, 1.0, 0.0, 1.0},  // top
+        {0.0, 0.0, 1.0, 0.0},  // far
+        {0.0, 0.0, -1.0, 1.0}  // near
+    };
+
+    CullingPushConstants pushConstants;
+    for (int i = 0; i < 6; ++i)
+    {
+        dplane plane = clipPlanes[i] * clipMatrix;
+        double normalLength = length(plane.n);
+        if (normalLength > 0.0) plane.vec /= normalLength;
+        pushConstants.frustum[i] = vec4(plane.vec);
+    }
+
+    // same LOD scale as State::Frustum::computeLodScale(), with the lodBias folded in
+    const auto& mv = viewMatrix;
+    double sc = -projectionMatrix[1][1] * std::sqrt(square(mv[0][0]) + square(mv[1][0]) + square(mv[2][0]) + square(mv[0][1]) + square(mv[1][1]) + square(mv[2][1])) * 0.5;
+    double scale = lodBias / sc;
+    pushConstants.lodScale = vec4(dvec4(mv[0][2], mv[1][2], mv[2][2], mv[3][2]) * scale);
+    pushConstants.numInstances = numInstances;
+    pushConstants.numLODs = numLODs;
+
+    auto deviceID = commandBuffer.deviceID;
+
+    // reset the instance counts by copying the templates over the draw commands
+    _preCullBarrier->record(commandBuffer);
+    VkBufferCopy region{drawTemplates->offset, drawCommands->offset, drawTemplates->range};
+    vkCmdCopyBuffer(commandBuffer, drawTemplates->buffer->vk(deviceID), drawCommands->buffer->vk(deviceID), 1, &region);
+    _resetBarrier->record(commandBuffer);
+
+    _bindPipeline->record(commandBuffer);
+    _bindDescriptorSet->record(commandBuffer);
+    vkCmdPushConstants(commandBuffer, _pipelineLayout->vk(deviceID), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingPushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, (numInstances + workgroupSize - 1) / workgroupSize, 1, 1);
+
+    _postCullBarrier->record(commandBuffer);
+}
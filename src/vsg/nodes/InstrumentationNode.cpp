@@ -10,6 +10,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/app/GpuTimestamps.h>
+#include <vsg/app/RecordTraversal.h>
 #include <vsg/io/Options.h>
 #include <vsg/io/stream.h>
 #include <vsg/nodes/InstrumentationNode.h>
@@ -52,7 +54,36 @@ void InstrumentationNode::traverse(ConstVisitor& visitor) const
 void InstrumentationNode::traverse(RecordTraversal& rt) const
 {
     GpuInstrumentation cpuInst(rt.instrumentation, &_sl_RecordTraversal, *rt.getCommandBuffer(), child.get());
-    child->accept(rt);
+
+    if (_gpuTimings && rt.gpuTimestamps)
+    {
+        auto commandBuffer = rt.getCommandBuffer();
+        auto reference = rt.gpuTimestamps->begin(*commandBuffer, _gpuTimings);
+        child->accept(rt);
+        rt.gpuTimestamps->end(*commandBuffer, reference);
+    }
+    else
+    {
+        child->accept(rt);
+    }
+}
+
+void InstrumentationNode::setGpuTiming(bool enabled)
+{
+    if (!enabled)
+        _gpuTimings = {};
+    else if (!_gpuTimings)
+        _gpuTimings = Timings::create(_name, 240);
+}
+
+ref_ptr<Timings> InstrumentationNode::getGpuTimings() const
+{
+    return _gpuTimings;
+}
+
+double InstrumentationNode::getGpuTime() const
+{
+    return _gpuTimings ? _gpuTimings->latest() : 0.0;
 }
 
 void InstrumentationNode::setColor(uint_color color)
@@ -32,7 +32,8 @@ int MatrixTransform::compare(const Object& rhs_object) const
     if (result != 0) return result;
 
     auto& rhs = static_cast<decltype(*this)>(rhs_object);
-    return compare_value(matrix, rhs.matrix);
+    if ((result = compare_value(matrix, rhs.matrix))) return result;
+    return compare_value(bound, rhs.bound);
 }
 
 void MatrixTransform::read(Input& input)
@@ -41,6 +42,11 @@ void MatrixTransform::read(Input& input)
 
     input.read("matrix", matrix);
     input.read("subgraphRequiresLocalFrustum", subgraphRequiresLocalFrustum);
+
+    if (input.version_greater_equal(1, 1, 9))
+    {
+        input.read("bound", bound);
+    }
 }
 
 void MatrixTransform::write(Output& output) const
@@ -49,4 +55,9 @@ void MatrixTransform::write(Output& output) const
 
     output.write("matrix", matrix);
     output.write("subgraphRequiresLocalFrustum", subgraphRequiresLocalFrustum);
+
+    if (output.version_greater_equal(1, 1, 9))
+    {
+        output.write("bound", bound);
+    }
 }
@@ -0,0 +1,70 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/stream.h>
+#include <vsg/nodes/OcclusionQueryNode.h>
+
+using namespace vsg;
+
+OcclusionQueryNode::OcclusionQueryNode()
+{
+}
+
+OcclusionQueryNode::OcclusionQueryNode(const dsphere& in_bound, ref_ptr<Node> in_proxy, ref_ptr<Node> in_child) :
+    bound(in_bound),
+    proxy(in_proxy),
+    child(in_child)
+{
+}
+
+OcclusionQueryNode::~OcclusionQueryNode()
+{
+}
+
+void OcclusionQueryNode::traverse(Visitor& visitor)
+{
+    if (proxy) proxy->accept(visitor);
+    if (child) child->accept(visitor);
+}
+
+void OcclusionQueryNode::traverse(ConstVisitor& visitor) const
+{
+    if (proxy) proxy->accept(visitor);
+    if (child) child->accept(visitor);
+}
+
+void OcclusionQueryNode::traverse(RecordTraversal& visitor) const
+{
+    if (child) child->accept(visitor);
+}
+
+void OcclusionQueryNode::read(Input& input)
+{
+    Node::read(input);
+
+    input.read("bound", bound);
+    input.read("proxy", proxy);
+    input.read("child", child);
+    input.read("recordHidden", recordHidden);
+    input.read("maximumResultAge", maximumResultAge);
+}
+
+void OcclusionQueryNode::write(Output& output) const
+{
+    Node::write(output);
+
+    output.write("bound", bound);
+    output.write("proxy", proxy);
+    output.write("child", child);
+    output.write("recordHidden", recordHidden);
+    output.write("maximumResultAge", maximumResultAge);
+}
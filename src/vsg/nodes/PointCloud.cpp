@@ -0,0 +1,78 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/stream.h>
+#include <vsg/nodes/PointCloud.h>
+
+using namespace vsg;
+
+PointCloud::PointCloud()
+{
+}
+
+PointCloud::~PointCloud()
+{
+}
+
+void PointCloud::assignTiles(const Path& directory)
+{
+    for (auto& octant : octants)
+    {
+        if (!octant.tile) octant.tile = PagedLOD::create();
+
+        auto& tile = octant.tile;
+        tile->bound = octant.bound;
+        tile->options = options;
+        if (octant.filename) tile->filename = directory ? (directory / octant.filename).lexically_normal() : octant.filename;
+    }
+}
+
+void PointCloud::read(Input& input)
+{
+    Node::read(input);
+
+    input.read("pointBudget", pointBudget);
+    input.read("minimumScreenHeightRatio", minimumScreenHeightRatio);
+
+    octants.resize(input.readValue<uint32_t>("octants"));
+    for (auto& octant : octants)
+    {
+        input.read("octant.bound", octant.bound);
+        input.read("octant.numPoints", octant.numPoints);
+        input.read("octant.spacing", octant.spacing);
+        for (auto& child : octant.children) input.read("octant.child", child);
+        input.read("octant.filename", octant.filename);
+        octant.tile = {};
+    }
+
+    options = Options::create_if(input.options, *input.options);
+
+    assignTiles(input.filename ? filePath(input.filename) : Path());
+}
+
+void PointCloud::write(Output& output) const
+{
+    Node::write(output);
+
+    output.write("pointBudget", pointBudget);
+    output.write("minimumScreenHeightRatio", minimumScreenHeightRatio);
+
+    output.writeValue<uint32_t>("octants", octants.size());
+    for (auto& octant : octants)
+    {
+        output.write("octant.bound", octant.bound);
+        output.write("octant.numPoints", octant.numPoints);
+        output.write("octant.spacing", octant.spacing);
+        for (auto& child : octant.children) output.write("octant.child", child);
+        output.write("octant.filename", octant.filename);
+    }
+}
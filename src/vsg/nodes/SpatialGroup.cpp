@@ -0,0 +1,180 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Options.h>
+#include <vsg/io/stream.h>
+#include <vsg/nodes/SpatialGroup.h>
+
+#include <cmath>
+
+using namespace vsg;
+
+SpatialGroup::SpatialGroup(double in_cellSize) :
+    _cellSize(in_cellSize)
+{
+}
+
+SpatialGroup::~SpatialGroup()
+{
+}
+
+uint64_t SpatialGroup::_cellKey(const dvec3& position) const
+{
+    // pack the 21 low bits of each cell coordinate, wrapping around for very distant cells, which only costs some culling efficiency
+    const uint64_t mask = (uint64_t(1) << 21) - 1;
+    auto cellCoord = [&](double v) { return static_cast<uint64_t>(static_cast<int64_t>(std::floor(v / _cellSize))) & mask; };
+    return (cellCoord(position.x) << 42) | (cellCoord(position.y) << 21) | cellCoord(position.z);
+}
+
+void SpatialGroup::_insert(uint32_t index)
+{
+    auto& child = _children[index];
+    uint64_t key = _cellKey(child.bound.center);
+
+    auto& cell = _cells[key];
+    if (cell.children.empty())
+    {
+        dvec3 c = child.bound.center / _cellSize;
+        cell.bound.center.set((std::floor(c.x) + 0.5) * _cellSize, (std::floor(c.y) + 0.5) * _cellSize, (std::floor(c.z) + 0.5) * _cellSize);
+        cell.maximumChildRadius = 0.0;
+    }
+
+    cell.maximumChildRadius = std::max(cell.maximumChildRadius, child.bound.radius);
+    cell.bound.radius = _cellSize * 0.5 * std::sqrt(3.0) + cell.maximumChildRadius;
+
+    _placements[index] = Placement{key, static_cast<uint32_t>(cell.children.size())};
+    cell.children.push_back(index);
+}
+
+void SpatialGroup::_erase(uint32_t index)
+{
+    auto& placement = _placements[index];
+    auto itr = _cells.find(placement.cell);
+    if (itr == _cells.end()) return;
+
+    // move the cell's last child into the removed child's position so removal is O(1)
+    auto& cellChildren = itr->second.children;
+    uint32_t last = cellChildren.back();
+    cellChildren[placement.position] = last;
+    _placements[last].position = placement.position;
+    cellChildren.pop_back();
+
+    // the cell's maximumChildRadius is left as is, as it remains a conservative bound, until the cell is emptied
+    if (cellChildren.empty()) _cells.erase(itr);
+}
+
+uint32_t SpatialGroup::addChild(ref_ptr<Node> node, const dsphere& bound)
+{
+    uint32_t index;
+    if (!_freeIndices.empty())
+    {
+        index = _freeIndices.back();
+        _freeIndices.pop_back();
+        _children[index] = Child{bound, node};
+    }
+    else
+    {
+        index = static_cast<uint32_t>(_children.size());
+        _children.push_back(Child{bound, node});
+        _placements.emplace_back();
+    }
+
+    _insert(index);
+    return index;
+}
+
+void SpatialGroup::updateChild(uint32_t index, const dsphere& bound)
+{
+    if (index >= _children.size() || !_children[index].node) return;
+
+    auto& child = _children[index];
+    auto& placement = _placements[index];
+    if (_cellKey(bound.center) == placement.cell)
+    {
+        child.bound = bound;
+
+        auto& cell = _cells[placement.cell];
+        if (bound.radius > cell.maximumChildRadius)
+        {
+            cell.maximumChildRadius = bound.radius;
+            cell.bound.radius = _cellSize * 0.5 * std::sqrt(3.0) + cell.maximumChildRadius;
+        }
+    }
+    else
+    {
+        _erase(index);
+        child.bound = bound;
+        _insert(index);
+    }
+}
+
+void SpatialGroup::removeChild(uint32_t index)
+{
+    if (index >= _children.size() || !_children[index].node) return;
+
+    _erase(index);
+    _children[index] = Child{};
+    _freeIndices.push_back(index);
+}
+
+void SpatialGroup::clear()
+{
+    _children.clear();
+    _placements.clear();
+    _freeIndices.clear();
+    _cells.clear();
+}
+
+void SpatialGroup::setCellSize(double in_cellSize)
+{
+    _cellSize = in_cellSize;
+
+    _cells.clear();
+    for (uint32_t i = 0; i < _children.size(); ++i)
+    {
+        if (_children[i].node) _insert(i);
+    }
+}
+
+void SpatialGroup::read(Input& input)
+{
+    Node::read(input);
+
+    clear();
+
+    input.read("cellSize", _cellSize);
+
+    auto numChildren = input.readValue<uint32_t>("children");
+    for (uint32_t i = 0; i < numChildren; ++i)
+    {
+        Child child;
+        input.read("child.bound", child.bound);
+        input.read("child.node", child.node);
+        if (child.node) addChild(child.node, child.bound);
+    }
+}
+
+void SpatialGroup::write(Output& output) const
+{
+    Node::write(output);
+
+    output.write("cellSize", _cellSize);
+
+    // removed children aren't written so indices are compacted when read back
+    output.writeValue<uint32_t>("children", size());
+    for (auto& child : _children)
+    {
+        if (!child.node) continue;
+        output.write("child.bound", child.bound);
+        output.write("child.node", child.node);
+    }
+}
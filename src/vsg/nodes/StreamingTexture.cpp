@@ -0,0 +1,144 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array2D.h>
+#include <vsg/core/ConstVisitor.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/nodes/StreamingTexture.h>
+#include <vsg/state/DescriptorImage.h>
+
+using namespace vsg;
+
+namespace
+{
+    /// create a view of the mipmap chain of an image starting at a specified mip level, sharing the image's data
+    struct CreateMipmapView : public ConstVisitor
+    {
+        uint32_t mipLevel = 0;
+        ref_ptr<Data> view;
+
+        template<class A>
+        void createView(const A& array)
+        {
+            auto mipmapOffsets = array.computeMipmapOffsets();
+            if (mipLevel == 0 || mipLevel >= mipmapOffsets.size()) return;
+
+            uint32_t width = std::max(static_cast<uint32_t>(array.width()) >> mipLevel, 1u);
+            uint32_t height = std::max(static_cast<uint32_t>(array.height()) >> mipLevel, 1u);
+
+            auto properties = array.properties;
+            properties.maxNumMipmaps = static_cast<uint8_t>(mipmapOffsets.size() - mipLevel);
+
+            auto offset = static_cast<uint32_t>(mipmapOffsets[mipLevel] * array.valueSize());
+            view = A::create(ref_ptr<Data>(const_cast<A*>(&array)), offset, array.stride(), width, height, properties);
+        }
+
+        void apply(const ubyteArray2D& array) override { createView(array); }
+        void apply(const ushortArray2D& array) override { createView(array); }
+        void apply(const floatArray2D& array) override { createView(array); }
+        void apply(const ubvec2Array2D& array) override { createView(array); }
+        void apply(const ubvec3Array2D& array) override { createView(array); }
+        void apply(const ubvec4Array2D& array) override { createView(array); }
+        void apply(const usvec4Array2D& array) override { createView(array); }
+        void apply(const vec4Array2D& array) override { createView(array); }
+        void apply(const block64Array2D& array) override { createView(array); }
+        void apply(const block128Array2D& array) override { createView(array); }
+    };
+} // namespace
+
+StreamingTexture::StreamingTexture()
+{
+}
+
+StreamingTexture::~StreamingTexture()
+{
+}
+
+uint32_t StreamingTexture::numMipLevels() const
+{
+    if (!image) return 0;
+    return std::max(static_cast<uint32_t>(image->computeMipmapOffsets().size()), 1u);
+}
+
+void StreamingTexture::init()
+{
+    uint32_t numLevels = numMipLevels();
+    coarseMipLevel = (numLevels > numCoarseMipLevels) ? (numLevels - numCoarseMipLevels) : 0;
+
+    coarseState = createBindDescriptorSet(coarseMipLevel);
+    if (!coarseState)
+    {
+        // image type not supported for streaming so fallback to using the full mipmap chain
+        coarseMipLevel = 0;
+        coarseState = bindDescriptorSet;
+    }
+
+    activeState = coarseState;
+    activeMipLevel = coarseMipLevel;
+}
+
+ref_ptr<BindDescriptorSet> StreamingTexture::createBindDescriptorSet(uint32_t baseMipLevel) const
+{
+    if (!bindDescriptorSet || !bindDescriptorSet->descriptorSet || !image) return {};
+
+    auto& templateSet = *(bindDescriptorSet->descriptorSet);
+    if (descriptorIndex >= templateSet.descriptors.size()) return {};
+
+    auto templateImage = templateSet.descriptors[descriptorIndex].cast<DescriptorImage>();
+    if (!templateImage || templateImage->imageInfoList.empty()) return {};
+
+    ref_ptr<Data> data = image;
+    if (baseMipLevel > 0)
+    {
+        CreateMipmapView createMipmapView;
+        createMipmapView.mipLevel = baseMipLevel;
+        image->accept(createMipmapView);
+        if (!createMipmapView.view) return {};
+
+        data = createMipmapView.view;
+    }
+
+    auto descriptors = templateSet.descriptors;
+    descriptors[descriptorIndex] = DescriptorImage::create(templateImage->imageInfoList.front()->sampler, data, templateImage->dstBinding, templateImage->dstArrayElement, templateImage->descriptorType);
+
+    auto descriptorSet = DescriptorSet::create(templateSet.setLayout, descriptors);
+    auto state = BindDescriptorSet::create(bindDescriptorSet->pipelineBindPoint, bindDescriptorSet->layout, bindDescriptorSet->firstSet, descriptorSet);
+    state->slot = bindDescriptorSet->slot;
+    return state;
+}
+
+void StreamingTexture::read(Input& input)
+{
+    Node::read(input);
+
+    input.read("bound", bound);
+    input.readObject("image", image);
+    input.readObject("bindDescriptorSet", bindDescriptorSet);
+    input.read("descriptorIndex", descriptorIndex);
+    input.read("numCoarseMipLevels", numCoarseMipLevels);
+    input.readObject("child", child);
+
+    init();
+}
+
+void StreamingTexture::write(Output& output) const
+{
+    Node::write(output);
+
+    output.write("bound", bound);
+    output.writeObject("image", image);
+    output.writeObject("bindDescriptorSet", bindDescriptorSet);
+    output.write("descriptorIndex", descriptorIndex);
+    output.write("numCoarseMipLevels", numCoarseMipLevels);
+    output.writeObject("child", child);
+}
@@ -41,6 +41,14 @@ void TileDatabaseSettings::read(vsg::Input& input)
         input.read("lighting", lighting);
         input.readObject("shaderSet", shaderSet);
     }
+
+    if (input.version_greater_equal(1, 1, 5))
+    {
+        input.read("cacheDirectory", cacheDirectory);
+        input.read("maxCacheSize", maxCacheSize);
+        input.read("maxCacheAge", maxCacheAge);
+        input.read("memoryCacheSize", memoryCacheSize);
+    }
 }
 
 void TileDatabaseSettings::write(vsg::Output& output) const
@@ -62,6 +70,14 @@ void TileDatabaseSettings::write(vsg::Output& output) const
         output.write("lighting", lighting);
         output.writeObject("shaderSet", shaderSet);
     }
+
+    if (output.version_greater_equal(1, 1, 5))
+    {
+        output.write("cacheDirectory", cacheDirectory);
+        output.write("maxCacheSize", maxCacheSize);
+        output.write("maxCacheAge", maxCacheAge);
+        output.write("memoryCacheSize", memoryCacheSize);
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
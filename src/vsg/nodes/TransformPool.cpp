@@ -0,0 +1,162 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/compare.h>
+#include <vsg/io/Options.h>
+#include <vsg/io/stream.h>
+#include <vsg/nodes/TransformPool.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace vsg;
+
+/////////////////////////////////////////////////////////////////////////
+//
+// TransformPool
+//
+TransformPool::TransformPool(uint32_t initialCapacity) :
+    matrices(dmat4Array::create(std::max(initialCapacity, 1u)))
+{
+}
+
+TransformPool::~TransformPool()
+{
+}
+
+uint32_t TransformPool::allocate(const dmat4& matrix)
+{
+    uint32_t index;
+    if (!_freeIndices.empty())
+    {
+        index = _freeIndices.back();
+        _freeIndices.pop_back();
+    }
+    else
+    {
+        if (_size >= static_cast<uint32_t>(matrices->size()))
+        {
+            auto newMatrices = dmat4Array::create(std::max(static_cast<uint32_t>(matrices->size()) * 2, 16u));
+            std::memcpy(newMatrices->data(), matrices->data(), sizeof(dmat4) * _size);
+            matrices = newMatrices;
+        }
+        index = _size++;
+    }
+
+    matrices->at(index) = matrix;
+    return index;
+}
+
+void TransformPool::release(uint32_t index)
+{
+    if (index >= _size) return;
+
+    matrices->at(index) = dmat4();
+    _freeIndices.push_back(index);
+}
+
+void TransformPool::set(uint32_t first, const dmat4* src, uint32_t count)
+{
+    if (first >= _size) return;
+
+    count = std::min(count, _size - first);
+    std::memcpy(matrices->data() + first, src, sizeof(dmat4) * count);
+}
+
+void TransformPool::updateInstanceMatrices()
+{
+    if (!instanceMatrices || instanceMatrices->size() < _size)
+    {
+        instanceMatrices = mat4Array::create(matrices->size());
+        instanceMatrices->properties.dataVariance = DYNAMIC_DATA;
+    }
+
+    const dmat4* src = matrices->data();
+    mat4* dest = instanceMatrices->data();
+    for (uint32_t i = 0; i < _size; ++i)
+    {
+        dest[i] = mat4(src[i]);
+    }
+
+    instanceMatrices->dirty();
+}
+
+void TransformPool::read(Input& input)
+{
+    Object::read(input);
+
+    input.read("matrices", matrices);
+    input.read("size", _size);
+
+    _freeIndices.resize(input.readValue<uint32_t>("freeIndices"));
+    for (auto& index : _freeIndices) input.read("index", index);
+
+    if (!matrices) matrices = dmat4Array::create(1);
+    _size = std::min(_size, static_cast<uint32_t>(matrices->size()));
+}
+
+void TransformPool::write(Output& output) const
+{
+    Object::write(output);
+
+    output.write("matrices", matrices);
+    output.write("size", _size);
+
+    output.writeValue<uint32_t>("freeIndices", _freeIndices.size());
+    for (auto& index : _freeIndices) output.write("index", index);
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// PooledTransform
+//
+PooledTransform::PooledTransform()
+{
+}
+
+PooledTransform::PooledTransform(ref_ptr<TransformPool> in_pool, uint32_t in_index) :
+    pool(in_pool),
+    index(in_index)
+{
+}
+
+PooledTransform::~PooledTransform()
+{
+}
+
+int PooledTransform::compare(const Object& rhs_object) const
+{
+    int result = Transform::compare(rhs_object);
+    if (result != 0) return result;
+
+    auto& rhs = static_cast<decltype(*this)>(rhs_object);
+    if ((result = compare_pointer(pool, rhs.pool))) return result;
+    return compare_value(index, rhs.index);
+}
+
+void PooledTransform::read(Input& input)
+{
+    Transform::read(input);
+
+    input.read("pool", pool);
+    input.read("index", index);
+    input.read("subgraphRequiresLocalFrustum", subgraphRequiresLocalFrustum);
+}
+
+void PooledTransform::write(Output& output) const
+{
+    Transform::write(output);
+
+    output.write("pool", pool);
+    output.write("index", index);
+    output.write("subgraphRequiresLocalFrustum", subgraphRequiresLocalFrustum);
+}
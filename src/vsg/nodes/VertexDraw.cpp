@@ -123,4 +123,7 @@ void VertexDraw::record(CommandBuffer& commandBuffer) const
 
     vkCmdBindVertexBuffers(cmdBuffer, firstBinding, static_cast<uint32_t>(vkd.vkBuffers.size()), vkd.vkBuffers.data(), vkd.offsets.data());
     vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+
+    ++commandBuffer.recordStatistics.draws;
+    commandBuffer.recordStatistics.vertices += static_cast<uint64_t>(vertexCount) * instanceCount;
 }
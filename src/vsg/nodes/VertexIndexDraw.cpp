@@ -157,4 +157,7 @@ void VertexIndexDraw::record(CommandBuffer& commandBuffer) const
     vkCmdBindIndexBuffer(cmdBuffer, indices->buffer->vk(commandBuffer.deviceID), indices->offset, indexType);
 
     vkCmdDrawIndexed(cmdBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+
+    ++commandBuffer.recordStatistics.draws;
+    commandBuffer.recordStatistics.vertices += static_cast<uint64_t>(indexCount) * instanceCount;
 }
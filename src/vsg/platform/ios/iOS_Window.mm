@@ -39,6 +39,19 @@ namespace vsg
         return vsgiOS::iOS_Window::create(traits);
     }
 
+    // Provide the getThermalStatus() implementation that maps NSProcessInfo's thermalState
+    ThermalStatus getThermalStatus()
+    {
+        switch ([[NSProcessInfo processInfo] thermalState])
+        {
+        case NSProcessInfoThermalStateNominal: return THERMAL_STATUS_NONE;
+        case NSProcessInfoThermalStateFair: return THERMAL_STATUS_LIGHT;
+        case NSProcessInfoThermalStateSerious: return THERMAL_STATUS_SEVERE;
+        case NSProcessInfoThermalStateCritical: return THERMAL_STATUS_CRITICAL;
+        default: return THERMAL_STATUS_NONE;
+        }
+    }
+
 } // namespace vsg
 
 
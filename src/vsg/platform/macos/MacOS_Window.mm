@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/platform/macos/MacOS_Window.h>
 
+#include <vsg/app/PowerManager.h>
 #include <vsg/core/Exception.h>
 #include <vsg/core/observer_ptr.h>
 #include <vsg/io/Logger.h>
@@ -39,6 +40,19 @@ namespace vsg
         return vsgMacOS::MacOS_Window::create(traits);
     }
 
+    // Provide the getThermalStatus() implementation that maps NSProcessInfo's thermalState
+    ThermalStatus getThermalStatus()
+    {
+        switch ([[NSProcessInfo processInfo] thermalState])
+        {
+        case NSProcessInfoThermalStateNominal: return THERMAL_STATUS_NONE;
+        case NSProcessInfoThermalStateFair: return THERMAL_STATUS_LIGHT;
+        case NSProcessInfoThermalStateSerious: return THERMAL_STATUS_SEVERE;
+        case NSProcessInfoThermalStateCritical: return THERMAL_STATUS_CRITICAL;
+        default: return THERMAL_STATUS_NONE;
+        }
+    }
+
 } // namespace vsg
 
 
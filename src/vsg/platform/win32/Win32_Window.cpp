@@ -16,6 +16,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/platform/win32/Win32_Window.h>
 #include <vsg/ui/ScrollWheelEvent.h>
 
+#include <cmath>
+
 using namespace vsg;
 using namespace vsgWin32;
 
@@ -520,6 +522,22 @@ bool Win32_Window::pollEvents(vsg::UIEvents& events)
     return Window::pollEvents(events);
 }
 
+bool Win32_Window::waitEvents(vsg::UIEvents& events, double timeout)
+{
+    if (pollEvents(events)) return true;
+
+    DWORD milliseconds = timeout < 0.0 ? INFINITE : static_cast<DWORD>(std::ceil(timeout * 1000.0));
+    MsgWaitForMultipleObjectsEx(0, nullptr, milliseconds, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+    return pollEvents(events);
+}
+
+void Win32_Window::wakeEvents()
+{
+    // posting a message is thread safe and releases the MsgWaitForMultipleObjectsEx() of the thread that owns the window
+    if (_window) PostMessageW(_window, WM_NULL, 0, 0);
+}
+
 void Win32_Window::resize()
 {
     RECT windowRect;
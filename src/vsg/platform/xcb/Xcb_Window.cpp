@@ -20,9 +20,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <xcb/xproto.h>
 
 #include <chrono>
+#include <cmath>
 #include <cstring>
 #include <thread>
 
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
 namespace vsg
 {
     // Provide the Window::create(...) implementation that automatically maps to a Xcb_Window
@@ -510,6 +515,19 @@ Xcb_Window::Xcb_Window(vsg::ref_ptr<WindowTraits> traits) :
 
     traits->nativeWindow = _window;
     traits->systemConnection = _connection;
+
+    if (::pipe(_wakePipe) == 0)
+    {
+        for (auto fd : _wakePipe)
+        {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+    else
+    {
+        _wakePipe[0] = _wakePipe[1] = -1;
+    }
 }
 
 Xcb_Window::~Xcb_Window()
@@ -527,6 +545,11 @@ Xcb_Window::~Xcb_Window()
         xcb_flush(_connection);
         xcb_disconnect(_connection);
     }
+
+    for (auto fd : _wakePipe)
+    {
+        if (fd >= 0) ::close(fd);
+    }
 }
 
 void Xcb_Window::_initSurface()
@@ -780,6 +803,36 @@ bool Xcb_Window::pollEvents(UIEvents& events)
     return Window::pollEvents(events);
 }
 
+bool Xcb_Window::waitEvents(UIEvents& events, double timeout)
+{
+    if (pollEvents(events)) return true;
+    if (!_connection || _wakePipe[0] < 0) return Window::waitEvents(events, timeout);
+
+    // pollEvents() has emptied xcb's event queue, so any new events have to arrive through the connection's socket
+    xcb_flush(_connection);
+
+    pollfd fds[2];
+    fds[0] = {xcb_get_file_descriptor(_connection), POLLIN, 0};
+    fds[1] = {_wakePipe[0], POLLIN, 0};
+
+    int milliseconds = timeout < 0.0 ? -1 : static_cast<int>(std::ceil(timeout * 1000.0));
+    if (::poll(fds, 2, milliseconds) > 0 && (fds[1].revents & POLLIN))
+    {
+        char buffer[64];
+        while (::read(_wakePipe[0], buffer, sizeof(buffer)) > 0) {}
+    }
+
+    return pollEvents(events);
+}
+
+void Xcb_Window::wakeEvents()
+{
+    if (_wakePipe[1] < 0) return Window::wakeEvents();
+
+    char c = 1;
+    [[maybe_unused]] auto result = ::write(_wakePipe[1], &c, 1);
+}
+
 void Xcb_Window::resize()
 {
     xcb_get_geometry_reply_t* geometry_reply = xcb_get_geometry_reply(_connection, xcb_get_geometry(_connection, _window), nullptr);
@@ -26,6 +26,7 @@ AccelerationStructure::AccelerationStructure(VkAccelerationStructureTypeKHR type
     _accelerationStructureInfo{},
     _accelerationStructureBuildGeometryInfo{},
     _requiredBuildScratchSize(0),
+    _requiredUpdateScratchSize(0),
     _device(device)
 {
     _accelerationStructureInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
@@ -78,6 +79,7 @@ void AccelerationStructure::compile(Context& context)
         _handle = extensions->vkGetAccelerationStructureDeviceAddressKHR(*context.device, &deviceAddressInfo);
 
         _requiredBuildScratchSize = accelerationStructureBuildSizesInfo.buildScratchSize;
+        _requiredUpdateScratchSize = accelerationStructureBuildSizesInfo.updateScratchSize;
         context.scratchBufferSize = std::max(_requiredBuildScratchSize, context.scratchBufferSize);
     }
     else
@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/raytracing/BottomLevelAccelerationStructure.h>
 
+#include <vsg/core/Exception.h>
 #include <vsg/io/Options.h>
 #include <vsg/vk/CommandBuffer.h>
 #include <vsg/vk/Context.h>
@@ -25,6 +26,11 @@ BottomLevelAccelerationStructure::BottomLevelAccelerationStructure(Device* devic
 {
 }
 
+BottomLevelAccelerationStructure::~BottomLevelAccelerationStructure()
+{
+    releaseUncompacted();
+}
+
 void BottomLevelAccelerationStructure::compile(Context& context)
 {
     if (geometries.empty()) return;                        // no data
@@ -43,8 +49,60 @@ void BottomLevelAccelerationStructure::compile(Context& context)
     }
     _accelerationStructureBuildGeometryInfo.geometryCount = static_cast<uint32_t>(geometries.size());
     _accelerationStructureBuildGeometryInfo.pGeometries = _vkGeometries.data();
+    if (allowCompaction) _accelerationStructureBuildGeometryInfo.flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
 
     Inherit::compile(context);
 
     context.buildAccelerationStructureCommands.push_back(BuildAccelerationStructureCommand::create(context.device, _accelerationStructureBuildGeometryInfo, _accelerationStructure, _geometryPrimitiveCounts));
 }
+
+void BottomLevelAccelerationStructure::recordCompaction(Context& context, CommandBuffer& commandBuffer, VkDeviceSize compactedSize)
+{
+    if (!_accelerationStructure || compactedSize == 0 || compactedSize >= _accelerationStructureInfo.size) return;
+
+    auto extensions = context.device->getExtensions();
+
+    auto buffer = vsg::createBufferAndMemory(context.device, compactedSize, VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    VkAccelerationStructureCreateInfoKHR createInfo = _accelerationStructureInfo;
+    createInfo.buffer = buffer->vk(context.deviceID);
+    createInfo.size = compactedSize;
+
+    VkAccelerationStructureKHR compacted = VK_NULL_HANDLE;
+    VkResult result = extensions->vkCreateAccelerationStructureKHR(*context.device, &createInfo, nullptr, &compacted);
+    if (result != VK_SUCCESS)
+    {
+        throw Exception{"Error: vsg::BottomLevelAccelerationStructure::recordCompaction(...) failed to create AccelerationStructure.", result};
+    }
+
+    VkCopyAccelerationStructureInfoKHR copyInfo{};
+    copyInfo.sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR;
+    copyInfo.src = _accelerationStructure;
+    copyInfo.dst = compacted;
+    copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+    extensions->vkCmdCopyAccelerationStructureKHR(commandBuffer, &copyInfo);
+
+    releaseUncompacted();
+    _uncompactedAccelerationStructure = _accelerationStructure;
+    _uncompactedBuffer = _buffer;
+
+    _accelerationStructure = compacted;
+    _accelerationStructureInfo = createInfo;
+    _buffer = buffer;
+
+    VkAccelerationStructureDeviceAddressInfoKHR deviceAddressInfo{};
+    deviceAddressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
+    deviceAddressInfo.accelerationStructure = _accelerationStructure;
+    _handle = extensions->vkGetAccelerationStructureDeviceAddressKHR(*context.device, &deviceAddressInfo);
+}
+
+void BottomLevelAccelerationStructure::releaseUncompacted()
+{
+    if (_uncompactedAccelerationStructure)
+    {
+        auto extensions = _device->getExtensions();
+        extensions->vkDestroyAccelerationStructureKHR(*_device, _uncompactedAccelerationStructure, nullptr);
+        _uncompactedAccelerationStructure = VK_NULL_HANDLE;
+    }
+    _uncompactedBuffer = {};
+}
@@ -10,8 +10,15 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
 #include <vsg/raytracing/BuildAccelerationStructureTraversal.h>
+#include <vsg/state/QueryPool.h>
+#include <vsg/vk/CommandPool.h>
+#include <vsg/vk/Context.h>
+#include <vsg/vk/SubmitCommands.h>
+
+#include <set>
 
 using namespace vsg;
 
@@ -24,16 +31,27 @@ BuildAccelerationStructureTraversal::BuildAccelerationStructureTraversal(Device*
 
 void BuildAccelerationStructureTraversal::apply(Object& object)
 {
-    object.traverse(*this);
+    if (auto node = object.cast<Node>())
+    {
+        _nodePath.push_back(node);
+        object.traverse(*this);
+        _nodePath.pop_back();
+    }
+    else
+    {
+        object.traverse(*this);
+    }
 }
 
 void BuildAccelerationStructureTraversal::apply(Transform& transform)
 {
+    _nodePath.push_back(&transform);
     _transformStack.push(transform);
 
     transform.traverse(*this);
 
     _transformStack.pop();
+    _nodePath.pop_back();
 }
 
 void BuildAccelerationStructureTraversal::apply(Geometry& geometry)
@@ -57,7 +75,9 @@ void BuildAccelerationStructureTraversal::apply(Geometry& geometry)
     }
 
     // create a geometry instance for this geometry using the blas that represents it and the current transform matrix
+    _nodePath.push_back(&geometry);
     createGeometryInstance(blas);
+    _nodePath.pop_back();
 }
 
 void BuildAccelerationStructureTraversal::apply(VertexIndexDraw& vid)
@@ -76,7 +96,9 @@ void BuildAccelerationStructureTraversal::apply(VertexIndexDraw& vid)
     }
 
     // create a geometry instance for this geometry using the blas that represents it and the current transform matrix
+    _nodePath.push_back(&vid);
     createGeometryInstance(blas);
+    _nodePath.pop_back();
 }
 
 void BuildAccelerationStructureTraversal::createGeometryInstance(BottomLevelAccelerationStructure* blas)
@@ -85,6 +107,150 @@ void BuildAccelerationStructureTraversal::createGeometryInstance(BottomLevelAcce
     geominst->accelerationStructure = blas;
     geominst->id = static_cast<uint32_t>(tlas->geometryInstances.size());
     geominst->transform = _transformStack.top();
+    geominst->nodePath = _nodePath;
 
     tlas->geometryInstances.push_back(geominst);
 }
+
+VkDeviceSize BuildAccelerationStructureTraversal::buildBottomLevelAccelerationStructures(Queue* queue)
+{
+    if (!queue) return 0;
+
+    std::set<BottomLevelAccelerationStructure*> uniqueBlas;
+    for (auto& [vid, blas] : _vertexIndexDrawBlasMap) uniqueBlas.insert(blas.get());
+    for (auto& [geometry, blas] : _geometryBlasMap) uniqueBlas.insert(blas.get());
+
+    auto context = Context::create(_device);
+    context->graphicsQueue = queue;
+    context->commandPool = CommandPool::create(_device, queue->queueFamilyIndex());
+
+    // compile the blas, taking the build commands they add to the Context so they can be recorded in batches
+    struct Build
+    {
+        BottomLevelAccelerationStructure* blas;
+        ref_ptr<BuildAccelerationStructureCommand> command;
+    };
+    std::vector<Build> builds;
+    for (auto blas : uniqueBlas)
+    {
+        size_t numCommands = context->buildAccelerationStructureCommands.size();
+        blas->allowCompaction = compact;
+        blas->compile(*context);
+        if (context->buildAccelerationStructureCommands.size() > numCommands) builds.push_back(Build{blas, context->buildAccelerationStructureCommands.back()});
+    }
+    context->buildAccelerationStructureCommands.clear();
+
+    // complete any data transfers required by the AccelerationGeometry
+    if (context->record()) context->waitForCompletion();
+
+    if (builds.empty()) return 0;
+
+    // scratch regions are aligned to 256 bytes, the largest minAccelerationStructureScratchOffsetAlignment permitted
+    const VkDeviceSize alignment = 256;
+    auto alignedSize = [&](VkDeviceSize size) { return (size + alignment - 1) & ~(alignment - 1); };
+
+    // group builds into batches that each give every build its own region of the shared scratch buffer
+    struct Batch
+    {
+        size_t begin = 0;
+        size_t end = 0;
+        VkDeviceSize scratchSize = 0;
+    };
+    std::vector<Batch> batches;
+    VkDeviceSize scratchBufferSize = 0;
+    for (size_t i = 0; i < builds.size(); ++i)
+    {
+        VkDeviceSize scratchSize = alignedSize(builds[i].blas->requiredScratchSize());
+        if (batches.empty() || (batches.back().scratchSize + scratchSize) > maxBatchScratchSize) batches.push_back(Batch{i, i, 0});
+
+        auto& batch = batches.back();
+        batch.end = i + 1;
+        batch.scratchSize += scratchSize;
+        scratchBufferSize = std::max(scratchBufferSize, batch.scratchSize);
+    }
+
+    auto extensions = _device->getExtensions();
+
+    auto scratchBuffer = vsg::createBufferAndMemory(_device, scratchBufferSize + alignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    VkBufferDeviceAddressInfo scratchAddressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, nullptr, scratchBuffer->vk(_device->deviceID)};
+    VkDeviceAddress scratchAddress = alignedSize(extensions->vkGetBufferDeviceAddressKHR(*_device, &scratchAddressInfo));
+
+    uint32_t numBuilds = static_cast<uint32_t>(builds.size());
+    ref_ptr<QueryPool> queryPool;
+    if (compact)
+    {
+        queryPool = QueryPool::create();
+        queryPool->queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+        queryPool->queryCount = numBuilds;
+        queryPool->compile(*context);
+    }
+
+    submitCommandsToQueue(context->commandPool, queue, [&](CommandBuffer& commandBuffer) {
+        if (queryPool) vkCmdResetQueryPool(commandBuffer, *queryPool, 0, numBuilds);
+
+        std::vector<VkAccelerationStructureBuildGeometryInfoKHR> buildGeometryInfos;
+        std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> buildRangeInfos;
+        for (auto& batch : batches)
+        {
+            buildGeometryInfos.clear();
+            buildRangeInfos.clear();
+
+            VkDeviceSize offset = 0;
+            for (size_t i = batch.begin; i < batch.end; ++i)
+            {
+                auto& command = builds[i].command;
+                buildGeometryInfos.push_back(command->_accelerationStructureInfo);
+                buildGeometryInfos.back().scratchData.deviceAddress = scratchAddress + offset;
+                buildRangeInfos.push_back(command->_accelerationStructureBuildRangeInfos.data());
+                offset += alignedSize(builds[i].blas->requiredScratchSize());
+            }
+
+            extensions->vkCmdBuildAccelerationStructuresKHR(commandBuffer, static_cast<uint32_t>(buildGeometryInfos.size()), buildGeometryInfos.data(), buildRangeInfos.data());
+
+            // the next batch reuses the scratch buffer and the compacted size queries read the built acceleration structures
+            VkMemoryBarrier memoryBarrier;
+            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memoryBarrier.pNext = nullptr;
+            memoryBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+            memoryBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+        }
+
+        if (queryPool)
+        {
+            std::vector<VkAccelerationStructureKHR> accelerationStructures;
+            for (auto& build : builds) accelerationStructures.push_back(*build.blas);
+            extensions->vkCmdWriteAccelerationStructuresPropertiesKHR(commandBuffer, numBuilds, accelerationStructures.data(), VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR, *queryPool, 0);
+        }
+    });
+
+    debug("BuildAccelerationStructureTraversal::buildBottomLevelAccelerationStructures() built ", numBuilds, " bottom level acceleration structures in ", batches.size(), " batches using ", scratchBufferSize, " bytes of scratch memory.");
+
+    if (!queryPool) return 0;
+
+    std::vector<uint64_t> compactedSizes(numBuilds, 0);
+    if (VkResult result = queryPool->getResults(compactedSizes); result != VK_SUCCESS)
+    {
+        warn("BuildAccelerationStructureTraversal::buildBottomLevelAccelerationStructures() unable to read compacted sizes, result = ", result);
+        return 0;
+    }
+
+    VkDeviceSize originalSize = 0;
+    VkDeviceSize compactedSize = 0;
+    submitCommandsToQueue(context->commandPool, queue, [&](CommandBuffer& commandBuffer) {
+        for (uint32_t i = 0; i < numBuilds; ++i)
+        {
+            auto blas = builds[i].blas;
+            originalSize += blas->size();
+            blas->recordCompaction(*context, commandBuffer, compactedSizes[i]);
+            compactedSize += blas->size();
+        }
+    });
+
+    // the copies have completed so the original acceleration structures are no longer required
+    for (auto& build : builds) build.blas->releaseUncompacted();
+
+    info("BuildAccelerationStructureTraversal compacted ", numBuilds, " bottom level acceleration structures from ", originalSize, " to ", compactedSize, " bytes, saving ", originalSize - compactedSize, " bytes.");
+
+    return originalSize - compactedSize;
+}
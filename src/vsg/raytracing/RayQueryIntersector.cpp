@@ -0,0 +1,272 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/PipelineBarrier.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/raytracing/DescriptorAccelerationStructure.h>
+#include <vsg/raytracing/RayQueryIntersector.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/vk/SubmitCommands.h>
+
+#include <cstring>
+#include <limits>
+
+using namespace vsg;
+
+namespace
+{
+    const char* rayQuery_comp = R"(
+#version 460
+#extension GL_EXT_ray_query : require
+
+layout(local_size_x = 64) in;
+
+layout(push_constant) uniform PushConstants
+{
+    uint numSegments;
+    uint cullMask;
+} pc;
+
+layout(set = 0, binding = 0) uniform accelerationStructureEXT tlas;
+layout(std430, set = 0, binding = 1) readonly buffer Segments { vec4 segments[]; };
+layout(std430, set = 0, binding = 2) writeonly buffer Hits { vec4 hits[]; };
+layout(std430, set = 0, binding = 3) writeonly buffer HitIndices { uvec4 hitIndices[]; };
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.numSegments) return;
+
+    vec3 start = segments[i * 2].xyz;
+    vec3 direction = segments[i * 2 + 1].xyz - start;
+
+    // with the unnormalized direction and a tMax of 1.0 the intersection's t is the ratio along the segment
+    rayQueryEXT rayQuery;
+    rayQueryInitializeEXT(rayQuery, tlas, gl_RayFlagsOpaqueEXT, pc.cullMask, start, 0.0, direction, 1.0);
+    while (rayQueryProceedEXT(rayQuery)) {}
+
+    if (rayQueryGetIntersectionTypeEXT(rayQuery, true) == gl_RayQueryCommittedIntersectionTriangleEXT)
+    {
+        vec2 barycentrics = rayQueryGetIntersectionBarycentricsEXT(rayQuery, true);
+        hits[i] = vec4(rayQueryGetIntersectionTEXT(rayQuery, true), barycentrics.x, barycentrics.y, 1.0);
+        hitIndices[i] = uvec4(rayQueryGetIntersectionInstanceIdEXT(rayQuery, true), rayQueryGetIntersectionGeometryIndexEXT(rayQuery, true), rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, true), 0);
+    }
+    else
+    {
+        hits[i] = vec4(0.0);
+    }
+}
+)";
+
+    struct RayQueryPushConstants
+    {
+        uint32_t numSegments;
+        uint32_t cullMask;
+    };
+
+    /// copy the first size bytes of a host visible buffer back to its data
+    bool copyBufferToData(BufferInfo& bufferInfo, uint32_t deviceID, VkDeviceSize size)
+    {
+        auto deviceMemory = bufferInfo.buffer ? bufferInfo.buffer->getDeviceMemory(deviceID) : nullptr;
+        if (!deviceMemory || !bufferInfo.data) return false;
+
+        void* buffer_data = nullptr;
+        VkResult result = deviceMemory->map(bufferInfo.buffer->getMemoryOffset(deviceID) + bufferInfo.offset, size, 0, &buffer_data);
+        if (result != VK_SUCCESS)
+        {
+            warn("RayQueryIntersector cannot read back results. vkMapMemory(..) failed with result = ", result);
+            return false;
+        }
+
+        std::memcpy(bufferInfo.data->dataPointer(), buffer_data, size);
+
+        deviceMemory->unmap();
+        return true;
+    }
+
+    uint32_t vertexIndex(const Data* indices, uint32_t i)
+    {
+        if (auto ushortIndices = indices ? indices->cast<ushortArray>() : nullptr) return ushortIndices->at(i);
+        if (auto uintIndices = indices ? indices->cast<uintArray>() : nullptr) return uintIndices->at(i);
+        return i;
+    }
+} // namespace
+
+RayQueryIntersector::RayQueryIntersector(ref_ptr<Device> in_device, ref_ptr<Queue> in_queue, ref_ptr<TopLevelAccelerationStructure> in_tlas) :
+    device(in_device),
+    queue(in_queue),
+    tlas(in_tlas)
+{
+}
+
+RayQueryIntersector::~RayQueryIntersector()
+{
+}
+
+bool RayQueryIntersector::supported(const Device* device)
+{
+    return device && device->supportsDeviceExtension(VK_KHR_RAY_QUERY_EXTENSION_NAME) && device->supportsDeviceExtension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME);
+}
+
+void RayQueryIntersector::_compile()
+{
+    if (_context) return;
+
+    _context = Context::create(device);
+    _context->commandPool = CommandPool::create(device, queue->queueFamilyIndex());
+    _context->graphicsQueue = queue;
+
+    // build the acceleration structures if they haven't already been compiled
+    tlas->compile(*_context);
+    _context->record();
+    _context->waitForCompletion();
+    _context->buildAccelerationStructureCommands.clear();
+
+    DescriptorSetLayoutBindings bindings{
+        {0, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+    _descriptorSetLayout = DescriptorSetLayout::create(bindings);
+
+    PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(RayQueryPushConstants)}};
+    _pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{_descriptorSetLayout}, pushConstantRanges);
+
+    // ray queries require SPIR-V 1.4
+    auto hints = ShaderCompileSettings::create();
+    hints->vulkanVersion = VK_API_VERSION_1_2;
+    hints->target = ShaderCompileSettings::SPIRV_1_4;
+
+    auto computeShader = ShaderStage::create(VK_SHADER_STAGE_COMPUTE_BIT, "main", rayQuery_comp, hints);
+    _bindPipeline = BindComputePipeline::create(ComputePipeline::create(_pipelineLayout, computeShader));
+    _bindPipeline->compile(*_context);
+}
+
+void RayQueryIntersector::_reserve(uint32_t numSegments)
+{
+    if (numSegments <= _capacity) return;
+
+    // round up to whole workgroups so small changes in the number of segments don't require reallocation
+    _capacity = ((numSegments + workgroupSize - 1) / workgroupSize) * workgroupSize;
+
+    _segments = vec4Array::create(_capacity * 2);
+    _hits = vec4Array::create(_capacity);
+    _hitIndices = uivec4Array::create(_capacity);
+
+    _segmentsInfo = BufferInfo::create(_segments);
+    _hitsInfo = BufferInfo::create(_hits);
+    _hitIndicesInfo = BufferInfo::create(_hitIndices);
+
+    Descriptors descriptors{
+        DescriptorAccelerationStructure::create(AccelerationStructures{tlas}, 0, 0),
+        DescriptorBuffer::create(BufferInfoList{_segmentsInfo}, 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{_hitsInfo}, 2, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{_hitIndicesInfo}, 3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)};
+
+    // DescriptorBuffer::compile(..) allocates host visible memory so the segments can be written and the results read back directly
+    _bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, DescriptorSet::create(_descriptorSetLayout, descriptors));
+    _bindDescriptorSet->compile(*_context);
+}
+
+RayQueryIntersector::Intersections RayQueryIntersector::intersect(const Segments& segments)
+{
+    Intersections intersections(segments.size());
+    if (segments.empty() || !tlas || tlas->geometryInstances.empty()) return intersections;
+
+    if (!supported(device))
+    {
+        warn("RayQueryIntersector::intersect(..) VK_KHR_ray_query not supported.");
+        return intersections;
+    }
+
+    _compile();
+
+    auto numSegments = static_cast<uint32_t>(segments.size());
+    _reserve(numSegments);
+
+    for (uint32_t i = 0; i < numSegments; ++i)
+    {
+        _segments->set(i * 2, vec4(vec3(segments[i].start), 1.0f));
+        _segments->set(i * 2 + 1, vec4(vec3(segments[i].end), 1.0f));
+    }
+    _segmentsInfo->copyDataToBuffer(device->deviceID);
+
+    RayQueryPushConstants pushConstants{numSegments, cullMask};
+
+    // the compute shader's writes must be visible to the host once the fence has signalled
+    auto hostReadBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                                                   MemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT));
+
+    auto fence = Fence::create(device);
+    submitCommandsToQueue(_context->commandPool, fence, std::numeric_limits<uint64_t>::max(), queue, [&](CommandBuffer& commandBuffer) {
+        _bindPipeline->record(commandBuffer);
+        _bindDescriptorSet->record(commandBuffer);
+        vkCmdPushConstants(commandBuffer, _pipelineLayout->vk(commandBuffer.deviceID), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(RayQueryPushConstants), &pushConstants);
+        vkCmdDispatch(commandBuffer, (numSegments + workgroupSize - 1) / workgroupSize, 1, 1);
+        hostReadBarrier->record(commandBuffer);
+    });
+
+    if (!copyBufferToData(*_hitsInfo, device->deviceID, numSegments * sizeof(vec4)) ||
+        !copyBufferToData(*_hitIndicesInfo, device->deviceID, numSegments * sizeof(uivec4)))
+    {
+        return intersections;
+    }
+
+    // map the hits back to the scene graph, recomputing the intersection points in double precision from the barycentric coordinates
+    const auto& geometryInstances = tlas->geometryInstances;
+    for (uint32_t i = 0; i < numSegments; ++i)
+    {
+        const auto& hit = _hits->at(i);
+        if (hit.w == 0.0f) continue;
+
+        const auto& hitIndex = _hitIndices->at(i);
+        if (hitIndex.x >= geometryInstances.size()) continue;
+
+        const auto& geometryInstance = geometryInstances[hitIndex.x];
+        const auto& geometries = geometryInstance->accelerationStructure->geometries;
+        if (hitIndex.y >= geometries.size()) continue;
+
+        const auto& geometry = geometries[hitIndex.y];
+
+        double ratio = hit.x;
+        double r1 = hit.y;
+        double r2 = hit.z;
+        double r0 = 1.0 - r1 - r2;
+
+        dmat4 localToWorld(geometryInstance->transform);
+
+        const auto& segment = segments[i];
+        dvec3 worldIntersection = segment.start + (segment.end - segment.start) * ratio;
+        dvec3 localIntersection = inverse(localToWorld) * worldIntersection;
+
+        IndexRatios indexRatios;
+        if (auto vertices = geometry->verts.cast<vec3Array>())
+        {
+            uint32_t first = hitIndex.z * 3;
+            uint32_t i0 = vertexIndex(geometry->indices, first);
+            uint32_t i1 = vertexIndex(geometry->indices, first + 1);
+            uint32_t i2 = vertexIndex(geometry->indices, first + 2);
+            if (i0 < vertices->size() && i1 < vertices->size() && i2 < vertices->size())
+            {
+                localIntersection = dvec3(vertices->at(i0)) * r0 + dvec3(vertices->at(i1)) * r1 + dvec3(vertices->at(i2)) * r2;
+                worldIntersection = localToWorld * localIntersection;
+                indexRatios = {{i0, r0}, {i1, r1}, {i2, r2}};
+            }
+        }
+
+        intersections[i] = Intersection::create(localIntersection, worldIntersection, ratio, localToWorld, geometryInstance->nodePath, DataList{geometry->verts}, indexRatios, 0);
+    }
+
+    return intersections;
+}
@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/raytracing/TopLevelAccelerationStructure.h>
 
 #include <vsg/io/Options.h>
+#include <vsg/maths/transform.h>
 #include <vsg/vk/CommandBuffer.h>
 #include <vsg/vk/Context.h>
 
@@ -31,17 +32,45 @@ GeometryInstance::GeometryInstance() :
 }
 
 TopLevelAccelerationStructure::TopLevelAccelerationStructure(Device* device) :
-    Inherit(VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR, device)
+    Inherit(VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR, device),
+    _accelerationStructureGeometry{}
 {
 }
 
+ref_ptr<BufferInfo> TopLevelAccelerationStructure::getInstanceBufferInfo()
+{
+    if (!_instanceBufferInfo)
+    {
+        // allocate instances array to size of reference bottom level geoms list
+        _instances = VkGeometryInstanceArray::create(static_cast<uint32_t>(geometryInstances.size()));
+        if (allowUpdate) _instances->properties.dataVariance = DYNAMIC_DATA_TRANSFER_AFTER_RECORD;
+        _instanceBufferInfo = BufferInfo::create(_instances);
+    }
+    return _instanceBufferInfo;
+}
+
+void TopLevelAccelerationStructure::updateInstances()
+{
+    if (!_instances) return;
+
+    // the number of instances is fixed when first compiled
+    uint32_t numInstances = static_cast<uint32_t>(std::min(geometryInstances.size(), _instances->size()));
+    for (uint32_t i = 0; i < numInstances; i++)
+    {
+        auto& geometryInstance = geometryInstances[i];
+        if (!geometryInstance->nodePath.empty()) geometryInstance->transform = mat4(computeTransform(geometryInstance->nodePath));
+        _instances->set(i, *geometryInstance);
+    }
+
+    _instances->dirty();
+}
+
 void TopLevelAccelerationStructure::compile(Context& context)
 {
     if (geometryInstances.empty()) return; // no data
-    if (_instances) return;                // already compiled
+    if (_instanceBuffer) return;           // already compiled
 
-    // allocate instances array to size of reference bottom level geoms list
-    _instances = VkGeometryInstanceArray::create(static_cast<uint32_t>(geometryInstances.size()));
+    getInstanceBufferInfo();
 
     // compile the referenced bottom level acceleration structures and add geom instance to instances array
     for (uint32_t i = 0; i < geometryInstances.size(); i++)
@@ -50,31 +79,75 @@ void TopLevelAccelerationStructure::compile(Context& context)
         _instances->set(i, *geometryInstances[i]);
     }
 
-    DataList dataList = {_instances};
+    // dynamic instance data is updated by the TransferTask so also needs to be a transfer destination
+    VkBufferUsageFlags usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+    if (allowUpdate) usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
+    // the instance BufferInfo may already have been assigned to a TransferTask so compile into it rather than creating a new one
 #if TRANSFER_BUFFERS
-    auto instanceBufferInfo = vsg::createBufferAndTransferData(context, dataList, VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR, VK_SHARING_MODE_EXCLUSIVE);
-    _instanceBuffer = instanceBufferInfo[0].buffer;
+    vsg::createBufferAndTransferData(context, BufferInfoList{_instanceBufferInfo}, usage, VK_SHARING_MODE_EXCLUSIVE);
 #else
-    auto instanceBufferInfo = vsg::createHostVisibleBuffer(context.device, dataList, VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR, VK_SHARING_MODE_EXCLUSIVE);
-    vsg::copyDataListToBuffers(context.device, instanceBufferInfo);
-    _instanceBuffer = instanceBufferInfo[0]->buffer;
+    _instanceBufferInfo->buffer = vsg::createBufferAndMemory(context.device, _instances->dataSize(), usage, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    _instanceBufferInfo->offset = 0;
+    _instanceBufferInfo->range = _instances->dataSize();
+    _instanceBufferInfo->copyDataToBuffer(context.deviceID);
 #endif
+    _instanceBuffer = _instanceBufferInfo->buffer;
+
     auto extensions = _device->getExtensions();
     VkBufferDeviceAddressInfo bufferDeviceAddressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, nullptr, _instanceBuffer->vk(context.deviceID)};
-    VkAccelerationStructureGeometryKHR accelerationStructureGeometry{};
-    accelerationStructureGeometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    accelerationStructureGeometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    accelerationStructureGeometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
-    accelerationStructureGeometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    accelerationStructureGeometry.geometry.instances.arrayOfPointers = VK_FALSE;
-    accelerationStructureGeometry.geometry.instances.data.deviceAddress = extensions->vkGetBufferDeviceAddressKHR(*context.device, &bufferDeviceAddressInfo);
-
+    _accelerationStructureGeometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+    _accelerationStructureGeometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+    _accelerationStructureGeometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+    _accelerationStructureGeometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+    _accelerationStructureGeometry.geometry.instances.arrayOfPointers = VK_FALSE;
+    _accelerationStructureGeometry.geometry.instances.data.deviceAddress = extensions->vkGetBufferDeviceAddressKHR(*context.device, &bufferDeviceAddressInfo) + _instanceBufferInfo->offset;
+
+    if (allowUpdate) _accelerationStructureBuildGeometryInfo.flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
     _accelerationStructureBuildGeometryInfo.geometryCount = 1;
-    _accelerationStructureBuildGeometryInfo.pGeometries = &accelerationStructureGeometry;
+    _accelerationStructureBuildGeometryInfo.pGeometries = &_accelerationStructureGeometry;
     _geometryPrimitiveCounts = {static_cast<uint32_t>(_instances->valueCount())};
 
     Inherit::compile(context);
 
     context.buildAccelerationStructureCommands.push_back(BuildAccelerationStructureCommand::create(context.device, _accelerationStructureBuildGeometryInfo, _accelerationStructure, _geometryPrimitiveCounts));
 }
+
+void TopLevelAccelerationStructure::recordUpdate(CommandBuffer& commandBuffer, Buffer* scratchBuffer, bool rebuild) const
+{
+    if (!_accelerationStructure || !scratchBuffer || _geometryPrimitiveCounts.empty()) return;
+
+    auto device = commandBuffer.getDevice();
+    auto extensions = device->getExtensions();
+
+    VkBufferDeviceAddressInfo scratchAddressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, nullptr, scratchBuffer->vk(device->deviceID)};
+
+    // an update refits the existing acceleration structure in place, a rebuild recreates its hierarchy from the current instance positions
+    VkAccelerationStructureBuildGeometryInfoKHR buildGeometryInfo = _accelerationStructureBuildGeometryInfo;
+    buildGeometryInfo.mode = rebuild ? VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR : VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+    buildGeometryInfo.srcAccelerationStructure = rebuild ? VK_NULL_HANDLE : _accelerationStructure;
+    buildGeometryInfo.dstAccelerationStructure = _accelerationStructure;
+    buildGeometryInfo.geometryCount = 1;
+    buildGeometryInfo.pGeometries = &_accelerationStructureGeometry;
+    buildGeometryInfo.scratchData.deviceAddress = extensions->vkGetBufferDeviceAddressKHR(*device, &scratchAddressInfo);
+
+    VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo{};
+    buildRangeInfo.primitiveCount = _geometryPrimitiveCounts[0];
+    const VkAccelerationStructureBuildRangeInfoKHR* buildRangeInfos = &buildRangeInfo;
+
+    VkMemoryBarrier memoryBarrier;
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.pNext = nullptr;
+
+    // wait for previous traces against the acceleration structure to complete before modifying it
+    memoryBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+    memoryBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+    extensions->vkCmdBuildAccelerationStructuresKHR(commandBuffer, 1, &buildGeometryInfo, &buildRangeInfos);
+
+    // make the updated acceleration structure visible to the traces that follow
+    memoryBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+    memoryBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
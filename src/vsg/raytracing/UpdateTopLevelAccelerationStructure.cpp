@@ -0,0 +1,63 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/raytracing/UpdateTopLevelAccelerationStructure.h>
+#include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/Context.h>
+
+using namespace vsg;
+
+UpdateTopLevelAccelerationStructure::UpdateTopLevelAccelerationStructure(ref_ptr<TopLevelAccelerationStructure> in_accelerationStructure) :
+    accelerationStructure(in_accelerationStructure)
+{
+}
+
+UpdateTopLevelAccelerationStructure::~UpdateTopLevelAccelerationStructure()
+{
+}
+
+void UpdateTopLevelAccelerationStructure::compile(Context& context)
+{
+    if (!accelerationStructure) return;
+
+    if (!accelerationStructure->allowUpdate)
+    {
+        warn("UpdateTopLevelAccelerationStructure::compile() TopLevelAccelerationStructure::allowUpdate must be enabled before compiling, updates disabled.");
+        return;
+    }
+
+    accelerationStructure->compile(context);
+
+    auto& scratchBuffer = _scratchBuffers[context.deviceID];
+    if (scratchBuffer) return;
+
+    // the same scratch buffer is used for both updates and periodic rebuilds
+    VkDeviceSize scratchSize = std::max(accelerationStructure->requiredScratchSize(), accelerationStructure->requiredUpdateScratchSize());
+    if (scratchSize > 0)
+    {
+        scratchBuffer = vsg::createBufferAndMemory(context.device, scratchSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+}
+
+void UpdateTopLevelAccelerationStructure::record(CommandBuffer& commandBuffer) const
+{
+    auto& scratchBuffer = _scratchBuffers[commandBuffer.deviceID];
+    if (!accelerationStructure || !scratchBuffer) return;
+
+    // the instance data is DYNAMIC_DATA_TRANSFER_AFTER_RECORD so changes made here are transferred before the command buffer is executed
+    if (updateInstances) accelerationStructure->updateInstances();
+
+    auto interval = accelerationStructure->rebuildInterval;
+    bool rebuild = interval > 0 && (++_numUpdates % interval) == 0;
+
+    accelerationStructure->recordUpdate(commandBuffer, scratchBuffer, rebuild);
+}
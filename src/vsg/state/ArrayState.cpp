@@ -113,7 +113,8 @@ void ArrayState::applyArrays(uint32_t firstBinding, const BufferInfoList& in_arr
     if (arrays.size() < (in_arrays.size() + firstBinding)) arrays.resize(in_arrays.size() + firstBinding);
     for (size_t i = 0; i < in_arrays.size(); ++i)
     {
-        arrays[firstBinding + i] = in_arrays[i]->data;
+        auto& bufferInfo = in_arrays[i];
+        arrays[firstBinding + i] = (reloadReleasedData && bufferInfo->dataReleased()) ? bufferInfo->reloadData() : bufferInfo->data;
     }
 
     // if the required vertexAttribute is within the new arrays apply the appropriate array to set up the vertices array
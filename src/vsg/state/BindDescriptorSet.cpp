@@ -87,17 +87,25 @@ void BindDescriptorSets::compile(Context& context)
 {
     auto& vkd = _vulkanData[context.deviceID];
 
-    // no need to compile if already compiled
-    if (vkd._vkPipelineLayout != 0 && vkd._vkDescriptorSets.size() == descriptorSets.size()) return;
+    // compile the layout on first use, then make sure the descriptor set handles are current as the DescriptorSets may have been reassigned
+    if (vkd._vkPipelineLayout == 0 || vkd._vkDescriptorSets.size() != descriptorSets.size())
+    {
+        layout->compile(context);
+        vkd._vkPipelineLayout = layout->vk(context.deviceID);
 
-    layout->compile(context);
-    vkd._vkPipelineLayout = layout->vk(context.deviceID);
+        vkd._vkDescriptorSets.resize(descriptorSets.size());
+        vkd._descriptorHeapOffsets.resize(descriptorSets.size());
+    }
 
-    vkd._vkDescriptorSets.resize(descriptorSets.size());
+    vkd._descriptorHeap = {};
     for (size_t i = 0; i < descriptorSets.size(); ++i)
     {
         descriptorSets[i]->compile(context);
-        vkd._vkDescriptorSets[i] = descriptorSets[i]->vk(context.deviceID);
+
+        auto dsi = descriptorSets[i]->getImplementation(context.deviceID);
+        vkd._vkDescriptorSets[i] = dsi->_descriptorSet;
+        vkd._descriptorHeapOffsets[i] = dsi->_descriptorHeapOffset;
+        if (dsi->_descriptorHeap) vkd._descriptorHeap = dsi->_descriptorHeap;
     }
 }
 
@@ -105,6 +113,13 @@ void BindDescriptorSets::record(CommandBuffer& commandBuffer) const
 {
     //info("BindDescriptorSets::record() ", dynamicOffsets.size(), ", ", dynamicOffsets.data());
     auto& vkd = _vulkanData[commandBuffer.deviceID];
+    commandBuffer.recordStatistics.descriptorSetsBound += descriptorSets.size();
+    if (vkd._descriptorHeap)
+    {
+        vkd._descriptorHeap->bind(commandBuffer, pipelineBindPoint, vkd._vkPipelineLayout, firstSet, static_cast<uint32_t>(vkd._descriptorHeapOffsets.size()), vkd._descriptorHeapOffsets.data());
+        return;
+    }
+
     vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, vkd._vkPipelineLayout, firstSet,
                             static_cast<uint32_t>(vkd._vkDescriptorSets.size()), vkd._vkDescriptorSets.data(),
                             static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
@@ -177,20 +192,57 @@ void BindDescriptorSet::compile(Context& context)
 {
     auto& vkd = _vulkanData[context.deviceID];
 
-    // no need to compile if already compiled
-    if (vkd._vkPipelineLayout != 0 && vkd._vkDescriptorSet != 0) return;
+    // compile the layout on first use, then make sure the descriptor set handle is current as the DescriptorSet may have been reassigned
+    if (vkd._vkPipelineLayout == 0)
+    {
+        layout->compile(context);
+        vkd._vkPipelineLayout = layout->vk(context.deviceID);
+    }
 
-    layout->compile(context);
     descriptorSet->compile(context);
 
-    vkd._vkPipelineLayout = layout->vk(context.deviceID);
-    vkd._vkDescriptorSet = descriptorSet->vk(context.deviceID);
+    auto dsi = descriptorSet->getImplementation(context.deviceID);
+    vkd._vkDescriptorSet = dsi->_descriptorSet;
+    vkd._descriptorHeap = dsi->_descriptorHeap;
+    vkd._descriptorHeapOffset = dsi->_descriptorHeapOffset;
+
+    if (bufferRing && descriptorSet->setLayout)
+    {
+        vkd._numDynamicOffsets = 0;
+        for (auto& binding : descriptorSet->setLayout->bindings)
+        {
+            if (binding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) vkd._numDynamicOffsets += binding.descriptorCount;
+        }
+    }
 }
 
 void BindDescriptorSet::record(CommandBuffer& commandBuffer) const
 {
     //info("BindDescriptorSet::record() ", dynamicOffsets.size(), ", ", dynamicOffsets.data());
     auto& vkd = _vulkanData[commandBuffer.deviceID];
+    ++commandBuffer.recordStatistics.descriptorSetsBound;
+    if (vkd._descriptorHeap)
+    {
+        vkd._descriptorHeap->bind(commandBuffer, pipelineBindPoint, vkd._vkPipelineLayout, firstSet, 1, &vkd._descriptorHeapOffset);
+        return;
+    }
+
+    if (bufferRing)
+    {
+        constexpr uint32_t maxDynamicOffsets = 32;
+        uint32_t offsets[maxDynamicOffsets];
+        uint32_t numOffsets = std::min(std::max(static_cast<uint32_t>(dynamicOffsets.size()), vkd._numDynamicOffsets), maxDynamicOffsets);
+
+        uint32_t ringOffset = bufferRing->dynamicOffset();
+        for (uint32_t i = 0; i < numOffsets; ++i)
+        {
+            offsets[i] = ((i < dynamicOffsets.size()) ? dynamicOffsets[i] : 0) + ringOffset;
+        }
+
+        vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, vkd._vkPipelineLayout, firstSet, 1, &(vkd._vkDescriptorSet), numOffsets, offsets);
+        return;
+    }
+
     vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, vkd._vkPipelineLayout, firstSet,
                             1, &(vkd._vkDescriptorSet),
                             static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
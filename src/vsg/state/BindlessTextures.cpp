@@ -0,0 +1,182 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/state/BindlessTextures.h>
+#include <vsg/vk/Context.h>
+
+using namespace vsg;
+
+BindlessTextures::BindlessTextures(uint32_t in_maxTextures, uint32_t in_binding, VkShaderStageFlags in_stageFlags) :
+    maxTextures(in_maxTextures),
+    binding(in_binding)
+{
+    setLayout = DescriptorSetLayout::create(DescriptorSetLayoutBindings{{binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, maxTextures, in_stageFlags, nullptr}});
+    setLayout->flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    setLayout->bindingFlags = {VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT};
+}
+
+BindlessTextures::~BindlessTextures()
+{
+}
+
+uint32_t BindlessTextures::add(ref_ptr<ImageInfo> imageInfo)
+{
+    if (!imageInfo) return maxTextures;
+
+    std::scoped_lock lock(_mutex);
+
+    if (auto itr = _imageInfoSlots.find(imageInfo.get()); itr != _imageInfoSlots.end()) return itr->second;
+
+    uint32_t slot = maxTextures;
+    if (!_freeSlots.empty())
+    {
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+    else if (_slots.size() < maxTextures)
+    {
+        slot = static_cast<uint32_t>(_slots.size());
+        _slots.emplace_back();
+    }
+    else
+    {
+        warn("BindlessTextures::add() all ", maxTextures, " slots are in use.");
+        return maxTextures;
+    }
+
+    // increment the modifiedCount so that reused slots are rewritten on the next compile
+    auto& entry = _slots[slot];
+    entry.imageInfo = imageInfo;
+    ++entry.modifiedCount;
+
+    _imageInfoSlots[imageInfo.get()] = slot;
+    return slot;
+}
+
+uint32_t BindlessTextures::add(ref_ptr<Data> image, ref_ptr<Sampler> sampler)
+{
+    if (!image) return maxTextures;
+
+    if (!sampler) sampler = Sampler::create();
+
+    std::pair<const Data*, const Sampler*> key(image.get(), sampler.get());
+    {
+        std::scoped_lock lock(_mutex);
+        if (auto itr = _imageSlots.find(key); itr != _imageSlots.end()) return itr->second;
+    }
+
+    uint32_t slot = add(ImageInfo::create(sampler, image));
+    if (slot < maxTextures)
+    {
+        std::scoped_lock lock(_mutex);
+        _imageSlots[key] = slot;
+    }
+    return slot;
+}
+
+void BindlessTextures::remove(uint32_t slot)
+{
+    std::scoped_lock lock(_mutex);
+
+    if (slot >= _slots.size() || !_slots[slot].imageInfo) return;
+
+    auto& imageInfo = _slots[slot].imageInfo;
+    _imageInfoSlots.erase(imageInfo.get());
+    for (auto itr = _imageSlots.begin(); itr != _imageSlots.end();)
+    {
+        if (itr->second == slot)
+            itr = _imageSlots.erase(itr);
+        else
+            ++itr;
+    }
+
+    imageInfo = {};
+    _freeSlots.push_back(slot);
+}
+
+ref_ptr<ImageInfo> BindlessTextures::get(uint32_t slot) const
+{
+    std::scoped_lock lock(_mutex);
+    return (slot < _slots.size()) ? _slots[slot].imageInfo : ref_ptr<ImageInfo>();
+}
+
+uint32_t BindlessTextures::count() const
+{
+    std::scoped_lock lock(_mutex);
+    return static_cast<uint32_t>(_slots.size() - _freeSlots.size());
+}
+
+void BindlessTextures::compile(Context& context)
+{
+    // allocate the VkDescriptorSet, it has no Descriptors so the texture array is written below.
+    DescriptorSet::compile(context);
+
+    std::scoped_lock lock(_mutex);
+
+    auto& compiledCounts = _compiledCounts[context.deviceID];
+    if (compiledCounts.size() < _slots.size()) compiledCounts.resize(_slots.size(), 0);
+
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+    imageInfos.reserve(_slots.size());
+    descriptorWrites.reserve(_slots.size());
+
+    for (size_t i = 0; i < _slots.size(); ++i)
+    {
+        auto& [imageInfo, modifiedCount] = _slots[i];
+        if (!imageInfo || compiledCounts[i] == modifiedCount) continue;
+
+        if (imageInfo->sampler) imageInfo->sampler->compile(context);
+        if (imageInfo->imageView)
+        {
+            if (imageInfo->imageView->image->mipLevels == 0)
+            {
+                imageInfo->computeNumMipMapLevels();
+            }
+
+            auto& imageView = *imageInfo->imageView;
+            imageView.compile(context);
+
+            if (imageView.image && imageView.image->syncModifiedCount(context.deviceID))
+            {
+                auto& image = *imageView.image;
+                context.copy(image.data, imageInfo, image.mipLevels);
+
+                auto dataVariance = image.data->properties.dataVariance;
+                if (dataVariance == STATIC_DATA_UNREF_AFTER_TRANSFER || (dataVariance == STATIC_DATA && context.resourceRequirements.releaseDataHint != Options::KEEP_DATA)) image.data = {};
+            }
+        }
+
+        VkDescriptorImageInfo info = {};
+        info.sampler = imageInfo->sampler ? imageInfo->sampler->vk(context.deviceID) : VK_NULL_HANDLE;
+        info.imageView = imageInfo->imageView ? imageInfo->imageView->vk(context.deviceID) : VK_NULL_HANDLE;
+        info.imageLayout = imageInfo->imageLayout;
+        imageInfos.push_back(info);
+
+        VkWriteDescriptorSet wds = {};
+        wds.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        wds.dstBinding = binding;
+        wds.dstArrayElement = static_cast<uint32_t>(i);
+        wds.descriptorCount = 1;
+        wds.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        wds.pImageInfo = &imageInfos.back();
+        descriptorWrites.push_back(wds);
+
+        compiledCounts[i] = modifiedCount;
+    }
+
+    if (!descriptorWrites.empty())
+    {
+        _implementation[context.deviceID]->write(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data());
+    }
+}
@@ -98,8 +98,14 @@ bool Buffer::compile(Device* device)
     vd.device = device;
     vd.size = size;
 
+    VkExternalMemoryBufferCreateInfo externalMemoryInfo = {};
+    externalMemoryInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+    externalMemoryInfo.pNext = nullptr;
+    externalMemoryInfo.handleTypes = externalMemoryHandleTypes;
+
     VkBufferCreateInfo bufferInfo = {};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.pNext = (externalMemoryHandleTypes != 0) ? &externalMemoryInfo : nullptr;
     bufferInfo.flags = flags;
     bufferInfo.size = size;
     bufferInfo.usage = usage;
@@ -113,6 +119,14 @@ bool Buffer::compile(Device* device)
     return true;
 }
 
+VkResult Buffer::allocateAndBindMemory(Device* device, VkMemoryPropertyFlags memoryProperties, void* pNextAllocInfo)
+{
+    auto memRequirements = getMemoryRequirements(device->deviceID);
+    auto memory = (externalMemoryHandleTypes != 0 && !pNextAllocInfo) ? createExportableDeviceMemory(device, memRequirements, memoryProperties, externalMemoryHandleTypes, VK_NULL_HANDLE, vk(device->deviceID))
+                                                                      : DeviceMemory::create(device, memRequirements, memoryProperties, pNextAllocInfo);
+    return bind(memory, 0);
+}
+
 bool Buffer::compile(Context& context)
 {
     return compile(context.device);
@@ -16,9 +16,79 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/state/BufferInfo.h>
 #include <vsg/vk/Context.h>
+#include <vsg/vk/SubmitCommands.h>
+
+#include <limits>
 
 using namespace vsg;
 
+namespace
+{
+    /// write the data of each BufferInfo directly to the host visible memory bound to buffer, assigning the buffer and shifting the offsets to offset within it.
+    /// Returns false without modifying the BufferInfo when the buffer's memory isn't host visible and coherent or can't be mapped.
+    bool writeDirectToBuffer(const BufferInfoList& bufferInfoList, Buffer* buffer, VkDeviceSize bufferOffset, VkDeviceSize totalSize, uint32_t deviceID)
+    {
+        auto deviceMemory = buffer->getDeviceMemory(deviceID);
+        if (!deviceMemory) return false;
+
+        const VkMemoryPropertyFlags requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        if ((deviceMemory->getMemoryPropertyFlags() & requiredFlags) != requiredFlags) return false;
+
+        void* buffer_data = nullptr;
+        if (deviceMemory->map(buffer->getMemoryOffset(deviceID) + bufferOffset, totalSize, 0, &buffer_data) != VK_SUCCESS) return false;
+
+        char* ptr = reinterpret_cast<char*>(buffer_data);
+        for (auto& bufferInfo : bufferInfoList)
+        {
+            bufferInfo->buffer = buffer;
+            if (const Data* data = bufferInfo->data) std::memcpy(ptr + bufferInfo->offset, data->dataPointer(), data->dataSize());
+            bufferInfo->offset += bufferOffset;
+        }
+
+        deviceMemory->unmap();
+        return true;
+    }
+
+    /// return true if data should be released once transferred, either because it's marked STATIC_DATA_UNREF_AFTER_TRANSFER or the ReleaseDataHint selects it.
+    bool releaseAfterTransfer(const Data& data, Options::ReleaseDataHint hint)
+    {
+        auto dataVariance = data.properties.dataVariance;
+        if (dataVariance == STATIC_DATA_UNREF_AFTER_TRANSFER) return true;
+        if (dataVariance != STATIC_DATA) return false;
+        return hint == Options::RELEASE_ALL_DATA || (hint == Options::RELEASE_IMAGE_DATA && data.dimensions() >= 2);
+    }
+
+    /// release the data of BufferInfo entries selected by releaseAfterTransfer() once it's been transferred, retaining an empty prototype of each so it can be reloaded.
+    /// Entries sharing a buffer are repacked from their data when any of them is modified, so nothing is released when the list contains dynamic data.
+    void releaseTransferredData(const BufferInfoList& bufferInfoList, Options::ReleaseDataHint hint)
+    {
+        bool release = false;
+        for (auto& bufferInfo : bufferInfoList)
+        {
+            if (!bufferInfo->data) continue;
+
+            auto dataVariance = bufferInfo->data->properties.dataVariance;
+            if (dataVariance >= DYNAMIC_DATA) return;
+            if (releaseAfterTransfer(*bufferInfo->data, hint)) release = true;
+        }
+
+        if (!release) return;
+
+        for (auto& bufferInfo : bufferInfoList)
+        {
+            if (bufferInfo->data && releaseAfterTransfer(*bufferInfo->data, hint))
+            {
+                bufferInfo->releasedPrototype = createArrayLike(*bufferInfo->data, 0);
+                if (bufferInfo->releasedPrototype) bufferInfo->releasedPrototype->properties = bufferInfo->data->properties;
+                bufferInfo->data = {};
+            }
+        }
+    }
+
+    /// serializes reloads so concurrent intersection traversals don't read back the same BufferInfo twice
+    std::mutex s_reloadMutex;
+} // namespace
+
 /////////////////////////////////////////////////////////////////////////////////////////
 //
 // vsg::BufferInfo
@@ -121,6 +191,74 @@ void BufferInfo::copyDataToBuffer(uint32_t deviceID)
     }
 }
 
+ref_ptr<Data> BufferInfo::reloadData()
+{
+    std::scoped_lock lock(s_reloadMutex);
+
+    if (data) return data;
+    if (!dataReleased() || range == 0) return {};
+
+    // read back from the first device the buffer has been compiled for
+    uint32_t deviceID = 0;
+    while (deviceID < buffer->sizeVulkanData() && !buffer->getDeviceMemory(deviceID)) ++deviceID;
+    if (deviceID >= buffer->sizeVulkanData()) return {};
+
+    auto deviceMemory = buffer->getDeviceMemory(deviceID);
+    auto device = deviceMemory->getDevice();
+
+    auto reloaded = createArrayLike(*releasedPrototype, static_cast<uint32_t>(range / releasedPrototype->valueSize()));
+    if (!reloaded) return {};
+
+    auto readMemory = [&](DeviceMemory* dm, VkDeviceSize memoryOffset) -> bool {
+        void* buffer_data = nullptr;
+        if (dm->map(memoryOffset, reloaded->dataSize(), 0, &buffer_data) != VK_SUCCESS) return false;
+        std::memcpy(reloaded->dataPointer(), buffer_data, reloaded->dataSize());
+        dm->unmap();
+        return true;
+    };
+
+    const VkMemoryPropertyFlags hostFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    if ((deviceMemory->getMemoryPropertyFlags() & hostFlags) == hostFlags)
+    {
+        if (!readMemory(deviceMemory, buffer->getMemoryOffset(deviceID) + offset)) return {};
+    }
+    else
+    {
+        // device local memory so copy to a host visible staging buffer and read back from that
+        ref_ptr<Queue> queue;
+        for (auto& candidate : device->getQueues())
+        {
+            if ((candidate->queueFlags() & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT)) != 0)
+            {
+                queue = candidate;
+                break;
+            }
+        }
+        if (!queue) return {};
+
+        auto stagingBuffer = createBufferAndMemory(device, reloaded->dataSize(), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_SHARING_MODE_EXCLUSIVE, hostFlags);
+        if (!stagingBuffer) return {};
+
+        auto commandPool = CommandPool::create(device, queue->queueFamilyIndex());
+        auto fence = Fence::create(device);
+
+        VkBufferCopy region{offset, 0, reloaded->dataSize()};
+        submitCommandsToQueue(commandPool, fence, std::numeric_limits<uint64_t>::max(), queue, [&](CommandBuffer& commandBuffer) {
+            vkCmdCopyBuffer(commandBuffer, buffer->vk(deviceID), stagingBuffer->vk(deviceID), 1, &region);
+        });
+
+        if (!readMemory(stagingBuffer->getDeviceMemory(deviceID), stagingBuffer->getMemoryOffset(deviceID))) return {};
+    }
+
+    reloaded->properties = releasedPrototype->properties;
+    data = reloaded;
+    releasedPrototype = {};
+
+    debug("BufferInfo::reloadData() ", this, " read back ", data->dataSize(), " bytes");
+
+    return data;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 //
 // vsg::copyDataToStagingBuffer
@@ -132,21 +270,13 @@ ref_ptr<BufferInfo> vsg::copyDataToStagingBuffer(Context& context, const Data* d
     VkDeviceSize imageTotalSize = data->dataSize();
 
     VkDeviceSize alignment = std::max(VkDeviceSize(4), VkDeviceSize(data->valueSize()));
-    auto stagingBufferInfo = context.stagingMemoryBufferPools->reserveBuffer(imageTotalSize, alignment, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    auto stagingBufferInfo = context.writeToStagingBuffer(imageTotalSize, alignment, [&](void* ptr) { std::memcpy(ptr, data->dataPointer(), imageTotalSize); });
+    if (!stagingBufferInfo) return {};
+
     stagingBufferInfo->data = const_cast<Data*>(data);
 
     debug("stagingBufferInfo->buffer ", stagingBufferInfo->buffer.get(), ", ", stagingBufferInfo->offset, ", ", stagingBufferInfo->range, ")");
 
-    ref_ptr<Buffer> imageStagingBuffer(stagingBufferInfo->buffer);
-    ref_ptr<DeviceMemory> imageStagingMemory(imageStagingBuffer->getDeviceMemory(context.deviceID));
-
-    if (!imageStagingMemory) return {};
-
-    // copy data to staging memory
-    imageStagingMemory->copy(imageStagingBuffer->getMemoryOffset(context.deviceID) + stagingBufferInfo->offset, imageTotalSize, data->dataPointer());
-
-    debug("Creating imageStagingBuffer and memory size = ", imageTotalSize);
-
     return stagingBufferInfo;
 }
 
@@ -162,6 +292,12 @@ bool vsg::createBufferAndTransferData(Context& context, const BufferInfoList& bu
 
     auto deviceID = context.deviceID;
 
+    // data released after transfer to another device needs reading back so it can be transferred to this one
+    for (auto& bufferInfo : bufferInfoList)
+    {
+        if (bufferInfo->dataReleased() && !bufferInfo->buffer->getDeviceMemory(deviceID)) bufferInfo->reloadData();
+    }
+
     ref_ptr<BufferInfo> deviceBufferInfo;
     size_t numBuffersRequired = 0;
     bool containsMultipleParents = false;
@@ -196,11 +332,12 @@ bool vsg::createBufferAndTransferData(Context& context, const BufferInfoList& bu
 
     Device* device = context.device;
 
+    // usage may combine buffer types, such as a storage buffer also used as an indirect buffer, so honour the strictest alignment
     VkDeviceSize alignment = 4;
-    if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
-        alignment = device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment;
-    else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
-        alignment = device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment;
+    if ((usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) != 0)
+        alignment = std::max(alignment, device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment);
+    if ((usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) != 0)
+        alignment = std::max(alignment, device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment);
 
     VkDeviceSize totalSize = 0;
     VkDeviceSize offset = 0;
@@ -219,6 +356,8 @@ bool vsg::createBufferAndTransferData(Context& context, const BufferInfoList& bu
     totalSize = offset;
     if (totalSize == 0) return false;
 
+    const VkMemoryPropertyFlags directFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
     if (deviceBufferInfo && deviceBufferInfo->buffer)
     {
         if (totalSize != deviceBufferInfo->range)
@@ -238,15 +377,42 @@ bool vsg::createBufferAndTransferData(Context& context, const BufferInfoList& bu
                 VkMemoryRequirements memRequirements;
                 vkGetBufferMemoryRequirements(*device, deviceBufferInfo->buffer->vk(device->deviceID), &memRequirements);
 
-                auto deviceMemoryOffset = context.deviceMemoryBufferPools->reserveMemory(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                MemoryBufferPools::DeviceMemoryOffset deviceMemoryOffset;
+                if (context.hostVisibleDeviceMemoryBufferPools) deviceMemoryOffset = context.hostVisibleDeviceMemoryBufferPools->reserveMemory(memRequirements, directFlags);
+                if (!deviceMemoryOffset.first) deviceMemoryOffset = context.deviceMemoryBufferPools->reserveMemory(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
                 deviceBufferInfo->buffer->bind(deviceMemoryOffset.first, deviceMemoryOffset.second);
             }
+
+            // buffers bound to host visible memory, such as those from hostVisibleDeviceMemoryBufferPools, are written to directly
+            if (writeDirectToBuffer(bufferInfoList, deviceBufferInfo->buffer, deviceBufferInfo->offset, totalSize, deviceID))
+            {
+                for (auto& bufferInfo : bufferInfoList) bufferInfo->parent = deviceBufferInfo;
+                releaseTransferredData(bufferInfoList, context.resourceRequirements.releaseDataHint);
+                return true;
+            }
         }
     }
 
     if (!deviceBufferInfo)
     {
-        VkBufferUsageFlags bufferUsageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage;
+        // transfer source usage allows the MemoryDefragmenter to relocate the data with GPU copies
+        VkBufferUsageFlags bufferUsageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage;
+
+        // with resizable BAR or unified memory write the data directly to device local memory, skipping the staging buffer and copy
+        if (context.hostVisibleDeviceMemoryBufferPools)
+        {
+            if (auto directBufferInfo = context.hostVisibleDeviceMemoryBufferPools->reserveBuffer(totalSize, alignment, bufferUsageFlags, sharingMode, directFlags))
+            {
+                if (writeDirectToBuffer(bufferInfoList, directBufferInfo->buffer, directBufferInfo->offset, totalSize, deviceID))
+                {
+                    for (auto& bufferInfo : bufferInfoList) bufferInfo->parent = directBufferInfo;
+                    releaseTransferredData(bufferInfoList, context.resourceRequirements.releaseDataHint);
+                    return true;
+                }
+                directBufferInfo->release();
+            }
+        }
+
         deviceBufferInfo = context.deviceMemoryBufferPools->reserveBuffer(totalSize, alignment, bufferUsageFlags, sharingMode, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
     }
 
@@ -259,38 +425,37 @@ bool vsg::createBufferAndTransferData(Context& context, const BufferInfoList& bu
         bufferInfo->offset += deviceBufferInfo->offset;
     }
 
-    auto stagingBufferInfo = context.stagingMemoryBufferPools->reserveBuffer(totalSize, alignment, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, sharingMode, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    auto stagingBufferInfo = context.writeToStagingBuffer(totalSize, alignment, [&](void* buffer_data) {
+        char* ptr = reinterpret_cast<char*>(buffer_data);
 
-    debug("stagingBufferInfo->buffer ", stagingBufferInfo->buffer.get(), ", ", stagingBufferInfo->offset, ", ", stagingBufferInfo->range, ")");
+        debug("    buffer_data ", buffer_data, ", totalSize = ", totalSize);
 
-    ref_ptr<Buffer> stagingBuffer(stagingBufferInfo->buffer);
-    ref_ptr<DeviceMemory> stagingMemory(stagingBuffer->getDeviceMemory(context.deviceID));
+        for (auto& bufferInfo : bufferInfoList)
+        {
+            const Data* data = bufferInfo->data;
+            if (data)
+            {
+                std::memcpy(ptr + bufferInfo->offset - deviceBufferInfo->offset, data->dataPointer(), data->dataSize());
+            }
+        }
+    });
 
-    if (!stagingMemory)
+    if (!stagingBufferInfo)
     {
         return false;
     }
 
-    void* buffer_data;
-    stagingMemory->map(stagingBuffer->getMemoryOffset(context.deviceID) + stagingBufferInfo->offset, stagingBufferInfo->range, 0, &buffer_data);
-    char* ptr = reinterpret_cast<char*>(buffer_data);
-
-    debug("    buffer_data ", buffer_data, ", stagingBufferInfo->offset=", stagingBufferInfo->offset, ", ", totalSize);
+    debug("stagingBufferInfo->buffer ", stagingBufferInfo->buffer.get(), ", ", stagingBufferInfo->offset, ", ", stagingBufferInfo->range, ")");
 
     for (auto& bufferInfo : bufferInfoList)
     {
-        const Data* data = bufferInfo->data;
-        if (data)
-        {
-            std::memcpy(ptr + bufferInfo->offset - deviceBufferInfo->offset, data->dataPointer(), data->dataSize());
-        }
         bufferInfo->parent = deviceBufferInfo;
     }
 
-    stagingMemory->unmap();
-
     context.copy(stagingBufferInfo, deviceBufferInfo);
 
+    releaseTransferredData(bufferInfoList, context.resourceRequirements.releaseDataHint);
+
     return true;
 }
 
@@ -304,11 +469,12 @@ BufferInfoList vsg::createHostVisibleBuffer(Device* device, const DataList& data
 
     BufferInfoList bufferInfoList;
 
+    // usage may combine buffer types, such as a storage buffer also used as an indirect buffer, so honour the strictest alignment
     VkDeviceSize alignment = 4;
-    if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
-        alignment = device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment;
-    else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
-        alignment = device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment;
+    if ((usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) != 0)
+        alignment = std::max(alignment, device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment);
+    if ((usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) != 0)
+        alignment = std::max(alignment, device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment);
 
     VkDeviceSize totalSize = 0;
     VkDeviceSize offset = 0;
@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
 #include <vsg/state/ComputePipeline.h>
+#include <vsg/utils/Instrumentation.h>
 #include <vsg/vk/Context.h>
 
 using namespace vsg;
@@ -68,6 +69,8 @@ void ComputePipeline::compile(Context& context)
 {
     if (!_implementation[context.deviceID])
     {
+        CPU_INSTRUMENTATION_L2_NCO(context.instrumentation, "ComputePipeline compile", COLOR_COMPILE, this);
+
         // compile shaders if required
         bool requiresShaderCompiler = stage && stage->module && stage->module->code.empty() && !(stage->module->source.empty());
 
@@ -108,7 +111,11 @@ ComputePipeline::Implementation::Implementation(Context& context, Device* device
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.pNext = nullptr;
 
-    if (VkResult result = vkCreateComputePipelines(*device, VK_NULL_HANDLE, 1, &pipelineInfo, _device->getAllocationCallbacks(), &_pipeline); result != VK_SUCCESS)
+    // DescriptorSetLayouts are created for use with DescriptorHeap when VK_EXT_descriptor_buffer is enabled
+    if (DescriptorHeap::supported(device)) pipelineInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+    VkPipelineCache pipelineCache = context.pipelineCache ? context.pipelineCache->vk() : VK_NULL_HANDLE;
+    if (VkResult result = vkCreateComputePipelines(*device, pipelineCache, 1, &pipelineInfo, _device->getAllocationCallbacks(), &_pipeline); result != VK_SUCCESS)
     {
         throw Exception{"Error: vsg::ComputePipeline failed to create VkPipeline.", result};
     }
@@ -159,10 +166,11 @@ void BindComputePipeline::write(Output& output) const
 void BindComputePipeline::record(CommandBuffer& commandBuffer) const
 {
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk(commandBuffer.deviceID));
+    ++commandBuffer.recordStatistics.pipelinesBound;
     commandBuffer.setCurrentPipelineLayout(pipeline->layout);
 }
 
 void BindComputePipeline::compile(Context& context)
 {
-    if (pipeline) pipeline->compile(context);
+    if (pipeline && !context.deferCompile(pipeline)) pipeline->compile(context);
 }
@@ -112,6 +112,9 @@ void DescriptorBuffer::compile(Context& context)
         break;
     }
 
+    // with VK_EXT_descriptor_buffer the descriptors are written using the buffer's device address
+    VkBufferUsageFlags deviceAddressUsageFlags = DescriptorHeap::supported(context.device) ? VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT : 0;
+
     bool requiresAssignmentOfBuffers = false;
     for (auto& bufferInfo : bufferInfoList)
     {
@@ -148,7 +151,7 @@ void DescriptorBuffer::compile(Context& context)
         // if required allocate the buffer and reserve slots in it for the BufferInfo
         if (totalSize > 0)
         {
-            auto buffer = vsg::Buffer::create(totalSize, bufferUsageFlags, VK_SHARING_MODE_EXCLUSIVE);
+            auto buffer = vsg::Buffer::create(totalSize, bufferUsageFlags | deviceAddressUsageFlags, VK_SHARING_MODE_EXCLUSIVE);
             for (auto& bufferInfo : bufferInfoList)
             {
                 if (bufferInfo->data && !bufferInfo->buffer)
@@ -119,6 +119,10 @@ void DescriptorImage::compile(Context& context)
             {
                 auto& image = *imageView.image;
                 context.copy(image.data, imageInfo, image.mipLevels);
+
+                // the data has been copied to a staging buffer so can be released if requested
+                auto dataVariance = image.data->properties.dataVariance;
+                if (dataVariance == STATIC_DATA_UNREF_AFTER_TRANSFER || (dataVariance == STATIC_DATA && context.resourceRequirements.releaseDataHint != Options::KEEP_DATA)) image.data = {};
             }
         }
     }
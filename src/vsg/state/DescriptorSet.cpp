@@ -16,9 +16,65 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/state/DescriptorSet.h>
 #include <vsg/vk/Context.h>
+#include <vsg/vk/DescriptorHeap.h>
+
+#include <cstring>
 
 using namespace vsg;
 
+namespace
+{
+    /// pack the descriptor infos of the writes into the layout of the update template's data, returning false if the writes don't
+    /// cover every descriptor of the template's bindings in order, in which case they must be written with vkUpdateDescriptorSets.
+    bool packUpdateTemplateData(const DescriptorSetLayout::UpdateTemplate& updateTemplate, uint32_t descriptorWriteCount, const VkWriteDescriptorSet* descriptorWrites, std::vector<uint8_t>& data, std::vector<uint32_t>& written)
+    {
+        auto& entries = updateTemplate.entries;
+        data.resize(updateTemplate.dataSize);
+        written.assign(entries.size(), 0);
+
+        for (uint32_t i = 0; i < descriptorWriteCount; ++i)
+        {
+            auto& wds = descriptorWrites[i];
+
+            size_t e = 0;
+            while (e < entries.size() && entries[e].dstBinding != wds.dstBinding) ++e;
+            if (e == entries.size()) return false;
+
+            auto& entry = entries[e];
+            if (entry.descriptorType != wds.descriptorType || wds.dstArrayElement != written[e] || (written[e] + wds.descriptorCount) > entry.descriptorCount) return false;
+
+            // the template's entries only use image, buffer and texel buffer view descriptor types
+            const void* src = nullptr;
+            switch (wds.descriptorType)
+            {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                src = wds.pTexelBufferView;
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                src = wds.pBufferInfo;
+                break;
+            default:
+                src = wds.pImageInfo;
+                break;
+            }
+            if (!src) return false;
+
+            std::memcpy(data.data() + entry.offset + entry.stride * wds.dstArrayElement, src, entry.stride * wds.descriptorCount);
+            written[e] += wds.descriptorCount;
+        }
+
+        for (size_t e = 0; e < entries.size(); ++e)
+        {
+            if (written[e] != entries[e].descriptorCount) return false;
+        }
+        return true;
+    }
+} // namespace
+
 DescriptorSet::DescriptorSet()
 {
 }
@@ -84,6 +140,13 @@ void DescriptorSet::release()
     _implementation.clear();
 }
 
+ref_ptr<DescriptorSet::Implementation> DescriptorSet::detach(uint32_t deviceID)
+{
+    ref_ptr<Implementation> dsi;
+    dsi.swap(_implementation[deviceID]);
+    return dsi;
+}
+
 VkDescriptorSet DescriptorSet::vk(uint32_t deviceID) const
 {
     return _implementation[deviceID]->_descriptorSet;
@@ -117,6 +180,18 @@ DescriptorSet::Implementation::Implementation(DescriptorPool* descriptorPool, De
     }
 }
 
+DescriptorSet::Implementation::Implementation(DescriptorHeap* descriptorHeap, DescriptorSetLayout* descriptorSetLayout) :
+    _descriptorHeap(descriptorHeap),
+    _descriptorSetLayout(descriptorSetLayout)
+{
+    auto [reserved, offset] = descriptorHeap->reserve(descriptorSetLayout, _descriptorHeapSize);
+    if (!reserved)
+    {
+        throw Exception{"Error: Failed to allocate DescriptorSet from DescriptorHeap.", VK_ERROR_OUT_OF_POOL_MEMORY};
+    }
+    _descriptorHeapOffset = offset;
+}
+
 DescriptorSet::Implementation::~Implementation()
 {
     if (_descriptorPool && _descriptorSet)
@@ -124,6 +199,8 @@ DescriptorSet::Implementation::~Implementation()
         std::scoped_lock<std::mutex> lock(_descriptorPool->mutex);
         vkFreeDescriptorSets(*(_descriptorPool->getDevice()), *_descriptorPool, 1, &_descriptorSet);
     }
+
+    if (_descriptorHeap) _descriptorHeap->release(_descriptorHeapOffset, _descriptorHeapSize);
 }
 
 void DescriptorSet::Implementation::assign(Context& context, const Descriptors& in_descriptors)
@@ -135,20 +212,50 @@ void DescriptorSet::Implementation::assign(Context& context, const Descriptors&
     for (size_t i = 0; i < in_descriptors.size(); ++i)
     {
         in_descriptors[i]->assignTo(context, descriptorWrites[i]);
-        descriptorWrites[i].dstSet = _descriptorSet;
     }
 
-    auto device = _descriptorPool->getDevice();
-    vkUpdateDescriptorSets(*device, static_cast<uint32_t>(in_descriptors.size()), descriptorWrites, 0, nullptr);
+    write(static_cast<uint32_t>(in_descriptors.size()), descriptorWrites);
 
     // clean up scratch memory so it can be reused.
     context.scratchMemory->release();
 }
 
+void DescriptorSet::Implementation::write(uint32_t descriptorWriteCount, VkWriteDescriptorSet* descriptorWrites)
+{
+    if (_descriptorHeap)
+    {
+        // descriptors are copied straight into the DescriptorHeap's mapped buffer.
+        _descriptorHeap->write(_descriptorSetLayout, _descriptorHeapOffset, descriptorWriteCount, descriptorWrites);
+        return;
+    }
+
+    auto device = _descriptorPool->getDevice();
+
+    // write complete descriptor sets with the layout's update template, avoiding the driver parsing each VkWriteDescriptorSet
+    if (auto updateTemplate = _descriptorSetLayout->getUpdateTemplate(device->deviceID))
+    {
+        thread_local std::vector<uint8_t> data;
+        thread_local std::vector<uint32_t> written;
+        if (packUpdateTemplateData(*updateTemplate, descriptorWriteCount, descriptorWrites, data, written))
+        {
+            device->getExtensions()->vkUpdateDescriptorSetWithTemplate(*device, _descriptorSet, updateTemplate->handle, data.data());
+            return;
+        }
+    }
+
+    for (uint32_t i = 0; i < descriptorWriteCount; ++i)
+    {
+        descriptorWrites[i].dstSet = _descriptorSet;
+    }
+
+    vkUpdateDescriptorSets(*device, descriptorWriteCount, descriptorWrites, 0, nullptr);
+}
+
 void DescriptorSet::Implementation::recycle(ref_ptr<DescriptorSet::Implementation>& dsi)
 {
     if (dsi)
     {
+        // DescriptorHeap allocated implementations release their space in the heap on destruction
         if (dsi->_descriptorPool) dsi->_descriptorPool->freeDescriptorSet(dsi);
         dsi = {};
     }
@@ -62,7 +62,9 @@ int DescriptorSetLayout::compare(const Object& rhs_object) const
     if (result != 0) return result;
 
     auto& rhs = static_cast<decltype(*this)>(rhs_object);
-    return compare_value_container(bindings, rhs.bindings);
+    if ((result = compare_value(flags, rhs.flags))) return result;
+    if ((result = compare_value_container(bindings, rhs.bindings))) return result;
+    return compare_value_container(bindingFlags, rhs.bindingFlags);
 }
 
 void DescriptorSetLayout::read(Input& input)
@@ -78,6 +80,16 @@ void DescriptorSetLayout::read(Input& input)
         input.read("descriptorCount", dslb.descriptorCount);
         input.readValue<uint32_t>("stageFlags", dslb.stageFlags);
     }
+
+    if (input.version_greater_equal(1, 1, 3))
+    {
+        input.readValue<uint32_t>("flags", flags);
+        bindingFlags.resize(input.readValue<uint32_t>("bindingFlags"));
+        for (auto& bindingFlag : bindingFlags)
+        {
+            input.readValue<uint32_t>("bindingFlag", bindingFlag);
+        }
+    }
 }
 
 void DescriptorSetLayout::write(Output& output) const
@@ -93,36 +105,162 @@ void DescriptorSetLayout::write(Output& output) const
         output.write("descriptorCount", dslb.descriptorCount);
         output.writeValue<uint32_t>("stageFlags", dslb.stageFlags);
     }
+
+    if (output.version_greater_equal(1, 1, 3))
+    {
+        output.writeValue<uint32_t>("flags", flags);
+        output.writeValue<uint32_t>("bindingFlags", bindingFlags.size());
+        for (auto& bindingFlag : bindingFlags)
+        {
+            output.writeValue<uint32_t>("bindingFlag", bindingFlag);
+        }
+    }
 }
 
 void DescriptorSetLayout::compile(Context& context)
 {
-    if (!_implementation[context.deviceID]) _implementation[context.deviceID] = DescriptorSetLayout::Implementation::create(context.device, bindings);
+    if (_implementation[context.deviceID]) return;
+
+    auto create = [&]() { return DescriptorSetLayout::Implementation::create(context.device, bindings, flags, bindingFlags); };
+
+    // only share implementations of DescriptorSetLayout itself as subclasses may not serialize all their state
+    if (context.stateCache && type_info() == typeid(DescriptorSetLayout))
+        _implementation[context.deviceID] = context.stateCache->getOrCreate(*this, nullptr, create).cast<Implementation>();
+    else
+        _implementation[context.deviceID] = create();
 }
 
 //////////////////////////////////////
 //
 // DescriptorSetLayout::Implementation
 //
-DescriptorSetLayout::Implementation::Implementation(Device* device, const DescriptorSetLayoutBindings& descriptorSetLayoutBindings) :
+DescriptorSetLayout::Implementation::Implementation(Device* device, const DescriptorSetLayoutBindings& descriptorSetLayoutBindings, VkDescriptorSetLayoutCreateFlags flags, const std::vector<VkDescriptorBindingFlagsEXT>& in_bindingFlags) :
     _device(device)
 {
+    auto bindingFlags = in_bindingFlags;
+    if (DescriptorHeap::supported(device) && (flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR) == 0)
+    {
+        // DescriptorSets are allocated from the DescriptorHeap so layouts must be usable with descriptor buffers,
+        // descriptor buffers can always be written while in use so the update after bind flags aren't required.
+        flags = (flags & ~VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT) | VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        for (auto& bindingFlag : bindingFlags) bindingFlag &= ~VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;
+    }
+
     VkDescriptorSetLayoutCreateInfo layoutInfo = {};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.flags = flags;
     layoutInfo.bindingCount = static_cast<uint32_t>(descriptorSetLayoutBindings.size());
     layoutInfo.pBindings = descriptorSetLayoutBindings.data();
     layoutInfo.pNext = nullptr;
 
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo = {};
+    if (!bindingFlags.empty())
+    {
+        if (bindingFlags.size() != descriptorSetLayoutBindings.size())
+        {
+            throw Exception{"Error: DescriptorSetLayout::bindingFlags must have one entry per binding.", VK_ERROR_INITIALIZATION_FAILED};
+        }
+
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        bindingFlagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+        layoutInfo.pNext = &bindingFlagsInfo;
+    }
+
     if (VkResult result = vkCreateDescriptorSetLayout(*device, &layoutInfo, _device->getAllocationCallbacks(), &_descriptorSetLayout); result != VK_SUCCESS)
     {
         throw Exception{"Error: Failed to create DescriptorSetLayout.", result};
     }
+
+    _createUpdateTemplate(descriptorSetLayoutBindings, flags, bindingFlags);
 }
 
 DescriptorSetLayout::Implementation::~Implementation()
 {
+    if (_updateTemplate.handle)
+    {
+        _device->getExtensions()->vkDestroyDescriptorUpdateTemplate(*_device, _updateTemplate.handle, _device->getAllocationCallbacks());
+    }
+
     if (_descriptorSetLayout)
     {
         vkDestroyDescriptorSetLayout(*_device, _descriptorSetLayout, _device->getAllocationCallbacks());
     }
 }
+
+void DescriptorSetLayout::Implementation::_createUpdateTemplate(const DescriptorSetLayoutBindings& descriptorSetLayoutBindings, VkDescriptorSetLayoutCreateFlags flags, const std::vector<VkDescriptorBindingFlagsEXT>& bindingFlags)
+{
+    auto extensions = _device->getExtensions();
+    if (!extensions->vkCreateDescriptorUpdateTemplate || !extensions->vkUpdateDescriptorSetWithTemplate) return;
+
+    // push descriptors and descriptor buffers are written by other means
+    if ((flags & (VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR | VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT)) != 0) return;
+
+    // a template writes every descriptor of each binding so can't be used when bindings needn't be fully written
+    for (auto& bindingFlag : bindingFlags)
+    {
+        if ((bindingFlag & (VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT)) != 0) return;
+    }
+
+    std::vector<VkDescriptorUpdateTemplateEntry> entries;
+    size_t dataSize = 0;
+    for (auto& binding : descriptorSetLayoutBindings)
+    {
+        if (binding.descriptorCount == 0) continue;
+
+        size_t stride = 0;
+        switch (binding.descriptorType)
+        {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            stride = sizeof(VkDescriptorImageInfo);
+            break;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+            stride = sizeof(VkDescriptorBufferInfo);
+            break;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            stride = sizeof(VkBufferView);
+            break;
+        default:
+            // inline uniform blocks and acceleration structures are passed via pNext so aren't supported
+            return;
+        }
+
+        VkDescriptorUpdateTemplateEntry entry = {};
+        entry.dstBinding = binding.binding;
+        entry.dstArrayElement = 0;
+        entry.descriptorCount = binding.descriptorCount;
+        entry.descriptorType = binding.descriptorType;
+        entry.offset = dataSize;
+        entry.stride = stride;
+        entries.push_back(entry);
+
+        dataSize += stride * binding.descriptorCount;
+    }
+
+    if (entries.empty()) return;
+
+    VkDescriptorUpdateTemplateCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+    createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+    createInfo.pDescriptorUpdateEntries = entries.data();
+    createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    createInfo.descriptorSetLayout = _descriptorSetLayout;
+
+    // leave the UpdateTemplate unassigned on failure so descriptors are written with vkUpdateDescriptorSets
+    if (extensions->vkCreateDescriptorUpdateTemplate(*_device, &createInfo, _device->getAllocationCallbacks(), &_updateTemplate.handle) != VK_SUCCESS)
+    {
+        _updateTemplate.handle = VK_NULL_HANDLE;
+        return;
+    }
+
+    _updateTemplate.entries = std::move(entries);
+    _updateTemplate.dataSize = dataSize;
+}
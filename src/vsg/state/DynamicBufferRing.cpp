@@ -0,0 +1,147 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Exception.h>
+#include <vsg/io/Logger.h>
+#include <vsg/state/DynamicBufferRing.h>
+#include <vsg/vk/Context.h>
+
+#include <cstring>
+
+using namespace vsg;
+
+/////////////////////////////////////////////////////////////////////////
+//
+// DynamicBufferRing
+//
+void DynamicBufferRing::VulkanData::release()
+{
+    if (deviceMemory && data) deviceMemory->unmap();
+    data = nullptr;
+    deviceMemory = {};
+}
+
+DynamicBufferRing::DynamicBufferRing(VkDeviceSize in_sliceSize, uint32_t in_numSlices, VkBufferUsageFlags in_usage) :
+    sliceSize(((in_sliceSize + alignment - 1) / alignment) * alignment),
+    numSlices(std::max(in_numSlices, 1u)),
+    usage(in_usage)
+{
+    _buffer = Buffer::create(sliceSize * numSlices, usage, VK_SHARING_MODE_EXCLUSIVE);
+}
+
+DynamicBufferRing::~DynamicBufferRing()
+{
+    for (size_t i = 0; i < _vulkanData.size(); ++i)
+    {
+        _vulkanData[i].release();
+    }
+}
+
+ref_ptr<BufferInfo> DynamicBufferRing::add(ref_ptr<Data> data)
+{
+    if (!data) return {};
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    VkDeviceSize size = data->dataSize();
+    if (_used + size > sliceSize)
+    {
+        warn("DynamicBufferRing::add(..) unable to allocate ", size, " bytes, ", sliceSize - _used, " bytes remaining of sliceSize ", sliceSize);
+        return {};
+    }
+
+    auto bufferInfo = BufferInfo::create(data);
+    bufferInfo->buffer = _buffer;
+    bufferInfo->offset = _used;
+    bufferInfo->range = size;
+
+    _used = ((_used + size + alignment - 1) / alignment) * alignment;
+    _entries.push_back(Entry{bufferInfo, std::vector<ModifiedCount>(numSlices)});
+
+    return bufferInfo;
+}
+
+void DynamicBufferRing::_copy(uint32_t slice, BufferInfo& bufferInfo)
+{
+    for (size_t deviceID = 0; deviceID < _vulkanData.size(); ++deviceID)
+    {
+        auto& vd = _vulkanData[deviceID];
+        if (vd.data) std::memcpy(vd.data + slice * sliceSize + bufferInfo.offset, bufferInfo.data->dataPointer(), bufferInfo.range);
+    }
+}
+
+void DynamicBufferRing::advance()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    _currentSlice = (_currentSlice + 1) % numSlices;
+
+    for (auto& entry : _entries)
+    {
+        if (entry.bufferInfo->data->getModifiedCount(entry.copiedModifiedCounts[_currentSlice])) _copy(_currentSlice, *entry.bufferInfo);
+    }
+}
+
+void DynamicBufferRing::compile(Context& context)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    auto deviceID = context.deviceID;
+    auto& vd = _vulkanData[deviceID];
+    if (vd.data) return;
+
+    _buffer->compile(context.device);
+
+    // dedicated memory is required as memory from MemoryBufferPools is mapped and unmapped by other buffers sharing it
+    auto memRequirements = _buffer->getMemoryRequirements(deviceID);
+    vd.deviceMemory = DeviceMemory::create(context.device, memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (auto [allocated, offset] = vd.deviceMemory->reserve(memRequirements.size); !allocated || _buffer->bind(vd.deviceMemory, offset) != VK_SUCCESS)
+    {
+        throw Exception{"Error: DynamicBufferRing::compile(..) failed to allocate buffer memory.", VK_ERROR_OUT_OF_DEVICE_MEMORY};
+    }
+
+    void* data = nullptr;
+    if (VkResult result = vd.deviceMemory->map(_buffer->getMemoryOffset(deviceID), _buffer->size, 0, &data); result != VK_SUCCESS)
+    {
+        throw Exception{"Error: DynamicBufferRing::compile(..) failed to map buffer memory.", result};
+    }
+    vd.data = static_cast<uint8_t*>(data);
+
+    for (auto& entry : _entries)
+    {
+        for (uint32_t slice = 0; slice < numSlices; ++slice)
+        {
+            std::memcpy(vd.data + slice * sliceSize + entry.bufferInfo->offset, entry.bufferInfo->data->dataPointer(), entry.bufferInfo->range);
+            entry.bufferInfo->data->getModifiedCount(entry.copiedModifiedCounts[slice]);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// DynamicDescriptorBuffer
+//
+DynamicDescriptorBuffer::DynamicDescriptorBuffer(ref_ptr<DynamicBufferRing> in_bufferRing, ref_ptr<Data> data, uint32_t dstBinding, uint32_t dstArrayElement, VkDescriptorType descriptorType) :
+    Inherit(BufferInfoList{in_bufferRing->add(data)}, dstBinding, dstArrayElement, descriptorType),
+    bufferRing(in_bufferRing)
+{
+}
+
+DynamicDescriptorBuffer::~DynamicDescriptorBuffer()
+{
+}
+
+void DynamicDescriptorBuffer::compile(Context& context)
+{
+    // the ring manages the buffer's memory and copying of data, so DescriptorBuffer::compile isn't required
+    bufferRing->compile(context);
+}
@@ -0,0 +1,81 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/compare.h>
+#include <vsg/io/Options.h>
+#include <vsg/state/FragmentShadingRateState.h>
+#include <vsg/vk/Context.h>
+
+using namespace vsg;
+
+FragmentShadingRateState::FragmentShadingRateState(const VkExtent2D& in_fragmentSize) :
+    fragmentSize(in_fragmentSize)
+{
+}
+
+FragmentShadingRateState::FragmentShadingRateState(const FragmentShadingRateState& fsrs) :
+    Inherit(fsrs),
+    fragmentSize(fsrs.fragmentSize)
+{
+    combinerOps[0] = fsrs.combinerOps[0];
+    combinerOps[1] = fsrs.combinerOps[1];
+}
+
+FragmentShadingRateState::~FragmentShadingRateState()
+{
+}
+
+int FragmentShadingRateState::compare(const Object& rhs_object) const
+{
+    int result = GraphicsPipelineState::compare(rhs_object);
+    if (result != 0) return result;
+
+    auto& rhs = static_cast<decltype(*this)>(rhs_object);
+    if ((result = compare_value(fragmentSize.width, rhs.fragmentSize.width))) return result;
+    if ((result = compare_value(fragmentSize.height, rhs.fragmentSize.height))) return result;
+    if ((result = compare_value(combinerOps[0], rhs.combinerOps[0]))) return result;
+    return compare_value(combinerOps[1], rhs.combinerOps[1]);
+}
+
+void FragmentShadingRateState::read(Input& input)
+{
+    GraphicsPipelineState::read(input);
+
+    input.read("fragmentWidth", fragmentSize.width);
+    input.read("fragmentHeight", fragmentSize.height);
+    input.readValue<uint32_t>("primitiveCombinerOp", combinerOps[0]);
+    input.readValue<uint32_t>("attachmentCombinerOp", combinerOps[1]);
+}
+
+void FragmentShadingRateState::write(Output& output) const
+{
+    GraphicsPipelineState::write(output);
+
+    output.write("fragmentWidth", fragmentSize.width);
+    output.write("fragmentHeight", fragmentSize.height);
+    output.writeValue<uint32_t>("primitiveCombinerOp", combinerOps[0]);
+    output.writeValue<uint32_t>("attachmentCombinerOp", combinerOps[1]);
+}
+
+void FragmentShadingRateState::apply(Context& context, VkGraphicsPipelineCreateInfo& pipelineInfo) const
+{
+    auto fragmentShadingRateState = context.scratchMemory->allocate<VkPipelineFragmentShadingRateStateCreateInfoKHR>();
+
+    fragmentShadingRateState->sType = VK_STRUCTURE_TYPE_PIPELINE_FRAGMENT_SHADING_RATE_STATE_CREATE_INFO_KHR;
+    fragmentShadingRateState->fragmentSize = fragmentSize;
+    fragmentShadingRateState->combinerOps[0] = combinerOps[0];
+    fragmentShadingRateState->combinerOps[1] = combinerOps[1];
+
+    // chain on to any existing extension structures, such as the VkPipelineRenderingCreateInfo used for dynamic rendering
+    fragmentShadingRateState->pNext = pipelineInfo.pNext;
+    pipelineInfo.pNext = fragmentShadingRateState;
+}
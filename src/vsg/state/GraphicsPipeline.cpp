@@ -15,7 +15,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
 #include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/GraphicsPipelineLibrary.h>
+#include <vsg/state/SetDynamicState.h>
 #include <vsg/state/ViewportState.h>
+#include <vsg/utils/Instrumentation.h>
 #include <vsg/vk/Context.h>
 
 using namespace vsg;
@@ -77,6 +80,33 @@ void vsg::mergeGraphicsPipelineStates(Mask mask, GraphicsPipelineStates& dest_Pi
     }
 }
 
+////////////////////////////////////////////////////////////////////////
+//
+// GraphicsPipeline::LinkOptimizedOperation
+//
+struct GraphicsPipeline::LinkOptimizedOperation : public Inherit<Operation, LinkOptimizedOperation>
+{
+    explicit LinkOptimizedOperation(ref_ptr<Implementation> in_implementation) :
+        implementation(in_implementation) {}
+
+    // doesn't reference the GraphicsPipelineLibrary as it owns the OperationThreads running this operation
+    ref_ptr<Implementation> implementation;
+
+    void run() override
+    {
+        try
+        {
+            VkPipelineCache pipelineCache = implementation->_pipelineCache ? implementation->_pipelineCache->vk() : VK_NULL_HANDLE;
+            auto pipelineLayout = implementation->_pipelineLayout->vk(implementation->_device->deviceID);
+            implementation->_pipeline.store(GraphicsPipelineLibrary::link(implementation->_device, implementation->_libraryParts, implementation->_flags, pipelineLayout, pipelineCache, true));
+        }
+        catch (const Exception& exception)
+        {
+            warn(exception.message, " Continuing with fast linked pipeline.");
+        }
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////
 //
 // GraphicsPipeline
@@ -140,6 +170,20 @@ void GraphicsPipeline::compile(Context& context)
 
     if (!_implementation[viewID])
     {
+        CPU_INSTRUMENTATION_L2_NCO(context.instrumentation, "GraphicsPipeline compile", COLOR_COMPILE, this);
+
+        _usesSetDynamicState = false;
+        for (auto& pipelineState : pipelineStates)
+        {
+            if (auto dynamicState = pipelineState.cast<DynamicState>())
+            {
+                for (auto state : dynamicState->dynamicStates)
+                {
+                    if (SetDynamicState::supported(state)) _usesSetDynamicState = true;
+                }
+            }
+        }
+
         // compile shaders if required
         bool requiresShaderCompiler = false;
         for (auto& shaderStage : stages)
@@ -180,7 +224,32 @@ void GraphicsPipeline::compile(Context& context)
         mergeGraphicsPipelineStates(context.mask, combined_pipelineStates, pipelineStates);
         mergeGraphicsPipelineStates(context.mask, combined_pipelineStates, context.overridePipelineStates);
 
-        _implementation[viewID] = GraphicsPipeline::Implementation::create(context, context.device, context.renderPass, layout, stages, combined_pipelineStates, subpass);
+        auto create = [&]() {
+            auto implementation = GraphicsPipeline::Implementation::create(context, context.device, context.renderPass, layout, stages, combined_pipelineStates, subpass);
+
+            // replace the fast linked pipeline with a link time optimized one in the background
+            if (implementation->_fastLinkedPipeline) context.graphicsPipelineLibrary->operationThreads->add(LinkOptimizedOperation::create(implementation));
+            return implementation;
+        };
+
+        if (context.stateCache && type_info() == typeid(GraphicsPipeline))
+        {
+            // the pipeline is created from the merged Context and GraphicsPipeline state so share implementations based on that, within the RenderPass it's created for
+            ShaderStages activeStages;
+            for (auto& shaderStage : stages)
+            {
+                if ((context.mask & shaderStage->mask) != 0) activeStages.push_back(shaderStage);
+            }
+            auto combined = GraphicsPipeline::create(layout, activeStages, combined_pipelineStates, subpass);
+
+            // dynamic rendering replaces the RenderPass with the VkPipelineRenderingCreateInfo, and the fragment shading rate attachment adds a create flag, so keep these variants apart
+            uint32_t variant = (context.dynamicRendering ? 1u : 0u) | (context.fragmentShadingRateAttachment ? 2u : 0u);
+            _implementation[viewID] = context.stateCache->getOrCreate(*combined, context.renderPass, create, variant).cast<Implementation>();
+        }
+        else
+        {
+            _implementation[viewID] = create();
+        }
     }
 }
 
@@ -199,6 +268,49 @@ GraphicsPipeline::Implementation::Implementation(Context& context, Device* devic
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.pNext = nullptr;
 
+    // DescriptorSetLayouts are created for use with DescriptorHeap when VK_EXT_descriptor_buffer is enabled
+    if (DescriptorHeap::supported(device)) pipelineInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+    VkPipelineRenderingCreateInfoKHR renderingInfo = {};
+    if (context.dynamicRendering && renderPass && !renderPass->subpasses.empty())
+    {
+        // with dynamic rendering the RenderPass just describes the attachment formats of the subpass being rendered
+        const auto& subpassDescription = renderPass->subpasses[std::min(static_cast<size_t>(subpass), renderPass->subpasses.size() - 1)];
+        auto attachmentFormat = [&](const AttachmentReference& reference) {
+            return (reference.attachment < renderPass->attachments.size()) ? renderPass->attachments[reference.attachment].format : VK_FORMAT_UNDEFINED;
+        };
+
+        auto colorAttachmentFormats = context.scratchMemory->allocate<VkFormat>(subpassDescription.colorAttachments.size());
+        for (size_t c = 0; c < subpassDescription.colorAttachments.size(); ++c)
+        {
+            colorAttachmentFormats[c] = attachmentFormat(subpassDescription.colorAttachments[c]);
+        }
+
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+        renderingInfo.viewMask = subpassDescription.viewMask;
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(subpassDescription.colorAttachments.size());
+        renderingInfo.pColorAttachmentFormats = colorAttachmentFormats;
+        renderingInfo.depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+        renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+        if (!subpassDescription.depthStencilAttachments.empty())
+        {
+            auto depthFormat = attachmentFormat(subpassDescription.depthStencilAttachments.front());
+            auto aspectMask = computeAspectFlagsForFormat(depthFormat);
+            if ((aspectMask & VK_IMAGE_ASPECT_DEPTH_BIT) != 0) renderingInfo.depthAttachmentFormat = depthFormat;
+            if ((aspectMask & VK_IMAGE_ASPECT_STENCIL_BIT) != 0) renderingInfo.stencilAttachmentFormat = depthFormat;
+        }
+
+        pipelineInfo.renderPass = VK_NULL_HANDLE;
+        pipelineInfo.subpass = 0;
+        pipelineInfo.pNext = &renderingInfo;
+
+        if (context.fragmentShadingRateAttachment || !subpassDescription.fragmentShadingRateAttachments.empty())
+        {
+            pipelineInfo.flags |= VK_PIPELINE_CREATE_RENDERING_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR;
+        }
+    }
+
     auto shaderStageCreateInfo = context.scratchMemory->allocate<VkPipelineShaderStageCreateInfo>(shaderStages.size());
     uint32_t i = 0;
     for (auto& shaderStage : shaderStages)
@@ -221,7 +333,36 @@ GraphicsPipeline::Implementation::Implementation(Context& context, Device* devic
         pipelineState->apply(context, pipelineInfo);
     }
 
-    VkResult result = vkCreateGraphicsPipelines(*device, VK_NULL_HANDLE, 1, &pipelineInfo, _device->getAllocationCallbacks(), &_pipeline);
+    VkPipelineCache pipelineCache = context.pipelineCache ? context.pipelineCache->vk() : VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult result = VK_SUCCESS;
+
+    if (context.graphicsPipelineLibrary)
+    {
+        ShaderStages activeShaderStages;
+        for (auto& shaderStage : shaderStages)
+        {
+            if ((context.mask & shaderStage->mask) != 0) activeShaderStages.push_back(shaderStage);
+        }
+
+        try
+        {
+            _fastLinkedPipeline = context.graphicsPipelineLibrary->createFastLinked(pipelineInfo, pipelineLayout, renderPass, activeShaderStages, pipelineStates, pipelineCache, _libraryParts);
+        }
+        catch (const Exception& exception)
+        {
+            warn(exception.message, " Falling back to monolithic pipeline creation.");
+            _libraryParts.clear();
+        }
+
+        pipeline = _fastLinkedPipeline;
+        _flags = pipelineInfo.flags;
+        _pipelineLayout = pipelineLayout;
+        _pipelineCache = context.pipelineCache;
+    }
+
+    if (!pipeline) result = vkCreateGraphicsPipelines(*device, pipelineCache, 1, &pipelineInfo, _device->getAllocationCallbacks(), &pipeline);
+    _pipeline.store(pipeline);
 
     context.scratchMemory->release();
 
@@ -233,7 +374,9 @@ GraphicsPipeline::Implementation::Implementation(Context& context, Device* devic
 
 GraphicsPipeline::Implementation::~Implementation()
 {
-    vkDestroyPipeline(*_device, _pipeline, _device->getAllocationCallbacks());
+    VkPipeline pipeline = _pipeline.load();
+    vkDestroyPipeline(*_device, pipeline, _device->getAllocationCallbacks());
+    if (_fastLinkedPipeline && _fastLinkedPipeline != pipeline) vkDestroyPipeline(*_device, _fastLinkedPipeline, _device->getAllocationCallbacks());
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -256,7 +399,8 @@ int BindGraphicsPipeline::compare(const Object& rhs_object) const
     if (result != 0) return result;
 
     auto& rhs = static_cast<decltype(*this)>(rhs_object);
-    return compare_pointer(pipeline, rhs.pipeline);
+    if ((result = compare_pointer(pipeline, rhs.pipeline))) return result;
+    return compare_pointer(fallbackPipeline, rhs.fallbackPipeline);
 }
 
 void BindGraphicsPipeline::read(Input& input)
@@ -264,6 +408,11 @@ void BindGraphicsPipeline::read(Input& input)
     StateCommand::read(input);
 
     input.readObject("pipeline", pipeline);
+
+    if (input.version_greater_equal(1, 1, 6))
+    {
+        input.readObject("fallbackPipeline", fallbackPipeline);
+    }
 }
 
 void BindGraphicsPipeline::write(Output& output) const
@@ -271,20 +420,34 @@ void BindGraphicsPipeline::write(Output& output) const
     StateCommand::write(output);
 
     output.writeObject("pipeline", pipeline);
+
+    if (output.version_greater_equal(1, 1, 6))
+    {
+        output.writeObject("fallbackPipeline", fallbackPipeline);
+    }
 }
 
 void BindGraphicsPipeline::record(CommandBuffer& commandBuffer) const
 {
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk(commandBuffer.viewID));
-    commandBuffer.setCurrentPipelineLayout(pipeline->layout);
+    auto& boundPipeline = (fallbackPipeline && pipeline->pending()) ? fallbackPipeline : pipeline;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, boundPipeline->vk(commandBuffer.viewID));
+    ++commandBuffer.recordStatistics.pipelinesBound;
+    commandBuffer.setCurrentPipelineLayout(boundPipeline->layout);
+
+    // state baked into a pipeline replaces the dynamic state recorded before it was bound, so SetDynamicState has to be recorded again
+    if (!boundPipeline->usesSetDynamicState()) commandBuffer.resetRecordedStateCommand(SetDynamicState::dynamicStateSlot);
 }
 
 void BindGraphicsPipeline::compile(Context& context)
 {
-    if (pipeline) pipeline->compile(context);
+    // the fallbackPipeline has to be available as soon as the subgraph is merged so is never deferred
+    if (fallbackPipeline) fallbackPipeline->compile(context);
+
+    if (pipeline && !context.deferCompile(pipeline)) pipeline->compile(context);
 }
 
 void BindGraphicsPipeline::release()
 {
     if (pipeline) pipeline->release();
+    if (fallbackPipeline) fallbackPipeline->release();
 }
@@ -0,0 +1,248 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Exception.h>
+#include <vsg/core/compare.h>
+#include <vsg/core/observer_ptr.h>
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DepthStencilState.h>
+#include <vsg/state/GraphicsPipelineLibrary.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/MultisampleState.h>
+#include <vsg/state/RasterizationState.h>
+#include <vsg/state/TessellationState.h>
+#include <vsg/state/VertexInputState.h>
+#include <vsg/state/ViewportState.h>
+
+using namespace vsg;
+
+static constexpr VkGraphicsPipelineLibraryFlagsEXT s_allLibraryParts = VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT |
+                                                                       VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+// return the library parts that a GraphicsPipelineState contributes to
+static VkGraphicsPipelineLibraryFlagsEXT s_libraryParts(const GraphicsPipelineState* state)
+{
+    if (state->cast<VertexInputState>() || state->cast<InputAssemblyState>()) return VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+    if (state->cast<ViewportState>() || state->cast<RasterizationState>() || state->cast<TessellationState>()) return VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+    if (state->cast<DepthStencilState>()) return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+    if (state->cast<MultisampleState>()) return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+    if (state->cast<ColorBlendState>()) return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+    // DynamicState and user defined states may affect any of the parts
+    return s_allLibraryParts;
+}
+
+////////////////////////////////////////////////////////////////////////
+//
+// GraphicsPipelineLibraryPart
+//
+GraphicsPipelineLibraryPart::GraphicsPipelineLibraryPart(Device* in_device, VkGraphicsPipelineLibraryFlagsEXT in_flags, VkPipeline in_pipeline) :
+    flags(in_flags),
+    _pipeline(in_pipeline),
+    _device(in_device)
+{
+}
+
+GraphicsPipelineLibraryPart::~GraphicsPipelineLibraryPart()
+{
+    vkDestroyPipeline(_device->vk(), _pipeline, _device->getAllocationCallbacks());
+}
+
+////////////////////////////////////////////////////////////////////////
+//
+// GraphicsPipelineLibrary
+//
+bool GraphicsPipelineLibrary::PartKey::operator<(const PartKey& rhs) const
+{
+    if (flags != rhs.flags) return flags < rhs.flags;
+    if (pipelineFlags != rhs.pipelineFlags) return pipelineFlags < rhs.pipelineFlags;
+    if (layout != rhs.layout) return layout < rhs.layout;
+    if (renderPass != rhs.renderPass) return renderPass < rhs.renderPass;
+    if (subpass != rhs.subpass) return subpass < rhs.subpass;
+    if (colorAttachmentFormats != rhs.colorAttachmentFormats) return colorAttachmentFormats < rhs.colorAttachmentFormats;
+    if (depthAttachmentFormat != rhs.depthAttachmentFormat) return depthAttachmentFormat < rhs.depthAttachmentFormat;
+    if (stencilAttachmentFormat != rhs.stencilAttachmentFormat) return stencilAttachmentFormat < rhs.stencilAttachmentFormat;
+    if (viewMask != rhs.viewMask) return viewMask < rhs.viewMask;
+    return compare_pointer_container(objects, rhs.objects) < 0;
+}
+
+GraphicsPipelineLibrary::GraphicsPipelineLibrary(Device* in_device) :
+    operationThreads(OperationThreads::create(1)),
+    _device(in_device)
+{
+    if (!supported(_device))
+    {
+        throw Exception{"Error: vsg::GraphicsPipelineLibrary requires a Device created with VK_EXT_graphics_pipeline_library enabled.", VK_ERROR_EXTENSION_NOT_PRESENT};
+    }
+}
+
+GraphicsPipelineLibrary::~GraphicsPipelineLibrary()
+{
+}
+
+bool GraphicsPipelineLibrary::supported(const Device* device)
+{
+    return device && device->supportsDeviceExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+}
+
+ref_ptr<GraphicsPipelineLibrary> GraphicsPipelineLibrary::getOrCreate(Device* device)
+{
+    static std::mutex s_mutex;
+    static std::vector<observer_ptr<GraphicsPipelineLibrary>> s_graphicsPipelineLibraries;
+
+    std::scoped_lock<std::mutex> lock(s_mutex);
+
+    if (s_graphicsPipelineLibraries.size() <= device->deviceID) s_graphicsPipelineLibraries.resize(device->deviceID + 1);
+
+    auto graphicsPipelineLibrary = s_graphicsPipelineLibraries[device->deviceID].ref_ptr();
+    if (!graphicsPipelineLibrary || graphicsPipelineLibrary->getDevice() != device)
+    {
+        graphicsPipelineLibrary = GraphicsPipelineLibrary::create(device);
+        s_graphicsPipelineLibraries[device->deviceID] = graphicsPipelineLibrary;
+    }
+    return graphicsPipelineLibrary;
+}
+
+size_t GraphicsPipelineLibrary::numParts() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _parts.size();
+}
+
+void GraphicsPipelineLibrary::clear()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _parts.clear();
+}
+
+VkPipeline GraphicsPipelineLibrary::createFastLinked(const VkGraphicsPipelineCreateInfo& pipelineInfo, const PipelineLayout* pipelineLayout, const RenderPass* renderPass, const ShaderStages& shaderStages, const GraphicsPipelineStates& pipelineStates, VkPipelineCache pipelineCache, GraphicsPipelineLibraryParts& parts)
+{
+    // mesh shading pipelines don't have a vertex input interface, so leave them to be created as a monolithic pipeline
+    for (auto& shaderStage : shaderStages)
+    {
+        if ((shaderStage->stage & (VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT)) != 0) return VK_NULL_HANDLE;
+    }
+
+    // with dynamic rendering pipelineInfo.renderPass is null and the attachment formats are provided by a VkPipelineRenderingCreateInfo in the pNext chain
+    const VkPipelineRenderingCreateInfoKHR* renderingInfo = nullptr;
+    for (auto next = static_cast<const VkBaseInStructure*>(pipelineInfo.pNext); next; next = next->pNext)
+    {
+        if (next->sType == VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR) renderingInfo = reinterpret_cast<const VkPipelineRenderingCreateInfoKHR*>(next);
+    }
+
+    parts.clear();
+    for (VkGraphicsPipelineLibraryFlagsEXT partFlags : {VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT, VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+                                                        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT, VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT})
+    {
+        PartKey key{partFlags, pipelineInfo.flags, ref_ptr<const PipelineLayout>(pipelineLayout), {}, pipelineInfo.subpass, {}, VK_FORMAT_UNDEFINED, VK_FORMAT_UNDEFINED, 0, {}};
+        if (pipelineInfo.renderPass != VK_NULL_HANDLE) key.renderPass = renderPass;
+        if (renderingInfo)
+        {
+            key.colorAttachmentFormats.assign(renderingInfo->pColorAttachmentFormats, renderingInfo->pColorAttachmentFormats + renderingInfo->colorAttachmentCount);
+            key.depthAttachmentFormat = renderingInfo->depthAttachmentFormat;
+            key.stencilAttachmentFormat = renderingInfo->stencilAttachmentFormat;
+            key.viewMask = renderingInfo->viewMask;
+        }
+
+        // the fragment shader stage belongs to the fragment shader part, all other stages to the pre-rasterization shaders part
+        ShaderStages partStages;
+        for (auto& shaderStage : shaderStages)
+        {
+            bool fragment = shaderStage->stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+            if ((fragment && partFlags == VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) || (!fragment && partFlags == VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT))
+            {
+                partStages.push_back(shaderStage);
+                key.objects.emplace_back(shaderStage);
+            }
+        }
+
+        for (auto& pipelineState : pipelineStates)
+        {
+            if ((s_libraryParts(pipelineState) & partFlags) != 0) key.objects.emplace_back(pipelineState);
+        }
+
+        parts.push_back(_getOrCreatePart(key, pipelineInfo, partStages, pipelineCache));
+    }
+
+    return link(_device, parts, pipelineInfo.flags, pipelineInfo.layout, pipelineCache, false);
+}
+
+ref_ptr<GraphicsPipelineLibraryPart> GraphicsPipelineLibrary::_getOrCreatePart(PartKey& key, const VkGraphicsPipelineCreateInfo& pipelineInfo, const ShaderStages& shaderStages, VkPipelineCache pipelineCache)
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        if (auto itr = _parts.find(key); itr != _parts.end()) return itr->second;
+    }
+
+    // select the pStages entries for the part's shader stages, all other state that isn't part of the library is ignored by the driver
+    std::vector<VkPipelineShaderStageCreateInfo> stageCreateInfos;
+    for (uint32_t i = 0; i < pipelineInfo.stageCount; ++i)
+    {
+        for (auto& shaderStage : shaderStages)
+        {
+            if (pipelineInfo.pStages[i].stage == shaderStage->stage) stageCreateInfos.push_back(pipelineInfo.pStages[i]);
+        }
+    }
+
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo = {};
+    libraryInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+    libraryInfo.pNext = const_cast<void*>(pipelineInfo.pNext);
+    libraryInfo.flags = key.flags;
+
+    VkGraphicsPipelineCreateInfo partInfo = pipelineInfo;
+    partInfo.pNext = &libraryInfo;
+    partInfo.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    partInfo.stageCount = static_cast<uint32_t>(stageCreateInfos.size());
+    partInfo.pStages = stageCreateInfos.empty() ? nullptr : stageCreateInfos.data();
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (VkResult result = vkCreateGraphicsPipelines(_device->vk(), pipelineCache, 1, &partInfo, _device->getAllocationCallbacks(), &pipeline); result != VK_SUCCESS)
+    {
+        throw Exception{"Error: vsg::GraphicsPipelineLibrary failed to create pipeline library part.", result};
+    }
+
+    auto part = GraphicsPipelineLibraryPart::create(_device, key.flags, pipeline);
+
+    // another thread may have created a matching part while this one was being created, in which case use the first one created
+    std::scoped_lock<std::mutex> lock(_mutex);
+    auto [itr, inserted] = _parts.emplace(std::move(key), part);
+    return itr->second;
+}
+
+VkPipeline GraphicsPipelineLibrary::link(Device* device, const GraphicsPipelineLibraryParts& parts, VkPipelineCreateFlags flags, VkPipelineLayout layout, VkPipelineCache pipelineCache, bool optimize)
+{
+    std::vector<VkPipeline> libraries;
+    for (auto& part : parts)
+    {
+        if (part) libraries.push_back(part->vk());
+    }
+
+    VkPipelineLibraryCreateInfoKHR libraryInfo = {};
+    libraryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+    libraryInfo.libraryCount = static_cast<uint32_t>(libraries.size());
+    libraryInfo.pLibraries = libraries.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = &libraryInfo;
+    pipelineInfo.flags = flags;
+    if (optimize) pipelineInfo.flags |= VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+    pipelineInfo.layout = layout;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (VkResult result = vkCreateGraphicsPipelines(device->vk(), pipelineCache, 1, &pipelineInfo, device->getAllocationCallbacks(), &pipeline); result != VK_SUCCESS)
+    {
+        throw Exception{"Error: vsg::GraphicsPipelineLibrary failed to link pipeline library parts.", result};
+    }
+    return pipeline;
+}
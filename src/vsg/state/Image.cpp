@@ -140,7 +140,8 @@ int Image::compare(const Object& rhs_object) const
     if ((result = compare_value(usage, rhs.usage))) return result;
     if ((result = compare_value(sharingMode, rhs.sharingMode))) return result;
     if ((result = compare_value_container(queueFamilyIndices, rhs.queueFamilyIndices))) return result;
-    return compare_value(initialLayout, rhs.initialLayout);
+    if ((result = compare_value(initialLayout, rhs.initialLayout))) return result;
+    return compare_value(externalMemoryHandleTypes, rhs.externalMemoryHandleTypes);
 }
 
 VkResult Image::bind(DeviceMemory* deviceMemory, VkDeviceSize memoryOffset)
@@ -159,7 +160,8 @@ VkResult Image::bind(DeviceMemory* deviceMemory, VkDeviceSize memoryOffset)
 VkResult Image::allocateAndBindMemory(Device* device, VkMemoryPropertyFlags memoryProperties, void* pNextAllocInfo)
 {
     auto memRequirements = getMemoryRequirements(device->deviceID);
-    auto memory = DeviceMemory::create(device, memRequirements, memoryProperties, pNextAllocInfo);
+    auto memory = (externalMemoryHandleTypes != 0 && !pNextAllocInfo) ? createExportableDeviceMemory(device, memRequirements, memoryProperties, externalMemoryHandleTypes, vk(device->deviceID))
+                                                                      : DeviceMemory::create(device, memRequirements, memoryProperties, pNextAllocInfo);
     auto [allocated, offset] = memory->reserve(memRequirements.size);
     if (!allocated)
     {
@@ -168,6 +170,26 @@ VkResult Image::allocateAndBindMemory(Device* device, VkMemoryPropertyFlags memo
     return bind(memory, offset);
 }
 
+VkMemoryPropertyFlags Image::preferredMemoryProperties(Device* device) const
+{
+    VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    if ((usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) == 0) return memoryProperties;
+
+    VkPhysicalDeviceMemoryProperties deviceMemoryProperties;
+    device->getPhysicalDevice()->getMemoryProperties(deviceMemoryProperties);
+
+    auto memoryTypeBits = getMemoryRequirements(device->deviceID).memoryTypeBits;
+    for (uint32_t i = 0; i < deviceMemoryProperties.memoryTypeCount; ++i)
+    {
+        if ((memoryTypeBits & (1 << i)) && (deviceMemoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0)
+        {
+            memoryProperties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            break;
+        }
+    }
+    return memoryProperties;
+}
+
 VkMemoryRequirements Image::getMemoryRequirements(uint32_t deviceID) const
 {
     const VulkanData& vd = _vulkanData[deviceID];
@@ -182,9 +204,14 @@ void Image::compile(Device* device)
     auto& vd = _vulkanData[device->deviceID];
     if (vd.image != VK_NULL_HANDLE) return;
 
+    VkExternalMemoryImageCreateInfo externalMemoryInfo = {};
+    externalMemoryInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO;
+    externalMemoryInfo.pNext = nullptr;
+    externalMemoryInfo.handleTypes = externalMemoryHandleTypes;
+
     VkImageCreateInfo info = {};
     info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    info.pNext = nullptr;
+    info.pNext = (externalMemoryHandleTypes != 0) ? &externalMemoryInfo : nullptr;
     info.flags = flags;
     info.imageType = imageType;
     info.format = format;
@@ -216,6 +243,15 @@ void Image::compile(Context& context)
 
     compile(context.device);
 
+    // lazily allocated memory isn't pooled as it doesn't occupy memory, and MemoryBufferPools doesn't distinguish memory properties,
+    // exportable memory isn't pooled as it has to be allocated as exportable and the importer typically requires a dedicated allocation
+    if (auto memoryProperties = preferredMemoryProperties(context.device); (memoryProperties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0 || externalMemoryHandleTypes != 0)
+    {
+        vd.requiresDataCopy = false;
+        allocateAndBindMemory(context.device, memoryProperties);
+        return;
+    }
+
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(*vd.device, vd.image, &memRequirements);
 
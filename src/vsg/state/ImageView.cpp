@@ -200,62 +200,167 @@ ref_ptr<ImageView> vsg::createImageView(Device* device, ref_ptr<Image> image, Vk
     return imageView;
 }
 
-void vsg::transferImageData(ref_ptr<ImageView> imageView, VkImageLayout targetImageLayout, Data::Properties properties, uint32_t width, uint32_t height, uint32_t depth, uint32_t mipLevels, const Data::MipmapOffsets& mipmapOffsets, ref_ptr<Buffer> stagingBuffer, VkDeviceSize stagingBufferOffset, VkCommandBuffer commandBuffer, vsg::Device* device)
+namespace
 {
-    ref_ptr<Image> textureImage(imageView->image);
-    auto aspectMask = imageView->subresourceRange.aspectMask;
+    /// the image, subresource range and copy regions of a transfer from a staging buffer to an image
+    struct ImageUpload
+    {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageAspectFlags aspectMask = 0;
+        VkImageLayout targetImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        uint32_t arrayLayers = 1;
+        uint32_t mipLevels = 1;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t depth = 0;
+        bool generateMipmaps = false;
+        std::vector<VkBufferImageCopy> regions;
+    };
+
+    ImageUpload prepareImageUpload(ImageView* imageView, VkImageLayout targetImageLayout, const Data::Properties& properties, uint32_t width, uint32_t height, uint32_t depth, uint32_t mipLevels, const Data::MipmapOffsets& mipmapOffsets, VkDeviceSize stagingBufferOffset, Device* device)
+    {
+        ref_ptr<Image> textureImage(imageView->image);
+        auto aspectMask = imageView->subresourceRange.aspectMask;
 
-    uint32_t faceWidth = width;
-    uint32_t faceHeight = height;
-    uint32_t faceDepth = depth;
-    uint32_t arrayLayers = 1;
+        uint32_t faceWidth = width;
+        uint32_t faceHeight = height;
+        uint32_t faceDepth = depth;
+        uint32_t arrayLayers = 1;
 
-    //switch(properties.imageViewType)
-    switch (imageView->viewType)
-    {
-    case (VK_IMAGE_VIEW_TYPE_CUBE):
-        arrayLayers = faceDepth;
-        faceDepth = 1;
-        break;
-    case (VK_IMAGE_VIEW_TYPE_1D_ARRAY):
-        arrayLayers = faceHeight * faceDepth;
-        faceHeight = 1;
-        faceDepth = 1;
-        break;
-    case (VK_IMAGE_VIEW_TYPE_2D_ARRAY):
-        arrayLayers = faceDepth;
-        faceDepth = 1;
-        break;
-    case (VK_IMAGE_VIEW_TYPE_CUBE_ARRAY):
-        arrayLayers = faceDepth;
-        faceDepth = 1;
-        break;
-    default:
-        break;
-    }
+        //switch(properties.imageViewType)
+        switch (imageView->viewType)
+        {
+        case (VK_IMAGE_VIEW_TYPE_CUBE):
+            arrayLayers = faceDepth;
+            faceDepth = 1;
+            break;
+        case (VK_IMAGE_VIEW_TYPE_1D_ARRAY):
+            arrayLayers = faceHeight * faceDepth;
+            faceHeight = 1;
+            faceDepth = 1;
+            break;
+        case (VK_IMAGE_VIEW_TYPE_2D_ARRAY):
+            arrayLayers = faceDepth;
+            faceDepth = 1;
+            break;
+        case (VK_IMAGE_VIEW_TYPE_CUBE_ARRAY):
+            arrayLayers = faceDepth;
+            faceDepth = 1;
+            break;
+        default:
+            break;
+        }
 
-    uint32_t destWidth = faceWidth * properties.blockWidth;
-    uint32_t destHeight = faceHeight * properties.blockHeight;
-    uint32_t destDepth = faceDepth * properties.blockDepth;
+        uint32_t destWidth = faceWidth * properties.blockWidth;
+        uint32_t destHeight = faceHeight * properties.blockHeight;
+        uint32_t destDepth = faceDepth * properties.blockDepth;
 
-    const auto valueSize = properties.stride; // data->valueSize();
+        const auto valueSize = properties.stride; // data->valueSize();
 
-    bool useDataMipmaps = (mipLevels > 1) && (mipmapOffsets.size() > 1);
-    bool generateMipmaps = (mipLevels > 1) && (mipmapOffsets.size() <= 1);
+        bool useDataMipmaps = (mipLevels > 1) && (mipmapOffsets.size() > 1);
+        bool generateMipmaps = (mipLevels > 1) && (mipmapOffsets.size() <= 1);
 
-    auto vk_textureImage = textureImage->vk(device->deviceID);
+        auto vk_textureImage = textureImage->vk(device->deviceID);
 
-    if (generateMipmaps)
-    {
-        VkFormatProperties props;
-        vkGetPhysicalDeviceFormatProperties(*(device->getPhysicalDevice()), properties.format, &props);
-        const bool isBlitPossible = (props.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT) > 0;
+        if (generateMipmaps)
+        {
+            VkFormatProperties props;
+            vkGetPhysicalDeviceFormatProperties(*(device->getPhysicalDevice()), properties.format, &props);
+            const bool isBlitPossible = (props.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT) > 0;
 
-        if (!isBlitPossible)
+            if (!isBlitPossible)
+            {
+                generateMipmaps = false;
+            }
+        }
+
+        std::vector<VkBufferImageCopy> regions;
+
+        if (useDataMipmaps)
         {
-            generateMipmaps = false;
+            size_t offset = 0u;
+            regions.resize(mipLevels * arrayLayers);
+
+            uint32_t mipWidth = destWidth;
+            uint32_t mipHeight = destHeight;
+            uint32_t mipDepth = destDepth;
+
+            for (uint32_t mipLevel = 0; mipLevel < mipLevels; ++mipLevel)
+            {
+                const size_t faceSize = static_cast<size_t>(faceWidth * faceHeight * faceDepth * valueSize);
+
+                for (uint32_t face = 0; face < arrayLayers; ++face)
+                {
+                    auto& region = regions[mipLevel * arrayLayers + face];
+                    region.bufferOffset = stagingBufferOffset + offset;
+                    region.bufferRowLength = 0;
+                    region.bufferImageHeight = 0;
+                    region.imageSubresource.aspectMask = aspectMask;
+                    region.imageSubresource.mipLevel = mipLevel;
+                    region.imageSubresource.baseArrayLayer = face;
+                    region.imageSubresource.layerCount = 1;
+                    region.imageOffset = {0, 0, 0};
+                    region.imageExtent = {mipWidth, mipHeight, mipDepth};
+
+                    offset += faceSize;
+                }
+
+                if (mipWidth > 1) mipWidth /= 2;
+                if (mipHeight > 1) mipHeight /= 2;
+                if (mipDepth > 1) mipDepth /= 2;
+                if (faceWidth > 1) faceWidth /= 2;
+                if (faceHeight > 1) faceHeight /= 2;
+                if (faceDepth > 1) faceDepth /= 2;
+            }
         }
+        else
+        {
+            regions.resize(arrayLayers);
+
+            const size_t faceSize = static_cast<size_t>(faceWidth * faceHeight * faceDepth * valueSize);
+            for (auto face = 0u; face < arrayLayers; face++)
+            {
+                auto& region = regions[face];
+                region.bufferOffset = stagingBufferOffset + face * faceSize;
+                region.bufferRowLength = 0;
+                region.bufferImageHeight = 0;
+                region.imageSubresource.aspectMask = aspectMask;
+                region.imageSubresource.mipLevel = 0;
+                region.imageSubresource.baseArrayLayer = face;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = {0, 0, 0};
+                region.imageExtent = {destWidth, destHeight, destDepth};
+            }
+        }
+
+        ImageUpload upload;
+        upload.image = vk_textureImage;
+        upload.aspectMask = aspectMask;
+        upload.targetImageLayout = targetImageLayout;
+        upload.arrayLayers = arrayLayers;
+        upload.mipLevels = mipLevels;
+        upload.width = destWidth;
+        upload.height = destHeight;
+        upload.depth = destDepth;
+        upload.generateMipmaps = generateMipmaps;
+        upload.regions = std::move(regions);
+        return upload;
     }
+} // namespace
+
+VkImageMemoryBarrier vsg::transferImageData(ref_ptr<ImageView> imageView, VkImageLayout targetImageLayout, Data::Properties properties, uint32_t width, uint32_t height, uint32_t depth, uint32_t mipLevels, const Data::MipmapOffsets& mipmapOffsets, ref_ptr<Buffer> stagingBuffer, VkDeviceSize stagingBufferOffset, VkCommandBuffer commandBuffer, vsg::Device* device,
+                                             uint32_t srcQueueFamilyIndex, uint32_t dstQueueFamilyIndex)
+{
+    auto upload = prepareImageUpload(imageView, targetImageLayout, properties, width, height, depth, mipLevels, mipmapOffsets, stagingBufferOffset, device);
+
+    auto vk_textureImage = upload.image;
+    auto aspectMask = upload.aspectMask;
+    auto arrayLayers = upload.arrayLayers;
+    auto destWidth = upload.width;
+    auto destHeight = upload.height;
+    auto destDepth = upload.depth;
+    auto generateMipmaps = upload.generateMipmaps;
+    auto& regions = upload.regions;
 
     // transfer the data.
     VkImageMemoryBarrier preCopyBarrier = {};
@@ -279,65 +384,6 @@ void vsg::transferImageData(ref_ptr<ImageView> imageView, VkImageLayout targetIm
                          0, nullptr,
                          1, &preCopyBarrier);
 
-    std::vector<VkBufferImageCopy> regions;
-
-    if (useDataMipmaps)
-    {
-        size_t offset = 0u;
-        regions.resize(mipLevels * arrayLayers);
-
-        uint32_t mipWidth = destWidth;
-        uint32_t mipHeight = destHeight;
-        uint32_t mipDepth = destDepth;
-
-        for (uint32_t mipLevel = 0; mipLevel < mipLevels; ++mipLevel)
-        {
-            const size_t faceSize = static_cast<size_t>(faceWidth * faceHeight * faceDepth * valueSize);
-
-            for (uint32_t face = 0; face < arrayLayers; ++face)
-            {
-                auto& region = regions[mipLevel * arrayLayers + face];
-                region.bufferOffset = stagingBufferOffset + offset;
-                region.bufferRowLength = 0;
-                region.bufferImageHeight = 0;
-                region.imageSubresource.aspectMask = aspectMask;
-                region.imageSubresource.mipLevel = mipLevel;
-                region.imageSubresource.baseArrayLayer = face;
-                region.imageSubresource.layerCount = 1;
-                region.imageOffset = {0, 0, 0};
-                region.imageExtent = {mipWidth, mipHeight, mipDepth};
-
-                offset += faceSize;
-            }
-
-            if (mipWidth > 1) mipWidth /= 2;
-            if (mipHeight > 1) mipHeight /= 2;
-            if (mipDepth > 1) mipDepth /= 2;
-            if (faceWidth > 1) faceWidth /= 2;
-            if (faceHeight > 1) faceHeight /= 2;
-            if (faceDepth > 1) faceDepth /= 2;
-        }
-    }
-    else
-    {
-        regions.resize(arrayLayers);
-
-        const size_t faceSize = static_cast<size_t>(faceWidth * faceHeight * faceDepth * valueSize);
-        for (auto face = 0u; face < arrayLayers; face++)
-        {
-            auto& region = regions[face];
-            region.bufferOffset = stagingBufferOffset + face * faceSize;
-            region.bufferRowLength = 0;
-            region.bufferImageHeight = 0;
-            region.imageSubresource.aspectMask = aspectMask;
-            region.imageSubresource.mipLevel = 0;
-            region.imageSubresource.baseArrayLayer = face;
-            region.imageSubresource.layerCount = 1;
-            region.imageOffset = {0, 0, 0};
-            region.imageExtent = {destWidth, destHeight, destDepth};
-        }
-    }
-
     vkCmdCopyBufferToImage(commandBuffer, stagingBuffer->vk(device->deviceID), vk_textureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                            static_cast<uint32_t>(regions.size()), regions.data());
 
@@ -418,17 +464,22 @@ void vsg::transferImageData(ref_ptr<ImageView> imageView, VkImageLayout targetIm
                              0, nullptr,
                              0, nullptr,
                              1, &barrier);
+
+        return barrier;
     }
     else
     {
+        // when releasing ownership to another queue family the destination access and stage are ignored, and the fragment stage may not be supported by the transfer queue
+        bool releaseOwnership = srcQueueFamilyIndex != dstQueueFamilyIndex;
+
         VkImageMemoryBarrier postCopyBarrier = {};
         postCopyBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         postCopyBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        postCopyBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        postCopyBarrier.dstAccessMask = releaseOwnership ? 0 : VK_ACCESS_SHADER_READ_BIT;
         postCopyBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
         postCopyBarrier.newLayout = targetImageLayout;
-        postCopyBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        postCopyBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        postCopyBarrier.srcQueueFamilyIndex = releaseOwnership ? srcQueueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
+        postCopyBarrier.dstQueueFamilyIndex = releaseOwnership ? dstQueueFamilyIndex : VK_QUEUE_FAMILY_IGNORED;
         postCopyBarrier.image = vk_textureImage;
         postCopyBarrier.subresourceRange.aspectMask = aspectMask;
         postCopyBarrier.subresourceRange.baseArrayLayer = 0;
@@ -437,9 +488,130 @@ void vsg::transferImageData(ref_ptr<ImageView> imageView, VkImageLayout targetIm
         postCopyBarrier.subresourceRange.baseMipLevel = 0;
 
         vkCmdPipelineBarrier(commandBuffer,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, releaseOwnership ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
                              0, nullptr,
                              0, nullptr,
                              1, &postCopyBarrier);
+
+        return postCopyBarrier;
+    }
+}
+
+void vsg::transferImageData(const ImageTransfers& transfers, VkCommandBuffer commandBuffer, vsg::Device* device)
+{
+    if (transfers.empty()) return;
+
+    std::vector<ImageUpload> uploads;
+    uploads.reserve(transfers.size());
+    for (auto& transfer : transfers)
+    {
+        uploads.push_back(prepareImageUpload(transfer.imageView, transfer.targetImageLayout, transfer.properties, transfer.width, transfer.height, transfer.depth, transfer.mipLevels, transfer.mipmapOffsets, transfer.stagingBufferOffset, device));
+    }
+
+    auto createBarrier = [](const ImageUpload& upload, uint32_t baseMipLevel, uint32_t levelCount, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkImageLayout oldLayout, VkImageLayout newLayout) {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccessMask;
+        barrier.dstAccessMask = dstAccessMask;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = upload.image;
+        barrier.subresourceRange.aspectMask = upload.aspectMask;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = upload.arrayLayers;
+        barrier.subresourceRange.baseMipLevel = baseMipLevel;
+        barrier.subresourceRange.levelCount = levelCount;
+        return barrier;
+    };
+
+    auto pipelineBarrier = [&](VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, const std::vector<VkImageMemoryBarrier>& barriers) {
+        if (barriers.empty()) return;
+        vkCmdPipelineBarrier(commandBuffer,
+                             srcStageMask, dstStageMask, 0,
+                             0, nullptr,
+                             0, nullptr,
+                             static_cast<uint32_t>(barriers.size()), barriers.data());
+    };
+
+    // transition all the images for the copies with a single barrier
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(uploads.size() * 2);
+    for (auto& upload : uploads)
+    {
+        barriers.push_back(createBarrier(upload, 0, upload.mipLevels, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL));
+    }
+    pipelineBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, barriers);
+
+    for (size_t i = 0; i < uploads.size(); ++i)
+    {
+        auto& regions = uploads[i].regions;
+        vkCmdCopyBufferToImage(commandBuffer, transfers[i].stagingBuffer->vk(device->deviceID), uploads[i].image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    // transition the images that don't need mipmaps generating to their target layouts with a single barrier
+    barriers.clear();
+    uint32_t maxMipLevels = 0;
+    for (auto& upload : uploads)
+    {
+        if (upload.generateMipmaps)
+            maxMipLevels = std::max(maxMipLevels, upload.mipLevels);
+        else
+            barriers.push_back(createBarrier(upload, 0, upload.mipLevels, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, upload.targetImageLayout));
+    }
+    pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, barriers);
+
+    // generate the mipmaps of all the images together level by level, so each level needs one barrier to make the previous level a blit source
+    // and one to transition it to its target layout, rather than two per image
+    for (uint32_t level = 1; level < maxMipLevels; ++level)
+    {
+        barriers.clear();
+        for (auto& upload : uploads)
+        {
+            if (!upload.generateMipmaps || level >= upload.mipLevels) continue;
+            barriers.push_back(createBarrier(upload, level - 1, 1, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL));
+        }
+        pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, barriers);
+
+        barriers.clear();
+        for (auto& upload : uploads)
+        {
+            if (!upload.generateMipmaps || level >= upload.mipLevels) continue;
+
+            int32_t mipWidth = static_cast<int32_t>(std::max(upload.width >> (level - 1), 1u));
+            int32_t mipHeight = static_cast<int32_t>(std::max(upload.height >> (level - 1), 1u));
+            int32_t mipDepth = static_cast<int32_t>(std::max(upload.depth >> (level - 1), 1u));
+
+            VkImageBlit blit;
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {mipWidth, mipHeight, mipDepth};
+            blit.srcSubresource.aspectMask = upload.aspectMask;
+            blit.srcSubresource.mipLevel = level - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = upload.arrayLayers;
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, mipDepth > 1 ? mipDepth / 2 : 1};
+            blit.dstSubresource.aspectMask = upload.aspectMask;
+            blit.dstSubresource.mipLevel = level;
+            blit.dstSubresource.baseArrayLayer = 0;
+            blit.dstSubresource.layerCount = upload.arrayLayers;
+
+            vkCmdBlitImage(commandBuffer,
+                           upload.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           1, &blit,
+                           VK_FILTER_LINEAR);
+
+            barriers.push_back(createBarrier(upload, level - 1, 1, VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, upload.targetImageLayout));
+
+            // the last level is only written to so transition it directly to the target layout
+            if (level == upload.mipLevels - 1)
+            {
+                barriers.push_back(createBarrier(upload, level, 1, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, upload.targetImageLayout));
+            }
+        }
+        pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, barriers);
     }
 }
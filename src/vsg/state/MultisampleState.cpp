@@ -105,6 +105,14 @@ void MultisampleState::apply(Context& context, VkGraphicsPipelineCreateInfo& pip
     multisampleState->flags = 0;
 
     multisampleState->rasterizationSamples = rasterizationSamples;
+
+    // a RenderGraph's MultisampleState override applies to all its subpasses, so clamp to the samples of the attachments that the pipeline's subpass renders to,
+    // such as for a post processing subpass that reads the resolved color of a multisampled subpass
+    if (context.renderPass && pipelineInfo.renderPass != VK_NULL_HANDLE && pipelineInfo.renderPass == context.renderPass->vk())
+    {
+        auto samples = context.renderPass->subpassSamples(pipelineInfo.subpass);
+        if (samples < rasterizationSamples) multisampleState->rasterizationSamples = samples;
+    }
     multisampleState->sampleShadingEnable = sampleShadingEnable;
     multisampleState->minSampleShading = minSampleShading;
     multisampleState->pSampleMask = sampleMasks.empty() ? nullptr : sampleMasks.data();
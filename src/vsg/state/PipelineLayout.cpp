@@ -100,7 +100,14 @@ void PipelineLayout::compile(Context& context)
         {
             if (dsl) dsl->compile(context);
         }
-        _implementation[context.deviceID] = PipelineLayout::Implementation::create(context.device, setLayouts, pushConstantRanges, flags);
+
+        auto create = [&]() { return PipelineLayout::Implementation::create(context.device, setLayouts, pushConstantRanges, flags); };
+
+        // only share implementations of PipelineLayout itself as subclasses may not serialize all their state
+        if (context.stateCache && type_info() == typeid(PipelineLayout))
+            _implementation[context.deviceID] = context.stateCache->getOrCreate(*this, nullptr, create).cast<Implementation>();
+        else
+            _implementation[context.deviceID] = create();
     }
 }
 
@@ -54,4 +54,8 @@ void PushConstants::write(Output& output) const
 void PushConstants::record(CommandBuffer& commandBuffer) const
 {
     vkCmdPushConstants(commandBuffer, commandBuffer.getCurrentPipelineLayout(), stageFlags, offset, static_cast<uint32_t>(data->dataSize()), data->dataPointer());
+    ++commandBuffer.recordStatistics.pushConstants;
+
+    // may overwrite the projection and modelview matrices pushed by vsg::State
+    commandBuffer.recordedMatricesMask = 0;
 }
@@ -0,0 +1,147 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/compare.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/state/PushDescriptorSet.h>
+#include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/Context.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+PushDescriptorSet::PushDescriptorSet() :
+    Inherit(1) // slot 1
+{
+}
+
+int PushDescriptorSet::compare(const Object& rhs_object) const
+{
+    int result = StateCommand::compare(rhs_object);
+    if (result != 0) return result;
+
+    auto& rhs = static_cast<decltype(*this)>(rhs_object);
+
+    if ((result = compare_value(pipelineBindPoint, rhs.pipelineBindPoint))) return result;
+    if ((result = compare_pointer(layout, rhs.layout))) return result;
+    if ((result = compare_value(set, rhs.set))) return result;
+    return compare_pointer_container(descriptors, rhs.descriptors);
+}
+
+void PushDescriptorSet::read(Input& input)
+{
+    _vulkanData.clear();
+
+    StateCommand::read(input);
+
+    input.readValue<uint32_t>("pipelineBindPoint", pipelineBindPoint);
+    input.readObject("layout", layout);
+    input.read("set", set);
+    input.readObjects("descriptors", descriptors);
+
+    slot = 1 + set;
+}
+
+void PushDescriptorSet::write(Output& output) const
+{
+    StateCommand::write(output);
+
+    output.writeValue<uint32_t>("pipelineBindPoint", pipelineBindPoint);
+    output.writeObject("layout", layout);
+    output.write("set", set);
+    output.writeObjects("descriptors", descriptors);
+}
+
+void PushDescriptorSet::compile(Context& context)
+{
+    auto& vkd = _vulkanData[context.deviceID];
+
+    if (vkd._vkPipelineLayout == 0)
+    {
+        layout->compile(context);
+        vkd._vkPipelineLayout = layout->vk(context.deviceID);
+        vkd._vkCmdPushDescriptorSetKHR = context.device->getExtensions()->vkCmdPushDescriptorSetKHR;
+        if (!vkd._vkCmdPushDescriptorSetKHR) warn("PushDescriptorSet::compile() VK_KHR_push_descriptor not enabled on device, descriptors will not be pushed.");
+    }
+
+    for (auto& descriptor : descriptors)
+    {
+        descriptor->compile(context);
+    }
+
+    // the descriptor infos provided by assignTo() point into scratch memory, so copy them into storage retained for recording
+    auto descriptorWrites = context.scratchMemory->allocate<VkWriteDescriptorSet>(descriptors.size());
+    size_t numImageInfos = 0, numBufferInfos = 0, numTexelBufferViews = 0;
+    for (size_t i = 0; i < descriptors.size(); ++i)
+    {
+        auto& wds = descriptorWrites[i];
+        descriptors[i]->assignTo(context, wds);
+
+        if (wds.pImageInfo) numImageInfos += wds.descriptorCount;
+        if (wds.pBufferInfo) numBufferInfos += wds.descriptorCount;
+        if (wds.pTexelBufferView) numTexelBufferViews += wds.descriptorCount;
+    }
+
+    vkd._descriptorWrites.clear();
+    vkd._imageInfos.resize(numImageInfos);
+    vkd._bufferInfos.resize(numBufferInfos);
+    vkd._texelBufferViews.resize(numTexelBufferViews);
+
+    auto imageInfo = vkd._imageInfos.data();
+    auto bufferInfo = vkd._bufferInfos.data();
+    auto texelBufferView = vkd._texelBufferViews.data();
+    for (size_t i = 0; i < descriptors.size(); ++i)
+    {
+        auto wds = descriptorWrites[i];
+        if (wds.pNext)
+        {
+            // inline uniform blocks and acceleration structures pass their data via pNext
+            warn("PushDescriptorSet::compile() descriptor type ", wds.descriptorType, " not supported.");
+            continue;
+        }
+
+        if (wds.pImageInfo)
+        {
+            std::copy(wds.pImageInfo, wds.pImageInfo + wds.descriptorCount, imageInfo);
+            wds.pImageInfo = imageInfo;
+            imageInfo += wds.descriptorCount;
+        }
+        if (wds.pBufferInfo)
+        {
+            std::copy(wds.pBufferInfo, wds.pBufferInfo + wds.descriptorCount, bufferInfo);
+            wds.pBufferInfo = bufferInfo;
+            bufferInfo += wds.descriptorCount;
+        }
+        if (wds.pTexelBufferView)
+        {
+            std::copy(wds.pTexelBufferView, wds.pTexelBufferView + wds.descriptorCount, texelBufferView);
+            wds.pTexelBufferView = texelBufferView;
+            texelBufferView += wds.descriptorCount;
+        }
+        wds.dstSet = VK_NULL_HANDLE;
+        vkd._descriptorWrites.push_back(wds);
+    }
+
+    // clean up scratch memory so it can be reused.
+    context.scratchMemory->release();
+}
+
+void PushDescriptorSet::record(CommandBuffer& commandBuffer) const
+{
+    auto& vkd = _vulkanData[commandBuffer.deviceID];
+    if (!vkd._vkCmdPushDescriptorSetKHR || vkd._descriptorWrites.empty()) return;
+
+    ++commandBuffer.recordStatistics.descriptorSetsBound;
+    vkd._vkCmdPushDescriptorSetKHR(commandBuffer, pipelineBindPoint, vkd._vkPipelineLayout, set, static_cast<uint32_t>(vkd._descriptorWrites.size()), vkd._descriptorWrites.data());
+}
@@ -11,12 +11,29 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/core/compare.h>
+#include <vsg/io/Fields.h>
 #include <vsg/io/Options.h>
 #include <vsg/state/RasterizationState.h>
 #include <vsg/vk/Context.h>
 
 using namespace vsg;
 
+namespace
+{
+    // depthBiasConstantFactor has historically been stored as a uint32_t so is read/written as a converted value rather than raw.
+    constexpr auto s_rasterizationStateFields = fields(
+        fieldAs<uint32_t>("depthClampEnable", &RasterizationState::depthClampEnable),
+        fieldAs<uint32_t>("rasterizerDiscardEnable", &RasterizationState::rasterizerDiscardEnable),
+        fieldAs<uint32_t>("polygonMode", &RasterizationState::polygonMode),
+        fieldAs<uint32_t>("cullMode", &RasterizationState::cullMode),
+        fieldAs<uint32_t>("frontFace", &RasterizationState::frontFace),
+        fieldAs<uint32_t>("depthBiasEnable", &RasterizationState::depthBiasEnable),
+        fieldAs<uint32_t>("depthBiasConstantFactor", &RasterizationState::depthBiasConstantFactor),
+        field("depthBiasClamp", &RasterizationState::depthBiasClamp),
+        field("depthBiasSlopeFactor", &RasterizationState::depthBiasSlopeFactor),
+        field("lineWidth", &RasterizationState::lineWidth));
+} // namespace
+
 RasterizationState::RasterizationState()
 {
 }
@@ -53,32 +70,14 @@ void RasterizationState::read(Input& input)
 {
     GraphicsPipelineState::read(input);
 
-    input.readValue<uint32_t>("depthClampEnable", depthClampEnable);
-    input.readValue<uint32_t>("rasterizerDiscardEnable", rasterizerDiscardEnable);
-    input.readValue<uint32_t>("polygonMode", polygonMode);
-    input.readValue<uint32_t>("cullMode", cullMode);
-    input.readValue<uint32_t>("frontFace", frontFace);
-    input.readValue<uint32_t>("depthBiasEnable", depthBiasEnable);
-    input.readValue<uint32_t>("depthBiasConstantFactor", depthBiasConstantFactor);
-    input.read("depthBiasClamp", depthBiasClamp);
-    input.read("depthBiasSlopeFactor", depthBiasSlopeFactor);
-    input.read("lineWidth", lineWidth);
+    readFields(input, *this, s_rasterizationStateFields);
 }
 
 void RasterizationState::write(Output& output) const
 {
     GraphicsPipelineState::write(output);
 
-    output.writeValue<uint32_t>("depthClampEnable", depthClampEnable);
-    output.writeValue<uint32_t>("rasterizerDiscardEnable", rasterizerDiscardEnable);
-    output.writeValue<uint32_t>("polygonMode", polygonMode);
-    output.writeValue<uint32_t>("cullMode", cullMode);
-    output.writeValue<uint32_t>("frontFace", frontFace);
-    output.writeValue<uint32_t>("depthBiasEnable", depthBiasEnable);
-    output.writeValue<uint32_t>("depthBiasConstantFactor", depthBiasConstantFactor);
-    output.write("depthBiasClamp", depthBiasClamp);
-    output.write("depthBiasSlopeFactor", depthBiasSlopeFactor);
-    output.write("lineWidth", lineWidth);
+    writeFields(output, *this, s_rasterizationStateFields);
 }
 
 void RasterizationState::apply(Context& context, VkGraphicsPipelineCreateInfo& pipelineInfo) const
@@ -50,6 +50,11 @@ void ResourceHints::read(Input& input)
         input.read("numShadowMapsRange", numShadowMapsRange);
         input.read("shadowMapSize", shadowMapSize);
     }
+
+    if (input.version_greater_equal(1, 1, 8))
+    {
+        input.readValue<uint32_t>("releaseDataHint", releaseDataHint);
+    }
 }
 
 void ResourceHints::write(Output& output) const
@@ -79,4 +84,9 @@ void ResourceHints::write(Output& output) const
         output.write("numShadowMapsRange", numShadowMapsRange);
         output.write("shadowMapSize", shadowMapSize);
     }
+
+    if (output.version_greater_equal(1, 1, 8))
+    {
+        output.writeValue<uint32_t>("releaseDataHint", releaseDataHint);
+    }
 }
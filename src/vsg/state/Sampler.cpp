@@ -12,12 +12,34 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/core/Exception.h>
 #include <vsg/core/compare.h>
+#include <vsg/io/Fields.h>
 #include <vsg/io/Options.h>
 #include <vsg/state/Sampler.h>
 #include <vsg/vk/Context.h>
 
 using namespace vsg;
 
+namespace
+{
+    constexpr auto s_samplerFields = fields(
+        fieldAs<uint32_t>("flags", &Sampler::flags),
+        fieldAs<uint32_t>("minFilter", &Sampler::minFilter),
+        fieldAs<uint32_t>("magFilter", &Sampler::magFilter),
+        fieldAs<uint32_t>("mipmapMode", &Sampler::mipmapMode),
+        fieldAs<uint32_t>("addressModeU", &Sampler::addressModeU),
+        fieldAs<uint32_t>("addressModeV", &Sampler::addressModeV),
+        fieldAs<uint32_t>("addressModeW", &Sampler::addressModeW),
+        field("mipLodBias", &Sampler::mipLodBias),
+        fieldAs<uint32_t>("anisotropyEnable", &Sampler::anisotropyEnable),
+        field("maxAnisotropy", &Sampler::maxAnisotropy),
+        fieldAs<uint32_t>("compareEnable", &Sampler::compareEnable),
+        fieldAs<uint32_t>("compareOp", &Sampler::compareOp),
+        field("minLod", &Sampler::minLod),
+        field("maxLod", &Sampler::maxLod),
+        fieldAs<uint32_t>("borderColor", &Sampler::borderColor),
+        fieldAs<uint32_t>("unnormalizedCoordinates", &Sampler::unnormalizedCoordinates));
+} // namespace
+
 Sampler::Sampler()
 {
 }
@@ -37,42 +59,12 @@ int Sampler::compare(const Object& rhs_object) const
 
 void Sampler::read(Input& input)
 {
-    input.readValue<uint32_t>("flags", flags);
-    input.readValue<uint32_t>("minFilter", minFilter);
-    input.readValue<uint32_t>("magFilter", magFilter);
-    input.readValue<uint32_t>("mipmapMode", mipmapMode);
-    input.readValue<uint32_t>("addressModeU", addressModeU);
-    input.readValue<uint32_t>("addressModeV", addressModeV);
-    input.readValue<uint32_t>("addressModeW", addressModeW);
-    input.read("mipLodBias", mipLodBias);
-    input.readValue<uint32_t>("anisotropyEnable", anisotropyEnable);
-    input.read("maxAnisotropy", maxAnisotropy);
-    input.readValue<uint32_t>("compareEnable", compareEnable);
-    input.readValue<uint32_t>("compareOp", compareOp);
-    input.read("minLod", minLod);
-    input.read("maxLod", maxLod);
-    input.readValue<uint32_t>("borderColor", borderColor);
-    input.readValue<uint32_t>("unnormalizedCoordinates", unnormalizedCoordinates);
+    readFields(input, *this, s_samplerFields);
 }
 
 void Sampler::write(Output& output) const
 {
-    output.writeValue<uint32_t>("flags", flags);
-    output.writeValue<uint32_t>("minFilter", minFilter);
-    output.writeValue<uint32_t>("magFilter", magFilter);
-    output.writeValue<uint32_t>("mipmapMode", mipmapMode);
-    output.writeValue<uint32_t>("addressModeU", addressModeU);
-    output.writeValue<uint32_t>("addressModeV", addressModeV);
-    output.writeValue<uint32_t>("addressModeW", addressModeW);
-    output.write("mipLodBias", mipLodBias);
-    output.writeValue<uint32_t>("anisotropyEnable", anisotropyEnable);
-    output.write("maxAnisotropy", maxAnisotropy);
-    output.writeValue<uint32_t>("compareEnable", compareEnable);
-    output.writeValue<uint32_t>("compareOp", compareOp);
-    output.write("minLod", minLod);
-    output.write("maxLod", maxLod);
-    output.writeValue<uint32_t>("borderColor", borderColor);
-    output.writeValue<uint32_t>("unnormalizedCoordinates", unnormalizedCoordinates);
+    writeFields(output, *this, s_samplerFields);
 }
 
 void Sampler::compile(Context& context)
@@ -100,7 +92,13 @@ void Sampler::compile(Context& context)
     samplerInfo->borderColor = borderColor;
     samplerInfo->unnormalizedCoordinates = unnormalizedCoordinates;
 
-    _implementation[context.deviceID] = Implementation::create(context.device, *samplerInfo);
+    auto create = [&]() { return Implementation::create(context.device, *samplerInfo); };
+
+    // only share implementations of Sampler itself as subclasses may not serialize all their state
+    if (context.stateCache && type_info() == typeid(Sampler))
+        _implementation[context.deviceID] = context.stateCache->getOrCreate(*this, nullptr, create).cast<Implementation>();
+    else
+        _implementation[context.deviceID] = create();
 }
 
 Sampler::Implementation::Implementation(Device* device, const VkSamplerCreateInfo& createSamplerInfo) :
@@ -0,0 +1,390 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/compare.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/state/SetDynamicState.h>
+#include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/Context.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+namespace
+{
+    VkPrimitiveTopology topologyClass(VkPrimitiveTopology topology)
+    {
+        switch (topology)
+        {
+        case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+            return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+        case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+            return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+        case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+            return VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+        default:
+            return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        }
+    }
+
+    bool available(const DeviceExtensions& extensions, VkDynamicState dynamicState)
+    {
+        switch (dynamicState)
+        {
+        case VK_DYNAMIC_STATE_CULL_MODE_EXT: return extensions.vkCmdSetCullMode != nullptr;
+        case VK_DYNAMIC_STATE_FRONT_FACE_EXT: return extensions.vkCmdSetFrontFace != nullptr;
+        case VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT: return extensions.vkCmdSetPrimitiveTopology != nullptr;
+        case VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT: return extensions.vkCmdSetDepthTestEnable != nullptr;
+        case VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT: return extensions.vkCmdSetDepthWriteEnable != nullptr;
+        case VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT: return extensions.vkCmdSetDepthCompareOp != nullptr;
+        case VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT: return extensions.vkCmdSetDepthBoundsTestEnable != nullptr;
+        case VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT: return extensions.vkCmdSetStencilTestEnable != nullptr;
+        case VK_DYNAMIC_STATE_STENCIL_OP_EXT: return extensions.vkCmdSetStencilOp != nullptr;
+        case VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT: return extensions.vkCmdSetRasterizerDiscardEnable != nullptr;
+        case VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT: return extensions.vkCmdSetDepthBiasEnable != nullptr;
+        case VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT: return extensions.vkCmdSetPrimitiveRestartEnable != nullptr;
+        case VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT: return extensions.vkCmdSetDepthClampEnableEXT != nullptr;
+        case VK_DYNAMIC_STATE_POLYGON_MODE_EXT: return extensions.vkCmdSetPolygonModeEXT != nullptr;
+        case VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT: return extensions.vkCmdSetColorBlendEnableEXT != nullptr;
+        case VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT: return extensions.vkCmdSetColorBlendEquationEXT != nullptr;
+        case VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT: return extensions.vkCmdSetColorWriteMaskEXT != nullptr;
+        default: return false;
+        }
+    }
+} // namespace
+
+SetDynamicState::SetDynamicState() :
+    Inherit(dynamicStateSlot)
+{
+}
+
+SetDynamicState::SetDynamicState(const DynamicState::DynamicStates& in_dynamicStates, const GraphicsPipelineStates& pipelineStates) :
+    Inherit(dynamicStateSlot),
+    dynamicStates(in_dynamicStates)
+{
+    for (auto& pipelineState : pipelineStates)
+    {
+        if (auto rs = pipelineState.cast<RasterizationState>())
+            rasterizationState = rs;
+        else if (auto dss = pipelineState.cast<DepthStencilState>())
+            depthStencilState = dss;
+        else if (auto ias = pipelineState.cast<InputAssemblyState>())
+            inputAssemblyState = ias;
+        else if (auto cbs = pipelineState.cast<ColorBlendState>())
+            colorBlendState = cbs;
+    }
+}
+
+SetDynamicState::~SetDynamicState()
+{
+}
+
+bool SetDynamicState::supported(VkDynamicState dynamicState)
+{
+    switch (dynamicState)
+    {
+    case VK_DYNAMIC_STATE_CULL_MODE_EXT:
+    case VK_DYNAMIC_STATE_FRONT_FACE_EXT:
+    case VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT:
+    case VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT:
+    case VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_STENCIL_OP_EXT:
+    case VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_POLYGON_MODE_EXT:
+    case VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT:
+    case VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT:
+    case VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void SetDynamicState::makeDynamic(GraphicsPipelineStates& pipelineStates) const
+{
+    ref_ptr<RasterizationState> rs;
+    ref_ptr<DepthStencilState> dss;
+    ref_ptr<InputAssemblyState> ias;
+    ref_ptr<ColorBlendState> cbs;
+    ref_ptr<DynamicState> dynamicState;
+
+    for (auto& pipelineState : pipelineStates)
+    {
+        if (auto rasterization = pipelineState.cast<RasterizationState>())
+            pipelineState = rs = RasterizationState::create(*rasterization);
+        else if (auto depthStencil = pipelineState.cast<DepthStencilState>())
+            pipelineState = dss = DepthStencilState::create(*depthStencil);
+        else if (auto inputAssembly = pipelineState.cast<InputAssemblyState>())
+            pipelineState = ias = InputAssemblyState::create(*inputAssembly);
+        else if (auto colorBlend = pipelineState.cast<ColorBlendState>())
+            pipelineState = cbs = ColorBlendState::create(*colorBlend);
+        else if (auto dynamic = pipelineState.cast<DynamicState>())
+            pipelineState = dynamicState = DynamicState::create(*dynamic);
+    }
+
+    if (!dynamicState)
+    {
+        dynamicState = DynamicState::create();
+        pipelineStates.push_back(dynamicState);
+    }
+
+    auto defaultRS = RasterizationState::create();
+    auto defaultDSS = DepthStencilState::create();
+    auto defaultIAS = InputAssemblyState::create();
+
+    for (auto state : dynamicStates)
+    {
+        switch (state)
+        {
+        case VK_DYNAMIC_STATE_CULL_MODE_EXT:
+            if (rs) rs->cullMode = defaultRS->cullMode;
+            break;
+        case VK_DYNAMIC_STATE_FRONT_FACE_EXT:
+            if (rs) rs->frontFace = defaultRS->frontFace;
+            break;
+        case VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT:
+            if (rs) rs->rasterizerDiscardEnable = defaultRS->rasterizerDiscardEnable;
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT:
+            if (rs) rs->depthBiasEnable = defaultRS->depthBiasEnable;
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT:
+            if (rs) rs->depthClampEnable = defaultRS->depthClampEnable;
+            break;
+        case VK_DYNAMIC_STATE_POLYGON_MODE_EXT:
+            if (rs) rs->polygonMode = defaultRS->polygonMode;
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT:
+            if (dss) dss->depthTestEnable = defaultDSS->depthTestEnable;
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT:
+            if (dss) dss->depthWriteEnable = defaultDSS->depthWriteEnable;
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT:
+            if (dss) dss->depthCompareOp = defaultDSS->depthCompareOp;
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT:
+            if (dss) dss->depthBoundsTestEnable = defaultDSS->depthBoundsTestEnable;
+            break;
+        case VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT:
+            if (dss) dss->stencilTestEnable = defaultDSS->stencilTestEnable;
+            break;
+        case VK_DYNAMIC_STATE_STENCIL_OP_EXT:
+            if (dss)
+            {
+                for (auto* sos : {&dss->front, &dss->back})
+                {
+                    sos->failOp = VK_STENCIL_OP_KEEP;
+                    sos->passOp = VK_STENCIL_OP_KEEP;
+                    sos->depthFailOp = VK_STENCIL_OP_KEEP;
+                    sos->compareOp = VK_COMPARE_OP_NEVER;
+                }
+            }
+            break;
+        case VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT:
+            if (ias) ias->topology = topologyClass(ias->topology);
+            break;
+        case VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT:
+            if (ias) ias->primitiveRestartEnable = defaultIAS->primitiveRestartEnable;
+            break;
+        case VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT:
+            if (cbs)
+            {
+                for (auto& attachment : cbs->attachments) attachment.blendEnable = VK_FALSE;
+            }
+            break;
+        case VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT:
+            if (cbs)
+            {
+                for (auto& attachment : cbs->attachments)
+                {
+                    attachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+                    attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+                    attachment.colorBlendOp = VK_BLEND_OP_ADD;
+                    attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+                    attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+                    attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+                }
+            }
+            break;
+        case VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT:
+            if (cbs)
+            {
+                for (auto& attachment : cbs->attachments) attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+            }
+            break;
+        default:
+            break;
+        }
+
+        auto& pipelineDynamicStates = dynamicState->dynamicStates;
+        if (std::find(pipelineDynamicStates.begin(), pipelineDynamicStates.end(), state) == pipelineDynamicStates.end()) pipelineDynamicStates.push_back(state);
+    }
+}
+
+int SetDynamicState::compare(const Object& rhs_object) const
+{
+    int result = StateCommand::compare(rhs_object);
+    if (result != 0) return result;
+
+    auto& rhs = static_cast<decltype(*this)>(rhs_object);
+
+    if ((result = compare_value_container(dynamicStates, rhs.dynamicStates))) return result;
+    if ((result = compare_pointer(rasterizationState, rhs.rasterizationState))) return result;
+    if ((result = compare_pointer(depthStencilState, rhs.depthStencilState))) return result;
+    if ((result = compare_pointer(inputAssemblyState, rhs.inputAssemblyState))) return result;
+    return compare_pointer(colorBlendState, rhs.colorBlendState);
+}
+
+void SetDynamicState::read(Input& input)
+{
+    StateCommand::read(input);
+
+    dynamicStates.resize(input.readValue<uint32_t>("NumDynamicStates"));
+    for (auto& dynamicState : dynamicStates)
+    {
+        input.readValue<uint32_t>("value", dynamicState);
+    }
+
+    input.readObject("rasterizationState", rasterizationState);
+    input.readObject("depthStencilState", depthStencilState);
+    input.readObject("inputAssemblyState", inputAssemblyState);
+    input.readObject("colorBlendState", colorBlendState);
+}
+
+void SetDynamicState::write(Output& output) const
+{
+    StateCommand::write(output);
+
+    output.writeValue<uint32_t>("NumDynamicStates", dynamicStates.size());
+    for (auto& dynamicState : dynamicStates)
+    {
+        output.writeValue<uint32_t>("value", dynamicState);
+    }
+
+    output.writeObject("rasterizationState", rasterizationState);
+    output.writeObject("depthStencilState", depthStencilState);
+    output.writeObject("inputAssemblyState", inputAssemblyState);
+    output.writeObject("colorBlendState", colorBlendState);
+}
+
+void SetDynamicState::compile(Context& context)
+{
+    auto extensions = context.device->getExtensions();
+    for (auto dynamicState : dynamicStates)
+    {
+        if (supported(dynamicState) && !available(*extensions, dynamicState))
+        {
+            warn("SetDynamicState::compile() dynamic state ", dynamicState, " not supported by device, extended dynamic state extension not enabled.");
+        }
+    }
+
+    _colorBlendEnables.clear();
+    _colorBlendEquations.clear();
+    _colorWriteMasks.clear();
+
+    if (colorBlendState)
+    {
+        for (auto& attachment : colorBlendState->attachments)
+        {
+            _colorBlendEnables.push_back(attachment.blendEnable);
+            _colorBlendEquations.push_back(VkColorBlendEquationEXT{attachment.srcColorBlendFactor, attachment.dstColorBlendFactor, attachment.colorBlendOp,
+                                                                   attachment.srcAlphaBlendFactor, attachment.dstAlphaBlendFactor, attachment.alphaBlendOp});
+            _colorWriteMasks.push_back(attachment.colorWriteMask);
+        }
+    }
+}
+
+void SetDynamicState::record(CommandBuffer& commandBuffer) const
+{
+    auto& extensions = *(commandBuffer.getDevice()->getExtensions());
+    auto numAttachments = static_cast<uint32_t>(_colorBlendEnables.size());
+
+    for (auto dynamicState : dynamicStates)
+    {
+        if (!available(extensions, dynamicState)) continue;
+
+        switch (dynamicState)
+        {
+        case VK_DYNAMIC_STATE_CULL_MODE_EXT:
+            if (rasterizationState) extensions.vkCmdSetCullMode(commandBuffer, rasterizationState->cullMode);
+            break;
+        case VK_DYNAMIC_STATE_FRONT_FACE_EXT:
+            if (rasterizationState) extensions.vkCmdSetFrontFace(commandBuffer, rasterizationState->frontFace);
+            break;
+        case VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT:
+            if (rasterizationState) extensions.vkCmdSetRasterizerDiscardEnable(commandBuffer, rasterizationState->rasterizerDiscardEnable);
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT:
+            if (rasterizationState) extensions.vkCmdSetDepthBiasEnable(commandBuffer, rasterizationState->depthBiasEnable);
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT:
+            if (rasterizationState) extensions.vkCmdSetDepthClampEnableEXT(commandBuffer, rasterizationState->depthClampEnable);
+            break;
+        case VK_DYNAMIC_STATE_POLYGON_MODE_EXT:
+            if (rasterizationState) extensions.vkCmdSetPolygonModeEXT(commandBuffer, rasterizationState->polygonMode);
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT:
+            if (depthStencilState) extensions.vkCmdSetDepthTestEnable(commandBuffer, depthStencilState->depthTestEnable);
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT:
+            if (depthStencilState) extensions.vkCmdSetDepthWriteEnable(commandBuffer, depthStencilState->depthWriteEnable);
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT:
+            if (depthStencilState) extensions.vkCmdSetDepthCompareOp(commandBuffer, depthStencilState->depthCompareOp);
+            break;
+        case VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT:
+            if (depthStencilState) extensions.vkCmdSetDepthBoundsTestEnable(commandBuffer, depthStencilState->depthBoundsTestEnable);
+            break;
+        case VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT:
+            if (depthStencilState) extensions.vkCmdSetStencilTestEnable(commandBuffer, depthStencilState->stencilTestEnable);
+            break;
+        case VK_DYNAMIC_STATE_STENCIL_OP_EXT:
+            if (depthStencilState)
+            {
+                auto& front = depthStencilState->front;
+                auto& back = depthStencilState->back;
+                extensions.vkCmdSetStencilOp(commandBuffer, VK_STENCIL_FACE_FRONT_BIT, front.failOp, front.passOp, front.depthFailOp, front.compareOp);
+                extensions.vkCmdSetStencilOp(commandBuffer, VK_STENCIL_FACE_BACK_BIT, back.failOp, back.passOp, back.depthFailOp, back.compareOp);
+            }
+            break;
+        case VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT:
+            if (inputAssemblyState) extensions.vkCmdSetPrimitiveTopology(commandBuffer, inputAssemblyState->topology);
+            break;
+        case VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT:
+            if (inputAssemblyState) extensions.vkCmdSetPrimitiveRestartEnable(commandBuffer, inputAssemblyState->primitiveRestartEnable);
+            break;
+        case VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT:
+            if (numAttachments > 0) extensions.vkCmdSetColorBlendEnableEXT(commandBuffer, 0, numAttachments, _colorBlendEnables.data());
+            break;
+        case VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT:
+            if (numAttachments > 0) extensions.vkCmdSetColorBlendEquationEXT(commandBuffer, 0, numAttachments, _colorBlendEquations.data());
+            break;
+        case VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT:
+            if (numAttachments > 0) extensions.vkCmdSetColorWriteMaskEXT(commandBuffer, 0, numAttachments, _colorWriteMasks.data());
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -11,6 +11,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/app/View.h>
+#include <vsg/commands/CopyImage.h>
 #include <vsg/commands/PipelineBarrier.h>
 #include <vsg/core/compare.h>
 #include <vsg/io/Logger.h>
@@ -18,8 +19,13 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/write.h>
 #include <vsg/state/DescriptorImage.h>
 #include <vsg/state/ViewDependentState.h>
+#include <vsg/ui/FrameStamp.h>
 #include <vsg/vk/Context.h>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 using namespace vsg;
 
 //////////////////////////////////////
@@ -55,6 +61,56 @@ namespace vsg
         return Clog * lambda + Cuniform * (1.0 - lambda);
     };
 
+    /// return the rotation, about the origin, that minimizes the area of the axis aligned bounding rectangle of the points
+    inline double minimumAreaRotation(std::vector<dvec2> points)
+    {
+        // convex hull using Andrew's monotone chain
+        std::sort(points.begin(), points.end(), [](const dvec2& lhs, const dvec2& rhs) { return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y); });
+        auto turn = [](const dvec2& o, const dvec2& a, const dvec2& b) { return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x); };
+
+        std::vector<dvec2> hull(points.size() * 2);
+        size_t k = 0;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            while (k >= 2 && turn(hull[k - 2], hull[k - 1], points[i]) <= 0.0) --k;
+            hull[k++] = points[i];
+        }
+        for (size_t i = points.size() - 1, t = k + 1; i > 0; --i)
+        {
+            while (k >= t && turn(hull[k - 2], hull[k - 1], points[i - 1]) <= 0.0) --k;
+            hull[k++] = points[i - 1];
+        }
+        hull.resize(k > 1 ? k - 1 : k);
+
+        // the minimum area rectangle has a side collinear with one of the hull's edges
+        double bestAngle = 0.0;
+        double bestArea = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < hull.size(); ++i)
+        {
+            auto edge = hull[(i + 1) % hull.size()] - hull[i];
+            if (edge.x == 0.0 && edge.y == 0.0) continue;
+
+            double angle = std::atan2(edge.y, edge.x);
+            double c = std::cos(angle), s = std::sin(angle);
+            dvec2 minimum(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+            dvec2 maximum(-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max());
+            for (auto& v : hull)
+            {
+                dvec2 r(v.x * c + v.y * s, -v.x * s + v.y * c);
+                minimum.set(std::min(minimum.x, r.x), std::min(minimum.y, r.y));
+                maximum.set(std::max(maximum.x, r.x), std::max(maximum.y, r.y));
+            }
+
+            double area = (maximum.x - minimum.x) * (maximum.y - minimum.y);
+            if (area < bestArea)
+            {
+                bestArea = area;
+                bestAngle = angle;
+            }
+        }
+        return bestAngle;
+    }
+
 } // namespace vsg
 
 //////////////////////////////////////
@@ -280,7 +336,15 @@ void ViewDependentState::init(ResourceRequirements& requirements)
 
     if (maxShadowMaps > 0)
     {
-        shadowDepthImage = createShadowImage(shadowWidth, shadowHeight, maxShadowMaps, VK_FORMAT_D32_SFLOAT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (cacheShadowMaps)
+        {
+            // the static casters are rendered into their own image and copied into the shadow map each frame
+            staticShadowDepthImage = createShadowImage(shadowWidth, shadowHeight, maxShadowMaps, VK_FORMAT_D32_SFLOAT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+            usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
+
+        shadowDepthImage = createShadowImage(shadowWidth, shadowHeight, maxShadowMaps, VK_FORMAT_D32_SFLOAT, usage);
 
         auto depthImageView = ImageView::create(shadowDepthImage, VK_IMAGE_ASPECT_DEPTH_BIT);
         depthImageView->viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
@@ -324,8 +388,36 @@ void ViewDependentState::init(ResourceRequirements& requirements)
         VkDescriptorSetLayoutBinding{2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr},                      // shadow map 2D texture array
     };
 
+    Descriptors descriptors{descriptor, shadowMapImages};
+
+    if (clusteredLighting && maxNumberLights > 0)
+    {
+        uint32_t numClusters = clusterDimensions.x * clusterDimensions.y * clusterDimensions.z;
+        clusterData = uintArray::create(8 + numClusters * 2 + maxClusterLightIndices, 0u);
+        clusterData->properties.dataVariance = DYNAMIC_DATA_TRANSFER_AFTER_RECORD;
+        clusterDataBufferInfo = BufferInfo::create(clusterData.get());
+        clusterDescriptor = DescriptorBuffer::create(BufferInfoList{clusterDataBufferInfo}, 3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+        descriptorBindings.push_back(VkDescriptorSetLayoutBinding{3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr}); // light clusters
+        descriptors.push_back(clusterDescriptor);
+    }
+
+    if (!view->multiviewCameras.empty())
+    {
+        if (view->multiviewCameras.size() > maxMultiviews) warn("ViewDependentState::init() ", view->multiviewCameras.size(), " multiviewCameras exceeds the maximum of ", maxMultiviews, ", only the first ", maxMultiviews, " will be rendered.");
+
+        // sized for maxMultiviews as the shaders declare the full array
+        multiviewData = mat4Array::create(maxMultiviews * 2);
+        multiviewData->properties.dataVariance = DYNAMIC_DATA_TRANSFER_AFTER_RECORD;
+        multiviewDataBufferInfo = BufferInfo::create(multiviewData.get());
+        multiviewDescriptor = DescriptorBuffer::create(BufferInfoList{multiviewDataBufferInfo}, 4, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+
+        descriptorBindings.push_back(VkDescriptorSetLayoutBinding{4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr}); // multiview matrices
+        descriptors.push_back(multiviewDescriptor);
+    }
+
     descriptorSetLayout = DescriptorSetLayout::create(descriptorBindings);
-    descriptorSet = DescriptorSet::create(descriptorSetLayout, Descriptors{descriptor, shadowMapImages});
+    descriptorSet = DescriptorSet::create(descriptorSetLayout, descriptors);
 
     // if not active then don't enable shadow maps
     if (maxShadowMaps == 0) return;
@@ -355,13 +447,60 @@ void ViewDependentState::init(ResourceRequirements& requirements)
             shadowMap.view = first_view;
         }
 
-        shadowMap.view->mask = shadowMask;
+        shadowMap.view->mask = cacheShadowMaps ? dynamicShadowCasterMask : shadowMask;
         shadowMap.view->camera = Camera::create();
         shadowMap.view->addChild(tcon);
 
         shadowMap.renderGraph = RenderGraph::create();
         shadowMap.renderGraph->addChild(shadowMap.view);
-        preRenderSwitch->addChild(MASK_ALL, shadowMap.renderGraph);
+
+        if (!cacheShadowMaps)
+        {
+            preRenderSwitch->addChild(MASK_ALL, shadowMap.renderGraph);
+            continue;
+        }
+
+        // static casters share the dynamic casters' camera but are only rendered when it's refitted
+        shadowMap.staticView = View::create(*first_view);
+        shadowMap.staticView->mask = staticShadowCasterMask;
+        shadowMap.staticView->camera = shadowMap.view->camera;
+        shadowMap.staticView->addChild(tcon);
+
+        shadowMap.staticRenderGraph = RenderGraph::create();
+        shadowMap.staticRenderGraph->addChild(shadowMap.staticView);
+
+        shadowMap.staticSwitch = Switch::create();
+        shadowMap.staticSwitch->addChild(MASK_ALL, shadowMap.staticRenderGraph);
+
+        // copy the cached static casters' depth into the shadow map layer, ready for the dynamic casters to be rendered on top
+        uint32_t layer = static_cast<uint32_t>(&shadowMap - shadowMaps.data());
+        VkImageSubresourceRange layerRange{VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, layer, 1};
+
+        auto srcBarrier = ImageMemoryBarrier::create(VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                                                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                     VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, staticShadowDepthImage, layerRange);
+        auto dstBarrier = ImageMemoryBarrier::create(VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                     VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, shadowDepthImage, layerRange);
+        auto preCopyBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+        preCopyBarrier->add(srcBarrier);
+        preCopyBarrier->add(dstBarrier);
+
+        auto copyImage = CopyImage::create();
+        copyImage->srcImage = staticShadowDepthImage;
+        copyImage->srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        copyImage->dstImage = shadowDepthImage;
+        copyImage->dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        copyImage->regions.push_back(VkImageCopy{VkImageSubresourceLayers{VK_IMAGE_ASPECT_DEPTH_BIT, 0, layer, 1}, VkOffset3D{0, 0, 0},
+                                                 VkImageSubresourceLayers{VK_IMAGE_ASPECT_DEPTH_BIT, 0, layer, 1}, VkOffset3D{0, 0, 0},
+                                                 shadowDepthImage->extent});
+
+        auto group = Group::create();
+        group->addChild(shadowMap.staticSwitch);
+        group->addChild(preCopyBarrier);
+        group->addChild(copyImage);
+        group->addChild(shadowMap.renderGraph);
+        preRenderSwitch->addChild(MASK_ALL, group);
     }
 }
 
@@ -390,11 +529,12 @@ void ViewDependentState::compile(Context& context)
 
         shadowDepthImage->compile(context);
 
-        uint32_t layer = 0;
-        for (auto& shadowMap : shadowMaps)
-        {
+        if (staticShadowDepthImage) staticShadowDepthImage->compile(context);
+
+        auto setUpRenderGraph = [&](RenderGraph& rendergraph, ref_ptr<Image> image, uint32_t layer, VkAttachmentLoadOp loadOp, VkImageLayout initialLayout, VkImageLayout finalLayout,
+                                    VkPipelineStageFlags srcStageMask, VkAccessFlags srcAccessMask, VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask) {
             // create depth buffer
-            auto depthImageView = ImageView::create(shadowDepthImage, VK_IMAGE_ASPECT_DEPTH_BIT);
+            auto depthImageView = ImageView::create(image, VK_IMAGE_ASPECT_DEPTH_BIT);
             depthImageView->viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
             depthImageView->subresourceRange.baseMipLevel = 0;
             depthImageView->subresourceRange.levelCount = 1;
@@ -405,14 +545,14 @@ void ViewDependentState::compile(Context& context)
             // attachment descriptions
             RenderPass::Attachments attachments(1);
             // Depth attachment
-            attachments[0].format = shadowDepthImage->format;
+            attachments[0].format = image->format;
             attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
-            attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            attachments[0].loadOp = loadOp;
             attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
             attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
             attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            attachments[0].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+            attachments[0].initialLayout = initialLayout;
+            attachments[0].finalLayout = finalLayout;
 
             AttachmentReference ignoreColorReference = {VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED};
             AttachmentReference depthReference = {0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
@@ -425,18 +565,19 @@ void ViewDependentState::compile(Context& context)
 
             dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
             dependencies[0].dstSubpass = 0;
-            dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            dependencies[0].srcStageMask = srcStageMask;
             dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-            dependencies[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            dependencies[0].srcAccessMask = srcAccessMask;
             dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            if (loadOp == VK_ATTACHMENT_LOAD_OP_LOAD) dependencies[0].dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
             dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
             dependencies[1].srcSubpass = 0;
             dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
             dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-            dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            dependencies[1].dstStageMask = dstStageMask;
             dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            dependencies[1].dstAccessMask = dstAccessMask;
             dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
             auto renderPass = RenderPass::create(context.device, attachments, subpassDescription, dependencies);
@@ -444,13 +585,31 @@ void ViewDependentState::compile(Context& context)
             // Framebuffer
             auto fbuf = Framebuffer::create(renderPass, ImageViews{depthImageView}, extent.width, extent.height, 1);
 
-            auto rendergraph = shadowMap.renderGraph;
-            rendergraph->renderArea.offset = VkOffset2D{0, 0};
-            rendergraph->renderArea.extent = VkExtent2D{extent.width, extent.height};
-            rendergraph->framebuffer = fbuf;
+            rendergraph.renderArea.offset = VkOffset2D{0, 0};
+            rendergraph.renderArea.extent = VkExtent2D{extent.width, extent.height};
+            rendergraph.framebuffer = fbuf;
+            rendergraph.dynamicRendering = context.dynamicRendering;
 
-            rendergraph->clearValues.resize(1);
-            rendergraph->clearValues[0].depthStencil = VkClearDepthStencilValue{0.0f, 0};
+            rendergraph.clearValues.resize(1);
+            rendergraph.clearValues[0].depthStencil = VkClearDepthStencilValue{0.0f, 0};
+        };
+
+        uint32_t layer = 0;
+        for (auto& shadowMap : shadowMaps)
+        {
+            if (shadowMap.staticRenderGraph)
+            {
+                // static casters are cleared and rendered into the cache, then the dynamic casters are rendered over the copy of the cache in the shadow map
+                setUpRenderGraph(*shadowMap.staticRenderGraph, staticShadowDepthImage, layer, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+                setUpRenderGraph(*shadowMap.renderGraph, shadowDepthImage, layer, VK_ATTACHMENT_LOAD_OP_LOAD, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+            }
+            else
+            {
+                setUpRenderGraph(*shadowMap.renderGraph, shadowDepthImage, layer, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+            }
 
             ++layer;
         }
@@ -489,6 +648,19 @@ void ViewDependentState::traverse(RecordTraversal& rt) const
     //GPU_INSTRUMENTATION_L1_NC(rt.instrumentation, *rt.getCommandBuffer(), "ViewDependentState", COLOR_RECORD_L1);
     CPU_INSTRUMENTATION_L1_NC(rt.instrumentation, "ViewDependentState", COLOR_RECORD_L1);
 
+    if (multiviewData && view->camera)
+    {
+        auto inverse_viewMatrix = view->camera->viewMatrix->inverse();
+        auto numViews = std::min(view->multiviewCameras.size(), static_cast<size_t>(maxMultiviews));
+        for (size_t i = 0; i < numViews; ++i)
+        {
+            auto& camera = view->multiviewCameras[i];
+            multiviewData->set(i * 2, mat4(camera->projectionMatrix->transform()));
+            multiviewData->set(i * 2 + 1, mat4(camera->viewMatrix->transform() * inverse_viewMatrix));
+        }
+        multiviewData->dirty();
+    }
+
     if ((view->features & RECORD_SHADOW_MAPS) == 0) return;
 
     // useful reference : https://learn.microsoft.com/en-us/windows/win32/dxtecharts/cascaded-shadow-maps
@@ -528,11 +700,14 @@ void ViewDependentState::traverse(RecordTraversal& rt) const
         return bounds;
     };
 
+    // when shadow maps are cached or distant cascades updated periodically the shadow map cameras are only refitted when required
+    bool incrementalShadowMaps = cacheShadowMaps || distantCascadeUpdateInterval > 1;
+    uint64_t frameCount = rt.getFrameStamp() ? rt.getFrameStamp()->frameCount : 0;
+
     // info("\n\nViewDependentState::traverse(", &rt, ", ", &view, ") numShadowMaps = ", numShadowMaps);
 
     // set up the light data
     auto light_itr = lightData->begin();
-    lightData->dirty();
 
     (*light_itr++) = vec4(static_cast<float>(ambientLights.size()),
                           static_cast<float>(directionalLights.size()),
@@ -599,14 +774,106 @@ void ViewDependentState::traverse(RecordTraversal& rt) const
             // near plane further than maximum shadow distance so no need to generate shadow maps
             continue;
         }
-        if (f > maxShadowDistance)
+        if (f > maxShadowDistance || !(f > n))
         {
+            // an infinite far plane maps to infinity, or past it if its inverse isn't exact, so also clamp when f isn't beyond n
             f = maxShadowDistance;
         }
 
-        auto updateCamera = [&](double clip_near_z, double clip_far_z, const dmat4& clipToWorld) -> void {
-            const auto& shadowMap = shadowMaps[shadowMapIndex];
-            preRenderSwitch->children[shadowMapIndex].mask = MASK_ALL;
+        // use the application provided receiver depth range, such as from a depth reduction of the previous frame, to tighten the cascade splits
+        if (receiverDepthRange.y > receiverDepthRange.x)
+        {
+            n = std::max(n, receiverDepthRange.x);
+            f = std::min(f, receiverDepthRange.y);
+            if (n >= f) continue;
+        }
+
+        const void* current_light = light;
+
+        // fit the shadow map camera to the view frustum slice between clip_near_z and clip_far_z, enlarged by the margin
+        auto fitCamera = [&](LookAt& lookAt, Orthographic& ortho, double clip_near_z, double clip_far_z, const dmat4& clipToWorld, double margin) -> void {
+            if (cascadeFitting == FIT_STABILIZED)
+            {
+                // the bounding sphere of the frustum slice is computed in eye coords so its size doesn't change as the view rotates
+                dvec3 corners[8] = {
+                    clipToEye * dvec3(-1.0, -1.0, clip_near_z), clipToEye * dvec3(-1.0, 1.0, clip_near_z), clipToEye * dvec3(1.0, -1.0, clip_near_z), clipToEye * dvec3(1.0, 1.0, clip_near_z),
+                    clipToEye * dvec3(-1.0, -1.0, clip_far_z), clipToEye * dvec3(-1.0, 1.0, clip_far_z), clipToEye * dvec3(1.0, -1.0, clip_far_z), clipToEye * dvec3(1.0, 1.0, clip_far_z)};
+
+                dvec3 eye_center;
+                for (auto& corner : corners) eye_center += corner;
+                eye_center /= 8.0;
+
+                double radius = 0.0;
+                for (auto& corner : corners) radius = std::max(radius, length(corner - eye_center));
+                radius *= (1.0 + margin);
+
+                // light space basis that is independent of the view direction
+                auto stable_x = cross(light_z, std::abs(light_z.z) < 0.9 ? dvec3(0.0, 0.0, 1.0) : dvec3(0.0, 1.0, 0.0));
+                stable_x = normalize(stable_x);
+                auto stable_y = cross(stable_x, light_z);
+
+                // snap the center to whole texels so the shadow map doesn't shimmer as the view moves
+                double texelSize = (2.0 * radius) / static_cast<double>(shadowDepthImage->extent.width);
+                auto ws_center = inverse_viewMatrix * eye_center;
+                double cx = dot(ws_center, stable_x), cy = dot(ws_center, stable_y);
+                ws_center += stable_x * (std::floor(cx / texelSize) * texelSize - cx) + stable_y * (std::floor(cy / texelSize) * texelSize - cy);
+
+                auto sm_eye = ws_center - light_z * (radius + shadowCasterExtension);
+                lookAt.eye = sm_eye;
+                lookAt.center = sm_eye + light_z;
+                lookAt.up = stable_y;
+
+                ortho.left = -radius;
+                ortho.right = radius;
+                ortho.bottom = -radius;
+                ortho.top = radius;
+                ortho.nearDistance = 0.0;
+                ortho.farDistance = 2.0 * radius + shadowCasterExtension;
+                return;
+            }
+
+            auto ws_bounds = computeFrustumBounds(clip_near_z, clip_far_z, clipToWorld);
+            auto ws_center = (ws_bounds.min + ws_bounds.max) * 0.5;
+            auto sm_eye = ws_center - light_z * (0.5 * length(ws_bounds.max - ws_bounds.min) * (1.0 + margin) + shadowCasterExtension);
+
+            lookAt.eye = sm_eye;
+            lookAt.center = sm_eye + light_z;
+            lookAt.up = light_y;
+
+            if (cascadeFitting == FIT_TIGHT)
+            {
+                // rotate the shadow map about the light direction so the frustum slice's footprint fills as much of it as possible
+                auto ls_matrix = lookAt.transform() * clipToWorld;
+                std::vector<dvec2> footprint;
+                for (auto z : {clip_near_z, clip_far_z})
+                {
+                    for (auto& xy : {dvec2(-1.0, -1.0), dvec2(-1.0, 1.0), dvec2(1.0, -1.0), dvec2(1.0, 1.0)})
+                    {
+                        auto v = ls_matrix * dvec3(xy.x, xy.y, z);
+                        footprint.emplace_back(v.x, v.y);
+                    }
+                }
+
+                double angle = minimumAreaRotation(footprint);
+                auto vm = lookAt.transform();
+                dvec3 ls_x(vm[0][0], vm[1][0], vm[2][0]);
+                dvec3 ls_y(vm[0][1], vm[1][1], vm[2][1]);
+                lookAt.up = ls_y * std::cos(angle) - ls_x * std::sin(angle);
+            }
+
+            auto ls_bounds = computeFrustumBounds(clip_near_z, clip_far_z, lookAt.transform() * clipToWorld);
+            auto ls_margin = (ls_bounds.max - ls_bounds.min) * (0.5 * margin);
+
+            ortho.left = ls_bounds.min.x - ls_margin.x;
+            ortho.right = ls_bounds.max.x + ls_margin.x;
+            ortho.bottom = ls_bounds.min.y - ls_margin.y;
+            ortho.top = ls_bounds.max.y + ls_margin.y;
+            ortho.nearDistance = std::max(0.0, -ls_bounds.max.z - ls_margin.z - shadowCasterExtension);
+            ortho.farDistance = -ls_bounds.min.z + ls_margin.z;
+        };
+
+        auto updateCamera = [&](double clip_near_z, double clip_far_z, const dmat4& clipToWorld, uint32_t cascade) -> void {
+            auto& shadowMap = shadowMaps[shadowMapIndex];
 
             const auto& camera = shadowMap.view->camera;
             auto lookAt = camera->viewMatrix.cast<LookAt>();
@@ -615,21 +882,38 @@ void ViewDependentState::traverse(RecordTraversal& rt) const
             if (!lookAt) camera->viewMatrix = lookAt = LookAt::create();
             if (!ortho) camera->projectionMatrix = ortho = Orthographic::create();
 
-            auto ws_bounds = computeFrustumBounds(clip_near_z, clip_far_z, clipToWorld);
-            auto sm_eye = (ws_bounds.min + ws_bounds.max) * 0.5 - light_z * (0.5 * length(ws_bounds.max - ws_bounds.min));
-
-            lookAt->eye = sm_eye;
-            lookAt->center = sm_eye + light_z;
-            lookAt->up = light_y;
-
-            auto ls_bounds = computeFrustumBounds(clip_near_z, clip_far_z, lookAt->transform() * clipToWorld);
+            if (!incrementalShadowMaps)
+            {
+                preRenderSwitch->children[shadowMapIndex].mask = MASK_ALL;
 
-            ortho->left = ls_bounds.min.x;
-            ortho->right = ls_bounds.max.x;
-            ortho->bottom = ls_bounds.min.y;
-            ortho->top = ls_bounds.max.y;
-            ortho->nearDistance = -ls_bounds.max.z;
-            ortho->farDistance = -ls_bounds.min.z;
+                fitCamera(*lookAt, *ortho, clip_near_z, clip_far_z, clipToWorld, 0.0);
+            }
+            else
+            {
+                // reuse the previous fit if the light is unchanged and the frustum slice still lies within the shadow map's bounds
+                bool refit = !shadowMap.valid || shadowMap.light != current_light || dot(shadowMap.lightDirection, light_direction) < (1.0 - 1e-6);
+                if (!refit)
+                {
+                    auto ls_bounds = computeFrustumBounds(clip_near_z, clip_far_z, lookAt->transform() * clipToWorld);
+                    refit = ls_bounds.min.x < ortho->left || ls_bounds.max.x > ortho->right ||
+                            ls_bounds.min.y < ortho->bottom || ls_bounds.max.y > ortho->top ||
+                            -ls_bounds.max.z < ortho->nearDistance || -ls_bounds.min.z > ortho->farDistance;
+                }
+
+                if (refit)
+                {
+                    fitCamera(*lookAt, *ortho, clip_near_z, clip_far_z, clipToWorld, shadowMapCacheMargin);
+
+                    shadowMap.valid = true;
+                    shadowMap.light = current_light;
+                    shadowMap.lightDirection = light_direction;
+                }
+
+                // the first cascade covers the area closest to the viewer so is updated every frame, the more distant cascades are staggered across frames
+                bool periodic = cascade == 0 || distantCascadeUpdateInterval <= 1 || ((frameCount + shadowMapIndex) % distantCascadeUpdateInterval) == 0;
+                preRenderSwitch->children[shadowMapIndex].mask = (refit || periodic) ? MASK_ALL : MASK_OFF;
+                if (shadowMap.staticSwitch) shadowMap.staticSwitch->setAllChildren(refit);
+            }
 
             dmat4 shadowMapProjView = camera->projectionMatrix->transform() * camera->viewMatrix->transform();
 
@@ -672,7 +956,7 @@ void ViewDependentState::traverse(RecordTraversal& rt) const
                 auto clip_near = projectionMatrix * eye_near;
                 auto clip_far = projectionMatrix * eye_far;
 
-                updateCamera(clip_near.z, clip_far.z, clipToWorld);
+                updateCamera(clip_near.z, clip_far.z, clipToWorld, static_cast<uint32_t>(i));
             }
         }
         else
@@ -683,13 +967,16 @@ void ViewDependentState::traverse(RecordTraversal& rt) const
             auto clip_near = projectionMatrix * eye_near;
             auto clip_far = projectionMatrix * eye_far;
 
-            updateCamera(clip_near.z, clip_far.z, clipToWorld);
+            updateCamera(clip_near.z, clip_far.z, clipToWorld, 0);
         }
     }
 
+    _clusterLights.clear();
+
     for (auto& [mv, light] : pointLights)
     {
         auto eye_position = mv * light->position;
+        if (clusterData) _clusterLights.push_back(ClusterLight{static_cast<uint32_t>(&(*light_itr) - lightData->data()), eye_position, lightRange(*light)});
         (*light_itr++).set(light->color.r, light->color.g, light->color.b, light->intensity);
         (*light_itr++).set(static_cast<float>(eye_position.x), static_cast<float>(eye_position.y), static_cast<float>(eye_position.z), 0.0f);
     }
@@ -700,11 +987,17 @@ void ViewDependentState::traverse(RecordTraversal& rt) const
         auto eye_direction = normalize(light->direction * inverse_3x3(mv));
         float cos_innerAngle = static_cast<float>(cos(light->innerAngle));
         float cos_outerAngle = static_cast<float>(cos(light->outerAngle));
+        if (clusterData) _clusterLights.push_back(ClusterLight{static_cast<uint32_t>(&(*light_itr) - lightData->data()) | 0x80000000, eye_position, lightRange(*light)});
         (*light_itr++).set(light->color.r, light->color.g, light->color.b, light->intensity);
         (*light_itr++).set(static_cast<float>(eye_position.x), static_cast<float>(eye_position.y), static_cast<float>(eye_position.z), cos_innerAngle);
         (*light_itr++).set(static_cast<float>(eye_direction.x), static_cast<float>(eye_direction.y), static_cast<float>(eye_direction.z), cos_outerAngle);
     }
 
+    // only the packed lights need transferring, the counts in the first vec4 tell the shaders how much of lightData to read
+    lightData->dirty(0, static_cast<size_t>(&(*light_itr) - lightData->data()) * sizeof(vec4));
+
+    if (clusterData) assignLightClusters(_clusterLights);
+
     if (requiresPerRenderShadowMaps && preRenderCommandGraph)
     {
         if (rt.instrumentation && !preRenderCommandGraph->instrumentation)
@@ -717,8 +1010,148 @@ void ViewDependentState::traverse(RecordTraversal& rt) const
     }
 }
 
+dsphere ViewDependentState::lightBound(const SpotLight& light) const
+{
+    // bounding sphere of the cone from the light position along its direction out to the light's range
+    double range = lightRange(light);
+    double angle = light.outerAngle;
+    auto direction = normalize(light.direction);
+    if (angle > PI * 0.25)
+    {
+        return dsphere(light.position + direction * (range * std::cos(angle)), range * std::sin(angle));
+    }
+
+    double radius = range / (2.0 * std::cos(angle));
+    return dsphere(light.position + direction * radius, radius);
+}
+
+void ViewDependentState::assignLightClusters(const std::vector<ClusterLight>& lights) const
+{
+    const uint32_t dimX = clusterDimensions.x, dimY = clusterDimensions.y, dimZ = clusterDimensions.z;
+    const uint32_t numClusters = dimX * dimY * dimZ;
+    const uint32_t indicesBase = 8 + numClusters * 2;
+    const uint32_t maxIndices = static_cast<uint32_t>(clusterData->size()) - indicesBase;
+
+    auto& data = *clusterData;
+    clusterData->dirty();
+
+    auto projectionMatrix = view->camera->projectionMatrix->transform();
+    auto clipToEye = inverse(projectionMatrix);
+    double n = -(clipToEye * dvec3(0.0, 0.0, 1.0)).z;
+    double f = -(clipToEye * dvec3(0.0, 0.0, 0.0)).z;
+    if (!std::isfinite(f) || std::abs(f) > std::numeric_limits<float>::max())
+    {
+        // infinite far plane, so limit the depth slices to the furthest reach of the lights
+        f = n;
+        for (auto& light : lights) f = std::max(f, -light.eye_position.z + light.range);
+    }
+    if (n > f) std::swap(n, f);
+    n = std::max(n, 1e-6);
+    f = std::max(f, n * (1.0 + 1e-6));
+
+    float near_f = static_cast<float>(n), far_f = static_cast<float>(f), zero_f = 0.0f;
+    data[0] = dimX;
+    data[1] = dimY;
+    data[2] = dimZ;
+    std::memcpy(&data[4], &near_f, sizeof(float));
+    std::memcpy(&data[5], &far_f, sizeof(float));
+    std::memcpy(&data[6], &zero_f, sizeof(float));
+    std::memcpy(&data[7], &zero_f, sizeof(float));
+
+    // compute the range of clusters each light's bounding sphere overlaps, packing min/max x, y and z into a uivec3
+    const double logDepthScale = static_cast<double>(dimZ) / std::log(f / n);
+    auto slice = [&](double d) { return static_cast<uint32_t>(std::clamp(std::floor(std::log(std::max(d, n) / n) * logDepthScale), 0.0, static_cast<double>(dimZ - 1))); };
+    auto tile = [](double ndc, uint32_t dim) { return static_cast<uint32_t>(std::clamp(std::floor((ndc * 0.5 + 0.5) * static_cast<double>(dim)), 0.0, static_cast<double>(dim - 1))); };
+
+    _clusterRanges.resize(lights.size());
+    _clusterCounts.assign(numClusters, 0);
+
+    for (size_t li = 0; li < lights.size(); ++li)
+    {
+        auto& light = lights[li];
+        auto& range = _clusterRanges[li];
+        range.set(1, 0, 0); // empty range
+
+        const auto& c = light.eye_position;
+        double r = light.range;
+        double d_near = std::max(-c.z - r, n);
+        double d_far = std::min(-c.z + r, f);
+        if (d_near > d_far) continue;
+
+        // project the corners of the sphere's eye space bounding box, with depths clamped to the slices, to find the tiles it covers
+        dvec2 ndc_min(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+        dvec2 ndc_max(-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max());
+        for (int i = 0; i < 8; ++i)
+        {
+            dvec4 corner((i & 1) ? c.x + r : c.x - r, (i & 2) ? c.y + r : c.y - r, (i & 4) ? -d_far : -d_near, 1.0);
+            auto clip = projectionMatrix * corner;
+            if (clip.w <= 0.0) continue;
+            ndc_min.set(std::min(ndc_min.x, clip.x / clip.w), std::min(ndc_min.y, clip.y / clip.w));
+            ndc_max.set(std::max(ndc_max.x, clip.x / clip.w), std::max(ndc_max.y, clip.y / clip.w));
+        }
+        if (ndc_min.x > 1.0 || ndc_max.x < -1.0 || ndc_min.y > 1.0 || ndc_max.y < -1.0) continue;
+
+        uint32_t x0 = tile(ndc_min.x, dimX), x1 = tile(ndc_max.x, dimX);
+        uint32_t y0 = tile(ndc_min.y, dimY), y1 = tile(ndc_max.y, dimY);
+        uint32_t z0 = slice(d_near), z1 = slice(d_far);
+        range.set(x0 | (x1 << 16), y0 | (y1 << 16), z0 | (z1 << 16));
+
+        for (uint32_t z = z0; z <= z1; ++z)
+            for (uint32_t y = y0; y <= y1; ++y)
+                for (uint32_t x = x0; x <= x1; ++x)
+                    ++_clusterCounts[(z * dimY + y) * dimX + x];
+    }
+
+    // prefix sum the counts into offsets, truncating clusters once the light index list is full
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < numClusters; ++i)
+    {
+        uint32_t count = std::min(_clusterCounts[i], maxIndices - offset);
+        data[8 + i * 2] = offset;
+        data[8 + i * 2 + 1] = 0;
+        _clusterCounts[i] = count;
+        offset += count;
+    }
+    data[3] = offset;
+
+    if (offset == maxIndices) debug("ViewDependentState::assignLightClusters() maxClusterLightIndices of ", maxClusterLightIndices, " exceeded, some lights have been dropped.");
+
+    for (size_t li = 0; li < lights.size(); ++li)
+    {
+        auto& range = _clusterRanges[li];
+        uint32_t x0 = range.x & 0xffff, x1 = range.x >> 16;
+        uint32_t y0 = range.y & 0xffff, y1 = range.y >> 16;
+        uint32_t z0 = range.z & 0xffff, z1 = range.z >> 16;
+        if (x0 > x1) continue;
+
+        for (uint32_t z = z0; z <= z1; ++z)
+        {
+            for (uint32_t y = y0; y <= y1; ++y)
+            {
+                for (uint32_t x = x0; x <= x1; ++x)
+                {
+                    uint32_t cluster = (z * dimY + y) * dimX + x;
+                    auto& count = data[8 + cluster * 2 + 1];
+                    if (count < _clusterCounts[cluster])
+                    {
+                        data[indicesBase + data[8 + cluster * 2] + count] = lights[li].lightDataIndex;
+                        ++count;
+                    }
+                }
+            }
+        }
+    }
+}
+
 void ViewDependentState::bindDescriptorSets(CommandBuffer& commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet)
 {
-    auto vk = descriptorSet->vk(commandBuffer.deviceID);
-    vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, layout, firstSet, 1, &vk, 0, nullptr);
+    auto dsi = descriptorSet->getImplementation(commandBuffer.deviceID);
+    ++commandBuffer.recordStatistics.descriptorSetsBound;
+    if (dsi->_descriptorHeap)
+    {
+        dsi->_descriptorHeap->bind(commandBuffer, pipelineBindPoint, layout, firstSet, 1, &(dsi->_descriptorHeapOffset));
+        return;
+    }
+
+    vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, layout, firstSet, 1, &(dsi->_descriptorSet), 0, nullptr);
 }
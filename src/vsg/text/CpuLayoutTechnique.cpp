@@ -32,6 +32,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/utils/GraphicsPipelineConfigurator.h>
 #include <vsg/utils/SharedObjects.h>
 
+#include <algorithm>
+
 using namespace vsg;
 
 void CpuLayoutTechnique::setup(Text* text, uint32_t minimumAllocation, ref_ptr<const Options> options)
@@ -43,6 +45,7 @@ void CpuLayoutTechnique::setup(Text* text, uint32_t minimumAllocation, ref_ptr<c
     auto shaderSet = text->shaderSet ? text->shaderSet : createTextShaderSet(options);
 
     textExtents = layout->extents(text->text, *font);
+    textRanges.clear();
 
     auto num_quads = vsg::visit<CountGlyphs>(text->text).count;
 
@@ -75,115 +78,230 @@ void CpuLayoutTechnique::setup(TextGroup* textGroup, uint32_t minimumAllocation,
         }
     }
 
+    uint32_t slack = (dataVariance >= DYNAMIC_DATA) ? textSlack : 0;
+
     TextQuads quads;
-    quads.reserve(countGlyphs.count);
+    quads.reserve(countGlyphs.count + textGroup->children.size() * slack);
+
+    textRanges.clear();
+    std::vector<bool> spare;
     for (auto& text : textGroup->children)
     {
+        TextRange range;
+        range.firstQuad = static_cast<uint32_t>(quads.size());
         if (text->text && text->layout) text->layout->layout(text->text, *font, quads);
+        spare.resize(quads.size(), false);
+
+        // reserve spare quads after each Text so updates that lengthen a Text can be applied in place
+        quads.resize(quads.size() + slack);
+        spare.resize(quads.size(), true);
+
+        range.capacity = static_cast<uint32_t>(quads.size()) - range.firstQuad;
+        textRanges.push_back(range);
+    }
+
+    auto first_glyph = std::find(spare.begin(), spare.end(), false);
+    if (first_glyph == spare.end()) return;
+
+    // spare quads are degenerate but take the colors of a glyph so they don't prevent the use of single per instance values
+    TextQuad spareQuad = quads[std::distance(spare.begin(), first_glyph)];
+    for (auto& vertex : spareQuad.vertices) vertex.set(0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < quads.size(); ++i)
+    {
+        if (spare[i]) quads[i] = spareQuad;
     }
 
     scenegraph = createRenderingSubgraph(shaderSet, font, requiresBillboard, quads, minimumAllocation);
 }
 
-ref_ptr<Node> CpuLayoutTechnique::createRenderingSubgraph(ref_ptr<ShaderSet> shaderSet, ref_ptr<Font> font, bool billboard, TextQuads& quads, uint32_t minimumAllocation)
+bool CpuLayoutTechnique::update(TextGroup* textGroup, Text* text)
 {
-    if (quads.empty()) return {};
+    if (!textGroup || !text || !text->text || !text->layout || !textGroup->font || !scenegraph || !vertices || dataVariance < DYNAMIC_DATA) return false;
+    if (text->layout->requiresBillboard() != billboard) return false;
 
-    ref_ptr<StateGroup> stategroup;
+    auto itr = std::find(textGroup->children.begin(), textGroup->children.end(), ref_ptr<Text>(text));
+    auto index = static_cast<size_t>(std::distance(textGroup->children.begin(), itr));
+    if (index >= textRanges.size() || textRanges.size() != textGroup->children.size()) return false;
 
-    vec4 color = quads.front().colors[0];
-    vec4 outlineColor = quads.front().outlineColors[0];
-    float outlineWidth = quads.front().outlineWidths[0];
-    vec4 centerAndAutoScaleDistance = quads.front().centerAndAutoScaleDistance;
-    bool singleColor = true;
-    bool singleOutlineColor = true;
-    bool singleOutlineWidth = true;
-    bool singleCenterAutoScaleDistance = true;
+    auto& range = textRanges[index];
+
+    TextQuads quads;
+    text->layout->layout(text->text, *textGroup->font, quads);
+    if (quads.size() > range.capacity) return false;
+
+    // values shared by all the glyphs can't be changed in place
     for (auto& quad : quads)
     {
         for (int i = 0; i < 4; ++i)
         {
-            if (quad.colors[i] != color) singleColor = false;
-            if (quad.outlineColors[i] != outlineColor) singleOutlineColor = false;
-            if (quad.outlineWidths[i] != outlineWidth) singleOutlineWidth = false;
+            if (singleColor && quad.colors[i] != colors->at(0)) return false;
+            if (singleOutlineColor && quad.outlineColors[i] != outlineColors->at(0)) return false;
+            if (singleOutlineWidth && quad.outlineWidths[i] != outlineWidths->at(0)) return false;
         }
-        if (quad.centerAndAutoScaleDistance != centerAndAutoScaleDistance) singleCenterAutoScaleDistance = false;
+        if (billboard && singleCenterAutoScaleDistance && quad.centerAndAutoScaleDistance != centerAndAutoScaleDistances->at(0)) return false;
     }
 
-    uint32_t num_quads = std::max(static_cast<uint32_t>(quads.size()), minimumAllocation);
-    uint32_t num_vertices = num_quads * 4;
-    uint32_t num_colors = singleColor ? 1 : num_vertices;
-    uint32_t num_outlineColors = singleOutlineColor ? 1 : num_vertices;
-    uint32_t num_outlineWidths = singleOutlineWidth ? 1 : num_vertices;
-    uint32_t num_centerAndAutoScaleDistances = billboard ? (singleCenterAutoScaleDistance ? 1 : num_vertices) : 0;
-
-    if (!vertices || num_vertices > vertices->size()) vertices = vec3Array::create(num_vertices);
-    if (!colors || num_colors > colors->size()) colors = vec4Array::create(num_colors);
-    if (!outlineColors || num_outlineColors > outlineColors->size()) outlineColors = vec4Array::create(num_outlineColors);
-    if (!outlineWidths || num_outlineWidths > outlineWidths->size()) outlineWidths = floatArray::create(num_outlineWidths);
-    if (!texcoords || num_vertices > texcoords->size()) texcoords = vec3Array::create(num_vertices);
-    if (billboard && (!centerAndAutoScaleDistances || num_centerAndAutoScaleDistances > centerAndAutoScaleDistances->size())) centerAndAutoScaleDistances = vec4Array::create(num_centerAndAutoScaleDistances);
+    uint32_t vi = range.firstQuad * 4;
+    for (auto& quad : quads)
+    {
+        _assignQuad(vi, quad);
+        vi += 4;
+    }
 
-    uint32_t vi = 0;
+    // collapse the unused spare quads
+    TextQuad spareQuad = {};
+    for (uint32_t i = static_cast<uint32_t>(quads.size()); i < range.capacity; ++i)
+    {
+        _assignQuad(vi, spareQuad);
+        vi += 4;
+    }
+
+    // only mark the Text's range of the per vertex arrays as modified so only that range is transferred
+    auto dirtyRange = [&](Data* data, bool perVertex) {
+        if (!data || !perVertex) return;
+        size_t valueSize = data->valueSize();
+        data->dirty(range.firstQuad * 4 * valueSize, range.capacity * 4 * valueSize);
+    };
+
+    dirtyRange(vertices, true);
+    dirtyRange(texcoords, true);
+    dirtyRange(colors, !singleColor);
+    dirtyRange(outlineColors, !singleOutlineColor);
+    dirtyRange(outlineWidths, !singleOutlineWidth);
+    dirtyRange(centerAndAutoScaleDistances, billboard && !singleCenterAutoScaleDistance);
+
+    textExtents.add(text->layout->extents(text->text, *textGroup->font));
+
+    return true;
+}
 
+void CpuLayoutTechnique::_assignQuad(uint32_t vi, const TextQuad& quad)
+{
     float leadingEdgeGradient = 0.1f;
+    float leadingEdgeTilt = length(quad.vertices[0] - quad.vertices[1]) * leadingEdgeGradient;
+    float topEdgeTilt = leadingEdgeTilt;
 
-    if (singleColor) colors->set(0, color);
-    if (singleOutlineColor) outlineColors->set(0, outlineColor);
-    if (singleOutlineWidth) outlineWidths->set(0, outlineWidth);
-    if (singleCenterAutoScaleDistance && centerAndAutoScaleDistances) centerAndAutoScaleDistances->set(0, centerAndAutoScaleDistance);
+    vertices->set(vi, quad.vertices[0]);
+    vertices->set(vi + 1, quad.vertices[1]);
+    vertices->set(vi + 2, quad.vertices[2]);
+    vertices->set(vi + 3, quad.vertices[3]);
 
-    for (auto& quad : quads)
+    if (!singleColor)
     {
-        float leadingEdgeTilt = length(quad.vertices[0] - quad.vertices[1]) * leadingEdgeGradient;
-        float topEdgeTilt = leadingEdgeTilt;
+        colors->set(vi, quad.colors[0]);
+        colors->set(vi + 1, quad.colors[1]);
+        colors->set(vi + 2, quad.colors[2]);
+        colors->set(vi + 3, quad.colors[3]);
+    }
 
-        vertices->set(vi, quad.vertices[0]);
-        vertices->set(vi + 1, quad.vertices[1]);
-        vertices->set(vi + 2, quad.vertices[2]);
-        vertices->set(vi + 3, quad.vertices[3]);
+    if (!singleOutlineColor)
+    {
+        outlineColors->set(vi, quad.outlineColors[0]);
+        outlineColors->set(vi + 1, quad.outlineColors[1]);
+        outlineColors->set(vi + 2, quad.outlineColors[2]);
+        outlineColors->set(vi + 3, quad.outlineColors[3]);
+    }
 
-        if (!singleColor)
-        {
-            colors->set(vi, quad.colors[0]);
-            colors->set(vi + 1, quad.colors[1]);
-            colors->set(vi + 2, quad.colors[2]);
-            colors->set(vi + 3, quad.colors[3]);
-        }
+    if (!singleOutlineWidth)
+    {
+        outlineWidths->set(vi, quad.outlineWidths[0]);
+        outlineWidths->set(vi + 1, quad.outlineWidths[1]);
+        outlineWidths->set(vi + 2, quad.outlineWidths[2]);
+        outlineWidths->set(vi + 3, quad.outlineWidths[3]);
+    }
 
-        if (!singleOutlineColor)
-        {
-            outlineColors->set(vi, quad.outlineColors[0]);
-            outlineColors->set(vi + 1, quad.outlineColors[1]);
-            outlineColors->set(vi + 2, quad.outlineColors[2]);
-            outlineColors->set(vi + 3, quad.outlineColors[3]);
-        }
+    texcoords->set(vi, vec3(quad.texcoords[0].x, quad.texcoords[0].y, leadingEdgeTilt + topEdgeTilt));
+    texcoords->set(vi + 1, vec3(quad.texcoords[1].x, quad.texcoords[1].y, topEdgeTilt));
+    texcoords->set(vi + 2, vec3(quad.texcoords[2].x, quad.texcoords[2].y, 0.0f));
+    texcoords->set(vi + 3, vec3(quad.texcoords[3].x, quad.texcoords[3].y, leadingEdgeTilt));
 
-        if (!singleOutlineWidth)
-        {
-            outlineWidths->set(vi, quad.outlineWidths[0]);
-            outlineWidths->set(vi + 1, quad.outlineWidths[1]);
-            outlineWidths->set(vi + 2, quad.outlineWidths[2]);
-            outlineWidths->set(vi + 3, quad.outlineWidths[3]);
-        }
+    if (!singleCenterAutoScaleDistance && centerAndAutoScaleDistances)
+    {
+        centerAndAutoScaleDistances->set(vi, quad.centerAndAutoScaleDistance);
+        centerAndAutoScaleDistances->set(vi + 1, quad.centerAndAutoScaleDistance);
+        centerAndAutoScaleDistances->set(vi + 2, quad.centerAndAutoScaleDistance);
+        centerAndAutoScaleDistances->set(vi + 3, quad.centerAndAutoScaleDistance);
+    }
+}
 
-        texcoords->set(vi, vec3(quad.texcoords[0].x, quad.texcoords[0].y, leadingEdgeTilt + topEdgeTilt));
-        texcoords->set(vi + 1, vec3(quad.texcoords[1].x, quad.texcoords[1].y, topEdgeTilt));
-        texcoords->set(vi + 2, vec3(quad.texcoords[2].x, quad.texcoords[2].y, 0.0f));
-        texcoords->set(vi + 3, vec3(quad.texcoords[3].x, quad.texcoords[3].y, leadingEdgeTilt));
+ref_ptr<Node> CpuLayoutTechnique::createRenderingSubgraph(ref_ptr<ShaderSet> shaderSet, ref_ptr<Font> font, bool in_billboard, TextQuads& quads, uint32_t minimumAllocation)
+{
+    if (quads.empty()) return {};
 
-        if (!singleCenterAutoScaleDistance && centerAndAutoScaleDistances)
+    vec4 color = quads.front().colors[0];
+    vec4 outlineColor = quads.front().outlineColors[0];
+    float outlineWidth = quads.front().outlineWidths[0];
+    vec4 centerAndAutoScaleDistance = quads.front().centerAndAutoScaleDistance;
+    bool quadsSingleColor = true;
+    bool quadsSingleOutlineColor = true;
+    bool quadsSingleOutlineWidth = true;
+    bool quadsSingleCenterAutoScaleDistance = true;
+    for (auto& quad : quads)
+    {
+        for (int i = 0; i < 4; ++i)
         {
-            centerAndAutoScaleDistances->set(vi, quad.centerAndAutoScaleDistance);
-            centerAndAutoScaleDistances->set(vi + 1, quad.centerAndAutoScaleDistance);
-            centerAndAutoScaleDistances->set(vi + 2, quad.centerAndAutoScaleDistance);
-            centerAndAutoScaleDistances->set(vi + 3, quad.centerAndAutoScaleDistance);
+            if (quad.colors[i] != color) quadsSingleColor = false;
+            if (quad.outlineColors[i] != outlineColor) quadsSingleOutlineColor = false;
+            if (quad.outlineWidths[i] != outlineWidth) quadsSingleOutlineWidth = false;
         }
+        if (quad.centerAndAutoScaleDistance != centerAndAutoScaleDistance) quadsSingleCenterAutoScaleDistance = false;
+    }
 
+    uint32_t num_quads = std::max(static_cast<uint32_t>(quads.size()), minimumAllocation);
+    uint32_t num_vertices = num_quads * 4;
+    uint32_t num_colors = quadsSingleColor ? 1 : num_vertices;
+    uint32_t num_outlineColors = quadsSingleOutlineColor ? 1 : num_vertices;
+    uint32_t num_outlineWidths = quadsSingleOutlineWidth ? 1 : num_vertices;
+    uint32_t num_centerAndAutoScaleDistances = in_billboard ? (quadsSingleCenterAutoScaleDistance ? 1 : num_vertices) : 0;
+    uint32_t num_indices = num_quads * 6;
+
+    // a dynamic subgraph can be updated in place if the vertex input rates are unchanged and the existing arrays are large enough
+    ref_ptr<StateGroup> stategroup = scenegraph.cast<StateGroup>();
+    bool updateInPlace = stategroup && dataVariance >= DYNAMIC_DATA &&
+                         in_billboard == billboard &&
+                         quadsSingleColor == singleColor &&
+                         quadsSingleOutlineColor == singleOutlineColor &&
+                         quadsSingleOutlineWidth == singleOutlineWidth &&
+                         (!in_billboard || quadsSingleCenterAutoScaleDistance == singleCenterAutoScaleDistance) &&
+                         num_vertices <= vertices->size() && num_colors <= colors->size() && num_outlineColors <= outlineColors->size() &&
+                         num_outlineWidths <= outlineWidths->size() && num_vertices <= texcoords->size() &&
+                         (!in_billboard || num_centerAndAutoScaleDistances <= centerAndAutoScaleDistances->size()) &&
+                         num_indices <= indices->valueCount();
+
+    if (!updateInPlace) stategroup = {};
+
+    billboard = in_billboard;
+    singleColor = quadsSingleColor;
+    singleOutlineColor = quadsSingleOutlineColor;
+    singleOutlineWidth = quadsSingleOutlineWidth;
+    singleCenterAutoScaleDistance = quadsSingleCenterAutoScaleDistance;
+
+    auto allocate = [&](auto& array, uint32_t size) {
+        using ArrayType = typename std::decay_t<decltype(array)>::element_type;
+        if (array && size <= array->size()) return;
+        array = ArrayType::create(size);
+        array->properties.dataVariance = dataVariance;
+    };
+
+    allocate(vertices, num_vertices);
+    allocate(colors, num_colors);
+    allocate(outlineColors, num_outlineColors);
+    allocate(outlineWidths, num_outlineWidths);
+    allocate(texcoords, num_vertices);
+    if (billboard) allocate(centerAndAutoScaleDistances, num_centerAndAutoScaleDistances);
+
+    if (singleColor) colors->set(0, color);
+    if (singleOutlineColor) outlineColors->set(0, outlineColor);
+    if (singleOutlineWidth) outlineWidths->set(0, outlineWidth);
+    if (singleCenterAutoScaleDistance && centerAndAutoScaleDistances) centerAndAutoScaleDistances->set(0, centerAndAutoScaleDistance);
+
+    uint32_t vi = 0;
+    for (auto& quad : quads)
+    {
+        _assignQuad(vi, quad);
         vi += 4;
     }
 
-    uint32_t num_indices = num_quads * 6;
     if (!indices || num_indices > indices->valueCount())
     {
         if (num_vertices > 65536) // check if requires uint or ushort indices
@@ -231,74 +349,84 @@ ref_ptr<Node> CpuLayoutTechnique::createRenderingSubgraph(ref_ptr<ShaderSet> sha
     else
         drawIndexed->indexCount = static_cast<uint32_t>(quads.size() * 6);
 
-    // create StateGroup as the root of the scene/command graph to hold the GraphicsPipeline, and binding of Descriptors to decorate the whole graph
-    if (!stategroup)
+    if (updateInPlace)
     {
-        stategroup = StateGroup::create();
-
-        auto config = vsg::GraphicsPipelineConfigurator::create(shaderSet);
-
-        auto& sharedObjects = font->sharedObjects;
-        if (!sharedObjects) sharedObjects = SharedObjects::create();
-
-        DataList arrays;
-        config->assignArray(arrays, "inPosition", VK_VERTEX_INPUT_RATE_VERTEX, vertices);
-        config->assignArray(arrays, "inColor", singleColor ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX, colors);
-        config->assignArray(arrays, "inOutlineColor", singleOutlineColor ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX, outlineColors);
-        config->assignArray(arrays, "inOutlineWidth", singleOutlineWidth ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX, outlineWidths);
-        config->assignArray(arrays, "inTexCoord", VK_VERTEX_INPUT_RATE_VERTEX, texcoords);
-
-        if (centerAndAutoScaleDistances)
+        // the existing arrays have been filled in, so just mark them as modified for the TransferTask to copy them to the GPU
+        for (auto& array : DataList{vertices, colors, outlineColors, outlineWidths, texcoords, centerAndAutoScaleDistances})
         {
-            config->assignArray(arrays, "inCenterAndAutoScaleDistance", singleCenterAutoScaleDistance ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX, centerAndAutoScaleDistances);
-        }
-
-        if (billboard)
-        {
-            config->shaderHints->defines.insert("BILLBOARD");
+            if (array) array->dirty();
         }
+        return stategroup;
+    }
 
-        // set up sampler for atlas.
-        auto sampler = Sampler::create();
-        sampler->magFilter = VK_FILTER_LINEAR;
-        sampler->minFilter = VK_FILTER_LINEAR;
-        sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-        sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-        sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-        sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-        sampler->borderColor = VK_BORDER_COLOR_INT_TRANSPARENT_BLACK;
-        sampler->anisotropyEnable = VK_TRUE;
-        sampler->maxAnisotropy = 16.0f;
-        sampler->maxLod = 12.0;
-
-        if (sharedObjects) sharedObjects->share(sampler);
+    // create StateGroup as the root of the scene/command graph to hold the GraphicsPipeline, and binding of Descriptors to decorate the whole graph
+    stategroup = StateGroup::create();
 
-        config->assignTexture("textureAtlas", font->atlas, sampler);
+    auto config = vsg::GraphicsPipelineConfigurator::create(shaderSet);
 
-        if (sharedObjects)
-            sharedObjects->share(config, [](auto gpc) { gpc->init(); });
-        else
-            config->init();
+    auto& sharedObjects = font->sharedObjects;
+    if (!sharedObjects) sharedObjects = SharedObjects::create();
 
-        config->copyTo(stategroup, sharedObjects);
+    DataList arrays;
+    config->assignArray(arrays, "inPosition", VK_VERTEX_INPUT_RATE_VERTEX, vertices);
+    config->assignArray(arrays, "inColor", singleColor ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX, colors);
+    config->assignArray(arrays, "inOutlineColor", singleOutlineColor ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX, outlineColors);
+    config->assignArray(arrays, "inOutlineWidth", singleOutlineWidth ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX, outlineWidths);
+    config->assignArray(arrays, "inTexCoord", VK_VERTEX_INPUT_RATE_VERTEX, texcoords);
 
-        bindVertexBuffers = BindVertexBuffers::create(0, arrays);
-        bindIndexBuffer = BindIndexBuffer::create(indices);
+    if (billboard && centerAndAutoScaleDistances)
+    {
+        config->assignArray(arrays, "inCenterAndAutoScaleDistance", singleCenterAutoScaleDistance ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX, centerAndAutoScaleDistances);
+    }
 
-        // setup geometry
-        auto drawCommands = Commands::create();
-        drawCommands->addChild(bindVertexBuffers);
-        drawCommands->addChild(bindIndexBuffer);
-        drawCommands->addChild(drawIndexed);
+    if (billboard)
+    {
+        config->shaderHints->defines.insert("BILLBOARD");
+    }
 
-        stategroup->addChild(drawCommands);
+    // set up sampler for atlas.
+    auto sampler = Sampler::create();
+    sampler->magFilter = VK_FILTER_LINEAR;
+    sampler->minFilter = VK_FILTER_LINEAR;
+    sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->borderColor = VK_BORDER_COLOR_INT_TRANSPARENT_BLACK;
+    sampler->anisotropyEnable = VK_TRUE;
+    sampler->maxAnisotropy = 16.0f;
+    sampler->maxLod = 12.0;
+
+    if (sharedObjects) sharedObjects->share(sampler);
+
+    if (font->dynamicAtlas)
+    {
+        // share the font's ImageInfo so glyphs added to the atlas after compile are uploaded to the texture used here
+        if (!font->atlasImageInfo) font->createFontImages();
+        config->assignTexture("textureAtlas", {font->atlasImageInfo}, 0);
     }
     else
     {
-        info("TODO : CpuLayoutTechnique::setup(), does not yet support updates. Consider using GpuLayoutTechnique instead.");
-        // bindVertexBuffers->copyDataToBuffers();
-        // bindIndexBuffer->copyDataToBuffers();
+        config->assignTexture("textureAtlas", font->atlas, sampler);
     }
 
+    if (sharedObjects)
+        sharedObjects->share(config, [](auto gpc) { gpc->init(); });
+    else
+        config->init();
+
+    config->copyTo(stategroup, sharedObjects);
+
+    bindVertexBuffers = BindVertexBuffers::create(0, arrays);
+    bindIndexBuffer = BindIndexBuffer::create(indices);
+
+    // setup geometry
+    auto drawCommands = Commands::create();
+    drawCommands->addChild(bindVertexBuffers);
+    drawCommands->addChild(bindIndexBuffer);
+    drawCommands->addChild(drawIndexed);
+
+    stategroup->addChild(drawCommands);
+
     return stategroup;
 }
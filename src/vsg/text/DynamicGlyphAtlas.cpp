@@ -0,0 +1,245 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/text/DynamicGlyphAtlas.h>
+#include <vsg/text/Font.h>
+
+#include <cstring>
+
+using namespace vsg;
+
+namespace vsg
+{
+    struct RasterizeGlyph : public Inherit<Operation, RasterizeGlyph>
+    {
+        RasterizeGlyph(ref_ptr<const DynamicGlyphAtlas> in_atlas, uint32_t in_charcode, uint32_t in_cellIndex) :
+            atlas(in_atlas),
+            charcode(in_charcode),
+            cellIndex(in_cellIndex) {}
+
+        ref_ptr<const DynamicGlyphAtlas> atlas;
+        uint32_t charcode;
+        uint32_t cellIndex;
+
+        void run() override
+        {
+            GlyphMetrics metrics{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, vec4(0.0f, 0.0f, 0.0f, 0.0f)};
+            auto image = atlas->_rasterize(charcode, metrics);
+            atlas->_assign(cellIndex, charcode, image, metrics);
+        }
+    };
+} // namespace vsg
+
+DynamicGlyphAtlas::DynamicGlyphAtlas(ref_ptr<GlyphRasterizer> in_rasterizer, uint32_t in_cellSize, uint32_t in_numCellsX, uint32_t in_numCellsY) :
+    rasterizer(in_rasterizer),
+    cellSize(in_cellSize),
+    numCellsX(in_numCellsX),
+    numCellsY(in_numCellsY),
+    _cells(in_numCellsX * in_numCellsY)
+{
+    _atlas = ubyteArray2D::create(cellSize * numCellsX, cellSize * numCellsY, Data::Properties{VK_FORMAT_R8_UNORM});
+    std::fill(_atlas->begin(), _atlas->end(), uint8_t(0));
+
+    // glyph index 0 is reserved for missing glyphs, so glyph index is cell index + 1
+    _glyphMetrics = GlyphMetricsArray::create(numCells() + 1);
+    for (auto& metrics : *_glyphMetrics) metrics = GlyphMetrics{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, vec4(0.0f, 0.0f, 0.0f, 0.0f)};
+
+    // sub image updates only write the base mip level so the atlas is sampled without mipmaps
+    auto sampler = Sampler::create();
+    sampler->magFilter = VK_FILTER_LINEAR;
+    sampler->minFilter = VK_FILTER_LINEAR;
+    sampler->mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    sampler->borderColor = VK_BORDER_COLOR_INT_TRANSPARENT_BLACK;
+    sampler->anisotropyEnable = VK_TRUE;
+    sampler->maxAnisotropy = 16.0f;
+    sampler->maxLod = 0.0f;
+    _atlasImageInfo = ImageInfo::create(sampler, _atlas);
+}
+
+DynamicGlyphAtlas::~DynamicGlyphAtlas()
+{
+}
+
+void DynamicGlyphAtlas::setup(Font& font)
+{
+    if (rasterizer)
+    {
+        font.ascender = rasterizer->ascender;
+        font.descender = rasterizer->descender;
+        font.height = rasterizer->height;
+    }
+
+    font.atlas = _atlas;
+    font.glyphMetrics = _glyphMetrics;
+    font.charmap = {};
+    font.atlasImageInfo = _atlasImageInfo;
+    font.glyphImageInfo = {};
+    font.dynamicAtlas = this;
+    font.createFontImages();
+
+    _glyphImageInfo = font.glyphImageInfo;
+}
+
+uint32_t DynamicGlyphAtlas::numPending() const
+{
+    std::scoped_lock lock(_mutex);
+    return _numPending;
+}
+
+ref_ptr<ubyteArray2D> DynamicGlyphAtlas::_rasterize(uint32_t charcode, GlyphMetrics& metrics) const
+{
+    if (!rasterizer) return {};
+
+    // leave a one texel border around each glyph so linear filtering doesn't pick up neighbouring cells
+    auto image = rasterizer->rasterize(charcode, cellSize - 2, metrics);
+    if (image && (image->width() > cellSize - 2 || image->height() > cellSize - 2))
+    {
+        warn("DynamicGlyphAtlas : glyph for charcode ", charcode, " of ", image->width(), "x", image->height(), " exceeds cell size of ", cellSize);
+        return {};
+    }
+    return image;
+}
+
+bool DynamicGlyphAtlas::_allocate(uint32_t charcode, uint32_t& cellIndex) const
+{
+    // find a free cell, or the least recently used glyph that's old enough to evict
+    uint64_t frameCount = _frameCount.load();
+    uint32_t candidate = numCells();
+    uint64_t oldestFrame = frameCount;
+    for (uint32_t i = 0; i < _cells.size(); ++i)
+    {
+        auto& cell = _cells[i];
+        if (!cell.occupied)
+        {
+            candidate = i;
+            break;
+        }
+        if (!cell.pending && cell.frameLastUsed < oldestFrame && (cell.frameLastUsed + minimumEvictionAge) <= frameCount)
+        {
+            candidate = i;
+            oldestFrame = cell.frameLastUsed;
+        }
+    }
+
+    if (candidate >= numCells()) return false;
+
+    auto& cell = _cells[candidate];
+    if (cell.occupied)
+    {
+        _charcodeCells.erase(cell.charcode);
+        (*_glyphMetrics)[candidate + 1].uvrect.set(0.0f, 0.0f, 0.0f, 0.0f);
+        cell.valid = false;
+        ++_numEvictions;
+    }
+
+    cell.charcode = charcode;
+    cell.frameLastUsed = frameCount;
+    cell.occupied = true;
+    cell.pending = true;
+    _charcodeCells[charcode] = candidate;
+    ++_numPending;
+
+    cellIndex = candidate;
+    return true;
+}
+
+void DynamicGlyphAtlas::_assign(uint32_t cellIndex, uint32_t charcode, ref_ptr<ubyteArray2D> image, const GlyphMetrics& metrics) const
+{
+    std::scoped_lock lock(_mutex);
+
+    auto& cell = _cells[cellIndex];
+    if (cell.charcode != charcode || !cell.pending) return;
+
+    cell.pending = false;
+    --_numPending;
+
+    auto& glyph = (*_glyphMetrics)[cellIndex + 1];
+    if (!image)
+    {
+        // glyphs without an image, such as spaces, only need their advances. Missing glyphs keep their cell so they aren't rasterized again.
+        glyph = metrics;
+        glyph.uvrect.set(0.0f, 0.0f, 0.0f, 0.0f);
+        cell.valid = metrics.horiAdvance > 0.0f || metrics.vertAdvance > 0.0f;
+        if (cell.valid) ++_glyphsModifiedCount;
+        return;
+    }
+
+    uint32_t x = (cellIndex % numCellsX) * cellSize + 1;
+    uint32_t y = (cellIndex / numCellsX) * cellSize + 1;
+    uint32_t w = image->width();
+    uint32_t h = image->height();
+
+    for (uint32_t r = 0; r < h; ++r)
+    {
+        std::memcpy(&_atlas->at(x, y + r), &image->at(0, r), w);
+    }
+
+    float atlasWidth = static_cast<float>(_atlas->width());
+    float atlasHeight = static_cast<float>(_atlas->height());
+    glyph = metrics;
+    cell.valid = true;
+    glyph.uvrect.set(static_cast<float>(x) / atlasWidth, static_cast<float>(y + h) / atlasHeight, static_cast<float>(x + w) / atlasWidth, static_cast<float>(y) / atlasHeight);
+
+    if (transferTask)
+    {
+        transferTask->transfer(image, _atlasImageInfo, VkOffset3D{static_cast<int32_t>(x), static_cast<int32_t>(y), 0}, VkExtent3D{w, h, 1});
+
+        if (_glyphImageInfo)
+        {
+            uint32_t numVec4PerGlyph = static_cast<uint32_t>(sizeof(GlyphMetrics) / sizeof(vec4));
+            auto row = vec4Array::create(numVec4PerGlyph);
+            std::memcpy(row->dataPointer(), &glyph, sizeof(GlyphMetrics));
+            transferTask->transfer(row, _glyphImageInfo, VkOffset3D{0, static_cast<int32_t>(cellIndex + 1), 0}, VkExtent3D{numVec4PerGlyph, 1, 1});
+        }
+    }
+
+    ++_glyphsModifiedCount;
+}
+
+uint32_t DynamicGlyphAtlas::glyphIndex(uint32_t charcode) const
+{
+    uint32_t cellIndex = 0;
+    {
+        std::scoped_lock lock(_mutex);
+
+        if (auto itr = _charcodeCells.find(charcode); itr != _charcodeCells.end())
+        {
+            auto& cell = _cells[itr->second];
+            cell.frameLastUsed = _frameCount.load();
+            if (cell.pending) return 0;
+            return cell.valid ? itr->second + 1 : 0;
+        }
+
+        if (!_allocate(charcode, cellIndex))
+        {
+            debug("DynamicGlyphAtlas::glyphIndex(", charcode, ") all ", numCells(), " cells in use.");
+            return 0;
+        }
+    }
+
+    if (operationThreads)
+    {
+        operationThreads->add(RasterizeGlyph::create(ref_ptr<const DynamicGlyphAtlas>(this), charcode, cellIndex));
+        return 0;
+    }
+
+    GlyphMetrics metrics{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, vec4(0.0f, 0.0f, 0.0f, 0.0f)};
+    auto image = _rasterize(charcode, metrics);
+    _assign(cellIndex, charcode, image, metrics);
+
+    std::scoped_lock lock(_mutex);
+    return _cells[cellIndex].valid ? cellIndex + 1 : 0;
+}
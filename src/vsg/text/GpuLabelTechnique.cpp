@@ -0,0 +1,640 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/BindVertexBuffers.h>
+#include <vsg/commands/Commands.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/maths/transform.h>
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/RasterizationState.h>
+#include <vsg/text/GpuLabelTechnique.h>
+#include <vsg/text/StandardLayout.h>
+#include <vsg/text/TextGroup.h>
+#include <vsg/utils/GraphicsPipelineConfigurator.h>
+#include <vsg/utils/SharedObjects.h>
+#include <vsg/vk/Context.h>
+
+using namespace vsg;
+
+namespace
+{
+    const char* labelCulling_comp = R"(
+#version 450
+
+layout(local_size_x = 64) in;
+
+struct Label
+{
+    vec4 position;
+    vec4 horizontal;
+    vec4 vertical;
+    vec4 color;
+    vec4 outlineColor;
+    vec4 extents;
+    uint firstGlyph;
+    uint numGlyphs;
+    float outlineWidth;
+    float maximumDistance;
+};
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 mvp;
+    vec4 eye;        // xyz eye position in the label coordinate frame, w maximum distance
+    vec4 viewport;   // x, y, width, height
+    vec4 projection; // projection[0][0], projection[1][1], grid height
+    uvec4 params;    // number of labels, pass, grid width, cell size
+} pc;
+
+layout(std430, set = 0, binding = 0) readonly buffer Labels { Label labels[]; };
+layout(std430, set = 0, binding = 1) buffer LabelRects { uvec2 labelRects[]; };
+layout(std430, set = 0, binding = 2) buffer Grid { uint grid[]; };
+layout(std430, set = 0, binding = 3) writeonly buffer VisibleGlyphs { uint visibleGlyphs[]; };
+layout(std430, set = 0, binding = 4) buffer DrawCommand { uint vertexCount; uint instanceCount; uint firstVertex; uint firstInstance; } drawCommand;
+
+const uint CULLED = 0xffffffff;
+const uint MAX_CELLS = 16;
+
+vec4 row(int i) { return vec4(pc.mvp[0][i], pc.mvp[1][i], pc.mvp[2][i], pc.mvp[3][i]); }
+
+bool outside(vec4 plane, vec3 center, float radius)
+{
+    return (dot(plane.xyz, center) + plane.w) < -radius * length(plane.xyz);
+}
+
+vec2 toScreen(vec4 clip)
+{
+    return pc.viewport.xy + (clip.xy / clip.w * 0.5 + 0.5) * pc.viewport.zw;
+}
+
+// return the packed min and max grid cells covered by the label, or CULLED
+uvec2 cull(uint i)
+{
+    Label label = labels[i];
+    bool billboard = label.horizontal.w > 0.0;
+
+    vec2 mid = (label.extents.xy + label.extents.zw) * 0.5;
+    vec2 halfSize = (label.extents.zw - label.extents.xy) * 0.5;
+    vec3 offset = label.horizontal.xyz * mid.x + label.vertical.xyz * mid.y;
+    float radius = length(label.horizontal.xyz * halfSize.x) + length(label.vertical.xyz * halfSize.y);
+
+    vec3 center = billboard ? label.position.xyz : label.position.xyz + offset;
+    float distance = length(center - pc.eye.xyz);
+    if (distance > pc.eye.w || (label.maximumDistance > 0.0 && distance > label.maximumDistance)) return uvec2(CULLED);
+
+    float scale = 1.0;
+    if (billboard)
+    {
+        if (distance < label.position.w) scale = distance / label.position.w;
+        radius = (radius + length(offset)) * scale;
+    }
+
+    vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+    if (outside(r3 + r0, center, radius) || outside(r3 - r0, center, radius) ||
+        outside(r3 + r1, center, radius) || outside(r3 - r1, center, radius) ||
+        outside(r2, center, radius) || outside(r3 - r2, center, radius)) return uvec2(CULLED);
+
+    // labels are visible without taking part in decluttering when it's disabled or their screen rect can't be computed
+    uvec2 noCells = uvec2(1, 0);
+    if (pc.params.z == 0) return noCells;
+
+    vec2 minScreen, maxScreen;
+    if (billboard)
+    {
+        vec4 clip = pc.mvp * vec4(label.position.xyz, 1.0);
+        if (clip.w <= 0.0) return noCells;
+
+        vec2 screenCenter = toScreen(clip);
+        vec2 pixelsPerUnit = abs(pc.projection.xy) * 0.5 * pc.viewport.zw * scale / clip.w;
+        vec2 a = screenCenter + vec2(label.extents.x, label.extents.y) * pixelsPerUnit;
+        vec2 b = screenCenter + vec2(label.extents.z, label.extents.w) * pixelsPerUnit;
+        minScreen = min(a, b);
+        maxScreen = max(a, b);
+    }
+    else
+    {
+        minScreen = vec2(1.0e30);
+        maxScreen = vec2(-1.0e30);
+        for (int c = 0; c < 4; ++c)
+        {
+            vec2 corner = vec2((c & 1) == 0 ? label.extents.x : label.extents.z, (c & 2) == 0 ? label.extents.y : label.extents.w);
+            vec4 clip = pc.mvp * vec4(label.position.xyz + label.horizontal.xyz * corner.x + label.vertical.xyz * corner.y, 1.0);
+            if (clip.w <= 0.0) return noCells;
+
+            vec2 screen = toScreen(clip);
+            minScreen = min(minScreen, screen);
+            maxScreen = max(maxScreen, screen);
+        }
+    }
+
+    ivec2 gridSize = ivec2(pc.params.z, int(pc.projection.z));
+    float cellSize = float(pc.params.w);
+    ivec2 minCell = clamp(ivec2(floor((minScreen - pc.viewport.xy) / cellSize)), ivec2(0), gridSize - 1);
+    ivec2 maxCell = clamp(ivec2(floor((maxScreen - pc.viewport.xy) / cellSize)), ivec2(0), gridSize - 1);
+    maxCell = min(maxCell, minCell + int(MAX_CELLS - 1));
+
+    return uvec2(uint(minCell.x) | (uint(minCell.y) << 16), uint(maxCell.x) | (uint(maxCell.y) << 16));
+}
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.params.x) return;
+
+    if (pc.params.y == 0)
+    {
+        // first pass, cull and claim the grid cells covered by the label, the lowest label index wins each cell
+        uvec2 rect = cull(i);
+        labelRects[i] = rect;
+        if (rect.x == CULLED) return;
+
+        for (uint y = (rect.x >> 16); y <= (rect.y >> 16); ++y)
+        {
+            for (uint x = (rect.x & 0xffff); x <= (rect.y & 0xffff); ++x)
+            {
+                atomicMin(grid[y * pc.params.z + x], i);
+            }
+        }
+    }
+    else
+    {
+        // second pass, labels that own all their cells write their glyphs for the indirect draw
+        uvec2 rect = labelRects[i];
+        if (rect.x == CULLED) return;
+
+        for (uint y = (rect.x >> 16); y <= (rect.y >> 16); ++y)
+        {
+            for (uint x = (rect.x & 0xffff); x <= (rect.y & 0xffff); ++x)
+            {
+                if (grid[y * pc.params.z + x] != i) return;
+            }
+        }
+
+        Label label = labels[i];
+        uint base = atomicAdd(drawCommand.instanceCount, label.numGlyphs);
+        for (uint g = 0; g < label.numGlyphs; ++g)
+        {
+            visibleGlyphs[base + g] = label.firstGlyph + g;
+        }
+    }
+}
+)";
+
+    const char* label_vert = R"(
+#version 450
+
+struct Label
+{
+    vec4 position;
+    vec4 horizontal;
+    vec4 vertical;
+    vec4 color;
+    vec4 outlineColor;
+    vec4 extents;
+    uint firstGlyph;
+    uint numGlyphs;
+    float outlineWidth;
+    float maximumDistance;
+};
+
+struct Glyph
+{
+    vec4 rect;
+    vec4 uvrect;
+    uint label;
+};
+
+layout(push_constant) uniform PushConstants {
+    mat4 projection;
+    mat4 modelview;
+} pc;
+
+layout(std430, set = 0, binding = 1) readonly buffer Labels { Label labels[]; };
+layout(std430, set = 0, binding = 2) readonly buffer Glyphs { Glyph glyphs[]; };
+layout(std430, set = 0, binding = 3) readonly buffer VisibleGlyphs { uint visibleGlyphs[]; };
+
+layout(location = 0) in vec3 inPosition;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec4 outlineColor;
+layout(location = 2) out float outlineWidth;
+layout(location = 3) out vec2 fragTexCoord;
+
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main()
+{
+    Glyph glyph = glyphs[visibleGlyphs[gl_InstanceIndex]];
+    Label label = labels[glyph.label];
+
+    vec2 local = mix(glyph.rect.xy, glyph.rect.zw, inPosition.xy);
+    vec3 pos = label.horizontal.xyz * local.x + label.vertical.xyz * local.y;
+
+    if (label.horizontal.w > 0.0)
+    {
+        vec4 center_eye = pc.modelview * vec4(label.position.xyz, 1.0);
+        float distance = -center_eye.z;
+        float scale = (distance < label.position.w) ? distance / label.position.w : 1.0;
+        gl_Position = pc.projection * vec4(center_eye.xyz + pos * scale, 1.0);
+    }
+    else
+    {
+        gl_Position = (pc.projection * pc.modelview) * vec4(label.position.xyz + pos, 1.0);
+    }
+
+    gl_Position.z += inPosition.z * 0.0001;
+
+    fragColor = label.color;
+    outlineColor = label.outlineColor;
+    outlineWidth = label.outlineWidth;
+    fragTexCoord = mix(glyph.uvrect.xy, glyph.uvrect.zw, inPosition.xy);
+}
+)";
+
+    const char* label_frag = R"(
+#version 450
+
+layout(set = 0, binding = 0) uniform sampler2D texSampler;
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec4 outlineColor;
+layout(location = 2) in float outlineWidth;
+layout(location = 3) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+vec2 glyph_alpha(vec2 texcoord, vec2 dx, vec2 dy)
+{
+    float lod = textureQueryLod(texSampler, texcoord).x;
+    float innerCutOff = 0.0;
+    if (lod > 0.0) innerCutOff = lod * 0.03;
+
+    float distance_from_edge = (textureGrad(texSampler, texcoord, dx, dy).r);
+
+    float d_distance_dx = dFdx(distance_from_edge);
+    float d_distance_dy = dFdy(distance_from_edge);
+
+    float delta = sqrt(d_distance_dx * d_distance_dx + d_distance_dy * d_distance_dy);
+
+    float min_distance_from_edge = distance_from_edge - delta + innerCutOff;
+    float max_distance_from_edge = distance_from_edge + delta;
+
+    float inner_alpha = 0.0;
+    if (min_distance_from_edge >= 0.0) inner_alpha = 1.0;
+    else if (max_distance_from_edge >= 0.0) inner_alpha = max_distance_from_edge / (max_distance_from_edge - min_distance_from_edge);
+
+    min_distance_from_edge += outlineWidth;
+    float outer_alpha = 0.0;
+    if (min_distance_from_edge >= 0.0) outer_alpha = 1.0;
+    else if (max_distance_from_edge >= 0.0) outer_alpha = max_distance_from_edge / (max_distance_from_edge - min_distance_from_edge);
+
+    return vec2(inner_alpha, outer_alpha);
+}
+
+void main()
+{
+    vec2 alphas = glyph_alpha(fragTexCoord, dFdx(fragTexCoord), dFdy(fragTexCoord));
+
+    if (alphas[1] > 0.0)
+    {
+        vec4 glyph = vec4(fragColor.rgb, fragColor.a * alphas[0]);
+        vec4 outline = vec4(outlineColor.rgb, outlineColor.a * alphas[1]);
+        outColor = mix(outline, glyph, glyph.a);
+    }
+    else
+    {
+        outColor = vec4(fragColor.rgb, fragColor.a * alphas[0]);
+    }
+
+    if (outColor.a == 0.0) discard;
+}
+)";
+
+    struct LabelCullingPushConstants
+    {
+        mat4 mvp;
+        vec4 eye;
+        vec4 viewport;
+        vec4 projection;
+        uivec4 params;
+    };
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// createLabelShaderSet
+//
+ref_ptr<ShaderSet> vsg::createLabelShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("label"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    ShaderStages stages{
+        ShaderStage::create(VK_SHADER_STAGE_VERTEX_BIT, "main", label_vert),
+        ShaderStage::create(VK_SHADER_STAGE_FRAGMENT_BIT, "main", label_frag)};
+
+    auto shaderSet = ShaderSet::create(stages);
+
+    shaderSet->addAttributeBinding("inPosition", "", 0, VK_FORMAT_R32G32B32_SFLOAT, vec3Array::create(1));
+
+    shaderSet->addDescriptorBinding("textureAtlas", "", 0, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, ubyteArray2D::create(1, 1, Data::Properties{VK_FORMAT_R8_UNORM}));
+    shaderSet->addDescriptorBinding("labels", "", 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, LabelArray::create(1));
+    shaderSet->addDescriptorBinding("glyphs", "", 0, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, LabelGlyphArray::create(1));
+    shaderSet->addDescriptorBinding("visibleGlyphs", "", 0, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, uintArray::create(1));
+
+    shaderSet->addPushConstantRange("pc", "", VK_SHADER_STAGE_VERTEX_BIT, 0, 128);
+
+    auto rasterizationState = RasterizationState::create();
+    rasterizationState->cullMode = VK_CULL_MODE_NONE;
+
+    auto colorBlendState = ColorBlendState::create();
+    colorBlendState->configureAttachments(true);
+
+    shaderSet->defaultGraphicsPipelineStates.push_back(rasterizationState);
+    shaderSet->defaultGraphicsPipelineStates.push_back(colorBlendState);
+
+    return shaderSet;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// LabelCulling
+//
+LabelCulling::LabelCulling() :
+    labels(BufferInfo::create()),
+    visibleGlyphs(BufferInfo::create()),
+    drawCommand(BufferInfo::create(DrawIndirectCommandArray::create(1, DrawIndirectCommand{4, 0, 0, 0})))
+{
+    DescriptorSetLayoutBindings bindings{
+        {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+    auto descriptorSetLayout = DescriptorSetLayout::create(bindings);
+
+    PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(LabelCullingPushConstants)}};
+    _pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{descriptorSetLayout}, pushConstantRanges);
+
+    auto computeShader = ShaderStage::create(VK_SHADER_STAGE_COMPUTE_BIT, "main", labelCulling_comp);
+    _bindPipeline = BindComputePipeline::create(ComputePipeline::create(_pipelineLayout, computeShader));
+
+    // previous frame's draws must have finished reading the outputs before they're cleared and rewritten
+    _preCullBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                              MemoryBarrier::create(0, VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+    // the cleared grid and glyph count must be visible to the compute shader's atomics
+    _clearBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                            MemoryBarrier::create(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+    // the grid cells claimed by the first pass must be visible to the second
+    _claimBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                            MemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+    // the compute shader's writes must be visible to the indirect draw
+    _postCullBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0,
+                                               MemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT));
+}
+
+void LabelCulling::compile(Context& context)
+{
+    if (!_grid || _grid->data->valueCount() != maximumGridCells)
+    {
+        _grid = BufferInfo::create(uintArray::create(std::max(maximumGridCells, 1u), 0xffffffff));
+    }
+    if (!_labelRects || _labelRects->data->valueCount() < numLabels)
+    {
+        _labelRects = BufferInfo::create(uivec2Array::create(std::max(numLabels, 1u)));
+    }
+
+    // create the buffers before the DescriptorBuffers or DrawIndirect can, so that they have the usage needed by both the compute and graphics pipelines
+    createBufferAndTransferData(context, {labels, visibleGlyphs, _grid, _labelRects}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+    createBufferAndTransferData(context, {drawCommand}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+
+    Descriptors descriptors{
+        DescriptorBuffer::create(BufferInfoList{labels}, 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{_labelRects}, 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{_grid}, 2, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{visibleGlyphs}, 3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{drawCommand}, 4, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)};
+    _bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, DescriptorSet::create(_pipelineLayout->setLayouts[0], descriptors));
+
+    _bindPipeline->compile(context);
+    _bindDescriptorSet->compile(context);
+}
+
+void LabelCulling::record(CommandBuffer& commandBuffer) const
+{
+    if (!camera || numLabels == 0 || !_bindDescriptorSet || !drawCommand->buffer) return;
+
+    dmat4 projectionMatrix = camera->projectionMatrix->transform();
+    dmat4 modelviewMatrix = camera->viewMatrix->transform() * matrix;
+    dvec3 eye = inverse(modelviewMatrix) * dvec3(0.0, 0.0, 0.0);
+
+    // size the declutter grid to cover the viewport, increasing the cell size if the grid would need more cells than have been allocated
+    auto viewport = camera->getViewport();
+    uint32_t cellSize = std::max(declutterCellSize, 1u);
+    uint32_t gridWidth = 0, gridHeight = 0;
+    if (declutter && viewport.width > 0.0f && viewport.height > 0.0f)
+    {
+        for (;;)
+        {
+            gridWidth = static_cast<uint32_t>(std::ceil(viewport.width / static_cast<float>(cellSize)));
+            gridHeight = static_cast<uint32_t>(std::ceil(viewport.height / static_cast<float>(cellSize)));
+            if (gridWidth * gridHeight <= maximumGridCells) break;
+            cellSize *= 2;
+        }
+    }
+
+    LabelCullingPushConstants pushConstants;
+    pushConstants.mvp = mat4(projectionMatrix * modelviewMatrix);
+    pushConstants.eye.set(static_cast<float>(eye.x), static_cast<float>(eye.y), static_cast<float>(eye.z), static_cast<float>(std::min(maximumDistance, static_cast<double>(std::numeric_limits<float>::max()))));
+    pushConstants.viewport.set(viewport.x, viewport.y, viewport.width, viewport.height);
+    pushConstants.projection.set(static_cast<float>(projectionMatrix[0][0]), static_cast<float>(projectionMatrix[1][1]), static_cast<float>(gridHeight), 0.0f);
+    pushConstants.params.set(numLabels, 0, gridWidth, cellSize);
+
+    auto deviceID = commandBuffer.deviceID;
+
+    _preCullBarrier->record(commandBuffer);
+    if (gridWidth > 0) vkCmdFillBuffer(commandBuffer, _grid->buffer->vk(deviceID), _grid->offset, gridWidth * gridHeight * sizeof(uint32_t), 0xffffffff);
+    vkCmdFillBuffer(commandBuffer, drawCommand->buffer->vk(deviceID), drawCommand->offset + offsetof(DrawIndirectCommand, instanceCount), sizeof(uint32_t), 0);
+    _clearBarrier->record(commandBuffer);
+
+    _bindPipeline->record(commandBuffer);
+    _bindDescriptorSet->record(commandBuffer);
+
+    uint32_t numWorkgroups = (numLabels + workgroupSize - 1) / workgroupSize;
+    vkCmdPushConstants(commandBuffer, _pipelineLayout->vk(deviceID), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(LabelCullingPushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
+
+    _claimBarrier->record(commandBuffer);
+
+    pushConstants.params.y = 1;
+    vkCmdPushConstants(commandBuffer, _pipelineLayout->vk(deviceID), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(LabelCullingPushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, numWorkgroups, 1, 1);
+
+    _postCullBarrier->record(commandBuffer);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// GpuLabelTechnique
+//
+void GpuLabelTechnique::setup(Text* text, uint32_t /*minimumAllocation*/, ref_ptr<const Options> /*options*/)
+{
+    info("GpuLabelTechnique::setup(", text, ") not supported, use GpuLabelTechnique with a TextGroup.");
+}
+
+void GpuLabelTechnique::setup(TextGroup* textGroup, uint32_t minimumAllocation, ref_ptr<const Options> options)
+{
+    if (!textGroup || !textGroup->font) return;
+
+    auto& font = textGroup->font;
+
+    textExtents = {};
+
+    std::vector<LabelStruct> labelList;
+    std::vector<LabelGlyph> glyphList;
+    labelList.reserve(textGroup->children.size());
+
+    // lay out each label's glyphs in its own horizontal/vertical axes, the label position and orientation are applied in the vertex shader
+    auto localLayout = StandardLayout::create();
+    TextQuads quads;
+    for (auto& text : textGroup->children)
+    {
+        auto standardLayout = text->layout.cast<StandardLayout>();
+        if (!text->text || !standardLayout)
+        {
+            if (text->text) warn("GpuLabelTechnique::setup(..) Text without a StandardLayout not supported.");
+            continue;
+        }
+
+        localLayout->horizontalAlignment = standardLayout->horizontalAlignment;
+        localLayout->verticalAlignment = standardLayout->verticalAlignment;
+        localLayout->glyphLayout = standardLayout->glyphLayout;
+
+        quads.clear();
+        localLayout->layout(text->text, *font, quads);
+        if (quads.empty()) continue;
+
+        auto labelIndex = static_cast<uint32_t>(labelList.size());
+
+        LabelStruct label;
+        label.position.set(standardLayout->position.x, standardLayout->position.y, standardLayout->position.z, standardLayout->billboardAutoScaleDistance);
+        label.horizontal.set(standardLayout->horizontal.x, standardLayout->horizontal.y, standardLayout->horizontal.z, standardLayout->billboard ? 1.0f : 0.0f);
+        label.vertical.set(standardLayout->vertical.x, standardLayout->vertical.y, standardLayout->vertical.z, 0.0f);
+        label.color = standardLayout->color;
+        label.outlineColor = standardLayout->outlineColor;
+        label.firstGlyph = static_cast<uint32_t>(glyphList.size());
+        label.numGlyphs = static_cast<uint32_t>(quads.size());
+        label.outlineWidth = standardLayout->outlineWidth;
+        label.maximumDistance = labelMaximumDistance;
+
+        vec2 minExtents(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+        vec2 maxExtents(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+        for (auto& quad : quads)
+        {
+            LabelGlyph glyph{};
+            glyph.rect.set(quad.vertices[0].x, quad.vertices[0].y, quad.vertices[2].x, quad.vertices[2].y);
+            glyph.uvrect.set(quad.texcoords[0].x, quad.texcoords[0].y, quad.texcoords[2].x, quad.texcoords[2].y);
+            glyph.label = labelIndex;
+            glyphList.push_back(glyph);
+
+            minExtents.set(std::min(minExtents.x, quad.vertices[0].x), std::min(minExtents.y, quad.vertices[0].y));
+            maxExtents.set(std::max(maxExtents.x, quad.vertices[2].x), std::max(maxExtents.y, quad.vertices[2].y));
+        }
+        label.extents.set(minExtents.x, minExtents.y, maxExtents.x, maxExtents.y);
+        labelList.push_back(label);
+
+        auto extents = standardLayout->extents(text->text, *font);
+        if (extents.valid())
+        {
+            textExtents.add(extents.min);
+            textExtents.add(extents.max);
+        }
+    }
+
+    if (labelList.empty()) return;
+
+    labels = LabelArray::create(static_cast<uint32_t>(labelList.size()));
+    std::copy(labelList.begin(), labelList.end(), labels->begin());
+
+    auto numGlyphs = std::max(static_cast<uint32_t>(glyphList.size()), minimumAllocation);
+    glyphs = LabelGlyphArray::create(numGlyphs, LabelGlyph{});
+    std::copy(glyphList.begin(), glyphList.end(), glyphs->begin());
+
+    if (!culling) culling = LabelCulling::create();
+    culling->camera = camera;
+    culling->numLabels = static_cast<uint32_t>(labels->size());
+    culling->labels = BufferInfo::create(labels);
+    culling->visibleGlyphs = BufferInfo::create(uintArray::create(numGlyphs, 0u));
+
+    // create StateGroup as the root of the scene/command graph to hold the GraphicsPipeline, and binding of Descriptors to decorate the whole graph
+    auto stateGroup = StateGroup::create();
+    scenegraph = stateGroup;
+
+    auto shaderSet = textGroup->shaderSet ? textGroup->shaderSet : createLabelShaderSet(options);
+    auto config = GraphicsPipelineConfigurator::create(shaderSet);
+
+    auto& sharedObjects = font->sharedObjects;
+    if (!sharedObjects) sharedObjects = SharedObjects::create();
+
+    auto vertices = vec3Array::create(4);
+    float leadingEdgeGradient = 0.1f;
+    vertices->set(0, vec3(0.0f, 1.0f, 2.0f * leadingEdgeGradient));
+    vertices->set(1, vec3(0.0f, 0.0f, leadingEdgeGradient));
+    vertices->set(2, vec3(1.0f, 1.0f, leadingEdgeGradient));
+    vertices->set(3, vec3(1.0f, 0.0f, 0.0f));
+
+    DataList arrays;
+    config->assignArray(arrays, "inPosition", VK_VERTEX_INPUT_RATE_VERTEX, vertices);
+
+    if (!font->atlasImageInfo) font->createFontImages();
+    config->assignTexture("textureAtlas", {font->atlasImageInfo}, 0);
+    config->assignDescriptor("labels", BufferInfoList{culling->labels});
+    config->assignDescriptor("glyphs", BufferInfoList{BufferInfo::create(glyphs)});
+    config->assignDescriptor("visibleGlyphs", BufferInfoList{culling->visibleGlyphs});
+
+    // Set the InputAssemblyState.topology
+    struct SetPipelineStates : public Visitor
+    {
+        void apply(Object& object) override { object.traverse(*this); }
+        void apply(InputAssemblyState& ias) override { ias.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP; }
+    };
+    vsg::visit<SetPipelineStates>(config);
+
+    if (sharedObjects)
+        sharedObjects->share(config, [](auto gpc) { gpc->init(); });
+    else
+        config->init();
+
+    config->copyTo(stateGroup, sharedObjects);
+
+    draw = DrawIndirect::create();
+    draw->bufferInfo = culling->drawCommand;
+    draw->drawCount = 1;
+    draw->stride = sizeof(DrawIndirectCommand);
+
+    auto drawCommands = Commands::create();
+    drawCommands->addChild(BindVertexBuffers::create(0, arrays));
+    drawCommands->addChild(draw);
+    stateGroup->addChild(drawCommands);
+}
@@ -78,7 +78,7 @@ ref_ptr<ShaderSet> vsg::createTextShaderSet(ref_ptr<const Options> options)
         if (auto itr = options->shaderSets.find("text"); itr != options->shaderSets.end()) return itr->second;
     }
 
-    return text_ShaderSet();
+    return createSharedShaderSet("vsg::createTextShaderSet", options, text_ShaderSet);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
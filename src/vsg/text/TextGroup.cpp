@@ -76,3 +76,10 @@ void TextGroup::setup(uint32_t minimumAllocation, ref_ptr<const Options> options
 
     technique->setup(this, minimumAllocation, options);
 }
+
+void TextGroup::update(Text* text, ref_ptr<const Options> options)
+{
+    if (technique && technique->update(this, text)) return;
+
+    setup(0, options);
+}
@@ -54,6 +54,20 @@ void vsg::setAffinity(const Affinity& affinity)
     win32_setAffinity(GetCurrentThread(), affinity);
 }
 
+int vsg::numaNode(const Affinity& affinity)
+{
+    int node = -1;
+    for (auto cpu : affinity.cpus)
+    {
+        USHORT cpuNode = 0;
+        PROCESSOR_NUMBER processorNumber{static_cast<WORD>(cpu / 64), static_cast<BYTE>(cpu % 64), 0};
+        if (!GetNumaProcessorNodeEx(&processorNumber, &cpuNode) || cpuNode == 0xffff) return -1;
+        if (node >= 0 && node != cpuNode) return -1;
+        node = cpuNode;
+    }
+    return node;
+}
+
 #elif defined(__APPLE__)
 
 #    include <mach/mach.h>
@@ -98,6 +112,12 @@ void vsg::setAffinity(const Affinity& affinity)
     macos_setAffinity(pthread_self(), affinity);
 }
 
+int vsg::numaNode(const Affinity&)
+{
+    // macOS doesn't expose NUMA nodes
+    return -1;
+}
+
 #elif defined(__ANDROID__) || defined(__CYGWIN__)
 
 void vsg::setAffinity(std::thread&, const Affinity&)
@@ -110,8 +130,21 @@ void vsg::setAffinity(const Affinity&)
     // Not currently implemented
 }
 
+int vsg::numaNode(const Affinity&)
+{
+    // Not currently implemented
+    return -1;
+}
+
 #else // unices
 
+#    include <dirent.h>
+
+#    include <cctype>
+#    include <cstdlib>
+#    include <cstring>
+#    include <string>
+
 static void pthread_setAffinity(pthread_t thread_native_handle, const vsg::Affinity& affinity)
 {
     uint32_t numProcessors = std::thread::hardware_concurrency();
@@ -151,4 +184,32 @@ void vsg::setAffinity(const Affinity& affinity)
     pthread_setAffinity(pthread_self(), affinity);
 }
 
+int vsg::numaNode(const Affinity& affinity)
+{
+    int node = -1;
+    for (auto cpu : affinity.cpus)
+    {
+        // the sysfs directory of each cpu contains a nodeN link to the NUMA node it's on
+        int cpuNode = -1;
+        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        if (auto dir = opendir(path.c_str()))
+        {
+            while (auto entry = readdir(dir))
+            {
+                if (std::strncmp(entry->d_name, "node", 4) == 0 && std::isdigit(static_cast<unsigned char>(entry->d_name[4])))
+                {
+                    cpuNode = std::atoi(entry->d_name + 4);
+                    break;
+                }
+            }
+            closedir(dir);
+        }
+
+        if (cpuNode < 0) return -1;
+        if (node >= 0 && node != cpuNode) return -1;
+        node = cpuNode;
+    }
+    return node;
+}
+
 #endif
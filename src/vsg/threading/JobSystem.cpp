@@ -0,0 +1,337 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/threading/JobSystem.h>
+
+using namespace vsg;
+
+namespace
+{
+    /// Chase-Lev work stealing deque, based on "Correct and Efficient Work-Stealing for Weak Memory Models", Lê et al. 2013.
+    /// Only the owning thread may push() and take(), any thread may steal(). Entries hold a reference to the Operation while in the deque.
+    class WorkStealingDeque
+    {
+    public:
+        WorkStealingDeque()
+        {
+            _arrays.emplace_back(new Array(256));
+            _array.store(_arrays.back().get(), std::memory_order_relaxed);
+        }
+
+        ~WorkStealingDeque()
+        {
+            auto array = _array.load(std::memory_order_relaxed);
+            for (int64_t i = _top.load(std::memory_order_relaxed); i < _bottom.load(std::memory_order_relaxed); ++i)
+            {
+                array->get(i)->unref();
+            }
+        }
+
+        void push(Operation* operation)
+        {
+            operation->ref();
+
+            int64_t b = _bottom.load(std::memory_order_relaxed);
+            int64_t t = _top.load(std::memory_order_acquire);
+            Array* array = _array.load(std::memory_order_relaxed);
+            if (b - t > array->capacity - 1) array = _grow(array, b, t);
+
+            array->put(b, operation);
+            _bottom.store(b + 1, std::memory_order_release);
+        }
+
+        ref_ptr<Operation> take()
+        {
+            int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+            Array* array = _array.load(std::memory_order_relaxed);
+            _bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = _top.load(std::memory_order_relaxed);
+
+            Operation* operation = nullptr;
+            if (t <= b)
+            {
+                operation = array->get(b);
+                if (t == b)
+                {
+                    // last entry so race against stealing threads for it
+                    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) operation = nullptr;
+                    _bottom.store(b + 1, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                _bottom.store(b + 1, std::memory_order_relaxed);
+            }
+
+            return _adopt(operation);
+        }
+
+        ref_ptr<Operation> steal()
+        {
+            int64_t t = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = _bottom.load(std::memory_order_acquire);
+
+            if (t >= b) return {};
+
+            Array* array = _array.load(std::memory_order_acquire);
+            Operation* operation = array->get(t);
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return {};
+
+            return _adopt(operation);
+        }
+
+    protected:
+        struct Array
+        {
+            explicit Array(int64_t in_capacity) :
+                capacity(in_capacity),
+                mask(in_capacity - 1),
+                entries(new std::atomic<Operation*>[static_cast<size_t>(in_capacity)]) {}
+
+            Operation* get(int64_t i) const { return entries[i & mask].load(std::memory_order_relaxed); }
+            void put(int64_t i, Operation* operation) { entries[i & mask].store(operation, std::memory_order_relaxed); }
+
+            const int64_t capacity;
+            const int64_t mask;
+            std::unique_ptr<std::atomic<Operation*>[]> entries;
+        };
+
+        static ref_ptr<Operation> _adopt(Operation* operation)
+        {
+            if (!operation) return {};
+
+            // transfer the reference held by the deque to the returned ref_ptr
+            ref_ptr<Operation> result(operation);
+            operation->unref_nodelete();
+            return result;
+        }
+
+        Array* _grow(Array* array, int64_t b, int64_t t)
+        {
+            // previous arrays may still be being read by stealing threads, so retain them until the deque is destroyed
+            _arrays.emplace_back(new Array(array->capacity * 2));
+            Array* new_array = _arrays.back().get();
+            for (int64_t i = t; i < b; ++i) new_array->put(i, array->get(i));
+            _array.store(new_array, std::memory_order_release);
+            return new_array;
+        }
+
+        alignas(64) std::atomic_int64_t _top{0};
+        alignas(64) std::atomic_int64_t _bottom{0};
+        std::atomic<Array*> _array;
+        std::vector<std::unique_ptr<Array>> _arrays;
+    };
+} // namespace
+
+struct JobSystem::Worker
+{
+    size_t index = 0;
+    WorkStealingDeque deque;
+    std::thread thread;
+};
+
+// the JobSystem and worker index associated with the current thread
+static thread_local JobSystem* s_currentJobSystem = nullptr;
+static thread_local size_t s_currentWorkerIndex = 0;
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Job
+//
+Job::Job(ref_ptr<Operation> in_operation) :
+    operation(in_operation)
+{
+}
+
+Job::~Job()
+{
+}
+
+void Job::dependsOn(ref_ptr<Job> dependency)
+{
+    if (!dependency || dependency == this) return;
+
+    std::scoped_lock lock(dependency->_mutex);
+    if (dependency->_completed) return;
+
+    ++_pendingCount;
+    dependency->_continuations.emplace_back(this);
+}
+
+void Job::run()
+{
+    if (operation) operation->run();
+    completed();
+}
+
+bool Job::isCompleted() const
+{
+    std::scoped_lock lock(_mutex);
+    return _completed;
+}
+
+void Job::completed()
+{
+    std::vector<ref_ptr<Job>> continuations;
+    {
+        std::scoped_lock lock(_mutex);
+        _completed = true;
+        continuations.swap(_continuations);
+    }
+
+    for (auto& continuation : continuations)
+    {
+        // the last dependency to complete schedules the continuation, if it's not been added to a JobSystem yet adding it will schedule it.
+        if (continuation->_pendingCount.fetch_sub(1) == 1) continuation->_jobSystem->_schedule(continuation);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// JobSystem
+//
+JobSystem::JobSystem(uint32_t numThreads, const Affinity& in_affinity, ref_ptr<ActivityStatus> in_status) :
+    Inherit(0, in_status),
+    affinity(in_affinity)
+{
+    // create all the workers before starting any threads so workers can safely steal from each other
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        _workers.push_back(std::move(worker));
+    }
+
+    auto cpu_itr = affinity.cpus.begin();
+    for (auto& worker : _workers)
+    {
+        worker->thread = std::thread(&JobSystem::_workerLoop, this, worker.get());
+
+        if (affinity.cpus.size() >= _workers.size())
+            setAffinity(worker->thread, Affinity(*(cpu_itr++)));
+        else if (affinity)
+            setAffinity(worker->thread, affinity);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    stop();
+}
+
+void JobSystem::add(ref_ptr<Operation> operation)
+{
+    if (!operation) return;
+
+    if (auto job = operation.cast<Job>())
+    {
+        job->_jobSystem = this;
+
+        // release the count held until the Job is added, if dependencies are outstanding the last one to complete will schedule it
+        if (job->_pendingCount.fetch_sub(1) != 1) return;
+    }
+
+    _schedule(operation);
+}
+
+void JobSystem::_schedule(ref_ptr<Operation> operation)
+{
+    if (s_currentJobSystem == this)
+        _workers[s_currentWorkerIndex]->deque.push(operation.get());
+    else
+        queue->add(operation);
+
+    ++_numQueued;
+
+    if (_numSleeping.load() > 0)
+    {
+        std::scoped_lock lock(_sleepMutex);
+        _sleepCV.notify_one();
+    }
+}
+
+ref_ptr<Operation> JobSystem::_next(Worker* worker)
+{
+    ref_ptr<Operation> operation;
+    if (worker) operation = worker->deque.take();
+    if (!operation) operation = queue->take();
+
+    for (size_t i = 0; !operation && i < _workers.size(); ++i)
+    {
+        // start with the next worker along so that stealing is spread across the workers
+        auto& victim = _workers[(worker ? (worker->index + 1 + i) : i) % _workers.size()];
+        if (victim.get() != worker) operation = victim->deque.steal();
+    }
+
+    if (operation) --_numQueued;
+    return operation;
+}
+
+void JobSystem::_workerLoop(Worker* worker)
+{
+    s_currentJobSystem = this;
+    s_currentWorkerIndex = worker->index;
+
+    while (status->active())
+    {
+        if (auto operation = _next(worker))
+        {
+            operation->run();
+            continue;
+        }
+
+        std::unique_lock lock(_sleepMutex);
+        ++_numSleeping;
+        _sleepCV.wait(lock, [&]() { return _numQueued.load() > 0 || status->cancel(); });
+        --_numSleeping;
+    }
+
+    s_currentJobSystem = nullptr;
+}
+
+void JobSystem::run()
+{
+    if (s_currentJobSystem == this)
+    {
+        // when called from within a running operation only help with work this worker has added, so that an operation
+        // waiting on its own work can't end up nested inside an unrelated long running operation it picked up.
+        auto& worker = _workers[s_currentWorkerIndex];
+        while (auto operation = worker->deque.take())
+        {
+            --_numQueued;
+            operation->run();
+        }
+        return;
+    }
+
+    while (auto operation = _next(nullptr))
+    {
+        operation->run();
+    }
+}
+
+void JobSystem::stop()
+{
+    status->set(false);
+
+    {
+        std::scoped_lock lock(_sleepMutex);
+        _sleepCV.notify_all();
+    }
+
+    for (auto& worker : _workers)
+    {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
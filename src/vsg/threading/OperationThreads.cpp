@@ -11,10 +11,47 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/io/Options.h>
+#include <vsg/threading/Latch.h>
 #include <vsg/threading/OperationThreads.h>
 
+#include <exception>
+#include <mutex>
+
 using namespace vsg;
 
+namespace
+{
+    struct LatchedOperation : public Operation
+    {
+        LatchedOperation(const std::function<void()>& in_function, ref_ptr<Latch> in_latch, std::exception_ptr& in_exception, std::mutex& in_mutex) :
+            function(in_function),
+            latch(in_latch),
+            exception(in_exception),
+            mutex(in_mutex) {}
+
+        void run() override
+        {
+            try
+            {
+                function();
+            }
+            catch (...)
+            {
+                std::scoped_lock<std::mutex> lock(mutex);
+                if (!exception) exception = std::current_exception();
+            }
+
+            // always count down so the thread waiting on the latch is released
+            latch->count_down();
+        }
+
+        std::function<void()> function;
+        ref_ptr<Latch> latch;
+        std::exception_ptr& exception;
+        std::mutex& mutex;
+    };
+} // namespace
+
 OperationThreads::OperationThreads(uint32_t numThreads, ref_ptr<ActivityStatus> in_status) :
     status(in_status)
 {
@@ -62,3 +99,23 @@ void OperationThreads::stop()
 
     threads.clear();
 }
+
+void vsg::runAndWait(OperationThreads& operationThreads, const std::vector<std::function<void()>>& functions)
+{
+    if (functions.empty()) return;
+
+    std::exception_ptr exception;
+    std::mutex mutex;
+
+    auto latch = Latch::create(functions.size());
+    for (auto& function : functions)
+    {
+        operationThreads.add(ref_ptr<Operation>(new LatchedOperation(function, latch, exception, mutex)));
+    }
+
+    // use this thread to run operations as well
+    operationThreads.run();
+    latch->wait();
+
+    if (exception) std::rethrow_exception(exception);
+}
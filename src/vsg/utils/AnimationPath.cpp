@@ -15,11 +15,15 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/io/read.h>
 #include <vsg/io/write.h>
+#include <vsg/maths/simd.h>
 #include <vsg/nodes/MatrixTransform.h>
 #include <vsg/ui/ApplicationEvent.h>
 #include <vsg/ui/PrintEvents.h>
 #include <vsg/utils/AnimationPath.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace vsg;
 
 double AnimationPath::period() const
@@ -73,6 +77,72 @@ dmat4 AnimationPath::computeMatrix(double time) const
     return vsg::translate(location.position) * vsg::rotate(location.orientation) * vsg::scale(location.scale);
 }
 
+size_t AnimationPath::reduce(double positionTolerance, double orientationTolerance, double scaleTolerance)
+{
+    if (locations.size() <= 2) return 0;
+
+    std::vector<std::pair<double, Location>> points(locations.begin(), locations.end());
+    std::vector<bool> keep(points.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+
+    auto ratio = [](double error, double tolerance) {
+        if (tolerance > 0.0) return error / tolerance;
+        return error > 0.0 ? std::numeric_limits<double>::max() : 0.0;
+    };
+
+    // error of interpolating point i from the first and last points, relative to the tolerances
+    auto relativeError = [&](size_t first, size_t last, size_t i) {
+        auto& [t0, l0] = points[first];
+        auto& [t1, l1] = points[last];
+        auto& [t, l] = points[i];
+        double r = (t - t0) / (t1 - t0);
+
+        double positionError = length(mix(l0.position, l1.position, r) - l.position);
+        double d = std::abs(dot(mix(l0.orientation, l1.orientation, r), l.orientation));
+        double orientationError = 2.0 * std::acos(std::min(d, 1.0));
+        dvec3 scaleDelta = mix(l0.scale, l1.scale, r) - l.scale;
+        double scaleError = std::max({std::abs(scaleDelta.x), std::abs(scaleDelta.y), std::abs(scaleDelta.z)});
+
+        return std::max({ratio(positionError, positionTolerance), ratio(orientationError, orientationTolerance), ratio(scaleError, scaleTolerance)});
+    };
+
+    // Douglas-Peucker, keep the point with largest error within each segment until all the points between kept points are within tolerance
+    std::vector<std::pair<size_t, size_t>> segments{{0, points.size() - 1}};
+    while (!segments.empty())
+    {
+        auto [first, last] = segments.back();
+        segments.pop_back();
+
+        size_t maxIndex = 0;
+        double maxError = 1.0;
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            double error = relativeError(first, last, i);
+            if (error > maxError)
+            {
+                maxError = error;
+                maxIndex = i;
+            }
+        }
+
+        if (maxIndex != 0)
+        {
+            keep[maxIndex] = true;
+            segments.emplace_back(first, maxIndex);
+            segments.emplace_back(maxIndex, last);
+        }
+    }
+
+    locations.clear();
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        if (keep[i]) locations.insert(locations.end(), points[i]);
+    }
+
+    return points.size() - locations.size();
+}
+
 void AnimationPath::read(Input& input)
 {
     vsg::Object::read(input);
@@ -112,6 +182,236 @@ void AnimationPath::write(Output& output) const
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// CompactAnimationPath
+//
+CompactAnimationPath::CompactAnimationPath()
+{
+}
+
+CompactAnimationPath::CompactAnimationPath(const AnimationPath& path) :
+    mode(path.mode)
+{
+    times.reserve(path.locations.size());
+    positions.reserve(path.locations.size());
+    orientations.reserve(path.locations.size());
+
+    bool unitScale = true;
+    for (auto& [time, location] : path.locations)
+    {
+        times.push_back(time);
+        positions.push_back(location.position);
+        orientations.push_back(quat(location.orientation));
+        if (location.scale != dvec3(1.0, 1.0, 1.0)) unitScale = false;
+    }
+
+    if (!unitScale)
+    {
+        scales.reserve(path.locations.size());
+        for (auto& location : path.locations) scales.push_back(vec3(location.second.scale));
+    }
+}
+
+double CompactAnimationPath::localTime(double time) const
+{
+    if (times.empty()) return time;
+
+    double start = times.front();
+    double p = period();
+    if (p > 0.0)
+    {
+        if (mode == AnimationPath::REPEAT)
+        {
+            time = start + std::fmod(time - start, p);
+        }
+        else if (mode == AnimationPath::FORWARD_AND_BACK)
+        {
+            double t = std::fmod(time - start, p * 2.0);
+            if (t <= p)
+                time = start + t;
+            else
+                time = start + p * 2.0 - t;
+        }
+    }
+
+    return std::clamp(time, start, times.back());
+}
+
+size_t CompactAnimationPath::findInterval(double time, size_t& hint) const
+{
+    size_t last = times.size() - 2;
+    size_t i = std::min(hint, last);
+
+    if (time >= times[i])
+    {
+        // playback is usually forward so step on from the hint a few intervals before resorting to a binary search
+        size_t end = std::min(i + 4, last);
+        while (i < end && time > times[i + 1]) ++i;
+        if (time > times[i + 1])
+        {
+            i = static_cast<size_t>(std::upper_bound(times.begin() + i, times.end(), time) - times.begin()) - 1;
+        }
+    }
+    else
+    {
+        i = static_cast<size_t>(std::upper_bound(times.begin(), times.begin() + i, time) - times.begin());
+        if (i > 0) --i;
+    }
+
+    hint = std::min(i, last);
+    return hint;
+}
+
+AnimationPath::Location CompactAnimationPath::computeLocation(double time) const
+{
+    size_t hint = 0;
+    return computeLocation(time, hint);
+}
+
+AnimationPath::Location CompactAnimationPath::computeLocation(double time, size_t& hint) const
+{
+    auto location = [&](size_t i) {
+        return AnimationPath::Location{positions[i], dquat(orientations[i]), scales.empty() ? dvec3(1.0, 1.0, 1.0) : dvec3(scales[i])};
+    };
+
+    if (times.empty()) return {};
+    if (times.size() == 1) return location(0);
+
+    double t = localTime(time);
+    size_t i = findInterval(t, hint);
+    double r = (t - times[i]) / (times[i + 1] - times[i]);
+
+    auto lower = location(i);
+    auto upper = location(i + 1);
+    return AnimationPath::Location{mix(lower.position, upper.position, r), mix(lower.orientation, upper.orientation, r), mix(lower.scale, upper.scale, r)};
+}
+
+dmat4 CompactAnimationPath::computeMatrix(double time) const
+{
+    size_t hint = 0;
+    return computeMatrix(time, hint);
+}
+
+dmat4 CompactAnimationPath::computeMatrix(double time, size_t& hint) const
+{
+    auto location = computeLocation(time, hint);
+    return vsg::translate(location.position) * vsg::rotate(location.orientation) * vsg::scale(location.scale);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// AnimationPathBatch
+//
+namespace
+{
+#if defined(VSG_SIMD_SSE2)
+    // sum of the four components, broadcast to all components
+    inline __m128 horizontal_sum(__m128 v)
+    {
+        __m128 s = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+#endif
+
+    // compute translate(position) * rotate(orientation) * scale(scale) interpolated between control points i and j
+    void interpolateMatrix(const CompactAnimationPath& path, size_t i, size_t j, double r, dmat4& matrix)
+    {
+        const dvec3& p0 = path.positions[i];
+        const dvec3& p1 = path.positions[j];
+        const quat& q0 = path.orientations[i];
+        const quat& q1 = path.orientations[j];
+
+        dvec3 position;
+        dquat q;
+
+#if defined(VSG_SIMD_SSE2)
+        __m128d rd = _mm_set1_pd(r);
+        __m128d a_xy = _mm_loadu_pd(p0.data());
+        __m128d b_xy = _mm_loadu_pd(p1.data());
+        _mm_storeu_pd(position.data(), _mm_add_pd(a_xy, _mm_mul_pd(_mm_sub_pd(b_xy, a_xy), rd)));
+        position.z = p0.z + (p1.z - p0.z) * r;
+
+        __m128 rf = _mm_set1_ps(static_cast<float>(r));
+        __m128 a = _mm_loadu_ps(q0.data());
+        __m128 b = _mm_loadu_ps(q1.data());
+
+        // negate b when the quaternions are in opposite hemispheres so that the shortest path is taken
+        __m128 negative = _mm_cmplt_ps(horizontal_sum(_mm_mul_ps(a, b)), _mm_setzero_ps());
+        b = _mm_xor_ps(b, _mm_and_ps(negative, _mm_set1_ps(-0.0f)));
+
+        __m128 v = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), rf));
+        v = _mm_div_ps(v, _mm_sqrt_ps(horizontal_sum(_mm_mul_ps(v, v))));
+
+        alignas(16) float qf[4];
+        _mm_store_ps(qf, v);
+        q.set(qf[0], qf[1], qf[2], qf[3]);
+#else
+        position = p0 + (p1 - p0) * r;
+
+        double sign = dot(q0, q1) < 0.0f ? -1.0 : 1.0;
+        q.x = q0.x + (q1.x * sign - q0.x) * r;
+        q.y = q0.y + (q1.y * sign - q0.y) * r;
+        q.z = q0.z + (q1.z * sign - q0.z) * r;
+        q.w = q0.w + (q1.w * sign - q0.w) * r;
+        q = normalize(q);
+#endif
+
+        dvec3 s(1.0, 1.0, 1.0);
+        if (!path.scales.empty())
+        {
+            s = mix(dvec3(path.scales[i]), dvec3(path.scales[j]), r);
+        }
+
+        double qxx = q.x * q.x, qyy = q.y * q.y, qzz = q.z * q.z;
+        double qxy = q.x * q.y, qxz = q.x * q.z, qyz = q.y * q.z;
+        double qwx = q.w * q.x, qwy = q.w * q.y, qwz = q.w * q.z;
+
+        matrix.set((1.0 - 2.0 * (qyy + qzz)) * s.x, 2.0 * (qxy + qwz) * s.x, 2.0 * (qxz - qwy) * s.x, 0.0,
+                   2.0 * (qxy - qwz) * s.y, (1.0 - 2.0 * (qxx + qzz)) * s.y, 2.0 * (qyz + qwx) * s.y, 0.0,
+                   2.0 * (qxz + qwy) * s.z, 2.0 * (qyz - qwx) * s.z, (1.0 - 2.0 * (qxx + qyy)) * s.z, 0.0,
+                   position.x, position.y, position.z, 1.0);
+    }
+} // namespace
+
+size_t AnimationPathBatch::add(ref_ptr<CompactAnimationPath> path, double timeOffset)
+{
+    entries.push_back(Entry{path, timeOffset, 0});
+    return entries.size() - 1;
+}
+
+void AnimationPathBatch::computeMatrices(double time, dmat4* matrices)
+{
+    for (auto& entry : entries)
+    {
+        dmat4& matrix = *(matrices++);
+
+        if (!entry.path || entry.path->times.empty())
+        {
+            matrix = dmat4();
+            continue;
+        }
+
+        auto& path = *entry.path;
+        if (path.times.size() == 1)
+        {
+            interpolateMatrix(path, 0, 0, 0.0, matrix);
+            continue;
+        }
+
+        double t = path.localTime(time + entry.timeOffset);
+        size_t i = path.findInterval(t, entry.hint);
+        double r = (t - path.times[i]) / (path.times[i + 1] - path.times[i]);
+        interpolateMatrix(path, i, i + 1, r, matrix);
+    }
+}
+
+void AnimationPathBatch::computeMatrices(double time, std::vector<dmat4>& matrices)
+{
+    matrices.resize(entries.size());
+    if (!entries.empty()) computeMatrices(time, matrices.data());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // AnimationPathHandler
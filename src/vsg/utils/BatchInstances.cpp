@@ -0,0 +1,435 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/ArrayState.h>
+#include <vsg/state/VertexInputState.h>
+#include <vsg/utils/BatchInstances.h>
+#include <vsg/utils/ComputeBounds.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+namespace
+{
+    bool isTranslation(const dmat4& m, double epsilon)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                if (c == 3 && r != 3) continue;
+                double expected = (c == r) ? 1.0 : 0.0;
+                if (std::abs(m[c][r] - expected) > epsilon) return false;
+            }
+        }
+        return true;
+    }
+
+    /// return the VertexIndexDraw at the end of a chain of single child StateGroups, or nullptr if the subgraph can't be instanced
+    VertexIndexDraw* instanceableDraw(Node* node, std::vector<StateGroup*>& chain)
+    {
+        while (auto stateGroup = node->cast<StateGroup>())
+        {
+            // a custom ArrayState maps the arrays in a way the PositionArrayState assigned to the batch won't know about
+            if (stateGroup->children.size() != 1 || stateGroup->prototypeArrayState) return nullptr;
+            chain.push_back(stateGroup);
+            node = stateGroup->children.front();
+        }
+
+        auto vid = node->cast<VertexIndexDraw>();
+        if (vid && vid->instanceCount == 1 && vid->firstInstance == 0 && vid->indices) return vid;
+        return nullptr;
+    }
+
+    /// split instances spatially until each cluster has no more than maximumSize instances
+    void cluster(std::vector<uint32_t>::iterator begin, std::vector<uint32_t>::iterator end, const std::vector<dvec3>& positions, uint32_t maximumSize, std::vector<std::vector<uint32_t>>& clusters)
+    {
+        auto size = static_cast<size_t>(end - begin);
+        if (size <= maximumSize)
+        {
+            clusters.emplace_back(begin, end);
+            return;
+        }
+
+        dbox bounds;
+        for (auto itr = begin; itr != end; ++itr) bounds.add(positions[*itr]);
+
+        dvec3 extents = bounds.max - bounds.min;
+        int axis = (extents.x >= extents.y && extents.x >= extents.z) ? 0 : ((extents.y >= extents.z) ? 1 : 2);
+
+        auto middle = begin + size / 2;
+        std::nth_element(begin, middle, end, [&](uint32_t lhs, uint32_t rhs) { return positions[lhs][axis] < positions[rhs][axis]; });
+
+        cluster(begin, middle, positions, maximumSize, clusters);
+        cluster(middle, end, positions, maximumSize, clusters);
+    }
+} // namespace
+
+BatchInstances::BatchInstances()
+{
+}
+
+void BatchInstances::apply(Node& node)
+{
+    // instances can only be moved between Group children, so nodes like LOD and Switch stop batching across them
+    auto previousAnchor = _anchor;
+    auto previousParent = _parent;
+    _anchor = nullptr;
+    _parent = nullptr;
+
+    node.traverse(*this);
+
+    _anchor = previousAnchor;
+    _parent = previousParent;
+}
+
+void BatchInstances::apply(Group& group)
+{
+    _traverseAnchor(group);
+}
+
+void BatchInstances::apply(StateGroup& stateGroup)
+{
+    auto previousPipeline = _currentPipeline;
+
+    for (auto& stateCommand : stateGroup.stateCommands)
+    {
+        stateCommand->accept(*this);
+    }
+
+    _traverseAnchor(stateGroup);
+
+    _currentPipeline = previousPipeline;
+}
+
+void BatchInstances::apply(MatrixTransform& transform)
+{
+    if (!_anchor || !isTranslation(transform.matrix, translationEpsilon))
+    {
+        _traverseAnchor(transform);
+        return;
+    }
+
+    _transformParents[&transform].insert(_parent);
+
+    auto previousOffset = _offset;
+    _offset += dvec3(transform.matrix[3][0], transform.matrix[3][1], transform.matrix[3][2]);
+
+    std::vector<StateGroup*> chain;
+    for (auto& child : transform.children)
+    {
+        chain.clear();
+        if (instanceableDraw(child, chain))
+            _instances[Key(_anchor, child.get())].push_back(Instance{&transform, _offset});
+    }
+
+    _traverse(transform);
+
+    _offset = previousOffset;
+}
+
+void BatchInstances::apply(BindGraphicsPipeline& bindPipeline)
+{
+    _currentPipeline = bindPipeline.pipeline.get();
+}
+
+void BatchInstances::_traverse(Group& group)
+{
+    auto previousParent = _parent;
+    _parent = &group;
+
+    std::vector<StateGroup*> chain;
+    for (auto& child : group.children)
+    {
+        // children recorded as instances are left to the batch
+        chain.clear();
+        if (_parent != _anchor && instanceableDraw(child, chain)) continue;
+        child->accept(*this);
+    }
+
+    _parent = previousParent;
+}
+
+void BatchInstances::_traverseAnchor(Group& group)
+{
+    // a shared subgraph is only traversed once, so its batches are only created once
+    auto [itr, inserted] = _anchors.emplace(&group, Anchor{_currentPipeline, true});
+    if (!inserted)
+    {
+        if (itr->second.pipeline != _currentPipeline) itr->second.valid = false;
+        return;
+    }
+
+    auto previousAnchor = _anchor;
+    auto previousOffset = _offset;
+    _anchor = &group;
+    _offset = {};
+
+    _traverse(group);
+
+    _anchor = previousAnchor;
+    _offset = previousOffset;
+}
+
+ref_ptr<GraphicsPipeline> BatchInstances::_instancedPipeline(const GraphicsPipeline* pipeline, uint32_t positionBinding)
+{
+    auto& instancedPipeline = _pipelines[{pipeline, positionBinding}];
+    if (instancedPipeline) return instancedPipeline;
+
+    GraphicsPipelineStates pipelineStates;
+    bool hasVertexInputState = false;
+    for (auto& pipelineState : pipeline->pipelineStates)
+    {
+        if (auto vis = pipelineState.cast<VertexInputState>())
+        {
+            for (auto& binding : vis->vertexBindingDescriptions)
+            {
+                if (binding.binding == positionBinding) return {};
+            }
+            for (auto& attribute : vis->vertexAttributeDescriptions)
+            {
+                if (attribute.location == positionLocation) return {};
+            }
+
+            auto instancedVIS = VertexInputState::create(*vis);
+            instancedVIS->vertexBindingDescriptions.push_back(VkVertexInputBindingDescription{positionBinding, sizeof(vec3), VK_VERTEX_INPUT_RATE_INSTANCE});
+            instancedVIS->vertexAttributeDescriptions.push_back(VkVertexInputAttributeDescription{positionLocation, positionBinding, VK_FORMAT_R32G32B32_SFLOAT, 0});
+            pipelineStates.push_back(instancedVIS);
+            hasVertexInputState = true;
+        }
+        else
+        {
+            pipelineStates.push_back(pipelineState);
+        }
+    }
+    if (!hasVertexInputState) return {};
+
+    ShaderStages stages;
+    for (auto& stage : pipeline->stages)
+    {
+        if (stage->stage != VK_SHADER_STAGE_VERTEX_BIT)
+        {
+            stages.push_back(stage);
+            continue;
+        }
+
+        // the define can only be applied when the shader is compiled from source
+        auto& module = stage->module;
+        if (!module || module->source.empty()) return {};
+
+        auto hints = module->hints ? ShaderCompileSettings::create(*module->hints) : ShaderCompileSettings::create();
+        if (hints->defines.count(instancePositionsDefine) != 0 || hints->defines.count("VSG_BILLBOARD") != 0) return {};
+        hints->defines.insert(instancePositionsDefine);
+
+        auto instancedStage = ShaderStage::create(stage->stage, stage->entryPointName, ShaderModule::create(module->source, hints));
+        instancedStage->mask = stage->mask;
+        instancedStage->flags = stage->flags;
+        instancedStage->specializationConstants = stage->specializationConstants;
+        stages.push_back(instancedStage);
+    }
+
+    instancedPipeline = GraphicsPipeline::create(pipeline->layout, stages, pipelineStates, pipeline->subpass);
+    return instancedPipeline;
+}
+
+bool BatchInstances::_batch(const Key& key, const std::vector<Instance>& instances)
+{
+    auto [anchor, subgraph] = key;
+
+    std::vector<StateGroup*> chain;
+    auto vid = instanceableDraw(subgraph, chain);
+    if (!vid) return false;
+
+    // use the pipeline bound within the subgraph, otherwise the one inherited from above the anchor
+    const GraphicsPipeline* pipeline = _anchors[anchor].pipeline;
+    BindGraphicsPipeline* bindPipeline = nullptr;
+    for (auto& stateGroup : chain)
+    {
+        for (auto& stateCommand : stateGroup->stateCommands)
+        {
+            if (auto bgp = stateCommand.cast<BindGraphicsPipeline>())
+            {
+                bindPipeline = bgp;
+                pipeline = bgp->pipeline;
+            }
+        }
+    }
+    if (!pipeline) return false;
+
+    uint32_t positionBinding = vid->firstBinding + static_cast<uint32_t>(vid->arrays.size());
+    auto instancedPipeline = _instancedPipeline(pipeline, positionBinding);
+    if (!instancedPipeline) return false;
+
+    ComputeBounds computeBounds;
+    subgraph->accept(computeBounds);
+    if (!computeBounds.bounds.valid()) return false;
+    const dbox& localBounds = computeBounds.bounds;
+
+    auto instancedBindPipeline = BindGraphicsPipeline::create(instancedPipeline);
+
+    // replicate the StateGroup chain with the pipeline replaced by the instanced version
+    auto root = StateGroup::create();
+    auto arrayState = PositionArrayState::create();
+    arrayState->position_attribute_location = positionLocation;
+    root->prototypeArrayState = arrayState;
+    if (!bindPipeline) root->add(instancedBindPipeline);
+
+    ref_ptr<Group> parent = root;
+    for (auto& stateGroup : chain)
+    {
+        auto replicated = StateGroup::create();
+        for (auto& stateCommand : stateGroup->stateCommands)
+        {
+            if (stateCommand == bindPipeline)
+                replicated->add(instancedBindPipeline);
+            else
+                replicated->add(stateCommand);
+        }
+        parent->addChild(replicated);
+        parent = replicated;
+    }
+
+    std::vector<dvec3> positions;
+    for (auto& instance : instances) positions.push_back(instance.position);
+
+    std::vector<uint32_t> order(positions.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    std::vector<std::vector<uint32_t>> clusters;
+    cluster(order.begin(), order.end(), positions, std::max(maximumInstancesPerCluster, 1u), clusters);
+
+    for (auto& members : clusters)
+    {
+        auto positionArray = vec3Array::create(static_cast<uint32_t>(members.size()));
+        dbox bounds;
+        for (size_t i = 0; i < members.size(); ++i)
+        {
+            auto& position = positions[members[i]];
+            positionArray->set(i, vec3(position));
+            bounds.add(localBounds.min + position);
+            bounds.add(localBounds.max + position);
+        }
+
+        auto instancedDraw = VertexIndexDraw::create();
+        instancedDraw->firstBinding = vid->firstBinding;
+        instancedDraw->arrays = vid->arrays;
+        instancedDraw->arrays.push_back(BufferInfo::create(positionArray));
+        // assign the index data to set up the index type, then share the original BufferInfo so the indices are only uploaded once
+        instancedDraw->assignIndices(vid->indices->data);
+        instancedDraw->indices = vid->indices;
+        instancedDraw->indexCount = vid->indexCount;
+        instancedDraw->firstIndex = vid->firstIndex;
+        instancedDraw->vertexOffset = vid->vertexOffset;
+        instancedDraw->instanceCount = static_cast<uint32_t>(members.size());
+
+        dvec3 center = (bounds.min + bounds.max) * 0.5;
+        parent->addChild(CullNode::create(dsphere(center, length(bounds.max - center)), instancedDraw));
+    }
+
+    anchor->addChild(root);
+
+    ++numBatches;
+    numClusters += static_cast<uint32_t>(clusters.size());
+    numInstances += static_cast<uint32_t>(instances.size());
+    return true;
+}
+
+uint32_t BatchInstances::batch()
+{
+    uint32_t previousNumBatches = numBatches;
+
+    // a transform's child can only be removed if every instance it provides is batched
+    std::set<Key> candidates;
+    for (auto& [key, instances] : _instances)
+    {
+        if (instances.size() >= minimumInstances && _anchors[key.first].valid) candidates.insert(key);
+    }
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        std::set<std::pair<MatrixTransform*, Node*>> blocked;
+        for (auto& [key, instances] : _instances)
+        {
+            if (candidates.count(key) != 0) continue;
+            for (auto& instance : instances) blocked.emplace(instance.transform, key.second);
+        }
+
+        for (auto itr = candidates.begin(); itr != candidates.end();)
+        {
+            auto& instances = _instances[*itr];
+            bool isBlocked = std::any_of(instances.begin(), instances.end(), [&](const Instance& instance) { return blocked.count({instance.transform, itr->second}) != 0; });
+            if (isBlocked)
+            {
+                itr = candidates.erase(itr);
+                changed = true;
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+    }
+
+    std::set<MatrixTransform*> modified;
+    for (auto& key : candidates)
+    {
+        auto& instances = _instances[key];
+        if (!_batch(key, instances)) continue;
+
+        // keep a reference to the subgraph while it's removed from the transforms as the batch may not be its only remaining user
+        ref_ptr<Node> subgraph(key.second);
+        for (auto& instance : instances)
+        {
+            auto& children = instance.transform->children;
+            children.erase(std::remove(children.begin(), children.end(), subgraph), children.end());
+            modified.insert(instance.transform);
+        }
+    }
+
+    // remove transforms that have been emptied, repeating for parent transforms that become empty in turn
+    while (!modified.empty())
+    {
+        std::set<MatrixTransform*> nextModified;
+        for (auto& transform : modified)
+        {
+            if (!transform->children.empty()) continue;
+
+            ref_ptr<MatrixTransform> ref_transform(transform);
+            for (auto& parent : _transformParents[transform])
+            {
+                if (!parent) continue;
+                auto& children = parent->children;
+                children.erase(std::remove(children.begin(), children.end(), ref_transform), children.end());
+
+                if (auto parentTransform = parent->cast<MatrixTransform>(); parentTransform && _transformParents.count(parentTransform) != 0)
+                {
+                    nextModified.insert(parentTransform);
+                }
+            }
+        }
+        modified.swap(nextModified);
+    }
+
+    _anchors.clear();
+    _instances.clear();
+    _transformParents.clear();
+    _pipelines.clear();
+
+    return numBatches - previousNumBatches;
+}
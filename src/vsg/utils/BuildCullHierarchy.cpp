@@ -0,0 +1,175 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/utils/BuildCullHierarchy.h>
+#include <vsg/utils/ComputeBounds.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace vsg;
+
+namespace
+{
+    double surfaceArea(const dbox& bounds)
+    {
+        if (!bounds.valid()) return 0.0;
+        auto d = bounds.max - bounds.min;
+        return 2.0 * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+} // namespace
+
+BuildCullHierarchy::BuildCullHierarchy()
+{
+}
+
+void BuildCullHierarchy::apply(Node& node)
+{
+    node.traverse(*this);
+}
+
+void BuildCullHierarchy::apply(Group& group)
+{
+    if (!_visited.insert(&group).second) return;
+
+    group.traverse(*this);
+
+    // only reorganize Groups where the order and position of children carries no meaning beyond draw order
+    const auto& type = group.type_info();
+    bool reorganizable = type == typeid(Group) || type == typeid(CullGroup) || type == typeid(StateGroup) || type == typeid(MatrixTransform);
+    if (!reorganizable || group.children.size() < std::max(minimumChildren, 2u)) return;
+
+    Group::Children unbounded;
+    Items items;
+    items.reserve(group.children.size());
+    for (auto& child : group.children)
+    {
+        ComputeBounds computeBounds;
+        child->accept(computeBounds);
+        if (computeBounds.bounds.valid())
+        {
+            auto& bounds = computeBounds.bounds;
+            items.push_back(Item{child, bounds, (bounds.min + bounds.max) * 0.5});
+        }
+        else
+        {
+            unbounded.push_back(child);
+        }
+    }
+
+    if (items.size() < std::max(minimumChildren, 2u)) return;
+
+    auto root = _build(items.begin(), items.end());
+
+    group.children.swap(unbounded);
+    group.children.push_back(root);
+
+    ++numGroupsReorganized;
+}
+
+ref_ptr<CullGroup> BuildCullHierarchy::_build(Items::iterator begin, Items::iterator end)
+{
+    dbox bounds;
+    dbox centers;
+    for (auto itr = begin; itr != end; ++itr)
+    {
+        bounds.add(itr->bounds);
+        centers.add(itr->center);
+    }
+
+    auto cullGroup = CullGroup::create(dsphere((bounds.min + bounds.max) * 0.5, length(bounds.max - bounds.min) * 0.5));
+    ++numCullGroupsCreated;
+
+    auto count = static_cast<size_t>(end - begin);
+    auto extents = centers.max - centers.min;
+    int axis = (extents.x >= extents.y && extents.x >= extents.z) ? 0 : (extents.y >= extents.z ? 1 : 2);
+
+    if (count <= std::max(maximumLeafChildren, 1u) || extents[axis] <= 0.0)
+    {
+        cullGroup->children.reserve(count);
+        for (auto itr = begin; itr != end; ++itr) cullGroup->addChild(itr->node);
+        return cullGroup;
+    }
+
+    // bin the centers along the longest axis and pick the split with the lowest surface area heuristic cost
+    struct Bucket
+    {
+        size_t count = 0;
+        dbox bounds;
+    };
+
+    auto numBins = std::max(numBuckets, 2u);
+    std::vector<Bucket> buckets(numBins);
+    auto bucketIndex = [&](const Item& item) {
+        auto b = static_cast<size_t>(double(numBins) * (item.center[axis] - centers.min[axis]) / extents[axis]);
+        return std::min(b, static_cast<size_t>(numBins - 1));
+    };
+
+    for (auto itr = begin; itr != end; ++itr)
+    {
+        auto& bucket = buckets[bucketIndex(*itr)];
+        ++bucket.count;
+        bucket.bounds.add(itr->bounds);
+    }
+
+    // accumulate the right hand side from the far end so each split can be costed in a single pass
+    std::vector<double> rightCost(numBins, 0.0);
+    {
+        dbox right;
+        size_t rightCount = 0;
+        for (size_t i = numBins - 1; i > 0; --i)
+        {
+            right.add(buckets[i].bounds);
+            rightCount += buckets[i].count;
+            rightCost[i] = surfaceArea(right) * double(rightCount);
+        }
+    }
+
+    size_t bestSplit = 0;
+    double bestCost = std::numeric_limits<double>::max();
+    {
+        dbox left;
+        size_t leftCount = 0;
+        for (size_t i = 1; i < numBins; ++i)
+        {
+            left.add(buckets[i - 1].bounds);
+            leftCount += buckets[i - 1].count;
+            if (leftCount == 0 || leftCount == count) continue;
+
+            double cost = surfaceArea(left) * double(leftCount) + rightCost[i];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestSplit = i;
+            }
+        }
+    }
+
+    Items::iterator middle;
+    if (bestSplit > 0)
+    {
+        middle = std::partition(begin, end, [&](const Item& item) { return bucketIndex(item) < bestSplit; });
+    }
+    else
+    {
+        // all the centers fell in one bucket, fall back to a median split
+        middle = begin + count / 2;
+        std::nth_element(begin, middle, end, [axis](const Item& lhs, const Item& rhs) { return lhs.center[axis] < rhs.center[axis]; });
+    }
+
+    cullGroup->children.reserve(2);
+    cullGroup->addChild(_build(begin, middle));
+    cullGroup->addChild(_build(middle, end));
+    return cullGroup;
+}
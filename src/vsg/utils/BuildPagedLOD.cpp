@@ -0,0 +1,486 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/DrawIndexed.h>
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/write.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/PagedLOD.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/VertexInputState.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/utils/BuildPagedLOD.h>
+#include <vsg/utils/GenerateLODs.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+using namespace vsg;
+
+namespace
+{
+    bool readIndices(const Data* data, std::vector<uint32_t>& indices)
+    {
+        if (!data || !data->dataAvailable() || data->stride() != data->valueSize()) return false;
+
+        auto copy = [&](auto array) {
+            indices.assign(array->begin(), array->end());
+            return true;
+        };
+
+        if (auto us = data->cast<ushortArray>()) return copy(us);
+        if (auto ui = data->cast<uintArray>()) return copy(ui);
+        if (auto ub = data->cast<ubyteArray>()) return copy(ub);
+        return false;
+    }
+
+    /// copy the values of the used vertices into a new array, handles interleaved arrays where each vertex spans several values
+    ref_ptr<Data> gatherVertices(const Data& data, size_t numVertices, const std::vector<uint32_t>& used)
+    {
+        size_t bytesPerVertex = data.dataSize() / numVertices;
+        size_t valuesPerVertex = bytesPerVertex / data.valueSize();
+
+        auto array = createArrayLike(data, static_cast<uint32_t>(used.size() * valuesPerVertex));
+        if (!array) return {};
+
+        auto src = static_cast<const uint8_t*>(data.dataPointer());
+        auto dest = static_cast<uint8_t*>(array->dataPointer());
+        for (size_t i = 0; i < used.size(); ++i)
+        {
+            std::memcpy(dest + i * bytesPerVertex, src + used[i] * bytesPerVertex, bytesPerVertex);
+        }
+        return array;
+    }
+} // namespace
+
+BuildPagedLOD::BuildPagedLOD(const Path& in_outputDirectory, ref_ptr<const Options> in_options) :
+    outputDirectory(in_outputDirectory),
+    options(in_options)
+{
+    _matrixStack.emplace_back();
+}
+
+void BuildPagedLOD::apply(Node& node)
+{
+    node.traverse(*this);
+}
+
+void BuildPagedLOD::apply(StateGroup& stateGroup)
+{
+    auto previousPipeline = _currentPipeline;
+
+    for (auto& stateCommand : stateGroup.stateCommands)
+    {
+        stateCommand->accept(*this);
+    }
+
+    _stateGroups.emplace_back(&stateGroup);
+    stateGroup.traverse(*this);
+    _stateGroups.pop_back();
+
+    _currentPipeline = previousPipeline;
+}
+
+void BuildPagedLOD::apply(Transform& transform)
+{
+    _matrixStack.push_back(transform.transform(_matrixStack.back()));
+    transform.traverse(*this);
+    _matrixStack.pop_back();
+}
+
+void BuildPagedLOD::apply(BindGraphicsPipeline& bindPipeline)
+{
+    _currentPipeline = bindPipeline.pipeline.get();
+}
+
+void BuildPagedLOD::apply(VertexIndexDraw& vid)
+{
+    if (vid.vertexOffset != 0) return;
+    _addDraw(vid, vid.firstBinding, vid.arrays, vid.indices, vid.firstIndex, vid.indexCount, vid.instanceCount);
+}
+
+void BuildPagedLOD::apply(Geometry& geometry)
+{
+    for (auto& command : geometry.commands)
+    {
+        if (auto drawIndexed = command.cast<DrawIndexed>(); drawIndexed && drawIndexed->vertexOffset == 0)
+        {
+            _addDraw(geometry, geometry.firstBinding, geometry.arrays, geometry.indices, drawIndexed->firstIndex, drawIndexed->indexCount, drawIndexed->instanceCount);
+        }
+    }
+}
+
+void BuildPagedLOD::_addDraw(Node& /*draw*/, uint32_t firstBinding, const BufferInfoList& arrays, ref_ptr<BufferInfo> indices, uint32_t firstIndex, uint32_t indexCount, uint32_t instanceCount)
+{
+    if (!_currentPipeline || !indices || indexCount < 3) return;
+
+    const VertexInputState* vertexInputState = nullptr;
+    for (auto& state : _currentPipeline->pipelineStates)
+    {
+        if (auto vis = state.cast<VertexInputState>()) vertexInputState = vis;
+        if (auto ias = state.cast<InputAssemblyState>(); ias && ias->topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST) return;
+    }
+    if (!vertexInputState) return;
+
+    Item item;
+    item.stateGroups = _stateGroups;
+    item.matrix = _matrixStack.back();
+    item.firstBinding = firstBinding;
+    item.instanceCount = instanceCount;
+
+    for (auto& bufferInfo : arrays)
+    {
+        if (!bufferInfo || !bufferInfo->data) return;
+        item.arrays.push_back(bufferInfo->data);
+    }
+
+    item.perVertex.resize(item.arrays.size(), false);
+    for (auto& binding : vertexInputState->vertexBindingDescriptions)
+    {
+        if (binding.binding >= firstBinding && (binding.binding - firstBinding) < item.arrays.size())
+        {
+            item.perVertex[binding.binding - firstBinding] = binding.inputRate == VK_VERTEX_INPUT_RATE_VERTEX;
+        }
+    }
+
+    for (auto& attribute : vertexInputState->vertexAttributeDescriptions)
+    {
+        if (attribute.location == vertexLocation && attribute.offset == 0 && attribute.binding >= firstBinding && (attribute.binding - firstBinding) < item.arrays.size())
+        {
+            item.vertices = item.arrays[attribute.binding - firstBinding].cast<vec3Array>();
+        }
+    }
+    if (!item.vertices || item.vertices->stride() != sizeof(vec3)) return;
+
+    // all per vertex arrays must be tightly packed with a whole number of bytes per vertex so they can be split
+    size_t numVertices = item.vertices->size();
+    for (size_t i = 0; i < item.arrays.size(); ++i)
+    {
+        auto& array = item.arrays[i];
+        if (item.perVertex[i] && (array->stride() != array->valueSize() || array->dataSize() % numVertices != 0 || !createArrayLike(*array, 1))) return;
+    }
+
+    std::vector<uint32_t> allIndices;
+    if (!readIndices(indices->data, allIndices) || firstIndex + indexCount > allIndices.size()) return;
+
+    item.indices.assign(allIndices.begin() + firstIndex, allIndices.begin() + firstIndex + (indexCount / 3) * 3);
+    if (!std::all_of(item.indices.begin(), item.indices.end(), [&](uint32_t index) { return index < numVertices; })) return;
+
+    _items.push_back(std::move(item));
+}
+
+void BuildPagedLOD::_split(Cell& cell) const
+{
+    if (cell.numTriangles <= maximumTrianglesPerTile || cell.level + 1 >= maximumLevels) return;
+
+    uint32_t numChildren = quadtree ? 4 : 8;
+    std::vector<std::unique_ptr<Cell>> children(numChildren);
+    for (auto& child : children)
+    {
+        child = std::make_unique<Cell>();
+        child->level = cell.level + 1;
+    }
+
+    // assign each triangle to the child containing its centroid
+    dvec3 center = (cell.bounds.min + cell.bounds.max) * 0.5;
+    for (auto& part : cell.parts)
+    {
+        auto& item = _items[part.item];
+        auto& vertices = *item.vertices;
+
+        std::vector<Part*> childParts(numChildren, nullptr);
+        for (auto t : part.triangles)
+        {
+            dvec3 v0 = item.matrix * dvec3(vertices[item.indices[t * 3]]);
+            dvec3 v1 = item.matrix * dvec3(vertices[item.indices[t * 3 + 1]]);
+            dvec3 v2 = item.matrix * dvec3(vertices[item.indices[t * 3 + 2]]);
+            dvec3 centroid = (v0 + v1 + v2) / 3.0;
+
+            uint32_t c = (centroid.x > center.x ? 1 : 0) | (centroid.y > center.y ? 2 : 0);
+            if (!quadtree && centroid.z > center.z) c |= 4;
+
+            auto& child = *children[c];
+            if (!childParts[c])
+            {
+                child.parts.push_back(Part{part.item, {}});
+                childParts[c] = &child.parts.back();
+            }
+            childParts[c]->triangles.push_back(t);
+            child.bounds.add(v0);
+            child.bounds.add(v1);
+            child.bounds.add(v2);
+            ++child.numTriangles;
+        }
+    }
+
+    children.erase(std::remove_if(children.begin(), children.end(), [](auto& child) { return child->numTriangles == 0; }), children.end());
+
+    // triangles that can't be separated, such as many triangles sharing the same centroid, stay in a leaf
+    if (children.size() < 2) return;
+
+    cell.children = std::move(children);
+}
+
+void BuildPagedLOD::_createContent(Cell& cell) const
+{
+    bool leaf = cell.children.empty();
+    double ratio = leaf ? 1.0 : std::min(1.0, static_cast<double>(maximumTrianglesPerTile) / static_cast<double>(cell.numTriangles));
+    double maximumError = simplificationError * length(cell.bounds.max - cell.bounds.min) * 0.5;
+
+    auto group = Group::create();
+    std::map<std::vector<StateGroup*>, ref_ptr<Group>> stateGroups;
+
+    for (auto& part : cell.parts)
+    {
+        auto& item = _items[part.item];
+
+        std::vector<uint32_t> indices;
+        indices.reserve(part.triangles.size() * 3);
+        for (auto t : part.triangles)
+        {
+            indices.insert(indices.end(), item.indices.begin() + t * 3, item.indices.begin() + t * 3 + 3);
+        }
+
+        if (!leaf)
+        {
+            // the mesh local coordinate frame may be scaled relative to the world so scale the error to match
+            double scale = length(dvec3(item.matrix[0][0], item.matrix[0][1], item.matrix[0][2]));
+            double localError = scale > 0.0 ? maximumError / scale : maximumError;
+            indices = simplifyTriangles(*item.vertices, indices, static_cast<size_t>(static_cast<double>(part.triangles.size()) * ratio), localError);
+            if (indices.empty()) continue;
+        }
+
+        // compact the vertices used by this part
+        std::unordered_map<uint32_t, uint32_t> remap;
+        std::vector<uint32_t> used;
+        for (auto& index : indices)
+        {
+            auto [itr, inserted] = remap.emplace(index, static_cast<uint32_t>(used.size()));
+            if (inserted) used.push_back(index);
+            index = itr->second;
+        }
+
+        DataList arrays;
+        for (size_t i = 0; i < item.arrays.size(); ++i)
+        {
+            if (item.perVertex[i])
+                arrays.push_back(gatherVertices(*item.arrays[i], item.vertices->size(), used));
+            else
+                arrays.push_back(item.arrays[i]);
+        }
+
+        auto vid = VertexIndexDraw::create();
+        vid->firstBinding = item.firstBinding;
+        vid->assignArrays(arrays);
+        if (used.size() <= 65536)
+        {
+            auto shortIndices = ushortArray::create(static_cast<uint32_t>(indices.size()));
+            std::transform(indices.begin(), indices.end(), shortIndices->begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
+            vid->assignIndices(shortIndices);
+        }
+        else
+        {
+            auto intIndices = uintArray::create(static_cast<uint32_t>(indices.size()));
+            std::copy(indices.begin(), indices.end(), intIndices->begin());
+            vid->assignIndices(intIndices);
+        }
+        vid->indexCount = static_cast<uint32_t>(indices.size());
+        vid->instanceCount = item.instanceCount;
+
+        // replicate the StateGroups of the original draw, sharing them between the draws in the same tile
+        std::vector<StateGroup*> key;
+        for (auto& sg : item.stateGroups) key.push_back(sg.get());
+
+        auto& parent = stateGroups[key];
+        if (!parent)
+        {
+            parent = group;
+            for (auto& original : item.stateGroups)
+            {
+                auto stateGroup = StateGroup::create();
+                stateGroup->stateCommands = original->stateCommands;
+                parent->addChild(stateGroup);
+                parent = stateGroup;
+            }
+        }
+
+        if (item.matrix != dmat4())
+        {
+            auto transform = MatrixTransform::create(item.matrix);
+            transform->addChild(vid);
+            parent->addChild(transform);
+        }
+        else
+        {
+            parent->addChild(vid);
+        }
+    }
+
+    cell.content = group;
+}
+
+ref_ptr<Node> BuildPagedLOD::_createNode(Cell& cell, std::vector<std::pair<ref_ptr<Node>, Path>>& files)
+{
+    dvec3 center = (cell.bounds.min + cell.bounds.max) * 0.5;
+    dsphere bound(center, length(cell.bounds.max - center));
+
+    if (cell.children.empty())
+    {
+        return CullNode::create(bound, cell.content);
+    }
+
+    auto children = Group::create();
+    for (auto& child : cell.children)
+    {
+        children->addChild(_createNode(*child, files));
+    }
+
+    Path filename = outputDirectory / cell.filename;
+    files.emplace_back(children, filename);
+
+    auto plod = PagedLOD::create();
+    plod->bound = bound;
+    plod->filename = filename;
+    plod->children[0].minimumScreenHeightRatio = lodTransitionScreenHeightRatio;
+    plod->children[1].minimumScreenHeightRatio = 0.0;
+    plod->children[1].node = cell.content;
+    return plod;
+}
+
+void BuildPagedLOD::_runInParallel(const std::vector<Cell*>& cells, void (BuildPagedLOD::*function)(Cell&) const)
+{
+    if (!operationThreads || cells.size() < 2)
+    {
+        for (auto cell : cells) (this->*function)(*cell);
+        return;
+    }
+
+    struct CellOperation : public Operation
+    {
+        CellOperation(const BuildPagedLOD& in_builder, void (BuildPagedLOD::*in_function)(Cell&) const, Cell& in_cell, ref_ptr<Latch> in_latch) :
+            builder(in_builder),
+            function(in_function),
+            cell(in_cell),
+            latch(in_latch) {}
+
+        void run() override
+        {
+            (builder.*function)(cell);
+            latch->count_down();
+        }
+
+        const BuildPagedLOD& builder;
+        void (BuildPagedLOD::*function)(Cell&) const;
+        Cell& cell;
+        ref_ptr<Latch> latch;
+    };
+
+    auto latch = Latch::create(static_cast<int>(cells.size()));
+    for (auto cell : cells)
+    {
+        operationThreads->add(ref_ptr<Operation>(new CellOperation(*this, function, *cell, latch)));
+    }
+
+    // help out with the cells then wait for the remaining ones to complete
+    operationThreads->run();
+    latch->wait();
+}
+
+ref_ptr<Node> BuildPagedLOD::build()
+{
+    if (_items.empty()) return {};
+
+    Cell root;
+    for (uint32_t i = 0; i < _items.size(); ++i)
+    {
+        auto& item = _items[i];
+        Part part{i, {}};
+        part.triangles.resize(item.indices.size() / 3);
+        for (uint32_t t = 0; t < part.triangles.size(); ++t) part.triangles[t] = t;
+
+        for (auto index : item.indices) root.bounds.add(item.matrix * dvec3(item.vertices->at(index)));
+        root.numTriangles += part.triangles.size();
+        root.parts.push_back(std::move(part));
+    }
+
+    // partition a level at a time, with the cells of each level split in parallel
+    std::vector<Cell*> allCells;
+    std::vector<Cell*> level{&root};
+    while (!level.empty())
+    {
+        _runInParallel(level, &BuildPagedLOD::_split);
+
+        std::vector<Cell*> nextLevel;
+        for (auto cell : level)
+        {
+            cell->filename = make_string(name, "_", cell->level, "_", allCells.size(), extension);
+            allCells.push_back(cell);
+            for (auto& child : cell->children) nextLevel.push_back(child.get());
+        }
+        level.swap(nextLevel);
+    }
+
+    _runInParallel(allCells, &BuildPagedLOD::_createContent);
+
+    // the triangle lists are no longer required once the content is created
+    for (auto cell : allCells) cell->parts.clear();
+
+    makeDirectory(outputDirectory);
+
+    std::vector<std::pair<ref_ptr<Node>, Path>> files;
+    auto rootNode = _createNode(root, files);
+    files.emplace_back(rootNode, outputDirectory / (name + extension));
+
+    struct WriteFile : public Operation
+    {
+        WriteFile(ref_ptr<Node> in_node, const Path& in_filename, ref_ptr<const Options> in_options, ref_ptr<Latch> in_latch) :
+            node(in_node),
+            filename(in_filename),
+            options(in_options),
+            latch(in_latch) {}
+
+        void run() override
+        {
+            if (!vsg::write(node, filename, options)) warn("BuildPagedLOD unable to write ", filename);
+            latch->count_down();
+        }
+
+        ref_ptr<Node> node;
+        Path filename;
+        ref_ptr<const Options> options;
+        ref_ptr<Latch> latch;
+    };
+
+    auto latch = Latch::create(static_cast<int>(files.size()));
+    for (auto& [node, filename] : files)
+    {
+        ref_ptr<Operation> operation(new WriteFile(node, filename, options, latch));
+        if (operationThreads)
+            operationThreads->add(operation);
+        else
+            operation->run();
+    }
+
+    if (operationThreads) operationThreads->run();
+    latch->wait();
+
+    numTiles += static_cast<uint32_t>(files.size());
+    _items.clear();
+
+    return rootNode;
+}
@@ -0,0 +1,300 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/write.h>
+#include <vsg/maths/transform.h>
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/VertexDraw.h>
+#include <vsg/state/BindDescriptorSet.h>
+#include <vsg/state/ColorBlendState.h>
+#include <vsg/state/DepthStencilState.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/state/GraphicsPipeline.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/MultisampleState.h>
+#include <vsg/state/RasterizationState.h>
+#include <vsg/state/VertexInputState.h>
+#include <vsg/utils/BuildPointCloud.h>
+
+#include <unordered_set>
+
+using namespace vsg;
+
+namespace
+{
+    const char* pointCloud_vert = R"(
+#version 450
+
+layout(push_constant) uniform PushConstants {
+    mat4 projection;
+    mat4 modelView;
+} pc;
+
+// x: point size scale, y: minimum point size, z: maximum point size, w: viewport height
+layout(set = 0, binding = 0) uniform PointSizeSettings { vec4 settings; };
+
+layout(location = 0) in vec3 vsg_Vertex;
+layout(location = 1) in vec4 vsg_Color;
+layout(location = 2) in float vsg_PointSpacing;
+
+layout(location = 0) out vec4 color;
+
+out gl_PerVertex {
+    vec4 gl_Position;
+    float gl_PointSize;
+};
+
+void main()
+{
+    gl_Position = pc.projection * pc.modelView * vec4(vsg_Vertex, 1.0);
+
+    // size the point to cover the projected spacing between the octant's points
+    float pixels = settings.x * vsg_PointSpacing * abs(pc.projection[1][1]) * settings.w * 0.5 / max(gl_Position.w, 1e-6);
+    gl_PointSize = clamp(pixels, settings.y, settings.z);
+
+    color = vsg_Color;
+}
+)";
+
+    const char* pointCloud_frag = R"(
+#version 450
+
+layout(location = 0) in vec4 color;
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    // round points
+    vec2 coord = gl_PointCoord * 2.0 - 1.0;
+    if (dot(coord, coord) > 1.0) discard;
+
+    outColor = color;
+}
+)";
+} // namespace
+
+BuildPointCloud::BuildPointCloud(const Path& in_outputDirectory, ref_ptr<const Options> in_options) :
+    outputDirectory(in_outputDirectory),
+    options(in_options),
+    pointSizeSettings(vec4Value::create(vec4(1.0f, 1.0f, 16.0f, 1080.0f)))
+{
+    pointSizeSettings->properties.dataVariance = DYNAMIC_DATA;
+}
+
+ref_ptr<StateGroup> BuildPointCloud::createStateGroup(bool perVertexColors) const
+{
+    DescriptorSetLayoutBindings bindings{
+        {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr}};
+    auto descriptorSetLayout = DescriptorSetLayout::create(bindings);
+
+    auto pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{descriptorSetLayout}, PushConstantRanges{{VK_SHADER_STAGE_VERTEX_BIT, 0, 128}});
+
+    ShaderStages stages{
+        ShaderStage::create(VK_SHADER_STAGE_VERTEX_BIT, "main", pointCloud_vert),
+        ShaderStage::create(VK_SHADER_STAGE_FRAGMENT_BIT, "main", pointCloud_frag)};
+
+    // positions and colors per vertex, with the colors per instance when there is a single color, and the octant's point spacing per instance
+    auto vertexInputState = VertexInputState::create();
+    vertexInputState->vertexBindingDescriptions = {
+        VkVertexInputBindingDescription{0, sizeof(vec3), VK_VERTEX_INPUT_RATE_VERTEX},
+        VkVertexInputBindingDescription{1, sizeof(ubvec4), perVertexColors ? VK_VERTEX_INPUT_RATE_VERTEX : VK_VERTEX_INPUT_RATE_INSTANCE},
+        VkVertexInputBindingDescription{2, sizeof(float), VK_VERTEX_INPUT_RATE_INSTANCE}};
+    vertexInputState->vertexAttributeDescriptions = {
+        VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0},
+        VkVertexInputAttributeDescription{1, 1, VK_FORMAT_R8G8B8A8_UNORM, 0},
+        VkVertexInputAttributeDescription{2, 2, VK_FORMAT_R32_SFLOAT, 0}};
+
+    auto inputAssemblyState = InputAssemblyState::create();
+    inputAssemblyState->topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+
+    GraphicsPipelineStates pipelineStates{
+        vertexInputState,
+        inputAssemblyState,
+        RasterizationState::create(),
+        MultisampleState::create(),
+        ColorBlendState::create(),
+        DepthStencilState::create()};
+
+    auto graphicsPipeline = GraphicsPipeline::create(pipelineLayout, stages, pipelineStates);
+
+    auto descriptorSet = DescriptorSet::create(descriptorSetLayout, Descriptors{DescriptorBuffer::create(pointSizeSettings, 0, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)});
+
+    auto stateGroup = StateGroup::create();
+    stateGroup->add(BindGraphicsPipeline::create(graphicsPipeline));
+    stateGroup->add(BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, descriptorSet));
+    return stateGroup;
+}
+
+ref_ptr<StateGroup> BuildPointCloud::build(ref_ptr<const vec3Array> positions, ref_ptr<const ubvec4Array> colors)
+{
+    if (!positions || positions->size() == 0) return {};
+
+    if (colors && colors->size() != positions->size())
+    {
+        warn("BuildPointCloud::build(..) colors array size doesn't match positions, ignoring colors.");
+        colors = {};
+    }
+
+    _positions = positions;
+    _colors = colors;
+
+    // cubic root bounds so that the octants are cubes
+    dbox bounds;
+    for (auto& position : *positions) bounds.add(position);
+
+    dvec3 center = (bounds.min + bounds.max) * 0.5;
+    dvec3 extent = bounds.max - bounds.min;
+    double halfSize = std::max({extent.x, extent.y, extent.z, 1e-6}) * 0.5;
+    dbox root(center - dvec3(halfSize, halfSize, halfSize), center + dvec3(halfSize, halfSize, halfSize));
+
+    if (outputDirectory) makeDirectory(outputDirectory);
+
+    auto pointCloud = PointCloud::create();
+
+    std::vector<uint32_t> indices(positions->size());
+    for (uint32_t i = 0; i < indices.size(); ++i) indices[i] = i;
+    _addOctant(*pointCloud, root, indices, 0);
+
+    pointCloud->assignTiles(outputDirectory);
+
+    auto stateGroup = createStateGroup(colors.valid());
+    stateGroup->addChild(pointCloud);
+
+    if (outputDirectory)
+    {
+        Path filename = outputDirectory / (name + extension);
+        if (!vsg::write(stateGroup, filename, options)) warn("BuildPointCloud unable to write ", filename);
+    }
+
+    _positions = {};
+    _colors = {};
+
+    return stateGroup;
+}
+
+uint32_t BuildPointCloud::_addOctant(PointCloud& pointCloud, const dbox& bounds, std::vector<uint32_t>& indices, uint32_t level)
+{
+    uint32_t octantIndex = static_cast<uint32_t>(pointCloud.octants.size());
+    pointCloud.octants.emplace_back();
+
+    dvec3 center = (bounds.min + bounds.max) * 0.5;
+    double cellSize = (bounds.max.x - bounds.min.x) / static_cast<double>(gridResolution);
+
+    // keep one point per grid cell for this octant, passing the rest on to the children
+    std::vector<uint32_t> selected;
+    std::vector<uint32_t> remaining;
+    if (indices.size() <= maximumPointsPerOctant || (level + 1) >= maximumLevels)
+    {
+        selected.swap(indices);
+    }
+    else
+    {
+        std::unordered_set<uint64_t> occupied;
+        auto cell = [&](double v, double minimum) {
+            return static_cast<uint64_t>(std::clamp((v - minimum) / cellSize, 0.0, static_cast<double>(gridResolution - 1)));
+        };
+        for (auto index : indices)
+        {
+            auto& p = _positions->at(index);
+            uint64_t key = (cell(p.x, bounds.min.x) << 42) | (cell(p.y, bounds.min.y) << 21) | cell(p.z, bounds.min.z);
+            if (selected.size() < maximumPointsPerOctant && occupied.insert(key).second)
+                selected.push_back(index);
+            else
+                remaining.push_back(index);
+        }
+        indices.clear();
+        indices.shrink_to_fit();
+    }
+
+    // leaf octants hold all their points so estimate their spacing from the point density
+    double spacing = remaining.empty() ? (bounds.max.x - bounds.min.x) / std::max(1.0, std::cbrt(static_cast<double>(selected.size()))) : cellSize;
+
+    {
+        auto& octant = pointCloud.octants[octantIndex];
+        octant.bound.center = center;
+        octant.bound.radius = length(bounds.max - bounds.min) * 0.5;
+        octant.numPoints = static_cast<uint32_t>(selected.size());
+        octant.spacing = spacing;
+
+        auto tile = _createTile(selected, center, spacing);
+        if (outputDirectory)
+        {
+            octant.filename = make_string(name, "_", octantIndex, extension);
+            Path filename = outputDirectory / octant.filename;
+            if (!vsg::write(tile, filename, options)) warn("BuildPointCloud unable to write ", filename);
+        }
+        else
+        {
+            octant.tile = PagedLOD::create();
+            octant.tile->children[0].node = tile;
+        }
+    }
+
+    if (remaining.empty()) return octantIndex;
+
+    std::array<std::vector<uint32_t>, 8> childIndices;
+    for (auto index : remaining)
+    {
+        auto& p = _positions->at(index);
+        uint32_t c = (p.x >= center.x ? 1 : 0) | (p.y >= center.y ? 2 : 0) | (p.z >= center.z ? 4 : 0);
+        childIndices[c].push_back(index);
+    }
+    remaining.clear();
+    remaining.shrink_to_fit();
+
+    for (uint32_t c = 0; c < 8; ++c)
+    {
+        if (childIndices[c].empty()) continue;
+
+        dbox childBounds;
+        childBounds.min = dvec3((c & 1) ? center.x : bounds.min.x, (c & 2) ? center.y : bounds.min.y, (c & 4) ? center.z : bounds.min.z);
+        childBounds.max = dvec3((c & 1) ? bounds.max.x : center.x, (c & 2) ? bounds.max.y : center.y, (c & 4) ? bounds.max.z : center.z);
+
+        // octants may be reallocated by the recursion so assign the child index afterwards
+        uint32_t childIndex = _addOctant(pointCloud, childBounds, childIndices[c], level + 1);
+        pointCloud.octants[octantIndex].children[c] = childIndex;
+    }
+
+    return octantIndex;
+}
+
+ref_ptr<Node> BuildPointCloud::_createTile(const std::vector<uint32_t>& indices, const dvec3& center, double spacing) const
+{
+    // positions are relative to the octant's center to retain precision for large coordinates
+    auto vertices = vec3Array::create(static_cast<uint32_t>(indices.size()));
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        vertices->set(i, vec3(dvec3(_positions->at(indices[i])) - center));
+    }
+
+    ref_ptr<ubvec4Array> tileColors;
+    if (_colors)
+    {
+        tileColors = ubvec4Array::create(static_cast<uint32_t>(indices.size()));
+        for (size_t i = 0; i < indices.size(); ++i) tileColors->set(i, _colors->at(indices[i]));
+    }
+    else
+    {
+        tileColors = ubvec4Array::create(1, ubvec4(255, 255, 255, 255));
+    }
+
+    auto draw = VertexDraw::create();
+    draw->assignArrays(DataList{vertices, tileColors, floatArray::create(1, static_cast<float>(spacing))});
+    draw->vertexCount = static_cast<uint32_t>(indices.size());
+    draw->instanceCount = 1;
+
+    auto transform = MatrixTransform::create(translate(center));
+    transform->addChild(draw);
+    return transform;
+}
@@ -19,6 +19,8 @@
 #include <vsg/utils/Builder.h>
 #include <vsg/utils/GraphicsPipelineConfigurator.h>
 
+#include <optional>
+
 using namespace vsg;
 
 void Builder::assignCompileTraversal(ref_ptr<CompileTraversal> ct)
@@ -223,10 +225,13 @@ ref_ptr<Node> Builder::decorateAndCompileIfRequired(const GeometryInfo& info, co
     ref_ptr<Node> subgraph = node;
 
     // create StateGroup as the root of the scene/command graph to hold the GraphicsPipeline, and binding of Descriptors to decorate the whole graph
-    if (auto stateGroup = createStateGroup(stateInfo))
+    if (!_batchingShapes)
     {
-        stateGroup->addChild(node);
-        subgraph = stateGroup;
+        if (auto stateGroup = createStateGroup(stateInfo))
+        {
+            stateGroup->addChild(node);
+            subgraph = stateGroup;
+        }
     }
 
     if (info.cullNode)
@@ -261,11 +266,41 @@ ref_ptr<Node> Builder::decorateAndCompileIfRequired(const GeometryInfo& info, co
         subgraph = cullNode;
     }
 
-    if (compileTraversal) compileTraversal->compile(subgraph);
+    if (compileTraversal && !_batchingShapes) compileTraversal->compile(subgraph);
 
     return subgraph;
 }
 
+ref_ptr<Node> Builder::createShapes(CreateShapeFunction createShape, const std::vector<GeometryInfo>& infos, const StateInfo& stateInfo)
+{
+    if (!createShape || infos.empty()) return {};
+
+    std::optional<AllocatorArena::Scope> arenaScope;
+    if (allocatorArena) arenaScope.emplace(allocatorArena.get());
+
+    auto stateGroup = createStateGroup(stateInfo);
+    ref_ptr<Group> group = stateGroup;
+    if (!group) group = Group::create();
+
+    group->children.reserve(infos.size());
+
+    // GeometryInfo that match share the same shape, and with it the arrays
+    std::map<GeometryInfo, ref_ptr<Node>> shapes;
+
+    _batchingShapes = true;
+    for (auto& info : infos)
+    {
+        auto& shape = shapes[info];
+        if (!shape) shape = (this->*createShape)(info, stateInfo);
+        if (shape) group->children.push_back(shape);
+    }
+    _batchingShapes = false;
+
+    if (compileTraversal) compileTraversal->compile(group);
+
+    return group;
+}
+
 ref_ptr<Node> Builder::createBox(const GeometryInfo& info, const StateInfo& stateInfo)
 {
     auto& subgraph = _boxes[info];
@@ -0,0 +1,45 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/nodes/MatrixTransform.h>
+#include <vsg/utils/CacheTransformBounds.h>
+#include <vsg/utils/ComputeBounds.h>
+
+using namespace vsg;
+
+CacheTransformBounds::CacheTransformBounds()
+{
+}
+
+void CacheTransformBounds::apply(Node& node)
+{
+    node.traverse(*this);
+}
+
+void CacheTransformBounds::apply(MatrixTransform& transform)
+{
+    if (!_visited.insert(&transform).second) return;
+
+    // assign the nested transforms' bounds first so computing this transform's bound can reuse them
+    transform.traverse(*this);
+
+    transform.bound = {};
+
+    ComputeBounds computeBounds;
+    transform.accept(computeBounds);
+    if (computeBounds.bounds.valid())
+    {
+        auto& bounds = computeBounds.bounds;
+        transform.bound.set((bounds.min + bounds.max) * 0.5, length(bounds.max - bounds.min) * 0.5);
+        ++numBoundsAssigned;
+    }
+}
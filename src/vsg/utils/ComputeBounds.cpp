@@ -17,6 +17,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/commands/DrawIndexed.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
+#include <vsg/maths/transform.h>
 #include <vsg/nodes/CullGroup.h>
 #include <vsg/nodes/CullNode.h>
 #include <vsg/nodes/Geometry.h>
@@ -28,35 +29,222 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/nodes/VertexIndexDraw.h>
 #include <vsg/text/Text.h>
 #include <vsg/text/TextGroup.h>
+#include <vsg/threading/Latch.h>
 #include <vsg/utils/ComputeBounds.h>
 
 using namespace vsg;
 
+namespace
+{
+    dbox computeVertexBounds(const dmat4& matrix, const vec3Array& vertices, const ushortArray* ushort_indices, const uintArray* uint_indices, uint32_t first, uint32_t end)
+    {
+        dbox bounds;
+        if (ushort_indices)
+        {
+            for (uint32_t i = first; i < end; ++i)
+            {
+                bounds.add(matrix * dvec3(vertices.at(ushort_indices->at(i))));
+            }
+        }
+        else if (uint_indices)
+        {
+            for (uint32_t i = first; i < end; ++i)
+            {
+                bounds.add(matrix * dvec3(vertices.at(uint_indices->at(i))));
+            }
+        }
+        else if (vertices.properties.stride == sizeof(vec3))
+        {
+            // transform contiguous vertices in batches so the SIMD transform can be used
+            const uint32_t batchSize = 256;
+            dvec3 transformed[batchSize];
+            for (uint32_t i = first; i < end; i += batchSize)
+            {
+                uint32_t count = std::min(batchSize, end - i);
+                transform(matrix, vertices.data() + i, transformed, count);
+                for (uint32_t j = 0; j < count; ++j) bounds.add(transformed[j]);
+            }
+        }
+        else
+        {
+            for (uint32_t i = first; i < end; ++i)
+            {
+                bounds.add(matrix * dvec3(vertices.at(i)));
+            }
+        }
+        return bounds;
+    }
+
+    BoundsCache::DataSource dataSource(const Data* data)
+    {
+        BoundsCache::DataSource source{observer_ptr<Data>(const_cast<Data*>(data)), {}};
+        data->getModifiedCount(source.modifiedCount);
+        return source;
+    }
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////
+//
+// BoundsCache
+//
+BoundsCache::BoundsCache()
+{
+}
+
+BoundsCache::~BoundsCache()
+{
+}
+
+bool BoundsCache::getBounds(const Node& node, dbox& bounds, DataSources& sources)
+{
+    std::scoped_lock lock(_mutex);
+
+    auto itr = _entries.find(&node);
+    if (itr == _entries.end()) return false;
+
+    // the node may have been deleted and a new one allocated at the same address, or the arrays may have been modified since the bounds were computed
+    auto& entry = itr->second;
+    bool valid = entry.node.valid();
+    for (auto source_itr = entry.sources.begin(); valid && source_itr != entry.sources.end(); ++source_itr)
+    {
+        auto data = source_itr->data.ref_ptr();
+        auto modifiedCount = source_itr->modifiedCount;
+        valid = data && !data->getModifiedCount(modifiedCount);
+    }
+
+    if (!valid)
+    {
+        _entries.erase(itr);
+        return false;
+    }
+
+    bounds = entry.bounds;
+    sources.insert(sources.end(), entry.sources.begin(), entry.sources.end());
+    return true;
+}
+
+void BoundsCache::setBounds(const Node& node, const dbox& bounds, const DataSources& sources)
+{
+    std::scoped_lock lock(_mutex);
+
+    auto& entry = _entries[&node];
+    entry.node = const_cast<Node*>(&node);
+    entry.bounds = bounds;
+    entry.sources = sources;
+}
+
+void BoundsCache::dirty(const Node* node)
+{
+    std::scoped_lock lock(_mutex);
+    _entries.erase(node);
+}
+
+void BoundsCache::dirty(const std::vector<const Node*>& nodePath)
+{
+    std::scoped_lock lock(_mutex);
+    for (auto node : nodePath) _entries.erase(node);
+}
+
+void BoundsCache::clear()
+{
+    std::scoped_lock lock(_mutex);
+    _entries.clear();
+}
+
+size_t BoundsCache::prune()
+{
+    std::scoped_lock lock(_mutex);
+
+    size_t previous_size = _entries.size();
+    for (auto itr = _entries.begin(); itr != _entries.end();)
+    {
+        if (itr->second.node.valid())
+            ++itr;
+        else
+            itr = _entries.erase(itr);
+    }
+    return previous_size - _entries.size();
+}
+
+size_t BoundsCache::size() const
+{
+    std::scoped_lock lock(_mutex);
+    return _entries.size();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+//
+// ComputeBounds
+//
 ComputeBounds::ComputeBounds(ref_ptr<ArrayState> intialArrayState)
 {
     arrayStateStack.reserve(4);
     arrayStateStack.emplace_back(intialArrayState ? intialArrayState : ArrayState::create());
 }
 
+template<class F>
+void ComputeBounds::_cached(const Node& node, F traverse)
+{
+    // ArrayState subclasses compute vertices that may depend on state inherited from above the node so their bounds can't be cached
+    if (!boundsCache || typeid(*arrayStateStack.back()) != typeid(ArrayState))
+    {
+        traverse();
+        return;
+    }
+
+    ++_cacheDepth;
+
+    dbox localBounds;
+    if (!boundsCache->getBounds(node, localBounds, _dataSources))
+    {
+        // compute the bounds of the subgraph in the node's local coordinate frame, recording the arrays they are computed from
+        dbox parentBounds;
+        MatrixStack parentMatrixStack;
+        std::swap(bounds, parentBounds);
+        std::swap(matrixStack, parentMatrixStack);
+        size_t firstSource = _dataSources.size();
+
+        traverse();
+
+        localBounds = bounds;
+        boundsCache->setBounds(node, localBounds, BoundsCache::DataSources(_dataSources.begin() + firstSource, _dataSources.end()));
+
+        std::swap(bounds, parentBounds);
+        std::swap(matrixStack, parentMatrixStack);
+    }
+
+    // the data sources are only required by enclosing cached nodes
+    if (--_cacheDepth == 0) _dataSources.clear();
+
+    if (localBounds.valid()) add(localBounds);
+}
+
 void ComputeBounds::apply(const vsg::Object& object)
 {
     object.traverse(*this);
 }
 
+void ComputeBounds::apply(const Group& group)
+{
+    _cached(group, [&]() { group.traverse(*this); });
+}
+
 void ComputeBounds::apply(const StateGroup& stategroup)
 {
-    auto arrayState = stategroup.prototypeArrayState ? stategroup.prototypeArrayState->clone(arrayStateStack.back()) : arrayStateStack.back()->clone();
+    _cached(stategroup, [&]() {
+        auto arrayState = stategroup.prototypeArrayState ? stategroup.prototypeArrayState->clone(arrayStateStack.back()) : arrayStateStack.back()->clone();
 
-    for (auto& statecommand : stategroup.stateCommands)
-    {
-        statecommand->accept(*arrayState);
-    }
+        for (auto& statecommand : stategroup.stateCommands)
+        {
+            statecommand->accept(*arrayState);
+        }
 
-    arrayStateStack.emplace_back(arrayState);
+        arrayStateStack.emplace_back(arrayState);
 
-    stategroup.traverse(*this);
+        stategroup.traverse(*this);
 
-    arrayStateStack.pop_back();
+        arrayStateStack.pop_back();
+    });
 }
 
 void ComputeBounds::apply(const Transform& transform)
@@ -66,19 +254,26 @@ void ComputeBounds::apply(const Transform& transform)
     else
         matrixStack.push_back(transform.transform(matrixStack.back()));
 
-    transform.traverse(*this);
+    _cached(transform, [&]() { transform.traverse(*this); });
 
     matrixStack.pop_back();
 }
 
 void ComputeBounds::apply(const MatrixTransform& transform)
 {
+    if (useNodeBounds && transform.bound.valid())
+    {
+        // the bound is in the parent's coordinate frame
+        add(transform.bound);
+        return;
+    }
+
     if (matrixStack.empty())
         matrixStack.push_back(transform.matrix);
     else
         matrixStack.push_back(matrixStack.back() * transform.matrix);
 
-    transform.traverse(*this);
+    _cached(transform, [&]() { transform.traverse(*this); });
 
     matrixStack.pop_back();
 }
@@ -117,33 +312,39 @@ void ComputeBounds::apply(const PagedLOD& plod)
 
 void ComputeBounds::apply(const vsg::Geometry& geometry)
 {
-    auto& arrayState = *arrayStateStack.back();
-    arrayState.apply(geometry);
+    _cached(geometry, [&]() {
+        auto& arrayState = *arrayStateStack.back();
+        arrayState.apply(geometry);
 
-    if (geometry.indices) geometry.indices->accept(*this);
+        if (geometry.indices) geometry.indices->accept(*this);
 
-    for (auto& command : geometry.commands)
-    {
-        command->accept(*this);
-    }
+        for (auto& command : geometry.commands)
+        {
+            command->accept(*this);
+        }
+    });
 }
 
 void ComputeBounds::apply(const vsg::VertexDraw& vid)
 {
-    auto& arrayState = *arrayStateStack.back();
-    arrayState.apply(vid);
+    _cached(vid, [&]() {
+        auto& arrayState = *arrayStateStack.back();
+        arrayState.apply(vid);
 
-    applyDraw(vid.firstVertex, vid.vertexCount, vid.firstInstance, vid.instanceCount);
+        applyDraw(vid.firstVertex, vid.vertexCount, vid.firstInstance, vid.instanceCount);
+    });
 }
 
 void ComputeBounds::apply(const vsg::VertexIndexDraw& vid)
 {
-    auto& arrayState = *arrayStateStack.back();
-    arrayState.apply(vid);
+    _cached(vid, [&]() {
+        auto& arrayState = *arrayStateStack.back();
+        arrayState.apply(vid);
 
-    if (vid.indices) vid.indices->accept(*this);
+        if (vid.indices) vid.indices->accept(*this);
 
-    applyDrawIndexed(vid.firstIndex, vid.indexCount, vid.firstInstance, vid.instanceCount);
+        applyDrawIndexed(vid.firstIndex, vid.indexCount, vid.firstInstance, vid.instanceCount);
+    });
 }
 
 void ComputeBounds::apply(const vsg::BindVertexBuffers& bvb)
@@ -163,6 +364,7 @@ void ComputeBounds::apply(const vsg::StateCommand& statecommand)
 
 void ComputeBounds::apply(const BufferInfo& bufferInfo)
 {
+    if (bufferInfo.dataReleased() && arrayStateStack.back()->reloadReleasedData) const_cast<BufferInfo&>(bufferInfo).reloadData();
     if (bufferInfo.data) bufferInfo.data->accept(*this);
 }
 
@@ -193,55 +395,105 @@ void ComputeBounds::applyDraw(uint32_t firstVertex, uint32_t vertexCount, uint32
     auto& arrayState = *arrayStateStack.back();
     uint32_t lastIndex = instanceCount > 1 ? (firstInstance + instanceCount) : firstInstance + 1;
     uint32_t endVertex = firstVertex + vertexCount;
-    dmat4 matrix;
-    if (!matrixStack.empty()) matrix = matrixStack.back();
 
     for (uint32_t instanceIndex = firstInstance; instanceIndex < lastIndex; ++instanceIndex)
     {
         if (auto vertices = arrayState.vertexArray(instanceIndex))
         {
-            for (uint32_t i = firstVertex; i < endVertex; ++i)
-            {
-                bounds.add(matrix * dvec3(vertices->at(i)));
-            }
+            _addVertices(*vertices, nullptr, firstVertex, endVertex);
         }
     }
+
+    if (_cacheDepth > 0 && arrayState.vertices)
+    {
+        _dataSources.push_back(dataSource(arrayState.vertices));
+    }
 }
 
 void ComputeBounds::applyDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount)
 {
+    const Data* indices = ushort_indices ? static_cast<const Data*>(ushort_indices.get()) : static_cast<const Data*>(uint_indices.get());
+    if (!indices) return;
+
     auto& arrayState = *arrayStateStack.back();
     uint32_t lastIndex = instanceCount > 1 ? (firstInstance + instanceCount) : firstInstance + 1;
     uint32_t endIndex = firstIndex + indexCount;
-    dmat4 matrix;
-    if (!matrixStack.empty()) matrix = matrixStack.back();
 
-    if (ushort_indices)
+    for (uint32_t instanceIndex = firstInstance; instanceIndex < lastIndex; ++instanceIndex)
     {
-        for (uint32_t instanceIndex = firstInstance; instanceIndex < lastIndex; ++instanceIndex)
+        if (auto vertices = arrayState.vertexArray(instanceIndex))
         {
-            if (auto vertices = arrayState.vertexArray(instanceIndex))
-            {
-                for (uint32_t i = firstIndex; i < endIndex; ++i)
-                {
-                    bounds.add(matrix * dvec3(vertices->at(ushort_indices->at(i))));
-                }
-            }
+            _addVertices(*vertices, indices, firstIndex, endIndex);
         }
     }
-    else if (uint_indices)
+
+    if (_cacheDepth > 0)
     {
-        for (uint32_t instanceIndex = firstInstance; instanceIndex < lastIndex; ++instanceIndex)
+        _dataSources.push_back(dataSource(indices));
+        if (arrayState.vertices) _dataSources.push_back(dataSource(arrayState.vertices));
+    }
+}
+
+void ComputeBounds::_addVertices(const vec3Array& vertices, const Data* indices, uint32_t first, uint32_t end)
+{
+    dmat4 matrix;
+    if (!matrixStack.empty()) matrix = matrixStack.back();
+
+    auto ushortIndices = indices ? indices->cast<ushortArray>() : nullptr;
+    auto uintIndices = indices ? indices->cast<uintArray>() : nullptr;
+
+    const uint32_t blockSize = 16384;
+    uint32_t count = end > first ? end - first : 0;
+    if (!operationThreads || count < minimumVerticesForThreading || count < blockSize * 2)
+    {
+        bounds.add(computeVertexBounds(matrix, vertices, ushortIndices, uintIndices, first, end));
+        return;
+    }
+
+    // compute the bounds of blocks of vertices in parallel then combine them
+    struct ComputeBlockBounds : public Operation
+    {
+        ComputeBlockBounds(const dmat4& in_matrix, const vec3Array& in_vertices, const ushortArray* in_ushortIndices, const uintArray* in_uintIndices, uint32_t in_first, uint32_t in_end, dbox& in_bounds, ref_ptr<Latch> in_latch) :
+            matrix(in_matrix),
+            vertices(in_vertices),
+            ushortIndices(in_ushortIndices),
+            uintIndices(in_uintIndices),
+            first(in_first),
+            end(in_end),
+            blockBounds(in_bounds),
+            latch(in_latch) {}
+
+        void run() override
         {
-            if (auto vertices = arrayState.vertexArray(instanceIndex))
-            {
-                for (uint32_t i = firstIndex; i < endIndex; ++i)
-                {
-                    bounds.add(matrix * dvec3(vertices->at(uint_indices->at(i))));
-                }
-            }
+            blockBounds = computeVertexBounds(matrix, vertices, ushortIndices, uintIndices, first, end);
+            latch->count_down();
         }
+
+        const dmat4& matrix;
+        const vec3Array& vertices;
+        const ushortArray* ushortIndices;
+        const uintArray* uintIndices;
+        uint32_t first;
+        uint32_t end;
+        dbox& blockBounds;
+        ref_ptr<Latch> latch;
+    };
+
+    uint32_t numBlocks = (count + blockSize - 1) / blockSize;
+    std::vector<dbox> blockBounds(numBlocks);
+    auto latch = Latch::create(static_cast<int>(numBlocks));
+    for (uint32_t i = 0; i < numBlocks; ++i)
+    {
+        uint32_t blockFirst = first + i * blockSize;
+        uint32_t blockEnd = std::min(blockFirst + blockSize, end);
+        operationThreads->add(ref_ptr<Operation>(new ComputeBlockBounds(matrix, vertices, ushortIndices, uintIndices, blockFirst, blockEnd, blockBounds[i], latch)));
     }
+
+    // help out with the blocks then wait for the remaining ones to complete
+    operationThreads->run();
+    latch->wait();
+
+    for (auto& bb : blockBounds) bounds.add(bb);
 }
 
 void ComputeBounds::apply(const Text& text)
@@ -0,0 +1,253 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/ConstVisitor.h>
+#include <vsg/io/Logger.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/utils/ComputeSkinning.h>
+#include <vsg/vk/Context.h>
+
+using namespace vsg;
+
+namespace
+{
+    const char* computeSkinning_comp = R"(
+#version 450
+
+layout(local_size_x = 64) in;
+
+layout(push_constant) uniform PushConstants
+{
+    uint numVertices;
+    uint numMorphTargets;
+    uint skinned;
+} pc;
+
+layout(std430, set = 0, binding = 0) readonly buffer Vertices { float vertices[]; };
+layout(std430, set = 0, binding = 1) readonly buffer Normals { float normals[]; };
+layout(std430, set = 0, binding = 2) readonly buffer JointIndices { uvec4 jointIndices[]; };
+layout(std430, set = 0, binding = 3) readonly buffer JointWeights { vec4 jointWeights[]; };
+layout(std430, set = 0, binding = 4) readonly buffer JointMatrices { mat4 jointMatrices[]; };
+layout(std430, set = 0, binding = 5) readonly buffer MorphDeltas { vec4 morphDeltas[]; };
+layout(std430, set = 0, binding = 6) readonly buffer MorphWeights { float morphWeights[]; };
+layout(std430, set = 0, binding = 7) writeonly buffer SkinnedVertices { float skinnedVertices[]; };
+layout(std430, set = 0, binding = 8) writeonly buffer SkinnedNormals { float skinnedNormals[]; };
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.numVertices) return;
+
+    vec3 vertex = vec3(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+    vec3 normal = vec3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]);
+
+    // morph targets, with the vertex and normal deltas of each target interleaved
+    for (uint t = 0; t < pc.numMorphTargets; ++t)
+    {
+        float weight = morphWeights[t];
+        if (weight == 0.0) continue;
+
+        uint index = (t * pc.numVertices + i) * 2;
+        vertex += weight * morphDeltas[index].xyz;
+        normal += weight * morphDeltas[index + 1].xyz;
+    }
+
+    // linear blend skinning
+    if (pc.skinned != 0)
+    {
+        uvec4 joints = jointIndices[i];
+        vec4 weights = jointWeights[i];
+        mat4 skinMatrix = weights.x * jointMatrices[joints.x] +
+                          weights.y * jointMatrices[joints.y] +
+                          weights.z * jointMatrices[joints.z] +
+                          weights.w * jointMatrices[joints.w];
+
+        vertex = (skinMatrix * vec4(vertex, 1.0)).xyz;
+        normal = mat3(skinMatrix) * normal;
+    }
+
+    normal = normalize(normal);
+
+    skinnedVertices[i * 3] = vertex.x;
+    skinnedVertices[i * 3 + 1] = vertex.y;
+    skinnedVertices[i * 3 + 2] = vertex.z;
+
+    skinnedNormals[i * 3] = normal.x;
+    skinnedNormals[i * 3 + 1] = normal.y;
+    skinnedNormals[i * 3 + 2] = normal.z;
+}
+)";
+
+    struct SkinningPushConstants
+    {
+        uint32_t numVertices;
+        uint32_t numMorphTargets;
+        uint32_t skinned;
+    };
+} // namespace
+
+ComputeSkinning::ComputeSkinning(ref_ptr<vec3Array> in_vertices, ref_ptr<vec3Array> in_normals,
+                                 ref_ptr<uivec4Array> in_jointIndices, ref_ptr<vec4Array> in_jointWeights, ref_ptr<BufferInfo> in_jointMatrices,
+                                 const MorphTargets& in_morphTargets, ref_ptr<floatArray> in_morphWeights) :
+    vertices(in_vertices),
+    normals(in_normals),
+    jointIndices(in_jointIndices),
+    jointWeights(in_jointWeights),
+    jointMatrices(in_jointMatrices),
+    morphTargets(in_morphTargets),
+    morphWeights(in_morphWeights),
+    skinnedVertices(BufferInfo::create()),
+    skinnedNormals(BufferInfo::create())
+{
+    _setUp();
+}
+
+void ComputeSkinning::_setUp()
+{
+    uint32_t numVertices = static_cast<uint32_t>(vertices->size());
+
+    // pack the morph target deltas into a single array, unused inputs are bound to placeholder arrays
+    ref_ptr<vec4Array> morphDeltas;
+    if (!morphTargets.empty() && morphWeights && morphWeights->size() >= morphTargets.size())
+    {
+        morphDeltas = vec4Array::create(static_cast<uint32_t>(morphTargets.size()) * numVertices * 2, vec4(0.0f, 0.0f, 0.0f, 0.0f));
+        size_t index = 0;
+        for (auto& morphTarget : morphTargets)
+        {
+            for (uint32_t i = 0; i < numVertices; ++i, index += 2)
+            {
+                if (morphTarget.vertexDeltas && i < morphTarget.vertexDeltas->size()) morphDeltas->set(index, vec4(morphTarget.vertexDeltas->at(i), 0.0f));
+                if (morphTarget.normalDeltas && i < morphTarget.normalDeltas->size()) morphDeltas->set(index + 1, vec4(morphTarget.normalDeltas->at(i), 0.0f));
+            }
+        }
+    }
+    else
+    {
+        morphTargets.clear();
+        morphDeltas = vec4Array::create(1);
+        if (!morphWeights) morphWeights = floatArray::create(1, 0.0f);
+    }
+
+    _skinned = jointIndices && jointWeights && jointMatrices && jointIndices->size() >= numVertices && jointWeights->size() >= numVertices;
+    if (!_skinned)
+    {
+        jointIndices = uivec4Array::create(1);
+        jointWeights = vec4Array::create(1);
+        jointMatrices = BufferInfo::create(mat4Array::create(1));
+    }
+
+    auto morphWeightsBufferInfo = BufferInfo::create(morphWeights);
+    _staticBufferInfos = {BufferInfo::create(vertices), BufferInfo::create(normals), BufferInfo::create(jointIndices), BufferInfo::create(jointWeights), BufferInfo::create(morphDeltas)};
+    _dynamicBufferInfos = {jointMatrices, morphWeightsBufferInfo};
+
+    DescriptorSetLayoutBindings bindings;
+    for (uint32_t binding = 0; binding <= 8; ++binding)
+    {
+        bindings.push_back(VkDescriptorSetLayoutBinding{binding, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr});
+    }
+    auto descriptorSetLayout = DescriptorSetLayout::create(bindings);
+
+    PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SkinningPushConstants)}};
+    _pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{descriptorSetLayout}, pushConstantRanges);
+
+    auto computeShader = ShaderStage::create(VK_SHADER_STAGE_COMPUTE_BIT, "main", computeSkinning_comp);
+    _bindPipeline = BindComputePipeline::create(ComputePipeline::create(_pipelineLayout, computeShader));
+
+    Descriptors descriptors{
+        DescriptorBuffer::create(BufferInfoList{_staticBufferInfos[0]}, 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{_staticBufferInfos[1]}, 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{_staticBufferInfos[2]}, 2, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{_staticBufferInfos[3]}, 3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{jointMatrices}, 4, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{_staticBufferInfos[4]}, 5, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{morphWeightsBufferInfo}, 6, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{skinnedVertices}, 7, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{skinnedNormals}, 8, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)};
+    _bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, DescriptorSet::create(descriptorSetLayout, descriptors));
+
+    // previous frame's draws must have finished reading the skinned outputs before they're overwritten
+    _preSkinningBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                                  MemoryBarrier::create(0, VK_ACCESS_SHADER_WRITE_BIT));
+
+    // the compute shader's writes must be visible to the vertex attribute fetches of the draws
+    _postSkinningBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0,
+                                                   MemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT));
+}
+
+void ComputeSkinning::assignOutputs(VertexIndexDraw& draw, uint32_t vertexArrayIndex, uint32_t normalArrayIndex) const
+{
+    uint32_t numArrays = std::max(vertexArrayIndex, normalArrayIndex) + 1;
+    if (draw.arrays.size() < numArrays) draw.arrays.resize(numArrays);
+
+    draw.arrays[vertexArrayIndex] = skinnedVertices;
+    draw.arrays[normalArrayIndex] = skinnedNormals;
+}
+
+void ComputeSkinning::traverse(ConstVisitor& visitor) const
+{
+    // allows CollectResourceRequirements to find the descriptors and the dynamic joint matrices and morph weights
+    _bindPipeline->accept(visitor);
+    _bindDescriptorSet->accept(visitor);
+}
+
+void ComputeSkinning::compile(Context& context)
+{
+    createBufferAndTransferData(context, _staticBufferInfos, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+    for (auto& bufferInfo : _dynamicBufferInfos)
+    {
+        // compiled separately so the jointMatrices shared by the ComputeSkinning of a skeleton aren't moved each time one of them is compiled
+        createBufferAndTransferData(context, {bufferInfo}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+    }
+
+    // the outputs have no Data so are allocated directly, with both the storage usage the compute shader writes them with and the vertex usage they're drawn with
+    VkDeviceSize outputSize = vertices->size() * sizeof(vec3);
+    VkDeviceSize alignment = std::max(VkDeviceSize(4), context.device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment);
+    for (auto& output : {skinnedVertices, skinnedNormals})
+    {
+        if (output->buffer) continue;
+
+        auto deviceBufferInfo = context.deviceMemoryBufferPools->reserveBuffer(outputSize, alignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (!deviceBufferInfo)
+        {
+            warn("ComputeSkinning::compile(..) unable to allocate skinned output buffer.");
+            return;
+        }
+
+        output->buffer = deviceBufferInfo->buffer;
+        output->offset = deviceBufferInfo->offset;
+        output->range = deviceBufferInfo->range;
+        output->parent = deviceBufferInfo;
+    }
+
+    _bindPipeline->compile(context);
+    _bindDescriptorSet->compile(context);
+}
+
+void ComputeSkinning::record(CommandBuffer& commandBuffer) const
+{
+    if (!skinnedVertices->buffer || !skinnedNormals->buffer) return;
+
+    SkinningPushConstants pushConstants;
+    pushConstants.numVertices = static_cast<uint32_t>(vertices->size());
+    pushConstants.numMorphTargets = static_cast<uint32_t>(morphTargets.size());
+    pushConstants.skinned = _skinned ? 1 : 0;
+
+    _preSkinningBarrier->record(commandBuffer);
+
+    _bindPipeline->record(commandBuffer);
+    _bindDescriptorSet->record(commandBuffer);
+    vkCmdPushConstants(commandBuffer, _pipelineLayout->vk(commandBuffer.deviceID), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SkinningPushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, (pushConstants.numVertices + workgroupSize - 1) / workgroupSize, 1, 1);
+
+    _postSkinningBarrier->record(commandBuffer);
+}
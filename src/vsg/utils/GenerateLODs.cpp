@@ -0,0 +1,508 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/DrawIndexed.h>
+#include <vsg/io/Logger.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/nodes/LOD.h>
+#include <vsg/nodes/PagedLOD.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/state/VertexInputState.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/utils/GenerateLODs.h>
+
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+
+using namespace vsg;
+
+namespace
+{
+    /// symmetric 4x4 matrix representing the sum of squared distances to a set of planes
+    struct Quadric
+    {
+        double a[10] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+        Quadric() = default;
+
+        Quadric(const dvec3& n, double d) :
+            a{n.x * n.x, n.x * n.y, n.x * n.z, n.x * d, n.y * n.y, n.y * n.z, n.y * d, n.z * n.z, n.z * d, d * d}
+        {
+        }
+
+        Quadric& operator+=(const Quadric& rhs)
+        {
+            for (int i = 0; i < 10; ++i) a[i] += rhs.a[i];
+            return *this;
+        }
+
+        double evaluate(const dvec3& v) const
+        {
+            return a[0] * v.x * v.x + 2.0 * a[1] * v.x * v.y + 2.0 * a[2] * v.x * v.z + 2.0 * a[3] * v.x +
+                   a[4] * v.y * v.y + 2.0 * a[5] * v.y * v.z + 2.0 * a[6] * v.y +
+                   a[7] * v.z * v.z + 2.0 * a[8] * v.z +
+                   a[9];
+        }
+    };
+
+    struct Collapse
+    {
+        double cost;
+        uint32_t from;
+        uint32_t to;
+        uint32_t fromStamp;
+        uint32_t toStamp;
+
+        bool operator>(const Collapse& rhs) const { return cost > rhs.cost; }
+    };
+
+    bool readIndices(const Data* data, std::vector<uint32_t>& indices)
+    {
+        if (!data || !data->dataAvailable() || data->stride() != data->valueSize()) return false;
+
+        auto copy = [&](auto array) {
+            indices.assign(array->begin(), array->end());
+            return true;
+        };
+
+        if (auto us = data->cast<ushortArray>()) return copy(us);
+        if (auto ui = data->cast<uintArray>()) return copy(ui);
+        if (auto ub = data->cast<ubyteArray>()) return copy(ub);
+        return false;
+    }
+
+    ref_ptr<Data> createIndices(const std::vector<uint32_t>& indices, const Data* original)
+    {
+        if (original->cast<uintArray>())
+        {
+            auto array = uintArray::create(static_cast<uint32_t>(indices.size()));
+            std::copy(indices.begin(), indices.end(), array->begin());
+            return array;
+        }
+
+        auto array = ushortArray::create(static_cast<uint32_t>(indices.size()));
+        std::transform(indices.begin(), indices.end(), array->begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
+        return array;
+    }
+} // namespace
+
+std::vector<uint32_t> vsg::simplifyTriangles(const vec3Array& vertices, const std::vector<uint32_t>& indices, size_t targetTriangleCount, double maximumError)
+{
+    size_t numTriangles = indices.size() / 3;
+    uint32_t numVertices = static_cast<uint32_t>(vertices.size());
+
+    std::vector<dvec3> positions(vertices.begin(), vertices.end());
+    std::vector<std::array<uint32_t, 3>> triangles(numTriangles);
+    std::vector<bool> removed(numTriangles, false);
+    std::vector<Quadric> quadrics(numVertices);
+    std::vector<std::vector<uint32_t>> vertexTriangles(numVertices);
+    std::unordered_map<uint64_t, uint32_t> edges;
+
+    auto edgeKey = [](uint32_t a, uint32_t b) { return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a; };
+
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        auto& triangle = triangles[t];
+        for (size_t k = 0; k < 3; ++k) triangle[k] = indices[t * 3 + k];
+
+        auto& p0 = positions[triangle[0]];
+        auto n = cross(positions[triangle[1]] - p0, positions[triangle[2]] - p0);
+        if (double len = length(n); len > 0.0) n /= len;
+
+        Quadric quadric(n, -dot(n, p0));
+        for (auto v : triangle)
+        {
+            quadrics[v] += quadric;
+            vertexTriangles[v].push_back(static_cast<uint32_t>(t));
+        }
+
+        for (size_t k = 0; k < 3; ++k) ++edges[edgeKey(triangle[k], triangle[(k + 1) % 3])];
+    }
+
+    // vertices on border or non-manifold edges stay in place
+    std::vector<bool> locked(numVertices, false);
+    for (auto& [key, count] : edges)
+    {
+        if (count != 2)
+        {
+            locked[static_cast<uint32_t>(key >> 32)] = true;
+            locked[static_cast<uint32_t>(key & 0xffffffff)] = true;
+        }
+    }
+
+    std::vector<uint32_t> stamps(numVertices, 0);
+    std::vector<bool> collapsed(numVertices, false);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> candidates;
+
+    auto addCandidate = [&](uint32_t from, uint32_t to) {
+        if (locked[from]) return;
+        Quadric quadric = quadrics[from];
+        quadric += quadrics[to];
+        candidates.push(Collapse{std::max(quadric.evaluate(positions[to]), 0.0), from, to, stamps[from], stamps[to]});
+    };
+
+    for (auto& [key, count] : edges)
+    {
+        auto a = static_cast<uint32_t>(key >> 32);
+        auto b = static_cast<uint32_t>(key & 0xffffffff);
+        addCandidate(a, b);
+        addCandidate(b, a);
+    }
+    edges.clear();
+
+    double maximumCost = maximumError * maximumError;
+    size_t numRemaining = numTriangles;
+    std::vector<uint32_t> neighbours;
+
+    while (numRemaining > targetTriangleCount && !candidates.empty())
+    {
+        auto collapse = candidates.top();
+        candidates.pop();
+
+        if (collapse.cost > maximumCost) break;
+
+        uint32_t from = collapse.from;
+        uint32_t to = collapse.to;
+        if (collapsed[from] || collapsed[to] || stamps[from] != collapse.fromStamp || stamps[to] != collapse.toStamp) continue;
+
+        // reject collapses that would flip or degenerate the triangles that move
+        bool valid = true;
+        for (auto t : vertexTriangles[from])
+        {
+            auto& triangle = triangles[t];
+            if (removed[t] || triangle[0] == to || triangle[1] == to || triangle[2] == to) continue;
+
+            dvec3 p[3] = {positions[triangle[0]], positions[triangle[1]], positions[triangle[2]]};
+            auto before = cross(p[1] - p[0], p[2] - p[0]);
+            for (size_t k = 0; k < 3; ++k)
+            {
+                if (triangle[k] == from) p[k] = positions[to];
+            }
+            auto after = cross(p[1] - p[0], p[2] - p[0]);
+
+            if (dot(before, after) <= 0.0 || length(after) <= length(before) * 1e-3)
+            {
+                valid = false;
+                break;
+            }
+        }
+        if (!valid) continue;
+
+        for (auto t : vertexTriangles[from])
+        {
+            if (removed[t]) continue;
+
+            auto& triangle = triangles[t];
+            if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            {
+                removed[t] = true;
+                --numRemaining;
+            }
+            else
+            {
+                for (auto& v : triangle)
+                {
+                    if (v == from) v = to;
+                }
+                vertexTriangles[to].push_back(t);
+            }
+        }
+
+        collapsed[from] = true;
+        vertexTriangles[from].clear();
+        quadrics[to] += quadrics[from];
+        ++stamps[to];
+
+        // prune the removed triangles and update the collapse costs of the edges around the vertex collapsed onto
+        auto& around = vertexTriangles[to];
+        around.erase(std::remove_if(around.begin(), around.end(), [&](uint32_t t) { return removed[t]; }), around.end());
+
+        neighbours.clear();
+        for (auto t : around)
+        {
+            for (auto v : triangles[t])
+            {
+                if (v != to) neighbours.push_back(v);
+            }
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+        for (auto v : neighbours)
+        {
+            addCandidate(to, v);
+            addCandidate(v, to);
+        }
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(numRemaining * 3);
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        if (!removed[t]) result.insert(result.end(), triangles[t].begin(), triangles[t].end());
+    }
+    return result;
+}
+
+GenerateLODs::GenerateLODs()
+{
+}
+
+void GenerateLODs::apply(Node& node)
+{
+    node.traverse(*this);
+}
+
+void GenerateLODs::apply(Group& group)
+{
+    _collectChildren(group);
+}
+
+void GenerateLODs::apply(StateGroup& stateGroup)
+{
+    auto previousPipeline = _currentPipeline;
+
+    for (auto& stateCommand : stateGroup.stateCommands)
+    {
+        stateCommand->accept(*this);
+    }
+
+    _collectChildren(stateGroup);
+
+    _currentPipeline = previousPipeline;
+}
+
+void GenerateLODs::apply(BindGraphicsPipeline& bindPipeline)
+{
+    _currentPipeline = bindPipeline.pipeline.get();
+}
+
+void GenerateLODs::apply(LOD&)
+{
+    // already has levels of detail
+}
+
+void GenerateLODs::apply(PagedLOD&)
+{
+    // already has levels of detail
+}
+
+void GenerateLODs::_collectChildren(Group& group)
+{
+    for (auto& child : group.children)
+    {
+        if (auto itr = _entryIndices.find(child.get()); itr != _entryIndices.end())
+        {
+            _entries[itr->second].parents.emplace_back(&group);
+            continue;
+        }
+
+        // find the vertices, indices and draw range of triangle list draws
+        uint32_t firstBinding = 0;
+        const BufferInfoList* arrays = nullptr;
+        ref_ptr<BufferInfo> indices;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        if (auto vid = child->cast<VertexIndexDraw>(); vid && vid->vertexOffset == 0)
+        {
+            firstBinding = vid->firstBinding;
+            arrays = &vid->arrays;
+            indices = vid->indices;
+            firstIndex = vid->firstIndex;
+            indexCount = vid->indexCount;
+        }
+        else if (auto geometry = child->cast<Geometry>(); geometry && geometry->commands.size() == 1)
+        {
+            if (auto drawIndexed = geometry->commands.front().cast<DrawIndexed>(); drawIndexed && drawIndexed->vertexOffset == 0)
+            {
+                firstBinding = geometry->firstBinding;
+                arrays = &geometry->arrays;
+                indices = geometry->indices;
+                firstIndex = drawIndexed->firstIndex;
+                indexCount = drawIndexed->indexCount;
+            }
+        }
+
+        ref_ptr<vec3Array> vertices;
+        if (arrays && indices && _currentPipeline && indexCount / 3 >= minimumTriangles)
+        {
+            bool triangles = true;
+            const VertexInputState* vertexInputState = nullptr;
+            for (auto& state : _currentPipeline->pipelineStates)
+            {
+                if (auto vis = state.cast<VertexInputState>()) vertexInputState = vis;
+                if (auto ias = state.cast<InputAssemblyState>()) triangles = ias->topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            }
+
+            if (vertexInputState && triangles)
+            {
+                for (auto& attribute : vertexInputState->vertexAttributeDescriptions)
+                {
+                    if (attribute.location == vertexLocation && attribute.offset == 0 && attribute.binding >= firstBinding && (attribute.binding - firstBinding) < arrays->size())
+                    {
+                        auto& bufferInfo = (*arrays)[attribute.binding - firstBinding];
+                        if (bufferInfo) vertices = bufferInfo->data.cast<vec3Array>();
+                    }
+                }
+            }
+        }
+
+        Entry entry;
+        if (vertices && readIndices(indices->data, entry.indices) && firstIndex + indexCount <= entry.indices.size())
+        {
+            entry.indices.erase(entry.indices.begin() + firstIndex + (indexCount / 3) * 3, entry.indices.end());
+            entry.indices.erase(entry.indices.begin(), entry.indices.begin() + firstIndex);
+
+            bool inRange = std::all_of(entry.indices.begin(), entry.indices.end(), [&](uint32_t index) { return index < vertices->size(); });
+            if (inRange)
+            {
+                entry.draw = child;
+                entry.vertices = vertices;
+                entry.parents.emplace_back(&group);
+
+                _entryIndices[child.get()] = _entries.size();
+                _entries.push_back(std::move(entry));
+                continue;
+            }
+        }
+
+        child->accept(*this);
+    }
+}
+
+void GenerateLODs::_simplify(Entry& entry) const
+{
+    dbox bounds;
+    for (auto index : entry.indices) bounds.add(entry.vertices->at(index));
+
+    dvec3 center = (bounds.min + bounds.max) * 0.5;
+    double radius = length(bounds.max - center);
+    entry.bound.set(center, radius);
+
+    // simplify each level from the previous one, so each level is a further collapse of the level above
+    size_t numTriangles = entry.indices.size() / 3;
+    const std::vector<uint32_t>* previous = &entry.indices;
+    for (auto& level : levels)
+    {
+        auto target = static_cast<size_t>(static_cast<double>(numTriangles) * level.triangleRatio);
+        entry.levels.push_back(simplifyTriangles(*entry.vertices, *previous, target, maximumError * radius));
+        previous = &entry.levels.back();
+    }
+}
+
+ref_ptr<Node> GenerateLODs::_createLOD(Entry& entry)
+{
+    auto lod = LOD::create();
+    lod->bound = entry.bound;
+    lod->addChild(LOD::Child{fullDetailScreenHeightRatio, entry.draw});
+
+    size_t previousSize = entry.indices.size();
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        auto& indices = entry.levels[i];
+
+        // skip levels that simplification couldn't reduce any further
+        if (indices.empty() || indices.size() >= previousSize)
+        {
+            lod->children.back().minimumScreenHeightRatio = levels[i].minimumScreenHeightRatio;
+            continue;
+        }
+        previousSize = indices.size();
+
+        ref_ptr<Node> simplified;
+        if (auto vid = entry.draw.cast<VertexIndexDraw>())
+        {
+            auto new_vid = VertexIndexDraw::create();
+            new_vid->firstBinding = vid->firstBinding;
+            new_vid->arrays = vid->arrays;
+            new_vid->assignIndices(createIndices(indices, vid->indices->data));
+            new_vid->indexCount = static_cast<uint32_t>(indices.size());
+            new_vid->instanceCount = vid->instanceCount;
+            new_vid->firstInstance = vid->firstInstance;
+            simplified = new_vid;
+        }
+        else if (auto geometry = entry.draw.cast<Geometry>())
+        {
+            auto drawIndexed = geometry->commands.front().cast<DrawIndexed>();
+            auto new_geometry = Geometry::create();
+            new_geometry->firstBinding = geometry->firstBinding;
+            new_geometry->arrays = geometry->arrays;
+            new_geometry->assignIndices(createIndices(indices, geometry->indices->data));
+            new_geometry->commands.push_back(DrawIndexed::create(static_cast<uint32_t>(indices.size()), drawIndexed->instanceCount, 0, 0, drawIndexed->firstInstance));
+            simplified = new_geometry;
+        }
+
+        lod->addChild(LOD::Child{levels[i].minimumScreenHeightRatio, simplified});
+    }
+
+    numTriangles += entry.indices.size() / 3;
+    numLowestDetailTriangles += (entry.levels.empty() ? entry.indices.size() : std::min(entry.indices.size(), previousSize)) / 3;
+
+    return lod;
+}
+
+void GenerateLODs::generate()
+{
+    if (operationThreads && _entries.size() > 1)
+    {
+        struct Simplify : public Operation
+        {
+            Simplify(const GenerateLODs& in_generateLODs, Entry& in_entry, ref_ptr<Latch> in_latch) :
+                generateLODs(in_generateLODs),
+                entry(in_entry),
+                latch(in_latch) {}
+
+            void run() override
+            {
+                generateLODs._simplify(entry);
+                latch->count_down();
+            }
+
+            const GenerateLODs& generateLODs;
+            Entry& entry;
+            ref_ptr<Latch> latch;
+        };
+
+        auto latch = Latch::create(static_cast<int>(_entries.size()));
+        for (auto& entry : _entries)
+        {
+            operationThreads->add(ref_ptr<Operation>(new Simplify(*this, entry, latch)));
+        }
+
+        // help out with the simplification then wait for the remaining ones to complete
+        operationThreads->run();
+        latch->wait();
+    }
+    else
+    {
+        for (auto& entry : _entries) _simplify(entry);
+    }
+
+    for (auto& entry : _entries)
+    {
+        auto lod = _createLOD(entry);
+        for (auto& parent : entry.parents)
+        {
+            for (auto& child : parent->children)
+            {
+                if (child == entry.draw) child = lod;
+            }
+        }
+        ++numLODs;
+    }
+
+    _entryIndices.clear();
+    _entries.clear();
+}
@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
 #include <vsg/nodes/StateGroup.h>
+#include <vsg/state/FragmentShadingRateState.h>
 #include <vsg/state/ViewDependentState.h>
 #include <vsg/utils/GraphicsPipelineConfigurator.h>
 #include <vsg/utils/SharedObjects.h>
@@ -107,7 +108,9 @@ int DescriptorConfigurator::compare(const Object& rhs_object) const
     if ((result = compare_value(two_sided, rhs.two_sided))) return result;
     if ((result = compare_container(assigned, rhs.assigned))) return result;
     if ((result = compare_container(defines, rhs.defines))) return result;
-    return compare_pointer_container(descriptorSets, rhs.descriptorSets);
+    if ((result = compare_pointer_container(descriptorSets, rhs.descriptorSets))) return result;
+    if (bindlessTextureIndices < rhs.bindlessTextureIndices) return -1;
+    return (rhs.bindlessTextureIndices < bindlessTextureIndices) ? 1 : 0;
 }
 
 void DescriptorConfigurator::reset()
@@ -115,6 +118,7 @@ void DescriptorConfigurator::reset()
     assigned.clear();
     defines.clear();
     descriptorSets.clear();
+    bindlessTextureIndices.clear();
 }
 
 bool DescriptorConfigurator::enableTexture(const std::string& name)
@@ -167,6 +171,41 @@ bool DescriptorConfigurator::assignTexture(const std::string& name, const ImageI
     return false;
 }
 
+bool DescriptorConfigurator::assignBindlessTexture(const std::string& name, ref_ptr<Data> textureData, ref_ptr<Sampler> sampler)
+{
+    ref_ptr<BindlessTextureBinding> bindlessTextureBinding;
+    for (auto& cdsb : shaderSet->customDescriptorSetBindings)
+    {
+        if (auto btb = cdsb.cast<BindlessTextureBinding>(); btb && btb->textures) bindlessTextureBinding = btb;
+    }
+    if (!bindlessTextureBinding)
+    {
+        // the built in flat, phong and pbr ShaderSets don't index into a texture array so fall back to a per object texture binding
+        info("DescriptorConfigurator::assignBindlessTexture(", name, ", ..) ShaderSet has no BindlessTextureBinding, falling back to assignTexture(..).");
+        return assignTexture(name, textureData, sampler);
+    }
+
+    auto& textureBinding = shaderSet->getDescriptorBinding(name);
+    if (!textureData && textureBinding) textureData = textureBinding.data;
+
+    auto& textures = bindlessTextureBinding->textures;
+    uint32_t slot = textures->add(textureData, sampler);
+    if (slot >= textures->maxTextures)
+    {
+        warn("DescriptorConfigurator::assignBindlessTexture(", name, ", ..) no BindlessTextures slots available, falling back to assignTexture(..).");
+        return assignTexture(name, textureData, sampler);
+    }
+
+    assigned.insert(name);
+    bindlessTextureIndices[name] = slot;
+
+    // set up defines so shaders know the texture is available and is indexed from the texture array
+    if (textureBinding && !textureBinding.define.empty()) defines.insert(textureBinding.define);
+    if (!bindlessTextureBinding->define.empty()) defines.insert(bindlessTextureBinding->define);
+
+    return true;
+}
+
 bool DescriptorConfigurator::enableDescriptor(const std::string& name)
 {
     if (auto& descriptorBinding = shaderSet->getDescriptorBinding(name))
@@ -369,6 +408,7 @@ void GraphicsPipelineConfigurator::_assignShaderSetSettings()
     if (!agps.depthStencilState) pipelineStates.push_back(vsg::DepthStencilState::create());
 
     shaderHints = shaderSet->defaultShaderHints ? vsg::ShaderCompileSettings::create(*shaderSet->defaultShaderHints) : vsg::ShaderCompileSettings::create();
+    subpass = shaderSet->subpass;
 }
 
 void GraphicsPipelineConfigurator::traverse(Visitor& visitor)
@@ -446,6 +486,13 @@ bool GraphicsPipelineConfigurator::enableDescriptor(const std::string& name)
     return descriptorConfigurator->enableDescriptor(name);
 }
 
+void GraphicsPipelineConfigurator::assignFragmentShadingRate(const VkExtent2D& fragmentSize, VkFragmentShadingRateCombinerOpKHR attachmentCombinerOp)
+{
+    auto fragmentShadingRateState = FragmentShadingRateState::create(fragmentSize);
+    fragmentShadingRateState->combinerOps[1] = attachmentCombinerOp;
+    mergeGraphicsPipelineStates(MASK_ALL, pipelineStates, fragmentShadingRateState);
+}
+
 bool GraphicsPipelineConfigurator::assignArray(DataList& arrays, const std::string& name, VkVertexInputRate vertexInputRate, ref_ptr<Data> array)
 {
     const auto& attributeBinding = shaderSet->getAttributeBinding(name);
@@ -498,6 +545,7 @@ int GraphicsPipelineConfigurator::compare(const Object& rhs_object) const
     if ((result = compare_value(subpass, rhs.subpass))) return result;
     if ((result = compare_value(baseAttributeBinding, rhs.baseAttributeBinding))) return result;
     if ((result = compare_pointer(shaderSet, rhs.shaderSet))) return result;
+    if ((result = compare_value_container(extendedDynamicStates, rhs.extendedDynamicStates))) return result;
 
     if ((result = compare_pointer(shaderHints, rhs.shaderHints))) return result;
     if ((result = compare_pointer_container(inheritedState, rhs.inheritedState))) return result;
@@ -588,7 +636,27 @@ void GraphicsPipelineConfigurator::init()
     }
 
     layout = shaderSet->createPipelineLayout(shaderHints->defines);
-    graphicsPipeline = GraphicsPipeline::create(layout, shaderSet->getShaderStages(shaderHints), pipelineStates, subpass);
+
+    if (extendedDynamicStates.empty())
+    {
+        setDynamicState = {};
+        graphicsPipeline = GraphicsPipeline::create(layout, shaderSet->getShaderStages(shaderHints), pipelineStates, subpass);
+    }
+    else
+    {
+        for (auto state : extendedDynamicStates)
+        {
+            if (!SetDynamicState::supported(state)) warn("GraphicsPipelineConfigurator::init() dynamic state ", state, " not supported by SetDynamicState.");
+        }
+
+        // the values of the dynamic states are recorded by the SetDynamicState, leaving the GraphicsPipeline with the defaults so it can be shared
+        setDynamicState = SetDynamicState::create(extendedDynamicStates, pipelineStates);
+
+        auto dynamicPipelineStates = pipelineStates;
+        setDynamicState->makeDynamic(dynamicPipelineStates);
+        graphicsPipeline = GraphicsPipeline::create(layout, shaderSet->getShaderStages(shaderHints), dynamicPipelineStates, subpass);
+    }
+
     bindGraphicsPipeline = vsg::BindGraphicsPipeline::create(graphicsPipeline);
 }
 
@@ -621,6 +689,23 @@ bool GraphicsPipelineConfigurator::copyTo(StateCommands& stateCommands, ref_ptr<
         stateAssigned = true;
     }
 
+    if (setDynamicState)
+    {
+        bool dynamicStateUnique = true;
+        for (auto& sc : inheritedState)
+        {
+            if (compare_pointer(sc, setDynamicState) == 0) dynamicStateUnique = false;
+        }
+
+        if (dynamicStateUnique)
+        {
+            if (sharedObjects) sharedObjects->share(setDynamicState);
+
+            stateCommands.push_back(setDynamicState);
+            stateAssigned = true;
+        }
+    }
+
     if (descriptorConfigurator)
     {
         for (size_t set = 0; set < descriptorConfigurator->descriptorSets.size(); ++set)
@@ -0,0 +1,309 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Allocator.h>
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/Logger.h>
+#include <vsg/ui/FrameStamp.h>
+#include <vsg/ui/UIEvent.h>
+#include <vsg/utils/HitchDetector.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+using namespace vsg;
+
+namespace
+{
+    uint64_t nowNanoseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count());
+    }
+
+    std::string escape(const char* str)
+    {
+        std::string result;
+        if (!str) return result;
+        for (; *str != 0; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+                result.push_back('\\');
+            else if (static_cast<unsigned char>(*str) < 0x20)
+                continue;
+            result.push_back(*str);
+        }
+        return result;
+    }
+
+    std::atomic_uint64_t s_nextHitchDetectorID{1};
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////
+//
+// HitchDetector::Snapshot
+//
+struct HitchDetector::Snapshot
+{
+    struct Thread
+    {
+        std::string name;
+        std::vector<Event> events;
+    };
+
+    std::vector<Thread> threads;
+    std::vector<Frame> frames;
+};
+
+/////////////////////////////////////////////////////////////////////////
+//
+// HitchDetector
+//
+HitchDetector::HitchDetector() :
+    _id(s_nextHitchDetectorID.fetch_add(1))
+{
+}
+
+HitchDetector::~HitchDetector()
+{
+    if (_writeThread.joinable()) _writeThread.join();
+}
+
+HitchDetector::ThreadEvents* HitchDetector::_threadEvents() const
+{
+    // each thread caches the ThreadEvents it has been assigned by each HitchDetector, keyed by ID so stale entries are never matched
+    thread_local std::vector<std::pair<uint64_t, ThreadEvents*>> s_threadEvents;
+    for (auto& [id, events] : s_threadEvents)
+    {
+        if (id == _id) return events;
+    }
+
+    std::scoped_lock lock(_threadsMutex);
+    _threads.emplace_back(new ThreadEvents);
+    _threads.back()->name = "thread " + std::to_string(_threads.size() - 1);
+    s_threadEvents.emplace_back(_id, _threads.back().get());
+    return _threads.back().get();
+}
+
+void HitchDetector::_add(const Event& event) const
+{
+    auto threadEvents = _threadEvents();
+
+    // the lock is only contended while a snapshot is being taken
+    std::scoped_lock lock(threadEvents->mutex);
+    if (threadEvents->events.size() != eventsPerThread) threadEvents->events.resize(std::max(eventsPerThread, 1u));
+    threadEvents->events[threadEvents->count % threadEvents->events.size()] = event;
+    ++threadEvents->count;
+}
+
+void HitchDetector::setThreadName(const std::string& name) const
+{
+    auto threadEvents = _threadEvents();
+    std::scoped_lock lock(threadEvents->mutex);
+    threadEvents->name = name;
+}
+
+void HitchDetector::enterFrame(const SourceLocation* sl, uint64_t& reference, FrameStamp& /*frameStamp*/) const
+{
+    enter(sl, reference);
+}
+
+void HitchDetector::leaveFrame(const SourceLocation* sl, uint64_t& reference, FrameStamp& frameStamp) const
+{
+    if (reference == 0) return;
+
+    Frame frame;
+    frame.frameCount = frameStamp.frameCount;
+    frame.start = reference;
+    frame.duration = nowNanoseconds() - reference;
+    frame.allocatedMemory = Allocator::instance()->totalMemorySize();
+
+    leave(sl, reference);
+
+    double averageDuration = 0.0;
+    {
+        std::scoped_lock lock(_framesMutex);
+
+        size_t numBuffered = std::min(static_cast<size_t>(_frameIndex), _frames.size());
+        for (size_t i = 0; i < numBuffered; ++i) averageDuration += static_cast<double>(_frames[i].duration);
+        if (numBuffered > 0) averageDuration /= static_cast<double>(numBuffered);
+
+        if (_frames.size() != numFrames) _frames.resize(std::max(numFrames, 1u));
+        _frames[_frameIndex % _frames.size()] = frame;
+        ++_frameIndex;
+        ++_framesSinceSnapshot;
+
+        // wait until the ring of frames has filled so the average is representative and start up frames don't trigger snapshots
+        if (_frameIndex < _frames.size() || _framesSinceSnapshot <= minimumFramesBetweenSnapshots) return;
+    }
+
+    double durationMilliseconds = static_cast<double>(frame.duration) * 1e-6;
+    bool hitch = durationMilliseconds > thresholdTime || (thresholdRatio > 0.0 && static_cast<double>(frame.duration) > averageDuration * thresholdRatio);
+    if (!hitch) return;
+
+    {
+        std::scoped_lock lock(_framesMutex);
+        _framesSinceSnapshot = 0;
+    }
+
+    vsg::info("HitchDetector frame ", frame.frameCount, " took ", durationMilliseconds, "ms, average ", averageDuration * 1e-6, "ms, writing snapshot.");
+
+    // copy the ring buffers on this thread but leave the file writing to a background thread so the hitch isn't made worse
+    std::shared_ptr<Snapshot> snapshot(_snapshot().release());
+    Path filename = directory / ("hitch_" + std::to_string(frame.frameCount) + ".json");
+
+    if (_writeThread.joinable()) _writeThread.join();
+    _writeThread = std::thread([this, snapshot, filename]() {
+        if (!directory.empty() && !vsg::fileExists(directory)) vsg::makeDirectory(directory);
+
+        std::ofstream fout(filename);
+        if (!fout)
+        {
+            vsg::warn("HitchDetector unable to write ", filename);
+            return;
+        }
+        _write(fout, *snapshot);
+        ++_numSnapshots;
+    });
+}
+
+void HitchDetector::enter(const SourceLocation* sl, uint64_t& reference, const Object* /*object*/) const
+{
+    reference = (sl->level <= cpuInstrumentationLevel) ? nowNanoseconds() : 0;
+}
+
+void HitchDetector::leave(const SourceLocation* sl, uint64_t& reference, const Object* /*object*/) const
+{
+    if (reference == 0) return;
+
+    Event event;
+    event.sourceLocation = sl;
+    event.start = reference;
+    event.duration = nowNanoseconds() - reference;
+    _add(event);
+}
+
+void HitchDetector::enterCommandBuffer(const SourceLocation* sl, uint64_t& reference, CommandBuffer& /*commandBuffer*/) const
+{
+    enter(sl, reference);
+}
+
+void HitchDetector::leaveCommandBuffer(const SourceLocation* sl, uint64_t& reference, CommandBuffer& /*commandBuffer*/) const
+{
+    leave(sl, reference);
+}
+
+void HitchDetector::enter(const SourceLocation* sl, uint64_t& reference, CommandBuffer& /*commandBuffer*/, const Object* object) const
+{
+    enter(sl, reference, object);
+}
+
+void HitchDetector::leave(const SourceLocation* sl, uint64_t& reference, CommandBuffer& /*commandBuffer*/, const Object* object) const
+{
+    leave(sl, reference, object);
+}
+
+void HitchDetector::plot(const char* name, double value) const
+{
+    Event event;
+    event.name = name;
+    event.start = nowNanoseconds();
+    event.value = value;
+    _add(event);
+}
+
+std::unique_ptr<HitchDetector::Snapshot> HitchDetector::_snapshot() const
+{
+    std::unique_ptr<Snapshot> snapshot(new Snapshot);
+
+    uint64_t windowStart = 0;
+    {
+        std::scoped_lock lock(_framesMutex);
+        size_t numBuffered = std::min(static_cast<size_t>(_frameIndex), _frames.size());
+        for (size_t i = numBuffered; i > 0; --i)
+        {
+            snapshot->frames.push_back(_frames[(_frameIndex - i) % _frames.size()]);
+        }
+        if (!snapshot->frames.empty()) windowStart = snapshot->frames.front().start;
+    }
+
+    std::scoped_lock lock(_threadsMutex);
+    for (auto& threadEvents : _threads)
+    {
+        std::scoped_lock threadLock(threadEvents->mutex);
+
+        auto& thread = snapshot->threads.emplace_back();
+        thread.name = threadEvents->name;
+
+        // copy oldest to newest, only keeping events that ended within the buffered frames
+        size_t numEvents = std::min(static_cast<size_t>(threadEvents->count), threadEvents->events.size());
+        for (size_t i = numEvents; i > 0; --i)
+        {
+            auto& event = threadEvents->events[(threadEvents->count - i) % threadEvents->events.size()];
+            if (event.start + event.duration >= windowStart) thread.events.push_back(event);
+        }
+    }
+
+    return snapshot;
+}
+
+void HitchDetector::_write(std::ostream& out, const Snapshot& snapshot) const
+{
+    uint64_t origin = snapshot.frames.empty() ? std::numeric_limits<uint64_t>::max() : snapshot.frames.front().start;
+    for (auto& thread : snapshot.threads)
+    {
+        for (auto& event : thread.events) origin = std::min(origin, event.start);
+    }
+
+    // trace event timestamps are in microseconds
+    auto timestamp = [&](uint64_t t) { return static_cast<double>(t - std::min(t, origin)) * 1e-3; };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"vsg\"}}";
+
+    // frames are shown on their own track
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"frames\"}}";
+    for (auto& frame : snapshot.frames)
+    {
+        out << ",\n{\"name\":\"frame " << frame.frameCount << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":" << timestamp(frame.start) << ",\"dur\":" << static_cast<double>(frame.duration) * 1e-3 << "}";
+        out << ",\n{\"name\":\"allocated memory\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":" << timestamp(frame.start + frame.duration) << ",\"args\":{\"bytes\":" << frame.allocatedMemory << "}}";
+    }
+
+    for (size_t t = 0; t < snapshot.threads.size(); ++t)
+    {
+        auto& thread = snapshot.threads[t];
+        size_t tid = t + 1;
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":\"" << escape(thread.name.c_str()) << "\"}}";
+
+        for (auto& event : thread.events)
+        {
+            if (event.sourceLocation)
+            {
+                auto sl = event.sourceLocation;
+                out << ",\n{\"name\":\"" << escape(sl->name ? sl->name : sl->function) << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid;
+                out << ",\"ts\":" << timestamp(event.start) << ",\"dur\":" << static_cast<double>(event.duration) * 1e-3;
+                out << ",\"args\":{\"function\":\"" << escape(sl->function) << "\",\"file\":\"" << escape(sl->file) << "\",\"line\":" << sl->line << "}}";
+            }
+            else
+            {
+                out << ",\n{\"name\":\"" << escape(event.name) << "\",\"ph\":\"C\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << timestamp(event.start) << ",\"args\":{\"value\":" << event.value << "}}";
+            }
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+void HitchDetector::write(std::ostream& out) const
+{
+    _write(out, *_snapshot());
+}
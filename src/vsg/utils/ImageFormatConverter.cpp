@@ -0,0 +1,209 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/utils/ImageFormatConverter.h>
+#include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/Context.h>
+
+#include <cstring>
+
+using namespace vsg;
+
+namespace
+{
+    const char* imageFormatConverter_comp = R"(
+#version 450
+
+layout(local_size_x = 64) in;
+
+layout(push_constant) uniform PushConstants
+{
+    uint componentSize;
+    uint numGroups;
+    uint alpha;
+} pc;
+
+layout(std430, set = 0, binding = 0) readonly buffer Source { uint source[]; };
+layout(std430, set = 0, binding = 1) writeonly buffer Destination { uint destination[]; };
+
+uint component(uint base, uint index)
+{
+    uint byteOffset = index * pc.componentSize;
+    uint word = source[base + byteOffset / 4];
+    if (pc.componentSize == 4) return word;
+    return (word >> ((byteOffset % 4) * 8)) & ((1u << (pc.componentSize * 8)) - 1u);
+}
+
+// each invocation expands 12 bytes of 3 component pixels to 16 bytes of 4 component pixels, that's 4, 2 or 1 pixels depending on the component size
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.numGroups) return;
+
+    uint base = i * 3;
+    uint componentsPerWord = 4 / pc.componentSize;
+    uint bits = pc.componentSize * 8;
+    for (uint w = 0; w < 4; ++w)
+    {
+        uint word = 0;
+        for (uint c = 0; c < componentsPerWord; ++c)
+        {
+            uint m = w * componentsPerWord + c;
+            uint channel = m % 4;
+            uint value = (channel == 3) ? pc.alpha : component(base, (m / 4) * 3 + channel);
+            word |= value << (c * bits);
+        }
+        destination[i * 4 + w] = word;
+    }
+}
+)";
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ImageFormatConverter
+//
+ImageFormatConverter::ImageFormatConverter()
+{
+    DescriptorSetLayoutBindings bindings{
+        {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+    descriptorSetLayout = DescriptorSetLayout::create(bindings);
+
+    PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ImageFormatConversion::PushConstants)}};
+    pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{descriptorSetLayout}, pushConstantRanges);
+
+    auto computeShader = ShaderStage::create(VK_SHADER_STAGE_COMPUTE_BIT, "main", imageFormatConverter_comp);
+    bindPipeline = BindComputePipeline::create(ComputePipeline::create(pipelineLayout, computeShader));
+}
+
+ImageFormatConverter::~ImageFormatConverter()
+{
+}
+
+bool ImageFormatConverter::supported(VkFormat sourceFormat, VkFormat targetFormat)
+{
+    auto sourceTraits = getFormatTraits(sourceFormat);
+    auto targetTraits = getFormatTraits(targetFormat);
+
+    if (sourceTraits.packed || targetTraits.packed || sourceTraits.blockWidth != 1 || targetTraits.blockWidth != 1) return false;
+    if (sourceTraits.numComponents != 3 || targetTraits.numComponents != 4) return false;
+    if (sourceTraits.numBitsPerComponent != targetTraits.numBitsPerComponent) return false;
+
+    int componentSize = sourceTraits.size / 3;
+    return (componentSize == 1 || componentSize == 2 || componentSize == 4) && targetTraits.size == componentSize * 4;
+}
+
+ref_ptr<ImageFormatConverter> ImageFormatConverter::getOrCreate(Context& context)
+{
+    if (!context.getOrCreateShaderCompiler()) return {};
+
+    if (auto queue = context.graphicsQueue; queue && (queue->queueFlags() & VK_QUEUE_COMPUTE_BIT) == 0) return {};
+
+    static std::mutex s_mutex;
+    std::scoped_lock lock(s_mutex);
+
+    auto converter = context.device->getRefObject<ImageFormatConverter>("ImageFormatConverter");
+    if (!converter)
+    {
+        converter = ImageFormatConverter::create();
+        context.device->setObject("ImageFormatConverter", converter);
+    }
+    return converter;
+}
+
+ref_ptr<Command> ImageFormatConverter::convert(Context& context, ref_ptr<Data> data, VkFormat targetFormat)
+{
+    if (!data || !supported(data->properties.format, targetFormat)) return {};
+
+    auto sourceTraits = getFormatTraits(data->properties.format);
+    auto targetTraits = getFormatTraits(targetFormat);
+    if (data->stride() != static_cast<uint32_t>(sourceTraits.size)) return {};
+
+    // each group is 12 bytes of source pixels expanded to 16 bytes
+    uint32_t componentSize = static_cast<uint32_t>(sourceTraits.size / 3);
+    uint32_t pixelsPerGroup = 4 / componentSize;
+    size_t valueCount = data->valueCount();
+    uint32_t numGroups = static_cast<uint32_t>((valueCount + pixelsPerGroup - 1) / pixelsPerGroup);
+    VkDeviceSize sourceSize = VkDeviceSize(numGroups) * 12;
+    VkDeviceSize destinationSize = VkDeviceSize(numGroups) * 16;
+
+    VkDeviceSize alignment = std::max(VkDeviceSize(16), context.device->getPhysicalDevice()->getProperties().limits.minStorageBufferOffsetAlignment);
+
+    auto source = context.stagingMemoryBufferPools->reserveBuffer(sourceSize, alignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (!source) return {};
+
+    auto destination = context.deviceMemoryBufferPools->reserveBuffer(destinationSize, alignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (!destination) return {};
+
+    auto deviceID = context.deviceID;
+    auto sourceMemory = source->buffer->getDeviceMemory(deviceID);
+    if (!sourceMemory) return {};
+
+    void* ptr = nullptr;
+    if (sourceMemory->map(source->buffer->getMemoryOffset(deviceID) + source->offset, sourceSize, 0, &ptr) != VK_SUCCESS) return {};
+    std::memcpy(ptr, data->dataPointer(), data->dataSize());
+    if (sourceSize > data->dataSize()) std::memset(static_cast<uint8_t*>(ptr) + data->dataSize(), 0, static_cast<size_t>(sourceSize - data->dataSize()));
+    sourceMemory->unmap();
+
+    // CopyAndReleaseImage::CopyData takes the image dimensions and mipmap layout from the BufferInfo's data
+    destination->data = data;
+
+    auto conversion = ImageFormatConversion::create(ref_ptr<ImageFormatConverter>(this), source, destination);
+    conversion->pushConstants.componentSize = componentSize;
+    conversion->pushConstants.numGroups = numGroups;
+    std::memcpy(&conversion->pushConstants.alpha, targetTraits.defaultValue + 3 * componentSize, componentSize);
+
+    {
+        // pipelines and descriptor sets are compiled per device, and the converter is shared between the Contexts compiling on different threads
+        std::scoped_lock lock(_mutex);
+        bindPipeline->compile(context);
+        conversion->bindDescriptorSet->compile(context);
+    }
+
+    return conversion;
+}
+
+void ImageFormatConverter::recordBarrier(CommandBuffer& commandBuffer) const
+{
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ImageFormatConversion
+//
+ImageFormatConversion::ImageFormatConversion(ref_ptr<ImageFormatConverter> in_converter, ref_ptr<BufferInfo> in_source, ref_ptr<BufferInfo> in_destination) :
+    converter(in_converter),
+    source(in_source),
+    destination(in_destination)
+{
+    Descriptors descriptors{
+        DescriptorBuffer::create(BufferInfoList{source}, 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{destination}, 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)};
+    bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, converter->pipelineLayout, 0, DescriptorSet::create(converter->descriptorSetLayout, descriptors));
+}
+
+void ImageFormatConversion::record(CommandBuffer& commandBuffer) const
+{
+    converter->bindPipeline->record(commandBuffer);
+    bindDescriptorSet->record(commandBuffer);
+    vkCmdPushConstants(commandBuffer, converter->pipelineLayout->vk(commandBuffer.deviceID), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, (pushConstants.numGroups + ImageFormatConverter::workgroupSize - 1) / ImageFormatConverter::workgroupSize, 1, 1);
+}
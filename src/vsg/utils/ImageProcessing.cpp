@@ -0,0 +1,850 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Allocator.h>
+#include <vsg/core/Array2D.h>
+#include <vsg/core/Array3D.h>
+#include <vsg/io/Logger.h>
+#include <vsg/maths/simd.h>
+#include <vsg/utils/ImageProcessing.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace vsg;
+
+namespace
+{
+    enum ComponentType
+    {
+        UNSUPPORTED,
+        UNORM8,
+        SRGB8,
+        SFLOAT16,
+        SFLOAT32
+    };
+
+    struct PixelFormat
+    {
+        ComponentType type = UNSUPPORTED;
+        uint32_t components = 0;
+        bool bgr = false;
+
+        uint32_t componentSize() const { return type == SFLOAT32 ? 4 : (type == SFLOAT16 ? 2 : 1); }
+        uint32_t size() const { return componentSize() * components; }
+
+        explicit operator bool() const { return type != UNSUPPORTED; }
+    };
+
+    PixelFormat pixelFormat(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8_UNORM: return {UNORM8, 1, false};
+        case VK_FORMAT_R8G8_UNORM: return {UNORM8, 2, false};
+        case VK_FORMAT_R8G8B8_UNORM: return {UNORM8, 3, false};
+        case VK_FORMAT_R8G8B8A8_UNORM: return {UNORM8, 4, false};
+        case VK_FORMAT_B8G8R8_UNORM: return {UNORM8, 3, true};
+        case VK_FORMAT_B8G8R8A8_UNORM: return {UNORM8, 4, true};
+        case VK_FORMAT_R8_SRGB: return {SRGB8, 1, false};
+        case VK_FORMAT_R8G8_SRGB: return {SRGB8, 2, false};
+        case VK_FORMAT_R8G8B8_SRGB: return {SRGB8, 3, false};
+        case VK_FORMAT_R8G8B8A8_SRGB: return {SRGB8, 4, false};
+        case VK_FORMAT_B8G8R8_SRGB: return {SRGB8, 3, true};
+        case VK_FORMAT_B8G8R8A8_SRGB: return {SRGB8, 4, true};
+        case VK_FORMAT_R16_SFLOAT: return {SFLOAT16, 1, false};
+        case VK_FORMAT_R16G16_SFLOAT: return {SFLOAT16, 2, false};
+        case VK_FORMAT_R16G16B16_SFLOAT: return {SFLOAT16, 3, false};
+        case VK_FORMAT_R16G16B16A16_SFLOAT: return {SFLOAT16, 4, false};
+        case VK_FORMAT_R32_SFLOAT: return {SFLOAT32, 1, false};
+        case VK_FORMAT_R32G32_SFLOAT: return {SFLOAT32, 2, false};
+        case VK_FORMAT_R32G32B32_SFLOAT: return {SFLOAT32, 3, false};
+        case VK_FORMAT_R32G32B32A32_SFLOAT: return {SFLOAT32, 4, false};
+        default: return {};
+        }
+    }
+
+    /// lookup tables for sRGB <-> linear conversion, the alpha component is always linear.
+    struct SRGBTables
+    {
+        SRGBTables()
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                float c = static_cast<float>(i) / 255.0f;
+                toLinear[i] = (c <= 0.04045f) ? (c / 12.92f) : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < 4096; ++i)
+            {
+                float c = static_cast<float>(i) / 4095.0f;
+                float s = (c <= 0.0031308f) ? (c * 12.92f) : (1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f);
+                fromLinear[i] = static_cast<uint8_t>(std::clamp(s * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+        }
+
+        float toLinear[256];
+        uint8_t fromLinear[4096];
+    };
+
+    const SRGBTables& srgbTables()
+    {
+        static const SRGBTables s_tables;
+        return s_tables;
+    }
+
+    inline uint8_t encodeUNORM8(float v)
+    {
+        return static_cast<uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    inline uint8_t encodeSRGB8(const SRGBTables& tables, float v)
+    {
+        return tables.fromLinear[static_cast<uint32_t>(std::clamp(v, 0.0f, 1.0f) * 4095.0f + 0.5f)];
+    }
+
+    /// decode count pixels into RGBA float values, missing components are set to 0 and alpha to 1. sRGB components are converted to linear.
+    void decodePixels(const uint8_t* src, uint32_t srcStride, const PixelFormat& pf, float* dest, size_t count)
+    {
+        const uint32_t n = pf.components;
+        size_t i = 0;
+
+        switch (pf.type)
+        {
+        case UNORM8:
+#if defined(VSG_SIMD_SSE2)
+            if (n == 4 && srcStride == 4)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+                for (; i + 4 <= count; i += 4, src += 16, dest += 16)
+                {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                    __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+                    __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+                    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+                    _mm_storeu_ps(dest + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+                    _mm_storeu_ps(dest + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+                    _mm_storeu_ps(dest + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+                }
+            }
+#endif
+            for (; i < count; ++i, src += srcStride, dest += 4)
+            {
+                dest[0] = 0.0f, dest[1] = 0.0f, dest[2] = 0.0f, dest[3] = 1.0f;
+                for (uint32_t c = 0; c < n; ++c) dest[c] = static_cast<float>(src[c]) / 255.0f;
+            }
+            break;
+        case SRGB8: {
+            auto& tables = srgbTables();
+            for (; i < count; ++i, src += srcStride, dest += 4)
+            {
+                dest[0] = 0.0f, dest[1] = 0.0f, dest[2] = 0.0f, dest[3] = 1.0f;
+                for (uint32_t c = 0; c < n; ++c) dest[c] = (c < 3) ? tables.toLinear[src[c]] : static_cast<float>(src[c]) / 255.0f;
+            }
+            break;
+        }
+        case SFLOAT16:
+#if defined(__F16C__)
+            if (n == 4 && srcStride == 8)
+            {
+                for (; i < count; ++i, src += 8, dest += 4)
+                {
+                    _mm_storeu_ps(dest, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+                }
+            }
+#endif
+            for (; i < count; ++i, src += srcStride, dest += 4)
+            {
+                dest[0] = 0.0f, dest[1] = 0.0f, dest[2] = 0.0f, dest[3] = 1.0f;
+                for (uint32_t c = 0; c < n; ++c)
+                {
+                    uint16_t h;
+                    std::memcpy(&h, src + c * 2, 2);
+                    dest[c] = halfToFloat(h);
+                }
+            }
+            break;
+        case SFLOAT32:
+            for (; i < count; ++i, src += srcStride, dest += 4)
+            {
+                dest[0] = 0.0f, dest[1] = 0.0f, dest[2] = 0.0f, dest[3] = 1.0f;
+                std::memcpy(dest, src, n * 4);
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (pf.bgr)
+        {
+            dest -= count * 4;
+            for (i = 0; i < count; ++i, dest += 4) std::swap(dest[0], dest[2]);
+        }
+    }
+
+    /// encode count RGBA float pixels, clamping 8 bit components to the 0 to 1 range. Modifies src when swapping to BGR.
+    void encodePixels(float* src, const PixelFormat& pf, uint8_t* dest, size_t count)
+    {
+        const uint32_t n = pf.components;
+        const uint32_t destStride = pf.size();
+
+        if (pf.bgr)
+        {
+            float* ptr = src;
+            for (size_t i = 0; i < count; ++i, ptr += 4) std::swap(ptr[0], ptr[2]);
+        }
+
+        size_t i = 0;
+        switch (pf.type)
+        {
+        case UNORM8:
+#if defined(VSG_SIMD_SSE2)
+            if (n == 4)
+            {
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128 scale = _mm_set1_ps(255.0f);
+                for (; i + 4 <= count; i += 4, src += 16, dest += 16)
+                {
+                    // _mm_cvtps_epi32 rounds to nearest
+                    __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src), zero), one), scale));
+                    __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + 4), zero), one), scale));
+                    __m128i c = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + 8), zero), one), scale));
+                    __m128i d = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + 12), zero), one), scale));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+                }
+            }
+#endif
+            for (; i < count; ++i, src += 4, dest += destStride)
+            {
+                for (uint32_t c = 0; c < n; ++c) dest[c] = encodeUNORM8(src[c]);
+            }
+            break;
+        case SRGB8: {
+            auto& tables = srgbTables();
+            for (; i < count; ++i, src += 4, dest += destStride)
+            {
+                for (uint32_t c = 0; c < n; ++c) dest[c] = (c < 3) ? encodeSRGB8(tables, src[c]) : encodeUNORM8(src[c]);
+            }
+            break;
+        }
+        case SFLOAT16:
+#if defined(__F16C__)
+            if (n == 4)
+            {
+                for (; i < count; ++i, src += 4, dest += 8)
+                {
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_cvtps_ph(_mm_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT));
+                }
+            }
+#endif
+            for (; i < count; ++i, src += 4, dest += destStride)
+            {
+                for (uint32_t c = 0; c < n; ++c)
+                {
+                    uint16_t h = floatToHalf(src[c]);
+                    std::memcpy(dest + c * 2, &h, 2);
+                }
+            }
+            break;
+        case SFLOAT32:
+            for (; i < count; ++i, src += 4, dest += destStride)
+            {
+                std::memcpy(dest, src, n * 4);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    /// call func(begin, end) over the range 0 to count, splitting the range across threads when there is enough work to be worthwhile.
+    template<typename F>
+    void parallelFor(size_t count, size_t costPerItem, F func)
+    {
+        const size_t minimumWorkPerThread = 256 * 1024;
+        size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        size_t numThreads = std::min({maxThreads, (count * costPerItem) / minimumWorkPerThread, count});
+        if (numThreads <= 1)
+        {
+            func(size_t(0), count);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        size_t chunk = (count + numThreads - 1) / numThreads;
+        for (size_t begin = chunk; begin < count; begin += chunk)
+        {
+            threads.emplace_back(func, begin, std::min(begin + chunk, count));
+        }
+        func(size_t(0), std::min(chunk, count));
+
+        for (auto& thread : threads) thread.join();
+    }
+
+    /// expand 3 byte pixels to 4 bytes, filling the 4th byte with fill.
+    void expand3to4(const uint8_t* src, uint8_t* dest, size_t count, uint8_t fill)
+    {
+        size_t i = 0;
+#if defined(VSG_SIMD_AVX) || defined(__SSSE3__)
+        // each iteration reads 16 bytes but only uses 12, so stop while there are still 2 pixels remaining to avoid reading past the end of src
+        const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(fill) << 24));
+        for (; i + 6 <= count; i += 4, src += 12, dest += 16)
+        {
+            __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+        }
+#elif defined(VSG_SIMD_NEON)
+        const uint8x16_t alpha = vdupq_n_u8(fill);
+        for (; i + 16 <= count; i += 16, src += 48, dest += 64)
+        {
+            uint8x16x3_t rgb = vld3q_u8(src);
+            uint8x16x4_t rgba;
+            rgba.val[0] = rgb.val[0];
+            rgba.val[1] = rgb.val[1];
+            rgba.val[2] = rgb.val[2];
+            rgba.val[3] = alpha;
+            vst4q_u8(dest, rgba);
+        }
+#endif
+        for (; i < count; ++i, src += 3, dest += 4)
+        {
+            dest[0] = src[0];
+            dest[1] = src[1];
+            dest[2] = src[2];
+            dest[3] = fill;
+        }
+    }
+
+    void copyPixelRange(const uint8_t* src, uint32_t srcStride, uint8_t* dest, uint32_t destStride, size_t count, const uint8_t* defaultValue)
+    {
+        if (srcStride == destStride)
+        {
+            std::memcpy(dest, src, count * srcStride);
+        }
+        else if (srcStride == 3 && destStride == 4)
+        {
+            expand3to4(src, dest, count, defaultValue[0]);
+        }
+        else
+        {
+            uint32_t copySize = std::min(srcStride, destStride);
+            uint32_t fillSize = destStride - copySize;
+            for (size_t i = 0; i < count; ++i, src += srcStride, dest += destStride)
+            {
+                std::memcpy(dest, src, copySize);
+                if (fillSize > 0) std::memcpy(dest + copySize, defaultValue, fillSize);
+            }
+        }
+    }
+
+    template<class A>
+    ref_ptr<Data> allocateImage(uint32_t width, uint32_t height, uint32_t depth, Data::Properties properties)
+    {
+        using value_type = typename A::value_type;
+        size_t count = Data::computeValueCountIncludingMipmaps(width, height, depth, properties.maxNumMipmaps);
+        properties.allocatorType = ALLOCATOR_TYPE_VSG_ALLOCATOR;
+
+        auto values = new (vsg::allocate(sizeof(value_type) * count, ALLOCATOR_AFFINITY_DATA)) value_type[count];
+        if constexpr (std::is_same_v<A, Array3D<value_type>>)
+            return A::create(width, height, depth, values, properties);
+        else
+            return A::create(width, height, values, properties);
+    }
+
+    /// number of mipmap levels computeMipmapOffsets() would produce for the dimensions, limited by maxNumMipmaps when it's non zero.
+    uint32_t computeNumMipmapLevels(uint32_t w, uint32_t h, uint32_t d, uint32_t maxNumMipmaps)
+    {
+        uint32_t levels = 1;
+        while ((maxNumMipmaps == 0 || levels < maxNumMipmaps) && (w > 1 || h > 1 || d > 1))
+        {
+            if (w > 1) w /= 2;
+            if (h > 1) h /= 2;
+            if (d > 1) d /= 2;
+            ++levels;
+        }
+        return levels;
+    }
+
+    void copyImageProperties(const Data& image, Data& dest)
+    {
+        dest.properties.origin = image.properties.origin;
+        dest.properties.imageViewType = image.properties.imageViewType;
+    }
+
+    /// per destination pixel source range and weights for one axis of a separable resize
+    struct FilterWeights
+    {
+        std::vector<uint32_t> first;
+        std::vector<uint32_t> count;
+        std::vector<float> weights;
+        uint32_t stride = 0;
+
+        FilterWeights(uint32_t srcSize, uint32_t destSize, ResizeFilter filter)
+        {
+            const double pi = 3.14159265358979323846;
+            double scale = static_cast<double>(srcSize) / static_cast<double>(destSize);
+            double filterScale = std::max(scale, 1.0);
+            double radius = ((filter == RESIZE_LANCZOS3) ? 3.0 : 0.5) * filterScale;
+
+            stride = static_cast<uint32_t>(std::ceil(radius * 2.0)) + 2;
+            first.resize(destSize);
+            count.resize(destSize);
+            weights.resize(static_cast<size_t>(destSize) * stride);
+
+            auto kernel = [&](double t) -> double {
+                if (filter == RESIZE_BOX) return (t >= -0.5 && t < 0.5) ? 1.0 : 0.0;
+
+                t = std::abs(t);
+                if (t < 1e-8) return 1.0;
+                if (t >= 3.0) return 0.0;
+                double pt = pi * t;
+                return 3.0 * std::sin(pt) * std::sin(pt / 3.0) / (pt * pt);
+            };
+
+            for (uint32_t i = 0; i < destSize; ++i)
+            {
+                double center = (static_cast<double>(i) + 0.5) * scale;
+                int64_t begin = std::max(int64_t(0), static_cast<int64_t>(std::floor(center - radius)));
+                int64_t end = std::min(static_cast<int64_t>(srcSize), static_cast<int64_t>(std::ceil(center + radius)) + 1);
+                end = std::min(end, begin + static_cast<int64_t>(stride));
+
+                float* w = weights.data() + static_cast<size_t>(i) * stride;
+                double sum = 0.0;
+                for (int64_t j = begin; j < end; ++j)
+                {
+                    double weight = kernel((static_cast<double>(j) + 0.5 - center) / filterScale);
+                    w[j - begin] = static_cast<float>(weight);
+                    sum += weight;
+                }
+
+                if (sum == 0.0)
+                {
+                    // fallback to nearest
+                    begin = std::min(static_cast<int64_t>(srcSize) - 1, static_cast<int64_t>(center));
+                    end = begin + 1;
+                    w[0] = 1.0f;
+                    sum = 1.0;
+                }
+
+                first[i] = static_cast<uint32_t>(begin);
+                count[i] = static_cast<uint32_t>(end - begin);
+                for (int64_t j = 0; j < end - begin; ++j) w[j] = static_cast<float>(w[j] / sum);
+            }
+        }
+    };
+
+} // namespace
+
+bool vsg::imageProcessingSupported(VkFormat format)
+{
+    return static_cast<bool>(pixelFormat(format));
+}
+
+void vsg::copyPixels(const void* src, uint32_t srcStride, void* dest, uint32_t destStride, size_t count, const uint8_t* defaultValue)
+{
+    auto src_ptr = static_cast<const uint8_t*>(src);
+    auto dest_ptr = static_cast<uint8_t*>(dest);
+
+    parallelFor(count, destStride, [&](size_t begin, size_t end) {
+        copyPixelRange(src_ptr + begin * srcStride, srcStride, dest_ptr + begin * destStride, destStride, end - begin, defaultValue);
+    });
+}
+
+ref_ptr<Data> vsg::createImage(VkFormat format, uint32_t width, uint32_t height, uint32_t depth, uint8_t maxNumMipmaps)
+{
+    auto pf = pixelFormat(format);
+    if (!pf || width == 0 || height == 0 || depth == 0) return {};
+
+    Data::Properties properties(format);
+    properties.maxNumMipmaps = (maxNumMipmaps > 1) ? maxNumMipmaps : 0;
+    if (depth > 1) properties.imageViewType = VK_IMAGE_VIEW_TYPE_3D;
+
+    uint32_t key = pf.componentSize() * 4 + pf.components - 1;
+    if (depth > 1)
+    {
+        switch (key)
+        {
+        case 4: return allocateImage<ubyteArray3D>(width, height, depth, properties);
+        case 5: return allocateImage<ubvec2Array3D>(width, height, depth, properties);
+        case 6: return allocateImage<ubvec3Array3D>(width, height, depth, properties);
+        case 7: return allocateImage<ubvec4Array3D>(width, height, depth, properties);
+        case 8: return allocateImage<ushortArray3D>(width, height, depth, properties);
+        case 9: return allocateImage<uintArray3D>(width, height, depth, properties);
+        case 16: return allocateImage<floatArray3D>(width, height, depth, properties);
+        case 17: return allocateImage<vec2Array3D>(width, height, depth, properties);
+        case 18: return allocateImage<vec3Array3D>(width, height, depth, properties);
+        case 19: return allocateImage<vec4Array3D>(width, height, depth, properties);
+        default: break;
+        }
+
+        warn("vsg::createImage(", format, ", ", width, ", ", height, ", ", depth, ") no Array3D type for 3 or 4 component half float images.");
+        return {};
+    }
+
+    switch (key)
+    {
+    case 4: return allocateImage<ubyteArray2D>(width, height, depth, properties);
+    case 5: return allocateImage<ubvec2Array2D>(width, height, depth, properties);
+    case 6: return allocateImage<ubvec3Array2D>(width, height, depth, properties);
+    case 7: return allocateImage<ubvec4Array2D>(width, height, depth, properties);
+    case 8: return allocateImage<ushortArray2D>(width, height, depth, properties);
+    case 9: return allocateImage<usvec2Array2D>(width, height, depth, properties);
+    case 10: return allocateImage<usvec3Array2D>(width, height, depth, properties);
+    case 11: return allocateImage<usvec4Array2D>(width, height, depth, properties);
+    case 16: return allocateImage<floatArray2D>(width, height, depth, properties);
+    case 17: return allocateImage<vec2Array2D>(width, height, depth, properties);
+    case 18: return allocateImage<vec3Array2D>(width, height, depth, properties);
+    case 19: return allocateImage<vec4Array2D>(width, height, depth, properties);
+    default: return {};
+    }
+}
+
+ref_ptr<Data> vsg::convertImage(const Data& image, VkFormat targetFormat)
+{
+    auto srcPF = pixelFormat(image.properties.format);
+    auto destPF = pixelFormat(targetFormat);
+    if (!srcPF || !destPF) return {};
+
+    uint32_t width = image.width();
+    uint32_t height = image.height();
+    uint32_t depth = image.depth();
+
+    auto dest = createImage(targetFormat, width, height, depth);
+    if (!dest) return {};
+    copyImageProperties(image, *dest);
+
+    size_t count = static_cast<size_t>(width) * height * depth;
+    auto src_ptr = static_cast<const uint8_t*>(image.dataPointer());
+    auto dest_ptr = static_cast<uint8_t*>(dest->dataPointer());
+    uint32_t srcStride = image.stride();
+    uint32_t destStride = destPF.size();
+
+    if (srcPF.type == destPF.type && srcPF.bgr == destPF.bgr)
+    {
+        // same component encoding so just copy the components in common and fill the rest
+        const float defaults[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        uint8_t defaultValue[16];
+        for (uint32_t c = srcPF.components; c < destPF.components; ++c)
+        {
+            uint8_t* ptr = defaultValue + (c - srcPF.components) * destPF.componentSize();
+            if (destPF.type == SFLOAT32)
+                std::memcpy(ptr, &defaults[c], 4);
+            else if (destPF.type == SFLOAT16)
+            {
+                uint16_t h = floatToHalf(defaults[c]);
+                std::memcpy(ptr, &h, 2);
+            }
+            else
+                *ptr = encodeUNORM8(defaults[c]);
+        }
+
+        copyPixels(src_ptr, srcStride, dest_ptr, destStride, count, defaultValue);
+        return dest;
+    }
+
+    parallelFor(count, destStride * 4, [&](size_t begin, size_t end) {
+        const size_t batchSize = 1024;
+        std::vector<float> rgba(batchSize * 4);
+        for (size_t i = begin; i < end; i += batchSize)
+        {
+            size_t n = std::min(batchSize, end - i);
+            decodePixels(src_ptr + i * srcStride, srcStride, srcPF, rgba.data(), n);
+            encodePixels(rgba.data(), destPF, dest_ptr + i * destStride, n);
+        }
+    });
+
+    return dest;
+}
+
+ref_ptr<Data> vsg::resizeImage(const Data& image, uint32_t width, uint32_t height, ResizeFilter filter)
+{
+    auto pf = pixelFormat(image.properties.format);
+    if (!pf || width == 0 || height == 0 || image.width() == 0 || image.height() == 0) return {};
+
+    uint32_t srcWidth = image.width();
+    uint32_t srcHeight = image.height();
+    uint32_t depth = image.depth();
+
+    auto dest = createImage(image.properties.format, width, height, depth);
+    if (!dest) return {};
+    copyImageProperties(image, *dest);
+
+    FilterWeights horizontalWeights(srcWidth, width, filter);
+    FilterWeights verticalWeights(srcHeight, height, filter);
+
+    uint32_t srcStride = image.stride();
+    uint32_t destStride = pf.size();
+    std::vector<float> source(static_cast<size_t>(srcWidth) * srcHeight * 4);
+    std::vector<float> horizontal(static_cast<size_t>(width) * srcHeight * 4);
+
+    for (uint32_t z = 0; z < depth; ++z)
+    {
+        auto src_ptr = static_cast<const uint8_t*>(image.dataPointer()) + static_cast<size_t>(z) * srcWidth * srcHeight * srcStride;
+        auto dest_ptr = static_cast<uint8_t*>(dest->dataPointer()) + static_cast<size_t>(z) * width * height * destStride;
+
+        // decode and filter horizontally
+        parallelFor(srcHeight, (srcWidth + width * horizontalWeights.stride) * 4, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; ++y)
+            {
+                float* src_row = source.data() + y * srcWidth * 4;
+                decodePixels(src_ptr + y * srcWidth * srcStride, srcStride, pf, src_row, srcWidth);
+
+                float* dest_row = horizontal.data() + y * width * 4;
+                for (uint32_t x = 0; x < width; ++x, dest_row += 4)
+                {
+                    const float* w = horizontalWeights.weights.data() + static_cast<size_t>(x) * horizontalWeights.stride;
+                    const float* s = src_row + static_cast<size_t>(horizontalWeights.first[x]) * 4;
+                    float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+                    for (uint32_t k = 0; k < horizontalWeights.count[x]; ++k, s += 4)
+                    {
+                        r += w[k] * s[0];
+                        g += w[k] * s[1];
+                        b += w[k] * s[2];
+                        a += w[k] * s[3];
+                    }
+                    dest_row[0] = r, dest_row[1] = g, dest_row[2] = b, dest_row[3] = a;
+                }
+            }
+        });
+
+        // filter vertically and encode
+        parallelFor(height, width * verticalWeights.stride * 4, [&](size_t begin, size_t end) {
+            std::vector<float> row(static_cast<size_t>(width) * 4);
+            for (size_t y = begin; y < end; ++y)
+            {
+                std::fill(row.begin(), row.end(), 0.0f);
+                const float* w = verticalWeights.weights.data() + y * verticalWeights.stride;
+                for (uint32_t k = 0; k < verticalWeights.count[y]; ++k)
+                {
+                    const float* s = horizontal.data() + static_cast<size_t>(verticalWeights.first[y] + k) * width * 4;
+                    float weight = w[k];
+                    for (size_t i = 0; i < row.size(); ++i) row[i] += weight * s[i];
+                }
+                encodePixels(row.data(), pf, dest_ptr + y * width * destStride, width);
+            }
+        });
+    }
+
+    return dest;
+}
+
+ref_ptr<Data> vsg::generateMipmaps(const Data& image, uint32_t maxNumMipmaps)
+{
+    auto pf = pixelFormat(image.properties.format);
+    if (!pf) return {};
+
+    uint32_t w = image.width();
+    uint32_t h = image.height();
+    uint32_t d = image.depth();
+    uint32_t numLevels = computeNumMipmapLevels(w, h, d, std::min(maxNumMipmaps, 255u));
+
+    auto dest = createImage(image.properties.format, w, h, d, static_cast<uint8_t>(numLevels));
+    if (!dest) return {};
+    copyImageProperties(image, *dest);
+
+    uint32_t srcStride = image.stride();
+    uint32_t destStride = pf.size();
+    auto src_ptr = static_cast<const uint8_t*>(image.dataPointer());
+    auto dest_ptr = static_cast<uint8_t*>(dest->dataPointer());
+
+    // level 0 is a straight copy, the float copy of the current level avoids requantizing the 8 bit formats between levels
+    size_t count = static_cast<size_t>(w) * h * d;
+    copyPixels(src_ptr, srcStride, dest_ptr, destStride, count, nullptr);
+
+    std::vector<float> current(count * 4);
+    parallelFor(count, 16, [&](size_t begin, size_t end) {
+        decodePixels(src_ptr + begin * srcStride, srcStride, pf, current.data() + begin * 4, end - begin);
+    });
+
+    dest_ptr += count * destStride;
+    std::vector<float> next;
+    for (uint32_t level = 1; level < numLevels; ++level)
+    {
+        uint32_t nw = std::max(w / 2, 1u);
+        uint32_t nh = std::max(h / 2, 1u);
+        uint32_t nd = std::max(d / 2, 1u);
+        uint32_t sx = (w > 1) ? 2 : 1;
+        uint32_t sy = (h > 1) ? 2 : 1;
+        uint32_t sz = (d > 1) ? 2 : 1;
+        float scale = 1.0f / static_cast<float>(sx * sy * sz);
+
+        size_t nextCount = static_cast<size_t>(nw) * nh * nd;
+        next.resize(nextCount * 4);
+
+        parallelFor(static_cast<size_t>(nh) * nd, nw * sx * sy * sz * 4, [&](size_t begin, size_t end) {
+            for (size_t row = begin; row < end; ++row)
+            {
+                size_t y = row % nh;
+                size_t z = row / nh;
+                float* out = next.data() + row * nw * 4;
+                for (uint32_t x = 0; x < nw; ++x, out += 4)
+                {
+                    out[0] = 0.0f, out[1] = 0.0f, out[2] = 0.0f, out[3] = 0.0f;
+                    for (uint32_t k = 0; k < sz; ++k)
+                    {
+                        for (uint32_t j = 0; j < sy; ++j)
+                        {
+                            const float* in = current.data() + (((z * sz + k) * h + (y * sy + j)) * w + x * sx) * 4;
+                            for (uint32_t i = 0; i < sx; ++i, in += 4)
+                            {
+                                out[0] += in[0];
+                                out[1] += in[1];
+                                out[2] += in[2];
+                                out[3] += in[3];
+                            }
+                        }
+                    }
+                    out[0] *= scale, out[1] *= scale, out[2] *= scale, out[3] *= scale;
+                }
+            }
+        });
+
+        current.swap(next);
+        w = nw;
+        h = nh;
+        d = nd;
+
+        // encodePixels() can modify its source so encode from a copy as the current level is needed for the next level
+        next.assign(current.begin(), current.end());
+        parallelFor(nextCount, destStride * 4, [&](size_t begin, size_t end) {
+            encodePixels(next.data() + begin * 4, pf, dest_ptr + begin * destStride, end - begin);
+        });
+        dest_ptr += nextCount * destStride;
+    }
+
+    return dest;
+}
+
+ref_ptr<Data> vsg::createImageLayers(const Data& image, uint32_t tileWidth, uint32_t tileHeight)
+{
+    auto pf = pixelFormat(image.properties.format);
+    uint32_t width = image.width();
+    uint32_t height = image.height();
+    if (!pf || image.depth() > 1 || tileWidth == 0 || tileHeight == 0 || width < tileWidth || height < tileHeight) return {};
+
+    uint32_t columns = width / tileWidth;
+    uint32_t rows = height / tileHeight;
+    uint32_t numLayers = columns * rows;
+
+    auto dest = createImage(image.properties.format, tileWidth, tileHeight, numLayers);
+    if (!dest) return {};
+    dest->properties.origin = image.properties.origin;
+    dest->properties.imageViewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+
+    uint32_t srcStride = image.stride();
+    uint32_t destStride = pf.size();
+    auto src_ptr = static_cast<const uint8_t*>(image.dataPointer());
+    auto dest_ptr = static_cast<uint8_t*>(dest->dataPointer());
+
+    parallelFor(numLayers, static_cast<size_t>(tileWidth) * tileHeight * destStride, [&](size_t begin, size_t end) {
+        for (size_t layer = begin; layer < end; ++layer)
+        {
+            size_t column = layer % columns;
+            size_t row = layer / columns;
+            uint8_t* dest_tile = dest_ptr + layer * tileWidth * tileHeight * destStride;
+            for (uint32_t y = 0; y < tileHeight; ++y)
+            {
+                const uint8_t* src_row = src_ptr + ((row * tileHeight + y) * width + column * tileWidth) * srcStride;
+                copyPixelRange(src_row, srcStride, dest_tile + static_cast<size_t>(y) * tileWidth * destStride, destStride, tileWidth, nullptr);
+            }
+        }
+    });
+
+    return dest;
+}
+
+float vsg::halfToFloat(uint16_t value)
+{
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+
+    uint32_t bits;
+    if (exponent == 0x1f)
+    {
+        // inf or NaN
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    else if (mantissa != 0)
+    {
+        // subnormal, normalize the mantissa
+        exponent = 113;
+        while ((mantissa & 0x400) == 0)
+        {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+    else
+    {
+        bits = sign;
+    }
+
+    float result;
+    std::memcpy(&result, &bits, 4);
+    return result;
+}
+
+uint16_t vsg::floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, 4);
+
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t exponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (exponent == 0xff)
+    {
+        // inf or NaN, keeping NaNs as NaNs
+        return sign | 0x7c00 | (mantissa ? (0x200 | (mantissa >> 13)) : 0);
+    }
+
+    int32_t e = static_cast<int32_t>(exponent) - 112;
+    if (e >= 0x1f)
+    {
+        // overflow to inf
+        return sign | 0x7c00;
+    }
+
+    if (e <= 0)
+    {
+        // subnormal or zero
+        if (e < -10) return sign;
+
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - e);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) ++half;
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    // round to nearest even, a carry out of the mantissa correctly increments the exponent
+    uint32_t half = (static_cast<uint32_t>(e) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ++half;
+    return sign | static_cast<uint16_t>(half);
+}
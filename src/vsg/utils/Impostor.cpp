@@ -0,0 +1,529 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/app/CommandGraph.h>
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/app/RenderGraph.h>
+#include <vsg/app/View.h>
+#include <vsg/app/Viewer.h>
+#include <vsg/core/Array.h>
+#include <vsg/io/Input.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Output.h>
+#include <vsg/nodes/Light.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/ImageInfo.h>
+#include <vsg/state/material.h>
+#include <vsg/utils/ComputeBounds.h>
+#include <vsg/utils/GraphicsPipelineConfigurator.h>
+#include <vsg/utils/Impostor.h>
+#include <vsg/vk/State.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vsg;
+
+namespace
+{
+    // half angle of the field of view the atlas cells are rendered with, narrow so that the view approximates the parallel projection of a distant billboard
+    constexpr double s_halfFieldOfView = 10.0 * PI / 180.0;
+
+    // BakeCells records the subgraph once for each cell of the atlas, setting the projection and view matrices of the cell
+    class BakeCells : public Node
+    {
+    public:
+        struct Cell
+        {
+            dmat4 projection;
+            dmat4 view;
+        };
+
+        ref_ptr<Node> subgraph;
+        std::vector<Cell> cells;
+
+        void traverse(Visitor& visitor) override { subgraph->accept(visitor); }
+        void traverse(ConstVisitor& visitor) const override { subgraph->accept(visitor); }
+
+        void accept(RecordTraversal& recordTraversal) const override
+        {
+            auto state = recordTraversal.getState();
+            for (auto& cell : cells)
+            {
+                state->setProjectionAndViewMatrix(cell.projection, cell.view);
+                state->dirty = true;
+                subgraph->accept(recordTraversal);
+            }
+        }
+    };
+
+    // ImpostorCells records the draw of the atlas cell whose view direction is closest to the direction of the eye from the center of the Impostor
+    class ImpostorCells : public Node
+    {
+    public:
+        dvec3 center;
+        uint32_t gridSize = 0;
+        std::vector<ref_ptr<Node>> cells;
+
+        void traverse(Visitor& visitor) override
+        {
+            for (auto& cell : cells) cell->accept(visitor);
+        }
+
+        void traverse(ConstVisitor& visitor) const override
+        {
+            for (auto& cell : cells) cell->accept(visitor);
+        }
+
+        void accept(RecordTraversal& recordTraversal) const override
+        {
+            auto inverseModelView = inverse(recordTraversal.getState()->modelviewMatrixStack.top());
+            dvec3 eye(inverseModelView[3][0], inverseModelView[3][1], inverseModelView[3][2]);
+            cells[octahedralCell(eye - center, gridSize)]->accept(recordTraversal);
+        }
+    };
+
+    dmat4 cellMatrix(uint32_t i, uint32_t j, uint32_t gridSize)
+    {
+        // map the whole of clip space into the cell's region of the atlas
+        double g = static_cast<double>(gridSize);
+        return translate(-1.0 + (2.0 * i + 1.0) / g, -1.0 + (2.0 * j + 1.0) / g, 0.0) * scale(1.0 / g, 1.0 / g, 1.0);
+    }
+
+    dvec3 cellUp(const dvec3& direction)
+    {
+        // keep the cells upright for z up scenes, other than when looking straight up or down
+        return (std::abs(direction.z) > 0.99) ? dvec3(0.0, 1.0, 0.0) : dvec3(0.0, 0.0, 1.0);
+    }
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////
+//
+// octahedral mapping
+//
+dvec3 vsg::octahedralDirection(uint32_t i, uint32_t j, uint32_t gridSize)
+{
+    double x = (2.0 * i + 1.0) / gridSize - 1.0;
+    double y = (2.0 * j + 1.0) / gridSize - 1.0;
+    double z = 1.0 - std::abs(x) - std::abs(y);
+
+    // unfold the lower hemisphere from the corners of the octahedron
+    if (z < 0.0)
+    {
+        double fx = (1.0 - std::abs(y)) * (x >= 0.0 ? 1.0 : -1.0);
+        double fy = (1.0 - std::abs(x)) * (y >= 0.0 ? 1.0 : -1.0);
+        x = fx;
+        y = fy;
+    }
+
+    return normalize(dvec3(x, y, z));
+}
+
+uint32_t vsg::octahedralCell(const dvec3& direction, uint32_t gridSize)
+{
+    double sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (sum == 0.0) return 0;
+
+    double x = direction.x / sum;
+    double y = direction.y / sum;
+    if (direction.z < 0.0)
+    {
+        double fx = (1.0 - std::abs(y)) * (x >= 0.0 ? 1.0 : -1.0);
+        double fy = (1.0 - std::abs(x)) * (y >= 0.0 ? 1.0 : -1.0);
+        x = fx;
+        y = fy;
+    }
+
+    auto cell = [gridSize](double v) {
+        return std::min(static_cast<uint32_t>(std::max((v * 0.5 + 0.5) * gridSize, 0.0)), gridSize - 1);
+    };
+    return cell(y) * gridSize + cell(x);
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Impostor
+//
+Impostor::Impostor(ref_ptr<Node> in_subgraph) :
+    subgraph(in_subgraph)
+{
+    if (subgraph)
+    {
+        ComputeBounds computeBounds;
+        subgraph->accept(computeBounds);
+        if (computeBounds.bounds.valid())
+        {
+            bound.center = (computeBounds.bounds.min + computeBounds.bounds.max) * 0.5;
+            bound.radius = length(computeBounds.bounds.max - computeBounds.bounds.min) * 0.5;
+        }
+    }
+}
+
+Impostor::~Impostor()
+{
+}
+
+void Impostor::accept(RecordTraversal& visitor) const
+{
+    auto state = visitor.getState();
+    auto lodDistance = state->lodDistance(bound);
+    if (lodDistance < 0.0) return;
+
+    if (bound.r > lodDistance * minimumScreenHeightRatio)
+    {
+        traverse(visitor);
+        return;
+    }
+
+    if (billboard)
+    {
+        if (auto frameStamp = visitor.getFrameStamp()) frameLastUsed = frameStamp->frameCount;
+        billboard->accept(visitor);
+        return;
+    }
+
+    // render the subgraph until the atlas is ready
+    if (auto in_manager = manager.ref_ptr()) in_manager->request(this);
+    traverse(visitor);
+}
+
+int Impostor::compare(const Object& rhs_object) const
+{
+    int result = Node::compare(rhs_object);
+    if (result != 0) return result;
+
+    const auto& rhs = static_cast<decltype(*this)>(rhs_object);
+    if ((result = compare_value(bound, rhs.bound))) return result;
+    if ((result = compare_value(minimumScreenHeightRatio, rhs.minimumScreenHeightRatio))) return result;
+    return compare_pointer(subgraph, rhs.subgraph);
+}
+
+void Impostor::read(Input& input)
+{
+    Node::read(input);
+
+    input.read("bound", bound);
+    input.read("minimumScreenHeightRatio", minimumScreenHeightRatio);
+    input.read("subgraph", subgraph);
+}
+
+void Impostor::write(Output& output) const
+{
+    Node::write(output);
+
+    output.write("bound", bound);
+    output.write("minimumScreenHeightRatio", minimumScreenHeightRatio);
+    output.write("subgraph", subgraph);
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ImpostorManager
+//
+ImpostorManager::ImpostorManager(ref_ptr<Viewer> in_viewer, ref_ptr<Window> window, uint32_t in_gridSize, uint32_t in_cellSize) :
+    viewer(in_viewer),
+    gridSize(std::max(in_gridSize, 1u)),
+    cellSize(std::max(in_cellSize, 1u)),
+    shaderSet(createFlatShadedShaderSet()),
+    sharedObjects(SharedObjects::create())
+{
+    auto device = window->getOrCreateDevice();
+    uint32_t atlasDimension = gridSize * cellSize;
+
+    // the atlas is left ready to be sampled by the billboards
+    auto colorAttachment = defaultColorAttachment(colorFormat);
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    RenderPass::Attachments attachments{colorAttachment, defaultDepthAttachment(depthFormat)};
+
+    SubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachments.push_back(AttachmentReference{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    subpass.depthStencilAttachments.push_back(AttachmentReference{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
+
+    RenderPass::Dependencies dependencies(2);
+
+    // depth buffer is shared between the atlases
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dependencyFlags = 0;
+
+    // rendering must complete before the billboards sample the atlas
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    dependencies[1].dependencyFlags = 0;
+
+    _renderPass = RenderPass::create(device, attachments, RenderPass::Subpasses{subpass}, dependencies);
+
+    auto depthImage = Image::create();
+    depthImage->imageType = VK_IMAGE_TYPE_2D;
+    depthImage->extent = VkExtent3D{atlasDimension, atlasDimension, 1};
+    depthImage->mipLevels = 1;
+    depthImage->arrayLayers = 1;
+    depthImage->format = depthFormat;
+    depthImage->tiling = VK_IMAGE_TILING_OPTIMAL;
+    depthImage->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthImage->samples = VK_SAMPLE_COUNT_1_BIT;
+    depthImage->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    depthImage->usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    depthImage->compile(device);
+    depthImage->allocateAndBindMemory(device, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    _depthImageView = ImageView::create(depthImage, VK_IMAGE_ASPECT_DEPTH_BIT);
+    _depthImageView->compile(device);
+
+    // the cells set their own projection and view matrices, the camera provides the viewport covering the whole atlas
+    auto camera = Camera::create(Perspective::create(), LookAt::create(), ViewportState::create(VkExtent2D{atlasDimension, atlasDimension}));
+
+    _cells = Group::create();
+
+    _view = View::create(camera);
+    _view->addChild(createHeadlight());
+    _view->addChild(_cells);
+
+    _renderGraph = RenderGraph::create();
+    _renderGraph->renderPass = _renderPass;
+    _renderGraph->renderArea.offset = {0, 0};
+    _renderGraph->renderArea.extent = {atlasDimension, atlasDimension};
+    _renderGraph->setClearValues(VkClearColorValue{{0.0f, 0.0f, 0.0f, 0.0f}});
+    _renderGraph->addChild(_view);
+
+    // the RenderGraph is only a child while an atlas is being rendered, it's left in place until the first update so that Viewer::compile() sets up its View
+    commandGraph = CommandGraph::create(window);
+    commandGraph->submitOrder = -1;
+    commandGraph->addChild(_renderGraph);
+
+    in_viewer->addUpdateOperation(ref_ptr<Operation>(this), UpdateOperations::ALL_FRAMES);
+}
+
+ImpostorManager::~ImpostorManager()
+{
+}
+
+ref_ptr<Impostor> ImpostorManager::createImpostor(ref_ptr<Node> subgraph, double minimumScreenHeightRatio)
+{
+    auto impostor = Impostor::create(subgraph);
+    impostor->minimumScreenHeightRatio = minimumScreenHeightRatio;
+    impostor->manager = this;
+    return impostor;
+}
+
+void ImpostorManager::request(const Impostor* impostor)
+{
+    std::scoped_lock<std::mutex> lock(_requestMutex);
+    for (auto& requested : _requests)
+    {
+        if (requested == impostor) return;
+    }
+    _requests.emplace_back(const_cast<Impostor*>(impostor));
+}
+
+void ImpostorManager::evict(Impostor& impostor)
+{
+    auto itr = std::find_if(_atlases.begin(), _atlases.end(), [&](const Atlas& atlas) { return atlas.impostor == &impostor; });
+    if (itr == _atlases.end()) return;
+
+    auto in_viewer = viewer.ref_ptr();
+    uint64_t frameCount = (in_viewer && in_viewer->getFrameStamp()) ? in_viewer->getFrameStamp()->frameCount : 0;
+
+    _retired.push_back(Retired{frameCount, impostor.billboard, itr->imageView, itr->framebuffer});
+    impostor.billboard = {};
+
+    _atlases.erase(itr);
+    ++numEvicted;
+}
+
+bool ImpostorManager::_makeRoom(uint64_t frameCount)
+{
+    while (!_atlases.empty() && atlasMemory() + atlasSize() > memoryBudget)
+    {
+        // evict the least recently used atlas that wasn't used by the previous frame
+        auto lru = std::min_element(_atlases.begin(), _atlases.end(), [](const Atlas& lhs, const Atlas& rhs) { return lhs.impostor->frameLastUsed < rhs.impostor->frameLastUsed; });
+        if (lru->impostor->frameLastUsed + 1 >= frameCount) return false;
+
+        evict(*(lru->impostor));
+    }
+    return atlasSize() <= memoryBudget;
+}
+
+ref_ptr<Node> ImpostorManager::_createBillboard(const Impostor& impostor, ref_ptr<ImageView> imageView)
+{
+    auto config = GraphicsPipelineConfigurator::create(shaderSet);
+
+    auto sampler = Sampler::create();
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sharedObjects->share(sampler);
+
+    config->assignTexture("diffuseMap", ImageInfoList{ImageInfo::create(sampler, imageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)});
+
+    // the transparent background of the atlas is discarded so the billboards depth test correctly
+    auto material = PhongMaterialValue::create();
+    material->value().alphaMask = 1.0f;
+    material->value().alphaMaskCutoff = alphaCutoff;
+    config->assignDescriptor("material", material);
+
+    config->enableArray("vsg_Vertex", VK_VERTEX_INPUT_RATE_VERTEX, 12);
+    config->enableArray("vsg_Normal", VK_VERTEX_INPUT_RATE_VERTEX, 12);
+    config->enableArray("vsg_TexCoord0", VK_VERTEX_INPUT_RATE_VERTEX, 8);
+    config->enableArray("vsg_Color", VK_VERTEX_INPUT_RATE_INSTANCE, 16);
+    config->enableArray("vsg_position_scaleDistance", VK_VERTEX_INPUT_RATE_INSTANCE, 16);
+
+    sharedObjects->share(config, [](auto gpc) { gpc->init(); });
+
+    auto stateGroup = StateGroup::create();
+    if (!config->copyTo(stateGroup, sharedObjects)) return {};
+
+    // quad in eye coordinates, sized to match the view of the subgraph captured by the cells
+    float h = static_cast<float>(impostor.bound.r / std::cos(s_halfFieldOfView));
+    auto vertices = vec3Array::create({{-h, -h, 0.0f}, {h, -h, 0.0f}, {h, h, 0.0f}, {-h, h, 0.0f}});
+    auto normals = vec3Array::create({{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}});
+    auto colors = vec4Array::create({{1.0f, 1.0f, 1.0f, 1.0f}});
+    auto positions = vec4Array::create({vec4(vec3(impostor.bound.center), 0.0f)});
+    auto indices = ushortArray::create({0, 1, 2, 2, 3, 0});
+
+    auto cells = ref_ptr<ImpostorCells>(new ImpostorCells);
+    cells->center = impostor.bound.center;
+    cells->gridSize = gridSize;
+
+    float cellWidth = 1.0f / static_cast<float>(gridSize);
+    for (uint32_t j = 0; j < gridSize; ++j)
+    {
+        for (uint32_t i = 0; i < gridSize; ++i)
+        {
+            // the top of each cell is the top row of the cell's region of the atlas
+            float u0 = i * cellWidth, u1 = u0 + cellWidth;
+            float v0 = j * cellWidth, v1 = v0 + cellWidth;
+            auto texcoords = vec2Array::create({{u0, v1}, {u1, v1}, {u1, v0}, {u0, v0}});
+
+            auto draw = VertexIndexDraw::create();
+            draw->assignArrays(DataList{vertices, normals, texcoords, colors, positions});
+            draw->assignIndices(indices);
+            draw->indexCount = static_cast<uint32_t>(indices->size());
+            draw->instanceCount = 1;
+            cells->cells.push_back(draw);
+        }
+    }
+
+    stateGroup->addChild(cells);
+    return stateGroup;
+}
+
+void ImpostorManager::run()
+{
+    auto in_viewer = viewer.ref_ptr();
+    if (!in_viewer) return;
+
+    uint64_t frameCount = in_viewer->getFrameStamp() ? in_viewer->getFrameStamp()->frameCount : 0;
+
+    // the atlases rendered by the previous frame are now ready to use
+    for (auto& atlas : _rendering)
+    {
+        auto billboard = _createBillboard(*atlas.impostor, atlas.imageView);
+        if (!billboard) continue;
+
+        if (in_viewer->compileManager)
+        {
+            auto result = in_viewer->compileManager->compile(billboard);
+            if (!result) continue;
+            updateViewer(*in_viewer, result);
+        }
+
+        atlas.impostor->billboard = billboard;
+        atlas.impostor->frameLastUsed = frameCount;
+        _atlases.push_back(atlas);
+    }
+    _rendering.clear();
+    _cells->children.clear();
+    commandGraph->children.clear();
+
+    while (!_retired.empty() && (frameCount - _retired.front().frameCount) > retainForFrameCount)
+    {
+        _retired.pop_front();
+    }
+
+    ref_ptr<Impostor> impostor;
+    {
+        std::scoped_lock<std::mutex> lock(_requestMutex);
+        auto itr = std::find_if(_requests.begin(), _requests.end(), [](const ref_ptr<Impostor>& requested) { return !requested->billboard && requested->subgraph && requested->bound.valid(); });
+        if (itr != _requests.end()) impostor = *itr;
+        _requests.clear();
+    }
+
+    // requests are repeated each frame an Impostor is beyond its cut off, so ones not serviced this frame are picked up later
+    if (!impostor || !_makeRoom(frameCount)) return;
+
+    auto device = _renderPass->device;
+    uint32_t atlasDimension = gridSize * cellSize;
+
+    auto image = Image::create();
+    image->imageType = VK_IMAGE_TYPE_2D;
+    image->extent = VkExtent3D{atlasDimension, atlasDimension, 1};
+    image->mipLevels = 1;
+    image->arrayLayers = 1;
+    image->format = colorFormat;
+    image->tiling = VK_IMAGE_TILING_OPTIMAL;
+    image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image->samples = VK_SAMPLE_COUNT_1_BIT;
+    image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image->usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    image->compile(device);
+    image->allocateAndBindMemory(device, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    Atlas atlas;
+    atlas.impostor = impostor;
+    atlas.imageView = ImageView::create(image, VK_IMAGE_ASPECT_COLOR_BIT);
+    atlas.imageView->compile(device);
+    atlas.framebuffer = Framebuffer::create(_renderPass, ImageViews{atlas.imageView, _depthImageView}, atlasDimension, atlasDimension, 1);
+
+    // view each cell's direction from just far enough away for the bounding sphere to fill the cell
+    const auto& bound = impostor->bound;
+    double distance = bound.r / std::sin(s_halfFieldOfView);
+    auto projection = perspective(2.0 * s_halfFieldOfView, 1.0, distance - bound.r, distance + bound.r);
+
+    auto bake = ref_ptr<BakeCells>(new BakeCells);
+    bake->subgraph = impostor->subgraph;
+    for (uint32_t j = 0; j < gridSize; ++j)
+    {
+        for (uint32_t i = 0; i < gridSize; ++i)
+        {
+            auto direction = octahedralDirection(i, j, gridSize);
+            auto view = lookAt(bound.center + direction * distance, bound.center, cellUp(direction));
+            bake->cells.push_back(BakeCells::Cell{cellMatrix(i, j, gridSize) * projection, view});
+        }
+    }
+
+    // compile the subgraph for the atlas View
+    if (in_viewer->compileManager)
+    {
+        auto viewID = _view->viewID;
+        auto result = in_viewer->compileManager->compile(bake, [viewID](Context& context) { return context.viewID == viewID; });
+        if (!result) return;
+        updateViewer(*in_viewer, result);
+    }
+
+    _cells->addChild(bake);
+    _renderGraph->framebuffer = atlas.framebuffer;
+    commandGraph->addChild(_renderGraph);
+
+    _rendering.push_back(atlas);
+    ++numRendered;
+}
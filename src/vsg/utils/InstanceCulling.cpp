@@ -0,0 +1,187 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/utils/InstanceCulling.h>
+#include <vsg/vk/Context.h>
+
+using namespace vsg;
+
+namespace
+{
+    const char* instanceCulling_comp = R"(
+#version 450
+
+layout(local_size_x = 64) in;
+
+struct DrawIndexedIndirectCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(push_constant) uniform PushConstants
+{
+    vec4 frustum[6];
+    uint numInstances;
+} pc;
+
+layout(std430, set = 0, binding = 0) readonly buffer InstanceBounds { vec4 bounds[]; };
+layout(std430, set = 0, binding = 1) readonly buffer DrawTemplates { DrawIndexedIndirectCommand drawTemplates[]; };
+layout(std430, set = 0, binding = 2) writeonly buffer DrawCommands { DrawIndexedIndirectCommand drawCommands[]; };
+layout(std430, set = 0, binding = 3) buffer DrawCount { uint drawCount; };
+
+void main()
+{
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= pc.numInstances) return;
+
+    vec4 sphere = bounds[i];
+    for (int f = 0; f < 6; ++f)
+    {
+        if (dot(pc.frustum[f].xyz, sphere.xyz) + pc.frustum[f].w < -sphere.w) return;
+    }
+
+    uint index = atomicAdd(drawCount, 1);
+    drawCommands[index] = drawTemplates[i];
+}
+)";
+
+    struct CullingPushConstants
+    {
+        vec4 frustum[6];
+        uint32_t numInstances;
+    };
+} // namespace
+
+InstanceCulling::InstanceCulling() :
+    instanceBounds(BufferInfo::create()),
+    drawTemplates(BufferInfo::create()),
+    drawCommands(BufferInfo::create()),
+    drawCount(BufferInfo::create())
+{
+    _setUp();
+}
+
+InstanceCulling::InstanceCulling(ref_ptr<Camera> in_camera, ref_ptr<vec4Array> in_bounds, ref_ptr<DrawIndexedIndirectCommandArray> in_drawTemplates) :
+    camera(in_camera),
+    instanceBounds(BufferInfo::create(in_bounds)),
+    drawTemplates(BufferInfo::create(in_drawTemplates)),
+    numInstances(static_cast<uint32_t>(std::min(in_bounds->size(), in_drawTemplates->size())))
+{
+    // the outputs are allocated once at compile time, initialized to no visible instances
+    drawCommands = BufferInfo::create(DrawIndexedIndirectCommandArray::create(std::max(numInstances, 1u), DrawIndexedIndirectCommand{0, 0, 0, 0, 0}));
+    drawCount = BufferInfo::create(uintArray::create(1, 0u));
+
+    _setUp();
+}
+
+void InstanceCulling::_setUp()
+{
+    DescriptorSetLayoutBindings bindings{
+        {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+        {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+    auto descriptorSetLayout = DescriptorSetLayout::create(bindings);
+
+    PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingPushConstants)}};
+    _pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{descriptorSetLayout}, pushConstantRanges);
+
+    auto computeShader = ShaderStage::create(VK_SHADER_STAGE_COMPUTE_BIT, "main", instanceCulling_comp);
+    _bindPipeline = BindComputePipeline::create(ComputePipeline::create(_pipelineLayout, computeShader));
+
+    Descriptors descriptors{
+        DescriptorBuffer::create(BufferInfoList{instanceBounds}, 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{drawTemplates}, 1, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{drawCommands}, 2, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+        DescriptorBuffer::create(BufferInfoList{drawCount}, 3, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)};
+    _bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, DescriptorSet::create(descriptorSetLayout, descriptors));
+
+    // previous frame's draws must have finished reading the outputs before they're cleared and rewritten
+    _preCullBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                              MemoryBarrier::create(0, VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+    // the cleared count must be visible to the compute shader's atomicAdd
+    _clearCountBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                                 MemoryBarrier::create(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+
+    // the compute shader's writes must be visible to the indirect draw
+    _postCullBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0,
+                                               MemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT));
+}
+
+ref_ptr<DrawIndexedIndirectCount> InstanceCulling::createDrawCommand() const
+{
+    return DrawIndexedIndirectCount::create(drawCommands, drawCount, numInstances, static_cast<uint32_t>(sizeof(DrawIndexedIndirectCommand)));
+}
+
+void InstanceCulling::compile(Context& context)
+{
+    if (!context.device->getExtensions()->vkCmdDrawIndexedIndirectCount)
+    {
+        warn("InstanceCulling::compile(..) vkCmdDrawIndexedIndirectCount not supported, requires Vulkan 1.2 or VK_KHR_draw_indirect_count.");
+    }
+
+    // create the outputs before the DescriptorBuffer or DrawIndexedIndirectCount can, so that the buffer has both storage and indirect usage
+    createBufferAndTransferData(context, {instanceBounds, drawTemplates}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+    createBufferAndTransferData(context, {drawCommands, drawCount}, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_SHARING_MODE_EXCLUSIVE);
+
+    _bindPipeline->compile(context);
+    _bindDescriptorSet->compile(context);
+}
+
+void InstanceCulling::record(CommandBuffer& commandBuffer) const
+{
+    if (!camera || numInstances == 0 || !drawCount->buffer) return;
+
+    // world coordinate frustum planes from the clip space planes, normalized so the shader can compare distances against the sphere radii
+    dmat4 clipMatrix = camera->projectionMatrix->transform() * camera->viewMatrix->transform();
+    const dplane clipPlanes[6] = {
+        {1.0, 0.0, 0.0, 1.0},  // left
+        {-1.0, 0.0, 0.0, 1.0}, // right
+        {0.0, -1.0, 0.0, 1.0}, // bottom
+        {0.0, 1.0, 0.0, 1.0},  // top
+        {0.0, 0.0, 1.0, 0.0},  // far
+        {0.0, 0.0, -1.0, 1.0}  // near
+    };
+
+    CullingPushConstants pushConstants;
+    for (int i = 0; i < 6; ++i)
+    {
+        dplane plane = clipPlanes[i] * clipMatrix;
+        double normalLength = length(plane.n);
+        if (normalLength > 0.0) plane.vec /= normalLength;
+        pushConstants.frustum[i] = vec4(plane.vec);
+    }
+    pushConstants.numInstances = numInstances;
+
+    auto deviceID = commandBuffer.deviceID;
+
+    _preCullBarrier->record(commandBuffer);
+    vkCmdFillBuffer(commandBuffer, drawCount->buffer->vk(deviceID), drawCount->offset, sizeof(uint32_t), 0);
+    _clearCountBarrier->record(commandBuffer);
+
+    _bindPipeline->record(commandBuffer);
+    _bindDescriptorSet->record(commandBuffer);
+    vkCmdPushConstants(commandBuffer, _pipelineLayout->vk(deviceID), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingPushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, (numInstances + workgroupSize - 1) / workgroupSize, 1, 1);
+
+    _postCullBarrier->record(commandBuffer);
+}
@@ -22,6 +22,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/nodes/Geometry.h>
 #include <vsg/nodes/LOD.h>
 #include <vsg/nodes/PagedLOD.h>
+#include <vsg/nodes/SpatialGroup.h>
 #include <vsg/nodes/StateGroup.h>
 #include <vsg/nodes/Transform.h>
 #include <vsg/nodes/VertexDraw.h>
@@ -137,6 +138,23 @@ void Intersector::apply(const DepthSorted& cn)
     if (intersects(cn.bound)) cn.traverse(*this);
 }
 
+void Intersector::apply(const SpatialGroup& sg)
+{
+    PushPopNode ppn(_nodePath, &sg);
+
+    auto& children = sg.children();
+    for (auto& [key, cell] : sg.cells())
+    {
+        if (!intersects(cell.bound)) continue;
+
+        for (auto index : cell.children)
+        {
+            auto& child = children[index];
+            if (intersects(child.bound)) child.node->accept(*this);
+        }
+    }
+}
+
 void Intersector::apply(const VertexDraw& vid)
 {
     auto& arrayState = *arrayStateStack.back();
@@ -189,6 +207,7 @@ void Intersector::apply(const BindIndexBuffer& bib)
 
 void Intersector::apply(const BufferInfo& bufferInfo)
 {
+    if (bufferInfo.dataReleased() && arrayStateStack.back()->reloadReleasedData) const_cast<BufferInfo&>(bufferInfo).reloadData();
     if (bufferInfo.data) bufferInfo.data->accept(*this);
 }
 
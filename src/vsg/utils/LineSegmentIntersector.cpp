@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/nodes/Transform.h>
 #include <vsg/utils/LineSegmentIntersector.h>
+#include <vsg/utils/TriangleBVH.h>
 
 using namespace vsg;
 
@@ -150,7 +151,8 @@ LineSegmentIntersector::LineSegmentIntersector(const Camera& camera, int32_t x,
     auto projectionMatrix = camera.projectionMatrix->transform();
     auto viewMatrix = camera.viewMatrix->transform();
 
-    bool reverse_depth = (projectionMatrix(2, 2) > 0.0);
+    // standard and infinite far reverse depth projections both have a positive depth translation
+    bool reverse_depth = (projectionMatrix(3, 2) > 0.0);
 
     vsg::dvec3 ndc_near(ndc.x * 2.0 - 1.0, ndc.y * 2.0 - 1.0, reverse_depth ? viewport.maxDepth : viewport.minDepth);
     vsg::dvec3 ndc_far(ndc.x * 2.0 - 1.0, ndc.y * 2.0 - 1.0, reverse_depth ? viewport.minDepth : viewport.maxDepth);
@@ -158,6 +160,13 @@ LineSegmentIntersector::LineSegmentIntersector(const Camera& camera, int32_t x,
     auto inv_projectionMatrix = vsg::inverse(projectionMatrix);
     vsg::dvec3 eye_near = inv_projectionMatrix * ndc_near;
     vsg::dvec3 eye_far = inv_projectionMatrix * ndc_far;
+
+    // with an infinite far plane the far point is at infinity, so end the line segment well beyond any scene along the same ray
+    bool perspective = projectionMatrix(2, 3) != 0.0;
+    if (perspective && (!std::isfinite(eye_far.z) || eye_far.z >= 0.0 || eye_far.z < eye_near.z * 1e10))
+    {
+        eye_far = eye_near * 1e10;
+    }
     _lineSegmentStack.push_back(LineSegment{eye_near, eye_far});
 
     dmat4 eyeToWorld = inverse(viewMatrix);
@@ -259,6 +268,16 @@ bool LineSegmentIntersector::intersectDraw(uint32_t firstVertex, uint32_t vertex
         TriangleIntersector<double> triIntersector(*this, ls.start, ls.end, arrayState.vertexArray(instanceIndex));
         if (!triIntersector.vertices) return false;
 
+        // only vertex arrays used directly can have a cached TriangleBVH, ArrayState subclasses may compute new vertex arrays on each call
+        if (useTriangleBVH && triIntersector.vertices == arrayState.vertices)
+        {
+            if (auto bvh = TriangleBVH::getOrCreate(*triIntersector.vertices, nullptr, firstVertex, vertexCount, minimumTrianglesForBVH))
+            {
+                bvh->intersect(ls.start, ls.end, [&](uint32_t i0, uint32_t i1, uint32_t i2) { triIntersector.intersect(i0, i1, i2); });
+                continue;
+            }
+        }
+
         uint32_t endVertex = int((firstVertex + vertexCount) / 3.0f) * 3;
 
         for (uint32_t i = firstVertex; i < endVertex; i += 3)
@@ -286,6 +305,16 @@ bool LineSegmentIntersector::intersectDrawIndexed(uint32_t firstIndex, uint32_t
 
         triIntersector.instanceIndex = instanceIndex;
 
+        if (useTriangleBVH && triIntersector.vertices == arrayState.vertices)
+        {
+            const Data* indices = ushort_indices ? static_cast<const Data*>(ushort_indices.get()) : static_cast<const Data*>(uint_indices.get());
+            if (auto bvh = indices ? TriangleBVH::getOrCreate(*triIntersector.vertices, indices, firstIndex, indexCount, minimumTrianglesForBVH) : ref_ptr<const TriangleBVH>())
+            {
+                bvh->intersect(ls.start, ls.end, [&](uint32_t i0, uint32_t i1, uint32_t i2) { triIntersector.intersect(i0, i1, i2); });
+                continue;
+            }
+        }
+
         uint32_t endIndex = int((firstIndex + indexCount) / 3.0f) * 3;
 
         if (ushort_indices)
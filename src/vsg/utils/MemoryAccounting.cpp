@@ -0,0 +1,313 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/BindIndexBuffer.h>
+#include <vsg/commands/BindVertexBuffers.h>
+#include <vsg/core/Allocator.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/nodes/PagedLOD.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/VertexDraw.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/DescriptorBuffer.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/utils/MemoryAccounting.h>
+#include <vsg/vk/MemoryBudget.h>
+
+#include <algorithm>
+#include <iomanip>
+
+using namespace vsg;
+
+namespace
+{
+    void addGpuMemory(const DeviceMemory* deviceMemory, VkDeviceSize size, MemoryAccounting::Usage& usage)
+    {
+        if ((deviceMemory->getMemoryPropertyFlags() & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0)
+            usage.deviceLocalMemory += size;
+        else
+            usage.hostMemory += size;
+    }
+
+    struct MB
+    {
+        double size;
+        explicit MB(VkDeviceSize in_size) :
+            size(static_cast<double>(in_size) / (1024.0 * 1024.0)) {}
+    };
+
+    std::ostream& operator<<(std::ostream& out, const MB& mb)
+    {
+        return out << std::fixed << std::setprecision(2) << mb.size << "MB";
+    }
+} // namespace
+
+MemoryAccounting::Usage& MemoryAccounting::Usage::operator+=(const Usage& rhs)
+{
+    objects += rhs.objects;
+    objectMemory += rhs.objectMemory;
+    dataMemory += rhs.dataMemory;
+    deviceLocalMemory += rhs.deviceLocalMemory;
+    hostMemory += rhs.hostMemory;
+    return *this;
+}
+
+MemoryAccounting::MemoryAccounting(uint32_t in_deviceID) :
+    deviceID(in_deviceID)
+{
+}
+
+void MemoryAccounting::reset()
+{
+    total = {};
+    subgraphs.clear();
+    _counted.clear();
+    _activeSubgraphs.clear();
+    _depth = 0;
+    _pagedLODChild = nullptr;
+}
+
+bool MemoryAccounting::_count(const Object& object)
+{
+    if (!_counted.insert(&object).second) return false;
+
+    Usage usage;
+    usage.objects = 1;
+    usage.objectMemory = object.sizeofObject();
+    _add(usage);
+    return true;
+}
+
+void MemoryAccounting::_add(const Usage& usage)
+{
+    total += usage;
+    for (auto& subgraph : _activeSubgraphs) *subgraph += usage;
+}
+
+bool MemoryAccounting::_push(const Node& node)
+{
+    bool subgraph = (_depth == 1) || (&node == _pagedLODChild);
+    ++_depth;
+
+    if (!subgraph) return false;
+
+    // the Node itself has already been counted against the enclosing subgraphs, so add it to its own subgraph before making it active
+    auto& usage = subgraphs[&node];
+    usage.objects += 1;
+    usage.objectMemory += node.sizeofObject();
+    _activeSubgraphs.push_back(&usage);
+    return true;
+}
+
+void MemoryAccounting::_pop(bool subgraph)
+{
+    --_depth;
+    if (subgraph) _activeSubgraphs.pop_back();
+}
+
+void MemoryAccounting::apply(const Object& object)
+{
+    if (_count(object)) object.traverse(*this);
+}
+
+void MemoryAccounting::apply(const Data& data)
+{
+    if (!_count(data)) return;
+
+    Usage usage;
+    usage.dataMemory = data.dataSize();
+    _add(usage);
+}
+
+void MemoryAccounting::apply(const Node& node)
+{
+    if (!_count(node)) return;
+
+    bool subgraph = _push(node);
+    node.traverse(*this);
+    _pop(subgraph);
+}
+
+void MemoryAccounting::apply(const PagedLOD& plod)
+{
+    if (!_count(plod)) return;
+
+    bool subgraph = _push(plod);
+    for (auto& child : plod.children)
+    {
+        if (!child.node) continue;
+
+        // a loaded high resolution child is reported as its own subgraph so the memory of individual tiles can be seen
+        if (&child == &plod.children[0]) _pagedLODChild = child.node.get();
+        child.node->accept(*this);
+        _pagedLODChild = nullptr;
+    }
+    _pop(subgraph);
+}
+
+void MemoryAccounting::apply(const StateGroup& stateGroup)
+{
+    if (!_count(stateGroup)) return;
+
+    bool subgraph = _push(stateGroup);
+    for (auto& stateCommand : stateGroup.stateCommands)
+    {
+        stateCommand->accept(*this);
+    }
+    stateGroup.traverse(*this);
+    _pop(subgraph);
+}
+
+void MemoryAccounting::apply(const Geometry& geometry)
+{
+    if (!_count(geometry)) return;
+
+    bool subgraph = _push(geometry);
+    for (auto& bufferInfo : geometry.arrays) bufferInfo->accept(*this);
+    if (geometry.indices) geometry.indices->accept(*this);
+    for (auto& command : geometry.commands) command->accept(*this);
+    _pop(subgraph);
+}
+
+void MemoryAccounting::apply(const VertexDraw& vd)
+{
+    if (!_count(vd)) return;
+
+    bool subgraph = _push(vd);
+    for (auto& bufferInfo : vd.arrays) bufferInfo->accept(*this);
+    _pop(subgraph);
+}
+
+void MemoryAccounting::apply(const VertexIndexDraw& vid)
+{
+    if (!_count(vid)) return;
+
+    bool subgraph = _push(vid);
+    for (auto& bufferInfo : vid.arrays) bufferInfo->accept(*this);
+    if (vid.indices) vid.indices->accept(*this);
+    _pop(subgraph);
+}
+
+void MemoryAccounting::apply(const BindVertexBuffers& bvb)
+{
+    if (!_count(bvb)) return;
+
+    for (auto& bufferInfo : bvb.arrays) bufferInfo->accept(*this);
+}
+
+void MemoryAccounting::apply(const BindIndexBuffer& bib)
+{
+    if (!_count(bib)) return;
+
+    if (bib.indices) bib.indices->accept(*this);
+}
+
+void MemoryAccounting::apply(const DescriptorBuffer& db)
+{
+    if (!_count(db)) return;
+
+    for (auto& bufferInfo : db.bufferInfoList) bufferInfo->accept(*this);
+}
+
+void MemoryAccounting::apply(const DescriptorImage& di)
+{
+    if (!_count(di)) return;
+
+    for (auto& imageInfo : di.imageInfoList) _imageInfo(*imageInfo);
+}
+
+void MemoryAccounting::apply(const BufferInfo& bufferInfo)
+{
+    if (!_count(bufferInfo)) return;
+
+    if (bufferInfo.data) bufferInfo.data->accept(*this);
+
+    if (bufferInfo.buffer)
+    {
+        _count(*bufferInfo.buffer);
+
+        // Buffers are often shared between BufferInfo so only the range used by each BufferInfo is attributed to it
+        if (auto deviceMemory = bufferInfo.buffer->getDeviceMemory(deviceID))
+        {
+            Usage usage;
+            addGpuMemory(deviceMemory, bufferInfo.range, usage);
+            _add(usage);
+        }
+    }
+}
+
+void MemoryAccounting::_imageInfo(const ImageInfo& imageInfo)
+{
+    if (!_count(imageInfo)) return;
+
+    if (imageInfo.sampler) imageInfo.sampler->accept(*this);
+    if (imageInfo.imageView && _count(*imageInfo.imageView) && imageInfo.imageView->image) _image(*imageInfo.imageView->image);
+}
+
+void MemoryAccounting::_image(const Image& image)
+{
+    if (!_count(image)) return;
+
+    if (image.data) image.data->accept(*this);
+
+    if (auto deviceMemory = image.getDeviceMemory(deviceID))
+    {
+        Usage usage;
+        addGpuMemory(deviceMemory, image.getMemoryRequirements(deviceID).size, usage);
+        _add(usage);
+    }
+}
+
+void MemoryAccounting::report(std::ostream& out, size_t maxSubgraphs) const
+{
+    auto print = [&](const Usage& usage) {
+        out << "objects = " << usage.objects << ", objectMemory = " << MB(usage.objectMemory) << ", dataMemory = " << MB(usage.dataMemory)
+            << ", deviceLocalMemory = " << MB(usage.deviceLocalMemory) << ", hostMemory = " << MB(usage.hostMemory) << std::endl;
+    };
+
+    out << "MemoryAccounting::report()" << std::endl;
+    out << "  total : ";
+    print(total);
+
+    std::vector<std::pair<const Node*, const Usage*>> sorted;
+    sorted.reserve(subgraphs.size());
+    for (auto& [node, usage] : subgraphs) sorted.emplace_back(node, &usage);
+    std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+        return (lhs.second->cpuMemory() + lhs.second->gpuMemory()) > (rhs.second->cpuMemory() + rhs.second->gpuMemory());
+    });
+
+    out << "  subgraphs : " << subgraphs.size() << std::endl;
+    for (size_t i = 0; i < sorted.size() && i < maxSubgraphs; ++i)
+    {
+        auto& [node, usage] = sorted[i];
+        out << "    " << node->className() << " " << node << " : ";
+        print(*usage);
+    }
+
+    if (auto& allocator = Allocator::instance())
+    {
+        out << "  Allocator : totalMemorySize = " << MB(allocator->totalMemorySize()) << ", totalReservedSize = " << MB(allocator->totalReservedSize()) << std::endl;
+    }
+
+    for (auto& pools : memoryBufferPools)
+    {
+        out << "  MemoryBufferPools " << pools->name << " : memory reserved = " << MB(pools->computeMemoryTotalReserved()) << ", available = " << MB(pools->computeMemoryTotalAvailable())
+            << ", buffer reserved = " << MB(pools->computeBufferTotalReserved()) << ", available = " << MB(pools->computeBufferTotalAvailable()) << std::endl;
+    }
+
+    if (device)
+    {
+        auto memoryBudget = MemoryBudget::create(device);
+        memoryBudget->update();
+        memoryBudget->report(out);
+    }
+}
@@ -0,0 +1,360 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/DrawIndexedIndirect.h>
+#include <vsg/commands/DrawIndexedIndirectCommand.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/state/VertexInputState.h>
+#include <vsg/utils/ComputeBounds.h>
+#include <vsg/utils/MergeGeometry.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+using namespace vsg;
+
+namespace
+{
+    bool readIndices(const Data* data, std::vector<uint32_t>& indices)
+    {
+        if (!data || !data->dataAvailable() || data->stride() != data->valueSize()) return false;
+
+        auto copy = [&](auto array) {
+            indices.assign(array->begin(), array->end());
+            return true;
+        };
+
+        if (auto us = data->cast<ushortArray>()) return copy(us);
+        if (auto ui = data->cast<uintArray>()) return copy(ui);
+        if (auto ub = data->cast<ubyteArray>()) return copy(ub);
+        return false;
+    }
+
+    uint32_t spreadBits(uint32_t v)
+    {
+        v &= 0x3ff;
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+
+    /// 30 bit Morton code of position within bounds, used to order draws so that each batch covers a compact region
+    uint32_t mortonCode(const dvec3& position, const dbox& bounds)
+    {
+        dvec3 extents = bounds.max - bounds.min;
+        auto quantize = [](double v, double minimum, double extent) {
+            return extent > 0.0 ? static_cast<uint32_t>(std::clamp((v - minimum) / extent, 0.0, 1.0) * 1023.0) : 0u;
+        };
+        return spreadBits(quantize(position.x, bounds.min.x, extents.x)) |
+               (spreadBits(quantize(position.y, bounds.min.y, extents.y)) << 1) |
+               (spreadBits(quantize(position.z, bounds.min.z, extents.z)) << 2);
+    }
+
+    template<class T>
+    ref_ptr<Data> createIndices(const std::vector<uint32_t>& indices)
+    {
+        auto array = T::create(static_cast<uint32_t>(indices.size()));
+        std::transform(indices.begin(), indices.end(), array->begin(), [](uint32_t index) { return static_cast<typename T::value_type>(index); });
+        return array;
+    }
+} // namespace
+
+MergeGeometry::MergeGeometry()
+{
+}
+
+void MergeGeometry::apply(Node& node)
+{
+    node.traverse(*this);
+}
+
+void MergeGeometry::apply(Group& group)
+{
+    if (!_visited.insert(&group).second) return;
+
+    group.traverse(*this);
+    _mergeChildren(group);
+}
+
+void MergeGeometry::apply(StateGroup& stateGroup)
+{
+    auto previousPipeline = _currentPipeline;
+
+    for (auto& stateCommand : stateGroup.stateCommands)
+    {
+        stateCommand->accept(*this);
+    }
+
+    apply(static_cast<Group&>(stateGroup));
+
+    _currentPipeline = previousPipeline;
+}
+
+void MergeGeometry::apply(BindGraphicsPipeline& bindPipeline)
+{
+    _currentPipeline = bindPipeline.pipeline.get();
+}
+
+bool MergeGeometry::_member(Node* node, Member& member) const
+{
+    const GraphicsPipeline* pipeline = _currentPipeline;
+
+    auto key = [&](auto value) { member.key.push_back(static_cast<uintptr_t>(value)); };
+    auto keyPointer = [&](const void* ptr) { member.key.push_back(reinterpret_cast<uintptr_t>(ptr)); };
+
+    // single child StateGroups above the draw are replicated above the merged draw so their state must match
+    while (auto stateGroup = node->cast<StateGroup>())
+    {
+        if (stateGroup->children.size() != 1 || stateGroup->prototypeArrayState) return false;
+
+        member.chain.push_back(stateGroup);
+        key(stateGroup->stateCommands.size());
+        for (auto& stateCommand : stateGroup->stateCommands)
+        {
+            keyPointer(stateCommand.get());
+            if (auto bindPipeline = stateCommand.cast<BindGraphicsPipeline>()) pipeline = bindPipeline->pipeline.get();
+        }
+        node = stateGroup->children.front();
+    }
+
+    auto vid = node->cast<VertexIndexDraw>();
+    if (!vid || vid->instanceCount != 1 || vid->firstInstance != 0 || !vid->indices || !pipeline) return false;
+
+    const VertexInputState* vertexInputState = nullptr;
+    for (auto& state : pipeline->pipelineStates)
+    {
+        if (auto vis = state.cast<VertexInputState>()) vertexInputState = vis;
+    }
+    if (!vertexInputState) return false;
+
+    keyPointer(pipeline);
+    key(vid->firstBinding);
+    key(vid->arrays.size());
+
+    member.draw = vid;
+    member.perVertex.resize(vid->arrays.size(), false);
+    member.numVertices = 0;
+
+    for (size_t i = 0; i < vid->arrays.size(); ++i)
+    {
+        auto& data = vid->arrays[i]->data;
+        if (!data || !data->dataAvailable()) return false;
+
+        auto binding = std::find_if(vertexInputState->vertexBindingDescriptions.begin(), vertexInputState->vertexBindingDescriptions.end(), [&](auto& b) { return b.binding == vid->firstBinding + i; });
+        if (binding == vertexInputState->vertexBindingDescriptions.end()) return false;
+
+        if (binding->inputRate == VK_VERTEX_INPUT_RATE_INSTANCE)
+        {
+            // per instance data can only be shared, not merged
+            keyPointer(data.get());
+            continue;
+        }
+
+        if (data->stride() != data->valueSize() || binding->stride == 0 || data->dataSize() % binding->stride != 0 || !createArrayLike(*data, 1)) return false;
+
+        auto numVertices = static_cast<uint32_t>(data->dataSize() / binding->stride);
+        if (member.numVertices != 0 && numVertices != member.numVertices) return false;
+
+        member.numVertices = numVertices;
+        member.perVertex[i] = true;
+        keyPointer(&data->type_info());
+        key(data->properties.format);
+        key(binding->stride);
+    }
+
+    if (member.numVertices == 0 || member.numVertices > maximumDrawVertices) return false;
+
+    std::vector<uint32_t> indices;
+    if (!readIndices(vid->indices->data, indices) || vid->firstIndex + vid->indexCount > indices.size()) return false;
+
+    member.indices.assign(indices.begin() + vid->firstIndex, indices.begin() + vid->firstIndex + vid->indexCount);
+    for (auto& index : member.indices)
+    {
+        index += vid->vertexOffset;
+        if (index >= member.numVertices) return false;
+    }
+
+    ComputeBounds computeBounds;
+    vid->accept(computeBounds);
+    if (!computeBounds.bounds.valid()) return false;
+    member.bounds = computeBounds.bounds;
+
+    return true;
+}
+
+ref_ptr<Node> MergeGeometry::_merge(const std::vector<Member*>& batch) const
+{
+    auto& first = *batch.front();
+    auto& arrays = first.draw->arrays;
+
+    uint32_t numVertices = 0;
+    uint32_t numIndices = 0;
+    for (auto member : batch)
+    {
+        numVertices += member->numVertices;
+        numIndices += static_cast<uint32_t>(member->indices.size());
+    }
+
+    DataList mergedArrays;
+    for (size_t i = 0; i < arrays.size(); ++i)
+    {
+        auto& data = arrays[i]->data;
+        if (!first.perVertex[i])
+        {
+            mergedArrays.push_back(data);
+            continue;
+        }
+
+        size_t bytesPerVertex = data->dataSize() / first.numVertices;
+        auto merged = createArrayLike(*data, static_cast<uint32_t>((numVertices * bytesPerVertex) / data->valueSize()));
+
+        auto dest = static_cast<uint8_t*>(merged->dataPointer());
+        for (auto member : batch)
+        {
+            auto& memberData = member->draw->arrays[i]->data;
+            std::memcpy(dest, memberData->dataPointer(), memberData->dataSize());
+            dest += memberData->dataSize();
+        }
+        mergedArrays.push_back(merged);
+    }
+
+    // in the direct case the indices are rebased on to the merged vertex arrays, the indirect commands instead provide a vertexOffset for each draw
+    std::vector<uint32_t> indices;
+    indices.reserve(numIndices);
+    auto drawCommands = DrawIndexedIndirectCommandArray::create(static_cast<uint32_t>(batch.size()));
+    uint32_t baseVertex = 0;
+    uint32_t maximumIndex = 0;
+    dbox bounds;
+    for (size_t m = 0; m < batch.size(); ++m)
+    {
+        auto& member = *batch[m];
+        drawCommands->set(m, DrawIndexedIndirectCommand{static_cast<uint32_t>(member.indices.size()), 1, static_cast<uint32_t>(indices.size()), static_cast<int32_t>(baseVertex), 0});
+
+        for (auto index : member.indices)
+        {
+            uint32_t value = useIndirect ? index : index + baseVertex;
+            maximumIndex = std::max(maximumIndex, value);
+            indices.push_back(value);
+        }
+
+        baseVertex += member.numVertices;
+        bounds.add(member.bounds);
+    }
+
+    auto mergedIndices = (maximumIndex < 65536) ? createIndices<ushortArray>(indices) : createIndices<uintArray>(indices);
+
+    ref_ptr<Node> draw;
+    if (useIndirect)
+    {
+        auto geometry = Geometry::create();
+        geometry->firstBinding = first.draw->firstBinding;
+        geometry->assignArrays(mergedArrays);
+        geometry->assignIndices(mergedIndices);
+        geometry->commands.push_back(DrawIndexedIndirect::create(drawCommands, static_cast<uint32_t>(batch.size()), static_cast<uint32_t>(sizeof(DrawIndexedIndirectCommand))));
+        draw = geometry;
+    }
+    else
+    {
+        auto vid = VertexIndexDraw::create();
+        vid->firstBinding = first.draw->firstBinding;
+        vid->assignArrays(mergedArrays);
+        vid->assignIndices(mergedIndices);
+        vid->indexCount = numIndices;
+        vid->instanceCount = 1;
+        draw = vid;
+    }
+
+    // replicate the StateGroup chain, sharing the original StateCommands
+    ref_ptr<Node> node = draw;
+    for (auto itr = first.chain.rbegin(); itr != first.chain.rend(); ++itr)
+    {
+        auto stateGroup = StateGroup::create();
+        stateGroup->stateCommands = (*itr)->stateCommands;
+        stateGroup->addChild(node);
+        node = stateGroup;
+    }
+
+    dvec3 center = (bounds.min + bounds.max) * 0.5;
+    return CullNode::create(dsphere(center, length(bounds.max - center)), node);
+}
+
+void MergeGeometry::_mergeChildren(Group& group)
+{
+    if (group.children.size() < 2) return;
+
+    std::vector<Member> members;
+    for (size_t i = 0; i < group.children.size(); ++i)
+    {
+        Member member;
+        member.childIndex = i;
+        if (_member(group.children[i], member)) members.push_back(std::move(member));
+    }
+    if (members.size() < 2) return;
+
+    std::map<std::vector<uintptr_t>, std::vector<Member*>> compatible;
+    for (auto& member : members) compatible[member.key].push_back(&member);
+
+    std::vector<ref_ptr<Node>> replacements(group.children.size());
+    std::vector<bool> removed(group.children.size(), false);
+
+    for (auto& [key, candidates] : compatible)
+    {
+        if (candidates.size() < 2) continue;
+
+        dbox bounds;
+        for (auto member : candidates) bounds.add(member->bounds);
+
+        std::vector<std::pair<uint32_t, Member*>> ordered;
+        for (auto member : candidates) ordered.emplace_back(mortonCode((member->bounds.min + member->bounds.max) * 0.5, bounds), member);
+        std::sort(ordered.begin(), ordered.end(), [](auto& lhs, auto& rhs) { return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second->childIndex < rhs.second->childIndex); });
+
+        auto flush = [&](std::vector<Member*>& batch) {
+            if (batch.size() >= 2)
+            {
+                // the merged draw takes the place of the first of the draws in the children list to preserve draw order as far as possible
+                size_t position = std::min_element(batch.begin(), batch.end(), [](auto lhs, auto rhs) { return lhs->childIndex < rhs->childIndex; })[0]->childIndex;
+                replacements[position] = _merge(batch);
+                for (auto member : batch) removed[member->childIndex] = true;
+
+                ++numBatches;
+                numDrawsMerged += static_cast<uint32_t>(batch.size());
+            }
+            batch.clear();
+        };
+
+        std::vector<Member*> batch;
+        uint32_t batchVertices = 0;
+        for (auto& [code, member] : ordered)
+        {
+            if (!batch.empty() && batchVertices + member->numVertices > maximumBatchVertices)
+            {
+                flush(batch);
+                batchVertices = 0;
+            }
+            batch.push_back(member);
+            batchVertices += member->numVertices;
+        }
+        flush(batch);
+    }
+
+    Group::Children children;
+    for (size_t i = 0; i < group.children.size(); ++i)
+    {
+        if (replacements[i]) children.push_back(replacements[i]);
+        if (!removed[i]) children.push_back(group.children[i]);
+    }
+    group.children.swap(children);
+}
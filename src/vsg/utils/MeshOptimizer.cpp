@@ -0,0 +1,729 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/commands/Commands.h>
+#include <vsg/commands/DrawIndexed.h>
+#include <vsg/io/Logger.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/ImageInfo.h>
+#include <vsg/state/InputAssemblyState.h>
+#include <vsg/utils/MeshOptimizer.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace vsg;
+
+namespace
+{
+    bool contiguous(const Data* data)
+    {
+        return data && data->dataAvailable() && data->stride() == data->valueSize() && data->properties.dataVariance < DYNAMIC_DATA;
+    }
+
+    bool readIndices(const Data* data, std::vector<uint32_t>& indices)
+    {
+        if (!contiguous(data)) return false;
+
+        auto copy = [&](auto array) {
+            indices.assign(array->begin(), array->end());
+            return true;
+        };
+
+        if (auto us = data->cast<ushortArray>()) return copy(us);
+        if (auto ui = data->cast<uintArray>()) return copy(ui);
+        if (auto ub = data->cast<ubyteArray>()) return copy(ub);
+        return false;
+    }
+
+    void writeIndices(Data* data, const std::vector<uint32_t>& indices)
+    {
+        auto copy = [&](auto array) {
+            using value_type = typename std::remove_pointer_t<decltype(array)>::value_type;
+            auto itr = array->begin();
+            for (auto index : indices) *(itr++) = static_cast<value_type>(index);
+        };
+
+        if (auto us = data->cast<ushortArray>())
+            copy(us);
+        else if (auto ui = data->cast<uintArray>())
+            copy(ui);
+        else if (auto ub = data->cast<ubyteArray>())
+            copy(ub);
+
+        data->dirty();
+    }
+
+    /// count the vertices transformed by a FIFO post transform vertex cache
+    uint64_t countCacheMisses(const uint32_t* indices, size_t count, uint32_t numVertices, uint32_t cacheSize)
+    {
+        // a vertex is in the cache if fewer than cacheSize vertices have been added to the cache since it was
+        std::vector<uint64_t> timestamps(numVertices, 0);
+        uint64_t time = cacheSize + 1;
+        uint64_t misses = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto& timestamp = timestamps[indices[i]];
+            if (time - timestamp > cacheSize)
+            {
+                timestamp = time++;
+                ++misses;
+            }
+        }
+        return misses;
+    }
+
+    /// reorder the triangles for a post transform vertex cache of cacheSize entries using Tipsify,
+    /// "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", Sander, Nehab and Barczak, 2007.
+    void tipsify(uint32_t* indices, size_t count, uint32_t numVertices, uint32_t cacheSize)
+    {
+        size_t numTriangles = count / 3;
+        if (numTriangles < 2) return;
+
+        // vertex to triangle adjacency
+        std::vector<uint32_t> offsets(numVertices + 1, 0);
+        for (size_t i = 0; i < numTriangles * 3; ++i) ++offsets[indices[i] + 1];
+        for (uint32_t v = 0; v < numVertices; ++v) offsets[v + 1] += offsets[v];
+
+        std::vector<uint32_t> adjacency(numTriangles * 3);
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < numTriangles * 3; ++i) adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+        std::vector<uint32_t> liveTriangles(numVertices);
+        for (uint32_t v = 0; v < numVertices; ++v) liveTriangles[v] = offsets[v + 1] - offsets[v];
+
+        std::vector<uint64_t> timestamps(numVertices, 0);
+        std::vector<bool> emitted(numTriangles, false);
+        std::vector<uint32_t> deadEnds;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> output;
+        output.reserve(numTriangles * 3);
+
+        int64_t time = cacheSize + 1;
+        uint32_t cursor = 0;
+        int64_t fanning = indices[0];
+        while (fanning >= 0)
+        {
+            // emit all the remaining triangles of the fanning vertex
+            candidates.clear();
+            for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; ++a)
+            {
+                uint32_t t = adjacency[a];
+                if (emitted[t]) continue;
+
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    uint32_t v = indices[t * 3 + k];
+                    output.push_back(v);
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    --liveTriangles[v];
+                    if (time - static_cast<int64_t>(timestamps[v]) > static_cast<int64_t>(cacheSize)) timestamps[v] = time++;
+                }
+                emitted[t] = true;
+            }
+
+            // choose the next fanning vertex, preferring candidates that will still be in the cache once all their triangles have been emitted
+            int64_t next = -1;
+            int64_t bestPriority = -1;
+            for (auto v : candidates)
+            {
+                if (liveTriangles[v] == 0) continue;
+
+                int64_t priority = 0;
+                int64_t age = time - static_cast<int64_t>(timestamps[v]);
+                if (age + 2 * static_cast<int64_t>(liveTriangles[v]) <= static_cast<int64_t>(cacheSize)) priority = age;
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+
+            // at a dead end so use the most recently referenced vertex with remaining triangles, or failing that the next in input order
+            while (next < 0 && !deadEnds.empty())
+            {
+                uint32_t v = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangles[v] > 0) next = v;
+            }
+
+            for (; next < 0 && cursor < numVertices; ++cursor)
+            {
+                if (liveTriangles[cursor] > 0) next = cursor;
+            }
+
+            fanning = next;
+        }
+
+        std::copy(output.begin(), output.end(), indices);
+    }
+
+    /// reorder the elements of a contiguous array in place so element v moves to remap[v]
+    void permute(Data* data, const std::vector<uint32_t>& remap)
+    {
+        size_t valueSize = data->valueSize();
+        auto ptr = static_cast<uint8_t*>(data->dataPointer());
+        std::vector<uint8_t> original(ptr, ptr + valueSize * remap.size());
+        for (size_t v = 0; v < remap.size(); ++v)
+        {
+            std::memcpy(ptr + remap[v] * valueSize, original.data() + v * valueSize, valueSize);
+        }
+        data->dirty();
+    }
+
+    const VkVertexInputBindingDescription* findBinding(const VertexInputState* vertexInputState, uint32_t binding)
+    {
+        if (!vertexInputState) return nullptr;
+        for (auto& description : vertexInputState->vertexBindingDescriptions)
+        {
+            if (description.binding == binding) return &description;
+        }
+        return nullptr;
+    }
+
+    ref_ptr<Data> quantizeNormalArray(const vec3Array& normals)
+    {
+        auto quantized = bvec4Array::create(static_cast<uint32_t>(normals.size()));
+        quantized->properties.format = VK_FORMAT_R8G8B8A8_SNORM;
+
+        auto itr = quantized->begin();
+        for (auto normal : normals)
+        {
+            if (float len = length(normal); len > 0.0f) normal /= len;
+            auto snorm = [](float value) { return static_cast<int8_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 127.0f)); };
+            *(itr++) = bvec4(snorm(normal.x), snorm(normal.y), snorm(normal.z), 0);
+        }
+        return quantized;
+    }
+
+    ref_ptr<Data> quantizeTexCoordArray(const vec2Array& texCoords)
+    {
+        auto quantized = usvec2Array::create(static_cast<uint32_t>(texCoords.size()));
+        quantized->properties.format = VK_FORMAT_R16G16_UNORM;
+
+        auto itr = quantized->begin();
+        for (auto& tc : texCoords)
+        {
+            auto unorm = [](float value) { return static_cast<uint16_t>(std::round(std::clamp(value, 0.0f, 1.0f) * 65535.0f)); };
+            *(itr++) = usvec2(unorm(tc.x), unorm(tc.y));
+        }
+        return quantized;
+    }
+
+    bool unitRange(const vec2Array& texCoords)
+    {
+        for (auto& tc : texCoords)
+        {
+            if (tc.x < 0.0f || tc.x > 1.0f || tc.y < 0.0f || tc.y > 1.0f) return false;
+        }
+        return true;
+    }
+} // namespace
+
+MeshOptimizer::MeshOptimizer()
+{
+}
+
+void MeshOptimizer::apply(Node& node)
+{
+    node.traverse(*this);
+}
+
+void MeshOptimizer::apply(StateGroup& stateGroup)
+{
+    auto previousPipeline = _currentPipeline;
+
+    for (auto& stateCommand : stateGroup.stateCommands)
+    {
+        stateCommand->accept(*this);
+    }
+
+    stateGroup.traverse(*this);
+
+    _currentPipeline = previousPipeline;
+}
+
+void MeshOptimizer::apply(Commands& commands)
+{
+    auto previousPipeline = _currentPipeline;
+
+    commands.traverse(*this);
+
+    _currentPipeline = previousPipeline;
+}
+
+void MeshOptimizer::apply(BindGraphicsPipeline& bindPipeline)
+{
+    _currentPipeline = bindPipeline.pipeline.get();
+}
+
+void MeshOptimizer::apply(VertexIndexDraw& vid)
+{
+    Draw draw;
+    draw.command = &vid;
+    draw.firstBinding = vid.firstBinding;
+    for (auto& bufferInfo : vid.arrays)
+    {
+        draw.arrays.push_back(bufferInfo ? bufferInfo->data : ref_ptr<Data>());
+    }
+    if (vid.indices && !vid.indices->buffer) draw.indices = vid.indices->data;
+    draw.ranges.emplace_back(vid.firstIndex, vid.indexCount);
+    draw.reorderable = vid.vertexOffset == 0;
+
+    _addDraw(std::move(draw));
+}
+
+void MeshOptimizer::apply(Geometry& geometry)
+{
+    Draw draw;
+    draw.command = &geometry;
+    draw.firstBinding = geometry.firstBinding;
+    for (auto& bufferInfo : geometry.arrays)
+    {
+        draw.arrays.push_back(bufferInfo ? bufferInfo->data : ref_ptr<Data>());
+    }
+    if (geometry.indices && !geometry.indices->buffer) draw.indices = geometry.indices->data;
+
+    for (auto& command : geometry.commands)
+    {
+        // non indexed or indirect draws depend on the vertex order so disable reordering
+        auto drawIndexed = command.cast<DrawIndexed>();
+        if (drawIndexed && drawIndexed->vertexOffset == 0)
+            draw.ranges.emplace_back(drawIndexed->firstIndex, drawIndexed->indexCount);
+        else
+            draw.reorderable = false;
+    }
+
+    _addDraw(std::move(draw));
+}
+
+void MeshOptimizer::_addDraw(Draw&& draw)
+{
+    // only handle draws with data that hasn't been compiled, or already assigned to shared buffers
+    if (draw.arrays.empty() || !draw.indices) return;
+
+    auto command = draw.command.get();
+    auto& bufferInfos = command->is_compatible(typeid(VertexIndexDraw)) ? static_cast<VertexIndexDraw*>(command)->arrays : static_cast<Geometry*>(command)->arrays;
+    for (auto& bufferInfo : bufferInfos)
+    {
+        if (!bufferInfo || bufferInfo->buffer || !bufferInfo->data) return;
+    }
+
+    ++statistics.numDraws;
+    _draws[ref_ptr<GraphicsPipeline>(_currentPipeline)].push_back(std::move(draw));
+}
+
+void MeshOptimizer::_assignArrays(Draw& draw, const DataList& arrays)
+{
+    draw.arrays = arrays;
+    if (auto vid = draw.command.cast<VertexIndexDraw>())
+        vid->assignArrays(arrays);
+    else if (auto geometry = draw.command.cast<Geometry>())
+        geometry->assignArrays(arrays);
+}
+
+void MeshOptimizer::_reorder(Draw& draw, const VertexInputState* vertexInputState, bool triangles)
+{
+    std::vector<uint32_t> indices;
+    if (!readIndices(draw.indices, indices)) return;
+
+    uint32_t numVertices = 0;
+    for (auto index : indices) numVertices = std::max(numVertices, index + 1);
+
+    // ranges must be within the index array and not overlap
+    auto ranges = draw.ranges;
+    std::sort(ranges.begin(), ranges.end());
+    uint32_t end = 0;
+    for (auto& [first, count] : ranges)
+    {
+        if (first < end || first + count > indices.size()) return;
+        end = first + count;
+    }
+
+    bool modified = false;
+    for (auto& [first, count] : ranges)
+    {
+        uint32_t numTriangleIndices = triangles ? (count / 3) * 3 : 0;
+        if (numTriangleIndices == 0) continue;
+
+        statistics.numTriangles += numTriangleIndices / 3;
+        statistics.vertexCacheMissesBefore += countCacheMisses(indices.data() + first, numTriangleIndices, numVertices, vertexCacheSize);
+
+        if (optimizeVertexCache && draw.reorderable)
+        {
+            tipsify(indices.data() + first, numTriangleIndices, numVertices, vertexCacheSize);
+            modified = true;
+        }
+
+        statistics.vertexCacheMissesAfter += countCacheMisses(indices.data() + first, numTriangleIndices, numVertices, vertexCacheSize);
+    }
+
+    // vertex reordering requires knowing which arrays are per vertex so they can all be permuted together
+    bool reorderVertices = optimizeVertexFetch && draw.reorderable && vertexInputState;
+    DataList perVertexArrays;
+    for (size_t i = 0; reorderVertices && i < draw.arrays.size(); ++i)
+    {
+        auto binding = findBinding(vertexInputState, draw.firstBinding + static_cast<uint32_t>(i));
+        auto& array = draw.arrays[i];
+        if (!binding || !contiguous(array))
+            reorderVertices = false;
+        else if (binding->inputRate == VK_VERTEX_INPUT_RATE_VERTEX)
+            perVertexArrays.push_back(array);
+    }
+
+    if (reorderVertices && !perVertexArrays.empty())
+    {
+        size_t numArrayVertices = perVertexArrays.front()->valueCount();
+        for (auto& array : perVertexArrays)
+        {
+            if (array->valueCount() != numArrayVertices || array->valueCount() < numVertices) reorderVertices = false;
+        }
+
+        if (reorderVertices)
+        {
+            // assign new vertex indices in the order they are first used, followed by any unreferenced vertices
+            std::vector<uint32_t> remap(numArrayVertices, std::numeric_limits<uint32_t>::max());
+            uint32_t next = 0;
+            for (auto& [first, count] : ranges)
+            {
+                for (uint32_t i = first; i < first + count; ++i)
+                {
+                    if (remap[indices[i]] == std::numeric_limits<uint32_t>::max()) remap[indices[i]] = next++;
+                }
+            }
+            for (auto& index : remap)
+            {
+                if (index == std::numeric_limits<uint32_t>::max()) index = next++;
+            }
+
+            for (auto& array : perVertexArrays) permute(array, remap);
+            for (auto& index : indices) index = remap[index];
+            modified = true;
+        }
+    }
+
+    if (modified)
+    {
+        writeIndices(draw.indices, indices);
+        ++statistics.numDrawsReordered;
+    }
+}
+
+bool MeshOptimizer::_repack(GraphicsPipeline& pipeline, Draws& draws)
+{
+    auto itr = std::find_if(pipeline.pipelineStates.begin(), pipeline.pipelineStates.end(), [](auto& state) { return state->template cast<VertexInputState>() != nullptr; });
+    if (itr == pipeline.pipelineStates.end()) return false;
+    auto vertexInputState = itr->template cast<VertexInputState>();
+
+    // all draws must bind all the pipeline's bindings, so that bindings can be renumbered
+    uint32_t firstBinding = draws.front().firstBinding;
+    size_t numArrays = draws.front().arrays.size();
+    for (auto& draw : draws)
+    {
+        if (draw.firstBinding != firstBinding || draw.arrays.size() != numArrays) return false;
+    }
+    if (vertexInputState->vertexBindingDescriptions.size() != numArrays) return false;
+
+    enum Conversion
+    {
+        NONE,
+        NORMAL,
+        TEXCOORD
+    };
+
+    struct Slot
+    {
+        VkVertexInputBindingDescription binding;
+        std::vector<VkVertexInputAttributeDescription> attributes;
+        Conversion conversion = NONE;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t size = 0;
+        bool interleave = false;
+        uint32_t offset = 0;
+    };
+
+    std::vector<Slot> slots(numArrays);
+    for (size_t i = 0; i < numArrays; ++i)
+    {
+        auto& slot = slots[i];
+        auto binding = findBinding(vertexInputState, firstBinding + static_cast<uint32_t>(i));
+        if (!binding) return false;
+
+        slot.binding = *binding;
+        for (auto& attribute : vertexInputState->vertexAttributeDescriptions)
+        {
+            if (attribute.binding == binding->binding) slot.attributes.push_back(attribute);
+        }
+
+        // only tightly packed, single attribute, per vertex bindings are converted
+        if (slot.attributes.size() != 1 || slot.attributes.front().offset != 0 || binding->inputRate != VK_VERTEX_INPUT_RATE_VERTEX) continue;
+
+        auto& attribute = slot.attributes.front();
+        slot.format = attribute.format;
+        slot.size = static_cast<uint32_t>(getFormatTraits(attribute.format, false).size);
+        if (slot.size == 0 || slot.size != binding->stride) continue;
+
+        bool suitable = true;
+        for (auto& draw : draws)
+        {
+            auto& array = draw.arrays[i];
+            if (!contiguous(array) || array->valueSize() != slot.size) suitable = false;
+        }
+        if (!suitable) continue;
+
+        if (quantizeNormals && normalLocations.count(attribute.location) && attribute.format == VK_FORMAT_R32G32B32_SFLOAT)
+        {
+            bool normals = std::all_of(draws.begin(), draws.end(), [&](auto& draw) { return draw.arrays[i]->template cast<vec3Array>() != nullptr; });
+            if (normals)
+            {
+                slot.conversion = NORMAL;
+                slot.format = VK_FORMAT_R8G8B8A8_SNORM;
+                slot.size = 4;
+            }
+        }
+        else if (quantizeTexCoords && texCoordLocations.count(attribute.location) && attribute.format == VK_FORMAT_R32G32_SFLOAT)
+        {
+            bool texCoords = std::all_of(draws.begin(), draws.end(), [&](auto& draw) {
+                auto array = draw.arrays[i]->template cast<vec2Array>();
+                return array && unitRange(*array);
+            });
+            if (texCoords)
+            {
+                slot.conversion = TEXCOORD;
+                slot.format = VK_FORMAT_R16G16_UNORM;
+                slot.size = 4;
+            }
+        }
+
+        slot.interleave = interleaveAttributes && positionLocations.count(attribute.location) == 0 && (slot.size % 4) == 0;
+    }
+
+    // interleaving is only possible when the arrays of each draw have the same number of vertices
+    auto interleaved = [&](Slot& slot) { return slot.interleave; };
+    if (std::count_if(slots.begin(), slots.end(), interleaved) < 2)
+    {
+        for (auto& slot : slots) slot.interleave = false;
+    }
+    for (auto& draw : draws)
+    {
+        size_t numVertices = 0;
+        for (size_t i = 0; i < numArrays; ++i)
+        {
+            if (!slots[i].interleave) continue;
+            if (numVertices == 0) numVertices = draw.arrays[i]->valueCount();
+            if (draw.arrays[i]->valueCount() != numVertices)
+            {
+                for (auto& slot : slots) slot.interleave = false;
+            }
+        }
+    }
+
+    bool interleave = std::any_of(slots.begin(), slots.end(), interleaved);
+    bool convert = std::any_of(slots.begin(), slots.end(), [](Slot& slot) { return slot.conversion != NONE; });
+    if (!interleave && !convert) return false;
+
+    // set up the new bindings, with the interleaved attributes placed at the binding of the first interleaved attribute
+    auto newVertexInputState = VertexInputState::create();
+    auto& bindings = newVertexInputState->vertexBindingDescriptions;
+    auto& attributes = newVertexInputState->vertexAttributeDescriptions;
+
+    int interleavedIndex = -1;
+    uint32_t interleavedStride = 0;
+    for (auto& slot : slots)
+    {
+        if (slot.interleave)
+        {
+            if (interleavedIndex < 0)
+            {
+                interleavedIndex = static_cast<int>(bindings.size());
+                bindings.push_back(VkVertexInputBindingDescription{firstBinding + static_cast<uint32_t>(bindings.size()), 0, VK_VERTEX_INPUT_RATE_VERTEX});
+            }
+
+            slot.offset = interleavedStride;
+            interleavedStride += slot.size;
+
+            auto attribute = slot.attributes.front();
+            attribute.binding = bindings[interleavedIndex].binding;
+            attribute.format = slot.format;
+            attribute.offset = slot.offset;
+            attributes.push_back(attribute);
+        }
+        else
+        {
+            auto binding = slot.binding;
+            binding.binding = firstBinding + static_cast<uint32_t>(bindings.size());
+            if (slot.conversion != NONE) binding.stride = slot.size;
+            bindings.push_back(binding);
+
+            for (auto attribute : slot.attributes)
+            {
+                attribute.binding = binding.binding;
+                if (slot.conversion != NONE) attribute.format = slot.format;
+                attributes.push_back(attribute);
+            }
+        }
+    }
+    if (interleavedIndex >= 0) bindings[interleavedIndex].stride = interleavedStride;
+
+    // convert the arrays, sharing the converted arrays between draws that shared the original arrays
+    std::map<const Data*, ref_ptr<Data>> convertedArrays;
+    std::map<std::vector<const Data*>, ref_ptr<Data>> interleavedArrays;
+
+    auto converted = [&](Slot& slot, ref_ptr<Data> array) -> ref_ptr<Data> {
+        if (slot.conversion == NONE) return array;
+
+        auto& result = convertedArrays[array.get()];
+        if (!result)
+        {
+            if (slot.conversion == NORMAL)
+                result = quantizeNormalArray(*array.cast<vec3Array>());
+            else
+                result = quantizeTexCoordArray(*array.cast<vec2Array>());
+        }
+        return result;
+    };
+
+    for (auto& draw : draws)
+    {
+        DataList arrays;
+        std::vector<const Data*> sources;
+        DataList interleavedSources;
+        for (size_t i = 0; i < numArrays; ++i)
+        {
+            auto& slot = slots[i];
+            if (slot.interleave)
+            {
+                if (sources.empty()) arrays.push_back({});
+                sources.push_back(draw.arrays[i].get());
+                interleavedSources.push_back(converted(slot, draw.arrays[i]));
+            }
+            else
+            {
+                arrays.push_back(converted(slot, draw.arrays[i]));
+            }
+        }
+
+        if (interleavedIndex >= 0)
+        {
+            auto& array = interleavedArrays[sources];
+            if (!array)
+            {
+                size_t numVertices = interleavedSources.front()->valueCount();
+                auto data = ubyteArray::create(static_cast<uint32_t>(numVertices * interleavedStride));
+                data->properties.stride = 1;
+                auto dest = static_cast<uint8_t*>(data->dataPointer());
+
+                size_t s = 0;
+                for (auto& slot : slots)
+                {
+                    if (!slot.interleave) continue;
+                    auto src = static_cast<const uint8_t*>(interleavedSources[s++]->dataPointer());
+                    for (size_t v = 0; v < numVertices; ++v)
+                    {
+                        std::memcpy(dest + v * interleavedStride + slot.offset, src + v * slot.size, slot.size);
+                    }
+                }
+                array = data;
+            }
+            arrays[interleavedIndex] = array;
+        }
+
+        _assignArrays(draw, arrays);
+    }
+
+    *itr = newVertexInputState;
+    return true;
+}
+
+void MeshOptimizer::optimize()
+{
+    // count the draws referencing each array so that shared arrays aren't reordered differently by each draw
+    std::map<const Data*, uint32_t> references;
+    for (auto& [pipeline, draws] : _draws)
+    {
+        for (auto& draw : draws)
+        {
+            for (auto& array : draw.arrays) ++references[array.get()];
+            ++references[draw.indices.get()];
+        }
+    }
+
+    for (auto& [data, count] : references)
+    {
+        statistics.vertexBytesBefore += data->dataSize();
+    }
+
+    for (auto& [pipeline, draws] : _draws)
+    {
+        const VertexInputState* vertexInputState = nullptr;
+        bool triangles = false;
+        if (pipeline)
+        {
+            triangles = true;
+            for (auto& state : pipeline->pipelineStates)
+            {
+                if (auto vis = state.cast<VertexInputState>()) vertexInputState = vis;
+                if (auto inputAssemblyState = state.cast<InputAssemblyState>()) triangles = inputAssemblyState->topology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            }
+        }
+
+        for (auto& draw : draws)
+        {
+            for (auto& array : draw.arrays)
+            {
+                if (references[array.get()] > 1) draw.reorderable = false;
+            }
+            if (references[draw.indices.get()] > 1) draw.reorderable = false;
+
+            _reorder(draw, vertexInputState, triangles);
+        }
+
+        if (pipeline && (quantizeNormals || quantizeTexCoords || interleaveAttributes) && _repack(*pipeline, draws))
+        {
+            ++statistics.numPipelinesRepacked;
+        }
+    }
+
+    std::set<const Data*> optimizedData;
+    for (auto& [pipeline, draws] : _draws)
+    {
+        for (auto& draw : draws)
+        {
+            for (auto& array : draw.arrays) optimizedData.insert(array.get());
+            optimizedData.insert(draw.indices.get());
+        }
+    }
+
+    for (auto& data : optimizedData)
+    {
+        statistics.vertexBytesAfter += data->dataSize();
+    }
+
+    _draws.clear();
+}
+
+void MeshOptimizer::report(std::ostream& out) const
+{
+    auto acmr = [&](uint64_t misses) { return statistics.numTriangles > 0 ? static_cast<double>(misses) / static_cast<double>(statistics.numTriangles) : 0.0; };
+
+    out << "MeshOptimizer numDraws = " << statistics.numDraws << ", numDrawsReordered = " << statistics.numDrawsReordered << ", numPipelinesRepacked = " << statistics.numPipelinesRepacked << std::endl;
+    out << "    average cache miss ratio before = " << acmr(statistics.vertexCacheMissesBefore) << ", after = " << acmr(statistics.vertexCacheMissesAfter) << std::endl;
+    out << "    vertex and index bytes before = " << statistics.vertexBytesBefore << ", after = " << statistics.vertexBytesAfter;
+    if (statistics.vertexBytesBefore > 0)
+    {
+        out << ", saved " << (100.0 * static_cast<double>(statistics.vertexBytesBefore - statistics.vertexBytesAfter) / static_cast<double>(statistics.vertexBytesBefore)) << "%";
+    }
+    out << std::endl;
+}
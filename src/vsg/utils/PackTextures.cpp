@@ -0,0 +1,384 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array2D.h>
+#include <vsg/io/Logger.h>
+#include <vsg/nodes/Geometry.h>
+#include <vsg/nodes/VertexDraw.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/state/VertexInputState.h>
+#include <vsg/utils/PackTextures.h>
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <tuple>
+
+using namespace vsg;
+
+namespace
+{
+    ref_ptr<Data> createAtlas(const Data& image, uint32_t size)
+    {
+        ref_ptr<Data> atlas;
+        switch (image.valueSize())
+        {
+        case 1: atlas = ubyteArray2D::create(size, size); break;
+        case 2: atlas = ushortArray2D::create(size, size); break;
+        case 4: atlas = ubvec4Array2D::create(size, size); break;
+        case 8: atlas = usvec4Array2D::create(size, size); break;
+        case 16: atlas = vec4Array2D::create(size, size); break;
+        default: return {};
+        }
+
+        atlas->properties.format = image.properties.format;
+        atlas->properties.origin = image.properties.origin;
+        std::memset(atlas->dataPointer(), 0, atlas->dataSize());
+        return atlas;
+    }
+
+    // copy the image into the atlas at (x, y), surrounded by padding texels that replicate the image's edges
+    void copyImage(const Data& image, Data& atlas, uint32_t x, uint32_t y, uint32_t padding)
+    {
+        auto width = static_cast<int64_t>(image.width());
+        auto height = static_cast<int64_t>(image.height());
+        auto atlasWidth = static_cast<int64_t>(atlas.width());
+        auto valueSize = image.valueSize();
+        auto p = static_cast<int64_t>(padding);
+
+        auto src = static_cast<const uint8_t*>(image.dataPointer());
+        auto dest = static_cast<uint8_t*>(atlas.dataPointer());
+
+        for (int64_t r = -p; r < height + p; ++r)
+        {
+            int64_t sr = std::clamp<int64_t>(r, 0, height - 1);
+            auto destRow = dest + ((static_cast<int64_t>(y) + p + r) * atlasWidth + static_cast<int64_t>(x) + p) * valueSize;
+            auto srcRow = src + sr * width * valueSize;
+
+            std::memcpy(destRow, srcRow, width * valueSize);
+            for (int64_t c = 1; c <= p; ++c)
+            {
+                std::memcpy(destRow - c * valueSize, srcRow, valueSize);
+                std::memcpy(destRow + (width - 1 + c) * valueSize, srcRow + (width - 1) * valueSize, valueSize);
+            }
+        }
+    }
+} // namespace
+
+PackTextures::PackTextures() :
+    sharedObjects(SharedObjects::create())
+{
+}
+
+void PackTextures::apply(Node& node)
+{
+    node.traverse(*this);
+}
+
+void PackTextures::apply(BindGraphicsPipeline& bindPipeline)
+{
+    _currentPipeline = bindPipeline.pipeline.get();
+}
+
+int PackTextures::_texture(StateGroup& stateGroup, size_t stateCommandIndex)
+{
+    auto bind = stateGroup.stateCommands[stateCommandIndex].cast<BindDescriptorSet>();
+    if (!bind || !bind->descriptorSet) return -1;
+
+    // only descriptor sets with a single texture are packed, so that the draws' texture coordinates only need to be remapped for one texture
+    int descriptorIndex = -1;
+    const auto& descriptors = bind->descriptorSet->descriptors;
+    for (size_t i = 0; i < descriptors.size(); ++i)
+    {
+        if (descriptors[i]->cast<DescriptorImage>())
+        {
+            if (descriptorIndex >= 0) return -1;
+            descriptorIndex = static_cast<int>(i);
+        }
+    }
+    if (descriptorIndex < 0) return -1;
+
+    auto descriptorImage = descriptors[descriptorIndex]->cast<DescriptorImage>();
+    if (descriptorImage->descriptorType != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER || descriptorImage->imageInfoList.size() != 1) return -1;
+
+    auto& imageInfo = descriptorImage->imageInfoList.front();
+    if (!imageInfo || !imageInfo->sampler || !imageInfo->imageView || !imageInfo->imageView->image) return -1;
+
+    auto image = imageInfo->imageView->image->data;
+    if (!image || !image->dataAvailable()) return -1;
+
+    const auto& properties = image->properties;
+    if (image->depth() != 1 || image->width() > maximumTextureSize || image->height() > maximumTextureSize || properties.blockWidth != 1 || properties.blockHeight != 1 ||
+        properties.maxNumMipmaps > 1 || image->stride() != image->valueSize() || imageInfo->sampler->unnormalizedCoordinates)
+    {
+        return -1;
+    }
+
+    size_t index = 0;
+    if (auto itr = _textureIndices.find(image.get()); itr != _textureIndices.end())
+    {
+        index = itr->second;
+    }
+    else
+    {
+        index = _textures.size();
+        _textureIndices[image.get()] = index;
+
+        Texture texture;
+        texture.image = image;
+        texture.sampler = imageInfo->sampler;
+        _textures.push_back(texture);
+    }
+
+    _textures[index].bindings.push_back(Binding{&stateGroup, stateCommandIndex, static_cast<size_t>(descriptorIndex)});
+    return static_cast<int>(index);
+}
+
+void PackTextures::apply(StateGroup& stateGroup)
+{
+    auto previousPipeline = _currentPipeline;
+    auto previousStackSize = _textureStack.size();
+
+    for (size_t i = 0; i < stateGroup.stateCommands.size(); ++i)
+    {
+        stateGroup.stateCommands[i]->accept(*this);
+
+        if (stateGroup.stateCommands[i].cast<BindDescriptorSet>())
+        {
+            // descriptor sets that aren't packable are pushed as -1 so the texture coordinates of draws that use them aren't remapped
+            _textureStack.push_back(_texture(stateGroup, i));
+        }
+    }
+
+    stateGroup.traverse(*this);
+
+    _textureStack.resize(previousStackSize);
+    _currentPipeline = previousPipeline;
+}
+
+void PackTextures::_draw(uint32_t firstBinding, const BufferInfoList& arrays)
+{
+    if (_textureStack.empty()) return;
+
+    int textureIndex = _textureStack.back();
+
+    auto invalidate = [&]() {
+        for (auto index : _textureStack)
+        {
+            if (index >= 0) _textures[index].valid = false;
+        }
+    };
+
+    const VertexInputState* vertexInputState = nullptr;
+    if (_currentPipeline)
+    {
+        for (auto& state : _currentPipeline->pipelineStates)
+        {
+            if (auto vis = state.cast<VertexInputState>()) vertexInputState = vis;
+        }
+    }
+
+    if (!vertexInputState)
+    {
+        invalidate();
+        return;
+    }
+
+    auto attribute = std::find_if(vertexInputState->vertexAttributeDescriptions.begin(), vertexInputState->vertexAttributeDescriptions.end(), [&](auto& a) { return a.location == texCoordLocation; });
+    if (attribute == vertexInputState->vertexAttributeDescriptions.end() || attribute->binding < firstBinding || (attribute->binding - firstBinding) >= arrays.size())
+    {
+        // without texture coordinates the texture can only be sampled at constant coordinates, which can't be remapped
+        invalidate();
+        return;
+    }
+
+    auto& bufferInfo = arrays[attribute->binding - firstBinding];
+    auto texCoords = bufferInfo ? bufferInfo->data.cast<vec2Array>() : ref_ptr<vec2Array>();
+    if (!texCoords || !texCoords->dataAvailable() || texCoords->stride() != sizeof(vec2))
+    {
+        invalidate();
+        return;
+    }
+
+    // texture coordinates shared by draws using different textures can't be remapped for both
+    auto [itr, inserted] = _texCoordTextures.emplace(texCoords.get(), textureIndex);
+    if (!inserted && itr->second != textureIndex)
+    {
+        if (itr->second >= 0) _textures[itr->second].valid = false;
+        if (textureIndex >= 0) _textures[textureIndex].valid = false;
+        return;
+    }
+
+    if (inserted && textureIndex >= 0) _textures[textureIndex].texCoords.push_back(texCoords);
+}
+
+void PackTextures::apply(VertexDraw& vd)
+{
+    _draw(vd.firstBinding, vd.arrays);
+}
+
+void PackTextures::apply(VertexIndexDraw& vid)
+{
+    _draw(vid.firstBinding, vid.arrays);
+}
+
+void PackTextures::apply(Geometry& geometry)
+{
+    _draw(geometry.firstBinding, geometry.arrays);
+}
+
+uint32_t PackTextures::pack()
+{
+    const float epsilon = 1e-4f;
+    uint32_t cellLimit = atlasSize > 2 * padding ? atlasSize - 2 * padding : 0;
+
+    // group the packable textures by the settings the textures in an atlas must share
+    using Key = std::tuple<VkFormat, uint8_t, uint32_t, VkFilter, VkFilter, VkSamplerMipmapMode, VkBool32>;
+    std::map<Key, std::vector<Texture*>> groups;
+    for (auto& texture : _textures)
+    {
+        if (!texture.valid || texture.texCoords.empty() || texture.image->width() > cellLimit || texture.image->height() > cellLimit) continue;
+
+        bool withinUnitSquare = true;
+        for (auto& texCoords : texture.texCoords)
+        {
+            for (auto& tc : *texCoords)
+            {
+                if (tc.x < -epsilon || tc.x > 1.0f + epsilon || tc.y < -epsilon || tc.y > 1.0f + epsilon) withinUnitSquare = false;
+            }
+        }
+        if (!withinUnitSquare) continue;
+
+        auto& image = *texture.image;
+        auto& sampler = *texture.sampler;
+        groups[Key(image.properties.format, image.properties.origin, image.valueSize(), sampler.magFilter, sampler.minFilter, sampler.mipmapMode, sampler.anisotropyEnable)].push_back(&texture);
+    }
+
+    std::set<const DescriptorSet*> originalDescriptorSets;
+    std::set<const DescriptorSet*> packedDescriptorSets;
+    uint32_t numPacked = 0;
+
+    for (auto& [key, textures] : groups)
+    {
+        if (textures.size() < 2) continue;
+
+        // shelf pack the tallest textures first
+        std::sort(textures.begin(), textures.end(), [](const Texture* lhs, const Texture* rhs) { return lhs->image->height() > rhs->image->height(); });
+
+        uint32_t atlasIndex = 0, x = 0, y = 0, shelfHeight = 0;
+        for (auto texture : textures)
+        {
+            uint32_t width = texture->image->width() + 2 * padding;
+            uint32_t height = texture->image->height() + 2 * padding;
+
+            if (x + width > atlasSize)
+            {
+                x = 0;
+                y += shelfHeight;
+                shelfHeight = 0;
+            }
+            if (y + height > atlasSize)
+            {
+                ++atlasIndex;
+                x = 0;
+                y = 0;
+                shelfHeight = 0;
+            }
+
+            texture->atlas = atlasIndex;
+            texture->x = x;
+            texture->y = y;
+
+            x += width;
+            shelfHeight = std::max(shelfHeight, height);
+        }
+
+        // create the atlases, sharing a clamp to edge copy of the first texture's sampler
+        auto sampler = Sampler::create(*textures.front()->sampler);
+        sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        sampler->maxLod = 0.0f;
+        if (sharedObjects) sharedObjects->share(sampler);
+
+        std::vector<ref_ptr<Data>> atlases;
+        std::vector<ref_ptr<ImageInfo>> imageInfos;
+        for (uint32_t i = 0; i <= atlasIndex; ++i)
+        {
+            atlases.push_back(createAtlas(*textures.front()->image, atlasSize));
+            imageInfos.push_back(ImageInfo::create(sampler, atlases.back()));
+        }
+        if (!atlases.front()) continue;
+
+        std::map<std::tuple<uint32_t, uint32_t, uint32_t>, ref_ptr<DescriptorImage>> descriptorImages;
+
+        for (auto texture : textures)
+        {
+            auto& image = *texture->image;
+            copyImage(image, *atlases[texture->atlas], texture->x, texture->y, padding);
+
+            // remap the texture coordinates into the texture's region of the atlas
+            float scaleX = static_cast<float>(image.width()) / static_cast<float>(atlasSize);
+            float scaleY = static_cast<float>(image.height()) / static_cast<float>(atlasSize);
+            float offsetX = static_cast<float>(texture->x + padding) / static_cast<float>(atlasSize);
+            float offsetY = static_cast<float>(texture->y + padding) / static_cast<float>(atlasSize);
+            for (auto& texCoords : texture->texCoords)
+            {
+                for (auto& tc : *texCoords)
+                {
+                    tc.x = offsetX + std::clamp(tc.x, 0.0f, 1.0f) * scaleX;
+                    tc.y = offsetY + std::clamp(tc.y, 0.0f, 1.0f) * scaleY;
+                }
+                texCoords->dirty();
+            }
+
+            // replace the texture's descriptor with the atlas, sharing the DescriptorSets that are now identical
+            for (auto& binding : texture->bindings)
+            {
+                auto bind = binding.stateGroup->stateCommands[binding.stateCommandIndex].cast<BindDescriptorSet>();
+                auto& descriptorSet = bind->descriptorSet;
+                originalDescriptorSets.insert(descriptorSet.get());
+
+                auto original = descriptorSet->descriptors[binding.descriptorIndex].cast<DescriptorImage>();
+                auto& descriptorImage = descriptorImages[{texture->atlas, original->dstBinding, original->dstArrayElement}];
+                if (!descriptorImage) descriptorImage = DescriptorImage::create(imageInfos[texture->atlas], original->dstBinding, original->dstArrayElement, original->descriptorType);
+
+                auto descriptors = descriptorSet->descriptors;
+                descriptors[binding.descriptorIndex] = descriptorImage;
+
+                auto packedDescriptorSet = DescriptorSet::create(descriptorSet->setLayout, descriptors);
+                if (sharedObjects) sharedObjects->share(packedDescriptorSet);
+                packedDescriptorSets.insert(packedDescriptorSet.get());
+
+                auto packedBind = BindDescriptorSet::create(bind->pipelineBindPoint, bind->layout, bind->firstSet, packedDescriptorSet);
+                if (sharedObjects) sharedObjects->share(packedBind);
+                binding.stateGroup->stateCommands[binding.stateCommandIndex] = packedBind;
+            }
+
+            ++numPacked;
+        }
+
+        numAtlases += atlasIndex + 1;
+    }
+
+    numTexturesPacked += numPacked;
+    if (originalDescriptorSets.size() > packedDescriptorSets.size()) numDescriptorSetsMerged += static_cast<uint32_t>(originalDescriptorSets.size() - packedDescriptorSets.size());
+
+    debug("PackTextures::pack() packed ", numPacked, " textures into ", numAtlases, " atlases, merging ", numDescriptorSetsMerged, " DescriptorSets.");
+
+    _textures.clear();
+    _textureIndices.clear();
+    _texCoordTextures.clear();
+
+    return numPacked;
+}
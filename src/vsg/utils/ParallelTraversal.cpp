@@ -0,0 +1,121 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/nodes/Group.h>
+#include <vsg/utils/ParallelTraversal.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ConcurrentVisitedSet
+//
+bool ConcurrentVisitedSet::insert(const Object* object)
+{
+    auto& stripe = _stripe(object);
+    std::scoped_lock<std::mutex> lock(stripe.mutex);
+    return stripe.objects.insert(object).second;
+}
+
+bool ConcurrentVisitedSet::contains(const Object* object) const
+{
+    auto& stripe = _stripe(object);
+    std::scoped_lock<std::mutex> lock(stripe.mutex);
+    return stripe.objects.count(object) != 0;
+}
+
+void ConcurrentVisitedSet::clear()
+{
+    for (auto& stripe : _stripes)
+    {
+        std::scoped_lock<std::mutex> lock(stripe.mutex);
+        stripe.objects.clear();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ParallelTraversal
+//
+ParallelTraversal::ParallelTraversal(ref_ptr<OperationThreads> in_operationThreads) :
+    operationThreads(in_operationThreads),
+    visited(ConcurrentVisitedSet::create())
+{
+}
+
+ParallelTraversal::~ParallelTraversal()
+{
+}
+
+void ParallelTraversal::_split(const Node* node, uint32_t depth, std::vector<const Node*>& subgraphs, std::unordered_set<const Node*>& added) const
+{
+    if (!node || !added.insert(node).second) return;
+
+    // only split plain Groups, subclasses may apply transforms or state, or select between their children
+    auto group = (node->type_info() == typeid(Group)) ? static_cast<const Group*>(node) : nullptr;
+    if (group && depth < maximumSplitDepth && group->children.size() >= minimumGroupChildren)
+    {
+        for (auto& child : group->children) _split(child.get(), depth + 1, subgraphs, added);
+    }
+    else
+    {
+        subgraphs.push_back(node);
+    }
+}
+
+size_t ParallelTraversal::traverse(const Node& root, const CreateFunction& create, const ReduceFunction& reduce)
+{
+    if (visited) visited->clear();
+
+    std::vector<const Node*> subgraphs;
+    std::unordered_set<const Node*> added;
+    _split(&root, 0, subgraphs, added);
+
+    size_t numTasks = operationThreads ? std::min(subgraphs.size(), std::max(maximumTasks, size_t(1))) : 1;
+    if (numTasks <= 1)
+    {
+        auto visitor = create();
+        if (!visitor) return 0;
+
+        for (auto node : subgraphs) node->accept(*visitor);
+        reduce(*visitor);
+        return 1;
+    }
+
+    // create all the visitors up front on the calling thread so create() needn't be thread safe
+    std::vector<ref_ptr<ConstVisitor>> visitors(numTasks);
+    for (auto& visitor : visitors)
+    {
+        visitor = create();
+        if (!visitor) return 0;
+    }
+
+    std::vector<std::function<void()>> functions;
+    for (size_t i = 0; i < numTasks; ++i)
+    {
+        auto visitor = visitors[i].get();
+        auto begin = subgraphs.data() + (subgraphs.size() * i) / numTasks;
+        auto end = subgraphs.data() + (subgraphs.size() * (i + 1)) / numTasks;
+        functions.push_back([visitor, begin, end]() {
+            for (auto itr = begin; itr != end; ++itr) (*itr)->accept(*visitor);
+        });
+    }
+
+    // exceptions thrown by the visitors are rethrown here once all the traversals have completed
+    runAndWait(*operationThreads, functions);
+
+    for (auto& visitor : visitors) reduce(*visitor);
+
+    return numTasks;
+}
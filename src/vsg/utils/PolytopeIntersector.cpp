@@ -0,0 +1,335 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Options.h>
+#include <vsg/maths/simd.h>
+#include <vsg/nodes/Transform.h>
+#include <vsg/utils/PolytopeIntersector.h>
+
+#include <limits>
+
+using namespace vsg;
+
+namespace
+{
+    /// set bit p of each vertex's outcode when the vertex is outside plane p of the polytope, several vertices at a time using SIMD where available
+    void computeOutcodes(const PolytopeIntersector::Polytope& polytope, const vec3* vertices, size_t count, uint32_t* outcodes)
+    {
+        size_t numPlanes = std::min(polytope.size(), size_t(32));
+        size_t i = 0;
+
+#if defined(VSG_SIMD_AVX)
+        for (; i + 4 <= count; i += 4)
+        {
+            const vec3* v = vertices + i;
+            __m256d x = _mm256_set_pd(v[3].x, v[2].x, v[1].x, v[0].x);
+            __m256d y = _mm256_set_pd(v[3].y, v[2].y, v[1].y, v[0].y);
+            __m256d z = _mm256_set_pd(v[3].z, v[2].z, v[1].z, v[0].z);
+
+            uint32_t codes[4] = {0, 0, 0, 0};
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const auto& plane = polytope[p];
+                __m256d d = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(plane.n.x)), _mm256_mul_pd(y, _mm256_set1_pd(plane.n.y))),
+                                          _mm256_add_pd(_mm256_mul_pd(z, _mm256_set1_pd(plane.n.z)), _mm256_set1_pd(plane.p)));
+                int bits = _mm256_movemask_pd(_mm256_cmp_pd(d, _mm256_setzero_pd(), _CMP_LT_OQ));
+                for (int lane = 0; lane < 4; ++lane) codes[lane] |= static_cast<uint32_t>((bits >> lane) & 1) << p;
+            }
+            for (int lane = 0; lane < 4; ++lane) outcodes[i + lane] = codes[lane];
+        }
+#elif defined(VSG_SIMD_SSE2)
+        for (; i + 2 <= count; i += 2)
+        {
+            const vec3* v = vertices + i;
+            __m128d x = _mm_set_pd(v[1].x, v[0].x);
+            __m128d y = _mm_set_pd(v[1].y, v[0].y);
+            __m128d z = _mm_set_pd(v[1].z, v[0].z);
+
+            uint32_t codes[2] = {0, 0};
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const auto& plane = polytope[p];
+                __m128d d = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(plane.n.x)), _mm_mul_pd(y, _mm_set1_pd(plane.n.y))),
+                                       _mm_add_pd(_mm_mul_pd(z, _mm_set1_pd(plane.n.z)), _mm_set1_pd(plane.p)));
+                int bits = _mm_movemask_pd(_mm_cmplt_pd(d, _mm_setzero_pd()));
+                for (int lane = 0; lane < 2; ++lane) codes[lane] |= static_cast<uint32_t>((bits >> lane) & 1) << p;
+            }
+            for (int lane = 0; lane < 2; ++lane) outcodes[i + lane] = codes[lane];
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            dvec3 v(vertices[i]);
+            uint32_t code = 0;
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                if (distance(polytope[p], v) < 0.0) code |= (1u << p);
+            }
+            outcodes[i] = code;
+        }
+    }
+
+    /// Sutherland-Hodgman clipping of a triangle against the planes of the polytope selected by planeMask
+    struct TriangleClipper
+    {
+        std::vector<dvec3> polygon;
+        std::vector<dvec3> clipped;
+
+        /// return true if part of the triangle lies within the polytope, with center set to the center of the part within
+        bool clip(const PolytopeIntersector::Polytope& polytope, uint32_t planeMask, const dvec3& v0, const dvec3& v1, const dvec3& v2, dvec3& center)
+        {
+            polygon.assign({v0, v1, v2});
+
+            for (size_t p = 0; p < polytope.size() && p < 32 && !polygon.empty(); ++p)
+            {
+                if ((planeMask & (1u << p)) == 0) continue;
+
+                const auto& plane = polytope[p];
+                clipped.clear();
+
+                for (size_t i = 0; i < polygon.size(); ++i)
+                {
+                    const dvec3& a = polygon[i];
+                    const dvec3& b = polygon[(i + 1) % polygon.size()];
+                    double da = distance(plane, a);
+                    double db = distance(plane, b);
+
+                    if (da >= 0.0) clipped.push_back(a);
+                    if ((da >= 0.0) != (db >= 0.0)) clipped.push_back(a + (b - a) * (da / (da - db)));
+                }
+
+                polygon.swap(clipped);
+            }
+
+            if (polygon.empty()) return false;
+
+            center.set(0.0, 0.0, 0.0);
+            for (auto& v : polygon) center += v;
+            center /= static_cast<double>(polygon.size());
+            return true;
+        }
+    };
+} // namespace
+
+PolytopeIntersector::PolytopeIntersector(const Polytope& in_polytope, ref_ptr<ArrayState> initialArrayData) :
+    Inherit(initialArrayData)
+{
+    if (in_polytope.size() > 32) warn("PolytopeIntersector only supports 32 planes, ignoring remaining ", in_polytope.size() - 32, " planes.");
+
+    _polytopeStack.push_back(in_polytope);
+}
+
+PolytopeIntersector::PolytopeIntersector(const Camera& camera, double xMin, double yMin, double xMax, double yMax, ref_ptr<ArrayState> initialArrayData) :
+    Inherit(initialArrayData)
+{
+    auto viewport = camera.getViewport();
+
+    vsg::dvec2 ndc_min(-1.0, -1.0);
+    vsg::dvec2 ndc_max(1.0, 1.0);
+    if ((viewport.width > 0) && (viewport.height > 0))
+    {
+        ndc_min.set((std::min(xMin, xMax) - viewport.x) / viewport.width * 2.0 - 1.0, (std::min(yMin, yMax) - viewport.y) / viewport.height * 2.0 - 1.0);
+        ndc_max.set((std::max(xMin, xMax) - viewport.x) / viewport.width * 2.0 - 1.0, (std::max(yMin, yMax) - viewport.y) / viewport.height * 2.0 - 1.0);
+    }
+
+    // planes in clip space, the w component of each plane is the coefficient of the clip coordinate's w
+    const dplane clipPlanes[6] = {
+        {1.0, 0.0, 0.0, -ndc_min.x}, // left
+        {-1.0, 0.0, 0.0, ndc_max.x}, // right
+        {0.0, 1.0, 0.0, -ndc_min.y}, // top
+        {0.0, -1.0, 0.0, ndc_max.y}, // bottom
+        {0.0, 0.0, 1.0, 0.0},        // z >= 0
+        {0.0, 0.0, -1.0, 1.0}        // z <= 1
+    };
+
+    // transform the planes into world coordinates
+    dmat4 clipMatrix = camera.projectionMatrix->transform() * camera.viewMatrix->transform();
+
+    Polytope polytope;
+    for (auto& clipPlane : clipPlanes)
+    {
+        dplane plane = clipPlane * clipMatrix;
+        double normalLength = length(plane.n);
+        if (normalLength > 0.0) plane.vec /= normalLength;
+        polytope.push_back(plane);
+    }
+
+    _polytopeStack.push_back(polytope);
+}
+
+PolytopeIntersector::Intersection::Intersection(const dvec3& in_localIntersection, const dvec3& in_worldIntersection, const dmat4& in_localToWorld, const NodePath& in_nodePath, const DataList& in_arrays, const std::vector<uint32_t>& in_indices, uint32_t in_instanceIndex) :
+    localIntersection(in_localIntersection),
+    worldIntersection(in_worldIntersection),
+    localToWorld(in_localToWorld),
+    nodePath(in_nodePath),
+    arrays(in_arrays),
+    indices(in_indices),
+    instanceIndex(in_instanceIndex)
+{
+}
+
+ref_ptr<PolytopeIntersector::Intersection> PolytopeIntersector::add(const dvec3& coord, const std::vector<uint32_t>& indices, uint32_t instanceIndex)
+{
+    auto localToWorld = computeTransform(_nodePath);
+    auto intersection = Intersection::create(coord, localToWorld * coord, localToWorld, _nodePath, arrayStateStack.back()->arrays, indices, instanceIndex);
+    intersections.emplace_back(intersection);
+
+    return intersection;
+}
+
+void PolytopeIntersector::pushTransform(const Transform& transform)
+{
+    auto& l2wStack = localToWorldStack();
+    auto& w2lStack = worldToLocalStack();
+
+    dmat4 localToWorld = l2wStack.empty() ? transform.transform(dmat4{}) : transform.transform(l2wStack.back());
+    dmat4 worldToLocal = inverse(localToWorld);
+
+    l2wStack.push_back(localToWorld);
+    w2lStack.push_back(worldToLocal);
+
+    // transform the world polytope into local coordinates, renormalizing so distances to the planes remain in local units
+    Polytope localPolytope;
+    for (auto& worldPlane : _polytopeStack.front())
+    {
+        dplane plane = worldPlane * localToWorld;
+        double normalLength = length(plane.n);
+        if (normalLength > 0.0) plane.vec /= normalLength;
+        localPolytope.push_back(plane);
+    }
+    _polytopeStack.push_back(localPolytope);
+}
+
+void PolytopeIntersector::popTransform()
+{
+    _polytopeStack.pop_back();
+    localToWorldStack().pop_back();
+    worldToLocalStack().pop_back();
+}
+
+bool PolytopeIntersector::intersects(const dsphere& bs)
+{
+    if (!bs.valid()) return false;
+
+    return vsg::intersect(_polytopeStack.back(), bs);
+}
+
+bool PolytopeIntersector::intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t firstInstance, uint32_t instanceCount)
+{
+    return _intersectTriangles(nullptr, firstVertex, vertexCount, firstInstance, instanceCount);
+}
+
+bool PolytopeIntersector::intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount)
+{
+    const Data* indices = ushort_indices ? static_cast<const Data*>(ushort_indices.get()) : static_cast<const Data*>(uint_indices.get());
+    if (!indices) return false;
+
+    return _intersectTriangles(indices, firstIndex, indexCount, firstInstance, instanceCount);
+}
+
+bool PolytopeIntersector::_intersectTriangles(const Data* indices, uint32_t first, uint32_t count, uint32_t firstInstance, uint32_t instanceCount)
+{
+    auto& arrayState = *arrayStateStack.back();
+    if (arrayState.topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST || count < 3) return false;
+
+    const auto& polytope = _polytopeStack.back();
+
+    uint32_t end = first + (count / 3) * 3;
+    if (indices) end = std::min(end, static_cast<uint32_t>(indices->valueCount()));
+    if (end < first + 3) return false;
+
+    auto ushortIndices = ushort_indices.get();
+    auto uintIndices = uint_indices.get();
+    auto vertexIndex = [&](uint32_t i) -> uint32_t {
+        if (!indices) return i;
+        return ushortIndices ? ushortIndices->at(i) : uintIndices->at(i);
+    };
+
+    // range of vertices referenced by the draw
+    uint32_t minVertex = first;
+    uint32_t maxVertex = end - 1;
+    if (indices)
+    {
+        minVertex = std::numeric_limits<uint32_t>::max();
+        maxVertex = 0;
+        for (uint32_t i = first; i < end; ++i)
+        {
+            uint32_t index = vertexIndex(i);
+            minVertex = std::min(minVertex, index);
+            maxVertex = std::max(maxVertex, index);
+        }
+    }
+
+    size_t previous_size = intersections.size();
+    std::vector<uint32_t> outcodes;
+    TriangleClipper clipper;
+
+    uint32_t lastIndex = instanceCount > 1 ? (firstInstance + instanceCount) : firstInstance + 1;
+    for (uint32_t instanceIndex = firstInstance; instanceIndex < lastIndex; ++instanceIndex)
+    {
+        auto vertices = arrayState.vertexArray(instanceIndex);
+        if (!vertices || maxVertex >= vertices->size()) continue;
+
+        outcodes.resize(maxVertex - minVertex + 1);
+        computeOutcodes(polytope, vertices->data() + minVertex, outcodes.size(), outcodes.data());
+
+        std::vector<uint32_t> intersectedIndices;
+        dvec3 center;
+        uint32_t numIntersected = 0;
+
+        for (uint32_t i = first; i + 3 <= end; i += 3)
+        {
+            uint32_t i0 = vertexIndex(i);
+            uint32_t i1 = vertexIndex(i + 1);
+            uint32_t i2 = vertexIndex(i + 2);
+
+            uint32_t c0 = outcodes[i0 - minVertex];
+            uint32_t c1 = outcodes[i1 - minVertex];
+            uint32_t c2 = outcodes[i2 - minVertex];
+
+            // all vertices outside the same plane so triangle is outside the polytope
+            if ((c0 & c1 & c2) != 0) continue;
+
+            dvec3 v0(vertices->at(i0));
+            dvec3 v1(vertices->at(i1));
+            dvec3 v2(vertices->at(i2));
+
+            dvec3 triangleCenter;
+            if ((c0 | c1 | c2) == 0)
+            {
+                // all vertices inside all the planes so triangle is wholly within the polytope
+                triangleCenter = (v0 + v1 + v2) / 3.0;
+            }
+            else if (!clipper.clip(polytope, c0 | c1 | c2, v0, v1, v2, triangleCenter))
+            {
+                continue;
+            }
+
+            center += triangleCenter;
+            ++numIntersected;
+
+            if (nodePathsOnly) break;
+
+            intersectedIndices.push_back(i0);
+            intersectedIndices.push_back(i1);
+            intersectedIndices.push_back(i2);
+        }
+
+        if (numIntersected > 0)
+        {
+            add(center / static_cast<double>(numIntersected), intersectedIndices, instanceIndex);
+        }
+    }
+
+    return intersections.size() != previous_size;
+}
@@ -0,0 +1,584 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/maths/simd.h>
+#include <vsg/maths/transform.h>
+#include <vsg/nodes/CullGroup.h>
+#include <vsg/nodes/CullNode.h>
+#include <vsg/nodes/DepthSorted.h>
+#include <vsg/nodes/LOD.h>
+#include <vsg/nodes/PagedLOD.h>
+#include <vsg/nodes/Transform.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/utils/RayBatchIntersector.h>
+#include <vsg/utils/TriangleBVH.h>
+
+#include <cmath>
+
+using namespace vsg;
+
+namespace
+{
+    /// structure of arrays of the active segments in the local coordinates of a draw, with normalized directions so the determinant epsilon matches LineSegmentIntersector
+    struct RayPacket
+    {
+        std::vector<double> ox, oy, oz;
+        std::vector<double> dx, dy, dz;
+        std::vector<double> length;
+        std::vector<double> tmax;
+        std::vector<uint32_t> segments;
+
+        size_t size() const { return segments.size(); }
+
+        void add(uint32_t segment, const dvec3& start, const dvec3& end, double maxRatio)
+        {
+            dvec3 d = end - start;
+            double l = vsg::length(d);
+            if (l == 0.0) return;
+            d /= l;
+
+            ox.push_back(start.x);
+            oy.push_back(start.y);
+            oz.push_back(start.z);
+            dx.push_back(d.x);
+            dy.push_back(d.y);
+            dz.push_back(d.z);
+            length.push_back(l);
+            tmax.push_back(l * maxRatio);
+            segments.push_back(segment);
+        }
+
+        dvec3 start(size_t i) const { return dvec3(ox[i], oy[i], oz[i]); }
+        dvec3 end(size_t i) const { return dvec3(ox[i] + dx[i] * tmax[i], oy[i] + dy[i] * tmax[i], oz[i] + dz[i] * tmax[i]); }
+
+        /// Möller–Trumbore intersection of ray i with the triangle v0, v0 + e1, v0 + e2
+        bool intersect(size_t i, const dvec3& v0, const dvec3& e1, const dvec3& e2, double& u, double& v, double& t) const
+        {
+            const double epsilon = 1e-10;
+
+            dvec3 d(dx[i], dy[i], dz[i]);
+            dvec3 P = cross(d, e2);
+            double det = dot(P, e1);
+            if (std::abs(det) <= epsilon) return false;
+
+            double inv_det = 1.0 / det;
+            dvec3 T = start(i) - v0;
+            u = dot(T, P) * inv_det;
+            if (u < 0.0 || u > 1.0) return false;
+
+            dvec3 Q = cross(T, e1);
+            v = dot(d, Q) * inv_det;
+            if (v < 0.0 || (u + v) > 1.0) return false;
+
+            t = dot(e2, Q) * inv_det;
+            return t >= 0.0 && t <= tmax[i];
+        }
+    };
+
+    /// intersect all the rays in the packet with a triangle, several rays at a time using SIMD where available, calling hit(i, u, v, t) for each ray that intersects.
+    template<class F>
+    void intersectTriangle(const RayPacket& rays, const dvec3& v0, const dvec3& e1, const dvec3& e2, F hit)
+    {
+        size_t n = rays.size();
+        size_t i = 0;
+
+#if defined(VSG_SIMD_AVX)
+        {
+            const __m256d v0x = _mm256_set1_pd(v0.x), v0y = _mm256_set1_pd(v0.y), v0z = _mm256_set1_pd(v0.z);
+            const __m256d e1x = _mm256_set1_pd(e1.x), e1y = _mm256_set1_pd(e1.y), e1z = _mm256_set1_pd(e1.z);
+            const __m256d e2x = _mm256_set1_pd(e2.x), e2y = _mm256_set1_pd(e2.y), e2z = _mm256_set1_pd(e2.z);
+            const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0), epsilon = _mm256_set1_pd(1e-10);
+            const __m256d signMask = _mm256_set1_pd(-0.0);
+
+            for (; i + 4 <= n; i += 4)
+            {
+                __m256d dx = _mm256_loadu_pd(&rays.dx[i]), dy = _mm256_loadu_pd(&rays.dy[i]), dz = _mm256_loadu_pd(&rays.dz[i]);
+
+                __m256d px = _mm256_sub_pd(_mm256_mul_pd(dy, e2z), _mm256_mul_pd(dz, e2y));
+                __m256d py = _mm256_sub_pd(_mm256_mul_pd(dz, e2x), _mm256_mul_pd(dx, e2z));
+                __m256d pz = _mm256_sub_pd(_mm256_mul_pd(dx, e2y), _mm256_mul_pd(dy, e2x));
+                __m256d det = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(px, e1x), _mm256_mul_pd(py, e1y)), _mm256_mul_pd(pz, e1z));
+                __m256d mask = _mm256_cmp_pd(_mm256_andnot_pd(signMask, det), epsilon, _CMP_GT_OQ);
+                if (_mm256_movemask_pd(mask) == 0) continue;
+
+                __m256d inv_det = _mm256_div_pd(one, det);
+                __m256d tx = _mm256_sub_pd(_mm256_loadu_pd(&rays.ox[i]), v0x);
+                __m256d ty = _mm256_sub_pd(_mm256_loadu_pd(&rays.oy[i]), v0y);
+                __m256d tz = _mm256_sub_pd(_mm256_loadu_pd(&rays.oz[i]), v0z);
+                __m256d u = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(tx, px), _mm256_mul_pd(ty, py)), _mm256_mul_pd(tz, pz)), inv_det);
+                mask = _mm256_and_pd(mask, _mm256_and_pd(_mm256_cmp_pd(u, zero, _CMP_GE_OQ), _mm256_cmp_pd(u, one, _CMP_LE_OQ)));
+                if (_mm256_movemask_pd(mask) == 0) continue;
+
+                __m256d qx = _mm256_sub_pd(_mm256_mul_pd(ty, e1z), _mm256_mul_pd(tz, e1y));
+                __m256d qy = _mm256_sub_pd(_mm256_mul_pd(tz, e1x), _mm256_mul_pd(tx, e1z));
+                __m256d qz = _mm256_sub_pd(_mm256_mul_pd(tx, e1y), _mm256_mul_pd(ty, e1x));
+                __m256d v = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, qx), _mm256_mul_pd(dy, qy)), _mm256_mul_pd(dz, qz)), inv_det);
+                __m256d t = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(e2x, qx), _mm256_mul_pd(e2y, qy)), _mm256_mul_pd(e2z, qz)), inv_det);
+                mask = _mm256_and_pd(mask, _mm256_and_pd(_mm256_cmp_pd(v, zero, _CMP_GE_OQ), _mm256_cmp_pd(_mm256_add_pd(u, v), one, _CMP_LE_OQ)));
+                mask = _mm256_and_pd(mask, _mm256_and_pd(_mm256_cmp_pd(t, zero, _CMP_GE_OQ), _mm256_cmp_pd(t, _mm256_loadu_pd(&rays.tmax[i]), _CMP_LE_OQ)));
+
+                int bits = _mm256_movemask_pd(mask);
+                if (bits == 0) continue;
+
+                alignas(32) double us[4], vs[4], ts[4];
+                _mm256_store_pd(us, u);
+                _mm256_store_pd(vs, v);
+                _mm256_store_pd(ts, t);
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if (bits & (1 << lane)) hit(i + lane, us[lane], vs[lane], ts[lane]);
+                }
+            }
+        }
+#elif defined(VSG_SIMD_SSE2)
+        {
+            const __m128d v0x = _mm_set1_pd(v0.x), v0y = _mm_set1_pd(v0.y), v0z = _mm_set1_pd(v0.z);
+            const __m128d e1x = _mm_set1_pd(e1.x), e1y = _mm_set1_pd(e1.y), e1z = _mm_set1_pd(e1.z);
+            const __m128d e2x = _mm_set1_pd(e2.x), e2y = _mm_set1_pd(e2.y), e2z = _mm_set1_pd(e2.z);
+            const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0), epsilon = _mm_set1_pd(1e-10);
+            const __m128d signMask = _mm_set1_pd(-0.0);
+
+            for (; i + 2 <= n; i += 2)
+            {
+                __m128d dx = _mm_loadu_pd(&rays.dx[i]), dy = _mm_loadu_pd(&rays.dy[i]), dz = _mm_loadu_pd(&rays.dz[i]);
+
+                __m128d px = _mm_sub_pd(_mm_mul_pd(dy, e2z), _mm_mul_pd(dz, e2y));
+                __m128d py = _mm_sub_pd(_mm_mul_pd(dz, e2x), _mm_mul_pd(dx, e2z));
+                __m128d pz = _mm_sub_pd(_mm_mul_pd(dx, e2y), _mm_mul_pd(dy, e2x));
+                __m128d det = _mm_add_pd(_mm_add_pd(_mm_mul_pd(px, e1x), _mm_mul_pd(py, e1y)), _mm_mul_pd(pz, e1z));
+                __m128d mask = _mm_cmpgt_pd(_mm_andnot_pd(signMask, det), epsilon);
+                if (_mm_movemask_pd(mask) == 0) continue;
+
+                __m128d inv_det = _mm_div_pd(one, det);
+                __m128d tx = _mm_sub_pd(_mm_loadu_pd(&rays.ox[i]), v0x);
+                __m128d ty = _mm_sub_pd(_mm_loadu_pd(&rays.oy[i]), v0y);
+                __m128d tz = _mm_sub_pd(_mm_loadu_pd(&rays.oz[i]), v0z);
+                __m128d u = _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(tx, px), _mm_mul_pd(ty, py)), _mm_mul_pd(tz, pz)), inv_det);
+                mask = _mm_and_pd(mask, _mm_and_pd(_mm_cmpge_pd(u, zero), _mm_cmple_pd(u, one)));
+                if (_mm_movemask_pd(mask) == 0) continue;
+
+                __m128d qx = _mm_sub_pd(_mm_mul_pd(ty, e1z), _mm_mul_pd(tz, e1y));
+                __m128d qy = _mm_sub_pd(_mm_mul_pd(tz, e1x), _mm_mul_pd(tx, e1z));
+                __m128d qz = _mm_sub_pd(_mm_mul_pd(tx, e1y), _mm_mul_pd(ty, e1x));
+                __m128d v = _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, qx), _mm_mul_pd(dy, qy)), _mm_mul_pd(dz, qz)), inv_det);
+                __m128d t = _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(e2x, qx), _mm_mul_pd(e2y, qy)), _mm_mul_pd(e2z, qz)), inv_det);
+                mask = _mm_and_pd(mask, _mm_and_pd(_mm_cmpge_pd(v, zero), _mm_cmple_pd(_mm_add_pd(u, v), one)));
+                mask = _mm_and_pd(mask, _mm_and_pd(_mm_cmpge_pd(t, zero), _mm_cmple_pd(t, _mm_loadu_pd(&rays.tmax[i]))));
+
+                int bits = _mm_movemask_pd(mask);
+                if (bits == 0) continue;
+
+                alignas(16) double us[2], vs[2], ts[2];
+                _mm_store_pd(us, u);
+                _mm_store_pd(vs, v);
+                _mm_store_pd(ts, t);
+                for (int lane = 0; lane < 2; ++lane)
+                {
+                    if (bits & (1 << lane)) hit(i + lane, us[lane], vs[lane], ts[lane]);
+                }
+            }
+        }
+#endif
+
+        for (; i < n; ++i)
+        {
+            double u, v, t;
+            if (rays.intersect(i, v0, e1, e2, u, v, t)) hit(i, u, v, t);
+        }
+    }
+
+    /// return true if the line segment from start to start + (end - start) * maxRatio intersects the sphere
+    bool intersectsSphere(const dvec3& start, const dvec3& end, double maxRatio, const dsphere& bs)
+    {
+        dvec3 sm = start - bs.center;
+        double c = length2(sm) - bs.radius * bs.radius;
+        if (c < 0.0) return true;
+
+        dvec3 se = end - start;
+        double a = length2(se);
+        double b = dot(sm, se) * 2.0;
+        double d = b * b - 4.0 * a * c;
+
+        if (d < 0.0) return false;
+
+        d = sqrt(d);
+
+        double div = 1.0 / (2.0 * a);
+
+        double r1 = (-b - d) * div;
+        double r2 = (-b + d) * div;
+
+        if (r1 <= 0.0 && r2 <= 0.0) return false;
+        if (r1 >= maxRatio && r2 >= maxRatio) return false;
+
+        return true;
+    }
+
+    struct PushPopNode
+    {
+        Intersector::NodePath& nodePath;
+
+        PushPopNode(Intersector::NodePath& np, const Node* node) :
+            nodePath(np) { nodePath.push_back(node); }
+        ~PushPopNode() { nodePath.pop_back(); }
+    };
+} // namespace
+
+RayBatchIntersector::RayBatchIntersector(const Segments& in_segments, ref_ptr<ArrayState> initialArrayData) :
+    Inherit(initialArrayData),
+    segments(in_segments)
+{
+    _reset();
+}
+
+void RayBatchIntersector::_reset()
+{
+    intersections.clear();
+    intersections.resize(segments.size());
+    _maxRatios.assign(segments.size(), 1.0);
+    _numIntersections = 0;
+
+    _frames.clear();
+    _frames.emplace_back();
+
+    auto& frame = _frames.back();
+    frame.active.reserve(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        frame.active.push_back(static_cast<uint32_t>(i));
+    }
+
+    // segments are in world coordinates, so transform them if the initial ArrayState already has a transform
+    auto& w2lStack = worldToLocalStack();
+    if (w2lStack.empty())
+    {
+        frame.local = segments;
+    }
+    else
+    {
+        const auto& worldToLocal = w2lStack.back();
+        frame.local.reserve(segments.size());
+        for (auto& segment : segments)
+        {
+            frame.local.push_back(Segment{worldToLocal * segment.start, worldToLocal * segment.end});
+        }
+    }
+}
+
+void RayBatchIntersector::intersect(const Node& node, ref_ptr<OperationThreads> operationThreads, size_t segmentsPerBatch)
+{
+    _reset();
+
+    if (!operationThreads || segmentsPerBatch == 0 || segments.size() <= segmentsPerBatch)
+    {
+        node.accept(*this);
+        return;
+    }
+
+    std::vector<ref_ptr<RayBatchIntersector>> batches;
+    for (size_t first = 0; first < segments.size(); first += segmentsPerBatch)
+    {
+        size_t last = std::min(first + segmentsPerBatch, segments.size());
+        auto batch = RayBatchIntersector::create(Segments(segments.begin() + first, segments.begin() + last), arrayStateStack.front()->clone());
+        batch->closestOnly = closestOnly;
+        batch->useTriangleBVH = useTriangleBVH;
+        batch->minimumTrianglesForBVH = minimumTrianglesForBVH;
+        batches.push_back(batch);
+    }
+
+    struct IntersectOperation : public Operation
+    {
+        IntersectOperation(const Node* in_node, RayBatchIntersector* in_batch, ref_ptr<Latch> in_latch) :
+            node(in_node),
+            batch(in_batch),
+            latch(in_latch) {}
+
+        void run() override
+        {
+            node->accept(*batch);
+            latch->count_down();
+        }
+
+        const Node* node;
+        RayBatchIntersector* batch;
+        ref_ptr<Latch> latch;
+    };
+
+    auto latch = Latch::create(batches.size());
+    for (auto& batch : batches)
+    {
+        operationThreads->add(ref_ptr<Operation>(new IntersectOperation(&node, batch.get(), latch)));
+    }
+
+    // help out with the batches then wait for the remaining ones to complete
+    operationThreads->run();
+    latch->wait();
+
+    size_t offset = 0;
+    for (auto& batch : batches)
+    {
+        for (auto& batchIntersections : batch->intersections)
+        {
+            intersections[offset++] = std::move(batchIntersections);
+        }
+        _numIntersections += batch->_numIntersections;
+    }
+
+    debug("RayBatchIntersector::intersect() ", segments.size(), " segments in ", batches.size(), " batches, ", _numIntersections, " intersections");
+}
+
+bool RayBatchIntersector::_pushBound(const dsphere& bs)
+{
+    if (!bs.valid()) return false;
+
+    const auto& parent = _frames.back();
+
+    Frame frame;
+    for (size_t i = 0; i < parent.active.size(); ++i)
+    {
+        auto segmentIndex = parent.active[i];
+        const auto& segment = parent.local[i];
+        if (intersectsSphere(segment.start, segment.end, _maxRatios[segmentIndex], bs))
+        {
+            frame.active.push_back(segmentIndex);
+            frame.local.push_back(segment);
+        }
+    }
+
+    if (frame.active.empty()) return false;
+
+    _frames.push_back(std::move(frame));
+    return true;
+}
+
+bool RayBatchIntersector::intersects(const dsphere& bs)
+{
+    if (!bs.valid()) return false;
+
+    const auto& frame = _frames.back();
+    for (size_t i = 0; i < frame.active.size(); ++i)
+    {
+        const auto& segment = frame.local[i];
+        if (intersectsSphere(segment.start, segment.end, _maxRatios[frame.active[i]], bs)) return true;
+    }
+    return false;
+}
+
+void RayBatchIntersector::apply(const LOD& lod)
+{
+    PushPopNode ppn(_nodePath, &lod);
+
+    if (_pushBound(lod.bound))
+    {
+        for (auto& child : lod.children)
+        {
+            if (child.node)
+            {
+                child.node->accept(*this);
+                break;
+            }
+        }
+        _popBound();
+    }
+}
+
+void RayBatchIntersector::apply(const PagedLOD& plod)
+{
+    PushPopNode ppn(_nodePath, &plod);
+
+    if (_pushBound(plod.bound))
+    {
+        for (auto& child : plod.children)
+        {
+            if (child.node)
+            {
+                child.node->accept(*this);
+                break;
+            }
+        }
+        _popBound();
+    }
+}
+
+void RayBatchIntersector::apply(const CullNode& cn)
+{
+    PushPopNode ppn(_nodePath, &cn);
+
+    if (_pushBound(cn.bound))
+    {
+        cn.traverse(*this);
+        _popBound();
+    }
+}
+
+void RayBatchIntersector::apply(const CullGroup& cn)
+{
+    PushPopNode ppn(_nodePath, &cn);
+
+    if (_pushBound(cn.bound))
+    {
+        cn.traverse(*this);
+        _popBound();
+    }
+}
+
+void RayBatchIntersector::apply(const DepthSorted& cn)
+{
+    PushPopNode ppn(_nodePath, &cn);
+
+    if (_pushBound(cn.bound))
+    {
+        cn.traverse(*this);
+        _popBound();
+    }
+}
+
+void RayBatchIntersector::pushTransform(const Transform& transform)
+{
+    auto& l2wStack = localToWorldStack();
+    auto& w2lStack = worldToLocalStack();
+
+    dmat4 localToWorld = l2wStack.empty() ? transform.transform(dmat4{}) : transform.transform(l2wStack.back());
+    dmat4 worldToLocal = inverse(localToWorld);
+
+    l2wStack.push_back(localToWorld);
+    w2lStack.push_back(worldToLocal);
+
+    Frame frame;
+    frame.active = _frames.back().active;
+    frame.local.reserve(frame.active.size());
+    for (auto segmentIndex : frame.active)
+    {
+        const auto& segment = segments[segmentIndex];
+        frame.local.push_back(Segment{worldToLocal * segment.start, worldToLocal * segment.end});
+    }
+    _frames.push_back(std::move(frame));
+}
+
+void RayBatchIntersector::popTransform()
+{
+    _frames.pop_back();
+    localToWorldStack().pop_back();
+    worldToLocalStack().pop_back();
+}
+
+bool RayBatchIntersector::intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t firstInstance, uint32_t instanceCount)
+{
+    size_t previous_numIntersections = _numIntersections;
+    _intersectTriangles(nullptr, firstVertex, vertexCount, firstInstance, instanceCount);
+    return _numIntersections != previous_numIntersections;
+}
+
+bool RayBatchIntersector::intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t firstInstance, uint32_t instanceCount)
+{
+    const Data* indices = ushort_indices ? static_cast<const Data*>(ushort_indices.get()) : static_cast<const Data*>(uint_indices.get());
+    if (!indices) return false;
+
+    size_t previous_numIntersections = _numIntersections;
+    _intersectTriangles(indices, firstIndex, indexCount, firstInstance, instanceCount);
+    return _numIntersections != previous_numIntersections;
+}
+
+void RayBatchIntersector::_intersectTriangles(const Data* indices, uint32_t first, uint32_t count, uint32_t firstInstance, uint32_t instanceCount)
+{
+    auto& arrayState = *arrayStateStack.back();
+    if (arrayState.topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST || count < 3) return;
+
+    const auto& frame = _frames.back();
+    if (frame.active.empty()) return;
+
+    RayPacket rays;
+    for (size_t i = 0; i < frame.active.size(); ++i)
+    {
+        auto segmentIndex = frame.active[i];
+        rays.add(segmentIndex, frame.local[i].start, frame.local[i].end, _maxRatios[segmentIndex]);
+    }
+    if (rays.size() == 0) return;
+
+    // the node path is the same for all intersections with this draw so only compute the localToWorld once
+    dmat4 localToWorld = computeTransform(_nodePath);
+
+    uint32_t end = first + (count / 3) * 3;
+    if (indices) end = std::min(end, static_cast<uint32_t>(indices->valueCount()));
+
+    auto ushortIndices = ushort_indices.get();
+    auto uintIndices = uint_indices.get();
+    auto vertexIndex = [&](uint32_t i) -> uint32_t {
+        if (!indices) return i;
+        return ushortIndices ? ushortIndices->at(i) : uintIndices->at(i);
+    };
+
+    uint32_t lastIndex = instanceCount > 1 ? (firstInstance + instanceCount) : firstInstance + 1;
+    for (uint32_t instanceIndex = firstInstance; instanceIndex < lastIndex; ++instanceIndex)
+    {
+        auto vertices = arrayState.vertexArray(instanceIndex);
+        if (!vertices) continue;
+
+        uint32_t numVertices = static_cast<uint32_t>(vertices->size());
+
+        auto intersectTriangleIndices = [&](uint32_t i0, uint32_t i1, uint32_t i2, auto intersectRays) {
+            if (i0 >= numVertices || i1 >= numVertices || i2 >= numVertices) return;
+
+            dvec3 v0(vertices->at(i0));
+            dvec3 v1(vertices->at(i1));
+            dvec3 v2(vertices->at(i2));
+
+            intersectRays(v0, v1 - v0, v2 - v0, [&](size_t r, double u, double v, double t) {
+                auto segmentIndex = rays.segments[r];
+                double ratio = t / rays.length[r];
+                double r0 = 1.0 - u - v;
+                dvec3 coord = v0 * r0 + v1 * u + v2 * v;
+
+                auto& segmentIntersections = intersections[segmentIndex];
+                if (closestOnly)
+                {
+                    // shorten the ray so only closer intersections are found in the rest of the traversal
+                    segmentIntersections.clear();
+                    _maxRatios[segmentIndex] = ratio;
+                    rays.tmax[r] = t;
+                }
+
+                segmentIntersections.push_back(Intersection::create(coord, localToWorld * coord, ratio, localToWorld, _nodePath, arrayState.arrays, IndexRatios{{i0, r0}, {i1, u}, {i2, v}}, instanceIndex));
+                ++_numIntersections;
+            });
+        };
+
+        // only vertex arrays used directly can have a cached TriangleBVH, ArrayState subclasses may compute new vertex arrays on each call
+        ref_ptr<const TriangleBVH> bvh;
+        if (useTriangleBVH && vertices == arrayState.vertices) bvh = TriangleBVH::getOrCreate(*vertices, indices, first, count, minimumTrianglesForBVH);
+
+        if (bvh)
+        {
+            // traverse the hierarchy for each ray, testing the candidate triangles with just that ray
+            for (size_t r = 0; r < rays.size(); ++r)
+            {
+                bvh->intersect(rays.start(r), rays.end(r), [&](uint32_t i0, uint32_t i1, uint32_t i2) {
+                    intersectTriangleIndices(i0, i1, i2, [&](const dvec3& v0, const dvec3& e1, const dvec3& e2, auto hit) {
+                        double u, v, t;
+                        if (rays.intersect(r, v0, e1, e2, u, v, t)) hit(r, u, v, t);
+                    });
+                });
+            }
+        }
+        else
+        {
+            // test each triangle against packets of rays
+            for (uint32_t i = first; i + 3 <= end; i += 3)
+            {
+                intersectTriangleIndices(vertexIndex(i), vertexIndex(i + 1), vertexIndex(i + 2), [&](const dvec3& v0, const dvec3& e1, const dvec3& e2, auto hit) {
+                    intersectTriangle(rays, v0, e1, e2, hit);
+                });
+            }
+        }
+    }
+}
@@ -11,12 +11,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 </editor-fold> */
 
 #include <vsg/core/Version.h>
+#include <vsg/core/compare.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
 #include <vsg/nodes/StateGroup.h>
 #include <vsg/raytracing/RayTracingPipeline.h>
 #include <vsg/state/ComputePipeline.h>
 #include <vsg/state/GraphicsPipeline.h>
+#include <vsg/threading/Latch.h>
 #include <vsg/utils/ShaderCompiler.h>
 
 #if VSG_SUPPORTS_ShaderCompiler
@@ -26,7 +28,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #endif
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
+#include <set>
+#include <sstream>
 
 #ifndef VK_API_VERSION_MAJOR
 #    define VK_API_VERSION_MAJOR(version) (((uint32_t)(version) >> 22) & 0x7FU)
@@ -54,8 +60,172 @@ static void s_finalizeProcess()
     }
 }
 
+namespace
+{
+    /// 64 bit FNV-1a hash
+    struct Hash
+    {
+        uint64_t value = 14695981039346656037ull;
+
+        void add(const void* data, size_t size)
+        {
+            auto bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                value ^= bytes[i];
+                value *= 1099511628211ull;
+            }
+        }
+
+        template<typename T>
+        void add(T v) { add(&v, sizeof(T)); }
+
+        void add(const std::string& str)
+        {
+            add(str.size());
+            add(str.data(), str.size());
+        }
+    };
+} // namespace
+
+// compute a key for each stage of the program, as linking can affect the SPIR-V generated the keys depend upon all the stages
+static std::vector<uint64_t> s_spirvCacheKeys(const ShaderStages& shaders, const std::vector<std::string>& finalShaderSources, const ref_ptr<ShaderCompileSettings>& defaults)
+{
+    auto version = glslang::GetVersion();
+
+    Hash program;
+    program.add(version.major);
+    program.add(version.minor);
+    program.add(version.patch);
+    program.add(std::string(version.flavor ? version.flavor : ""));
+
+    for (size_t i = 0; i < shaders.size(); ++i)
+    {
+        auto& vsg_shader = shaders[i];
+        auto settings = vsg_shader->module->hints ? vsg_shader->module->hints : defaults;
+
+        program.add(vsg_shader->stage);
+        program.add(settings->vulkanVersion);
+        program.add(settings->clientInputVersion);
+        program.add(settings->language);
+        program.add(settings->defaultVersion);
+        program.add(settings->target);
+        program.add(settings->forwardCompatible);
+        program.add(settings->generateDebugInfo);
+        program.add(finalShaderSources[i]);
+    }
+
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < shaders.size(); ++i)
+    {
+        Hash stage = program;
+        stage.add(i);
+        stage.add(shaders[i]->stage);
+        keys.push_back(stage.value);
+    }
+    return keys;
+}
+
 #endif
 
+/////////////////////////////////////////////////////////////////////////
+//
+// SpirvCache
+//
+bool SpirvCache::read(uint64_t key, ShaderModule::SPIRV& code, const Path& directory)
+{
+    std::scoped_lock lock(_mutex);
+
+    if (auto itr = _spirv.find(key); itr != _spirv.end())
+    {
+        code = itr->second;
+        return true;
+    }
+
+    auto cacheFilename = filename(key, directory);
+    if (!cacheFilename || !fileExists(cacheFilename)) return false;
+
+    std::ifstream fin(cacheFilename, std::ios::ate | std::ios::binary);
+    if (!fin.is_open()) return false;
+
+    size_t fileSize = fin.tellg();
+    if (fileSize < sizeof(uint32_t) || (fileSize % sizeof(uint32_t)) != 0) return false;
+
+    ShaderModule::SPIRV spirv(fileSize / sizeof(uint32_t));
+    fin.seekg(0);
+    fin.read(reinterpret_cast<char*>(spirv.data()), fileSize);
+    fin.close();
+
+    // discard truncated or foreign files, SPIR-V starts with the magic number 0x07230203
+    if (!fin || spirv.front() != 0x07230203)
+    {
+        warn("SpirvCache::read() ignoring invalid file ", cacheFilename);
+        return false;
+    }
+
+    code = _spirv[key] = std::move(spirv);
+    return true;
+}
+
+void SpirvCache::write(uint64_t key, const ShaderModule::SPIRV& code, const Path& directory)
+{
+    if (code.empty()) return;
+
+    std::scoped_lock lock(_mutex);
+
+    _spirv[key] = code;
+
+    auto cacheFilename = filename(key, directory);
+    if (!cacheFilename) return;
+
+    auto path = filePath(cacheFilename);
+    if (path && !makeDirectory(path))
+    {
+        warn("SpirvCache::write() unable to create directory ", path);
+        return;
+    }
+
+    // write to a temporary file first so that concurrent readers never see a partially written file
+    Path tempFilename = cacheFilename;
+    tempFilename += ".tmp";
+
+    std::ofstream fout(tempFilename, std::ios::out | std::ios::binary);
+    if (!fout.is_open()) return;
+
+    fout.write(reinterpret_cast<const char*>(code.data()), code.size() * sizeof(uint32_t));
+    fout.close();
+
+    std::remove(cacheFilename.string().c_str());
+    std::rename(tempFilename.string().c_str(), cacheFilename.string().c_str());
+}
+
+void SpirvCache::clear()
+{
+    std::scoped_lock lock(_mutex);
+    _spirv.clear();
+}
+
+Path SpirvCache::filename(uint64_t key, const Path& directory)
+{
+    if (!directory) return {};
+
+    std::ostringstream str;
+    str << "spirv_" << std::hex << std::setfill('0') << std::setw(16) << key << ".spv";
+
+    return directory / "shaders" / str.str();
+}
+
+ref_ptr<SpirvCache>& SpirvCache::instance()
+{
+    static ref_ptr<SpirvCache> s_spirvCache = SpirvCache::create();
+    return s_spirvCache;
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ShaderCompiler
+//
+
 std::string debugFormatShaderSource(const std::string& source)
 {
     std::istringstream iss(source);
@@ -73,7 +243,8 @@ std::string debugFormatShaderSource(const std::string& source)
 
 ShaderCompiler::ShaderCompiler() :
     Inherit(),
-    defaults(ShaderCompileSettings::create())
+    defaults(ShaderCompileSettings::create()),
+    spirvCache(SpirvCache::instance())
 {
 }
 
@@ -89,15 +260,22 @@ bool ShaderCompiler::supported() const
     return VSG_SUPPORTS_ShaderCompiler == 1;
 }
 
-#if VSG_SUPPORTS_ShaderCompiler
-bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::string>& defines, ref_ptr<const Options> options)
+void ShaderCompiler::_initialize()
 {
+#if VSG_SUPPORTS_ShaderCompiler
     // need to balance the inits.
     if (!_initialized)
     {
         s_initializeProcess();
         _initialized = true;
     }
+#endif
+}
+
+#if VSG_SUPPORTS_ShaderCompiler
+bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::string>& defines, ref_ptr<const Options> options)
+{
+    _initialize();
 
     auto getFriendlyNameForShader = [](const ref_ptr<ShaderStage>& vsg_shader) {
         switch (vsg_shader->stage)
@@ -121,6 +299,45 @@ bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::strin
         return "";
     };
 
+    // apply includes and defines up front so the final source can be used to look up previously compiled SPIR-V
+    std::vector<std::string> finalShaderSources;
+    for (auto& vsg_shader : shaders)
+    {
+        auto settings = vsg_shader->module->hints ? vsg_shader->module->hints : defaults;
+
+        std::string finalShaderSource = vsg::insertIncludes(vsg_shader->module->source, options);
+
+        std::vector<std::string> combinedDefines(defines);
+        for (auto& define : settings->defines) combinedDefines.push_back(define);
+        if (!combinedDefines.empty()) finalShaderSource = combineSourceAndDefines(finalShaderSource, combinedDefines);
+
+        finalShaderSources.push_back(std::move(finalShaderSource));
+    }
+
+    Path cacheDirectory;
+    std::vector<uint64_t> cacheKeys;
+    if (spirvCache)
+    {
+        cacheDirectory = (options && options->fileCache) ? options->fileCache : spirvCache->fileCache;
+        cacheKeys = s_spirvCacheKeys(shaders, finalShaderSources, defaults);
+
+        std::vector<ShaderModule::SPIRV> cachedCode(shaders.size());
+        bool allCached = !shaders.empty();
+        for (size_t i = 0; i < shaders.size() && allCached; ++i)
+        {
+            allCached = spirvCache->read(cacheKeys[i], cachedCode[i], cacheDirectory);
+        }
+
+        if (allCached)
+        {
+            for (size_t i = 0; i < shaders.size(); ++i)
+            {
+                shaders[i]->module->code = std::move(cachedCode[i]);
+            }
+            return true;
+        }
+    }
+
     using StageShaderMap = std::map<EShLanguage, ref_ptr<ShaderStage>>;
     using TShaders = std::list<std::unique_ptr<glslang::TShader>>;
     TShaders tshaders;
@@ -130,8 +347,9 @@ bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::strin
     StageShaderMap stageShaderMap;
     std::unique_ptr<glslang::TProgram> program(new glslang::TProgram);
 
-    for (auto& vsg_shader : shaders)
+    for (size_t shaderIndex = 0; shaderIndex < shaders.size(); ++shaderIndex)
     {
+        auto& vsg_shader = shaders[shaderIndex];
         EShLanguage envStage = EShLangCount;
 
         glslang::EShTargetLanguageVersion minTargetLanguageVersion = glslang::EShTargetSpv_1_0;
@@ -202,11 +420,7 @@ bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::strin
         shader->setEnvClient(glslang::EShClientVulkan, targetClientVersion);
         shader->setEnvTarget(glslang::EShTargetSpv, targetLanguageVersion);
 
-        std::string finalShaderSource = vsg::insertIncludes(vsg_shader->module->source, options);
-
-        std::vector<std::string> combinedDefines(defines);
-        for (auto& define : settings->defines) combinedDefines.push_back(define);
-        if (!combinedDefines.empty()) finalShaderSource = combineSourceAndDefines(finalShaderSource, combinedDefines);
+        const std::string& finalShaderSource = finalShaderSources[shaderIndex];
 
         const char* str = finalShaderSource.c_str();
         shader->setStrings(&str, 1);
@@ -288,6 +502,14 @@ bool ShaderCompiler::compile(ShaderStages& shaders, const std::vector<std::strin
         }
     }
 
+    if (spirvCache)
+    {
+        for (size_t i = 0; i < shaders.size(); ++i)
+        {
+            spirvCache->write(cacheKeys[i], shaders[i]->module->code, cacheDirectory);
+        }
+    }
+
     return true;
 }
 #else
@@ -306,6 +528,191 @@ bool ShaderCompiler::compile(ref_ptr<ShaderStage> shaderStage, const std::vector
     return compile(stages, defines, options);
 }
 
+static bool s_requiresCompile(const ShaderStages& shaders)
+{
+    for (auto& shaderStage : shaders)
+    {
+        if (shaderStage && shaderStage->module && shaderStage->module->code.empty() && !(shaderStage->module->source.empty())) return true;
+    }
+    return false;
+}
+
+namespace
+{
+    /// order programs so that programs with the same stages, sources and ShaderCompileSettings compare as equal
+    struct ProgramLess
+    {
+        bool operator()(const ShaderStages* lhs, const ShaderStages* rhs) const
+        {
+            if (lhs->size() != rhs->size()) return lhs->size() < rhs->size();
+            for (size_t i = 0; i < lhs->size(); ++i)
+            {
+                auto& lhs_stage = (*lhs)[i];
+                auto& rhs_stage = (*rhs)[i];
+                if (lhs_stage->stage != rhs_stage->stage) return lhs_stage->stage < rhs_stage->stage;
+                if (lhs_stage->module == rhs_stage->module) continue;
+                if (!lhs_stage->module || !rhs_stage->module) return lhs_stage->module < rhs_stage->module;
+                if (int result = lhs_stage->module->source.compare(rhs_stage->module->source); result != 0) return result < 0;
+                if (int result = compare_pointer(lhs_stage->module->hints, rhs_stage->module->hints); result != 0) return result < 0;
+            }
+            return false;
+        }
+    };
+} // namespace
+
+bool ShaderCompiler::compile(std::vector<ShaderStages>& programs, ref_ptr<OperationThreads> operationThreads, ref_ptr<const Options> options)
+{
+    // glslang must be initialized before TShader/TProgram are used from multiple threads
+    _initialize();
+
+    // de-duplicate programs so each combination of stages, sources and settings is only compiled once
+    std::map<const ShaderStages*, std::vector<ShaderStages*>, ProgramLess> uniquePrograms;
+    for (auto& program : programs)
+    {
+        if (s_requiresCompile(program)) uniquePrograms[&program].push_back(&program);
+    }
+
+    if (uniquePrograms.empty()) return true;
+
+    struct CompileOperation : public Operation
+    {
+        CompileOperation(ShaderCompiler* sc, ShaderStages& s, ref_ptr<const Options> o, ref_ptr<Latch> l) :
+            shaderCompiler(sc),
+            shaders(s),
+            options(o),
+            latch(l) {}
+
+        void run() override
+        {
+            result = shaderCompiler->compile(shaders, {}, options);
+            latch->count_down();
+        }
+
+        ShaderCompiler* shaderCompiler;
+        ShaderStages& shaders;
+        ref_ptr<const Options> options;
+        ref_ptr<Latch> latch;
+        bool result = false;
+    };
+
+    bool result = true;
+
+    std::vector<ShaderStages*> remaining;
+    for (auto& entry : uniquePrograms) remaining.push_back(entry.second.front());
+
+    while (!remaining.empty())
+    {
+        // programs sharing a ShaderModule would write to it concurrently, so defer them to a subsequent pass
+        std::set<const ShaderModule*> claimed;
+        std::vector<ShaderStages*> batch;
+        std::vector<ShaderStages*> deferred;
+        for (auto program : remaining)
+        {
+            bool shared = false;
+            for (auto& shaderStage : *program)
+            {
+                if (claimed.count(shaderStage->module.get()) != 0) shared = true;
+            }
+
+            if (shared)
+            {
+                deferred.push_back(program);
+                continue;
+            }
+
+            for (auto& shaderStage : *program) claimed.insert(shaderStage->module.get());
+            batch.push_back(program);
+        }
+
+        if (operationThreads && batch.size() > 1)
+        {
+            // use latch to synchronize this thread with the compile threads
+            auto latch = Latch::create(batch.size());
+
+            std::vector<ref_ptr<CompileOperation>> operations;
+            operations.reserve(batch.size());
+            for (auto program : batch)
+            {
+                operations.emplace_back(new CompileOperation(this, *program, options, latch));
+                operationThreads->add(operations.back());
+            }
+
+            // use this thread to compile programs as well
+            operationThreads->run();
+
+            // wait till all the programs have been compiled
+            latch->wait();
+
+            for (auto& operation : operations)
+            {
+                if (!operation->result) result = false;
+            }
+        }
+        else
+        {
+            for (auto program : batch)
+            {
+                if (!compile(*program, {}, options)) result = false;
+            }
+        }
+
+        remaining.clear();
+        for (auto program : deferred)
+        {
+            if (s_requiresCompile(*program)) remaining.push_back(program);
+        }
+    }
+
+    // assign the SPIR-V to the duplicate programs' ShaderModules
+    for (auto& [program, duplicates] : uniquePrograms)
+    {
+        for (auto duplicate : duplicates)
+        {
+            for (size_t i = 0; i < program->size(); ++i)
+            {
+                auto& module = (*program)[i]->module;
+                auto& duplicate_module = (*duplicate)[i]->module;
+                if (duplicate_module != module && duplicate_module->code.empty()) duplicate_module->code = module->code;
+            }
+        }
+    }
+
+    return result;
+}
+
+bool ShaderCompiler::compileSubgraph(Object& object, ref_ptr<OperationThreads> operationThreads, ref_ptr<const Options> options)
+{
+    _collecting = true;
+    object.accept(*this);
+    _collecting = false;
+
+    std::vector<ShaderStages> programs;
+    programs.swap(_collectedPrograms);
+
+    if (programs.empty()) return true;
+
+    ref_ptr<OperationThreads> temporaryThreads;
+    if (!operationThreads && programs.size() > 1)
+    {
+        uint32_t numThreads = std::min(static_cast<uint32_t>(programs.size()), std::thread::hardware_concurrency());
+        if (numThreads > 1) operationThreads = temporaryThreads = OperationThreads::create(numThreads - 1);
+    }
+
+    bool result = compile(programs, operationThreads, options);
+
+    if (temporaryThreads) temporaryThreads->stop();
+
+    return result;
+}
+
+void ShaderCompiler::_compileOrCollect(ShaderStages& shaders)
+{
+    if (_collecting)
+        _collectedPrograms.push_back(shaders);
+    else
+        compile(shaders); // may need to map defines and paths in some fashion
+}
+
 std::string ShaderCompiler::combineSourceAndDefines(const std::string& source, const std::vector<std::string>& defines)
 {
     if (defines.empty()) return source;
@@ -445,21 +852,9 @@ void ShaderCompiler::apply(BindGraphicsPipeline& bgp)
     if (!pipeline) return;
 
     // compile shaders if required
-    bool requiresShaderCompiler = false;
-    for (auto& shaderStage : pipeline->stages)
+    if (s_requiresCompile(pipeline->stages))
     {
-        if (shaderStage->module)
-        {
-            if (shaderStage->module->code.empty() && !(shaderStage->module->source.empty()))
-            {
-                requiresShaderCompiler = true;
-            }
-        }
-    }
-
-    if (requiresShaderCompiler)
-    {
-        compile(pipeline->stages); // may need to map defines and paths in some fashion
+        _compileOrCollect(pipeline->stages);
     }
 }
 
@@ -468,14 +863,12 @@ void ShaderCompiler::apply(BindComputePipeline& bcp)
     auto pipeline = bcp.pipeline;
     if (!pipeline) return;
 
-    auto stage = pipeline->stage;
+    ShaderStages stages{pipeline->stage};
 
     // compile shaders if required
-    bool requiresShaderCompiler = stage && stage->module && stage->module->code.empty() && !(stage->module->source.empty());
-
-    if (requiresShaderCompiler)
+    if (pipeline->stage && s_requiresCompile(stages))
     {
-        compile(stage); // may need to map defines and paths in some fashion
+        _compileOrCollect(stages);
     }
 }
 
@@ -485,20 +878,8 @@ void ShaderCompiler::apply(BindRayTracingPipeline& brtp)
     if (!pipeline) return;
 
     // compile shaders if required
-    bool requiresShaderCompiler = false;
-    for (auto& shaderStage : pipeline->getShaderStages())
-    {
-        if (shaderStage->module)
-        {
-            if (shaderStage->module->code.empty() && !(shaderStage->module->source.empty()))
-            {
-                requiresShaderCompiler = true;
-            }
-        }
-    }
-
-    if (requiresShaderCompiler)
+    if (s_requiresCompile(pipeline->getShaderStages()))
     {
-        compile(pipeline->getShaderStages()); // may need to map defines and paths in some fashion
+        _compileOrCollect(pipeline->getShaderStages());
     }
 }
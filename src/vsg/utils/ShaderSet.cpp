@@ -26,6 +26,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/state/ViewDependentState.h>
 #include <vsg/state/material.h>
 #include <vsg/utils/ShaderSet.h>
+#include <vsg/utils/SharedObjects.h>
 #include <vsg/vk/Context.h>
 
 #include "shaders/flat_ShaderSet.cpp"
@@ -78,6 +79,17 @@ int PushConstantRange::compare(const PushConstantRange& rhs) const
     return compare_region(range, range, rhs.range);
 }
 
+int SpecializationConstantBinding::compare(const SpecializationConstantBinding& rhs) const
+{
+    if (define < rhs.define) return -1;
+    if (define > rhs.define) return 1;
+
+    if (constantID < rhs.constantID) return -1;
+    if (constantID > rhs.constantID) return 1;
+
+    return compare_value(stageFlags, rhs.stageFlags);
+}
+
 int DefinesArrayState::compare(const DefinesArrayState& rhs) const
 {
     int result = compare_container(defines, rhs.defines);
@@ -158,6 +170,56 @@ ref_ptr<StateCommand> ViewDependentStateBinding::createStateCommand(ref_ptr<Pipe
     return BindViewDescriptorSets::create(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, set);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// BindlessTextureBinding
+//
+BindlessTextureBinding::BindlessTextureBinding(uint32_t in_set, ref_ptr<BindlessTextures> in_textures) :
+    Inherit(in_set),
+    textures(in_textures ? in_textures : BindlessTextures::create())
+{
+}
+
+int BindlessTextureBinding::compare(const Object& rhs_object) const
+{
+    int result = CustomDescriptorSetBinding::compare(rhs_object);
+    if (result != 0) return result;
+
+    auto& rhs = static_cast<decltype(*this)>(rhs_object);
+    if ((result = compare_value(define, rhs.define))) return result;
+    return compare_value(textures, rhs.textures);
+}
+
+void BindlessTextureBinding::read(Input& input)
+{
+    CustomDescriptorSetBinding::read(input);
+
+    input.read("define", define);
+}
+
+void BindlessTextureBinding::write(Output& output) const
+{
+    CustomDescriptorSetBinding::write(output);
+
+    output.write("define", define);
+}
+
+bool BindlessTextureBinding::compatibleDescriptorSetLayout(const DescriptorSetLayout& dsl) const
+{
+    return textures && textures->setLayout->compare(dsl) == 0;
+}
+
+ref_ptr<DescriptorSetLayout> BindlessTextureBinding::createDescriptorSetLayout()
+{
+    return textures ? textures->setLayout : ref_ptr<DescriptorSetLayout>();
+}
+
+ref_ptr<StateCommand> BindlessTextureBinding::createStateCommand(ref_ptr<PipelineLayout> layout)
+{
+    if (!textures) return {};
+    return BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, set, textures);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // ShaderSet
@@ -191,6 +253,11 @@ void ShaderSet::addPushConstantRange(const std::string& name, const std::string&
     pushConstantRanges.push_back(vsg::PushConstantRange{name, define, VkPushConstantRange{stageFlags, offset, size}});
 }
 
+void ShaderSet::addSpecializationConstantBinding(const std::string& define, uint32_t constantID, VkShaderStageFlags stageFlags)
+{
+    specializationConstantBindings.push_back(vsg::SpecializationConstantBinding{define, constantID, stageFlags});
+}
+
 const AttributeBinding& ShaderSet::getAttributeBinding(const std::string& name) const
 {
     for (auto& binding : attributeBindings)
@@ -266,6 +333,51 @@ ShaderStages ShaderSet::getShaderStages(ref_ptr<ShaderCompileSettings> scs)
         return itr->second;
     }
 
+    ref_ptr<ShaderCompileSettings> moduleSettings;
+    if (scs)
+    {
+        for (auto& scb : specializationConstantBindings)
+        {
+            if (scs->defines.count(scb.define) == 0) continue;
+
+            if (!moduleSettings) moduleSettings = ShaderCompileSettings::create(*scs);
+            moduleSettings->defines.erase(scb.define);
+        }
+    }
+
+    if (!moduleSettings) return _getShaderStages(scs);
+
+    // share the ShaderModules compiled without the specialization constant defines, only the ShaderStage's specializationConstants differ
+    auto& module_stages = _getShaderStages(moduleSettings);
+    auto& new_stages = variants[scs];
+    for (auto& stage : module_stages)
+    {
+        auto new_stage = vsg::ShaderStage::create();
+        new_stage->flags = stage->flags;
+        new_stage->stage = stage->stage;
+        new_stage->module = stage->module;
+        new_stage->entryPointName = stage->entryPointName;
+        new_stage->specializationConstants = stage->specializationConstants;
+        for (auto& scb : specializationConstantBindings)
+        {
+            if ((scb.stageFlags & stage->stage) != 0 && scs->defines.count(scb.define) != 0)
+            {
+                new_stage->specializationConstants[scb.constantID] = uintValue::create(VK_TRUE);
+            }
+        }
+        new_stages.push_back(new_stage);
+    }
+
+    return new_stages;
+}
+
+ShaderStages& ShaderSet::_getShaderStages(ref_ptr<ShaderCompileSettings> scs)
+{
+    if (auto itr = variants.find(scs); itr != variants.end())
+    {
+        return itr->second;
+    }
+
     auto& new_stages = variants[scs];
     for (auto& stage : stages)
     {
@@ -288,6 +400,27 @@ ShaderStages ShaderSet::getShaderStages(ref_ptr<ShaderCompileSettings> scs)
     return new_stages;
 }
 
+ref_ptr<ShaderSet> ShaderSet::sharedCopy()
+{
+    auto copy = ShaderSet::create();
+    copy->stages = stages;
+    copy->attributeBindings = attributeBindings;
+    copy->descriptorBindings = descriptorBindings;
+    copy->pushConstantRanges = pushConstantRanges;
+    copy->specializationConstantBindings = specializationConstantBindings;
+    copy->definesArrayStates = definesArrayStates;
+    copy->optionalDefines = optionalDefines;
+    copy->defaultGraphicsPipelineStates = defaultGraphicsPipelineStates;
+    copy->customDescriptorSetBindings = customDescriptorSetBindings;
+    copy->subpass = subpass;
+    copy->defaultShaderHints = defaultShaderHints;
+
+    std::scoped_lock<std::mutex> lock(mutex);
+    copy->variants = variants;
+
+    return copy;
+}
+
 int ShaderSet::compare(const Object& rhs_object) const
 {
     int result = Object::compare(rhs_object);
@@ -298,8 +431,10 @@ int ShaderSet::compare(const Object& rhs_object) const
     if ((result = compare_container(attributeBindings, rhs.attributeBindings))) return result;
     if ((result = compare_container(descriptorBindings, rhs.descriptorBindings))) return result;
     if ((result = compare_container(pushConstantRanges, rhs.pushConstantRanges))) return result;
+    if ((result = compare_container(specializationConstantBindings, rhs.specializationConstantBindings))) return result;
     if ((result = compare_container(definesArrayStates, rhs.definesArrayStates))) return result;
     if ((result = compare_container(optionalDefines, rhs.optionalDefines))) return result;
+    if ((result = compare_value(subpass, rhs.subpass))) return result;
     return compare_pointer_container(defaultGraphicsPipelineStates, rhs.defaultGraphicsPipelineStates);
 }
 
@@ -381,6 +516,23 @@ void ShaderSet::read(Input& input)
             }
         }
     }
+
+    if (input.version_greater_equal(1, 1, 10))
+    {
+        input.read("subpass", subpass);
+    }
+
+    if (input.version_greater_equal(1, 1, 12))
+    {
+        auto num_specializationConstantBindings = input.readValue<uint32_t>("specializationConstantBindings");
+        specializationConstantBindings.resize(num_specializationConstantBindings);
+        for (auto& scb : specializationConstantBindings)
+        {
+            input.read("define", scb.define);
+            input.read("constantID", scb.constantID);
+            input.readValue<uint32_t>("stageFlags", scb.stageFlags);
+        }
+    }
 }
 
 void ShaderSet::write(Output& output) const
@@ -452,6 +604,37 @@ void ShaderSet::write(Output& output) const
             output.writeObject("customDescriptorSetBinding", custom);
         }
     }
+
+    if (output.version_greater_equal(1, 1, 10))
+    {
+        output.write("subpass", subpass);
+    }
+
+    if (output.version_greater_equal(1, 1, 12))
+    {
+        output.writeValue<uint32_t>("specializationConstantBindings", specializationConstantBindings.size());
+        for (auto& scb : specializationConstantBindings)
+        {
+            output.write("define", scb.define);
+            output.write("constantID", scb.constantID);
+            output.writeValue<uint32_t>("stageFlags", scb.stageFlags);
+        }
+    }
+}
+
+ref_ptr<ShaderSet> vsg::createSharedShaderSet(const std::string& name, ref_ptr<const Options> options, ref_ptr<ShaderSet> (*create)())
+{
+    if (!options || !options->sharedObjects) return create();
+
+    // parse the ShaderSet once per SharedObjects and share its precompiled variants with all the ShaderSets returned,
+    // the cached ShaderSet doesn't depend on the options so they aren't included in the key.
+    auto loadedObject = LoadedObject::create(Path(name), ref_ptr<const Options>());
+    options->sharedObjects->share(loadedObject, [&](auto load) {
+        load->object = create();
+    });
+
+    auto shaderSet = loadedObject->object.cast<ShaderSet>();
+    return shaderSet ? shaderSet->sharedCopy() : shaderSet;
 }
 
 ref_ptr<ShaderSet> vsg::createFlatShadedShaderSet(ref_ptr<const Options> options)
@@ -461,7 +644,8 @@ ref_ptr<ShaderSet> vsg::createFlatShadedShaderSet(ref_ptr<const Options> options
         // check if a ShaderSet has already been assigned to the options object, if so return it
         if (auto itr = options->shaderSets.find("flat"); itr != options->shaderSets.end()) return itr->second;
     }
-    return flat_ShaderSet();
+
+    return createSharedShaderSet("vsg::createFlatShadedShaderSet", options, flat_ShaderSet);
 }
 
 ref_ptr<ShaderSet> vsg::createPhongShaderSet(ref_ptr<const Options> options)
@@ -472,7 +656,7 @@ ref_ptr<ShaderSet> vsg::createPhongShaderSet(ref_ptr<const Options> options)
         if (auto itr = options->shaderSets.find("phong"); itr != options->shaderSets.end()) return itr->second;
     }
 
-    return phong_ShaderSet();
+    return createSharedShaderSet("vsg::createPhongShaderSet", options, phong_ShaderSet);
 }
 
 ref_ptr<ShaderSet> vsg::createPhysicsBasedRenderingShaderSet(ref_ptr<const Options> options)
@@ -483,7 +667,182 @@ ref_ptr<ShaderSet> vsg::createPhysicsBasedRenderingShaderSet(ref_ptr<const Optio
         if (auto itr = options->shaderSets.find("pbr"); itr != options->shaderSets.end()) return itr->second;
     }
 
-    return pbr_ShaderSet();
+    return createSharedShaderSet("vsg::createPhysicsBasedRenderingShaderSet", options, pbr_ShaderSet);
+}
+
+namespace
+{
+    const char* multiview_vert = R"(
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_multiview : enable
+
+#pragma import_defines (VSG_INSTANCE_POSITIONS, VSG_BILLBOARD, VSG_DISPLACEMENT_MAP)
+
+#define VIEW_DESCRIPTOR_SET 0
+#define MATERIAL_DESCRIPTOR_SET 1
+
+layout(push_constant) uniform PushConstants {
+    mat4 projection;
+    mat4 modelView;
+} pc;
+
+// ViewDependentState::multiviewData, projection and relative view matrix pairs for each view
+layout(set = VIEW_DESCRIPTOR_SET, binding = 4) uniform MultiviewData
+{
+    mat4 matrices[8];
+} multiview;
+
+#ifdef VSG_DISPLACEMENT_MAP
+layout(set = MATERIAL_DESCRIPTOR_SET, binding = 6) uniform sampler2D displacementMap;
+#endif
+
+layout(location = 0) in vec3 vsg_Vertex;
+layout(location = 1) in vec3 vsg_Normal;
+layout(location = 2) in vec2 vsg_TexCoord0;
+layout(location = 3) in vec4 vsg_Color;
+
+
+#ifdef VSG_BILLBOARD
+layout(location = 4) in vec4 vsg_position_scaleDistance;
+#elif defined(VSG_INSTANCE_POSITIONS)
+layout(location = 4) in vec3 vsg_position;
+#endif
+
+layout(location = 0) out vec3 eyePos;
+layout(location = 1) out vec3 normalDir;
+layout(location = 2) out vec4 vertexColor;
+layout(location = 3) out vec2 texCoord0;
+
+layout(location = 5) out vec3 viewDir;
+
+out gl_PerVertex{ vec4 gl_Position; };
+
+#ifdef VSG_BILLBOARD
+mat4 computeBillboadMatrix(vec4 center_eye, float autoScaleDistance)
+{
+    float distance = -center_eye.z;
+
+    float scale = (distance < autoScaleDistance) ? distance/autoScaleDistance : 1.0;
+    mat4 S = mat4(scale, 0.0, 0.0, 0.0,
+                  0.0, scale, 0.0, 0.0,
+                  0.0, 0.0, scale, 0.0,
+                  0.0, 0.0, 0.0, 1.0);
+
+    mat4 T = mat4(1.0, 0.0, 0.0, 0.0,
+                  0.0, 1.0, 0.0, 0.0,
+                  0.0, 0.0, 1.0, 0.0,
+                  center_eye.x, center_eye.y, center_eye.z, 1.0);
+    return T*S;
+}
+#endif
+
+void main()
+{
+    vec4 vertex = vec4(vsg_Vertex, 1.0);
+    vec4 normal = vec4(vsg_Normal, 0.0);
+
+#ifdef VSG_DISPLACEMENT_MAP
+    // TODO need to pass as as uniform or per instance attributes
+    vec3 scale = vec3(1.0, 1.0, 1.0);
+
+    vertex.xyz = vertex.xyz + vsg_Normal * (texture(displacementMap, vsg_TexCoord0.st).s * scale.z);
+
+    float s_delta = 0.01;
+    float width = 0.0;
+
+    float s_left = max(vsg_TexCoord0.s - s_delta, 0.0);
+    float s_right = min(vsg_TexCoord0.s + s_delta, 1.0);
+    float t_center = vsg_TexCoord0.t;
+    float delta_left_right = (s_right - s_left) * scale.x;
+    float dz_left_right = (texture(displacementMap, vec2(s_right, t_center)).s - texture(displacementMap, vec2(s_left, t_center)).s) * scale.z;
+
+    // TODO need to handle different origins of displacementMap vs diffuseMap etc,
+    float t_delta = s_delta;
+    float t_bottom = max(vsg_TexCoord0.t - t_delta, 0.0);
+    float t_top = min(vsg_TexCoord0.t + t_delta, 1.0);
+    float s_center = vsg_TexCoord0.s;
+    float delta_bottom_top = (t_top - t_bottom) * scale.y;
+    float dz_bottom_top = (texture(displacementMap, vec2(s_center, t_top)).s - texture(displacementMap, vec2(s_center, t_bottom)).s) * scale.z;
+
+    vec3 dx = normalize(vec3(delta_left_right, 0.0, dz_left_right));
+    vec3 dy = normalize(vec3(0.0, delta_bottom_top, -dz_bottom_top));
+    vec3 dz = normalize(cross(dx, dy));
+
+    normal.xyz = normalize(dx * vsg_Normal.x + dy * vsg_Normal.y + dz * vsg_Normal.z);
+#endif
+
+#ifdef VSG_INSTANCE_POSITIONS
+    vertex.xyz = vertex.xyz + vsg_position;
+#endif
+
+#ifdef VSG_BILLBOARD
+    mat4 mv = computeBillboadMatrix(pc.modelView * vec4(vsg_position_scaleDistance.xyz, 1.0), vsg_position_scaleDistance.w);
+#else
+    mat4 mv = pc.modelView;
+#endif
+
+    mat4 projection = multiview.matrices[gl_ViewIndex * 2];
+    mat4 viewOffset = multiview.matrices[gl_ViewIndex * 2 + 1];
+
+    // lighting is computed in the View's camera eye coordinates, with the view direction from this view's eye point
+    vec3 viewOrigin = -(transpose(mat3(viewOffset)) * viewOffset[3].xyz);
+
+    gl_Position = (projection * viewOffset * mv) * vertex;
+    eyePos = (mv * vertex).xyz;
+    viewDir = viewOrigin - eyePos;
+    normalDir = (mv * normal).xyz;
+
+    vertexColor = vsg_Color;
+    texCoord0 = vsg_TexCoord0;
+}
+)";
+} // namespace
+
+ref_ptr<ShaderSet> vsg::createMultiviewShaderSet(ref_ptr<ShaderSet> base)
+{
+    if (!base) return {};
+
+    ShaderStages stages;
+    stages.push_back(ShaderStage::create(VK_SHADER_STAGE_VERTEX_BIT, "main", multiview_vert));
+    for (auto& stage : base->stages)
+    {
+        if (stage->stage != VK_SHADER_STAGE_VERTEX_BIT) stages.push_back(stage);
+    }
+
+    // the multiviewData binding is provided by the ViewDependentState's descriptor set so the base ShaderSet's bindings can be shared
+    auto shaderSet = ShaderSet::create(stages, base->defaultShaderHints);
+    shaderSet->attributeBindings = base->attributeBindings;
+    shaderSet->descriptorBindings = base->descriptorBindings;
+    shaderSet->pushConstantRanges = base->pushConstantRanges;
+    shaderSet->definesArrayStates = base->definesArrayStates;
+    shaderSet->optionalDefines = base->optionalDefines;
+    shaderSet->defaultGraphicsPipelineStates = base->defaultGraphicsPipelineStates;
+    shaderSet->customDescriptorSetBindings = base->customDescriptorSetBindings;
+
+    return shaderSet;
+}
+
+ref_ptr<ShaderSet> vsg::createMultiviewPhongShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("multiview_phong"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    return createMultiviewShaderSet(createPhongShaderSet(options));
+}
+
+ref_ptr<ShaderSet> vsg::createMultiviewPhysicsBasedRenderingShaderSet(ref_ptr<const Options> options)
+{
+    if (options)
+    {
+        // check if a ShaderSet has already been assigned to the options object, if so return it
+        if (auto itr = options->shaderSets.find("multiview_pbr"); itr != options->shaderSets.end()) return itr->second;
+    }
+
+    return createMultiviewShaderSet(createPhysicsBasedRenderingShaderSet(options));
 }
 
 std::pair<uint32_t, uint32_t> ShaderSet::descriptorSetRange() const
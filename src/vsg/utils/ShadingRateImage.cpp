@@ -0,0 +1,216 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/utils/ShadingRateImage.h>
+#include <vsg/vk/Context.h>
+
+using namespace vsg;
+
+namespace
+{
+    const char* shadingRate_comp = R"(
+#version 450
+#pragma import_defines (VSG_CONTENT_ADAPTIVE)
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(push_constant) uniform PushConstants
+{
+    vec2 center;
+    float innerRadius;
+    float outerRadius;
+    float lowContrastThreshold;
+    float mediumContrastThreshold;
+    uint foveated;
+} pc;
+
+layout(set = 0, binding = 0, r8ui) uniform writeonly uimage2D shadingRateImage;
+
+#ifdef VSG_CONTENT_ADAPTIVE
+layout(set = 0, binding = 1) uniform sampler2D sourceImage;
+#endif
+
+// VK_KHR_fragment_shading_rate encoding of (log2(width) << 2) | log2(height)
+const uint RATE_1X1 = 0;
+const uint RATE_2X2 = 5;
+const uint RATE_4X4 = 10;
+
+void main()
+{
+    ivec2 size = imageSize(shadingRateImage);
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if (texel.x >= size.x || texel.y >= size.y) return;
+
+    vec2 texelScale = 1.0 / vec2(size);
+    uint rate = RATE_1X1;
+
+    if (pc.foveated != 0)
+    {
+        // distance relative to the height so the foveal region is circular
+        vec2 delta = ((vec2(texel) + 0.5) * texelScale - pc.center) * vec2(float(size.x) / float(size.y), 1.0);
+        float distance = length(delta);
+        rate = (distance < pc.innerRadius) ? RATE_1X1 : ((distance < pc.outerRadius) ? RATE_2X2 : RATE_4X4);
+    }
+
+#ifdef VSG_CONTENT_ADAPTIVE
+    // luminance range of a 4x4 grid of samples across the region covered by the texel
+    float minLuminance = 1e10;
+    float maxLuminance = -1e10;
+    for (int j = 0; j < 4; ++j)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            vec2 uv = (vec2(texel) + (vec2(i, j) + 0.5) * 0.25) * texelScale;
+            float luminance = dot(textureLod(sourceImage, uv, 0.0).rgb, vec3(0.2126, 0.7152, 0.0722));
+            minLuminance = min(minLuminance, luminance);
+            maxLuminance = max(maxLuminance, luminance);
+        }
+    }
+
+    float contrast = maxLuminance - minLuminance;
+    uint contentRate = (contrast < pc.lowContrastThreshold) ? RATE_4X4 : ((contrast < pc.mediumContrastThreshold) ? RATE_2X2 : RATE_1X1);
+
+    // the encoded rates increase with fragment size so max() selects the coarser rate
+    rate = (pc.foveated != 0) ? max(rate, contentRate) : contentRate;
+#endif
+
+    imageStore(shadingRateImage, texel, uvec4(rate));
+}
+)";
+
+    struct ShadingRatePushConstants
+    {
+        vec2 center;
+        float innerRadius;
+        float outerRadius;
+        float lowContrastThreshold;
+        float mediumContrastThreshold;
+        uint32_t foveated;
+    };
+} // namespace
+
+ShadingRateImage::ShadingRateImage(const VkExtent2D& in_framebufferExtent, const VkExtent2D& in_texelSize) :
+    framebufferExtent(in_framebufferExtent),
+    texelSize(in_texelSize)
+{
+    uint32_t width = std::max(1u, (framebufferExtent.width + texelSize.width - 1) / std::max(1u, texelSize.width));
+    uint32_t height = std::max(1u, (framebufferExtent.height + texelSize.height - 1) / std::max(1u, texelSize.height));
+
+    auto image = Image::create();
+    image->imageType = VK_IMAGE_TYPE_2D;
+    image->format = VK_FORMAT_R8_UINT;
+    image->extent = VkExtent3D{width, height, 1};
+    image->mipLevels = 1;
+    image->arrayLayers = 1;
+    image->samples = VK_SAMPLE_COUNT_1_BIT;
+    image->tiling = VK_IMAGE_TILING_OPTIMAL;
+    image->usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR;
+    image->initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image->sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    imageView = ImageView::create(image, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    VkImageSubresourceRange subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    // the whole image is rewritten each frame so its previous contents can be discarded once the previous frame's rendering has read it
+    _preComputeBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                                 ImageMemoryBarrier::create(0, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL,
+                                                                            VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, subresourceRange));
+
+    _postComputeBarrier = PipelineBarrier::create(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR, 0,
+                                                  ImageMemoryBarrier::create(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR,
+                                                                             VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image, subresourceRange));
+}
+
+AttachmentDescription ShadingRateImage::attachmentDescription() const
+{
+    AttachmentDescription attachment = {};
+    attachment.format = VK_FORMAT_R8_UINT;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+    attachment.finalLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR;
+    return attachment;
+}
+
+void ShadingRateImage::compile(Context& context)
+{
+    if (_bindPipeline)
+    {
+        _bindPipeline->compile(context);
+        _bindDescriptorSet->compile(context);
+        return;
+    }
+
+    if (!context.device->getPhysicalDevice()->supportsDeviceExtension(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME))
+    {
+        warn("ShadingRateImage::compile(..) VK_KHR_fragment_shading_rate not supported by device.");
+    }
+
+    DescriptorSetLayoutBindings bindings{
+        {0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}};
+
+    Descriptors descriptors{
+        DescriptorImage::create(ImageInfo::create(ref_ptr<Sampler>(), imageView, VK_IMAGE_LAYOUT_GENERAL), 0, 0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)};
+
+    auto computeShader = ShaderStage::create(VK_SHADER_STAGE_COMPUTE_BIT, "main", shadingRate_comp);
+    if (sourceImage)
+    {
+        bindings.push_back(VkDescriptorSetLayoutBinding{1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr});
+        descriptors.push_back(DescriptorImage::create(sourceImage, 1, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER));
+
+        computeShader->module->hints = ShaderCompileSettings::create();
+        computeShader->module->hints->defines.insert("VSG_CONTENT_ADAPTIVE");
+    }
+
+    auto descriptorSetLayout = DescriptorSetLayout::create(bindings);
+
+    PushConstantRanges pushConstantRanges{
+        {VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ShadingRatePushConstants)}};
+    _pipelineLayout = PipelineLayout::create(DescriptorSetLayouts{descriptorSetLayout}, pushConstantRanges);
+
+    _bindPipeline = BindComputePipeline::create(ComputePipeline::create(_pipelineLayout, computeShader));
+    _bindDescriptorSet = BindDescriptorSet::create(VK_PIPELINE_BIND_POINT_COMPUTE, _pipelineLayout, 0, DescriptorSet::create(descriptorSetLayout, descriptors));
+
+    _bindPipeline->compile(context);
+    _bindDescriptorSet->compile(context);
+}
+
+void ShadingRateImage::record(CommandBuffer& commandBuffer) const
+{
+    if (!_bindPipeline) return;
+
+    ShadingRatePushConstants pushConstants;
+    pushConstants.center = center;
+    pushConstants.innerRadius = innerRadius;
+    pushConstants.outerRadius = outerRadius;
+    pushConstants.lowContrastThreshold = lowContrastThreshold;
+    pushConstants.mediumContrastThreshold = mediumContrastThreshold;
+    pushConstants.foveated = foveated ? 1 : 0;
+
+    auto& extent = imageView->image->extent;
+
+    _preComputeBarrier->record(commandBuffer);
+
+    _bindPipeline->record(commandBuffer);
+    _bindDescriptorSet->record(commandBuffer);
+    vkCmdPushConstants(commandBuffer, _pipelineLayout->vk(commandBuffer.deviceID), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ShadingRatePushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, (extent.width + workgroupSize - 1) / workgroupSize, (extent.height + workgroupSize - 1) / workgroupSize, 1);
+
+    _postComputeBarrier->record(commandBuffer);
+}
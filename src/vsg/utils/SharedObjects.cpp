@@ -1,4 +1,5 @@
 
+#include <vsg/io/HashOutput.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
 #include <vsg/utils/SharedObjects.h>
@@ -19,70 +20,110 @@ bool SharedObjects::suitable(const Path& filename) const
     return excludedExtensions.count(vsg::lowerCaseFileExtension(filename)) == 0;
 }
 
-bool SharedObjects::contains(const Path& filename, ref_ptr<const Options> options) const
+SharedObjects::Table& SharedObjects::_getTable(const std::type_index& type)
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
+    {
+        std::shared_lock<std::shared_mutex> lock(_tablesMutex);
+        if (auto itr = _tables.find(type); itr != _tables.end()) return *(itr->second);
+    }
 
-    auto loadedObject_id = std::type_index(typeid(LoadedObject));
-    auto itr = _sharedObjects.find(loadedObject_id);
-    if (itr == _sharedObjects.end()) return false;
+    std::unique_lock<std::shared_mutex> lock(_tablesMutex);
+    auto& table = _tables[type];
+    if (!table) table = std::make_unique<Table>();
+    return *table;
+}
 
-    auto& loadedObjects = itr->second;
-    auto key = LoadedObject::create(filename, options);
-    return loadedObjects.find(key) != loadedObjects.end();
+ref_ptr<Object> SharedObjects::_share(const std::type_index& type, ref_ptr<Object> object, bool insert)
+{
+    // compute the hash before taking the lock as hashing large objects can take a while
+    auto hash_value = vsg::hash(object.get());
+
+    auto& table = _getTable(type);
+    std::scoped_lock<std::mutex> lock(table.mutex);
+
+    auto [begin, end] = table.objects.equal_range(hash_value);
+    for (auto itr = begin; itr != end; ++itr)
+    {
+        if (itr->second == object) return {};
+        if (itr->second->compare(*object) == 0) return itr->second;
+    }
+
+    if (insert) table.objects.emplace(hash_value, object);
+    return {};
 }
 
-void SharedObjects::add(ref_ptr<Object> object, const Path& filename, ref_ptr<const Options> options)
+bool SharedObjects::contains(const Path& filename, ref_ptr<const Options> options) const
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
+    auto key = LoadedObject::create(filename, options);
+    auto hash_value = vsg::hash(key.get());
 
-    auto loadedObject_id = std::type_index(typeid(LoadedObject));
-    auto& loadedObjects = _sharedObjects[loadedObject_id];
+    std::shared_lock<std::shared_mutex> tables_lock(_tablesMutex);
+    auto itr = _tables.find(std::type_index(typeid(LoadedObject)));
+    if (itr == _tables.end()) return false;
+
+    auto& table = *(itr->second);
+    std::scoped_lock<std::mutex> lock(table.mutex);
 
+    auto [begin, end] = table.objects.equal_range(hash_value);
+    for (auto lo_itr = begin; lo_itr != end; ++lo_itr)
+    {
+        if (lo_itr->second->compare(*key) == 0) return true;
+    }
+    return false;
+}
+
+void SharedObjects::add(ref_ptr<Object> object, const Path& filename, ref_ptr<const Options> options)
+{
     auto key = LoadedObject::create(filename, options, object);
-    loadedObjects.insert(key);
+    _share(std::type_index(typeid(LoadedObject)), key, true);
 }
 
 bool SharedObjects::remove(const Path& filename, ref_ptr<const Options> options)
 {
-    std::scoped_lock<std::recursive_mutex> lock(_mutex);
+    auto key = LoadedObject::create(filename, options);
+    auto hash_value = vsg::hash(key.get());
 
-    auto loadedObject_id = std::type_index(typeid(LoadedObject));
-    auto itr = _sharedObjects.find(loadedObject_id);
-    if (itr == _sharedObjects.end()) return false;
+    std::shared_lock<std::shared_mutex> tables_lock(_tablesMutex);
+    auto itr = _tables.find(std::type_index(typeid(LoadedObject)));
+    if (itr == _tables.end()) return false;
 
-    auto& loadedObjects = itr->second;
+    auto& table = *(itr->second);
+    std::scoped_lock<std::mutex> lock(table.mutex);
 
-    auto key = LoadedObject::create(filename, options);
-    if (auto lo_itr = loadedObjects.find(key); lo_itr != loadedObjects.end())
+    auto [begin, end] = table.objects.equal_range(hash_value);
+    for (auto lo_itr = begin; lo_itr != end; ++lo_itr)
     {
-        loadedObjects.erase(lo_itr);
-        return true;
-    }
-    else
-    {
-        return false;
+        if (lo_itr->second->compare(*key) == 0)
+        {
+            table.objects.erase(lo_itr);
+            return true;
+        }
     }
+    return false;
 }
 
 void SharedObjects::clear()
 {
     std::scoped_lock<std::recursive_mutex> lock(_mutex);
     _defaults.clear();
-    _sharedObjects.clear();
+
+    std::unique_lock<std::shared_mutex> tables_lock(_tablesMutex);
+    _tables.clear();
 }
 
 void SharedObjects::prune()
 {
     std::scoped_lock<std::recursive_mutex> lock(_mutex);
+    std::unique_lock<std::shared_mutex> tables_lock(_tablesMutex);
 
     auto loadedObject_id = std::type_index(typeid(LoadedObject));
 
     // record observer pointers for each LoadedObject object so we can clear them to prevent local references keeping them from being pruned
-    auto& loadedObjects = _sharedObjects[loadedObject_id];
-    std::vector<observer_ptr<Object>> observedLoadedObjects(loadedObjects.size());
+    auto& loadedObjects = _tables[loadedObject_id];
+    if (!loadedObjects) loadedObjects = std::make_unique<Table>();
+    std::vector<observer_ptr<Object>> observedLoadedObjects(loadedObjects->objects.size());
     auto observedLoadedObject_itr = observedLoadedObjects.begin();
-    for (auto& object : loadedObjects)
+    for (auto& [hash_value, object] : loadedObjects->objects)
     {
         auto& loadedObject = static_cast<LoadedObject&>(*object);
         *(observedLoadedObject_itr++) = loadedObject.object;
@@ -103,17 +144,19 @@ void SharedObjects::prune()
     do
     {
         prunedObjects = false;
-        for (auto itr = _sharedObjects.begin(); itr != _sharedObjects.end(); ++itr)
+        for (auto itr = _tables.begin(); itr != _tables.end(); ++itr)
         {
             auto id = itr->first;
             if (id != loadedObject_id)
             {
-                auto& objects = itr->second;
-                for (auto object_itr = itr->second.begin(); object_itr != itr->second.end();)
+                auto& table = *(itr->second);
+                std::scoped_lock<std::mutex> table_lock(table.mutex);
+
+                for (auto object_itr = table.objects.begin(); object_itr != table.objects.end();)
                 {
-                    if ((*object_itr)->referenceCount() == 1)
+                    if (object_itr->second->referenceCount() == 1)
                     {
-                        object_itr = objects.erase(object_itr);
+                        object_itr = table.objects.erase(object_itr);
                         prunedObjects = true;
                     }
                     else
@@ -126,13 +169,13 @@ void SharedObjects::prune()
     } while (prunedObjects);
 
     observedLoadedObject_itr = observedLoadedObjects.begin();
-    for (auto object_itr = loadedObjects.begin(); object_itr != loadedObjects.end();)
+    for (auto object_itr = loadedObjects->objects.begin(); object_itr != loadedObjects->objects.end();)
     {
-        auto& loadedObject = static_cast<LoadedObject&>(*(*object_itr));
+        auto& loadedObject = static_cast<LoadedObject&>(*(object_itr->second));
         loadedObject.object = *(observedLoadedObject_itr++);
         if (!loadedObject.object)
         {
-            object_itr = loadedObjects.erase(object_itr);
+            object_itr = loadedObjects->objects.erase(object_itr);
         }
         else
         {
@@ -162,14 +205,16 @@ void SharedObjects::report(std::ostream& out)
         out << "    " << type.name() << ", object = " << object << " " << object->referenceCount() << std::endl;
     }
 
-    out << "SharedObjects::_sharedObjects " << SharedObjects::_sharedObjects.size() << std::endl;
-    for (auto& [type, objects] : _sharedObjects)
+    std::shared_lock<std::shared_mutex> tables_lock(_tablesMutex);
+    out << "SharedObjects::_tables " << _tables.size() << std::endl;
+    for (auto& [type, table] : _tables)
     {
-        out << "    " << type.name() << ", objects = " << objects.size() << std::endl;
-        for (auto& object : objects)
+        std::scoped_lock<std::mutex> table_lock(table->mutex);
+        out << "    " << type.name() << ", objects = " << table->objects.size() << ", buckets = " << table->objects.bucket_count() << std::endl;
+        for (auto& [hash_value, object] : table->objects)
         {
             out << "        object = " << object << " "
-                << " " << object->referenceCount() << std::endl;
+                << " " << object->referenceCount() << ", hash = " << hash_value << std::endl;
         }
     }
 }
@@ -206,6 +251,11 @@ int LoadedObject::compare(const Object& rhs_object) const
     return compare_pointer(options, rhs.options);
 }
 
+void LoadedObject::write(Output& output) const
+{
+    output.write("filename", filename);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // SuitableForSharing
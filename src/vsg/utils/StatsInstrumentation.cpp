@@ -0,0 +1,505 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/ui/FrameStamp.h>
+#include <vsg/utils/StatsInstrumentation.h>
+#include <vsg/vk/CommandBuffer.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+
+using namespace vsg;
+
+namespace
+{
+    // durations are binned into a logarithmic histogram with two bins per power of two nanoseconds, used to estimate percentiles
+    constexpr size_t numBuckets = 64;
+
+    size_t bucketIndex(uint64_t nanoseconds)
+    {
+        if (nanoseconds < 2) return static_cast<size_t>(nanoseconds);
+
+        uint32_t msb = 1;
+        while ((nanoseconds >> (msb + 1)) != 0) ++msb;
+        return std::min(static_cast<size_t>(msb) * 2 + static_cast<size_t>((nanoseconds >> (msb - 1)) & 1), numBuckets - 1);
+    }
+
+    double bucketMilliseconds(size_t index)
+    {
+        if (index < 2) return static_cast<double>(index) * 1e-6;
+
+        size_t msb = index / 2;
+        double width = static_cast<double>(uint64_t(1) << (msb - 1));
+        double lower = static_cast<double>(2 + (index & 1)) * width;
+        return (lower + width * 0.5) * 1e-6;
+    }
+
+    uint64_t nowNanoseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count());
+    }
+
+    std::string escape(const char* str)
+    {
+        std::string result;
+        if (!str) return result;
+        for (; *str != 0; ++str)
+        {
+            if (*str == '"' || *str == '\\') result.push_back('\\');
+            result.push_back(*str);
+        }
+        return result;
+    }
+
+    std::atomic_uint64_t s_nextStatsInstrumentationID{1};
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////
+//
+// StatsInstrumentation::Accumulator
+//
+/// aggregated durations of a SourceLocation, only written by one thread at a time but may be read by any thread.
+struct StatsInstrumentation::Accumulator
+{
+    Accumulator()
+    {
+        for (auto& bucket : histogram) bucket.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<const SourceLocation*> sourceLocation{nullptr};
+    std::atomic_uint64_t count{0};
+    std::atomic_uint64_t total{0};
+    std::atomic_uint64_t minimum{std::numeric_limits<uint64_t>::max()};
+    std::atomic_uint64_t maximum{0};
+    std::array<std::atomic_uint32_t, numBuckets> histogram;
+
+    void add(uint64_t nanoseconds)
+    {
+        // single writer so plain loads and stores are sufficient, avoiding the cost of atomic read-modify-write operations
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total.store(total.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+        if (nanoseconds < minimum.load(std::memory_order_relaxed)) minimum.store(nanoseconds, std::memory_order_relaxed);
+        if (nanoseconds > maximum.load(std::memory_order_relaxed)) maximum.store(nanoseconds, std::memory_order_relaxed);
+        auto& bucket = histogram[bucketIndex(nanoseconds)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Statistics statistics(const SourceLocation* sl, const std::string& thread, bool gpu) const
+    {
+        Statistics stats;
+        stats.sourceLocation = sl;
+        stats.thread = thread;
+        stats.gpu = gpu;
+        stats.count = count.load(std::memory_order_relaxed);
+        if (stats.count == 0) return stats;
+
+        stats.total = static_cast<double>(total.load(std::memory_order_relaxed)) * 1e-6;
+        stats.minimum = static_cast<double>(minimum.load(std::memory_order_relaxed)) * 1e-6;
+        stats.maximum = static_cast<double>(maximum.load(std::memory_order_relaxed)) * 1e-6;
+
+        std::array<uint64_t, numBuckets> counts;
+        uint64_t histogramCount = 0;
+        for (size_t i = 0; i < numBuckets; ++i) histogramCount += (counts[i] = histogram[i].load(std::memory_order_relaxed));
+
+        auto percentile = [&](double fraction) {
+            auto target = static_cast<uint64_t>(fraction * static_cast<double>(histogramCount - 1));
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i < numBuckets; ++i)
+            {
+                cumulative += counts[i];
+                if (cumulative > target) return std::clamp(bucketMilliseconds(i), stats.minimum, stats.maximum);
+            }
+            return stats.maximum;
+        };
+
+        if (histogramCount > 0)
+        {
+            stats.percentile50 = percentile(0.5);
+            stats.percentile95 = percentile(0.95);
+            stats.percentile99 = percentile(0.99);
+        }
+        return stats;
+    }
+};
+
+/////////////////////////////////////////////////////////////////////////
+//
+// StatsInstrumentation::ThreadStats
+//
+/// per thread open addressed table of Accumulators, entries are only added by the owning thread so no locking is required to record durations.
+struct StatsInstrumentation::ThreadStats
+{
+    ThreadStats(uint32_t in_capacity, const std::string& in_name) :
+        capacity(std::max(in_capacity, 1u)),
+        accumulators(new Accumulator[capacity]),
+        name(in_name)
+    {
+    }
+
+    const uint32_t capacity;
+    std::unique_ptr<Accumulator[]> accumulators;
+    uint32_t size = 0;
+
+    std::mutex nameMutex;
+    std::string name;
+
+    // CPU start times of the GPU instrumented regions currently open on this thread
+    std::vector<uint64_t> gpuRegionStarts;
+
+    Accumulator* find(const SourceLocation* sl)
+    {
+        auto hash = (reinterpret_cast<uintptr_t>(sl) >> 3) * uintptr_t(0x9E3779B97F4A7C15ull);
+        for (uint32_t i = 0; i < capacity; ++i)
+        {
+            auto& accumulator = accumulators[(hash + i) % capacity];
+            auto key = accumulator.sourceLocation.load(std::memory_order_relaxed);
+            if (key == sl) return &accumulator;
+            if (key == nullptr)
+            {
+                if (size >= capacity) return nullptr;
+                ++size;
+                accumulator.sourceLocation.store(sl, std::memory_order_release);
+                return &accumulator;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/////////////////////////////////////////////////////////////////////////
+//
+// StatsInstrumentation::GpuQueries
+//
+/// per Device ring of timestamp queries, with a slot of queries for each of the frames that may be in flight.
+struct StatsInstrumentation::GpuQueries
+{
+    static constexpr uint32_t numSlots = 4;
+    static constexpr uint64_t invalidFrame = std::numeric_limits<uint64_t>::max();
+
+    struct Region
+    {
+        const SourceLocation* sourceLocation;
+        uint32_t query;
+        uint64_t timestampMask;
+    };
+
+    struct Block
+    {
+        uint32_t next = 0;
+        uint32_t end = 0;
+        uint64_t timestampMask = 0;
+    };
+
+    struct Slot
+    {
+        uint64_t frameCount = invalidFrame;
+        uint32_t used = 0;
+        std::vector<Region> regions;
+        std::map<const CommandBuffer*, Block> blocks;
+    };
+
+    GpuQueries(Device* in_device, uint32_t in_queriesPerSlot) :
+        device(in_device),
+        queriesPerSlot(in_queriesPerSlot)
+    {
+        timestampPeriod = static_cast<double>(device->getPhysicalDevice()->getProperties().limits.timestampPeriod);
+
+        VkQueryPoolCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = numSlots * queriesPerSlot;
+        if (vkCreateQueryPool(*device, &createInfo, device->getAllocationCallbacks(), &queryPool) != VK_SUCCESS)
+        {
+            warn("vsg::StatsInstrumentation unable to create timestamp QueryPool, GPU timings disabled.");
+            queryPool = VK_NULL_HANDLE;
+        }
+    }
+
+    ~GpuQueries()
+    {
+        if (queryPool) vkDestroyQueryPool(*device, queryPool, device->getAllocationCallbacks());
+    }
+
+    uint64_t timestampMask(uint32_t queueFamilyIndex) const
+    {
+        auto& queueFamilyProperties = device->getPhysicalDevice()->getQueueFamilyProperties();
+        uint32_t timestampValidBits = queueFamilyIndex < queueFamilyProperties.size() ? queueFamilyProperties[queueFamilyIndex].timestampValidBits : 0;
+        if (timestampValidBits == 0) return 0;
+        return (timestampValidBits >= 64) ? std::numeric_limits<uint64_t>::max() : ((uint64_t(1) << timestampValidBits) - 1);
+    }
+
+    ref_ptr<Device> device;
+    const uint32_t queriesPerSlot;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    double timestampPeriod = 1.0;
+    std::array<Slot, numSlots> slots;
+};
+
+/////////////////////////////////////////////////////////////////////////
+//
+// StatsInstrumentation
+//
+StatsInstrumentation::StatsInstrumentation() :
+    _id(s_nextStatsInstrumentationID.fetch_add(1))
+{
+}
+
+StatsInstrumentation::~StatsInstrumentation()
+{
+}
+
+StatsInstrumentation::ThreadStats* StatsInstrumentation::_threadStats() const
+{
+    // each thread caches the ThreadStats it has been assigned by each StatsInstrumentation, keyed by ID so stale entries are never matched
+    thread_local std::vector<std::pair<uint64_t, ThreadStats*>> s_threadStats;
+    for (auto& [id, stats] : s_threadStats)
+    {
+        if (id == _id) return stats;
+    }
+
+    std::scoped_lock lock(_threadsMutex);
+    _threads.emplace_back(new ThreadStats(maxSourceLocations, "thread " + std::to_string(_threads.size())));
+    s_threadStats.emplace_back(_id, _threads.back().get());
+    return _threads.back().get();
+}
+
+void StatsInstrumentation::setThreadName(const std::string& name) const
+{
+    auto stats = _threadStats();
+    std::scoped_lock lock(stats->nameMutex);
+    stats->name = name;
+}
+
+void StatsInstrumentation::enterFrame(const SourceLocation* sl, uint64_t& reference, FrameStamp& frameStamp) const
+{
+    _frameCount.store(frameStamp.frameCount);
+    enter(sl, reference);
+}
+
+void StatsInstrumentation::leaveFrame(const SourceLocation* sl, uint64_t& reference, FrameStamp& /*frameStamp*/) const
+{
+    leave(sl, reference);
+    merge();
+}
+
+void StatsInstrumentation::enter(const SourceLocation* sl, uint64_t& reference, const Object* /*object*/) const
+{
+    reference = (sl->level <= cpuInstrumentationLevel) ? nowNanoseconds() : 0;
+}
+
+void StatsInstrumentation::leave(const SourceLocation* sl, uint64_t& reference, const Object* /*object*/) const
+{
+    if (reference == 0) return;
+
+    if (auto accumulator = _threadStats()->find(sl)) accumulator->add(nowNanoseconds() - reference);
+}
+
+void StatsInstrumentation::enterCommandBuffer(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer) const
+{
+    _threadStats()->gpuRegionStarts.push_back((sl->level <= cpuInstrumentationLevel) ? nowNanoseconds() : 0);
+    _enterGpu(sl, reference, commandBuffer, true);
+}
+
+void StatsInstrumentation::leaveCommandBuffer(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer) const
+{
+    _leaveGpu(reference, commandBuffer);
+    leave(sl, _threadStats()->gpuRegionStarts.back());
+    _threadStats()->gpuRegionStarts.pop_back();
+}
+
+void StatsInstrumentation::enter(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer, const Object* /*object*/) const
+{
+    _threadStats()->gpuRegionStarts.push_back((sl->level <= cpuInstrumentationLevel) ? nowNanoseconds() : 0);
+    _enterGpu(sl, reference, commandBuffer, false);
+}
+
+void StatsInstrumentation::leave(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer, const Object* /*object*/) const
+{
+    _leaveGpu(reference, commandBuffer);
+    leave(sl, _threadStats()->gpuRegionStarts.back());
+    _threadStats()->gpuRegionStarts.pop_back();
+}
+
+void StatsInstrumentation::_enterGpu(const SourceLocation* sl, uint64_t& reference, CommandBuffer& commandBuffer, bool beginCommandBuffer) const
+{
+    reference = 0;
+    if (!beginCommandBuffer && sl->level > gpuInstrumentationLevel) return;
+
+    std::scoped_lock lock(_gpuMutex);
+
+    auto& queries = _gpuQueries[commandBuffer.getDevice()];
+    if (!queries) queries.reset(new GpuQueries(commandBuffer.getDevice(), queriesPerCommandBuffer * commandBuffersPerFrame));
+    if (!queries->queryPool) return;
+
+    auto frameCount = _frameCount.load();
+    uint32_t slotIndex = static_cast<uint32_t>(frameCount % GpuQueries::numSlots);
+    auto& slot = queries->slots[slotIndex];
+    if (slot.frameCount != frameCount) _collectGpuResults(*queries, slotIndex, frameCount);
+
+    if (beginCommandBuffer)
+    {
+        // reserve and reset a block of queries for this command buffer while outside of any render pass
+        auto& block = slot.blocks[&commandBuffer];
+        block = {};
+
+        uint64_t timestampMask = queries->timestampMask(commandBuffer.getCommandPool()->queueFamilyIndex);
+        if (timestampMask == 0 || (slot.used + queriesPerCommandBuffer) > queries->queriesPerSlot) return;
+
+        block.next = slotIndex * queries->queriesPerSlot + slot.used;
+        block.end = block.next + queriesPerCommandBuffer;
+        block.timestampMask = timestampMask;
+        slot.used += queriesPerCommandBuffer;
+
+        vkCmdResetQueryPool(commandBuffer, queries->queryPool, block.next, queriesPerCommandBuffer);
+
+        if (sl->level > gpuInstrumentationLevel) return;
+    }
+
+    auto itr = slot.blocks.find(&commandBuffer);
+    if (itr == slot.blocks.end() || (itr->second.next + 2) > itr->second.end) return;
+
+    auto& block = itr->second;
+    uint32_t query = block.next;
+    block.next += 2;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queries->queryPool, query);
+    slot.regions.push_back(GpuQueries::Region{sl, query, block.timestampMask});
+
+    // encode the frame so that a region left after its slot has been reused isn't completed
+    reference = ((frameCount & 0xffffffff) << 32) | (static_cast<uint64_t>(query) + 1);
+}
+
+void StatsInstrumentation::_leaveGpu(uint64_t& reference, CommandBuffer& commandBuffer) const
+{
+    if (reference == 0) return;
+
+    std::scoped_lock lock(_gpuMutex);
+
+    auto itr = _gpuQueries.find(commandBuffer.getDevice());
+    if (itr == _gpuQueries.end()) return;
+
+    auto& queries = *(itr->second);
+    uint32_t endQuery = static_cast<uint32_t>(reference & 0xffffffff);
+    auto& slot = queries.slots[endQuery / queries.queriesPerSlot];
+    if ((slot.frameCount & 0xffffffff) != (reference >> 32)) return;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queries.queryPool, endQuery);
+}
+
+void StatsInstrumentation::_collectGpuResults(GpuQueries& queries, uint32_t slotIndex, uint64_t frameCount) const
+{
+    auto& slot = queries.slots[slotIndex];
+
+    // gather the timestamps written when this slot was last used, regions whose frame hasn't completed yet are skipped rather than waited on
+    for (auto& region : slot.regions)
+    {
+        uint64_t timestamps[2] = {0, 0};
+        if (vkGetQueryPoolResults(*queries.device, queries.queryPool, region.query, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            uint64_t ticks = (timestamps[1] - timestamps[0]) & region.timestampMask;
+
+            auto& accumulator = _gpuStats[region.sourceLocation];
+            if (!accumulator) accumulator.reset(new Accumulator);
+            accumulator->add(static_cast<uint64_t>(static_cast<double>(ticks) * queries.timestampPeriod));
+        }
+    }
+
+    slot.frameCount = frameCount;
+    slot.used = 0;
+    slot.regions.clear();
+    slot.blocks.clear();
+}
+
+void StatsInstrumentation::merge() const
+{
+    std::vector<Statistics> merged;
+    {
+        std::scoped_lock lock(_threadsMutex);
+        for (auto& thread : _threads)
+        {
+            std::string name;
+            {
+                std::scoped_lock name_lock(thread->nameMutex);
+                name = thread->name;
+            }
+
+            for (uint32_t i = 0; i < thread->capacity; ++i)
+            {
+                auto& accumulator = thread->accumulators[i];
+                if (auto sl = accumulator.sourceLocation.load(std::memory_order_acquire)) merged.push_back(accumulator.statistics(sl, name, false));
+            }
+        }
+    }
+
+    {
+        std::scoped_lock lock(_gpuMutex);
+        for (auto& [sl, accumulator] : _gpuStats) merged.push_back(accumulator->statistics(sl, "GPU", true));
+    }
+
+    // CPU timings before GPU timings, most expensive first
+    std::sort(merged.begin(), merged.end(), [](const Statistics& lhs, const Statistics& rhs) {
+        if (lhs.gpu != rhs.gpu) return rhs.gpu;
+        return lhs.total > rhs.total;
+    });
+
+    std::scoped_lock lock(_resultsMutex);
+    _results.swap(merged);
+}
+
+std::vector<StatsInstrumentation::Statistics> StatsInstrumentation::results() const
+{
+    std::scoped_lock lock(_resultsMutex);
+    return _results;
+}
+
+void StatsInstrumentation::write(std::ostream& out, Format format) const
+{
+    auto statistics = results();
+
+    if (format == CSV)
+    {
+        out << "name,function,file,line,thread,type,count,total_ms,min_ms,max_ms,average_ms,p50_ms,p95_ms,p99_ms\n";
+        for (auto& stats : statistics)
+        {
+            auto sl = stats.sourceLocation;
+            out << "\"" << escape(sl->name) << "\",\"" << escape(sl->function) << "\",\"" << escape(sl->file) << "\"," << sl->line << ",\"" << stats.thread << "\"," << (stats.gpu ? "gpu" : "cpu") << ","
+                << stats.count << "," << stats.total << "," << stats.minimum << "," << stats.maximum << "," << stats.average() << ","
+                << stats.percentile50 << "," << stats.percentile95 << "," << stats.percentile99 << "\n";
+        }
+        return;
+    }
+
+    out << "[\n";
+    for (size_t i = 0; i < statistics.size(); ++i)
+    {
+        auto& stats = statistics[i];
+        auto sl = stats.sourceLocation;
+        out << "  {\"name\": \"" << escape(sl->name) << "\", \"function\": \"" << escape(sl->function) << "\", \"file\": \"" << escape(sl->file) << "\", \"line\": " << sl->line
+            << ", \"thread\": \"" << stats.thread << "\", \"type\": \"" << (stats.gpu ? "gpu" : "cpu") << "\", \"count\": " << stats.count
+            << ", \"total_ms\": " << stats.total << ", \"min_ms\": " << stats.minimum << ", \"max_ms\": " << stats.maximum << ", \"average_ms\": " << stats.average()
+            << ", \"p50_ms\": " << stats.percentile50 << ", \"p95_ms\": " << stats.percentile95 << ", \"p99_ms\": " << stats.percentile99 << "}"
+            << ((i + 1 < statistics.size()) ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+bool StatsInstrumentation::write(const Path& filename) const
+{
+    std::ofstream fout(filename);
+    if (!fout) return false;
+
+    write(fout, lowerCaseFileExtension(filename) == ".csv" ? CSV : JSON);
+    return true;
+}
@@ -0,0 +1,279 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Input.h>
+#include <vsg/io/Output.h>
+#include <vsg/maths/transform.h>
+#include <vsg/utils/LineSegmentIntersector.h>
+#include <vsg/utils/TerrainHeightQuery.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+/////////////////////////////////////////////////////////////////////////
+//
+// ElevationGrid
+//
+ElevationGrid::ElevationGrid()
+{
+}
+
+ElevationGrid::ElevationGrid(uint32_t in_x, uint32_t in_y, uint32_t in_level, const dbox& in_extents, ref_ptr<floatArray2D> in_heights) :
+    x(in_x),
+    y(in_y),
+    level(in_level),
+    extents(in_extents),
+    heights(in_heights)
+{
+}
+
+double ElevationGrid::sample(double px, double py) const
+{
+    if (!heights || heights->width() == 0 || heights->height() == 0) return 0.0;
+
+    uint32_t numColumns = heights->width();
+    uint32_t numRows = heights->height();
+
+    double u = (px - extents.min.x) / (extents.max.x - extents.min.x) * double(numColumns - 1);
+    double v = (py - extents.min.y) / (extents.max.y - extents.min.y) * double(numRows - 1);
+    if (heights->properties.origin == TOP_LEFT) v = double(numRows - 1) - v;
+
+    u = std::clamp(u, 0.0, double(numColumns - 1));
+    v = std::clamp(v, 0.0, double(numRows - 1));
+
+    uint32_t c = std::min(static_cast<uint32_t>(u), numColumns > 1 ? numColumns - 2 : 0);
+    uint32_t r = std::min(static_cast<uint32_t>(v), numRows > 1 ? numRows - 2 : 0);
+    uint32_t c1 = std::min(c + 1, numColumns - 1);
+    uint32_t r1 = std::min(r + 1, numRows - 1);
+    double fc = u - double(c);
+    double fr = v - double(r);
+
+    double h0 = double(heights->at(c, r)) * (1.0 - fc) + double(heights->at(c1, r)) * fc;
+    double h1 = double(heights->at(c, r1)) * (1.0 - fc) + double(heights->at(c1, r1)) * fc;
+    return h0 * (1.0 - fr) + h1 * fr;
+}
+
+ref_ptr<floatArray2D> ElevationGrid::convert(ref_ptr<Data> data)
+{
+    if (!data) return {};
+    if (auto floatHeights = data.cast<floatArray2D>()) return floatHeights;
+
+    auto convertArray = [&](auto& array, auto toHeight) {
+        auto result = floatArray2D::create(array.width(), array.height(), Data::Properties{VK_FORMAT_R32_SFLOAT});
+        result->properties.origin = array.properties.origin;
+        std::transform(array.begin(), array.end(), result->begin(), toHeight);
+        return result;
+    };
+
+    auto terrainRGB = [](const auto& c) { return -10000.0f + float(uint32_t(c.r) * 65536 + uint32_t(c.g) * 256 + uint32_t(c.b)) * 0.1f; };
+
+    if (auto shortHeights = data.cast<shortArray2D>()) return convertArray(*shortHeights, [](int16_t h) { return float(h); });
+    if (auto ushortHeights = data.cast<ushortArray2D>()) return convertArray(*ushortHeights, [](uint16_t h) { return float(h); });
+    if (auto rgb = data.cast<ubvec3Array2D>()) return convertArray(*rgb, terrainRGB);
+    if (auto rgba = data.cast<ubvec4Array2D>()) return convertArray(*rgba, terrainRGB);
+
+    return {};
+}
+
+void ElevationGrid::read(Input& input)
+{
+    Object::read(input);
+
+    input.read("x", x);
+    input.read("y", y);
+    input.read("level", level);
+    input.read("extents", extents);
+    input.read("heights", heights);
+}
+
+void ElevationGrid::write(Output& output) const
+{
+    Object::write(output);
+
+    output.write("x", x);
+    output.write("y", y);
+    output.write("level", level);
+    output.write("extents", extents);
+    output.write("heights", heights);
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// TerrainHeightQuery
+//
+TerrainHeightQuery::TerrainHeightQuery(const TileDatabaseSettings& settings) :
+    extents(settings.extents),
+    noX(settings.noX),
+    noY(settings.noY),
+    originTopLeft(settings.originTopLeft),
+    projection(settings.projection),
+    ellipsoidModel(settings.ellipsoidModel)
+{
+}
+
+TerrainHeightQuery::~TerrainHeightQuery()
+{
+}
+
+void TerrainHeightQuery::add(ref_ptr<ElevationGrid> grid)
+{
+    if (!grid || !grid->heights) return;
+
+    std::scoped_lock lock(_mutex);
+    _grids[key(grid->x, grid->y, grid->level)] = grid;
+    _maxLevel = std::max(_maxLevel, grid->level);
+}
+
+dvec2 TerrainHeightQuery::computeProjectionCoord(double latitude, double longitude) const
+{
+    if (projection == "EPSG:3857" || projection == "spherical-mercator")
+    {
+        // inverse of the mapping used by vsg::tile
+        return dvec2(longitude, degrees(0.5 * std::asinh(std::tan(radians(latitude)))));
+    }
+    return dvec2(longitude, latitude);
+}
+
+ref_ptr<ElevationGrid> TerrainHeightQuery::findGrid(const dvec2& coord, ref_ptr<ElevationGrid>& previous) const
+{
+    auto find = [&](uint32_t level) -> ref_ptr<ElevationGrid> {
+        double multiplier = std::ldexp(1.0, -static_cast<int>(level));
+        double tileWidth = multiplier * (extents.max.x - extents.min.x) / double(noX);
+        double tileHeight = multiplier * (extents.max.y - extents.min.y) / double(noY);
+
+        double fx = (coord.x - extents.min.x) / tileWidth;
+        double fy = originTopLeft ? (extents.max.y - coord.y) / tileHeight : (coord.y - extents.min.y) / tileHeight;
+        if (fx < 0.0 || fy < 0.0) return {};
+
+        uint32_t tx = static_cast<uint32_t>(fx);
+        uint32_t ty = static_cast<uint32_t>(fy);
+        if (tx >= (noX << level)) tx = (noX << level) - 1;
+        if (ty >= (noY << level)) ty = (noY << level) - 1;
+
+        auto itr = _grids.find(key(tx, ty, level));
+        if (itr == _grids.end()) return {};
+        return itr->second.ref_ptr();
+    };
+
+    if (previous && coord.x >= previous->extents.min.x && coord.x <= previous->extents.max.x && coord.y >= previous->extents.min.y && coord.y <= previous->extents.max.y)
+    {
+        // nearby queries usually fall within the same grid so only look for a higher resolution grid before reusing it
+        if (previous->level == _maxLevel) return previous;
+        if (auto finer = find(previous->level + 1)) return finer;
+        return previous;
+    }
+
+    for (uint32_t level = _maxLevel + 1; level > 0; --level)
+    {
+        if (auto grid = find(level - 1)) return grid;
+    }
+    return {};
+}
+
+bool TerrainHeightQuery::intersect(double latitude, double longitude, double& height) const
+{
+    if (!scene || !ellipsoidModel) return false;
+
+    auto start = ellipsoidModel->convertLatLongAltitudeToECEF(dvec3(latitude, longitude, 1.0e5));
+    auto end = ellipsoidModel->convertLatLongAltitudeToECEF(dvec3(latitude, longitude, -1.2e4));
+
+    auto intersector = LineSegmentIntersector::create(start, end);
+    scene->accept(*intersector);
+
+    if (intersector->intersections.empty()) return false;
+
+    auto nearest = std::min_element(intersector->intersections.begin(), intersector->intersections.end(), [](auto& lhs, auto& rhs) { return lhs->ratio < rhs->ratio; });
+    height = ellipsoidModel->convertECEFToLatLongAltitude((*nearest)->worldIntersection).z;
+    return true;
+}
+
+bool TerrainHeightQuery::computeHeight(double latitude, double longitude, double& height) const
+{
+    dvec2 latitudeLongitude(latitude, longitude);
+    double result = 0.0;
+    if (computeHeights(&latitudeLongitude, &result, 1) == 0) return false;
+
+    height = result;
+    return true;
+}
+
+size_t TerrainHeightQuery::computeHeights(const dvec2* latitudeLongitudes, double* heights, size_t count, double defaultHeight) const
+{
+    size_t numFound = 0;
+    std::vector<size_t> notFound;
+
+    {
+        std::scoped_lock lock(_mutex);
+
+        ref_ptr<ElevationGrid> previous;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto coord = computeProjectionCoord(latitudeLongitudes[i].x, latitudeLongitudes[i].y);
+            if (auto grid = findGrid(coord, previous))
+            {
+                heights[i] = grid->sample(coord.x, coord.y);
+                previous = grid;
+                ++numFound;
+            }
+            else
+            {
+                notFound.push_back(i);
+            }
+        }
+    }
+
+    // intersect outside the lock so that reading threads adding grids aren't blocked
+    for (auto i : notFound)
+    {
+        if (intersect(latitudeLongitudes[i].x, latitudeLongitudes[i].y, heights[i]))
+            ++numFound;
+        else
+            heights[i] = defaultHeight;
+    }
+
+    return numFound;
+}
+
+size_t TerrainHeightQuery::computeHeights(const std::vector<dvec2>& latitudeLongitudes, std::vector<double>& heights, double defaultHeight) const
+{
+    heights.resize(latitudeLongitudes.size());
+    return computeHeights(latitudeLongitudes.data(), heights.data(), latitudeLongitudes.size(), defaultHeight);
+}
+
+size_t TerrainHeightQuery::prune()
+{
+    std::scoped_lock lock(_mutex);
+
+    size_t numRemoved = 0;
+    _maxLevel = 0;
+    for (auto itr = _grids.begin(); itr != _grids.end();)
+    {
+        if (itr->second)
+        {
+            _maxLevel = std::max(_maxLevel, static_cast<uint32_t>(itr->first >> 58));
+            ++itr;
+        }
+        else
+        {
+            itr = _grids.erase(itr);
+            ++numRemoved;
+        }
+    }
+    return numRemoved;
+}
+
+size_t TerrainHeightQuery::size() const
+{
+    std::scoped_lock lock(_mutex);
+    return _grids.size();
+}
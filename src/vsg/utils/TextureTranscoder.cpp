@@ -0,0 +1,459 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Allocator.h>
+#include <vsg/core/Array2D.h>
+#include <vsg/io/Logger.h>
+#include <vsg/nodes/StateGroup.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/utils/TextureTranscoder.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace vsg;
+
+namespace
+{
+    /// tightly packed RGBA texels
+    using RGBAImage = std::vector<uint8_t>;
+
+    struct SRGBTable
+    {
+        SRGBTable()
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                float c = static_cast<float>(i) / 255.0f;
+                toLinear[i] = (c <= 0.04045f) ? (c / 12.92f) : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+        }
+
+        static uint8_t fromLinear(float c)
+        {
+            c = std::clamp(c, 0.0f, 1.0f);
+            float s = (c <= 0.0031308f) ? (c * 12.92f) : (1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f);
+            return static_cast<uint8_t>(s * 255.0f + 0.5f);
+        }
+
+        float toLinear[256];
+    };
+
+    RGBAImage copyTexels(const uint8_t* src, size_t numTexels, bool bgra)
+    {
+        RGBAImage image(src, src + numTexels * 4);
+        if (bgra)
+        {
+            for (size_t i = 0; i < image.size(); i += 4) std::swap(image[i], image[i + 2]);
+        }
+        return image;
+    }
+
+    /// box filter an image down to the next mipmap level, averaging the color of sRGB images in linear space
+    RGBAImage downsample(const RGBAImage& src, uint32_t width, uint32_t height, bool srgb)
+    {
+        static const SRGBTable s_srgbTable;
+
+        uint32_t w = std::max(width / 2, 1u);
+        uint32_t h = std::max(height / 2, 1u);
+        RGBAImage dest(static_cast<size_t>(w) * h * 4);
+
+        uint8_t* ptr = dest.data();
+        for (uint32_t y = 0; y < h; ++y)
+        {
+            uint32_t y0 = std::min(y * 2, height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, height - 1);
+            for (uint32_t x = 0; x < w; ++x)
+            {
+                uint32_t x0 = std::min(x * 2, width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, width - 1);
+                const uint8_t* p[4] = {&src[(y0 * width + x0) * 4], &src[(y0 * width + x1) * 4], &src[(y1 * width + x0) * 4], &src[(y1 * width + x1) * 4]};
+                for (int c = 0; c < 4; ++c)
+                {
+                    if (srgb && c < 3)
+                    {
+                        float sum = s_srgbTable.toLinear[p[0][c]] + s_srgbTable.toLinear[p[1][c]] + s_srgbTable.toLinear[p[2][c]] + s_srgbTable.toLinear[p[3][c]];
+                        *(ptr++) = SRGBTable::fromLinear(sum * 0.25f);
+                    }
+                    else
+                    {
+                        *(ptr++) = static_cast<uint8_t>((p[0][c] + p[1][c] + p[2][c] + p[3][c] + 2) / 4);
+                    }
+                }
+            }
+        }
+        return dest;
+    }
+
+    /// load the 4x4 block of texels at block bx, by, clamping to the edges of images smaller than a block
+    void loadBlock(const RGBAImage& image, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, uint8_t texels[16][4])
+    {
+        for (uint32_t y = 0; y < 4; ++y)
+        {
+            uint32_t sy = std::min(by * 4 + y, height - 1);
+            for (uint32_t x = 0; x < 4; ++x)
+            {
+                uint32_t sx = std::min(bx * 4 + x, width - 1);
+                const uint8_t* src = &image[(static_cast<size_t>(sy) * width + sx) * 4];
+                std::copy(src, src + 4, texels[y * 4 + x]);
+            }
+        }
+    }
+
+    uint16_t to565(const int c[3])
+    {
+        return static_cast<uint16_t>((((c[0] * 31 + 127) / 255) << 11) | (((c[1] * 63 + 127) / 255) << 5) | ((c[2] * 31 + 127) / 255));
+    }
+
+    void from565(uint16_t v, int c[3])
+    {
+        int r = (v >> 11) & 31;
+        int g = (v >> 5) & 63;
+        int b = v & 31;
+        c[0] = (r << 3) | (r >> 2);
+        c[1] = (g << 2) | (g >> 4);
+        c[2] = (b << 3) | (b >> 2);
+    }
+
+    /// encode the RGB of 16 texels as a BC1 color block, using the inset bounding box of the colors as endpoints
+    /// with the box's diagonal chosen from the signs of the color covariances. Based on "Real-Time DXT Compression", van Waveren 2006.
+    void encodeColorBlock(const uint8_t texels[16][4], uint8_t* out)
+    {
+        int minColor[3] = {255, 255, 255};
+        int maxColor[3] = {0, 0, 0};
+        int mean[3] = {0, 0, 0};
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                minColor[c] = std::min(minColor[c], static_cast<int>(texels[i][c]));
+                maxColor[c] = std::max(maxColor[c], static_cast<int>(texels[i][c]));
+                mean[c] += texels[i][c];
+            }
+        }
+        for (int c = 0; c < 3; ++c) mean[c] = (mean[c] + 8) / 16;
+
+        // flip the green and blue extents when they are anti-correlated with red so the endpoints lie along the colors' main axis
+        int covarianceRG = 0;
+        int covarianceRB = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            int dr = texels[i][0] - mean[0];
+            covarianceRG += dr * (texels[i][1] - mean[1]);
+            covarianceRB += dr * (texels[i][2] - mean[2]);
+        }
+        if (covarianceRG < 0) std::swap(minColor[1], maxColor[1]);
+        if (covarianceRB < 0) std::swap(minColor[2], maxColor[2]);
+
+        // inset the endpoints by 1/16 of the range to reduce the error of the interpolated colors
+        for (int c = 0; c < 3; ++c)
+        {
+            int inset = (maxColor[c] - minColor[c]) / 16;
+            maxColor[c] -= inset;
+            minColor[c] += inset;
+        }
+
+        uint16_t color0 = to565(maxColor);
+        uint16_t color1 = to565(minColor);
+
+        // color0 > color1 selects the four color mode
+        if (color0 < color1) std::swap(color0, color1);
+
+        uint32_t indices = 0;
+        if (color0 != color1)
+        {
+            int palette[4][3];
+            from565(color0, palette[0]);
+            from565(color1, palette[1]);
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            for (int i = 0; i < 16; ++i)
+            {
+                uint32_t best = 0;
+                int bestDistance = INT_MAX;
+                for (uint32_t j = 0; j < 4; ++j)
+                {
+                    int dr = texels[i][0] - palette[j][0];
+                    int dg = texels[i][1] - palette[j][1];
+                    int db = texels[i][2] - palette[j][2];
+                    int distance = dr * dr + dg * dg + db * db;
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        best = j;
+                    }
+                }
+                indices |= best << (2 * i);
+            }
+        }
+
+        out[0] = static_cast<uint8_t>(color0 & 0xff);
+        out[1] = static_cast<uint8_t>(color0 >> 8);
+        out[2] = static_cast<uint8_t>(color1 & 0xff);
+        out[3] = static_cast<uint8_t>(color1 >> 8);
+        for (int b = 0; b < 4; ++b) out[4 + b] = static_cast<uint8_t>((indices >> (8 * b)) & 0xff);
+    }
+
+    /// encode the alpha of 16 texels as a BC3 alpha block using the alpha range as the endpoints
+    void encodeAlphaBlock(const uint8_t texels[16][4], uint8_t* out)
+    {
+        int alpha0 = 0;
+        int alpha1 = 255;
+        for (int i = 0; i < 16; ++i)
+        {
+            alpha0 = std::max(alpha0, static_cast<int>(texels[i][3]));
+            alpha1 = std::min(alpha1, static_cast<int>(texels[i][3]));
+        }
+
+        uint64_t indices = 0;
+        if (alpha0 != alpha1)
+        {
+            // alpha0 > alpha1 selects the eight alpha mode
+            int palette[8] = {alpha0, alpha1};
+            for (int j = 1; j < 7; ++j) palette[j + 1] = ((7 - j) * alpha0 + j * alpha1) / 7;
+
+            for (int i = 0; i < 16; ++i)
+            {
+                uint64_t best = 0;
+                int bestDistance = INT_MAX;
+                for (uint64_t j = 0; j < 8; ++j)
+                {
+                    int distance = std::abs(texels[i][3] - palette[j]);
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        best = j;
+                    }
+                }
+                indices |= best << (3 * i);
+            }
+        }
+
+        out[0] = static_cast<uint8_t>(alpha0);
+        out[1] = static_cast<uint8_t>(alpha1);
+        for (int b = 0; b < 6; ++b) out[2 + b] = static_cast<uint8_t>((indices >> (8 * b)) & 0xff);
+    }
+
+    struct TranscodeTextures : public Visitor
+    {
+        explicit TranscodeTextures(const TextureTranscoder& in_transcoder) :
+            transcoder(in_transcoder) {}
+
+        const TextureTranscoder& transcoder;
+        uint32_t numTranscoded = 0;
+
+        void apply(Object& object) override
+        {
+            object.traverse(*this);
+        }
+
+        void apply(StateGroup& stateGroup) override
+        {
+            for (auto& stateCommand : stateGroup.stateCommands) stateCommand->accept(*this);
+            stateGroup.traverse(*this);
+        }
+
+        void apply(DescriptorImage& descriptorImage) override
+        {
+            if (descriptorImage.descriptorType != VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER && descriptorImage.descriptorType != VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE) return;
+
+            for (auto& imageInfo : descriptorImage.imageInfoList)
+            {
+                if (imageInfo && transcoder.transcode(*imageInfo)) ++numTranscoded;
+            }
+        }
+    };
+} // namespace
+
+TextureTranscoder::TextureTranscoder()
+{
+}
+
+TextureTranscoder::TextureTranscoder(const PhysicalDevice* physicalDevice)
+{
+    if (physicalDevice)
+    {
+        const auto& features = physicalDevice->getFeatures();
+        supportsBC = features.textureCompressionBC == VK_TRUE;
+        supportsASTC = features.textureCompressionASTC_LDR == VK_TRUE;
+    }
+}
+
+TextureTranscoder::~TextureTranscoder()
+{
+}
+
+bool TextureTranscoder::compressible(VkFormat format)
+{
+    switch (format)
+    {
+    case (VK_FORMAT_R8G8B8A8_UNORM):
+    case (VK_FORMAT_R8G8B8A8_SRGB):
+    case (VK_FORMAT_B8G8R8A8_UNORM):
+    case (VK_FORMAT_B8G8R8A8_SRGB):
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint32_t TextureTranscoder::transcode(Object& object) const
+{
+    TranscodeTextures transcodeTextures(*this);
+    object.accept(transcodeTextures);
+    return transcodeTextures.numTranscoded;
+}
+
+bool TextureTranscoder::transcode(ImageInfo& imageInfo) const
+{
+    if (!imageInfo.imageView || !imageInfo.imageView->image) return false;
+
+    auto& imageView = imageInfo.imageView;
+    auto& image = imageView->image;
+    if (!image->data || image->data->dynamic()) return false;
+
+    // storage images and attachments need to keep their uncompressed format
+    if ((image->usage & (VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)) != 0) return false;
+
+    auto compressed = transcode(image->data.get(), vsg::computeNumMipMapLevels(image->data, imageInfo.sampler));
+    if (!compressed) return false;
+
+    if (imageView->format == image->format) imageView->format = compressed->properties.format;
+
+    image->data = compressed;
+    image->format = compressed->properties.format;
+    image->mipLevels = std::max(1u, static_cast<uint32_t>(compressed->properties.maxNumMipmaps));
+
+    return true;
+}
+
+ref_ptr<Data> TextureTranscoder::transcode(const Data* data, uint32_t mipLevels) const
+{
+    if (!supportsBC || !data) return {};
+
+    const auto& properties = data->properties;
+    if (!compressible(properties.format) || data->dimensions() != 2 || data->valueSize() != 4 || !data->contiguous()) return {};
+    if (properties.imageViewType >= 0 && properties.imageViewType != VK_IMAGE_VIEW_TYPE_2D) return {};
+
+    uint32_t width = data->width();
+    uint32_t height = data->height();
+    if (width < minimumDimension || height < minimumDimension || (width % 4) != 0 || (height % 4) != 0) return {};
+
+    uint32_t blocksWide = width / 4;
+    uint32_t blocksHigh = height / 4;
+
+    // the mipmaps of block compressed data halve the number of blocks each level, which only matches the texel mipmaps for power of two dimensions
+    uint32_t numLevels = 1;
+    if (mipLevels > 1)
+    {
+        auto powerOfTwo = [](uint32_t v) { return (v & (v - 1)) == 0; };
+        if (!powerOfTwo(width) || !powerOfTwo(height)) return {};
+
+        uint32_t w = blocksWide;
+        uint32_t h = blocksHigh;
+        while (numLevels < mipLevels && (w > 1 || h > 1))
+        {
+            if (w > 1) w /= 2;
+            if (h > 1) h /= 2;
+            ++numLevels;
+        }
+    }
+
+    bool srgb = (properties.format == VK_FORMAT_R8G8B8A8_SRGB || properties.format == VK_FORMAT_B8G8R8A8_SRGB);
+    bool bgra = (properties.format == VK_FORMAT_B8G8R8A8_UNORM || properties.format == VK_FORMAT_B8G8R8A8_SRGB);
+
+    auto source = static_cast<const uint8_t*>(data->dataPointer());
+    auto sourceMipmapOffsets = data->computeMipmapOffsets();
+
+    RGBAImage level = copyTexels(source, static_cast<size_t>(width) * height, bgra);
+
+    bool opaque = true;
+    for (size_t i = 3; i < level.size() && opaque; i += 4) opaque = (level[i] == 255);
+
+    Data::Properties layout = properties;
+    layout.format = opaque ? (srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK) : (srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK);
+    layout.stride = 0;
+    layout.maxNumMipmaps = static_cast<uint8_t>(numLevels);
+    layout.blockWidth = 4;
+    layout.blockHeight = 4;
+    layout.blockDepth = 1;
+    layout.allocatorType = ALLOCATOR_TYPE_VSG_ALLOCATOR;
+
+    size_t numBlocks = Data::computeValueCountIncludingMipmaps(blocksWide, blocksHigh, 1, numLevels);
+
+    ref_ptr<Data> compressed;
+    uint8_t* ptr = nullptr;
+    if (opaque)
+    {
+        auto blocks = new (vsg::allocate(sizeof(block64) * numBlocks, ALLOCATOR_AFFINITY_DATA)) block64[numBlocks];
+        ptr = blocks->value;
+        compressed = block64Array2D::create(blocksWide, blocksHigh, blocks, layout);
+    }
+    else
+    {
+        auto blocks = new (vsg::allocate(sizeof(block128) * numBlocks, ALLOCATOR_AFFINITY_DATA)) block128[numBlocks];
+        ptr = blocks->value;
+        compressed = block128Array2D::create(blocksWide, blocksHigh, blocks, layout);
+    }
+
+    uint32_t w = width;
+    uint32_t h = height;
+    uint32_t bw = blocksWide;
+    uint32_t bh = blocksHigh;
+    uint8_t texels[16][4];
+    for (uint32_t l = 0; l < numLevels; ++l)
+    {
+        if (l > 0)
+        {
+            // use the source's own mipmaps when it has them, otherwise generate them from the previous level
+            uint32_t previous_w = w;
+            uint32_t previous_h = h;
+            w = std::max(w / 2, 1u);
+            h = std::max(h / 2, 1u);
+            if (bw > 1) bw /= 2;
+            if (bh > 1) bh /= 2;
+
+            if (l < sourceMipmapOffsets.size())
+                level = copyTexels(source + sourceMipmapOffsets[l] * 4, static_cast<size_t>(w) * h, bgra);
+            else
+                level = downsample(level, previous_w, previous_h, srgb);
+        }
+
+        for (uint32_t by = 0; by < bh; ++by)
+        {
+            for (uint32_t bx = 0; bx < bw; ++bx)
+            {
+                loadBlock(level, w, h, bx, by, texels);
+                if (opaque)
+                {
+                    encodeColorBlock(texels, ptr);
+                    ptr += 8;
+                }
+                else
+                {
+                    encodeAlphaBlock(texels, ptr);
+                    encodeColorBlock(texels, ptr + 8);
+                    ptr += 16;
+                }
+            }
+        }
+    }
+
+    debug("TextureTranscoder::transcode(", data, ") ", width, "x", height, " to ", compressed, " format = ", layout.format, ", mipmap levels = ", numLevels);
+
+    return compressed;
+}
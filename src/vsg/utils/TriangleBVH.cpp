@@ -0,0 +1,401 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Objects.h>
+#include <vsg/io/Input.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Output.h>
+#include <vsg/maths/box.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/utils/TriangleBVH.h>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace vsg;
+
+namespace
+{
+    // limit the depth so the fixed size stack used by TriangleBVH::intersect() can't overflow
+    constexpr uint32_t maxDepth = 60;
+    constexpr int numBins = 16;
+
+    float halfArea(const box& b)
+    {
+        if (!b.valid()) return 0.0f;
+        vec3 e = b.max - b.min;
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+
+    struct Builder
+    {
+        std::vector<TriangleBVH::BVHNode>& nodes;
+        std::vector<box> bounds;
+        std::vector<vec3> centroids;
+        std::vector<uint32_t> order;
+
+        int binIndex(uint32_t t, int axis, float origin, float scale) const
+        {
+            return std::min(numBins - 1, static_cast<int>((centroids[t][axis] - origin) * scale));
+        }
+
+        void makeLeaf(uint32_t nodeIndex, uint32_t begin, uint32_t end)
+        {
+            nodes[nodeIndex].first = begin;
+            nodes[nodeIndex].count = end - begin;
+        }
+
+        void build(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t depth)
+        {
+            box nodeBounds, centroidBounds;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                nodeBounds.add(bounds[order[i]]);
+                centroidBounds.add(centroids[order[i]]);
+            }
+            nodes[nodeIndex].lower = nodeBounds.min;
+            nodes[nodeIndex].upper = nodeBounds.max;
+
+            uint32_t n = end - begin;
+            if (n <= TriangleBVH::maxLeafSize || depth >= maxDepth) return makeLeaf(nodeIndex, begin, end);
+
+            // find the binned split with the lowest surface area heuristic cost
+            float bestCost = std::numeric_limits<float>::max();
+            int bestAxis = -1, bestSplit = 0;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+                if (extent <= 0.0f) continue;
+
+                float scale = static_cast<float>(numBins) / extent;
+
+                box binBounds[numBins];
+                uint32_t binCounts[numBins] = {};
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    int bin = binIndex(order[i], axis, centroidBounds.min[axis], scale);
+                    ++binCounts[bin];
+                    binBounds[bin].add(bounds[order[i]]);
+                }
+
+                float rightCosts[numBins] = {};
+                box right;
+                uint32_t rightCount = 0;
+                for (int b = numBins - 1; b > 0; --b)
+                {
+                    right.add(binBounds[b]);
+                    rightCount += binCounts[b];
+                    rightCosts[b] = static_cast<float>(rightCount) * halfArea(right);
+                }
+
+                box left;
+                uint32_t leftCount = 0;
+                for (int b = 0; b < numBins - 1; ++b)
+                {
+                    left.add(binBounds[b]);
+                    leftCount += binCounts[b];
+                    float cost = static_cast<float>(leftCount) * halfArea(left) + rightCosts[b + 1];
+                    if (leftCount > 0 && leftCount < n && cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = b;
+                    }
+                }
+            }
+
+            float leafCost = static_cast<float>(n) * halfArea(nodeBounds);
+
+            uint32_t mid = begin + n / 2;
+            if (bestAxis >= 0)
+            {
+                if (bestCost >= leafCost && n <= 4 * TriangleBVH::maxLeafSize) return makeLeaf(nodeIndex, begin, end);
+
+                float scale = static_cast<float>(numBins) / (centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis]);
+                float origin = centroidBounds.min[bestAxis];
+                auto itr = std::partition(order.begin() + begin, order.begin() + end, [&](uint32_t t) { return binIndex(t, bestAxis, origin, scale) <= bestSplit; });
+                mid = static_cast<uint32_t>(itr - order.begin());
+                if (mid == begin || mid == end) mid = begin + n / 2;
+            }
+            else if (n <= 4 * TriangleBVH::maxLeafSize)
+            {
+                // all the centroids coincide so splitting won't help
+                return makeLeaf(nodeIndex, begin, end);
+            }
+
+            uint32_t leftIndex = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+            build(leftIndex, begin, mid, depth + 1);
+
+            uint32_t rightIndex = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+            build(rightIndex, mid, end, depth + 1);
+
+            nodes[nodeIndex].first = rightIndex;
+            nodes[nodeIndex].count = 0;
+        }
+    };
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////
+//
+// TriangleBVH
+//
+TriangleBVH::TriangleBVH()
+{
+}
+
+TriangleBVH::~TriangleBVH()
+{
+}
+
+void TriangleBVH::build(const vec3Array& vertices, const Data* in_indexArray, uint32_t in_first, uint32_t in_count)
+{
+    indexArray = in_indexArray;
+    first = in_first;
+    count = in_count;
+    nodes.clear();
+    indices.clear();
+
+    auto ushort_indices = in_indexArray ? in_indexArray->cast<ushortArray>() : nullptr;
+    auto uint_indices = in_indexArray ? in_indexArray->cast<uintArray>() : nullptr;
+    if (in_indexArray && !ushort_indices && !uint_indices) return;
+
+    uint32_t end = first + count;
+    if (in_indexArray) end = std::min(end, static_cast<uint32_t>(in_indexArray->valueCount()));
+
+    auto vertexIndex = [&](uint32_t i) -> uint32_t {
+        if (ushort_indices) return ushort_indices->at(i);
+        if (uint_indices) return uint_indices->at(i);
+        return i;
+    };
+
+    // gather the valid triangles
+    std::vector<uint32_t> triangles;
+    triangles.reserve(end > first ? end - first : 0);
+    for (uint32_t i = first; i + 3 <= end; i += 3)
+    {
+        uint32_t i0 = vertexIndex(i), i1 = vertexIndex(i + 1), i2 = vertexIndex(i + 2);
+        if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) continue;
+
+        triangles.push_back(i0);
+        triangles.push_back(i1);
+        triangles.push_back(i2);
+    }
+
+    uint32_t numTriangles = static_cast<uint32_t>(triangles.size() / 3);
+    if (numTriangles == 0) return;
+
+    Builder builder{nodes, {}, {}, {}};
+    builder.bounds.resize(numTriangles);
+    builder.centroids.resize(numTriangles);
+    builder.order.resize(numTriangles);
+    std::iota(builder.order.begin(), builder.order.end(), 0);
+    for (uint32_t t = 0; t < numTriangles; ++t)
+    {
+        auto& b = builder.bounds[t];
+        b.add(vertices.at(triangles[t * 3]));
+        b.add(vertices.at(triangles[t * 3 + 1]));
+        b.add(vertices.at(triangles[t * 3 + 2]));
+        builder.centroids[t] = (b.min + b.max) * 0.5f;
+    }
+
+    nodes.reserve(2 * (numTriangles / maxLeafSize) + 1);
+    nodes.emplace_back();
+    builder.build(0, 0, numTriangles, 0);
+    nodes.shrink_to_fit();
+
+    // reorder the triangles so each leaf's triangles are contiguous
+    indices.resize(triangles.size());
+    for (uint32_t p = 0; p < numTriangles; ++p)
+    {
+        uint32_t t = builder.order[p];
+        indices[p * 3] = triangles[t * 3];
+        indices[p * 3 + 1] = triangles[t * 3 + 1];
+        indices[p * 3 + 2] = triangles[t * 3 + 2];
+    }
+}
+
+ref_ptr<const TriangleBVH> TriangleBVH::getOrCreate(const vec3Array& vertices, const Data* indexArray, uint32_t in_first, uint32_t in_count, uint32_t minimumTriangles)
+{
+    if (vertices.properties.dataVariance != STATIC_DATA || (in_count / 3) < minimumTriangles) return {};
+
+    // draws that share the vertex array may use different index arrays and draw ranges, so the vertex array holds the TriangleBVH of each of them
+    auto find = [&](const Objects* bvhs) -> ref_ptr<const TriangleBVH> {
+        if (bvhs)
+        {
+            for (auto& child : bvhs->children)
+            {
+                if (auto bvh = child.cast<TriangleBVH>(); bvh && bvh->matches(indexArray, in_first, in_count)) return bvh;
+            }
+        }
+        return {};
+    };
+
+    // the Auxiliary used to cache the TriangleBVHs is shared with the rest of the application so serialize access
+    static std::mutex s_mutex;
+    {
+        std::scoped_lock lock(s_mutex);
+        if (auto bvh = find(vertices.getObject<Objects>("TriangleBVHs"))) return bvh;
+    }
+
+    auto bvh = TriangleBVH::create();
+    bvh->build(vertices, indexArray, in_first, in_count);
+
+    std::scoped_lock lock(s_mutex);
+    auto& mutable_vertices = const_cast<vec3Array&>(vertices);
+    auto bvhs = mutable_vertices.getRefObject<Objects>("TriangleBVHs");
+    if (auto existing = find(bvhs)) return existing;
+
+    if (!bvhs)
+    {
+        bvhs = Objects::create();
+        mutable_vertices.setObject("TriangleBVHs", bvhs);
+    }
+    else
+    {
+        // drop the TriangleBVHs of index arrays that are no longer referenced by any draw
+        auto& children = bvhs->children;
+        children.erase(std::remove_if(children.begin(), children.end(), [](const ref_ptr<Object>& child) {
+                           auto existing = child.cast<TriangleBVH>();
+                           return !existing || (existing->indexArray && existing->indexArray->referenceCount() == 1);
+                       }),
+                       children.end());
+    }
+
+    bvhs->addChild(bvh);
+    return bvh;
+}
+
+void TriangleBVH::read(Input& input)
+{
+    Object::read(input);
+
+    indexArray = input.readObject<Data>("indexArray");
+    input.read("first", first);
+    input.read("count", count);
+
+    nodes.resize(input.readValue<uint32_t>("numNodes"));
+    for (auto& node : nodes)
+    {
+        input.read("node", node.lower, node.first, node.upper, node.count);
+    }
+
+    indices.resize(input.readValue<uint32_t>("numIndices"));
+    if (input.matchPropertyName("indices")) input.read(indices.size(), indices.data());
+}
+
+void TriangleBVH::write(Output& output) const
+{
+    Object::write(output);
+
+    output.writeObject("indexArray", indexArray);
+    output.write("first", first);
+    output.write("count", count);
+
+    output.writeValue<uint32_t>("numNodes", nodes.size());
+    for (auto& node : nodes)
+    {
+        output.write("node", node.lower, node.first, node.upper, node.count);
+    }
+
+    output.writeValue<uint32_t>("numIndices", indices.size());
+    output.writePropertyName("indices");
+    output.write(indices.size(), indices.data());
+    output.writeEndOfLine();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+//
+// BuildTriangleBVHs
+//
+BuildTriangleBVHs::BuildTriangleBVHs(ref_ptr<OperationThreads> in_operationThreads) :
+    operationThreads(in_operationThreads)
+{
+}
+
+void BuildTriangleBVHs::_add(const Data* indices, uint32_t first, uint32_t count)
+{
+    auto& arrayState = *arrayStateStack.back();
+    if (arrayState.topology != VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST || (count / 3) < minimumTriangles) return;
+
+    // only vertex arrays used directly can have a cached TriangleBVH, ArrayState subclasses may compute new vertex arrays on each call
+    auto vertices = arrayState.vertexArray(0);
+    if (!vertices || vertices != arrayState.vertices || vertices->properties.dataVariance != STATIC_DATA) return;
+
+    for (auto& draw : draws)
+    {
+        if (draw.vertices == vertices && draw.indices == indices && draw.first == first && draw.count == count) return;
+    }
+
+    draws.push_back(Draw{vertices, ref_ptr<const Data>(indices), first, count});
+}
+
+bool BuildTriangleBVHs::intersectDraw(uint32_t firstVertex, uint32_t vertexCount, uint32_t /*firstInstance*/, uint32_t /*instanceCount*/)
+{
+    _add(nullptr, firstVertex, vertexCount);
+    return false;
+}
+
+bool BuildTriangleBVHs::intersectDrawIndexed(uint32_t firstIndex, uint32_t indexCount, uint32_t /*firstInstance*/, uint32_t /*instanceCount*/)
+{
+    const Data* indices = ushort_indices ? static_cast<const Data*>(ushort_indices.get()) : static_cast<const Data*>(uint_indices.get());
+    if (indices) _add(indices, firstIndex, indexCount);
+    return false;
+}
+
+size_t BuildTriangleBVHs::build()
+{
+    if (draws.empty()) return 0;
+
+    auto buildDraw = [this](const Draw& draw) {
+        TriangleBVH::getOrCreate(*draw.vertices, draw.indices.get(), draw.first, draw.count, minimumTriangles);
+    };
+
+    if (!operationThreads)
+    {
+        for (auto& draw : draws) buildDraw(draw);
+        return draws.size();
+    }
+
+    struct BuildOperation : public Operation
+    {
+        BuildOperation(BuildTriangleBVHs* in_builder, const Draw* in_draw, ref_ptr<Latch> in_latch) :
+            builder(in_builder),
+            draw(in_draw),
+            latch(in_latch) {}
+
+        void run() override
+        {
+            TriangleBVH::getOrCreate(*draw->vertices, draw->indices.get(), draw->first, draw->count, builder->minimumTriangles);
+            latch->count_down();
+        }
+
+        BuildTriangleBVHs* builder;
+        const Draw* draw;
+        ref_ptr<Latch> latch;
+    };
+
+    auto latch = Latch::create(draws.size());
+    for (auto& draw : draws)
+    {
+        operationThreads->add(ref_ptr<Operation>(new BuildOperation(this, &draw, latch)));
+    }
+
+    // help out with the builds then wait for the remaining ones to complete
+    operationThreads->run();
+    latch->wait();
+
+    debug("BuildTriangleBVHs::build() built ", draws.size(), " TriangleBVH");
+
+    return draws.size();
+}
@@ -0,0 +1,179 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array.h>
+#include <vsg/core/Array2D.h>
+#include <vsg/io/Logger.h>
+#include <vsg/utils/VirtualTexture.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace vsg;
+
+/////////////////////////////////////////////////////////////////////////
+//
+// VirtualTexture::Page
+//
+VirtualTexture::Page::Page(ref_ptr<VirtualTexture> in_virtualTexture, uint32_t in_index) :
+    index(in_index),
+    _virtualTexture(in_virtualTexture)
+{
+    auto& vt = *_virtualTexture;
+    float slotWidth = static_cast<float>(vt.pageWidth + 2 * vt.pageBorder);
+    float slotHeight = static_cast<float>(vt.pageHeight + 2 * vt.pageBorder);
+    float atlasWidth = slotWidth * static_cast<float>(vt.numPagesX);
+    float atlasHeight = slotHeight * static_cast<float>(vt.numPagesY);
+
+    uint32_t column = index % vt.numPagesX;
+    uint32_t row = index / vt.numPagesX;
+
+    offset.set((static_cast<float>(column) * slotWidth + static_cast<float>(vt.pageBorder)) / atlasWidth,
+               (static_cast<float>(row) * slotHeight + static_cast<float>(vt.pageBorder)) / atlasHeight);
+    scale.set(static_cast<float>(vt.pageWidth) / atlasWidth, static_cast<float>(vt.pageHeight) / atlasHeight);
+}
+
+VirtualTexture::Page::~Page()
+{
+    _virtualTexture->_release(index);
+}
+
+/////////////////////////////////////////////////////////////////////////
+//
+// VirtualTexture
+//
+VirtualTexture::VirtualTexture(uint32_t in_pageWidth, uint32_t in_pageHeight, uint32_t in_numPagesX, uint32_t in_numPagesY, VkFormat in_format, uint32_t in_pageBorder) :
+    pageWidth(in_pageWidth),
+    pageHeight(in_pageHeight),
+    numPagesX(in_numPagesX),
+    numPagesY(in_numPagesY),
+    format(in_format),
+    pageBorder(in_pageBorder)
+{
+    sampler = Sampler::create();
+    sampler->addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler->maxLod = 0.0f;
+
+    // the initial contents of the atlas are cleared to zero, only needing to be held in memory until they've been transferred to the GPU
+    uint32_t width = (pageWidth + 2 * pageBorder) * numPagesX;
+    uint32_t height = (pageHeight + 2 * pageBorder) * numPagesY;
+    Data::Properties properties(format);
+    properties.dataVariance = STATIC_DATA_UNREF_AFTER_TRANSFER;
+
+    ref_ptr<Data> image;
+    switch (getFormatTraits(format).size)
+    {
+    case 1: image = ubyteArray2D::create(width, height, uint8_t(0), properties); break;
+    case 2: image = ubvec2Array2D::create(width, height, ubvec2(0, 0), properties); break;
+    case 4: image = ubvec4Array2D::create(width, height, ubvec4(0, 0, 0, 0), properties); break;
+    case 8: image = usvec4Array2D::create(width, height, usvec4(0, 0, 0, 0), properties); break;
+    case 16: image = vec4Array2D::create(width, height, vec4(0.0f, 0.0f, 0.0f, 0.0f), properties); break;
+    default: break;
+    }
+
+    if (!image || numPages() == 0)
+    {
+        warn("VirtualTexture::VirtualTexture(..) unsupported format ", format, " or number of pages, no atlas created.");
+        return;
+    }
+
+    atlas = ImageInfo::create(sampler, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    // hand out the lowest pages first
+    _freePages.resize(numPages());
+    for (uint32_t i = 0; i < numPages(); ++i) _freePages[i] = numPages() - 1 - i;
+}
+
+VirtualTexture::~VirtualTexture()
+{
+}
+
+bool VirtualTexture::compatible(const Data* data) const
+{
+    if (!atlas || !data || data->width() != pageWidth || data->height() != pageHeight || data->depth() != 1) return false;
+
+    // block compressed data can't be repacked with borders
+    if (data->properties.blockWidth > 1 || data->properties.blockHeight > 1) return false;
+
+    // texels are copied without conversion, so the formats must match other than RGB data being padded to the atlas's RGBA format, matching the remapping done by Image
+    VkFormat sourceFormat = data->properties.format;
+    VkFormat paddedFormat = sourceFormat;
+    if (sourceFormat >= VK_FORMAT_R8G8B8_UNORM && sourceFormat <= VK_FORMAT_B8G8R8_SRGB)
+        paddedFormat = static_cast<VkFormat>(sourceFormat + 14);
+    else if (sourceFormat >= VK_FORMAT_R16G16B16_UNORM && sourceFormat <= VK_FORMAT_R16G16B16_SFLOAT)
+        paddedFormat = static_cast<VkFormat>(sourceFormat + 7);
+    else if (sourceFormat >= VK_FORMAT_R32G32B32_UINT && sourceFormat <= VK_FORMAT_R32G32B32_SFLOAT)
+        paddedFormat = static_cast<VkFormat>(sourceFormat + 3);
+
+    if (sourceFormat != format && paddedFormat != format) return false;
+
+    auto sourceSize = getFormatTraits(sourceFormat).size;
+    return sourceSize > 0 && data->properties.stride >= static_cast<uint32_t>(sourceSize);
+}
+
+ref_ptr<VirtualTexture::Page> VirtualTexture::allocate(ref_ptr<Data> data)
+{
+    if (!transferTask || !compatible(data)) return {};
+
+    uint32_t index = 0;
+    {
+        std::scoped_lock lock(_mutex);
+        if (_freePages.empty()) return {};
+
+        index = _freePages.back();
+        _freePages.pop_back();
+    }
+
+    auto page = Page::create(ref_ptr<VirtualTexture>(this), index);
+
+    // copy the data into a page sized block, replicating the edge texels into the border and padding to the atlas format if required
+    auto sourceSize = static_cast<uint32_t>(getFormatTraits(data->properties.format).size);
+    auto targetTraits = getFormatTraits(format);
+    auto targetSize = static_cast<uint32_t>(targetTraits.size);
+
+    uint32_t slotWidth = pageWidth + 2 * pageBorder;
+    uint32_t slotHeight = pageHeight + 2 * pageBorder;
+    auto pageData = ubyteArray::create(slotWidth * slotHeight * targetSize);
+
+    uint8_t* dest_ptr = pageData->data();
+    for (uint32_t y = 0; y < slotHeight; ++y)
+    {
+        uint32_t sy = std::min(std::max(y, pageBorder) - pageBorder, pageHeight - 1);
+        for (uint32_t x = 0; x < slotWidth; ++x)
+        {
+            uint32_t sx = std::min(std::max(x, pageBorder) - pageBorder, pageWidth - 1);
+            auto src_ptr = reinterpret_cast<const uint8_t*>(data->dataPointer(sx + sy * pageWidth));
+            std::memcpy(dest_ptr, src_ptr, sourceSize);
+            if (targetSize > sourceSize) std::memcpy(dest_ptr + sourceSize, targetTraits.defaultValue + sourceSize, targetSize - sourceSize);
+            dest_ptr += targetSize;
+        }
+    }
+
+    VkOffset3D imageOffset{static_cast<int32_t>((index % numPagesX) * slotWidth), static_cast<int32_t>((index / numPagesX) * slotHeight), 0};
+    transferTask->transfer(pageData, atlas, imageOffset, VkExtent3D{slotWidth, slotHeight, 1});
+
+    return page;
+}
+
+uint32_t VirtualTexture::numAllocatedPages() const
+{
+    std::scoped_lock lock(_mutex);
+    return numPages() - static_cast<uint32_t>(_freePages.size());
+}
+
+void VirtualTexture::_release(uint32_t index)
+{
+    std::scoped_lock lock(_mutex);
+    _freePages.push_back(index);
+}
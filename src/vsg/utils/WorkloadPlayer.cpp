@@ -0,0 +1,198 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/utils/WorkloadPlayer.h>
+#include <vsg/utils/WorkloadRecorder.h>
+
+#include <fstream>
+
+using namespace vsg;
+
+namespace
+{
+    template<typename T>
+    bool readValue(std::istream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    bool readValue(std::istream& in, Path& path)
+    {
+        uint32_t length = 0;
+        if (!readValue(in, length)) return false;
+
+        std::string str(length, '\0');
+        if (!in.read(str.data(), length)) return false;
+        path = str;
+        return true;
+    }
+
+    /// ProjectionMatrix and ViewMatrix returning the recorded matrices
+    class RecordedProjectionMatrix : public Inherit<ProjectionMatrix, RecordedProjectionMatrix>
+    {
+    public:
+        dmat4 matrix;
+        dmat4 transform() const override { return matrix; }
+    };
+
+    class RecordedViewMatrix : public Inherit<ViewMatrix, RecordedViewMatrix>
+    {
+    public:
+        dmat4 matrix;
+        dmat4 transform() const override { return matrix; }
+    };
+} // namespace
+
+WorkloadPlayer::WorkloadPlayer(const std::vector<ref_ptr<Camera>>& in_cameras) :
+    cameras(in_cameras)
+{
+}
+
+WorkloadPlayer::~WorkloadPlayer()
+{
+}
+
+bool WorkloadPlayer::read(const Path& filename)
+{
+    frames.clear();
+    nextFrame = 0;
+
+    std::ifstream fin(filename, std::ios::in | std::ios::binary);
+    if (!fin)
+    {
+        warn("WorkloadPlayer unable to open ", filename);
+        return false;
+    }
+
+    uint32_t magic = 0, version = 0;
+    if (!readValue(fin, magic) || !readValue(fin, version) || magic != WorkloadRecorder::magic || version > WorkloadRecorder::version)
+    {
+        warn("WorkloadPlayer ", filename, " is not a supported workload log.");
+        return false;
+    }
+
+    // merges are recorded during Viewer::update(), before the FRAME record of the frame they are merged in, so hold on to them until it's read
+    Frame pending;
+
+    auto frameFor = [&](uint64_t frameCount) -> Frame* {
+        if (frames.empty() || frameCount > frames.back().frameCount)
+        {
+            if (pending.frameCount != frameCount) pending = Frame{frameCount};
+            return &pending;
+        }
+
+        for (auto itr = frames.rbegin(); itr != frames.rend(); ++itr)
+        {
+            if (itr->frameCount <= frameCount) return &(*itr);
+        }
+        return &frames.front();
+    };
+
+    uint8_t recordType;
+    while (readValue(fin, recordType))
+    {
+        bool ok = true;
+        switch (recordType)
+        {
+        case (WorkloadRecorder::FRAME): {
+            Frame frame;
+            ok = readValue(fin, frame.frameCount) && readValue(fin, frame.time);
+            if (ok && pending.frameCount == frame.frameCount)
+            {
+                frame.pagerRequests.swap(pending.pagerRequests);
+                frame.pagerMerges.swap(pending.pagerMerges);
+                frame.dynamicDataSize = pending.dynamicDataSize;
+                pending = {};
+            }
+            if (ok) frames.push_back(frame);
+            break;
+        }
+        case (WorkloadRecorder::CAMERA): {
+            uint32_t index = 0;
+            CameraMatrices matrices;
+            ok = readValue(fin, index) && readValue(fin, matrices.projection) && readValue(fin, matrices.view);
+            if (ok && !frames.empty())
+            {
+                auto& frameCameras = frames.back().cameras;
+                if (index >= frameCameras.size()) frameCameras.resize(index + 1);
+                frameCameras[index] = matrices;
+            }
+            break;
+        }
+        case (WorkloadRecorder::PAGER_REQUEST):
+        case (WorkloadRecorder::PAGER_MERGE): {
+            uint64_t frameCount = 0;
+            PagerEvent pagerEvent;
+            ok = readValue(fin, frameCount);
+            if (ok && recordType == WorkloadRecorder::PAGER_REQUEST) ok = readValue(fin, pagerEvent.priority);
+            ok = ok && readValue(fin, pagerEvent.filename);
+            if (auto frame = frameFor(frameCount); ok && frame)
+            {
+                if (recordType == WorkloadRecorder::PAGER_REQUEST)
+                    frame->pagerRequests.push_back(pagerEvent);
+                else
+                    frame->pagerMerges.push_back(pagerEvent);
+            }
+            break;
+        }
+        case (WorkloadRecorder::DYNAMIC_DATA): {
+            uint64_t frameCount = 0, size = 0;
+            ok = readValue(fin, frameCount) && readValue(fin, size);
+            if (auto frame = frameFor(frameCount); ok && frame) frame->dynamicDataSize += size;
+            break;
+        }
+        default:
+            warn("WorkloadPlayer ", filename, " contains unknown record type ", static_cast<uint32_t>(recordType));
+            ok = false;
+            break;
+        }
+
+        if (!ok) break;
+    }
+
+    return !frames.empty();
+}
+
+const WorkloadPlayer::Frame* WorkloadPlayer::advance()
+{
+    if (nextFrame >= frames.size()) return nullptr;
+
+    auto& frame = frames[nextFrame++];
+    for (size_t i = 0; i < cameras.size() && i < frame.cameras.size(); ++i)
+    {
+        auto& camera = cameras[i];
+
+        auto projectionMatrix = camera->projectionMatrix.cast<RecordedProjectionMatrix>();
+        if (!projectionMatrix) camera->projectionMatrix = projectionMatrix = RecordedProjectionMatrix::create();
+        projectionMatrix->matrix = frame.cameras[i].projection;
+
+        auto viewMatrix = camera->viewMatrix.cast<RecordedViewMatrix>();
+        if (!viewMatrix) camera->viewMatrix = viewMatrix = RecordedViewMatrix::create();
+        viewMatrix->matrix = frame.cameras[i].view;
+    }
+    return &frame;
+}
+
+size_t WorkloadPlayer::numPagerRequests() const
+{
+    size_t count = 0;
+    for (auto& frame : frames) count += frame.pagerRequests.size();
+    return count;
+}
+
+size_t WorkloadPlayer::numPagerMerges() const
+{
+    size_t count = 0;
+    for (auto& frame : frames) count += frame.pagerMerges.size();
+    return count;
+}
@@ -0,0 +1,122 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/utils/WorkloadRecorder.h>
+
+using namespace vsg;
+
+namespace
+{
+    template<typename T>
+    void writeValue(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeValue(std::ostream& out, const Path& path)
+    {
+        const auto& str = path.string();
+        writeValue(out, static_cast<uint32_t>(str.size()));
+        out.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+} // namespace
+
+WorkloadRecorder::WorkloadRecorder(const Path& in_filename, const std::vector<ref_ptr<Camera>>& in_cameras) :
+    filename(in_filename),
+    cameras(in_cameras),
+    _fout(in_filename, std::ios::out | std::ios::binary)
+{
+    if (!_fout)
+    {
+        warn("WorkloadRecorder unable to open ", filename, " for writing.");
+        return;
+    }
+
+    writeValue(_fout, magic);
+    writeValue(_fout, version);
+}
+
+WorkloadRecorder::~WorkloadRecorder()
+{
+    close();
+}
+
+bool WorkloadRecorder::valid() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _fout.is_open() && _fout.good();
+}
+
+void WorkloadRecorder::frame(const FrameStamp& frameStamp)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    if (!_fout.is_open()) return;
+
+    if (_firstFrame)
+    {
+        _startTime = frameStamp.time;
+        _firstFrame = false;
+    }
+
+    _frameCount = frameStamp.frameCount;
+
+    writeValue(_fout, FRAME);
+    writeValue(_fout, _frameCount);
+    writeValue(_fout, std::chrono::duration<double>(frameStamp.time - _startTime).count());
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(cameras.size()); ++i)
+    {
+        auto& camera = cameras[i];
+        writeValue(_fout, CAMERA);
+        writeValue(_fout, i);
+        writeValue(_fout, camera->projectionMatrix ? camera->projectionMatrix->transform() : dmat4());
+        writeValue(_fout, camera->viewMatrix ? camera->viewMatrix->transform() : dmat4());
+    }
+}
+
+void WorkloadRecorder::pagerRequest(uint64_t frameCount, const Path& plodFilename, double priority)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    if (!_fout.is_open()) return;
+
+    writeValue(_fout, PAGER_REQUEST);
+    writeValue(_fout, frameCount);
+    writeValue(_fout, priority);
+    writeValue(_fout, plodFilename);
+}
+
+void WorkloadRecorder::pagerMerge(uint64_t frameCount, const Path& plodFilename)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    if (!_fout.is_open()) return;
+
+    writeValue(_fout, PAGER_MERGE);
+    writeValue(_fout, frameCount);
+    writeValue(_fout, plodFilename);
+}
+
+void WorkloadRecorder::dynamicData(uint64_t size)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    if (!_fout.is_open()) return;
+
+    writeValue(_fout, DYNAMIC_DATA);
+    writeValue(_fout, _frameCount);
+    writeValue(_fout, size);
+}
+
+void WorkloadRecorder::close()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    if (_fout.is_open()) _fout.close();
+}
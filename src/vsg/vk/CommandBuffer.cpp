@@ -46,6 +46,9 @@ void CommandBuffer::reset()
     _currentPipelineLayout = VK_NULL_HANDLE;
     _currentPushConstantStageFlags = 0;
 
+    resetRecordedState();
+    recordStatistics = {};
+
     _commandPool->reset();
 }
 
@@ -0,0 +1,88 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Logger.h>
+#include <vsg/vk/CommandPoolRing.h>
+
+using namespace vsg;
+
+bool CommandPoolRing::Frame::available() const
+{
+    for (size_t i = 0; i < numPrimaryUsed; ++i)
+    {
+        if (primaryCommandBuffers[i]->numDependentSubmissions() != 0) return false;
+    }
+    for (size_t i = 0; i < numSecondaryUsed; ++i)
+    {
+        if (secondaryCommandBuffers[i]->numDependentSubmissions() != 0) return false;
+    }
+    return true;
+}
+
+CommandPoolRing::CommandPoolRing(Device* in_device, uint32_t in_queueFamilyIndex) :
+    device(in_device),
+    queueFamilyIndex(in_queueFamilyIndex)
+{
+    _frames.emplace_back();
+    _frames.back().commandPool = CommandPool::create(device, queueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+}
+
+CommandPoolRing::~CommandPoolRing()
+{
+}
+
+void CommandPoolRing::advance()
+{
+    size_t nextFrame = (_currentFrame + 1) % _frames.size();
+    auto& frame = _frames[nextFrame];
+    if (frame.available())
+    {
+        if (frame.numPrimaryUsed > 0 || frame.numSecondaryUsed > 0)
+        {
+            // retain the memory allocated by the CommandBuffers so recording into them again doesn't need to allocate
+            frame.commandPool->reset(0);
+            frame.numPrimaryUsed = 0;
+            frame.numSecondaryUsed = 0;
+        }
+        _currentFrame = nextFrame;
+    }
+    else
+    {
+        // submissions still pending on the oldest frame so grow the ring, inserting the new frame after the current one to preserve the order of the others
+        ++_currentFrame;
+        _frames.insert(_frames.begin() + _currentFrame, Frame{});
+        _frames[_currentFrame].commandPool = CommandPool::create(device, queueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+        debug("CommandPoolRing::advance() growing ring to ", _frames.size(), " frames.");
+    }
+}
+
+ref_ptr<CommandBuffer> CommandPoolRing::allocate(VkCommandBufferLevel level)
+{
+    auto& frame = _frames[_currentFrame];
+
+    bool primary = (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    auto& commandBuffers = primary ? frame.primaryCommandBuffers : frame.secondaryCommandBuffers;
+    auto& numUsed = primary ? frame.numPrimaryUsed : frame.numSecondaryUsed;
+
+    if (numUsed < commandBuffers.size())
+    {
+        auto& commandBuffer = commandBuffers[numUsed++];
+        commandBuffer->_currentPipelineLayout = VK_NULL_HANDLE;
+        commandBuffer->_currentPushConstantStageFlags = 0;
+        return commandBuffer;
+    }
+
+    commandBuffers.push_back(frame.commandPool->allocate(level));
+    ++numUsed;
+    return commandBuffers.back();
+}
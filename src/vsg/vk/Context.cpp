@@ -14,6 +14,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/commands/CopyAndReleaseBuffer.h>
 #include <vsg/commands/CopyAndReleaseImage.h>
 #include <vsg/commands/PipelineBarrier.h>
+#include <vsg/core/Exception.h>
 #include <vsg/core/Version.h>
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
@@ -23,11 +24,16 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/nodes/QuadGroup.h>
 #include <vsg/nodes/StateGroup.h>
 #include <vsg/state/DescriptorSet.h>
+#include <vsg/threading/Latch.h>
+#include <vsg/utils/ImageFormatConverter.h>
 #include <vsg/vk/CommandBuffer.h>
 #include <vsg/vk/Context.h>
 #include <vsg/vk/RenderPass.h>
 #include <vsg/vk/State.h>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace vsg;
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -95,9 +101,21 @@ Context::Context(Device* in_device, const ResourceRequirements& in_resourceRequi
 {
     //semaphore = vsg::Semaphore::create(device);
     scratchMemory = ScratchMemory::create(4096);
+    stateCache = StateCache::getOrCreate(device);
 
     minimum_maxSets = in_resourceRequirements.computeNumDescriptorSets();
     minimum_descriptorPoolSizes = in_resourceRequirements.computeDescriptorPoolSizes();
+
+    // assigned here rather than on first use as GraphicsPipelines may be created in parallel from copies of this Context
+    if (GraphicsPipelineLibrary::supported(device)) graphicsPipelineLibrary = GraphicsPipelineLibrary::getOrCreate(device);
+
+    stagingRingBuffer = StagingRingBuffer::getOrCreate(device);
+
+    // with resizable BAR or unified memory buffer data can be written directly to device local memory
+    if (MemoryBufferPools::supportsHostVisibleDeviceLocalMemory(device))
+    {
+        hostVisibleDeviceMemoryBufferPools = MemoryBufferPools::create("HostVisibleDevice_MemoryBufferPool", device, in_resourceRequirements);
+    }
 }
 
 Context::Context(const Context& context) :
@@ -111,13 +129,22 @@ Context::Context(const Context& context) :
     minimum_maxSets(context.minimum_maxSets),
     minimum_descriptorPoolSizes(context.minimum_descriptorPoolSizes),
     renderPass(context.renderPass),
+    dynamicRendering(context.dynamicRendering),
+    fragmentShadingRateAttachment(context.fragmentShadingRateAttachment),
     defaultPipelineStates(context.defaultPipelineStates),
     overridePipelineStates(context.overridePipelineStates),
     descriptorPools(context.descriptorPools),
+    descriptorHeap(context.descriptorHeap),
+    pipelineCache(context.pipelineCache),
+    graphicsPipelineLibrary(context.graphicsPipelineLibrary),
+    stateCache(context.stateCache),
+    asynchronousPipelineCompile(context.asynchronousPipelineCompile),
     graphicsQueue(context.graphicsQueue),
     commandPool(context.commandPool),
     deviceMemoryBufferPools(context.deviceMemoryBufferPools),
     stagingMemoryBufferPools(context.stagingMemoryBufferPools),
+    stagingRingBuffer(context.stagingRingBuffer),
+    hostVisibleDeviceMemoryBufferPools(context.hostVisibleDeviceMemoryBufferPools),
     scratchBufferSize(context.scratchBufferSize)
 {
     scratchMemory = ScratchMemory::create(4096);
@@ -126,6 +153,7 @@ Context::Context(const Context& context) :
 Context::~Context()
 {
     waitForCompletion();
+    _releaseStagingAllocations();
 }
 
 ref_ptr<CommandBuffer> Context::getOrCreateCommandBuffer()
@@ -187,8 +215,21 @@ ref_ptr<DescriptorSet::Implementation> Context::allocateDescriptorSet(Descriptor
 {
     CPU_INSTRUMENTATION_L2_NC(instrumentation, "Context allocateDescriptorSet", COLOR_COMPILE)
 
+    // with VK_EXT_descriptor_buffer DescriptorSets are suballocated from the Device's DescriptorHeap so no DescriptorPools are required
+    if (DescriptorHeap::supported(device))
+    {
+        if (!descriptorHeap) descriptorHeap = DescriptorHeap::getOrCreate(device);
+        return DescriptorSet::Implementation::create(descriptorHeap, descriptorSetLayout);
+    }
+
+    // update after bind layouts must be allocated from pools created with the matching flag, and aren't mixed with other layouts to avoid the pools' size limits
+    VkDescriptorPoolCreateFlags poolFlags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    if ((descriptorSetLayout->flags & VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT) != 0) poolFlags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+
     for (auto itr = descriptorPools.rbegin(); itr != descriptorPools.rend(); ++itr)
     {
+        if ((*itr)->flags != poolFlags) continue;
+
         auto dsi = (*itr)->allocateDescriptorSet(descriptorSetLayout);
         if (dsi) return dsi;
     }
@@ -197,9 +238,9 @@ ref_ptr<DescriptorSet::Implementation> Context::allocateDescriptorSet(Descriptor
     descriptorSetLayout->getDescriptorPoolSizes(descriptorPoolSizes);
 
     uint32_t maxSets = 1;
-    getDescriptorPoolSizesToUse(maxSets, descriptorPoolSizes);
+    if (poolFlags == VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT) getDescriptorPoolSizesToUse(maxSets, descriptorPoolSizes);
 
-    auto descriptorPool = vsg::DescriptorPool::create(device, maxSets, descriptorPoolSizes);
+    auto descriptorPool = vsg::DescriptorPool::create(device, maxSets, descriptorPoolSizes, poolFlags);
     auto dsi = descriptorPool->allocateDescriptorSet(descriptorSetLayout);
 
     descriptorPools.push_back(descriptorPool);
@@ -222,7 +263,7 @@ void Context::reserve(const ResourceRequirements& requirements)
     DescriptorPoolSizes available_descriptorPoolSizes;
     for (auto& descriptorPool : descriptorPools)
     {
-        descriptorPool->getAvailability(available_maxSets, available_descriptorPoolSizes);
+        if (descriptorPool->flags == VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT) descriptorPool->getAvailability(available_maxSets, available_descriptorPoolSizes);
     }
 
     auto required_maxSets = maxSets;
@@ -266,17 +307,280 @@ void Context::reserve(const ResourceRequirements& requirements)
     }
 }
 
-void Context::copy(ref_ptr<Data> data, ref_ptr<ImageInfo> dest)
+ref_ptr<Context> Context::_getOrCreateDeferredState()
 {
-    CPU_INSTRUMENTATION_L2_NC(instrumentation, "Context copy", COLOR_COMPILE)
+    // reuse the previous snapshot of the Context state if none of the state used by pipeline creation has changed since it was taken
+    if (_deferredState &&
+        _deferredState->viewID == viewID &&
+        _deferredState->mask == mask &&
+        _deferredState->renderPass == renderPass &&
+        _deferredState->dynamicRendering == dynamicRendering &&
+        _deferredState->fragmentShadingRateAttachment == fragmentShadingRateAttachment &&
+        _deferredState->defaultPipelineStates == defaultPipelineStates &&
+        _deferredState->overridePipelineStates == overridePipelineStates)
+    {
+        return _deferredState;
+    }
 
-    if (!copyImageCmd)
+    _deferredState = Context::create(*this);
+    return _deferredState;
+}
+
+bool Context::deferCompile(ref_ptr<GraphicsPipeline> pipeline)
+{
+    if (!operationThreads || !pipeline) return false;
+
+    // already compiled for this view, or being compiled in the background, so nothing to do
+    if (pipeline->pending() || pipeline->validated_vk(viewID) != VK_NULL_HANDLE) return true;
+
+    auto& states = deferredPipelines[pipeline];
+    for (auto& state : states)
     {
-        copyImageCmd = CopyAndReleaseImage::create(stagingMemoryBufferPools);
-        commands.push_back(copyImageCmd);
+        if (state->viewID == viewID) return true;
+    }
+
+    states.push_back(_getOrCreateDeferredState());
+    return true;
+}
+
+bool Context::deferCompile(ref_ptr<ComputePipeline> pipeline)
+{
+    if (!operationThreads || !pipeline) return false;
+
+    auto& states = deferredPipelines[pipeline];
+    if (states.empty()) states.push_back(_getOrCreateDeferredState());
+    return true;
+}
+
+void Context::compileDeferred()
+{
+    if (deferredPipelines.empty()) return;
+
+    CPU_INSTRUMENTATION_L1_NC(instrumentation, "Context compileDeferred", COLOR_COMPILE)
+
+    if (asynchronousPipelineCompile)
+    {
+        struct AsynchronousCompileOperation : public Operation
+        {
+            AsynchronousCompileOperation(ref_ptr<Context> c, DeferredPipelines& p, ref_ptr<OperationThreads> t) :
+                context(c),
+                threads(t)
+            {
+                pipelines.swap(p);
+            }
+
+            void run() override
+            {
+                try
+                {
+                    context->_createPipelines(pipelines, threads);
+                }
+                catch (const Exception& exception)
+                {
+                    warn(exception.message);
+                }
+                catch (const std::exception& exception)
+                {
+                    warn(exception.what());
+                }
+
+                // pipelines that failed to compile are left pending so that the subgraphs using them continue to be skipped
+                for (auto& [object, states] : pipelines)
+                {
+                    auto gp = object.cast<GraphicsPipeline>();
+                    bool compiled = std::all_of(states.begin(), states.end(), [&](const ref_ptr<Context>& state) { return gp->validated_vk(state->viewID) != VK_NULL_HANDLE; });
+                    if (compiled) --(gp->pendingCompiles);
+                }
+            }
+
+            ref_ptr<Context> context;
+            DeferredPipelines pipelines;
+            ref_ptr<OperationThreads> threads;
+        };
+
+        // only GraphicsPipelines have a pending state, so ComputePipelines are still created before returning
+        DeferredPipelines graphicsPipelines;
+        for (auto itr = deferredPipelines.begin(); itr != deferredPipelines.end();)
+        {
+            if (auto gp = itr->first.cast<GraphicsPipeline>())
+            {
+                ++(gp->pendingCompiles);
+                graphicsPipelines.insert(*itr);
+                itr = deferredPipelines.erase(itr);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+
+        // the PipelineLayouts and ShaderModules may be shared with pipelines compiled later on this thread so compile them here,
+        // leaving just the pipeline creation to the background compile, which uses its own copy of the Context so this Context can continue to be used for compiling
+        if (!graphicsPipelines.empty())
+        {
+            _preparePipelines(graphicsPipelines, operationThreads);
+            operationThreads->add(ref_ptr<Operation>(new AsynchronousCompileOperation(Context::create(*this), graphicsPipelines, operationThreads)));
+        }
+    }
+
+    _compilePipelines(deferredPipelines, operationThreads);
+
+    deferredPipelines.clear();
+    _deferredState = {};
+}
+
+void Context::_compilePipelines(DeferredPipelines& pipelines, ref_ptr<OperationThreads> threads)
+{
+    _preparePipelines(pipelines, threads);
+    _createPipelines(pipelines, threads);
+}
+
+void Context::_preparePipelines(DeferredPipelines& pipelines, ref_ptr<OperationThreads> threads)
+{
+    if (pipelines.empty()) return;
+
+    auto pipelineStages = [](const Object* object) {
+        ShaderStages stages;
+        if (auto gp = object->cast<GraphicsPipeline>())
+            stages = gp->stages;
+        else if (auto cp = object->cast<ComputePipeline>(); cp && cp->stage)
+            stages.push_back(cp->stage);
+        return stages;
+    };
+
+    // compile GLSL for all the deferred pipelines together so that identical programs are only compiled once and the rest are compiled in parallel
+    std::vector<ShaderStages> programs;
+    bool requiresShaderCompiler = false;
+    for (auto& entry : pipelines)
+    {
+        programs.push_back(pipelineStages(entry.first));
+        for (auto& shaderStage : programs.back())
+        {
+            if (shaderStage->module && shaderStage->module->code.empty() && !(shaderStage->module->source.empty()))
+            {
+                requiresShaderCompiler = true;
+            }
+        }
     }
 
-    copyImageCmd->copy(data, dest);
+    if (requiresShaderCompiler)
+    {
+        auto sc = getOrCreateShaderCompiler();
+        if (sc)
+        {
+            sc->compile(programs, threads);
+        }
+        else
+        {
+            fatal("VulkanSceneGraph not compiled with GLSLang, unable to compile shaders.");
+        }
+    }
+
+    // PipelineLayout and ShaderModule creation write to objects that may be shared between pipelines so do these serially,
+    // leaving only the expensive vkCreate*Pipelines calls to be run in parallel.
+    auto program_itr = programs.begin();
+    for (auto& [object, states] : pipelines)
+    {
+        PipelineLayout* layout = nullptr;
+        if (auto gp = object->cast<GraphicsPipeline>())
+        {
+            layout = gp->layout;
+            for (auto& state : states) gp->reserve(state->viewID + 1);
+        }
+        else if (auto cp = object->cast<ComputePipeline>())
+        {
+            layout = cp->layout;
+        }
+
+        if (layout) layout->compile(*this);
+        for (auto& shaderStage : *(program_itr++))
+        {
+            shaderStage->compile(*this);
+        }
+    }
+}
+
+void Context::_createPipelines(DeferredPipelines& pipelines, ref_ptr<OperationThreads> threads)
+{
+    if (pipelines.empty()) return;
+
+    struct CompilePipelineOperation : public Operation
+    {
+        CompilePipelineOperation(ref_ptr<Object> obj, std::vector<ref_ptr<Context>>& s, ref_ptr<Latch> l) :
+            object(obj),
+            states(s),
+            latch(l) {}
+
+        void run() override
+        {
+            try
+            {
+                // compile each view of a pipeline in turn as GraphicsPipeline::compile(..) assigns to its per view implementation container.
+                // The state snapshots are shared between the operations running in parallel, so compile with a copy that has its own ScratchMemory.
+                for (auto& state : states)
+                {
+                    auto context = Context::create(*state);
+                    if (auto gp = object->cast<GraphicsPipeline>())
+                        gp->compile(*context);
+                    else if (auto cp = object->cast<ComputePipeline>())
+                        cp->compile(*context);
+                }
+            }
+            catch (const Exception& exception)
+            {
+                message = exception.message;
+                result = exception.result;
+            }
+            catch (const std::exception& exception)
+            {
+                message = exception.what();
+                result = VK_ERROR_UNKNOWN;
+            }
+            catch (...)
+            {
+                message = "Context::_compilePipelines() unknown exception creating pipeline.";
+                result = VK_ERROR_UNKNOWN;
+            }
+
+            // always count down so that the thread waiting on the latch is released
+            latch->count_down();
+        }
+
+        ref_ptr<Object> object;
+        std::vector<ref_ptr<Context>>& states;
+        ref_ptr<Latch> latch;
+        std::string message;
+        int result = 0;
+    };
+
+    // use latch to synchronize this thread with the pipeline creation threads
+    auto latch = Latch::create(static_cast<int>(pipelines.size()));
+
+    std::vector<ref_ptr<CompilePipelineOperation>> operations;
+    operations.reserve(pipelines.size());
+    for (auto& [object, states] : pipelines)
+    {
+        operations.emplace_back(new CompilePipelineOperation(object, states, latch));
+        threads->add(operations.back());
+    }
+
+    // use this thread to create pipelines as well
+    threads->run();
+
+    // wait till all the pipelines have been created
+    latch->wait();
+
+    for (auto& operation : operations)
+    {
+        if (!operation->message.empty()) throw Exception{operation->message, operation->result};
+    }
+}
+
+void Context::copy(ref_ptr<Data> data, ref_ptr<ImageInfo> dest)
+{
+    CPU_INSTRUMENTATION_L2_NC(instrumentation, "Context copy", COLOR_COMPILE)
+
+    copy(data, dest, vsg::computeNumMipMapLevels(data, dest->sampler));
 }
 
 void Context::copy(ref_ptr<Data> data, ref_ptr<ImageInfo> dest, uint32_t numMipMapLevels)
@@ -289,9 +593,72 @@ void Context::copy(ref_ptr<Data> data, ref_ptr<ImageInfo> dest, uint32_t numMipM
         commands.push_back(copyImageCmd);
     }
 
+    // when no format conversion is required stage the data via writeToStagingBuffer() so it can use the stagingRingBuffer
+    if (data && dest->imageView && getFormatTraits(data->properties.format).size == getFormatTraits(dest->imageView->format).size)
+    {
+        VkDeviceSize alignment = std::max(VkDeviceSize(4), VkDeviceSize(data->valueSize()));
+        auto stagingBufferInfo = writeToStagingBuffer(data->dataSize(), alignment, [&](void* ptr) { std::memcpy(ptr, data->dataPointer(), data->dataSize()); });
+        if (stagingBufferInfo)
+        {
+            stagingBufferInfo->data = data;
+            copyImageCmd->add(stagingBufferInfo, dest, numMipMapLevels);
+            return;
+        }
+    }
+
+    // expand 3 component formats on the GPU rather than the CPU
+    if (data && dest->imageView && ImageFormatConverter::supported(data->properties.format, dest->imageView->format))
+    {
+        auto converter = ImageFormatConverter::getOrCreate(*this);
+        if (auto conversion = converter ? converter->convert(*this, data, dest->imageView->format) : ref_ptr<Command>{})
+        {
+            auto targetTraits = getFormatTraits(dest->imageView->format);
+            CopyAndReleaseImage::CopyData cd(conversion.cast<ImageFormatConversion>()->destination, dest, numMipMapLevels);
+            cd.layout.format = dest->imageView->format;
+            cd.layout.stride = targetTraits.size;
+            cd.conversion = conversion;
+            copyImageCmd->add(cd);
+            return;
+        }
+    }
+
     copyImageCmd->copy(data, dest, numMipMapLevels);
 }
 
+ref_ptr<BufferInfo> Context::writeToStagingBuffer(VkDeviceSize size, VkDeviceSize alignment, const std::function<void(void* ptr)>& write)
+{
+    if (stagingRingBuffer)
+    {
+        if (auto allocation = stagingRingBuffer->allocate(size, alignment))
+        {
+            write(allocation.data);
+            _stagingAllocations.push_back(allocation);
+            return stagingRingBuffer->bufferInfo(allocation, size);
+        }
+        debug("Context::writeToStagingBuffer(", size, ") stagingRingBuffer full, falling back to stagingMemoryBufferPools.");
+    }
+
+    auto stagingBufferInfo = stagingMemoryBufferPools->reserveBuffer(size, alignment, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (!stagingBufferInfo) return {};
+
+    auto stagingBuffer = stagingBufferInfo->buffer;
+    auto stagingMemory = stagingBuffer->getDeviceMemory(deviceID);
+    if (!stagingMemory) return {};
+
+    void* ptr = nullptr;
+    if (stagingMemory->map(stagingBuffer->getMemoryOffset(deviceID) + stagingBufferInfo->offset, size, 0, &ptr) != VK_SUCCESS) return {};
+    write(ptr);
+    stagingMemory->unmap();
+
+    return stagingBufferInfo;
+}
+
+void Context::_releaseStagingAllocations()
+{
+    for (auto& allocation : _stagingAllocations) stagingRingBuffer->release(allocation);
+    _stagingAllocations.clear();
+}
+
 void Context::copy(ref_ptr<BufferInfo> src, ref_ptr<BufferInfo> dest)
 {
     CPU_INSTRUMENTATION_L2_NC(instrumentation, "Context copy", COLOR_COMPILE)
@@ -382,11 +749,13 @@ void Context::waitForCompletion()
 
     if (!commandBuffer || !fence)
     {
+        _releaseStagingAllocations();
         return;
     }
 
     if (commands.empty() && buildAccelerationStructureCommands.empty())
     {
+        _releaseStagingAllocations();
         return;
     }
 
@@ -407,4 +776,7 @@ void Context::waitForCompletion()
     commands.clear();
     copyImageCmd = nullptr;
     copyBufferCmd = nullptr;
+
+    // the GPU has completed the copies so the staging memory can be reused
+    _releaseStagingAllocations();
 }
@@ -0,0 +1,223 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Exception.h>
+#include <vsg/core/observer_ptr.h>
+#include <vsg/state/DescriptorSetLayout.h>
+#include <vsg/vk/CommandBuffer.h>
+#include <vsg/vk/DescriptorHeap.h>
+
+#include <algorithm>
+
+using namespace vsg;
+
+DescriptorHeap::DescriptorHeap(Device* in_device, VkDeviceSize in_size) :
+    size(in_size),
+    usage(VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT),
+    _device(in_device),
+    _memorySlots(static_cast<size_t>(in_size))
+{
+    if (!supported(_device))
+    {
+        throw Exception{"Error: vsg::DescriptorHeap requires a Device created with VK_EXT_descriptor_buffer enabled.", VK_ERROR_EXTENSION_NOT_PRESENT};
+    }
+
+    _properties = _device->getPhysicalDevice()->getProperties<VkPhysicalDeviceDescriptorBufferPropertiesEXT, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT>();
+
+    _buffer = Buffer::create(size, usage, VK_SHARING_MODE_EXCLUSIVE);
+    _buffer->compile(_device);
+
+    // the buffer's device address is passed to vkCmdBindDescriptorBuffersEXT so the memory has to be allocated with VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT
+    VkMemoryAllocateFlagsInfo allocateFlagsInfo = {};
+    allocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+
+    auto memRequirements = _buffer->getMemoryRequirements(_device->deviceID);
+    auto deviceMemory = DeviceMemory::create(_device, memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &allocateFlagsInfo);
+    _buffer->bind(deviceMemory, 0);
+
+    void* mappedData = nullptr;
+    if (VkResult result = deviceMemory->map(0, size, 0, &mappedData); result != VK_SUCCESS)
+    {
+        throw Exception{"Error: vsg::DescriptorHeap failed to map descriptor buffer memory.", result};
+    }
+    _mappedData = static_cast<uint8_t*>(mappedData);
+
+    VkBufferDeviceAddressInfo addressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, nullptr, _buffer->vk(_device->deviceID)};
+    _address = _device->getExtensions()->vkGetBufferDeviceAddressKHR(_device->vk(), &addressInfo);
+}
+
+DescriptorHeap::~DescriptorHeap()
+{
+    if (_mappedData) _buffer->getDeviceMemory(_device->deviceID)->unmap();
+}
+
+ref_ptr<DescriptorHeap> DescriptorHeap::getOrCreate(Device* device, VkDeviceSize size)
+{
+    static std::mutex s_mutex;
+    static std::vector<observer_ptr<DescriptorHeap>> s_descriptorHeaps;
+
+    std::scoped_lock<std::mutex> lock(s_mutex);
+
+    if (s_descriptorHeaps.size() <= device->deviceID) s_descriptorHeaps.resize(device->deviceID + 1);
+
+    auto descriptorHeap = s_descriptorHeaps[device->deviceID].ref_ptr();
+    if (!descriptorHeap || descriptorHeap->getDevice() != device)
+    {
+        descriptorHeap = DescriptorHeap::create(device, size);
+        s_descriptorHeaps[device->deviceID] = descriptorHeap;
+    }
+    return descriptorHeap;
+}
+
+MemorySlots::OptionalOffset DescriptorHeap::reserve(const DescriptorSetLayout* descriptorSetLayout, VkDeviceSize& setSize)
+{
+    auto extensions = _device->getExtensions();
+    extensions->vkGetDescriptorSetLayoutSizeEXT(_device->vk(), descriptorSetLayout->vk(_device->deviceID), &setSize);
+
+    // DescriptorSets with no bindings don't need any space but still need a valid offset to bind
+    size_t alignment = static_cast<size_t>(std::max(_properties.descriptorBufferOffsetAlignment, VkDeviceSize(1)));
+    setSize = std::max(((setSize + alignment - 1) / alignment) * alignment, VkDeviceSize(alignment));
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _memorySlots.reserve(static_cast<size_t>(setSize), alignment);
+}
+
+void DescriptorHeap::release(VkDeviceSize offset, VkDeviceSize setSize)
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _memorySlots.release(static_cast<size_t>(offset), static_cast<size_t>(setSize));
+}
+
+size_t DescriptorHeap::totalAvailableSize() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _memorySlots.totalAvailableSize();
+}
+
+size_t DescriptorHeap::totalReservedSize() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _memorySlots.totalReservedSize();
+}
+
+size_t DescriptorHeap::_descriptorSize(VkDescriptorType descriptorType) const
+{
+    switch (descriptorType)
+    {
+    case VK_DESCRIPTOR_TYPE_SAMPLER: return _properties.samplerDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: return _properties.combinedImageSamplerDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE: return _properties.sampledImageDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: return _properties.storageImageDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: return _properties.uniformBufferDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: return _properties.storageBufferDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT: return _properties.inputAttachmentDescriptorSize;
+    case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR: return _properties.accelerationStructureDescriptorSize;
+    default: return 0;
+    }
+}
+
+void DescriptorHeap::write(const DescriptorSetLayout* descriptorSetLayout, VkDeviceSize offset, uint32_t descriptorWriteCount, const VkWriteDescriptorSet* descriptorWrites)
+{
+    auto extensions = _device->getExtensions();
+    VkDescriptorSetLayout vk_descriptorSetLayout = descriptorSetLayout->vk(_device->deviceID);
+
+    // descriptors are written straight into the mapped buffer so no locking is required, the caller is responsible for not writing to a DescriptorSet being used by the GPU.
+    for (uint32_t w = 0; w < descriptorWriteCount; ++w)
+    {
+        const auto& wds = descriptorWrites[w];
+
+        size_t descriptorSize = _descriptorSize(wds.descriptorType);
+        if (descriptorSize == 0)
+        {
+            throw Exception{"Error: vsg::DescriptorHeap::write() unsupported descriptorType, texel buffer, dynamic buffer and inline uniform block descriptors can't be used with VK_EXT_descriptor_buffer.", VK_ERROR_FEATURE_NOT_PRESENT};
+        }
+
+        VkDeviceSize bindingOffset = 0;
+        extensions->vkGetDescriptorSetLayoutBindingOffsetEXT(_device->vk(), vk_descriptorSetLayout, wds.dstBinding, &bindingOffset);
+
+        auto accelerationStructureWrite = (wds.descriptorType == VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR) ? static_cast<const VkWriteDescriptorSetAccelerationStructureKHR*>(wds.pNext) : nullptr;
+
+        for (uint32_t i = 0; i < wds.descriptorCount; ++i)
+        {
+            VkDescriptorGetInfoEXT getInfo = {};
+            getInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+            getInfo.type = wds.descriptorType;
+
+            VkDescriptorAddressInfoEXT addressInfo = {};
+            switch (wds.descriptorType)
+            {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+                getInfo.data.pSampler = &(wds.pImageInfo[i].sampler);
+                break;
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                getInfo.data.pCombinedImageSampler = wds.pImageInfo + i;
+                break;
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                getInfo.data.pSampledImage = wds.pImageInfo + i;
+                break;
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                getInfo.data.pStorageImage = wds.pImageInfo + i;
+                break;
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                getInfo.data.pInputAttachmentImage = wds.pImageInfo + i;
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: {
+                // buffers have to be created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, DescriptorBuffer::compile() adds it when the Device supports DescriptorHeap.
+                VkBufferDeviceAddressInfo bufferAddressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, nullptr, wds.pBufferInfo[i].buffer};
+                addressInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+                addressInfo.address = extensions->vkGetBufferDeviceAddressKHR(_device->vk(), &bufferAddressInfo) + wds.pBufferInfo[i].offset;
+                addressInfo.range = wds.pBufferInfo[i].range;
+                addressInfo.format = VK_FORMAT_UNDEFINED;
+                if (wds.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+                    getInfo.data.pUniformBuffer = &addressInfo;
+                else
+                    getInfo.data.pStorageBuffer = &addressInfo;
+                break;
+            }
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR: {
+                VkAccelerationStructureDeviceAddressInfoKHR deviceAddressInfo = {};
+                deviceAddressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
+                deviceAddressInfo.accelerationStructure = accelerationStructureWrite->pAccelerationStructures[i];
+                getInfo.data.accelerationStructure = extensions->vkGetAccelerationStructureDeviceAddressKHR(_device->vk(), &deviceAddressInfo);
+                break;
+            }
+            default:
+                break;
+            }
+
+            uint8_t* dst = _mappedData + offset + bindingOffset + (wds.dstArrayElement + i) * descriptorSize;
+            extensions->vkGetDescriptorEXT(_device->vk(), &getInfo, descriptorSize, dst);
+        }
+    }
+}
+
+void DescriptorHeap::bind(CommandBuffer& commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout, uint32_t firstSet, uint32_t setCount, const VkDeviceSize* offsets) const
+{
+    auto extensions = _device->getExtensions();
+
+    // all DescriptorSets live in the one buffer so every set uses buffer index 0
+    static const uint32_t s_bufferIndices[32] = {};
+
+    VkDescriptorBufferBindingInfoEXT bindingInfo = {};
+    bindingInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+    bindingInfo.address = _address;
+    bindingInfo.usage = usage;
+    extensions->vkCmdBindDescriptorBuffersEXT(commandBuffer.vk(), 1, &bindingInfo);
+
+    for (uint32_t i = 0; i < setCount; i += 32)
+    {
+        uint32_t count = std::min(setCount - i, 32u);
+        extensions->vkCmdSetDescriptorBufferOffsetsEXT(commandBuffer.vk(), pipelineBindPoint, layout, firstSet + i, count, s_bufferIndices, offsets + i);
+    }
+}
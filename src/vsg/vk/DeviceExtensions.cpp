@@ -25,18 +25,38 @@ DeviceExtensions::DeviceExtensions(Device* device)
     // VK_EXT_host_query_reset
     device->getProcAddr(vkResetQueryPool, "vkResetQueryPool", "vkResetQueryPoolEXT");
 
+    // VK_KHR_descriptor_update_template / Vulkan-1.1
+    if (device->supportsApiVersion(VK_API_VERSION_1_1) || device->supportsDeviceExtension(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME))
+    {
+        device->getProcAddr(vkCreateDescriptorUpdateTemplate, "vkCreateDescriptorUpdateTemplate", "vkCreateDescriptorUpdateTemplateKHR");
+        device->getProcAddr(vkDestroyDescriptorUpdateTemplate, "vkDestroyDescriptorUpdateTemplate", "vkDestroyDescriptorUpdateTemplateKHR");
+        device->getProcAddr(vkUpdateDescriptorSetWithTemplate, "vkUpdateDescriptorSetWithTemplate", "vkUpdateDescriptorSetWithTemplateKHR");
+    }
+
+    // VK_KHR_push_descriptor
+    if (device->supportsDeviceExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME))
+        device->getProcAddr(vkCmdPushDescriptorSetKHR, "vkCmdPushDescriptorSetKHR");
+
     // VK_KHR_create_renderpass2
     if (device->supportsApiVersion(VK_API_VERSION_1_2))
         device->getProcAddr(vkCreateRenderPass2, "vkCreateRenderPass2");
     else if (device->getPhysicalDevice()->supportsDeviceExtension(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME))
         device->getProcAddr(vkCreateRenderPass2, "vkCreateRenderPass2KHR");
 
+    // VK_KHR_draw_indirect_count
+    if (device->supportsApiVersion(VK_API_VERSION_1_2))
+        device->getProcAddr(vkCmdDrawIndexedIndirectCount, "vkCmdDrawIndexedIndirectCount");
+    else if (device->getPhysicalDevice()->supportsDeviceExtension("VK_KHR_draw_indirect_count"))
+        device->getProcAddr(vkCmdDrawIndexedIndirectCount, "vkCmdDrawIndexedIndirectCountKHR");
+
     // VK_KHR_ray_tracing
     device->getProcAddr(vkCreateAccelerationStructureKHR, "vkCreateAccelerationStructureKHR");
     device->getProcAddr(vkDestroyAccelerationStructureKHR, "vkDestroyAccelerationStructureKHR");
     device->getProcAddr(vkGetAccelerationStructureDeviceAddressKHR, "vkGetAccelerationStructureDeviceAddressKHR");
     device->getProcAddr(vkGetAccelerationStructureBuildSizesKHR, "vkGetAccelerationStructureBuildSizesKHR");
     device->getProcAddr(vkCmdBuildAccelerationStructuresKHR, "vkCmdBuildAccelerationStructuresKHR");
+    device->getProcAddr(vkCmdCopyAccelerationStructureKHR, "vkCmdCopyAccelerationStructureKHR");
+    device->getProcAddr(vkCmdWriteAccelerationStructuresPropertiesKHR, "vkCmdWriteAccelerationStructuresPropertiesKHR");
     device->getProcAddr(vkCreateRayTracingPipelinesKHR, "vkCreateRayTracingPipelinesKHR");
     device->getProcAddr(vkGetRayTracingShaderGroupHandlesKHR, "vkGetRayTracingShaderGroupHandlesKHR");
     device->getProcAddr(vkCmdTraceRaysKHR, "vkCmdTraceRaysKHR");
@@ -47,4 +67,84 @@ DeviceExtensions::DeviceExtensions(Device* device)
     device->getProcAddr(vkCmdDrawMeshTasksEXT, "vkCmdDrawMeshTasksEXT");
     device->getProcAddr(vkCmdDrawMeshTasksIndirectEXT, "vkCmdDrawMeshTasksIndirectEXT");
     device->getProcAddr(vkCmdDrawMeshTasksIndirectCountEXT, "vkCmdDrawMeshTasksIndirectCountEXT");
+
+    // VK_EXT_conditional_rendering
+    if (device->supportsDeviceExtension(VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME))
+    {
+        device->getProcAddr(vkCmdBeginConditionalRenderingEXT, "vkCmdBeginConditionalRenderingEXT");
+        device->getProcAddr(vkCmdEndConditionalRenderingEXT, "vkCmdEndConditionalRenderingEXT");
+    }
+
+    // VK_KHR_timeline_semaphore
+    device->getProcAddr(vkGetSemaphoreCounterValue, "vkGetSemaphoreCounterValue", "vkGetSemaphoreCounterValueKHR");
+    device->getProcAddr(vkWaitSemaphores, "vkWaitSemaphores", "vkWaitSemaphoresKHR");
+    device->getProcAddr(vkSignalSemaphore, "vkSignalSemaphore", "vkSignalSemaphoreKHR");
+
+    // VK_KHR_present_wait
+    if (device->supportsDeviceExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+        device->getProcAddr(vkWaitForPresentKHR, "vkWaitForPresentKHR");
+
+    // VK_KHR_external_memory_fd
+    if (device->supportsDeviceExtension(VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME))
+    {
+        device->getProcAddr(vkGetMemoryFdKHR, "vkGetMemoryFdKHR");
+        device->getProcAddr(vkGetMemoryFdPropertiesKHR, "vkGetMemoryFdPropertiesKHR");
+    }
+
+    // VK_KHR_external_semaphore_fd
+    if (device->supportsDeviceExtension(VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME))
+    {
+        device->getProcAddr(vkGetSemaphoreFdKHR, "vkGetSemaphoreFdKHR");
+        device->getProcAddr(vkImportSemaphoreFdKHR, "vkImportSemaphoreFdKHR");
+    }
+
+    // VK_KHR_dynamic_rendering
+    device->getProcAddr(vkCmdBeginRendering, "vkCmdBeginRendering", "vkCmdBeginRenderingKHR");
+    device->getProcAddr(vkCmdEndRendering, "vkCmdEndRendering", "vkCmdEndRenderingKHR");
+
+    // VK_KHR_fragment_shading_rate
+    if (device->supportsDeviceExtension(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME))
+        device->getProcAddr(vkCmdSetFragmentShadingRateKHR, "vkCmdSetFragmentShadingRateKHR");
+
+    // VK_EXT_descriptor_buffer
+    if (device->supportsDeviceExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME))
+    {
+        device->getProcAddr(vkGetDescriptorSetLayoutSizeEXT, "vkGetDescriptorSetLayoutSizeEXT");
+        device->getProcAddr(vkGetDescriptorSetLayoutBindingOffsetEXT, "vkGetDescriptorSetLayoutBindingOffsetEXT");
+        device->getProcAddr(vkGetDescriptorEXT, "vkGetDescriptorEXT");
+        device->getProcAddr(vkCmdBindDescriptorBuffersEXT, "vkCmdBindDescriptorBuffersEXT");
+        device->getProcAddr(vkCmdSetDescriptorBufferOffsetsEXT, "vkCmdSetDescriptorBufferOffsetsEXT");
+    }
+
+    // VK_EXT_extended_dynamic_state
+    if (device->supportsApiVersion(VK_API_VERSION_1_3) || device->supportsDeviceExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME))
+    {
+        device->getProcAddr(vkCmdSetCullMode, "vkCmdSetCullMode", "vkCmdSetCullModeEXT");
+        device->getProcAddr(vkCmdSetFrontFace, "vkCmdSetFrontFace", "vkCmdSetFrontFaceEXT");
+        device->getProcAddr(vkCmdSetPrimitiveTopology, "vkCmdSetPrimitiveTopology", "vkCmdSetPrimitiveTopologyEXT");
+        device->getProcAddr(vkCmdSetDepthTestEnable, "vkCmdSetDepthTestEnable", "vkCmdSetDepthTestEnableEXT");
+        device->getProcAddr(vkCmdSetDepthWriteEnable, "vkCmdSetDepthWriteEnable", "vkCmdSetDepthWriteEnableEXT");
+        device->getProcAddr(vkCmdSetDepthCompareOp, "vkCmdSetDepthCompareOp", "vkCmdSetDepthCompareOpEXT");
+        device->getProcAddr(vkCmdSetDepthBoundsTestEnable, "vkCmdSetDepthBoundsTestEnable", "vkCmdSetDepthBoundsTestEnableEXT");
+        device->getProcAddr(vkCmdSetStencilTestEnable, "vkCmdSetStencilTestEnable", "vkCmdSetStencilTestEnableEXT");
+        device->getProcAddr(vkCmdSetStencilOp, "vkCmdSetStencilOp", "vkCmdSetStencilOpEXT");
+    }
+
+    // VK_EXT_extended_dynamic_state2
+    if (device->supportsApiVersion(VK_API_VERSION_1_3) || device->supportsDeviceExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME))
+    {
+        device->getProcAddr(vkCmdSetRasterizerDiscardEnable, "vkCmdSetRasterizerDiscardEnable", "vkCmdSetRasterizerDiscardEnableEXT");
+        device->getProcAddr(vkCmdSetDepthBiasEnable, "vkCmdSetDepthBiasEnable", "vkCmdSetDepthBiasEnableEXT");
+        device->getProcAddr(vkCmdSetPrimitiveRestartEnable, "vkCmdSetPrimitiveRestartEnable", "vkCmdSetPrimitiveRestartEnableEXT");
+    }
+
+    // VK_EXT_extended_dynamic_state3
+    if (device->supportsDeviceExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME))
+    {
+        device->getProcAddr(vkCmdSetDepthClampEnableEXT, "vkCmdSetDepthClampEnableEXT");
+        device->getProcAddr(vkCmdSetPolygonModeEXT, "vkCmdSetPolygonModeEXT");
+        device->getProcAddr(vkCmdSetColorBlendEnableEXT, "vkCmdSetColorBlendEnableEXT");
+        device->getProcAddr(vkCmdSetColorBlendEquationEXT, "vkCmdSetColorBlendEquationEXT");
+        device->getProcAddr(vkCmdSetColorWriteMaskEXT, "vkCmdSetColorWriteMaskEXT");
+    }
 }
@@ -17,6 +17,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <atomic>
 #include <cstring>
 
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#    include <vulkan/vulkan_win32.h>
+#endif
+
 using namespace vsg;
 
 #define DO_CHECK 0
@@ -46,6 +54,7 @@ DeviceMemory::DeviceMemory(Device* device, const VkMemoryRequirements& memRequir
         throw Exception{"Error: vsg::DeviceMemory::create(...) failed to create DeviceMemory, no usable memory type found.", VK_ERROR_FORMAT_NOT_SUPPORTED};
     }
     uint32_t memoryTypeIndex = i;
+    _heapIndex = memProperties.memoryTypes[memoryTypeIndex].heapIndex;
 
 #if DO_CHECK
     if (properties & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
@@ -72,6 +81,8 @@ DeviceMemory::DeviceMemory(Device* device, const VkMemoryRequirements& memRequir
     {
         throw Exception{"Error: Failed to allocate DeviceMemory.", result};
     }
+
+    _device->_allocatedMemory[_heapIndex] += memRequirements.size;
 }
 
 DeviceMemory::~DeviceMemory()
@@ -83,7 +94,64 @@ DeviceMemory::~DeviceMemory()
 #endif
 
         vkFreeMemory(*_device, _deviceMemory, _device->getAllocationCallbacks());
+
+        _device->_allocatedMemory[_heapIndex] -= _memoryRequirements.size;
+    }
+}
+
+int DeviceMemory::exportFd(VkExternalMemoryHandleTypeFlagBits handleType) const
+{
+    auto vkGetMemoryFdKHR = _device->getExtensions()->vkGetMemoryFdKHR;
+    if (!vkGetMemoryFdKHR)
+    {
+        warn("DeviceMemory::exportFd() requires VK_KHR_external_memory_fd to be enabled on the Device.");
+        return -1;
+    }
+
+    VkMemoryGetFdInfoKHR getFdInfo = {};
+    getFdInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
+    getFdInfo.pNext = nullptr;
+    getFdInfo.memory = _deviceMemory;
+    getFdInfo.handleType = handleType;
+
+    int fd = -1;
+    if (VkResult result = vkGetMemoryFdKHR(*_device, &getFdInfo, &fd); result != VK_SUCCESS)
+    {
+        warn("DeviceMemory::exportFd() vkGetMemoryFdKHR failed, VkResult = ", result);
+        return -1;
     }
+    return fd;
+}
+
+void* DeviceMemory::exportWin32Handle(VkExternalMemoryHandleTypeFlagBits handleType) const
+{
+#if defined(_WIN32)
+    // loaded on demand as the Win32 types are only available with vulkan_win32.h
+    PFN_vkGetMemoryWin32HandleKHR vkGetMemoryWin32HandleKHR = nullptr;
+    if (!_device->getProcAddr(vkGetMemoryWin32HandleKHR, "vkGetMemoryWin32HandleKHR"))
+    {
+        warn("DeviceMemory::exportWin32Handle() requires VK_KHR_external_memory_win32 to be enabled on the Device.");
+        return nullptr;
+    }
+
+    VkMemoryGetWin32HandleInfoKHR getHandleInfo = {};
+    getHandleInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_WIN32_HANDLE_INFO_KHR;
+    getHandleInfo.pNext = nullptr;
+    getHandleInfo.memory = _deviceMemory;
+    getHandleInfo.handleType = handleType;
+
+    HANDLE handle = nullptr;
+    if (VkResult result = vkGetMemoryWin32HandleKHR(*_device, &getHandleInfo, &handle); result != VK_SUCCESS)
+    {
+        warn("DeviceMemory::exportWin32Handle() vkGetMemoryWin32HandleKHR failed, VkResult = ", result);
+        return nullptr;
+    }
+    return handle;
+#else
+    (void)handleType;
+    warn("DeviceMemory::exportWin32Handle() not supported on this platform.");
+    return nullptr;
+#endif
 }
 
 VkResult DeviceMemory::map(VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags, void** ppData)
@@ -148,3 +216,85 @@ size_t DeviceMemory::totalReservedSize() const
     std::scoped_lock<std::mutex> lock(_mutex);
     return _memorySlots.totalReservedSize();
 }
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// external memory
+//
+static void* dedicatedAllocateInfo(VkMemoryDedicatedAllocateInfo& dedicatedInfo, VkImage dedicatedImage, VkBuffer dedicatedBuffer)
+{
+    if (dedicatedImage == VK_NULL_HANDLE && dedicatedBuffer == VK_NULL_HANDLE) return nullptr;
+
+    dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicatedInfo.pNext = nullptr;
+    dedicatedInfo.image = dedicatedImage;
+    dedicatedInfo.buffer = dedicatedBuffer;
+    return &dedicatedInfo;
+}
+
+ref_ptr<DeviceMemory> vsg::createExportableDeviceMemory(Device* device, const VkMemoryRequirements& memRequirements, VkMemoryPropertyFlags properties, VkExternalMemoryHandleTypeFlags handleTypes,
+                                                        VkImage dedicatedImage, VkBuffer dedicatedBuffer)
+{
+    VkMemoryDedicatedAllocateInfo dedicatedInfo = {};
+
+    VkExportMemoryAllocateInfo exportInfo = {};
+    exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO;
+    exportInfo.pNext = dedicatedAllocateInfo(dedicatedInfo, dedicatedImage, dedicatedBuffer);
+    exportInfo.handleTypes = handleTypes;
+
+    return DeviceMemory::create(device, memRequirements, properties, &exportInfo);
+}
+
+ref_ptr<DeviceMemory> vsg::importDeviceMemory(Device* device, const VkMemoryRequirements& memRequirements, VkMemoryPropertyFlags properties, VkExternalMemoryHandleTypeFlagBits handleType, int fd,
+                                              VkImage dedicatedImage, VkBuffer dedicatedBuffer)
+{
+    auto requirements = memRequirements;
+
+    // dma-bufs can only be imported into the memory types that the implementation reports for them
+    if (handleType == VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT)
+    {
+        if (auto vkGetMemoryFdPropertiesKHR = device->getExtensions()->vkGetMemoryFdPropertiesKHR)
+        {
+            VkMemoryFdPropertiesKHR fdProperties = {};
+            fdProperties.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
+            fdProperties.pNext = nullptr;
+            if (vkGetMemoryFdPropertiesKHR(*device, handleType, fd, &fdProperties) == VK_SUCCESS) requirements.memoryTypeBits &= fdProperties.memoryTypeBits;
+        }
+    }
+
+    VkMemoryDedicatedAllocateInfo dedicatedInfo = {};
+
+    VkImportMemoryFdInfoKHR importInfo = {};
+    importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
+    importInfo.pNext = dedicatedAllocateInfo(dedicatedInfo, dedicatedImage, dedicatedBuffer);
+    importInfo.handleType = handleType;
+    importInfo.fd = fd;
+
+    return DeviceMemory::create(device, requirements, properties, &importInfo);
+}
+
+ref_ptr<DeviceMemory> vsg::importDeviceMemoryWin32(Device* device, const VkMemoryRequirements& memRequirements, VkMemoryPropertyFlags properties, VkExternalMemoryHandleTypeFlagBits handleType, void* handle,
+                                                   VkImage dedicatedImage, VkBuffer dedicatedBuffer)
+{
+#if defined(_WIN32)
+    VkMemoryDedicatedAllocateInfo dedicatedInfo = {};
+
+    VkImportMemoryWin32HandleInfoKHR importInfo = {};
+    importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_WIN32_HANDLE_INFO_KHR;
+    importInfo.pNext = dedicatedAllocateInfo(dedicatedInfo, dedicatedImage, dedicatedBuffer);
+    importInfo.handleType = handleType;
+    importInfo.handle = handle;
+    importInfo.name = nullptr;
+
+    return DeviceMemory::create(device, memRequirements, properties, &importInfo);
+#else
+    (void)device;
+    (void)memRequirements;
+    (void)properties;
+    (void)handleType;
+    (void)handle;
+    (void)dedicatedImage;
+    (void)dedicatedBuffer;
+    throw Exception{"Error: importDeviceMemoryWin32() not supported on this platform.", VK_ERROR_FEATURE_NOT_PRESENT};
+#endif
+}
@@ -47,7 +47,10 @@ void Fence::resetFenceAndDependencies()
 
     for (auto& commandBuffer : _dependentCommandBuffers)
     {
-        commandBuffer->numDependentSubmissions().exchange(0);
+        // CommandBuffers reused by CommandGraph::reuseCommandBuffers may have submissions pending on other Fences, so only release this Fence's submission
+        auto& numDependentSubmissions = commandBuffer->numDependentSubmissions();
+        auto count = numDependentSubmissions.load();
+        while (count > 0 && !numDependentSubmissions.compare_exchange_weak(count, count - 1)) {}
     }
 
     _dependentSemaphores.clear();
@@ -58,10 +61,30 @@ void Fence::resetFenceAndDependencies()
 
 VkResult Fence::wait(uint64_t timeout) const
 {
+    if (_timeline) return _timeline->wait(_timelineValue, timeout);
     return vkWaitForFences(*_device, 1, &_vkFence, VK_TRUE, timeout);
 }
 
-VkResult Fence::reset() const
+VkResult Fence::status() const
 {
+    if (_timeline) return (_timeline->value() >= _timelineValue) ? VK_SUCCESS : VK_NOT_READY;
+    return vkGetFenceStatus(*_device, _vkFence);
+}
+
+void Fence::assignTimelineValue(ref_ptr<TimelineSemaphore> timeline, uint64_t value)
+{
+    _timeline = timeline;
+    _timelineValue = value;
+}
+
+VkResult Fence::reset()
+{
+    if (_timeline)
+    {
+        // the VkFence wasn't submitted so remains unsignalled
+        _timeline = {};
+        _timelineValue = 0;
+        return VK_SUCCESS;
+    }
     return vkResetFences(*_device, 1, &_vkFence);
 }
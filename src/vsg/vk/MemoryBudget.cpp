@@ -0,0 +1,95 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/vk/MemoryBudget.h>
+
+using namespace vsg;
+
+MemoryBudget::MemoryBudget(ref_ptr<Device> in_device) :
+    device(in_device)
+{
+    memoryBudgetSupported = device->supportsDeviceExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    update();
+}
+
+MemoryBudget::~MemoryBudget()
+{
+}
+
+void MemoryBudget::update()
+{
+    auto physicalDevice = device->getPhysicalDevice();
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    bool budgetQueried = physicalDevice->getMemoryProperties(memoryProperties, memoryBudgetSupported ? &budgetProperties : nullptr) && memoryBudgetSupported;
+
+    heaps.resize(memoryProperties.memoryHeapCount);
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+    {
+        auto& heap = heaps[i];
+        heap.flags = memoryProperties.memoryHeaps[i].flags;
+        heap.size = memoryProperties.memoryHeaps[i].size;
+        heap.allocated = device->allocatedMemory(i);
+
+        if (budgetQueried)
+        {
+            heap.budget = budgetProperties.heapBudget[i];
+            heap.usage = budgetProperties.heapUsage[i];
+        }
+        else
+        {
+            heap.budget = static_cast<VkDeviceSize>(static_cast<double>(heap.size) * fallbackBudgetRatio);
+            heap.usage = heap.allocated;
+        }
+    }
+}
+
+VkDeviceSize MemoryBudget::budget(VkMemoryHeapFlags heapFlags) const
+{
+    VkDeviceSize total = 0;
+    for (auto& heap : heaps)
+    {
+        if ((heap.flags & heapFlags) == heapFlags) total += heap.budget;
+    }
+    return total;
+}
+
+VkDeviceSize MemoryBudget::usage(VkMemoryHeapFlags heapFlags) const
+{
+    VkDeviceSize total = 0;
+    for (auto& heap : heaps)
+    {
+        if ((heap.flags & heapFlags) == heapFlags) total += heap.usage;
+    }
+    return total;
+}
+
+double MemoryBudget::usageRatio(VkMemoryHeapFlags heapFlags) const
+{
+    auto total_budget = budget(heapFlags);
+    if (total_budget == 0) return 0.0;
+    return static_cast<double>(usage(heapFlags)) / static_cast<double>(total_budget);
+}
+
+void MemoryBudget::report(std::ostream& out) const
+{
+    out << "MemoryBudget::report() memoryBudgetSupported = " << memoryBudgetSupported << std::endl;
+    for (size_t i = 0; i < heaps.size(); ++i)
+    {
+        auto& heap = heaps[i];
+        out << "    heap[" << i << "] flags = " << heap.flags << ", size = " << heap.size << ", budget = " << heap.budget << ", usage = " << heap.usage << ", allocated = " << heap.allocated << std::endl;
+    }
+}
@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsg/io/Logger.h>
 #include <vsg/io/Options.h>
+#include <vsg/vk/DescriptorHeap.h>
 #include <vsg/vk/MemoryBufferPools.h>
 
 #include <algorithm>
@@ -75,6 +76,44 @@ VkDeviceSize MemoryBufferPools::computeBufferTotalReserved() const
     return totalReservedSize;
 }
 
+VkDeviceSize MemoryBufferPools::releaseUnused()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    VkDeviceSize totalReleased = 0;
+
+    // remove Buffers first as their release will release their DeviceMemory slots
+    auto buffer_itr = std::remove_if(bufferPools.begin(), bufferPools.end(), [&](const ref_ptr<Buffer>& buffer) {
+        if (buffer->totalReservedSize() != 0) return false;
+        totalReleased += buffer->size;
+        return true;
+    });
+    bufferPools.erase(buffer_itr, bufferPools.end());
+
+    auto memory_itr = std::remove_if(memoryPools.begin(), memoryPools.end(), [&](const ref_ptr<DeviceMemory>& deviceMemory) {
+        if (deviceMemory->totalReservedSize() != 0) return false;
+        totalReleased += deviceMemory->getMemoryRequirements().size;
+        return true;
+    });
+    memoryPools.erase(memory_itr, memoryPools.end());
+
+    return totalReleased;
+}
+
+bool MemoryBufferPools::supportsHostVisibleDeviceLocalMemory(Device* device, VkDeviceSize minimumHeapSize)
+{
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    if (!device->getPhysicalDevice()->getMemoryProperties(memoryProperties)) return false;
+
+    const VkMemoryPropertyFlags requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i)
+    {
+        const auto& memoryType = memoryProperties.memoryTypes[i];
+        if ((memoryType.propertyFlags & requiredFlags) == requiredFlags && memoryProperties.memoryHeaps[memoryType.heapIndex].size > minimumHeapSize) return true;
+    }
+    return false;
+}
+
 ref_ptr<BufferInfo> MemoryBufferPools::reserveBuffer(VkDeviceSize totalSize, VkDeviceSize alignment, VkBufferUsageFlags bufferUsageFlags, VkSharingMode sharingMode, VkMemoryPropertyFlags memoryProperties)
 {
     ref_ptr<BufferInfo> bufferInfo = BufferInfo::create();
@@ -166,6 +205,15 @@ MemoryBufferPools::DeviceMemoryOffset MemoryBufferPools::reserveMemory(VkMemoryR
         //debug("Creating new local DeviceMemory");
         if (memRequirements.size < deviceMemorySize) memRequirements.size = deviceMemorySize;
 
+        // with VK_EXT_descriptor_buffer the device address of buffers is needed to write their descriptors, so allocate memory that supports it
+        VkMemoryAllocateFlagsInfo allocateFlagsInfo = {};
+        if (!pNextAllocInfo && DescriptorHeap::supported(device))
+        {
+            allocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+            allocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+            pNextAllocInfo = &allocateFlagsInfo;
+        }
+
         deviceMemory = vsg::DeviceMemory::create(device, memRequirements, memoryProperties, pNextAllocInfo);
         if (deviceMemory)
         {
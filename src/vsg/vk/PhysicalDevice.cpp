@@ -34,6 +34,25 @@ PhysicalDevice::PhysicalDevice(Instance* instance, VkPhysicalDevice device) :
     /// get function pointers
     instance->getProcAddr(_vkGetPhysicalDeviceFeatures2, "vkGetPhysicalDeviceFeatures2", "vkGetPhysicalDeviceFeatures2KHR");
     instance->getProcAddr(_vkGetPhysicalDeviceProperties2, "vkGetPhysicalDeviceProperties2", "vkGetPhysicalDeviceProperties2KHR");
+    instance->getProcAddr(_vkGetPhysicalDeviceMemoryProperties2, "vkGetPhysicalDeviceMemoryProperties2", "vkGetPhysicalDeviceMemoryProperties2KHR");
+}
+
+bool PhysicalDevice::getMemoryProperties(VkPhysicalDeviceMemoryProperties& memoryProperties, void* pNext) const
+{
+    if (!_vkGetPhysicalDeviceMemoryProperties2)
+    {
+        vkGetPhysicalDeviceMemoryProperties(_device, &memoryProperties);
+        return false;
+    }
+
+    VkPhysicalDeviceMemoryProperties2 memoryProperties2 = {};
+    memoryProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memoryProperties2.pNext = pNext;
+
+    _vkGetPhysicalDeviceMemoryProperties2(_device, &memoryProperties2);
+
+    memoryProperties = memoryProperties2.memoryProperties;
+    return true;
 }
 
 PhysicalDevice::~PhysicalDevice()
@@ -104,9 +123,21 @@ std::vector<VkExtensionProperties> PhysicalDevice::enumerateDeviceExtensionPrope
     return extensionProperties;
 }
 
+const ExtensionProperties& PhysicalDevice::getExtensionProperties()
+{
+    // the supported extensions don't change so only enumerate them once, Window and Device setup checks for many extensions
+    std::scoped_lock<std::mutex> lock(_extensionPropertiesMutex);
+    if (!_extensionPropertiesEnumerated)
+    {
+        _extensionProperties = enumerateDeviceExtensionProperties();
+        _extensionPropertiesEnumerated = true;
+    }
+    return _extensionProperties;
+}
+
 bool PhysicalDevice::supportsDeviceExtension(const char* extensionName)
 {
-    auto extensionProperties = enumerateDeviceExtensionProperties();
+    auto& extensionProperties = getExtensionProperties();
     for (auto& extensionProperty : extensionProperties)
     {
         if (std::strncmp(extensionProperty.extensionName, extensionName, VK_MAX_EXTENSION_NAME_SIZE) == 0)
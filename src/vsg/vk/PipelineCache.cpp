@@ -0,0 +1,165 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2018 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Exception.h>
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/Logger.h>
+#include <vsg/io/Options.h>
+#include <vsg/vk/PipelineCache.h>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace vsg;
+
+PipelineCache::PipelineCache(Device* device, ref_ptr<ubyteArray> initialData) :
+    _device(device)
+{
+    _create(initialData);
+}
+
+PipelineCache::PipelineCache(Device* device, const Path& in_filename) :
+    filename(in_filename),
+    _device(device)
+{
+    ref_ptr<ubyteArray> initialData;
+    if (filename && fileExists(filename))
+    {
+        std::ifstream fin(filename, std::ios::ate | std::ios::binary);
+        if (fin.is_open())
+        {
+            size_t fileSize = fin.tellg();
+            if (fileSize > 0)
+            {
+                initialData = ubyteArray::create(fileSize);
+                fin.seekg(0);
+                fin.read(reinterpret_cast<char*>(initialData->dataPointer()), fileSize);
+            }
+        }
+    }
+
+    _create(initialData);
+}
+
+PipelineCache::~PipelineCache()
+{
+    if (_pipelineCache)
+    {
+        vkDestroyPipelineCache(*_device, _pipelineCache, _device->getAllocationCallbacks());
+    }
+}
+
+void PipelineCache::_create(const ubyteArray* initialData)
+{
+    VkPipelineCacheCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.pNext = nullptr;
+    createInfo.flags = 0;
+
+    if (initialData && compatible(_device, initialData))
+    {
+        createInfo.initialDataSize = initialData->dataSize();
+        createInfo.pInitialData = initialData->dataPointer();
+    }
+    else
+    {
+        if (initialData) info("PipelineCache::PipelineCache() initial data not compatible with device, ignoring it.");
+
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+    }
+
+    if (VkResult result = vkCreatePipelineCache(*_device, &createInfo, _device->getAllocationCallbacks(), &_pipelineCache); result != VK_SUCCESS)
+    {
+        throw Exception{"Error: Failed to create PipelineCache.", result};
+    }
+}
+
+ref_ptr<ubyteArray> PipelineCache::getData() const
+{
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(*_device, _pipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) return {};
+
+    auto data = ubyteArray::create(dataSize);
+    if (vkGetPipelineCacheData(*_device, _pipelineCache, &dataSize, data->dataPointer()) != VK_SUCCESS) return {};
+
+    return data;
+}
+
+bool PipelineCache::write(const Path& in_filename) const
+{
+    if (!in_filename) return false;
+
+    auto data = getData();
+    if (!data) return false;
+
+    auto path = filePath(in_filename);
+    if (path && !makeDirectory(path))
+    {
+        warn("PipelineCache::write() unable to create directory ", path);
+        return false;
+    }
+
+    // write to a temporary file first so that concurrent readers never see a partially written cache
+    Path tempFilename = in_filename;
+    tempFilename += ".tmp";
+
+    std::ofstream fout(tempFilename, std::ios::out | std::ios::binary);
+    if (!fout.is_open()) return false;
+
+    fout.write(reinterpret_cast<const char*>(data->dataPointer()), data->dataSize());
+    fout.close();
+
+    std::remove(in_filename.string().c_str());
+    return std::rename(tempFilename.string().c_str(), in_filename.string().c_str()) == 0;
+}
+
+bool PipelineCache::compatible(const Device* device, const ubyteArray* data)
+{
+    // header layout is defined by VkPipelineCacheHeaderVersionOne
+    const size_t headerSize = 16 + VK_UUID_SIZE;
+    if (!data || data->dataSize() < headerSize) return false;
+
+    auto ptr = static_cast<const uint8_t*>(data->dataPointer());
+
+    uint32_t headerLength, headerVersion, vendorID, deviceID;
+    std::memcpy(&headerLength, ptr, 4);
+    std::memcpy(&headerVersion, ptr + 4, 4);
+    std::memcpy(&vendorID, ptr + 8, 4);
+    std::memcpy(&deviceID, ptr + 12, 4);
+
+    if (headerLength < headerSize || headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) return false;
+
+    auto& properties = device->getPhysicalDevice()->getProperties();
+    if (vendorID != properties.vendorID || deviceID != properties.deviceID) return false;
+
+    return std::memcmp(ptr + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+Path PipelineCache::cacheFilename(const Device* device, const Options* options)
+{
+    if (!options || !options->fileCache) return {};
+
+    auto& properties = device->getPhysicalDevice()->getProperties();
+
+    std::ostringstream str;
+    str << "pipelineCache_" << std::hex << std::setfill('0');
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+    {
+        str << std::setw(2) << static_cast<uint32_t>(properties.pipelineCacheUUID[i]);
+    }
+    str << "_" << std::setw(8) << properties.driverVersion << ".bin";
+
+    return options->fileCache / "pipelines" / str.str();
+}
@@ -13,6 +13,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/vk/Fence.h>
 #include <vsg/vk/Queue.h>
+#include <vsg/vk/TimelineSemaphore.h>
 
 using namespace vsg;
 
@@ -40,6 +41,47 @@ VkResult Queue::submit(const VkSubmitInfo& submitInfo, Fence* fence)
     return vkQueueSubmit(_vkQueue, 1, &submitInfo, fence ? fence->vk() : VK_NULL_HANDLE);
 }
 
+VkResult Queue::submit(const VkSubmitInfo& submitInfo, const std::vector<uint64_t>& waitValues, uint64_t& signalValue, const std::vector<uint64_t>& signalValues)
+{
+    if (!timeline) return VK_ERROR_FEATURE_NOT_PRESENT;
+
+    // values are required for every wait and signal semaphore, binary semaphores ignore theirs
+    std::vector<uint64_t> vk_waitValues(waitValues);
+    vk_waitValues.resize(submitInfo.waitSemaphoreCount, 0);
+
+    std::vector<VkSemaphore> vk_signalSemaphores(submitInfo.pSignalSemaphores, submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount);
+    vk_signalSemaphores.push_back(timeline->vk());
+    std::vector<uint64_t> vk_signalValues(signalValues);
+    vk_signalValues.resize(vk_signalSemaphores.size(), 0);
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.pNext = submitInfo.pNext;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(vk_waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = vk_waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(vk_signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = vk_signalValues.data();
+
+    VkSubmitInfo timelineSubmitInfo = submitInfo;
+    timelineSubmitInfo.pNext = &timelineInfo;
+    timelineSubmitInfo.signalSemaphoreCount = static_cast<uint32_t>(vk_signalSemaphores.size());
+    timelineSubmitInfo.pSignalSemaphores = vk_signalSemaphores.data();
+
+    std::scoped_lock<std::mutex> guard(_mutex);
+
+    // assign the value while holding the mutex so that values increase in submission order
+    uint64_t value = timeline->submittedValue + 1;
+    vk_signalValues.back() = value;
+
+    VkResult result = vkQueueSubmit(_vkQueue, 1, &timelineSubmitInfo, VK_NULL_HANDLE);
+    if (result == VK_SUCCESS)
+    {
+        timeline->submittedValue = value;
+        signalValue = value;
+    }
+    return result;
+}
+
 VkResult Queue::present(const VkPresentInfoKHR& info)
 {
     std::scoped_lock<std::mutex> guard(_mutex);
@@ -119,6 +119,17 @@ RenderPass::RenderPass(Device* in_device, const Attachments& in_attachments, con
 
                     dst.pNext = depthStencilResolve;
                 }
+
+                if (!src.fragmentShadingRateAttachments.empty())
+                {
+                    auto fragmentShadingRate = scratchMemory->allocate<VkFragmentShadingRateAttachmentInfoKHR>();
+                    fragmentShadingRate->sType = VK_STRUCTURE_TYPE_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR;
+                    fragmentShadingRate->pNext = dst.pNext;
+                    fragmentShadingRate->pFragmentShadingRateAttachment = copyAttachmentReference(src.fragmentShadingRateAttachments);
+                    fragmentShadingRate->shadingRateAttachmentTexelSize = src.shadingRateAttachmentTexelSize;
+
+                    dst.pNext = fragmentShadingRate;
+                }
             }
             return vk_subpassDescription;
         };
@@ -271,6 +282,26 @@ RenderPass::~RenderPass()
     }
 }
 
+VkSampleCountFlagBits RenderPass::subpassSamples(uint32_t subpass) const
+{
+    if (subpass >= subpasses.size()) return maxSamples;
+
+    auto& description = subpasses[subpass];
+    if (description.colorAttachments.empty() && description.depthStencilAttachments.empty()) return maxSamples;
+
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    auto accumulate = [&](const std::vector<AttachmentReference>& references) {
+        for (auto& reference : references)
+        {
+            if (reference.attachment < attachments.size() && attachments[reference.attachment].samples > samples) samples = attachments[reference.attachment].samples;
+        }
+    };
+    accumulate(description.colorAttachments);
+    accumulate(description.depthStencilAttachments);
+
+    return samples;
+}
+
 AttachmentDescription vsg::defaultColorAttachment(VkFormat imageFormat)
 {
     AttachmentDescription colorAttachment = {};
@@ -353,6 +384,223 @@ ref_ptr<RenderPass> vsg::createRenderPass(Device* device, VkFormat imageFormat,
     return RenderPass::create(device, attachments, subpasses, dependencies);
 }
 
+ref_ptr<RenderPass> vsg::createMultiviewRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat, uint32_t numViews, bool requiresDepthRead)
+{
+    auto colorAttachment = defaultColorAttachment(imageFormat);
+    auto depthAttachment = defaultDepthAttachment(depthFormat);
+
+    // multiview attachments are typically array images that are passed on to a compositor or sampled, rather than presented
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    if (requiresDepthRead)
+    {
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    }
+
+    RenderPass::Attachments attachments{colorAttachment, depthAttachment};
+
+    AttachmentReference colorAttachmentRef = {};
+    colorAttachmentRef.attachment = 0;
+    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    AttachmentReference depthAttachmentRef = {};
+    depthAttachmentRef.attachment = 1;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    // render to each of the numViews layers, with gl_ViewIndex selecting the layer's projection and view matrices
+    uint32_t viewMask = (numViews >= 32) ? 0xffffffff : ((1u << numViews) - 1);
+
+    SubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachments.emplace_back(colorAttachmentRef);
+    subpass.depthStencilAttachments.emplace_back(depthAttachmentRef);
+    subpass.viewMask = viewMask;
+
+    RenderPass::Subpasses subpasses{subpass};
+
+    // image layout transition
+    SubpassDependency colorDependency = {};
+    colorDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    colorDependency.dstSubpass = 0;
+    colorDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    colorDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    colorDependency.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    colorDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    colorDependency.dependencyFlags = 0;
+
+    // depth buffer is shared between frames
+    SubpassDependency depthDependency = {};
+    depthDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    depthDependency.dstSubpass = 0;
+    depthDependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    depthDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    depthDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthDependency.dependencyFlags = 0;
+
+    // sampling of the color attachment after the render pass
+    SubpassDependency outputDependency = {};
+    outputDependency.srcSubpass = 0;
+    outputDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    outputDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    outputDependency.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    outputDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    outputDependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    outputDependency.dependencyFlags = 0;
+
+    RenderPass::Dependencies dependencies{colorDependency, depthDependency, outputDependency};
+
+    // the views are spatially coherent, so let the implementation render them concurrently
+    RenderPass::CorrelatedViewMasks correlatedViewMasks{viewMask};
+
+    return RenderPass::create(device, attachments, subpasses, dependencies, correlatedViewMasks);
+}
+
+ref_ptr<RenderPass> vsg::createDepthPrePassRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat, bool requiresDepthRead)
+{
+    auto colorAttachment = defaultColorAttachment(imageFormat);
+    auto depthAttachment = defaultDepthAttachment(depthFormat);
+
+    if (requiresDepthRead)
+    {
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    }
+
+    RenderPass::Attachments attachments{colorAttachment, depthAttachment};
+
+    // subpass 0 only writes depth
+    SubpassDescription depthSubpass = {};
+    depthSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    depthSubpass.depthStencilAttachments.push_back(AttachmentReference{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
+    depthSubpass.preserveAttachments.push_back(0);
+
+    // subpass 1 shades the color buffer, testing against but not writing depth
+    SubpassDescription colorSubpass = {};
+    colorSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    colorSubpass.colorAttachments.push_back(AttachmentReference{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    colorSubpass.depthStencilAttachments.push_back(AttachmentReference{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL});
+
+    RenderPass::Subpasses subpasses{depthSubpass, colorSubpass};
+
+    // depth buffer is shared between swap chain images
+    SubpassDependency depthDependency = {};
+    depthDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    depthDependency.dstSubpass = 0;
+    depthDependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    depthDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    depthDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthDependency.dependencyFlags = 0;
+
+    // depth writes must complete before the color subpass tests against them, only the same pixel is accessed so the dependency can be by region
+    SubpassDependency prePassDependency = {};
+    prePassDependency.srcSubpass = 0;
+    prePassDependency.dstSubpass = 1;
+    prePassDependency.srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    prePassDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    prePassDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    prePassDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    prePassDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // image layout transition
+    SubpassDependency colorDependency = {};
+    colorDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    colorDependency.dstSubpass = 1;
+    colorDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    colorDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    colorDependency.srcAccessMask = 0;
+    colorDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    colorDependency.dependencyFlags = 0;
+
+    RenderPass::Dependencies dependencies{depthDependency, prePassDependency, colorDependency};
+
+    return RenderPass::create(device, attachments, subpasses, dependencies);
+}
+
+ref_ptr<RenderPass> vsg::createToneMapRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat, VkFormat hdrFormat, VkSampleCountFlagBits samples)
+{
+    auto colorAttachment = defaultColorAttachment(imageFormat);
+
+    auto hdrAttachment = defaultColorAttachment(hdrFormat);
+    hdrAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    hdrAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    auto depthAttachment = defaultDepthAttachment(depthFormat);
+    depthAttachment.samples = samples;
+
+    // the swapchain image is only written by the tone map subpass so needn't be cleared
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+
+    RenderPass::Attachments attachments{colorAttachment, hdrAttachment, depthAttachment};
+
+    // subpass 0 renders the scene to the hdr color buffer
+    SubpassDescription sceneSubpass = {};
+    sceneSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    sceneSubpass.depthStencilAttachments.push_back(AttachmentReference{2, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
+
+    if (samples != VK_SAMPLE_COUNT_1_BIT)
+    {
+        // the multisampled hdr color buffer is resolved within the render pass, so on tile based GPUs only the resolved hdr color is ever held per pixel
+        auto multisampleAttachment = defaultColorAttachment(hdrFormat);
+        multisampleAttachment.samples = samples;
+        multisampleAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        multisampleAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachments.push_back(multisampleAttachment);
+
+        // the resolve overwrites every pixel of the hdr color buffer
+        attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+
+        sceneSubpass.colorAttachments.push_back(AttachmentReference{3, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+        sceneSubpass.resolveAttachments.push_back(AttachmentReference{1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    }
+    else
+    {
+        sceneSubpass.colorAttachments.push_back(AttachmentReference{1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+    }
+
+    // subpass 1 reads the hdr color buffer as an input attachment and writes the tone mapped color
+    SubpassDescription toneMapSubpass = {};
+    toneMapSubpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    toneMapSubpass.inputAttachments.push_back(AttachmentReference{1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT});
+    toneMapSubpass.colorAttachments.push_back(AttachmentReference{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+
+    RenderPass::Subpasses subpasses{sceneSubpass, toneMapSubpass};
+
+    // hdr color and depth buffers are shared between swap chain images
+    SubpassDependency sceneDependency = {};
+    sceneDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    sceneDependency.dstSubpass = 0;
+    sceneDependency.srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    sceneDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    sceneDependency.srcAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    sceneDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    sceneDependency.dependencyFlags = 0;
+
+    // hdr writes must complete before the tone map subpass reads them, only the same pixel is read so the dependency can be by region
+    SubpassDependency toneMapDependency = {};
+    toneMapDependency.srcSubpass = 0;
+    toneMapDependency.dstSubpass = 1;
+    toneMapDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    toneMapDependency.dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    toneMapDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toneMapDependency.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    toneMapDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // image layout transition
+    SubpassDependency colorDependency = {};
+    colorDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    colorDependency.dstSubpass = 1;
+    colorDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    colorDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    colorDependency.srcAccessMask = 0;
+    colorDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    colorDependency.dependencyFlags = 0;
+
+    RenderPass::Dependencies dependencies{sceneDependency, toneMapDependency, colorDependency};
+
+    return RenderPass::create(device, attachments, subpasses, dependencies);
+}
+
 ref_ptr<RenderPass> vsg::createMultisampledRenderPass(Device* device, VkFormat imageFormat, VkFormat depthFormat, VkSampleCountFlagBits samples, bool requiresDepthRead)
 {
     if (samples == VK_SAMPLE_COUNT_1_BIT)
@@ -21,6 +21,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/nodes/StateGroup.h>
 #include <vsg/nodes/VertexDraw.h>
 #include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/raytracing/DescriptorAccelerationStructure.h>
+#include <vsg/raytracing/TopLevelAccelerationStructure.h>
 #include <vsg/state/DescriptorImage.h>
 #include <vsg/state/MultisampleState.h>
 #include <vsg/state/ViewDependentState.h>
@@ -72,6 +74,7 @@ void ResourceRequirements::apply(const ResourceHints& resourceHints)
     numLightsRange = resourceHints.numLightsRange;
     numShadowMapsRange = resourceHints.numShadowMapsRange;
     shadowMapSize = resourceHints.shadowMapSize;
+    releaseDataHint = resourceHints.releaseDataHint;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -83,6 +86,7 @@ ref_ptr<ResourceHints> CollectResourceRequirements::createResourceHints(uint32_t
     auto resourceHints = vsg::ResourceHints::create();
 
     resourceHints->maxSlot = requirements.maxSlot;
+    resourceHints->releaseDataHint = requirements.releaseDataHint;
     resourceHints->numDescriptorSets = static_cast<uint32_t>(requirements.computeNumDescriptorSets() * tileMultiplier);
     resourceHints->descriptorPoolSizes = requirements.computeDescriptorPoolSizes();
 
@@ -191,7 +195,18 @@ bool CollectResourceRequirements::registerDescriptor(const Descriptor& descripto
 
 void CollectResourceRequirements::apply(const Descriptor& descriptor)
 {
-    registerDescriptor(descriptor);
+    if (registerDescriptor(descriptor))
+    {
+        // top level acceleration structures that allow updates have dynamic instance data that the TransferTask needs to be assigned
+        if (auto descriptorAccelerationStructure = descriptor.cast<DescriptorAccelerationStructure>())
+        {
+            for (auto& accelerationStructure : descriptorAccelerationStructure->getAccelerationStructures())
+            {
+                auto tlas = accelerationStructure.cast<TopLevelAccelerationStructure>();
+                if (tlas && tlas->allowUpdate) apply(tlas->getInstanceBufferInfo());
+            }
+        }
+    }
 }
 
 void CollectResourceRequirements::apply(const DescriptorBuffer& descriptorBuffer)
@@ -293,6 +308,11 @@ void CollectResourceRequirements::apply(const BindIndexBuffer& bib)
 
 void CollectResourceRequirements::apply(ref_ptr<BufferInfo> bufferInfo)
 {
+    if (bufferInfo && requirements.bufferInfos.insert(bufferInfo.get()).second && bufferInfo->data)
+    {
+        requirements.dataSize += bufferInfo->data->dataSize();
+    }
+
     if (bufferInfo && bufferInfo->data && bufferInfo->data->dynamic())
     {
         if (bufferInfo->data->properties.dataVariance == DYNAMIC_DATA)
@@ -310,6 +330,12 @@ void CollectResourceRequirements::apply(ref_ptr<ImageInfo> imageInfo)
 {
     if (imageInfo && imageInfo->imageView && imageInfo->imageView->image)
     {
+        auto& image = imageInfo->imageView->image;
+        if (requirements.images.insert(image.get()).second && image->data)
+        {
+            requirements.dataSize += image->data->dataSize();
+        }
+
         // check for dynamic data
         auto& data = imageInfo->imageView->image->data;
         if (data && data->dynamic())
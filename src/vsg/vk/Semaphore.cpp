@@ -14,6 +14,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/Options.h>
 #include <vsg/vk/Semaphore.h>
 
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#    include <vulkan/vulkan_win32.h>
+#endif
+
 using namespace vsg;
 
 Semaphore::Semaphore(Device* device, VkPipelineStageFlags pipelineStageFlags, void* pNextCreateInfo) :
@@ -38,3 +46,108 @@ Semaphore::~Semaphore()
         vkDestroySemaphore(*_device, _semaphore, _device->getAllocationCallbacks());
     }
 }
+
+int Semaphore::exportFd(VkExternalSemaphoreHandleTypeFlagBits handleType) const
+{
+    auto vkGetSemaphoreFdKHR = _device->getExtensions()->vkGetSemaphoreFdKHR;
+    if (!vkGetSemaphoreFdKHR)
+    {
+        warn("Semaphore::exportFd() requires VK_KHR_external_semaphore_fd to be enabled on the Device.");
+        return -1;
+    }
+
+    VkSemaphoreGetFdInfoKHR getFdInfo = {};
+    getFdInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR;
+    getFdInfo.pNext = nullptr;
+    getFdInfo.semaphore = _semaphore;
+    getFdInfo.handleType = handleType;
+
+    int fd = -1;
+    if (VkResult result = vkGetSemaphoreFdKHR(*_device, &getFdInfo, &fd); result != VK_SUCCESS)
+    {
+        warn("Semaphore::exportFd() vkGetSemaphoreFdKHR failed, VkResult = ", result);
+        return -1;
+    }
+    return fd;
+}
+
+VkResult Semaphore::importFd(VkExternalSemaphoreHandleTypeFlagBits handleType, int fd, VkSemaphoreImportFlags flags)
+{
+    auto vkImportSemaphoreFdKHR = _device->getExtensions()->vkImportSemaphoreFdKHR;
+    if (!vkImportSemaphoreFdKHR) return VK_ERROR_EXTENSION_NOT_PRESENT;
+
+    VkImportSemaphoreFdInfoKHR importInfo = {};
+    importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR;
+    importInfo.pNext = nullptr;
+    importInfo.semaphore = _semaphore;
+    importInfo.flags = flags;
+    importInfo.handleType = handleType;
+    importInfo.fd = fd;
+
+    return vkImportSemaphoreFdKHR(*_device, &importInfo);
+}
+
+void* Semaphore::exportWin32Handle(VkExternalSemaphoreHandleTypeFlagBits handleType) const
+{
+#if defined(_WIN32)
+    // loaded on demand as the Win32 types are only available with vulkan_win32.h
+    PFN_vkGetSemaphoreWin32HandleKHR vkGetSemaphoreWin32HandleKHR = nullptr;
+    if (!_device->getProcAddr(vkGetSemaphoreWin32HandleKHR, "vkGetSemaphoreWin32HandleKHR"))
+    {
+        warn("Semaphore::exportWin32Handle() requires VK_KHR_external_semaphore_win32 to be enabled on the Device.");
+        return nullptr;
+    }
+
+    VkSemaphoreGetWin32HandleInfoKHR getHandleInfo = {};
+    getHandleInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_WIN32_HANDLE_INFO_KHR;
+    getHandleInfo.pNext = nullptr;
+    getHandleInfo.semaphore = _semaphore;
+    getHandleInfo.handleType = handleType;
+
+    HANDLE handle = nullptr;
+    if (VkResult result = vkGetSemaphoreWin32HandleKHR(*_device, &getHandleInfo, &handle); result != VK_SUCCESS)
+    {
+        warn("Semaphore::exportWin32Handle() vkGetSemaphoreWin32HandleKHR failed, VkResult = ", result);
+        return nullptr;
+    }
+    return handle;
+#else
+    (void)handleType;
+    warn("Semaphore::exportWin32Handle() not supported on this platform.");
+    return nullptr;
+#endif
+}
+
+VkResult Semaphore::importWin32Handle(VkExternalSemaphoreHandleTypeFlagBits handleType, void* handle, VkSemaphoreImportFlags flags)
+{
+#if defined(_WIN32)
+    PFN_vkImportSemaphoreWin32HandleKHR vkImportSemaphoreWin32HandleKHR = nullptr;
+    if (!_device->getProcAddr(vkImportSemaphoreWin32HandleKHR, "vkImportSemaphoreWin32HandleKHR")) return VK_ERROR_EXTENSION_NOT_PRESENT;
+
+    VkImportSemaphoreWin32HandleInfoKHR importInfo = {};
+    importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_WIN32_HANDLE_INFO_KHR;
+    importInfo.pNext = nullptr;
+    importInfo.semaphore = _semaphore;
+    importInfo.flags = flags;
+    importInfo.handleType = handleType;
+    importInfo.handle = handle;
+    importInfo.name = nullptr;
+
+    return vkImportSemaphoreWin32HandleKHR(*_device, &importInfo);
+#else
+    (void)handleType;
+    (void)handle;
+    (void)flags;
+    return VK_ERROR_EXTENSION_NOT_PRESENT;
+#endif
+}
+
+ref_ptr<Semaphore> vsg::createExportableSemaphore(Device* device, VkExternalSemaphoreHandleTypeFlags handleTypes, VkPipelineStageFlags pipelineStageFlags)
+{
+    VkExportSemaphoreCreateInfo exportInfo = {};
+    exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO;
+    exportInfo.pNext = nullptr;
+    exportInfo.handleTypes = handleTypes;
+
+    return Semaphore::create(device, pipelineStageFlags, &exportInfo);
+}
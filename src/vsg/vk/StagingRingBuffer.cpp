@@ -0,0 +1,116 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/observer_ptr.h>
+#include <vsg/io/Logger.h>
+#include <vsg/vk/StagingRingBuffer.h>
+
+using namespace vsg;
+
+StagingRingBuffer::StagingRingBuffer(Device* in_device, VkDeviceSize in_size) :
+    _device(in_device),
+    _size(in_size)
+{
+    _buffer = createBufferAndMemory(_device, _size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    auto deviceID = _device->deviceID;
+    void* data = nullptr;
+    if (auto deviceMemory = _buffer->getDeviceMemory(deviceID); deviceMemory && deviceMemory->map(_buffer->getMemoryOffset(deviceID), _size, 0, &data) == VK_SUCCESS)
+    {
+        _data = static_cast<uint8_t*>(data);
+    }
+    else
+    {
+        warn("StagingRingBuffer::StagingRingBuffer() unable to map staging memory.");
+    }
+
+    // allocations are handed out as sub ranges with this as their parent, so releasing them doesn't touch the buffer's memory slots
+    _rootBufferInfo = BufferInfo::create(_buffer, 0, _size);
+}
+
+StagingRingBuffer::~StagingRingBuffer()
+{
+    if (_data) _buffer->getDeviceMemory(_device->deviceID)->unmap();
+}
+
+ref_ptr<StagingRingBuffer> StagingRingBuffer::getOrCreate(Device* device)
+{
+    static std::mutex s_mutex;
+    static std::vector<observer_ptr<StagingRingBuffer>> s_stagingRingBuffers;
+
+    std::scoped_lock<std::mutex> lock(s_mutex);
+
+    if (s_stagingRingBuffers.size() <= device->deviceID) s_stagingRingBuffers.resize(device->deviceID + 1);
+
+    auto stagingRingBuffer = s_stagingRingBuffers[device->deviceID].ref_ptr();
+    if (!stagingRingBuffer || stagingRingBuffer->getDevice() != device)
+    {
+        stagingRingBuffer = StagingRingBuffer::create(device);
+        s_stagingRingBuffers[device->deviceID] = stagingRingBuffer;
+    }
+    return stagingRingBuffer;
+}
+
+StagingRingBuffer::Allocation StagingRingBuffer::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    if (!_data || size == 0 || size > _size) return {};
+
+    alignment = std::max(alignment, VkDeviceSize(4));
+
+    uint64_t head = _head.load();
+    for (;;)
+    {
+        uint64_t offset = head % _size;
+        uint64_t alignedOffset = ((offset + alignment - 1) / alignment) * alignment;
+
+        // allocations can't straddle the end of the buffer so pad to the start of the ring, the padding is released along with the allocation
+        if (alignedOffset + size > _size) alignedOffset = _size;
+
+        uint64_t end = head + (alignedOffset - offset) + size;
+        if ((end - _tail.load()) > _size) return {};
+
+        if (_head.compare_exchange_weak(head, end))
+        {
+            Allocation allocation;
+            allocation.begin = head;
+            allocation.end = end;
+            allocation.offset = (end - size) % _size;
+            allocation.data = _data + allocation.offset;
+            return allocation;
+        }
+    }
+}
+
+void StagingRingBuffer::release(const Allocation& allocation)
+{
+    if (!allocation) return;
+
+    std::scoped_lock<std::mutex> lock(_releaseMutex);
+
+    _released[allocation.begin] = allocation.end;
+
+    // advance the tail over the contiguous run of released allocations
+    uint64_t tail = _tail.load();
+    for (auto itr = _released.find(tail); itr != _released.end(); itr = _released.find(tail))
+    {
+        tail = itr->second;
+        _released.erase(itr);
+    }
+    _tail.exchange(tail);
+}
+
+ref_ptr<BufferInfo> StagingRingBuffer::bufferInfo(const Allocation& allocation, VkDeviceSize size) const
+{
+    auto bufferInfo = BufferInfo::create(_buffer, allocation.offset, size);
+    bufferInfo->parent = _rootBufferInfo;
+    return bufferInfo;
+}
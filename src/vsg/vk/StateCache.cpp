@@ -0,0 +1,135 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/BinaryOutput.h>
+#include <vsg/vk/StateCache.h>
+
+#include <sstream>
+
+using namespace vsg;
+
+StateCache::StateCache(Device* in_device) :
+    _device(in_device)
+{
+}
+
+StateCache::~StateCache()
+{
+}
+
+ref_ptr<StateCache> StateCache::getOrCreate(Device* device)
+{
+    static std::mutex s_mutex;
+    static std::vector<observer_ptr<StateCache>> s_stateCaches;
+
+    std::scoped_lock<std::mutex> lock(s_mutex);
+
+    if (s_stateCaches.size() <= device->deviceID) s_stateCaches.resize(device->deviceID + 1);
+
+    auto stateCache = s_stateCaches[device->deviceID].ref_ptr();
+    if (!stateCache || stateCache->getDevice() != device)
+    {
+        stateCache = StateCache::create(device);
+        s_stateCaches[device->deviceID] = stateCache;
+    }
+    return stateCache;
+}
+
+ref_ptr<Object> StateCache::getOrCreate(const Object& object, const Object* scope, const std::function<ref_ptr<Object>()>& create, uint32_t variant)
+{
+    // the serialized state is used as the key so that objects only share implementations when their state is identical
+    std::ostringstream stream;
+    stream.write(reinterpret_cast<const char*>(&scope), sizeof(scope));
+    stream.write(reinterpret_cast<const char*>(&variant), sizeof(variant));
+    {
+        BinaryOutput output(stream);
+        output.writeObject("object", &object);
+    }
+    auto key = stream.str();
+
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+
+        auto& statistics = _statistics[object.className()];
+        ++statistics.requests;
+
+        if (auto itr = _entries.find(key); itr != _entries.end())
+        {
+            if (auto implementation = itr->second.implementation.ref_ptr())
+            {
+                ++statistics.hits;
+                statistics.bytesShared += key.size();
+                return implementation;
+            }
+        }
+    }
+
+    // create outside the lock as creating pipelines can be slow and may be done in parallel
+    auto implementation = create();
+    if (!implementation) return {};
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    auto& entry = _entries[key];
+    if (auto existing = entry.implementation.ref_ptr())
+    {
+        // another thread created a matching implementation while this one was being created, so use the first one created
+        return existing;
+    }
+
+    entry.scope = scope;
+    entry.implementation = implementation;
+
+    if (_entries.size() >= _pruneSize) _prune();
+
+    return implementation;
+}
+
+std::map<std::string, StateCache::Statistics> StateCache::getStatistics() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void StateCache::report(std::ostream& out) const
+{
+    for (auto& [className, statistics] : getStatistics())
+    {
+        out << className << " requests = " << statistics.requests << ", hits = " << statistics.hits << ", hit rate = " << statistics.hitRate() * 100.0 << "%, bytes shared = " << statistics.bytesShared << std::endl;
+    }
+}
+
+size_t StateCache::size() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+void StateCache::prune()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _prune();
+}
+
+void StateCache::_prune()
+{
+    for (auto itr = _entries.begin(); itr != _entries.end();)
+    {
+        if (!itr->second.implementation)
+            itr = _entries.erase(itr);
+        else
+            ++itr;
+    }
+
+    // avoid pruning on every insertion when most entries are still in use
+    _pruneSize = std::max(size_t(256), _entries.size() * 2);
+}
@@ -0,0 +1,73 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2024 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/vk/TimelineSemaphore.h>
+
+using namespace vsg;
+
+// the create info structs are temporaries that live until the end of the Semaphore constructor's mem-initializer
+static void* semaphoreTypeCreateInfo(VkSemaphoreTypeCreateInfo&& createInfo, VkExportSemaphoreCreateInfo&& exportInfo, uint64_t initialValue, VkExternalSemaphoreHandleTypeFlags exportHandleTypes)
+{
+    exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO;
+    exportInfo.pNext = nullptr;
+    exportInfo.handleTypes = exportHandleTypes;
+
+    createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    createInfo.pNext = (exportHandleTypes != 0) ? &exportInfo : nullptr;
+    createInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    createInfo.initialValue = initialValue;
+    return &createInfo;
+}
+
+TimelineSemaphore::TimelineSemaphore(Device* device, uint64_t initialValue, VkPipelineStageFlags pipelineStageFlags, VkExternalSemaphoreHandleTypeFlags exportHandleTypes) :
+    Inherit(device, pipelineStageFlags, semaphoreTypeCreateInfo(VkSemaphoreTypeCreateInfo{}, VkExportSemaphoreCreateInfo{}, initialValue, exportHandleTypes)),
+    submittedValue(initialValue)
+{
+}
+
+TimelineSemaphore::~TimelineSemaphore()
+{
+}
+
+uint64_t TimelineSemaphore::value() const
+{
+    uint64_t counter = 0;
+    if (auto vkGetSemaphoreCounterValue = _device->getExtensions()->vkGetSemaphoreCounterValue) vkGetSemaphoreCounterValue(_device->vk(), _semaphore, &counter);
+    return counter;
+}
+
+VkResult TimelineSemaphore::wait(uint64_t value, uint64_t timeout) const
+{
+    auto vkWaitSemaphores = _device->getExtensions()->vkWaitSemaphores;
+    if (!vkWaitSemaphores) return VK_ERROR_FEATURE_NOT_PRESENT;
+
+    VkSemaphoreWaitInfo waitInfo = {};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_semaphore;
+    waitInfo.pValues = &value;
+
+    return vkWaitSemaphores(_device->vk(), &waitInfo, timeout);
+}
+
+VkResult TimelineSemaphore::signal(uint64_t value)
+{
+    auto vkSignalSemaphore = _device->getExtensions()->vkSignalSemaphore;
+    if (!vkSignalSemaphore) return VK_ERROR_FEATURE_NOT_PRESENT;
+
+    VkSemaphoreSignalInfo signalInfo = {};
+    signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+    signalInfo.semaphore = _semaphore;
+    signalInfo.value = value;
+
+    return vkSignalSemaphore(_device->vk(), &signalInfo);
+}